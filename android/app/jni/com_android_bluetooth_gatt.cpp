@@ -125,6 +125,7 @@ static jmethodID method_onSearchCompleted;
 static jmethodID method_onReadDescriptor;
 static jmethodID method_onWriteDescriptor;
 static jmethodID method_onNotify;
+static jmethodID method_onNotifyBatch;
 static jmethodID method_onRegisterForNotifications;
 static jmethodID method_onReadRemoteRssi;
 static jmethodID method_onConfigureMTU;
@@ -308,6 +309,54 @@ void btgattc_notify_cb(int conn_id, const btgatt_notify_params_t& p_data) {
                                jb.get());
 }
 
+void btgattc_notify_batch_cb(const int* conn_ids,
+                             const btgatt_notify_params_t* p_data, int count) {
+  std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
+  CallbackEnv sCallbackEnv(__func__);
+  if (!sCallbackEnv.valid() || !mCallbacksObj) return;
+
+  ScopedLocalRef<jintArray> jconn_ids(sCallbackEnv.get(),
+                                      sCallbackEnv->NewIntArray(count));
+  ScopedLocalRef<jintArray> jhandles(sCallbackEnv.get(),
+                                     sCallbackEnv->NewIntArray(count));
+  ScopedLocalRef<jclass> string_class(
+      sCallbackEnv.get(), sCallbackEnv->FindClass("java/lang/String"));
+  ScopedLocalRef<jclass> byte_array_class(sCallbackEnv.get(),
+                                          sCallbackEnv->FindClass("[B"));
+  ScopedLocalRef<jobjectArray> addresses(
+      sCallbackEnv.get(),
+      sCallbackEnv->NewObjectArray(count, string_class.get(), NULL));
+  ScopedLocalRef<jobjectArray> values(
+      sCallbackEnv.get(),
+      sCallbackEnv->NewObjectArray(count, byte_array_class.get(), NULL));
+  if (!jconn_ids.get() || !jhandles.get() || !addresses.get() ||
+      !values.get()) {
+    error("Failed to allocate the notification batch");
+    return;
+  }
+
+  sCallbackEnv->SetIntArrayRegion(jconn_ids.get(), 0, count, conn_ids);
+  for (int i = 0; i < count; i++) {
+    jint handle = p_data[i].handle;
+    sCallbackEnv->SetIntArrayRegion(jhandles.get(), i, 1, &handle);
+
+    ScopedLocalRef<jstring> address(
+        sCallbackEnv.get(),
+        bdaddr2newjstr(sCallbackEnv.get(), &p_data[i].bda));
+    sCallbackEnv->SetObjectArrayElement(addresses.get(), i, address.get());
+
+    ScopedLocalRef<jbyteArray> jb(sCallbackEnv.get(),
+                                  sCallbackEnv->NewByteArray(p_data[i].len));
+    sCallbackEnv->SetByteArrayRegion(jb.get(), 0, p_data[i].len,
+                                     (jbyte*)p_data[i].value);
+    sCallbackEnv->SetObjectArrayElement(values.get(), i, jb.get());
+  }
+
+  sCallbackEnv->CallVoidMethod(mCallbacksObj, method_onNotifyBatch,
+                               jconn_ids.get(), addresses.get(), jhandles.get(),
+                               values.get());
+}
+
 void btgattc_read_characteristic_cb(int conn_id, int status,
                                     btgatt_read_params_t* p_data) {
   std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
@@ -626,6 +675,7 @@ static const btgatt_client_callbacks_t sGattClientCallbacks = {
     btgattc_conn_updated_cb,
     btgattc_service_changed_cb,
     btgattc_subrate_change_cb,
+    btgattc_notify_batch_cb,
 };
 
 /**
@@ -1260,6 +1310,8 @@ static void classInitNative(JNIEnv* env, jclass clazz) {
       env->GetMethodID(clazz, "onWriteDescriptor", "(III[B)V");
   method_onNotify =
       env->GetMethodID(clazz, "onNotify", "(ILjava/lang/String;IZ[B)V");
+  method_onNotifyBatch = env->GetMethodID(
+      clazz, "onNotifyBatch", "([I[Ljava/lang/String;[I[[B)V");
   method_onRegisterForNotifications =
       env->GetMethodID(clazz, "onRegisterForNotifications", "(IIII)V");
   method_onReadRemoteRssi =
@@ -1633,6 +1685,15 @@ static void gattClientRegisterForNotificationsNative(
     sGattIf->client->deregister_for_notification(clientIf, bd_addr, handle);
 }
 
+static void gattClientSetNotificationBatchingNative(JNIEnv* env,
+                                                   jobject object,
+                                                   jint clientIf,
+                                                   jboolean enable) {
+  if (!sGattIf) return;
+
+  sGattIf->client->set_notification_batching(clientIf, enable);
+}
+
 static void gattClientReadRemoteRssiNative(JNIEnv* env, jobject object,
                                            jint clientif, jstring address) {
   if (!sGattIf) return;
@@ -2806,6 +2867,8 @@ static JNINativeMethod sMethods[] = {
      (void*)gattClientExecuteWriteNative},
     {"gattClientRegisterForNotificationsNative", "(ILjava/lang/String;IZ)V",
      (void*)gattClientRegisterForNotificationsNative},
+    {"gattClientSetNotificationBatchingNative", "(IZ)V",
+     (void*)gattClientSetNotificationBatchingNative},
     {"gattClientReadRemoteRssiNative", "(ILjava/lang/String;)V",
      (void*)gattClientReadRemoteRssiNative},
     {"gattClientConfigureMTUNative", "(II)V",
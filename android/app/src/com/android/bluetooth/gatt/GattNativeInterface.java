@@ -18,6 +18,7 @@ package com.android.bluetooth.gatt;
 
 import android.bluetooth.BluetoothDevice;
 import android.os.RemoteException;
+import android.util.Log;
 
 import java.util.ArrayList;
 import java.util.List;
@@ -152,6 +153,19 @@ public class GattNativeInterface {
         getGattService().onNotify(connId, address, handle, isNotify, data);
     }
 
+    void onNotifyBatch(int[] connIds, String[] addresses, int[] handles, byte[][] data)
+            throws RemoteException {
+        GattService service = getGattService();
+        for (int i = 0; i < connIds.length; i++) {
+            try {
+                service.onNotify(connIds[i], addresses[i], handles[i], true, data[i]);
+            } catch (SecurityException e) {
+                // Do not drop the notifications of the other apps of the batch
+                Log.w(TAG, "onNotifyBatch() - " + e);
+            }
+        }
+    }
+
     void onReadCharacteristic(int connId, int status, int handle, byte[] data)
             throws RemoteException {
         getGattService().onReadCharacteristic(connId, status, handle, data);
@@ -335,6 +349,7 @@ public class GattNativeInterface {
     private native void gattClientExecuteWriteNative(int connId, boolean execute);
     private native void gattClientRegisterForNotificationsNative(int clientIf, String address,
             int handle, boolean enable);
+    private native void gattClientSetNotificationBatchingNative(int clientIf, boolean enable);
     private native void gattClientReadRemoteRssiNative(int clientIf, String address);
     private native void gattClientConfigureMTUNative(int connId, int mtu);
     private native void gattConnectionParameterUpdateNative(int clientIf, String address,
@@ -523,6 +538,13 @@ public class GattNativeInterface {
         gattClientRegisterForNotificationsNative(clientIf, address, handle, enable);
     }
 
+    /**
+     * Deliver the notifications of the client in batches
+     */
+    public void gattClientSetNotificationBatching(int clientIf, boolean enable) {
+        gattClientSetNotificationBatchingNative(clientIf, enable);
+    }
+
     /**
      * Read the RSSI for a connected remote device
      * @param clientIf
@@ -2154,6 +2154,10 @@ public class GattService extends ProfileService {
             if (status == 0) {
                 app.id = clientIf;
                 app.linkToDeath(new ClientDeathRecipient(clientIf));
+                if (DeviceConfig.getBoolean(DeviceConfig.NAMESPACE_BLUETOOTH,
+                        "gatt_notification_batching", false)) {
+                    mNativeInterface.gattClientSetNotificationBatching(clientIf, true);
+                }
             } else {
                 mClientMap.remove(uuid);
             }
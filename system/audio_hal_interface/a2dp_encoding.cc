@@ -127,6 +127,23 @@ size_t read(uint8_t* p_buf, uint32_t len) {
   return aidl::a2dp::read(p_buf, len);
 }
 
+bool peek(const uint8_t** p_buf, uint32_t len) {
+  // The HIDL FMQ is only read with a copy
+  if (HalVersionManager::GetHalTransport() ==
+      BluetoothAudioHalTransport::HIDL) {
+    return false;
+  }
+  return aidl::a2dp::peek(p_buf, len);
+}
+
+void release(uint32_t len) {
+  if (HalVersionManager::GetHalTransport() ==
+      BluetoothAudioHalTransport::HIDL) {
+    return;
+  }
+  aidl::a2dp::release(len);
+}
+
 // Update A2DP delay report to BluetoothAudio HAL
 void set_remote_delay(uint16_t delay_report) {
   if (HalVersionManager::GetHalTransport() ==
@@ -56,6 +56,11 @@ void ack_stream_suspended(const tA2DP_CTRL_ACK& status);
 // Read from the FMQ of BluetoothAudio HAL
 size_t read(uint8_t* p_buf, uint32_t len);
 
+// Map contiguous bytes of the FMQ of BluetoothAudio HAL without reading them,
+// and release them once encoded. Returns false when the bytes have to be read.
+bool peek(const uint8_t** p_buf, uint32_t len);
+void release(uint32_t len);
+
 // Update A2DP delay report to BluetoothAudio HAL
 void set_remote_delay(uint16_t delay_report);
 
@@ -281,6 +281,11 @@ size_t read(uint8_t* p_buf, uint32_t len) {
   return bytes_read;
 }
 
+// The UIPC channel can only be read with a copy
+bool peek(const uint8_t** p_buf, uint32_t len) { return false; }
+
+void release(uint32_t len) {}
+
 // Check if OPUS codec is supported
 bool is_opus_supported() { return true; }
 
@@ -554,6 +554,16 @@ size_t read(uint8_t* p_buf, uint32_t len) {
   return active_hal_interface->ReadAudioData(p_buf, len);
 }
 
+bool peek(const uint8_t** p_buf, uint32_t len) {
+  if (!is_hal_enabled() || is_hal_offloading()) return false;
+  return active_hal_interface->PeekAudioData(p_buf, len);
+}
+
+void release(uint32_t len) {
+  if (!is_hal_enabled() || is_hal_offloading()) return;
+  active_hal_interface->ReleaseAudioData(len);
+}
+
 // Update A2DP delay report to BluetoothAudio HAL
 void set_remote_delay(uint16_t delay_report) {
   if (!is_hal_enabled()) {
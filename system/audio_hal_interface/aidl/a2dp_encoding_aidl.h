@@ -76,6 +76,13 @@ void ack_stream_suspended(const tA2DP_CTRL_ACK& status);
  ***/
 size_t read(uint8_t* p_buf, uint32_t len);
 
+/***
+ * Map |len| contiguous bytes of the FMQ of BluetoothAudio HAL without reading
+ * them, and release them once encoded
+ ***/
+bool peek(const uint8_t** p_buf, uint32_t len);
+void release(uint32_t len);
+
 /***
  * Update A2DP delay report to BluetoothAudio HAL
  ***/
@@ -20,6 +20,10 @@
 
 #include <android/binder_manager.h>
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 namespace bluetooth {
 namespace audio {
 namespace aidl {
@@ -49,11 +53,62 @@ BluetoothAudioClientInterface::BluetoothAudioClientInterface(
       provider_factory_(nullptr),
       session_started_(false),
       data_mq_(nullptr),
+      data_mq_event_flag_(nullptr),
+      data_mq_event_flag_woken_(false),
       transport_(instance) {
   death_recipient_ = ::ndk::ScopedAIBinder_DeathRecipient(
       AIBinder_DeathRecipient_new(binderDiedCallbackAidl));
 }
 
+BluetoothAudioClientInterface::~BluetoothAudioClientInterface() {
+  ResetDataMq(nullptr);
+}
+
+void BluetoothAudioClientInterface::ResetDataMq(
+    std::unique_ptr<DataMQ> data_mq) {
+  if (data_mq_event_flag_ != nullptr) {
+    EventFlag::deleteEventFlag(&data_mq_event_flag_);
+    data_mq_event_flag_ = nullptr;
+  }
+  data_mq_event_flag_woken_ = false;
+  data_mq_ = std::move(data_mq);
+
+  if (data_mq_ == nullptr || data_mq_->getEventFlagWord() == nullptr) return;
+  if (EventFlag::createEventFlag(data_mq_->getEventFlagWord(),
+                                 &data_mq_event_flag_) != ::android::OK) {
+    LOG(WARNING) << __func__ << ": failed to create the event flag";
+    data_mq_event_flag_ = nullptr;
+  }
+}
+
+int BluetoothAudioClientInterface::WaitDataMq(uint32_t bits, int timeout_ms,
+                                              int poll_interval_ms) {
+  if (data_mq_event_flag_ == nullptr) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(poll_interval_ms));
+    return poll_interval_ms;
+  }
+
+  int wait_ms = data_mq_event_flag_woken_ ? timeout_ms : poll_interval_ms;
+  auto start = std::chrono::steady_clock::now();
+  uint32_t state = 0;
+  if (data_mq_event_flag_->wait(bits, &state,
+                                std::chrono::nanoseconds(
+                                    std::chrono::milliseconds(wait_ms))
+                                    .count()) == ::android::OK &&
+      (state & bits) != 0) {
+    data_mq_event_flag_woken_ = true;
+  }
+  int waited_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  // Count at least 1 ms, so that spurious wakes cannot loop forever
+  return std::max(waited_ms, 1);
+}
+
+void BluetoothAudioClientInterface::WakeDataMq(uint32_t bits) {
+  if (data_mq_event_flag_ != nullptr) data_mq_event_flag_->wake(bits);
+}
+
 bool BluetoothAudioClientInterface::is_aidl_available() {
   return AServiceManager_isDeclared(
       kDefaultAudioProviderFactoryInterface.c_str());
@@ -320,7 +375,7 @@ int BluetoothAudioClientInterface::StartSession() {
   data_mq.reset(new DataMQ(mq_desc));
 
   if (data_mq && data_mq->isValid()) {
-    data_mq_ = std::move(data_mq);
+    ResetDataMq(std::move(data_mq));
   } else if (transport_->GetSessionType() ==
                  SessionType::A2DP_HARDWARE_OFFLOAD_ENCODING_DATAPATH ||
              transport_->GetSessionType() ==
@@ -402,7 +457,7 @@ int BluetoothAudioClientInterface::EndSession() {
     LOG(ERROR) << __func__ << ": BluetoothAudioHal nullptr";
     return -EINVAL;
   }
-  data_mq_ = nullptr;
+  ResetDataMq(nullptr);
 
   auto aidl_retval = provider_->endSession();
 
@@ -434,6 +489,7 @@ void BluetoothAudioClientInterface::FlushAudioData() {
   if (data_mq_->read(buffer.data(), size) != size) {
     LOG(WARNING) << __func__ << ", failed to flush data queue!";
   }
+  WakeDataMq(kDataMqNotFull);
 }
 
 size_t BluetoothAudioSinkClientInterface::ReadAudioData(uint8_t* p_buf,
@@ -462,10 +518,10 @@ size_t BluetoothAudioSinkClientInterface::ReadAudioData(uint8_t* p_buf,
         break;
       }
       total_read += avail_to_read;
+      WakeDataMq(kDataMqNotFull);
     } else if (timeout_ms >= kDefaultDataReadPollIntervalMs) {
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(kDefaultDataReadPollIntervalMs));
-      timeout_ms -= kDefaultDataReadPollIntervalMs;
+      timeout_ms -= WaitDataMq(kDataMqNotEmpty, timeout_ms,
+                               kDefaultDataReadPollIntervalMs);
       continue;
     } else {
       LOG(WARNING) << __func__ << ": " << (len - total_read) << "/" << len
@@ -488,6 +544,35 @@ size_t BluetoothAudioSinkClientInterface::ReadAudioData(uint8_t* p_buf,
   return total_read;
 }
 
+bool BluetoothAudioSinkClientInterface::PeekAudioData(const uint8_t** p_buf,
+                                                      uint32_t len) {
+  if (!IsValid() || p_buf == nullptr || len == 0) return false;
+
+  std::lock_guard<std::mutex> guard(internal_mutex_);
+  if (data_mq_ == nullptr || !data_mq_->isValid()) return false;
+
+  DataMQ::MemTransaction transaction;
+  if (!data_mq_->beginRead(len, &transaction)) return false;
+  // Data wrapping around the end of the ring is read with a copy
+  auto region = transaction.getFirstRegion();
+  if (region.getLength() < len) return false;
+
+  *p_buf = reinterpret_cast<const uint8_t*>(region.getAddress());
+  return true;
+}
+
+void BluetoothAudioSinkClientInterface::ReleaseAudioData(uint32_t len) {
+  std::lock_guard<std::mutex> guard(internal_mutex_);
+  if (data_mq_ == nullptr || !data_mq_->isValid()) return;
+
+  if (!data_mq_->commitRead(len)) {
+    LOG(WARNING) << __func__ << ": len=" << len << " failed";
+    return;
+  }
+  WakeDataMq(kDataMqNotFull);
+  sink_->LogBytesRead(len);
+}
+
 void BluetoothAudioClientInterface::RenewAudioProviderAndSession() {
   // NOTE: must be invoked on the same thread where this
   // BluetoothAudioClientInterface is running
@@ -529,10 +614,10 @@ size_t BluetoothAudioSourceClientInterface::WriteAudioData(const uint8_t* p_buf,
         break;
       }
       total_written += avail_to_write;
+      WakeDataMq(kDataMqNotEmpty);
     } else if (timeout_ms >= kDefaultDataWritePollIntervalMs) {
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(kDefaultDataWritePollIntervalMs));
-      timeout_ms -= kDefaultDataWritePollIntervalMs;
+      timeout_ms -= WaitDataMq(kDataMqNotFull, timeout_ms,
+                               kDefaultDataWritePollIntervalMs);
       continue;
     } else {
       LOG(WARNING) << __func__ << ": " << (len - total_written) << "/" << len
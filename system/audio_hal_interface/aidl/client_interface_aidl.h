@@ -17,6 +17,7 @@
 #pragma once
 
 #include <fmq/AidlMessageQueue.h>
+#include <fmq/EventFlag.h>
 #include <hardware/audio.h>
 
 #include <ctime>
@@ -49,6 +50,7 @@ using ::aidl::android::hardware::bluetooth::audio::PcmConfiguration;
 using ::aidl::android::hardware::common::fmq::MQDescriptor;
 using ::aidl::android::hardware::common::fmq::SynchronizedReadWrite;
 using ::android::AidlMessageQueue;
+using ::android::hardware::EventFlag;
 
 using MqDataType = int8_t;
 using MqDataMode = SynchronizedReadWrite;
@@ -63,7 +65,7 @@ using DataMQDesc = MQDescriptor<MqDataType, MqDataMode>;
 class BluetoothAudioClientInterface {
  public:
   BluetoothAudioClientInterface(IBluetoothTransportInstance* instance);
-  virtual ~BluetoothAudioClientInterface() = default;
+  virtual ~BluetoothAudioClientInterface();
 
   bool IsValid() const { return provider_ != nullptr; }
 
@@ -107,12 +109,32 @@ class BluetoothAudioClientInterface {
    ***/
   static void binderDiedCallbackAidl(void* cookie_ptr);
 
+  /***
+   * Wait for the other end of the fmq to set |bits| in its event flag, for at
+   * most |timeout_ms|, and return the time waited. Until the other end is
+   * seen waking the flag, it may only poll the fmq: the wait is then cut to
+   * |poll_interval_ms|, so that the data is not noticed later than by polling.
+   ***/
+  int WaitDataMq(uint32_t bits, int timeout_ms, int poll_interval_ms);
+
+  /***
+   * Wake the other end of the fmq, if it waits for |bits|
+   ***/
+  void WakeDataMq(uint32_t bits);
+
+  // Same bits as the blocking reads and writes of libfmq
+  static constexpr uint32_t kDataMqNotEmpty = 1 << 0;
+  static constexpr uint32_t kDataMqNotFull = 1 << 1;
+
   std::shared_ptr<IBluetoothAudioProvider> provider_;
 
   std::shared_ptr<IBluetoothAudioProviderFactory> provider_factory_;
 
   bool session_started_;
   std::unique_ptr<DataMQ> data_mq_;
+  // Event flag of data_mq_, when the provider configured one
+  EventFlag* data_mq_event_flag_;
+  bool data_mq_event_flag_woken_;
 
   ::ndk::ScopedAIBinder_DeathRecipient death_recipient_;
   // static constexpr const char* kDefaultAudioProviderFactoryInterface =
@@ -121,6 +143,8 @@ class BluetoothAudioClientInterface {
       std::string() + IBluetoothAudioProviderFactory::descriptor + "/default";
 
  private:
+  void ResetDataMq(std::unique_ptr<DataMQ> data_mq);
+
   IBluetoothTransportInstance* transport_;
   std::vector<AudioCapabilities> capabilities_;
   bool is_low_latency_allowed_{false};
@@ -152,6 +176,14 @@ class BluetoothAudioSinkClientInterface : public BluetoothAudioClientInterface {
    ***/
   size_t ReadAudioData(uint8_t* p_buf, uint32_t len);
 
+  /***
+   * Map |len| bytes of the fmq without reading them, when they are all
+   * available and contiguous. The bytes must be released with
+   * ReleaseAudioData() once consumed.
+   ***/
+  bool PeekAudioData(const uint8_t** p_buf, uint32_t len);
+  void ReleaseAudioData(uint32_t len);
+
  private:
   IBluetoothSinkTransportInstance* sink_;
 
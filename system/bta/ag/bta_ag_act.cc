@@ -200,6 +200,12 @@ void bta_ag_start_open(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {
   /* set role */
   p_scb->role = BTA_AG_INT;
 
+  /* reconnect to the cached scn, the service search is done once connected */
+  if (bta_ag_sdp_cache_find(p_scb)) {
+    bta_ag_rfc_do_open(p_scb, data);
+    return;
+  }
+
   /* do service search */
   bta_ag_do_disc(p_scb, p_scb->open_services);
 }
@@ -284,6 +290,7 @@ void bta_ag_disc_acp_res(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {
         p_scb->peer_addr, IOT_CONF_KEY_HFP_VERSION, p_scb->peer_version,
         IOT_CONF_BYTE_NUM_2);
   }
+  p_scb->sdp_cache_used = false;
 
   /* free discovery db */
   bta_ag_free_db(p_scb, data);
@@ -350,6 +357,7 @@ void bta_ag_rfc_fail(tBTA_AG_SCB* p_scb, UNUSED_ATTR const tBTA_AG_DATA& data) {
   p_scb->sco_codec = BTM_SCO_CODEC_CVSD;
   p_scb->role = 0;
   p_scb->svc_conn = false;
+  p_scb->sdp_cache_used = false;
   p_scb->hsp_version = HSP_VERSION_1_2;
   /*Clear the BD address*/
   p_scb->peer_addr = RawAddress::kEmpty;
@@ -390,6 +398,7 @@ void bta_ag_rfc_close(tBTA_AG_SCB* p_scb,
   p_scb->codec_lc3_settings = BTA_AG_SCO_LC3_SETTINGS_T2;
   p_scb->role = 0;
   p_scb->svc_conn = false;
+  p_scb->sdp_cache_used = false;
   p_scb->hsp_version = HSP_VERSION_1_2;
   bta_ag_at_reinit(&p_scb->at_cb);
 
@@ -510,6 +519,11 @@ void bta_ag_rfc_open(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {
   p_scb->at_cb.cmd_max_len = BTA_AG_CMD_MAX;
   bta_ag_at_init(&p_scb->at_cb);
 
+  /* the peer was reconnected to the cached scn, refresh its features */
+  if (p_scb->sdp_cache_used) {
+    bta_ag_do_disc(p_scb, bta_ag_svc_mask[p_scb->conn_service]);
+  }
+
   bta_sys_conn_open(BTA_ID_AG, p_scb->app_id, p_scb->peer_addr);
 
   bta_ag_cback_open(p_scb, p_scb->peer_addr, BTA_AG_SUCCESS);
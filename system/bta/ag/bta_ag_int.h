@@ -41,6 +41,11 @@
 #define BTA_AG_COLLISION_TIMEOUT_MS (2 * 1000) /* 2 seconds */
 #endif
 
+/* How long the RFCOMM channel found by SDP is reused to reconnect a peer */
+#ifndef BTA_AG_SDP_CACHE_TIMEOUT_S
+#define BTA_AG_SDP_CACHE_TIMEOUT_S (7 * 24 * 60 * 60) /* 7 days */
+#endif
+
 /* RFCOMM MTU SIZE */
 #define BTA_AG_MTU 256
 
@@ -233,6 +238,7 @@ struct tBTA_AG_SCB {
   bool cmee_enabled;        /* set to true if HF enables CME ERROR reporting */
   bool inband_enabled;      /* set to true if inband ring enabled */
   bool svc_conn;            /* set to true when service level connection up */
+  bool sdp_cache_used;      /* connecting to the cached scn, SDP deferred */
   uint8_t state;            /* state machine state */
   uint8_t conn_service;     /* connected service */
   uint8_t peer_scn;         /* peer scn */
@@ -354,6 +360,9 @@ void bta_ag_del_records(tBTA_AG_SCB* p_scb);
 bool bta_ag_sdp_find_attr(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service);
 void bta_ag_do_disc(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service);
 void bta_ag_free_db(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data);
+bool bta_ag_sdp_cache_find(tBTA_AG_SCB* p_scb);
+void bta_ag_sdp_cache_update(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service);
+bool bta_ag_sdp_cache_retry(tBTA_AG_SCB* p_scb);
 
 /* RFCOMM functions */
 void bta_ag_start_servers(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK services);
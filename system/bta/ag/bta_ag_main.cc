@@ -152,6 +152,7 @@ static tBTA_AG_SCB* bta_ag_scb_alloc(void) {
       p_scb->peer_version = HFP_HSP_VERSION_UNKNOWN;
       p_scb->hsp_version = HSP_VERSION_1_2;
       p_scb->peer_sdp_features = 0;
+      p_scb->sdp_cache_used = false;
       /* set up timers */
       p_scb->ring_timer = alarm_new("bta_ag.scb_ring_timer");
       p_scb->collision_timer = alarm_new("bta_ag.scb_collision_timer");
@@ -596,6 +597,9 @@ static void bta_ag_better_state_machine(tBTA_AG_SCB* p_scb, uint16_t event,
           bta_ag_sco_listen(p_scb, data);
           break;
         case BTA_AG_RFC_CLOSE_EVT:
+          if (p_scb->sdp_cache_used && bta_ag_sdp_cache_retry(p_scb)) {
+            break;
+          }
           p_scb->state = BTA_AG_INIT_ST;
           bta_ag_rfc_fail(p_scb, data);
           break;
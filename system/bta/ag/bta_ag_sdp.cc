@@ -27,6 +27,8 @@
 #include <base/location.h>
 #include <base/logging.h>
 
+#include <ctime>
+
 #include "bt_target.h"  // Legacy stack config
 #include "bt_trace.h"   // Legacy trace logging
 #include "bta/ag/bta_ag_int.h"
@@ -37,9 +39,11 @@
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "stack/btm/btm_sco_hfp_hal.h"
+#include "stack/include/acl_api.h"
 #include "stack/include/btm_api.h"
 #include "stack/include/btu.h"  // do_in_main_thread
 #include "stack/include/port_api.h"
+#include "stack/include/rfcdefs.h"
 #include "types/bluetooth/uuid.h"
 
 using bluetooth::Uuid;
@@ -84,8 +88,9 @@ static void bta_ag_sdp_cback(uint16_t status, uint8_t idx) {
   tBTA_AG_SCB* p_scb = bta_ag_scb_by_idx(idx);
   if (p_scb) {
     uint16_t event;
-    /* set event according to int/acp */
-    if (p_scb->role == BTA_AG_ACP) {
+    /* set event according to int/acp, the discovery deferred after a
+     * connection to the cached scn completes like the acceptor one */
+    if (p_scb->role == BTA_AG_ACP || p_scb->sdp_cache_used) {
       event = BTA_AG_DISC_ACP_RES_EVT;
     } else {
       event = BTA_AG_DISC_INT_RES_EVT;
@@ -434,6 +439,10 @@ bool bta_ag_sdp_find_attr(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service) {
     result = true;
     break;
   }
+
+  if (result && p_scb->role == BTA_AG_INT) {
+    bta_ag_sdp_cache_update(p_scb, service);
+  }
   return result;
 }
 
@@ -542,3 +551,108 @@ void bta_ag_do_disc(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service) {
 void bta_ag_free_db(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {
   osi_free_and_reset((void**)&p_scb->p_disc_db);
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_sdp_cache_find
+ *
+ * Description      Look up the RFCOMM channel found by the last discovery of
+ *                  the peer, so that a reconnection does not wait for SDP.
+ *                  The cached channel is only used if it is for one of the
+ *                  services to open and if it is not older than
+ *                  BTA_AG_SDP_CACHE_TIMEOUT_S.
+ *
+ *
+ * Returns          true if p_scb->peer_scn and p_scb->conn_service are set
+ *                  from the cache, false otherwise.
+ *
+ ******************************************************************************/
+bool bta_ag_sdp_cache_find(tBTA_AG_SCB* p_scb) {
+  const std::string section = p_scb->peer_addr.ToString();
+  int scn = 0;
+  int service = 0;
+  uint64_t timestamp = 0;
+  if (!btif_config_get_int(section, HFP_PEER_SCN_CONFIG_KEY, &scn) ||
+      !btif_config_get_int(section, HFP_PEER_SERVICE_CONFIG_KEY, &service) ||
+      !btif_config_get_uint64(section, HFP_PEER_SCN_TIMESTAMP_CONFIG_KEY,
+                              &timestamp)) {
+    return false;
+  }
+
+  uint64_t now = static_cast<uint64_t>(time(nullptr));
+  if (timestamp > now || now - timestamp > BTA_AG_SDP_CACHE_TIMEOUT_S) {
+    LOG_DEBUG("Cached scn of %s expired",
+              ADDRESS_TO_LOGGABLE_CSTR(p_scb->peer_addr));
+    return false;
+  }
+  if (scn == 0 || scn >= PORT_MAX_RFC_PORTS || service < 0 ||
+      service >= BTA_AG_NUM_IDX ||
+      !(p_scb->open_services &
+        ((tBTA_SERVICE_MASK)1 << (BTA_HSP_SERVICE_ID + service)))) {
+    return false;
+  }
+
+  LOG_INFO("Reconnecting %s to cached scn %d, service %d",
+           ADDRESS_TO_LOGGABLE_CSTR(p_scb->peer_addr), scn, service);
+  p_scb->peer_scn = static_cast<uint8_t>(scn);
+  p_scb->conn_service = static_cast<uint8_t>(service);
+  p_scb->sdp_cache_used = true;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_sdp_cache_update
+ *
+ * Description      Store the RFCOMM channel of the peer found by discovery
+ *                  for the given service.
+ *
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_ag_sdp_cache_update(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service) {
+  const std::string section = p_scb->peer_addr.ToString();
+  if (!btif_config_set_int(section, HFP_PEER_SCN_CONFIG_KEY,
+                           p_scb->peer_scn) ||
+      !btif_config_set_int(section, HFP_PEER_SERVICE_CONFIG_KEY,
+                           bta_ag_service_to_idx(service)) ||
+      !btif_config_set_uint64(section, HFP_PEER_SCN_TIMESTAMP_CONFIG_KEY,
+                              static_cast<uint64_t>(time(nullptr)))) {
+    LOG_WARN("Failed to store scn of %s",
+             ADDRESS_TO_LOGGABLE_CSTR(p_scb->peer_addr));
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_sdp_cache_retry
+ *
+ * Description      Handle the failure of a connection to the cached RFCOMM
+ *                  channel. The cached channel is dropped, and if the peer
+ *                  is still connected, the channel may just be stale and a
+ *                  discovery is started to find the current one.
+ *
+ *
+ * Returns          true if the connection goes on with a discovery, false if
+ *                  it failed.
+ *
+ ******************************************************************************/
+bool bta_ag_sdp_cache_retry(tBTA_AG_SCB* p_scb) {
+  const std::string section = p_scb->peer_addr.ToString();
+  btif_config_remove(section, HFP_PEER_SCN_CONFIG_KEY);
+  btif_config_remove(section, HFP_PEER_SERVICE_CONFIG_KEY);
+  btif_config_remove(section, HFP_PEER_SCN_TIMESTAMP_CONFIG_KEY);
+  p_scb->sdp_cache_used = false;
+
+  if (!BTM_IsAclConnectionUp(p_scb->peer_addr, BT_TRANSPORT_BR_EDR)) {
+    return false;
+  }
+
+  LOG_INFO("Cached scn of %s failed, discovering it again",
+           ADDRESS_TO_LOGGABLE_CSTR(p_scb->peer_addr));
+  p_scb->conn_handle = 0;
+  p_scb->conn_service = 0;
+  bta_ag_do_disc(p_scb, p_scb->open_services);
+  return true;
+}
@@ -477,10 +477,9 @@ void bta_av_sink_data_cback(uint8_t handle, BT_HDR* p_pkt, uint32_t time_stamp,
     return;
   }
   p_pkt->event = BTA_AV_SINK_MEDIA_DATA_EVT;
+  /* The application takes the ownership of the packet */
   p_scb->seps[p_scb->sep_idx].p_app_sink_data_cback(
       p_scb->PeerAddress(), BTA_AV_SINK_MEDIA_DATA_EVT, (tBTA_AV_MEDIA*)p_pkt);
-  /* Free the buffer: a copy of the packet has been delivered */
-  osi_free(p_pkt);
 }
 
 /*******************************************************************************
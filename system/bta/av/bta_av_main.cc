@@ -24,6 +24,7 @@
 
 #define LOG_TAG "bt_bta_av"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "bt_target.h"  // Must be first to define build configuration
@@ -38,6 +39,7 @@
 #include "osi/include/log.h"
 #include "osi/include/osi.h"  // UNUSED_ATTR
 #include "osi/include/properties.h"
+#include "stack/include/a2dp_codec_api.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btm_api.h"
@@ -1057,7 +1059,9 @@ bool bta_av_link_role_ok(tBTA_AV_SCB* p_scb, uint8_t bits) {
  * Function         bta_av_dup_audio_buf
  *
  * Description      dup the audio data to the q_info.a2dp of other audio
- *                  channels
+ *                  channels using the same codec configuration, so that the
+ *                  audio is encoded once for all of them. Each channel drops
+ *                  its own oldest packets when it falls behind.
  *
  * Returns          void
  *
@@ -1075,13 +1079,20 @@ void bta_av_dup_audio_buf(tBTA_AV_SCB* p_scb, BT_HDR* p_buf) {
       continue; /* Ignore if SCB is not used or started */
     if (!(bta_av_cb.conn_audio & BTA_AV_HNDL_TO_MSK(i)))
       continue; /* Audio is not connected */
+    if (!A2DP_CodecEquals(p_scbi->cfg.codec_info, p_scb->cfg.codec_info))
+      continue; /* The channel encodes its own audio */
 
-    /* Enqueue the data */
+    /* Enqueue the data. The buffers are consumed by AVDTP, each channel
+     * needs its own copy. */
     BT_HDR* p_new = (BT_HDR*)osi_malloc(copy_size);
     memcpy(p_new, p_buf, copy_size);
     list_append(p_scbi->a2dp_list, p_new);
 
-    if (list_length(p_scbi->a2dp_list) > p_bta_av_cfg->audio_mqs) {
+    /* A congested channel keeps only half of the queue, so that it does not
+     * lag behind the other channels once the congestion clears */
+    size_t max_len = p_bta_av_cfg->audio_mqs;
+    if (p_scbi->cong) max_len = std::max<size_t>(max_len / 2, 1);
+    while (list_length(p_scbi->a2dp_list) > max_len) {
       // Drop the oldest packet
       bta_av_co_audio_drop(p_scbi->hndl, p_scbi->PeerAddress());
       BT_HDR* p_buf_drop = static_cast<BT_HDR*>(list_front(p_scbi->a2dp_list));
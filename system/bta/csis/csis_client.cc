@@ -68,6 +68,12 @@ using bluetooth::groups::DeviceGroupsCallbacks;
 namespace {
 class CsisClientImpl;
 CsisClientImpl* instance;
+
+/* When set, the lock requests of a set are written to all its connected
+ * members at once, still issued in rank order, rather than one member after
+ * the response of the previous one. */
+static constexpr char kCsisParallelLockProperty[] =
+    "bluetooth.csis.parallel_lock.enabled";
 std::mutex instance_mutex;
 DeviceGroupsCallbacks* device_group_callbacks;
 
@@ -110,7 +116,10 @@ class CsisClientImpl : public CsisClient {
  public:
   CsisClientImpl(bluetooth::csis::CsisClientCallbacks* callbacks,
                  Closure initCb)
-      : gatt_if_(0), callbacks_(callbacks) {
+      : gatt_if_(0),
+        callbacks_(callbacks),
+        parallel_lock_(
+            osi_property_get_bool(kCsisParallelLockProperty, false)) {
     BTA_GATTC_AppRegister(
         [](tBTA_GATTC_EVT event, tBTA_GATTC* p_data) {
           if (instance && p_data) instance->GattcCallback(event, p_data);
@@ -300,16 +309,19 @@ class CsisClientImpl : public CsisClient {
     csis_group->SetTargetLockState(CsisLockState::CSIS_STATE_UNSET);
 
     int group_id = csis_group->GetGroupId();
-    /* Send unlock to previous devices. It shall be done in reverse order. */
-    auto prev_dev = csis_group->GetPrevDevice(csis_device);
-    while (prev_dev) {
+    /* Send unlock to previous devices. It shall be done in reverse order. With
+     * parallel lock requests, the members ranked after |csis_device| were
+     * asked for the lock as well, and their unlock is queued after it. */
+    auto prev_dev = parallel_lock_ ? csis_group->GetLastDevice()
+                                   : csis_group->GetPrevDevice(csis_device);
+    for (; prev_dev; prev_dev = csis_group->GetPrevDevice(prev_dev)) {
+      if (prev_dev == csis_device) continue;
       if (prev_dev->IsConnected()) {
         auto prev_csis_instance = prev_dev->GetCsisInstanceByGroupId(group_id);
         LOG_ASSERT(prev_csis_instance) << " prev_csis_instance does not exist!";
         SetLock(prev_dev, prev_csis_instance,
                 CsisLockState::CSIS_STATE_UNLOCKED);
       }
-      prev_dev = csis_group->GetPrevDevice(prev_dev);
     }
     /* Call application callback */
     NotifyGroupStatus(group_id, false, status, std::move(cb));
@@ -378,11 +390,14 @@ class CsisClientImpl : public CsisClient {
       return;
     }
 
+    /* All the members were already asked for the lock */
+    if (parallel_lock_) return;
+
     if (target_lock_state == CsisLockState::CSIS_STATE_LOCKED) {
-      std::shared_ptr<CsisDevice> next_dev;
+      std::shared_ptr<CsisDevice> next_dev = device;
 
       do {
-        next_dev = csis_group->GetNextDevice(device);
+        next_dev = csis_group->GetNextDevice(next_dev);
         if (!next_dev) break;
       } while (!next_dev->IsConnected());
 
@@ -516,9 +531,24 @@ class CsisClientImpl : public CsisClient {
         csis_device = csis_group->GetNextDevice(csis_device);
       }
 
-      auto csis_instance = csis_device->GetCsisInstanceByGroupId(group_id);
-      LOG_ASSERT(csis_instance) << " csis_instance does not exist!";
-      SetLock(csis_device, csis_instance, new_lock_state);
+      if (!parallel_lock_) {
+        auto csis_instance = csis_device->GetCsisInstanceByGroupId(group_id);
+        LOG_ASSERT(csis_instance) << " csis_instance does not exist!";
+        SetLock(csis_device, csis_instance, new_lock_state);
+        return;
+      }
+
+      /* With parallel lock requests, a request is written to each connected
+       * member in rank order right away. The GATT queues of the members are
+       * independent, so the locking takes about the time of one request
+       * whatever the size of the set. The first failure aborts it. */
+      for (; csis_device;
+           csis_device = csis_group->GetNextDevice(csis_device)) {
+        if (!csis_device->IsConnected()) continue;
+        auto csis_instance = csis_device->GetCsisInstanceByGroupId(group_id);
+        LOG_ASSERT(csis_instance) << " csis_instance does not exist!";
+        SetLock(csis_device, csis_instance, new_lock_state);
+      }
     } else {
       /* For unlocking, we don't have to monitor status of unlocking device,
        * therefore, we can just send unlock to all of them, in oposite rank
@@ -2060,6 +2090,7 @@ class CsisClientImpl : public CsisClient {
   std::list<std::shared_ptr<CsisGroup>> csis_groups_;
   DeviceGroups* dev_groups_;
   int discovering_group_ = bluetooth::groups::kGroupUnknown;
+  bool parallel_lock_;
 };
 
 class DeviceGroupsCallbacksImpl : public DeviceGroupsCallbacks {
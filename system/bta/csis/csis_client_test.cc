@@ -29,6 +29,7 @@
 #include "csis_types.h"
 #include "gatt/database_builder.h"
 #include "hardware/bt_gatt_types.h"
+#include "osi/include/properties.h"
 #include "test/common/mock_functions.h"
 
 namespace bluetooth {
@@ -877,6 +878,123 @@ TEST_F(CsisClientTest, test_get_set_sirk) {
   ASSERT_EQ(g_1->GetSirk(), sirk);
 }
 
+TEST_F(CsisClientTest, test_rsi_matching_sirk_change) {
+  auto g_1 = std::make_shared<CsisGroup>(666, bluetooth::Uuid::kEmpty);
+  Octet16 sirk = {1};
+  g_1->SetSirk(sirk);
+
+  /* RSI = hash(sirk, prand) || prand, most significant byte first */
+  uint8_t prand[3] = {0x2c, 0x4b, 0x5a};
+  Octet16 hash = crypto_toolbox::aes_128(sirk, prand, 3);
+  RawAddress rsi;
+  rsi.address[0] = prand[2];
+  rsi.address[1] = prand[1];
+  rsi.address[2] = prand[0];
+  rsi.address[3] = hash[2];
+  rsi.address[4] = hash[1];
+  rsi.address[5] = hash[0];
+
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+
+  Octet16 other_sirk = {2};
+  g_1->SetSirk(other_sirk);
+  ASSERT_FALSE(g_1->IsRsiMatching(rsi));
+
+  g_1->SetSirk(sirk);
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+}
+
+class CsisParallelLockTest : public CsisClientTest {
+ protected:
+  void SetUp(void) override {
+    osi_property_set("bluetooth.csis.parallel_lock.enabled", "true");
+    CsisClientTest::SetUp();
+  }
+
+  void TearDown(void) override {
+    CsisClientTest::TearDown();
+    osi_property_set("bluetooth.csis.parallel_lock.enabled", "false");
+  }
+};
+
+TEST_F(CsisParallelLockTest, test_lock_denied_releases_other_members) {
+  SetSampleDatabaseCsis(1, 1);
+  SetSampleDatabaseCsis(2, 2);
+  SetSampleDatabaseCsis(3, 3);
+
+  TestAppRegister();
+  for (uint16_t conn_id = 1; conn_id <= 3; conn_id++) {
+    TestConnect(GetTestAddress(conn_id));
+    InjectConnectedEvent(GetTestAddress(conn_id), conn_id);
+    GetSearchCompleteEvent(conn_id);
+    ASSERT_EQ(1, CsisClient::Get()->GetGroupId(
+                     GetTestAddress(conn_id),
+                     bluetooth::Uuid::From16Bit(0x0000)));
+  }
+
+  /* Hold the write responses back, to see which writes are sent at once */
+  struct LockWrite {
+    uint16_t conn_id;
+    uint16_t handle;
+    uint8_t value;
+    GATT_WRITE_OP_CB cb;
+    void* cb_data;
+  };
+  std::vector<LockWrite> writes;
+  ON_CALL(gatt_queue, WriteCharacteristic(_, _, _, _, _, _))
+      .WillByDefault(
+          Invoke([&writes](uint16_t conn_id, uint16_t handle,
+                           std::vector<uint8_t> value,
+                           tGATT_WRITE_TYPE write_type, GATT_WRITE_OP_CB cb,
+                           void* cb_data) {
+            writes.push_back({conn_id, handle, value[0], cb, cb_data});
+          }));
+  auto respond = [](LockWrite write, tGATT_STATUS status) {
+    write.cb(write.conn_id, status, write.handle, 1, &write.value,
+             write.cb_data);
+  };
+
+  CsisClient::Get()->LockGroup(
+      1, true,
+      base::BindOnce([](int group_id, bool locked, CsisGroupLockStatus status) {
+        csis_lock_callback_mock->CsisGroupLockCb(group_id, locked, status);
+      }));
+
+  /* All the members are asked for the lock, in rank order */
+  ASSERT_EQ(3u, writes.size());
+  for (uint16_t i = 0; i < 3; i++) {
+    ASSERT_EQ(i + 1, writes[i].conn_id);
+    ASSERT_EQ((uint8_t)CsisLockState::CSIS_STATE_LOCKED, writes[i].value);
+  }
+
+  EXPECT_CALL(*callbacks, OnGroupLockChanged(
+                              1, false, CsisGroupLockStatus::FAILED_LOCKED_BY_OTHER))
+      .Times(1);
+  EXPECT_CALL(*csis_lock_callback_mock,
+              CsisGroupLockCb(1, false,
+                              CsisGroupLockStatus::FAILED_LOCKED_BY_OTHER))
+      .Times(1);
+  respond(writes[0], GATT_SUCCESS);
+  respond(writes[1], (tGATT_STATUS)kCsisErrorCodeLockDenied);
+
+  /* The other members are released in reverse rank order */
+  ASSERT_EQ(5u, writes.size());
+  ASSERT_EQ(3, writes[3].conn_id);
+  ASSERT_EQ((uint8_t)CsisLockState::CSIS_STATE_UNLOCKED, writes[3].value);
+  ASSERT_EQ(1, writes[4].conn_id);
+  ASSERT_EQ((uint8_t)CsisLockState::CSIS_STATE_UNLOCKED, writes[4].value);
+
+  /* A lock granted after the abort does not complete it */
+  respond(writes[2], GATT_SUCCESS);
+  respond(writes[3], GATT_SUCCESS);
+  respond(writes[4], GATT_SUCCESS);
+  Mock::VerifyAndClearExpectations(callbacks.get());
+  Mock::VerifyAndClearExpectations(csis_lock_callback_mock);
+
+  TestAppUnregister();
+}
+
 class CsisMultiClientTest : public CsisClientTest {
  protected:
   const RawAddress test_address_1 = GetTestAddress(1);
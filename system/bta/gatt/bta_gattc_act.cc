@@ -29,6 +29,8 @@
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
+
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/gatt/bta_gattc_int.h"
 #include "bta/hh/bta_hh_int.h"
@@ -42,6 +44,7 @@
 #include "osi/include/log.h"
 #include "osi/include/osi.h"  // UNUSED_ATTR
 #include "stack/include/bt_hdr.h"
+#include "stack/include/bt_types.h"
 #include "stack/include/btm_ble_api_types.h"
 #include "stack/include/btu.h"  // do_in_main_thread
 #include "stack/include/l2c_api.h"
@@ -797,9 +800,19 @@ void bta_gattc_start_discover_internal(tBTA_GATTC_CLCB* p_clcb) {
   if (p_clcb->transport == BT_TRANSPORT_LE)
     L2CA_EnableUpdateBleConnParams(p_clcb->p_srcb->server_bda, false);
 
-  bta_gattc_init_cache(p_clcb->p_srcb);
-  p_clcb->status = bta_gattc_discover_pri_service(
-      p_clcb->bta_conn_id, p_clcb->p_srcb, GATT_DISC_SRVC_ALL);
+  bta_gattc_init_discovery_range(p_clcb->p_srcb, p_clcb->transport);
+  if (p_clcb->p_srcb->disc_s_handle != 0) {
+    /* keep the cached services outside of the range */
+    p_clcb->p_srcb->pending_discovery.Clear();
+    p_clcb->status =
+        GATTC_Discover(p_clcb->bta_conn_id, GATT_DISC_SRVC_ALL,
+                       p_clcb->p_srcb->disc_s_handle,
+                       p_clcb->p_srcb->disc_e_handle);
+  } else {
+    bta_gattc_init_cache(p_clcb->p_srcb);
+    p_clcb->status = bta_gattc_discover_pri_service(
+        p_clcb->bta_conn_id, p_clcb->p_srcb, GATT_DISC_SRVC_ALL);
+  }
   if (p_clcb->status != GATT_SUCCESS) {
     LOG(ERROR) << "discovery on server failed";
     bta_gattc_reset_discover_st(p_clcb->p_srcb, p_clcb->status);
@@ -813,8 +826,8 @@ void bta_gattc_start_discover(tBTA_GATTC_CLCB* p_clcb,
   VLOG(1) << __func__ << ": conn_id:" << loghex(p_clcb->bta_conn_id)
           << " p_clcb->p_srcb->state:" << +p_clcb->p_srcb->state;
 
-  if (((p_clcb->p_q_cmd == NULL ||
-        p_clcb->auto_update == BTA_GATTC_REQ_WAITING) &&
+  if ((((p_clcb->p_q_cmd == NULL && p_clcb->p_q_cmd_parallel.empty()) ||
+         p_clcb->auto_update == BTA_GATTC_REQ_WAITING) &&
        p_clcb->p_srcb->state == BTA_GATTC_SERV_IDLE) ||
       p_clcb->p_srcb->state == BTA_GATTC_SERV_DISC)
   /* no pending operation, start discovery right away */
@@ -832,6 +845,11 @@ void bta_gattc_start_discover(tBTA_GATTC_CLCB* p_clcb,
 
       /* clear the service change mask */
       p_clcb->p_srcb->srvc_hdl_chg = false;
+      if (!is_svc_chg) {
+        /* the whole database is discovered */
+        p_clcb->p_srcb->srvc_chg_s_handle = 0;
+        p_clcb->p_srcb->srvc_chg_e_handle = 0;
+      }
       p_clcb->p_srcb->update_count = 0;
       p_clcb->p_srcb->state = BTA_GATTC_SERV_DISC_ACT;
 
@@ -920,8 +938,84 @@ void bta_gattc_disc_cmpl(tBTA_GATTC_CLCB* p_clcb,
   }
 }
 
+/** The handle the completion of a read carries: the handle read by handle,
+ * or the first one of a read multiple variable length. 0 for other commands.
+ */
+static uint16_t bta_gattc_read_cmd_handle(const tBTA_GATTC_DATA* p_cmd) {
+  if (p_cmd->hdr.event == BTA_GATTC_API_READ_EVT) return p_cmd->api_read.handle;
+  if (p_cmd->hdr.event == BTA_GATTC_API_READ_MULTI_EVT &&
+      p_cmd->api_read_multi.variable_len)
+    return p_cmd->api_read_multi.handles[0];
+  return 0;
+}
+
+/** Send a read multiple of |p_read_multi|, with variable lengths if asked */
+static tGATT_STATUS bta_gattc_send_read_multi(
+    tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_API_READ_MULTI* p_read_multi) {
+  tGATT_READ_PARAM read_param;
+  memset(&read_param, 0, sizeof(tGATT_READ_PARAM));
+
+  read_param.read_multiple.num_handles = p_read_multi->num_attr;
+  read_param.read_multiple.auth_req = p_read_multi->auth_req;
+  memcpy(&read_param.read_multiple.handles, p_read_multi->handles,
+         sizeof(uint16_t) * p_read_multi->num_attr);
+
+  return GATTC_Read(p_clcb->bta_conn_id,
+                    p_read_multi->variable_len ? GATT_READ_MULTIPLE_VAR_LEN
+                                               : GATT_READ_MULTIPLE,
+                    &read_param);
+}
+
+/** Send a read by handle or a read multiple variable length right away on an
+ * idle EATT bearer, if the requests outstanding on the connection are
+ * independent reads too. Completions of such reads are told apart by the
+ * handle they carry, so a handle is only read once at a time. Returns true if
+ * the read was sent.
+ */
+static bool bta_gattc_read_on_additional_bearer(tBTA_GATTC_CLCB* p_clcb,
+                                                const tBTA_GATTC_DATA* p_data) {
+  uint16_t handle = bta_gattc_read_cmd_handle(p_data);
+  if (handle == 0 || p_clcb->transport != BT_TRANSPORT_LE) return false;
+
+  const tBTA_GATTC_DATA* p_q_cmd = p_clcb->p_q_cmd;
+  if (p_q_cmd == NULL && p_clcb->p_q_cmd_parallel.empty()) return false;
+
+  /* keep the order of queued requests and of a pending discovery */
+  if (!p_clcb->p_q_cmd_queue.empty() ||
+      p_clcb->auto_update != BTA_GATTC_NO_SCHEDULE)
+    return false;
+
+  if (p_q_cmd != NULL && (bta_gattc_read_cmd_handle(p_q_cmd) == 0 ||
+                          bta_gattc_read_cmd_handle(p_q_cmd) == handle))
+    return false;
+
+  for (const tBTA_GATTC_DATA* p_cmd : p_clcb->p_q_cmd_parallel) {
+    if (bta_gattc_read_cmd_handle(p_cmd) == handle) return false;
+  }
+
+  if (!GATTC_IsAdditionalBearerAvailable(p_clcb->bta_conn_id)) return false;
+
+  tGATT_STATUS status;
+  if (p_data->hdr.event == BTA_GATTC_API_READ_MULTI_EVT) {
+    status = bta_gattc_send_read_multi(p_clcb, &p_data->api_read_multi);
+  } else {
+    tGATT_READ_PARAM read_param;
+    memset(&read_param, 0, sizeof(tGATT_READ_PARAM));
+    read_param.by_handle.handle = handle;
+    read_param.by_handle.auth_req = p_data->api_read.auth_req;
+    status = GATTC_Read(p_clcb->bta_conn_id, GATT_READ_BY_HANDLE, &read_param);
+  }
+  if (status != GATT_SUCCESS) return false;
+
+  VLOG(1) << __func__ << ": conn_id=" << loghex(p_clcb->bta_conn_id)
+          << ", handle=" << loghex(handle);
+  p_clcb->p_q_cmd_parallel.push_back(p_data);
+  return true;
+}
+
 /** Read an attribute */
 void bta_gattc_read(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
+  if (bta_gattc_read_on_additional_bearer(p_clcb, p_data)) return;
   if (bta_gattc_enqueue(p_clcb, p_data) == ENQUEUED_FOR_LATER) return;
 
   tGATT_STATUS status;
@@ -953,26 +1047,76 @@ void bta_gattc_read(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
   }
 }
 
+/** Pass the values of a read multiple variable length to its callback, once
+ * for each handle. The handles whose value was cut short in the response are
+ * read again on their own, as are all of them when the server does not
+ * support the request. */
+static void bta_gattc_read_multi_var_cb(
+    uint16_t conn_id, const tBTA_GATTC_API_READ_MULTI* p_read_multi,
+    tGATT_STATUS status, tGATT_CL_COMPLETE* p_cmpl) {
+  GATT_READ_OP_CB cb = p_read_multi->read_cb;
+  void* my_cb_data = p_read_multi->read_cb_data;
+  if (!p_read_multi->variable_len || cb == NULL) return;
+
+  uint8_t* p = NULL;
+  uint16_t left = 0;
+  if (status == GATT_SUCCESS && p_cmpl != NULL) {
+    p = p_cmpl->att_value.value;
+    left = p_cmpl->att_value.len;
+  }
+
+  for (uint8_t i = 0; i < p_read_multi->num_attr; i++) {
+    uint16_t handle = p_read_multi->handles[i];
+    if (status == GATT_REQ_NOT_SUPPORTED) {
+      BTA_GATTC_ReadCharacteristic(conn_id, handle, p_read_multi->auth_req, cb,
+                                   my_cb_data);
+      continue;
+    }
+
+    if (status != GATT_SUCCESS) {
+      cb(conn_id, status, handle, 0, NULL, my_cb_data);
+      continue;
+    }
+
+    /* Each value follows its length, those which did not fit in the MTU are
+     * cut short or left out */
+    uint16_t len = 0;
+    bool cut_short = left < 2;
+    if (!cut_short) {
+      STREAM_TO_UINT16(len, p);
+      left -= 2;
+      cut_short = len > left;
+    }
+    if (cut_short) {
+      VLOG(1) << __func__ << ": read again handle=" << loghex(handle);
+      BTA_GATTC_ReadCharacteristic(conn_id, handle, p_read_multi->auth_req, cb,
+                                   my_cb_data);
+      left = 0;
+      continue;
+    }
+
+    cb(conn_id, GATT_SUCCESS, handle, len, p, my_cb_data);
+    p += len;
+    left -= len;
+  }
+}
+
 /** read multiple */
 void bta_gattc_read_multi(tBTA_GATTC_CLCB* p_clcb,
                           const tBTA_GATTC_DATA* p_data) {
+  if (bta_gattc_read_on_additional_bearer(p_clcb, p_data)) return;
   if (bta_gattc_enqueue(p_clcb, p_data) == ENQUEUED_FOR_LATER) return;
 
-  tGATT_READ_PARAM read_param;
-  memset(&read_param, 0, sizeof(tGATT_READ_PARAM));
-
-  read_param.read_multiple.num_handles = p_data->api_read_multi.num_attr;
-  read_param.read_multiple.auth_req = p_data->api_read_multi.auth_req;
-  memcpy(&read_param.read_multiple.handles, p_data->api_read_multi.handles,
-         sizeof(uint16_t) * p_data->api_read_multi.num_attr);
-
   tGATT_STATUS status =
-      GATTC_Read(p_clcb->bta_conn_id, GATT_READ_MULTIPLE, &read_param);
+      bta_gattc_send_read_multi(p_clcb, &p_data->api_read_multi);
   /* read fail */
   if (status != GATT_SUCCESS) {
     /* Dequeue the data, if it was enqueued */
     if (p_clcb->p_q_cmd == p_data) p_clcb->p_q_cmd = NULL;
 
+    bta_gattc_read_multi_var_cb(p_clcb->bta_conn_id, &p_data->api_read_multi,
+                                status, NULL);
+
     bta_gattc_cmpl_sendmsg(p_clcb->bta_conn_id, GATTC_OPTYPE_READ, status,
                            NULL);
     bta_gattc_continue(p_clcb);
@@ -1137,8 +1281,13 @@ static void bta_gattc_cfg_mtu_cmpl(tBTA_GATTC_CLCB* p_clcb,
   (*p_clcb->p_rcb->p_cback)(BTA_GATTC_CFG_MTU_EVT, &cb_data);
 }
 
+static void bta_gattc_op_cmpl_next(tBTA_GATTC_CLCB* p_clcb,
+                                   tGATT_STATUS status);
+
 /** operation completed */
 void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
+  if (bta_gattc_parallel_read_cmpl(p_clcb, p_data)) return;
+
   if (p_clcb->p_q_cmd == NULL) {
     LOG_ERROR("No pending command gatt client command");
     return;
@@ -1161,8 +1310,10 @@ void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
       return;
   }
 
-  if (p_clcb->p_q_cmd->hdr.event !=
-      bta_gattc_opcode_to_int_evt[op - GATTC_OPTYPE_READ]) {
+  bool read_multi = op == GATTC_OPTYPE_READ &&
+                    p_clcb->p_q_cmd->hdr.event == BTA_GATTC_API_READ_MULTI_EVT;
+  if (!read_multi && p_clcb->p_q_cmd->hdr.event !=
+                         bta_gattc_opcode_to_int_evt[op - GATTC_OPTYPE_READ]) {
     uint8_t mapped_op =
         p_clcb->p_q_cmd->hdr.event - BTA_GATTC_API_READ_EVT + GATTC_OPTYPE_READ;
     if (mapped_op > GATTC_OPTYPE_INDICATION) mapped_op = 0;
@@ -1186,7 +1337,14 @@ void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
   }
 
   /* service handle change void the response, discard it */
-  if (op == GATTC_OPTYPE_READ) {
+  if (read_multi) {
+    const tBTA_GATTC_DATA* p_cmd = p_clcb->p_q_cmd;
+    p_clcb->p_q_cmd = NULL;
+    bta_gattc_read_multi_var_cb(p_clcb->bta_conn_id, &p_cmd->api_read_multi,
+                                p_data->op_cmpl.status,
+                                p_data->op_cmpl.p_cmpl);
+    osi_free_and_reset((void**)&p_cmd);
+  } else if (op == GATTC_OPTYPE_READ) {
     bta_gattc_read_cmpl(p_clcb, &p_data->op_cmpl);
   } else if (op == GATTC_OPTYPE_WRITE) {
     bta_gattc_write_cmpl(p_clcb, &p_data->op_cmpl);
@@ -1211,18 +1369,79 @@ void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
     }
   }
 
+  bta_gattc_op_cmpl_next(p_clcb, p_data->op_cmpl.status);
+}
+
+/** read sent on an additional EATT bearer completed, returns true if the
+ * completion was for such a read */
+bool bta_gattc_parallel_read_cmpl(tBTA_GATTC_CLCB* p_clcb,
+                                  const tBTA_GATTC_DATA* p_data) {
+  const tBTA_GATTC_OP_CMPL* p_cmpl = &p_data->op_cmpl;
+  if (p_cmpl->op_code != GATTC_OPTYPE_READ || p_cmpl->p_cmpl == NULL)
+    return false;
+
+  uint16_t handle = p_cmpl->p_cmpl->att_value.handle;
+  auto it = std::find_if(p_clcb->p_q_cmd_parallel.begin(),
+                         p_clcb->p_q_cmd_parallel.end(),
+                         [handle](const tBTA_GATTC_DATA* p_cmd) {
+                           return bta_gattc_read_cmd_handle(p_cmd) == handle;
+                         });
+  if (it == p_clcb->p_q_cmd_parallel.end()) return false;
+
+  const tBTA_GATTC_DATA* p_cmd = *it;
+  p_clcb->p_q_cmd_parallel.erase(it);
+
+  /* same as bta_gattc_op_cmpl, the service handle change voids the response */
+  tGATT_STATUS status = p_cmpl->status;
+  if (p_clcb->auto_update == BTA_GATTC_DISC_WAITING &&
+      p_clcb->p_srcb->srvc_hdl_chg) {
+    status = GATT_ERROR;
+  }
+
+  if (p_cmd->hdr.event == BTA_GATTC_API_READ_MULTI_EVT) {
+    bta_gattc_read_multi_var_cb(p_clcb->bta_conn_id, &p_cmd->api_read_multi,
+                                status, p_cmpl->p_cmpl);
+    osi_free_and_reset((void**)&p_cmd);
+  } else {
+    GATT_READ_OP_CB cb = p_cmd->api_read.read_cb;
+    void* my_cb_data = p_cmd->api_read.read_cb_data;
+    osi_free_and_reset((void**)&p_cmd);
+
+    if (cb) {
+      cb(p_clcb->bta_conn_id, status, handle, p_cmpl->p_cmpl->att_value.len,
+         p_cmpl->p_cmpl->att_value.value, my_cb_data);
+    }
+  }
+
+  /* a discovery in progress continues the queue once it completes */
+  if (p_clcb->state == BTA_GATTC_CONN_ST) {
+    bta_gattc_op_cmpl_next(p_clcb, status);
+  }
+  return true;
+}
+
+/** schedule what follows a completed operation: a discovery waiting for it, or
+ * the next queued command. Nothing is scheduled while reads sent on other EATT
+ * bearers are still outstanding, the last of them to complete does it. */
+static void bta_gattc_op_cmpl_next(tBTA_GATTC_CLCB* p_clcb,
+                                   tGATT_STATUS status) {
   // If receive DATABASE_OUT_OF_SYNC error code, bta_gattc should start service
   // discovery immediately
   if (bta_gattc_is_robust_caching_enabled() &&
-      p_data->op_cmpl.status == GATT_DATABASE_OUT_OF_SYNC) {
+      status == GATT_DATABASE_OUT_OF_SYNC) {
     LOG(INFO) << __func__ << ": DATABASE_OUT_OF_SYNC, re-discover service";
-    p_clcb->auto_update = BTA_GATTC_REQ_WAITING;
     /* request read db hash first */
     p_clcb->p_srcb->srvc_hdl_db_hash = true;
-    bta_gattc_sm_execute(p_clcb, BTA_GATTC_INT_DISCOVER_EVT, NULL);
-    return;
+    if (p_clcb->p_q_cmd == NULL && p_clcb->p_q_cmd_parallel.empty()) {
+      p_clcb->auto_update = BTA_GATTC_REQ_WAITING;
+      bta_gattc_sm_execute(p_clcb, BTA_GATTC_INT_DISCOVER_EVT, NULL);
+      return;
+    }
+    p_clcb->auto_update = BTA_GATTC_DISC_WAITING;
   }
 
+  if (p_clcb->p_q_cmd != NULL || !p_clcb->p_q_cmd_parallel.empty()) return;
+
   if (p_clcb->auto_update == BTA_GATTC_DISC_WAITING) {
     p_clcb->auto_update = BTA_GATTC_REQ_WAITING;
 
@@ -1408,6 +1627,18 @@ static bool bta_gattc_process_srvc_chg_ind(uint16_t conn_id,
 
   /* mark service handle change pending */
   p_srcb->srvc_hdl_chg = true;
+  /* add the range to the ones to discover again */
+  if (s_handle == 0 || s_handle > e_handle) {
+    s_handle = gatt::HANDLE_MIN;
+    e_handle = gatt::HANDLE_MAX;
+  }
+  if (p_srcb->srvc_chg_s_handle == 0) {
+    p_srcb->srvc_chg_s_handle = s_handle;
+    p_srcb->srvc_chg_e_handle = e_handle;
+  } else {
+    p_srcb->srvc_chg_s_handle = std::min(p_srcb->srvc_chg_s_handle, s_handle);
+    p_srcb->srvc_chg_e_handle = std::max(p_srcb->srvc_chg_e_handle, e_handle);
+  }
   /* clear up all notification/indication registration */
   bta_gattc_clear_notif_registration(p_srcb, conn_id, s_handle, e_handle);
   /* service change indication all received, do discovery update */
@@ -1448,10 +1679,13 @@ static bool bta_gattc_process_srvc_chg_ind(uint16_t conn_id,
   return true;
 }
 
-/** process all non-service change indication/notification */
+/** process all non-service change indication/notification, |p_event| has its
+ * handle and cid set and gets the rest of the notification */
 static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
                                             tGATT_CL_COMPLETE* p_data,
-                                            tBTA_GATTC_NOTIFY* p_notify) {
+                                            tBTA_GATTC* p_event) {
+  tBTA_GATTC_NOTIFY* p_notify = &p_event->notify;
+
   VLOG(1) << __func__
           << StringPrintf(
                  ": check p_data->att_value.handle=%d p_data->handle=%d",
@@ -1464,10 +1698,9 @@ static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
   memcpy(p_notify->value, p_data->att_value.value, p_data->att_value.len);
   p_notify->conn_id = p_clcb->bta_conn_id;
 
+  /* The event is built in place, rather than copying its value once more */
   if (p_clcb->p_rcb->p_cback) {
-    tBTA_GATTC bta_gattc;
-    bta_gattc.notify = *p_notify;
-    (*p_clcb->p_rcb->p_cback)(BTA_GATTC_NOTIF_EVT, &bta_gattc);
+    (*p_clcb->p_rcb->p_cback)(BTA_GATTC_NOTIF_EVT, p_event);
   }
 }
 
@@ -1475,7 +1708,8 @@ static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
 static void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
                                        tGATT_CL_COMPLETE* p_data) {
   uint16_t handle = p_data->att_value.handle;
-  tBTA_GATTC_NOTIFY notify;
+  tBTA_GATTC bta_gattc;
+  tBTA_GATTC_NOTIFY& notify = bta_gattc.notify;
   RawAddress remote_bda;
   tGATT_IF gatt_if;
   tBT_TRANSPORT transport;
@@ -1531,7 +1765,7 @@ static void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
     }
 
     if (p_clcb != NULL)
-      bta_gattc_proc_other_indication(p_clcb, op, p_data, &notify);
+      bta_gattc_proc_other_indication(p_clcb, op, p_data, &bta_gattc);
   }
   /* no one intersted and need ack? */
   else if (op == GATTC_OPTYPE_INDICATION) {
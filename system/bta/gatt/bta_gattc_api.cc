@@ -27,6 +27,7 @@
 #include <base/functional/bind.h>
 #include <base/logging.h>
 
+#include <algorithm>
 #include <ios>
 #include <list>
 #include <memory>
@@ -310,6 +311,23 @@ const std::list<gatt::Service>* BTA_GATTC_GetServices(uint16_t conn_id) {
   return bta_gattc_get_services(conn_id);
 }
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_GetDatabaseHash
+ *
+ * Description      This function is called to get the hash of the database
+ *                  discovered on the given server.
+ *
+ * Parameters       conn_id: connection ID which identify the server.
+ *                  p_hash: set to the database hash.
+ *
+ * Returns          true if the database of the server is known.
+ *
+ ******************************************************************************/
+bool BTA_GATTC_GetDatabaseHash(uint16_t conn_id, Octet16* p_hash) {
+  return bta_gattc_get_database_hash(conn_id, p_hash);
+}
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_GetCharacteristic
@@ -488,6 +506,52 @@ void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
   bta_sys_sendmsg(p_buf);
 }
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_ReadMultipleVariable
+ *
+ * Description      This function is called to read the values of several
+ *                  characteristics or descriptors, GATT_MAX_READ_MULTI_HANDLES
+ *                  at a time.
+ *
+ * Parameters       conn_id - connection ID.
+ *                  handles - handles of the attributes to read.
+ *                  callback - called once for each handle.
+ *
+ * Returns          None
+ *
+ ******************************************************************************/
+void BTA_GATTC_ReadMultipleVariable(uint16_t conn_id,
+                                    const std::vector<uint16_t>& handles,
+                                    tGATT_AUTH_REQ auth_req,
+                                    GATT_READ_OP_CB callback, void* cb_data) {
+  for (size_t first = 0; first < handles.size();
+       first += GATT_MAX_READ_MULTI_HANDLES) {
+    size_t count = std::min(handles.size() - first,
+                            (size_t)GATT_MAX_READ_MULTI_HANDLES);
+    /* The request takes two handles at least */
+    if (count == 1) {
+      BTA_GATTC_ReadCharacteristic(conn_id, handles[first], auth_req, callback,
+                                   cb_data);
+      break;
+    }
+
+    tBTA_GATTC_API_READ_MULTI* p_buf = (tBTA_GATTC_API_READ_MULTI*)osi_calloc(
+        sizeof(tBTA_GATTC_API_READ_MULTI));
+
+    p_buf->hdr.event = BTA_GATTC_API_READ_MULTI_EVT;
+    p_buf->hdr.layer_specific = conn_id;
+    p_buf->auth_req = auth_req;
+    p_buf->num_attr = count;
+    memcpy(p_buf->handles, &handles[first], sizeof(uint16_t) * count);
+    p_buf->variable_len = true;
+    p_buf->read_cb = callback;
+    p_buf->read_cb_data = cb_data;
+
+    bta_sys_sendmsg(p_buf);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_WriteCharValue
@@ -29,6 +29,7 @@
 #include <base/strings/string_number_conversions.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <sstream>
@@ -69,6 +70,13 @@ static void bta_gattc_read_db_hash_cmpl(tBTA_GATTC_CLCB* p_clcb,
 static void bta_gattc_read_ext_prop_desc_cmpl(tBTA_GATTC_CLCB* p_clcb,
                                               const tBTA_GATTC_OP_CMPL* p_data);
 
+static void bta_gattc_save_discovered_db(tBTA_GATTC_CLCB* p_clcb);
+
+static tGATT_STATUS bta_gattc_send_read_db_hash(tBTA_GATTC_CLCB* p_clcb);
+
+static void bta_gattc_read_db_hash_for_range_cmpl(
+    tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_OP_CMPL* p_data);
+
 // define the max retry count for DATABASE_OUT_OF_SYNC
 #define BTA_GATTC_DISCOVER_RETRY_COUNT 2
 
@@ -113,14 +121,38 @@ void bta_gattc_init_cache(tBTA_GATTC_SERV* p_srvc_cb) {
   p_srvc_cb->pending_discovery.Clear();
 }
 
-const Service* bta_gattc_find_matching_service(
-    const std::list<Service>& services, uint16_t handle) {
-  for (const Service& service : services) {
-    if (handle >= service.handle && handle <= service.end_handle)
-      return &service;
+/** Select the handle range of the next discovery: the services overlapping
+ * the ranges of the service change indications received, or the whole
+ * database */
+void bta_gattc_init_discovery_range(tBTA_GATTC_SERV* p_srvc_cb,
+                                    tBT_TRANSPORT transport) {
+  uint16_t s_handle = p_srvc_cb->srvc_chg_s_handle;
+  uint16_t e_handle = p_srvc_cb->srvc_chg_e_handle;
+  p_srvc_cb->srvc_chg_s_handle = 0;
+  p_srvc_cb->srvc_chg_e_handle = 0;
+  p_srvc_cb->disc_s_handle = 0;
+  p_srvc_cb->disc_e_handle = 0;
+
+  // Over BR/EDR the services are found by SDP, not in a handle range
+  if (transport != BT_TRANSPORT_LE || s_handle == 0 ||
+      p_srvc_cb->gatt_database.IsEmpty()) {
+    return;
+  }
+
+  // Services in part in the range are discovered again as a whole. Services
+  // don't overlap, a single pass is enough.
+  for (const Service& service : p_srvc_cb->gatt_database.Services()) {
+    if (service.handle <= e_handle && service.end_handle >= s_handle) {
+      s_handle = std::min(s_handle, service.handle);
+      e_handle = std::max(e_handle, service.end_handle);
+    }
   }
+  if (s_handle == gatt::HANDLE_MIN && e_handle == gatt::HANDLE_MAX) return;
 
-  return nullptr;
+  LOG_INFO("Discover services in range 0x%04x-0x%04x of %s", s_handle,
+           e_handle, ADDRESS_TO_LOGGABLE_CSTR(p_srvc_cb->server_bda));
+  p_srvc_cb->disc_s_handle = s_handle;
+  p_srvc_cb->disc_e_handle = e_handle;
 }
 
 /// Whether the peer device uses robust caching
@@ -285,7 +317,31 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
   /* no service found at all, the end of server discovery*/
   LOG(INFO) << __func__ << ": service discovery finished";
 
-  p_srvc_cb->gatt_database = p_srvc_cb->pending_discovery.Build();
+  if (p_srvc_cb->disc_s_handle != 0) {
+    p_srvc_cb->gatt_database.Splice(p_srvc_cb->pending_discovery.Build(),
+                                    p_srvc_cb->disc_s_handle,
+                                    p_srvc_cb->disc_e_handle);
+
+    /* the services outside of the range were not discovered again, make sure
+     * the server has the same database */
+    if (GetRobustCachingSupport(p_clcb, p_srvc_cb->gatt_database) ==
+            RobustCachingSupport::SUPPORTED &&
+        bta_gattc_send_read_db_hash(p_clcb) == GATT_SUCCESS) {
+      p_clcb->request_during_discovery =
+          BTA_GATTC_DISCOVER_REQ_READ_DB_HASH_FOR_RANGE;
+      // asynchronous continuation in bta_gattc_op_cmpl_during_discovery
+      return;
+    }
+  } else {
+    p_srvc_cb->gatt_database = p_srvc_cb->pending_discovery.Build();
+  }
+
+  bta_gattc_save_discovered_db(p_clcb);
+}
+
+/** save the database of a finished discovery */
+static void bta_gattc_save_discovered_db(tBTA_GATTC_CLCB* p_clcb) {
+  tBTA_GATTC_SERV* p_srvc_cb = p_clcb->p_srcb;
 
 #if (BTA_GATT_DEBUG == TRUE)
   bta_gattc_display_cache_server(p_srvc_cb->gatt_database);
@@ -314,7 +370,7 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
 
     // After success, reset the count.
     LOG_DEBUG("service discovery succeed, reset count to zero, conn_id=0x%04x",
-              conn_id);
+              p_clcb->bta_conn_id);
     p_srvc_cb->srvc_disc_count = 0;
   }
 
@@ -448,6 +504,8 @@ static tGATT_STATUS bta_gattc_sdp_service_disc(uint16_t conn_id,
 /** operation completed */
 void bta_gattc_op_cmpl_during_discovery(tBTA_GATTC_CLCB* p_clcb,
                                         const tBTA_GATTC_DATA* p_data) {
+  if (bta_gattc_parallel_read_cmpl(p_clcb, p_data)) return;
+
   // Currently, there are two cases needed to be handled.
   // 1. Read ext prop descriptor value after service discovery
   // 2. Read db hash before starting service discovery
@@ -466,6 +524,9 @@ void bta_gattc_op_cmpl_during_discovery(tBTA_GATTC_CLCB* p_clcb,
         p_clcb->request_during_discovery = BTA_GATTC_DISCOVER_REQ_NONE;
       }
       break;
+    case BTA_GATTC_DISCOVER_REQ_READ_DB_HASH_FOR_RANGE:
+      bta_gattc_read_db_hash_for_range_cmpl(p_clcb, &p_data->op_cmpl);
+      break;
     case BTA_GATTC_DISCOVER_REQ_NONE:
     default:
       break;
@@ -616,33 +677,36 @@ const std::list<Service>* bta_gattc_get_services(uint16_t conn_id) {
   return bta_gattc_get_services_srcb(p_srcb);
 }
 
+bool bta_gattc_get_database_hash(uint16_t conn_id, Octet16* p_hash) {
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
+
+  if (p_clcb == NULL || p_clcb->p_srcb == NULL ||
+      p_clcb->p_srcb->gatt_database.IsEmpty())
+    return false;
+
+  *p_hash = p_clcb->p_srcb->gatt_database.Hash();
+  return true;
+}
+
 const Service* bta_gattc_get_service_for_handle_srcb(tBTA_GATTC_SERV* p_srcb,
                                                      uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services_srcb(p_srcb);
-  if (services == NULL) return NULL;
-  return bta_gattc_find_matching_service(*services, handle);
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindService(handle);
 }
 
 const Service* bta_gattc_get_service_for_handle(uint16_t conn_id,
                                                 uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services(conn_id);
-  if (services == NULL) return NULL;
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
+
+  if (p_clcb == NULL) return NULL;
 
-  return bta_gattc_find_matching_service(*services, handle);
+  return bta_gattc_get_service_for_handle_srcb(p_clcb->p_srcb, handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic_srcb(tBTA_GATTC_SERV* p_srcb,
                                                         uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    if (handle == charac.value_handle) return &charac;
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
@@ -657,20 +721,8 @@ const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
 
 const Descriptor* bta_gattc_get_descriptor_srcb(tBTA_GATTC_SERV* p_srcb,
                                                 uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) {
-    return NULL;
-  }
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &desc;
-    }
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindDescriptor(handle);
 }
 
 const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
@@ -684,18 +736,8 @@ const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
 
 const Characteristic* bta_gattc_get_owning_characteristic_srcb(
     tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &charac;
-    }
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindOwningCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_owning_characteristic(uint16_t conn_id,
@@ -706,8 +748,8 @@ const Characteristic* bta_gattc_get_owning_characteristic(uint16_t conn_id,
   return bta_gattc_get_owning_characteristic_srcb(p_clcb->p_srcb, handle);
 }
 
-/* request reading database hash */
-bool bta_gattc_read_db_hash(tBTA_GATTC_CLCB* p_clcb, bool is_svc_chg) {
+/* send a read of the database hash */
+static tGATT_STATUS bta_gattc_send_read_db_hash(tBTA_GATTC_CLCB* p_clcb) {
   tGATT_READ_PARAM read_param;
   memset(&read_param, 0, sizeof(tGATT_READ_BY_TYPE));
 
@@ -715,10 +757,12 @@ bool bta_gattc_read_db_hash(tBTA_GATTC_CLCB* p_clcb, bool is_svc_chg) {
   read_param.char_type.e_handle = 0xFFFF;
   read_param.char_type.uuid = Uuid::From16Bit(GATT_UUID_DATABASE_HASH);
   read_param.char_type.auth_req = GATT_AUTH_REQ_NONE;
-  tGATT_STATUS status =
-      GATTC_Read(p_clcb->bta_conn_id, GATT_READ_BY_TYPE, &read_param);
+  return GATTC_Read(p_clcb->bta_conn_id, GATT_READ_BY_TYPE, &read_param);
+}
 
-  if (status != GATT_SUCCESS) return false;
+/* request reading database hash */
+bool bta_gattc_read_db_hash(tBTA_GATTC_CLCB* p_clcb, bool is_svc_chg) {
+  if (bta_gattc_send_read_db_hash(p_clcb) != GATT_SUCCESS) return false;
 
   if (is_svc_chg) {
     p_clcb->request_during_discovery =
@@ -812,6 +856,39 @@ static void bta_gattc_read_db_hash_cmpl(tBTA_GATTC_CLCB* p_clcb,
   }
 }
 
+/* handle response of reading database hash, after the discovery of a range
+ * of the database */
+static void bta_gattc_read_db_hash_for_range_cmpl(
+    tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_OP_CMPL* p_data) {
+  uint8_t op = (uint8_t)p_data->op_code;
+  if (op != GATTC_OPTYPE_READ) {
+    VLOG(1) << __func__ << ": op = " << +p_data->hdr.layer_specific;
+    return;
+  }
+  p_clcb->request_during_discovery = BTA_GATTC_DISCOVER_REQ_NONE;
+
+  bool matched = false;
+  if (p_data->status == GATT_SUCCESS &&
+      p_data->p_cmpl->att_value.len == Octet16().size()) {
+    Octet16 remote_hash;
+    std::copy(p_data->p_cmpl->att_value.value,
+              p_data->p_cmpl->att_value.value + remote_hash.size(),
+              remote_hash.begin());
+    matched = (p_clcb->p_srcb->gatt_database.Hash() == remote_hash);
+  }
+
+  if (matched) {
+    bta_gattc_save_discovered_db(p_clcb);
+    return;
+  }
+
+  LOG_WARN("Database hash mismatch after a range discovery, discover %s again",
+           ADDRESS_TO_LOGGABLE_CSTR(p_clcb->p_srcb->server_bda));
+  p_clcb->p_srcb->srvc_chg_s_handle = 0;
+  p_clcb->p_srcb->srvc_chg_e_handle = 0;
+  bta_gattc_start_discover_internal(p_clcb);
+}
+
 /* handle response of reading extended properties descriptor */
 static void bta_gattc_read_ext_prop_desc_cmpl(
     tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_OP_CMPL* p_data) {
@@ -21,7 +21,10 @@
 #include <base/logging.h>
 #include <base/strings/string_number_conversions.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include <string>
 #include <vector>
@@ -35,7 +38,7 @@ using std::vector;
 
 #ifdef TARGET_FLOSS
 #define GATT_CACHE_PREFIX "/var/lib/bluetooth/gatt/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CACHE_VERSION 7
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/var/lib/bluetooth/gatt/gatt_hash_"
@@ -43,7 +46,7 @@ using std::vector;
 #define GATT_HASH_FILE_PREFIX "gatt_hash_"
 #else
 #define GATT_CACHE_PREFIX "/data/misc/bluetooth/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CACHE_VERSION 7
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/data/misc/bluetooth/gatt_hash_"
@@ -54,6 +57,25 @@ using std::vector;
 // Default expired time is 7 days
 #define GATT_HASH_EXPIRED_TIME 604800
 
+// Version of the cache files written before the header carried the size of
+// the attributes. Such files are still loaded, and rewritten in the current
+// format.
+#define GATT_CACHE_LEGACY_VERSION 6
+
+// Header of the GATT cache files, directly followed by |num_attr|
+// attributes of |attr_size| bytes each. The version comes first, like in the
+// legacy format, so that either format rejects the other. The header size
+// keeps the attributes aligned in a mapped file.
+typedef struct {
+  uint16_t version;
+  uint16_t num_attr;
+  uint16_t attr_size;
+  uint16_t reserved;
+} tGATT_CACHE_HEADER;
+
+static_assert(sizeof(tGATT_CACHE_HEADER) % alignof(StoredAttribute) == 0,
+              "GATT cache attributes must be aligned in mapped files");
+
 static void bta_gattc_hash_remove_least_recently_used_if_possible();
 
 static void bta_gattc_generate_cache_file_name(char* buffer, size_t buffer_len,
@@ -71,11 +93,72 @@ static void bta_gattc_generate_hash_file_name(char* buffer, size_t buffer_len,
 
 static gatt::Database EMPTY_DB;
 
+static bool bta_gattc_store_db(const char* fname,
+                               const std::vector<StoredAttribute>& attr);
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_find_attributes
+ *
+ * Description      Locate the attributes in the content of a GATT cache file.
+ *
+ * Parameter        data: content of the file
+ *                  size: size of the file
+ *                  fname: file name, for logging
+ *                  num_attr: output number of attributes
+ *                  is_legacy: output, true if the file is in legacy format
+ *
+ * Returns          pointer to the first attribute on success, nullptr
+ *                  otherwise
+ *
+ ******************************************************************************/
+static const StoredAttribute* bta_gattc_find_attributes(const uint8_t* data,
+                                                        size_t size,
+                                                        const char* fname,
+                                                        uint16_t* num_attr,
+                                                        bool* is_legacy) {
+  uint16_t cache_ver;
+  memcpy(&cache_ver, data, sizeof(uint16_t));
+
+  if (cache_ver == GATT_CACHE_LEGACY_VERSION) {
+    // Legacy format: version and number of attributes, then the attributes.
+    memcpy(num_attr, data + sizeof(uint16_t), sizeof(uint16_t));
+    if (size != 2 * sizeof(uint16_t) + *num_attr * sizeof(StoredAttribute)) {
+      LOG(ERROR) << __func__ << ": wrong GATT cache size: " << fname;
+      return nullptr;
+    }
+    *is_legacy = true;
+    return reinterpret_cast<const StoredAttribute*>(data +
+                                                    2 * sizeof(uint16_t));
+  }
+
+  if (cache_ver != GATT_CACHE_VERSION || size < sizeof(tGATT_CACHE_HEADER)) {
+    LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
+    return nullptr;
+  }
+
+  const tGATT_CACHE_HEADER* header =
+      reinterpret_cast<const tGATT_CACHE_HEADER*>(data);
+  if (header->attr_size != sizeof(StoredAttribute) ||
+      size != sizeof(tGATT_CACHE_HEADER) +
+                  header->num_attr * sizeof(StoredAttribute)) {
+    LOG(ERROR) << __func__ << ": wrong GATT cache size: " << fname;
+    return nullptr;
+  }
+  *num_attr = header->num_attr;
+  *is_legacy = false;
+  return reinterpret_cast<const StoredAttribute*>(data +
+                                                  sizeof(tGATT_CACHE_HEADER));
+}
+
 /*******************************************************************************
  *
  * Function         bta_gattc_load_db
  *
- * Description      Load GATT database from storage.
+ * Description      Load GATT database from storage. The file is mapped
+ *                  read-only and the database is built directly from the
+ *                  mapped attributes. Files in legacy format are rewritten in
+ *                  the current format.
  *
  * Parameter        fname: input file name
  *
@@ -84,49 +167,51 @@ static gatt::Database EMPTY_DB;
  *
  ******************************************************************************/
 static gatt::Database bta_gattc_load_db(const char* fname) {
-  FILE* fd = fopen(fname, "rb");
-  if (!fd) {
+  int fd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
     LOG(ERROR) << __func__ << ": can't open GATT cache file " << fname
                << " for reading, error: " << strerror(errno);
     return EMPTY_DB;
   }
 
-  uint16_t cache_ver = 0;
-  uint16_t num_attr = 0;
-
-  if (fread(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size < (off_t)(2 * sizeof(uint16_t))) {
     LOG(ERROR) << __func__ << ": can't read GATT cache version from: " << fname;
-    goto done;
+    close(fd);
+    return EMPTY_DB;
   }
 
-  if (cache_ver != GATT_CACHE_VERSION) {
-    LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
-    goto done;
+  size_t size = st.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << __func__ << ": can't map GATT cache file " << fname
+               << ", error: " << strerror(errno);
+    return EMPTY_DB;
   }
 
-  if (fread(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't read number of GATT attributes: " << fname;
-    goto done;
+  uint16_t num_attr = 0;
+  bool is_legacy = false;
+  const StoredAttribute* attr = bta_gattc_find_attributes(
+      static_cast<const uint8_t*>(data), size, fname, &num_attr, &is_legacy);
+
+  bool success = false;
+  gatt::Database result;
+  if (attr != nullptr) {
+    result = gatt::Database::Deserialize(attr, num_attr, &success);
   }
+  munmap(data, size);
 
-  {
-    std::vector<StoredAttribute> attr(num_attr);
+  if (!success) return EMPTY_DB;
 
-    if (fread(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
-      LOG(ERROR) << __func__ << ": can't read GATT attributes: " << fname;
-      goto done;
-    }
-    fclose(fd);
-
-    bool success = false;
-    gatt::Database result = gatt::Database::Deserialize(attr, &success);
-    return success ? result : EMPTY_DB;
+  // The file is rewritten in place, so that the address files linked to it
+  // keep sharing it.
+  if (is_legacy) {
+    LOG_INFO("Migrating GATT cache file %s to version %d", fname,
+             GATT_CACHE_VERSION);
+    bta_gattc_store_db(fname, result.Serialize());
   }
-
-done:
-  fclose(fd);
-  return EMPTY_DB;
+  return result;
 }
 
 /*******************************************************************************
@@ -186,17 +271,15 @@ static bool bta_gattc_store_db(const char* fname,
     return false;
   }
 
-  uint16_t cache_ver = GATT_CACHE_VERSION;
-  if (fwrite(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__ << ": can't write GATT cache version: " << fname;
-    fclose(fd);
-    return false;
-  }
-
   uint16_t num_attr = attr.size();
-  if (fwrite(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't write GATT cache attribute count: " << fname;
+  tGATT_CACHE_HEADER header = {
+      .version = GATT_CACHE_VERSION,
+      .num_attr = num_attr,
+      .attr_size = sizeof(StoredAttribute),
+      .reserved = 0,
+  };
+  if (fwrite(&header, sizeof(header), 1, fd) != 1) {
+    LOG(ERROR) << __func__ << ": can't write GATT cache header: " << fname;
     fclose(fd);
     return false;
   }
@@ -162,6 +162,10 @@ typedef struct {
   tGATT_AUTH_REQ auth_req;
   uint8_t num_attr;
   uint16_t handles[GATT_MAX_READ_MULTI_HANDLES];
+  /* Read Multiple Variable Length, passing each value to |read_cb| */
+  bool variable_len;
+  GATT_READ_OP_CB read_cb;
+  void* read_cb_data;
 } tBTA_GATTC_API_READ_MULTI;
 
 typedef struct {
@@ -227,6 +231,13 @@ typedef struct {
   bool read_multiple_not_supported;
 
   uint8_t srvc_hdl_chg; /* service handle change indication pending */
+  /* handle range of the service change indications pending, 0 if none */
+  uint16_t srvc_chg_s_handle;
+  uint16_t srvc_chg_e_handle;
+  /* handle range the current discovery replaces in the cached database, 0
+   * when the whole database is discovered */
+  uint16_t disc_s_handle;
+  uint16_t disc_e_handle;
   bool srvc_hdl_db_hash;   /* read db hash pending */
   uint8_t srvc_disc_count; /* current discovery retry count */
   uint16_t attr_index;  /* cahce NV saving/loading attribute index */
@@ -265,12 +276,15 @@ typedef struct {
   tBTA_GATTC_SERV* p_srcb;  /* server cache CB */
   const tBTA_GATTC_DATA* p_q_cmd; /* command in queue waiting for execution */
   std::deque<const tBTA_GATTC_DATA*> p_q_cmd_queue;
+  /* reads by handle sent alongside p_q_cmd on other EATT bearers */
+  std::deque<const tBTA_GATTC_DATA*> p_q_cmd_parallel;
 
 // request during discover state
 #define BTA_GATTC_DISCOVER_REQ_NONE 0
 #define BTA_GATTC_DISCOVER_REQ_READ_EXT_PROP_DESC 1
 #define BTA_GATTC_DISCOVER_REQ_READ_DB_HASH 2
 #define BTA_GATTC_DISCOVER_REQ_READ_DB_HASH_FOR_SVC_CHG 3
+#define BTA_GATTC_DISCOVER_REQ_READ_DB_HASH_FOR_RANGE 4
 
   uint8_t request_during_discovery; /* request during discover state */
 
@@ -377,6 +391,8 @@ void bta_gattc_disc_cmpl(tBTA_GATTC_CLCB* p_clcb,
 void bta_gattc_read(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data);
 void bta_gattc_write(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data);
 void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data);
+bool bta_gattc_parallel_read_cmpl(tBTA_GATTC_CLCB* p_clcb,
+                                  const tBTA_GATTC_DATA* p_data);
 void bta_gattc_q_cmd(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data);
 void bta_gattc_search(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data);
 void bta_gattc_fail(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data);
@@ -459,6 +475,7 @@ tGATT_STATUS bta_gattc_discover_pri_service(uint16_t conn_id,
                                             tGATT_DISC_TYPE disc_type);
 void bta_gattc_search_service(tBTA_GATTC_CLCB* p_clcb, bluetooth::Uuid* p_uuid);
 const std::list<gatt::Service>* bta_gattc_get_services(uint16_t conn_id);
+bool bta_gattc_get_database_hash(uint16_t conn_id, Octet16* p_hash);
 const gatt::Service* bta_gattc_get_service_for_handle(uint16_t conn_id,
                                                       uint16_t handle);
 const gatt::Characteristic* bta_gattc_get_characteristic_srcb(
@@ -475,6 +492,8 @@ void bta_gattc_get_gatt_db(uint16_t conn_id, uint16_t start_handle,
                            uint16_t end_handle, btgatt_db_element_t** db,
                            int* count);
 void bta_gattc_init_cache(tBTA_GATTC_SERV* p_srvc_cb);
+void bta_gattc_init_discovery_range(tBTA_GATTC_SERV* p_srvc_cb,
+                                    tBT_TRANSPORT transport);
 
 enum class RobustCachingSupport {
   UNSUPPORTED,
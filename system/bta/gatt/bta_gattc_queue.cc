@@ -21,6 +21,7 @@
 #include <unordered_set>
 
 #include "osi/include/allocator.h"
+#include "stack/include/l2c_api.h"
 
 #include <base/logging.h>
 
@@ -32,17 +33,36 @@ constexpr uint8_t GATT_WRITE_CHAR = 3;
 constexpr uint8_t GATT_WRITE_DESC = 4;
 constexpr uint8_t GATT_CONFIG_MTU = 5;
 
-struct gatt_read_op_data {
+struct BtaGattQueue::gatt_read_op_data {
+  uint8_t type;
+  uint16_t handle;
   GATT_READ_OP_CB cb;
   void* cb_data;
+  std::vector<gatt_read_cb> coalesced_cbs;
 };
 
 std::unordered_map<uint16_t, std::list<gatt_operation>>
     BtaGattQueue::gatt_op_queue;
-std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_executing;
+std::unordered_map<uint16_t, uint8_t> BtaGattQueue::gatt_op_queue_executing;
+std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_executing_exclusive;
+std::unordered_map<uint16_t, std::list<BtaGattQueue::gatt_read_op_data*>>
+    BtaGattQueue::gatt_op_queue_executing_reads;
+std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_coalescing;
+
+/* Reads can be executed together, BTA GATTC sends them on separate EATT
+ * bearers when available. */
+constexpr uint8_t GATT_MAX_EXECUTING_READS = L2CAP_CREDIT_BASED_MAX_CIDS;
+
+static bool is_read_op(const gatt_operation& op) {
+  return op.type == GATT_READ_CHAR || op.type == GATT_READ_DESC;
+}
 
 void BtaGattQueue::mark_as_not_executing(uint16_t conn_id) {
-  gatt_op_queue_executing.erase(conn_id);
+  gatt_op_queue_executing_exclusive.erase(conn_id);
+
+  auto executing = gatt_op_queue_executing.find(conn_id);
+  if (executing == gatt_op_queue_executing.end()) return;
+  if (--executing->second == 0) gatt_op_queue_executing.erase(executing);
 }
 
 void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
@@ -51,21 +71,33 @@ void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
   gatt_read_op_data* tmp = (gatt_read_op_data*)data;
   GATT_READ_OP_CB tmp_cb = tmp->cb;
   void* tmp_cb_data = tmp->cb_data;
+  std::vector<gatt_read_cb> coalesced_cbs = std::move(tmp->coalesced_cbs);
 
-  osi_free(data);
+  auto executing = gatt_op_queue_executing_reads.find(conn_id);
+  if (executing != gatt_op_queue_executing_reads.end()) {
+    executing->second.remove(tmp);
+    if (executing->second.empty())
+      gatt_op_queue_executing_reads.erase(executing);
+  }
+  delete tmp;
 
   mark_as_not_executing(conn_id);
   gatt_execute_next_op(conn_id);
 
   if (tmp_cb) {
     tmp_cb(conn_id, status, handle, len, value, tmp_cb_data);
-    return;
+  }
+  for (const gatt_read_cb& coalesced : coalesced_cbs) {
+    if (coalesced.cb) {
+      coalesced.cb(conn_id, status, handle, len, value, coalesced.cb_data);
+    }
   }
 }
 
 struct gatt_write_op_data {
   GATT_WRITE_OP_CB cb;
   void* cb_data;
+  std::vector<BtaGattQueue::gatt_write_cb> coalesced_cbs;
 };
 
 void BtaGattQueue::gatt_write_op_finished(uint16_t conn_id, tGATT_STATUS status,
@@ -74,15 +106,20 @@ void BtaGattQueue::gatt_write_op_finished(uint16_t conn_id, tGATT_STATUS status,
   gatt_write_op_data* tmp = (gatt_write_op_data*)data;
   GATT_WRITE_OP_CB tmp_cb = tmp->cb;
   void* tmp_cb_data = tmp->cb_data;
+  std::vector<gatt_write_cb> coalesced_cbs = std::move(tmp->coalesced_cbs);
 
-  osi_free(data);
+  delete tmp;
 
   mark_as_not_executing(conn_id);
   gatt_execute_next_op(conn_id);
 
+  for (const gatt_write_cb& coalesced : coalesced_cbs) {
+    if (coalesced.cb) {
+      coalesced.cb(conn_id, status, handle, len, value, coalesced.cb_data);
+    }
+  }
   if (tmp_cb) {
     tmp_cb(conn_id, status, handle, len, value, tmp_cb_data);
-    return;
   }
 }
 
@@ -123,47 +160,47 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
     return;
   }
 
-  if (gatt_op_queue_executing.count(conn_id)) {
+  std::list<gatt_operation>& gatt_ops = map_ptr->second;
+
+  gatt_operation& op = gatt_ops.front();
+
+  auto executing = gatt_op_queue_executing.find(conn_id);
+  if (executing != gatt_op_queue_executing.end() &&
+      (!is_read_op(op) || gatt_op_queue_executing_exclusive.count(conn_id) ||
+       executing->second >= GATT_MAX_EXECUTING_READS)) {
     APPL_TRACE_DEBUG("%s: can't enqueue next op, already executing", __func__);
     return;
   }
 
-  gatt_op_queue_executing.insert(conn_id);
-
-  std::list<gatt_operation>& gatt_ops = map_ptr->second;
-
-  gatt_operation& op = gatt_ops.front();
+  gatt_op_queue_executing[conn_id]++;
+  if (!is_read_op(op)) gatt_op_queue_executing_exclusive.insert(conn_id);
 
   if (op.type == GATT_READ_CHAR) {
     gatt_read_op_data* data =
-        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
-    data->cb = op.read_cb;
-    data->cb_data = op.read_cb_data;
+        new gatt_read_op_data{op.type, op.handle, op.read_cb, op.read_cb_data,
+                              std::move(op.coalesced_read_cbs)};
+    gatt_op_queue_executing_reads[conn_id].push_back(data);
     BTA_GATTC_ReadCharacteristic(conn_id, op.handle, GATT_AUTH_REQ_NONE,
                                  gatt_read_op_finished, data);
 
   } else if (op.type == GATT_READ_DESC) {
     gatt_read_op_data* data =
-        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
-    data->cb = op.read_cb;
-    data->cb_data = op.read_cb_data;
+        new gatt_read_op_data{op.type, op.handle, op.read_cb, op.read_cb_data,
+                              std::move(op.coalesced_read_cbs)};
+    gatt_op_queue_executing_reads[conn_id].push_back(data);
     BTA_GATTC_ReadCharDescr(conn_id, op.handle, GATT_AUTH_REQ_NONE,
                             gatt_read_op_finished, data);
 
   } else if (op.type == GATT_WRITE_CHAR) {
-    gatt_write_op_data* data =
-        (gatt_write_op_data*)osi_malloc(sizeof(gatt_write_op_data));
-    data->cb = op.write_cb;
-    data->cb_data = op.write_cb_data;
+    gatt_write_op_data* data = new gatt_write_op_data{
+        op.write_cb, op.write_cb_data, std::move(op.coalesced_write_cbs)};
     BTA_GATTC_WriteCharValue(conn_id, op.handle, op.write_type,
                              std::move(op.value), GATT_AUTH_REQ_NONE,
                              gatt_write_op_finished, data);
 
   } else if (op.type == GATT_WRITE_DESC) {
-    gatt_write_op_data* data =
-        (gatt_write_op_data*)osi_malloc(sizeof(gatt_write_op_data));
-    data->cb = op.write_cb;
-    data->cb_data = op.write_cb_data;
+    gatt_write_op_data* data = new gatt_write_op_data{
+        op.write_cb, op.write_cb_data, std::move(op.coalesced_write_cbs)};
     BTA_GATTC_WriteCharDescr(conn_id, op.handle, std::move(op.value),
                              GATT_AUTH_REQ_NONE, gatt_write_op_finished, data);
   } else if (op.type == GATT_CONFIG_MTU) {
@@ -176,16 +213,87 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
                            gatt_configure_mtu_op_finished, data);
   }
 
+  bool is_read = is_read_op(op);
   gatt_ops.pop_front();
+
+  /* Start the reads following this one */
+  if (is_read) gatt_execute_next_op(conn_id);
 }
 
 void BtaGattQueue::Clean(uint16_t conn_id) {
   gatt_op_queue.erase(conn_id);
   gatt_op_queue_executing.erase(conn_id);
+  gatt_op_queue_executing_exclusive.erase(conn_id);
+  gatt_op_queue_executing_reads.erase(conn_id);
+  gatt_op_queue_coalescing.erase(conn_id);
+}
+
+void BtaGattQueue::SetCoalescing(uint16_t conn_id, bool enable) {
+  if (enable) {
+    gatt_op_queue_coalescing.insert(conn_id);
+  } else {
+    gatt_op_queue_coalescing.erase(conn_id);
+  }
+}
+
+bool BtaGattQueue::coalesce_read(uint16_t conn_id, uint8_t type,
+                                 uint16_t handle, GATT_READ_OP_CB cb,
+                                 void* cb_data) {
+  if (!gatt_op_queue_coalescing.count(conn_id)) return false;
+
+  /* The read can't be coalesced with one queued before a write */
+  auto map_ptr = gatt_op_queue.find(conn_id);
+  if (map_ptr != gatt_op_queue.end()) {
+    for (auto it = map_ptr->second.rbegin(); it != map_ptr->second.rend();
+         it++) {
+      if (!is_read_op(*it)) return false;
+      if (it->type == type && it->handle == handle) {
+        it->coalesced_read_cbs.push_back({cb, cb_data});
+        return true;
+      }
+    }
+  }
+
+  /* Only reads are queued, the executing ones were sent after any write */
+  auto executing = gatt_op_queue_executing_reads.find(conn_id);
+  if (executing == gatt_op_queue_executing_reads.end()) return false;
+  for (gatt_read_op_data* data : executing->second) {
+    if (data->type == type && data->handle == handle) {
+      data->coalesced_cbs.push_back({cb, cb_data});
+      return true;
+    }
+  }
+  return false;
+}
+
+bool BtaGattQueue::coalesce_write(uint16_t conn_id, uint8_t type,
+                                  uint16_t handle, std::vector<uint8_t>& value,
+                                  tGATT_WRITE_TYPE write_type,
+                                  GATT_WRITE_OP_CB cb, void* cb_data) {
+  if (write_type != GATT_WRITE_NO_RSP ||
+      !gatt_op_queue_coalescing.count(conn_id))
+    return false;
+
+  /* Only the last queued write is replaced, so the writes stay in order */
+  auto map_ptr = gatt_op_queue.find(conn_id);
+  if (map_ptr == gatt_op_queue.end() || map_ptr->second.empty()) return false;
+
+  gatt_operation& last = map_ptr->second.back();
+  if (last.type != type || last.handle != handle ||
+      last.write_type != GATT_WRITE_NO_RSP)
+    return false;
+
+  last.coalesced_write_cbs.push_back({last.write_cb, last.write_cb_data});
+  last.write_cb = cb;
+  last.write_cb_data = cb_data;
+  last.value = std::move(value);
+  return true;
 }
 
 void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                       GATT_READ_OP_CB cb, void* cb_data) {
+  if (coalesce_read(conn_id, GATT_READ_CHAR, handle, cb, cb_data)) return;
+
   gatt_op_queue[conn_id].push_back({.type = GATT_READ_CHAR,
                                     .handle = handle,
                                     .read_cb = cb,
@@ -195,6 +303,8 @@ void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
 
 void BtaGattQueue::ReadDescriptor(uint16_t conn_id, uint16_t handle,
                                   GATT_READ_OP_CB cb, void* cb_data) {
+  if (coalesce_read(conn_id, GATT_READ_DESC, handle, cb, cb_data)) return;
+
   gatt_op_queue[conn_id].push_back({.type = GATT_READ_DESC,
                                     .handle = handle,
                                     .read_cb = cb,
@@ -206,6 +316,10 @@ void BtaGattQueue::WriteCharacteristic(uint16_t conn_id, uint16_t handle,
                                        std::vector<uint8_t> value,
                                        tGATT_WRITE_TYPE write_type,
                                        GATT_WRITE_OP_CB cb, void* cb_data) {
+  if (coalesce_write(conn_id, GATT_WRITE_CHAR, handle, value, write_type, cb,
+                     cb_data))
+    return;
+
   gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_CHAR,
                                     .handle = handle,
                                     .write_cb = cb,
@@ -219,6 +333,10 @@ void BtaGattQueue::WriteDescriptor(uint16_t conn_id, uint16_t handle,
                                    std::vector<uint8_t> value,
                                    tGATT_WRITE_TYPE write_type,
                                    GATT_WRITE_OP_CB cb, void* cb_data) {
+  if (coalesce_write(conn_id, GATT_WRITE_DESC, handle, value, write_type, cb,
+                     cb_data))
+    return;
+
   gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_DESC,
                                     .handle = handle,
                                     .write_cb = cb,
@@ -249,6 +249,12 @@ void bta_gattc_clcb_dealloc(tBTA_GATTC_CLCB* p_clcb) {
     osi_free_and_reset((void**)&p_clcb->p_q_cmd);
   }
 
+  while (!p_clcb->p_q_cmd_parallel.empty()) {
+    auto p_q_cmd = p_clcb->p_q_cmd_parallel.front();
+    p_clcb->p_q_cmd_parallel.pop_front();
+    osi_free_and_reset((void**)&p_q_cmd);
+  }
+
   /* Clear p_clcb. Some of the fields are already reset e.g. p_q_cmd_queue and
    * p_q_cmd. */
   p_clcb->bta_conn_id = 0;
@@ -387,6 +393,12 @@ void bta_gattc_continue(tBTA_GATTC_CLCB* p_clcb) {
     return;
   }
 
+  if (!p_clcb->p_q_cmd_parallel.empty()) {
+    LOG_INFO("Reads still outstanding on other bearers for conn_id = 0x%04x",
+             p_clcb->bta_conn_id);
+    return;
+  }
+
   while (!p_clcb->p_q_cmd_queue.empty()) {
     const tBTA_GATTC_DATA* p_q_cmd = p_clcb->p_q_cmd_queue.front();
     if (p_q_cmd->hdr.event != BTA_GATTC_API_CFG_MTU_EVT) {
@@ -440,7 +452,13 @@ bool bta_gattc_is_data_queued(tBTA_GATTC_CLCB* p_clcb,
 
   auto it = std::find(p_clcb->p_q_cmd_queue.begin(),
                       p_clcb->p_q_cmd_queue.end(), p_data);
-  return it != p_clcb->p_q_cmd_queue.end();
+  if (it != p_clcb->p_q_cmd_queue.end()) {
+    return true;
+  }
+
+  return std::find(p_clcb->p_q_cmd_parallel.begin(),
+                   p_clcb->p_q_cmd_parallel.end(),
+                   p_data) != p_clcb->p_q_cmd_parallel.end();
 }
 /*******************************************************************************
  *
@@ -453,7 +471,7 @@ bool bta_gattc_is_data_queued(tBTA_GATTC_CLCB* p_clcb,
  ******************************************************************************/
 BtaEnqueuedResult_t bta_gattc_enqueue(tBTA_GATTC_CLCB* p_clcb,
                                       const tBTA_GATTC_DATA* p_data) {
-  if (p_clcb->p_q_cmd == NULL) {
+  if (p_clcb->p_q_cmd == NULL && p_clcb->p_q_cmd_parallel.empty()) {
     p_clcb->p_q_cmd = p_data;
     return ENQUEUED_READY_TO_SEND;
   }
@@ -481,10 +499,12 @@ bool bta_gattc_check_notif_registry(tBTA_GATTC_RCB* p_clreg,
                                     tBTA_GATTC_NOTIFY* p_notify) {
   uint8_t i;
 
+  /* Run for every notification: the handle, which differs for most of the
+   * registrations, is compared first */
   for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-    if (p_clreg->notif_reg[i].in_use &&
+    if (p_clreg->notif_reg[i].handle == p_notify->handle &&
+        p_clreg->notif_reg[i].in_use &&
         p_clreg->notif_reg[i].remote_bda == p_srcb->server_bda &&
-        p_clreg->notif_reg[i].handle == p_notify->handle &&
         !p_clreg->notif_reg[i].app_disconnected) {
       VLOG(1) << "Notification registered!";
       return true;
@@ -42,6 +42,10 @@ const Uuid CHARACTERISTIC = Uuid::From16Bit(GATT_UUID_CHAR_DECLARE);
 const Uuid CHARACTERISTIC_EXTENDED_PROPERTIES =
     Uuid::From16Bit(GATT_UUID_CHAR_EXT_PROP);
 
+/* The handle table is built when it spans at most that many handles per
+ * indexed attribute, which bounds it to a fraction of the index size. */
+constexpr size_t HANDLE_TABLE_MAX_HANDLES_PER_ATTRIBUTE = 4;
+
 bool HandleInRange(const Service& svc, uint16_t handle) {
   return handle >= svc.handle && handle <= svc.end_handle;
 }
@@ -61,6 +65,136 @@ Service* FindService(std::list<Service>& services, uint16_t handle) {
   return nullptr;
 }
 
+void Database::BuildIndex() {
+  size_t size = 0;
+  for (const Service& service : services) {
+    for (const Characteristic& charac : service.characteristics) {
+      size += 1 + charac.descriptors.size();
+    }
+  }
+
+  service_index.clear();
+  service_index.reserve(services.size());
+  index.clear();
+  index.reserve(size);
+  for (const Service& service : services) {
+    service_index.push_back(&service);
+    for (const Characteristic& charac : service.characteristics) {
+      index.push_back({charac.value_handle, &service, &charac, nullptr});
+      for (const Descriptor& desc : charac.descriptors) {
+        index.push_back({desc.handle, &service, &charac, &desc});
+      }
+    }
+  }
+
+  // Attributes sharing a handle keep the order of the services, like the
+  // lookups walking them did.
+  std::stable_sort(
+      service_index.begin(), service_index.end(),
+      [](const Service* a, const Service* b) { return a->handle < b->handle; });
+  std::stable_sort(index.begin(), index.end(),
+                   [](const IndexEntry& a, const IndexEntry& b) {
+                     return a.handle < b.handle;
+                   });
+
+  handle_table.clear();
+  if (index.empty() || index.size() >= UINT16_MAX) return;
+
+  size_t span = index.back().handle - index.front().handle + 1;
+  if (span > HANDLE_TABLE_MAX_HANDLES_PER_ATTRIBUTE * index.size()) return;
+
+  handle_table_base = index.front().handle;
+  handle_table.resize(span, 0);
+  for (size_t i = index.size(); i-- > 0;) {
+    handle_table[index[i].handle - handle_table_base] = i + 1;
+  }
+}
+
+std::pair<Database::IndexIterator, Database::IndexIterator>
+Database::FindEntries(uint16_t handle) const {
+  if (!handle_table.empty()) {
+    size_t offset = handle - handle_table_base;
+    if (handle < handle_table_base || offset >= handle_table.size()) {
+      return {index.end(), index.end()};
+    }
+    uint16_t position = handle_table[offset];
+    if (position == 0) return {index.end(), index.end()};
+
+    auto first = index.begin() + (position - 1);
+    auto last = std::next(first);
+    while (last != index.end() && last->handle == handle) last++;
+    return {first, last};
+  }
+
+  auto first = std::lower_bound(
+      index.begin(), index.end(), handle,
+      [](const IndexEntry& e, uint16_t handle) { return e.handle < handle; });
+  auto last = std::upper_bound(
+      first, index.end(), handle,
+      [](uint16_t handle, const IndexEntry& e) { return handle < e.handle; });
+  return {first, last};
+}
+
+const Service* Database::FindService(uint16_t handle) const {
+  // Last service starting at or before |handle|.
+  auto it = std::upper_bound(
+      service_index.begin(), service_index.end(), handle,
+      [](uint16_t handle, const Service* s) { return handle < s->handle; });
+  if (it == service_index.begin()) return nullptr;
+  --it;
+  return HandleInRange(**it, handle) ? *it : nullptr;
+}
+
+const Characteristic* Database::FindCharacteristic(
+    uint16_t value_handle) const {
+  auto range = FindEntries(value_handle);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->characteristic != nullptr && it->descriptor == nullptr &&
+        HandleInRange(*it->service, value_handle)) {
+      return it->characteristic;
+    }
+  }
+  return nullptr;
+}
+
+const Descriptor* Database::FindDescriptor(uint16_t handle) const {
+  auto range = FindEntries(handle);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->descriptor != nullptr && HandleInRange(*it->service, handle)) {
+      return it->descriptor;
+    }
+  }
+  return nullptr;
+}
+
+const Characteristic* Database::FindOwningCharacteristic(
+    uint16_t handle) const {
+  auto range = FindEntries(handle);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->descriptor != nullptr && HandleInRange(*it->service, handle)) {
+      return it->characteristic;
+    }
+  }
+  return nullptr;
+}
+
+void Database::Splice(Database other, uint16_t start_handle,
+                      uint16_t end_handle) {
+  services.remove_if([&](const Service& service) {
+    if (service.handle <= end_handle && service.end_handle >= start_handle) {
+      return true;
+    }
+    const Service* replacement = other.FindService(service.handle);
+    return replacement && replacement->handle == service.handle;
+  });
+
+  // Both lists are sorted by handle
+  services.merge(other.services, [](const Service& a, const Service& b) {
+    return a.handle < b.handle;
+  });
+  BuildIndex();
+}
+
 std::string Database::ToString() const {
   std::stringstream tmp;
 
@@ -139,11 +273,17 @@ std::vector<StoredAttribute> Database::Serialize() const {
 
 Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
                                bool* success) {
+  return Deserialize(nv_attr.data(), nv_attr.size(), success);
+}
+
+Database Database::Deserialize(const StoredAttribute* nv_attr, size_t count,
+                               bool* success) {
   // clear reallocating
   Database result;
-  auto it = nv_attr.cbegin();
+  const StoredAttribute* it = nv_attr;
+  const StoredAttribute* end = nv_attr + count;
 
-  for (; it != nv_attr.cend(); ++it) {
+  for (; it != end; ++it) {
     const auto& attr = *it;
     if (attr.type != PRIMARY_SERVICE && attr.type != SECONDARY_SERVICE) break;
     result.services.emplace_back(Service{
@@ -155,7 +295,7 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
   }
 
   auto current_service_it = result.services.begin();
-  for (; it != nv_attr.cend(); it++) {
+  for (; it != end; it++) {
     const auto& attr = *it;
 
     // go to the service this attribute belongs to; attributes are stored in
@@ -170,15 +310,17 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
       LOG(ERROR) << "Can't find service for attribute with handle: "
                  << loghex(attr.handle);
       *success = false;
+      result.BuildIndex();
       return result;
     }
 
     if (attr.type == INCLUDE) {
-      Service* included_service =
-          FindService(result.services, attr.value.included_service.handle);
+      Service* included_service = gatt::FindService(
+          result.services, attr.value.included_service.handle);
       if (!included_service) {
         LOG(ERROR) << __func__ << ": Non-existing included service!";
         *success = false;
+        result.BuildIndex();
         return result;
       }
       current_service_it->included_services.push_back(IncludedService{
@@ -210,6 +352,7 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
     }
   }
   *success = true;
+  result.BuildIndex();
   return result;
 }
 
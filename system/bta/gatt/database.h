@@ -102,16 +102,54 @@ class DatabaseBuilder;
 
 class Database {
  public:
+  Database() = default;
+  /* Copies rebuild the handle index, which points into the services. */
+  Database(const Database& other) : services(other.services) { BuildIndex(); }
+  Database& operator=(const Database& other) {
+    if (this != &other) {
+      services = other.services;
+      BuildIndex();
+    }
+    return *this;
+  }
+  Database(Database&&) = default;
+  Database& operator=(Database&&) = default;
+
   /* Return true if there are no services in this database. */
   bool IsEmpty() const { return services.empty(); }
 
   /* Clear the GATT database. This method forces relocation to ensure no extra
    * space is used unnecesarly */
-  void Clear() { std::list<Service>().swap(services); }
+  void Clear() {
+    std::list<Service>().swap(services);
+    std::vector<const Service*>().swap(service_index);
+    std::vector<IndexEntry>().swap(index);
+    std::vector<uint16_t>().swap(handle_table);
+  }
 
   /* Return list of services available in this database */
   const std::list<Service>& Services() const { return services; }
 
+  /* Return the service containing |handle|, or nullptr if there is none */
+  const Service* FindService(uint16_t handle) const;
+
+  /* Return the characteristic whose value handle is |value_handle|, or nullptr
+   * if there is none */
+  const Characteristic* FindCharacteristic(uint16_t value_handle) const;
+
+  /* Return the descriptor with |handle|, or nullptr if there is none */
+  const Descriptor* FindDescriptor(uint16_t handle) const;
+
+  /* Return the characteristic owning the descriptor with |handle|, or nullptr
+   * if there is none */
+  const Characteristic* FindOwningCharacteristic(uint16_t handle) const;
+
+  /* Replace the services overlapping the |start_handle| - |end_handle| range
+   * by the services of |other|, discovered in this range. A service of
+   * |other| outside of the range, i.e. an included secondary service,
+   * replaces the service with the same handle. */
+  void Splice(Database other, uint16_t start_handle, uint16_t end_handle);
+
   std::string ToString() const;
 
   std::vector<gatt::StoredAttribute> Serialize() const;
@@ -119,13 +157,47 @@ class Database {
   static Database Deserialize(const std::vector<gatt::StoredAttribute>& nv_attr,
                               bool* success);
 
+  /* Same as above, for |count| attributes stored at |nv_attr|, i.e. in a
+   * mapped cache file */
+  static Database Deserialize(const gatt::StoredAttribute* nv_attr,
+                              size_t count, bool* success);
+
   /* Return 128 bit unique identifier of this GATT database */
   Octet16 Hash() const;
 
   friend class DatabaseBuilder;
 
  private:
+  /* Entry of the handle index, for a characteristic value or a descriptor. */
+  struct IndexEntry {
+    uint16_t handle;
+    const Service* service;
+    const Characteristic* characteristic;
+    const Descriptor* descriptor;
+  };
+
+  using IndexIterator = std::vector<IndexEntry>::const_iterator;
+
+  /* Return the range of |index| entries with |handle| */
+  std::pair<IndexIterator, IndexIterator> FindEntries(uint16_t handle) const;
+
+  /* Rebuild the indexes from |services|. Must be called whenever |services| is
+   * modified. */
+  void BuildIndex();
+
   std::list<Service> services;
+
+  /* Contiguous indexes of the services and attributes, sorted by handle, so
+   * that lookups don't walk the services, characteristics and descriptors. */
+  std::vector<const Service*> service_index;
+  std::vector<IndexEntry> index;
+
+  /* Direct table from handle - |handle_table_base| to 1 + the position of the
+   * first |index| entry with that handle, or 0 if there is none. Only built
+   * when the handles are dense enough, lookups binary search |index|
+   * otherwise. */
+  uint16_t handle_table_base = 0;
+  std::vector<uint16_t> handle_table;
 };
 
 /* Find a service that should contain handle. Helper method for internal use
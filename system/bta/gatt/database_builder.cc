@@ -36,32 +36,90 @@ using bluetooth::Uuid;
 
 namespace gatt {
 
+namespace {
+bool HandleInRange(const Service& svc, uint16_t handle) {
+  return handle >= svc.handle && handle <= svc.end_handle;
+}
+}  // namespace
+
+const Service* DatabaseBuilder::FindPendingService(uint16_t handle) const {
+  // Last service starting at or before |handle|.
+  auto it = std::upper_bound(
+      services.begin(), services.end(), handle,
+      [](uint16_t handle, const Service& s) { return handle < s.handle; });
+  if (it == services.begin()) return nullptr;
+  --it;
+  return HandleInRange(*it, handle) ? &(*it) : nullptr;
+}
+
+std::pair<std::vector<DatabaseBuilder::PendingCharacteristic>::const_iterator,
+          std::vector<DatabaseBuilder::PendingCharacteristic>::const_iterator>
+DatabaseBuilder::CharacteristicsOf(uint16_t service_handle) const {
+  auto first = std::lower_bound(
+      characteristics.begin(), characteristics.end(), service_handle,
+      [](const PendingCharacteristic& c, uint16_t service_handle) {
+        return c.service_handle < service_handle;
+      });
+  auto last = std::upper_bound(
+      first, characteristics.end(), service_handle,
+      [](uint16_t service_handle, const PendingCharacteristic& c) {
+        return service_handle < c.service_handle;
+      });
+  return {first, last};
+}
+
+std::pair<size_t, size_t> DatabaseBuilder::DescriptorsOf(
+    uint16_t service_handle, uint16_t characteristic_handle) const {
+  auto key = std::make_pair(service_handle, characteristic_handle);
+  auto first = std::lower_bound(
+      descriptors.begin(), descriptors.end(), key,
+      [](const PendingDescriptor& d, const std::pair<uint16_t, uint16_t>& key) {
+        return std::make_pair(d.service_handle, d.characteristic_handle) < key;
+      });
+  auto last = std::upper_bound(
+      first, descriptors.end(), key,
+      [](const std::pair<uint16_t, uint16_t>& key, const PendingDescriptor& d) {
+        return key < std::make_pair(d.service_handle, d.characteristic_handle);
+      });
+  return {first - descriptors.begin(), last - descriptors.begin()};
+}
+
+const Characteristic* DatabaseBuilder::OwningCharacteristic(
+    uint16_t service_handle, uint16_t handle) const {
+  auto range = CharacteristicsOf(service_handle);
+  if (range.first == range.second) return nullptr;
+
+  const Characteristic* char_node = &range.first->characteristic;
+  for (auto it = range.first; it != range.second; it++) {
+    if (it->characteristic.declaration_handle > handle) break;
+    char_node = &it->characteristic;
+  }
+  return char_node;
+}
+
 void DatabaseBuilder::AddService(uint16_t handle, uint16_t end_handle,
                                  const Uuid& uuid, bool is_primary) {
   // general case optimization - we add services in order
-  if (database.services.empty() ||
-      database.services.back().end_handle < handle) {
-    database.services.emplace_back(Service{
+  if (services.empty() || services.back().end_handle < handle) {
+    services.emplace_back(Service{
         .handle = handle,
         .uuid = uuid,
         .is_primary = is_primary,
         .end_handle = end_handle,
     });
   } else {
-    auto& vec = database.services;
-
     // Find first service whose start handle is bigger than new service handle
     auto it = std::lower_bound(
-        vec.begin(), vec.end(), handle,
-        [](Service s, uint16_t handle) { return s.end_handle < handle; });
+        services.begin(), services.end(), handle,
+        [](const Service& s, uint16_t handle) { return s.end_handle < handle; });
 
     // Insert new service just before it
-    vec.emplace(it, Service{
-                        .handle = handle,
-                        .uuid = uuid,
-                        .is_primary = is_primary,
-                        .end_handle = end_handle,
-                    });
+    services.emplace(it, Service{
+                             .handle = handle,
+                             .uuid = uuid,
+                             .is_primary = is_primary,
+                             .end_handle = end_handle,
+                         });
   }
 
   services_to_discover.insert({handle, end_handle});
@@ -70,29 +128,40 @@ void DatabaseBuilder::AddService(uint16_t handle, uint16_t end_handle,
 void DatabaseBuilder::AddIncludedService(uint16_t handle, const Uuid& uuid,
                                          uint16_t start_handle,
                                          uint16_t end_handle) {
-  Service* service = FindService(database.services, handle);
+  const Service* service = FindPendingService(handle);
   if (!service) {
     LOG(ERROR) << "Illegal action to add to non-existing service!";
     return;
   }
+  // |service| is invalidated by adding a service below.
+  uint16_t service_handle = service->handle;
 
   /* We discover all Primary Services first. If included service was not seen
    * before, it must be a Secondary Service */
-  if (!FindService(database.services, start_handle)) {
+  if (!FindPendingService(start_handle)) {
     AddService(start_handle, end_handle, uuid, false /* not primary */);
   }
 
-  service->included_services.push_back(IncludedService{
-      .handle = handle,
-      .uuid = uuid,
-      .start_handle = start_handle,
-      .end_handle = end_handle,
-  });
+  auto it = std::upper_bound(
+      included_services.begin(), included_services.end(), service_handle,
+      [](uint16_t service_handle, const PendingIncludedService& is) {
+        return service_handle < is.service_handle;
+      });
+  included_services.insert(it, PendingIncludedService{
+                                   .service_handle = service_handle,
+                                   .included_service =
+                                       IncludedService{
+                                           .handle = handle,
+                                           .uuid = uuid,
+                                           .start_handle = start_handle,
+                                           .end_handle = end_handle,
+                                       },
+                               });
 }
 
 void DatabaseBuilder::AddCharacteristic(uint16_t handle, uint16_t value_handle,
                                         const Uuid& uuid, uint8_t properties) {
-  Service* service = FindService(database.services, handle);
+  const Service* service = FindPendingService(handle);
   if (!service) {
     LOG(ERROR) << "Illegal action to add to non-existing service!";
     return;
@@ -103,37 +172,43 @@ void DatabaseBuilder::AddCharacteristic(uint16_t handle, uint16_t value_handle,
                  << loghex(value_handle) << " is after service end_handle="
                  << loghex(service->end_handle);
 
-  service->characteristics.emplace_back(Characteristic{
-      .declaration_handle = handle,
-      .uuid = uuid,
-      .value_handle = value_handle,
-      .properties = properties,
-  });
+  characteristics.insert(CharacteristicsOf(service->handle).second,
+                         PendingCharacteristic{
+                             .service_handle = service->handle,
+                             .characteristic =
+                                 Characteristic{
+                                     .declaration_handle = handle,
+                                     .uuid = uuid,
+                                     .value_handle = value_handle,
+                                     .properties = properties,
+                                 },
+                         });
   return;
 }
 
 void DatabaseBuilder::AddDescriptor(uint16_t handle, const Uuid& uuid) {
-  Service* service = FindService(database.services, handle);
+  const Service* service = FindPendingService(handle);
   if (!service) {
     LOG(ERROR) << "Illegal action to add to non-existing service!";
     return;
   }
 
-  if (service->characteristics.empty()) {
+  const Characteristic* char_node =
+      OwningCharacteristic(service->handle, handle);
+  if (!char_node) {
     LOG(ERROR) << __func__
                << ": Illegal action to add to non-existing characteristic!";
     return;
   }
 
-  Characteristic* char_node = &service->characteristics.front();
-  for (auto it = service->characteristics.begin();
-       it != service->characteristics.end(); it++) {
-    if (it->declaration_handle > handle) break;
-    char_node = &(*it);
-  }
-
-  char_node->descriptors.emplace_back(
-      gatt::Descriptor{.handle = handle, .uuid = uuid});
+  auto range = DescriptorsOf(service->handle, char_node->declaration_handle);
+  descriptors.insert(
+      descriptors.begin() + range.second,
+      PendingDescriptor{
+          .service_handle = service->handle,
+          .characteristic_handle = char_node->declaration_handle,
+          .descriptor = gatt::Descriptor{.handle = handle, .uuid = uuid},
+      });
 
   // We must read value for Characteristic Extended Properties
   if (uuid == Uuid::From16Bit(GATT_UUID_CHAR_EXT_PROP)) {
@@ -162,23 +237,23 @@ DatabaseBuilder::CurrentlyExploredService() {
 }
 
 std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore() {
-  Service* service = FindService(database.services, pending_service.first);
-  if (!service || service->characteristics.empty()) {
+  const Service* service = FindPendingService(pending_service.first);
+  if (!service) {
     return {HANDLE_MAX, HANDLE_MAX};
   }
 
-  for (auto it = service->characteristics.cbegin();
-       it != service->characteristics.cend(); it++) {
-    if (it->declaration_handle > pending_characteristic) {
+  auto range = CharacteristicsOf(service->handle);
+  for (auto it = range.first; it != range.second; it++) {
+    if (it->characteristic.declaration_handle > pending_characteristic) {
       auto next = std::next(it);
 
       /* Characteristic Declaration is followed by Characteristic Value
        * Declaration, first descriptor is after that, see BT Spect 5.0 Vol 3,
        * Part G 3.3.2 and 3.3.3 */
-      uint16_t start = it->declaration_handle + 2;
+      uint16_t start = it->characteristic.declaration_handle + 2;
       uint16_t end;
-      if (next != service->characteristics.end())
-        end = next->declaration_handle - 1;
+      if (next != range.second)
+        end = next->characteristic.declaration_handle - 1;
       else
         end = service->end_handle;
 
@@ -194,25 +269,6 @@ std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore() {
   return {HANDLE_MAX, HANDLE_MAX};
 }
 
-Descriptor* FindDescriptorByHandle(std::list<Service>& services,
-                                   uint16_t handle) {
-  Service* service = FindService(services, handle);
-  if (!service) return nullptr;
-
-  Characteristic* char_node = &service->characteristics.front();
-  for (auto it = service->characteristics.begin();
-       it != service->characteristics.end(); it++) {
-    if (it->declaration_handle > handle) break;
-    char_node = &(*it);
-  }
-
-  for (auto& descriptor : char_node->descriptors) {
-    if (descriptor.handle == handle) return &descriptor;
-  }
-
-  return nullptr;
-}
-
 bool DatabaseBuilder::SetValueOfDescriptors(
     const std::vector<uint16_t>& values) {
   if (values.size() > descriptor_handles_to_read.size()) {
@@ -222,8 +278,20 @@ bool DatabaseBuilder::SetValueOfDescriptors(
   }
 
   for (size_t i = 0; i < values.size(); i++) {
-    Descriptor* d = FindDescriptorByHandle(database.services,
-                                           descriptor_handles_to_read[i]);
+    uint16_t handle = descriptor_handles_to_read[i];
+    const Service* service = FindPendingService(handle);
+    const Characteristic* char_node =
+        service ? OwningCharacteristic(service->handle, handle) : nullptr;
+
+    Descriptor* d = nullptr;
+    if (char_node) {
+      auto range = DescriptorsOf(service->handle, char_node->declaration_handle);
+      for (size_t j = range.first; j < range.second && !d; j++) {
+        if (descriptors[j].descriptor.handle == handle) {
+          d = &descriptors[j].descriptor;
+        }
+      }
+    }
     if (!d) {
       LOG(ERROR) << __func__ << "non-existing descriptor!";
       descriptor_handles_to_read.clear();
@@ -239,16 +307,78 @@ bool DatabaseBuilder::SetValueOfDescriptors(
   return true;
 }
 
-bool DatabaseBuilder::InProgress() const { return !database.services.empty(); }
+bool DatabaseBuilder::InProgress() const { return !services.empty(); }
+
+Database DatabaseBuilder::Assemble() const {
+  Database result;
+  auto included_it = included_services.begin();
+  auto char_it = characteristics.begin();
+
+  // The attributes are sorted by owning service, visited in the same order.
+  for (const Service& pending : services) {
+    Service& service = result.services.emplace_back(Service{
+        .handle = pending.handle,
+        .uuid = pending.uuid,
+        .is_primary = pending.is_primary,
+        .end_handle = pending.end_handle,
+    });
+
+    auto included_end = included_it;
+    while (included_end != included_services.end() &&
+           included_end->service_handle == pending.handle) {
+      included_end++;
+    }
+    service.included_services.reserve(included_end - included_it);
+    for (; included_it != included_end; included_it++) {
+      service.included_services.push_back(included_it->included_service);
+    }
+
+    auto char_end = char_it;
+    while (char_end != characteristics.end() &&
+           char_end->service_handle == pending.handle) {
+      char_end++;
+    }
+    service.characteristics.reserve(char_end - char_it);
+    for (auto it = char_it; it != char_end; it++) {
+      Characteristic& charac =
+          service.characteristics.emplace_back(it->characteristic);
+
+      // Descriptors of characteristics sharing a declaration handle all go
+      // to the first one.
+      if (std::any_of(char_it, it, [&](const PendingCharacteristic& c) {
+            return c.characteristic.declaration_handle ==
+                   charac.declaration_handle;
+          })) {
+        continue;
+      }
+      auto range = DescriptorsOf(pending.handle, charac.declaration_handle);
+      charac.descriptors.reserve(range.second - range.first);
+      for (size_t i = range.first; i < range.second; i++) {
+        charac.descriptors.push_back(descriptors[i].descriptor);
+      }
+    }
+    char_it = char_end;
+  }
+
+  result.BuildIndex();
+  return result;
+}
+
+void DatabaseBuilder::ClearAttributes() {
+  std::vector<Service>().swap(services);
+  std::vector<PendingIncludedService>().swap(included_services);
+  std::vector<PendingCharacteristic>().swap(characteristics);
+  std::vector<PendingDescriptor>().swap(descriptors);
+}
 
 Database DatabaseBuilder::Build() {
-  Database tmp = database;
-  database.Clear();
-  return tmp;
+  Database result = Assemble();
+  ClearAttributes();
+  return result;
 }
 
-void DatabaseBuilder::Clear() { database.Clear(); }
+void DatabaseBuilder::Clear() { ClearAttributes(); }
 
-std::string DatabaseBuilder::ToString() const { return database.ToString(); }
+std::string DatabaseBuilder::ToString() const { return Assemble().ToString(); }
 
 }  // namespace gatt
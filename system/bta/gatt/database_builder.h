@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include <set>
 #include <utility>
+#include <vector>
 
 #include "bta/gatt/database.h"
 #include "types/bluetooth/uuid.h"
@@ -80,7 +82,60 @@ class DatabaseBuilder {
   std::string ToString() const;
 
  private:
-  Database database;
+  /* Discovered attributes are kept in flat vectors, grouped by owning
+   * service (and characteristic for descriptors) and in discovery order
+   * within a group. They are only laid out as a Database by Build(), with
+   * every vector of the Database allocated once at its final size. */
+  struct PendingIncludedService {
+    uint16_t service_handle;
+    IncludedService included_service;
+  };
+
+  struct PendingCharacteristic {
+    uint16_t service_handle;
+    /* descriptors are kept in |descriptors| */
+    Characteristic characteristic;
+  };
+
+  struct PendingDescriptor {
+    uint16_t service_handle;
+    uint16_t characteristic_handle; /* declaration handle */
+    Descriptor descriptor;
+  };
+
+  /* Return the discovered service containing |handle|, or nullptr. */
+  const Service* FindPendingService(uint16_t handle) const;
+
+  /* Return the range of |characteristics| owned by the service starting at
+   * |service_handle| */
+  std::pair<std::vector<PendingCharacteristic>::const_iterator,
+            std::vector<PendingCharacteristic>::const_iterator>
+  CharacteristicsOf(uint16_t service_handle) const;
+
+  /* Return the range of indexes in |descriptors| of the descriptors owned by
+   * the characteristic declared at |characteristic_handle| in the service
+   * starting at |service_handle| */
+  std::pair<size_t, size_t> DescriptorsOf(uint16_t service_handle,
+                                          uint16_t characteristic_handle) const;
+
+  /* Return the characteristic of the service starting at |service_handle|
+   * owning the descriptor at |handle|, or nullptr if the service has no
+   * characteristics. */
+  const Characteristic* OwningCharacteristic(uint16_t service_handle,
+                                             uint16_t handle) const;
+
+  /* Lay out the discovered attributes as a Database */
+  Database Assemble() const;
+
+  void ClearAttributes();
+
+  /* services, sorted by handle; their included services and characteristics
+   * are empty. */
+  std::vector<Service> services;
+  std::vector<PendingIncludedService> included_services;
+  std::vector<PendingCharacteristic> characteristics;
+  std::vector<PendingDescriptor> descriptors;
+
   /* Start and end handle of service that is currently being discovered on the
    * remote device */
   std::pair<uint16_t, uint16_t> pending_service;
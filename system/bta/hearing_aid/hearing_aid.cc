@@ -25,6 +25,7 @@
 #include <base/logging.h>
 #include <base/strings/string_number_conversions.h>  // HexEncode
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <mutex>
@@ -37,6 +38,7 @@
 #include "common/init_flags.h"
 #include "device/include/controller.h"
 #include "embdrv/g722/g722_enc_dec.h"
+#include "osi/include/allocator.h"
 #include "osi/include/compat.h"
 #include "osi/include/log.h"
 #include "osi/include/properties.h"
@@ -115,8 +117,8 @@ void encryption_callback(const RawAddress*, tBT_TRANSPORT, void*, tBTM_STATUS);
 void read_rssi_cb(void* p_void);
 
 inline BT_HDR* malloc_l2cap_buf(uint16_t len) {
-  BT_HDR* msg = (BT_HDR*)osi_malloc(BT_HDR_SIZE + L2CAP_MIN_OFFSET +
-                                    len /* LE-only, no need for FCS here */);
+  BT_HDR* msg = (BT_HDR*)osi_malloc_packet(
+      BT_HDR_SIZE + L2CAP_MIN_OFFSET + len /* LE-only, no need for FCS here */);
   msg->offset = L2CAP_MIN_OFFSET;
   msg->len = len;
   return msg;
@@ -1364,8 +1366,10 @@ class HearingAidImpl : public HearingAid {
       return;
     }
 
-    std::vector<uint16_t> chan_left;
-    std::vector<uint16_t> chan_right;
+    // The channel buffers are kept across calls, so that their storage is
+    // only allocated when the stream starts.
+    chan_left.resize(num_samples);
+    chan_right.resize(num_samples);
     if (left == nullptr || right == nullptr) {
       for (int i = 0; i < num_samples; i++) {
         const uint8_t* sample = data.data() + i * 4;
@@ -1375,41 +1379,25 @@ class HearingAidImpl : public HearingAid {
         sample += 2;
         int16_t right = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
 
-        uint16_t mono_data = (int16_t)(((uint32_t)left + (uint32_t)right) >> 1);
-        chan_left.push_back(mono_data);
-        chan_right.push_back(mono_data);
+        int16_t mono_data = (int16_t)(((uint32_t)left + (uint32_t)right) >> 1);
+        chan_left[i] = mono_data;
+        chan_right[i] = mono_data;
       }
     } else {
       for (int i = 0; i < num_samples; i++) {
         const uint8_t* sample = data.data() + i * 4;
 
-        uint16_t left = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
-        chan_left.push_back(left);
+        chan_left[i] = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
 
         sample += 2;
-        uint16_t right = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
-        chan_right.push_back(right);
+        chan_right[i] = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
       }
     }
 
     // TODO: monural, binarual check
 
-    // divide encoded data into packets, add header, send.
-
-    // TODO: make those buffers static and global to prevent constant
-    // reallocations
-    // TODO: this should basically fit the encoded data, tune the size later
-    std::vector<uint8_t> encoded_data_left;
     auto time_point = std::chrono::steady_clock::now();
     if (left) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_left.resize(4000);
-      int encoded_size =
-          g722_encode(encoder_state_left, encoded_data_left.data(),
-                      (const int16_t*)chan_left.data(), chan_left.size());
-      encoded_data_left.resize(encoded_size);
-
       uint16_t cid = GAP_ConnGetL2CAPCid(left->gap_handle);
       uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
       if (packets_in_chans) {
@@ -1434,16 +1422,7 @@ class HearingAidImpl : public HearingAid {
       check_and_do_rssi_read(left);
     }
 
-    std::vector<uint8_t> encoded_data_right;
     if (right) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_right.resize(4000);
-      int encoded_size =
-          g722_encode(encoder_state_right, encoded_data_right.data(),
-                      (const int16_t*)chan_right.data(), chan_right.size());
-      encoded_data_right.resize(encoded_size);
-
       uint16_t cid = GAP_ConnGetL2CAPCid(right->gap_handle);
       uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
       if (packets_in_chans) {
@@ -1468,14 +1447,24 @@ class HearingAidImpl : public HearingAid {
       check_and_do_rssi_read(right);
     }
 
-    size_t encoded_data_size =
-        std::max(encoded_data_left.size(), encoded_data_right.size());
-
     uint16_t packet_size =
         CalcCompressedAudioPacketSize(codec_in_use, default_data_interval_ms);
+    // G.722 at 64 kbit/s encodes each pair of samples in one byte
+    int samples_per_packet = packet_size * 2;
 
     if (need_drop) {
       last_drop_time_point = time_point;
+      // The frame is still encoded, so that the encoders don't miss it
+      for (int i = 0; i < num_samples; i += samples_per_packet) {
+        int count = std::min(samples_per_packet, num_samples - i);
+        if (left) {
+          osi_free(EncodeAudioPacket(encoder_state_left, &chan_left[i], count));
+        }
+        if (right) {
+          osi_free(
+              EncodeAudioPacket(encoder_state_right, &chan_right[i], count));
+        }
+      }
       if (left) {
         left->audio_stats.packet_drop_count++;
       }
@@ -1485,14 +1474,19 @@ class HearingAidImpl : public HearingAid {
       return;
     }
 
-    for (size_t i = 0; i < encoded_data_size; i += packet_size) {
+    // Divide the frame into packets, each encoded in place after its header
+    for (int i = 0; i < num_samples; i += samples_per_packet) {
+      int count = std::min(samples_per_packet, num_samples - i);
       if (left) {
         left->audio_stats.packet_send_count++;
-        SendAudio(encoded_data_left.data() + i, packet_size, left);
+        SendAudio(EncodeAudioPacket(encoder_state_left, &chan_left[i], count),
+                  left);
       }
       if (right) {
         right->audio_stats.packet_send_count++;
-        SendAudio(encoded_data_right.data() + i, packet_size, right);
+        SendAudio(
+            EncodeAudioPacket(encoder_state_right, &chan_right[i], count),
+            right);
       }
       seq_counter++;
     }
@@ -1500,23 +1494,30 @@ class HearingAidImpl : public HearingAid {
     if (right) right->audio_stats.frame_send_count++;
   }
 
-  void SendAudio(uint8_t* encoded_data, uint16_t packet_size,
-                 HearingDevice* hearingAid) {
+  /* Returns an L2CAP buffer carrying the sequence number followed by the
+   * G.722 encoding of the |num_samples| |samples|. */
+  BT_HDR* EncodeAudioPacket(g722_encode_state_t* encoder_state,
+                            const int16_t* samples, int num_samples) {
+    BT_HDR* audio_packet = malloc_l2cap_buf(1 + num_samples / 2);
+    uint8_t* p = get_l2cap_sdu_start_ptr(audio_packet);
+    *p = seq_counter;
+    int encoded_size = g722_encode(encoder_state, p + 1, samples, num_samples);
+    audio_packet->len = 1 + encoded_size;
+    return audio_packet;
+  }
+
+  void SendAudio(BT_HDR* audio_packet, HearingDevice* hearingAid) {
     if (!hearingAid->playback_started || !hearingAid->command_acked) {
       LOG_DEBUG("Playback stalled, device=%s,cmd send=%i, cmd acked=%i",
                 ADDRESS_TO_LOGGABLE_CSTR(hearingAid->address),
                 hearingAid->playback_started, hearingAid->command_acked);
+      osi_free(audio_packet);
       return;
     }
 
-    BT_HDR* audio_packet = malloc_l2cap_buf(packet_size + 1);
-    uint8_t* p = get_l2cap_sdu_start_ptr(audio_packet);
-    *p = seq_counter;
-    p++;
-    memcpy(p, encoded_data, packet_size);
-
+    uint8_t* p = get_l2cap_sdu_start_ptr(audio_packet) + 1;
     LOG_DEBUG("%s : %s", ADDRESS_TO_LOGGABLE_CSTR(hearingAid->address),
-              base::HexEncode(p, packet_size).c_str());
+              base::HexEncode(p, audio_packet->len - 1).c_str());
 
     uint16_t result = GAP_ConnWriteData(hearingAid->gap_handle, audio_packet);
 
@@ -1843,6 +1844,9 @@ class HearingAidImpl : public HearingAid {
  private:
   uint8_t gatt_if;
   uint8_t seq_counter;
+  /* PCM of each side, reused for every frame of the stream */
+  std::vector<int16_t> chan_left;
+  std::vector<int16_t> chan_right;
   /* current volume gain for the hearing aids*/
   int8_t current_volume;
   bluetooth::hearing_aid::HearingAidCallbacks* callbacks;
@@ -90,14 +90,18 @@ void send_audio_data() {
   uint32_t bytes_per_tick =
       (num_channels * sample_rate * data_interval_ms * (bit_rate / 8)) / 1000;
 
-  uint8_t p_buf[bytes_per_tick];
+  // Read in place into a buffer kept across the ticks, which only allocates
+  // when the stream starts.
+  static std::vector<uint8_t> data;
+  data.resize(bytes_per_tick);
 
   uint32_t bytes_read;
   if (bluetooth::audio::hearing_aid::is_hal_enabled()) {
-    bytes_read = bluetooth::audio::hearing_aid::read(p_buf, bytes_per_tick);
+    bytes_read =
+        bluetooth::audio::hearing_aid::read(data.data(), bytes_per_tick);
   } else {
-    bytes_read = UIPC_Read(*uipc_hearing_aid, UIPC_CH_ID_AV_AUDIO, p_buf,
-                           bytes_per_tick);
+    bytes_read = UIPC_Read(*uipc_hearing_aid, UIPC_CH_ID_AV_AUDIO,
+                           data.data(), bytes_per_tick);
   }
 
   LOG_DEBUG("bytes_read: %u", bytes_read);
@@ -108,7 +112,7 @@ void send_audio_data() {
         bluetooth::common::time_get_os_boottime_us();
   }
 
-  std::vector<uint8_t> data(p_buf, p_buf + bytes_read);
+  data.resize(bytes_read);
 
   if (localAudioReceiver != nullptr) {
     localAudioReceiver->OnAudioDataReady(data);
@@ -127,7 +131,7 @@ void start_audio_ticks() {
     LOG_ALWAYS_FATAL("Unsupported data interval: %d", data_interval_ms);
   }
 
-  wakelock_acquire();
+  wakelock_acquire_for("hearing_aid_source");
   audio_timer.SchedulePeriodic(
       get_main_thread()->GetWeakPtr(), FROM_HERE, base::Bind(&send_audio_data),
 #if BASE_VER < 931007
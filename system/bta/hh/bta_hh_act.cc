@@ -34,6 +34,7 @@
 #include "bta/include/bta_hh_co.h"
 #include "bta/sys/bta_sys.h"
 #include "btif/include/btif_storage.h"
+#include "common/time_util.h"
 #include "main/shim/dumpsys.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
@@ -60,6 +61,8 @@ constexpr char kBtmLogTag[] = "HIDH";
  ****************************************************************************/
 static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
                          uint8_t event, uint32_t data, BT_HDR* pdata);
+static void bta_hh_write_rpt(tBTA_HH_DEV_CB* p_cb, uint8_t dev_handle,
+                             BT_HDR* pdata, uint64_t rx_timestamp_us);
 static tBTA_HH_STATUS bta_hh_get_trans_status(uint32_t result);
 
 static const char* bta_hh_get_w4_event(uint16_t event);
@@ -703,16 +706,59 @@ void bta_hh_open_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
  *
  ******************************************************************************/
 void bta_hh_data_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
-  BT_HDR* pdata = p_data->hid_cback.p_data;
+  bta_hh_write_rpt(p_cb, (uint8_t)p_data->hid_cback.hdr.layer_specific,
+                   p_data->hid_cback.p_data, p_data->hid_cback.rx_timestamp_us);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_write_rpt
+ *
+ * Description      Hand an input report to uhid and free it.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_write_rpt(tBTA_HH_DEV_CB* p_cb, uint8_t dev_handle,
+                             BT_HDR* pdata, uint64_t rx_timestamp_us) {
   uint8_t* p_rpt = (uint8_t*)(pdata + 1) + pdata->offset;
 
-  bta_hh_co_data((uint8_t)p_data->hid_cback.hdr.layer_specific, p_rpt,
-                 pdata->len, p_cb->mode, p_cb->sub_class,
-                 p_cb->dscp_info.ctry_code, p_cb->addr, p_cb->app_id);
+  bta_hh_co_data(dev_handle, p_rpt, pdata->len, p_cb->mode, p_cb->sub_class,
+                 p_cb->dscp_info.ctry_code, p_cb->addr, p_cb->app_id,
+                 p_cb->queued_rpt_count > 0);
+  bta_hh_record_rpt_latency(p_cb, rx_timestamp_us);
 
   osi_free_and_reset((void**)&pdata);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_data_fast_path
+ *
+ * Description      Input reports of a connected device skip the bta_sys
+ *                  queue. The L2CAP callback already runs on the main
+ *                  thread, so they are handed to uhid from there and a busy
+ *                  queue doesn't delay them. Reports still in the queue go
+ *                  first to keep the order.
+ *
+ * Returns          true if the report was handled
+ *
+ ******************************************************************************/
+static bool bta_hh_data_fast_path(uint8_t dev_handle, BT_HDR* pdata,
+                                  uint64_t rx_timestamp_us) {
+  uint8_t index = bta_hh_dev_handle_to_cb_idx(dev_handle);
+  if (index == BTA_HH_IDX_INVALID) return false;
+
+  tBTA_HH_DEV_CB* p_cb = &bta_hh_cb.kdev[index];
+  if (p_cb->state != BTA_HH_CONN_ST || p_cb->queued_rpt_count > 0) {
+    p_cb->queued_rpt_count++;
+    return false;
+  }
+
+  bta_hh_write_rpt(p_cb, dev_handle, pdata, rx_timestamp_us);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_handsk_act
@@ -1214,6 +1260,7 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
                          uint8_t event, uint32_t data, BT_HDR* pdata) {
   uint16_t sm_event = BTA_HH_INVALID_EVT;
   uint8_t xx = 0;
+  uint64_t rx_timestamp_us = 0;
 
   APPL_TRACE_DEBUG("%s::HID_event [%s]", __func__,
                    bta_hh_hid_event_name(event));
@@ -1226,6 +1273,8 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
       sm_event = BTA_HH_INT_CLOSE_EVT;
       break;
     case HID_HDEV_EVT_INTR_DATA:
+      rx_timestamp_us = bluetooth::common::time_get_os_boottime_us();
+      if (bta_hh_data_fast_path(dev_handle, pdata, rx_timestamp_us)) return;
       sm_event = BTA_HH_INT_DATA_EVT;
       break;
     case HID_HDEV_EVT_HANDSHAKE:
@@ -1259,6 +1308,7 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
     p_buf->data = data;
     p_buf->addr = addr;
     p_buf->p_data = pdata;
+    p_buf->rx_timestamp_us = rx_timestamp_us;
 
     bta_sys_sendmsg(p_buf);
   }
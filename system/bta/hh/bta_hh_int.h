@@ -93,6 +93,7 @@ typedef struct {
   RawAddress addr;
   uint32_t data;
   BT_HDR* p_data;
+  uint64_t rx_timestamp_us; /* reception time of an input report */
 } tBTA_HH_CBACK_DATA;
 
 typedef struct {
@@ -179,6 +180,17 @@ typedef struct {
 #define BTA_HH_IS_LE_DEV_HDL(x) ((x)&0xf0)
 #define BTA_HH_IS_LE_DEV_HDL_VALID(x) (((x) >> 4) <= BTA_HH_LE_MAX_KNOWN)
 
+/* Latency of the input reports from their reception by HID Host to their
+ * write to uhid. Bucket i counts the latencies below 2^i us, the last bucket
+ * counts the rest. */
+#define BTA_HH_RPT_LATENCY_BUCKETS 16
+typedef struct {
+  uint64_t buckets[BTA_HH_RPT_LATENCY_BUCKETS];
+  uint64_t count;
+  uint64_t total_us;
+  uint64_t max_us;
+} tBTA_HH_RPT_LATENCY;
+
 /* device control block */
 typedef struct {
   tBTA_HH_DEV_DSCP_INFO dscp_info; /* report descriptor and DI information */
@@ -219,6 +231,9 @@ typedef struct {
 #define BTA_HH_LE_SCPS_NOTIFY_ENB 0x02
   uint8_t scps_notify; /* scan refresh supported/notification enabled */
   bool security_pending;
+
+  uint16_t queued_rpt_count; /* input reports queued through bta_sys */
+  tBTA_HH_RPT_LATENCY rpt_latency;
 } tBTA_HH_DEV_CB;
 
 /******************************************************************************
@@ -283,6 +298,7 @@ void bta_hh_update_di_info(tBTA_HH_DEV_CB* p_cb, uint16_t vendor_id,
 void bta_hh_cleanup_disable(tBTA_HH_STATUS status);
 
 uint8_t bta_hh_dev_handle_to_cb_idx(uint8_t dev_handle);
+void bta_hh_record_rpt_latency(tBTA_HH_DEV_CB* p_cb, uint64_t rx_timestamp_us);
 
 /* action functions used outside state machine */
 void bta_hh_api_enable(tBTA_HH_CBACK* p_cback, bool enable_hid,
@@ -27,6 +27,7 @@
 #include "bta/hh/bta_hh_int.h"
 #include "bta/include/bta_gatt_queue.h"
 #include "bta/include/bta_hh_co.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
@@ -919,8 +920,6 @@ static void bta_hh_le_dis_cback(const RawAddress& addr,
  *
  ******************************************************************************/
 static void bta_hh_le_pri_service_discovery(tBTA_HH_DEV_CB* p_cb) {
-  bta_hh_le_co_reset_rpt_cache(p_cb->addr, p_cb->app_id);
-
   p_cb->disc_active |= (BTA_HH_LE_DISC_HIDS | BTA_HH_LE_DISC_DIS);
 
   /* read DIS info */
@@ -1377,13 +1376,16 @@ static void read_pref_conn_params_cb(uint16_t conn_id, tGATT_STATUS status,
  * Function         bta_hh_le_search_hid_chars
  *
  * Description      This function discover all characteristics a service and
- *                  all descriptors available.
+ *                  all descriptors available. With |use_cache|, the HID
+ *                  information, the report map and the report references
+ *                  already loaded from the cache are not read again.
  *
  * Parameters:
  *
  ******************************************************************************/
 static void bta_hh_le_search_hid_chars(tBTA_HH_DEV_CB* p_dev_cb,
-                                       const gatt::Service* service) {
+                                       const gatt::Service* service,
+                                       bool use_cache) {
   tBTA_HH_LE_RPT* p_rpt;
 
   for (const gatt::Characteristic& charac : service->characteristics) {
@@ -1398,11 +1400,17 @@ static void bta_hh_le_search_hid_chars(tBTA_HH_DEV_CB* p_dev_cb,
         p_dev_cb->hid_srvc.control_point_handle = charac.value_handle;
         break;
       case GATT_UUID_HID_INFORMATION:
+        /* restored with the device information */
+        if (use_cache) break;
+
         /* only one instance per HID service */
         BtaGattQueue::ReadCharacteristic(p_dev_cb->conn_id, charac.value_handle,
                                          read_hid_info_cb, p_dev_cb);
         break;
       case GATT_UUID_HID_REPORT_MAP:
+        /* restored with the device information */
+        if (use_cache) break;
+
         /* only one instance per HID service */
         BtaGattQueue::ReadCharacteristic(p_dev_cb->conn_id, charac.value_handle,
                                          read_hid_report_map_cb, p_dev_cb);
@@ -1413,6 +1421,12 @@ static void bta_hh_le_search_hid_chars(tBTA_HH_DEV_CB* p_dev_cb,
         break;
 
       case GATT_UUID_HID_REPORT:
+        /* report reference loaded from the cache */
+        if (use_cache && bta_hh_le_find_report_entry(
+                             p_dev_cb, p_dev_cb->hid_srvc.srvc_inst_id,
+                             GATT_UUID_HID_REPORT, charac.value_handle))
+          break;
+
         p_rpt = bta_hh_le_find_alloc_report_entry(
             p_dev_cb, p_dev_cb->hid_srvc.srvc_inst_id, GATT_UUID_HID_REPORT,
             charac.value_handle);
@@ -1454,6 +1468,42 @@ static void bta_hh_le_search_hid_chars(tBTA_HH_DEV_CB* p_dev_cb,
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_is_cache_valid
+ *
+ * Description      Check if the reports loaded from the cache were discovered
+ *                  in the GATT database the device has now, in which case the
+ *                  HID service does not need to be read again. Otherwise the
+ *                  cache is reset, to be saved again as the service is read.
+ *
+ * Parameters:
+ *
+ ******************************************************************************/
+static bool bta_hh_le_is_cache_valid(tBTA_HH_DEV_CB* p_dev_cb) {
+  Octet16 db_hash, cached_hash;
+  bool have_db_hash = BTA_GATTC_GetDatabaseHash(p_dev_cb->conn_id, &db_hash);
+
+  /* the report map comes with the device information, the cached reports are
+   * useless without it */
+  if (have_db_hash && p_dev_cb->hid_srvc.descriptor.dl_len != 0 &&
+      p_dev_cb->hid_srvc.descriptor.dsc_list != NULL &&
+      bta_hh_le_co_load_db_hash(p_dev_cb->addr, &cached_hash,
+                                p_dev_cb->app_id) &&
+      cached_hash == db_hash) {
+    LOG_INFO("Using the cached HID service of %s",
+             ADDRESS_TO_LOGGABLE_CSTR(p_dev_cb->addr));
+    return true;
+  }
+
+  bta_hh_le_co_reset_rpt_cache(p_dev_cb->addr, p_dev_cb->app_id);
+  memset(p_dev_cb->hid_srvc.report, 0, sizeof(p_dev_cb->hid_srvc.report));
+  if (have_db_hash) {
+    bta_hh_le_co_save_db_hash(p_dev_cb->addr, db_hash, p_dev_cb->app_id);
+  }
+  return false;
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_le_srvc_search_cmpl
@@ -1480,6 +1530,8 @@ static void bta_hh_le_srvc_search_cmpl(tBTA_GATTC_SEARCH_CMPL* p_data) {
   const gatt::Service* gap_service = nullptr;
   const gatt::Service* scp_service = nullptr;
 
+  bool use_cache = bta_hh_le_is_cache_valid(p_dev_cb);
+
   bool have_hid = false;
   for (const gatt::Service& service : *services) {
     if (service.uuid == Uuid::From16Bit(UUID_SERVCLASS_LE_HID) &&
@@ -1492,7 +1544,7 @@ static void bta_hh_le_srvc_search_cmpl(tBTA_GATTC_SEARCH_CMPL* p_data) {
       p_dev_cb->hid_srvc.proto_mode_handle = 0;
       p_dev_cb->hid_srvc.control_point_handle = 0;
 
-      bta_hh_le_search_hid_chars(p_dev_cb, &service);
+      bta_hh_le_search_hid_chars(p_dev_cb, &service, use_cache);
 
       APPL_TRACE_DEBUG("%s: have HID service inst_id= %d", __func__,
                        p_dev_cb->hid_srvc.srvc_inst_id);
@@ -1548,8 +1600,10 @@ static void bta_hh_le_srvc_search_cmpl(tBTA_GATTC_SEARCH_CMPL* p_data) {
  *
  ******************************************************************************/
 static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
+  uint64_t rx_timestamp_us = bluetooth::common::time_get_os_boottime_us();
   tBTA_HH_DEV_CB* p_dev_cb = bta_hh_le_find_dev_cb_by_conn_id(p_data->conn_id);
   uint8_t app_id;
+  uint8_t rpt_with_id[GATT_MAX_ATTR_LEN + 1];
   uint8_t* p_buf;
   tBTA_HH_LE_RPT* p_rpt;
 
@@ -1594,7 +1648,7 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
 
   /* need to append report ID to the head of data */
   if (p_rpt->rpt_id != 0) {
-    p_buf = (uint8_t*)osi_malloc(p_data->len + 1);
+    p_buf = rpt_with_id;
 
     p_buf[0] = p_rpt->rpt_id;
     memcpy(&p_buf[1], p_data->value, p_data->len);
@@ -1605,9 +1659,9 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
 
   bta_hh_co_data((uint8_t)p_dev_cb->hid_handle, p_buf, p_data->len,
                  p_dev_cb->mode, 0, /* no sub class*/
-                 p_dev_cb->dscp_info.ctry_code, p_dev_cb->addr, app_id);
-
-  if (p_buf != p_data->value) osi_free(p_buf);
+                 p_dev_cb->dscp_info.ctry_code, p_dev_cb->addr, app_id,
+                 false);
+  bta_hh_record_rpt_latency(p_dev_cb, rx_timestamp_us);
 }
 
 /*******************************************************************************
@@ -335,6 +335,13 @@ bool bta_hh_hdl_event(BT_HDR_RIGID* p_msg) {
 
   if (index != BTA_HH_IDX_INVALID) p_cb = &bta_hh_cb.kdev[index];
 
+  /* Once the queued input reports are handled they take the fast path again,
+   * see bta_hh_data_fast_path() */
+  if (p_msg->event == BTA_HH_INT_DATA_EVT && p_cb != NULL &&
+      p_cb->queued_rpt_count > 0) {
+    p_cb->queued_rpt_count--;
+  }
+
   APPL_TRACE_DEBUG("bta_hh_hdl_event:: handle = %d dev_cb[%d] ", p_msg->layer_specific, index);
   bta_hh_sm_execute(p_cb, p_msg->event, (tBTA_HH_DATA*)p_msg);
 
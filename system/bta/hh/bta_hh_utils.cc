@@ -15,16 +15,21 @@
  *  limitations under the License.
  *
  ******************************************************************************/
+#include <base/strings/stringprintf.h>
 #include <string.h>  // memset
 
 #include <cstring>
+#include <string>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bt_trace.h"   // Legacy trace logging
 #include "bta/hh/bta_hh_int.h"
 #include "btif/include/btif_storage.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
+#include "main/shim/dumpsys.h"
 #include "osi/include/allocator.h"
+#include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/btm_client_interface.h"
@@ -349,6 +354,63 @@ uint8_t bta_hh_dev_handle_to_cb_idx(uint8_t dev_handle) {
 
   return index;
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_record_rpt_latency
+ *
+ * Description      Record the latency of an input report received at
+ *                  |rx_timestamp_us| and now written to uhid.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_hh_record_rpt_latency(tBTA_HH_DEV_CB* p_cb,
+                               uint64_t rx_timestamp_us) {
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  uint64_t latency_us = now_us > rx_timestamp_us ? now_us - rx_timestamp_us : 0;
+  tBTA_HH_RPT_LATENCY* p_latency = &p_cb->rpt_latency;
+
+  uint8_t bucket = 0;
+  while (bucket < BTA_HH_RPT_LATENCY_BUCKETS - 1 &&
+         latency_us >= (1ULL << bucket)) {
+    bucket++;
+  }
+  p_latency->buckets[bucket]++;
+  p_latency->count++;
+  p_latency->total_us += latency_us;
+  if (latency_us > p_latency->max_us) p_latency->max_us = latency_us;
+}
+
+#define DUMPSYS_TAG "shim::legacy::bta::hh"
+void DumpsysBtaHh(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+  for (uint8_t xx = 0; xx < BTA_HH_MAX_DEVICE; xx++) {
+    const tBTA_HH_DEV_CB* p_cb = &bta_hh_cb.kdev[xx];
+    const tBTA_HH_RPT_LATENCY* p_latency = &p_cb->rpt_latency;
+    if (!p_cb->in_use || p_latency->count == 0) continue;
+
+    LOG_DUMPSYS(fd,
+                "  %u: addr:%s handle:%u input reports:%llu "
+                "mean latency:%lluus max latency:%lluus",
+                xx, ADDRESS_TO_LOGGABLE_CSTR(p_cb->addr), p_cb->hid_handle,
+                (unsigned long long)p_latency->count,
+                (unsigned long long)(p_latency->total_us / p_latency->count),
+                (unsigned long long)p_latency->max_us);
+    std::string histogram;
+    for (uint8_t bucket = 0; bucket < BTA_HH_RPT_LATENCY_BUCKETS; bucket++) {
+      if (p_latency->buckets[bucket] == 0) continue;
+      histogram += base::StringPrintf(
+          " %s%lluus:%llu",
+          bucket == BTA_HH_RPT_LATENCY_BUCKETS - 1 ? ">=" : "<",
+          1ULL << (bucket == BTA_HH_RPT_LATENCY_BUCKETS - 1 ? bucket - 1
+                                                            : bucket),
+          (unsigned long long)p_latency->buckets[bucket]);
+    }
+    LOG_DUMPSYS(fd, "     latency histogram:%s", histogram.c_str());
+  }
+}
+#undef DUMPSYS_TAG
 #if (BTA_HH_DEBUG == TRUE)
 /*******************************************************************************
  *
@@ -369,6 +369,8 @@ typedef union {
 
 /* AV callback */
 typedef void(tBTA_AV_CBACK)(tBTA_AV_EVT event, tBTA_AV* p_data);
+/* The callback owns the media packet of BTA_AV_SINK_MEDIA_DATA_EVT, and must
+ * free it */
 typedef void(tBTA_AV_SINK_DATA_CBACK)(const RawAddress&, tBTA_AV_EVT event,
                                       tBTA_AV_MEDIA* p_data);
 
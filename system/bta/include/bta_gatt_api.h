@@ -554,6 +554,22 @@ void BTA_GATTC_DiscoverServiceByUuid(uint16_t conn_id,
  ******************************************************************************/
 const std::list<gatt::Service>* BTA_GATTC_GetServices(uint16_t conn_id);
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_GetDatabaseHash
+ *
+ * Description      This function is called to get the hash of the database
+ *                  discovered on the given server, as defined for the
+ *                  Database Hash characteristic.
+ *
+ * Parameters       conn_id: connection ID which identify the server.
+ *                  p_hash: set to the database hash.
+ *
+ * Returns          true if the database of the server is known.
+ *
+ ******************************************************************************/
+bool BTA_GATTC_GetDatabaseHash(uint16_t conn_id, Octet16* p_hash);
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_GetCharacteristic
@@ -800,6 +816,31 @@ void BTA_GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute);
 void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
                             tGATT_AUTH_REQ auth_req);
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_ReadMultipleVariable
+ *
+ * Description      This function is called to read the values of several
+ *                  characteristics or descriptors. They are read with Read
+ *                  Multiple Variable Length Requests of up to
+ *                  GATT_MAX_READ_MULTI_HANDLES handles, which can use several
+ *                  EATT bearers at once. The values that do not fit in a
+ *                  response, or all of them when the server does not support
+ *                  the request, are read one by one.
+ *
+ * Parameters       conn_id - connection ID.
+ *                  handles - handles of the attributes to read.
+ *                  callback - called once for each handle, not necessarily in
+ *                             the order of |handles|.
+ *
+ * Returns          None
+ *
+ ******************************************************************************/
+void BTA_GATTC_ReadMultipleVariable(uint16_t conn_id,
+                                    const std::vector<uint16_t>& handles,
+                                    tGATT_AUTH_REQ auth_req,
+                                    GATT_READ_OP_CB callback, void* cb_data);
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_Refresh
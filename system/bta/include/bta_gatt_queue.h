@@ -29,6 +29,15 @@
  *
  * Methods below can be used as replacement to BTA_GATTC_* in BTA app. They do
  * queue the commands if another command is currently being executed.
+ * Consecutive reads are executed together, so that BTA GATTC can send them on
+ * separate EATT bearers. Writes and MTU configuration are executed alone, in
+ * queue order.
+ *
+ * When coalescing is enabled for a connection, a read of an attribute which is
+ * already being read, or already queued with no write queued after it,
+ * completes with the result of that read. A write without response queued
+ * right after one to the same attribute replaces its value. The callbacks of
+ * all the coalesced operations are called.
  *
  * If you decide to use those methods in your app, make sure to not mix it with
  * existing BTA_GATTC_* API.
@@ -36,6 +45,7 @@
 class BtaGattQueue {
  public:
   static void Clean(uint16_t conn_id);
+  static void SetCoalescing(uint16_t conn_id, bool enable);
   static void ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                  GATT_READ_OP_CB cb, void* cb_data);
   static void ReadDescriptor(uint16_t conn_id, uint16_t handle,
@@ -50,6 +60,16 @@ class BtaGattQueue {
                               void* cb_data);
   static void ConfigureMtu(uint16_t conn_id, uint16_t mtu);
 
+  struct gatt_read_cb {
+    GATT_READ_OP_CB cb;
+    void* cb_data;
+  };
+
+  struct gatt_write_cb {
+    GATT_WRITE_OP_CB cb;
+    void* cb_data;
+  };
+
   /* Holds pending GATT operations */
   struct gatt_operation {
     uint8_t type;
@@ -64,9 +84,21 @@ class BtaGattQueue {
     /* write-specific fields */
     tGATT_WRITE_TYPE write_type;
     std::vector<uint8_t> value;
+
+    /* callbacks of the operations coalesced with this one */
+    std::vector<gatt_read_cb> coalesced_read_cbs;
+    std::vector<gatt_write_cb> coalesced_write_cbs;
   };
 
  private:
+  struct gatt_read_op_data;
+
+  static bool coalesce_read(uint16_t conn_id, uint8_t type, uint16_t handle,
+                            GATT_READ_OP_CB cb, void* cb_data);
+  static bool coalesce_write(uint16_t conn_id, uint8_t type, uint16_t handle,
+                             std::vector<uint8_t>& value,
+                             tGATT_WRITE_TYPE write_type, GATT_WRITE_OP_CB cb,
+                             void* cb_data);
   static void mark_as_not_executing(uint16_t conn_id);
   static void gatt_execute_next_op(uint16_t conn_id);
   static void gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
@@ -80,6 +112,14 @@ class BtaGattQueue {
 
   // maps connection id to operations waiting for execution
   static std::unordered_map<uint16_t, std::list<gatt_operation>> gatt_op_queue;
-  // contain connection ids that currently execute operations
-  static std::unordered_set<uint16_t> gatt_op_queue_executing;
+  // maps connection id to the number of currently executing operations, only
+  // reads execute more than one at a time
+  static std::unordered_map<uint16_t, uint8_t> gatt_op_queue_executing;
+  // contain connection ids that currently execute a write or MTU configuration
+  static std::unordered_set<uint16_t> gatt_op_queue_executing_exclusive;
+  // maps connection id to its currently executing reads
+  static std::unordered_map<uint16_t, std::list<gatt_read_op_data*>>
+      gatt_op_queue_executing_reads;
+  // contain connection ids whose operations are coalesced
+  static std::unordered_set<uint16_t> gatt_op_queue_coalescing;
 };
@@ -32,6 +32,9 @@
 
 #define HFP_VERSION_CONFIG_KEY "HfpVersion"
 #define HFP_SDP_FEATURES_CONFIG_KEY "HfpSdpFeatures"
+#define HFP_PEER_SCN_CONFIG_KEY "HfpPeerScn"
+#define HFP_PEER_SERVICE_CONFIG_KEY "HfpPeerService"
+#define HFP_PEER_SCN_TIMESTAMP_CONFIG_KEY "HfpPeerScnTimestamp"
 
 int get_default_hfp_version();
 
@@ -523,4 +523,7 @@ void BTA_HhAddDev(const RawAddress& bda, tBTA_HH_ATTR_MASK attr_mask,
  ******************************************************************************/
 void BTA_HhRemoveDev(uint8_t dev_handle);
 
+/* Dump the input report latency of the HID devices */
+void DumpsysBtaHh(int fd);
+
 #endif /* BTA_HH_API_H */
@@ -27,6 +27,7 @@
 #include <cstdint>
 
 #include "bta/include/bta_hh_api.h"
+#include "stack/include/bt_octets.h"
 #include "types/raw_address.h"
 
 typedef struct {
@@ -43,7 +44,8 @@ typedef struct {
  *
  * Description      This callout function is executed by HH when data is
  *                  received
- *                  in interupt channel.
+ *                  in interupt channel. |more_data| is set when more reports
+ *                  of the device are queued right behind this one.
  *
  *
  * Returns          void.
@@ -52,7 +54,7 @@ typedef struct {
 void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len,
                     tBTA_HH_PROTO_MODE mode, uint8_t sub_class,
                     uint8_t ctry_code, const RawAddress& peer_addr,
-                    uint8_t app_id);
+                    uint8_t app_id, bool more_data);
 
 /*******************************************************************************
  *
@@ -145,4 +147,39 @@ tBTA_HH_RPT_CACHE_ENTRY* bta_hh_le_co_cache_load(const RawAddress& remote_bda,
  ******************************************************************************/
 void bta_hh_le_co_reset_rpt_cache(const RawAddress& remote_bda, uint8_t app_id);
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_co_save_db_hash
+ *
+ * Description      This callout function is to save the hash of the GATT
+ *                  database the cached HOGP reports were discovered in, so
+ *                  that the cache is only used while the database is the same.
+ *
+ * Parameters       remote_bda  - remote device address
+ *                  hash        - GATT database hash
+ *                  app_id      - application id
+ *
+ * Returns          none
+ *
+ ******************************************************************************/
+void bta_hh_le_co_save_db_hash(const RawAddress& remote_bda,
+                               const Octet16& hash, uint8_t app_id);
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_co_load_db_hash
+ *
+ * Description      This callout function is to load the hash of the GATT
+ *                  database the cached HOGP reports were discovered in.
+ *
+ * Parameters       remote_bda  - remote device address
+ *                  p_hash      - set to the GATT database hash
+ *                  app_id      - application id
+ *
+ * Returns          true if a hash was saved with the cache
+ *
+ ******************************************************************************/
+bool bta_hh_le_co_load_db_hash(const RawAddress& remote_bda, Octet16* p_hash,
+                               uint8_t app_id);
+
 #endif /* BTA_HH_CO_H */
@@ -214,7 +214,7 @@ bool SourceImpl::InitAudioSinkThread() {
   }
 
   /* Schedule the rest of the operations */
-  if (!worker_thread_->EnableRealTimeScheduling()) {
+  if (!worker_thread_->ApplySchedulingPolicy(true)) {
 #if defined(__ANDROID__)
     LOG(FATAL) << __func__ << ", Failed to increase media thread priority";
 #endif
@@ -224,7 +224,7 @@ bool SourceImpl::InitAudioSinkThread() {
 }
 
 void SourceImpl::StartAudioTicks() {
-  wakelock_acquire();
+  wakelock_acquire_for("le_audio_source");
   audio_timer_.SchedulePeriodic(
       worker_thread_->GetWeakPtr(), FROM_HERE,
       base::Bind(&SourceImpl::SendAudioData, base::Unretained(this)),
@@ -17,10 +17,13 @@
 
 #include <base/functional/bind.h>
 
+#include <algorithm>
+#include <memory>
 #include <mutex>
 
 #include "bta/include/bta_le_audio_api.h"
 #include "bta/include/bta_le_audio_broadcaster_api.h"
+#include "bta/le_audio/broadcaster/encoder_worker_pool.h"
 #include "bta/le_audio/broadcaster/state_machine.h"
 #include "bta/le_audio/content_control_id_keeper.h"
 #include "bta/le_audio/le_audio_types.h"
@@ -53,6 +56,7 @@ using le_audio::broadcaster::BroadcastCodecWrapper;
 using le_audio::broadcaster::BroadcastQosConfig;
 using le_audio::broadcaster::BroadcastStateMachine;
 using le_audio::broadcaster::BroadcastStateMachineConfig;
+using le_audio::broadcaster::EncoderWorkerPool;
 using le_audio::broadcaster::IBroadcastStateMachineCallbacks;
 using le_audio::types::AudioContexts;
 using le_audio::types::CodecLocation;
@@ -62,6 +66,15 @@ using le_audio::types::LeAudioLtvMap;
 using le_audio::utils::GetAllowedAudioContextsFromSourceMetadata;
 
 namespace {
+/* Number of threads helping the audio thread to encode the BIS channels. Only
+ * used when the broadcast carries more than kMinChannelsForEncoderWorkers
+ * channels, 0 encodes everything on the audio thread.
+ */
+constexpr char kEncoderWorkersProp[] =
+    "persist.bluetooth.leaudio.broadcast.encoder_workers";
+constexpr int32_t kDefaultEncoderWorkers = 3;
+constexpr uint8_t kMinChannelsForEncoderWorkers = 2;
+
 class LeAudioBroadcasterImpl;
 LeAudioBroadcasterImpl* instance;
 std::mutex instance_mutex;
@@ -127,6 +140,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       le_audio_source_hal_client_->Stop();
       le_audio_source_hal_client_.reset();
     }
+    audio_receiver_.ReleaseEncoderWorkers();
   }
 
   void Stop() {
@@ -887,8 +901,23 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         encoders_.emplace_back(
             lc3_setup_encoder(dt_us, sr_hz, 0, encoders_mem_.back().get()));
       }
+
+      const auto num_channels = codec_wrapper_.GetNumChannels();
+      size_t num_workers = 0;
+      if (num_channels > kMinChannelsForEncoderWorkers) {
+        num_workers = std::clamp<int32_t>(
+            osi_property_get_int32(kEncoderWorkersProp, kDefaultEncoderWorkers),
+            0, num_channels - 1);
+      }
+      if (!encoder_pool_ || encoder_pool_->GetNumWorkers() != num_workers) {
+        encoder_pool_.reset();
+        if (num_workers > 0)
+          encoder_pool_ = std::make_unique<EncoderWorkerPool>(num_workers);
+      }
     }
 
+    void ReleaseEncoderWorkers() { encoder_pool_.reset(); }
+
     const BroadcastCodecWrapper& getCurrentCodecConfig(void) const {
       return codec_wrapper_;
     }
@@ -945,11 +974,19 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       const auto num_channels = codec_wrapper_.GetNumChannels();
       const auto bytes_per_sample = (codec_wrapper_.GetBitsPerSample() / 8);
 
-      /* Prepare encoded data for all channels */
-      for (uint8_t chan = 0; chan < num_channels; ++chan) {
+      /* Prepare encoded data for all channels. Each channel has its own
+       * encoder and output buffer, so they can be encoded in parallel.
+       */
+      auto encode_channel = [&](size_t chan) {
         /* TODO: Use encoder agnostic wrapper */
         encodeLc3Channel(encoders_[chan], enc_audio_buffers_[chan], data,
                          chan * bytes_per_sample, num_channels, num_channels);
+      };
+      if (encoder_pool_) {
+        encoder_pool_->Run(num_channels, encode_channel);
+      } else {
+        for (uint8_t chan = 0; chan < num_channels; ++chan)
+          encode_channel(chan);
       }
 
       /* Currently there is no way to broadcast multiple distinct streams.
@@ -1015,6 +1052,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     std::vector<lc3_encoder_t> encoders_;
     std::vector<std::unique_ptr<void, decltype(&std::free)>> encoders_mem_;
     std::vector<std::vector<uint8_t>> enc_audio_buffers_;
+    std::unique_ptr<EncoderWorkerPool> encoder_pool_;
   } audio_receiver_;
 
   bluetooth::le_audio::LeAudioBroadcasterCallbacks* callbacks_;
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/le_audio/broadcaster/encoder_worker_pool.h"
+
+#include <base/functional/bind.h>
+#include <base/location.h>
+
+#include <algorithm>
+#include <future>
+#include <string>
+
+#include "osi/include/log.h"
+
+using bluetooth::common::MessageLoopThread;
+
+namespace le_audio {
+namespace broadcaster {
+
+static void RunJobs(size_t first, size_t stride, size_t num_jobs,
+                    const std::function<void(size_t)>& job) {
+  for (size_t i = first; i < num_jobs; i += stride) job(i);
+}
+
+EncoderWorkerPool::EncoderWorkerPool(size_t num_workers) {
+  for (size_t i = 0; i < num_workers; ++i) {
+    auto worker = std::make_unique<MessageLoopThread>(
+        "bt_lea_bcast_enc_" + std::to_string(i));
+    worker->StartUp();
+    if (!worker->IsRunning()) {
+      LOG_ERROR("Unable to start encoder worker %zu", i);
+      break;
+    }
+    workers_.push_back(std::move(worker));
+  }
+  LOG_INFO("Started %zu encoder workers", workers_.size());
+}
+
+EncoderWorkerPool::~EncoderWorkerPool() {
+  for (auto& worker : workers_) worker->ShutDown();
+}
+
+void EncoderWorkerPool::Run(size_t num_jobs,
+                            const std::function<void(size_t)>& job) {
+  const size_t stride = workers_.size() + 1;
+  std::vector<std::promise<void>> done(std::min(workers_.size(), num_jobs));
+  std::vector<std::future<void>> barrier;
+
+  for (size_t w = 0; w < done.size(); ++w) {
+    barrier.push_back(done[w].get_future());
+    bool posted = workers_[w]->DoInThread(
+        FROM_HERE, base::BindOnce(
+                       [](size_t first, size_t stride, size_t num_jobs,
+                          const std::function<void(size_t)>* job,
+                          std::promise<void>* done) {
+                         RunJobs(first, stride, num_jobs, *job);
+                         done->set_value();
+                       },
+                       w + 1, stride, num_jobs, &job, &done[w]));
+    if (!posted) {
+      /* The worker is gone, run its share of the jobs here */
+      RunJobs(w + 1, stride, num_jobs, job);
+      done[w].set_value();
+    }
+  }
+
+  RunJobs(0, stride, num_jobs, job);
+
+  for (auto& f : barrier) f.wait();
+}
+
+}  // namespace broadcaster
+}  // namespace le_audio
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "common/message_loop_thread.h"
+
+namespace le_audio {
+namespace broadcaster {
+
+/* Spreads the per-BIS encoding of one SDU interval over a few worker threads.
+ *
+ * Job |i| always runs on the same thread: the calling thread takes every
+ * (num_workers + 1)th job, starting with the first one, and worker |w| the
+ * ones following it. Run() returns only once every job of the interval is
+ * done, so the encoded SDUs are sent in the same order and within the same
+ * interval as when encoding on a single thread.
+ */
+class EncoderWorkerPool {
+ public:
+  explicit EncoderWorkerPool(size_t num_workers);
+  ~EncoderWorkerPool();
+
+  size_t GetNumWorkers() const { return workers_.size(); }
+
+  /* Runs job(0) .. job(num_jobs - 1) and waits for all of them */
+  void Run(size_t num_jobs, const std::function<void(size_t)>& job);
+
+ private:
+  std::vector<std::unique_ptr<bluetooth::common::MessageLoopThread>> workers_;
+};
+
+}  // namespace broadcaster
+}  // namespace le_audio
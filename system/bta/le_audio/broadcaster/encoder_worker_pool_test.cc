@@ -0,0 +1,67 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/le_audio/broadcaster/encoder_worker_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace le_audio {
+namespace broadcaster {
+namespace {
+
+TEST(EncoderWorkerPoolTest, RunsEveryJobOnce) {
+  EncoderWorkerPool pool(3);
+  ASSERT_EQ(pool.GetNumWorkers(), 3u);
+
+  for (size_t num_jobs : {0u, 1u, 2u, 4u, 8u, 13u}) {
+    std::vector<std::atomic_int> runs(num_jobs);
+    pool.Run(num_jobs, [&](size_t i) { runs[i]++; });
+    for (size_t i = 0; i < num_jobs; ++i) ASSERT_EQ(runs[i], 1);
+  }
+}
+
+TEST(EncoderWorkerPoolTest, JobsKeepTheirThread) {
+  EncoderWorkerPool pool(2);
+  constexpr size_t kNumJobs = 8;
+
+  std::vector<std::thread::id> first(kNumJobs), second(kNumJobs);
+  pool.Run(kNumJobs, [&](size_t i) { first[i] = std::this_thread::get_id(); });
+  pool.Run(kNumJobs, [&](size_t i) { second[i] = std::this_thread::get_id(); });
+  ASSERT_EQ(first, second);
+
+  /* Every (num_workers + 1)th job runs on the caller */
+  for (size_t i = 0; i < kNumJobs; ++i) {
+    ASSERT_EQ(first[i] == std::this_thread::get_id(), i % 3 == 0);
+  }
+}
+
+TEST(EncoderWorkerPoolTest, NoWorkers) {
+  EncoderWorkerPool pool(0);
+  ASSERT_EQ(pool.GetNumWorkers(), 0u);
+
+  std::vector<std::thread::id> threads(4);
+  pool.Run(threads.size(),
+           [&](size_t i) { threads[i] = std::this_thread::get_id(); });
+  for (auto const& id : threads) ASSERT_EQ(id, std::this_thread::get_id());
+}
+
+}  // namespace
+}  // namespace broadcaster
+}  // namespace le_audio
@@ -19,6 +19,7 @@
 
 #include <base/bind_helpers.h>
 
+#include <chrono>
 #include <functional>
 #include <iostream>
 
@@ -191,6 +192,17 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
   std::optional<BigConfig> active_config_;
   BroadcastStateMachineConfig sm_config_;
   bool suspending_;
+  /* BISes whose data path setup is still pending */
+  std::vector<uint16_t> pending_data_paths_;
+  std::chrono::steady_clock::time_point phase_start_;
+
+  std::chrono::milliseconds EndPhase() {
+    auto now = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - phase_start_);
+    phase_start_ = now;
+    return duration;
+  }
 
   /* Message handlers for each possible state */
   typedef std::function<void(const void*)> msg_handler_t;
@@ -287,6 +299,8 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
       return;
     }
 
+    startup_timings_.announcement = EndPhase();
+
     /* Ext. advertisings are already on */
     SetState(State::CONFIGURED);
 
@@ -344,6 +358,7 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
       /* Callback returns the status and handle which we use later in
        * CreateBIG command.
        */
+      phase_start_ = std::chrono::steady_clock::now();
       advertiser_if_->StartAdvertisingSet(
           base::Bind(&BroadcastStateMachineImpl::CreateAnnouncementCb,
                      base::Unretained(this)),
@@ -366,6 +381,7 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
     if (status == BTM_BLE_MULTI_ADV_SUCCESS) {
       /* Periodic is enabled but without BIGInfo. Stream is suspended. */
       if (enable) {
+        startup_timings_.announcement = EndPhase();
         SetState(State::CONFIGURED);
         /* Target state is always STREAMING state - start it now. */
         ProcessMessage(Message::START);
@@ -392,6 +408,7 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
 
   void EnableAnnouncement() {
     LOG_INFO("broadcast_id=%d", GetBroadcastId());
+    phase_start_ = std::chrono::steady_clock::now();
     advertiser_if_->Enable(
         GetAdvertisingSid(), true,
         base::Bind(&BroadcastStateMachineImpl::EnableAnnouncementCb,
@@ -419,6 +436,7 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
                                               : std::array<uint8_t, 16>({0}),
     };
 
+    phase_start_ = std::chrono::steady_clock::now();
     IsoManager::GetInstance()->CreateBig(GetAdvertisingSid(),
                                          std::move(big_params));
   }
@@ -441,34 +459,55 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
   }
 
   void OnSetupIsoDataPath(uint8_t status, uint16_t conn_hdl) override {
+    auto pending_it = std::find(pending_data_paths_.begin(),
+                                pending_data_paths_.end(), conn_hdl);
+    if (pending_it == pending_data_paths_.end()) {
+      /* Completion of a setup issued before an earlier one failed */
+      LOG_INFO("Ignoring data path of conn_hdl=%d", conn_hdl);
+      return;
+    }
     LOG_ASSERT(active_config_ != std::nullopt);
 
     if (status != 0) {
       LOG_ERROR("Failure creating data path. Tearing down the BIG now.");
+      pending_data_paths_.clear();
       suspending_ = true;
       TerminateBig();
       return;
     }
 
-    /* Look for the next BIS handle */
-    auto handle_it = std::find_if(
-        active_config_->connection_handles.begin(),
-        active_config_->connection_handles.end(),
-        [conn_hdl](const auto& handle) { return conn_hdl == handle; });
-    LOG_ASSERT(handle_it != active_config_->connection_handles.end());
-    handle_it = std::next(handle_it);
-
-    if (handle_it == active_config_->connection_handles.end()) {
+    pending_data_paths_.erase(pending_it);
+    if (pending_data_paths_.empty()) {
       /* It was the last BIS to set up - change state to streaming */
+      startup_timings_.data_paths = EndPhase();
+      LOG_INFO(
+          "broadcast_id=%d started, announcement=%lldms, big=%lldms, "
+          "data paths=%lldms",
+          GetBroadcastId(),
+          static_cast<long long>(startup_timings_.announcement.count()),
+          static_cast<long long>(startup_timings_.big.count()),
+          static_cast<long long>(startup_timings_.data_paths.count()));
       SetState(State::STREAMING);
       callbacks_->OnStateMachineEvent(
           GetBroadcastId(), GetState(),
           &sm_config_.codec_wrapper.GetLeAudioCodecConfiguration());
     } else {
-      /* Note: We would feed a watchdog here if we had one */
-      /* There are more BISes to set up data path for */
       LOG_INFO("There is more data paths to set up.");
-      TriggerIsoDatapathSetup(*handle_it);
+    }
+  }
+
+  /* The data paths of the BISes do not depend on each other, so they are all
+   * requested at once and the HCI layer queues the commands.
+   */
+  void TriggerIsoDatapathsSetup(void) {
+    LOG_ASSERT(active_config_ != std::nullopt);
+    pending_data_paths_ = active_config_->connection_handles;
+
+    auto const conn_handles = active_config_->connection_handles;
+    for (auto conn_handle : conn_handles) {
+      /* A failure already reported synchronously tore the BIG down */
+      if (pending_data_paths_.empty()) break;
+      TriggerIsoDatapathSetup(conn_handle);
     }
   }
 
@@ -586,11 +625,12 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
               .iso_interval = evt->iso_interval,
               .connection_handles = evt->conn_handles,
           };
+          startup_timings_.big = EndPhase();
           if (CodecManager::GetInstance()->GetCodecLocation() ==
               CodecLocation::ADSP) {
             callbacks_->OnBigCreated(evt->conn_handles);
           }
-          TriggerIsoDatapathSetup(evt->conn_handles[0]);
+          TriggerIsoDatapathsSetup();
         } else {
           LOG_ERROR(
               "State=%s Event=%d. Unable to create big, big_id=%d, status=%d",
@@ -610,6 +650,7 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
         }
 
         active_config_ = std::nullopt;
+        pending_data_paths_.clear();
 
         /* Go back to configured if BIG is inactive (we are still announcing) */
         SetState(State::CONFIGURED);
@@ -736,6 +777,10 @@ std::ostream& operator<<(
      << "      State: " << machine.GetState() << "\n";
   os << "      State Machine Config: " << machine.GetStateMachineConfig()
      << "\n";
+  auto const& timings = machine.GetStartupTimings();
+  os << "      Startup timings: announcement "
+     << timings.announcement.count() << "ms, BIG " << timings.big.count()
+     << "ms, data paths " << timings.data_paths.count() << "ms\n";
 
   if (machine.GetBigConfig()) {
     os << "      BigConfig: " << *machine.GetBigConfig() << "\n";
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <limits>
 #include <optional>
 #include <type_traits>
@@ -175,6 +176,14 @@ class BroadcastStateMachine : public StateMachine<5> {
   virtual void ProcessMessage(Message event, const void* data = nullptr) = 0;
   virtual ~BroadcastStateMachine() {}
 
+  /* Durations of the phases of the last start of the broadcast */
+  struct StartupTimings {
+    std::chrono::milliseconds announcement{0};
+    std::chrono::milliseconds big{0};
+    std::chrono::milliseconds data_paths{0};
+  };
+  const StartupTimings& GetStartupTimings() const { return startup_timings_; }
+
  protected:
   BroadcastStateMachine() = default;
 
@@ -188,6 +197,7 @@ class BroadcastStateMachine : public StateMachine<5> {
 
   RawAddress addr_ = RawAddress::kEmpty;
   uint8_t addr_type_ = 0;
+  StartupTimings startup_timings_;
 };
 
 class IBroadcastStateMachineCallbacks {
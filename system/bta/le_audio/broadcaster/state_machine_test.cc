@@ -754,6 +754,35 @@ TEST_F(StateMachineTest, OnSetupIsoDataPathError) {
             BroadcastStateMachine::State::STREAMING);
 }
 
+TEST_F(StateMachineTest, SetupIsoDataPathsAtOnce) {
+  auto broadcast_id =
+      InstantiateStateMachine(le_audio::types::LeAudioContextType::MEDIA);
+  ASSERT_EQ(broadcasts_[broadcast_id]->GetState(),
+            BroadcastStateMachine::State::CONFIGURED);
+
+  // Hold the completions until all the data paths were requested
+  std::vector<uint16_t> requested_handles;
+  EXPECT_CALL(*mock_iso_manager_, SetupIsoDataPath)
+      .Times(2)
+      .WillRepeatedly([&requested_handles](uint16_t conn_handle,
+                                           iso_data_path_params p) {
+        requested_handles.push_back(conn_handle);
+      });
+  broadcasts_[broadcast_id]->ProcessMessage(
+      BroadcastStateMachine::Message::START);
+  ASSERT_EQ(requested_handles.size(), 2u);
+  ASSERT_EQ(broadcasts_[broadcast_id]->GetState(),
+            BroadcastStateMachine::State::CONFIGURED);
+
+  // Completions may come in any order
+  broadcasts_[broadcast_id]->OnSetupIsoDataPath(0, requested_handles[1]);
+  ASSERT_EQ(broadcasts_[broadcast_id]->GetState(),
+            BroadcastStateMachine::State::CONFIGURED);
+  broadcasts_[broadcast_id]->OnSetupIsoDataPath(0, requested_handles[0]);
+  ASSERT_EQ(broadcasts_[broadcast_id]->GetState(),
+            BroadcastStateMachine::State::STREAMING);
+}
+
 TEST_F(StateMachineTest, OnRemoveIsoDataPathError) {
   auto broadcast_id =
       InstantiateStateMachine(le_audio::types::LeAudioContextType::MEDIA);
@@ -4326,6 +4326,8 @@ class LeAudioClientImpl : public LeAudioClient {
     /* Need to reconfigure stream */
     group->SetPendingConfiguration();
     groupStateMachine_->StopStream(group);
+    le_audio::MetricsCollector::Get()->OnStreamContextSwitchStarted(
+        group->group_id_);
     return true;
   }
 
@@ -4835,6 +4837,7 @@ class LeAudioClientImpl : public LeAudioClient {
 
   void IsoCigEventsCb(uint16_t event_type, void* data) {
     switch (event_type) {
+      case bluetooth::hci::iso_manager::kIsoEventCigOnReconfigureCmpl:
       case bluetooth::hci::iso_manager::kIsoEventCigOnCreateCmpl: {
         auto* evt = static_cast<cig_create_cmpl_evt*>(data);
         LeAudioDeviceGroup* group = aseGroups_.FindById(evt->cig_id);
@@ -5136,6 +5139,10 @@ class LeAudioClientImpl : public LeAudioClient {
 
         le_audio::MetricsCollector::Get()->OnStreamStarted(
             active_group_id_, configuration_context_type_);
+        if (group) {
+          le_audio::MetricsCollector::Get()->OnStreamContextSwitchCompleted(
+              group_id, group->cig_reused_);
+        }
         break;
       case GroupStreamStatus::SUSPENDED:
         stream_setup_end_timestamp_ = 0;
@@ -5610,6 +5617,7 @@ void LeAudioClient::DebugDump(int fd) {
   LeAudioSourceAudioHalClient::DebugDump(fd);
   le_audio::AudioSetConfigurationProvider::DebugDump(fd);
   IsoManager::GetInstance()->Dump(fd);
+  le_audio::MetricsCollector::Get()->Dump(fd);
   LeAudioLogHistory::DebugDump(fd);
   dprintf(fd, "\n");
 }
@@ -246,6 +246,10 @@ void LeAudioDeviceGroup::SetCigState(le_audio::types::CigState state) {
   LOG_VERBOSE("%s -> %s", bluetooth::common::ToString(cig_state_).c_str(),
               bluetooth::common::ToString(state).c_str());
   cig_state_ = state;
+  if (state == le_audio::types::CigState::NONE) {
+    cig_params_.reset();
+    cig_conn_handles_.clear();
+  }
 }
 
 bool LeAudioDeviceGroup::Activate(LeAudioContextType context_type) {
@@ -2068,6 +2072,8 @@ LeAudioDeviceGroup::FindFirstSupportedConfiguration(
   /* Filter out device set for each end every scenario */
 
   auto required_snk_strategy = GetGroupStrategy(Size());
+  confs = AudioSetConfigurationProvider::Get()->GetConfigurations(
+      context_type, NumOfConnected(context_type), required_snk_strategy);
   for (const auto& conf : *confs) {
     if (IsConfigurationSupported(conf, context_type, required_snk_strategy)) {
       LOG_DEBUG("found: %s", conf->name.c_str());
@@ -2985,74 +2991,85 @@ void LeAudioDevices::Add(const RawAddress& address, DeviceConnectState state,
     return;
   }
 
-  leAudioDevices_.emplace_back(
-      std::make_shared<LeAudioDevice>(address, state, group_id));
+  auto new_device = std::make_shared<LeAudioDevice>(address, state, group_id);
+  leAudioDevices_.push_back(new_device);
+  address_index_[address] = std::move(new_device);
 }
 
 void LeAudioDevices::Remove(const RawAddress& address) {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&address](auto const& leAudioDevice) {
-                             return leAudioDevice->address_ == address;
-                           });
-
-  if (iter == leAudioDevices_.end()) {
+  auto index = address_index_.find(address);
+  if (index == address_index_.end()) {
     LOG(ERROR) << __func__ << ", no such address: "
                << ADDRESS_TO_LOGGABLE_STR(address);
     return;
   }
 
-  leAudioDevices_.erase(iter);
+  auto iter = std::find(leAudioDevices_.begin(), leAudioDevices_.end(),
+                        index->second);
+  if (iter != leAudioDevices_.end()) leAudioDevices_.erase(iter);
+  address_index_.erase(index);
 }
 
 LeAudioDevice* LeAudioDevices::FindByAddress(const RawAddress& address) {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&address](auto const& leAudioDevice) {
-                             return leAudioDevice->address_ == address;
-                           });
-
-  return (iter == leAudioDevices_.end()) ? nullptr : iter->get();
+  auto index = address_index_.find(address);
+  return (index == address_index_.end()) ? nullptr : index->second.get();
 }
 
 std::shared_ptr<LeAudioDevice> LeAudioDevices::GetByAddress(
     const RawAddress& address) {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&address](auto const& leAudioDevice) {
-                             return leAudioDevice->address_ == address;
-                           });
-
-  return (iter == leAudioDevices_.end()) ? nullptr : *iter;
+  auto index = address_index_.find(address);
+  return (index == address_index_.end()) ? nullptr : index->second;
 }
 
 LeAudioDevice* LeAudioDevices::FindByConnId(uint16_t conn_id) {
+  /* Many devices may be without connection, keep the first one as before */
+  bool cacheable = (conn_id != GATT_INVALID_CONN_ID);
+  if (cacheable) {
+    auto index = conn_id_index_.find(conn_id);
+    if (index != conn_id_index_.end()) {
+      auto device = index->second.lock();
+      if (device && device->conn_id_ == conn_id) return device.get();
+      conn_id_index_.erase(index);
+    }
+  }
+
   auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
                            [&conn_id](auto const& leAudioDevice) {
                              return leAudioDevice->conn_id_ == conn_id;
                            });
 
-  return (iter == leAudioDevices_.end()) ? nullptr : iter->get();
+  if (iter == leAudioDevices_.end()) return nullptr;
+
+  if (cacheable) conn_id_index_[conn_id] = *iter;
+  return iter->get();
 }
 
 LeAudioDevice* LeAudioDevices::FindByCisConnHdl(uint8_t cig_id,
                                                 uint16_t conn_hdl) {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&conn_hdl, &cig_id](auto& d) {
-                             LeAudioDevice* dev;
-                             BidirectAsesPair ases;
+  auto is_cis_owner = [&conn_hdl, &cig_id](LeAudioDevice* dev) {
+    if (dev->group_id_ != cig_id) {
+      return false;
+    }
 
-                             dev = d.get();
-                             if (dev->group_id_ != cig_id) {
-                               return false;
-                             }
+    BidirectAsesPair ases = dev->GetAsesByCisConnHdl(conn_hdl);
+    return (ases.sink || ases.source);
+  };
 
-                             ases = dev->GetAsesByCisConnHdl(conn_hdl);
-                             if (ases.sink || ases.source)
-                               return true;
-                             else
-                               return false;
-                           });
+  auto key = std::make_pair(cig_id, conn_hdl);
+  auto index = cis_conn_hdl_index_.find(key);
+  if (index != cis_conn_hdl_index_.end()) {
+    auto device = index->second.lock();
+    if (device && is_cis_owner(device.get())) return device.get();
+    cis_conn_hdl_index_.erase(index);
+  }
+
+  auto iter = std::find_if(
+      leAudioDevices_.begin(), leAudioDevices_.end(),
+      [&is_cis_owner](auto& d) { return is_cis_owner(d.get()); });
 
   if (iter == leAudioDevices_.end()) return nullptr;
 
+  cis_conn_hdl_index_[key] = *iter;
   return iter->get();
 }
 
@@ -3127,6 +3144,9 @@ void LeAudioDevices::Cleanup(tGATT_IF client_if) {
     }
   }
   leAudioDevices_.clear();
+  address_index_.clear();
+  conn_id_index_.clear();
+  cis_conn_hdl_index_.clear();
 }
 
 }  // namespace le_audio
@@ -238,6 +238,16 @@ class LeAudioDevices {
 
  private:
   std::vector<std::shared_ptr<LeAudioDevice>> leAudioDevices_;
+
+  /* Lookup indexes over leAudioDevices_. The address index is updated on
+   * Add()/Remove(). The connection id and the CIS handles are assigned to the
+   * device fields directly, hence their entries are only hints: they are
+   * verified on each hit and refreshed by a linear search on a miss.
+   */
+  std::map<RawAddress, std::shared_ptr<LeAudioDevice>> address_index_;
+  std::map<uint16_t, std::weak_ptr<LeAudioDevice>> conn_id_index_;
+  std::map<std::pair<uint8_t, uint16_t>, std::weak_ptr<LeAudioDevice>>
+      cis_conn_hdl_index_;
 };
 
 /* LeAudioDeviceGroup class represents group of LeAudioDevices and allows to
@@ -264,10 +274,20 @@ class LeAudioDeviceGroup {
   bool is_duplex_preference_le_audio;
 
   std::vector<struct types::cis> cises_;
+
+  /* Parameters and CIS handles of the CIG currently in the controller, kept
+   * so that the next stream can reuse it when its parameters did not change.
+   */
+  std::optional<bluetooth::hci::iso_manager::cig_create_params> cig_params_;
+  std::vector<uint16_t> cig_conn_handles_;
+  /* Whether the last CIG setup reused or reconfigured an existing CIG */
+  bool cig_reused_;
+
   explicit LeAudioDeviceGroup(const int group_id)
       : group_id_(group_id),
         enabled_(true),
         cig_state_(types::CigState::NONE),
+        cig_reused_(false),
         stream_conf({}),
         audio_directions_(0),
         transport_latency_mtos_us_(0),
@@ -168,6 +168,28 @@ TEST_F(LeAudioDevicesTest, test_find_by_conn_id_failed) {
   ASSERT_EQ(nullptr, devices_->FindByConnId(0x0006));
 }
 
+TEST_F(LeAudioDevicesTest, test_find_by_conn_id_after_reassignment) {
+  RawAddress test_address_0 = GetTestAddress(0);
+  devices_->Add(test_address_0, DeviceConnectState::CONNECTING_BY_USER);
+  RawAddress test_address_1 = GetTestAddress(1);
+  devices_->Add(test_address_1, DeviceConnectState::CONNECTING_BY_USER);
+  LeAudioDevice* device_0 = devices_->FindByAddress(test_address_0);
+  LeAudioDevice* device_1 = devices_->FindByAddress(test_address_1);
+
+  device_0->conn_id_ = 0x0005;
+  ASSERT_EQ(device_0, devices_->FindByConnId(0x0005));
+
+  /* The connection id is reused by the other device */
+  device_0->conn_id_ = GATT_INVALID_CONN_ID;
+  device_1->conn_id_ = 0x0005;
+  ASSERT_EQ(device_1, devices_->FindByConnId(0x0005));
+
+  devices_->Remove(test_address_1);
+  ASSERT_EQ(nullptr, devices_->FindByConnId(0x0005));
+  ASSERT_EQ(nullptr, devices_->FindByAddress(test_address_1));
+  ASSERT_EQ(device_0, devices_->FindByAddress(test_address_0));
+}
+
 /* TODO: Add FindByCisConnHdl test cases (ASE) */
 
 }  // namespace
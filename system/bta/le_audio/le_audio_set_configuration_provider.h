@@ -32,6 +32,12 @@ class AudioSetConfigurationProvider {
   static void Cleanup();
   virtual const set_configurations::AudioSetConfigurations* GetConfigurations(
       ::le_audio::types::LeAudioContextType content_type) const;
+  /* Configurations for the context type, without those a group with the given
+   * number of connected devices and sink strategy cannot use */
+  virtual const set_configurations::AudioSetConfigurations* GetConfigurations(
+      ::le_audio::types::LeAudioContextType content_type,
+      uint8_t num_of_connected,
+      ::le_audio::types::LeAudioConfigurationStrategy snk_strategy) const;
 
  private:
   struct impl;
@@ -15,9 +15,11 @@
  *
  */
 
+#include <map>
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <tuple>
 
 #include "audio_set_configurations_generated.h"
 #include "audio_set_scenarios_generated.h"
@@ -34,34 +36,45 @@ using le_audio::set_configurations::CodecCapabilitySetting;
 using le_audio::set_configurations::LeAudioCodecIdLc3;
 using le_audio::set_configurations::QosConfigSetting;
 using le_audio::set_configurations::SetConfiguration;
+using le_audio::types::LeAudioConfigurationStrategy;
 using le_audio::types::LeAudioContextType;
 
 namespace le_audio {
 using ::le_audio::CodecManager;
 
 #ifdef __ANDROID__
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
+static const std::vector<std::tuple<const char* /*binary*/,
+                                    const char* /*schema*/,
+                                    const char* /*content*/>>
     kLeAudioSetConfigs = {
         {"/apex/com.android.btservices/etc/bluetooth/le_audio/"
+         "audio_set_configurations.bin",
+         "/apex/com.android.btservices/etc/bluetooth/le_audio/"
          "audio_set_configurations.bfbs",
          "/apex/com.android.btservices/etc/bluetooth/le_audio/"
          "audio_set_configurations.json"}};
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
+static const std::vector<std::tuple<const char* /*binary*/,
+                                    const char* /*schema*/,
+                                    const char* /*content*/>>
     kLeAudioSetScenarios = {{"/apex/com.android.btservices/etc/bluetooth/"
+                             "le_audio/audio_set_scenarios.bin",
+                             "/apex/com.android.btservices/etc/bluetooth/"
                              "le_audio/audio_set_scenarios.bfbs",
                              "/apex/com.android.btservices/etc/bluetooth/"
                              "le_audio/audio_set_scenarios.json"}};
 #else
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetConfigs = {
-        {"audio_set_configurations.bfbs", "audio_set_configurations.json"}};
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetScenarios = {
-        {"audio_set_scenarios.bfbs", "audio_set_scenarios.json"}};
+static const std::vector<std::tuple<const char* /*binary*/,
+                                    const char* /*schema*/,
+                                    const char* /*content*/>>
+    kLeAudioSetConfigs = {{"audio_set_configurations.bin",
+                           "audio_set_configurations.bfbs",
+                           "audio_set_configurations.json"}};
+static const std::vector<std::tuple<const char* /*binary*/,
+                                    const char* /*schema*/,
+                                    const char* /*content*/>>
+    kLeAudioSetScenarios = {{"audio_set_scenarios.bin",
+                             "audio_set_scenarios.bfbs",
+                             "audio_set_scenarios.json"}};
 #endif
 
 /** Provides a set configurations for the given context type */
@@ -150,6 +163,32 @@ struct AudioSetConfigurationProviderJson {
     return nullptr;
   };
 
+  /* Subset of the context type configurations, in the same priority order,
+   * which a group with |num_of_connected| devices and the |snk_strategy|
+   * could use at all. PAC records and ASEs still have to be checked.
+   */
+  const AudioSetConfigurations* GetConfigurationsByContextType(
+      LeAudioContextType context_type, uint8_t num_of_connected,
+      LeAudioConfigurationStrategy snk_strategy) const {
+    auto index_it = configuration_index_.find(context_type);
+    if (index_it == configuration_index_.end()) {
+      auto [it_begin, it_end] = ScenarioToContextTypes(kDefaultScenario);
+      if (it_begin != it_end)
+        index_it = configuration_index_.find(it_begin->second);
+    }
+
+    if (index_it != configuration_index_.end()) {
+      auto const& context_index = index_it->second;
+      auto confs_it = context_index.configurations.find(
+          {std::min(num_of_connected, context_index.max_required_devices),
+           snk_strategy});
+      if (confs_it != context_index.configurations.end())
+        return &confs_it->second;
+    }
+
+    return GetConfigurationsByContextType(context_type);
+  }
+
  private:
   /* Codec configurations */
   std::map<std::string, const AudioSetConfiguration> configurations_;
@@ -158,6 +197,18 @@ struct AudioSetConfigurationProviderJson {
   std::map<::le_audio::types::LeAudioContextType, AudioSetConfigurations>
       context_configurations_;
 
+  /* Configurations of a context type by the number of connected devices,
+   * clamped to the most any of them requires, and by the sink strategy
+   */
+  struct ContextConfigurationIndex {
+    uint8_t max_required_devices;
+    std::map<std::pair<uint8_t, LeAudioConfigurationStrategy>,
+             AudioSetConfigurations>
+        configurations;
+  };
+  std::map<::le_audio::types::LeAudioContextType, ContextConfigurationIndex>
+      configuration_index_;
+
   static const bluetooth::le_audio::CodecSpecificConfiguration*
   LookupCodecSpecificParam(
       const flatbuffers::Vector<
@@ -399,33 +450,58 @@ struct AudioSetConfigurationProviderJson {
     return AudioSetConfiguration({flat_cfg->name()->c_str(), subconfigs});
   }
 
-  bool LoadConfigurationsFromFiles(const char* schema_file,
-                                   const char* content_file) {
-    flatbuffers::Parser configurations_parser_;
-    std::string configurations_schema_binary_content;
-    bool ok = flatbuffers::LoadFile(schema_file, true,
-                                    &configurations_schema_binary_content);
+  /* The JSON content is compiled into a flatbuffer binary at build time, so
+   * that it does not have to be parsed on every start. The JSON is only
+   * parsed, against the binary schema, when that binary is missing or does
+   * not verify.
+   */
+  static bool LoadFlatBuffer(const char* binary_file, const char* schema_file,
+                             const char* content_file,
+                             bool (*verify_buffer)(flatbuffers::Verifier&),
+                             std::string& buffer) {
+    if (flatbuffers::LoadFile(binary_file, true, &buffer)) {
+      flatbuffers::Verifier verifier((const uint8_t*)buffer.c_str(),
+                                     buffer.length());
+      if (verify_buffer(verifier)) return true;
+      LOG_WARN(": Invalid %s, falling back to %s", binary_file, content_file);
+    }
+
+    flatbuffers::Parser parser;
+    std::string schema_binary_content;
+    bool ok = flatbuffers::LoadFile(schema_file, true, &schema_binary_content);
     if (!ok) return ok;
 
     /* Load the binary schema */
-    ok = configurations_parser_.Deserialize(
-        (uint8_t*)configurations_schema_binary_content.c_str(),
-        configurations_schema_binary_content.length());
+    ok = parser.Deserialize((uint8_t*)schema_binary_content.c_str(),
+                            schema_binary_content.length());
     if (!ok) return ok;
 
     /* Load the content from JSON */
-    std::string configurations_json_content;
-    ok = flatbuffers::LoadFile(content_file, false,
-                               &configurations_json_content);
+    std::string json_content;
+    ok = flatbuffers::LoadFile(content_file, false, &json_content);
     if (!ok) return ok;
 
     /* Parse */
-    ok = configurations_parser_.Parse(configurations_json_content.c_str());
+    ok = parser.Parse(json_content.c_str());
     if (!ok) return ok;
 
+    buffer.assign((const char*)parser.builder_.GetBufferPointer(),
+                  parser.builder_.GetSize());
+    return true;
+  }
+
+  bool LoadConfigurationsFromFiles(const char* binary_file,
+                                   const char* schema_file,
+                                   const char* content_file) {
+    std::string configurations_buffer;
+    if (!LoadFlatBuffer(binary_file, schema_file, content_file,
+                        bluetooth::le_audio::VerifyAudioSetConfigurationsBuffer,
+                        configurations_buffer))
+      return false;
+
     /* Import from flatbuffers */
     auto configurations_root = bluetooth::le_audio::GetAudioSetConfigurations(
-        configurations_parser_.builder_.GetBufferPointer());
+        configurations_buffer.c_str());
     if (!configurations_root) return false;
 
     auto flat_qos_configs = configurations_root->qos_configurations();
@@ -477,32 +553,18 @@ struct AudioSetConfigurationProviderJson {
     return items;
   }
 
-  bool LoadScenariosFromFiles(const char* schema_file,
+  bool LoadScenariosFromFiles(const char* binary_file,
+                              const char* schema_file,
                               const char* content_file) {
-    flatbuffers::Parser scenarios_parser_;
-    std::string scenarios_schema_binary_content;
-    bool ok = flatbuffers::LoadFile(schema_file, true,
-                                    &scenarios_schema_binary_content);
-    if (!ok) return ok;
-
-    /* Load the binary schema */
-    ok = scenarios_parser_.Deserialize(
-        (uint8_t*)scenarios_schema_binary_content.c_str(),
-        scenarios_schema_binary_content.length());
-    if (!ok) return ok;
-
-    /* Load the content from JSON */
-    std::string scenarios_json_content;
-    ok = flatbuffers::LoadFile(content_file, false, &scenarios_json_content);
-    if (!ok) return ok;
-
-    /* Parse */
-    ok = scenarios_parser_.Parse(scenarios_json_content.c_str());
-    if (!ok) return ok;
+    std::string scenarios_buffer;
+    if (!LoadFlatBuffer(binary_file, schema_file, content_file,
+                        bluetooth::le_audio::VerifyAudioSetScenariosBuffer,
+                        scenarios_buffer))
+      return false;
 
     /* Import from flatbuffers */
-    auto scenarios_root = bluetooth::le_audio::GetAudioSetScenarios(
-        scenarios_parser_.builder_.GetBufferPointer());
+    auto scenarios_root =
+        bluetooth::le_audio::GetAudioSetScenarios(scenarios_buffer.c_str());
     if (!scenarios_root) return false;
 
     auto flat_scenarios = scenarios_root->scenarios();
@@ -528,18 +590,70 @@ struct AudioSetConfigurationProviderJson {
     return true;
   }
 
+  static bool MatchesSinkStrategy(const AudioSetConfiguration* conf,
+                                  LeAudioConfigurationStrategy strategy) {
+    for (const auto& ent : conf->confs) {
+      if (ent.direction == types::kLeAudioDirectionSink &&
+          ent.strategy != strategy)
+        return false;
+    }
+    return true;
+  }
+
+  void BuildConfigurationIndex() {
+    static constexpr LeAudioConfigurationStrategy kSinkStrategies[] = {
+        LeAudioConfigurationStrategy::MONO_ONE_CIS_PER_DEVICE,
+        LeAudioConfigurationStrategy::STEREO_TWO_CISES_PER_DEVICE,
+        LeAudioConfigurationStrategy::STEREO_ONE_CIS_PER_DEVICE,
+    };
+
+    for (auto const& [context_type, confs] : context_configurations_) {
+      ContextConfigurationIndex context_index{};
+      for (auto const* conf : confs) {
+        context_index.max_required_devices = std::max(
+            context_index.max_required_devices,
+            set_configurations::get_num_of_devices_in_configuration(conf));
+      }
+
+      for (uint8_t num_of_connected = 0;
+           num_of_connected <= context_index.max_required_devices;
+           num_of_connected++) {
+        for (auto strategy : kSinkStrategies) {
+          auto& indexed = context_index.configurations[{num_of_connected,
+                                                        strategy}];
+          for (auto const* conf : confs) {
+            if (set_configurations::check_if_may_cover_scenario(
+                    conf, num_of_connected) &&
+                MatchesSinkStrategy(conf, strategy))
+              indexed.push_back(conf);
+          }
+        }
+      }
+
+      LOG_DEBUG(": Indexed %zu configurations for context %d, up to %d devices",
+                confs.size(), static_cast<int>(context_type),
+                +context_index.max_required_devices);
+      configuration_index_.insert_or_assign(context_type,
+                                            std::move(context_index));
+    }
+  }
+
   bool LoadContent(
-      std::vector<std::pair<const char* /*schema*/, const char* /*content*/>>
+      std::vector<std::tuple<const char* /*binary*/, const char* /*schema*/,
+                             const char* /*content*/>>
           config_files,
-      std::vector<std::pair<const char* /*schema*/, const char* /*content*/>>
+      std::vector<std::tuple<const char* /*binary*/, const char* /*schema*/,
+                             const char* /*content*/>>
           scenario_files) {
-    for (auto [schema, content] : config_files) {
-      if (!LoadConfigurationsFromFiles(schema, content)) return false;
+    for (auto [binary, schema, content] : config_files) {
+      if (!LoadConfigurationsFromFiles(binary, schema, content)) return false;
     }
 
-    for (auto [schema, content] : scenario_files) {
-      if (!LoadScenariosFromFiles(schema, content)) return false;
+    for (auto [binary, schema, content] : scenario_files) {
+      if (!LoadScenariosFromFiles(binary, schema, content)) return false;
     }
+
+    BuildConfigurationIndex();
     return true;
   }
 };
@@ -668,4 +782,19 @@ AudioSetConfigurationProvider::GetConfigurations(
   return nullptr;
 }
 
+const set_configurations::AudioSetConfigurations*
+AudioSetConfigurationProvider::GetConfigurations(
+    ::le_audio::types::LeAudioContextType content_type,
+    uint8_t num_of_connected,
+    ::le_audio::types::LeAudioConfigurationStrategy snk_strategy) const {
+  /* Offload configurations are not indexed */
+  if (CodecManager::GetInstance()->GetCodecLocation() ==
+          types::CodecLocation::ADSP ||
+      !pimpl_->IsRunning())
+    return GetConfigurations(content_type);
+
+  return pimpl_->config_provider_impl_->GetConfigurationsByContextType(
+      content_type, num_of_connected, snk_strategy);
+}
+
 }  // namespace le_audio
@@ -16,7 +16,13 @@
 
 #include "metrics_collector.h"
 
+#include <base/strings/stringprintf.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
 #include <memory>
+#include <sstream>
 #include <vector>
 
 #include "common/metrics.h"
@@ -292,6 +298,50 @@ void MetricsCollector::OnBroadcastStateChanged(bool started) {
   }
 }
 
+void MetricsCollector::OnStreamContextSwitchStarted(int32_t group_id) {
+  if (group_id <= 0) return;
+  context_switches_[group_id].started_timepoint =
+      std::chrono::high_resolution_clock::now();
+}
+
+void MetricsCollector::OnStreamContextSwitchCompleted(int32_t group_id,
+                                                      bool cig_reused) {
+  auto it = context_switches_.find(group_id);
+  if (it == context_switches_.end() ||
+      it->second.started_timepoint == kInvalidTimePoint) {
+    return;
+  }
+
+  int64_t latency_nanos = get_timedelta_nanos(
+      std::chrono::high_resolution_clock::now(), it->second.started_timepoint);
+  it->second.started_timepoint = kInvalidTimePoint;
+
+  SwitchLatency& latency =
+      cig_reused ? it->second.cig_reused : it->second.cig_recreated;
+  latency.count++;
+  latency.total_nanos += latency_nanos;
+  latency.max_nanos = std::max(latency.max_nanos, latency_nanos);
+}
+
+void MetricsCollector::Dump(int fd) {
+  std::stringstream stream;
+  stream << "  LE Audio context switch latency:\n";
+  for (const auto& [group_id, switches] : context_switches_) {
+    for (const auto& [label, latency] :
+         {std::make_pair("cig reused", switches.cig_reused),
+          std::make_pair("cig recreated", switches.cig_recreated)}) {
+      if (latency.count == 0) continue;
+      stream << base::StringPrintf(
+          "    group %d, %s: count: %u, avg: %" PRId64 " us, max: %" PRId64
+          " us\n",
+          group_id, label, latency.count,
+          latency.total_nanos / latency.count / 1000,
+          latency.max_nanos / 1000);
+    }
+  }
+  dprintf(fd, "%s", stream.str().c_str());
+}
+
 void MetricsCollector::Flush() {
   LOG(INFO) << __func__;
   for (auto& p : opened_groups_) {
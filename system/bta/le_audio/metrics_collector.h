@@ -129,6 +129,28 @@ class MetricsCollector {
    */
   void OnBroadcastStateChanged(bool started);
 
+  /**
+   * When the group starts reconfiguring its stream for another context type
+   *
+   * @param group_id Group ID of the associated stream.
+   */
+  void OnStreamContextSwitchStarted(int32_t group_id);
+
+  /**
+   * When the group is streaming again after a context switch
+   *
+   * @param group_id Group ID of the associated stream.
+   * @param cig_reused if the CIG of the previous stream was kept.
+   */
+  void OnStreamContextSwitchCompleted(int32_t group_id, bool cig_reused);
+
+  /**
+   * Dump the context switch latencies, which have no statsd atom
+   *
+   * @param fd File descriptor to write to.
+   */
+  void Dump(int fd);
+
   /**
    * Flush all log to statsd
    *
@@ -146,6 +168,20 @@ class MetricsCollector {
   std::unordered_map<int32_t, int32_t> group_size_table_;
 
   metrics::ClockTimePoint broadcast_beginning_timepoint_;
+
+  struct SwitchLatency {
+    uint32_t count = 0;
+    int64_t total_nanos = 0;
+    int64_t max_nanos = 0;
+  };
+
+  struct ContextSwitchMetrics {
+    metrics::ClockTimePoint started_timepoint;
+    SwitchLatency cig_reused;
+    SwitchLatency cig_recreated;
+  };
+
+  std::unordered_map<int32_t, ContextSwitchMetrics> context_switches_;
 };
 
 }  // namespace le_audio
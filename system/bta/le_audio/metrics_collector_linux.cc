@@ -42,6 +42,13 @@ void MetricsCollector::OnStreamEnded(int32_t group_id) {}
 
 void MetricsCollector::OnBroadcastStateChanged(bool started) {}
 
+void MetricsCollector::OnStreamContextSwitchStarted(int32_t group_id) {}
+
+void MetricsCollector::OnStreamContextSwitchCompleted(int32_t group_id,
+                                                      bool cig_reused) {}
+
+void MetricsCollector::Dump(int fd) {}
+
 void MetricsCollector::Flush() {}
 
 }  // namespace le_audio
@@ -21,6 +21,8 @@
 #include <unistd.h>
 
 #include <cstdint>
+#include <cstdio>
+#include <string>
 #include <vector>
 
 #include "types/raw_address.h"
@@ -384,4 +386,31 @@ TEST_F(MetricsCollectorTest, BroadastSessions) {
   ASSERT_GT(last_broadcast_duration_nanos, 0);
 }
 
+TEST_F(MetricsCollectorTest, StreamContextSwitches) {
+  // Completion without a start is ignored
+  collector->OnStreamContextSwitchCompleted(group_id1, true);
+  collector->OnStreamContextSwitchStarted(group_id1);
+  collector->OnStreamContextSwitchCompleted(group_id1, true);
+  collector->OnStreamContextSwitchCompleted(group_id1, true);
+  collector->OnStreamContextSwitchStarted(group_id2);
+  collector->OnStreamContextSwitchCompleted(group_id2, false);
+
+  FILE* file = tmpfile();
+  ASSERT_NE(file, nullptr);
+  collector->Dump(fileno(file));
+  rewind(file);
+  std::string dump;
+  char buf[256];
+  while (fgets(buf, sizeof(buf), file) != nullptr) dump += buf;
+  fclose(file);
+
+  ASSERT_NE(dump.find("group 1, cig reused: count: 1,"), std::string::npos);
+  ASSERT_EQ(dump.find("group 1, cig recreated"), std::string::npos);
+  ASSERT_NE(dump.find("group 2, cig recreated: count: 1,"), std::string::npos);
+  ASSERT_EQ(dump.find("group 2, cig reused"), std::string::npos);
+
+  // Switching does not log a streaming session on its own
+  ASSERT_EQ(log_count, 0);
+}
+
 }  // namespace le_audio
\ No newline at end of file
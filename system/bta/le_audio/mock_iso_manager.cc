@@ -116,6 +116,11 @@ void IsoManager::HandleIsoData(void* p_msg) {
   pimpl_->HandleIsoData(static_cast<BT_HDR*>(p_msg));
 }
 
+void IsoManager::ReleaseIsoSdu(void* p_msg) {
+  if (!pimpl_) return;
+  pimpl_->ReleaseIsoSdu(p_msg);
+}
+
 void IsoManager::HandleDisconnect(uint16_t handle, uint8_t reason) {
   if (!pimpl_) return;
   pimpl_->HandleDisconnect(handle, reason);
@@ -65,6 +65,7 @@ struct MockIsoManager {
        struct bluetooth::hci::iso_manager::big_create_params big_params));
   MOCK_METHOD((void), TerminateBig, (uint8_t big_id, uint8_t reason));
   MOCK_METHOD((void), HandleIsoData, (void* p_msg));
+  MOCK_METHOD((void), ReleaseIsoSdu, (void* p_msg));
   MOCK_METHOD((void), HandleDisconnect, (uint16_t handle, uint8_t reason));
   MOCK_METHOD((void), HandleNumComplDataPkts, (uint8_t * p, uint8_t evt_len));
   MOCK_METHOD((void), HandleGdNumComplDataPkts, (uint8_t * p, uint8_t evt_len));
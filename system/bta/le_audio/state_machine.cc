@@ -21,6 +21,7 @@
 #include <base/functional/callback.h>
 #include <base/strings/string_number_conversions.h>
 
+#include <algorithm>
 #include <map>
 
 #include "bt_types.h"
@@ -126,7 +127,10 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
  public:
   LeAudioGroupStateMachineImpl(Callbacks* state_machine_callbacks_)
       : state_machine_callbacks_(state_machine_callbacks_),
-        watchdog_(alarm_new("LeAudioStateMachineTimer")) {
+        watchdog_(alarm_new("LeAudioStateMachineTimer")),
+        pipelined_stream_setup_(
+            osi_property_get_bool(kPipelinedStreamSetupProp, false)),
+        cig_reuse_(osi_property_get_bool(kCigReuseProp, false)) {
     log_history_ = LeAudioLogHistory::Get();
   }
 
@@ -178,7 +182,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
         if (group->GetConfigurationContextType() == context_type) {
           if (group->Activate(context_type)) {
             SetTargetState(group, AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
-            if (CigCreate(group)) {
+            if (CreateCigForStreaming(group)) {
               return true;
             }
           }
@@ -387,6 +391,15 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
         return;
       }
 
+      if (group->cig_reused_) {
+        /* Failed reconfiguration leaves the CIG in the controller */
+        LOG_ERROR(", failed to reconfigure CIG, reason: 0x%02x", +status);
+        group->SetCigState(CigState::CREATED);
+        RemoveCigForGroup(group);
+        StopStream(group);
+        return;
+      }
+
       group->SetCigState(CigState::NONE);
       LOG_ERROR(", failed to create CIG, reason: 0x%02x, new cig state: %s",
                 +status, ToString(group->cig_state_).c_str());
@@ -403,17 +416,28 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
              group, group->group_id_, ToString(group->cig_state_).c_str(),
              static_cast<int>(conn_handles.size()));
 
+    /* Keep the handles for the next stream which may reuse this CIG */
+    group->cig_conn_handles_ = conn_handles;
+
     /* Assign all connection handles to cis ids */
     group->CigAssignCisConnHandles(conn_handles);
 
     /* Assign all connection handles to ases */
     group->CigAssignCisConnHandlesToAses();
 
+    if (pipelined_stream_setup_ &&
+        group->GetState() == AseState::BTA_LE_AUDIO_ASE_STATE_ENABLING) {
+      /* All ASEs got enabled while the CIG was being created */
+      ProcessGroupEnable(group);
+      return;
+    }
+
     /* Last node configured, process group to codec configured state */
     group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED);
 
     if (group->GetTargetState() == AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
-      PrepareAndSendQoSToTheGroup(group);
+      /* In the pipelined mode QoS was sent along with the CIG creation */
+      if (!pipelined_stream_setup_) PrepareAndSendQoSToTheGroup(group);
     } else {
       LOG_ERROR(", invalid state transition, from: %s , to: %s",
                 ToString(group->GetState()).c_str(),
@@ -477,7 +501,10 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
                group->group_id_, ToString(group->GetCigState()).c_str());
 
     group->SetCigState(CigState::NONE);
+    ClearCisDataPathStates(group);
+  }
 
+  void ClearCisDataPathStates(LeAudioDeviceGroup* group) {
     LeAudioDevice* leAudioDevice = group->GetFirstDevice();
     if (!leAudioDevice) return;
 
@@ -624,6 +651,21 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     group->CigClearCis();
   }
 
+  /* All the CISes are gone. When the group is being reconfigured for another
+   * stream, the CIG stays in the controller so the next stream can reuse it.
+   */
+  void ReleaseCigForGroup(LeAudioDeviceGroup* group, bool reconfiguring) {
+    if (cig_reuse_ && reconfiguring &&
+        group->GetCigState() == CigState::CREATED) {
+      LOG_INFO("Group %d is reconfiguring, keeping its CIG",
+               group->group_id_);
+      ClearCisDataPathStates(group);
+      return;
+    }
+
+    RemoveCigForGroup(group);
+  }
+
   void RemoveCigForGroup(LeAudioDeviceGroup* group) {
     LOG_DEBUG("Group: %p, id: %d cig state: %s", group, group->group_id_,
               ToString(group->cig_state_).c_str());
@@ -970,6 +1012,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
          */
         cancel_watchdog_if_needed(group->group_id_);
 
+        auto reconfiguring = group->IsPendingConfiguration();
         if (current_group_state == AseState::BTA_LE_AUDIO_ASE_STATE_IDLE) {
           LOG_INFO(
               "Cises disconnected for group %d, we are good in Idle state.",
@@ -999,7 +1042,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
             }
           }
         }
-        RemoveCigForGroup(group);
+        ReleaseCigForGroup(group, reconfiguring);
       } break;
       default:
         break;
@@ -1043,9 +1086,16 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
   static constexpr uint64_t kStateTransitionTimeoutMs = 3500;
   static constexpr char kStateTransitionTimeoutMsProp[] =
       "persist.bluetooth.leaudio.device.set.state.timeoutms";
+  static constexpr char kPipelinedStreamSetupProp[] =
+      "persist.bluetooth.leaudio.pipelined_stream_setup";
+  static constexpr char kCigReuseProp[] = "persist.bluetooth.leaudio.cig_reuse";
   Callbacks* state_machine_callbacks_;
   alarm_t* watchdog_;
   LeAudioLogHistory* log_history_;
+  /* Config QoS and Enable are sent while the CIG is being created */
+  bool pipelined_stream_setup_;
+  /* CIG is kept over a reconfiguration and reused by the next stream */
+  bool cig_reuse_;
 
   /* This callback is called on timeout during transition to target state */
   void OnStateTransitionTimeout(int group_id) {
@@ -1325,7 +1375,8 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     LOG_DEBUG("Group: %p, id: %d cig state: %s", group, group->group_id_,
               ToString(group->cig_state_).c_str());
 
-    if (group->GetCigState() != CigState::NONE) {
+    if (group->GetCigState() != CigState::NONE &&
+        !(cig_reuse_ && group->GetCigState() == CigState::CREATED)) {
       LOG_WARN(" Group %p, id: %d has invalid cig state: %s ", group,
                group->group_id_, ToString(group->cig_state_).c_str());
       return false;
@@ -1425,10 +1476,17 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
         .cis_cfgs = std::move(cis_cfgs),
     };
 
+    if (group->GetCigState() == CigState::CREATED) {
+      ReuseCig(group, std::move(param));
+      return true;
+    }
+
     log_history_->AddLogHistory(
         kLogStateMachineTag, group->group_id_, RawAddress::kEmpty,
         kLogCigCreateOp + "#CIS: " + std::to_string(param.cis_cfgs.size()));
 
+    group->cig_params_ = param;
+    group->cig_reused_ = false;
     group->SetCigState(CigState::CREATING);
     IsoManager::GetInstance()->CreateCig(group->group_id_, std::move(param));
     LOG_DEBUG("Group: %p, id: %d cig state: %s", group, group->group_id_,
@@ -1436,6 +1494,88 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     return true;
   }
 
+  static bool IsSameCisCfg(const EXT_CIS_CFG& a, const EXT_CIS_CFG& b) {
+    return a.cis_id == b.cis_id &&
+           a.max_sdu_size_mtos == b.max_sdu_size_mtos &&
+           a.max_sdu_size_stom == b.max_sdu_size_stom &&
+           a.phy_mtos == b.phy_mtos && a.phy_stom == b.phy_stom &&
+           a.rtn_mtos == b.rtn_mtos && a.rtn_stom == b.rtn_stom;
+  }
+
+  static bool IsSameCisSet(
+      const bluetooth::hci::iso_manager::cig_create_params& a,
+      const bluetooth::hci::iso_manager::cig_create_params& b) {
+    return std::equal(a.cis_cfgs.begin(), a.cis_cfgs.end(),
+                      b.cis_cfgs.begin(), b.cis_cfgs.end(),
+                      [](const EXT_CIS_CFG& x, const EXT_CIS_CFG& y) {
+                        return x.cis_id == y.cis_id;
+                      });
+  }
+
+  static bool IsSameCigParams(
+      const bluetooth::hci::iso_manager::cig_create_params& a,
+      const bluetooth::hci::iso_manager::cig_create_params& b) {
+    return a.sdu_itv_mtos == b.sdu_itv_mtos &&
+           a.sdu_itv_stom == b.sdu_itv_stom && a.sca == b.sca &&
+           a.packing == b.packing && a.framing == b.framing &&
+           a.max_trans_lat_stom == b.max_trans_lat_stom &&
+           a.max_trans_lat_mtos == b.max_trans_lat_mtos &&
+           std::equal(a.cis_cfgs.begin(), a.cis_cfgs.end(),
+                      b.cis_cfgs.begin(), b.cis_cfgs.end(), IsSameCisCfg);
+  }
+
+  /* The CIG kept from the previous stream is used as is when nothing changed,
+   * reconfigured with LE Set CIG Parameters when only the CIS parameters
+   * changed, and removed and created again when the set of CISes changed as
+   * the controller cannot add or drop CISes of an existing CIG.
+   */
+  void ReuseCig(LeAudioDeviceGroup* group,
+                bluetooth::hci::iso_manager::cig_create_params param) {
+    if (!group->cig_params_ || !IsSameCisSet(*group->cig_params_, param)) {
+      LOG_INFO("Group %d CIS set changed, recreating its CIG",
+               group->group_id_);
+      group->SetCigState(CigState::RECOVERING);
+      IsoManager::GetInstance()->RemoveCig(group->group_id_);
+      log_history_->AddLogHistory(kLogStateMachineTag, group->group_id_,
+                                  RawAddress::kEmpty, kLogCigRemoveOp);
+      return;
+    }
+
+    group->cig_reused_ = true;
+    if (IsSameCigParams(*group->cig_params_, param)) {
+      LOG_INFO("Group %d reuses its CIG", group->group_id_);
+      log_history_->AddLogHistory(kLogStateMachineTag, group->group_id_,
+                                  RawAddress::kEmpty,
+                                  kLogCigCreateOp + " REUSED");
+      group->SetCigState(CigState::CREATING);
+      ProcessHciNotifOnCigCreate(group, HCI_SUCCESS, group->group_id_,
+                                 group->cig_conn_handles_);
+      return;
+    }
+
+    LOG_INFO("Group %d reconfigures its CIG", group->group_id_);
+    log_history_->AddLogHistory(
+        kLogStateMachineTag, group->group_id_, RawAddress::kEmpty,
+        kLogCigCreateOp + " RECONFIGURE #CIS: " +
+            std::to_string(param.cis_cfgs.size()));
+    group->cig_params_ = param;
+    group->SetCigState(CigState::CREATING);
+    IsoManager::GetInstance()->ReconfigureCig(group->group_id_,
+                                              std::move(param));
+  }
+
+  /* Config QoS only carries the CIG and CIS IDs, not the CIS connection
+   * handles, so in the pipelined mode it goes to all the group members while
+   * the controller is still creating the CIG. CISes are established once both
+   * the CIG is created and all the ASEs are enabled.
+   */
+  bool CreateCigForStreaming(LeAudioDeviceGroup* group) {
+    if (!CigCreate(group)) return false;
+
+    if (pipelined_stream_setup_) PrepareAndSendQoSToTheGroup(group);
+    return true;
+  }
+
   static bool CisCreateForDevice(LeAudioDeviceGroup* group,
                                  LeAudioDevice* leAudioDevice) {
     std::vector<EXT_CIS_CREATE_CFG> conn_pairs;
@@ -1865,7 +2005,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
 
         if (group->GetTargetState() ==
             AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
-          if (!CigCreate(group)) {
+          if (!CreateCigForStreaming(group)) {
             LOG_ERROR("Could not create CIG. Stop the stream for group %d",
                       group->group_id_);
             StopStream(group);
@@ -1965,7 +2105,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
 
         if (group->GetTargetState() ==
             AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
-          if (!CigCreate(group)) {
+          if (!CreateCigForStreaming(group)) {
             LOG_ERROR("Could not create CIG. Stop the stream for group %d",
                       group->group_id_);
             StopStream(group);
@@ -2798,7 +2938,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_RELEASING);
 
           /* At this point all of the active ASEs within group are released. */
-          RemoveCigForGroup(group);
+          ReleaseCigForGroup(group, group->IsPendingConfiguration());
         }
 
         break;
@@ -2864,6 +3004,13 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
       return;
     }
 
+    if (group->GetCigState() == CigState::CREATING ||
+        group->GetCigState() == CigState::RECOVERING) {
+      LOG_DEBUG("Group %d enabled, waiting for the CIG to create CISes",
+                group->group_id_);
+      return;
+    }
+
     if (!CisCreate(group)) {
       StopStream(group);
     }
@@ -1813,6 +1813,81 @@ TEST_F(StateMachineTest, testStreamMultiple) {
   ASSERT_EQ(1, get_func_call_count("alarm_cancel"));
 }
 
+TEST_F(StateMachineTest, testStreamMultiplePipelined) {
+  const auto context_type = kContextTypeMedia;
+  const auto leaudio_group_id = 4;
+  const auto num_devices = 2;
+
+  osi_property_set_bool("persist.bluetooth.leaudio.pipelined_stream_setup",
+                        true);
+  LeAudioGroupStateMachine::Cleanup();
+  LeAudioGroupStateMachine::Initialize(&mock_callbacks_);
+
+  // Prepare multiple fake connected devices in a group
+  auto* group =
+      PrepareSingleTestDeviceGroup(leaudio_group_id, context_type, num_devices);
+  ASSERT_EQ(group->Size(), num_devices);
+
+  PrepareConfigureCodecHandler(group);
+  PrepareConfigureQosHandler(group);
+  PrepareEnableHandler(group);
+
+  // Hold the CIG creation until all the ASEs are enabled
+  uint8_t cis_count = 0;
+  ON_CALL(*mock_iso_manager_, CreateCig)
+      .WillByDefault(
+          [&cis_count](uint8_t cig_id,
+                       bluetooth::hci::iso_manager::cig_create_params p) {
+            cis_count = p.cis_cfgs.size();
+          });
+
+  EXPECT_CALL(*mock_iso_manager_, CreateCig(_, _)).Times(1);
+  EXPECT_CALL(*mock_iso_manager_, EstablishCis(_)).Times(0);
+
+  InjectInitialIdleNotification(group);
+
+  auto* leAudioDevice = group->GetFirstDevice();
+  while (leAudioDevice) {
+    EXPECT_CALL(gatt_queue,
+                WriteCharacteristic(leAudioDevice->conn_id_,
+                                    leAudioDevice->ctp_hdls_.val_hdl, _,
+                                    GATT_WRITE_NO_RSP, _, _))
+        .Times(AtLeast(3));
+    leAudioDevice = group->GetNextDevice(leAudioDevice);
+  }
+
+  ASSERT_TRUE(LeAudioGroupStateMachine::Get()->StartStream(
+      group, context_type,
+      {.sink = types::AudioContexts(context_type),
+       .source = types::AudioContexts(context_type)}));
+
+  // Config QoS and Enable went through without waiting for the CIG
+  ASSERT_EQ(group->GetState(),
+            types::AseState::BTA_LE_AUDIO_ASE_STATE_ENABLING);
+  ASSERT_EQ(group->GetCigState(), types::CigState::CREATING);
+  testing::Mock::VerifyAndClearExpectations(mock_iso_manager_);
+
+  EXPECT_CALL(*mock_iso_manager_, EstablishCis(_)).Times(AtLeast(1));
+  EXPECT_CALL(*mock_iso_manager_, SetupIsoDataPath(_, _)).Times(2);
+  EXPECT_CALL(
+      mock_callbacks_,
+      StatusReportCb(leaudio_group_id,
+                     bluetooth::le_audio::GroupStreamStatus::STREAMING));
+
+  std::vector<uint16_t> conn_handles;
+  for (auto i = 0u; i < cis_count; ++i) {
+    conn_handles.push_back(UNIQUE_CIS_CONN_HANDLE(leaudio_group_id, i));
+  }
+  LeAudioGroupStateMachine::Get()->ProcessHciNotifOnCigCreate(
+      group, HCI_SUCCESS, leaudio_group_id, conn_handles);
+
+  ASSERT_EQ(group->GetState(),
+            types::AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
+
+  osi_property_set_bool("persist.bluetooth.leaudio.pipelined_stream_setup",
+                        false);
+}
+
 TEST_F(StateMachineTest, testUpdateMetadataMultiple) {
   const auto context_type = kContextTypeMedia;
   const auto leaudio_group_id = 4;
@@ -3686,6 +3761,100 @@ TEST_F(StateMachineTest, StartStreamCachedConfig) {
   ASSERT_EQ(1, get_func_call_count("alarm_cancel"));
 }
 
+TEST_F(StateMachineTest, StartStreamReusesCigAfterReconfiguration) {
+  const auto context_type = kContextTypeMedia;
+  const auto leaudio_group_id = 6;
+  const auto num_devices = 2;
+
+  osi_property_set_bool("persist.bluetooth.leaudio.cig_reuse", true);
+  LeAudioGroupStateMachine::Cleanup();
+  LeAudioGroupStateMachine::Initialize(&mock_callbacks_);
+
+  ContentControlIdKeeper::GetInstance()->SetCcid(media_context, media_ccid);
+
+  // Prepare multiple fake connected devices in a group
+  auto* group =
+      PrepareSingleTestDeviceGroup(leaudio_group_id, context_type, num_devices);
+  ASSERT_EQ(group->Size(), num_devices);
+
+  PrepareConfigureCodecHandler(group, 0, true);
+  PrepareConfigureQosHandler(group);
+  PrepareEnableHandler(group);
+  PrepareDisableHandler(group);
+  PrepareReleaseHandler(group);
+
+  InjectInitialIdleNotification(group);
+
+  auto* leAudioDevice = group->GetFirstDevice();
+  while (leAudioDevice) {
+    /* Six Writes:
+     * 1: Codec config
+     * 2: Codec QoS (+1 after restart)
+     * 3: Enabling (+1 after restart)
+     * 4: Release (1)
+     */
+    EXPECT_CALL(gatt_queue,
+                WriteCharacteristic(leAudioDevice->conn_id_,
+                                    leAudioDevice->ctp_hdls_.val_hdl, _,
+                                    GATT_WRITE_NO_RSP, _, _))
+        .Times(6);
+    leAudioDevice = group->GetNextDevice(leAudioDevice);
+  }
+
+  // The CIG is created once and kept over the reconfiguration
+  EXPECT_CALL(*mock_iso_manager_, CreateCig(_, _)).Times(1);
+  EXPECT_CALL(*mock_iso_manager_, ReconfigureCig(_, _)).Times(0);
+  EXPECT_CALL(*mock_iso_manager_, RemoveCig(_, _)).Times(0);
+
+  EXPECT_CALL(
+      mock_callbacks_,
+      StatusReportCb(leaudio_group_id,
+                     bluetooth::le_audio::GroupStreamStatus::STREAMING));
+
+  LeAudioGroupStateMachine::Get()->StartStream(
+      group, context_type,
+      {.sink = types::AudioContexts(context_type),
+       .source = types::AudioContexts(context_type)});
+
+  testing::Mock::VerifyAndClearExpectations(&mock_callbacks_);
+  ASSERT_FALSE(group->cig_reused_);
+
+  // Stop the stream to reconfigure
+  group->SetPendingConfiguration();
+  EXPECT_CALL(
+      mock_callbacks_,
+      StatusReportCb(leaudio_group_id,
+                     bluetooth::le_audio::GroupStreamStatus::RELEASING));
+  EXPECT_CALL(mock_callbacks_,
+              StatusReportCb(
+                  leaudio_group_id,
+                  bluetooth::le_audio::GroupStreamStatus::CONFIGURED_BY_USER));
+  LeAudioGroupStateMachine::Get()->StopStream(group);
+
+  testing::Mock::VerifyAndClearExpectations(&mock_callbacks_);
+  ASSERT_EQ(group->GetCigState(), types::CigState::CREATED);
+
+  // Restart the stream with the same parameters
+  group->ClearPendingConfiguration();
+  EXPECT_CALL(
+      mock_callbacks_,
+      StatusReportCb(leaudio_group_id,
+                     bluetooth::le_audio::GroupStreamStatus::STREAMING));
+
+  LeAudioGroupStateMachine::Get()->StartStream(
+      group, context_type,
+      {.sink = types::AudioContexts(context_type),
+       .source = types::AudioContexts(context_type)});
+
+  testing::Mock::VerifyAndClearExpectations(&mock_callbacks_);
+  testing::Mock::VerifyAndClearExpectations(mock_iso_manager_);
+  ASSERT_TRUE(group->cig_reused_);
+  ASSERT_EQ(group->GetState(),
+            types::AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
+
+  osi_property_set_bool("persist.bluetooth.leaudio.cig_reuse", false);
+}
+
 TEST_F(StateMachineTest, BoundedHeadphonesConversationalToMediaChannelCount_2) {
   const auto initial_context_type = kContextTypeConversational;
   const auto new_context_type = kContextTypeMedia;
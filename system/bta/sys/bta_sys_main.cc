@@ -38,7 +38,7 @@
 #include "osi/include/log.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
-#include "stack/include/btu.h"  // do_in_main_thread
+#include "stack/include/btu.h"  // do_in_executor
 
 void BTIF_dm_on_hw_error();
 
@@ -148,6 +148,29 @@ void bta_sys_deregister(uint8_t id) { bta_sys_cb.is_reg[id] = false; }
  ******************************************************************************/
 bool bta_sys_is_register(uint8_t id) { return bta_sys_cb.is_reg[id]; }
 
+/*******************************************************************************
+ *
+ * Function         bta_sys_executor
+ *
+ * Description      Get the executor the messages of a BTA subsystem are
+ *                  handled on.
+ *
+ *
+ * Returns          the executor of the subsystem
+ *
+ ******************************************************************************/
+static tBTU_EXECUTOR bta_sys_executor(const void* p_msg) {
+  switch (static_cast<const BT_HDR_RIGID*>(p_msg)->event >> 8) {
+    case BTA_ID_GATTC:
+    case BTA_ID_GATTS:
+      return tBTU_EXECUTOR::GATT;
+    case BTA_ID_AV:
+      return tBTU_EXECUTOR::AUDIO_CONTROL;
+    default:
+      return tBTU_EXECUTOR::MAIN;
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_sys_sendmsg
@@ -164,20 +187,20 @@ bool bta_sys_is_register(uint8_t id) { return bta_sys_cb.is_reg[id]; }
  *
  ******************************************************************************/
 void bta_sys_sendmsg(void* p_msg) {
-  if (do_in_main_thread(
-          FROM_HERE,
+  if (do_in_executor(
+          bta_sys_executor(p_msg), FROM_HERE,
           base::Bind(&bta_sys_event, static_cast<BT_HDR_RIGID*>(p_msg))) !=
       BT_STATUS_SUCCESS) {
-    LOG(ERROR) << __func__ << ": do_in_main_thread failed";
+    LOG(ERROR) << __func__ << ": do_in_executor failed";
   }
 }
 
 void bta_sys_sendmsg_delayed(void* p_msg, const base::TimeDelta& delay) {
-  if (do_in_main_thread_delayed(
-          FROM_HERE,
+  if (do_in_executor_delayed(
+          bta_sys_executor(p_msg), FROM_HERE,
           base::Bind(&bta_sys_event, static_cast<BT_HDR_RIGID*>(p_msg)),
           delay) != BT_STATUS_SUCCESS) {
-    LOG(ERROR) << __func__ << ": do_in_main_thread_delayed failed";
+    LOG(ERROR) << __func__ << ": do_in_executor_delayed failed";
   }
 }
 
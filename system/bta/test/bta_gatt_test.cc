@@ -27,6 +27,7 @@
 #include "osi/include/allocator.h"
 #include "stack/gatt/gatt_int.h"
 #include "test/common/mock_functions.h"
+#include "test/mock/mock_stack_gatt_api.h"
 
 namespace param {
 struct {
@@ -297,3 +298,94 @@ TEST_F(BtaGattTest, bta_gattc_op_cmpl_read_interrupted) {
   bta_gattc_op_cmpl(&client_channel_control_block, &data);
   ASSERT_EQ(GATT_ERROR, param::bta_gatt_read_complete_callback.status);
 }
+
+TEST_F(BtaGattTest, bta_gattc_read_on_additional_bearer) {
+  command_queue = {
+      .api_read =  // tBTA_GATTC_API_READ
+      {
+          .hdr =
+              {
+                  .event = BTA_GATTC_API_READ_EVT,
+              },
+          .handle = 123,
+      },
+  };
+  client_channel_control_block.p_q_cmd = &command_queue;
+  client_channel_control_block.transport = BT_TRANSPORT_LE;
+
+  tBTA_GATTC_DATA read_other_handle = {
+      .api_read =
+          {
+              .hdr =
+                  {
+                      .event = BTA_GATTC_API_READ_EVT,
+                  },
+              .handle = 2,
+          },
+  };
+  tBTA_GATTC_DATA read_same_handle = read_other_handle;
+  read_same_handle.api_read.handle = 123;
+
+  test::mock::stack_gatt_api::GATTC_IsAdditionalBearerAvailable.body =
+      [](uint16_t conn_id) { return true; };
+
+  // Independent read is sent right away, a read of a handle in flight waits
+  bta_gattc_read(&client_channel_control_block, &read_other_handle);
+  bta_gattc_read(&client_channel_control_block, &read_same_handle);
+  ASSERT_EQ(1, get_func_call_count("GATTC_Read"));
+  ASSERT_EQ(&command_queue, client_channel_control_block.p_q_cmd);
+  ASSERT_EQ(1u, client_channel_control_block.p_q_cmd_parallel.size());
+  ASSERT_EQ(1u, client_channel_control_block.p_q_cmd_queue.size());
+  ASSERT_TRUE(bta_gattc_is_data_queued(&client_channel_control_block,
+                                       &read_other_handle));
+
+  test::mock::stack_gatt_api::GATTC_IsAdditionalBearerAvailable = {};
+  client_channel_control_block.p_q_cmd_queue.clear();
+}
+
+TEST_F(BtaGattTest, bta_gattc_op_cmpl_parallel_read) {
+  command_queue = {
+      .api_read =  // tBTA_GATTC_API_READ
+      {
+          .hdr =
+              {
+                  .event = BTA_GATTC_API_READ_EVT,
+              },
+          .handle = 123,
+      },
+  };
+  client_channel_control_block.p_q_cmd = &command_queue;
+
+  tBTA_GATTC_DATA parallel_read = {
+      .api_read =
+          {
+              .hdr =
+                  {
+                      .event = BTA_GATTC_API_READ_EVT,
+                  },
+              .handle = 2,
+              .read_cb = bta_gatt_read_complete_callback,
+              .read_cb_data = static_cast<void*>(this),
+          },
+  };
+  client_channel_control_block.p_q_cmd_parallel.push_back(&parallel_read);
+
+  // Completion of the read of handle 2, while handle 123 is still read
+  tBTA_GATTC_DATA data = {
+      .op_cmpl =
+          {
+              .op_code = GATTC_OPTYPE_READ,
+              .status = GATT_SUCCESS,
+              .p_cmpl = &gatt_cl_complete,
+          },
+  };
+
+  bta_gattc_op_cmpl(&client_channel_control_block, &data);
+  ASSERT_EQ(1, get_func_call_count("osi_free_and_reset"));
+  ASSERT_EQ(GATT_SUCCESS, param::bta_gatt_read_complete_callback.status);
+  ASSERT_EQ(2, param::bta_gatt_read_complete_callback.handle);
+  ASSERT_EQ(4, param::bta_gatt_read_complete_callback.len);
+  ASSERT_EQ(this, param::bta_gatt_read_complete_callback.data);
+  ASSERT_EQ(&command_queue, client_channel_control_block.p_q_cmd);
+  ASSERT_TRUE(client_channel_control_block.p_q_cmd_parallel.empty());
+}
@@ -21,6 +21,7 @@
 #include "bta/dm/bta_dm_int.h"
 #include "bta/hh/bta_hh_int.h"
 #include "bta/include/bta_hh_api.h"
+#include "common/time_util.h"
 #include "osi/include/allocator.h"
 #include "test/common/mock_functions.h"
 #include "test/mock/mock_osi_allocator.h"
@@ -106,3 +107,38 @@ TEST_F(BtaHhTest, bta_hh_ctrl_dat_act__BTA_HH_GET_RPT_EVT) {
   bta_hh_ctrl_dat_act(&cb, &data);
   ASSERT_EQ(cb.w4_evt, 0);
 }
+
+TEST_F(BtaHhTest, bta_hh_data_act__records_report_latency) {
+  tBTA_HH_DEV_CB cb = {};
+
+  tBTA_HH_DATA data = {
+      .hid_cback =
+          {
+              .hdr =
+                  {
+                      .event = BTA_HH_INT_DATA_EVT,
+                      .len = 0,
+                      .offset = 0,
+                      .layer_specific = 0,
+                  },
+              .addr = RawAddress::kEmpty,
+              .data = 0,
+              .p_data = static_cast<BT_HDR*>(osi_calloc(32 + sizeof(BT_HDR))),
+              .rx_timestamp_us =
+                  bluetooth::common::time_get_os_boottime_us() - 1000,
+          },
+  };
+  data.hid_cback.p_data->len = static_cast<uint16_t>(data32.size());
+
+  bta_hh_data_act(&cb, &data);
+  ASSERT_EQ(1, get_func_call_count("bta_hh_co_data"));
+  ASSERT_EQ(1u, cb.rpt_latency.count);
+  ASSERT_GE(cb.rpt_latency.max_us, 1000u);
+  ASSERT_EQ(cb.rpt_latency.total_us, cb.rpt_latency.max_us);
+
+  uint64_t reports = 0;
+  for (int i = 0; i < BTA_HH_RPT_LATENCY_BUCKETS; i++) {
+    reports += cb.rpt_latency.buckets[i];
+  }
+  ASSERT_EQ(1u, reports);
+}
@@ -25,6 +25,10 @@ void gatt::SetMockBtaGattQueue(MockBtaGattQueue* mock_bta_gatt_queue) {
 
 void BtaGattQueue::Clean(uint16_t conn_id) { gatt_queue->Clean(conn_id); }
 
+void BtaGattQueue::SetCoalescing(uint16_t conn_id, bool enable) {
+  gatt_queue->SetCoalescing(conn_id, enable);
+}
+
 void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                       GATT_READ_OP_CB cb, void* cb_data) {
   gatt_queue->ReadCharacteristic(conn_id, handle, cb, cb_data);
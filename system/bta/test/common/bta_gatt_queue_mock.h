@@ -26,6 +26,7 @@ namespace gatt {
 class MockBtaGattQueue {
  public:
   MOCK_METHOD((void), Clean, (uint16_t conn_id));
+  MOCK_METHOD((void), SetCoalescing, (uint16_t conn_id, bool enable));
   MOCK_METHOD((void), ReadCharacteristic,
               (uint16_t conn_id, uint16_t handle, GATT_READ_OP_CB cb,
                void* cb_data));
@@ -97,6 +97,96 @@ TEST(GattDatabaseTest, serialize_deserialize_binary_test) {
   EXPECT_EQ(serialized[5].value.characteristic_extended_properties, 0x0001);
 }
 
+/* This test makes sure that attributes are found by handle, in a built and in
+ * a copied database */
+TEST(GattDatabaseTest, find_by_handle_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0020, 0x002f, SERVICE_2_UUID, true);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddCharacteristic(0x0021, 0x0022, SERVICE_1_CHAR_1_UUID, 0x10);
+
+  Database built = builder.Build();
+  Database copy = built;
+  for (const Database* db : {&built, &copy}) {
+    const Service* service = db->FindService(0x0004);
+    ASSERT_NE(service, nullptr);
+    EXPECT_EQ(service->handle, 0x0001);
+    EXPECT_EQ(db->FindService(0x0010), nullptr);
+    EXPECT_EQ(db->FindService(0x002f)->handle, 0x0020);
+
+    const Characteristic* charac = db->FindCharacteristic(0x0004);
+    ASSERT_NE(charac, nullptr);
+    EXPECT_EQ(charac, &service->characteristics[0]);
+    EXPECT_EQ(db->FindCharacteristic(0x0022)->properties, 0x10);
+    EXPECT_EQ(db->FindCharacteristic(0x0005), nullptr);
+
+    const Descriptor* desc = db->FindDescriptor(0x0005);
+    ASSERT_NE(desc, nullptr);
+    EXPECT_EQ(desc->uuid, SERVICE_1_CHAR_1_DESC_1_UUID);
+    EXPECT_EQ(db->FindDescriptor(0x0004), nullptr);
+    EXPECT_EQ(db->FindOwningCharacteristic(0x0005), charac);
+    EXPECT_EQ(db->FindOwningCharacteristic(0x0006), nullptr);
+  }
+
+  built.Clear();
+  EXPECT_EQ(built.FindService(0x0004), nullptr);
+  EXPECT_NE(copy.FindService(0x0004), nullptr);
+}
+
+/* This test makes sure that attributes are found by handle when the handles
+ * are too sparse for the direct handle table */
+TEST(GattDatabaseTest, find_by_sparse_handle_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0xf000, 0xffff, SERVICE_2_UUID, true);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0xf001, 0xf002, SERVICE_1_CHAR_1_UUID, 0x10);
+  builder.AddDescriptor(0xf003, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  Database db = builder.Build();
+  EXPECT_EQ(db.FindCharacteristic(0x0004)->properties, 0x02);
+  EXPECT_EQ(db.FindCharacteristic(0xf002)->properties, 0x10);
+  EXPECT_EQ(db.FindCharacteristic(0x8000), nullptr);
+  EXPECT_EQ(db.FindDescriptor(0xf003)->handle, 0xf003);
+  EXPECT_EQ(db.FindOwningCharacteristic(0xf003)->value_handle, 0xf002);
+  EXPECT_EQ(db.FindService(0xfffe)->handle, 0xf000);
+}
+
+/* This test makes sure that the services rediscovered in a handle range
+ * replace the ones in this range, and only those */
+TEST(GattDatabaseTest, splice_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, true);
+  builder.AddService(0x0020, 0x002f, SERVICE_1_UUID, true);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0011, 0x0012, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0021, 0x0022, SERVICE_1_CHAR_1_UUID, 0x02);
+  Database db = builder.Build();
+
+  // The second service grew by a characteristic and a descriptor
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, true);
+  builder.AddCharacteristic(0x0011, 0x0012, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0013, 0x0014, SERVICE_1_CHAR_1_UUID, 0x10);
+  builder.AddDescriptor(0x0015, SERVICE_1_CHAR_1_DESC_1_UUID);
+  db.Splice(builder.Build(), 0x0010, 0x001f);
+
+  ASSERT_EQ(db.Services().size(), 3u);
+  EXPECT_EQ(db.FindService(0x0014)->characteristics.size(), 2u);
+  EXPECT_EQ(db.FindCharacteristic(0x0014)->properties, 0x10);
+  EXPECT_EQ(db.FindDescriptor(0x0015)->uuid, SERVICE_1_CHAR_1_DESC_1_UUID);
+  EXPECT_NE(db.FindCharacteristic(0x0004), nullptr);
+  EXPECT_NE(db.FindCharacteristic(0x0022), nullptr);
+
+  // The second service was removed
+  db.Splice(Database(), 0x0010, 0x001f);
+  ASSERT_EQ(db.Services().size(), 2u);
+  EXPECT_EQ(db.FindService(0x0014), nullptr);
+  EXPECT_EQ(db.Services().back().handle, 0x0020);
+}
+
 /* This test makes sure that Service represented in StoredAttribute have proper
  * binary format. */
 TEST(GattCacheTest, stored_attribute_to_binary_service_test) {
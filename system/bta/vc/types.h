@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <queue>
 #include <vector>
 
@@ -71,8 +73,13 @@ struct VolumeOperation {
   uint8_t opcode_;
   std::vector<uint8_t> arguments_;
 
+  /* Devices which did not complete the operation yet */
   std::vector<RawAddress> devices_;
+  /* Devices the operation was not written to yet, as they are still busy with
+   * an earlier operation */
+  std::vector<RawAddress> waiting_devices_;
   alarm_t* operation_timeout_;
+  std::chrono::steady_clock::time_point start_time_;
 
   VolumeOperation(int operation_id, int group_id, bool is_autonomous, uint8_t opcode,
                   std::vector<uint8_t> arguments,
@@ -82,7 +89,8 @@ struct VolumeOperation {
         is_autonomous_(is_autonomous),
         opcode_(opcode),
         arguments_(arguments),
-        devices_(devices) {
+        devices_(devices),
+        waiting_devices_(devices) {
     auto name = "operation_timeout_" + std::to_string(operation_id);
     operation_timeout_ = alarm_new(name.c_str());
     started_ = false;
@@ -101,7 +109,15 @@ struct VolumeOperation {
   }
 
   bool IsStarted(void) { return started_; };
-  void Start(void) { started_ = true; }
+  void Start(void) {
+    started_ = true;
+    start_time_ = std::chrono::steady_clock::now();
+  }
+
+  bool IsWaiting(const RawAddress& addr) const {
+    return std::find(waiting_devices_.begin(), waiting_devices_.end(), addr) !=
+           waiting_devices_.end();
+  }
 };
 
 struct VolumeOffset {
@@ -21,7 +21,10 @@
 #include <base/strings/string_util.h>
 #include <hardware/bt_vc.h>
 
+#include <chrono>
+#include <map>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -449,7 +452,8 @@ class VolumeControlImpl : public VolumeControl {
                       [addr](auto& operation) {
                         auto it = find(operation.devices_.begin(),
                                        operation.devices_.end(), addr);
-                        return it != operation.devices_.end();
+                        return it != operation.devices_.end() &&
+                               !operation.IsWaiting(addr);
                       });
     if (op == ongoing_operations_.end()) {
       DLOG(INFO) << __func__ << " Could not find operation id for device: "
@@ -468,10 +472,13 @@ class VolumeControlImpl : public VolumeControl {
     if (!op->devices_.empty()) {
       DLOG(INFO) << __func__ << " wait for more responses for operation_id: "
                  << op->operation_id_;
+      /* The device can already take the next operation queued for it */
+      StartQueueOperation();
       return;
     }
 
     if (op->IsGroupOperation()) {
+      UpdateGroupLatency(*op, false);
       callbacks_->OnGroupVolumeStateChanged(op->group_id_, device->volume,
                                             device->mute, op->is_autonomous_);
     } else {
@@ -624,6 +631,17 @@ class VolumeControlImpl : public VolumeControl {
   void Dump(int fd) {
     dprintf(fd, "APP ID: %d\n", gatt_if_);
     volume_control_devices_.DebugDump(fd);
+
+    std::stringstream stream;
+    for (auto const& [group_id, latency] : group_latencies_) {
+      stream << "  Group " << group_id
+             << " operations completed: " << latency.completed
+             << ", last: " << latency.last_ms << "ms, average: "
+             << (latency.completed ? latency.total_ms / latency.completed : 0)
+             << "ms, max: " << latency.max_ms
+             << "ms, timed out: " << latency.timeouts << "\n";
+    }
+    dprintf(fd, "%s", stream.str().c_str());
   }
 
   void Disconnect(const RawAddress& address) override {
@@ -688,8 +706,8 @@ class VolumeControlImpl : public VolumeControl {
       op->devices_.erase(it);
       if (op->devices_.empty()) {
         ongoing_operations_.erase(op);
-        StartQueueOperation();
       }
+      StartQueueOperation();
       return;
     }
   }
@@ -716,6 +734,11 @@ class VolumeControlImpl : public VolumeControl {
         if (it != op->devices_.end()) {
           op->devices_.erase(it);
         }
+        it = find(op->waiting_devices_.begin(), op->waiting_devices_.end(),
+                  addr);
+        if (it != op->waiting_devices_.end()) {
+          op->waiting_devices_.erase(it);
+        }
       }
       if (op->devices_.empty()) {
         op = ongoing_operations_.erase(op);
@@ -755,29 +778,85 @@ class VolumeControlImpl : public VolumeControl {
     instance->CancelVolumeOperation(PTR_TO_INT(data));
   }
 
+  /* Operations are written to each device in the order they were queued, as
+   * each write carries the change counter left by the previous one. A device
+   * is written the next operation as soon as it notified the result of the
+   * previous one, without waiting for the other devices of that operation, so
+   * that a slower member does not hold the rest of the group back.
+   */
   void StartQueueOperation(void) {
     LOG(INFO) << __func__;
-    if (ongoing_operations_.empty()) {
-      return;
+
+    struct PendingWrite {
+      int operation_id;
+      uint8_t opcode;
+      std::vector<uint8_t> arguments;
+      std::vector<RawAddress> devices;
     };
+    std::vector<PendingWrite> writes;
+
+    std::vector<RawAddress> busy_devices;
+    for (auto& op : ongoing_operations_) {
+      std::vector<RawAddress> ready_devices;
+      for (auto const& addr : op.waiting_devices_) {
+        if (find(busy_devices.begin(), busy_devices.end(), addr) ==
+            busy_devices.end()) {
+          ready_devices.push_back(addr);
+        }
+      }
+      busy_devices.insert(busy_devices.end(), op.devices_.begin(),
+                          op.devices_.end());
 
-    auto op = &ongoing_operations_.front();
+      if (ready_devices.empty()) {
+        if (!op.waiting_devices_.empty()) {
+          LOG(INFO) << __func__ << " operation " << op.operation_id_
+                    << " waits for earlier operations";
+        }
+        continue;
+      }
 
-    LOG(INFO) << __func__ << " operation_id: " << op->operation_id_;
+      LOG(INFO) << __func__ << " operation_id: " << op.operation_id_
+                << " devices: " << ready_devices.size();
 
-    if (op->IsStarted()) {
-      LOG(INFO) << __func__ << " wait until operation " << op->operation_id_
-                << " is complete";
-      return;
+      for (auto const& addr : ready_devices) {
+        op.waiting_devices_.erase(find(op.waiting_devices_.begin(),
+                                       op.waiting_devices_.end(), addr));
+      }
+
+      if (!op.IsStarted()) {
+        op.Start();
+        alarm_set_on_mloop(op.operation_timeout_, 3000, operation_callback,
+                           INT_TO_PTR(op.operation_id_));
+      }
+
+      writes.push_back({op.operation_id_, op.opcode_, op.arguments_,
+                        std::move(ready_devices)});
     }
 
-    op->Start();
+    /* Written once the queue is updated, as the write results can change it */
+    for (auto& write : writes) {
+      devices_control_point_helper(
+          write.devices, write.opcode,
+          write.arguments.size() == 0 ? nullptr : &(write.arguments),
+          write.operation_id);
+    }
+  }
 
-    alarm_set_on_mloop(op->operation_timeout_, 3000, operation_callback,
-                       INT_TO_PTR(op->operation_id_));
-    devices_control_point_helper(
-        op->devices_, op->opcode_,
-        op->arguments_.size() == 0 ? nullptr : &(op->arguments_));
+  void UpdateGroupLatency(const VolumeOperation& op, bool timed_out) {
+    auto& latency = group_latencies_[op.group_id_];
+    if (timed_out) {
+      latency.timeouts++;
+      return;
+    }
+
+    uint64_t latency_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - op.start_time_)
+            .count();
+    latency.completed++;
+    latency.last_ms = latency_ms;
+    latency.total_ms += latency_ms;
+    latency.max_ms = std::max(latency.max_ms, latency_ms);
   }
 
   void CancelVolumeOperation(int operation_id) {
@@ -793,6 +872,8 @@ class VolumeControlImpl : public VolumeControl {
       return;
     }
 
+    if (op->IsGroupOperation()) UpdateGroupLatency(*op, true);
+
     /* Possibly close GATT operations */
     ongoing_operations_.erase(op);
     StartQueueOperation();
@@ -1063,6 +1144,16 @@ class VolumeControlImpl : public VolumeControl {
   std::list<VolumeOperation> ongoing_operations_;
   int latest_operation_id_;
 
+  /* Time from the first write to the last notification of group operations */
+  struct GroupLatency {
+    uint64_t completed = 0;
+    uint64_t timeouts = 0;
+    uint64_t last_ms = 0;
+    uint64_t total_ms = 0;
+    uint64_t max_ms = 0;
+  };
+  std::map<int, GroupLatency> group_latencies_;
+
   void verify_device_ready(VolumeControlDevice* device, uint16_t handle) {
     if (device->IsReady()) return;
 
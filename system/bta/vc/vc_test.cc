@@ -1231,6 +1231,56 @@ TEST_F(VolumeControlCsis, test_set_volume) {
   GetNotificationEvent(conn_id_2, test_address_2, 0x0021, value2);
 }
 
+TEST_F(VolumeControlCsis, test_set_volume_slow_member) {
+  TestConnect(test_address_1);
+  GetConnectedEvent(test_address_1, conn_id_1);
+  GetSearchCompleteEvent(conn_id_1);
+  TestConnect(test_address_2);
+  GetConnectedEvent(test_address_2, conn_id_2);
+  GetSearchCompleteEvent(conn_id_2);
+
+  /* Record the volume written to each device */
+  std::vector<std::pair<uint16_t, uint8_t>> writes;
+  ON_CALL(gatt_queue, WriteCharacteristic(_, 0x0024, _, GATT_WRITE, _, _))
+      .WillByDefault([&writes](uint16_t conn_id, uint16_t handle,
+                               std::vector<uint8_t> value,
+                               tGATT_WRITE_TYPE write_type, GATT_WRITE_OP_CB cb,
+                               void* cb_data) {
+        writes.push_back({conn_id, value[2]});
+      });
+
+  VolumeControl::Get()->SetVolume(group_id, 10);
+  ASSERT_EQ(2u, writes.size());
+
+  std::vector<uint8_t> value({10, 0x00, 0x02});
+  GetNotificationEvent(conn_id_1, test_address_1, 0x0021, value);
+
+  /* The first device takes the next volume while the second one is busy */
+  VolumeControl::Get()->SetVolume(group_id, 20);
+  ASSERT_EQ(3u, writes.size());
+  ASSERT_EQ(std::make_pair(conn_id_1, (uint8_t)20), writes[2]);
+
+  /* Only the latest of the volumes queued behind is sent */
+  VolumeControl::Get()->SetVolume(group_id, 30);
+  VolumeControl::Get()->SetVolume(group_id, 40);
+  ASSERT_EQ(3u, writes.size());
+
+  EXPECT_CALL(*callbacks, OnGroupVolumeStateChanged(group_id, 10, false, false));
+  GetNotificationEvent(conn_id_2, test_address_2, 0x0021, value);
+  ASSERT_EQ(4u, writes.size());
+  ASSERT_EQ(std::make_pair(conn_id_2, (uint8_t)20), writes[3]);
+
+  std::vector<uint8_t> value2({20, 0x00, 0x03});
+  GetNotificationEvent(conn_id_1, test_address_1, 0x0021, value2);
+  ASSERT_EQ(5u, writes.size());
+  ASSERT_EQ(std::make_pair(conn_id_1, (uint8_t)40), writes[4]);
+
+  EXPECT_CALL(*callbacks, OnGroupVolumeStateChanged(group_id, 20, false, false));
+  GetNotificationEvent(conn_id_2, test_address_2, 0x0021, value2);
+  ASSERT_EQ(6u, writes.size());
+  ASSERT_EQ(std::make_pair(conn_id_2, (uint8_t)40), writes[5]);
+}
+
 TEST_F(VolumeControlCsis, test_set_volume_device_not_ready) {
   /* Make sure we did not get responds to the initial reads,
    * so that the device was not marked as ready yet.
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include "bt_target.h"
+#include "btif/include/btif_pan_internal.h"
+#include "osi/include/allocator.h"
+#include "osi/include/osi.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/pan_api.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// A tap device as seen by the PAN data path: a non blocking fd returning one
+// Ethernet frame per read, emulated with a sequenced packet socket. Each
+// iteration queues range(0) frames of range(1) bytes and drains them.
+class BM_PanTapRead : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds_);
+    fcntl(fds_[0], F_SETFL, fcntl(fds_[0], F_GETFL, 0) | O_NONBLOCK);
+    int size = 1 << 22;
+    setsockopt(fds_[1], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(fds_[0], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    frame_.resize(st.range(1));
+    for (size_t i = 0; i < frame_.size(); i++) frame_[i] = i;
+  }
+
+  void TearDown(State& st) override {
+    close(fds_[0]);
+    close(fds_[1]);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void QueueFrames(State& st) {
+    st.PauseTiming();
+    for (int i = 0; i < st.range(0); i++) {
+      ssize_t ret;
+      OSI_NO_INTR(ret = write(fds_[1], frame_.data(), frame_.size()));
+    }
+    st.ResumeTiming();
+  }
+
+  // Prepends a compressed BNEP header and the L2CAP header room, as
+  // BNEP_WriteBuf() does, then releases the buffer like L2CAP would.
+  static void Forward(BT_HDR* buffer) {
+    buffer->offset -= 3;
+    buffer->len += 3;
+    ::benchmark::DoNotOptimize((uint8_t*)(buffer + 1) + buffer->offset);
+    osi_free(buffer);
+  }
+
+  int fds_[2];
+  std::vector<uint8_t> frame_;
+};
+
+// The frames read into a staging buffer then copied into a buffer from the
+// heap, with a poll() to find out whether another frame is queued.
+BENCHMARK_DEFINE_F(BM_PanTapRead, staged)(State& state) {
+  static uint8_t staging[1600];
+  for (auto _ : state) {
+    QueueFrames(state);
+    for (;;) {
+      BT_HDR* buffer = (BT_HDR*)osi_malloc(PAN_BUF_SIZE);
+      buffer->offset = PAN_MINIMUM_OFFSET;
+      ssize_t ret;
+      OSI_NO_INTR(ret = read(fds_[0], staging, sizeof(staging)));
+      if (ret <= 0) {
+        osi_free(buffer);
+        break;
+      }
+      memcpy((uint8_t*)(buffer + 1) + buffer->offset, staging, ret);
+      buffer->len = ret;
+      Forward(buffer);
+
+      struct pollfd ufd = {.fd = fds_[0], .events = POLLIN, .revents = 0};
+      OSI_NO_INTR(ret = poll(&ufd, 1, 0));
+      if (ret <= 0) break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+
+BENCHMARK_REGISTER_F(BM_PanTapRead, staged)
+    ->Args({100, 64})
+    ->Args({100, 1500});
+
+// The frames read in place into pooled buffers until the read would block
+BENCHMARK_DEFINE_F(BM_PanTapRead, in_place)(State& state) {
+  for (auto _ : state) {
+    QueueFrames(state);
+    ssize_t ret;
+    BT_HDR* buffer;
+    while ((buffer = btpan_tap_read_frame(fds_[0], &ret)) != NULL) {
+      Forward(buffer);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+
+BENCHMARK_REGISTER_F(BM_PanTapRead, in_place)
+    ->Args({100, 64})
+    ->Args({100, 1500});
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
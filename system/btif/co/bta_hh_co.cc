@@ -33,11 +33,13 @@
 #include "bta_api.h"
 #include "bta_hh_api.h"
 #include "btif_hh.h"
+#include "btif_hh_report_batch.h"
 #include "btif_util.h"
 #include "device/include/controller.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "types/raw_address.h"
 
 const char* dev_path = "/dev/uhid";
@@ -51,6 +53,11 @@ static tBTA_HH_RPT_CACHE_ENTRY sReportCache[BTA_HH_NV_LOAD_MAX];
 #define BTA_HH_UHID_POLL_PERIOD_MS 50
 /* Max number of polling interrupt allowed */
 #define BTA_HH_UHID_INTERRUPT_COUNT_MAX 100
+/* Input reports with more queued behind them are written together */
+#define BTA_HH_UHID_BATCHING_PROPERTY "bluetooth.hid.uhid_batching.enabled"
+/* Batched reports superseded by a later position are dropped */
+#define BTA_HH_REPORT_COALESCING_PROPERTY \
+  "bluetooth.hid.report_coalescing.enabled"
 
 static const bthh_report_type_t map_rtype_uhid_hh[] = {
     BTHH_FEATURE_REPORT, BTHH_OUTPUT_REPORT, BTHH_INPUT_REPORT};
@@ -492,6 +499,12 @@ void bta_hh_co_close(btif_hh_device_t* p_dev) {
   p_dev->set_rpt_id_queue = nullptr;
 #endif  // ENABLE_UHID_SET_REPORT
 
+  if (p_dev->report_batch != nullptr) {
+    if (p_dev->fd >= 0) p_dev->report_batch->Flush(p_dev->fd);
+    delete p_dev->report_batch;
+    p_dev->report_batch = nullptr;
+  }
+
   /* Stop the polling thread */
   if (p_dev->hh_keep_polling) {
     p_dev->hh_keep_polling = 0;
@@ -514,13 +527,14 @@ void bta_hh_co_close(btif_hh_device_t* p_dev) {
  *                  mode        - Hid host Protocol Mode
  *                  sub_clas    - Device Subclass
  *                  app_id      - application id
+ *                  more_data   - more reports are queued behind this one
  *
  * Returns          void
  ******************************************************************************/
 void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len,
                     tBTA_HH_PROTO_MODE mode, uint8_t sub_class,
                     uint8_t ctry_code, UNUSED_ATTR const RawAddress& peer_addr,
-                    uint8_t app_id) {
+                    uint8_t app_id, bool more_data) {
   btif_hh_device_t* p_dev;
 
   APPL_TRACE_DEBUG(
@@ -547,7 +561,19 @@ void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len,
 
   // Send the HID data to the kernel.
   if ((p_dev->fd >= 0) && p_dev->ready_for_data) {
-    bta_hh_co_write(p_dev->fd, p_rpt, len);
+    if (p_dev->report_batch == nullptr) {
+      bta_hh_co_write(p_dev->fd, p_rpt, len);
+      return;
+    }
+    /* Only held back while the next report is already queued */
+    p_dev->report_batch->Add(p_rpt, len);
+    if (!more_data || p_dev->report_batch->IsFull()) {
+      int result = p_dev->report_batch->Flush(p_dev->fd);
+      if (result < 0) {
+        APPL_TRACE_WARNING("%s: Error: batched UHID write failed (%s)",
+                           __func__, strerror(-result));
+      }
+    }
   } else {
     APPL_TRACE_WARNING("%s: Error: fd = %d, ready %d, len = %d", __func__,
                        p_dev->fd, p_dev->ready_for_data, len);
@@ -622,6 +648,15 @@ void bta_hh_co_send_hid_info(btif_hh_device_t* p_dev, const char* dev_name,
     /* The HID report descriptor is corrupted. Close the driver. */
     close(p_dev->fd);
     p_dev->fd = -1;
+    return;
+  }
+
+  delete p_dev->report_batch;
+  p_dev->report_batch = nullptr;
+  if (osi_property_get_bool(BTA_HH_UHID_BATCHING_PROPERTY, false)) {
+    p_dev->report_batch = new BtifHhReportBatch(
+        p_dscp, dscp_len,
+        osi_property_get_bool(BTA_HH_REPORT_COALESCING_PROPERTY, false));
   }
 }
 
@@ -843,6 +878,57 @@ void bta_hh_le_co_reset_rpt_cache(const RawAddress& remote_bda,
 
   btif_config_remove(bdstr, "HidReport");
   btif_config_remove(bdstr, "HidReportVersion");
+  btif_config_remove(bdstr, "HidReportDbHash");
   BTIF_TRACE_DEBUG("%s() - Reset cache for bda %s", __func__,
                    ADDRESS_TO_LOGGABLE_CSTR(remote_bda));
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_co_save_db_hash
+ *
+ * Description      This callout function is to save the hash of the GATT
+ *                  database the cached HOGP reports were discovered in.
+ *
+ * Parameters       remote_bda  - remote device address
+ *                  hash        - GATT database hash
+ *                  app_id      - application id
+ *
+ * Returns          none
+ *
+ ******************************************************************************/
+void bta_hh_le_co_save_db_hash(const RawAddress& remote_bda,
+                               const Octet16& hash,
+                               UNUSED_ATTR uint8_t app_id) {
+  std::string addrstr = remote_bda.ToString();
+  const char* bdstr = addrstr.c_str();
+
+  btif_config_set_bin(bdstr, "HidReportDbHash", hash.data(), hash.size());
+  BTIF_TRACE_DEBUG("%s() - Saving database hash; dev=%s", __func__,
+                   ADDRESS_TO_LOGGABLE_CSTR(remote_bda));
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_co_load_db_hash
+ *
+ * Description      This callout function is to load the hash of the GATT
+ *                  database the cached HOGP reports were discovered in.
+ *
+ * Parameters       remote_bda  - remote device address
+ *                  p_hash      - set to the GATT database hash
+ *                  app_id      - application id
+ *
+ * Returns          true if a hash was saved with the cache
+ *
+ ******************************************************************************/
+bool bta_hh_le_co_load_db_hash(const RawAddress& remote_bda, Octet16* p_hash,
+                               UNUSED_ATTR uint8_t app_id) {
+  std::string addrstr = remote_bda.ToString();
+  const char* bdstr = addrstr.c_str();
+
+  size_t len = p_hash->size();
+  if (btif_config_get_bin_length(bdstr, "HidReportDbHash") != len) return false;
+
+  return btif_config_get_bin(bdstr, "HidReportDbHash", p_hash->data(), &len);
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef BTIF_A2DP_SINK_JITTER_BUFFER_H
+#define BTIF_A2DP_SINK_JITTER_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+
+//
+// Playout control of the A2DP Sink receive queue.
+//
+// The encoded media packets stay in the A2DP Sink receive queue; this class
+// only decides when decoding starts and how many packets are decoded on each
+// decode tick.
+//
+// The arrival jitter is estimated from the packet inter-arrival times as in
+// RFC 3550, and the target depth of the queue is the number of packets needed
+// to cover four times that jitter. Every underrun deepens the target by one
+// packet for the rest of the stream.
+//
+// On each tick the packets are decoded at the pace the audio track plays them,
+// that is the time elapsed since the previous tick over the mean packet
+// interval, plus one more when the queue is above its target depth so that
+// the latency goes back down once the link is stable again.
+//
+class A2dpSinkJitterBuffer {
+ public:
+  // |min_depth| and |max_depth| bound the target depth, which is
+  // |initial_depth| until the jitter of the stream is known.
+  A2dpSinkJitterBuffer(size_t min_depth, size_t max_depth,
+                       size_t initial_depth);
+
+  // Restarts the estimation, for a new stream.
+  void Reset();
+
+  // Records the arrival of a packet at |timestamp_us|.
+  void OnPacketArrival(uint64_t timestamp_us);
+
+  // Returns true when decoding can start with |queue_length| packets queued.
+  bool IsReadyToPlay(size_t queue_length) const;
+
+  // Returns the number of packets to decode at the tick at |timestamp_us|
+  // with |queue_length| packets queued.
+  size_t OnDecodeTick(uint64_t timestamp_us, size_t queue_length);
+
+  size_t GetTargetDepth() const;
+  uint64_t GetJitterUs() const { return jitter_us_; }
+  uint64_t GetMeanIntervalUs() const { return mean_interval_us_; }
+  size_t GetUnderrunCount() const { return underrun_count_; }
+
+ private:
+  // Estimations are smoothed over 16 packets, as for the RFC 3550 jitter
+  static constexpr int kSmoothingShift = 4;
+  // The jitter of the stream is considered known after this many intervals
+  static constexpr size_t kMinIntervalSamples = 8;
+  // Longer gaps are stream pauses, not jitter
+  static constexpr uint64_t kMaxIntervalUs = 500000;
+
+  const size_t min_depth_;
+  const size_t max_depth_;
+  const size_t initial_depth_;
+
+  uint64_t last_arrival_us_;
+  uint64_t mean_interval_us_;
+  uint64_t jitter_us_;
+  size_t interval_samples_;
+
+  // Filling up the queue to the target depth before decoding
+  bool buffering_;
+  uint64_t last_tick_us_;
+  // Play time not yet covered by decoded packets
+  uint64_t pending_play_us_;
+  size_t extra_depth_;
+  size_t underrun_count_;
+};
+
+#endif /* BTIF_A2DP_SINK_JITTER_BUFFER_H */
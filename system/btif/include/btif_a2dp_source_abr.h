@@ -0,0 +1,103 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef BTIF_A2DP_SOURCE_ABR_H
+#define BTIF_A2DP_SOURCE_ABR_H
+
+#include <cstddef>
+#include <cstdint>
+
+//
+// Adaptive bit rate control of the A2DP Source encoders.
+//
+// The controller picks the bit rate of the encoder, as a percentage of the
+// bit rate of the codec config, from the state of the link. The main input is
+// the length of the tx queue at each encoding round: the queue only builds up
+// when the link, L2CAP flow control included, cannot carry the encoded audio.
+// Overflows of the tx queue and link quality readings, the Failed Contact
+// Counter and the RSSI, complete it.
+//
+// The bit rate goes down by steps as long as the smoothed queue length stays
+// high, with some time between the steps for the queue to drain, and at once
+// by a larger step when the queue overflows. It goes back up by smaller steps
+// each time the queue has stayed short for a while, so that it does not
+// oscillate around the capacity of the link.
+//
+class A2dpSourceAbr {
+ public:
+  // The bit rate is kept between |min_percent| and 100 percent of the bit
+  // rate of the codec config.
+  explicit A2dpSourceAbr(uint8_t min_percent);
+
+  // Restarts at the full bit rate, for a new stream.
+  void Reset();
+
+  // Records the length of the tx queue at the encoding round at
+  // |timestamp_us|. Returns true if the bit rate changed.
+  bool OnTxQueueLength(uint64_t timestamp_us, size_t queue_length);
+
+  // Records that the tx queue overflowed at |timestamp_us|.
+  // Returns true if the bit rate changed.
+  bool OnTxQueueOverflow(uint64_t timestamp_us);
+
+  // Records the Failed Contact Counter of the link read at |timestamp_us|.
+  // Returns true if the bit rate changed.
+  bool OnFailedContactCounter(uint64_t timestamp_us,
+                              uint16_t failed_contact_counter);
+
+  // Records the RSSI of the link read at |timestamp_us|.
+  void OnRssi(uint64_t timestamp_us, int8_t rssi);
+
+  uint8_t GetBitratePercent() const { return bitrate_percent_; }
+  size_t GetDecreaseCount() const { return decrease_count_; }
+  size_t GetIncreaseCount() const { return increase_count_; }
+
+ private:
+  // The queue length is smoothed over 4 encoding rounds, in 1/16 of packet
+  static constexpr int kSmoothingShift = 2;
+  static constexpr int kFractionShift = 4;
+  // Smoothed queue lengths above this lower the bit rate
+  static constexpr size_t kHighQueueLength = 3;
+  // Smoothed queue lengths up to this let the bit rate go back up
+  static constexpr size_t kLowQueueLength = 1;
+  static constexpr uint8_t kDecreaseStep = 10;
+  static constexpr uint8_t kOverflowStep = 25;
+  static constexpr uint8_t kIncreaseStep = 5;
+  // Time for the queue to drain between two decreases
+  static constexpr uint64_t kDecreaseHoldUs = 300000;
+  // Time the queue has to stay short before each increase
+  static constexpr uint64_t kIncreaseHoldUs = 2000000;
+  // Below this RSSI (dBm) the link is fading, hold the increases
+  static constexpr int8_t kWeakRssi = -75;
+
+  bool Decrease(uint64_t timestamp_us, uint8_t step);
+
+  const uint8_t min_percent_;
+
+  uint8_t bitrate_percent_;
+  int64_t queue_length_x16_;
+  uint64_t last_decrease_us_;
+  bool short_queue_;
+  uint64_t short_queue_since_us_;
+  bool has_failed_contact_counter_;
+  uint16_t failed_contact_counter_;
+  size_t decrease_count_;
+  size_t increase_count_;
+};
+
+#endif /* BTIF_A2DP_SOURCE_ABR_H */
@@ -154,14 +154,15 @@ static constexpr const char* kpBtSchedulingTraceLastLogPath =
 static constexpr const char* kpPropertyChoppyThreshold =
     "persist.bluetooth.bqr.choppy_threshold";
 
-// File Descriptor of LMP/LL message trace log
-static int LmpLlMessageTraceLogFd = INVALID_FD;
-// File Descriptor of Bluetooth Multi-profile/Coex scheduling trace log
-static int BtSchedulingTraceLogFd = INVALID_FD;
-// Counter of LMP/LL message trace
-static uint16_t LmpLlMessageTraceCounter = 0;
-// Counter of Bluetooth Multi-profile/Coex scheduling trace
-static uint16_t BtSchedulingTraceCounter = 0;
+// The Log Dump related events are buffered by the BQR worker thread, and
+// written to the log file once the buffer has that many bytes, or that long
+// after the first event of the buffer.
+static constexpr size_t kLogDumpBufferSize = 16 * 1024;
+static constexpr uint64_t kLogDumpFlushDelayMs = 1000;
+// Nice value of the BQR worker thread, which must not compete with the stack.
+static constexpr int kBqrWorkerThreadNice = 10;
+// The maximum count of connections with link quality statistics.
+static constexpr size_t kBqrLinkQualityStatsMaxConnections = 16;
 // The version supports ISO packets start from v1.01(257)
 static constexpr uint16_t kBqrIsoVersion = 0x101;
 // The version supports vendor quality and trace log starting v1.02(258)
@@ -327,20 +328,14 @@ class BqrVseSubEvt {
   // @param length Total length of all parameters contained in the sub-event.
   // @param p_param_buf A pointer to the parameters contained in the sub-event.
   void ParseBqrLinkQualityEvt(uint8_t length, const uint8_t* p_param_buf);
-  // Write the LMP/LL message trace to the log file.
+  // Parse the Log Dump related BQR event, and append it to the buffer of the
+  // log file.
   //
-  // @param fd The File Descriptor of the log file.
+  // @param log_buffer The buffer of the log file.
   // @param length Total length of all parameters contained in the sub-event.
   // @param p_param_buf A pointer to the parameters contained in the sub-event.
-  void WriteLmpLlTraceLogFile(int fd, uint8_t length,
-                              const uint8_t* p_param_buf);
-  // Write the Bluetooth Multi-profile/Coex scheduling trace to the log file.
-  //
-  // @param fd The File Descriptor of the log file.
-  // @param length Total length of all parameters contained in the sub-event.
-  // @param p_param_buf A pointer to the parameters contained in the sub-event.
-  void WriteBtSchedulingTraceLogFile(int fd, uint8_t length,
-                                     const uint8_t* p_param_buf);
+  void WriteLogDumpEvt(std::string* log_buffer, uint8_t length,
+                       const uint8_t* p_param_buf);
   // Get a string representation of the Bluetooth Quality event.
   //
   // @return a string representation of the Bluetooth Quality event.
@@ -359,6 +354,42 @@ class BqrVseSubEvt {
   std::tm tm_timestamp_ = {};
 };
 
+// Aggregate of the Link Quality related BQR events of a connection
+class BqrLinkQualityStats {
+ public:
+  // Accumulate the counts of the event, which are counted since the previous
+  // event of the connection.
+  //
+  // @param event The Link Quality related BQR event.
+  // @param timestamp_ms The boot time of reception of the event.
+  void Add(const BqrLinkQualityEvent& event, uint64_t timestamp_ms);
+  // Get a string representation of the statistics.
+  //
+  // @return a string representation of the statistics.
+  std::string ToString() const;
+
+  RawAddress bdaddr = RawAddress::kEmpty;
+  uint16_t connection_handle = 0;
+  uint64_t first_report_ms = 0;
+  uint64_t last_report_ms = 0;
+  uint32_t report_count = 0;
+  // Count of the events by Quality Report ID
+  uint32_t approach_lsto_count = 0;
+  uint32_t a2dp_choppy_count = 0;
+  uint32_t sco_choppy_count = 0;
+  uint32_t le_audio_choppy_count = 0;
+  int8_t min_rssi = 0;
+  int8_t max_rssi = 0;
+  int64_t rssi_sum = 0;
+  uint64_t snr_sum = 0;
+  uint64_t retransmission_count = 0;
+  uint64_t no_rx_count = 0;
+  uint64_t nak_count = 0;
+  uint64_t flow_off_count = 0;
+  uint64_t buffer_overflow_bytes = 0;
+  uint64_t buffer_underflow_bytes = 0;
+};
+
 BluetoothQualityReportInterface* getBluetoothQualityReportInterface();
 
 // Get a string representation of the Quality Report ID.
@@ -403,7 +434,8 @@ void BqrVscCompleteCallback(tBTM_VSC_CMPL* p_vsc_cmpl_params);
 //   the Bluetooth controller.
 void ConfigureBqrCmpl(uint32_t current_evt_mask);
 
-// Categorize the incoming Bluetooth Quality Report.
+// Categorize the incoming Bluetooth Quality Report. The report is copied, and
+// parsed on the BQR worker thread.
 //
 // @param length Lengths of the quality report sent from the Bluetooth
 //   controller.
@@ -419,17 +451,14 @@ void AddLinkQualityEventToQueue(uint8_t length,
                                 const uint8_t* p_link_quality_event);
 
 // Dump the LMP/LL message handshaking with the remote device to a log file.
+// The event is copied, and written by the BQR worker thread.
 //
 // @param length Lengths of the LMP/LL message trace event.
 // @param p_lmp_ll_message_event A pointer to the LMP/LL message trace event.
 void DumpLmpLlMessage(uint8_t length, const uint8_t* p_lmp_ll_message_event);
 
-// Open the LMP/LL message trace log file.
-//
-// @return a file descriptor of the LMP/LL message trace log file.
-int OpenLmpLlTraceLogFile();
-
 // Dump the Bluetooth Multi-profile/Coex scheduling information to a log file.
+// The event is copied, and written by the BQR worker thread.
 //
 // @param length Lengths of the Bluetooth Multi-profile/Coex scheduling trace
 //   event.
@@ -437,12 +466,6 @@ int OpenLmpLlTraceLogFile();
 //   scheduling trace event.
 void DumpBtScheduling(uint8_t length, const uint8_t* p_bt_scheduling_event);
 
-// Open the Bluetooth Multi-profile/Coex scheduling trace log file.
-//
-// @return a file descriptor of the Bluetooth Multi-profile/Coex scheduling
-//   trace log file.
-int OpenBtSchedulingTraceLogFile();
-
 // Dump Bluetooth Quality Report information.
 //
 // @param fd The file descriptor to use for dumping information.
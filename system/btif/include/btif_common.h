@@ -26,6 +26,7 @@
 #include <stdlib.h>
 
 #include <functional>
+#include <memory>
 
 #include "abstract_message_loop.h"
 #include "bta/include/bta_api.h"
@@ -155,6 +156,13 @@ typedef struct {
 bt_status_t do_in_jni_thread(base::OnceClosure task);
 bt_status_t do_in_jni_thread(const base::Location& from_here,
                              base::OnceClosure task);
+/**
+ * Posts a task of bulk data, such as scan results, that can be dropped. These
+ * tasks wait in their own lane, and run one at a time in turn with the other
+ * tasks of the JNI thread, rather than delaying them. BT_STATUS_BUSY is
+ * returned when the task is dropped because the lane is full.
+ */
+bt_status_t do_in_jni_thread_bulk(base::OnceClosure task);
 bool is_on_jni_thread();
 btbase::AbstractMessageLoop* get_jni_message_loop();
 
@@ -198,6 +206,19 @@ bt_status_t btif_transfer_context(tBTIF_CBACK* p_cback, uint16_t event,
                                   char* p_params, int param_len,
                                   tBTIF_COPY_CBACK* p_copy_cback);
 
+/**
+ * Switches context to btif task for a frequent event: |p_params| is moved to
+ * |p_cback| rather than copied into the message.
+ */
+template <typename T>
+bt_status_t btif_transfer_context(
+    void (*p_cback)(uint16_t event, std::unique_ptr<T> p_params),
+    uint16_t event, std::unique_ptr<T> p_params) {
+  return do_in_jni_thread(base::BindOnce(p_cback, event, std::move(p_params)));
+}
+
+void btif_debug_jni_thread_dump(int fd);
+
 void btif_init_ok();
 
 void invoke_adapter_state_changed_cb(bt_state_t state);
@@ -23,6 +23,7 @@
 
 #include <list>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "osi/include/config.h"
@@ -58,6 +59,10 @@ bool btif_config_get_str(const std::string& section, const std::string& key,
                          char* value, int* size_bytes);
 bool btif_config_set_str(const std::string& section, const std::string& key,
                          const std::string& value);
+// Sets all the |values| of |section| in one storage mutation
+bool btif_config_set_strs(
+    const std::string& section,
+    const std::vector<std::pair<std::string, std::string>>& values);
 bool btif_config_get_bin(const std::string& section, const std::string& key,
                          uint8_t* value, size_t* length);
 bool btif_config_set_bin(const std::string& section, const std::string& key,
@@ -30,6 +30,8 @@
 #include "osi/include/fixed_queue.h"
 #include "types/raw_address.h"
 
+class BtifHhReportBatch;
+
 /*******************************************************************************
  *  Constants & Macros
  ******************************************************************************/
@@ -104,6 +106,7 @@ typedef struct {
   fixed_queue_t* set_rpt_id_queue;
 #endif // ENABLE_UHID_SET_REPORT
   bool local_vup;  // Indicated locally initiated VUP
+  BtifHhReportBatch* report_batch;  // Set when uhid writes are batched
 } btif_hh_device_t;
 
 /* Control block to maintain properties of devices */
@@ -0,0 +1,82 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef BTIF_HH_REPORT_BATCH_H
+#define BTIF_HH_REPORT_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+//
+// Input reports of a HID device on their way to uhid.
+//
+// While more reports of the device are queued right behind the one being
+// handled, the reports are kept here and written together: one UHID_INPUT2
+// event per iovec of a single writev(), each only as long as its report.
+//
+// With coalescing, a pending report is dropped when a later report with the
+// same ID supersedes it, that is when the two only differ in the absolute
+// position fields found in the report descriptor: X, Y, Z, rotations,
+// pressure and tilt. Relative fields, buttons, contact identifiers and
+// anything else must be equal, so that no motion or state change is lost.
+//
+class BtifHhReportBatch {
+ public:
+  // The most events written by one Flush()
+  static constexpr size_t kMaxPendingReports = 32;
+
+  // The fields that can be coalesced are taken from the report |descriptor|
+  // when |coalesce| is set.
+  BtifHhReportBatch(const uint8_t* descriptor, size_t descriptor_len,
+                    bool coalesce);
+
+  // Appends the input |report| of |len| bytes, starting with its report ID
+  // when the descriptor declares report IDs. Reports too long for an uhid
+  // event are dropped.
+  void Add(const uint8_t* report, uint16_t len);
+
+  // Writes the pending reports to the uhid |fd|. Returns 0 on success or a
+  // negative errno. The pending reports are dropped either way.
+  int Flush(int fd);
+
+  bool IsFull() const { return events_.size() >= kMaxPendingReports; }
+  size_t GetPendingCount() const { return events_.size(); }
+  uint64_t GetCoalescedCount() const { return coalesced_count_; }
+  uint64_t GetWriteCount() const { return write_count_; }
+  uint64_t GetReportCount() const { return report_count_; }
+
+ private:
+  void ParseDescriptor(const uint8_t* descriptor, size_t descriptor_len);
+  bool Supersedes(const std::vector<uint8_t>& event, const uint8_t* report,
+                  uint16_t len) const;
+
+  bool has_report_ids_;
+  // Per report ID, the bits of the report (without the ID) that can differ
+  // between two reports for the later one to supersede the earlier one
+  std::map<uint8_t, std::vector<uint8_t>> coalescable_bits_;
+  // Serialized UHID_INPUT2 events
+  std::vector<std::vector<uint8_t>> events_;
+
+  uint64_t coalesced_count_;
+  uint64_t write_count_;
+  uint64_t report_count_;
+};
+
+#endif /* BTIF_HH_REPORT_BATCH_H */
@@ -27,7 +27,10 @@
 #ifndef BTIF_PAN_INTERNAL_H
 #define BTIF_PAN_INTERNAL_H
 
+#include <sys/types.h>
+
 #include "btif_pan.h"
+#include "stack/include/bt_hdr.h"
 #include "types/raw_address.h"
 
 /*******************************************************************************
@@ -73,8 +76,6 @@ typedef struct {
   int open_count;
   int flow;  // 1: outbound data flow on; 0: outbound data flow off
   btpan_conn_t conns[MAX_PAN_CONNS];
-  int congest_packet_size;
-  unsigned char congest_packet[1600];  // max ethernet packet size
 } btpan_cb_t;
 
 /*******************************************************************************
@@ -92,6 +93,7 @@ int btpan_tap_open(void);
 void create_tap_read_thread(int tap_fd);
 void destroy_tap_read_thread(void);
 int btpan_tap_close(int tap_fd);
+BT_HDR* btpan_tap_read_frame(int fd, ssize_t* p_result);
 int btpan_tap_send(int tap_fd, const RawAddress& src, const RawAddress& dst,
                    uint16_t protocol, const char* buff, uint16_t size, bool ext,
                    bool forward);
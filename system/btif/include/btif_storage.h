@@ -144,6 +144,21 @@ bt_status_t btif_storage_set_remote_device_property(
  ******************************************************************************/
 uint8_t btif_storage_get_local_io_caps();
 
+/*******************************************************************************
+ *
+ * Function         btif_storage_set_remote_device_properties
+ *
+ * Description      BTIF storage API - Stores the properties of the remote
+ *                  device to NVRAM at once
+ *
+ * Returns          BT_STATUS_SUCCESS if all the properties were stored,
+ *                  BT_STATUS_FAIL otherwise
+ *
+ ******************************************************************************/
+bt_status_t btif_storage_set_remote_device_properties(
+    const RawAddress* remote_bd_addr, uint32_t num_properties,
+    bt_property_t* properties);
+
 /*******************************************************************************
  *
  * Function         btif_storage_add_remote_device
@@ -90,6 +90,9 @@
 #include "device/include/interop.h"
 #include "device/include/interop_config.h"
 #include "gd/common/init_flags.h"
+#include "gd/common/packet_latency_trace.h"
+#include "gd/common/startup_trace.h"
+#include "gd/os/logging/binary_log.h"
 #include "gd/os/parameter_provider.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
@@ -106,9 +109,13 @@
 #include "stack/include/avdt_api.h"
 #include "stack/include/btm_api.h"
 #include "stack/include/btu.h"
+#include "stack/include/gatt_api.h"
+#include "stack/include/hfp_lc3_decoder.h"
+#include "stack/include/hfp_lc3_encoder.h"
 #include "stack/include/hfp_msbc_decoder.h"
 #include "stack/include/hfp_msbc_encoder.h"
 #include "stack/include/hidh_api.h"
+#include "stack/include/l2c_api.h"
 #include "stack/include/pan_api.h"
 #include "stack_config.h"
 #include "types/raw_address.h"
@@ -231,6 +238,28 @@ struct MSBCCodec : bluetooth::core::CodecInterface {
   }
 };
 
+struct LC3Codec : bluetooth::core::CodecInterface {
+  LC3Codec() : bluetooth::core::CodecInterface(){};
+
+  void initialize() override {
+    hfp_lc3_decoder_init();
+    hfp_lc3_encoder_init();
+  }
+
+  void cleanup() override {
+    hfp_lc3_decoder_cleanup();
+    hfp_lc3_encoder_cleanup();
+  }
+
+  uint32_t encodePacket(int16_t* input, uint8_t* output) {
+    return hfp_lc3_encode_frames(input, output);
+  }
+
+  bool decodePacket(const uint8_t* i_buf, int16_t* o_buf, size_t out_len) {
+    return hfp_lc3_decoder_decode_packet(i_buf, o_buf, out_len);
+  }
+};
+
 struct CoreInterfaceImpl : bluetooth::core::CoreInterface {
   using bluetooth::core::CoreInterface::CoreInterface;
 
@@ -330,6 +359,7 @@ static bluetooth::core::CoreInterface* CreateInterfaceToProfiles() {
       .invoke_link_quality_report_cb = invoke_link_quality_report_cb};
   static auto configInterface = ConfigInterfaceImpl();
   static auto msbcCodecInterface = MSBCCodec();
+  static auto lc3CodecInterface = LC3Codec();
   static auto profileInterface = bluetooth::core::HACK_ProfileInterface{
       // HID
       .btif_hh_connect = btif_hh_connect,
@@ -351,7 +381,7 @@ static bluetooth::core::CoreInterface* CreateInterfaceToProfiles() {
 
   static auto interfaceForCore =
       CoreInterfaceImpl(&eventCallbacks, &configInterface, &msbcCodecInterface,
-                        &profileInterface);
+                        &lc3CodecInterface, &profileInterface);
   return &interfaceForCore;
 }
 
@@ -391,6 +421,12 @@ static int init(bt_callbacks_t* callbacks, bool start_restricted,
 
 #ifdef BLUEDROID_DEBUG
   allocation_tracker_init();
+#else
+  int32_t allocation_sample_rate =
+      bluetooth::common::init_flags::get_osi_allocation_sample_rate();
+  if (allocation_sample_rate > 0) {
+    allocation_tracker_init_sampling(allocation_sample_rate);
+  }
 #endif
 
   set_hal_cbacks(callbacks);
@@ -411,6 +447,8 @@ static int init(bt_callbacks_t* callbacks, bool start_restricted,
 
   is_local_device_atv = is_atv;
 
+  // The timeline covers init() and enable(), until the stack is up
+  bluetooth::common::StartupTrace::Start();
   stack_manager_get_interface()->init_stack(CreateInterfaceToProfiles());
   return BT_STATUS_SUCCESS;
 }
@@ -775,6 +813,7 @@ static void dump(int fd, const char** arguments) {
   bta_debug_av_dump(fd);
   stack_debug_avdtp_api_dump(fd);
   btif_sock_dump(fd);
+  btif_debug_jni_thread_dump(fd);
   bluetooth::avrcp::AvrcpService::DebugDump(fd);
   btif_debug_config_dump(fd);
   device_debug_iot_config_dump(fd);
@@ -793,10 +832,17 @@ static void dump(int fd, const char** arguments) {
   VolumeControl::DebugDump(fd);
 #endif
   connection_manager::dump(fd);
+  GATT_Dumpsys(fd);
   bluetooth::bqr::DebugDump(fd);
   PAN_Dumpsys(fd);
+  L2CA_Dumpsys(fd);
   DumpsysHid(fd);
+  DumpsysBtaHh(fd);
   DumpsysBtaDm(fd);
+  bluetooth::common::StartupTrace::Dump(fd);
+  bluetooth::common::PacketLatencyTrace::Dump(fd);
+  bluetooth::os::BinaryLogDump(fd);
+  get_main_thread()->DumpScheduling(fd);
   bluetooth::shim::Dump(fd, arguments);
 }
 
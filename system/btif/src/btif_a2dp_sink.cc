@@ -30,10 +30,12 @@
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "btif/include/btif_av.h"
+#include "btif/include/btif_a2dp_sink_jitter_buffer.h"
 #include "btif/include/btif_av_co.h"
 #include "btif/include/btif_avrcp_audio_track.h"
 #include "btif/include/btif_util.h"  // CASE_RETURN_STR
 #include "common/message_loop_thread.h"
+#include "common/time_util.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
@@ -56,6 +58,10 @@ using LockGuard = std::lock_guard<std::mutex>;
 /* In case of A2DP Sink, we will delay start by 5 AVDTP Packets */
 #define MAX_A2DP_DELAYED_START_FRAME_COUNT 5
 
+/* Bounds of the adaptive decode delay, in AVDTP Packets */
+#define MIN_A2DP_JITTER_BUFFER_DEPTH 2
+#define MAX_A2DP_JITTER_BUFFER_DEPTH (MAX_INPUT_A2DP_FRAME_QUEUE_SZ - 1)
+
 enum {
   BTIF_A2DP_SINK_STATE_OFF,
   BTIF_A2DP_SINK_STATE_STARTING_UP,
@@ -91,6 +97,9 @@ class BtifA2dpSinkControlBlock {
         rx_audio_queue(nullptr),
         rx_flush(false),
         decode_alarm(nullptr),
+        jitter_buffer(MIN_A2DP_JITTER_BUFFER_DEPTH,
+                      MAX_A2DP_JITTER_BUFFER_DEPTH,
+                      MAX_A2DP_DELAYED_START_FRAME_COUNT),
         sample_rate(0),
         channel_count(0),
         rx_focus_state(BTIF_A2DP_SINK_FOCUS_NOT_GRANTED),
@@ -107,6 +116,7 @@ class BtifA2dpSinkControlBlock {
     rx_audio_queue = nullptr;
     alarm_free(decode_alarm);
     decode_alarm = nullptr;
+    jitter_buffer.Reset();
     rx_flush = false;
     rx_focus_state = BTIF_A2DP_SINK_FOCUS_NOT_GRANTED;
     sample_rate = 0;
@@ -118,6 +128,7 @@ class BtifA2dpSinkControlBlock {
   fixed_queue_t* rx_audio_queue;
   bool rx_flush; /* discards any incoming data when true */
   alarm_t* decode_alarm;
+  A2dpSinkJitterBuffer jitter_buffer; /* paces the decoding of rx_audio_queue */
   tA2DP_SAMPLE_RATE sample_rate;
   tA2DP_BITS_PER_SAMPLE bits_per_sample;
   tA2DP_CHANNEL_COUNT channel_count;
@@ -195,7 +206,7 @@ bool btif_a2dp_sink_init() {
   btif_a2dp_sink_cb.rx_audio_queue = fixed_queue_new(SIZE_MAX);
 
   /* Schedule the rest of the operations */
-  if (!btif_a2dp_sink_cb.worker_thread.EnableRealTimeScheduling()) {
+  if (!btif_a2dp_sink_cb.worker_thread.ApplySchedulingPolicy(true)) {
 #if defined(__ANDROID__)
     LOG(FATAL) << __func__
                << ": Failed to increase A2DP decoder thread priority";
@@ -470,6 +481,7 @@ static void btif_a2dp_sink_audio_handle_stop_decoding() {
     btif_a2dp_sink_audio_rx_flush_req();
     old_alarm = btif_a2dp_sink_cb.decode_alarm;
     btif_a2dp_sink_cb.decode_alarm = nullptr;
+    btif_a2dp_sink_cb.jitter_buffer.Reset();
   }
 
   // Drop the lock here, btif_decode_alarm_cb may in the process of being called
@@ -564,8 +576,14 @@ static void btif_a2dp_sink_avk_handle_timer() {
     return;
   }
 
-  APPL_TRACE_DEBUG("%s: process frames begin", __func__);
-  while (true) {
+  /* Decode only what the audio track played since the last tick */
+  size_t frames_to_decode = btif_a2dp_sink_cb.jitter_buffer.OnDecodeTick(
+      bluetooth::common::time_get_os_boottime_us(),
+      fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue));
+
+  APPL_TRACE_DEBUG("%s: process frames begin, decoding %zu", __func__,
+                   frames_to_decode);
+  while (frames_to_decode-- > 0) {
     p_msg = (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue);
     if (p_msg == NULL) {
       break;
@@ -662,26 +680,28 @@ static void btif_a2dp_sink_decoder_update_event(
 
 uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   LockGuard lock(g_mutex);
-  if (btif_a2dp_sink_cb.rx_flush) /* Flush enabled, do not enqueue */
+  if (btif_a2dp_sink_cb.rx_flush) { /* Flush enabled, do not enqueue */
+    osi_free(p_pkt);
     return fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
+  }
 
   if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
       MAX_INPUT_A2DP_FRAME_QUEUE_SZ) {
     uint8_t ret = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
     osi_free(fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue));
+    osi_free(p_pkt);
     return ret;
   }
 
   BTIF_TRACE_VERBOSE("%s +", __func__);
-  /* Allocate and queue this buffer */
-  BT_HDR* p_msg =
-      reinterpret_cast<BT_HDR*>(osi_malloc(sizeof(*p_msg) + p_pkt->len));
-  memcpy(p_msg, p_pkt, sizeof(*p_msg));
-  p_msg->offset = 0;
-  memcpy(p_msg->data, p_pkt->data + p_pkt->offset, p_pkt->len);
-  fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_msg);
-  if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
-      MAX_A2DP_DELAYED_START_FRAME_COUNT) {
+  /* Queue the L2CAP buffer as is, the decoders read the media payload at its
+   * offset */
+  fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_pkt);
+  btif_a2dp_sink_cb.jitter_buffer.OnPacketArrival(
+      bluetooth::common::time_get_os_boottime_us());
+  if (btif_a2dp_sink_cb.decode_alarm == nullptr &&
+      btif_a2dp_sink_cb.jitter_buffer.IsReadyToPlay(
+          fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue))) {
     BTIF_TRACE_DEBUG("%s: Initiate decoding. Current focus state:%d", __func__,
                      btif_a2dp_sink_cb.rx_focus_state);
     if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_GRANTED) {
@@ -706,8 +726,24 @@ void btif_a2dp_sink_audio_rx_flush_req() {
       FROM_HERE, base::BindOnce(btif_a2dp_sink_command_ready, p_buf));
 }
 
-void btif_a2dp_sink_debug_dump(UNUSED_ATTR int fd) {
-  // Nothing to do
+void btif_a2dp_sink_debug_dump(int fd) {
+  LockGuard lock(g_mutex);
+  if (btif_a2dp_sink_state != BTIF_A2DP_SINK_STATE_RUNNING) return;
+
+  const A2dpSinkJitterBuffer& jitter_buffer = btif_a2dp_sink_cb.jitter_buffer;
+  dprintf(fd, "\nA2DP Sink State:\n");
+  dprintf(fd,
+          "  Queued packets: %zu (target: %zu)\n"
+          "  Packet interval: %llu us, jitter: %llu us\n"
+          "  Underruns: %zu\n",
+          btif_a2dp_sink_cb.rx_audio_queue == nullptr
+              ? 0
+              : fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue),
+          jitter_buffer.GetTargetDepth(),
+          (unsigned long long)jitter_buffer.GetMeanIntervalUs(),
+          (unsigned long long)jitter_buffer.GetJitterUs(),
+          jitter_buffer.GetUnderrunCount());
+  btif_a2dp_sink_cb.worker_thread.DumpScheduling(fd);
 }
 
 void btif_a2dp_sink_set_focus_state_req(btif_a2dp_sink_focus_state_t state) {
@@ -0,0 +1,117 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif/include/btif_a2dp_sink_jitter_buffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+A2dpSinkJitterBuffer::A2dpSinkJitterBuffer(size_t min_depth, size_t max_depth,
+                                           size_t initial_depth)
+    : min_depth_(min_depth),
+      max_depth_(max_depth),
+      initial_depth_(initial_depth) {
+  Reset();
+}
+
+void A2dpSinkJitterBuffer::Reset() {
+  last_arrival_us_ = 0;
+  mean_interval_us_ = 0;
+  jitter_us_ = 0;
+  interval_samples_ = 0;
+  buffering_ = true;
+  last_tick_us_ = 0;
+  pending_play_us_ = 0;
+  extra_depth_ = 0;
+  underrun_count_ = 0;
+}
+
+void A2dpSinkJitterBuffer::OnPacketArrival(uint64_t timestamp_us) {
+  uint64_t last_arrival_us = last_arrival_us_;
+  last_arrival_us_ = timestamp_us;
+  if (last_arrival_us == 0 || timestamp_us < last_arrival_us) return;
+
+  uint64_t interval_us = timestamp_us - last_arrival_us;
+  if (interval_us > kMaxIntervalUs) return;
+
+  if (interval_samples_ == 0) {
+    mean_interval_us_ = interval_us;
+  } else {
+    int64_t delta = static_cast<int64_t>(interval_us) -
+                    static_cast<int64_t>(mean_interval_us_);
+    mean_interval_us_ += delta / (1 << kSmoothingShift);
+  }
+
+  int64_t deviation = std::abs(static_cast<int64_t>(interval_us) -
+                               static_cast<int64_t>(mean_interval_us_));
+  jitter_us_ += (deviation - static_cast<int64_t>(jitter_us_)) /
+                (1 << kSmoothingShift);
+  interval_samples_++;
+}
+
+size_t A2dpSinkJitterBuffer::GetTargetDepth() const {
+  size_t depth = initial_depth_;
+  if (interval_samples_ >= kMinIntervalSamples && mean_interval_us_ != 0) {
+    depth = 1 + (4 * jitter_us_ + mean_interval_us_ - 1) / mean_interval_us_;
+  }
+  return std::min(std::max(depth, min_depth_) + extra_depth_, max_depth_);
+}
+
+bool A2dpSinkJitterBuffer::IsReadyToPlay(size_t queue_length) const {
+  return queue_length >= GetTargetDepth();
+}
+
+size_t A2dpSinkJitterBuffer::OnDecodeTick(uint64_t timestamp_us,
+                                          size_t queue_length) {
+  uint64_t last_tick_us = last_tick_us_;
+  last_tick_us_ = timestamp_us;
+
+  // Nothing to pace the decoding with yet
+  if (mean_interval_us_ == 0) return queue_length;
+
+  size_t target_depth = GetTargetDepth();
+  if (buffering_) {
+    if (queue_length < target_depth) return 0;
+
+    // Half of the target depth goes to the audio track right away, so that it
+    // does not run dry between two ticks.
+    buffering_ = false;
+    pending_play_us_ = 0;
+    return std::max<size_t>(1, queue_length - target_depth / 2);
+  }
+
+  if (timestamp_us > last_tick_us) {
+    pending_play_us_ += timestamp_us - last_tick_us;
+  }
+  // A late tick does not turn into a burst larger than the queue could hold
+  pending_play_us_ = std::min(pending_play_us_, max_depth_ * mean_interval_us_);
+
+  size_t due = pending_play_us_ / mean_interval_us_;
+  pending_play_us_ -= due * mean_interval_us_;
+
+  if (due > queue_length) {
+    underrun_count_++;
+    extra_depth_ = std::min(extra_depth_ + 1, max_depth_);
+    buffering_ = true;
+    pending_play_us_ = 0;
+    return queue_length;
+  }
+
+  if (queue_length - due > target_depth) due++;
+  return due;
+}
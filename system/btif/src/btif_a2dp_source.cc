@@ -30,11 +30,13 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <future>
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "audio_hal_interface/a2dp_encoding.h"
 #include "bta_av_ci.h"
+#include "btif/include/btif_a2dp_source_abr.h"
 #include "btif_a2dp.h"
 #include "btif_a2dp_control.h"
 #include "btif_a2dp_source.h"
@@ -50,6 +52,7 @@
 #include "osi/include/fixed_queue.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_api_types.h"
@@ -70,6 +73,29 @@ extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/**
+ * Capacity of the tx queue ring. The queue is flushed before its length
+ * exceeds the dynamic audio buffer size, which fits in a uint8_t, so the
+ * ring never fills up and enqueuing never blocks.
+ */
+#define A2DP_TX_AUDIO_QUEUE_CAPACITY 512
+
+/**
+ * When set, the media task also runs an encoding round as soon as the link
+ * drains the tx queue, instead of leaving the link idle until the next tick.
+ */
+#define A2DP_SOURCE_KICK_ON_DRAIN_PROPERTY \
+  "persist.bluetooth.a2dp_source.kick_on_drain"
+
+/**
+ * When set, the bit rate of the encoders that support it follows the capacity
+ * of the link, as seen from the tx queue and the link quality readings.
+ */
+#define A2DP_SOURCE_ABR_PROPERTY "persist.bluetooth.a2dp_source.abr"
+
+/* Lowest bit rate of the adaptive bit rate, in percent of the codec config */
+#define A2DP_SOURCE_ABR_MIN_PERCENT 50
+
 class SchedulingStats {
  public:
   SchedulingStats() { Reset(); }
@@ -140,6 +166,8 @@ class BtifMediaStats {
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    tx_queue_total_drain_kicks = 0;
+    tx_queue_last_drain_kick_us = 0;
     codec_index = -1;
   }
 
@@ -170,6 +198,9 @@ class BtifMediaStats {
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
 
+  size_t tx_queue_total_drain_kicks;
+  uint64_t tx_queue_last_drain_kick_us;
+
   int codec_index = -1;
 };
 
@@ -187,6 +218,11 @@ class BtifA2dpSource {
         tx_flush(false),
         encoder_interface(nullptr),
         encoder_interval_ms(0),
+        kick_on_drain(false),
+        kick_pending(false),
+        last_encode_us(0),
+        abr_enabled(false),
+        abr(A2DP_SOURCE_ABR_MIN_PERCENT),
         state_(kStateOff) {}
 
   void Reset() {
@@ -197,6 +233,11 @@ class BtifA2dpSource {
     wakelock_release();
     encoder_interface = nullptr;
     encoder_interval_ms = 0;
+    kick_on_drain = false;
+    kick_pending = false;
+    last_encode_us = 0;
+    abr_enabled = false;
+    abr.Reset();
     stats.Reset();
     accumulated_stats.Reset();
     state_ = kStateOff;
@@ -223,6 +264,11 @@ class BtifA2dpSource {
   RepeatingTimer media_alarm;
   const tA2DP_ENCODER_INTERFACE* encoder_interface;
   uint64_t encoder_interval_ms; /* Local copy of the encoder interval */
+  bool kick_on_drain;           /* Encode when the link drains the tx queue */
+  std::atomic_bool kick_pending;
+  std::atomic<uint64_t> last_encode_us; /* Boottime of the last encoding */
+  bool abr_enabled;                     /* Adapt the encoder bit rate */
+  A2dpSourceAbr abr;
   BtifMediaStats stats;
   BtifMediaStats accumulated_stats;
 
@@ -254,6 +300,7 @@ static void btif_a2dp_source_audio_tx_flush_event(void);
 static void btif_a2dp_source_setup_codec(const RawAddress& peer_addr);
 static void btif_a2dp_source_setup_codec_delayed(
     const RawAddress& peer_address);
+static bool btif_a2dp_source_reconfigure_codec();
 static void btif_a2dp_source_cleanup_codec();
 static void btif_a2dp_source_cleanup_codec_delayed();
 static void btif_a2dp_source_encoder_user_config_update_event(
@@ -264,7 +311,12 @@ static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config);
 static bool btif_a2dp_source_audio_tx_flush_req(void);
 static void btif_a2dp_source_audio_handle_timer(void);
+static void btif_a2dp_source_audio_handle_drain_kick(void);
+static void btif_a2dp_source_audio_encode(uint64_t timestamp_us,
+                                          uint64_t stats_timestamp_us);
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len);
+static bool btif_a2dp_source_peek_callback(const uint8_t** p_buf, uint32_t len);
+static void btif_a2dp_source_release_callback(uint32_t len);
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read);
 static void log_tstamps_us(const char* comment, uint64_t timestamp_us);
@@ -273,6 +325,11 @@ static void update_scheduling_stats(SchedulingStats* stats, uint64_t now_us,
 // Update the A2DP Source related metrics.
 // This function should be called before collecting the metrics.
 static void btif_a2dp_source_update_metrics(void);
+static void btif_a2dp_source_abr_update(bool changed);
+static void btif_a2dp_source_abr_rssi_event(uint64_t timestamp_us,
+                                            int8_t rssi);
+static void btif_a2dp_source_abr_failed_contact_counter_event(
+    uint64_t timestamp_us, uint16_t failed_contact_counter);
 static void btm_read_rssi_cb(void* data);
 static void btm_read_failed_contact_counter_cb(void* data);
 static void btm_read_tx_power_cb(void* data);
@@ -319,6 +376,8 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
   dst->media_read_total_underflow_count +=
       src->media_read_total_underflow_count;
   dst->media_read_last_underflow_us = src->media_read_last_underflow_us;
+  dst->tx_queue_total_drain_kicks += src->tx_queue_total_drain_kicks;
+  dst->tx_queue_last_drain_kick_us = src->tx_queue_last_drain_kick_us;
   if (dst->codec_index < 0) dst->codec_index = src->codec_index;
   btif_a2dp_source_accumulate_scheduling_stats(&src->tx_queue_enqueue_stats,
                                                &dst->tx_queue_enqueue_stats);
@@ -352,7 +411,8 @@ bool btif_a2dp_source_startup(void) {
 
   btif_a2dp_source_cb.Reset();
   btif_a2dp_source_cb.SetState(BtifA2dpSource::kStateStartingUp);
-  btif_a2dp_source_cb.tx_audio_queue = fixed_queue_new(SIZE_MAX);
+  btif_a2dp_source_cb.tx_audio_queue =
+      fixed_queue_new_ring(A2DP_TX_AUDIO_QUEUE_CAPACITY);
 
   // Schedule the rest of the operations
   btif_a2dp_source_thread.DoInThread(
@@ -363,7 +423,7 @@ bool btif_a2dp_source_startup(void) {
 
 static void btif_a2dp_source_startup_delayed() {
   LOG_INFO("%s: state=%s", __func__, btif_a2dp_source_cb.StateStr().c_str());
-  if (!btif_a2dp_source_thread.EnableRealTimeScheduling()) {
+  if (!btif_a2dp_source_thread.ApplySchedulingPolicy(true)) {
 #if defined(__ANDROID__)
     LOG(FATAL) << __func__ << ": unable to enable real time scheduling";
 #endif
@@ -597,6 +657,11 @@ static void btif_a2dp_source_setup_codec_delayed(
   btif_a2dp_source_cb.encoder_interface->encoder_init(
       &peer_params, a2dp_codec_config, btif_a2dp_source_read_callback,
       btif_a2dp_source_enqueue_callback);
+  if (btif_a2dp_source_cb.encoder_interface->set_span_callbacks != nullptr) {
+    static const tA2DP_SOURCE_SPAN_CALLBACKS span_callbacks = {
+        btif_a2dp_source_peek_callback, btif_a2dp_source_release_callback};
+    btif_a2dp_source_cb.encoder_interface->set_span_callbacks(&span_callbacks);
+  }
 
   // Save a local copy of the encoder_interval_ms
   btif_a2dp_source_cb.encoder_interval_ms =
@@ -607,6 +672,29 @@ static void btif_a2dp_source_setup_codec_delayed(
   }
 }
 
+// Applies the current codec config to the running encoder, without setting
+// it up again. Returns false when the encoder has to be set up again.
+static bool btif_a2dp_source_reconfigure_codec() {
+  const tA2DP_ENCODER_INTERFACE* encoder_interface =
+      btif_a2dp_source_cb.encoder_interface;
+  if (encoder_interface == nullptr ||
+      encoder_interface->encoder_reconfigure == nullptr ||
+      encoder_interface != bta_av_co_get_encoder_interface() ||
+      btif_av_is_a2dp_offload_running()) {
+    return false;
+  }
+
+  A2dpCodecConfig* a2dp_codec_config = bta_av_get_a2dp_current_codec();
+  if (a2dp_codec_config == nullptr ||
+      !encoder_interface->encoder_reconfigure(a2dp_codec_config)) {
+    return false;
+  }
+  LOG_INFO("%s: reconfigured %s encoder in place, state=%s", __func__,
+           a2dp_codec_config->name().c_str(),
+           btif_a2dp_source_cb.StateStr().c_str());
+  return true;
+}
+
 static void btif_a2dp_source_cleanup_codec() {
   LOG_INFO("%s: state=%s", __func__, btif_a2dp_source_cb.StateStr().c_str());
   // Must stop media task first before cleaning up the encoder
@@ -687,6 +775,12 @@ static void btif_a2dp_source_encoder_user_config_update_event(
     LOG(ERROR) << __func__ << ": cannot update codec user configuration(s)";
   }
   if (!peer_address.IsEmpty() && peer_address == btif_av_source_active_peer()) {
+    // The encoder runs on this thread, it takes new encoding parameters like
+    // the LDAC quality mode from its next frame, and the stream goes on.
+    if (success && btif_a2dp_source_reconfigure_codec()) {
+      peer_ready_promise.set_value();
+      return;
+    }
     // No more actions needed with remote, and if succeed, user had changed the
     // config like the bits per sample only. Let's resume the session now.
     btif_a2dp_source_start_session(peer_address, std::move(peer_ready_promise));
@@ -812,7 +906,18 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
   /* audio engine starting, reset tx suspended flag */
   btif_a2dp_source_cb.tx_flush = false;
 
-  wakelock_acquire();
+  btif_a2dp_source_cb.kick_on_drain =
+      osi_property_get_bool(A2DP_SOURCE_KICK_ON_DRAIN_PROPERTY, false);
+  btif_a2dp_source_cb.kick_pending = false;
+  btif_a2dp_source_cb.last_encode_us = 0;
+
+  // The encoder starts at the bit rate of the codec config
+  btif_a2dp_source_cb.abr_enabled =
+      btif_a2dp_source_cb.encoder_interface->set_bitrate_percent != nullptr &&
+      osi_property_get_bool(A2DP_SOURCE_ABR_PROPERTY, true);
+  btif_a2dp_source_cb.abr.Reset();
+
+  wakelock_acquire_for("a2dp_source");
   btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
       btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
       base::Bind(&btif_a2dp_source_audio_handle_timer),
@@ -914,6 +1019,51 @@ static void btif_a2dp_source_audio_handle_timer(void) {
     LOG_ERROR("%s: ERROR Media task Scheduled after Suspend", __func__);
     return;
   }
+  btif_a2dp_source_audio_encode(timestamp_us, stats_timestamp_us);
+  update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
+                          stats_timestamp_us,
+                          btif_a2dp_source_cb.encoder_interval_ms * 1000);
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_a2dp_source_audio_handle_drain_kick
+ *
+ * Description      Runs an extra encoding round after the link drained the
+ *                  tx queue. The encoders size their output from the time
+ *                  elapsed since their previous round, so this only hands
+ *                  the link the audio that is already due, earlier.
+ *
+ ******************************************************************************/
+static void btif_a2dp_source_audio_handle_drain_kick(void) {
+  btif_a2dp_source_cb.kick_pending = false;
+  if (btif_av_is_a2dp_offload_running()) return;
+  if (!btif_a2dp_source_is_streaming()) return;
+
+#ifndef TARGET_FLOSS
+  uint64_t timestamp_us = bluetooth::common::time_get_os_boottime_us();
+  uint64_t stats_timestamp_us = timestamp_us;
+#else
+  uint64_t timestamp_us = bluetooth::common::time_get_os_monotonic_raw_us();
+  uint64_t stats_timestamp_us = bluetooth::common::time_get_os_boottime_us();
+#endif
+
+  log_tstamps_us("A2DP Source tx drain kick", timestamp_us);
+  btif_a2dp_source_cb.stats.tx_queue_total_drain_kicks++;
+  btif_a2dp_source_cb.stats.tx_queue_last_drain_kick_us = stats_timestamp_us;
+  btif_a2dp_source_audio_encode(timestamp_us, stats_timestamp_us);
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_a2dp_source_audio_encode
+ *
+ * Description      Encodes the audio due at |timestamp_us| into the tx queue
+ *                  and tells BTA AV there is data to send.
+ *
+ ******************************************************************************/
+static void btif_a2dp_source_audio_encode(uint64_t timestamp_us,
+                                          uint64_t stats_timestamp_us) {
   CHECK(btif_a2dp_source_cb.encoder_interface != nullptr);
   size_t transmit_queue_length =
       fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
@@ -925,11 +1075,32 @@ static void btif_a2dp_source_audio_handle_timer(void) {
     btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
         transmit_queue_length);
   }
+  btif_a2dp_source_abr_update(btif_a2dp_source_cb.abr.OnTxQueueLength(
+      stats_timestamp_us, transmit_queue_length));
   btif_a2dp_source_cb.encoder_interface->send_frames(timestamp_us);
+  btif_a2dp_source_cb.last_encode_us = stats_timestamp_us;
   bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
-  update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
-                          stats_timestamp_us,
-                          btif_a2dp_source_cb.encoder_interval_ms * 1000);
+}
+
+// Applies the bit rate of the adaptive bit rate to the encoder if it |changed|.
+static void btif_a2dp_source_abr_update(bool changed) {
+  if (!changed || !btif_a2dp_source_cb.abr_enabled) return;
+  uint8_t percent = btif_a2dp_source_cb.abr.GetBitratePercent();
+  LOG_INFO("%s: encoder bit rate %u%%", __func__, percent);
+  btif_a2dp_source_cb.encoder_interface->set_bitrate_percent(percent);
+}
+
+static void btif_a2dp_source_abr_rssi_event(uint64_t timestamp_us,
+                                            int8_t rssi) {
+  if (!btif_a2dp_source_is_streaming()) return;
+  btif_a2dp_source_cb.abr.OnRssi(timestamp_us, rssi);
+}
+
+static void btif_a2dp_source_abr_failed_contact_counter_event(
+    uint64_t timestamp_us, uint16_t failed_contact_counter) {
+  if (!btif_a2dp_source_is_streaming()) return;
+  btif_a2dp_source_abr_update(btif_a2dp_source_cb.abr.OnFailedContactCounter(
+      timestamp_us, failed_contact_counter));
 }
 
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
@@ -957,6 +1128,23 @@ static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
   return bytes_read;
 }
 
+static bool btif_a2dp_source_peek_callback(const uint8_t** p_buf,
+                                           uint32_t len) {
+  // Only the audio HAL data queue can be read in place. Unaligned spans are
+  // read with a copy, since the encoders access the samples as 16 or 32 bit
+  // words.
+  if (!bluetooth::audio::a2dp::is_hal_enabled()) return false;
+  const uint8_t* span = nullptr;
+  if (!bluetooth::audio::a2dp::peek(&span, len)) return false;
+  if (reinterpret_cast<uintptr_t>(span) % sizeof(uint32_t) != 0) return false;
+  *p_buf = span;
+  return true;
+}
+
+static void btif_a2dp_source_release_callback(uint32_t len) {
+  bluetooth::audio::a2dp::release(len);
+}
+
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read) {
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
@@ -1012,6 +1200,8 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
     log_a2dp_audio_overrun_event(
         btif_av_source_active_peer(), btif_a2dp_source_cb.encoder_interval_ms,
         drop_n, num_dropped_encoded_frames, num_dropped_encoded_bytes);
+    btif_a2dp_source_abr_update(
+        btif_a2dp_source_cb.abr.OnTxQueueOverflow(now_us));
 
     // Intel controllers don't handle ReadRSSI, ReadFailedContactCounter, and
     // ReadTxPower very well, it sends back Hardware Error event which will
@@ -1094,6 +1284,19 @@ BT_HDR* btif_a2dp_source_audio_readbuf(void) {
                             btif_a2dp_source_cb.encoder_interval_ms * 1000);
   }
 
+  // The link has room and nothing left to send: encode what is due now rather
+  // than at the next tick, unless the last round was less than half a tick ago
+  // and the encoder would have next to nothing to produce.
+  if (btif_a2dp_source_cb.kick_on_drain &&
+      fixed_queue_is_empty(btif_a2dp_source_cb.tx_audio_queue) &&
+      btif_a2dp_source_is_streaming() &&
+      now_us >= btif_a2dp_source_cb.last_encode_us +
+                    btif_a2dp_source_cb.encoder_interval_ms * 1000 / 2 &&
+      !btif_a2dp_source_cb.kick_pending.exchange(true)) {
+    btif_a2dp_source_thread.DoInThread(
+        FROM_HERE, base::Bind(&btif_a2dp_source_audio_handle_drain_kick));
+  }
+
   return p_buf;
 }
 
@@ -1216,6 +1419,18 @@ void btif_a2dp_source_debug_dump(int fd) {
                 1000
           : 0);
 
+  dprintf(fd,
+          "  Counts (drain kicks)                                    : %zu\n",
+          accumulated_stats->tx_queue_total_drain_kicks);
+
+  dprintf(fd,
+          "  Encoder bit rate in %% (ABR, decreases/increases)        : %u / "
+          "%s / %zu / %zu\n",
+          btif_a2dp_source_cb.abr.GetBitratePercent(),
+          btif_a2dp_source_cb.abr_enabled ? "on" : "off",
+          btif_a2dp_source_cb.abr.GetDecreaseCount(),
+          btif_a2dp_source_cb.abr.GetIncreaseCount());
+
   dprintf(fd,
           "  Counts (underflow)                                      : %zu\n",
           accumulated_stats->media_read_total_underflow_count);
@@ -1308,6 +1523,8 @@ void btif_a2dp_source_debug_dump(int fd) {
       (unsigned long long)dequeue_stats->max_premature_scheduling_delta_us /
           1000,
       (unsigned long long)ave_time_us / 1000);
+
+  btif_a2dp_source_thread.DumpScheduling(fd);
 }
 
 static void btif_a2dp_source_update_metrics(void) {
@@ -1381,6 +1598,11 @@ static void btm_read_rssi_cb(void* data) {
 
   LOG_WARN("%s: device: %s, rssi: %d", __func__,
            ADDRESS_TO_LOGGABLE_CSTR(result->rem_bda), result->rssi);
+
+  btif_a2dp_source_thread.DoInThread(
+      FROM_HERE,
+      base::Bind(&btif_a2dp_source_abr_rssi_event,
+                 bluetooth::common::time_get_os_boottime_us(), result->rssi));
 }
 
 static void btm_read_failed_contact_counter_cb(void* data) {
@@ -1403,6 +1625,11 @@ static void btm_read_failed_contact_counter_cb(void* data) {
   LOG_WARN("%s: device: %s, Failed Contact Counter: %u", __func__,
            ADDRESS_TO_LOGGABLE_CSTR(result->rem_bda),
            result->failed_contact_counter);
+
+  btif_a2dp_source_thread.DoInThread(
+      FROM_HERE, base::Bind(&btif_a2dp_source_abr_failed_contact_counter_event,
+                            bluetooth::common::time_get_os_boottime_us(),
+                            result->failed_contact_counter));
 }
 
 static void btm_read_tx_power_cb(void* data) {
@@ -0,0 +1,101 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif/include/btif_a2dp_source_abr.h"
+
+#include <algorithm>
+
+A2dpSourceAbr::A2dpSourceAbr(uint8_t min_percent)
+    : min_percent_(std::min<uint8_t>(min_percent, 100)) {
+  Reset();
+}
+
+void A2dpSourceAbr::Reset() {
+  bitrate_percent_ = 100;
+  queue_length_x16_ = 0;
+  last_decrease_us_ = 0;
+  short_queue_ = false;
+  short_queue_since_us_ = 0;
+  has_failed_contact_counter_ = false;
+  failed_contact_counter_ = 0;
+  decrease_count_ = 0;
+  increase_count_ = 0;
+}
+
+bool A2dpSourceAbr::Decrease(uint64_t timestamp_us, uint8_t step) {
+  last_decrease_us_ = timestamp_us;
+  short_queue_ = false;
+  if (bitrate_percent_ <= min_percent_) return false;
+  bitrate_percent_ = std::max<int>(min_percent_, bitrate_percent_ - step);
+  decrease_count_++;
+  return true;
+}
+
+bool A2dpSourceAbr::OnTxQueueLength(uint64_t timestamp_us,
+                                    size_t queue_length) {
+  int64_t length_x16 = static_cast<int64_t>(queue_length) << kFractionShift;
+  queue_length_x16_ +=
+      (length_x16 - queue_length_x16_) / (1 << kSmoothingShift);
+
+  if (queue_length_x16_ > (int64_t)(kHighQueueLength << kFractionShift)) {
+    if (timestamp_us - last_decrease_us_ < kDecreaseHoldUs) return false;
+    return Decrease(timestamp_us, kDecreaseStep);
+  }
+
+  if (queue_length_x16_ > (int64_t)(kLowQueueLength << kFractionShift)) {
+    short_queue_ = false;
+    return false;
+  }
+  if (!short_queue_) {
+    short_queue_ = true;
+    short_queue_since_us_ = timestamp_us;
+    return false;
+  }
+  if (bitrate_percent_ >= 100 ||
+      timestamp_us - short_queue_since_us_ < kIncreaseHoldUs) {
+    return false;
+  }
+  bitrate_percent_ = std::min(100, bitrate_percent_ + kIncreaseStep);
+  short_queue_since_us_ = timestamp_us;
+  increase_count_++;
+  return true;
+}
+
+bool A2dpSourceAbr::OnTxQueueOverflow(uint64_t timestamp_us) {
+  // The queue was flushed, start the smoothing over from high
+  queue_length_x16_ = kHighQueueLength << kFractionShift;
+  return Decrease(timestamp_us, kOverflowStep);
+}
+
+bool A2dpSourceAbr::OnFailedContactCounter(uint64_t timestamp_us,
+                                           uint16_t failed_contact_counter) {
+  bool had_failed_contact_counter = has_failed_contact_counter_;
+  uint16_t previous_counter = failed_contact_counter_;
+  has_failed_contact_counter_ = true;
+  failed_contact_counter_ = failed_contact_counter;
+  // The counter wraps around, and is reset when the link flush timeout is set
+  if (!had_failed_contact_counter || failed_contact_counter <= previous_counter)
+    return false;
+  return Decrease(timestamp_us, kDecreaseStep);
+}
+
+void A2dpSourceAbr::OnRssi(uint64_t timestamp_us, int8_t rssi) {
+  if (rssi >= kWeakRssi) return;
+  // Count the short queue time from now on
+  if (short_queue_) short_queue_since_us_ = timestamp_us;
+}
@@ -730,6 +730,7 @@ static void btif_report_connection_state(const RawAddress& peer_address,
                                          btav_connection_state_t state,
                                          const bt_status_t status,
                                          uint8_t error_code);
+static void btif_av_queue_advance(const BtifAvPeer& peer);
 static void btif_report_audio_state(const RawAddress& peer_address,
                                     btav_audio_state_t state);
 static void btif_av_report_sink_audio_config_state(
@@ -1510,7 +1511,7 @@ bool BtifAvStateMachine::StateIdle::ProcessEvent(uint32_t event, void* p_data) {
             "peers",
             __PRETTY_FUNCTION__, ADDRESS_TO_LOGGABLE_CSTR(peer_.PeerAddress()));
         if (peer_.SelfInitiatedConnection()) {
-          btif_queue_advance();
+          btif_av_queue_advance(peer_);
         }
         break;
       }
@@ -1657,7 +1658,7 @@ bool BtifAvStateMachine::StateIdle::ProcessEvent(uint32_t event, void* p_data) {
         DEVICE_IOT_CONFIG_ADDR_INT_ADD_ONE(peer_.PeerAddress(),
                                            IOT_CONF_KEY_A2DP_CONN_FAIL_COUNT);
       }
-      btif_queue_advance();
+      btif_av_queue_advance(peer_);
     } break;
 
     case BTA_AV_REMOTE_CMD_EVT:
@@ -1746,7 +1747,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
                                    bt_status_t::BT_STATUS_FAIL, BTA_AV_FAIL);
       peer_.StateMachine().TransitionTo(BtifAvStateMachine::kStateIdle);
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_av_queue_advance(peer_);
       }
       break;
     case BTA_AV_REJECT_EVT:
@@ -1762,7 +1763,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
           bt_status_t::BT_STATUS_AUTH_REJECTED, BTA_AV_FAIL);
       peer_.StateMachine().TransitionTo(BtifAvStateMachine::kStateIdle);
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_av_queue_advance(peer_);
       }
       break;
 
@@ -1827,7 +1828,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
         BTA_AvOpenRc(peer_.BtaHandle());
       }
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_av_queue_advance(peer_);
       }
     } break;
 
@@ -1852,7 +1853,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
       log_counter_metrics_btif(
           android::bluetooth::CodePathCounterKeyEnum::A2DP_ALREADY_CONNECTING,
           1);
-      btif_queue_advance();
+      btif_av_queue_advance(peer_);
     } break;
 
     case BTA_AV_PENDING_EVT: {
@@ -1890,7 +1891,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
       DEVICE_IOT_CONFIG_ADDR_INT_ADD_ONE(peer_.PeerAddress(),
                                          IOT_CONF_KEY_A2DP_CONN_FAIL_COUNT);
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_av_queue_advance(peer_);
       }
       break;
 
@@ -1906,7 +1907,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
                                    A2DP_CONNECTION_DISCONNECTED,
                                1);
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_av_queue_advance(peer_);
       }
       break;
 
@@ -2139,7 +2140,7 @@ bool BtifAvStateMachine::StateOpened::ProcessEvent(uint32_t event,
                          __PRETTY_FUNCTION__,
                          ADDRESS_TO_LOGGABLE_CSTR(peer_.PeerAddress()),
                          BtifAvEvent::EventName(event).c_str());
-      btif_queue_advance();
+      btif_av_queue_advance(peer_);
     } break;
 
     case BTIF_AV_OFFLOAD_START_REQ_EVT:
@@ -2481,7 +2482,7 @@ bool BtifAvStateMachine::StateClosing::ProcessEvent(uint32_t event,
                          __PRETTY_FUNCTION__,
                          ADDRESS_TO_LOGGABLE_CSTR(peer_.PeerAddress()),
                          BtifAvEvent::EventName(event).c_str());
-      btif_queue_advance();
+      btif_av_queue_advance(peer_);
       peer_.StateMachine().TransitionTo(BtifAvStateMachine::kStateIdle);
       break;
 
@@ -2550,6 +2551,17 @@ static void btif_av_sink_initiate_av_open_timer_timeout(void* data) {
   }
 }
 
+/**
+ * Advance the profile connection queue past the connection to a peer.
+ *
+ * @param peer the peer
+ */
+static void btif_av_queue_advance(const BtifAvPeer& peer) {
+  uint16_t uuid = peer.IsSink() ? UUID_SERVCLASS_AUDIO_SOURCE
+                                : UUID_SERVCLASS_AUDIO_SINK;
+  btif_queue_advance_by_uuid(uuid, &peer.PeerAddress());
+}
+
 /**
  * Report the A2DP connection state
  *
@@ -2920,8 +2932,10 @@ static void bta_av_sink_media_callback(const RawAddress& peer_address,
             (state == BtifAvStateMachine::kStateOpened)) {
           uint8_t queue_len = btif_a2dp_sink_enqueue_buf((BT_HDR*)p_data);
           BTIF_TRACE_DEBUG("%s: Packets in Sink queue %d", __func__, queue_len);
+          break;
         }
       }
+      osi_free(p_data);
       break;
     }
     case BTA_AV_SINK_MEDIA_CFG_EVT: {
@@ -3002,7 +3016,7 @@ static bt_status_t connect_int(RawAddress* peer_address, uint16_t uuid) {
       peer = btif_av_sink.FindOrCreatePeer(*peer_address, kBtaHandleUnknown);
     }
     if (peer == nullptr) {
-      btif_queue_advance();
+      btif_queue_advance_by_uuid(uuid, peer_address);
       return;
     }
     peer->StateMachine().ProcessEvent(BTIF_AV_CONNECT_REQ_EVT, nullptr);
@@ -21,8 +21,14 @@
 #include <statslog_bt.h>
 #endif
 #include <stdio.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include "btif/include/stack_manager.h"
 #include "btif_bqr.h"
 #include "btif_common.h"
@@ -30,6 +36,7 @@
 #include "btm_api.h"
 #include "btm_ble_api.h"
 #include "common/leaky_bonded_queue.h"
+#include "common/message_loop_thread.h"
 #include "common/time_util.h"
 #include "core_callbacks.h"
 #include "osi/include/properties.h"
@@ -40,12 +47,50 @@ namespace bluetooth {
 namespace bqr {
 
 using bluetooth::common::LeakyBondedQueue;
+using bluetooth::common::MessageLoopThread;
 using std::chrono::system_clock;
 
+// Log file of the Log Dump related events, only used on the BQR worker
+// thread. The events are buffered, and the file is rotated to its last log
+// path once it has kLogDumpEventPerFile events.
+class BqrTraceLogFile {
+ public:
+  BqrTraceLogFile(const char* path, const char* last_path)
+      : path_(path), last_path_(last_path) {}
+
+  void Write(uint8_t length, const uint8_t* p_log_dump_event);
+  void Flush();
+  void Close();
+
+ private:
+  void Open();
+
+  const char* path_;
+  const char* last_path_;
+  int fd_ = INVALID_FD;
+  uint16_t event_count_ = 0;
+  std::string buffer_;
+  bool flush_scheduled_ = false;
+};
+
 // The instance of BQR event queue
 static std::unique_ptr<LeakyBondedQueue<BqrVseSubEvt>> kpBqrEventQueue(
     new LeakyBondedQueue<BqrVseSubEvt>(kBqrEventQueueSize));
 
+static BqrTraceLogFile lmp_ll_message_trace_log(
+    kpLmpLlMessageTraceLogPath, kpLmpLlMessageTraceLastLogPath);
+static BqrTraceLogFile bt_scheduling_trace_log(kpBtSchedulingTraceLogPath,
+                                               kpBtSchedulingTraceLastLogPath);
+
+// Link quality statistics, by connection handle
+static std::mutex link_quality_stats_mutex;
+static std::map<uint16_t, BqrLinkQualityStats> link_quality_stats;
+
+// Parses the BQR events and writes the log files, so that neither holds up
+// the processing of the HCI events. Declared after the log files, so that it
+// is shut down before they are destroyed.
+static MessageLoopThread bqr_worker_thread("bt_bqr_worker_thread");
+
 static uint16_t vendor_cap_supported_version;
 
 class BluetoothQualityReportInterfaceImpl;
@@ -114,8 +159,8 @@ void BqrVseSubEvt::ParseBqrLinkQualityEvt(uint8_t length,
   localtime_r(&now, &tm_timestamp_);
 }
 
-void BqrVseSubEvt::WriteLmpLlTraceLogFile(int fd, uint8_t length,
-                                          const uint8_t* p_param_buf) {
+void BqrVseSubEvt::WriteLogDumpEvt(std::string* log_buffer, uint8_t length,
+                                   const uint8_t* p_param_buf) {
   const auto now = system_clock::to_time_t(system_clock::now());
   localtime_r(&now, &tm_timestamp_);
 
@@ -130,32 +175,10 @@ void BqrVseSubEvt::WriteLmpLlTraceLogFile(int fd, uint8_t length,
          << "Handle: " << loghex(bqr_log_dump_event_.connection_handle)
          << " VSP: ";
 
-  TEMP_FAILURE_RETRY(write(fd, ss_log.str().c_str(), ss_log.str().size()));
-  TEMP_FAILURE_RETRY(
-      write(fd, bqr_log_dump_event_.vendor_specific_parameter, length));
-  LmpLlMessageTraceCounter++;
-}
-
-void BqrVseSubEvt::WriteBtSchedulingTraceLogFile(int fd, uint8_t length,
-                                                 const uint8_t* p_param_buf) {
-  const auto now = system_clock::to_time_t(system_clock::now());
-  localtime_r(&now, &tm_timestamp_);
-
-  STREAM_TO_UINT8(bqr_log_dump_event_.quality_report_id, p_param_buf);
-  STREAM_TO_UINT16(bqr_log_dump_event_.connection_handle, p_param_buf);
-  length -= kLogDumpParamTotalLen;
-  bqr_log_dump_event_.vendor_specific_parameter = p_param_buf;
-
-  std::stringstream ss_log;
-  ss_log << "\n"
-         << std::put_time(&tm_timestamp_, "%m-%d %H:%M:%S ")
-         << "Handle: " << loghex(bqr_log_dump_event_.connection_handle)
-         << " VSP: ";
-
-  TEMP_FAILURE_RETRY(write(fd, ss_log.str().c_str(), ss_log.str().size()));
-  TEMP_FAILURE_RETRY(
-      write(fd, bqr_log_dump_event_.vendor_specific_parameter, length));
-  BtSchedulingTraceCounter++;
+  log_buffer->append(ss_log.str());
+  log_buffer->append(reinterpret_cast<const char*>(
+                         bqr_log_dump_event_.vendor_specific_parameter),
+                     length);
 }
 
 std::string BqrVseSubEvt::ToString() const {
@@ -204,6 +227,67 @@ std::string BqrVseSubEvt::ToString() const {
   return ss.str();
 }
 
+void BqrLinkQualityStats::Add(const BqrLinkQualityEvent& event,
+                              uint64_t timestamp_ms) {
+  if (report_count == 0) {
+    first_report_ms = timestamp_ms;
+    min_rssi = event.rssi;
+    max_rssi = event.rssi;
+  }
+  last_report_ms = timestamp_ms;
+  report_count++;
+
+  switch (event.quality_report_id) {
+    case QUALITY_REPORT_ID_APPROACH_LSTO:
+      approach_lsto_count++;
+      break;
+    case QUALITY_REPORT_ID_A2DP_AUDIO_CHOPPY:
+      a2dp_choppy_count++;
+      break;
+    case QUALITY_REPORT_ID_SCO_VOICE_CHOPPY:
+      sco_choppy_count++;
+      break;
+    case QUALITY_REPORT_ID_LE_AUDIO_CHOPPY:
+      le_audio_choppy_count++;
+      break;
+    default:
+      break;
+  }
+
+  min_rssi = std::min(min_rssi, event.rssi);
+  max_rssi = std::max(max_rssi, event.rssi);
+  rssi_sum += event.rssi;
+  snr_sum += event.snr;
+  retransmission_count += event.retransmission_count;
+  no_rx_count += event.no_rx_count;
+  nak_count += event.nak_count;
+  flow_off_count += event.flow_off_count;
+  buffer_overflow_bytes += event.buffer_overflow_bytes;
+  buffer_underflow_bytes += event.buffer_underflow_bytes;
+}
+
+std::string BqrLinkQualityStats::ToString() const {
+  std::stringstream ss;
+  ss << ADDRESS_TO_LOGGABLE_STR(bdaddr)
+     << ", Handle: " << loghex(connection_handle)
+     << ", Reports: " << report_count << " in "
+     << (last_report_ms - first_report_ms) / 1000 << "s"
+     << ", LSTO/A2DP/SCO/LE Audio: " << approach_lsto_count << "/"
+     << a2dp_choppy_count << "/" << sco_choppy_count << "/"
+     << le_audio_choppy_count;
+  if (report_count > 0) {
+    ss << ", RSSI min/avg/max: " << std::to_string(min_rssi) << "/"
+       << rssi_sum / static_cast<int64_t>(report_count) << "/"
+       << std::to_string(max_rssi)
+       << ", Avg SNR: " << snr_sum / report_count;
+  }
+  ss << ", ReTx: " << retransmission_count << ", NoRX: " << no_rx_count
+     << ", NAK: " << nak_count << ", FlowOff: " << flow_off_count
+     << ", OverFlow: " << buffer_overflow_bytes
+     << ", UndFlow: " << buffer_underflow_bytes;
+  return ss.str();
+}
+
 std::string QualityReportIdToString(uint8_t quality_report_id) {
   switch (quality_report_id) {
     case QUALITY_REPORT_ID_MONITOR_MODE:
@@ -288,6 +372,36 @@ std::string PacketTypeToString(uint8_t packet_type) {
   }
 }
 
+// Runs the task on the BQR worker thread, or right away if it is not
+// running
+static void DoInBqrWorkerThread(base::OnceClosure task) {
+  if (!bqr_worker_thread.IsRunning()) {
+    std::move(task).Run();
+    return;
+  }
+  bqr_worker_thread.DoInThread(FROM_HERE, std::move(task));
+}
+
+// The worker thread is started when BQR is first enabled, and kept afterwards
+// so that the events received after BQR is disabled are still handled in
+// order
+static void StartBqrWorkerThread() {
+  if (bqr_worker_thread.IsRunning()) {
+    return;
+  }
+  bqr_worker_thread.StartUp();
+  if (!bqr_worker_thread.IsRunning()) {
+    LOG(ERROR) << __func__ << ": Unable to start the BQR worker thread";
+    return;
+  }
+  bqr_worker_thread.ApplySchedulingPolicy(false);
+  if (setpriority(PRIO_PROCESS, bqr_worker_thread.GetThreadId(),
+                  kBqrWorkerThreadNice) != 0) {
+    LOG(WARNING) << __func__ << ": Unable to lower the priority of "
+                 << bqr_worker_thread.GetName() << ": " << strerror(errno);
+  }
+}
+
 void EnableBtQualityReport(bool is_enable) {
   LOG(INFO) << __func__ << ": is_enable: " << logbool(is_enable);
 
@@ -310,6 +424,7 @@ void EnableBtQualityReport(bool is_enable) {
   BqrConfiguration bqr_config = {};
 
   if (is_enable) {
+    StartBqrWorkerThread();
     bqr_config.report_action = REPORT_ACTION_ADD;
     bqr_config.quality_event_mask =
         static_cast<uint32_t>(atoi(bqr_prop_evtmask));
@@ -476,26 +591,22 @@ void ConfigureBqrCmpl(uint32_t current_evt_mask) {
     return;
   }
 
-  if (LmpLlMessageTraceLogFd != INVALID_FD &&
-      (current_evt_mask & kQualityEventMaskLmpMessageTrace) == 0) {
-    LOG(INFO) << __func__ << ": Closing LMP/LL log file.";
-    close(LmpLlMessageTraceLogFd);
-    LmpLlMessageTraceLogFd = INVALID_FD;
+  // Closed once the events already posted to the worker thread are written
+  if ((current_evt_mask & kQualityEventMaskLmpMessageTrace) == 0) {
+    DoInBqrWorkerThread(
+        base::BindOnce(&BqrTraceLogFile::Close,
+                       base::Unretained(&lmp_ll_message_trace_log)));
   }
-  if (BtSchedulingTraceLogFd != INVALID_FD &&
-      (current_evt_mask & kQualityEventMaskBtSchedulingTrace) == 0) {
-    LOG(INFO) << __func__ << ": Closing Scheduling log file.";
-    close(BtSchedulingTraceLogFd);
-    BtSchedulingTraceLogFd = INVALID_FD;
+  if ((current_evt_mask & kQualityEventMaskBtSchedulingTrace) == 0) {
+    DoInBqrWorkerThread(
+        base::BindOnce(&BqrTraceLogFile::Close,
+                       base::Unretained(&bt_scheduling_trace_log)));
   }
 }
 
-void CategorizeBqrEvent(uint8_t length, const uint8_t* p_bqr_event) {
-  if (length == 0) {
-    LOG(WARNING) << __func__ << ": Lengths of all of the parameters are zero.";
-    return;
-  }
-
+static void ProcessBqrEvent(std::vector<uint8_t> bqr_event) {
+  uint8_t length = static_cast<uint8_t>(bqr_event.size());
+  const uint8_t* p_bqr_event = bqr_event.data();
   uint8_t quality_report_id = p_bqr_event[0];
   switch (quality_report_id) {
     case QUALITY_REPORT_ID_MONITOR_MODE:
@@ -533,12 +644,50 @@ void CategorizeBqrEvent(uint8_t length, const uint8_t* p_bqr_event) {
   }
 }
 
+void CategorizeBqrEvent(uint8_t length, const uint8_t* p_bqr_event) {
+  if (length == 0) {
+    LOG(WARNING) << __func__ << ": Lengths of all of the parameters are zero.";
+    return;
+  }
+
+  DoInBqrWorkerThread(base::BindOnce(
+      &ProcessBqrEvent,
+      std::vector<uint8_t>(p_bqr_event, p_bqr_event + length)));
+}
+
+static void AddLinkQualityStats(const BqrLinkQualityEvent& event) {
+  std::lock_guard<std::mutex> lock(link_quality_stats_mutex);
+  auto it = link_quality_stats.find(event.connection_handle);
+  if (it != link_quality_stats.end() && it->second.bdaddr != event.bdaddr) {
+    // The handle was reused by another connection
+    link_quality_stats.erase(it);
+    it = link_quality_stats.end();
+  }
+  if (it == link_quality_stats.end()) {
+    if (link_quality_stats.size() >= kBqrLinkQualityStatsMaxConnections) {
+      // Forget the connection reported the longest time ago
+      link_quality_stats.erase(std::min_element(
+          link_quality_stats.begin(), link_quality_stats.end(),
+          [](const auto& a, const auto& b) {
+            return a.second.last_report_ms < b.second.last_report_ms;
+          }));
+    }
+    it = link_quality_stats.emplace(event.connection_handle,
+                                    BqrLinkQualityStats{})
+             .first;
+    it->second.bdaddr = event.bdaddr;
+    it->second.connection_handle = event.connection_handle;
+  }
+  it->second.Add(event, bluetooth::common::time_get_os_boottime_ms());
+}
+
 void AddLinkQualityEventToQueue(uint8_t length,
                                 const uint8_t* p_link_quality_event) {
   std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
   RawAddress bd_addr;
 
   p_bqr_event->ParseBqrLinkQualityEvt(length, p_link_quality_event);
+  AddLinkQualityStats(p_bqr_event->bqr_link_quality_event_);
 
   LOG(WARNING) << *p_bqr_event;
   GetInterfaceToProfiles()->events->invoke_link_quality_report_cb(
@@ -603,77 +752,107 @@ void AddLinkQualityEventToQueue(uint8_t length,
   kpBqrEventQueue->Enqueue(p_bqr_event.release());
 }
 
-void DumpLmpLlMessage(uint8_t length, const uint8_t* p_lmp_ll_message_event) {
-  std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
-
-  if (LmpLlMessageTraceLogFd == INVALID_FD ||
-      LmpLlMessageTraceCounter >= kLogDumpEventPerFile) {
-    LmpLlMessageTraceLogFd = OpenLmpLlTraceLogFile();
+void BqrTraceLogFile::Write(uint8_t length, const uint8_t* p_log_dump_event) {
+  if (fd_ == INVALID_FD || event_count_ >= kLogDumpEventPerFile) {
+    Close();
+    Open();
   }
-  if (LmpLlMessageTraceLogFd != INVALID_FD) {
-    p_bqr_event->WriteLmpLlTraceLogFile(LmpLlMessageTraceLogFd, length,
-                                        p_lmp_ll_message_event);
+  if (fd_ == INVALID_FD) {
+    return;
   }
-}
 
-int OpenLmpLlTraceLogFile() {
-  if (rename(kpLmpLlMessageTraceLogPath, kpLmpLlMessageTraceLastLogPath) != 0 &&
-      errno != ENOENT) {
-    LOG(ERROR) << __func__ << ": Unable to rename '"
-               << kpLmpLlMessageTraceLogPath << "' to '"
-               << kpLmpLlMessageTraceLastLogPath << "' : " << strerror(errno);
+  BqrVseSubEvt bqr_event;
+  bqr_event.WriteLogDumpEvt(&buffer_, length, p_log_dump_event);
+  event_count_++;
+
+  if (buffer_.size() >= kLogDumpBufferSize) {
+    Flush();
+  } else if (!flush_scheduled_) {
+    flush_scheduled_ = bqr_worker_thread.DoInThreadDelayed(
+        FROM_HERE,
+        base::BindOnce(&BqrTraceLogFile::Flush, base::Unretained(this)),
+#if BASE_VER < 931007
+        base::TimeDelta::FromMilliseconds(kLogDumpFlushDelayMs));
+#else
+        base::Milliseconds(kLogDumpFlushDelayMs));
+#endif
+    if (!flush_scheduled_) {
+      Flush();
+    }
   }
+}
 
-  mode_t prevmask = umask(0);
-  int logfile_fd =
-      open(kpLmpLlMessageTraceLogPath, O_WRONLY | O_CREAT | O_TRUNC,
-           S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
-  umask(prevmask);
-  if (logfile_fd == INVALID_FD) {
-    LOG(ERROR) << __func__ << ": Unable to open '" << kpLmpLlMessageTraceLogPath
+void BqrTraceLogFile::Flush() {
+  flush_scheduled_ = false;
+  if (fd_ == INVALID_FD || buffer_.empty()) {
+    return;
+  }
+  if (TEMP_FAILURE_RETRY(write(fd_, buffer_.data(), buffer_.size())) < 0) {
+    LOG(ERROR) << __func__ << ": Unable to write '" << path_
                << "' : " << strerror(errno);
-  } else {
-    LmpLlMessageTraceCounter = 0;
   }
-  return logfile_fd;
+  buffer_.clear();
 }
 
-void DumpBtScheduling(uint8_t length, const uint8_t* p_bt_scheduling_event) {
-  std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
-
-  if (BtSchedulingTraceLogFd == INVALID_FD ||
-      BtSchedulingTraceCounter == kLogDumpEventPerFile) {
-    BtSchedulingTraceLogFd = OpenBtSchedulingTraceLogFile();
-  }
-  if (BtSchedulingTraceLogFd != INVALID_FD) {
-    p_bqr_event->WriteBtSchedulingTraceLogFile(BtSchedulingTraceLogFd, length,
-                                               p_bt_scheduling_event);
+void BqrTraceLogFile::Close() {
+  if (fd_ == INVALID_FD) {
+    return;
   }
+  LOG(INFO) << __func__ << ": Closing '" << path_ << "'";
+  Flush();
+  close(fd_);
+  fd_ = INVALID_FD;
 }
 
-int OpenBtSchedulingTraceLogFile() {
-  if (rename(kpBtSchedulingTraceLogPath, kpBtSchedulingTraceLastLogPath) != 0 &&
-      errno != ENOENT) {
-    LOG(ERROR) << __func__ << ": Unable to rename '"
-               << kpBtSchedulingTraceLogPath << "' to '"
-               << kpBtSchedulingTraceLastLogPath << "' : " << strerror(errno);
+void BqrTraceLogFile::Open() {
+  if (rename(path_, last_path_) != 0 && errno != ENOENT) {
+    LOG(ERROR) << __func__ << ": Unable to rename '" << path_ << "' to '"
+               << last_path_ << "' : " << strerror(errno);
   }
 
   mode_t prevmask = umask(0);
-  int logfile_fd =
-      open(kpBtSchedulingTraceLogPath, O_WRONLY | O_CREAT | O_TRUNC,
-           S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
+  fd_ = open(path_, O_WRONLY | O_CREAT | O_TRUNC,
+             S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
   umask(prevmask);
-  if (logfile_fd == INVALID_FD) {
-    LOG(ERROR) << __func__ << ": Unable to open '" << kpBtSchedulingTraceLogPath
+  if (fd_ == INVALID_FD) {
+    LOG(ERROR) << __func__ << ": Unable to open '" << path_
                << "' : " << strerror(errno);
-  } else {
-    BtSchedulingTraceCounter = 0;
+    return;
   }
-  return logfile_fd;
+  event_count_ = 0;
+  buffer_.reserve(kLogDumpBufferSize);
+}
+
+void DumpLmpLlMessage(uint8_t length, const uint8_t* p_lmp_ll_message_event) {
+  DoInBqrWorkerThread(base::BindOnce(
+      [](std::vector<uint8_t> event) {
+        lmp_ll_message_trace_log.Write(event.size(), event.data());
+      },
+      std::vector<uint8_t>(p_lmp_ll_message_event,
+                           p_lmp_ll_message_event + length)));
+}
+
+void DumpBtScheduling(uint8_t length, const uint8_t* p_bt_scheduling_event) {
+  DoInBqrWorkerThread(base::BindOnce(
+      [](std::vector<uint8_t> event) {
+        bt_scheduling_trace_log.Write(event.size(), event.data());
+      },
+      std::vector<uint8_t>(p_bt_scheduling_event,
+                           p_bt_scheduling_event + length)));
 }
 
 void DebugDump(int fd) {
+  dprintf(fd, "\nBT Quality Report Link Statistics: \n");
+  {
+    std::lock_guard<std::mutex> lock(link_quality_stats_mutex);
+    if (link_quality_stats.empty()) {
+      dprintf(fd, "No link quality event.\n");
+    }
+    for (const auto& it : link_quality_stats) {
+      dprintf(fd, "   %s\n", it.second.ToString().c_str());
+    }
+  }
+
   dprintf(fd, "\nBT Quality Report Events: \n");
 
   if (kpBqrEventQueue->Empty()) {
@@ -270,6 +270,13 @@ bool btif_config_set_str(const std::string& section, const std::string& key,
   return bluetooth::shim::BtifConfigInterface::SetStr(section, key, value);
 }
 
+bool btif_config_set_strs(
+    const std::string& section,
+    const std::vector<std::pair<std::string, std::string>>& values) {
+  CHECK(bluetooth::shim::is_gd_stack_started_up());
+  return bluetooth::shim::BtifConfigInterface::SetStrs(section, values);
+}
+
 bool btif_config_get_bin(const std::string& section, const std::string& key,
                          uint8_t* value, size_t* length) {
   CHECK(bluetooth::shim::is_gd_stack_started_up());
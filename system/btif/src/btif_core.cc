@@ -35,7 +35,13 @@
 #include <signal.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "btif/include/btif_av.h"
@@ -51,6 +57,7 @@
 #include "common/message_loop_thread.h"
 #include "device/include/controller.h"
 #include "device/include/device_iot_config.h"
+#include "gd/common/startup_trace.h"
 #include "osi/include/allocator.h"
 #include "osi/include/future.h"
 #include "osi/include/log.h"
@@ -94,6 +101,28 @@ static void bt_jni_msg_ready(void* context);
 
 static tBTA_SERVICE_MASK btif_enabled_services = 0;
 
+/* Events copied by btif_transfer_context, by callback and event */
+typedef struct {
+  uint64_t count;
+  uint64_t bytes;
+} tBTIF_TRANSFER_CONTEXT_STATS;
+
+static std::mutex transfer_context_stats_mutex;
+static std::map<std::pair<tBTIF_CBACK*, uint16_t>, tBTIF_TRANSFER_CONTEXT_STATS>
+    transfer_context_stats;
+
+/* Bulk lane of the JNI thread: its tasks are posted to the JNI thread one at a
+ * time, behind the tasks posted meanwhile */
+#define BTIF_JNI_BULK_MAX_BACKLOG 64
+#define BTIF_JNI_BULK_DROP_LOG_INTERVAL 100
+
+static std::mutex jni_bulk_mutex;
+static std::deque<base::OnceClosure> jni_bulk_queue;
+static bool jni_bulk_scheduled = false;
+static uint64_t jni_bulk_task_count = 0;
+static uint64_t jni_bulk_dropped_count = 0;
+static size_t jni_bulk_max_backlog = 0;
+
 static MessageLoopThread jni_thread("bt_jni_thread");
 static base::AtExitManager* exit_manager;
 static uid_set_t* uid_set;
@@ -132,6 +161,14 @@ bt_status_t btif_transfer_context(tBTIF_CBACK* p_cback, uint16_t event,
   BTIF_TRACE_VERBOSE("btif_transfer_context event %d, len %d", event,
                      param_len);
 
+  {
+    std::lock_guard<std::mutex> lock(transfer_context_stats_mutex);
+    tBTIF_TRANSFER_CONTEXT_STATS& stats =
+        transfer_context_stats[std::make_pair(p_cback, event)];
+    stats.count++;
+    stats.bytes += param_len;
+  }
+
   /* allocate and send message that will be executed in btif context */
   p_msg->hdr.event = BT_EVT_CONTEXT_SWITCH_EVT; /* internal event */
   p_msg->p_cb = p_cback;
@@ -148,6 +185,28 @@ bt_status_t btif_transfer_context(tBTIF_CBACK* p_cback, uint16_t event,
   return do_in_jni_thread(base::Bind(&bt_jni_msg_ready, p_msg));
 }
 
+void btif_debug_jni_thread_dump(int fd) {
+  {
+    std::lock_guard<std::mutex> lock(jni_bulk_mutex);
+    dprintf(fd, "\nJNI thread bulk lane:\n");
+    dprintf(fd,
+            "  tasks: %" PRIu64 " dropped: %" PRIu64
+            " backlog: %zu max backlog: %zu\n",
+            jni_bulk_task_count, jni_bulk_dropped_count,
+            jni_bulk_queue.size(), jni_bulk_max_backlog);
+  }
+
+  std::lock_guard<std::mutex> lock(transfer_context_stats_mutex);
+  dprintf(fd, "\nEvents copied to the btif context:\n");
+  for (const auto& entry : transfer_context_stats) {
+    dprintf(fd,
+            "  callback: %p event: %-3hu count: %-8" PRIu64 " bytes: %" PRIu64
+            "\n",
+            reinterpret_cast<void*>(entry.first.first), entry.first.second,
+            entry.second.count, entry.second.bytes);
+  }
+}
+
 /**
  * This function posts a task into the btif message loop, that executes it in
  * the JNI message loop.
@@ -165,6 +224,50 @@ bt_status_t do_in_jni_thread(base::OnceClosure task) {
   return do_in_jni_thread(FROM_HERE, std::move(task));
 }
 
+static void jni_bulk_run_next() {
+  base::OnceClosure task;
+  {
+    std::lock_guard<std::mutex> lock(jni_bulk_mutex);
+    if (jni_bulk_queue.empty()) {
+      jni_bulk_scheduled = false;
+      return;
+    }
+    task = std::move(jni_bulk_queue.front());
+    jni_bulk_queue.pop_front();
+
+    /* the next task runs after the ones posted until now */
+    if (jni_bulk_queue.empty() ||
+        do_in_jni_thread(base::BindOnce(&jni_bulk_run_next)) !=
+            BT_STATUS_SUCCESS) {
+      jni_bulk_scheduled = false;
+    }
+  }
+  std::move(task).Run();
+}
+
+bt_status_t do_in_jni_thread_bulk(base::OnceClosure task) {
+  std::lock_guard<std::mutex> lock(jni_bulk_mutex);
+  if (jni_bulk_queue.size() >= BTIF_JNI_BULK_MAX_BACKLOG) {
+    if (jni_bulk_dropped_count++ % BTIF_JNI_BULK_DROP_LOG_INTERVAL == 0) {
+      LOG_WARN("JNI thread bulk lane full, %" PRIu64 " tasks dropped",
+               jni_bulk_dropped_count);
+    }
+    return BT_STATUS_BUSY;
+  }
+
+  if (!jni_bulk_scheduled) {
+    if (do_in_jni_thread(base::BindOnce(&jni_bulk_run_next)) !=
+        BT_STATUS_SUCCESS) {
+      return BT_STATUS_FAIL;
+    }
+    jni_bulk_scheduled = true;
+  }
+  jni_bulk_queue.push_back(std::move(task));
+  jni_bulk_task_count++;
+  jni_bulk_max_backlog = std::max(jni_bulk_max_backlog, jni_bulk_queue.size());
+  return BT_STATUS_SUCCESS;
+}
+
 bool is_on_jni_thread() {
   return jni_thread.GetThreadId() == PlatformThread::CurrentId();
 }
@@ -245,6 +348,8 @@ bt_status_t btif_init_bluetooth() {
  ******************************************************************************/
 
 void btif_enable_bluetooth_evt() {
+  auto start_timestamp = std::chrono::steady_clock::now();
+
   /* Fetch the local BD ADDR */
   RawAddress local_bd_addr = *controller_get_interface()->get_address();
 
@@ -290,6 +395,10 @@ void btif_enable_bluetooth_evt() {
   btif_dm_load_local_oob();
 #endif
 
+  // Recorded before the stack start up is unblocked and ends the timeline
+  bluetooth::common::StartupTrace::Record("btif_enable_bluetooth_evt",
+                                          start_timestamp,
+                                          std::chrono::steady_clock::now());
   future_ready(stack_manager_get_hack_future(), FUTURE_SUCCESS);
   LOG_INFO("Bluetooth enable event completed");
 }
@@ -310,6 +419,11 @@ bt_status_t btif_cleanup_bluetooth() {
   GetInterfaceToProfiles()->events->invoke_thread_evt_cb(DISASSOCIATE_JVM);
   btif_queue_release();
   jni_thread.ShutDown();
+  {
+    std::lock_guard<std::mutex> lock(jni_bulk_mutex);
+    jni_bulk_queue.clear();
+    jni_bulk_scheduled = false;
+  }
   delete exit_manager;
   exit_manager = nullptr;
   LOG_INFO("%s finished", __func__);
@@ -73,6 +73,7 @@
 #include "btif_storage.h"
 #include "btif_util.h"
 #include "common/lru.h"
+#include "common/time_util.h"
 #include "common/metrics.h"
 #include "device/include/controller.h"
 #include "device/include/device_iot_config.h"
@@ -165,6 +166,11 @@ struct btif_dm_pairing_cb_t {
 
   ServiceDiscoveryState gatt_over_le;
   ServiceDiscoveryState sdp_over_classic;
+
+  // Time at which each discovery was scheduled, to log how long the device
+  // takes to become usable after bonding
+  uint64_t gatt_over_le_start_ms;
+  uint64_t sdp_over_classic_start_ms;
 };
 
 // TODO(jpawlowski): unify ?
@@ -669,10 +675,6 @@ static void btif_update_remote_properties(const RawAddress& bdaddr,
   if (strlen((const char*)bd_name)) {
     BTIF_STORAGE_FILL_PROPERTY(&properties[num_properties], BT_PROPERTY_BDNAME,
                                strlen((char*)bd_name), bd_name);
-    status = btif_storage_set_remote_device_property(
-        &bdaddr, &properties[num_properties]);
-    ASSERTC(status == BT_STATUS_SUCCESS, "failed to save remote device name",
-            status);
     num_properties++;
   }
 
@@ -696,11 +698,6 @@ static void btif_update_remote_properties(const RawAddress& bdaddr,
 
   BTIF_STORAGE_FILL_PROPERTY(&properties[num_properties],
                              BT_PROPERTY_CLASS_OF_DEVICE, sizeof(cod), &cod);
-
-  status = btif_storage_set_remote_device_property(&bdaddr,
-                                                   &properties[num_properties]);
-  ASSERTC(status == BT_STATUS_SUCCESS, "failed to save remote device class",
-          status);
   num_properties++;
 
   /* device type */
@@ -718,12 +715,14 @@ static void btif_update_remote_properties(const RawAddress& bdaddr,
   BTIF_STORAGE_FILL_PROPERTY(&properties[num_properties],
                              BT_PROPERTY_TYPE_OF_DEVICE, sizeof(dev_type),
                              &dev_type);
-  status = btif_storage_set_remote_device_property(&bdaddr,
-                                                   &properties[num_properties]);
-  ASSERTC(status == BT_STATUS_SUCCESS, "failed to save remote device type",
-          status);
   num_properties++;
 
+  /* Stored at once, as this runs for each advertising report with a name */
+  status = btif_storage_set_remote_device_properties(&bdaddr, num_properties,
+                                                     properties);
+  ASSERTC(status == BT_STATUS_SUCCESS,
+          "failed to save remote device properties", status);
+
   GetInterfaceToProfiles()->events->invoke_remote_device_properties_cb(
       status, bdaddr, num_properties, properties);
 }
@@ -1272,6 +1271,8 @@ static void btif_dm_auth_cmpl_evt(tBTA_DM_AUTH_CMPL* p_auth_cmpl) {
           LOG_INFO("scheduling SDP for %s", ADDRESS_TO_LOGGABLE_CSTR(bd_addr));
           pairing_cb.sdp_over_classic =
               btif_dm_pairing_cb_t::ServiceDiscoveryState::SCHEDULED;
+          pairing_cb.sdp_over_classic_start_ms =
+              bluetooth::common::time_get_os_boottime_ms();
           btif_dm_get_remote_services(bd_addr, BT_TRANSPORT_BR_EDR);
         }
       }
@@ -1417,8 +1418,12 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
       uint8_t uuid_list[32 * Uuid::kNumBytes16];
 
       if (p_search_data->inq_res.inq_result_type != BTM_INQ_RESULT_BLE) {
+        /* A name stored by a previous session is reused as well */
         p_search_data->inq_res.remt_name_not_required =
-            check_eir_remote_name(p_search_data, NULL, NULL);
+            check_eir_remote_name(p_search_data, NULL, NULL) ||
+            (bluetooth::common::init_flags::
+                 sdp_skip_rnr_if_known_is_enabled() &&
+             check_cached_remote_name(p_search_data, NULL, NULL));
       }
       RawAddress& bdaddr = p_search_data->inq_res.bd_addr;
 
@@ -1651,6 +1656,17 @@ static bool btif_should_ignore_uuid(const Uuid& uuid) {
   return uuid.IsEmpty() || uuid.IsBase();
 }
 
+/* Logs the time taken by a service discovery scheduled after bonding */
+static void btif_dm_log_discovery_time(const RawAddress& bd_addr,
+                                       const char* phase, uint64_t start_ms) {
+  unsigned long long duration_ms =
+      bluetooth::common::time_get_os_boottime_ms() - start_ms;
+  LOG_INFO("%s for %s took %llu ms", phase, ADDRESS_TO_LOGGABLE_CSTR(bd_addr),
+           duration_ms);
+  BTM_LogHistory(kBtmLogTag, bd_addr, "Service discovery done",
+                 base::StringPrintf("%s:%llums", phase, duration_ms));
+}
+
 /*******************************************************************************
  *
  * Function         btif_dm_search_services_evt
@@ -1691,6 +1707,11 @@ static void btif_dm_search_services_evt(tBTA_DM_SEARCH_EVT event,
       if ((bd_addr == pairing_cb.bd_addr ||
            bd_addr == pairing_cb.static_bdaddr)) {
         LOG_INFO("SDP finished for %s:", ADDRESS_TO_LOGGABLE_CSTR(bd_addr));
+        if (pairing_cb.sdp_over_classic ==
+            btif_dm_pairing_cb_t::ServiceDiscoveryState::SCHEDULED) {
+          btif_dm_log_discovery_time(bd_addr, "SDP over classic",
+                                     pairing_cb.sdp_over_classic_start_ms);
+        }
         pairing_cb.sdp_over_classic =
             btif_dm_pairing_cb_t::ServiceDiscoveryState::FINISHED;
       }
@@ -1856,6 +1877,9 @@ static void btif_dm_search_services_evt(tBTA_DM_SEARCH_EVT event,
                 "gatt_over_le should be SCHEDULED, did someone clear the "
                 "control block for %s ?",
                 ADDRESS_TO_LOGGABLE_CSTR(bd_addr));
+          } else {
+            btif_dm_log_discovery_time(bd_addr, "GATT over LE",
+                                       pairing_cb.gatt_over_le_start_ms);
           }
           pairing_cb.gatt_over_le =
               btif_dm_pairing_cb_t::ServiceDiscoveryState::FINISHED;
@@ -1944,11 +1968,6 @@ static void btif_dm_search_services_evt(tBTA_DM_SEARCH_EVT event,
       prop[0].type = BT_PROPERTY_UUIDS;
       prop[0].val = (void*)property_value.data();
       prop[0].len = Uuid::kNumBytes128 * uuids.size();
-
-      /* Also write this to the NVRAM */
-      bt_status_t ret =
-          btif_storage_set_remote_device_property(&bd_addr, &prop[0]);
-      ASSERTC(ret == BT_STATUS_SUCCESS, "storing remote services failed", ret);
       num_properties++;
 
       /* Remote name update */
@@ -1956,13 +1975,15 @@ static void btif_dm_search_services_evt(tBTA_DM_SEARCH_EVT event,
         prop[1].type = BT_PROPERTY_BDNAME;
         prop[1].val = p_data->disc_ble_res.bd_name;
         prop[1].len = strnlen((char*)p_data->disc_ble_res.bd_name, BD_NAME_LEN);
-
-        ret = btif_storage_set_remote_device_property(&bd_addr, &prop[1]);
-        ASSERTC(ret == BT_STATUS_SUCCESS,
-                "failed to save remote device property", ret);
         num_properties++;
       }
 
+      /* Also write this to the NVRAM */
+      bt_status_t ret = btif_storage_set_remote_device_properties(
+          &bd_addr, num_properties, prop);
+      ASSERTC(ret == BT_STATUS_SUCCESS,
+              "failed to save remote services and name", ret);
+
       /* If services were returned as part of SDP discovery, we will immediately
        * send them with rest of SDP results in BTA_DM_DISC_RES_EVT */
       if (event == BTA_DM_GATT_OVER_SDP_RES_EVT) {
@@ -3449,6 +3470,8 @@ static void btif_dm_ble_auth_cmpl_evt(tBTA_DM_AUTH_CMPL* p_auth_cmpl) {
                  ADDRESS_TO_LOGGABLE_CSTR(bd_addr));
         pairing_cb.gatt_over_le =
             btif_dm_pairing_cb_t::ServiceDiscoveryState::SCHEDULED;
+        pairing_cb.gatt_over_le_start_ms =
+            bluetooth::common::time_get_os_boottime_ms();
         btif_dm_get_remote_services(bd_addr, BT_TRANSPORT_LE);
       } else {
         LOG_INFO(
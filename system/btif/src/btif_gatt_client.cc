@@ -34,6 +34,8 @@
 #include <hardware/bluetooth.h>
 #include <hardware/bt_gatt.h>
 
+#include <map>
+#include <set>
 #include <string>
 
 #include "bta_api.h"
@@ -105,11 +107,33 @@ namespace {
 
 uint8_t rssi_request_client_if;
 
+/* Notification batching state, only used in the JNI thread. The notifications
+ * of the batching clients are kept until the events already queued to the JNI
+ * thread were handled, and then delivered at once. */
+constexpr size_t kMaxBatchedNotifications = 32;
+std::set<int> batching_client_ifs;
+std::map<int, int> client_if_by_conn_id;
+std::vector<int> batched_conn_ids;
+std::vector<btgatt_notify_params_t> batched_notifications;
+
+static void btif_gattc_flush_notifications() {
+  if (batched_notifications.empty()) return;
+
+  HAL_CBACK(bt_gatt_callbacks, client->notify_batch_cb, batched_conn_ids.data(),
+            batched_notifications.data(), (int)batched_notifications.size());
+
+  batched_conn_ids.clear();
+  batched_notifications.clear();
+}
+
 static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
   LOG_DEBUG("Event %s [%d]",
             gatt_client_event_text(static_cast<tBTA_GATTC_EVT>(event)).c_str(),
             event);
 
+  /* Keep the notifications in order with the other events */
+  btif_gattc_flush_notifications();
+
   tBTA_GATTC* p_data = (tBTA_GATTC*)p_param;
   switch (event) {
     case BTA_GATTC_EXEC_EVT: {
@@ -124,25 +148,6 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
       break;
     }
 
-    case BTA_GATTC_NOTIF_EVT: {
-      btgatt_notify_params_t data;
-
-      data.bda = p_data->notify.bda;
-      memcpy(data.value, p_data->notify.value, p_data->notify.len);
-
-      data.handle = p_data->notify.handle;
-      data.is_notify = p_data->notify.is_notify;
-      data.len = p_data->notify.len;
-
-      HAL_CBACK(bt_gatt_callbacks, client->notify_cb, p_data->notify.conn_id,
-                data);
-
-      if (!p_data->notify.is_notify)
-        BTA_GATTC_SendIndConfirm(p_data->notify.conn_id, p_data->notify.cid);
-
-      break;
-    }
-
     case BTA_GATTC_OPEN_EVT: {
       LOG_DEBUG("BTA_GATTC_OPEN_EVT %s",
                 ADDRESS_TO_LOGGABLE_CSTR(p_data->open.remote_bda));
@@ -155,13 +160,16 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
                   p_data->open.conn_id, p_data->open.status, p_data->open.mtu);
       }
 
-      if (p_data->open.status == GATT_SUCCESS)
+      if (p_data->open.status == GATT_SUCCESS) {
+        client_if_by_conn_id[p_data->open.conn_id] = p_data->open.client_if;
         btif_gatt_check_encrypted_link(p_data->open.remote_bda,
                                        p_data->open.transport);
+      }
       break;
     }
 
     case BTA_GATTC_CLOSE_EVT: {
+      client_if_by_conn_id.erase(p_data->close.conn_id);
       HAL_CBACK(bt_gatt_callbacks, client->close_cb, p_data->close.conn_id,
                 p_data->close.status, p_data->close.client_if,
                 p_data->close.remote_bda);
@@ -219,9 +227,63 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
   }
 }
 
+static void btif_gattc_fill_notify_params(btgatt_notify_params_t& data,
+                                          const RawAddress& bda,
+                                          uint16_t handle, bool is_notify,
+                                          const vector<uint8_t>& value) {
+  data.bda = bda;
+  memcpy(data.value, value.data(), value.size());
+
+  data.handle = handle;
+  data.is_notify = is_notify;
+  data.len = value.size();
+}
+
+static void btif_gattc_notify(uint16_t conn_id, uint16_t cid,
+                              const RawAddress& bda, uint16_t handle,
+                              bool is_notify, const vector<uint8_t>& value) {
+  auto client = client_if_by_conn_id.find(conn_id);
+  if (is_notify && client != client_if_by_conn_id.end() &&
+      batching_client_ifs.count(client->second) != 0) {
+    if (batched_notifications.empty()) {
+      do_in_jni_thread(Bind(&btif_gattc_flush_notifications));
+    }
+
+    batched_conn_ids.push_back(conn_id);
+    btif_gattc_fill_notify_params(batched_notifications.emplace_back(), bda,
+                                  handle, is_notify, value);
+
+    if (batched_notifications.size() >= kMaxBatchedNotifications) {
+      btif_gattc_flush_notifications();
+    }
+    return;
+  }
+
+  btif_gattc_flush_notifications();
+
+  btgatt_notify_params_t data;
+  btif_gattc_fill_notify_params(data, bda, handle, is_notify, value);
+
+  HAL_CBACK(bt_gatt_callbacks, client->notify_cb, conn_id, data);
+
+  if (!is_notify) BTA_GATTC_SendIndConfirm(conn_id, cid);
+}
+
 static void bta_gattc_cback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data) {
   LOG_DEBUG(" gatt client callback event:%s [%d]",
             gatt_client_event_text(event).c_str(), event);
+
+  /* Notifications are most of the events, only their value is copied rather
+   * than the whole event */
+  if (event == BTA_GATTC_NOTIF_EVT) {
+    const tBTA_GATTC_NOTIFY& notify = p_data->notify;
+    do_in_jni_thread(Bind(
+        &btif_gattc_notify, notify.conn_id, notify.cid, notify.bda,
+        notify.handle, notify.is_notify,
+        vector<uint8_t>(notify.value, notify.value + notify.len)));
+    return;
+  }
+
   bt_status_t status =
       btif_transfer_context(btif_gattc_upstreams_evt, (uint16_t)event,
                             (char*)p_data, sizeof(tBTA_GATTC), NULL);
@@ -265,6 +327,8 @@ static bt_status_t btif_gattc_register_app(const Uuid& uuid,
 }
 
 static void btif_gattc_unregister_app_impl(int client_if) {
+  btif_gattc_flush_notifications();
+  batching_client_ifs.erase(client_if);
   BTA_GATTC_AppDeregister(client_if);
 }
 
@@ -681,6 +745,26 @@ static bt_status_t btif_gattc_subrate_request(const RawAddress& bd_addr,
            subrate_min, subrate_max, max_latency, cont_num, sup_timeout));
 }
 
+static void btif_gattc_set_notification_batching_impl(int client_if,
+                                                      bool enable) {
+  btif_gattc_flush_notifications();
+  if (enable) {
+    batching_client_ifs.insert(client_if);
+  } else {
+    batching_client_ifs.erase(client_if);
+  }
+}
+
+static bt_status_t btif_gattc_set_notification_batching(int client_if,
+                                                        bool enable) {
+  CHECK_BTGATT_INIT();
+  if (enable && !bt_gatt_callbacks->client->notify_batch_cb) {
+    return BT_STATUS_UNSUPPORTED;
+  }
+  return do_in_jni_thread(
+      Bind(&btif_gattc_set_notification_batching_impl, client_if, enable));
+}
+
 }  // namespace
 
 const btgatt_client_interface_t btgattClientInterface = {
@@ -708,4 +792,5 @@ const btgatt_client_interface_t btgattClientInterface = {
     btif_gattc_test_command,
     btif_gattc_get_gatt_db,
     btif_gattc_subrate_request,
+    btif_gattc_set_notification_batching,
 };
@@ -34,6 +34,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <memory>
+#include <vector>
+
 #include "bta_api.h"
 #include "bta_gatt_api.h"
 #include "btif_common.h"
@@ -78,6 +81,19 @@ using std::vector;
 
 extern const btgatt_callbacks_t* bt_gatt_callbacks;
 
+/* A read or write request of a remote client */
+typedef struct {
+  uint16_t conn_id;
+  uint32_t trans_id;
+  RawAddress remote_bda;
+  uint16_t handle;
+  uint16_t offset;
+  bool is_long;
+  bool need_rsp;
+  bool is_prep;
+  std::vector<uint8_t> value;
+} btif_gatts_request_t;
+
 /*******************************************************************************
  *  Static functions
  ******************************************************************************/
@@ -94,10 +110,6 @@ static void btapp_gatts_copy_req_data(uint16_t event, char* p_dest,
 
   // Allocate buffer for request data if necessary
   switch (event) {
-    case BTA_GATTS_READ_CHARACTERISTIC_EVT:
-    case BTA_GATTS_READ_DESCRIPTOR_EVT:
-    case BTA_GATTS_WRITE_CHARACTERISTIC_EVT:
-    case BTA_GATTS_WRITE_DESCRIPTOR_EVT:
     case BTA_GATTS_EXEC_WRITE_EVT:
     case BTA_GATTS_MTU_EVT:
       p_dest_data->req_data.p_data =
@@ -113,10 +125,6 @@ static void btapp_gatts_copy_req_data(uint16_t event, char* p_dest,
 
 static void btapp_gatts_free_req_data(uint16_t event, tBTA_GATTS* p_data) {
   switch (event) {
-    case BTA_GATTS_READ_CHARACTERISTIC_EVT:
-    case BTA_GATTS_READ_DESCRIPTOR_EVT:
-    case BTA_GATTS_WRITE_CHARACTERISTIC_EVT:
-    case BTA_GATTS_WRITE_DESCRIPTOR_EVT:
     case BTA_GATTS_EXEC_WRITE_EVT:
     case BTA_GATTS_MTU_EVT:
       if (p_data != NULL) osi_free_and_reset((void**)&p_data->req_data.p_data);
@@ -169,44 +177,6 @@ static void btapp_gatts_handle_cback(uint16_t event, char* p_param) {
                 p_data->srvc_oper.service_id);
       break;
 
-    case BTA_GATTS_READ_CHARACTERISTIC_EVT: {
-      HAL_CBACK(bt_gatt_callbacks, server->request_read_characteristic_cb,
-                p_data->req_data.conn_id, p_data->req_data.trans_id,
-                p_data->req_data.remote_bda,
-                p_data->req_data.p_data->read_req.handle,
-                p_data->req_data.p_data->read_req.offset,
-                p_data->req_data.p_data->read_req.is_long);
-      break;
-    }
-
-    case BTA_GATTS_READ_DESCRIPTOR_EVT: {
-      HAL_CBACK(bt_gatt_callbacks, server->request_read_descriptor_cb,
-                p_data->req_data.conn_id, p_data->req_data.trans_id,
-                p_data->req_data.remote_bda,
-                p_data->req_data.p_data->read_req.handle,
-                p_data->req_data.p_data->read_req.offset,
-                p_data->req_data.p_data->read_req.is_long);
-      break;
-    }
-
-    case BTA_GATTS_WRITE_CHARACTERISTIC_EVT: {
-      const auto& req = p_data->req_data.p_data->write_req;
-      HAL_CBACK(bt_gatt_callbacks, server->request_write_characteristic_cb,
-                p_data->req_data.conn_id, p_data->req_data.trans_id,
-                p_data->req_data.remote_bda, req.handle, req.offset,
-                req.need_rsp, req.is_prep, req.value, req.len);
-      break;
-    }
-
-    case BTA_GATTS_WRITE_DESCRIPTOR_EVT: {
-      const auto& req = p_data->req_data.p_data->write_req;
-      HAL_CBACK(bt_gatt_callbacks, server->request_write_descriptor_cb,
-                p_data->req_data.conn_id, p_data->req_data.trans_id,
-                p_data->req_data.remote_bda, req.handle, req.offset,
-                req.need_rsp, req.is_prep, req.value, req.len);
-      break;
-    }
-
     case BTA_GATTS_EXEC_WRITE_EVT: {
       HAL_CBACK(bt_gatt_callbacks, server->request_exec_write_cb,
                 p_data->req_data.conn_id, p_data->req_data.trans_id,
@@ -264,11 +234,88 @@ static void btapp_gatts_handle_cback(uint16_t event, char* p_param) {
   btapp_gatts_free_req_data(event, p_data);
 }
 
+static void btapp_gatts_handle_request(
+    uint16_t event, std::unique_ptr<btif_gatts_request_t> p_req) {
+  LOG_VERBOSE("%s: Event %d", __func__, event);
+
+  switch (event) {
+    case BTA_GATTS_READ_CHARACTERISTIC_EVT:
+      HAL_CBACK(bt_gatt_callbacks, server->request_read_characteristic_cb,
+                p_req->conn_id, p_req->trans_id, p_req->remote_bda,
+                p_req->handle, p_req->offset, p_req->is_long);
+      break;
+
+    case BTA_GATTS_READ_DESCRIPTOR_EVT:
+      HAL_CBACK(bt_gatt_callbacks, server->request_read_descriptor_cb,
+                p_req->conn_id, p_req->trans_id, p_req->remote_bda,
+                p_req->handle, p_req->offset, p_req->is_long);
+      break;
+
+    case BTA_GATTS_WRITE_CHARACTERISTIC_EVT:
+      HAL_CBACK(bt_gatt_callbacks, server->request_write_characteristic_cb,
+                p_req->conn_id, p_req->trans_id, p_req->remote_bda,
+                p_req->handle, p_req->offset, p_req->need_rsp, p_req->is_prep,
+                p_req->value.data(), p_req->value.size());
+      break;
+
+    case BTA_GATTS_WRITE_DESCRIPTOR_EVT:
+      HAL_CBACK(bt_gatt_callbacks, server->request_write_descriptor_cb,
+                p_req->conn_id, p_req->trans_id, p_req->remote_bda,
+                p_req->handle, p_req->offset, p_req->need_rsp, p_req->is_prep,
+                p_req->value.data(), p_req->value.size());
+      break;
+
+    default:
+      LOG_ERROR("%s: Unhandled event (%d)!", __func__, event);
+      break;
+  }
+}
+
+/* Read and write requests are most of the events, only the fields of the
+ * request are moved to the btif context rather than the whole event and its
+ * tGATTS_DATA */
+static std::unique_ptr<btif_gatts_request_t> btapp_gatts_new_request(
+    tBTA_GATTS_EVT event, const tBTA_GATTS_REQ& req_data) {
+  auto p_req = std::make_unique<btif_gatts_request_t>();
+  p_req->conn_id = req_data.conn_id;
+  p_req->trans_id = req_data.trans_id;
+  p_req->remote_bda = req_data.remote_bda;
+
+  if (event == BTA_GATTS_READ_CHARACTERISTIC_EVT ||
+      event == BTA_GATTS_READ_DESCRIPTOR_EVT) {
+    const tGATT_READ_REQ& read_req = req_data.p_data->read_req;
+    p_req->handle = read_req.handle;
+    p_req->offset = read_req.offset;
+    p_req->is_long = read_req.is_long;
+  } else {
+    const tGATT_WRITE_REQ& write_req = req_data.p_data->write_req;
+    p_req->handle = write_req.handle;
+    p_req->offset = write_req.offset;
+    p_req->need_rsp = write_req.need_rsp;
+    p_req->is_prep = write_req.is_prep;
+    p_req->value.assign(write_req.value, write_req.value + write_req.len);
+  }
+  return p_req;
+}
+
 static void btapp_gatts_cback(tBTA_GATTS_EVT event, tBTA_GATTS* p_data) {
   bt_status_t status;
-  status = btif_transfer_context(btapp_gatts_handle_cback, (uint16_t)event,
-                                 (char*)p_data, sizeof(tBTA_GATTS),
-                                 btapp_gatts_copy_req_data);
+  switch (event) {
+    case BTA_GATTS_READ_CHARACTERISTIC_EVT:
+    case BTA_GATTS_READ_DESCRIPTOR_EVT:
+    case BTA_GATTS_WRITE_CHARACTERISTIC_EVT:
+    case BTA_GATTS_WRITE_DESCRIPTOR_EVT:
+      status = btif_transfer_context(
+          btapp_gatts_handle_request, (uint16_t)event,
+          btapp_gatts_new_request(event, p_data->req_data));
+      break;
+
+    default:
+      status = btif_transfer_context(btapp_gatts_handle_cback, (uint16_t)event,
+                                     (char*)p_data, sizeof(tBTA_GATTS),
+                                     btapp_gatts_copy_req_data);
+      break;
+  }
   ASSERTC(status == BT_STATUS_SUCCESS, "Context transfer failed!", status);
 }
 
@@ -405,8 +405,10 @@ static void btif_hf_upstreams_evt(uint16_t event, char* p_param) {
           log_counter_metrics_btif(android::bluetooth::CodePathCounterKeyEnum::
                                        HFP_COLLISON_AT_CONNECTING,
                                    1);
+          RawAddress connected_bda = btif_hf_cb[idx].connected_bda;
           reset_control_block(&btif_hf_cb[idx]);
-          btif_queue_advance();
+          btif_queue_advance_by_uuid(UUID_SERVCLASS_AG_HANDSFREE,
+                                     &connected_bda);
         }
       }
 
@@ -449,7 +451,8 @@ static void btif_hf_upstreams_evt(uint16_t event, char* p_param) {
         log_counter_metrics_btif(android::bluetooth::CodePathCounterKeyEnum::
                                      HFP_SELF_INITIATED_AG_FAILED,
                                  1);
-        btif_queue_advance();
+        btif_queue_advance_by_uuid(UUID_SERVCLASS_AG_HANDSFREE,
+                                   &connected_bda);
         DEVICE_IOT_CONFIG_ADDR_INT_ADD_ONE(
             connected_bda, IOT_CONF_KEY_HFP_SLC_CONN_FAIL_COUNT);
       }
@@ -476,7 +479,8 @@ static void btif_hf_upstreams_evt(uint16_t event, char* p_param) {
         log_counter_metrics_btif(
             android::bluetooth::CodePathCounterKeyEnum::HFP_SLC_SETUP_FAILED,
             1);
-        btif_queue_advance();
+        btif_queue_advance_by_uuid(UUID_SERVCLASS_AG_HANDSFREE,
+                                   &connected_bda);
         DEVICE_IOT_CONFIG_ADDR_INT_ADD_ONE(
             btif_hf_cb[idx].connected_bda,
             IOT_CONF_KEY_HFP_SLC_CONN_FAIL_COUNT);
@@ -499,7 +503,8 @@ static void btif_hf_upstreams_evt(uint16_t event, char* p_param) {
       bt_hf_callbacks->ConnectionStateCallback(btif_hf_cb[idx].state,
                                                &btif_hf_cb[idx].connected_bda);
       if (btif_hf_cb[idx].is_initiator) {
-        btif_queue_advance();
+        btif_queue_advance_by_uuid(UUID_SERVCLASS_AG_HANDSFREE,
+                                   &btif_hf_cb[idx].connected_bda);
       }
       break;
 
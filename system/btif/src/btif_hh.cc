@@ -35,6 +35,7 @@
 
 #include "bta_hh_co.h"
 #include "btif/include/btif_common.h"
+#include "btif/include/btif_hh_report_batch.h"
 #include "btif/include/btif_profile_storage.h"
 #include "btif/include/btif_util.h"
 #include "include/hardware/bt_hh.h"
@@ -1901,6 +1902,13 @@ void DumpsysHid(int fd) {
                   bthh_connection_state_text(p_dev->dev_status).c_str(),
                   (p_dev->ready_for_data) ? ("T") : ("F"),
                   static_cast<int>(p_dev->hh_poll_thread_id));
+      const BtifHhReportBatch* batch = p_dev->report_batch;
+      if (batch != nullptr) {
+        LOG_DUMPSYS(fd, "     reports:%llu writes:%llu coalesced:%llu",
+                    (unsigned long long)batch->GetReportCount(),
+                    (unsigned long long)batch->GetWriteCount(),
+                    (unsigned long long)batch->GetCoalescedCount());
+      }
     }
   }
   for (unsigned i = 0; i < BTIF_HH_MAX_ADDED_DEV; i++) {
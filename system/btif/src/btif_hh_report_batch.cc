@@ -0,0 +1,277 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif/include/btif_hh_report_batch.h"
+
+#include <errno.h>
+#include <linux/uhid.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "osi/include/osi.h"
+
+namespace {
+
+// The type and size of an UHID_INPUT2 event come before its data
+constexpr size_t kInput2HeaderLen = sizeof(__u32) + sizeof(__u16);
+static_assert(offsetof(struct uhid_event, u.input2.data) == kInput2HeaderLen,
+              "Unexpected layout of the UHID_INPUT2 event");
+
+constexpr size_t kMaxReportBits = UHID_DATA_MAX * 8;
+
+// Short items of the report descriptor, HID 1.11 section 6.2.2
+constexpr uint8_t kLongItemPrefix = 0xfe;
+constexpr uint8_t kItemTypeMain = 0;
+constexpr uint8_t kItemTypeGlobal = 1;
+constexpr uint8_t kItemTypeLocal = 2;
+
+constexpr uint8_t kMainInput = 0x8;
+constexpr uint8_t kGlobalUsagePage = 0x0;
+constexpr uint8_t kGlobalReportSize = 0x7;
+constexpr uint8_t kGlobalReportId = 0x8;
+constexpr uint8_t kGlobalReportCount = 0x9;
+constexpr uint8_t kGlobalPush = 0xa;
+constexpr uint8_t kGlobalPop = 0xb;
+constexpr uint8_t kLocalUsage = 0x0;
+constexpr uint8_t kLocalUsageMinimum = 0x1;
+constexpr uint8_t kLocalUsageMaximum = 0x2;
+
+constexpr uint32_t kInputConstant = 1 << 0;
+constexpr uint32_t kInputVariable = 1 << 1;
+constexpr uint32_t kInputRelative = 1 << 2;
+
+constexpr uint16_t kUsagePageGenericDesktop = 0x01;
+constexpr uint16_t kUsagePageDigitizer = 0x0d;
+
+bool IsAbsolutePositionUsage(uint32_t usage) {
+  uint16_t page = usage >> 16;
+  uint16_t id = usage & 0xffff;
+  if (page == kUsagePageGenericDesktop) {
+    return id >= 0x30 && id <= 0x35; /* X, Y, Z, Rx, Ry, Rz */
+  }
+  if (page == kUsagePageDigitizer) {
+    return id == 0x30 || id == 0x3d || id == 0x3e; /* Pressure, X/Y Tilt */
+  }
+  return false;
+}
+
+struct GlobalItems {
+  uint16_t usage_page;
+  uint32_t report_size;
+  uint32_t report_count;
+  uint8_t report_id;
+};
+
+}  // namespace
+
+BtifHhReportBatch::BtifHhReportBatch(const uint8_t* descriptor,
+                                     size_t descriptor_len, bool coalesce)
+    : has_report_ids_(false),
+      coalesced_count_(0),
+      write_count_(0),
+      report_count_(0) {
+  ParseDescriptor(descriptor, descriptor_len);
+  if (!coalesce) coalescable_bits_.clear();
+}
+
+void BtifHhReportBatch::ParseDescriptor(const uint8_t* descriptor,
+                                        size_t descriptor_len) {
+  GlobalItems global = {};
+  std::vector<GlobalItems> global_stack;
+  std::vector<uint32_t> usages;
+  uint32_t usage_minimum = 0, usage_maximum = 0;
+  bool has_usage_range = false;
+  std::map<uint8_t, size_t> bit_offsets;
+
+  size_t i = 0;
+  while (i < descriptor_len) {
+    uint8_t prefix = descriptor[i++];
+    if (prefix == kLongItemPrefix) {
+      if (i >= descriptor_len) break;
+      /* bDataSize, bLongItemTag and the data */
+      i += 2 + descriptor[i];
+      continue;
+    }
+
+    size_t size = prefix & 0x3;
+    if (size == 3) size = 4;
+    if (i + size > descriptor_len) break;
+    uint32_t data = 0;
+    for (size_t b = 0; b < size; b++) {
+      data |= (uint32_t)descriptor[i + b] << (8 * b);
+    }
+    i += size;
+
+    uint8_t type = (prefix >> 2) & 0x3;
+    uint8_t tag = prefix >> 4;
+    /* Usages of 4 bytes carry their usage page */
+    uint32_t usage = size == 4 ? data : (global.usage_page << 16) | data;
+
+    if (type == kItemTypeGlobal) {
+      switch (tag) {
+        case kGlobalUsagePage:
+          global.usage_page = data;
+          break;
+        case kGlobalReportSize:
+          global.report_size = data;
+          break;
+        case kGlobalReportId:
+          global.report_id = data;
+          has_report_ids_ = true;
+          break;
+        case kGlobalReportCount:
+          global.report_count = data;
+          break;
+        case kGlobalPush:
+          global_stack.push_back(global);
+          break;
+        case kGlobalPop:
+          if (!global_stack.empty()) {
+            global = global_stack.back();
+            global_stack.pop_back();
+          }
+          break;
+      }
+    } else if (type == kItemTypeLocal) {
+      switch (tag) {
+        case kLocalUsage:
+          usages.push_back(usage);
+          break;
+        case kLocalUsageMinimum:
+          usage_minimum = usage;
+          has_usage_range = true;
+          break;
+        case kLocalUsageMaximum:
+          usage_maximum = usage;
+          has_usage_range = true;
+          break;
+      }
+    } else if (type == kItemTypeMain) {
+      if (tag == kMainInput) {
+        size_t& offset = bit_offsets[global.report_id];
+        bool absolute_variable =
+            (data & (kInputConstant | kInputVariable | kInputRelative)) ==
+                kInputVariable &&
+            global.report_size > 1;
+
+        for (uint32_t field = 0;
+             field < global.report_count && offset < kMaxReportBits;
+             field++, offset += global.report_size) {
+          if (!absolute_variable || global.report_size > kMaxReportBits ||
+              offset + global.report_size > kMaxReportBits) {
+            continue;
+          }
+          /* Each field takes the next usage, the last one is repeated */
+          uint32_t field_usage = 0;
+          if (has_usage_range) {
+            field_usage = std::min(usage_minimum + field, usage_maximum);
+          } else if (!usages.empty()) {
+            field_usage = usages[std::min<size_t>(field, usages.size() - 1)];
+          }
+          if (!IsAbsolutePositionUsage(field_usage)) continue;
+
+          std::vector<uint8_t>& bits = coalescable_bits_[global.report_id];
+          size_t end = offset + global.report_size;
+          if (bits.size() < (end + 7) / 8) bits.resize((end + 7) / 8, 0);
+          for (size_t bit = offset; bit < end; bit++) {
+            bits[bit / 8] |= 1 << (bit % 8);
+          }
+        }
+      }
+      /* Local items only apply to the main item that follows them */
+      usages.clear();
+      has_usage_range = false;
+    }
+  }
+}
+
+bool BtifHhReportBatch::Supersedes(const std::vector<uint8_t>& event,
+                                   const uint8_t* report, uint16_t len) const {
+  const uint8_t* pending = event.data() + kInput2HeaderLen;
+  if (event.size() != kInput2HeaderLen + len) return false;
+
+  auto it = coalescable_bits_.find(has_report_ids_ ? report[0] : 0);
+  if (it == coalescable_bits_.end()) return false;
+  const std::vector<uint8_t>& bits = it->second;
+
+  /* The report ID is compared as one of the bytes that must be equal */
+  size_t body = has_report_ids_ ? 1 : 0;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t mask = (i >= body && i - body < bits.size()) ? bits[i - body] : 0;
+    if ((pending[i] ^ report[i]) & ~mask) return false;
+  }
+  return true;
+}
+
+void BtifHhReportBatch::Add(const uint8_t* report, uint16_t len) {
+  if (len > UHID_DATA_MAX || (has_report_ids_ && len == 0)) return;
+  report_count_++;
+
+  if (!coalescable_bits_.empty()) {
+    /* Only the latest pending report with the same ID can be superseded, an
+     * earlier one is followed by a report that changed something else */
+    for (auto it = events_.rbegin(); it != events_.rend(); it++) {
+      const uint8_t* pending = it->data() + kInput2HeaderLen;
+      if (has_report_ids_ && pending[0] != report[0]) continue;
+      if (Supersedes(*it, report, len)) {
+        events_.erase(std::next(it).base());
+        coalesced_count_++;
+      }
+      break;
+    }
+  }
+
+  std::vector<uint8_t> event(kInput2HeaderLen + len);
+  __u32 type = UHID_INPUT2;
+  __u16 size = len;
+  memcpy(event.data(), &type, sizeof(type));
+  memcpy(event.data() + sizeof(type), &size, sizeof(size));
+  memcpy(event.data() + kInput2HeaderLen, report, len);
+  events_.push_back(std::move(event));
+}
+
+int BtifHhReportBatch::Flush(int fd) {
+  int rc = 0;
+  for (size_t first = 0; first < events_.size() && rc == 0;
+       first += kMaxPendingReports) {
+    size_t count = std::min(events_.size() - first, kMaxPendingReports);
+    struct iovec iov[kMaxPendingReports];
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+      iov[i].iov_base = events_[first + i].data();
+      iov[i].iov_len = events_[first + i].size();
+      total += iov[i].iov_len;
+    }
+
+    /* uhid takes one event per write, which writev() does for each iovec */
+    ssize_t ret;
+    OSI_NO_INTR(ret = writev(fd, iov, count));
+    write_count_++;
+    if (ret < 0) {
+      rc = -errno;
+    } else if ((size_t)ret != total) {
+      rc = -EFAULT;
+    }
+  }
+
+  events_.clear();
+  return rc;
+}
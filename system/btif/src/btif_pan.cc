@@ -37,7 +37,6 @@
 #ifdef __ANDROID__
 #include <pan.sysprop.h>
 #endif
-#include <poll.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 
@@ -651,55 +650,35 @@ static void bta_pan_callback(tBTA_PAN_EVT event, tBTA_PAN* p_data) {
                         sizeof(tBTA_PAN), NULL);
 }
 
-#define IS_EXCEPTION(e) ((e) & (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL))
 static void btu_exec_tap_fd_read(int fd) {
-  struct pollfd ufd;
-
   if (fd == INVALID_FD || fd != btpan_cb.tap_fd) return;
 
   // Don't occupy BTU context too long, avoid buffer overruns and
   // give other profiles a chance to run by limiting the amount of memory
   // PAN can use.
+  // The TAP fd is non blocking: the frames queued in the driver are drained
+  // until a read would block, one read per frame.
   for (int i = 0; i < PAN_BUF_MAX && btif_is_enabled() && btpan_cb.flow; i++) {
-    BT_HDR* buffer = (BT_HDR*)osi_malloc(PAN_BUF_SIZE);
-    buffer->offset = PAN_MINIMUM_OFFSET;
-    buffer->len = PAN_BUF_SIZE - sizeof(BT_HDR) - buffer->offset;
-
-    uint8_t* packet = (uint8_t*)buffer + sizeof(BT_HDR) + buffer->offset;
-
-    // If we don't have an undelivered packet left over, pull one from the TAP
-    // driver.
-    // We save it in the congest_packet right away in case we can't deliver it
-    // in this
-    // attempt.
-    if (!btpan_cb.congest_packet_size) {
-      ssize_t ret;
-      OSI_NO_INTR(ret = read(fd, btpan_cb.congest_packet,
-                             sizeof(btpan_cb.congest_packet)));
-      switch (ret) {
-        case -1:
-          BTIF_TRACE_ERROR("%s unable to read from driver: %s", __func__,
-                           strerror(errno));
-          osi_free(buffer);
-          // add fd back to monitor thread to try it again later
-          btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
-          return;
-        case 0:
-          BTIF_TRACE_WARNING("%s end of file reached.", __func__);
-          osi_free(buffer);
-          // add fd back to monitor thread to process the exception
-          btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
-          return;
-        default:
-          btpan_cb.congest_packet_size = ret;
-          break;
+    // The frame is read in place behind the room for the BNEP and L2CAP
+    // headers, no copy is made on the way to L2CAP.
+    ssize_t ret;
+    BT_HDR* buffer = btpan_tap_read_frame(fd, &ret);
+    if (buffer == NULL) {
+      if (ret == 0) {
+        BTIF_TRACE_WARNING("%s end of file reached.", __func__);
+        // add fd back to monitor thread to process the exception
+        btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
+        return;
       }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      BTIF_TRACE_ERROR("%s unable to read from driver: %s", __func__,
+                       strerror(errno));
+      // add fd back to monitor thread to try it again later
+      btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
+      return;
     }
 
-    memcpy(packet, btpan_cb.congest_packet,
-           MIN(btpan_cb.congest_packet_size, buffer->len));
-    buffer->len = MIN(btpan_cb.congest_packet_size, buffer->len);
-
+    uint8_t* packet = (uint8_t*)(buffer + 1) + buffer->offset;
     if (buffer->len > sizeof(tETH_HDR) && should_forward((tETH_HDR*)packet)) {
       // Extract the ethernet header from the buffer since the PAN_WriteBuf
       // inside
@@ -711,23 +690,16 @@ static void btu_exec_tap_fd_read(int fd) {
       // Skip the ethernet header.
       buffer->len -= sizeof(tETH_HDR);
       buffer->offset += sizeof(tETH_HDR);
-      if (forward_bnep(&hdr, buffer) != FORWARD_CONGEST)
-        btpan_cb.congest_packet_size = 0;
+      // BNEP only rejects a frame once its queue is full, that is after the
+      // flow has been turned off and this loop has stopped.
+      if (forward_bnep(&hdr, buffer) == FORWARD_CONGEST) {
+        BTIF_TRACE_WARNING("%s BNEP queue full, frame dropped", __func__);
+      }
     } else {
       BTIF_TRACE_WARNING("%s dropping packet of length %d", __func__,
                          buffer->len);
-      btpan_cb.congest_packet_size = 0;
       osi_free(buffer);
     }
-
-    // Bail out of the loop if reading from the TAP fd would block.
-    ufd.fd = fd;
-    ufd.events = POLLIN;
-    ufd.revents = 0;
-
-    int ret;
-    OSI_NO_INTR(ret = poll(&ufd, 1, 0));
-    if (ret <= 0 || IS_EXCEPTION(ufd.revents)) break;
   }
 
   if (btpan_cb.flow) {
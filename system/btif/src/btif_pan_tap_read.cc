@@ -0,0 +1,60 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <unistd.h>
+
+#include "bt_target.h"  // Must be first to define build configuration
+#include "btif/include/btif_pan_internal.h"
+#include "osi/include/allocator.h"
+#include "osi/include/osi.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/pan_api.h"
+
+/*******************************************************************************
+ *
+ * Function         btpan_tap_read_frame
+ *
+ * Description      Reads the next Ethernet frame from the tap |fd| straight
+ *                  into a packet buffer. PAN_MINIMUM_OFFSET bytes are left
+ *                  in front of the frame, so that the L2CAP and BNEP headers
+ *                  are built in place whatever the compression of the BNEP
+ *                  header is.
+ *
+ * Returns          The buffer holding the frame, or NULL with |*p_result|
+ *                  set to the return value of read()
+ *
+ ******************************************************************************/
+BT_HDR* btpan_tap_read_frame(int fd, ssize_t* p_result) {
+  BT_HDR* buffer = (BT_HDR*)osi_malloc_packet(PAN_BUF_SIZE);
+  buffer->event = 0;
+  buffer->layer_specific = 0;
+  buffer->offset = PAN_MINIMUM_OFFSET;
+
+  uint8_t* packet = (uint8_t*)(buffer + 1) + buffer->offset;
+  ssize_t ret;
+  OSI_NO_INTR(ret = read(fd, packet, PAN_BUF_SIZE - sizeof(BT_HDR) -
+                                         buffer->offset));
+  *p_result = ret;
+  if (ret <= 0) {
+    osi_free(buffer);
+    return NULL;
+  }
+
+  buffer->len = ret;
+  return buffer;
+}
@@ -34,11 +34,14 @@
 #include <base/strings/stringprintf.h>
 #include <string.h>
 
+#include <algorithm>
 #include <list>
 
 #include "btif/include/stack_manager.h"
 #include "btif_common.h"
+#include "device/include/interop.h"
 #include "main/shim/dumpsys.h"
+#include "stack/include/sdpdefs.h"
 #include "types/raw_address.h"
 
 /*******************************************************************************
@@ -60,6 +63,7 @@ class ConnectNode {
 
   const RawAddress& address() const { return address_; }
   uint16_t uuid() const { return uuid_; }
+  bool busy() const { return busy_; }
 
   /**
    * Initiate the connection.
@@ -93,6 +97,39 @@ static const size_t MAX_REASONABLE_REQUESTS = 20;
  *  Queue helper functions
  ******************************************************************************/
 
+// Profiles whose connections do not depend on each other once the ACL is up.
+// The connections of other profiles are run one at a time.
+static bool queue_int_is_independent_profile(uint16_t uuid) {
+  switch (uuid) {
+    case UUID_SERVCLASS_AUDIO_SOURCE:
+    case UUID_SERVCLASS_AUDIO_SINK:
+    case UUID_SERVCLASS_AG_HANDSFREE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Whether |node| can be connected while |other|, queued before it, is still
+// pending. The requests of the same profile keep their order.
+static bool queue_int_can_run_concurrently(const ConnectNode& node,
+                                           const ConnectNode& other) {
+  if (!queue_int_is_independent_profile(node.uuid()) ||
+      !queue_int_is_independent_profile(other.uuid()) ||
+      node.uuid() == other.uuid()) {
+    return false;
+  }
+  // Devices needing a delay between their profile connections get them
+  // one after the other
+  if (node.address() == other.address() &&
+      interop_match_addr(
+          INTEROP_PHONE_POLICY_INCREASED_DELAY_CONNECT_OTHER_PROFILES,
+          &node.address())) {
+    return false;
+  }
+  return true;
+}
+
 static void queue_int_add(uint16_t uuid, const RawAddress& bda,
                           btif_connect_cb_t connect_cb) {
   // Sanity check to make sure we're not leaking connection requests
@@ -124,6 +161,20 @@ static void queue_int_advance() {
   btif_queue_connect_next();
 }
 
+static void queue_int_advance_by_uuid(uint16_t uuid, const RawAddress& bda) {
+  for (auto it = connect_queue.begin(); it != connect_queue.end(); ++it) {
+    if (it->uuid() == uuid && it->address() == bda) {
+      LOG_INFO("%s: removing connection request: %s", __func__,
+               it->ToString().c_str());
+      connect_queue.erase(it);
+      btif_queue_connect_next();
+      return;
+    }
+  }
+  LOG_WARN("%s: no connection request for UUID=%04X address=%s", __func__,
+           uuid, ADDRESS_TO_LOGGABLE_CSTR(bda));
+}
+
 static void queue_int_cleanup(uint16_t uuid) {
   LOG_INFO("%s: UUID=%04X", __func__, uuid);
 
@@ -183,6 +234,24 @@ void btif_queue_advance() {
   do_in_jni_thread(FROM_HERE, base::Bind(&queue_int_advance));
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_queue_advance_by_uuid
+ *
+ * Description      Remove the connection request of profile |uuid| to |bda|
+ *                  and advance to the next scheduled connections. Profiles
+ *                  connecting concurrently must use this rather than
+ *                  btif_queue_advance, their requests can finish out of
+ *                  order.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btif_queue_advance_by_uuid(uint16_t uuid, const RawAddress* bda) {
+  do_in_jni_thread(FROM_HERE,
+                   base::Bind(&queue_int_advance_by_uuid, uuid, *bda));
+}
+
 bt_status_t btif_queue_connect_next(void) {
   // The call must be on the JNI thread, otherwise the access to connect_queue
   // is not thread-safe.
@@ -192,16 +261,29 @@ bt_status_t btif_queue_connect_next(void) {
   if (!stack_manager_get_interface()->get_stack_is_running())
     return BT_STATUS_FAIL;
 
-  ConnectNode& head = connect_queue.front();
-
-  LOG_INFO("Executing profile connection request:%s", head.ToString().c_str());
-  bt_status_t b_status = head.connect();
-  if (b_status != BT_STATUS_SUCCESS) {
-    LOG_INFO("%s: connect %s failed, advance to next scheduled connection.",
-             __func__, head.ToString().c_str());
-    btif_queue_advance();
+  // Start every request which does not have to wait for the ones before it
+  for (auto it = connect_queue.begin(); it != connect_queue.end(); ++it) {
+    if (it != connect_queue.begin() &&
+        !std::all_of(connect_queue.begin(), it,
+                     [&node = *it](const ConnectNode& other) {
+                       return queue_int_can_run_concurrently(node, other);
+                     })) {
+      continue;
+    }
+    if (it->busy()) continue;
+
+    LOG_INFO("Executing profile connection request:%s",
+             it->ToString().c_str());
+    bt_status_t b_status = it->connect();
+    if (b_status != BT_STATUS_SUCCESS) {
+      LOG_INFO("%s: connect %s failed, advance to next scheduled connection.",
+               __func__, it->ToString().c_str());
+      // The remaining requests are started once this one is removed
+      btif_queue_advance_by_uuid(it->uuid(), &it->address());
+      return b_status;
+    }
   }
-  return b_status;
+  return BT_STATUS_SUCCESS;
 }
 
 /*******************************************************************************
@@ -879,10 +879,12 @@ static bool flush_incoming_que_on_wr_signal_l(l2cap_socket* sock) {
 }
 
 inline BT_HDR* malloc_l2cap_buf(uint16_t len) {
-  // We need FCS only for L2CAP_FCR_ERTM_MODE, but it's just 2 bytes so it's ok
-  BT_HDR* msg = (BT_HDR*)osi_malloc(BT_HDR_SIZE + L2CAP_MIN_OFFSET + len +
-                                    L2CAP_FCS_LENGTH);
-  msg->offset = L2CAP_MIN_OFFSET;
+  // We need FCS only for L2CAP_FCR_ERTM_MODE, but it's just 2 bytes so it's ok.
+  // The headroom also fits the SDU length of LE CoC, so L2CAP can send an
+  // unsegmented SDU straight out of this buffer on either transport.
+  BT_HDR* msg = (BT_HDR*)osi_malloc_packet(BT_HDR_SIZE + L2CAP_LCC_OFFSET +
+                                           len + L2CAP_FCS_LENGTH);
+  msg->offset = L2CAP_LCC_OFFSET;
   msg->len = len;
   return msg;
 }
@@ -37,6 +37,7 @@
 #include "btif/include/btif_sock_thread.h"
 #include "btif/include/btif_sock_util.h"
 #include "btif/include/btif_uid.h"
+#include "gd/common/packet_latency_trace.h"
 #include "include/hardware/bt_sock.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
@@ -808,8 +809,23 @@ typedef enum {
   SENT_ALL,
 } sent_status_t;
 
+// The socket of the app is the last stage of the latency trace of the
+// incoming RFCOMM packets
+static sent_status_t end_packet_latency_sample(BT_HDR* p_buf,
+                                               sent_status_t status) {
+  if (status == SENT_ALL) {
+    bluetooth::common::PacketLatencyTrace::End(
+        bluetooth::common::PacketLatencyTrace::GetBufferSample(p_buf),
+        bluetooth::common::PacketLatencyStage::BTIF_SOCKET);
+  }
+  if (status == SENT_ALL || status == SENT_FAILED) {
+    bluetooth::common::PacketLatencyTrace::UntagBuffer(p_buf);
+  }
+  return status;
+}
+
 static sent_status_t send_data_to_app(int fd, BT_HDR* p_buf) {
-  if (p_buf->len == 0) return SENT_ALL;
+  if (p_buf->len == 0) return end_packet_latency_sample(p_buf, SENT_ALL);
 
   ssize_t sent;
   OSI_NO_INTR(
@@ -819,12 +835,12 @@ static sent_status_t send_data_to_app(int fd, BT_HDR* p_buf) {
     if (errno == EAGAIN || errno == EWOULDBLOCK) return SENT_NONE;
     LOG_ERROR("%s error writing RFCOMM data back to app: %s", __func__,
               strerror(errno));
-    return SENT_FAILED;
+    return end_packet_latency_sample(p_buf, SENT_FAILED);
   }
 
-  if (sent == 0) return SENT_FAILED;
+  if (sent == 0) return end_packet_latency_sample(p_buf, SENT_FAILED);
 
-  if (sent == p_buf->len) return SENT_ALL;
+  if (sent == p_buf->len) return end_packet_latency_sample(p_buf, SENT_ALL);
 
   p_buf->offset += sent;
   p_buf->len -= sent;
@@ -33,13 +33,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <features.h>
-#include <poll.h>
 #include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
@@ -50,6 +49,8 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "bta_api.h"
 #include "btif_common.h"
@@ -67,10 +68,10 @@
 
 #define MAX_THREAD 8
 #define MAX_POLL 64
-#define POLL_EXCEPTION_EVENTS (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL)
+#define POLL_EXCEPTION_EVENTS (EPOLLHUP | EPOLLRDHUP | EPOLLERR)
 #define IS_EXCEPTION(e) ((e)&POLL_EXCEPTION_EVENTS)
-#define IS_READ(e) ((e)&POLLIN)
-#define IS_WRITE(e) ((e)&POLLOUT)
+#define IS_READ(e) ((e)&EPOLLIN)
+#define IS_WRITE(e) ((e)&EPOLLOUT)
 /*cmd executes in socket poll thread */
 #define CMD_WAKEUP 1
 #define CMD_EXIT 2
@@ -79,16 +80,18 @@
 #define CMD_USER_PRIVATE 5
 
 struct poll_slot_t {
-  struct pollfd pfd;
+  int fd;
   uint32_t user_id;
   int type;
   int flags;
 };
 struct thread_slot_t {
   int cmd_fdr, cmd_fdw;
+  int epoll_fd;
   int poll_count;
   poll_slot_t ps[MAX_POLL];
-  int psi[MAX_POLL];  // index of poll slot
+  std::unordered_map<int, int> fd_to_ps;  // index of poll slot, by fd
+  std::vector<int> free_ps;               // indexes of unused poll slots
   std::optional<pthread_t> thread_id;
   btsock_signaled_cb callback;
   btsock_cmd_cb cmd_callback;
@@ -146,6 +149,10 @@ static int alloc_thread_slot() {
 static void free_thread_slot(int h) {
   if (0 <= h && h < MAX_THREAD) {
     close_cmd_fd(h);
+    if (ts[h].epoll_fd != -1) {
+      close(ts[h].epoll_fd);
+      ts[h].epoll_fd = -1;
+    }
     ts[h].used = 0;
   } else
     APPL_TRACE_ERROR("invalid thread handle:%d", h);
@@ -157,6 +164,7 @@ void btsock_thread_init() {
     int h;
     for (h = 0; h < MAX_THREAD; h++) {
       ts[h].cmd_fdr = ts[h].cmd_fdw = -1;
+      ts[h].epoll_fd = -1;
       ts[h].used = 0;
       ts[h].thread_id = std::nullopt;
       ts[h].poll_count = 0;
@@ -338,23 +346,50 @@ static void init_poll(int h) {
   ts[h].thread_id = std::nullopt;
   ts[h].callback = NULL;
   ts[h].cmd_callback = NULL;
-  for (i = 0; i < MAX_POLL; i++) {
-    ts[h].ps[i].pfd.fd = -1;
-    ts[h].psi[i] = -1;
+  ts[h].fd_to_ps.clear();
+  ts[h].free_ps.clear();
+  // popped from the back, so slot 0 is handed out first, to the cmd fd
+  for (i = MAX_POLL - 1; i >= 0; i--) {
+    ts[h].ps[i].fd = -1;
+    ts[h].free_ps.push_back(i);
+  }
+  asrt(ts[h].epoll_fd == -1);
+  ts[h].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (ts[h].epoll_fd == -1) {
+    APPL_TRACE_ERROR("epoll_create1 failed: %s", strerror(errno));
+    return;
   }
   init_cmd_fd(h);
 }
 static inline unsigned int flags2pevents(int flags) {
   unsigned int pevents = 0;
-  if (flags & SOCK_THREAD_FD_WR) pevents |= POLLOUT;
-  if (flags & SOCK_THREAD_FD_RD) pevents |= POLLIN;
+  if (flags & SOCK_THREAD_FD_WR) pevents |= EPOLLOUT;
+  if (flags & SOCK_THREAD_FD_RD) pevents |= EPOLLIN;
   pevents |= POLL_EXCEPTION_EVENTS;
   return pevents;
 }
 
+/* Apply the monitored events of ps to the epoll set. Descriptors are level
+ * triggered: an event stays reported until its flag is cleared from the slot,
+ * which happens as soon as it is delivered, so each SOCK_THREAD_FD_RD/WR
+ * request is signaled once, as the socket handlers expect */
+static inline void update_epoll(int h, poll_slot_t* ps, int op) {
+  struct epoll_event event = {};
+  event.events = flags2pevents(ps->flags);
+  event.data.fd = ps->fd;
+  int ret = epoll_ctl(ts[h].epoll_fd, op, ps->fd, &event);
+  if (ret == -1 && op == EPOLL_CTL_MOD && errno == ENOENT) {
+    // the fd was closed and reused behind our back, register it again
+    ret = epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_ADD, ps->fd, &event);
+  }
+  if (ret == -1)
+    APPL_TRACE_ERROR("epoll_ctl op:%d fd:%d failed: %s", op, ps->fd,
+                     strerror(errno));
+}
+
 static inline void set_poll(poll_slot_t* ps, int fd, int type, int flags,
                             uint32_t user_id) {
-  ps->pfd.fd = fd;
+  ps->fd = fd;
   ps->user_id = user_id;
   if (ps->type != 0 && ps->type != type)
     APPL_TRACE_ERROR(
@@ -362,28 +397,26 @@ static inline void set_poll(poll_slot_t* ps, int fd, int type, int flags,
         ps->type, type);
   ps->type = type;
   ps->flags = flags;
-  ps->pfd.events = flags2pevents(flags);
-  ps->pfd.revents = 0;
 }
 static inline void add_poll(int h, int fd, int type, int flags,
                             uint32_t user_id) {
   asrt(fd != -1);
-  int i;
-  int empty = -1;
   poll_slot_t* ps = ts[h].ps;
 
-  for (i = 0; i < MAX_POLL; i++) {
-    if (ps[i].pfd.fd == fd) {
-      asrt(ts[h].poll_count < MAX_POLL);
-
-      set_poll(&ps[i], fd, type, flags | ps[i].flags, user_id);
-      return;
-    } else if (empty < 0 && ps[i].pfd.fd == -1)
-      empty = i;
+  auto it = ts[h].fd_to_ps.find(fd);
+  if (it != ts[h].fd_to_ps.end()) {
+    int i = it->second;
+    set_poll(&ps[i], fd, type, flags | ps[i].flags, user_id);
+    update_epoll(h, &ps[i], EPOLL_CTL_MOD);
+    return;
   }
-  if (empty >= 0) {
+  if (!ts[h].free_ps.empty()) {
     asrt(ts[h].poll_count < MAX_POLL);
+    int empty = ts[h].free_ps.back();
+    ts[h].free_ps.pop_back();
     set_poll(&ps[empty], fd, type, flags, user_id);
+    ts[h].fd_to_ps[fd] = empty;
+    update_epoll(h, &ps[empty], EPOLL_CTL_ADD);
     ++ts[h].poll_count;
     return;
   }
@@ -392,14 +425,20 @@ static inline void add_poll(int h, int fd, int type, int flags,
 static inline void remove_poll(int h, poll_slot_t* ps, int flags) {
   if (flags == ps->flags) {
     // all monitored events signaled. To remove it, just clear the slot
+    if (epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_DEL, ps->fd, NULL) == -1 &&
+        errno != ENOENT && errno != EBADF)
+      APPL_TRACE_ERROR("epoll_ctl del fd:%d failed: %s", ps->fd,
+                       strerror(errno));
+    ts[h].fd_to_ps.erase(ps->fd);
+    ts[h].free_ps.push_back(ps - ts[h].ps);
     --ts[h].poll_count;
     memset(ps, 0, sizeof(*ps));
-    ps->pfd.fd = -1;
+    ps->fd = -1;
   } else {
     // one read or one write monitor event signaled, removed the accordding bit
     ps->flags &= ~flags;
     // update the poll events mask
-    ps->pfd.events = flags2pevents(ps->flags);
+    update_epoll(h, ps, EPOLL_CTL_MOD);
   }
 }
 static int process_cmd_sock(int h) {
@@ -417,16 +456,15 @@ static int process_cmd_sock(int h) {
     case CMD_ADD_FD:
       add_poll(h, cmd.fd, cmd.type, cmd.flags, cmd.user_id);
       break;
-    case CMD_REMOVE_FD:
-      for (int i = 1; i < MAX_POLL; ++i) {
-        poll_slot_t* poll_slot = &ts[h].ps[i];
-        if (poll_slot->pfd.fd == cmd.fd) {
-          remove_poll(h, poll_slot, poll_slot->flags);
-          break;
-        }
+    case CMD_REMOVE_FD: {
+      auto it = ts[h].fd_to_ps.find(cmd.fd);
+      if (it != ts[h].fd_to_ps.end() && cmd.fd != ts[h].cmd_fdr) {
+        poll_slot_t* poll_slot = &ts[h].ps[it->second];
+        remove_poll(h, poll_slot, poll_slot->flags);
       }
       close(cmd.fd);
       break;
+    }
     case CMD_WAKEUP:
       break;
     case CMD_USER_PRIVATE:
@@ -443,95 +481,66 @@ static int process_cmd_sock(int h) {
   return true;
 }
 
-static void process_data_sock(int h, struct pollfd* pfds, int pfds_count,
-                              int event_count) {
-  asrt(event_count <= pfds_count);
-  int i;
-  for (i = 1; i < pfds_count; i++) {
-    if (pfds[i].revents) {
-      int ps_i = ts[h].psi[i];
-      if (ts[h].ps[ps_i].pfd.fd == -1) {
-        LOG_INFO("Socket has been removed from poll set");
-        continue;
-      }
-      asrt(pfds[i].fd == ts[h].ps[ps_i].pfd.fd);
-      uint32_t user_id = ts[h].ps[ps_i].user_id;
-      int type = ts[h].ps[ps_i].type;
-      int flags = 0;
-      if (IS_READ(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_RD;
-      }
-      if (IS_WRITE(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_WR;
-      }
-      if (IS_EXCEPTION(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_EXCEPTION;
-        // remove the whole slot not flags
-        remove_poll(h, &ts[h].ps[ps_i], ts[h].ps[ps_i].flags);
-      } else if (flags)
-        remove_poll(h, &ts[h].ps[ps_i],
-                    flags);  // remove the monitor flags that already processed
-      if (flags) ts[h].callback(pfds[i].fd, type, flags, user_id);
-    }
+static void process_data_sock(int h, int fd, uint32_t revents) {
+  auto it = ts[h].fd_to_ps.find(fd);
+  if (it == ts[h].fd_to_ps.end()) {
+    LOG_INFO("Socket has been removed from poll set");
+    return;
   }
-}
-
-static void prepare_poll_fds(int h, struct pollfd* pfds) {
-  int count = 0;
-  int ps_i = 0;
-  int pfd_i = 0;
-  asrt(ts[h].poll_count <= MAX_POLL);
-  while (count < ts[h].poll_count) {
-    if (ps_i >= MAX_POLL) {
-      APPL_TRACE_ERROR(
-          "exceed max poll range, ps_i:%d, MAX_POLL:%d, count:%d, "
-          "ts[h].poll_count:%d",
-          ps_i, MAX_POLL, count, ts[h].poll_count);
-      return;
-    }
-    if (ts[h].ps[ps_i].pfd.fd >= 0) {
-      pfds[pfd_i] = ts[h].ps[ps_i].pfd;
-      ts[h].psi[pfd_i] = ps_i;
-      count++;
-      pfd_i++;
-    }
-    ps_i++;
+  poll_slot_t* ps = &ts[h].ps[it->second];
+  uint32_t user_id = ps->user_id;
+  int type = ps->type;
+  int flags = 0;
+  // only report what is still monitored, an earlier event in the same batch
+  // may have cleared it
+  if (IS_READ(revents) && (ps->flags & SOCK_THREAD_FD_RD)) {
+    flags |= SOCK_THREAD_FD_RD;
+  }
+  if (IS_WRITE(revents) && (ps->flags & SOCK_THREAD_FD_WR)) {
+    flags |= SOCK_THREAD_FD_WR;
   }
+  if (IS_EXCEPTION(revents)) {
+    flags |= SOCK_THREAD_FD_EXCEPTION;
+    // remove the whole slot not flags
+    remove_poll(h, ps, ps->flags);
+  } else if (flags)
+    remove_poll(h, ps, flags);  // remove the monitor flags that already processed
+  if (flags) ts[h].callback(fd, type, flags, user_id);
 }
+
 static void* sock_poll_thread(void* arg) {
-  std::array<struct pollfd, MAX_POLL> pfds;
+  std::array<struct epoll_event, MAX_POLL> events;
 
   int h = (intptr_t)arg;
   for (;;) {
-    pfds = {};
-    prepare_poll_fds(h, pfds.data());
     int ret;
-    OSI_NO_INTR(ret = poll(pfds.data(), ts[h].poll_count, -1));
+    OSI_NO_INTR(ret = epoll_wait(ts[h].epoll_fd, events.data(), events.size(),
+                                 -1));
     if (ret == -1) {
-      APPL_TRACE_ERROR("poll ret -1, exit the thread, errno:%d, err:%s", errno,
-                       strerror(errno));
+      APPL_TRACE_ERROR("epoll_wait ret -1, exit the thread, errno:%d, err:%s",
+                       errno, strerror(errno));
       break;
     }
-    if (ret != 0) {
-      int need_process_data_fd = true;
-      int pfds_count = ts[h].poll_count;
-      if (pfds[0].revents)  // cmd fd always is the first one
-      {
-        asrt(pfds[0].fd == ts[h].cmd_fdr);
-        if (!process_cmd_sock(h)) {
-          LOG_INFO("h:%d, process_cmd_sock return false, exit...", h);
-          break;
-        }
-        if (ret == 1)
-          need_process_data_fd = false;
-        else
-          ret--;  // exclude the cmd fd
+    if (ret == 0) {
+      LOG_INFO("no data, epoll_wait ret: %d", ret);
+      continue;
+    }
+    // the cmd fd goes first, so that sockets it removes are not signaled
+    bool exit = false;
+    for (int i = 0; i < ret; i++) {
+      if (events[i].data.fd != ts[h].cmd_fdr) continue;
+      if (!process_cmd_sock(h)) {
+        LOG_INFO("h:%d, process_cmd_sock return false, exit...", h);
+        exit = true;
       }
-      if (need_process_data_fd)
-        process_data_sock(h, pfds.data(), pfds_count, ret);
-    } else {
-      LOG_INFO("no data, select ret: %d", ret);
-    };
+      break;
+    }
+    if (exit) break;
+    // all sockets that became ready are handled in one pass
+    for (int i = 0; i < ret; i++) {
+      if (events[i].data.fd == ts[h].cmd_fdr) continue;
+      process_data_sock(h, events[i].data.fd, events[i].events);
+    }
   }
   LOG_INFO("socket poll thread exiting, h:%d", h);
   return 0;
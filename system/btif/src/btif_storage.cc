@@ -131,12 +131,12 @@ static bool btif_has_ble_keys(const std::string& bdstr);
  *  Static functions
  ******************************************************************************/
 
-static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
-  std::string bdstr;
-  if (remote_bd_addr) {
-    bdstr = remote_bd_addr->ToString();
-  }
+/* Config values of a property, as the (key, value) strings of its section */
+typedef std::vector<std::pair<std::string, std::string>> btif_config_values_t;
 
+static bool prop2cfg_values(const RawAddress* remote_bd_addr,
+                            bt_property_t* prop,
+                            btif_config_values_t* values) {
   char value[1024];
   if (prop->len <= 0 || prop->len > (int)sizeof(value) - 1) {
     LOG_WARN(
@@ -147,8 +147,8 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
   }
   switch (prop->type) {
     case BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP:
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTIME,
-                          (int)time(NULL));
+      values->emplace_back(BTIF_STORAGE_PATH_REMOTE_DEVTIME,
+                           std::to_string((int)time(NULL)));
       break;
     case BT_PROPERTY_BDNAME: {
       int name_length = prop->len > BTM_MAX_LOC_BD_NAME_LEN
@@ -157,36 +157,36 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       strncpy(value, (char*)prop->val, name_length);
       value[name_length] = '\0';
       if (remote_bd_addr) {
-        btif_config_set_str(bdstr, BTIF_STORAGE_PATH_REMOTE_NAME, value);
+        values->emplace_back(BTIF_STORAGE_PATH_REMOTE_NAME, value);
       } else {
-        btif_config_set_str("Adapter", BTIF_STORAGE_KEY_ADAPTER_NAME, value);
+        values->emplace_back(BTIF_STORAGE_KEY_ADAPTER_NAME, value);
       }
       break;
     }
     case BT_PROPERTY_REMOTE_FRIENDLY_NAME:
       strncpy(value, (char*)prop->val, prop->len);
       value[prop->len] = '\0';
-      btif_config_set_str(bdstr, BTIF_STORAGE_PATH_REMOTE_ALIASE, value);
+      values->emplace_back(BTIF_STORAGE_PATH_REMOTE_ALIASE, value);
       break;
     case BT_PROPERTY_ADAPTER_SCAN_MODE:
-      btif_config_set_int("Adapter", BTIF_STORAGE_KEY_ADAPTER_SCANMODE,
-                          *(int*)prop->val);
+      values->emplace_back(BTIF_STORAGE_KEY_ADAPTER_SCANMODE,
+                           std::to_string(*(int*)prop->val));
       break;
     case BT_PROPERTY_LOCAL_IO_CAPS:
-      btif_config_set_int("Adapter", BTIF_STORAGE_KEY_LOCAL_IO_CAPS,
-                          *(int*)prop->val);
+      values->emplace_back(BTIF_STORAGE_KEY_LOCAL_IO_CAPS,
+                           std::to_string(*(int*)prop->val));
       break;
     case BT_PROPERTY_ADAPTER_DISCOVERABLE_TIMEOUT:
-      btif_config_set_int("Adapter", BTIF_STORAGE_KEY_ADAPTER_DISC_TIMEOUT,
-                          *(int*)prop->val);
+      values->emplace_back(BTIF_STORAGE_KEY_ADAPTER_DISC_TIMEOUT,
+                           std::to_string(*(int*)prop->val));
       break;
     case BT_PROPERTY_CLASS_OF_DEVICE:
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVCLASS,
-                          *(int*)prop->val);
+      values->emplace_back(BTIF_STORAGE_PATH_REMOTE_DEVCLASS,
+                           std::to_string(*(int*)prop->val));
       break;
     case BT_PROPERTY_TYPE_OF_DEVICE:
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTYPE,
-                          *(int*)prop->val);
+      values->emplace_back(BTIF_STORAGE_PATH_REMOTE_DEVTYPE,
+                           std::to_string(*(int*)prop->val));
       break;
     case BT_PROPERTY_UUIDS: {
       std::string val;
@@ -194,7 +194,7 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       for (size_t i = 0; i < cnt; i++) {
         val += (reinterpret_cast<Uuid*>(prop->val) + i)->ToString() + " ";
       }
-      btif_config_set_str(bdstr, BTIF_STORAGE_PATH_REMOTE_SERVICE, val);
+      values->emplace_back(BTIF_STORAGE_PATH_REMOTE_SERVICE, std::move(val));
       break;
     }
     case BT_PROPERTY_REMOTE_VERSION_INFO: {
@@ -202,31 +202,35 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
 
       if (!info) return false;
 
-      btif_config_set_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_MFCT,
-                          info->manufacturer);
-      btif_config_set_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_VER, info->version);
-      btif_config_set_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_SUBVER,
-                          info->sub_ver);
+      values->emplace_back(BT_CONFIG_KEY_REMOTE_VER_MFCT,
+                           std::to_string(info->manufacturer));
+      values->emplace_back(BT_CONFIG_KEY_REMOTE_VER_VER,
+                           std::to_string(info->version));
+      values->emplace_back(BT_CONFIG_KEY_REMOTE_VER_SUBVER,
+                           std::to_string(info->sub_ver));
     } break;
     case BT_PROPERTY_APPEARANCE: {
       int val = *(uint16_t*)prop->val;
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_APPEARANCE, val);
+      values->emplace_back(BTIF_STORAGE_PATH_REMOTE_APPEARANCE,
+                           std::to_string(val));
     } break;
     case BT_PROPERTY_VENDOR_PRODUCT_INFO: {
       bt_vendor_product_info_t* info = (bt_vendor_product_info_t*)prop->val;
       if (!info) return false;
 
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_VENDOR_ID_SOURCE,
-                          info->vendor_id_src);
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_VENDOR_ID, info->vendor_id);
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_PRODUCT_ID,
-                          info->product_id);
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_VERSION, info->version);
+      values->emplace_back(BTIF_STORAGE_PATH_VENDOR_ID_SOURCE,
+                           std::to_string(info->vendor_id_src));
+      values->emplace_back(BTIF_STORAGE_PATH_VENDOR_ID,
+                           std::to_string(info->vendor_id));
+      values->emplace_back(BTIF_STORAGE_PATH_PRODUCT_ID,
+                           std::to_string(info->product_id));
+      values->emplace_back(BTIF_STORAGE_PATH_VERSION,
+                           std::to_string(info->version));
     } break;
     case BT_PROPERTY_REMOTE_MODEL_NUM: {
       strncpy(value, (char*)prop->val, prop->len);
       value[prop->len] = '\0';
-      btif_config_set_str(bdstr, BT_CONFIG_KEY_DIS_MODEL_NUM, value);
+      values->emplace_back(BT_CONFIG_KEY_DIS_MODEL_NUM, value);
     } break;
     default:
       BTIF_TRACE_ERROR("Unknown prop type:%d", prop->type);
@@ -236,6 +240,14 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
   return true;
 }
 
+static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
+  btif_config_values_t values;
+  if (!prop2cfg_values(remote_bd_addr, prop, &values)) return false;
+
+  return btif_config_set_strs(
+      remote_bd_addr ? remote_bd_addr->ToString() : "Adapter", values);
+}
+
 static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
   std::string bdstr;
   if (remote_bd_addr) {
@@ -790,10 +802,32 @@ bt_status_t btif_storage_set_remote_device_property(
 bt_status_t btif_storage_add_remote_device(const RawAddress* remote_bd_addr,
                                            uint32_t num_properties,
                                            bt_property_t* properties) {
-  uint32_t i = 0;
-  /* TODO: If writing a property, fails do we go back undo the earlier
-   * written properties? */
-  for (i = 0; i < num_properties; i++) {
+  /* The properties which could not be stored are skipped */
+  btif_storage_set_remote_device_properties(remote_bd_addr, num_properties,
+                                            properties);
+  return BT_STATUS_SUCCESS;
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_storage_set_remote_device_properties
+ *
+ * Description      BTIF storage API - Stores the properties of the remote
+ *                  device to NVRAM at once. The properties that are not
+ *                  stored, like the RSSI, are ignored, and the address is
+ *                  stored as the timestamp of the device.
+ *
+ * Returns          BT_STATUS_SUCCESS if all the properties were stored,
+ *                  BT_STATUS_FAIL otherwise
+ *
+ ******************************************************************************/
+bt_status_t btif_storage_set_remote_device_properties(
+    const RawAddress* remote_bd_addr, uint32_t num_properties,
+    bt_property_t* properties) {
+  btif_config_values_t values;
+  bt_status_t status = BT_STATUS_SUCCESS;
+
+  for (uint32_t i = 0; i < num_properties; i++) {
     /* Ignore properties that are not stored in DB */
     if (properties[i].type == BT_PROPERTY_REMOTE_RSSI ||
         properties[i].type == BT_PROPERTY_REMOTE_IS_COORDINATED_SET_MEMBER ||
@@ -804,16 +838,21 @@ bt_status_t btif_storage_add_remote_device(const RawAddress* remote_bd_addr,
 
     /* address for remote device needs special handling as we also store
      * timestamp */
-    if (properties[i].type == BT_PROPERTY_BDADDR) {
-      bt_property_t addr_prop;
-      memcpy(&addr_prop, &properties[i], sizeof(bt_property_t));
-      addr_prop.type = (bt_property_type_t)BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP;
-      btif_storage_set_remote_device_property(remote_bd_addr, &addr_prop);
-    } else {
-      btif_storage_set_remote_device_property(remote_bd_addr, &properties[i]);
+    bt_property_t prop = properties[i];
+    if (prop.type == BT_PROPERTY_BDADDR) {
+      prop.type = (bt_property_type_t)BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP;
+    }
+    if (!prop2cfg_values(remote_bd_addr, &prop, &values)) {
+      status = BT_STATUS_FAIL;
     }
   }
-  return BT_STATUS_SUCCESS;
+
+  /* Unchanged values are not written again to the config */
+  if (!values.empty() &&
+      !btif_config_set_strs(remote_bd_addr->ToString(), values)) {
+    return BT_STATUS_FAIL;
+  }
+  return status;
 }
 
 /*******************************************************************************
@@ -31,6 +31,7 @@
 #include "btif_common.h"
 #include "common/message_loop_thread.h"
 #include "core_callbacks.h"
+#include "gd/common/startup_trace.h"
 #include "main/shim/shim.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
@@ -253,6 +254,8 @@ static void init_stack_internal(bluetooth::core::CoreInterface* interface) {
   // all callbacks out of libbluetooth-core happen via this interface
   interfaceToProfiles = interface;
 
+  bluetooth::common::ScopedStartupTrace trace("init_stack");
+
   module_management_start();
 
   main_thread_start_up();
@@ -260,8 +263,14 @@ static void init_stack_internal(bluetooth::core::CoreInterface* interface) {
   module_init(get_local_module(DEVICE_IOT_CONFIG_MODULE));
   module_init(get_local_module(OSI_MODULE));
   bte_main_init();
-  module_start_up(get_local_module(GD_SHIM_MODULE));
-  module_init(get_local_module(BTIF_CONFIG_MODULE));
+  {
+    bluetooth::common::ScopedStartupTrace trace("Start gd stack");
+    module_start_up(get_local_module(GD_SHIM_MODULE));
+  }
+  {
+    bluetooth::common::ScopedStartupTrace trace("Init btif config");
+    module_init(get_local_module(BTIF_CONFIG_MODULE));
+  }
   btif_init_bluetooth();
 
   module_init(get_local_module(INTEROP_MODULE));
@@ -312,45 +321,65 @@ static void event_start_up_stack(bluetooth::core::CoreInterface* interface,
   hack_future = local_hack_future;
 
   LOG_INFO("%s Gd shim module enabled", __func__);
-  get_btm_client_interface().lifecycle.btm_init();
-  module_start_up(get_local_module(BTIF_CONFIG_MODULE));
-
-  l2c_init();
-  sdp_init();
-  gatt_init();
-  SMP_Init();
-  get_btm_client_interface().lifecycle.btm_ble_init();
-
-  RFCOMM_Init();
-  GAP_Init();
+  {
+    bluetooth::common::ScopedStartupTrace trace("Init legacy stack");
+    get_btm_client_interface().lifecycle.btm_init();
+    module_start_up(get_local_module(BTIF_CONFIG_MODULE));
+
+    l2c_init();
+    sdp_init();
+    gatt_init();
+    SMP_Init();
+    get_btm_client_interface().lifecycle.btm_ble_init();
+
+    RFCOMM_Init();
+    GAP_Init();
+  }
 
-  startProfiles();
+  {
+    bluetooth::common::ScopedStartupTrace trace("Start profiles");
+    startProfiles();
+  }
 
-  bta_sys_init();
+  {
+    bluetooth::common::ScopedStartupTrace trace("Init bta");
+    bta_sys_init();
 
-  module_init(get_local_module(BTE_LOGMSG_MODULE));
+    module_init(get_local_module(BTE_LOGMSG_MODULE));
 
-  btif_init_ok();
-  BTA_dm_init();
-  bta_dm_enable(bte_dm_evt);
+    btif_init_ok();
+    BTA_dm_init();
+    bta_dm_enable(bte_dm_evt);
+  }
 
   bta_set_forward_hw_failures(true);
   btm_acl_device_down();
-  CHECK(module_start_up(get_local_module(GD_CONTROLLER_MODULE)));
+  {
+    bluetooth::common::ScopedStartupTrace trace("Start legacy controller");
+    CHECK(module_start_up(get_local_module(GD_CONTROLLER_MODULE)));
+  }
   BTM_reset_complete();
 
   BTA_dm_on_hw_on();
 
-  if (future_await(local_hack_future) != FUTURE_SUCCESS) {
-    LOG_ERROR("%s failed to start up the stack", __func__);
-    stack_is_running = true;  // So stack shutdown actually happens
-    event_shut_down_stack(stopProfiles);
-    return;
+  {
+    bluetooth::common::ScopedStartupTrace trace("Wait for btif enable");
+    if (future_await(local_hack_future) != FUTURE_SUCCESS) {
+      LOG_ERROR("%s failed to start up the stack", __func__);
+      bluetooth::common::StartupTrace::Stop();
+      stack_is_running = true;  // So stack shutdown actually happens
+      event_shut_down_stack(stopProfiles);
+      return;
+    }
   }
 
-  module_start_up(get_local_module(RUST_MODULE));
+  {
+    bluetooth::common::ScopedStartupTrace trace("Start rust module");
+    module_start_up(get_local_module(RUST_MODULE));
+  }
 
   stack_is_running = true;
+  bluetooth::common::StartupTrace::Stop();
   LOG_INFO("%s finished", __func__);
   do_in_jni_thread(FROM_HERE, base::Bind(event_signal_stack_up, nullptr));
 }
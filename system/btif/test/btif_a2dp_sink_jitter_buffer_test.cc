@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif/include/btif_a2dp_sink_jitter_buffer.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr size_t kMinDepth = 2;
+constexpr size_t kMaxDepth = 27;
+constexpr size_t kInitialDepth = 5;
+constexpr uint64_t kIntervalUs = 20000;
+constexpr uint64_t kStartUs = 1000000;
+
+class A2dpSinkJitterBufferTest : public ::testing::Test {
+ protected:
+  A2dpSinkJitterBufferTest()
+      : jitter_buffer_(kMinDepth, kMaxDepth, kInitialDepth) {}
+
+  // Feeds |count| packets spaced by |interval_us|, alternating the gaps by
+  // +/- |jitter_us|
+  void FeedPackets(size_t count, uint64_t interval_us, uint64_t jitter_us) {
+    for (size_t i = 0; i < count; i++) {
+      now_us_ += (i % 2) ? interval_us + jitter_us : interval_us - jitter_us;
+      jitter_buffer_.OnPacketArrival(now_us_);
+    }
+  }
+
+  A2dpSinkJitterBuffer jitter_buffer_;
+  uint64_t now_us_ = kStartUs;
+};
+
+TEST_F(A2dpSinkJitterBufferTest, initial_depth_until_jitter_is_known) {
+  ASSERT_EQ(jitter_buffer_.GetTargetDepth(), kInitialDepth);
+  FeedPackets(4, kIntervalUs, 0);
+  ASSERT_EQ(jitter_buffer_.GetTargetDepth(), kInitialDepth);
+  ASSERT_FALSE(jitter_buffer_.IsReadyToPlay(kInitialDepth - 1));
+  ASSERT_TRUE(jitter_buffer_.IsReadyToPlay(kInitialDepth));
+}
+
+TEST_F(A2dpSinkJitterBufferTest, steady_stream_uses_min_depth) {
+  FeedPackets(64, kIntervalUs, 0);
+  ASSERT_EQ(jitter_buffer_.GetMeanIntervalUs(), kIntervalUs);
+  ASSERT_EQ(jitter_buffer_.GetJitterUs(), 0u);
+  ASSERT_EQ(jitter_buffer_.GetTargetDepth(), kMinDepth);
+}
+
+TEST_F(A2dpSinkJitterBufferTest, jittery_stream_gets_deeper) {
+  FeedPackets(256, kIntervalUs, kIntervalUs / 2);
+  // About half an interval of jitter, covered four times
+  ASSERT_GE(jitter_buffer_.GetJitterUs(), kIntervalUs / 4);
+  ASSERT_GE(jitter_buffer_.GetTargetDepth(), 3u);
+  ASSERT_LE(jitter_buffer_.GetTargetDepth(), 4u);
+}
+
+TEST_F(A2dpSinkJitterBufferTest, pauses_are_not_jitter) {
+  FeedPackets(64, kIntervalUs, 0);
+  now_us_ += 2000000;
+  jitter_buffer_.OnPacketArrival(now_us_);
+  FeedPackets(8, kIntervalUs, 0);
+  ASSERT_EQ(jitter_buffer_.GetJitterUs(), 0u);
+}
+
+TEST_F(A2dpSinkJitterBufferTest, decoding_follows_playback) {
+  FeedPackets(64, kIntervalUs, 0);
+  size_t queue_length = kInitialDepth;
+
+  // Half of the target depth is handed to the audio track at start
+  size_t decoded = jitter_buffer_.OnDecodeTick(now_us_, queue_length);
+  ASSERT_EQ(decoded, queue_length - kMinDepth / 2);
+  queue_length -= decoded;
+
+  // One packet played and one received per tick
+  for (int i = 0; i < 10; i++) {
+    now_us_ += kIntervalUs;
+    queue_length++;
+    ASSERT_EQ(jitter_buffer_.OnDecodeTick(now_us_, queue_length), 1u);
+    queue_length--;
+  }
+  ASSERT_EQ(jitter_buffer_.GetUnderrunCount(), 0u);
+}
+
+TEST_F(A2dpSinkJitterBufferTest, latency_drains_to_target) {
+  FeedPackets(64, kIntervalUs, 0);
+  size_t queue_length = kMinDepth;
+  queue_length -= jitter_buffer_.OnDecodeTick(now_us_, queue_length);
+
+  // A burst of late packets is drained one extra packet per tick
+  queue_length += 4;
+  now_us_ += kIntervalUs;
+  ASSERT_EQ(jitter_buffer_.OnDecodeTick(now_us_, queue_length), 2u);
+}
+
+TEST_F(A2dpSinkJitterBufferTest, underrun_deepens_target) {
+  FeedPackets(64, kIntervalUs, 0);
+  size_t queue_length = kMinDepth;
+  queue_length -= jitter_buffer_.OnDecodeTick(now_us_, queue_length);
+
+  // Nothing received for three ticks
+  now_us_ += 3 * kIntervalUs;
+  ASSERT_EQ(jitter_buffer_.OnDecodeTick(now_us_, queue_length), queue_length);
+  ASSERT_EQ(jitter_buffer_.GetUnderrunCount(), 1u);
+  ASSERT_EQ(jitter_buffer_.GetTargetDepth(), kMinDepth + 1);
+
+  // Decoding waits for the queue to refill to the new target
+  now_us_ += kIntervalUs;
+  ASSERT_EQ(jitter_buffer_.OnDecodeTick(now_us_, kMinDepth), 0u);
+  ASSERT_GT(jitter_buffer_.OnDecodeTick(now_us_, kMinDepth + 1), 0u);
+
+  jitter_buffer_.Reset();
+  ASSERT_EQ(jitter_buffer_.GetUnderrunCount(), 0u);
+  ASSERT_EQ(jitter_buffer_.GetTargetDepth(), kInitialDepth);
+}
+
+}  // namespace
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif/include/btif_a2dp_source_abr.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint8_t kMinPercent = 50;
+constexpr uint64_t kIntervalUs = 20000;
+constexpr uint64_t kStartUs = 1000000;
+
+class A2dpSourceAbrTest : public ::testing::Test {
+ protected:
+  A2dpSourceAbrTest() : abr_(kMinPercent) {}
+
+  // Runs |count| encoding rounds with |queue_length| packets in the tx queue,
+  // and returns the number of bit rate changes
+  size_t RunRounds(size_t count, size_t queue_length) {
+    size_t changes = 0;
+    for (size_t i = 0; i < count; i++) {
+      now_us_ += kIntervalUs;
+      if (abr_.OnTxQueueLength(now_us_, queue_length)) changes++;
+    }
+    return changes;
+  }
+
+  A2dpSourceAbr abr_;
+  uint64_t now_us_ = kStartUs;
+};
+
+TEST_F(A2dpSourceAbrTest, short_queue_keeps_full_bitrate) {
+  ASSERT_EQ(RunRounds(500, 1), 0u);
+  ASSERT_EQ(abr_.GetBitratePercent(), 100);
+}
+
+TEST_F(A2dpSourceAbrTest, long_queue_lowers_bitrate_by_steps) {
+  ASSERT_EQ(RunRounds(5, 8), 1u);
+  ASSERT_EQ(abr_.GetBitratePercent(), 90);
+  // The next step waits for the queue to drain
+  ASSERT_EQ(RunRounds(10, 8), 0u);
+  ASSERT_EQ(RunRounds(10, 8), 1u);
+  ASSERT_EQ(abr_.GetBitratePercent(), 80);
+}
+
+TEST_F(A2dpSourceAbrTest, bitrate_stays_above_min) {
+  RunRounds(1000, 8);
+  ASSERT_EQ(abr_.GetBitratePercent(), kMinPercent);
+  ASSERT_FALSE(abr_.OnTxQueueOverflow(now_us_));
+  ASSERT_EQ(abr_.GetBitratePercent(), kMinPercent);
+}
+
+TEST_F(A2dpSourceAbrTest, overflow_lowers_bitrate_at_once) {
+  ASSERT_TRUE(abr_.OnTxQueueOverflow(now_us_));
+  ASSERT_EQ(abr_.GetBitratePercent(), 75);
+  ASSERT_TRUE(abr_.OnTxQueueOverflow(now_us_ + kIntervalUs));
+  ASSERT_EQ(abr_.GetBitratePercent(), 50);
+}
+
+TEST_F(A2dpSourceAbrTest, bitrate_goes_back_up_slowly) {
+  abr_.OnTxQueueOverflow(now_us_);
+  ASSERT_EQ(abr_.GetBitratePercent(), 75);
+  // The smoothed queue length comes down, then stays short 2 seconds
+  ASSERT_EQ(RunRounds(110, 0), 1u);
+  ASSERT_EQ(abr_.GetBitratePercent(), 80);
+  ASSERT_EQ(RunRounds(100, 0), 1u);
+  ASSERT_EQ(abr_.GetBitratePercent(), 85);
+  RunRounds(1000, 0);
+  ASSERT_EQ(abr_.GetBitratePercent(), 100);
+  ASSERT_EQ(abr_.GetIncreaseCount(), 5u);
+}
+
+TEST_F(A2dpSourceAbrTest, medium_queue_holds_bitrate) {
+  abr_.OnTxQueueOverflow(now_us_);
+  ASSERT_EQ(RunRounds(500, 2), 0u);
+  ASSERT_EQ(abr_.GetBitratePercent(), 75);
+}
+
+TEST_F(A2dpSourceAbrTest, failed_contacts_lower_bitrate) {
+  ASSERT_FALSE(abr_.OnFailedContactCounter(now_us_, 10));
+  ASSERT_FALSE(abr_.OnFailedContactCounter(now_us_ + 1, 10));
+  ASSERT_TRUE(abr_.OnFailedContactCounter(now_us_ + 2, 12));
+  ASSERT_EQ(abr_.GetBitratePercent(), 90);
+  // Reset of the counter
+  ASSERT_FALSE(abr_.OnFailedContactCounter(now_us_ + 3, 0));
+}
+
+TEST_F(A2dpSourceAbrTest, weak_rssi_holds_increases) {
+  abr_.OnTxQueueOverflow(now_us_);
+  RunRounds(100, 0);
+  abr_.OnRssi(now_us_, -90);
+  ASSERT_EQ(RunRounds(50, 0), 0u);
+  abr_.OnRssi(now_us_, -50);
+  ASSERT_EQ(RunRounds(50, 0), 1u);
+  ASSERT_EQ(abr_.GetBitratePercent(), 80);
+}
+
+TEST_F(A2dpSourceAbrTest, reset_restores_full_bitrate) {
+  abr_.OnTxQueueOverflow(now_us_);
+  abr_.Reset();
+  ASSERT_EQ(abr_.GetBitratePercent(), 100);
+  ASSERT_EQ(abr_.GetDecreaseCount(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,229 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif/include/btif_hh_report_batch.h"
+
+#include <gtest/gtest.h>
+#include <linux/uhid.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// A pen with a tip switch, a contact identifier and an absolute position
+const std::vector<uint8_t> kPenDescriptor = {
+    0x05, 0x0d,              // Usage Page (Digitizer)
+    0x09, 0x02,              // Usage (Pen)
+    0xa1, 0x01,              // Collection (Application)
+    0x85, 0x01,              //   Report ID (1)
+    0x09, 0x42,              //   Usage (Tip Switch)
+    0x15, 0x00,              //   Logical Minimum (0)
+    0x25, 0x01,              //   Logical Maximum (1)
+    0x75, 0x01,              //   Report Size (1)
+    0x95, 0x01,              //   Report Count (1)
+    0x81, 0x02,              //   Input (Data, Var, Abs)
+    0x75, 0x07,              //   Report Size (7)
+    0x81, 0x03,              //   Input (Const, Var, Abs)
+    0x09, 0x51,              //   Usage (Contact Identifier)
+    0x75, 0x08,              //   Report Size (8)
+    0x81, 0x02,              //   Input (Data, Var, Abs)
+    0x05, 0x01,              //   Usage Page (Generic Desktop)
+    0x09, 0x30,              //   Usage (X)
+    0x09, 0x31,              //   Usage (Y)
+    0x26, 0xff, 0x7f,        //   Logical Maximum (32767)
+    0x75, 0x10,              //   Report Size (16)
+    0x95, 0x02,              //   Report Count (2)
+    0x81, 0x02,              //   Input (Data, Var, Abs)
+    0x85, 0x02,              //   Report ID (2)
+    0x09, 0x30,              //   Usage (X)
+    0x75, 0x10,              //   Report Size (16)
+    0x95, 0x01,              //   Report Count (1)
+    0x81, 0x02,              //   Input (Data, Var, Abs)
+    0xc0,                    // End Collection
+};
+
+// A mouse with three buttons and a relative motion, without report IDs
+const std::vector<uint8_t> kMouseDescriptor = {
+    0x05, 0x01,  // Usage Page (Generic Desktop)
+    0x09, 0x02,  // Usage (Mouse)
+    0xa1, 0x01,  // Collection (Application)
+    0x05, 0x09,  //   Usage Page (Button)
+    0x19, 0x01,  //   Usage Minimum (1)
+    0x29, 0x03,  //   Usage Maximum (3)
+    0x75, 0x01,  //   Report Size (1)
+    0x95, 0x03,  //   Report Count (3)
+    0x81, 0x02,  //   Input (Data, Var, Abs)
+    0x75, 0x05,  //   Report Size (5)
+    0x95, 0x01,  //   Report Count (1)
+    0x81, 0x03,  //   Input (Const, Var, Abs)
+    0x05, 0x01,  //   Usage Page (Generic Desktop)
+    0x09, 0x30,  //   Usage (X)
+    0x09, 0x31,  //   Usage (Y)
+    0x75, 0x08,  //   Report Size (8)
+    0x95, 0x02,  //   Report Count (2)
+    0x81, 0x06,  //   Input (Data, Var, Rel)
+    0xc0,        // End Collection
+};
+
+std::vector<uint8_t> PenReport(uint8_t tip, uint8_t contact, uint16_t x,
+                               uint16_t y) {
+  return {0x01,
+          tip,
+          contact,
+          (uint8_t)(x & 0xff),
+          (uint8_t)(x >> 8),
+          (uint8_t)(y & 0xff),
+          (uint8_t)(y >> 8)};
+}
+
+class BtifHhReportBatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_EQ(0, pipe(fds_)); }
+
+  void TearDown() override {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  void Add(BtifHhReportBatch& batch, const std::vector<uint8_t>& report) {
+    batch.Add(report.data(), report.size());
+  }
+
+  // Flushes |batch| and returns the reports of the UHID_INPUT2 events written
+  std::vector<std::vector<uint8_t>> Flush(BtifHhReportBatch& batch) {
+    EXPECT_EQ(0, batch.Flush(fds_[1]));
+    std::vector<uint8_t> written(UHID_DATA_MAX * 4);
+    ssize_t len = read(fds_[0], written.data(), written.size());
+    EXPECT_GT(len, 0);
+
+    std::vector<std::vector<uint8_t>> reports;
+    size_t offset = 0;
+    while (offset + 6 <= (size_t)len) {
+      __u32 type;
+      __u16 size;
+      memcpy(&type, &written[offset], sizeof(type));
+      memcpy(&size, &written[offset + 4], sizeof(size));
+      EXPECT_EQ((__u32)UHID_INPUT2, type);
+      reports.emplace_back(&written[offset + 6], &written[offset + 6 + size]);
+      offset += 6 + size;
+    }
+    EXPECT_EQ((size_t)len, offset);
+    return reports;
+  }
+
+  int fds_[2];
+};
+
+TEST_F(BtifHhReportBatchTest, writes_pending_reports_in_order) {
+  BtifHhReportBatch batch(kMouseDescriptor.data(), kMouseDescriptor.size(),
+                          true);
+  Add(batch, {0x01, 0x05, 0xfe});
+  Add(batch, {0x01, 0x05, 0xfe});
+  Add(batch, {0x00, 0x02, 0x03});
+  ASSERT_EQ(3u, batch.GetPendingCount());
+
+  auto reports = Flush(batch);
+  ASSERT_EQ(3u, reports.size());
+  ASSERT_EQ(std::vector<uint8_t>({0x01, 0x05, 0xfe}), reports[0]);
+  ASSERT_EQ(std::vector<uint8_t>({0x01, 0x05, 0xfe}), reports[1]);
+  ASSERT_EQ(std::vector<uint8_t>({0x00, 0x02, 0x03}), reports[2]);
+  ASSERT_EQ(0u, batch.GetPendingCount());
+  ASSERT_EQ(1u, batch.GetWriteCount());
+  ASSERT_EQ(0u, batch.GetCoalescedCount());
+}
+
+TEST_F(BtifHhReportBatchTest, coalesces_superseded_positions) {
+  BtifHhReportBatch batch(kPenDescriptor.data(), kPenDescriptor.size(), true);
+  Add(batch, PenReport(1, 0, 100, 200));
+  Add(batch, PenReport(1, 0, 110, 190));
+  Add(batch, PenReport(1, 0, 120, 180));
+
+  auto reports = Flush(batch);
+  ASSERT_EQ(1u, reports.size());
+  ASSERT_EQ(PenReport(1, 0, 120, 180), reports[0]);
+  ASSERT_EQ(2u, batch.GetCoalescedCount());
+  ASSERT_EQ(3u, batch.GetReportCount());
+}
+
+TEST_F(BtifHhReportBatchTest, keeps_state_changes) {
+  BtifHhReportBatch batch(kPenDescriptor.data(), kPenDescriptor.size(), true);
+  Add(batch, PenReport(1, 0, 100, 200));
+  // The tip is lifted
+  Add(batch, PenReport(0, 0, 110, 190));
+  // Another contact
+  Add(batch, PenReport(0, 1, 120, 180));
+
+  auto reports = Flush(batch);
+  ASSERT_EQ(3u, reports.size());
+  ASSERT_EQ(0u, batch.GetCoalescedCount());
+}
+
+TEST_F(BtifHhReportBatchTest, coalesces_per_report_id) {
+  BtifHhReportBatch batch(kPenDescriptor.data(), kPenDescriptor.size(), true);
+  Add(batch, PenReport(1, 0, 100, 200));
+  Add(batch, {0x02, 0x10, 0x00});
+  Add(batch, PenReport(1, 0, 110, 190));
+
+  auto reports = Flush(batch);
+  ASSERT_EQ(2u, reports.size());
+  ASSERT_EQ(std::vector<uint8_t>({0x02, 0x10, 0x00}), reports[0]);
+  ASSERT_EQ(PenReport(1, 0, 110, 190), reports[1]);
+}
+
+TEST_F(BtifHhReportBatchTest, does_not_coalesce_relative_motion) {
+  BtifHhReportBatch batch(kMouseDescriptor.data(), kMouseDescriptor.size(),
+                          true);
+  Add(batch, {0x00, 0x01, 0x01});
+  Add(batch, {0x00, 0x02, 0x02});
+
+  ASSERT_EQ(2u, Flush(batch).size());
+  ASSERT_EQ(0u, batch.GetCoalescedCount());
+}
+
+TEST_F(BtifHhReportBatchTest, coalescing_disabled) {
+  BtifHhReportBatch batch(kPenDescriptor.data(), kPenDescriptor.size(), false);
+  Add(batch, PenReport(1, 0, 100, 200));
+  Add(batch, PenReport(1, 0, 110, 190));
+
+  ASSERT_EQ(2u, Flush(batch).size());
+  ASSERT_EQ(0u, batch.GetCoalescedCount());
+}
+
+TEST_F(BtifHhReportBatchTest, truncated_descriptor) {
+  for (size_t len = 0; len < kPenDescriptor.size(); len++) {
+    BtifHhReportBatch batch(kPenDescriptor.data(), len, true);
+    Add(batch, PenReport(1, 0, 100, 200));
+    Add(batch, PenReport(1, 0, 110, 190));
+    ASSERT_LE(batch.GetPendingCount(), 2u);
+    batch.Flush(fds_[1]);
+    std::vector<uint8_t> drain(UHID_DATA_MAX);
+    read(fds_[0], drain.data(), drain.size());
+  }
+}
+
+TEST_F(BtifHhReportBatchTest, flush_error) {
+  BtifHhReportBatch batch(kMouseDescriptor.data(), kMouseDescriptor.size(),
+                          true);
+  Add(batch, {0x00, 0x01, 0x01});
+  ASSERT_EQ(-EBADF, batch.Flush(-1));
+  ASSERT_EQ(0u, batch.GetPendingCount());
+}
+
+}  // namespace
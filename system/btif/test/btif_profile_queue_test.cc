@@ -22,7 +22,11 @@
 #include <base/location.h>
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "btif/include/stack_manager.h"
+#include "device/include/interop.h"
+#include "stack/include/sdpdefs.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
 
@@ -41,6 +45,11 @@ bt_status_t do_in_jni_thread(const base::Location& from_here,
   return BT_STATUS_SUCCESS;
 }
 bool is_on_jni_thread() { return true; }
+static bool sInteropMatch;
+bool interop_match_addr(const interop_feature_t feature,
+                        const RawAddress* addr) {
+  return sInteropMatch;
+}
 
 enum ResultType {
   NOT_SET = 0,
@@ -63,6 +72,7 @@ class BtifProfileQueueTest : public ::testing::Test {
  protected:
   void SetUp() override {
     sStackRunning = true;
+    sInteropMatch = false;
     sResult = NOT_SET;
   };
   void TearDown() override { btif_queue_release(); };
@@ -263,3 +273,72 @@ TEST_F(BtifProfileQueueTest, test_cleanup_both_reverse_order) {
   btif_queue_connect_next();
   EXPECT_EQ(sResult, NOT_SET);
 }
+
+static std::vector<uint16_t> sConnectedUuids;
+
+static bt_status_t test_connect_cb_record(RawAddress* bda, uint16_t uuid) {
+  sConnectedUuids.push_back(uuid);
+  return BT_STATUS_SUCCESS;
+}
+
+TEST_F(BtifProfileQueueTest, test_independent_profiles_connect_concurrently) {
+  sConnectedUuids.clear();
+  btif_queue_connect(UUID_SERVCLASS_AG_HANDSFREE, &kTestAddr1,
+                     test_connect_cb_record);
+  btif_queue_connect(UUID_SERVCLASS_AUDIO_SOURCE, &kTestAddr1,
+                     test_connect_cb_record);
+  EXPECT_EQ(sConnectedUuids,
+            std::vector<uint16_t>(
+                {UUID_SERVCLASS_AG_HANDSFREE, UUID_SERVCLASS_AUDIO_SOURCE}));
+  // They can finish in any order
+  btif_queue_advance_by_uuid(UUID_SERVCLASS_AUDIO_SOURCE, &kTestAddr1);
+  btif_queue_advance_by_uuid(UUID_SERVCLASS_AG_HANDSFREE, &kTestAddr1);
+  EXPECT_EQ(btif_queue_connect_next(), BT_STATUS_FAIL);
+}
+
+TEST_F(BtifProfileQueueTest, test_same_profile_keeps_order) {
+  sConnectedUuids.clear();
+  btif_queue_connect(UUID_SERVCLASS_AUDIO_SOURCE, &kTestAddr1,
+                     test_connect_cb_record);
+  btif_queue_connect(UUID_SERVCLASS_AUDIO_SOURCE, &kTestAddr2,
+                     test_connect_cb_record);
+  btif_queue_connect(UUID_SERVCLASS_AG_HANDSFREE, &kTestAddr2,
+                     test_connect_cb_record);
+  // The second A2DP connection waits for the first one
+  EXPECT_EQ(sConnectedUuids,
+            std::vector<uint16_t>(
+                {UUID_SERVCLASS_AUDIO_SOURCE, UUID_SERVCLASS_AG_HANDSFREE}));
+  btif_queue_advance_by_uuid(UUID_SERVCLASS_AUDIO_SOURCE, &kTestAddr1);
+  EXPECT_EQ(sConnectedUuids.size(), 3u);
+  EXPECT_EQ(sConnectedUuids.back(), UUID_SERVCLASS_AUDIO_SOURCE);
+}
+
+TEST_F(BtifProfileQueueTest, test_other_profiles_are_serialized) {
+  sConnectedUuids.clear();
+  btif_queue_connect(UUID_SERVCLASS_AG_HANDSFREE, &kTestAddr1,
+                     test_connect_cb_record);
+  btif_queue_connect(kTestUuid1, &kTestAddr1, test_connect_cb_record);
+  btif_queue_connect(UUID_SERVCLASS_AUDIO_SOURCE, &kTestAddr1,
+                     test_connect_cb_record);
+  // Nothing runs along or after a profile with unknown dependencies
+  EXPECT_EQ(sConnectedUuids,
+            std::vector<uint16_t>({UUID_SERVCLASS_AG_HANDSFREE}));
+  btif_queue_advance_by_uuid(UUID_SERVCLASS_AG_HANDSFREE, &kTestAddr1);
+  EXPECT_EQ(sConnectedUuids,
+            std::vector<uint16_t>({UUID_SERVCLASS_AG_HANDSFREE, kTestUuid1}));
+  btif_queue_advance_by_uuid(kTestUuid1, &kTestAddr1);
+  EXPECT_EQ(sConnectedUuids.back(), UUID_SERVCLASS_AUDIO_SOURCE);
+}
+
+TEST_F(BtifProfileQueueTest, test_interop_device_is_serialized) {
+  sConnectedUuids.clear();
+  sInteropMatch = true;
+  btif_queue_connect(UUID_SERVCLASS_AG_HANDSFREE, &kTestAddr1,
+                     test_connect_cb_record);
+  btif_queue_connect(UUID_SERVCLASS_AUDIO_SOURCE, &kTestAddr1,
+                     test_connect_cb_record);
+  EXPECT_EQ(sConnectedUuids,
+            std::vector<uint16_t>({UUID_SERVCLASS_AG_HANDSFREE}));
+  btif_queue_advance_by_uuid(UUID_SERVCLASS_AG_HANDSFREE, &kTestAddr1);
+  EXPECT_EQ(sConnectedUuids.back(), UUID_SERVCLASS_AUDIO_SOURCE);
+}
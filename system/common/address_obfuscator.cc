@@ -29,6 +29,8 @@
 namespace bluetooth {
 namespace common {
 
+const size_t AddressObfuscator::kMaxNumCachedAddresses = 200;
+
 bool AddressObfuscator::IsSaltValid(const Octet32& salt_256bit) {
   return !std::all_of(salt_256bit.begin(), salt_256bit.end(),
                       [](uint8_t i) { return i == 0; });
@@ -36,6 +38,9 @@ bool AddressObfuscator::IsSaltValid(const Octet32& salt_256bit) {
 
 void AddressObfuscator::Initialize(const Octet32& salt_256bit) {
   std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
+  if (salt_256bit_ != salt_256bit) {
+    obfuscated_addresses_.Clear();
+  }
   salt_256bit_ = salt_256bit;
 }
 
@@ -47,13 +52,19 @@ bool AddressObfuscator::IsInitialized() {
 std::string AddressObfuscator::Obfuscate(const RawAddress& address) {
   std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
   CHECK(IsInitialized());
+  std::string cached;
+  if (obfuscated_addresses_.Get(address, &cached)) {
+    return cached;
+  }
   std::array<uint8_t, EVP_MAX_MD_SIZE> result = {};
   unsigned int out_len = 0;
   CHECK(::HMAC(EVP_sha256(), salt_256bit_.data(), salt_256bit_.size(),
                address.address, address.kLength, result.data(),
                &out_len) != nullptr);
   CHECK_EQ(out_len, static_cast<unsigned int>(kOctet32Length));
-  return std::string(reinterpret_cast<const char*>(result.data()), out_len);
+  std::string obfuscated(reinterpret_cast<const char*>(result.data()), out_len);
+  obfuscated_addresses_.Put(address, obfuscated);
+  return obfuscated;
 }
 
 }  // namespace common
@@ -22,6 +22,7 @@
 #include <mutex>
 #include <string>
 
+#include "lru.h"
 #include "raw_address.h"
 
 namespace bluetooth {
@@ -30,6 +31,7 @@ namespace common {
 class AddressObfuscator {
  public:
   static constexpr unsigned int kOctet32Length = 32;
+  static const size_t kMaxNumCachedAddresses;
   using Octet32 = std::array<uint8_t, kOctet32Length>;
   static AddressObfuscator* GetInstance() {
     static auto instance = new AddressObfuscator();
@@ -47,7 +49,8 @@ class AddressObfuscator {
   static bool IsSaltValid(const Octet32& salt_256bit);
 
   /**
-   * Initialize this obfuscator with necessary parameters
+   * Initialize this obfuscator with necessary parameters, the cached
+   * obfuscated addresses are dropped if the salt changed
    *
    * @param salt_256bit a 256 bit salt used to hash the fixed length address
    */
@@ -59,7 +62,8 @@ class AddressObfuscator {
   bool IsInitialized();
 
   /**
-   * Obfuscate Bluetooth MAC address into an anonymous ID string
+   * Obfuscate Bluetooth MAC address into an anonymous ID string, the result
+   * of the last kMaxNumCachedAddresses addresses is cached
    *
    * @param address Bluetooth MAC address to be obfuscated
    * @return the obfuscated MAC address in 256 bit
@@ -67,8 +71,12 @@ class AddressObfuscator {
   std::string Obfuscate(const RawAddress& address);
 
  private:
-  AddressObfuscator() : salt_256bit_({0}) {}
+  AddressObfuscator()
+      : salt_256bit_({0}),
+        obfuscated_addresses_(kMaxNumCachedAddresses,
+                              "bt_address_obfuscator") {}
   Octet32 salt_256bit_;
+  LegacyLruCache<RawAddress, std::string> obfuscated_addresses_;
   std::recursive_mutex instance_mutex_;
 };
 
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/logging.h>
+#include <benchmark/benchmark.h>
+
+#include <future>
+#include <memory>
+#include <thread>
+
+#include "osi/include/fixed_queue.h"
+#include "osi/include/thread.h"
+
+using ::benchmark::State;
+
+#define NUM_MESSAGES_TO_SEND 100000
+#define RING_CAPACITY 1024
+
+static int g_counter = 0;
+static std::unique_ptr<std::promise<void>> g_counter_promise = nullptr;
+
+// Drains as many messages as are available, like the stack queue consumers.
+static void callback_batch(fixed_queue_t* queue, void* data) {
+  CHECK_NE(queue, nullptr);
+  int dequeued = 0;
+  while (fixed_queue_try_dequeue(queue) != nullptr) {
+    dequeued++;
+  }
+  g_counter += dequeued;
+  if (dequeued > 0 && g_counter >= NUM_MESSAGES_TO_SEND) {
+    g_counter_promise->set_value();
+  }
+}
+
+// range(0) selects the queue: 0 for the list queue, 1 for the ring queue.
+class BM_FixedQueue : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    benchmark::Fixture::SetUp(st);
+    g_counter = 0;
+    queue_ = st.range(0) ? fixed_queue_new_ring(RING_CAPACITY)
+                         : fixed_queue_new(RING_CAPACITY);
+    thread_ = thread_new("BM_FixedQueue thread");
+  }
+  void TearDown(State& st) override {
+    thread_free(thread_);
+    thread_ = nullptr;
+    fixed_queue_free(queue_, nullptr);
+    queue_ = nullptr;
+    g_counter_promise.reset(nullptr);
+    benchmark::Fixture::TearDown(st);
+  }
+  fixed_queue_t* queue_ = nullptr;
+  thread_t* thread_ = nullptr;
+};
+
+BENCHMARK_DEFINE_F(BM_FixedQueue, blocking_enqueue_dequeue)(State& state) {
+  for (auto _ : state) {
+    std::thread producer([this]() {
+      for (int i = 0; i < NUM_MESSAGES_TO_SEND; i++) {
+        fixed_queue_enqueue(queue_, (void*)&g_counter);
+      }
+    });
+    for (int i = 0; i < NUM_MESSAGES_TO_SEND; i++) {
+      fixed_queue_dequeue(queue_);
+    }
+    producer.join();
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_MESSAGES_TO_SEND);
+}
+
+BENCHMARK_DEFINE_F(BM_FixedQueue, reactor_enqueue_dequeue)(State& state) {
+  for (auto _ : state) {
+    g_counter = 0;
+    g_counter_promise = std::make_unique<std::promise<void>>();
+    std::future<void> counter_future = g_counter_promise->get_future();
+    fixed_queue_register_dequeue(queue_, thread_get_reactor(thread_),
+                                 callback_batch, nullptr);
+    for (int i = 0; i < NUM_MESSAGES_TO_SEND; i++) {
+      fixed_queue_enqueue(queue_, (void*)&g_counter);
+    }
+    counter_future.wait();
+    fixed_queue_unregister_dequeue(queue_);
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_MESSAGES_TO_SEND);
+}
+
+BENCHMARK_REGISTER_F(BM_FixedQueue, blocking_enqueue_dequeue)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(BM_FixedQueue, reactor_enqueue_dequeue)->Arg(0)->Arg(1);
+
+int main(int argc, char** argv) {
+  // Disable LOG() output from libchrome
+  logging::LoggingSettings log_settings;
+  log_settings.logging_dest = logging::LoggingDestination::LOG_NONE;
+  CHECK(logging::InitLogging(log_settings)) << "Failed to set up logging";
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
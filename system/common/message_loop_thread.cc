@@ -18,13 +18,19 @@
 
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
+#include <sched.h>
+#include <stdio.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <iterator>
 #include <thread>
+#include <vector>
 
 #include "gd/common/init_flags.h"
 #include "osi/include/log.h"
+#include "osi/include/properties.h"
 
 namespace bluetooth {
 
@@ -32,6 +38,63 @@ namespace common {
 
 static constexpr int kRealTimeFifoSchedulingPriority = 1;
 
+// Upper bounds of the task profile histogram buckets, the last bucket has the
+// longer times
+static constexpr int64_t kTaskProfileBucketLimitsUs[] = {1000, 5000, 20000,
+                                                         100000, 500000};
+static constexpr const char* kTaskProfileBucketNames[] = {
+    "<1ms", "<5ms", "<20ms", "<100ms", "<500ms", ">=500ms"};
+// Number of locations with the slowest tasks in the dump
+static constexpr size_t kTaskProfileMaxLocations = 10;
+
+static const char kThreadPolicyPropertyPrefix[] = "persist.bluetooth.thread.";
+
+// Parse a list of CPUs such as "0,2" or "4-7" into |cpus|
+static bool parse_cpu_list(const std::string& list, cpu_set_t* cpus) {
+  CPU_ZERO(cpus);
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) end = list.size();
+    std::string range = list.substr(pos, end - pos);
+    int first = 0;
+    int last = 0;
+    char extra = 0;
+    if (sscanf(range.c_str(), "%d-%d%c", &first, &last, &extra) != 2) {
+      if (sscanf(range.c_str(), "%d%c", &first, &extra) != 1) return false;
+      last = first;
+    }
+    if (first < 0 || last < first || last >= CPU_SETSIZE) return false;
+    for (int cpu = first; cpu <= last; cpu++) CPU_SET(cpu, cpus);
+    pos = end + 1;
+  }
+  return CPU_COUNT(cpus) > 0;
+}
+
+static const char* sched_policy_text(int policy) {
+  switch (policy) {
+    case SCHED_OTHER:
+      return "SCHED_OTHER";
+    case SCHED_FIFO:
+      return "SCHED_FIFO";
+    case SCHED_RR:
+      return "SCHED_RR";
+    default:
+      return "unknown";
+  }
+}
+
+static size_t task_profile_bucket(int64_t time_us) {
+  size_t bucket = 0;
+  for (int64_t limit_us : kTaskProfileBucketLimitsUs) {
+    if (time_us < limit_us) {
+      break;
+    }
+    bucket++;
+  }
+  return bucket;
+}
+
 MessageLoopThread::MessageLoopThread(const std::string& thread_name)
     : MessageLoopThread(thread_name, false) {}
 
@@ -45,7 +108,8 @@ MessageLoopThread::MessageLoopThread(const std::string& thread_name,
       linux_tid_(-1),
       weak_ptr_factory_(this),
       shutting_down_(false),
-      is_main_(is_main) {}
+      is_main_(is_main),
+      task_profiling_enabled_(false) {}
 
 MessageLoopThread::~MessageLoopThread() { ShutDown(); }
 
@@ -80,6 +144,13 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                << ", from " << from_here.ToString();
     return false;
   }
+  if (task_profiling_enabled_.load(std::memory_order_relaxed)) {
+    auto ready_time = std::chrono::steady_clock::now() +
+                      std::chrono::microseconds(delay.InMicroseconds());
+    task = base::BindOnce(&MessageLoopThread::RunProfiledTask,
+                          base::Unretained(this), from_here, ready_time,
+                          std::move(task));
+  }
   if (!message_loop_->task_runner()->PostDelayedTask(from_here, std::move(task),
                                                      delay)) {
     LOG(ERROR) << __func__
@@ -172,6 +243,161 @@ bool MessageLoopThread::EnableRealTimeScheduling() {
   return true;
 }
 
+bool MessageLoopThread::ApplySchedulingPolicy(bool realtime) {
+  std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+
+  const std::string prefix = kThreadPolicyPropertyPrefix + thread_name_;
+  bool success = true;
+  if (osi_property_get_bool((prefix + ".realtime").c_str(), realtime)) {
+    success = EnableRealTimeScheduling();
+  }
+
+  char cpu_list[PROPERTY_VALUE_MAX] = "";
+  if (osi_property_get((prefix + ".cpus").c_str(), cpu_list, "") > 0) {
+    cpu_set_t cpus;
+    if (!parse_cpu_list(cpu_list, &cpus)) {
+      LOG(ERROR) << __func__ << ": invalid list of CPUs \"" << cpu_list
+                 << "\" for thread " << *this;
+    } else if (sched_setaffinity(linux_tid_, sizeof(cpus), &cpus) != 0) {
+      LOG(ERROR) << __func__ << ": unable to set the CPU affinity "
+                 << cpu_list << " for linux_tid "
+                 << std::to_string(linux_tid_) << ", thread " << *this
+                 << ", error: " << strerror(errno);
+    }
+  }
+
+  if (osi_property_get_bool((prefix + ".task_profiling").c_str(), false)) {
+    EnableTaskProfiling(true);
+  }
+  return success;
+}
+
+void MessageLoopThread::DumpScheduling(int fd) const {
+  {
+    std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+    dprintf(fd, "\nScheduling of %s:\n", thread_name_.c_str());
+    if (linux_tid_ == -1) {
+      dprintf(fd, "  Not running\n");
+      return;
+    }
+    int policy = sched_getscheduler(linux_tid_);
+    struct sched_param params = {};
+    sched_getparam(linux_tid_, &params);
+    dprintf(fd, "  Policy: %s, priority: %d\n", sched_policy_text(policy),
+            params.sched_priority);
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(linux_tid_, sizeof(cpus), &cpus) == 0) {
+      std::string cpu_list;
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &cpus)) continue;
+        if (!cpu_list.empty()) cpu_list += ",";
+        cpu_list += std::to_string(cpu);
+      }
+      dprintf(fd, "  CPUs: %s\n", cpu_list.c_str());
+    }
+  }
+  DumpTaskProfile(fd);
+}
+
+void MessageLoopThread::EnableTaskProfiling(bool enable) {
+  std::lock_guard<std::mutex> lock(task_profile_mutex_);
+  if (enable && !task_profiling_enabled_) {
+    task_site_profiles_.clear();
+    task_queue_histogram_ = {};
+    task_run_histogram_ = {};
+    task_profile_start_ = std::chrono::steady_clock::now();
+  }
+  task_profiling_enabled_ = enable;
+}
+
+void MessageLoopThread::RunProfiledTask(
+    const base::Location& from_here,
+    std::chrono::steady_clock::time_point ready_time, base::OnceClosure task) {
+  auto start_time = std::chrono::steady_clock::now();
+  std::move(task).Run();
+  auto end_time = std::chrono::steady_clock::now();
+
+  int64_t queue_us = std::max<int64_t>(
+      0, std::chrono::duration_cast<std::chrono::microseconds>(start_time -
+                                                               ready_time)
+             .count());
+  int64_t run_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                       end_time - start_time)
+                       .count();
+
+  std::lock_guard<std::mutex> lock(task_profile_mutex_);
+  task_queue_histogram_[task_profile_bucket(queue_us)]++;
+  task_run_histogram_[task_profile_bucket(run_us)]++;
+  auto& site = task_site_profiles_[std::make_pair(from_here.file_name(),
+                                                  from_here.line_number())];
+  if (site.count == 0) {
+    site.location = from_here.ToString();
+  }
+  site.count++;
+  site.total_queue_us += queue_us;
+  site.max_queue_us = std::max(site.max_queue_us, queue_us);
+  site.total_run_us += run_us;
+  site.max_run_us = std::max(site.max_run_us, run_us);
+}
+
+void MessageLoopThread::DumpTaskProfile(int fd) const {
+  static_assert(std::size(kTaskProfileBucketLimitsUs) + 1 ==
+                kTaskProfileNumBuckets);
+  static_assert(std::size(kTaskProfileBucketNames) == kTaskProfileNumBuckets);
+
+  std::lock_guard<std::mutex> lock(task_profile_mutex_);
+  dprintf(fd, "\nTask profile of %s:\n", thread_name_.c_str());
+  if (task_profile_start_ == std::chrono::steady_clock::time_point{}) {
+    dprintf(fd, "  Never enabled\n");
+    return;
+  }
+  dprintf(fd, "  %s, started %lld s ago\n",
+          task_profiling_enabled_ ? "Enabled" : "Disabled",
+          static_cast<long long>(
+              std::chrono::duration_cast<std::chrono::seconds>(
+                  std::chrono::steady_clock::now() - task_profile_start_)
+                  .count()));
+
+  dprintf(fd, "  %-12s", "");
+  for (const char* bucket_name : kTaskProfileBucketNames) {
+    dprintf(fd, " %9s", bucket_name);
+  }
+  auto dump_histogram = [fd](const char* name,
+                             const TaskProfileHistogram& histogram) {
+    dprintf(fd, "\n  %-12s", name);
+    for (uint64_t count : histogram) {
+      dprintf(fd, " %9llu", static_cast<unsigned long long>(count));
+    }
+  };
+  dump_histogram("queue delay", task_queue_histogram_);
+  dump_histogram("run time", task_run_histogram_);
+  dprintf(fd, "\n");
+
+  std::vector<const TaskSiteProfile*> sites;
+  for (const auto& entry : task_site_profiles_) {
+    sites.push_back(&entry.second);
+  }
+  size_t num_sites = std::min(sites.size(), kTaskProfileMaxLocations);
+  std::partial_sort(sites.begin(), sites.begin() + num_sites, sites.end(),
+                    [](const TaskSiteProfile* a, const TaskSiteProfile* b) {
+                      return a->max_run_us > b->max_run_us;
+                    });
+  dprintf(fd, "  Slowest locations:\n");
+  dprintf(fd, "  %8s %12s %12s %12s %12s  %s\n", "count", "avg run us",
+          "max run us", "avg queue us", "max queue us", "location");
+  for (size_t i = 0; i < num_sites; i++) {
+    const TaskSiteProfile* site = sites[i];
+    dprintf(fd, "  %8llu %12lld %12lld %12lld %12lld  %s\n",
+            static_cast<unsigned long long>(site->count),
+            static_cast<long long>(site->total_run_us / site->count),
+            static_cast<long long>(site->max_run_us),
+            static_cast<long long>(site->total_queue_us / site->count),
+            static_cast<long long>(site->max_queue_us),
+            site->location.c_str());
+  }
+}
+
 base::WeakPtr<MessageLoopThread> MessageLoopThread::GetWeakPtr() {
   std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
   return weak_ptr_factory_.GetWeakPtr();
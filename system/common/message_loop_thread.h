@@ -22,10 +22,16 @@
 #include <base/threading/platform_thread.h>
 #include <unistd.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <utility>
 
 #include "abstract_message_loop.h"
 
@@ -125,6 +131,28 @@ class MessageLoopThread final {
    */
   bool EnableRealTimeScheduling();
 
+  /**
+   * Apply the scheduling policy configured for this thread, by thread name:
+   * persist.bluetooth.thread.<name>.realtime enables real time scheduling,
+   * persist.bluetooth.thread.<name>.cpus restricts the thread to a list of
+   * CPUs such as "4-7" or "0,2" and
+   * persist.bluetooth.thread.<name>.task_profiling enables task profiling.
+   *
+   * @param realtime whether to enable real time scheduling when it is not
+   * configured
+   * @return false if real time scheduling is enabled and could not be set,
+   * true otherwise
+   */
+  bool ApplySchedulingPolicy(bool realtime);
+
+  /**
+   * Dump the scheduling policy and CPU affinity of this thread, followed by
+   * its task profile, which has the scheduling latency of its tasks
+   *
+   * @param fd file descriptor to dump to
+   */
+  void DumpScheduling(int fd) const;
+
   /**
    * Return the weak pointer to this object. This can be useful when posting
    * delayed tasks to this MessageLoopThread using Timer.
@@ -168,7 +196,37 @@ class MessageLoopThread final {
   bool DoInThreadDelayed(const base::Location& from_here,
                          base::OnceClosure task, const base::TimeDelta& delay);
 
+  /**
+   * Start or stop recording how long the tasks posted from here on wait in
+   * the queue and run, per location they are posted from. Starting clears
+   * what was recorded before. When stopped, posting a task only costs one
+   * more atomic load.
+   *
+   * @param enable true to start recording, false to stop
+   */
+  void EnableTaskProfiling(bool enable);
+
+  /**
+   * Dump the histograms of the queueing delay and run time of the tasks, and
+   * the locations with the slowest tasks
+   *
+   * @param fd file descriptor to dump to
+   */
+  void DumpTaskProfile(int fd) const;
+
  private:
+  // Task times recorded for one location
+  struct TaskSiteProfile {
+    std::string location;
+    uint64_t count = 0;
+    int64_t total_queue_us = 0;
+    int64_t max_queue_us = 0;
+    int64_t total_run_us = 0;
+    int64_t max_run_us = 0;
+  };
+  static constexpr size_t kTaskProfileNumBuckets = 6;
+  using TaskProfileHistogram = std::array<uint64_t, kTaskProfileNumBuckets>;
+
   /**
    * Static method to run the thread
    *
@@ -189,6 +247,17 @@ class MessageLoopThread final {
    */
   void Run(std::promise<void> start_up_promise);
 
+  /**
+   * Run a task posted while task profiling was enabled and record its times
+   *
+   * @param from_here location where this task is originated
+   * @param ready_time when the task was due to run
+   * @param task the task to run
+   */
+  void RunProfiledTask(const base::Location& from_here,
+                       std::chrono::steady_clock::time_point ready_time,
+                       base::OnceClosure task);
+
   mutable std::recursive_mutex api_mutex_;
   const std::string thread_name_;
   btbase::AbstractMessageLoop* message_loop_;
@@ -200,6 +269,14 @@ class MessageLoopThread final {
   base::WeakPtrFactory<MessageLoopThread> weak_ptr_factory_;
   bool shutting_down_;
   bool is_main_;
+
+  std::atomic_bool task_profiling_enabled_;
+  mutable std::mutex task_profile_mutex_;
+  // Keyed by the file name and line number of the location
+  std::map<std::pair<const char*, int>, TaskSiteProfile> task_site_profiles_;
+  TaskProfileHistogram task_queue_histogram_ = {};
+  TaskProfileHistogram task_run_histogram_ = {};
+  std::chrono::steady_clock::time_point task_profile_start_;
 };
 
 inline std::ostream& operator<<(std::ostream& os,
@@ -328,3 +328,67 @@ TEST_F(MessageLoopThreadTest, shut_down_start_up_multi_thread) {
   auto thread = std::thread(&MessageLoopThread::StartUp, &message_loop_thread);
   thread.join();
 }
+
+// Verify the slow tasks show up in the task profile
+TEST_F(MessageLoopThreadTest, task_profile) {
+  std::string name = "test_thread";
+  MessageLoopThread message_loop_thread(name);
+  message_loop_thread.StartUp();
+  message_loop_thread.EnableTaskProfiling(true);
+  std::promise<std::string> name_promise;
+  std::future<std::string> name_future = name_promise.get_future();
+  uint32_t delay_ms = 5;
+  message_loop_thread.DoInThread(
+      FROM_HERE, base::BindOnce(&MessageLoopThreadTest::SleepAndGetName,
+                                base::Unretained(this), std::move(name_promise),
+                                delay_ms));
+  ASSERT_EQ(name, name_future.get());
+  // Wait for the profiled task to be recorded
+  std::promise<void> execution_promise;
+  std::future<void> execution_future = execution_promise.get_future();
+  message_loop_thread.DoInThread(
+      FROM_HERE,
+      base::BindOnce([](std::promise<void> promise) { promise.set_value(); },
+                     std::move(execution_promise)));
+  execution_future.wait();
+  message_loop_thread.ShutDown();
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  message_loop_thread.DumpTaskProfile(fds[1]);
+  close(fds[1]);
+  std::string dump;
+  char buffer[256];
+  ssize_t len;
+  while ((len = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    dump.append(buffer, len);
+  }
+  close(fds[0]);
+  LOG(INFO) << dump;
+  ASSERT_NE(dump.find("Enabled"), std::string::npos);
+  ASSERT_NE(dump.find("message_loop_thread_unittest.cc"), std::string::npos);
+}
+
+TEST_F(MessageLoopThreadTest, scheduling_policy) {
+  std::string name = "test_thread";
+  MessageLoopThread message_loop_thread(name);
+  message_loop_thread.StartUp();
+  // Nothing is configured for the thread
+  ASSERT_TRUE(message_loop_thread.ApplySchedulingPolicy(false));
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  message_loop_thread.DumpScheduling(fds[1]);
+  close(fds[1]);
+  std::string dump;
+  char buffer[256];
+  ssize_t len;
+  while ((len = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    dump.append(buffer, len);
+  }
+  close(fds[0]);
+  message_loop_thread.ShutDown();
+  LOG(INFO) << dump;
+  ASSERT_NE(dump.find("SCHED_OTHER"), std::string::npos);
+  ASSERT_NE(dump.find("CPUs: "), std::string::npos);
+}
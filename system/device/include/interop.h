@@ -327,6 +327,11 @@ typedef enum {
   INTEROP_DISABLE_ROBUST_CACHING,
 
   INTEROP_HFP_1_7_ALLOWLIST,
+
+  // Some LE devices disconnect or stall after a PHY or data length update
+  // they did not ask for. Keep them out of the traffic based upgrade to the
+  // 2M PHY and maximum data length.
+  INTEROP_DISABLE_LE_AUTO_LINK_UPGRADE,
   END_OF_INTEROP_LIST
 } interop_feature_t;
 
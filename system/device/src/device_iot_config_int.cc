@@ -237,6 +237,10 @@ void device_iot_config_save_async(void) {
   CHECK(config != NULL);
   CHECK(config_timer != NULL);
 
+  // The counters change often, so the changes are written together once the
+  // pending save fires, rather than pushing that save back on each of them.
+  if (alarm_is_scheduled(config_timer)) return;
+
   LOG_VERBOSE("");
   alarm_set(config_timer, CONFIG_SETTLE_PERIOD_MS,
             device_iot_config_timer_save_cb, NULL);
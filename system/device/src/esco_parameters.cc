@@ -288,11 +288,12 @@ enh_esco_params_t esco_parameters_for_codec(esco_codec_t codec, bool offload) {
   CHECK(codec >= 0) << "codec index " << (int)codec << "< 0";
   CHECK(codec < ESCO_NUM_CODECS)
       << "codec index " << (int)codec << " > " << ESCO_NUM_CODECS;
+  enh_esco_params_t param = default_esco_parameters[codec];
+  param.coding_format = param.transmit_coding_format.coding_format;
   if (offload) {
-    return default_esco_parameters[codec];
+    return param;
   }
 
-  enh_esco_params_t param = default_esco_parameters[codec];
   param.input_data_path = param.output_data_path = ESCO_DATA_PATH_HCI;
 
   if (codec >= ESCO_CODEC_MSBC_T1) {
@@ -32,10 +32,13 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "bt_types.h"
 #include "btcore/include/module.h"
@@ -175,9 +178,46 @@ typedef struct {
 
 } interop_db_entry_t;
 
+// Index of the entries of interop_list, guarded by interop_list_lock, so that
+// a lookup only compares the entries that can match instead of going through
+// the whole list. The value of the key is:
+// - the length and bytes of the address prefix for INTEROP_BL_TYPE_ADDR,
+// - the OUI for INTEROP_BL_TYPE_SSR_MAX_LAT and INTEROP_BL_TYPE_LMP_VERSION,
+// - the length and hash of the lower case name for INTEROP_BL_TYPE_NAME,
+// - the ids or the version for the other types.
+// The address ranges are only grouped by feature.
+typedef struct {
+  interop_bl_type bl_type;
+  uint16_t feature;
+  uint64_t value;
+} interop_index_key_t;
+
+static bool operator==(const interop_index_key_t& a,
+                       const interop_index_key_t& b) {
+  return a.bl_type == b.bl_type && a.feature == b.feature &&
+         a.value == b.value;
+}
+
+typedef struct {
+  size_t operator()(const interop_index_key_t& key) const {
+    return std::hash<uint64_t>()(key.value ^
+                                 ((uint64_t)key.bl_type << 56) ^
+                                 ((uint64_t)key.feature << 40));
+  }
+} interop_index_key_hash_t;
+
+static std::unordered_multimap<interop_index_key_t, interop_db_entry_t*,
+                               interop_index_key_hash_t>
+    interop_index;
+// Lengths of the names of each feature, with their number of entries
+static std::map<uint16_t, std::map<size_t, size_t>> interop_name_lengths;
+static std::map<uint16_t, std::vector<interop_db_entry_t*>>
+    interop_addr_ranges;
+
 static const char* interop_feature_string_(const interop_feature_t feature);
 static void interop_free_entry_(void* data);
 static void interop_lazy_init_(void);
+static void interop_index_clear_();
 
 // Config related functions
 static void interop_config_cleanup(void);
@@ -294,6 +334,7 @@ static future_t* interop_init(void) {
 
 static future_t* interop_clean_up(void) {
   pthread_mutex_lock(&interop_list_lock);
+  interop_index_clear_();
   list_free(interop_list);
   interop_list = NULL;
   list_free(media_player_list);
@@ -379,6 +420,7 @@ static const char* interop_feature_string_(const interop_feature_t feature) {
     CASE_RETURN_STR(INTEROP_AVRCP_1_3_ONLY)
     CASE_RETURN_STR(INTEROP_DISABLE_ROBUST_CACHING);
     CASE_RETURN_STR(INTEROP_HFP_1_7_ALLOWLIST);
+    CASE_RETURN_STR(INTEROP_DISABLE_LE_AUTO_LINK_UPGRADE);
   }
   return UNKNOWN_INTEROP_FEATURE;
 }
@@ -388,6 +430,140 @@ static void interop_free_entry_(void* data) {
   osi_free(entry);
 }
 
+static uint16_t interop_entry_feature_(const interop_db_entry_t* entry) {
+  switch (entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR:
+      return entry->entry_type.addr_entry.feature;
+    case INTEROP_BL_TYPE_NAME:
+      return entry->entry_type.name_entry.feature;
+    case INTEROP_BL_TYPE_MANUFACTURE:
+      return entry->entry_type.mnfr_entry.feature;
+    case INTEROP_BL_TYPE_VNDR_PRDT:
+      return entry->entry_type.vnr_pdt_entry.feature;
+    case INTEROP_BL_TYPE_SSR_MAX_LAT:
+      return entry->entry_type.ssr_max_lat_entry.feature;
+    case INTEROP_BL_TYPE_VERSION:
+      return entry->entry_type.version_entry.feature;
+    case INTEROP_BL_TYPE_LMP_VERSION:
+      return entry->entry_type.lmp_version_entry.feature;
+    case INTEROP_BL_TYPE_ADDR_RANGE:
+      return entry->entry_type.addr_range_entry.feature;
+  }
+  return END_OF_INTEROP_LIST;
+}
+
+static uint64_t interop_addr_key_(const RawAddress& addr, size_t length) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < length && i < sizeof(RawAddress); i++) {
+    value = (value << 8) | addr.address[i];
+  }
+  return ((uint64_t)length << 48) | value;
+}
+
+// FNV-1a hash of the first |length| characters of |name|, in lower case, as
+// names are matched on a case insensitive prefix.
+static uint64_t interop_name_key_(const char* name, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint8_t)tolower((unsigned char)name[i]);
+    hash *= 16777619u;
+  }
+  return ((uint64_t)length << 32) | hash;
+}
+
+// Key of |entry| in interop_index, false for the address ranges.
+static bool interop_index_key_(const interop_db_entry_t* entry,
+                               interop_index_key_t* key) {
+  key->bl_type = entry->bl_type;
+  key->feature = interop_entry_feature_(entry);
+  switch (entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR:
+      key->value = interop_addr_key_(entry->entry_type.addr_entry.addr,
+                                     entry->entry_type.addr_entry.length);
+      return true;
+    case INTEROP_BL_TYPE_NAME: {
+      const char* name = entry->entry_type.name_entry.name;
+      key->value = interop_name_key_(
+          name, strnlen(name, sizeof(entry->entry_type.name_entry.name)));
+      return true;
+    }
+    case INTEROP_BL_TYPE_MANUFACTURE:
+      key->value = entry->entry_type.mnfr_entry.manufacturer;
+      return true;
+    case INTEROP_BL_TYPE_VNDR_PRDT:
+      key->value = ((uint64_t)entry->entry_type.vnr_pdt_entry.vendor_id << 16) |
+                   entry->entry_type.vnr_pdt_entry.product_id;
+      return true;
+    case INTEROP_BL_TYPE_SSR_MAX_LAT:
+      key->value =
+          interop_addr_key_(entry->entry_type.ssr_max_lat_entry.addr, 3);
+      return true;
+    case INTEROP_BL_TYPE_VERSION:
+      key->value = entry->entry_type.version_entry.version;
+      return true;
+    case INTEROP_BL_TYPE_LMP_VERSION:
+      key->value =
+          interop_addr_key_(entry->entry_type.lmp_version_entry.addr, 3);
+      return true;
+    case INTEROP_BL_TYPE_ADDR_RANGE:
+      return false;
+  }
+  return false;
+}
+
+// Must be called with interop_list_lock held.
+static void interop_index_add_(interop_db_entry_t* entry) {
+  const uint16_t feature = interop_entry_feature_(entry);
+  if (entry->bl_type == INTEROP_BL_TYPE_ADDR_RANGE) {
+    interop_addr_ranges[feature].push_back(entry);
+    return;
+  }
+
+  interop_index_key_t key;
+  if (!interop_index_key_(entry, &key)) return;
+  interop_index.emplace(key, entry);
+  if (entry->bl_type == INTEROP_BL_TYPE_NAME) {
+    interop_name_lengths[feature][key.value >> 32]++;
+  }
+}
+
+// Must be called with interop_list_lock held, before freeing |entry|.
+static void interop_index_remove_(interop_db_entry_t* entry) {
+  const uint16_t feature = interop_entry_feature_(entry);
+  if (entry->bl_type == INTEROP_BL_TYPE_ADDR_RANGE) {
+    auto ranges = interop_addr_ranges.find(feature);
+    if (ranges == interop_addr_ranges.end()) return;
+    auto& entries = ranges->second;
+    entries.erase(std::remove(entries.begin(), entries.end(), entry),
+                  entries.end());
+    if (entries.empty()) interop_addr_ranges.erase(ranges);
+    return;
+  }
+
+  interop_index_key_t key;
+  if (!interop_index_key_(entry, &key)) return;
+  auto range = interop_index.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second != entry) continue;
+    interop_index.erase(it);
+    if (entry->bl_type == INTEROP_BL_TYPE_NAME) {
+      auto& lengths = interop_name_lengths[feature];
+      auto length = lengths.find(key.value >> 32);
+      if (length != lengths.end() && --length->second == 0) {
+        lengths.erase(length);
+      }
+      if (lengths.empty()) interop_name_lengths.erase(feature);
+    }
+    return;
+  }
+}
+
+static void interop_index_clear_() {
+  interop_index.clear();
+  interop_name_lengths.clear();
+  interop_addr_ranges.clear();
+}
+
 static void interop_lazy_init_(void) {
   pthread_mutex_init(&interop_list_lock, NULL);
   if (interop_list == NULL) {
@@ -618,6 +794,7 @@ static void interop_database_add_(interop_db_entry_t* db_entry, bool persist) {
 
   if (interop_list) {
     list_append(interop_list, db_entry);
+    interop_index_add_(db_entry);
   }
 
   pthread_mutex_unlock(&interop_list_lock);
@@ -630,137 +807,184 @@ static void interop_database_add_(interop_db_entry_t* db_entry, bool persist) {
   interop_config_add_or_remove(db_entry, true);
 }
 
-static bool interop_database_match(interop_db_entry_t* entry,
-                                   interop_db_entry_t** ret_entry,
-                                   interop_entry_type entry_type) {
-  CHECK(entry);
+// Compares |entry| with the entry |db_entry| of the database, of the same
+// type.
+static bool interop_entry_match_(interop_db_entry_t* entry,
+                                 const interop_db_entry_t* db_entry) {
   bool found = false;
-  pthread_mutex_lock(&interop_list_lock);
-  if (interop_list == NULL || list_length(interop_list) == 0) {
-    pthread_mutex_unlock(&interop_list_lock);
-    return false;
-  }
-
-  const list_node_t* node = list_begin(interop_list);
-
-  while (node != list_end(interop_list)) {
-    interop_db_entry_t* db_entry = (interop_db_entry_t*)list_node(node);
-    CHECK(db_entry);
-
-    if (entry->bl_type != db_entry->bl_type) {
-      node = list_next(node);
-      continue;
+  switch (db_entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR: {
+      interop_addr_entry_t* src = &entry->entry_type.addr_entry;
+      const interop_addr_entry_t* cur = &db_entry->entry_type.addr_entry;
+      if ((src->feature == cur->feature) &&
+          (!memcmp(&src->addr, &cur->addr, cur->length))) {
+        /* cur len is used to remove src entry from config file, when
+         * interop_database_remove_addr is called. */
+        src->length = cur->length;
+        found = true;
+      }
+      break;
     }
+    case INTEROP_BL_TYPE_NAME: {
+      interop_name_entry_t* src = &entry->entry_type.name_entry;
+      const interop_name_entry_t* cur = &db_entry->entry_type.name_entry;
 
-    if ((entry_type == INTEROP_ENTRY_TYPE_STATIC) ||
-        (entry_type == INTEROP_ENTRY_TYPE_DYNAMIC)) {
-      if (entry->bl_entry_type != db_entry->bl_entry_type) {
-        node = list_next(node);
-        continue;
+      if ((src->feature == cur->feature) &&
+          (strcasestr(src->name, cur->name) == src->name)) {
+        found = true;
       }
+      break;
     }
+    case INTEROP_BL_TYPE_MANUFACTURE: {
+      interop_manufacturer_t* src = &entry->entry_type.mnfr_entry;
+      const interop_manufacturer_t* cur = &db_entry->entry_type.mnfr_entry;
 
-    switch (db_entry->bl_type) {
-      case INTEROP_BL_TYPE_ADDR: {
-        interop_addr_entry_t* src = &entry->entry_type.addr_entry;
-        interop_addr_entry_t* cur = &db_entry->entry_type.addr_entry;
-        if ((src->feature == cur->feature) &&
-            (!memcmp(&src->addr, &cur->addr, cur->length))) {
-          /* cur len is used to remove src entry from config file, when
-           * interop_database_remove_addr is called. */
-          src->length = cur->length;
-          found = true;
-        }
-        break;
+      if (src->feature == cur->feature &&
+          src->manufacturer == cur->manufacturer) {
+        found = true;
+      }
+      break;
+    }
+    case INTEROP_BL_TYPE_VNDR_PRDT: {
+      interop_hid_multitouch_t* src = &entry->entry_type.vnr_pdt_entry;
+      const interop_hid_multitouch_t* cur =
+          &db_entry->entry_type.vnr_pdt_entry;
+
+      if ((src->feature == cur->feature) &&
+          (src->vendor_id == cur->vendor_id) &&
+          (src->product_id == cur->product_id)) {
+        found = true;
       }
-      case INTEROP_BL_TYPE_NAME: {
-        interop_name_entry_t* src = &entry->entry_type.name_entry;
-        interop_name_entry_t* cur = &db_entry->entry_type.name_entry;
+      break;
+    }
+    case INTEROP_BL_TYPE_SSR_MAX_LAT: {
+      interop_hid_ssr_max_lat_t* src = &entry->entry_type.ssr_max_lat_entry;
+      const interop_hid_ssr_max_lat_t* cur =
+          &db_entry->entry_type.ssr_max_lat_entry;
 
-        if ((src->feature == cur->feature) &&
-            (strcasestr(src->name, cur->name) == src->name)) {
-          found = true;
-        }
-        break;
+      if ((src->feature == cur->feature) &&
+          !memcmp(&src->addr, &cur->addr, 3)) {
+        found = true;
       }
-      case INTEROP_BL_TYPE_MANUFACTURE: {
-        interop_manufacturer_t* src = &entry->entry_type.mnfr_entry;
-        interop_manufacturer_t* cur = &db_entry->entry_type.mnfr_entry;
+      break;
+    }
+    case INTEROP_BL_TYPE_VERSION: {
+      interop_version_t* src = &entry->entry_type.version_entry;
+      const interop_version_t* cur = &db_entry->entry_type.version_entry;
 
-        if (src->feature == cur->feature &&
-            src->manufacturer == cur->manufacturer) {
-          found = true;
-        }
-        break;
+      if ((src->feature == cur->feature) && (src->version == cur->version)) {
+        found = true;
       }
-      case INTEROP_BL_TYPE_VNDR_PRDT: {
-        interop_hid_multitouch_t* src = &entry->entry_type.vnr_pdt_entry;
-        interop_hid_multitouch_t* cur = &db_entry->entry_type.vnr_pdt_entry;
-
-        if ((src->feature == cur->feature) &&
-            (src->vendor_id == cur->vendor_id) &&
-            (src->product_id == cur->product_id)) {
-          found = true;
-        }
-        break;
+      break;
+    }
+    case INTEROP_BL_TYPE_LMP_VERSION: {
+      interop_lmp_version_t* src = &entry->entry_type.lmp_version_entry;
+      const interop_lmp_version_t* cur =
+          &db_entry->entry_type.lmp_version_entry;
+
+      if ((src->feature == cur->feature) &&
+          (!memcmp(&src->addr, &cur->addr, 3))) {
+        found = true;
       }
-      case INTEROP_BL_TYPE_SSR_MAX_LAT: {
-        interop_hid_ssr_max_lat_t* src = &entry->entry_type.ssr_max_lat_entry;
-        interop_hid_ssr_max_lat_t* cur =
-            &db_entry->entry_type.ssr_max_lat_entry;
-
-        if ((src->feature == cur->feature) &&
-            !memcmp(&src->addr, &cur->addr, 3)) {
-          found = true;
-        }
-        break;
+      break;
+    }
+    case INTEROP_BL_TYPE_ADDR_RANGE: {
+      interop_addr_range_entry_t* src = &entry->entry_type.addr_range_entry;
+      const interop_addr_range_entry_t* cur =
+          &db_entry->entry_type.addr_range_entry;
+
+      // src->addr_start has the actual address, which need to be searched in
+      // the range
+      if ((src->feature == cur->feature) &&
+          (src->addr_start >= cur->addr_start) &&
+          (src->addr_start <= cur->addr_end)) {
+        found = true;
       }
-      case INTEROP_BL_TYPE_VERSION: {
-        interop_version_t* src = &entry->entry_type.version_entry;
-        interop_version_t* cur = &db_entry->entry_type.version_entry;
+      break;
+    }
+    default:
+      LOG_ERROR("bl_type: %d not handled", db_entry->bl_type);
+      break;
+  }
+  return found;
+}
 
-        if ((src->feature == cur->feature) && (src->version == cur->version)) {
-          found = true;
-        }
-        break;
-      }
-      case INTEROP_BL_TYPE_LMP_VERSION: {
-        interop_lmp_version_t* src = &entry->entry_type.lmp_version_entry;
-        interop_lmp_version_t* cur = &db_entry->entry_type.lmp_version_entry;
+static bool interop_database_match(interop_db_entry_t* entry,
+                                   interop_db_entry_t** ret_entry,
+                                   interop_entry_type entry_type) {
+  CHECK(entry);
+  interop_db_entry_t* found_entry = NULL;
+  pthread_mutex_lock(&interop_list_lock);
+  if (interop_list == NULL || list_length(interop_list) == 0) {
+    pthread_mutex_unlock(&interop_list_lock);
+    return false;
+  }
 
-        if ((src->feature == cur->feature) &&
-            (!memcmp(&src->addr, &cur->addr, 3))) {
-          found = true;
+  auto check_entry = [&](interop_db_entry_t* db_entry) {
+    if ((entry_type == INTEROP_ENTRY_TYPE_STATIC) ||
+        (entry_type == INTEROP_ENTRY_TYPE_DYNAMIC)) {
+      if (entry->bl_entry_type != db_entry->bl_entry_type) return false;
+    }
+    if (!interop_entry_match_(entry, db_entry)) return false;
+    found_entry = db_entry;
+    return true;
+  };
+  auto check_key = [&](const interop_index_key_t& key) {
+    auto range = interop_index.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (check_entry(it->second)) return true;
+    }
+    return false;
+  };
+
+  // Only the entries of the index with the keys that can match are compared
+  const uint16_t feature = interop_entry_feature_(entry);
+  switch (entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR: {
+      const RawAddress& addr = entry->entry_type.addr_entry.addr;
+      for (size_t length = 0; length <= sizeof(RawAddress); length++) {
+        if (check_key({INTEROP_BL_TYPE_ADDR, feature,
+                       interop_addr_key_(addr, length)})) {
+          break;
         }
-        break;
       }
-      case INTEROP_BL_TYPE_ADDR_RANGE: {
-        interop_addr_range_entry_t* src = &entry->entry_type.addr_range_entry;
-        interop_addr_range_entry_t* cur =
-            &db_entry->entry_type.addr_range_entry;
-
-        // src->addr_start has the actual address, which need to be searched in
-        // the range
-        if ((src->feature == cur->feature) &&
-            (src->addr_start >= cur->addr_start) &&
-            (src->addr_start <= cur->addr_end)) {
-          found = true;
+      break;
+    }
+    case INTEROP_BL_TYPE_NAME: {
+      auto lengths = interop_name_lengths.find(feature);
+      if (lengths == interop_name_lengths.end()) break;
+      const char* name = entry->entry_type.name_entry.name;
+      size_t name_length =
+          strnlen(name, sizeof(entry->entry_type.name_entry.name));
+      for (const auto& length : lengths->second) {
+        if (length.first > name_length) break;
+        if (check_key({INTEROP_BL_TYPE_NAME, feature,
+                       interop_name_key_(name, length.first)})) {
+          break;
         }
-        break;
       }
-      default:
-        LOG_ERROR("bl_type: %d not handled", db_entry->bl_type);
-        break;
+      break;
+    }
+    case INTEROP_BL_TYPE_ADDR_RANGE: {
+      auto ranges = interop_addr_ranges.find(feature);
+      if (ranges == interop_addr_ranges.end()) break;
+      for (interop_db_entry_t* db_entry : ranges->second) {
+        if (check_entry(db_entry)) break;
+      }
+      break;
     }
-
-    if (found && ret_entry) {
-      *ret_entry = db_entry;
+    default: {
+      interop_index_key_t key;
+      if (interop_index_key_(entry, &key)) check_key(key);
       break;
     }
-    node = list_next(node);
+  }
+
+  if (found_entry && ret_entry) {
+    *ret_entry = found_entry;
   }
   pthread_mutex_unlock(&interop_list_lock);
-  return found;
+  return found_entry != NULL;
 }
 
 static bool interop_database_remove_(interop_db_entry_t* entry) {
@@ -775,6 +999,7 @@ static bool interop_database_remove_(interop_db_entry_t* entry) {
 
   // first remove it from linked list
   pthread_mutex_lock(&interop_list_lock);
+  interop_index_remove_(ret_entry);
   list_remove(interop_list, (void*)ret_entry);
   pthread_mutex_unlock(&interop_list_lock);
 
@@ -1563,6 +1788,7 @@ bool interop_database_remove_feature(const interop_feature_t feature) {
 
     if (entry_match) {
       pthread_mutex_lock(&interop_list_lock);
+      interop_index_remove_(entry);
       list_remove(interop_list, (void*)entry);
       pthread_mutex_unlock(&interop_list_lock);
     }
@@ -1260,6 +1260,42 @@ TEST_F(DeviceIotConfigTest, test_device_iot_config_set_int) {
   test::mock::osi_alarm::alarm_set.body = {};
 }
 
+TEST_F(DeviceIotConfigTest, test_device_iot_config_set_int_save_pending) {
+  std::string string_return_value = "123";
+  bool is_scheduled = false;
+
+  test::mock::osi_config::config_get_string.body =
+      [&](const config_t& config, const std::string& section,
+          const std::string& key,
+          const std::string* def_value) { return &string_return_value; };
+
+  test::mock::osi_alarm::alarm_is_scheduled.body =
+      [&](const alarm_t* alarm) -> bool { return is_scheduled; };
+
+  {
+    reset_mock_function_count_map();
+
+    EXPECT_TRUE(device_iot_config_set_int("abc", "def", 1));
+
+    EXPECT_EQ(get_func_call_count("config_set_string"), 1);
+    EXPECT_EQ(get_func_call_count("alarm_set"), 1);
+  }
+
+  {
+    reset_mock_function_count_map();
+
+    is_scheduled = true;
+
+    EXPECT_TRUE(device_iot_config_set_int("abc", "def", 2));
+
+    EXPECT_EQ(get_func_call_count("config_set_string"), 1);
+    EXPECT_EQ(get_func_call_count("alarm_set"), 0);
+  }
+
+  test::mock::osi_config::config_get_string.body = {};
+  test::mock::osi_alarm::alarm_is_scheduled.body = {};
+}
+
 TEST_F(DeviceIotConfigTest, test_device_iot_config_addr_set_int) {
   const RawAddress peer_addr{};
   std::string actual_key, expected_key = "def";
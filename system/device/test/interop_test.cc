@@ -834,3 +834,30 @@ TEST_F(InteropTest, test_dynamic_did_version) {
 
   module_clean_up(&interop_module);
 }
+
+TEST_F(InteropTest, test_dynamic_index_update) {
+  module_init(&interop_module);
+
+  RawAddress test_address;
+  RawAddress::FromString("11:22:33:44:55:66", test_address);
+  RawAddress other_address;
+  RawAddress::FromString("11:22:33:45:55:66", other_address);
+
+  interop_database_add_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address, 4);
+  EXPECT_TRUE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+  EXPECT_FALSE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &other_address));
+
+  // Names match on a case insensitive prefix
+  interop_database_add_name(INTEROP_AUTO_RETRY_PAIRING, "Test Headset");
+  EXPECT_TRUE(
+      interop_match_name(INTEROP_AUTO_RETRY_PAIRING, "TEST HEADSET Pro"));
+  EXPECT_FALSE(interop_match_name(INTEROP_AUTO_RETRY_PAIRING, "Test Head"));
+
+  EXPECT_TRUE(
+      interop_database_remove_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+  EXPECT_FALSE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+  EXPECT_TRUE(interop_database_remove_feature(INTEROP_AUTO_RETRY_PAIRING));
+  EXPECT_FALSE(interop_match_name(INTEROP_AUTO_RETRY_PAIRING, "Test Headset"));
+
+  module_clean_up(&interop_module);
+}
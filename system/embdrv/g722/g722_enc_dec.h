@@ -93,8 +93,9 @@ typedef struct
     /*! 6 for 48000kbps, 7 for 56000kbps, or 8 for 64000kbps. */
     int bits_per_sample;
 
-    /*! Signal history for the QMF */
-    int x[24];
+    /*! Signal history for the QMF, kept as the 16 bit input samples so that
+        the filter can be run on packed vectors */
+    int16_t x[24];
 
     g722_band_t band[2];
 
@@ -32,6 +32,12 @@
 #include "g722_typedefs.h"
 #include "g722_enc_dec.h"
 
+#if __SSE2__
+#include <emmintrin.h>
+#elif __ARM_NEON
+#include <arm_neon.h>
+#endif
+
 #if !defined(FALSE)
 #define FALSE 0
 #endif
@@ -259,15 +265,82 @@ static int16_t qm2[4] =
 {
     -7408,  -1616,   7408,   1616
 };
-static int16_t qmf_coeffs[12] =
+/* The QMF taps {3, -11, 12, 32, -210, 951, 3876, -805, 362, -156, 53, -11}
+   applied to the samples of the history, the i-th tap to x[2*i] and the
+   (11 - i)-th to x[2*i + 1]. The sum of the two gives the low band and
+   their difference the high band, so the even samples have their taps
+   negated for the high band. */
+static const int16_t qmf_coeffs_low[24] =
+{
+       3,  -11,  -11,   53,   12, -156,   32,  362, -210, -805,  951, 3876,
+    3876,  951, -805, -210,  362,   32, -156,   12,   53,  -11,  -11,    3,
+};
+static const int16_t qmf_coeffs_high[24] =
 {
-       3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
+      -3,  -11,   11,   53,  -12, -156,  -32,  362,  210, -805, -951, 3876,
+   -3876,  951,  805, -210, -362,   32,  156,   12,  -53,  -11,   11,    3,
 };
 static int16_t ihn[3] = {0, 1, 0};
 static int16_t ihp[3] = {0, 3, 2};
 static int16_t wh[3] = {0, -214, 798};
 static int16_t rh2[4] = {2, 1, 2, 1};
 
+/* Runs the transmit QMF on the 24 samples of history. The products are
+   exact 32 bit integers, so the vector versions give the same result as
+   the scalar one. */
+static __inline void qmf_analysis(const int16_t x[24], int *xlow, int *xhigh)
+{
+#if __SSE2__
+    __m128i x0 = _mm_loadu_si128((const __m128i *) &x[0]);
+    __m128i x1 = _mm_loadu_si128((const __m128i *) &x[8]);
+    __m128i x2 = _mm_loadu_si128((const __m128i *) &x[16]);
+    __m128i low = _mm_add_epi32(
+        _mm_add_epi32(
+            _mm_madd_epi16(x0, _mm_loadu_si128((const __m128i *) &qmf_coeffs_low[0])),
+            _mm_madd_epi16(x1, _mm_loadu_si128((const __m128i *) &qmf_coeffs_low[8]))),
+        _mm_madd_epi16(x2, _mm_loadu_si128((const __m128i *) &qmf_coeffs_low[16])));
+    __m128i high = _mm_add_epi32(
+        _mm_add_epi32(
+            _mm_madd_epi16(x0, _mm_loadu_si128((const __m128i *) &qmf_coeffs_high[0])),
+            _mm_madd_epi16(x1, _mm_loadu_si128((const __m128i *) &qmf_coeffs_high[8]))),
+        _mm_madd_epi16(x2, _mm_loadu_si128((const __m128i *) &qmf_coeffs_high[16])));
+    /* Sum the 4 lanes of both, the low band in lane 0 and the high in 1 */
+    __m128i sums = _mm_add_epi32(_mm_unpacklo_epi32(low, high),
+                                 _mm_unpackhi_epi32(low, high));
+    sums = _mm_add_epi32(sums, _mm_srli_si128(sums, 8));
+    *xlow = _mm_cvtsi128_si32(sums) >> 14;
+    *xhigh = _mm_cvtsi128_si32(_mm_srli_si128(sums, 4)) >> 14;
+#elif __ARM_NEON
+    int32x4_t low = vdupq_n_s32(0);
+    int32x4_t high = vdupq_n_s32(0);
+    for (int i = 0;  i < 24;  i += 8)
+    {
+        int16x8_t xi = vld1q_s16(&x[i]);
+        int16x8_t cl = vld1q_s16(&qmf_coeffs_low[i]);
+        int16x8_t ch = vld1q_s16(&qmf_coeffs_high[i]);
+        low = vmlal_s16(low, vget_low_s16(xi), vget_low_s16(cl));
+        low = vmlal_s16(low, vget_high_s16(xi), vget_high_s16(cl));
+        high = vmlal_s16(high, vget_low_s16(xi), vget_low_s16(ch));
+        high = vmlal_s16(high, vget_high_s16(xi), vget_high_s16(ch));
+    }
+    int32x2_t sums = vpadd_s32(vadd_s32(vget_low_s32(low), vget_high_s32(low)),
+                               vadd_s32(vget_low_s32(high), vget_high_s32(high)));
+    *xlow = vget_lane_s32(sums, 0) >> 14;
+    *xhigh = vget_lane_s32(sums, 1) >> 14;
+#else
+    int sumlow = 0;
+    int sumhigh = 0;
+    for (int i = 0;  i < 24;  i++)
+    {
+        sumlow += x[i]*qmf_coeffs_low[i];
+        sumhigh += x[i]*qmf_coeffs_high[i];
+    }
+    *xlow = sumlow >> 14;
+    *xhigh = sumhigh >> 14;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
 int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
                        const int16_t amp[], int len)
 {
@@ -289,9 +362,6 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     int xlow;
     int xhigh;
     int g722_bytes;
-    /* Even and odd tap accumulators */
-    int sumeven;
-    int sumodd;
     int ihigh;
     int ilow;
     int code;
@@ -310,25 +380,16 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
             {
                 /* Apply the transmit QMF */
                 /* Shuffle the buffer down */
-                for (i = 0;  i < 22;  i++)
-                    s->x[i] = s->x[i + 2];
+                memmove(&s->x[0], &s->x[2], 22*sizeof(s->x[0]));
                 //TODO: if len is odd, then this can be a buffer overrun
                 s->x[22] = amp[j++];
                 s->x[23] = amp[j++];
     
-                /* Discard every other QMF output */
-                sumeven = 0;
-                sumodd = 0;
-                for (i = 0;  i < 12;  i++)
-                {
-                    sumodd += s->x[2*i]*qmf_coeffs[i];
-                    sumeven += s->x[2*i + 1]*qmf_coeffs[11 - i];
-                }
-                /* We shift by 12 to allow for the QMF filters (DC gain = 4096), plus 1
-                   to allow for us summing two filters, plus 1 to allow for the 15 bit
-                   input to the G.722 algorithm. */
-                xlow = (sumeven + sumodd) >> 14;
-                xhigh = (sumeven - sumodd) >> 14;
+                /* Discard every other QMF output. We shift by 12 to allow for
+                   the QMF filters (DC gain = 4096), plus 1 to allow for us summing
+                   two filters, plus 1 to allow for the 15 bit input to the G.722
+                   algorithm. */
+                qmf_analysis(s->x, &xlow, &xhigh);
 
 #ifdef RUN_LIKE_REFERENCE_G722
                 /* The following lines are only used to verify bit-exactness
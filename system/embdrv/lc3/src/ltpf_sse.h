@@ -0,0 +1,275 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __SSE2__
+
+#include <emmintrin.h>
+
+
+/**
+ * Import
+ */
+
+static inline int32_t filter_hp50(struct lc3_ltpf_hp50_state *, int32_t);
+
+
+/**
+ * Horizontal sum of 32 bits lanes
+ */
+static inline int32_t sse_hadd_epi32(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+/**
+ * Resampling to 12.8 KHz Template
+ * p, q            Number of phases `p`, input to output ratio of `q / p`
+ * h, w            Arrange by phase coefficients table of `w` taps per phase
+ * hp50            High-Pass biquad filter state
+ * x               [-(w-1)..-1] Previous, [0..ns-1] Current samples, Q15
+ * y, n            [0..n-1] Output `n` processed samples, Q14
+ *
+ * The products of the 16 bits samples and coefficients are summed on
+ * 32 bits, as done by the generic implementation.
+ */
+LC3_HOT static inline void sse_resample_12k8(
+    const int p, const int q, const int16_t *h, const int w,
+    struct lc3_ltpf_hp50_state *hp50, const int16_t *x, int16_t *y, int n)
+{
+    x -= w - 1;
+
+    for (int i = 0; i < q*n; i += q) {
+        const int16_t *hn = h + (i % p) * w;
+        const int16_t *xn = x + (i / p);
+        __m128i un = _mm_setzero_si128();
+        int k;
+
+        for (k = 0; k + 8 <= w; k += 8, xn += 8, hn += 8)
+            un = _mm_add_epi32(un, _mm_madd_epi16(
+                _mm_loadu_si128((const __m128i *)xn),
+                _mm_loadu_si128((const __m128i *)hn) ));
+
+        if (k + 4 <= w) {
+            un = _mm_add_epi32(un, _mm_madd_epi16(
+                _mm_loadl_epi64((const __m128i *)xn),
+                _mm_loadl_epi64((const __m128i *)hn) ));
+            k += 4, xn += 4, hn += 4;
+        }
+
+        int32_t u32 = sse_hadd_epi32(un);
+        for ( ; k < w; k++)
+            u32 += *(xn++) * *(hn++);
+
+        int32_t yn = filter_hp50(hp50, u32);
+        *(y++) = (yn + (1 << 15)) >> 16;
+    }
+}
+
+/**
+ * Resample from 16 Khz to 12.8 KHz
+ */
+#ifndef resample_16k_12k8
+#ifndef TEST_SSE
+#define resample_16k_12k8 sse_resample_16k_12k8
+#endif
+LC3_HOT static void sse_resample_16k_12k8(
+    struct lc3_ltpf_hp50_state *hp50, const int16_t *x, int16_t *y, int n)
+{
+    static const int16_t h[4*20] = {
+          -61,   214,  -398,   417,     0, -1052,  2686, -4529,  5997, 26233,
+         5997, -4529,  2686, -1052,     0,   417,  -398,   214,   -61,     0,
+
+          -79,   180,  -213,     0,   598, -1522,  2389, -2427,     0, 24506,
+        13068, -5289,  1873,     0,  -752,   763,  -457,   156,     0,   -28,
+
+          -61,    92,     0,  -323,   861, -1361,  1317,     0, -3885, 19741,
+        19741, -3885,     0,  1317, -1361,   861,  -323,     0,    92,   -61,
+
+          -28,     0,   156,  -457,   763,  -752,     0,  1873, -5289, 13068,
+        24506,     0, -2427,  2389, -1522,   598,     0,  -213,   180,   -79,
+    };
+
+    sse_resample_12k8(4, 5, h, 20, hp50, x, y, n);
+}
+#endif /* resample_16k_12k8 */
+
+/**
+ * Resample from 32 Khz to 12.8 KHz
+ */
+#ifndef resample_32k_12k8
+#ifndef TEST_SSE
+#define resample_32k_12k8 sse_resample_32k_12k8
+#endif
+LC3_HOT static void sse_resample_32k_12k8(
+    struct lc3_ltpf_hp50_state *hp50, const int16_t *x, int16_t *y, int n)
+{
+    static const int16_t h[2*40] = {
+          -30,   -31,    46,   107,     0,  -199,  -162,   209,   430,     0,
+         -681,  -526,   658,  1343,     0, -2264, -1943,  2999,  9871, 13116,
+         9871,  2999, -1943, -2264,     0,  1343,   658,  -526,  -681,     0,
+          430,   209,  -162,  -199,     0,   107,    46,   -31,   -30,     0,
+
+          -14,   -39,     0,    90,    78,  -106,  -229,     0,   382,   299,
+         -376,  -761,     0,  1194,   937, -1214, -2644,     0,  6534, 12253,
+        12253,  6534,     0, -2644, -1214,   937,  1194,     0,  -761,  -376,
+          299,   382,     0,  -229,  -106,    78,    90,     0,   -39,   -14,
+    };
+
+    sse_resample_12k8(2, 5, h, 40, hp50, x, y, n);
+}
+#endif /* resample_32k_12k8 */
+
+/**
+ * Resample from 24 Khz to 12.8 KHz
+ */
+#ifndef resample_24k_12k8
+#ifndef TEST_SSE
+#define resample_24k_12k8 sse_resample_24k_12k8
+#endif
+LC3_HOT static void sse_resample_24k_12k8(
+    struct lc3_ltpf_hp50_state *hp50, const int16_t *x, int16_t *y, int n)
+{
+    static const int16_t h[8*30] = {
+          -50,    19,   143,   -93,  -290,   278,   485,  -658,  -701,  1396,
+          901, -3019, -1042, 10276, 17488, 10276, -1042, -3019,   901,  1396,
+         -701,  -658,   485,   278,  -290,   -93,   143,    19,   -50,     0,
+
+          -46,     0,   141,   -45,  -305,   185,   543,  -501,  -854,  1153,
+         1249, -2619, -1908,  8712, 17358, 11772,     0, -3319,   480,  1593,
+         -504,  -796,   399,   367,  -261,  -142,   138,    40,   -52,    -5,
+
+          -41,   -17,   133,     0,  -304,    91,   574,  -334,  -959,   878,
+         1516, -2143, -2590,  7118, 16971, 13161,  1202, -3495,     0,  1731,
+         -267,  -908,   287,   445,  -215,  -188,   125,    62,   -52,   -12,
+
+          -34,   -30,   120,    41,  -291,     0,   577,  -164, -1015,   585,
+         1697, -1618, -3084,  5534, 16337, 14406,  2544, -3526,  -523,  1800,
+            0,  -985,   152,   509,  -156,  -230,   104,    83,   -48,   -19,
+
+          -26,   -41,   103,    76,  -265,   -83,   554,     0, -1023,   288,
+         1791, -1070, -3393,  3998, 15474, 15474,  3998, -3393, -1070,  1791,
+          288, -1023,     0,   554,   -83,  -265,    76,   103,   -41,   -26,
+
+          -19,   -48,    83,   104,  -230,  -156,   509,   152,  -985,     0,
+         1800,  -523, -3526,  2544, 14406, 16337,  5534, -3084, -1618,  1697,
+          585, -1015,  -164,   577,     0,  -291,    41,   120,   -30,   -34,
+
+          -12,   -52,    62,   125,  -188,  -215,   445,   287,  -908,  -267,
+         1731,     0, -3495,  1202, 13161, 16971,  7118, -2590, -2143,  1516,
+          878,  -959,  -334,   574,    91,  -304,     0,   133,   -17,   -41,
+
+           -5,   -52,    40,   138,  -142,  -261,   367,   399,  -796,  -504,
+         1593,   480, -3319,     0, 11772, 17358,  8712, -1908, -2619,  1249,
+         1153,  -854,  -501,   543,   185,  -305,   -45,   141,     0,   -46,
+    };
+
+    sse_resample_12k8(8, 15, h, 30, hp50, x, y, n);
+}
+#endif /* resample_24k_12k8 */
+
+/**
+ * Resample from 48 Khz to 12.8 KHz
+ */
+#ifndef resample_48k_12k8
+#ifndef TEST_SSE
+#define resample_48k_12k8 sse_resample_48k_12k8
+#endif
+LC3_HOT static void sse_resample_48k_12k8(
+    struct lc3_ltpf_hp50_state *hp50, const int16_t *x, int16_t *y, int n)
+{
+    static const int16_t h[4*60] = {
+          -13,   -25,   -20,    10,    51,    71,    38,   -47,  -133,  -145,
+          -42,   139,   277,   242,     0,  -329,  -511,  -351,   144,   698,
+          895,   450,  -535, -1510, -1697,  -521,  1999,  5138,  7737,  8744,
+         7737,  5138,  1999,  -521, -1697, -1510,  -535,   450,   895,   698,
+          144,  -351,  -511,  -329,     0,   242,   277,   139,   -42,  -145,
+         -133,   -47,    38,    71,    51,    10,   -20,   -25,   -13,     0,
+
+           -9,   -23,   -24,     0,    41,    71,    52,   -23,  -115,  -152,
+          -78,    92,   254,   272,    76,  -251,  -493,  -427,     0,   576,
+          900,   624,  -262, -1309, -1763,  -954,  1272,  4356,  7203,  8679,
+         8169,  5886,  2767,     0, -1542, -1660,  -809,   240,   848,   796,
+          292,  -252,  -507,  -398,   -82,   199,   288,   183,     0,  -130,
+         -145,   -71,    20,    69,    60,    20,   -15,   -26,   -17,    -3,
+
+           -6,   -20,   -26,    -8,    31,    67,    62,     0,   -94,  -152,
+         -108,    45,   223,   287,   143,  -167,  -454,  -480,  -134,   439,
+          866,   758,     0, -1071, -1748, -1295,   601,  3559,  6580,  8485,
+         8485,  6580,  3559,   601, -1295, -1748, -1071,     0,   758,   866,
+          439,  -134,  -480,  -454,  -167,   143,   287,   223,    45,  -108,
+         -152,   -94,     0,    62,    67,    31,    -8,   -26,   -20,    -6,
+
+           -3,   -17,   -26,   -15,    20,    60,    69,    20,   -71,  -145,
+         -130,     0,   183,   288,   199,   -82,  -398,  -507,  -252,   292,
+          796,   848,   240,  -809, -1660, -1542,     0,  2767,  5886,  8169,
+         8679,  7203,  4356,  1272,  -954, -1763, -1309,  -262,   624,   900,
+          576,     0,  -427,  -493,  -251,    76,   272,   254,    92,   -78,
+         -152,  -115,   -23,    52,    71,    41,     0,   -24,   -23,    -9,
+    };
+
+    sse_resample_12k8(4, 15, h, 60, hp50, x, y, n);
+}
+#endif /* resample_48k_12k8 */
+
+/**
+ * Return dot product of 2 vectors
+ */
+#ifndef dot
+#ifndef TEST_SSE
+#define dot sse_dot
+#endif
+LC3_HOT static inline float sse_dot(const int16_t *a, const int16_t *b, int n)
+{
+    __m128i v = _mm_setzero_si128();
+
+    for (int i = 0; i < (n >> 3); i++, a += 8, b += 8) {
+        __m128i u = _mm_madd_epi16( _mm_loadu_si128((const __m128i *)a),
+                                    _mm_loadu_si128((const __m128i *)b) );
+
+        /* Accumulate on 64 bits, sign extending the pairwise sums */
+        __m128i s = _mm_srai_epi32(u, 31);
+        v = _mm_add_epi64(v, _mm_unpacklo_epi32(u, s));
+        v = _mm_add_epi64(v, _mm_unpackhi_epi32(u, s));
+    }
+
+    int64_t v64[2];
+    _mm_storeu_si128((__m128i *)v64, v);
+
+    int32_t v32 = (v64[0] + v64[1] + (1 << 5)) >> 6;
+    return (float)v32;
+}
+#endif /* dot */
+
+/**
+ * Return vector of correlations
+ */
+#ifndef correlate
+#ifndef TEST_SSE
+#define correlate sse_correlate
+#endif
+LC3_HOT static void sse_correlate(
+    const int16_t *a, const int16_t *b, int n, float *y, int nc)
+{
+    for (const float *ye = y + nc; y < ye; )
+        *(y++) = sse_dot(a, b--, n);
+}
+#endif /* correlate */
+
+#endif /* __SSE2__ */
@@ -0,0 +1,257 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __SSE2__
+
+#include <emmintrin.h>
+
+
+/**
+ * Complex operations on a pair of complex values `{ re0, im0, re1, im1 }`
+ */
+
+static inline __m128 sse_cswap(__m128 x)
+{
+    return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static inline __m128 sse_cmul(__m128 x, __m128 w)
+{
+    const __m128 neg_re = _mm_castsi128_ps(
+        _mm_set_epi32(0, 0x80000000, 0, 0x80000000));
+
+    __m128 w_re = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 w_im = _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 xr = _mm_xor_ps(sse_cswap(x), neg_re);
+
+    return _mm_add_ps( _mm_mul_ps(x, w_re), _mm_mul_ps(xr, w_im) );
+}
+
+
+/**
+ * FFT 5 Points
+ * The number of interleaved transform `n` assumed to be even
+ */
+#ifndef fft_5
+#ifndef TEST_SSE
+#define fft_5 sse_fft_5
+#endif
+LC3_HOT static inline void sse_fft_5(
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    const __m128 cos1 = _mm_set1_ps( 0.3090169944);
+    const __m128 cos2 = _mm_set1_ps(-0.8090169944);
+    const __m128 sin1 = _mm_set_ps(-0.9510565163,  0.9510565163,
+                                   -0.9510565163,  0.9510565163);
+    const __m128 sin2 = _mm_set_ps(-0.5877852523,  0.5877852523,
+                                   -0.5877852523,  0.5877852523);
+
+    for (int i = 0; i < n; i += 2, x += 2, y += 10) {
+
+        __m128 y0, y1, y2, y3, y4;
+
+        __m128 x0 = _mm_loadu_ps( (const float *)(x + 0*n) );
+        __m128 x1 = _mm_loadu_ps( (const float *)(x + 1*n) );
+        __m128 x2 = _mm_loadu_ps( (const float *)(x + 2*n) );
+        __m128 x3 = _mm_loadu_ps( (const float *)(x + 3*n) );
+        __m128 x4 = _mm_loadu_ps( (const float *)(x + 4*n) );
+
+        __m128 s14 = _mm_add_ps(x1, x4);
+        __m128 s23 = _mm_add_ps(x2, x3);
+
+        __m128 d14 = sse_cswap( _mm_sub_ps(x1, x4) );
+        __m128 d23 = sse_cswap( _mm_sub_ps(x2, x3) );
+
+        y0 = _mm_add_ps( x0, _mm_add_ps(s14, s23) );
+
+        y4 = _mm_add_ps( x0, _mm_add_ps(
+            _mm_mul_ps(s14, cos1), _mm_mul_ps(s23, cos2) ) );
+
+        y1 = _mm_add_ps( y4, _mm_add_ps(
+            _mm_mul_ps(d14, sin1), _mm_mul_ps(d23, sin2) ) );
+
+        y4 = _mm_sub_ps( y4, _mm_add_ps(
+            _mm_mul_ps(d14, sin1), _mm_mul_ps(d23, sin2) ) );
+
+        y3 = _mm_add_ps( x0, _mm_add_ps(
+            _mm_mul_ps(s14, cos2), _mm_mul_ps(s23, cos1) ) );
+
+        y2 = _mm_add_ps( y3, _mm_sub_ps(
+            _mm_mul_ps(d14, sin2), _mm_mul_ps(d23, sin1) ) );
+
+        y3 = _mm_sub_ps( y3, _mm_sub_ps(
+            _mm_mul_ps(d14, sin2), _mm_mul_ps(d23, sin1) ) );
+
+        _mm_storel_pi( (__m64 *)(y + 0), y0 );
+        _mm_storel_pi( (__m64 *)(y + 1), y1 );
+        _mm_storel_pi( (__m64 *)(y + 2), y2 );
+        _mm_storel_pi( (__m64 *)(y + 3), y3 );
+        _mm_storel_pi( (__m64 *)(y + 4), y4 );
+
+        _mm_storeh_pi( (__m64 *)(y + 5), y0 );
+        _mm_storeh_pi( (__m64 *)(y + 6), y1 );
+        _mm_storeh_pi( (__m64 *)(y + 7), y2 );
+        _mm_storeh_pi( (__m64 *)(y + 8), y3 );
+        _mm_storeh_pi( (__m64 *)(y + 9), y4 );
+    }
+}
+#endif /* fft_5 */
+
+/**
+ * FFT Butterfly 3 Points
+ */
+#ifndef fft_bf3
+#ifndef TEST_SSE
+#define fft_bf3 sse_fft_bf3
+#endif
+LC3_HOT static inline void sse_fft_bf3(
+    const struct lc3_fft_bf3_twiddles *twiddles,
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    int n3 = twiddles->n3;
+    const struct lc3_complex (*w0_ptr)[2] = twiddles->t;
+    const struct lc3_complex (*w1_ptr)[2] = w0_ptr + n3;
+    const struct lc3_complex (*w2_ptr)[2] = w1_ptr + n3;
+
+    const struct lc3_complex *x0_ptr = x;
+    const struct lc3_complex *x1_ptr = x0_ptr + n*n3;
+    const struct lc3_complex *x2_ptr = x1_ptr + n*n3;
+
+    struct lc3_complex *y0_ptr = y;
+    struct lc3_complex *y1_ptr = y0_ptr + n3;
+    struct lc3_complex *y2_ptr = y1_ptr + n3;
+
+    for (int j, i = 0; i < n; i++,
+            y0_ptr += 3*n3, y1_ptr += 3*n3, y2_ptr += 3*n3) {
+
+        /* --- Process by pair --- */
+
+        for (j = 0; j < (n3 >> 1); j++,
+                x0_ptr += 2, x1_ptr += 2, x2_ptr += 2) {
+
+            __m128 x0 = _mm_loadu_ps( (const float *)x0_ptr );
+            __m128 x1 = _mm_loadu_ps( (const float *)x1_ptr );
+            __m128 x2 = _mm_loadu_ps( (const float *)x2_ptr );
+
+            const struct lc3_complex (*w_ptr[3])[2] =
+                { w0_ptr, w1_ptr, w2_ptr };
+            struct lc3_complex *y_ptr[3] = { y0_ptr, y1_ptr, y2_ptr };
+
+            for (int k = 0; k < 3; k++) {
+                __m128 wa = _mm_loadu_ps( (const float *)(w_ptr[k] + 2*j) );
+                __m128 wb = _mm_loadu_ps(
+                    (const float *)(w_ptr[k] + 2*j + 1) );
+
+                __m128 yn = _mm_add_ps( x0, _mm_add_ps(
+                    sse_cmul(x1, _mm_movelh_ps(wa, wb)),
+                    sse_cmul(x2, _mm_movehl_ps(wb, wa)) ) );
+
+                _mm_storeu_ps( (float *)(y_ptr[k] + 2*j), yn );
+            }
+        }
+
+        /* --- Last iteration --- */
+
+        if (n3 & 1) {
+
+            const struct lc3_complex *x0 = x0_ptr++;
+            const struct lc3_complex *x1 = x1_ptr++;
+            const struct lc3_complex *x2 = x2_ptr++;
+
+            const struct lc3_complex *w0 = w0_ptr[2*j];
+            const struct lc3_complex *w1 = w1_ptr[2*j];
+            const struct lc3_complex *w2 = w2_ptr[2*j];
+
+            y0_ptr[2*j].re = x0->re + x1->re * w0[0].re - x1->im * w0[0].im
+                                    + x2->re * w0[1].re - x2->im * w0[1].im;
+
+            y0_ptr[2*j].im = x0->im + x1->im * w0[0].re + x1->re * w0[0].im
+                                    + x2->im * w0[1].re + x2->re * w0[1].im;
+
+            y1_ptr[2*j].re = x0->re + x1->re * w1[0].re - x1->im * w1[0].im
+                                    + x2->re * w1[1].re - x2->im * w1[1].im;
+
+            y1_ptr[2*j].im = x0->im + x1->im * w1[0].re + x1->re * w1[0].im
+                                    + x2->im * w1[1].re + x2->re * w1[1].im;
+
+            y2_ptr[2*j].re = x0->re + x1->re * w2[0].re - x1->im * w2[0].im
+                                    + x2->re * w2[1].re - x2->im * w2[1].im;
+
+            y2_ptr[2*j].im = x0->im + x1->im * w2[0].re + x1->re * w2[0].im
+                                    + x2->im * w2[1].re + x2->re * w2[1].im;
+        }
+
+    }
+}
+#endif /* fft_bf3 */
+
+/**
+ * FFT Butterfly 2 Points
+ */
+#ifndef fft_bf2
+#ifndef TEST_SSE
+#define fft_bf2 sse_fft_bf2
+#endif
+LC3_HOT static inline void sse_fft_bf2(
+    const struct lc3_fft_bf2_twiddles *twiddles,
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    int n2 = twiddles->n2;
+    const struct lc3_complex *w_ptr = twiddles->t;
+
+    const struct lc3_complex *x0_ptr = x;
+    const struct lc3_complex *x1_ptr = x0_ptr + n*n2;
+
+    struct lc3_complex *y0_ptr = y;
+    struct lc3_complex *y1_ptr = y0_ptr + n2;
+
+    for (int j, i = 0; i < n; i++, y0_ptr += 2*n2, y1_ptr += 2*n2) {
+
+        /* --- Process by pair --- */
+
+        for (j = 0; j < (n2 >> 1); j++, x0_ptr += 2, x1_ptr += 2) {
+
+            __m128 x0 = _mm_loadu_ps( (const float *)x0_ptr );
+            __m128 x1 = _mm_loadu_ps( (const float *)x1_ptr );
+            __m128 w = _mm_loadu_ps( (const float *)(w_ptr + 2*j) );
+
+            __m128 xw = sse_cmul(x1, w);
+
+            _mm_storeu_ps( (float *)(y0_ptr + 2*j), _mm_add_ps(x0, xw) );
+            _mm_storeu_ps( (float *)(y1_ptr + 2*j), _mm_sub_ps(x0, xw) );
+        }
+
+        /* --- Last iteration --- */
+
+        if (n2 & 1) {
+
+            const struct lc3_complex *x0 = x0_ptr++;
+            const struct lc3_complex *x1 = x1_ptr++;
+            const struct lc3_complex *w = w_ptr + 2*j;
+
+            y0_ptr[2*j].re = x0->re + x1->re * w->re - x1->im * w->im;
+            y0_ptr[2*j].im = x0->im + x1->im * w->re + x1->re * w->im;
+
+            y1_ptr[2*j].re = x0->re - x1->re * w->re + x1->im * w->im;
+            y1_ptr[2*j].im = x0->im - x1->im * w->re - x1->re * w->im;
+        }
+    }
+}
+#endif /* fft_bf2 */
+
+#endif /* __SSE2__ */
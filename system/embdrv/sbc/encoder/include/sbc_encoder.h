@@ -205,6 +205,10 @@ uint32_t SBC_Encode(SBC_ENC_PARAMS* strEncParams, int16_t* input,
                     uint8_t* output);
 void SBC_Encoder_Init(SBC_ENC_PARAMS* strEncParams);
 
+/* Selects the NEON or SSE2 analysis filter when the target has one, which is
+ * the default, or the portable C one. Both produce the same bitstream. */
+void SBC_Encoder_UseSimd(bool enable);
+
 #ifdef __cplusplus
 }
 #endif
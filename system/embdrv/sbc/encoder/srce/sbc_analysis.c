@@ -27,6 +27,27 @@
 #include "sbc_encoder.h"
 /*#include <math.h>*/
 
+/* The 16 bit windowing is also available with vector instructions. Each
+ * windowed sample is a sum of 5 products of 16 bit values accumulated on 32
+ * bits, which the SIMD kernels compute exactly, so both versions produce the
+ * same bitstream. */
+#if (SBC_ARM_ASM_OPT == FALSE) && (SBC_IPAQ_OPT == TRUE) && \
+    (SBC_IS_64_MULT_IN_WINDOW_ACCU == FALSE)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SBC_SIMD_WINDOW_NEON TRUE
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SBC_SIMD_WINDOW_SSE2 TRUE
+#endif
+#endif
+
+#if defined(SBC_SIMD_WINDOW_NEON) || defined(SBC_SIMD_WINDOW_SSE2)
+#define SBC_SIMD_WINDOW TRUE
+#else
+#define SBC_SIMD_WINDOW FALSE
+#endif
+
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
 #define WIND_4_SUBBANDS_0_1                                              \
   (int32_t)0x01659F45 /* gas32CoeffFor4SBs[8] = -gas32CoeffFor4SBs[32] = \
@@ -1185,6 +1206,121 @@ static int16_t* s16X =
 #endif
 #endif
 
+#if (SBC_SIMD_WINDOW == TRUE)
+/* Window coefficients in the order of the samples they weight: the windowed
+ * sample n is the sum over j of coeffs[j * 2 * subbands + n] *
+ * s16X[ChOffset + j * 2 * subbands + n]. */
+static const int16_t gas16WindowFor4SBs[5 * 8] = {
+    0, WIND_4_SUBBANDS_1_0, WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_3_0,
+    WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_2_4,
+    WIND_4_SUBBANDS_1_4,
+
+    WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_1, WIND_4_SUBBANDS_2_1,
+    WIND_4_SUBBANDS_3_1, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_3,
+    WIND_4_SUBBANDS_2_3, WIND_4_SUBBANDS_1_3,
+
+    WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_2, WIND_4_SUBBANDS_2_2,
+    WIND_4_SUBBANDS_3_2, WIND_4_SUBBANDS_4_2, WIND_4_SUBBANDS_3_2,
+    WIND_4_SUBBANDS_2_2, WIND_4_SUBBANDS_1_2,
+
+    -WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_3, WIND_4_SUBBANDS_2_3,
+    WIND_4_SUBBANDS_3_3, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_1,
+    WIND_4_SUBBANDS_2_1, WIND_4_SUBBANDS_1_1,
+
+    -WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_4, WIND_4_SUBBANDS_2_4,
+    WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_0,
+    WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_1_0,
+};
+
+static const int16_t gas16WindowFor8SBs[5 * 16] = {
+    0, WIND_8_SUBBANDS_1_0, WIND_8_SUBBANDS_2_0, WIND_8_SUBBANDS_3_0,
+    WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_5_0, WIND_8_SUBBANDS_6_0,
+    WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_8_0, WIND_8_SUBBANDS_7_4,
+    WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_5_4, WIND_8_SUBBANDS_4_4,
+    WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_2_4, WIND_8_SUBBANDS_1_4,
+
+    WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_1, WIND_8_SUBBANDS_2_1,
+    WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_5_1,
+    WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_8_1,
+    WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_5_3,
+    WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_2_3,
+    WIND_8_SUBBANDS_1_3,
+
+    WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_2, WIND_8_SUBBANDS_2_2,
+    WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_5_2,
+    WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_8_2,
+    WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_5_2,
+    WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_2_2,
+    WIND_8_SUBBANDS_1_2,
+
+    -WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_3, WIND_8_SUBBANDS_2_3,
+    WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_5_3,
+    WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_8_1,
+    WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_5_1,
+    WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_2_1,
+    WIND_8_SUBBANDS_1_1,
+
+    -WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_4, WIND_8_SUBBANDS_2_4,
+    WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_4_4, WIND_8_SUBBANDS_5_4,
+    WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_7_4, WIND_8_SUBBANDS_8_0,
+    WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_6_0, WIND_8_SUBBANDS_5_0,
+    WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_3_0, WIND_8_SUBBANDS_2_0,
+    WIND_8_SUBBANDS_1_0,
+};
+
+/****************************************************************************
+* SbcWindowSimd - windows the 2 * subbands samples of one block, 8 at a time
+*
+* RETURNS : N/A
+*/
+static void SbcWindowSimd(const int16_t* ps16X, const int16_t* ps16Coeffs,
+                          int32_t* ps32Y, int32_t s32Stride) {
+  int32_t i, j;
+  for (i = 0; i < s32Stride; i += 8) {
+#if defined(SBC_SIMD_WINDOW_NEON)
+    int32x4_t s32Lo = vdupq_n_s32(0);
+    int32x4_t s32Hi = vdupq_n_s32(0);
+    for (j = 0; j < 5; j++) {
+      int16x8_t s16Samples = vld1q_s16(ps16X + j * s32Stride + i);
+      int16x8_t s16Coeffs = vld1q_s16(ps16Coeffs + j * s32Stride + i);
+      s32Lo = vmlal_s16(s32Lo, vget_low_s16(s16Samples),
+                        vget_low_s16(s16Coeffs));
+      s32Hi = vmlal_s16(s32Hi, vget_high_s16(s16Samples),
+                        vget_high_s16(s16Coeffs));
+    }
+    vst1q_s32(ps32Y + i, s32Lo);
+    vst1q_s32(ps32Y + i + 4, s32Hi);
+#else
+    __m128i s32Lo = _mm_setzero_si128();
+    __m128i s32Hi = _mm_setzero_si128();
+    for (j = 0; j < 5; j++) {
+      __m128i s16Samples =
+          _mm_loadu_si128((const __m128i*)(ps16X + j * s32Stride + i));
+      __m128i s16Coeffs =
+          _mm_loadu_si128((const __m128i*)(ps16Coeffs + j * s32Stride + i));
+      /* full 32 bit products from their low and high halves */
+      __m128i s16ProdLo = _mm_mullo_epi16(s16Samples, s16Coeffs);
+      __m128i s16ProdHi = _mm_mulhi_epi16(s16Samples, s16Coeffs);
+      s32Lo = _mm_add_epi32(s32Lo, _mm_unpacklo_epi16(s16ProdLo, s16ProdHi));
+      s32Hi = _mm_add_epi32(s32Hi, _mm_unpackhi_epi16(s16ProdLo, s16ProdHi));
+    }
+    _mm_storeu_si128((__m128i*)(ps32Y + i), s32Lo);
+    _mm_storeu_si128((__m128i*)(ps32Y + i + 4), s32Hi);
+#endif
+  }
+}
+
+static bool bUseSimdWindow = true;
+#endif
+
+void SBC_Encoder_UseSimd(bool enable) {
+#if (SBC_SIMD_WINDOW == TRUE)
+  bUseSimdWindow = enable;
+#else
+  (void)enable;
+#endif
+}
+
 static int16_t ShiftCounter = 0;
 extern int16_t EncMaxShiftCounter;
 /****************************************************************************
@@ -1257,7 +1393,13 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
-      WINDOW_PARTIAL_4
+#if (SBC_SIMD_WINDOW == TRUE)
+      if (bUseSimdWindow) {
+        SbcWindowSimd(s16X + ChOffset, gas16WindowFor4SBs, s32DCTY,
+                      2 * SUB_BANDS_4);
+      } else
+#endif
+        WINDOW_PARTIAL_4
 
       SBC_FastIDCT4(s32DCTY, ps32SbBuf);
 
@@ -1370,7 +1512,13 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
-      WINDOW_PARTIAL_8
+#if (SBC_SIMD_WINDOW == TRUE)
+      if (bUseSimdWindow) {
+        SbcWindowSimd(s16X + ChOffset, gas16WindowFor8SBs, s32DCTY,
+                      2 * SUB_BANDS_8);
+      } else
+#endif
+        WINDOW_PARTIAL_8
 
       SBC_FastIDCT8(s32DCTY, ps32SbBuf);
 
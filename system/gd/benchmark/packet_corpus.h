@@ -0,0 +1,108 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// The packets the packet path benchmarks run on. They are fixed, so that the results of a benchmark can be compared
+// across releases: change a packet and the results before and after the change no longer compare. Add packets instead.
+namespace bluetooth {
+namespace benchmark {
+namespace corpus {
+
+// HCI events, without the H4 packet type
+
+inline const std::vector<uint8_t> kReadBdAddrComplete = {
+    0x0e, 0x0a, 0x01, 0x09, 0x10, 0x00, 0x14, 0x8e, 0x61, 0x5f, 0x36, 0x88};
+
+inline const std::vector<uint8_t> kCreateConnectionStatus = {0x0f, 0x04, 0x00, 0x01, 0x05, 0x04};
+
+// Two handles, as a controller completing the packets of an A2DP stream and of a HID device reports them
+inline const std::vector<uint8_t> kNumberOfCompletedPackets = {
+    0x13, 0x09, 0x02, 0x01, 0x00, 0x03, 0x00, 0x02, 0x00, 0x01, 0x00};
+
+inline const std::vector<uint8_t> kConnectionComplete = {
+    0x03, 0x0b, 0x00, 0x01, 0x00, 0x14, 0x8e, 0x61, 0x5f, 0x36, 0x88, 0x01, 0x00};
+
+inline const std::vector<uint8_t> kDisconnectionComplete = {0x05, 0x04, 0x00, 0x01, 0x00, 0x13};
+
+inline const std::vector<uint8_t> kLeEnhancedConnectionComplete = {
+    0x3e, 0x1f, 0x0a, 0x00, 0x40, 0x00, 0x01, 0x01, 0x26, 0x31, 0x9a, 0x4b, 0x2c, 0xd5, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0xf4, 0x01, 0x01};
+
+// The advertising data of an earbud case: flags, name, 16 bit service UUID and service data, 31 bytes
+#define BENCHMARK_CORPUS_ADVERTISING_DATA                                                                           \
+  0x02, 0x01, 0x06, 0x0b, 0x09, 'P', 'i', 'x', 'e', 'l', ' ', 'B', 'u', 'd', 's', 0x03, 0x03, 0x2c, 0xfe, 0x0b, \
+      0x16, 0x2c, 0xfe, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77
+
+inline const std::vector<uint8_t> kLeAdvertisingReport = {
+    0x3e, 0x2b, 0x02, 0x01, 0x00, 0x01, 0x26, 0x31, 0x9a, 0x4b, 0x2c, 0xd5, 0x1f, BENCHMARK_CORPUS_ADVERTISING_DATA,
+    0xc4};
+
+// A legacy ADV_IND on LE 1M and an extended advertisement on LE 2M
+inline const std::vector<uint8_t> kLeExtendedAdvertisingReport = {
+    0x3e, 0x70, 0x0d, 0x02,
+    // Legacy connectable and scannable
+    0x13, 0x00, 0x01, 0x26, 0x31, 0x9a, 0x4b, 0x2c, 0xd5, 0x01, 0x00, 0xff, 0x7f, 0xc4, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x1f, BENCHMARK_CORPUS_ADVERTISING_DATA,
+    // Extended connectable
+    0x01, 0x00, 0x00, 0x14, 0x8e, 0x61, 0x5f, 0x36, 0x88, 0x01, 0x02, 0x03, 0x7f, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x1f, BENCHMARK_CORPUS_ADVERTISING_DATA};
+
+#undef BENCHMARK_CORPUS_ADVERTISING_DATA
+
+// HCI commands, without the H4 packet type
+
+inline const std::vector<uint8_t> kReadBdAddr = {0x09, 0x10, 0x00};
+
+inline const std::vector<uint8_t> kLeSetScanEnable = {0x0c, 0x20, 0x02, 0x01, 0x00};
+
+// ACL packets, without the H4 packet type
+
+// An ATT Write Command of 20 bytes on an LE link, as HID over GATT hosts and audio controls send them
+inline const std::vector<uint8_t> kAclAttWriteCommand = {
+    0x40, 0x20, 0x1b, 0x00, 0x17, 0x00, 0x04, 0x00, 0x52, 0x10, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04,
+    0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13};
+
+// An SBC media packet of an A2DP stream
+inline const std::vector<uint8_t> kAclA2dpMedia = {
+    0x0b, 0x20, 0x3a, 0x00, 0x36, 0x00, 0x40, 0xa0, 0x80, 0xe0, 0x07, 0x7f, 0x00, 0x1e, 0x08, 0x00,
+    0x00, 0x00, 0x00, 0x02, 0x47, 0xfc, 0x00, 0x00, 0xb0, 0x90, 0x80, 0x03, 0x00, 0x20, 0x21, 0x11,
+    0x45, 0x00, 0x14, 0x50, 0x01, 0x46, 0xf0, 0x81, 0x0a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a,
+    0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5a, 0x5e};
+
+// ATT PDUs, starting with their op code
+
+// Write Request of 20 bytes to the handle 0x0010
+inline const std::vector<uint8_t> kAttWriteRequest = {
+    0x12, 0x10, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13};
+
+// Write Command of 20 bytes to the handle 0x0010
+inline const std::vector<uint8_t> kAttWriteCommand = {
+    0x52, 0x10, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13};
+
+// Prepare Write Request of 18 bytes at the offset 0x0012 of the handle 0x0010
+inline const std::vector<uint8_t> kAttPrepareWriteRequest = {
+    0x16, 0x10, 0x00, 0x12, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11};
+
+}  // namespace corpus
+}  // namespace benchmark
+}  // namespace bluetooth
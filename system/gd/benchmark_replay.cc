@@ -0,0 +1,253 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replay the incoming traffic of a btsnoop log through the gd module stack
+//
+//   bluetooth_benchmark_replay --replay_log=<btsnoop log> [--replay_speed=<factor>] [benchmark flags]
+//
+// The stack runs on the replay HAL, that answers the commands with the responses of the log. The incoming events and
+// data are injected at the pace of the log divided by the speed factor, 1 by default, or back to back with a factor of
+// 0. Each iteration starts a new stack and replays the whole log, and reports:
+//  - <module>_cpu_us: the thread CPU time of the tasks of each module,
+//  - process_cpu_us: the CPU time of the process while replaying,
+//  - latency_p50_us, latency_p99_us, latency_max_us: the time from the injection of one packet in 16 until a task
+//    posted after it went through the handlers of all the modules in the order they started,
+//  - acl_<stage>_us: the mean latency of the incoming ACL packets for each layer boundary they crossed.
+
+#include <benchmark/benchmark.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/bind.h"
+#include "common/packet_latency_trace.h"
+#include "hal/hci_hal.h"
+#include "hal/replay/replay_hci_hal.h"
+#include "hal/snoop_log_reader.h"
+#include "hci/acl_manager.h"
+#include "hci/acl_manager/acl_scheduler.h"
+#include "hci/controller.h"
+#include "hci/hci_layer.h"
+#include "l2cap/classic/l2cap_classic_module.h"
+#include "l2cap/le/l2cap_le_module.h"
+#include "module.h"
+#include "os/handler.h"
+#include "os/log.h"
+#include "storage/storage_module.h"
+
+using ::benchmark::State;
+using ::bluetooth::ModuleFactory;
+using ::bluetooth::hal::SnoopLogReader;
+using ::bluetooth::hal::replay::ReplayHciHal;
+
+namespace {
+
+std::string replay_log;
+double replay_speed = 1.0;
+
+constexpr size_t kLatencyMarkerInterval = 16;
+constexpr std::chrono::seconds kIdleTimeout(10);
+
+struct ReplayedModule {
+  const char* name;
+  const ModuleFactory* factory;
+};
+
+// In the order they start
+const ReplayedModule kReplayedModules[] = {
+    {"hal", &::bluetooth::hal::HciHal::Factory},
+    {"storage", &::bluetooth::storage::StorageModule::Factory},
+    {"hci_layer", &::bluetooth::hci::HciLayer::Factory},
+    {"controller", &::bluetooth::hci::Controller::Factory},
+    {"acl_scheduler", &::bluetooth::hci::acl_manager::AclScheduler::Factory},
+    {"acl_manager", &::bluetooth::hci::AclManager::Factory},
+    {"l2cap_classic", &::bluetooth::l2cap::classic::L2capClassicModule::Factory},
+    {"l2cap_le", &::bluetooth::l2cap::le::L2capLeModule::Factory},
+};
+
+std::chrono::nanoseconds process_cpu_time() {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+// Post the marker to the next handler once the current one ran it
+void PassMarker(
+    const std::vector<::bluetooth::os::Handler*>* handlers,
+    size_t index,
+    std::chrono::steady_clock::time_point injected,
+    std::vector<std::chrono::microseconds>* latencies) {
+  if (index == handlers->size()) {
+    latencies->push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - injected));
+    return;
+  }
+  (*handlers)[index]->Post(::bluetooth::common::BindOnce(
+      &PassMarker,
+      ::bluetooth::common::Unretained(handlers),
+      index + 1,
+      injected,
+      ::bluetooth::common::Unretained(latencies)));
+}
+
+double Percentile(std::vector<std::chrono::microseconds> latencies, double percentile) {
+  if (latencies.empty()) {
+    return 0;
+  }
+  size_t index = std::min(latencies.size() - 1, static_cast<size_t>(latencies.size() * percentile));
+  std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+  return latencies[index].count();
+}
+
+void BM_Replay(State& state) {
+  std::ifstream input(replay_log, std::ios::binary);
+  SnoopLogReader reader(&input);
+  if (!reader.IsValid()) {
+    state.SkipWithError(("Not a btsnoop log: " + replay_log).c_str());
+    return;
+  }
+  std::vector<SnoopLogReader::Packet> packets;
+  while (auto packet = reader.Next()) {
+    packets.push_back(std::move(*packet));
+  }
+
+  std::vector<std::chrono::nanoseconds> module_cpu_time(std::size(kReplayedModules));
+  std::chrono::nanoseconds process_cpu(0);
+  std::vector<std::chrono::microseconds> latencies;
+  size_t traffic_size = 0;
+  size_t unscripted_command_count = 0;
+  ::bluetooth::common::PacketLatencyTrace::Reset();
+  ::bluetooth::common::PacketLatencyTrace::SetSamplingRate(1);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    ::bluetooth::TestModuleRegistry registry;
+    auto hal = new ReplayHciHal();
+    hal->Load(packets);
+    registry.InjectTestModule(&::bluetooth::hal::HciHal::Factory, hal);
+    ::bluetooth::ModuleList modules;
+    modules.add<::bluetooth::l2cap::classic::L2capClassicModule>();
+    modules.add<::bluetooth::l2cap::le::L2capLeModule>();
+    registry.Start(&modules, &registry.GetTestThread());
+
+    std::vector<::bluetooth::os::Handler*> handlers;
+    for (const auto& module : kReplayedModules) {
+      auto handler = registry.GetTestModuleHandler(module.factory);
+      ASSERT_LOG(handler != nullptr, "%s did not start", module.name);
+      handler->SetCpuTimeAccounting(true);
+      handlers.push_back(handler);
+    }
+    const auto& traffic = hal->GetTraffic();
+    traffic_size = traffic.size();
+    auto process_cpu_start = process_cpu_time();
+    state.ResumeTiming();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < traffic.size(); i++) {
+      if (replay_speed > 0) {
+        auto offset = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            (traffic[i].timestamp - traffic.front().timestamp) / replay_speed);
+        std::this_thread::sleep_until(start + offset);
+      }
+      auto injected = std::chrono::steady_clock::now();
+      hal->InjectTraffic(traffic[i]);
+      if (i % kLatencyMarkerInterval == 0) {
+        PassMarker(&handlers, 0, injected, &latencies);
+      }
+    }
+    if (!registry.GetTestThread().GetReactor()->WaitForIdle(kIdleTimeout)) {
+      state.SkipWithError("The stack did not become idle");
+    }
+
+    state.PauseTiming();
+    process_cpu += process_cpu_time() - process_cpu_start;
+    for (size_t i = 0; i < handlers.size(); i++) {
+      module_cpu_time[i] += handlers[i]->GetCpuTime();
+    }
+    unscripted_command_count += hal->GetUnscriptedCommandCount();
+    registry.StopAll();
+    state.ResumeTiming();
+  }
+
+  using ::benchmark::Counter;
+  for (size_t i = 0; i < std::size(kReplayedModules); i++) {
+    state.counters[std::string(kReplayedModules[i].name) + "_cpu_us"] = Counter(
+        std::chrono::duration_cast<std::chrono::microseconds>(module_cpu_time[i]).count(), Counter::kAvgIterations);
+  }
+  state.counters["process_cpu_us"] =
+      Counter(std::chrono::duration_cast<std::chrono::microseconds>(process_cpu).count(), Counter::kAvgIterations);
+  state.counters["latency_p50_us"] = Percentile(latencies, 0.5);
+  state.counters["latency_p99_us"] = Percentile(latencies, 0.99);
+  state.counters["latency_max_us"] = Percentile(latencies, 1);
+  for (uint8_t stage = static_cast<uint8_t>(::bluetooth::common::PacketLatencyStage::HCI_LAYER);
+       stage < static_cast<uint8_t>(::bluetooth::common::PacketLatencyStage::COUNT);
+       stage++) {
+    auto histogram = ::bluetooth::common::PacketLatencyTrace::GetHistogram(
+        static_cast<::bluetooth::common::PacketLatencyStage>(stage));
+    if (histogram.count > 0) {
+      state.counters[std::string("acl_") +
+                     ::bluetooth::common::PacketLatencyStageText(
+                         static_cast<::bluetooth::common::PacketLatencyStage>(stage)) +
+                     "_us"] = static_cast<double>(histogram.total_us) / histogram.count;
+    }
+  }
+  state.counters["packets"] = traffic_size;
+  state.counters["unscripted_commands"] = Counter(unscripted_command_count, Counter::kAvgIterations);
+  ::bluetooth::common::PacketLatencyTrace::SetSamplingRate(0);
+}
+
+// Take the replay flags out of the arguments, before the benchmark library rejects them
+void ParseReplayFlags(int* argc, char** argv) {
+  int kept = 1;
+  for (int i = 1; i < *argc; i++) {
+    if (strncmp(argv[i], "--replay_log=", strlen("--replay_log=")) == 0) {
+      replay_log = argv[i] + strlen("--replay_log=");
+    } else if (strncmp(argv[i], "--replay_speed=", strlen("--replay_speed=")) == 0) {
+      replay_speed = atof(argv[i] + strlen("--replay_speed="));
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+  *argc = kept;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ParseReplayFlags(&argc, argv);
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  if (replay_log.empty()) {
+    fprintf(stderr, "Usage: %s --replay_log=<btsnoop log> [--replay_speed=<factor>]\n", argv[0]);
+    return 1;
+  }
+  auto benchmark = ::benchmark::RegisterBenchmark("BM_Replay", BM_Replay)->Unit(::benchmark::kMillisecond);
+  if (replay_speed > 0) {
+    // Each iteration lasts as long as the log
+    benchmark->Iterations(1);
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
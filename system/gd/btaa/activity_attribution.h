@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "hal/snoop_logger.h"
 #include "hci/address.h"
 #include "module.h"
@@ -61,6 +63,8 @@ class ActivityAttribution : public bluetooth::Module {
   void OnWakeup();
   void RegisterActivityAttributionCallback(ActivityAttributionCallback* callback);
   void NotifyActivityAttributionInfo(int uid, const std::string& package_name, const std::string& device_address);
+  // Starts or stops the capture of HCI packets, which costs nothing but a flag check while stopped
+  void SetCaptureEnabled(bool enabled);
 
   static const ModuleFactory Factory;
 
@@ -74,6 +78,7 @@ class ActivityAttribution : public bluetooth::Module {
  private:
   struct impl;
   std::unique_ptr<impl> pimpl_;
+  std::atomic_bool capture_enabled_{true};
 };
 
 }  // namespace activity_attribution
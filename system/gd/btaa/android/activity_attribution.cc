@@ -25,10 +25,14 @@
 #include <android/binder_manager.h>
 
 #include "btaa/attribution_processor.h"
+#include "btaa/capture_queue.h"
 #include "btaa/hci_processor.h"
 #include "btaa/wakelock_processor.h"
+#include "common/bind.h"
 #include "module.h"
+#include "os/handler.h"
 #include "os/log.h"
+#include "os/thread.h"
 
 using aidl::android::system::suspend::BnSuspendCallback;
 using aidl::android::system::suspend::BnWakelockCallback;
@@ -92,8 +96,13 @@ struct wakeup_callback : public BnSuspendCallback {
 
 static std::shared_ptr<wakeup_callback> g_wakeup_callback = nullptr;
 
+// Classification and aggregation run on a thread of their own, off the HCI path. Capture() on the HCI path only
+// hands the packets off, or counts the bytes of data packets in place.
 struct ActivityAttribution::impl {
   impl(ActivityAttribution* module) {
+    thread_ = std::make_unique<os::Thread>("bt_btaa", os::Thread::Priority::NORMAL);
+    handler_ = std::make_unique<os::Handler>(thread_.get());
+
     std::lock_guard<std::mutex> guard(g_module_mutex);
     g_module = module;
     if (is_wakeup_callback_registered && is_wakelock_callback_registered) {
@@ -133,12 +142,99 @@ struct ActivityAttribution::impl {
   }
 
   ~impl() {
-    std::lock_guard<std::mutex> guard(g_module_mutex);
-    g_module = nullptr;
+    {
+      std::lock_guard<std::mutex> guard(g_module_mutex);
+      g_module = nullptr;
+    }
+    handler_->Clear();
+    handler_->WaitUntilStopped(std::chrono::milliseconds(2000));
+    handler_.reset();
+    thread_.reset();
   }
 
-  void on_hci_packet(hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length) {
-    attribution_processor_.OnBtaaPackets(std::move(hci_processor_.OnHciPacket(std::move(packet), type, length)));
+  // Any thread
+  void capture(const hal::HciPacket& packet, hal::SnoopLogger::PacketType type) {
+    uint16_t length = packet.size();
+    uint16_t captured_length = length;
+    Activity data_activity = Activity::UNKNOWN;
+
+    switch (type) {
+      case hal::SnoopLogger::PacketType::CMD:
+      case hal::SnoopLogger::PacketType::EVT:
+        break;
+      case hal::SnoopLogger::PacketType::ACL:
+        data_activity = Activity::ACL;
+        break;
+      case hal::SnoopLogger::PacketType::SCO:
+        data_activity = Activity::HFP;
+        break;
+      case hal::SnoopLogger::PacketType::ISO:
+        data_activity = Activity::ISO;
+        break;
+    }
+
+    if (data_activity != Activity::UNKNOWN) {
+      if (length < kHciAclHeaderSize) {
+        return;
+      }
+      // The packet following a wakeup is queued so that the wakeup is attributed to it
+      if (!wakeup_pending_.load(std::memory_order_relaxed)) {
+        // Connection handle is extracted from the 12 least significant bit.
+        uint16_t connection_handle = (packet[0] | (packet[1] << 8)) & 0xfff;
+        data_byte_counters_.Add(data_activity, connection_handle, length);
+        return;
+      }
+      captured_length = kHciAclHeaderSize;
+    }
+
+    if (captured_length == 0) {
+      return;
+    }
+    if (!capture_queue_.TryEnqueue(type, packet.data(), captured_length, length)) {
+      dropped_packets_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    // Only the first packet queued since the last drain wakes the thread up
+    if (!drain_scheduled_.exchange(true)) {
+      handler_->Post(common::BindOnce(&impl::on_packets_captured, common::Unretained(this)));
+    }
+  }
+
+  void on_wakeup_captured() {
+    wakeup_pending_.store(true);
+  }
+
+  void on_packets_captured() {
+    drain_scheduled_.store(false);
+    process_captured_packets();
+  }
+
+  void process_captured_packets() {
+    CapturedPacket packet;
+    while (capture_queue_.TryDequeue(&packet)) {
+      hal::HciPacket captured(packet.data, packet.data + packet.captured_length);
+      attribution_processor_.OnBtaaPackets(hci_processor_.OnHciPacket(std::move(captured), packet.type, packet.length));
+      if (wakeup_) {
+        wakeup_ = false;
+        wakeup_pending_.store(false);
+      }
+    }
+
+    size_t dropped_packets = dropped_packets_.exchange(0);
+    if (dropped_packets != 0) {
+      LOG_WARN("%zu captured packets dropped", dropped_packets);
+    }
+  }
+
+  // Aggregates everything captured so far
+  void process_all_captured() {
+    process_captured_packets();
+
+    std::vector<BtaaHciPacket> byte_counts;
+    data_byte_counters_.Drain([this, &byte_counts](Activity activity, uint16_t connection_handle, uint32_t byte_count) {
+      byte_counts.push_back(hci_processor_.OnDataByteCount(activity, connection_handle, byte_count));
+    });
+    attribution_processor_.OnBtaaByteCounts(byte_counts);
   }
 
   void on_wakelock_acquired() {
@@ -148,6 +244,8 @@ struct ActivityAttribution::impl {
   void on_wakelock_released() {
     uint32_t wakelock_duration_ms = 0;
 
+    process_all_captured();
+
     wakelock_duration_ms = wakelock_processor_.OnWakelockReleased();
     if (wakelock_duration_ms != 0) {
       attribution_processor_.OnWakelockReleased(wakelock_duration_ms);
@@ -156,6 +254,7 @@ struct ActivityAttribution::impl {
 
   void on_wakeup() {
     attribution_processor_.OnWakeup();
+    wakeup_ = true;
   }
 
   void register_callback(ActivityAttributionCallback* callback) {
@@ -168,6 +267,7 @@ struct ActivityAttribution::impl {
 
   void Dump(
       std::promise<flatbuffers::Offset<ActivityAttributionData>> promise, flatbuffers::FlatBufferBuilder* fb_builder) {
+    process_all_captured();
     attribution_processor_.Dump(std::move(promise), fb_builder);
   }
 
@@ -175,51 +275,50 @@ struct ActivityAttribution::impl {
   AttributionProcessor attribution_processor_;
   HciProcessor hci_processor_;
   WakelockProcessor wakelock_processor_;
+
+  std::unique_ptr<os::Thread> thread_;
+  std::unique_ptr<os::Handler> handler_;
+  CaptureQueue capture_queue_;
+  DataByteCounters data_byte_counters_;
+  std::atomic_bool drain_scheduled_{false};
+  std::atomic<size_t> dropped_packets_{0};
+  // Set from the wakeup notification until a queued packet was attributed the wakeup
+  std::atomic_bool wakeup_pending_{false};
+  // Whether the attribution processor waits for a packet to attribute the wakeup to, on the btaa thread
+  bool wakeup_ = false;
 };
 
 void ActivityAttribution::Capture(const hal::HciPacket& packet, hal::SnoopLogger::PacketType type) {
-  uint16_t original_length = packet.size();
-  uint16_t truncate_length;
-
-  switch (type) {
-    case hal::SnoopLogger::PacketType::CMD:
-    case hal::SnoopLogger::PacketType::EVT:
-      truncate_length = packet.size();
-      break;
-    case hal::SnoopLogger::PacketType::ACL:
-    case hal::SnoopLogger::PacketType::SCO:
-    case hal::SnoopLogger::PacketType::ISO:
-      truncate_length = kHciAclHeaderSize;
-      break;
-  }
-
-  if (!truncate_length) {
+  if (!capture_enabled_.load(std::memory_order_relaxed)) {
     return;
   }
-
-  hal::HciPacket truncate_packet(packet.begin(), packet.begin() + truncate_length);
-  CallOn(pimpl_.get(), &impl::on_hci_packet, truncate_packet, type, original_length);
+  pimpl_->capture(packet, type);
 }
 
 void ActivityAttribution::OnWakelockAcquired() {
-  CallOn(pimpl_.get(), &impl::on_wakelock_acquired);
+  pimpl_->handler_->CallOn(pimpl_.get(), &impl::on_wakelock_acquired);
 }
 
 void ActivityAttribution::OnWakelockReleased() {
-  CallOn(pimpl_.get(), &impl::on_wakelock_released);
+  pimpl_->handler_->CallOn(pimpl_.get(), &impl::on_wakelock_released);
 }
 
 void ActivityAttribution::OnWakeup() {
-  CallOn(pimpl_.get(), &impl::on_wakeup);
+  pimpl_->on_wakeup_captured();
+  pimpl_->handler_->CallOn(pimpl_.get(), &impl::on_wakeup);
 }
 
 void ActivityAttribution::RegisterActivityAttributionCallback(ActivityAttributionCallback* callback) {
-  CallOn(pimpl_.get(), &impl::register_callback, callback);
+  pimpl_->handler_->CallOn(pimpl_.get(), &impl::register_callback, callback);
 }
 
 void ActivityAttribution::NotifyActivityAttributionInfo(
     int uid, const std::string& package_name, const std::string& device_address) {
-  CallOn(pimpl_.get(), &impl::notify_activity_attribution_info, uid, package_name, device_address);
+  pimpl_->handler_->CallOn(pimpl_.get(), &impl::notify_activity_attribution_info, uid, package_name, device_address);
+}
+
+void ActivityAttribution::SetCaptureEnabled(bool enabled) {
+  capture_enabled_.store(enabled);
 }
 
 std::string ActivityAttribution::ToString() const {
@@ -241,7 +340,7 @@ DumpsysDataFinisher ActivityAttribution::GetDumpsysData(flatbuffers::FlatBufferB
 
   std::promise<flatbuffers::Offset<ActivityAttributionData>> promise;
   auto future = promise.get_future();
-  pimpl_->Dump(std::move(promise), fb_builder);
+  pimpl_->handler_->CallOn(pimpl_.get(), &impl::Dump, std::move(promise), fb_builder);
 
   auto dumpsys_data = future.get();
 
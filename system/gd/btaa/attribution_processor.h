@@ -76,6 +76,8 @@ struct AppWakeupDescriptor {
 class AttributionProcessor {
  public:
   void OnBtaaPackets(std::vector<BtaaHciPacket> btaa_packets);
+  // Adds the byte counts of data packets, which are not attributed any wakeup
+  void OnBtaaByteCounts(const std::vector<BtaaHciPacket>& btaa_packets);
   void OnWakelockReleased(uint32_t duration_ms);
   void OnWakeup();
   void NotifyActivityAttributionInfo(int uid, const std::string& package_name, const std::string& device_address);
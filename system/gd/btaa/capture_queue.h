@@ -0,0 +1,92 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "btaa/activity_attribution.h"
+#include "hal/snoop_logger.h"
+
+namespace bluetooth {
+namespace activity_attribution {
+
+// Longest prefix of a packet kept for classification: a whole command or event
+static constexpr size_t kMaxCapturedLength = 3 + 255;
+
+struct CapturedPacket {
+  hal::SnoopLogger::PacketType type;
+  // Length of the whole packet, which is what is attributed
+  uint16_t length;
+  uint16_t captured_length;
+  uint8_t data[kMaxCapturedLength];
+};
+
+// Bounded queue of the packets captured on the HCI path, towards the thread classifying them.
+//
+// The packets are captured from several threads, the one receiving from the HAL and the ones sending to it, so
+// a producer claims a slot with a compare and swap of the enqueue position and publishes it with the sequence
+// number of the slot. Neither end takes a lock or allocates. Only one thread may dequeue.
+class CaptureQueue {
+ public:
+  // Must be a power of two
+  static constexpr size_t kCapacity = 256;
+
+  CaptureQueue();
+
+  // Copies the first |captured_length| bytes of a packet of |length| bytes. Returns false when the queue is full.
+  bool TryEnqueue(hal::SnoopLogger::PacketType type, const uint8_t* data, uint16_t captured_length, uint16_t length);
+
+  // Returns false when the queue is empty
+  bool TryDequeue(CapturedPacket* packet);
+
+ private:
+  struct Slot {
+    // Equal to the enqueue position when the slot is free, to the position + 1 once it holds a packet
+    std::atomic<size_t> sequence;
+    CapturedPacket packet;
+  };
+
+  std::array<Slot, kCapacity> slots_;
+  std::atomic<size_t> enqueue_position_{0};
+  size_t dequeue_position_ = 0;
+};
+
+// Byte counts of the data packets, per activity and connection handle.
+//
+// Data packets are by far the most frequent ones and only need their connection handle to be attributed, so
+// they are counted in place rather than queued. The counters are drained by the classifying thread when the
+// aggregation is needed.
+class DataByteCounters {
+ public:
+  // Only ACL, HFP and ISO are counted
+  void Add(Activity activity, uint16_t connection_handle, uint16_t byte_count);
+
+  // Calls |on_byte_count| for each handle with a count since the last drain, and resets the counts
+  void Drain(std::function<void(Activity activity, uint16_t connection_handle, uint32_t byte_count)> on_byte_count);
+
+ private:
+  static constexpr size_t kNumConnectionHandles = 0x1000;
+  static constexpr size_t kNumActivities = 3;
+
+  std::array<std::array<std::atomic<uint32_t>, kNumConnectionHandles>, kNumActivities> byte_counts_{};
+};
+
+}  // namespace activity_attribution
+}  // namespace bluetooth
@@ -27,10 +27,10 @@ namespace activity_attribution {
 struct BtaaHciPacket {
   Activity activity;
   hci::Address address;
-  uint16_t byte_count;
+  uint32_t byte_count;
 
   BtaaHciPacket() {}
-  BtaaHciPacket(Activity activity, hci::Address address, uint16_t byte_count)
+  BtaaHciPacket(Activity activity, hci::Address address, uint32_t byte_count)
       : activity(activity), address(address), byte_count(byte_count) {}
 };
 
@@ -50,6 +50,8 @@ struct PendingCommand {
 class HciProcessor {
  public:
   std::vector<BtaaHciPacket> OnHciPacket(hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length);
+  // Attributes the bytes of the data packets counted on a connection handle
+  BtaaHciPacket OnDataByteCount(Activity activity, uint16_t connection_handle, uint32_t byte_count);
 
  private:
   void process_le_event(std::vector<BtaaHciPacket>& btaa_hci_packets, int16_t byte_count, hci::EventView& event);
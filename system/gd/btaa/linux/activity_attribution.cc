@@ -37,6 +37,8 @@ void ActivityAttribution::RegisterActivityAttributionCallback(ActivityAttributio
 void ActivityAttribution::NotifyActivityAttributionInfo(
     int uid, const std::string& package_name, const std::string& device_address) {}
 
+void ActivityAttribution::SetCaptureEnabled(bool enabled) {}
+
 std::string ActivityAttribution::ToString() const {
   return "Btaa Module";
 }
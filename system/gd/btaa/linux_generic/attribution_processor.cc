@@ -58,6 +58,16 @@ void AttributionProcessor::OnBtaaPackets(std::vector<BtaaHciPacket> btaa_packets
   wakeup_ = false;
 }
 
+void AttributionProcessor::OnBtaaByteCounts(const std::vector<BtaaHciPacket>& btaa_packets) {
+  AddressActivityKey key;
+
+  for (auto& btaa_packet : btaa_packets) {
+    key.address = btaa_packet.address;
+    key.activity = btaa_packet.activity;
+    wakelock_duration_aggregator_[key].byte_count += btaa_packet.byte_count;
+  }
+}
+
 void AttributionProcessor::OnWakelockReleased(uint32_t duration_ms) {
   uint32_t total_byte_count = 0;
 
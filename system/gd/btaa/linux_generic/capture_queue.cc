@@ -0,0 +1,117 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btaa/capture_queue.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bluetooth {
+namespace activity_attribution {
+
+static_assert((CaptureQueue::kCapacity & (CaptureQueue::kCapacity - 1)) == 0, "kCapacity must be a power of two");
+
+CaptureQueue::CaptureQueue() {
+  for (size_t i = 0; i < kCapacity; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool CaptureQueue::TryEnqueue(
+    hal::SnoopLogger::PacketType type, const uint8_t* data, uint16_t captured_length, uint16_t length) {
+  Slot* slot;
+  size_t position = enqueue_position_.load(std::memory_order_relaxed);
+  for (;;) {
+    slot = &slots_[position & (kCapacity - 1)];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The slot still holds the packet enqueued one lap earlier
+      return false;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->packet.type = type;
+  slot->packet.length = length;
+  slot->packet.captured_length = std::min<size_t>(captured_length, kMaxCapturedLength);
+  memcpy(slot->packet.data, data, slot->packet.captured_length);
+  slot->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+bool CaptureQueue::TryDequeue(CapturedPacket* packet) {
+  Slot* slot = &slots_[dequeue_position_ & (kCapacity - 1)];
+  size_t sequence = slot->sequence.load(std::memory_order_acquire);
+  if ((intptr_t)sequence - (intptr_t)(dequeue_position_ + 1) < 0) {
+    return false;
+  }
+
+  packet->type = slot->packet.type;
+  packet->length = slot->packet.length;
+  packet->captured_length = slot->packet.captured_length;
+  memcpy(packet->data, slot->packet.data, slot->packet.captured_length);
+  slot->sequence.store(dequeue_position_ + kCapacity, std::memory_order_release);
+  dequeue_position_++;
+  return true;
+}
+
+static int ActivityIndex(Activity activity) {
+  switch (activity) {
+    case Activity::ACL:
+      return 0;
+    case Activity::HFP:
+      return 1;
+    case Activity::ISO:
+      return 2;
+    default:
+      return -1;
+  }
+}
+
+void DataByteCounters::Add(Activity activity, uint16_t connection_handle, uint16_t byte_count) {
+  int index = ActivityIndex(activity);
+  if (index < 0) {
+    return;
+  }
+  byte_counts_[index][connection_handle & (kNumConnectionHandles - 1)].fetch_add(
+      byte_count, std::memory_order_relaxed);
+}
+
+void DataByteCounters::Drain(
+    std::function<void(Activity activity, uint16_t connection_handle, uint32_t byte_count)> on_byte_count) {
+  for (Activity activity : {Activity::ACL, Activity::HFP, Activity::ISO}) {
+    auto& byte_counts = byte_counts_[ActivityIndex(activity)];
+    for (size_t handle = 0; handle < kNumConnectionHandles; handle++) {
+      // Loaded first so that idle handles are not written to
+      if (byte_counts[handle].load(std::memory_order_relaxed) == 0) {
+        continue;
+      }
+      uint32_t byte_count = byte_counts[handle].exchange(0, std::memory_order_relaxed);
+      if (byte_count != 0) {
+        on_byte_count(activity, handle, byte_count);
+      }
+    }
+  }
+}
+
+}  // namespace activity_attribution
+}  // namespace bluetooth
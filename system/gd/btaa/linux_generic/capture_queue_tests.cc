@@ -0,0 +1,128 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btaa/capture_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace bluetooth::activity_attribution;
+using bluetooth::hal::SnoopLogger;
+
+class CaptureQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    queue_ = std::make_unique<CaptureQueue>();
+  }
+
+  std::unique_ptr<CaptureQueue> queue_;
+};
+
+TEST_F(CaptureQueueTest, dequeue_in_order) {
+  CapturedPacket packet;
+  ASSERT_FALSE(queue_->TryDequeue(&packet));
+
+  uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+  ASSERT_TRUE(queue_->TryEnqueue(SnoopLogger::PacketType::CMD, data, 3, 3));
+  ASSERT_TRUE(queue_->TryEnqueue(SnoopLogger::PacketType::ACL, data, 4, 1000));
+
+  ASSERT_TRUE(queue_->TryDequeue(&packet));
+  ASSERT_EQ(SnoopLogger::PacketType::CMD, packet.type);
+  ASSERT_EQ(3, packet.length);
+  ASSERT_EQ(3, packet.captured_length);
+  ASSERT_EQ(0x03, packet.data[2]);
+
+  ASSERT_TRUE(queue_->TryDequeue(&packet));
+  ASSERT_EQ(SnoopLogger::PacketType::ACL, packet.type);
+  ASSERT_EQ(1000, packet.length);
+  ASSERT_EQ(4, packet.captured_length);
+
+  ASSERT_FALSE(queue_->TryDequeue(&packet));
+}
+
+TEST_F(CaptureQueueTest, full_queue_drops_packets) {
+  uint8_t data[] = {0x0e, 0x00};
+  for (size_t i = 0; i < CaptureQueue::kCapacity; i++) {
+    ASSERT_TRUE(queue_->TryEnqueue(SnoopLogger::PacketType::EVT, data, sizeof(data), sizeof(data)));
+  }
+  ASSERT_FALSE(queue_->TryEnqueue(SnoopLogger::PacketType::EVT, data, sizeof(data), sizeof(data)));
+
+  CapturedPacket packet;
+  ASSERT_TRUE(queue_->TryDequeue(&packet));
+  ASSERT_TRUE(queue_->TryEnqueue(SnoopLogger::PacketType::EVT, data, sizeof(data), sizeof(data)));
+}
+
+TEST_F(CaptureQueueTest, concurrent_producers) {
+  constexpr int kNumProducers = 4;
+  constexpr int kPacketsPerProducer = 10000;
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kNumProducers; producer++) {
+    producers.emplace_back([this, producer]() {
+      for (int i = 0; i < kPacketsPerProducer; i++) {
+        uint8_t data[] = {(uint8_t)producer, (uint8_t)(i & 0xff), (uint8_t)(i >> 8)};
+        while (!queue_->TryEnqueue(SnoopLogger::PacketType::EVT, data, sizeof(data), sizeof(data))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Each producer's packets come out in the order they were queued
+  std::map<int, int> next_packet;
+  int dequeued = 0;
+  CapturedPacket packet;
+  while (dequeued < kNumProducers * kPacketsPerProducer) {
+    if (!queue_->TryDequeue(&packet)) {
+      std::this_thread::yield();
+      continue;
+    }
+    int producer = packet.data[0];
+    ASSERT_EQ(next_packet[producer], packet.data[1] | (packet.data[2] << 8));
+    next_packet[producer]++;
+    dequeued++;
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+}
+
+TEST(DataByteCountersTest, drain_resets_counts) {
+  auto counters = std::make_unique<DataByteCounters>();
+  counters->Add(Activity::ACL, 0x0001, 100);
+  counters->Add(Activity::ACL, 0x0001, 50);
+  counters->Add(Activity::ISO, 0x0060, 20);
+  counters->Add(Activity::SCAN, 0x0001, 20);
+
+  std::map<std::pair<Activity, uint16_t>, uint32_t> byte_counts;
+  auto drain = [&byte_counts](Activity activity, uint16_t connection_handle, uint32_t byte_count) {
+    byte_counts[{activity, connection_handle}] += byte_count;
+  };
+
+  counters->Drain(drain);
+  ASSERT_EQ(2U, byte_counts.size());
+  ASSERT_EQ(150U, (byte_counts[{Activity::ACL, 0x0001}]));
+  ASSERT_EQ(20U, (byte_counts[{Activity::ISO, 0x0060}]));
+
+  byte_counts.clear();
+  counters->Drain(drain);
+  ASSERT_TRUE(byte_counts.empty());
+}
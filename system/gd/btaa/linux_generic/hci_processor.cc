@@ -240,6 +240,12 @@ void HciProcessor::process_iso(
   btaa_hci_packets.push_back(BtaaHciPacket(Activity::ISO, address_value, byte_count));
 }
 
+BtaaHciPacket HciProcessor::OnDataByteCount(Activity activity, uint16_t connection_handle, uint32_t byte_count) {
+  hci::Address address_value;
+  device_parser_.match_handle_with_address(connection_handle, address_value);
+  return BtaaHciPacket(activity, address_value, byte_count);
+}
+
 std::vector<BtaaHciPacket> HciProcessor::OnHciPacket(
     hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length) {
   std::vector<BtaaHciPacket> btaa_hci_packets;
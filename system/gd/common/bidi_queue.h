@@ -53,6 +53,10 @@ class BidiQueueEnd : public ::bluetooth::os::IQueueEnqueue<TENQUEUE>, public ::b
     return rx_->TryDequeue();
   }
 
+  std::vector<std::unique_ptr<TDEQUEUE>> TryDequeueBatch(size_t max_items) override {
+    return rx_->TryDequeueBatch(max_items);
+  }
+
  private:
   ::bluetooth::os::IQueueEnqueue<TENQUEUE>* tx_;
   ::bluetooth::os::IQueueDequeue<TDEQUEUE>* rx_;
@@ -21,6 +21,7 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <utility>
 
 namespace bluetooth {
 namespace common {
@@ -85,9 +86,9 @@ template <typename T>
 bluetooth::common::CircularBuffer<T>::CircularBuffer(size_t size) : size_(size) {}
 
 template <typename T>
-void bluetooth::common::CircularBuffer<T>::Push(const T item) {
+void bluetooth::common::CircularBuffer<T>::Push(T item) {
   std::unique_lock<std::mutex> lock(mutex_);
-  queue_.push_back(item);
+  queue_.push_back(std::move(item));
   while (queue_.size() > size_) {
     queue_.pop_front();
   }
@@ -113,9 +114,9 @@ bluetooth::common::TimestampedCircularBuffer<T>::TimestampedCircularBuffer(
     : CircularBuffer<TimestampedEntry<T>>(size), timestamper_(std::move(timestamper)) {}
 
 template <typename T>
-void bluetooth::common::TimestampedCircularBuffer<T>::Push(const T item) {
-  TimestampedEntry<T> timestamped_entry{timestamper_->GetTimestamp(), item};
-  bluetooth::common::CircularBuffer<TimestampedEntry<T>>::Push(timestamped_entry);
+void bluetooth::common::TimestampedCircularBuffer<T>::Push(T item) {
+  TimestampedEntry<T> timestamped_entry{timestamper_->GetTimestamp(), std::move(item)};
+  bluetooth::common::CircularBuffer<TimestampedEntry<T>>::Push(std::move(timestamped_entry));
 }
 
 template <typename T>
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "common/callback.h"
+
+namespace bluetooth {
+namespace common {
+
+// A move only task that runs once, like OnceClosure. A callable of up to kInlineSize bytes, such as a lambda with a
+// few captures, is stored inside the task instead of in a heap allocated BindState; a larger one is moved to the heap.
+// A OnceClosure is stored as is.
+class InlineTask {
+ public:
+  static constexpr size_t kInlineSize = 4 * sizeof(void*);
+
+  InlineTask() = default;
+
+  InlineTask(OnceClosure closure)
+      : InlineTask([closure = std::move(closure)]() mutable { std::move(closure).Run(); }) {}
+
+  template <
+      typename Functor,
+      typename = std::enable_if_t<
+          !std::is_same_v<std::decay_t<Functor>, InlineTask> && !std::is_same_v<std::decay_t<Functor>, OnceClosure>>>
+  InlineTask(Functor&& functor) {
+    using F = std::decay_t<Functor>;
+    if constexpr (fits_inline<F>()) {
+      new (storage_) F(std::forward<Functor>(functor));
+      ops_ = &kInlineOps<F>;
+    } else {
+      *reinterpret_cast<F**>(storage_) = new F(std::forward<Functor>(functor));
+      ops_ = &kHeapOps<F>;
+    }
+  }
+
+  InlineTask(InlineTask&& other) noexcept : ops_(other.ops_) {
+    if (ops_ != nullptr) {
+      ops_->move(other.storage_, storage_);
+      other.ops_ = nullptr;
+    }
+  }
+
+  InlineTask& operator=(InlineTask&& other) noexcept {
+    if (this != &other) {
+      reset();
+      ops_ = other.ops_;
+      if (ops_ != nullptr) {
+        ops_->move(other.storage_, storage_);
+        other.ops_ = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  InlineTask(const InlineTask&) = delete;
+  InlineTask& operator=(const InlineTask&) = delete;
+
+  ~InlineTask() {
+    reset();
+  }
+
+  bool is_null() const {
+    return ops_ == nullptr;
+  }
+
+  // Whether the callable is stored inside the task
+  bool is_inline() const {
+    return ops_ != nullptr && ops_->is_inline;
+  }
+
+  void Run() && {
+    InlineTask task = std::move(*this);
+    task.ops_->run(task.storage_);
+  }
+
+ private:
+  struct Ops {
+    void (*run)(void* storage);
+    // Move the callable from one storage to another and destroy |from|
+    void (*move)(void* from, void* to);
+    void (*destroy)(void* storage);
+    bool is_inline;
+  };
+
+  template <typename F>
+  static constexpr bool fits_inline() {
+    return sizeof(F) <= kInlineSize && alignof(F) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<F>;
+  }
+
+  template <typename F>
+  static constexpr Ops kInlineOps = {
+      [](void* storage) { (*std::launder(reinterpret_cast<F*>(storage)))(); },
+      [](void* from, void* to) {
+        F* f = std::launder(reinterpret_cast<F*>(from));
+        new (to) F(std::move(*f));
+        f->~F();
+      },
+      [](void* storage) { std::launder(reinterpret_cast<F*>(storage))->~F(); },
+      true,
+  };
+
+  template <typename F>
+  static constexpr Ops kHeapOps = {
+      [](void* storage) { (**reinterpret_cast<F**>(storage))(); },
+      [](void* from, void* to) { *reinterpret_cast<F**>(to) = *reinterpret_cast<F**>(from); },
+      [](void* storage) { delete *reinterpret_cast<F**>(storage); },
+      false,
+  };
+
+  void reset() {
+    if (ops_ != nullptr) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+  const Ops* ops_ = nullptr;
+};
+
+}  // namespace common
+}  // namespace bluetooth
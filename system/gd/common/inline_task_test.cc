@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/inline_task.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <utility>
+
+#include "common/bind.h"
+
+namespace testing {
+
+using bluetooth::common::InlineTask;
+
+TEST(InlineTaskTest, empty_test) {
+  InlineTask task;
+  EXPECT_TRUE(task.is_null());
+  EXPECT_FALSE(task.is_inline());
+}
+
+TEST(InlineTaskTest, small_lambda_is_inline_test) {
+  int val = 0;
+  InlineTask task([&val]() { val++; });
+  EXPECT_FALSE(task.is_null());
+  EXPECT_TRUE(task.is_inline());
+  std::move(task).Run();
+  EXPECT_EQ(val, 1);
+  EXPECT_TRUE(task.is_null());
+}
+
+TEST(InlineTaskTest, large_lambda_is_on_heap_test) {
+  std::array<int, 32> values{};
+  values[31] = 42;
+  int val = 0;
+  InlineTask task([&val, values]() { val = values[31]; });
+  EXPECT_FALSE(task.is_inline());
+  InlineTask moved = std::move(task);
+  EXPECT_TRUE(task.is_null());
+  std::move(moved).Run();
+  EXPECT_EQ(val, 42);
+}
+
+TEST(InlineTaskTest, once_closure_test) {
+  int val = 0;
+  InlineTask task(bluetooth::common::BindOnce([](int* val) { *val = 7; }, bluetooth::common::Unretained(&val)));
+  EXPECT_TRUE(task.is_inline());
+  std::move(task).Run();
+  EXPECT_EQ(val, 7);
+}
+
+TEST(InlineTaskTest, move_only_capture_test) {
+  auto number = std::make_unique<int>(5);
+  auto to_change = std::make_shared<int>(0);
+  InlineTask task([number = std::move(number), to_change]() { *to_change = *number; });
+  EXPECT_TRUE(task.is_inline());
+  InlineTask other;
+  other = std::move(task);
+  std::move(other).Run();
+  EXPECT_EQ(*to_change, 5);
+}
+
+TEST(InlineTaskTest, destroyed_without_running_test) {
+  auto counted = std::make_shared<int>(0);
+  {
+    InlineTask small([counted]() {});
+    std::array<std::shared_ptr<int>, 8> many;
+    many.fill(counted);
+    InlineTask large([many = std::move(many)]() {});
+    EXPECT_EQ(counted.use_count(), 10);
+  }
+  EXPECT_EQ(counted.use_count(), 1);
+}
+
+}  // namespace testing
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/circular_buffer.h"
+
+namespace bluetooth {
+namespace common {
+
+// Milliseconds since the epoch, read from the monotonic clock: the epoch is only read once, so the timestamps never go
+// back when the wall clock is set.
+class MonotonicTimestamperInMilliseconds : public Timestamper {
+ public:
+  MonotonicTimestamperInMilliseconds()
+      : epoch_start_(std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count()),
+        start_(std::chrono::steady_clock::now()) {}
+
+  long long GetTimestamp() const override {
+    return epoch_start_ +
+           std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count();
+  }
+  virtual ~MonotonicTimestamperInMilliseconds() {}
+
+ private:
+  const long long epoch_start_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+// Fixed capacity variant of TimestampedCircularBuffer, for the history buffers written on hot paths
+//
+// The entries are stored in place, so that pushing never allocates nor locks, and any number of threads can push at
+// once. Pull() and Drain() are for a single reader, i.e. dumpsys: they copy the entries, and skip the ones a writer is
+// replacing while they are read. An entry is also dropped, and counted, when its writer finds the slot still being
+// written by another one, which only happens when capacity entries are pushed during a single push.
+template <typename T, size_t kCapacity>
+class LockFreeTimestampedCircularBuffer {
+  static_assert(std::is_trivially_copyable<T>::value, "entries are copied while they may be written");
+  static_assert(kCapacity > 0 && (kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of two");
+
+ public:
+  explicit LockFreeTimestampedCircularBuffer(
+      std::unique_ptr<Timestamper> timestamper = std::make_unique<MonotonicTimestamperInMilliseconds>())
+      : timestamper_(std::move(timestamper)) {}
+
+  // Push one item to the circular buffer
+  void Push(const T& item);
+  // Take a snapshot of the circular buffer and return it as a vector
+  std::vector<TimestampedEntry<T>> Pull() const;
+  // Drain everything from the circular buffer and return them as a vector
+  std::vector<TimestampedEntry<T>> Drain();
+
+  // Number of entries dropped because of a concurrent writer
+  uint64_t GetDroppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // The entries are copied word by word with relaxed atomics, which readers racing with a writer may see torn, but
+  // without a data race
+  static constexpr size_t kWords = (sizeof(TimestampedEntry<T>) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  struct Slot {
+    // 2 * ticket + 1 while the entry of |ticket| is written, 2 * ticket + 2 once written, 0 if never written
+    std::atomic<uint64_t> sequence{0};
+    std::array<std::atomic<uint64_t>, kWords> words{};
+  };
+
+  std::vector<TimestampedEntry<T>> Read(uint64_t first, uint64_t last) const;
+
+  std::unique_ptr<Timestamper> timestamper_;
+  // Ticket of the next entry, and of the first one not drained
+  std::atomic<uint64_t> next_{0};
+  std::atomic<uint64_t> drained_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::array<Slot, kCapacity> slots_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
+
+template <typename T, size_t kCapacity>
+void bluetooth::common::LockFreeTimestampedCircularBuffer<T, kCapacity>::Push(const T& item) {
+  const uint64_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[ticket & (kCapacity - 1)];
+
+  // Claim the slot, unless a writer is still in it or a newer entry was already written there
+  uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  if ((sequence & 1) != 0 || sequence > 2 * ticket ||
+      !slot.sequence.compare_exchange_strong(sequence, 2 * ticket + 1, std::memory_order_relaxed)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  TimestampedEntry<T> value{timestamper_->GetTimestamp(), item};
+  uint64_t words[kWords] = {};
+  std::memcpy(words, &value, sizeof(value));
+  for (size_t i = 0; i < kWords; i++) {
+    slot.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot.sequence.store(2 * ticket + 2, std::memory_order_release);
+}
+
+template <typename T, size_t kCapacity>
+std::vector<bluetooth::common::TimestampedEntry<T>>
+bluetooth::common::LockFreeTimestampedCircularBuffer<T, kCapacity>::Read(uint64_t first, uint64_t last) const {
+  std::vector<TimestampedEntry<T>> items;
+  items.reserve(last - first);
+  for (uint64_t ticket = first; ticket < last; ticket++) {
+    const Slot& slot = slots_[ticket & (kCapacity - 1)];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * ticket + 2) {
+      continue;
+    }
+    uint64_t words[kWords];
+    for (size_t i = 0; i < kWords; i++) {
+      words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+    TimestampedEntry<T>& value = items.emplace_back();
+    std::memcpy(&value, words, sizeof(value));
+  }
+  return items;
+}
+
+template <typename T, size_t kCapacity>
+std::vector<bluetooth::common::TimestampedEntry<T>>
+bluetooth::common::LockFreeTimestampedCircularBuffer<T, kCapacity>::Pull() const {
+  const uint64_t last = next_.load(std::memory_order_acquire);
+  const uint64_t first = std::max(drained_.load(std::memory_order_relaxed), last > kCapacity ? last - kCapacity : 0);
+  return Read(first, last);
+}
+
+template <typename T, size_t kCapacity>
+std::vector<bluetooth::common::TimestampedEntry<T>>
+bluetooth::common::LockFreeTimestampedCircularBuffer<T, kCapacity>::Drain() {
+  const uint64_t last = next_.load(std::memory_order_acquire);
+  const uint64_t first = std::max(drained_.load(std::memory_order_relaxed), last > kCapacity ? last - kCapacity : 0);
+  drained_.store(last, std::memory_order_relaxed);
+  return Read(first, last);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/lock_free_circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace testing {
+
+using bluetooth::common::LockFreeTimestampedCircularBuffer;
+using bluetooth::common::MonotonicTimestamperInMilliseconds;
+using bluetooth::common::Timestamper;
+
+struct CountingTimestamper : public Timestamper {
+  long long GetTimestamp() const override {
+    return timestamp_++;
+  }
+  mutable long long timestamp_{0};
+};
+
+TEST(LockFreeCircularBufferTest, pull) {
+  LockFreeTimestampedCircularBuffer<int, 4> buffer(std::make_unique<CountingTimestamper>());
+  buffer.Push(1);
+  buffer.Push(2);
+  buffer.Push(3);
+
+  auto vec = buffer.Pull();
+  ASSERT_EQ(3ul, vec.size());
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(i + 1, vec[i].entry);
+    ASSERT_EQ(i, vec[i].timestamp);
+  }
+  ASSERT_EQ(3ul, buffer.Pull().size());
+}
+
+TEST(LockFreeCircularBufferTest, drain) {
+  LockFreeTimestampedCircularBuffer<int, 4> buffer;
+  buffer.Push(1);
+  buffer.Push(2);
+
+  ASSERT_EQ(2ul, buffer.Drain().size());
+  ASSERT_TRUE(buffer.Pull().empty());
+
+  buffer.Push(3);
+  auto vec = buffer.Drain();
+  ASSERT_EQ(1ul, vec.size());
+  ASSERT_EQ(3, vec[0].entry);
+}
+
+TEST(LockFreeCircularBufferTest, oldest_entries_are_replaced) {
+  LockFreeTimestampedCircularBuffer<int, 4> buffer;
+  for (int i = 0; i < 10; i++) {
+    buffer.Push(i);
+  }
+
+  auto vec = buffer.Pull();
+  ASSERT_EQ(4ul, vec.size());
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(6 + i, vec[i].entry);
+  }
+  ASSERT_EQ(0u, buffer.GetDroppedCount());
+}
+
+TEST(LockFreeCircularBufferTest, concurrent_writers) {
+  constexpr int kWriters = 4;
+  constexpr int kEntries = 10000;
+  LockFreeTimestampedCircularBuffer<int, 64> buffer;
+
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kWriters; w++) {
+    writers.emplace_back([&buffer, w]() {
+      for (int i = 0; i < kEntries; i++) {
+        buffer.Push(w * kEntries + i);
+      }
+    });
+  }
+  for (int i = 0; i < 100; i++) {
+    for (const auto& v : buffer.Pull()) {
+      ASSERT_GE(v.entry, 0);
+      ASSERT_LT(v.entry, kWriters * kEntries);
+    }
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+
+  auto vec = buffer.Pull();
+  ASSERT_LE(vec.size(), 64ul);
+  ASSERT_FALSE(vec.empty());
+}
+
+TEST(LockFreeCircularBufferTest, monotonic_timestamps) {
+  MonotonicTimestamperInMilliseconds timestamper;
+  long long first = timestamper.GetTimestamp();
+  ASSERT_GT(first, 0);
+  ASSERT_GE(timestamper.GetTimestamp(), first);
+}
+
+}  // namespace testing
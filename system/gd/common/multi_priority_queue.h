@@ -19,7 +19,9 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <queue>
+#include <utility>
 
 namespace bluetooth {
 namespace common {
@@ -29,46 +31,90 @@ namespace common {
  * Items with greater priority value will be dequeued first.
  * When Enqueuing, the user can specify the priority (0 by default).
  * This can be used by ACL or L2CAP lower queue end sender to prioritize some link or channel, used by A2DP.
+ *
+ * The non empty priority levels are kept in a bitmap, so that the front item is found in constant time.
+ *
+ * Aging is disabled by default. When enabled with SetMaxSkips(), an item which waited for that many pops is dequeued
+ * before the newer items of greater priority, so that the lower priorities are not starved.
  */
 template <typename T, int NUM_PRIORITY_LEVELS = 2>
 class MultiPriorityQueue {
   static_assert(NUM_PRIORITY_LEVELS > 1);
+  static_assert(NUM_PRIORITY_LEVELS <= 64, "the non empty levels are kept in a 64 bit bitmap");
 
  public:
   // Get the front item with the highest priority.  Queue must be non-empty.
   T& front() {
-    return queues_[next_to_dequeue_.top()].front();
+    return queues_[next_level()].front().first;
   }
 
   [[nodiscard]] bool empty() const {
-    return next_to_dequeue_.empty();
+    return size_ == 0;
   }
 
   [[nodiscard]] size_t size() const {
-    return next_to_dequeue_.size();
+    return size_;
   }
 
   // Push the item with specified priority
   void push(const T& t, int priority = 0) {
-    queues_[priority].push(t);
-    next_to_dequeue_.push(priority);
+    queues_[priority].emplace(t, num_pops_);
+    non_empty_levels_ |= uint64_t{1} << priority;
+    size_++;
   }
 
   // Push the item with specified priority
   void push(T&& t, int priority = 0) {
-    queues_[priority].push(std::forward<T>(t));
-    next_to_dequeue_.push(priority);
+    queues_[priority].emplace(std::forward<T>(t), num_pops_);
+    non_empty_levels_ |= uint64_t{1} << priority;
+    size_++;
   }
 
   // Pop the item in the front
   void pop() {
-    queues_[next_to_dequeue_.top()].pop();
-    next_to_dequeue_.pop();
+    int level = next_level();
+    queues_[level].pop();
+    if (queues_[level].empty()) {
+      non_empty_levels_ &= ~(uint64_t{1} << level);
+    }
+    size_--;
+    num_pops_++;
+  }
+
+  // Dequeue the items which waited for |max_skips| pops before the newer ones, 0 disables aging
+  void SetMaxSkips(uint64_t max_skips) {
+    max_skips_ = max_skips;
   }
 
  private:
-  std::array<std::queue<T>, NUM_PRIORITY_LEVELS> queues_;
-  std::priority_queue<int> next_to_dequeue_;
+  int next_level() const {
+    int top = 63 - __builtin_clzll(non_empty_levels_);
+    if (max_skips_ == 0) {
+      return top;
+    }
+
+    // The oldest item of each level is at its front
+    int level = top;
+    uint64_t oldest = queues_[top].front().second;
+    uint64_t lower_levels = non_empty_levels_ & ~(uint64_t{1} << top);
+    while (lower_levels != 0) {
+      int lower = 63 - __builtin_clzll(lower_levels);
+      lower_levels &= ~(uint64_t{1} << lower);
+      uint64_t pushed_at = queues_[lower].front().second;
+      if (num_pops_ - pushed_at >= max_skips_ && pushed_at < oldest) {
+        level = lower;
+        oldest = pushed_at;
+      }
+    }
+    return level;
+  }
+
+  // Each item is kept with the number of pops when it was pushed
+  std::array<std::queue<std::pair<T, uint64_t>>, NUM_PRIORITY_LEVELS> queues_;
+  uint64_t non_empty_levels_ = 0;
+  size_t size_ = 0;
+  uint64_t num_pops_ = 0;
+  uint64_t max_skips_ = 0;
 };
 
 }  // namespace common
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/multi_priority_queue.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+// Traffic classes, from the lowest priority
+enum TrafficClass : int { kBulk, kInteractive, kAudio, kControl, kNumTrafficClasses };
+
+// Share of the pushes of each traffic class, in percent
+constexpr std::array<int, kNumTrafficClasses> kMixedWorkload{70, 15, 10, 5};
+
+std::vector<int> MakeWorkload(size_t size) {
+  std::mt19937 generator(42);
+  std::discrete_distribution<int> distribution(kMixedWorkload.begin(), kMixedWorkload.end());
+  std::vector<int> priorities(size);
+  for (auto& priority : priorities) {
+    priority = distribution(generator);
+  }
+  return priorities;
+}
+
+// Keeps state.range(0) items queued, and pushes one item of the mixed workload for each pop
+template <int NUM_PRIORITY_LEVELS>
+void RunMixedWorkload(State& state, uint64_t max_skips) {
+  const size_t depth = state.range(0);
+  const std::vector<int> priorities = MakeWorkload(4096);
+  MultiPriorityQueue<uint32_t, NUM_PRIORITY_LEVELS> queue;
+  queue.SetMaxSkips(max_skips);
+
+  size_t next = 0;
+  auto push = [&]() {
+    int priority = priorities[next++ % priorities.size()] * NUM_PRIORITY_LEVELS / kNumTrafficClasses;
+    queue.push(static_cast<uint32_t>(next), priority);
+  };
+  for (size_t i = 0; i < depth; i++) {
+    push();
+  }
+
+  for (auto _ : state) {
+    push();
+    benchmark::DoNotOptimize(queue.front());
+    queue.pop();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+static void BM_MultiPriorityQueue_TwoLevels(State& state) {
+  RunMixedWorkload<2>(state, 0);
+}
+BENCHMARK(BM_MultiPriorityQueue_TwoLevels)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_MultiPriorityQueue_TrafficClasses(State& state) {
+  RunMixedWorkload<kNumTrafficClasses>(state, 0);
+}
+BENCHMARK(BM_MultiPriorityQueue_TrafficClasses)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_MultiPriorityQueue_TrafficClassesWithAging(State& state) {
+  RunMixedWorkload<kNumTrafficClasses>(state, 64);
+}
+BENCHMARK(BM_MultiPriorityQueue_TrafficClassesWithAging)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_MultiPriorityQueue_SixtyFourLevelsWithAging(State& state) {
+  RunMixedWorkload<64>(state, 64);
+}
+BENCHMARK(BM_MultiPriorityQueue_SixtyFourLevelsWithAging)->Arg(16)->Arg(256)->Arg(4096);
+
+}  // namespace common
+}  // namespace bluetooth
@@ -18,6 +18,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "common/multi_priority_queue.h"
 
 namespace bluetooth {
@@ -59,5 +61,48 @@ TEST(MultiPriorityQueueTest, with_multiple_priority_item) {
   }
 }
 
+TEST(MultiPriorityQueueTest, with_many_priority_levels) {
+  common::MultiPriorityQueue<int, 64> q;
+  q.push(2, 0);
+  q.push(0, 63);
+  q.push(1, 31);
+  q.push(3, 0);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(q.front(), i);
+    q.pop();
+  }
+  ASSERT_TRUE(q.empty());
+}
+
+TEST(MultiPriorityQueueTest, without_aging_low_priority_starves) {
+  common::MultiPriorityQueue<int, 2> q;
+  q.push(-1, 0);
+  for (int i = 0; i < 10; i++) {
+    q.push(i, 1);
+    ASSERT_EQ(q.front(), i);
+    q.pop();
+  }
+  ASSERT_EQ(q.front(), -1);
+}
+
+TEST(MultiPriorityQueueTest, with_aging) {
+  common::MultiPriorityQueue<int, 3> q;
+  q.SetMaxSkips(3);
+  q.push(-2, 0);
+  q.push(-1, 1);
+
+  // A new high priority item is pushed before each pop
+  std::vector<int> popped;
+  for (int i = 0; i < 8; i++) {
+    q.push(i, 2);
+    popped.push_back(q.front());
+    q.pop();
+  }
+
+  // The low priority items are dequeued once they waited for 3 pops, before the newer high priority ones
+  std::vector<int> expected{0, 1, 2, -1, -2, 3, 4, 5};
+  ASSERT_EQ(popped, expected);
+}
+
 }  // namespace common
 }  // namespace bluetooth
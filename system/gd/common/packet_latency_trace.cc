@@ -0,0 +1,314 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "BtPacketLatencyTrace"
+
+#include "common/packet_latency_trace.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#if defined(__ANDROID__)
+#include <cutils/trace.h>
+#endif /* defined(__ANDROID__) */
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+// Samples in flight, a sample that does not reach its last stage is overwritten by a later one
+constexpr size_t kMaxSamples = 32;
+constexpr size_t kMaxTaggedBuffers = 16;
+
+typedef struct {
+  uint32_t id;
+  PacketLatencyStage stage;
+  std::chrono::steady_clock::time_point start_timestamp;
+  std::chrono::steady_clock::time_point stage_timestamp;
+} Sample;
+
+typedef struct {
+  const void* buffer;
+  uint32_t sample_id;
+} BufferTag;
+
+std::atomic<uint32_t> sampling_rate;
+std::atomic<uint32_t> packet_count;
+// Checked without the lock so that the untagged buffers are not slowed down
+std::atomic<size_t> tagged_buffer_count;
+
+std::mutex packet_latency_trace_mutex;
+uint32_t next_sample_id = 1;
+Sample samples[kMaxSamples];
+BufferTag buffer_tags[kMaxTaggedBuffers];
+size_t next_buffer_tag;
+PacketLatencyHistogram histograms[static_cast<size_t>(PacketLatencyStage::COUNT)];
+PacketLatencyHistogram total_histogram;
+
+void add_to_histogram(PacketLatencyHistogram* histogram, std::chrono::steady_clock::duration latency) {
+  uint64_t latency_us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  size_t bucket = 0;
+  while (bucket < kPacketLatencyHistogramBuckets - 1 && latency_us >= (1ull << bucket)) {
+    bucket++;
+  }
+  histogram->buckets[bucket]++;
+  histogram->count++;
+  histogram->total_us += latency_us;
+  if (latency_us > histogram->max_us) {
+    histogram->max_us = latency_us;
+  }
+}
+
+#if defined(__ANDROID__)
+void trace_stage_begin(const Sample& sample) {
+  if (atrace_is_tag_enabled(ATRACE_TAG_BLUETOOTH)) {
+    atrace_async_begin(ATRACE_TAG_BLUETOOTH, PacketLatencyStageText(sample.stage), sample.id);
+  }
+}
+
+void trace_stage_end(const Sample& sample) {
+  if (atrace_is_tag_enabled(ATRACE_TAG_BLUETOOTH)) {
+    atrace_async_end(ATRACE_TAG_BLUETOOTH, PacketLatencyStageText(sample.stage), sample.id);
+  }
+}
+#else
+void trace_stage_begin(const Sample&) {}
+void trace_stage_end(const Sample&) {}
+#endif /* defined(__ANDROID__) */
+
+// Return the sample in flight with |sample_id|, nullptr if it ended or was overwritten
+Sample* find_sample(uint32_t sample_id) {
+  Sample* sample = &samples[sample_id % kMaxSamples];
+  return sample->id == sample_id ? sample : nullptr;
+}
+
+// The sample leaves its previous stage and reaches |stage|
+void record_stage(Sample* sample, PacketLatencyStage stage) {
+  auto now = std::chrono::steady_clock::now();
+  add_to_histogram(&histograms[static_cast<size_t>(stage)], now - sample->stage_timestamp);
+  trace_stage_end(*sample);
+  sample->stage = stage;
+  sample->stage_timestamp = now;
+}
+
+}  // namespace
+
+const char* PacketLatencyStageText(PacketLatencyStage stage) {
+  switch (stage) {
+    case PacketLatencyStage::HAL_READ:
+      return "hal_read";
+    case PacketLatencyStage::HCI_LAYER:
+      return "hci_layer";
+    case PacketLatencyStage::ACL_ASSEMBLER:
+      return "acl_assembler";
+    case PacketLatencyStage::L2CAP:
+      return "l2cap";
+    case PacketLatencyStage::RFCOMM:
+      return "rfcomm";
+    case PacketLatencyStage::GATT:
+      return "gatt";
+    case PacketLatencyStage::BTIF_SOCKET:
+      return "btif_socket";
+    case PacketLatencyStage::COUNT:
+      break;
+  }
+  return "unknown";
+}
+
+void PacketLatencyTrace::SetSamplingRate(uint32_t rate) {
+  sampling_rate = rate;
+  if (rate != 0) {
+    LOG_INFO("Tracing the latency of 1 in %u incoming ACL packets", rate);
+  }
+}
+
+uint32_t PacketLatencyTrace::GetSamplingRate() {
+  return sampling_rate.load(std::memory_order_relaxed);
+}
+
+uint32_t PacketLatencyTrace::StartSample() {
+  uint32_t rate = sampling_rate.load(std::memory_order_relaxed);
+  if (rate == 0 || packet_count.fetch_add(1, std::memory_order_relaxed) % rate != 0) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  uint32_t sample_id = next_sample_id++;
+  if (next_sample_id == 0) {
+    next_sample_id = 1;
+  }
+  Sample* sample = &samples[sample_id % kMaxSamples];
+  auto now = std::chrono::steady_clock::now();
+  *sample = Sample{sample_id, PacketLatencyStage::HAL_READ, now, now};
+  trace_stage_begin(*sample);
+  return sample_id;
+}
+
+void PacketLatencyTrace::Record(uint32_t sample_id, PacketLatencyStage stage) {
+  if (sample_id == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  Sample* sample = find_sample(sample_id);
+  if (sample == nullptr) {
+    return;
+  }
+  record_stage(sample, stage);
+  trace_stage_begin(*sample);
+}
+
+void PacketLatencyTrace::End(uint32_t sample_id, PacketLatencyStage stage) {
+  if (sample_id == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  Sample* sample = find_sample(sample_id);
+  if (sample == nullptr) {
+    return;
+  }
+  record_stage(sample, stage);
+  add_to_histogram(&total_histogram, sample->stage_timestamp - sample->start_timestamp);
+  sample->id = 0;
+}
+
+void PacketLatencyTrace::TagBuffer(const void* buffer, uint32_t sample_id) {
+  if (sample_id == 0 && tagged_buffer_count.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  BufferTag* free_tag = nullptr;
+  for (auto& tag : buffer_tags) {
+    if (tag.buffer == buffer) {
+      if (sample_id == 0) {
+        tag = BufferTag{nullptr, 0};
+        tagged_buffer_count--;
+      } else {
+        tag.sample_id = sample_id;
+      }
+      return;
+    }
+    if (tag.buffer == nullptr && free_tag == nullptr) {
+      free_tag = &tag;
+    }
+  }
+  if (sample_id == 0) {
+    return;
+  }
+  if (free_tag == nullptr) {
+    // Tags of buffers freed before their last stage are overwritten in turn
+    free_tag = &buffer_tags[next_buffer_tag];
+    next_buffer_tag = (next_buffer_tag + 1) % kMaxTaggedBuffers;
+  } else {
+    tagged_buffer_count++;
+  }
+  *free_tag = BufferTag{buffer, sample_id};
+}
+
+uint32_t PacketLatencyTrace::GetBufferSample(const void* buffer) {
+  if (tagged_buffer_count.load(std::memory_order_relaxed) == 0) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  for (const auto& tag : buffer_tags) {
+    if (tag.buffer == buffer) {
+      return tag.sample_id;
+    }
+  }
+  return 0;
+}
+
+void PacketLatencyTrace::UntagBuffer(const void* buffer) {
+  TagBuffer(buffer, 0);
+}
+
+PacketLatencyHistogram PacketLatencyTrace::GetHistogram(PacketLatencyStage stage) {
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  return histograms[static_cast<size_t>(stage)];
+}
+
+PacketLatencyHistogram PacketLatencyTrace::GetTotalHistogram() {
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  return total_histogram;
+}
+
+void PacketLatencyTrace::Reset() {
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  for (auto& sample : samples) {
+    sample.id = 0;
+  }
+  for (auto& tag : buffer_tags) {
+    tag = BufferTag{nullptr, 0};
+  }
+  tagged_buffer_count = 0;
+  next_buffer_tag = 0;
+  for (auto& histogram : histograms) {
+    histogram = {};
+  }
+  total_histogram = {};
+}
+
+void PacketLatencyTrace::Dump(int fd) {
+  std::lock_guard<std::mutex> lock(packet_latency_trace_mutex);
+  dprintf(fd, "\nBluetooth packet latency trace:\n");
+  uint32_t rate = sampling_rate.load(std::memory_order_relaxed);
+  if (rate == 0) {
+    dprintf(fd, "  Disabled\n");
+    return;
+  }
+  dprintf(fd, "  Sampling 1 in %u incoming ACL packets\n", rate);
+
+  auto dump_histogram = [fd](const char* name, const PacketLatencyHistogram& histogram) {
+    if (histogram.count == 0) {
+      dprintf(fd, "  %-14s %8d\n", name, 0);
+      return;
+    }
+    dprintf(
+        fd,
+        "  %-14s %8llu %10llu %10llu ",
+        name,
+        static_cast<unsigned long long>(histogram.count),
+        static_cast<unsigned long long>(histogram.total_us / histogram.count),
+        static_cast<unsigned long long>(histogram.max_us));
+    for (size_t i = 0; i < kPacketLatencyHistogramBuckets; i++) {
+      if (histogram.buckets[i] == 0) {
+        continue;
+      }
+      if (i == kPacketLatencyHistogramBuckets - 1) {
+        dprintf(fd, " >=%llu:%llu", 1ull << (i - 1), static_cast<unsigned long long>(histogram.buckets[i]));
+      } else {
+        dprintf(fd, " <%llu:%llu", 1ull << i, static_cast<unsigned long long>(histogram.buckets[i]));
+      }
+    }
+    dprintf(fd, "\n");
+  };
+
+  // The latency of a stage is the time from the previous stage the sample reached
+  dprintf(fd, "  %-14s %8s %10s %10s  %s\n", "stage", "count", "avg (us)", "max (us)", "histogram (us:count)");
+  for (size_t stage = static_cast<size_t>(PacketLatencyStage::HCI_LAYER);
+       stage < static_cast<size_t>(PacketLatencyStage::COUNT);
+       stage++) {
+    dump_histogram(PacketLatencyStageText(static_cast<PacketLatencyStage>(stage)), histograms[stage]);
+  }
+  dump_histogram("total", total_histogram);
+}
+
+}  // namespace common
+}  // namespace bluetooth
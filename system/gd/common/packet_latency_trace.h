@@ -0,0 +1,93 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace bluetooth {
+namespace common {
+
+// The layer boundaries an incoming ACL packet crosses, in order
+enum class PacketLatencyStage : uint8_t {
+  // The HAL delivered the packet to the HCI layer, where a sample starts
+  HAL_READ = 0,
+  // The ACL manager dequeued the packet from the HCI layer
+  HCI_LAYER,
+  // The reassembled L2CAP PDU was dequeued from the queue of its connection
+  ACL_ASSEMBLER,
+  // L2CAP received the PDU on the main thread
+  L2CAP,
+  RFCOMM,
+  GATT,
+  // The RFCOMM payload was written to the socket of the app
+  BTIF_SOCKET,
+  COUNT,
+};
+
+const char* PacketLatencyStageText(PacketLatencyStage stage);
+
+static constexpr size_t kPacketLatencyHistogramBuckets = 16;
+
+typedef struct {
+  // Bucket i counts the latencies below 2^i us, the last bucket counts the rest
+  std::array<uint64_t, kPacketLatencyHistogramBuckets> buckets;
+  uint64_t count;
+  uint64_t total_us;
+  uint64_t max_us;
+} PacketLatencyHistogram;
+
+// Sampled latency of the incoming ACL packets through the stack
+//
+// One in sampling rate incoming ACL packets gets a sample id when the HAL delivers it. The id is carried with the
+// packet, in the PacketView and then as a tag of the BT_HDR, and each layer boundary records the time since the
+// previous one into the histogram of its stage. The packets that are not sampled only cost an atomic load per
+// boundary. On Android, each stage of a sample is also an async atrace slice, that perfetto records with the
+// bluetooth atrace category.
+class PacketLatencyTrace {
+ public:
+  // One in |sampling_rate| packets is sampled, 0 disables the tracing
+  static void SetSamplingRate(uint32_t sampling_rate);
+  static uint32_t GetSamplingRate();
+
+  // Start the sample of a packet entering the stack. Return its id, or 0 when the packet is not sampled.
+  static uint32_t StartSample();
+
+  // Record that the sample reached |stage|. Nothing is recorded for id 0 or for an ended sample.
+  static void Record(uint32_t sample_id, PacketLatencyStage stage);
+
+  // Record the last stage of the sample, and the latency from the HAL to it
+  static void End(uint32_t sample_id, PacketLatencyStage stage);
+
+  // Carry the sample id with a legacy buffer. Tagging a buffer with 0 drops the tag a freed buffer at the same
+  // address may have left.
+  static void TagBuffer(const void* buffer, uint32_t sample_id);
+  static uint32_t GetBufferSample(const void* buffer);
+  static void UntagBuffer(const void* buffer);
+
+  static PacketLatencyHistogram GetHistogram(PacketLatencyStage stage);
+  // The latency from the HAL to the last stage of the ended samples
+  static PacketLatencyHistogram GetTotalHistogram();
+
+  // Drop the samples in flight and the histograms
+  static void Reset();
+  static void Dump(int fd);
+};
+
+}  // namespace common
+}  // namespace bluetooth
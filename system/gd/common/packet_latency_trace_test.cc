@@ -0,0 +1,111 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/packet_latency_trace.h"
+
+#include <gtest/gtest.h>
+
+namespace testing {
+
+using bluetooth::common::PacketLatencyStage;
+using bluetooth::common::PacketLatencyTrace;
+
+class PacketLatencyTraceTest : public Test {
+ protected:
+  void SetUp() override {
+    PacketLatencyTrace::Reset();
+  }
+
+  void TearDown() override {
+    PacketLatencyTrace::SetSamplingRate(0);
+    PacketLatencyTrace::Reset();
+  }
+};
+
+TEST_F(PacketLatencyTraceTest, disabled_by_default_test) {
+  EXPECT_EQ(PacketLatencyTrace::GetSamplingRate(), 0u);
+  EXPECT_EQ(PacketLatencyTrace::StartSample(), 0u);
+}
+
+TEST_F(PacketLatencyTraceTest, one_in_sampling_rate_is_sampled_test) {
+  PacketLatencyTrace::SetSamplingRate(4);
+  int sampled = 0;
+  for (int i = 0; i < 40; i++) {
+    if (PacketLatencyTrace::StartSample() != 0) {
+      sampled++;
+    }
+  }
+  EXPECT_EQ(sampled, 10);
+}
+
+TEST_F(PacketLatencyTraceTest, stages_are_recorded_test) {
+  PacketLatencyTrace::SetSamplingRate(1);
+  uint32_t sample_id = PacketLatencyTrace::StartSample();
+  ASSERT_NE(sample_id, 0u);
+  PacketLatencyTrace::Record(sample_id, PacketLatencyStage::HCI_LAYER);
+  PacketLatencyTrace::Record(sample_id, PacketLatencyStage::L2CAP);
+  PacketLatencyTrace::End(sample_id, PacketLatencyStage::GATT);
+
+  EXPECT_EQ(PacketLatencyTrace::GetHistogram(PacketLatencyStage::HCI_LAYER).count, 1u);
+  EXPECT_EQ(PacketLatencyTrace::GetHistogram(PacketLatencyStage::L2CAP).count, 1u);
+  EXPECT_EQ(PacketLatencyTrace::GetHistogram(PacketLatencyStage::GATT).count, 1u);
+  EXPECT_EQ(PacketLatencyTrace::GetHistogram(PacketLatencyStage::RFCOMM).count, 0u);
+  EXPECT_EQ(PacketLatencyTrace::GetTotalHistogram().count, 1u);
+
+  // The sample ended
+  PacketLatencyTrace::Record(sample_id, PacketLatencyStage::RFCOMM);
+  EXPECT_EQ(PacketLatencyTrace::GetHistogram(PacketLatencyStage::RFCOMM).count, 0u);
+}
+
+TEST_F(PacketLatencyTraceTest, unsampled_packets_are_not_recorded_test) {
+  PacketLatencyTrace::Record(0, PacketLatencyStage::HCI_LAYER);
+  PacketLatencyTrace::End(0, PacketLatencyStage::GATT);
+  EXPECT_EQ(PacketLatencyTrace::GetHistogram(PacketLatencyStage::HCI_LAYER).count, 0u);
+  EXPECT_EQ(PacketLatencyTrace::GetTotalHistogram().count, 0u);
+}
+
+TEST_F(PacketLatencyTraceTest, buffer_tag_test) {
+  PacketLatencyTrace::SetSamplingRate(1);
+  uint32_t sample_id = PacketLatencyTrace::StartSample();
+  int buffer = 0;
+  int other_buffer = 0;
+  EXPECT_EQ(PacketLatencyTrace::GetBufferSample(&buffer), 0u);
+
+  PacketLatencyTrace::TagBuffer(&buffer, sample_id);
+  EXPECT_EQ(PacketLatencyTrace::GetBufferSample(&buffer), sample_id);
+  EXPECT_EQ(PacketLatencyTrace::GetBufferSample(&other_buffer), 0u);
+
+  // A buffer allocated at the same address is not sampled
+  PacketLatencyTrace::TagBuffer(&buffer, 0);
+  EXPECT_EQ(PacketLatencyTrace::GetBufferSample(&buffer), 0u);
+
+  PacketLatencyTrace::TagBuffer(&other_buffer, sample_id);
+  PacketLatencyTrace::UntagBuffer(&other_buffer);
+  EXPECT_EQ(PacketLatencyTrace::GetBufferSample(&other_buffer), 0u);
+}
+
+TEST_F(PacketLatencyTraceTest, tags_are_capped_test) {
+  PacketLatencyTrace::SetSamplingRate(1);
+  int buffers[100];
+  for (auto& buffer : buffers) {
+    PacketLatencyTrace::TagBuffer(&buffer, PacketLatencyTrace::StartSample());
+  }
+  // The most recent tags are kept
+  EXPECT_EQ(PacketLatencyTrace::GetBufferSample(&buffers[0]), 0u);
+  EXPECT_NE(PacketLatencyTrace::GetBufferSample(&buffers[99]), 0u);
+}
+
+}  // namespace testing
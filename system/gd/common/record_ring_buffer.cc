@@ -0,0 +1,115 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/record_ring_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bluetooth {
+namespace common {
+
+RecordRingBuffer::RecordRingBuffer(
+    size_t capacity_bytes, std::chrono::milliseconds max_age, std::unique_ptr<Timestamper> timestamper)
+    : storage_(capacity_bytes), max_age_(max_age), timestamper_(std::move(timestamper)) {}
+
+void RecordRingBuffer::Push(std::string_view record) {
+  size_t record_size = sizeof(RecordHeader) + record.size();
+  if (record_size > storage_.size()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  RecordHeader header{static_cast<uint32_t>(record.size()), timestamper_->GetTimestamp()};
+  DropExpired(header.timestamp);
+  while (storage_.size() - used_ < record_size) {
+    PopFront();
+  }
+  size_t end = (begin_ + used_) % storage_.size();
+  Write(end, &header, sizeof(RecordHeader));
+  Write((end + sizeof(RecordHeader)) % storage_.size(), record.data(), record.size());
+  used_ += record_size;
+  count_++;
+}
+
+std::vector<std::string> RecordRingBuffer::Pull() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  long long oldest_timestamp = max_age_.count() > 0 ? timestamper_->GetTimestamp() - max_age_.count() : 0;
+  std::vector<std::string> records;
+  records.reserve(count_);
+  size_t offset = begin_;
+  for (size_t i = 0; i < count_; i++) {
+    auto header = ReadHeader(offset);
+    offset = (offset + sizeof(RecordHeader)) % storage_.size();
+    if (max_age_.count() == 0 || header.timestamp >= oldest_timestamp) {
+      std::string record(header.size, '\0');
+      Read(offset, record.data(), header.size);
+      records.push_back(std::move(record));
+    }
+    offset = (offset + header.size) % storage_.size();
+  }
+  return records;
+}
+
+std::vector<std::string> RecordRingBuffer::Drain() {
+  auto records = Pull();
+  std::lock_guard<std::mutex> lock(mutex_);
+  begin_ = 0;
+  used_ = 0;
+  count_ = 0;
+  return records;
+}
+
+size_t RecordRingBuffer::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return count_;
+}
+
+void RecordRingBuffer::Read(size_t offset, void* data, size_t size) const {
+  size_t first_part = std::min(size, storage_.size() - offset);
+  std::memcpy(data, storage_.data() + offset, first_part);
+  std::memcpy(static_cast<uint8_t*>(data) + first_part, storage_.data(), size - first_part);
+}
+
+void RecordRingBuffer::Write(size_t offset, const void* data, size_t size) {
+  size_t first_part = std::min(size, storage_.size() - offset);
+  std::memcpy(storage_.data() + offset, data, first_part);
+  std::memcpy(storage_.data(), static_cast<const uint8_t*>(data) + first_part, size - first_part);
+}
+
+RecordRingBuffer::RecordHeader RecordRingBuffer::ReadHeader(size_t offset) const {
+  RecordHeader header;
+  Read(offset, &header, sizeof(RecordHeader));
+  return header;
+}
+
+void RecordRingBuffer::PopFront() {
+  size_t record_size = sizeof(RecordHeader) + ReadHeader(begin_).size;
+  begin_ = (begin_ + record_size) % storage_.size();
+  used_ -= record_size;
+  count_--;
+}
+
+void RecordRingBuffer::DropExpired(long long now) {
+  if (max_age_.count() == 0) {
+    return;
+  }
+  while (count_ > 0 && ReadHeader(begin_).timestamp < now - max_age_.count()) {
+    PopFront();
+  }
+}
+
+}  // namespace common
+}  // namespace bluetooth
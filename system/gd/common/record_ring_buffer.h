@@ -0,0 +1,77 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/circular_buffer.h"
+
+namespace bluetooth {
+namespace common {
+
+// A circular buffer of variable sized records, stored back to back in a single allocation
+//
+// The buffer is bounded by the total size of the records instead of their count, and records older than |max_age| are
+// dropped. Each record only costs its own size plus a small header, and pushing a record never allocates.
+class RecordRingBuffer {
+ public:
+  // A |max_age| of zero keeps records until there is no room left for new ones
+  RecordRingBuffer(
+      size_t capacity_bytes,
+      std::chrono::milliseconds max_age,
+      std::unique_ptr<Timestamper> timestamper = std::make_unique<TimestamperInMilliseconds>());
+
+  // Push one record, dropping the oldest records to make room for it. Records larger than the capacity are dropped.
+  void Push(std::string_view record);
+  // Take a snapshot of the records that are not too old, oldest first
+  std::vector<std::string> Pull() const;
+  // Drain every record that is not too old, oldest first
+  std::vector<std::string> Drain();
+
+  size_t Size() const;
+
+ private:
+  struct RecordHeader {
+    uint32_t size;
+    long long timestamp;
+  };
+
+  void Read(size_t offset, void* data, size_t size) const;
+  void Write(size_t offset, const void* data, size_t size);
+  RecordHeader ReadHeader(size_t offset) const;
+  void PopFront();
+  void DropExpired(long long now);
+
+  std::vector<uint8_t> storage_;
+  std::chrono::milliseconds max_age_;
+  std::unique_ptr<Timestamper> timestamper_;
+  // Offset of the oldest record, and number of bytes used by the records from there
+  size_t begin_ = 0;
+  size_t used_ = 0;
+  size_t count_ = 0;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/record_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using bluetooth::common::RecordRingBuffer;
+
+namespace {
+
+struct TestTimestamper : public bluetooth::common::Timestamper {
+  explicit TestTimestamper(long long* timestamp) : timestamp_(timestamp) {}
+  long long GetTimestamp() const override {
+    return *timestamp_;
+  }
+  long long* timestamp_;
+};
+
+// Room for |count| records of |size| bytes
+size_t Capacity(size_t count, size_t size) {
+  // Record header: 32 bits size, padding, 64 bits timestamp
+  return count * (16 + size);
+}
+
+TEST(RecordRingBufferTest, push_and_pull) {
+  RecordRingBuffer buffer(Capacity(10, 5), std::chrono::milliseconds(0));
+  buffer.Push("One");
+  buffer.Push(std::string("Two\0Two", 7));
+  buffer.Push("Three");
+
+  auto records = buffer.Pull();
+  ASSERT_EQ(records.size(), 3ul);
+  ASSERT_EQ(records[0], "One");
+  ASSERT_EQ(records[1], std::string("Two\0Two", 7));
+  ASSERT_EQ(records[2], "Three");
+  ASSERT_EQ(buffer.Pull().size(), 3ul);
+}
+
+TEST(RecordRingBufferTest, drain) {
+  RecordRingBuffer buffer(Capacity(10, 5), std::chrono::milliseconds(0));
+  buffer.Push("One");
+  buffer.Push("Two");
+
+  auto records = buffer.Drain();
+  ASSERT_EQ(records.size(), 2ul);
+  ASSERT_EQ(records[0], "One");
+  ASSERT_EQ(records[1], "Two");
+  ASSERT_TRUE(buffer.Pull().empty());
+
+  buffer.Push("Three");
+  records = buffer.Pull();
+  ASSERT_EQ(records.size(), 1ul);
+  ASSERT_EQ(records[0], "Three");
+}
+
+TEST(RecordRingBufferTest, drop_oldest_when_full) {
+  RecordRingBuffer buffer(Capacity(3, 4), std::chrono::milliseconds(0));
+  for (int i = 0; i < 100; i++) {
+    buffer.Push(std::to_string(1000 + i));
+  }
+  auto records = buffer.Pull();
+  ASSERT_EQ(records.size(), 3ul);
+  ASSERT_EQ(records[0], "1097");
+  ASSERT_EQ(records[1], "1098");
+  ASSERT_EQ(records[2], "1099");
+}
+
+TEST(RecordRingBufferTest, records_of_different_sizes_wrap_around) {
+  RecordRingBuffer buffer(Capacity(4, 10), std::chrono::milliseconds(0));
+  std::vector<std::string> pushed;
+  for (size_t i = 0; i < 50; i++) {
+    pushed.push_back(std::string(i % 11, static_cast<char>('a' + i % 26)));
+    buffer.Push(pushed.back());
+    auto records = buffer.Pull();
+    ASSERT_FALSE(records.empty());
+    ASSERT_LE(records.size(), pushed.size());
+    // The records left are the most recent ones, in order
+    for (size_t j = 0; j < records.size(); j++) {
+      ASSERT_EQ(records[j], pushed[pushed.size() - records.size() + j]);
+    }
+  }
+}
+
+TEST(RecordRingBufferTest, record_larger_than_capacity_is_dropped) {
+  RecordRingBuffer buffer(Capacity(1, 4), std::chrono::milliseconds(0));
+  buffer.Push("One");
+  buffer.Push("Larger than the buffer");
+  auto records = buffer.Pull();
+  ASSERT_EQ(records.size(), 1ul);
+  ASSERT_EQ(records[0], "One");
+}
+
+TEST(RecordRingBufferTest, drop_expired_records) {
+  long long now = 1000;
+  RecordRingBuffer buffer(Capacity(10, 5), std::chrono::milliseconds(100), std::make_unique<TestTimestamper>(&now));
+  buffer.Push("One");
+  now += 60;
+  buffer.Push("Two");
+  now += 60;
+  auto records = buffer.Pull();
+  ASSERT_EQ(records.size(), 1ul);
+  ASSERT_EQ(records[0], "Two");
+
+  now += 60;
+  // Pushing drops the expired records
+  buffer.Push("Three");
+  ASSERT_EQ(buffer.Size(), 1ul);
+  now += 200;
+  ASSERT_TRUE(buffer.Pull().empty());
+}
+
+}  // namespace
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "BtStartupTrace"
+
+#include "common/startup_trace.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+#if defined(__ANDROID__)
+#include <cutils/trace.h>
+#endif /* defined(__ANDROID__) */
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace common {
+
+// Enough for the whole start up, including every HCI command sent by the controller module
+static const size_t MAX_EVENTS = 512;
+static std::atomic_bool is_recording;
+static std::mutex startup_trace_mutex;
+static std::chrono::steady_clock::time_point trace_start_timestamp;
+static std::chrono::steady_clock::time_point trace_stop_timestamp;
+static std::vector<StartupTraceEvent> events;
+static size_t dropped_events;
+
+void StartupTrace::Start() {
+  std::lock_guard<std::mutex> lock(startup_trace_mutex);
+  trace_start_timestamp = std::chrono::steady_clock::now();
+  trace_stop_timestamp = {};
+  events.clear();
+  dropped_events = 0;
+  is_recording = true;
+}
+
+void StartupTrace::Stop() {
+  std::lock_guard<std::mutex> lock(startup_trace_mutex);
+  if (!is_recording) {
+    return;
+  }
+  is_recording = false;
+  trace_stop_timestamp = std::chrono::steady_clock::now();
+  LOG_INFO(
+      "Stack started in %zu ms",
+      static_cast<size_t>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(trace_stop_timestamp - trace_start_timestamp).count()));
+}
+
+bool StartupTrace::IsRecording() {
+  return is_recording;
+}
+
+void StartupTrace::Record(
+    std::string name,
+    std::chrono::steady_clock::time_point start_timestamp,
+    std::chrono::steady_clock::time_point end_timestamp) {
+  if (!is_recording) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(startup_trace_mutex);
+  if (!is_recording) {
+    return;
+  }
+  if (events.size() >= MAX_EVENTS) {
+    dropped_events++;
+    return;
+  }
+  events.push_back(StartupTraceEvent{std::move(name), start_timestamp, end_timestamp});
+}
+
+std::vector<StartupTraceEvent> StartupTrace::GetEvents() {
+  std::lock_guard<std::mutex> lock(startup_trace_mutex);
+  std::vector<StartupTraceEvent> sorted_events = events;
+  // Steps are recorded when they end, the timeline is ordered by start
+  std::stable_sort(
+      sorted_events.begin(), sorted_events.end(), [](const StartupTraceEvent& a, const StartupTraceEvent& b) {
+        return a.start_timestamp < b.start_timestamp;
+      });
+  return sorted_events;
+}
+
+void StartupTrace::Dump(int fd) {
+  auto sorted_events = GetEvents();
+  std::lock_guard<std::mutex> lock(startup_trace_mutex);
+  auto to_us = [](std::chrono::steady_clock::duration duration) {
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  };
+
+  dprintf(fd, "\nBluetooth startup trace:\n");
+  if (trace_start_timestamp == std::chrono::steady_clock::time_point{}) {
+    dprintf(fd, "  No start up recorded\n");
+    return;
+  }
+  if (is_recording) {
+    dprintf(fd, "  In progress for %lld us\n", to_us(std::chrono::steady_clock::now() - trace_start_timestamp));
+  } else {
+    dprintf(fd, "  Total: %lld us\n", to_us(trace_stop_timestamp - trace_start_timestamp));
+  }
+  if (dropped_events > 0) {
+    dprintf(fd, "  Dropped events: %zu\n", dropped_events);
+  }
+  dprintf(fd, "  %12s %13s  %s\n", "start (us)", "duration (us)", "step");
+  for (const auto& event : sorted_events) {
+    dprintf(
+        fd,
+        "  %12lld %13lld  %s\n",
+        to_us(event.start_timestamp - trace_start_timestamp),
+        to_us(event.end_timestamp - event.start_timestamp),
+        event.name.c_str());
+  }
+}
+
+ScopedStartupTrace::ScopedStartupTrace(std::string name)
+    : name_(std::move(name)), start_timestamp_(std::chrono::steady_clock::now()) {
+#if defined(__ANDROID__)
+  atrace_begin(ATRACE_TAG_BLUETOOTH, name_.c_str());
+#endif /* defined(__ANDROID__) */
+}
+
+ScopedStartupTrace::~ScopedStartupTrace() {
+#if defined(__ANDROID__)
+  atrace_end(ATRACE_TAG_BLUETOOTH);
+#endif /* defined(__ANDROID__) */
+  StartupTrace::Record(std::move(name_), start_timestamp_, std::chrono::steady_clock::now());
+}
+
+}  // namespace common
+}  // namespace bluetooth
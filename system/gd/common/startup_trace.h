@@ -0,0 +1,65 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+typedef struct {
+  std::string name;
+  std::chrono::steady_clock::time_point start_timestamp;
+  std::chrono::steady_clock::time_point end_timestamp;
+} StartupTraceEvent;
+
+// The timeline of the last stack start up, from init() until the stack is up
+//
+// Steps are only recorded between Start() and Stop(), so the steps that are also taken once the stack is up, like HCI
+// commands, do not make the timeline grow.
+class StartupTrace {
+ public:
+  // Start a new timeline, dropping the previous one
+  static void Start();
+  static void Stop();
+  static bool IsRecording();
+
+  static void Record(
+      std::string name,
+      std::chrono::steady_clock::time_point start_timestamp,
+      std::chrono::steady_clock::time_point end_timestamp);
+
+  static std::vector<StartupTraceEvent> GetEvents();
+  static void Dump(int fd);
+};
+
+// Record the time from construction to destruction of this object in the startup timeline. On Android the step is
+// also an atrace slice.
+class ScopedStartupTrace {
+ public:
+  explicit ScopedStartupTrace(std::string name);
+  ~ScopedStartupTrace();
+
+ private:
+  std::string name_;
+  std::chrono::steady_clock::time_point start_timestamp_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
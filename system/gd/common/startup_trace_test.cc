@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/startup_trace.h"
+
+#include <gtest/gtest.h>
+
+namespace testing {
+
+using bluetooth::common::ScopedStartupTrace;
+using bluetooth::common::StartupTrace;
+
+TEST(StartupTraceTest, scoped_trace_is_recorded_test) {
+  StartupTrace::Start();
+  {
+    ScopedStartupTrace outer("outer");
+    ScopedStartupTrace inner("inner");
+  }
+  StartupTrace::Stop();
+
+  auto events = StartupTrace::GetEvents();
+  ASSERT_EQ(events.size(), 2u);
+  // Ordered by start, though the inner step ends first
+  EXPECT_EQ(events[0].name, "outer");
+  EXPECT_EQ(events[1].name, "inner");
+  EXPECT_LE(events[0].start_timestamp, events[1].start_timestamp);
+  EXPECT_GE(events[0].end_timestamp, events[1].end_timestamp);
+}
+
+TEST(StartupTraceTest, nothing_recorded_when_stopped_test) {
+  StartupTrace::Start();
+  StartupTrace::Stop();
+  EXPECT_FALSE(StartupTrace::IsRecording());
+  { ScopedStartupTrace trace("after stop"); }
+  auto now = std::chrono::steady_clock::now();
+  StartupTrace::Record("after stop", now, now);
+  EXPECT_TRUE(StartupTrace::GetEvents().empty());
+}
+
+TEST(StartupTraceTest, start_drops_previous_timeline_test) {
+  StartupTrace::Start();
+  { ScopedStartupTrace trace("first"); }
+  StartupTrace::Start();
+  EXPECT_TRUE(StartupTrace::IsRecording());
+  { ScopedStartupTrace trace("second"); }
+  StartupTrace::Stop();
+
+  auto events = StartupTrace::GetEvents();
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].name, "second");
+}
+
+TEST(StartupTraceTest, events_are_capped_test) {
+  StartupTrace::Start();
+  auto now = std::chrono::steady_clock::now();
+  for (int i = 0; i < 1000; i++) {
+    StartupTrace::Record("event", now, now);
+  }
+  StartupTrace::Stop();
+  EXPECT_EQ(StartupTrace::GetEvents().size(), 512u);
+}
+
+}  // namespace testing
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/traffic_telemetry.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+std::mutex traffic_telemetry_mutex;
+std::vector<std::unique_ptr<TrafficCounters>> traffic_counters;
+
+}  // namespace
+
+const char* TrafficChannelTypeText(TrafficChannelType type) {
+  switch (type) {
+    case TrafficChannelType::ACL:
+      return "ACL";
+    case TrafficChannelType::L2CAP:
+      return "L2CAP";
+    case TrafficChannelType::RFCOMM:
+      return "RFCOMM";
+  }
+  return "UNKNOWN";
+}
+
+TrafficCounters* TrafficTelemetry::Register(TrafficChannelType type, uint16_t acl_handle, uint16_t channel_id) {
+  std::lock_guard<std::mutex> lock(traffic_telemetry_mutex);
+  for (auto& counters : traffic_counters) {
+    if (counters->type_ == type && counters->acl_handle_ == acl_handle && counters->channel_id_ == channel_id) {
+      counters->owners_++;
+      return counters.get();
+    }
+  }
+  auto counters = std::make_unique<TrafficCounters>(type, acl_handle, channel_id);
+  counters->owners_ = 1;
+  counters->rate_timestamp_ = std::chrono::steady_clock::now();
+  traffic_counters.push_back(std::move(counters));
+  return traffic_counters.back().get();
+}
+
+void TrafficTelemetry::Unregister(TrafficCounters* counters) {
+  if (counters == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(traffic_telemetry_mutex);
+  auto it = std::find_if(traffic_counters.begin(), traffic_counters.end(), [counters](const auto& registered) {
+    return registered.get() == counters;
+  });
+  ASSERT_LOG(it != traffic_counters.end(), "Unregistering unknown traffic counters");
+  if (--counters->owners_ == 0) {
+    traffic_counters.erase(it);
+  }
+}
+
+std::vector<TrafficSnapshot> TrafficTelemetry::Poll() {
+  std::lock_guard<std::mutex> lock(traffic_telemetry_mutex);
+  auto now = std::chrono::steady_clock::now();
+  std::vector<TrafficSnapshot> snapshots;
+  snapshots.reserve(traffic_counters.size());
+  for (auto& counters : traffic_counters) {
+    uint64_t rx_bytes = counters->rx_bytes_.load(std::memory_order_relaxed);
+    uint64_t tx_bytes = counters->tx_bytes_.load(std::memory_order_relaxed);
+    auto elapsed = now - counters->rate_timestamp_;
+    if (elapsed >= kRateWindow) {
+      auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+      counters->rx_bytes_per_second_ = (rx_bytes - counters->rate_rx_bytes_) * 1000 / elapsed_ms;
+      counters->tx_bytes_per_second_ = (tx_bytes - counters->rate_tx_bytes_) * 1000 / elapsed_ms;
+      counters->rate_rx_bytes_ = rx_bytes;
+      counters->rate_tx_bytes_ = tx_bytes;
+      counters->rate_timestamp_ = now;
+    }
+    snapshots.push_back(TrafficSnapshot{
+        counters->type_,
+        counters->acl_handle_,
+        counters->channel_id_,
+        rx_bytes,
+        counters->rx_packets_.load(std::memory_order_relaxed),
+        tx_bytes,
+        counters->tx_packets_.load(std::memory_order_relaxed),
+        counters->rx_queue_depth_.load(std::memory_order_relaxed),
+        counters->tx_queue_depth_.load(std::memory_order_relaxed),
+        counters->outstanding_credits_.load(std::memory_order_relaxed),
+        counters->rx_bytes_per_second_,
+        counters->tx_bytes_per_second_,
+    });
+  }
+  std::sort(snapshots.begin(), snapshots.end(), [](const TrafficSnapshot& a, const TrafficSnapshot& b) {
+    return std::tie(a.acl_handle, a.type, a.channel_id) < std::tie(b.acl_handle, b.type, b.channel_id);
+  });
+  return snapshots;
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+enum class TrafficChannelType : uint8_t {
+  ACL = 0,
+  L2CAP,
+  RFCOMM,
+};
+
+const char* TrafficChannelTypeText(TrafficChannelType type);
+
+// Counters of an ACL connection or of a channel on it, updated by the layer that owns it from any thread. Updating a
+// counter is a relaxed atomic operation.
+class TrafficCounters {
+ public:
+  TrafficCounters(TrafficChannelType type, uint16_t acl_handle, uint16_t channel_id)
+      : type_(type), acl_handle_(acl_handle), channel_id_(channel_id) {}
+
+  void OnReceived(size_t bytes) {
+    rx_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    rx_packets_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void OnSent(size_t bytes) {
+    tx_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    tx_packets_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Packets received and not yet delivered to the layer above
+  void SetRxQueueDepth(size_t depth) {
+    rx_queue_depth_.store(depth, std::memory_order_relaxed);
+  }
+
+  // Packets waiting to be sent to the layer below
+  void SetTxQueueDepth(size_t depth) {
+    tx_queue_depth_.store(depth, std::memory_order_relaxed);
+  }
+
+  // Controller buffers used by the packets sent on the ACL connection
+  void SetOutstandingCredits(uint16_t credits) {
+    outstanding_credits_.store(credits, std::memory_order_relaxed);
+  }
+
+ private:
+  friend class TrafficTelemetry;
+
+  const TrafficChannelType type_;
+  const uint16_t acl_handle_;
+  const uint16_t channel_id_;
+  std::atomic<uint64_t> rx_bytes_{0};
+  std::atomic<uint64_t> rx_packets_{0};
+  std::atomic<uint64_t> tx_bytes_{0};
+  std::atomic<uint64_t> tx_packets_{0};
+  std::atomic<uint32_t> rx_queue_depth_{0};
+  std::atomic<uint32_t> tx_queue_depth_{0};
+  std::atomic<uint16_t> outstanding_credits_{0};
+
+  // Owned by TrafficTelemetry
+  int owners_ = 0;
+  std::chrono::steady_clock::time_point rate_timestamp_;
+  uint64_t rate_rx_bytes_ = 0;
+  uint64_t rate_tx_bytes_ = 0;
+  uint64_t rx_bytes_per_second_ = 0;
+  uint64_t tx_bytes_per_second_ = 0;
+};
+
+typedef struct {
+  TrafficChannelType type;
+  uint16_t acl_handle;
+  // 0 for an ACL connection, the local CID of an L2CAP channel or the DLCI of an RFCOMM port
+  uint16_t channel_id;
+  uint64_t rx_bytes;
+  uint64_t rx_packets;
+  uint64_t tx_bytes;
+  uint64_t tx_packets;
+  uint32_t rx_queue_depth;
+  uint32_t tx_queue_depth;
+  uint16_t outstanding_credits;
+  uint64_t rx_bytes_per_second;
+  uint64_t tx_bytes_per_second;
+} TrafficSnapshot;
+
+// The traffic counters of the live connections and channels, for dumpsys and for monitoring agents
+//
+// The rates are the throughput between the two last samples of the counters. Polling samples the counters once at
+// least kRateWindow has passed since the previous sample, so pollers share the samples and polling often does not
+// shorten the window.
+class TrafficTelemetry {
+ public:
+  static constexpr std::chrono::seconds kRateWindow{1};
+
+  // Return the counters of the channel. The layers that register the same channel share its counters, which exist
+  // until each of them unregistered.
+  static TrafficCounters* Register(TrafficChannelType type, uint16_t acl_handle, uint16_t channel_id);
+  static void Unregister(TrafficCounters* counters);
+
+  // A snapshot of the counters of every live channel, ordered by ACL handle, type and channel id
+  static std::vector<TrafficSnapshot> Poll();
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/traffic_telemetry.h"
+
+#include <gtest/gtest.h>
+
+namespace testing {
+
+using bluetooth::common::TrafficChannelType;
+using bluetooth::common::TrafficTelemetry;
+
+TEST(TrafficTelemetryTest, counters_are_polled_test) {
+  auto acl = TrafficTelemetry::Register(TrafficChannelType::ACL, 0x0040, 0);
+  auto l2cap = TrafficTelemetry::Register(TrafficChannelType::L2CAP, 0x0040, 0x0041);
+  acl->OnReceived(100);
+  acl->OnReceived(50);
+  acl->OnSent(20);
+  acl->SetOutstandingCredits(3);
+  l2cap->OnReceived(146);
+  l2cap->SetTxQueueDepth(2);
+
+  auto snapshots = TrafficTelemetry::Poll();
+  ASSERT_EQ(snapshots.size(), 2u);
+  EXPECT_EQ(snapshots[0].type, TrafficChannelType::ACL);
+  EXPECT_EQ(snapshots[0].acl_handle, 0x0040);
+  EXPECT_EQ(snapshots[0].rx_bytes, 150u);
+  EXPECT_EQ(snapshots[0].rx_packets, 2u);
+  EXPECT_EQ(snapshots[0].tx_bytes, 20u);
+  EXPECT_EQ(snapshots[0].tx_packets, 1u);
+  EXPECT_EQ(snapshots[0].outstanding_credits, 3);
+  EXPECT_EQ(snapshots[1].type, TrafficChannelType::L2CAP);
+  EXPECT_EQ(snapshots[1].channel_id, 0x0041);
+  EXPECT_EQ(snapshots[1].rx_bytes, 146u);
+  EXPECT_EQ(snapshots[1].tx_queue_depth, 2u);
+
+  TrafficTelemetry::Unregister(acl);
+  TrafficTelemetry::Unregister(l2cap);
+  EXPECT_TRUE(TrafficTelemetry::Poll().empty());
+}
+
+TEST(TrafficTelemetryTest, owners_share_counters_test) {
+  auto rx = TrafficTelemetry::Register(TrafficChannelType::ACL, 0x0001, 0);
+  auto tx = TrafficTelemetry::Register(TrafficChannelType::ACL, 0x0001, 0);
+  EXPECT_EQ(rx, tx);
+  rx->OnReceived(10);
+  tx->OnSent(20);
+
+  TrafficTelemetry::Unregister(rx);
+  auto snapshots = TrafficTelemetry::Poll();
+  ASSERT_EQ(snapshots.size(), 1u);
+  EXPECT_EQ(snapshots[0].rx_bytes, 10u);
+  EXPECT_EQ(snapshots[0].tx_bytes, 20u);
+
+  TrafficTelemetry::Unregister(tx);
+  EXPECT_TRUE(TrafficTelemetry::Poll().empty());
+}
+
+TEST(TrafficTelemetryTest, unregister_null_test) {
+  TrafficTelemetry::Unregister(nullptr);
+  EXPECT_TRUE(TrafficTelemetry::Poll().empty());
+}
+
+}  // namespace testing
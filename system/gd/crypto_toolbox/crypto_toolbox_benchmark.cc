@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "crypto_toolbox/aes.h"
+#include "crypto_toolbox/crypto_toolbox.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace crypto_toolbox {
+
+// range(0) is 1 to use the AES instructions of the CPU, 0 for the table based code. Every iteration sets up the key,
+// like every call to aes_128() and aes_cmac() does.
+class BM_CryptoToolbox : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    hw_was_enabled_ = aes_hw_is_enabled();
+    aes_hw_set_enabled(st.range(0) != 0);
+    for (size_t i = 0; i < key_.size(); i++) {
+      key_[i] = static_cast<uint8_t>(i);
+    }
+  }
+
+  void TearDown(State& st) override {
+    aes_hw_set_enabled(hw_was_enabled_);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  bool hw_was_enabled_ = false;
+  Octet16 key_;
+};
+
+// A single block, e.g. ah() for each RPA to resolve
+BENCHMARK_DEFINE_F(BM_CryptoToolbox, aes_128)(State& state) {
+  if (state.range(0) != 0 && !aes_hw_is_enabled()) {
+    state.SkipWithError("No AES instructions on this CPU");
+    return;
+  }
+  Octet16 message{};
+  for (auto _ : state) {
+    message = aes_128(key_, message);
+    benchmark::DoNotOptimize(message);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+// range(1) is the message size, from f4() and f5() of pairing up to a large GATT database hash
+BENCHMARK_DEFINE_F(BM_CryptoToolbox, aes_cmac)(State& state) {
+  if (state.range(0) != 0 && !aes_hw_is_enabled()) {
+    state.SkipWithError("No AES instructions on this CPU");
+    return;
+  }
+  std::vector<uint8_t> message(state.range(1));
+  for (size_t i = 0; i < message.size(); i++) {
+    message[i] = static_cast<uint8_t>(i);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(aes_cmac(key_, message.data(), message.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+BENCHMARK_REGISTER_F(BM_CryptoToolbox, aes_128)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(BM_CryptoToolbox, aes_cmac)->ArgsProduct({{0, 1}, {53, 65, 1024, 8192}});
+
+}  // namespace crypto_toolbox
+}  // namespace bluetooth
@@ -20,6 +20,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <random>
 #include <vector>
 
 #include "crypto_toolbox/aes.h"
@@ -352,5 +354,38 @@ TEST(CryptoToolboxTest, bt_spec_example_d_12_test) {
   EXPECT_EQ(expected_ltk, ltk);
 }
 
+// The AES instructions of the CPU, when it has them, and the table based code use the same key schedule and give the
+// same results
+TEST(CryptoToolboxTest, aes_hw_matches_table_based_aes_test) {
+  bool hw_enabled = aes_hw_is_enabled();
+  std::mt19937 random(0);
+  uint8_t key[32], message[16];
+
+  for (int i = 0; i < 100; i++) {
+    std::generate(std::begin(key), std::end(key), random);
+    std::generate(std::begin(message), std::end(message), random);
+
+    for (uint8_t key_length : {16, 32}) {
+      aes_context hw_ctx, table_ctx;
+      uint8_t hw_output[16], table_output[16], decrypted[16];
+
+      aes_hw_set_enabled(true);
+      aes_set_key(key, key_length, &hw_ctx);
+      aes_encrypt(message, hw_output, &hw_ctx);
+      aes_hw_set_enabled(false);
+      aes_set_key(key, key_length, &table_ctx);
+      aes_encrypt(message, table_output, &table_ctx);
+
+      ASSERT_EQ(hw_ctx.rnd, table_ctx.rnd);
+      EXPECT_EQ(0, memcmp(hw_ctx.ksch, table_ctx.ksch, (hw_ctx.rnd + 1) * N_BLOCK));
+      EXPECT_EQ(0, memcmp(hw_output, table_output, sizeof(hw_output)));
+      aes_decrypt(hw_output, decrypted, &hw_ctx);
+      EXPECT_EQ(0, memcmp(message, decrypted, sizeof(message)));
+    }
+  }
+
+  aes_hw_set_enabled(hw_enabled);
+}
+
 }  // namespace crypto_toolbox
 }  // namespace bluetooth
@@ -38,41 +38,31 @@ class Filter {
 
  protected:
   /**
-   * Given both reflection field data and the populated flatbuffer table data, if any,
+   * Given both the precompiled field data and the populated flatbuffer table data,
    * filter the contents of the field based upon the filtering privacy level.
    *
    * Primitives and composite strings may be successfully processed at this point.
-   * Other composite types (e.g. structs or tables) must be expanded into the
-   * respective grouping of subfields.
+   * Other composite types (e.g. tables) must be expanded into the respective
+   * grouping of subfields.
    *
-   * @param field The reflection field information from the bundled schema
-   * @param table The populated field data, if any
+   * @param field The field information compiled from the bundled schema
+   * @param table The populated field data
    *
    * @return true if field was filtered successfully, false otherwise.
    */
-  virtual bool FilterField(const reflection::Field* field, flatbuffers::Table* table) {
+  virtual bool FilterField(const dumpsys::FilterField& field, flatbuffers::Table* table) {
     return false;
   }
 
   /**
-   * Given both reflection object data and the populated flatbuffer table data, if any,
-   * filter the object fields based upon the filtering privacy level.
-   *
-   * @param object The reflection object information from the bundled schema
-   * @param table The populated field data, if any
-   *
-   */
-  virtual void FilterObject(const reflection::Object* object, flatbuffers::Table* table){};
-
-  /**
-   * Given both reflection field data and the populated table data, if any,
+   * Given both the precompiled table fields and the populated table data, if any,
    * filter the contents of the table based upon the filtering privacy level.
    *
-   * @param schema The reflection schema information from the bundled schema
-   * @param table The populated field data, if any
+   * @param filter_table The table fields compiled from the bundled schema
+   * @param table The populated table data, if any
    *
    */
-  virtual void FilterTable(const reflection::Schema* schema, flatbuffers::Table* table){};
+  virtual void FilterTable(const dumpsys::FilterTable& filter_table, flatbuffers::Table* table){};
 
   const dumpsys::ReflectionSchema& reflection_schema_;
 };
@@ -90,104 +80,72 @@ class UserPrivacyFilter : public Filter {
   void FilterInPlace(char* dumpsys_data) override;
 
  protected:
-  bool FilterField(const reflection::Field* field, flatbuffers::Table* table) override;
-  void FilterObject(const reflection::Object* object, flatbuffers::Table* table) override;
-  void FilterTable(const reflection::Schema* schema, flatbuffers::Table* table) override;
+  bool FilterField(const dumpsys::FilterField& field, flatbuffers::Table* table) override;
+  void FilterTable(const dumpsys::FilterTable& filter_table, flatbuffers::Table* table) override;
 };
 
-bool UserPrivacyFilter::FilterField(const reflection::Field* field, flatbuffers::Table* table) {
-  ASSERT(field != nullptr);
+bool UserPrivacyFilter::FilterField(const dumpsys::FilterField& field, flatbuffers::Table* table) {
+  ASSERT(field.field != nullptr);
   ASSERT(table != nullptr);
-  internal::PrivacyLevel privacy_level = internal::FindFieldPrivacyLevel(*field);
 
-  const auto type = static_cast<flatbuffers::BaseType>(field->type()->base_type());
-  switch (type) {
+  switch (field.base_type) {
     case flatbuffers::BASE_TYPE_INT:
-      return internal::FilterTypeInteger(*field, table, privacy_level);
+      return internal::FilterTypeInteger(*field.field, table, field.privacy_level);
       break;
     case flatbuffers::BASE_TYPE_FLOAT:
-      return internal::FilterTypeFloat(*field, table, privacy_level);
+      return internal::FilterTypeFloat(*field.field, table, field.privacy_level);
       break;
     case flatbuffers::BASE_TYPE_STRING:
-      return internal::FilterTypeString(*field, table, privacy_level);
+      return internal::FilterTypeString(*field.field, table, field.privacy_level);
       break;
     case flatbuffers::BASE_TYPE_STRUCT:
-      return internal::FilterTypeStruct(*field, table, privacy_level);
+      return internal::FilterTypeStruct(*field.field, table, field.privacy_level);
       break;
     case flatbuffers::BASE_TYPE_BOOL:
-      return internal::FilterTypeBool(*field, table, privacy_level);
+      return internal::FilterTypeBool(*field.field, table, field.privacy_level);
       break;
     case flatbuffers::BASE_TYPE_LONG:
-      return internal::FilterTypeLong(*field, table, privacy_level);
+      return internal::FilterTypeLong(*field.field, table, field.privacy_level);
       break;
     default:
-      LOG_WARN("Unsupported base type:%s", internal::FlatbufferTypeText(type).c_str());
+      if (field.sub_table == nullptr) {
+        LOG_WARN("Unsupported base type:%s", internal::FlatbufferTypeText(field.base_type).c_str());
+      }
       break;
   }
   return false;
 }
 
-void UserPrivacyFilter::FilterObject(const reflection::Object* object, flatbuffers::Table* table) {
-  ASSERT(object != nullptr);
-  if (table == nullptr) {
-    return;  // table data is not populated
-  }
-  for (auto it = object->fields()->cbegin(); it != object->fields()->cend(); ++it) {
-    if (!FilterField(*it, table)) {
-      LOG_ERROR("%s Unable to filter field from an object when it's expected it will work", __func__);
-    };
-  }
-}
-
-void UserPrivacyFilter::FilterTable(const reflection::Schema* schema, flatbuffers::Table* table) {
-  if (schema == nullptr) {
-    LOG_WARN("%s schema is nullptr...probably ok", __func__);
-    return;
-  }
-
-  const reflection::Object* object = schema->root_table();
-  if (object == nullptr) {
-    LOG_WARN("%s reflection object is nullptr...is ok ?", __func__);
-    return;
-  }
-
+void UserPrivacyFilter::FilterTable(const dumpsys::FilterTable& filter_table, flatbuffers::Table* table) {
   if (table == nullptr) {
     return;  // table not populated
   }
 
-  for (auto it = object->fields()->cbegin(); it != object->fields()->cend(); ++it) {
-    if (FilterField(*it, table)) {
+  for (const auto& field : filter_table.fields) {
+    if (FilterField(field, table)) {
       continue;  // Field successfully filtered
     }
-    // Get the index of this complex non-string object from the schema which is
-    // also the same index into the data table.
-    int32_t index = it->type()->index();
-    ASSERT(index != -1);
-
-    flatbuffers::Table* sub_table = table->GetPointer<flatbuffers::Table*>(it->offset());
-    const reflection::Schema* sub_schema =
-        reflection_schema_.FindInReflectionSchema(schema->objects()->Get(index)->name()->str());
-
-    if (sub_schema != nullptr) {
-      FilterTable(sub_schema, sub_table);  // Top level schema
-    } else {
-      // Leaf node schema
-      const flatbuffers::String* name = schema->objects()->Get(index)->name();
-      const reflection::Object* sub_object = internal::FindReflectionObject(schema->objects(), name);
-      if (sub_object != nullptr) {
-        FilterObject(sub_object, sub_table);
-      } else {
-        LOG_ERROR("Unable to find reflection sub object:%s\n", name->c_str());
+    if (field.sub_table == nullptr) {
+      if (filter_table.is_leaf) {
+        LOG_ERROR("%s Unable to filter field from an object when it's expected it will work", __func__);
       }
+      continue;
     }
+
+    flatbuffers::Table* sub_table = table->GetPointer<flatbuffers::Table*>(field.field->offset());
+    FilterTable(*field.sub_table, sub_table);
   }
 }
 
 void UserPrivacyFilter::FilterInPlace(char* dumpsys_data) {
   ASSERT(dumpsys_data != nullptr);
-  const reflection::Schema* root_schema = reflection_schema_.FindInReflectionSchema(reflection_schema_.GetRootName());
+  const dumpsys::FilterTable* root_table = reflection_schema_.FindFilterTable(reflection_schema_.GetRootName());
+  if (root_table == nullptr) {
+    LOG_WARN("%s schema is nullptr...probably ok", __func__);
+    return;
+  }
   flatbuffers::Table* table = const_cast<flatbuffers::Table*>(flatbuffers::GetRoot<flatbuffers::Table>(dumpsys_data));
-  FilterTable(root_schema, table);
+  FilterTable(*root_table, table);
 }
 
 std::unique_ptr<Filter> Filter::Factory(
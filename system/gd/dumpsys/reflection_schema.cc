@@ -25,10 +25,99 @@
 
 using namespace bluetooth;
 
+namespace {
+
+// The types filtered within the table holding them
+bool IsFilteredInPlace(flatbuffers::BaseType type) {
+  switch (type) {
+    case flatbuffers::BASE_TYPE_INT:
+    case flatbuffers::BASE_TYPE_FLOAT:
+    case flatbuffers::BASE_TYPE_STRING:
+    case flatbuffers::BASE_TYPE_STRUCT:
+    case flatbuffers::BASE_TYPE_BOOL:
+    case flatbuffers::BASE_TYPE_LONG:
+      return true;
+    default:
+      return false;
+  }
+}
+
+dumpsys::FilterField MakeFilterField(const reflection::Field* field) {
+  return dumpsys::FilterField{
+      .field = field,
+      .base_type = static_cast<flatbuffers::BaseType>(field->type()->base_type()),
+      .privacy_level = dumpsys::internal::FindFieldPrivacyLevel(*field),
+      .sub_table = nullptr,
+  };
+}
+
+}  // namespace
+
 dumpsys::ReflectionSchema::ReflectionSchema(const std::string& pre_bundled_schema)
     : pre_bundled_schema_(pre_bundled_schema) {
   bundled_schema_ = flatbuffers::GetRoot<bluetooth::dumpsys::BundledSchema>(pre_bundled_schema_.data());
   ASSERT(bundled_schema_ != nullptr);
+  CompileFilterTables();
+}
+
+void dumpsys::ReflectionSchema::CompileFilterTables() {
+  auto tables = std::make_shared<std::map<std::string, FilterTable>>();
+
+  // The bundled schemas come first so that the tables can refer to them
+  std::map<std::string, const reflection::Schema*> schemas;
+  const flatbuffers::Vector<flatbuffers::Offset<bluetooth::dumpsys::BundledSchemaMap>>* map = bundled_schema_->map();
+  for (auto it = map->cbegin(); it != map->cend(); ++it) {
+    flatbuffers::Verifier verifier(reinterpret_cast<const uint8_t*>(it->data()->Data()), it->data()->size());
+    if (!reflection::VerifySchemaBuffer(verifier)) {
+      LOG_WARN("Unable to verify schema buffer name:%s", it->name()->c_str());
+      continue;
+    }
+    schemas[it->name()->str()] = reflection::GetSchema(it->data()->Data());
+    (*tables)[it->name()->str()].is_leaf = false;
+  }
+
+  for (const auto& [name, schema] : schemas) {
+    const reflection::Object* object = schema->root_table();
+    if (object == nullptr) {
+      continue;
+    }
+
+    FilterTable& table = (*tables)[name];
+    for (auto it = object->fields()->cbegin(); it != object->fields()->cend(); ++it) {
+      FilterField field = MakeFilterField(*it);
+      int32_t index = it->type()->index();
+      if (!IsFilteredInPlace(field.base_type) && index != -1) {
+        const flatbuffers::String* sub_name = schema->objects()->Get(index)->name();
+        auto [sub_table, inserted] = tables->try_emplace(sub_name->str());
+        if (inserted) {
+          // Leaf table, described in this schema only
+          const reflection::Object* sub_object = internal::FindReflectionObject(schema->objects(), sub_name);
+          if (sub_object == nullptr) {
+            LOG_ERROR("Unable to find reflection sub object:%s", sub_name->c_str());
+            tables->erase(sub_table);
+            table.fields.push_back(field);
+            continue;
+          }
+          sub_table->second.is_leaf = true;
+          for (auto sub_it = sub_object->fields()->cbegin(); sub_it != sub_object->fields()->cend(); ++sub_it) {
+            sub_table->second.fields.push_back(MakeFilterField(*sub_it));
+          }
+        }
+        field.sub_table = &sub_table->second;
+      }
+      table.fields.push_back(field);
+    }
+  }
+
+  filter_tables_ = std::move(tables);
+}
+
+const dumpsys::FilterTable* dumpsys::ReflectionSchema::FindFilterTable(const std::string& name) const {
+  auto it = filter_tables_->find(name);
+  if (it == filter_tables_->end() || it->second.is_leaf) {
+    return nullptr;
+  }
+  return &it->second;
 }
 
 int dumpsys::ReflectionSchema::GetNumberOfBundledSchemas() const {
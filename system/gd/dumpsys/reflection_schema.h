@@ -16,15 +16,43 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "bundler_schema_generated.h"
+#include "dumpsys/internal/filter_internal.h"
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
 
 namespace bluetooth {
 namespace dumpsys {
 
+struct FilterTable;
+
+/**
+ * A field of a table as needed for filtering, resolved once from the
+ * reflection schema when the bundle is loaded.
+ */
+struct FilterField {
+  const reflection::Field* field;
+  flatbuffers::BaseType base_type;
+  internal::PrivacyLevel privacy_level;
+  // The fields of the table this field refers to, nullptr for primitives
+  const FilterTable* sub_table;
+};
+
+/**
+ * The fields of a table. The tables of bundled schemas may refer to other
+ * tables; leaf tables are only described in the schema that uses them and
+ * the filtering stops at their fields.
+ */
+struct FilterTable {
+  bool is_leaf;
+  std::vector<FilterField> fields;
+};
+
 class ReflectionSchema {
  public:
   ReflectionSchema(const std::string& pre_bundled_schema);
@@ -38,9 +66,19 @@ class ReflectionSchema {
   const reflection::Schema* FindInReflectionSchema(const std::string& name) const;
   void PrintReflectionSchema() const;
 
+  /**
+   * Returns the fields of the root table of the bundled schema |name|,
+   * nullptr if not found.
+   */
+  const FilterTable* FindFilterTable(const std::string& name) const;
+
  private:
+  void CompileFilterTables();
+
   const BundledSchema* bundled_schema_;
   const std::string pre_bundled_schema_;
+  // Shared by the copies, as the tables refer to each other
+  std::shared_ptr<const std::map<std::string, FilterTable>> filter_tables_;
 };
 
 }  // namespace dumpsys
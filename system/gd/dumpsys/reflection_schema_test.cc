@@ -55,6 +55,26 @@ TEST_F(ReflectionSchemaTest, verify_test_schema) {
   ASSERT_TRUE(reflection_schema.VerifyReflectionSchema());
 }
 
+TEST_F(ReflectionSchemaTest, verify_filter_tables) {
+  dumpsys::ReflectionSchema reflection_schema(testing::GetBundledSchemaData());
+  ASSERT_TRUE(reflection_schema.FindFilterTable("DoesNotExist") == nullptr);
+
+  const dumpsys::FilterTable* baz = reflection_schema.FindFilterTable("testing.BazTestSchema");
+  ASSERT_TRUE(baz != nullptr);
+  ASSERT_FALSE(baz->is_leaf);
+  ASSERT_EQ(4U, baz->fields.size());
+  for (const auto& field : baz->fields) {
+    ASSERT_TRUE(field.sub_table != nullptr);
+    ASSERT_TRUE(field.sub_table->is_leaf);
+  }
+
+  const dumpsys::FilterTable* foo = reflection_schema.FindFilterTable("testing.FooTestSchema");
+  ASSERT_TRUE(foo != nullptr);
+  for (const auto& field : foo->fields) {
+    ASSERT_TRUE(field.sub_table == nullptr);
+  }
+}
+
 TEST_F(ReflectionSchemaTest, verify_production_schema) {
   dumpsys::ReflectionSchema reflection_schema(bluetooth::dumpsys::GetBundledSchemaData());
   ASSERT_TRUE(reflection_schema.VerifyReflectionSchema());
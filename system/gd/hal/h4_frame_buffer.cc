@@ -0,0 +1,115 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/h4_frame_buffer.h"
+
+#include <cstring>
+
+#include "os/log.h"
+
+namespace {
+constexpr uint8_t kH4Command = 0x01;
+constexpr uint8_t kH4Acl = 0x02;
+constexpr uint8_t kH4Sco = 0x03;
+constexpr uint8_t kH4Event = 0x04;
+constexpr uint8_t kH4Iso = 0x05;
+
+constexpr size_t kH4HeaderSize = 1;
+constexpr size_t kHciCommandHeaderSize = 3;
+constexpr size_t kHciAclHeaderSize = 4;
+constexpr size_t kHciScoHeaderSize = 3;
+constexpr size_t kHciEvtHeaderSize = 2;
+constexpr size_t kHciIsoHeaderSize = 4;
+}  // namespace
+
+namespace bluetooth {
+namespace hal {
+
+H4FrameBuffer::H4FrameBuffer(size_t capacity) : buffer_(capacity) {}
+
+uint8_t* H4FrameBuffer::WritePtr() {
+  return buffer_.data() + end_;
+}
+
+size_t H4FrameBuffer::WritableSize() const {
+  return buffer_.size() - end_;
+}
+
+void H4FrameBuffer::Commit(size_t size) {
+  ASSERT_LOG(size <= WritableSize(), "Committed %zu bytes with only %zu writable", size, WritableSize());
+  end_ += size;
+}
+
+size_t H4FrameBuffer::FrameSize(const uint8_t* data, size_t available) {
+  const uint8_t* hci = data + kH4HeaderSize;
+  switch (data[0]) {
+    case kH4Command:
+      if (available < kH4HeaderSize + kHciCommandHeaderSize) return 0;
+      return kH4HeaderSize + kHciCommandHeaderSize + hci[2];
+    case kH4Acl:
+      if (available < kH4HeaderSize + kHciAclHeaderSize) return 0;
+      return kH4HeaderSize + kHciAclHeaderSize + ((hci[3] << 8) | hci[2]);
+    case kH4Sco:
+      if (available < kH4HeaderSize + kHciScoHeaderSize) return 0;
+      return kH4HeaderSize + kHciScoHeaderSize + hci[2];
+    case kH4Event:
+      if (available < kH4HeaderSize + kHciEvtHeaderSize) return 0;
+      return kH4HeaderSize + kHciEvtHeaderSize + hci[1];
+    case kH4Iso:
+      if (available < kH4HeaderSize + kHciIsoHeaderSize) return 0;
+      return kH4HeaderSize + kHciIsoHeaderSize + (((hci[3] & 0x3f) << 8) | hci[2]);
+    default:
+      return 0;
+  }
+}
+
+size_t H4FrameBuffer::Drain(const FrameCallback& callback) {
+  size_t delivered = 0;
+  size_t pending_frame_size = 0;
+  while (begin_ < end_) {
+    const uint8_t* frame = buffer_.data() + begin_;
+    size_t available = end_ - begin_;
+    if (frame[0] < kH4Command || frame[0] > kH4Iso) {
+      LOG_ERROR("Dropping byte with unknown H4 type 0x%02hhx", frame[0]);
+      begin_++;
+      continue;
+    }
+    size_t frame_size = FrameSize(frame, available);
+    if (frame_size == 0 || frame_size > available) {
+      pending_frame_size = frame_size;
+      break;
+    }
+    callback(frame[0], frame + kH4HeaderSize, frame_size - kH4HeaderSize);
+    begin_ += frame_size;
+    delivered++;
+  }
+
+  // Move the partial frame to the front so that the next read has the most room available.
+  if (begin_ == end_) {
+    begin_ = end_ = 0;
+  } else if (begin_ > 0) {
+    std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+    end_ -= begin_;
+    begin_ = 0;
+  }
+  if (pending_frame_size > buffer_.size()) {
+    buffer_.resize(pending_frame_size);
+  }
+  return delivered;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+
+// Reusable receive buffer for an H4 byte stream.
+//
+// The transport reads as many bytes as are available straight into WritePtr(), then Drain() slices every
+// complete H4 frame out of the buffer in place. A trailing partial frame is kept for the next read, so one
+// wakeup of the incoming thread can deliver any number of HCI packets with a single syscall.
+class H4FrameBuffer {
+ public:
+  // Invoked for each complete frame. |data| points to the HCI packet without the H4 type byte and is only
+  // valid for the duration of the call.
+  using FrameCallback = std::function<void(uint8_t h4_type, const uint8_t* data, size_t size)>;
+
+  static constexpr size_t kDefaultCapacity = 64 * 1024;
+
+  explicit H4FrameBuffer(size_t capacity = kDefaultCapacity);
+
+  // Destination for the next read from the transport.
+  uint8_t* WritePtr();
+  size_t WritableSize() const;
+
+  // Mark |size| bytes written at WritePtr() as received.
+  void Commit(size_t size);
+
+  // Deliver all complete frames to |callback|, returns the number of frames delivered.
+  size_t Drain(const FrameCallback& callback);
+
+  // Number of buffered bytes belonging to a frame that is not complete yet.
+  size_t PendingSize() const {
+    return end_ - begin_;
+  }
+
+ private:
+  // Size of the H4 frame starting at |data|, including the H4 type byte, or 0 if not enough bytes are
+  // available yet to know it.
+  static size_t FrameSize(const uint8_t* data, size_t available);
+
+  std::vector<uint8_t> buffer_;
+  size_t begin_ = 0;
+  size_t end_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/h4_frame_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr uint8_t kH4Acl = 0x02;
+constexpr uint8_t kH4Event = 0x04;
+constexpr uint8_t kH4Iso = 0x05;
+
+using Frame = std::pair<uint8_t, std::vector<uint8_t>>;
+
+class H4FrameBufferTest : public ::testing::Test {
+ protected:
+  void Receive(H4FrameBuffer& buffer, const std::vector<uint8_t>& bytes) {
+    ASSERT_LE(bytes.size(), buffer.WritableSize());
+    std::memcpy(buffer.WritePtr(), bytes.data(), bytes.size());
+    buffer.Commit(bytes.size());
+  }
+
+  size_t Drain(H4FrameBuffer& buffer) {
+    return buffer.Drain([this](uint8_t type, const uint8_t* data, size_t size) {
+      frames_.emplace_back(type, std::vector<uint8_t>(data, data + size));
+    });
+  }
+
+  std::vector<Frame> frames_;
+};
+
+TEST_F(H4FrameBufferTest, single_event) {
+  H4FrameBuffer buffer;
+  Receive(buffer, {kH4Event, 0x0e, 0x02, 0xaa, 0xbb});
+  ASSERT_EQ(1u, Drain(buffer));
+  ASSERT_EQ(1u, frames_.size());
+  EXPECT_EQ(kH4Event, frames_[0].first);
+  EXPECT_EQ(std::vector<uint8_t>({0x0e, 0x02, 0xaa, 0xbb}), frames_[0].second);
+  EXPECT_EQ(0u, buffer.PendingSize());
+}
+
+TEST_F(H4FrameBufferTest, multiple_frames_in_one_read) {
+  H4FrameBuffer buffer;
+  Receive(
+      buffer,
+      {kH4Event, 0x13, 0x01, 0x01, kH4Acl, 0x01, 0x20, 0x02, 0x00, 0x11, 0x22, kH4Iso, 0x02, 0x00, 0x01, 0x00, 0x33});
+  ASSERT_EQ(3u, Drain(buffer));
+  ASSERT_EQ(3u, frames_.size());
+  EXPECT_EQ(kH4Event, frames_[0].first);
+  EXPECT_EQ(kH4Acl, frames_[1].first);
+  EXPECT_EQ(std::vector<uint8_t>({0x01, 0x20, 0x02, 0x00, 0x11, 0x22}), frames_[1].second);
+  EXPECT_EQ(kH4Iso, frames_[2].first);
+  EXPECT_EQ(std::vector<uint8_t>({0x02, 0x00, 0x01, 0x00, 0x33}), frames_[2].second);
+}
+
+TEST_F(H4FrameBufferTest, partial_frame_is_kept_for_next_read) {
+  H4FrameBuffer buffer;
+  Receive(buffer, {kH4Event, 0x0e, 0x02, 0xaa, 0xbb, kH4Acl, 0x01});
+  ASSERT_EQ(1u, Drain(buffer));
+  EXPECT_EQ(2u, buffer.PendingSize());
+
+  Receive(buffer, {0x20, 0x01, 0x00});
+  ASSERT_EQ(0u, Drain(buffer));
+  EXPECT_EQ(5u, buffer.PendingSize());
+
+  Receive(buffer, {0x44});
+  ASSERT_EQ(1u, Drain(buffer));
+  ASSERT_EQ(2u, frames_.size());
+  EXPECT_EQ(std::vector<uint8_t>({0x01, 0x20, 0x01, 0x00, 0x44}), frames_[1].second);
+  EXPECT_EQ(0u, buffer.PendingSize());
+}
+
+TEST_F(H4FrameBufferTest, grows_for_frames_larger_than_capacity) {
+  H4FrameBuffer buffer(8);
+  Receive(buffer, {kH4Acl, 0x01, 0x20, 0x08, 0x00, 0x00, 0x01, 0x02});
+  ASSERT_EQ(0u, Drain(buffer));
+  ASSERT_GE(buffer.WritableSize(), 5u);
+  Receive(buffer, {0x03, 0x04, 0x05, 0x06, 0x07});
+  ASSERT_EQ(1u, Drain(buffer));
+  EXPECT_EQ(12u, frames_[0].second.size());
+}
+
+TEST_F(H4FrameBufferTest, unknown_type_is_skipped) {
+  H4FrameBuffer buffer;
+  Receive(buffer, {0x7f, kH4Event, 0x0e, 0x00});
+  ASSERT_EQ(1u, Drain(buffer));
+  EXPECT_EQ(kH4Event, frames_[0].first);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -70,13 +70,14 @@ class HciDeathRecipient : public ::android::hardware::hidl_death_recipient {
 
 android::sp<HciDeathRecipient> hci_death_recipient_ = new HciDeathRecipient();
 
+// Taken by reference, this runs for each packet received from the HAL
 template <class VecType>
-std::string GetTimerText(const char* func_name, VecType vec) {
+std::string GetTimerText(const char* func_name, const VecType& vec) {
   return common::StringFormat(
       "%s: len %zu, 1st 5 bytes '%s'",
       func_name,
       vec.size(),
-      common::ToHexString(vec.begin(), std::min(vec.end(), vec.begin() + 5)).c_str());
+      common::ToHexString(vec.begin(), vec.begin() + std::min<size_t>(vec.size(), 5)).c_str());
 }
 
 class InternalHciCallbacks : public IBluetoothHciCallbacks_1_1 {
@@ -21,12 +21,15 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <array>
 #include <chrono>
 #include <csignal>
 #include <mutex>
 #include <queue>
+#include <utility>
 
 #include "gd/common/init_flags.h"
 #include "hal/hci_hal.h"
@@ -52,6 +55,7 @@ constexpr uint8_t kHciScoHeaderSize = 3;
 constexpr uint8_t kHciEvtHeaderSize = 2;
 constexpr uint8_t kHciIsoHeaderSize = 4;
 constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
+constexpr size_t kMaxBatchedPackets = 16;  // Datagrams read from the user channel per wakeup
 
 constexpr uint8_t BTPROTO_HCI = 1;
 constexpr uint16_t HCI_CHANNEL_USER = 1;
@@ -236,8 +240,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(command);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
-    packet.insert(packet.cbegin(), kH4Command);
-    write_to_fd(packet);
+    write_to_fd(kH4Command, std::move(packet));
   }
 
   void sendAclData(HciPacket data) override {
@@ -245,8 +248,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
-    packet.insert(packet.cbegin(), kH4Acl);
-    write_to_fd(packet);
+    write_to_fd(kH4Acl, std::move(packet));
   }
 
   void sendScoData(HciPacket data) override {
@@ -254,8 +256,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::SCO);
-    packet.insert(packet.cbegin(), kH4Sco);
-    write_to_fd(packet);
+    write_to_fd(kH4Sco, std::move(packet));
   }
 
   void sendIsoData(HciPacket data) override {
@@ -263,8 +264,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ISO);
-    packet.insert(packet.cbegin(), kH4Iso);
-    write_to_fd(packet);
+    write_to_fd(kH4Iso, std::move(packet));
   }
 
   uint16_t getMsftOpcode() override {
@@ -282,6 +282,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ == INVALID_FD);
     sock_fd_ = ConnectToSocket();
     ASSERT(sock_fd_ != INVALID_FD);
+    setup_incoming_msgs();
     reactable_ = hci_incoming_thread_.GetReactor()->Register(
         sock_fd_,
         common::Bind(&HciHalHost::incoming_packet_received, common::Unretained(this)),
@@ -325,12 +326,16 @@ class HciHalHost : public HciHal {
   bluetooth::os::Thread hci_incoming_thread_ =
       bluetooth::os::Thread("hci_incoming_thread", bluetooth::os::Thread::Priority::NORMAL);
   bluetooth::os::Reactor::Reactable* reactable_ = nullptr;
-  std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
+  // H4 packet type and HCI packet, written with a single writev() so the type byte is never prepended
+  std::queue<std::pair<uint8_t, HciPacket>> hci_outgoing_queue_;
   SnoopLogger* btsnoop_logger_ = nullptr;
+  std::array<std::array<uint8_t, kBufSize>, kMaxBatchedPackets> incoming_bufs_;
+  std::array<struct iovec, kMaxBatchedPackets> incoming_iovs_;
+  std::array<struct mmsghdr, kMaxBatchedPackets> incoming_msgs_;
 
-  void write_to_fd(HciPacket packet) {
+  void write_to_fd(uint8_t h4_type, HciPacket packet) {
     // TODO: replace this with new queue when it's ready
-    hci_outgoing_queue_.emplace(packet);
+    hci_outgoing_queue_.emplace(h4_type, std::move(packet));
     if (hci_outgoing_queue_.size() == 1) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_WRITE);
     }
@@ -339,8 +344,12 @@ class HciHalHost : public HciHal {
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(api_mutex_);
     if (hci_outgoing_queue_.empty()) return;
-    auto packet_to_send = hci_outgoing_queue_.front();
-    auto bytes_written = write(sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
+    auto& [h4_type, packet_to_send] = hci_outgoing_queue_.front();
+    struct iovec iov[] = {
+        {.iov_base = &h4_type, .iov_len = sizeof(h4_type)},
+        {.iov_base = packet_to_send.data(), .iov_len = packet_to_send.size()},
+    };
+    auto bytes_written = writev(sock_fd_, iov, 2);
     hci_outgoing_queue_.pop();
     if (bytes_written == -1) {
       abort();
@@ -358,19 +367,49 @@ class HciHalHost : public HciHal {
         return;
       }
     }
-    uint8_t buf[kBufSize] = {};
-
-    ssize_t received_size;
-    RUN_NO_INTR(received_size = read(sock_fd_, buf, kBufSize));
-    ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
-    if (received_size == 0) {
-      LOG_WARN("Can't read H4 header. EOF received");
-      // First close sock fd before raising sigint
-      close(sock_fd_);
-      raise(SIGINT);
+
+    // The HCI user channel delivers one H4 packet per datagram. Pull every datagram already queued on the
+    // socket with a single recvmmsg() instead of paying one read() per packet.
+    int received_count;
+    RUN_NO_INTR(
+        received_count = recvmmsg(sock_fd_, incoming_msgs_.data(), incoming_msgs_.size(), MSG_DONTWAIT, nullptr));
+    if (received_count == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    ASSERT_LOG(received_count != -1, "Can't receive from socket: %s", strerror(errno));
+    if (received_count == 0) {
+      handle_eof();
       return;
     }
 
+    for (int i = 0; i < received_count; i++) {
+      ssize_t received_size = incoming_msgs_[i].msg_len;
+      if (received_size == 0) {
+        handle_eof();
+        return;
+      }
+      process_incoming_packet(incoming_bufs_[i].data(), received_size);
+    }
+  }
+
+  void handle_eof() {
+    LOG_WARN("Can't read H4 header. EOF received");
+    // First close sock fd before raising sigint
+    close(sock_fd_);
+    raise(SIGINT);
+  }
+
+  void setup_incoming_msgs() {
+    for (size_t i = 0; i < kMaxBatchedPackets; i++) {
+      incoming_iovs_[i].iov_base = incoming_bufs_[i].data();
+      incoming_iovs_[i].iov_len = incoming_bufs_[i].size();
+      incoming_msgs_[i] = {};
+      incoming_msgs_[i].msg_hdr.msg_iov = &incoming_iovs_[i];
+      incoming_msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  void process_incoming_packet(const uint8_t* buf, ssize_t received_size) {
     if (buf[0] == kH4Event) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciEvtHeaderSize, "Received bad HCI_EVT packet size: %zu", received_size);
@@ -391,7 +430,7 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping an event after processing");
           return;
         }
-        incoming_packet_callback_->hciEventReceived(receivedHciPacket);
+        incoming_packet_callback_->hciEventReceived(std::move(receivedHciPacket));
       }
     }
 
@@ -416,7 +455,7 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping an ACL packet after processing");
           return;
         }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
+        incoming_packet_callback_->aclDataReceived(std::move(receivedHciPacket));
       }
     }
 
@@ -440,7 +479,7 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping a SCO packet after processing");
           return;
         }
-        incoming_packet_callback_->scoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->scoDataReceived(std::move(receivedHciPacket));
       }
     }
 
@@ -464,10 +503,9 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping a ISO packet after processing");
           return;
         }
-        incoming_packet_callback_->isoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->isoDataReceived(std::move(receivedHciPacket));
       }
     }
-    memset(buf, 0, kBufSize);
   }
 };
 
@@ -21,13 +21,16 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <chrono>
 #include <csignal>
 #include <mutex>
 #include <queue>
+#include <utility>
 
+#include "hal/h4_frame_buffer.h"
 #include "hal/hci_hal.h"
 #include "hal/snoop_logger.h"
 #include "metrics/counter_metrics.h"
@@ -44,13 +47,6 @@ constexpr uint8_t kH4Sco = 0x03;
 constexpr uint8_t kH4Event = 0x04;
 constexpr uint8_t kH4Iso = 0x05;
 
-constexpr uint8_t kH4HeaderSize = 1;
-constexpr uint8_t kHciAclHeaderSize = 4;
-constexpr uint8_t kHciScoHeaderSize = 3;
-constexpr uint8_t kHciEvtHeaderSize = 2;
-constexpr uint8_t kHciIsoHeaderSize = 4;
-constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
-
 int ConnectToSocket() {
   auto* config = bluetooth::hal::HciHalHostRootcanalConfig::Get();
   const std::string& server = config->GetServerAddress();
@@ -125,8 +121,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(command);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
-    packet.insert(packet.cbegin(), kH4Command);
-    write_to_fd(packet);
+    write_to_fd(kH4Command, std::move(packet));
   }
 
   void sendAclData(HciPacket data) override {
@@ -134,8 +129,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
-    packet.insert(packet.cbegin(), kH4Acl);
-    write_to_fd(packet);
+    write_to_fd(kH4Acl, std::move(packet));
   }
 
   void sendScoData(HciPacket data) override {
@@ -143,8 +137,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::SCO);
-    packet.insert(packet.cbegin(), kH4Sco);
-    write_to_fd(packet);
+    write_to_fd(kH4Sco, std::move(packet));
   }
 
   void sendIsoData(HciPacket data) override {
@@ -152,8 +145,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ISO);
-    packet.insert(packet.cbegin(), kH4Iso);
-    write_to_fd(packet);
+    write_to_fd(kH4Iso, std::move(packet));
   }
 
  protected:
@@ -210,12 +202,14 @@ class HciHalHost : public HciHal {
   bluetooth::os::Thread hci_incoming_thread_ =
       bluetooth::os::Thread("hci_incoming_thread", bluetooth::os::Thread::Priority::NORMAL);
   bluetooth::os::Reactor::Reactable* reactable_ = nullptr;
-  std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
+  // H4 packet type and HCI packet, written with a single writev() so the type byte is never prepended
+  std::queue<std::pair<uint8_t, HciPacket>> hci_outgoing_queue_;
   SnoopLogger* btsnoop_logger_ = nullptr;
+  H4FrameBuffer incoming_buffer_;
 
-  void write_to_fd(HciPacket packet) {
+  void write_to_fd(uint8_t h4_type, HciPacket packet) {
     // TODO: replace this with new queue when it's ready
-    hci_outgoing_queue_.emplace(packet);
+    hci_outgoing_queue_.emplace(h4_type, std::move(packet));
     if (hci_outgoing_queue_.size() == 1) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_WRITE);
     }
@@ -224,8 +218,12 @@ class HciHalHost : public HciHal {
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(api_mutex_);
     if (hci_outgoing_queue_.empty()) return;
-    auto packet_to_send = hci_outgoing_queue_.front();
-    auto bytes_written = write(sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
+    auto& [h4_type, packet_to_send] = hci_outgoing_queue_.front();
+    struct iovec iov[] = {
+        {.iov_base = &h4_type, .iov_len = sizeof(h4_type)},
+        {.iov_base = packet_to_send.data(), .iov_len = packet_to_send.size()},
+    };
+    auto bytes_written = writev(sock_fd_, iov, 2);
     hci_outgoing_queue_.pop();
     if (bytes_written == -1) {
       abort();
@@ -235,20 +233,6 @@ class HciHalHost : public HciHal {
     }
   }
 
-  bool socketRecvAll(void* buffer, int bufferLen) {
-    auto buf = static_cast<char*>(buffer);
-    while (bufferLen > 0) {
-      ssize_t ret;
-      RUN_NO_INTR(ret = recv(sock_fd_, buf, bufferLen, 0));
-      if (ret <= 0) {
-        return false;
-      }
-      buf += ret;
-      bufferLen -= ret;
-    }
-    return true;
-  }
-
   void incoming_packet_received() {
     {
       std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -257,113 +241,68 @@ class HciHalHost : public HciHal {
         return;
       }
     }
-    uint8_t buf[kBufSize] = {};
 
+    // Drain everything the socket has ready in one read, then slice out all the complete H4 frames.
     ssize_t received_size;
-    RUN_NO_INTR(received_size = recv(sock_fd_, buf, kH4HeaderSize, 0));
+    RUN_NO_INTR(received_size = recv(sock_fd_, incoming_buffer_.WritePtr(), incoming_buffer_.WritableSize(), 0));
     ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
     if (received_size == 0) {
       LOG_WARN("Can't read H4 header. EOF received");
       raise(SIGINT);
       return;
     }
+    incoming_buffer_.Commit(received_size);
+    incoming_buffer_.Drain([this](uint8_t h4_type, const uint8_t* data, size_t size) {
+      dispatch_incoming_packet(h4_type, HciPacket(data, data + size));
+    });
+  }
 
-    if (buf[0] == kH4Event) {
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize, kHciEvtHeaderSize), "Can't receive from socket: %s", strerror(errno));
-
-      uint8_t hci_evt_parameter_total_length = buf[2];
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize + kHciEvtHeaderSize, hci_evt_parameter_total_length),
-          "Can't receive from socket: %s",
-          strerror(errno));
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciEvtHeaderSize + hci_evt_parameter_total_length);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
-      {
+  void dispatch_incoming_packet(uint8_t h4_type, HciPacket packet) {
+    switch (h4_type) {
+      case kH4Event: {
+        btsnoop_logger_->Capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping an event after processing");
           return;
         }
-        incoming_packet_callback_->hciEventReceived(receivedHciPacket);
+        incoming_packet_callback_->hciEventReceived(std::move(packet));
+        break;
       }
-    }
-
-    if (buf[0] == kH4Acl) {
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize, kHciAclHeaderSize), "Can't receive from socket: %s", strerror(errno));
-
-      uint16_t hci_acl_data_total_length = (buf[4] << 8) + buf[3];
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize + kHciAclHeaderSize, hci_acl_data_total_length),
-          "Can't receive from socket: %s",
-          strerror(errno));
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciAclHeaderSize + hci_acl_data_total_length);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
-      {
+      case kH4Acl: {
+        btsnoop_logger_->Capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping an ACL packet after processing");
           return;
         }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
+        incoming_packet_callback_->aclDataReceived(std::move(packet));
+        break;
       }
-    }
-
-    if (buf[0] == kH4Sco) {
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize, kHciScoHeaderSize), "Can't receive from socket: %s", strerror(errno));
-
-      uint8_t hci_sco_data_total_length = buf[3];
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize + kHciScoHeaderSize, hci_sco_data_total_length),
-          "Can't receive from socket: %s",
-          strerror(errno));
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciScoHeaderSize + hci_sco_data_total_length);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
-      {
+      case kH4Sco: {
+        btsnoop_logger_->Capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping a SCO packet after processing");
           return;
         }
-        incoming_packet_callback_->scoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->scoDataReceived(std::move(packet));
+        break;
       }
-    }
-
-    if (buf[0] == kH4Iso) {
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize, kHciIsoHeaderSize), "Can't receive from socket: %s", strerror(errno));
-
-      uint16_t hci_iso_data_total_length = ((buf[4] & 0x3f) << 8) + buf[3];
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize + kHciIsoHeaderSize, hci_iso_data_total_length),
-          "Can't receive from socket: %s",
-          strerror(errno));
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciIsoHeaderSize + hci_iso_data_total_length);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
-      {
+      case kH4Iso: {
+        btsnoop_logger_->Capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping a ISO packet after processing");
           return;
         }
-        incoming_packet_callback_->isoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->isoDataReceived(std::move(packet));
+        break;
       }
+      default:
+        LOG_WARN("Dropping a packet with unexpected H4 type 0x%02hhx", h4_type);
+        break;
     }
-    memset(buf, 0, kBufSize);
   }
 };
 
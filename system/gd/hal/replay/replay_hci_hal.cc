@@ -0,0 +1,164 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/replay/replay_hci_hal.h"
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hal {
+namespace replay {
+
+namespace {
+
+constexpr uint8_t kCommandCompleteCode = 0x0e;
+constexpr uint8_t kCommandStatusCode = 0x0f;
+constexpr uint8_t kNumberOfCompletedPacketsCode = 0x13;
+
+// The offset of the op code in the events
+constexpr size_t kCommandCompleteOpCodeOffset = 3;
+constexpr size_t kCommandStatusOpCodeOffset = 4;
+
+uint16_t GetUint16(const HciPacket& packet, size_t offset) {
+  return packet[offset] | (packet[offset + 1] << 8);
+}
+
+// Complete a single packet of the connection of an ACL or ISO packet
+HciPacket NumberOfCompletedPackets(const HciPacket& packet) {
+  uint16_t handle = GetUint16(packet, 0) & 0x0fff;
+  return {
+      kNumberOfCompletedPacketsCode,
+      0x05,
+      0x01,
+      static_cast<uint8_t>(handle),
+      static_cast<uint8_t>(handle >> 8),
+      0x01,
+      0x00,
+  };
+}
+
+}  // namespace
+
+void ReplayHciHal::Load(std::vector<SnoopLogReader::Packet> packets) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  responses_.clear();
+  traffic_.clear();
+  for (auto& packet : packets) {
+    if (packet.direction != SnoopLogger::Direction::INCOMING) {
+      continue;
+    }
+    if (packet.type == SnoopLogger::PacketType::EVT && packet.data.size() >= 2) {
+      uint8_t code = packet.data[0];
+      if (code == kCommandCompleteCode && packet.data.size() >= kCommandCompleteOpCodeOffset + 2) {
+        responses_[GetUint16(packet.data, kCommandCompleteOpCodeOffset)].push_back(std::move(packet.data));
+        continue;
+      }
+      if (code == kCommandStatusCode && packet.data.size() >= kCommandStatusOpCodeOffset + 2) {
+        responses_[GetUint16(packet.data, kCommandStatusOpCodeOffset)].push_back(std::move(packet.data));
+        continue;
+      }
+      if (code == kNumberOfCompletedPacketsCode) {
+        continue;
+      }
+    }
+    traffic_.push_back(std::move(packet));
+  }
+}
+
+void ReplayHciHal::registerIncomingPacketCallback(HciHalCallbacks* callbacks) {
+  callbacks_ = callbacks;
+}
+
+void ReplayHciHal::unregisterIncomingPacketCallback() {
+  callbacks_ = nullptr;
+}
+
+void ReplayHciHal::sendHciCommand(HciPacket command) {
+  if (command.size() < 2) {
+    return;
+  }
+  uint16_t op_code = GetUint16(command, 0);
+  HciPacket response;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto recorded = responses_.find(op_code);
+    if (recorded != responses_.end() && !recorded->second.empty()) {
+      response = std::move(recorded->second.front());
+      recorded->second.pop_front();
+    }
+  }
+  if (response.empty()) {
+    unscripted_command_count_++;
+    // Long enough for the fixed return parameters of any command
+    response = HciPacket(255 + 2, 0);
+    response[0] = kCommandCompleteCode;
+    response[1] = 255;
+    response[2] = 0x01;
+    response[3] = static_cast<uint8_t>(op_code);
+    response[4] = static_cast<uint8_t>(op_code >> 8);
+  }
+
+  HciHalCallbacks* callbacks = callbacks_;
+  if (callbacks != nullptr) {
+    callbacks->hciEventReceived(std::move(response));
+  }
+}
+
+void ReplayHciHal::sendAclData(HciPacket packet) {
+  HciHalCallbacks* callbacks = callbacks_;
+  if (callbacks != nullptr && packet.size() >= 2) {
+    callbacks->hciEventReceived(NumberOfCompletedPackets(packet));
+  }
+}
+
+void ReplayHciHal::sendScoData(HciPacket packet) {}
+
+void ReplayHciHal::sendIsoData(HciPacket packet) {
+  HciHalCallbacks* callbacks = callbacks_;
+  if (callbacks != nullptr && packet.size() >= 2) {
+    callbacks->hciEventReceived(NumberOfCompletedPackets(packet));
+  }
+}
+
+void ReplayHciHal::InjectTraffic(const SnoopLogReader::Packet& packet) {
+  HciHalCallbacks* callbacks = callbacks_;
+  if (callbacks == nullptr) {
+    return;
+  }
+  switch (packet.type) {
+    case SnoopLogger::PacketType::EVT:
+      callbacks->hciEventReceived(packet.data);
+      break;
+    case SnoopLogger::PacketType::ACL:
+      callbacks->aclDataReceived(packet.data);
+      break;
+    case SnoopLogger::PacketType::SCO:
+      callbacks->scoDataReceived(packet.data);
+      break;
+    case SnoopLogger::PacketType::ISO:
+      callbacks->isoDataReceived(packet.data);
+      break;
+    default:
+      LOG_WARN("Unexpected incoming packet type %d", packet.type);
+      break;
+  }
+}
+
+const ModuleFactory ReplayHciHal::Factory = ModuleFactory([]() { return new ReplayHciHal(); });
+
+}  // namespace replay
+}  // namespace hal
+}  // namespace bluetooth
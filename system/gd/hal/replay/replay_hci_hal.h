@@ -0,0 +1,87 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "hal/hci_hal.h"
+#include "hal/snoop_log_reader.h"
+
+namespace bluetooth {
+namespace hal {
+namespace replay {
+
+// A controller scripted by a btsnoop log, to replay the traffic of the log through the stack
+//
+// The commands the stack sends are answered with the Command Complete or Command Status events recorded for their
+// op code, in order, or with a successful Command Complete with zeroed return parameters once the recorded ones run
+// out. The captures taken from the enabling of Bluetooth answer the initialization of the stack as the controller
+// did. Each ACL packet the stack sends is completed right away, instead of the Number Of Completed Packets events of
+// the log that counted what the stack sent back then.
+//
+// The rest of the incoming packets of the log are the traffic, that InjectTraffic() feeds to the stack.
+class ReplayHciHal : public HciHal {
+ public:
+  // Take the responses and the traffic from the packets of a log
+  void Load(std::vector<SnoopLogReader::Packet> packets);
+
+  void registerIncomingPacketCallback(HciHalCallbacks* callbacks) override;
+  void unregisterIncomingPacketCallback() override;
+
+  void sendHciCommand(HciPacket command) override;
+  void sendAclData(HciPacket packet) override;
+  void sendScoData(HciPacket packet) override;
+  void sendIsoData(HciPacket packet) override;
+
+  const std::vector<SnoopLogReader::Packet>& GetTraffic() const {
+    return traffic_;
+  }
+
+  // Deliver the incoming packet to the stack, as the HAL would
+  void InjectTraffic(const SnoopLogReader::Packet& packet);
+
+  // Commands answered without a recorded response
+  size_t GetUnscriptedCommandCount() const {
+    return unscripted_command_count_;
+  }
+
+  std::string ToString() const override {
+    return "ReplayHciHal";
+  }
+
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const override {}
+  void Start() override {}
+  void Stop() override {}
+
+ private:
+  std::mutex mutex_;
+  std::map<uint16_t, std::deque<HciPacket>> responses_;
+  std::vector<SnoopLogReader::Packet> traffic_;
+  std::atomic<HciHalCallbacks*> callbacks_ = nullptr;
+  std::atomic<size_t> unscripted_command_count_ = 0;
+};
+
+}  // namespace replay
+}  // namespace hal
+}  // namespace bluetooth
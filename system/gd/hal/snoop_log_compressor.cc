@@ -0,0 +1,87 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_log_compressor.h"
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+// Adding 16 to the window bits makes zlib write a gzip header and trailer
+constexpr int kGzipWindowBits = 15 + 16;
+constexpr int kMemoryLevel = 8;
+constexpr size_t kOutputChunkSize = 16 * 1024;
+
+}  // namespace
+
+SnoopLogCompressor::SnoopLogCompressor(std::ostream* output) : output_(output) {
+  ASSERT(output_ != nullptr);
+  int ret = deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, kGzipWindowBits, kMemoryLevel, Z_DEFAULT_STRATEGY);
+  ASSERT_LOG(ret == Z_OK, "Unable to initialize the snoop log compression, error %d", ret);
+}
+
+SnoopLogCompressor::~SnoopLogCompressor() {
+  deflateEnd(&stream_);
+}
+
+bool SnoopLogCompressor::Write(const void* data, size_t size) {
+  if (finished_) {
+    return false;
+  }
+  stream_.next_in = static_cast<Bytef*>(const_cast<void*>(data));
+  stream_.avail_in = static_cast<uInt>(size);
+  return Deflate(Z_NO_FLUSH);
+}
+
+bool SnoopLogCompressor::Flush() {
+  if (finished_) {
+    return false;
+  }
+  return Deflate(Z_SYNC_FLUSH) && output_->flush();
+}
+
+bool SnoopLogCompressor::Finish() {
+  if (finished_) {
+    return false;
+  }
+  finished_ = true;
+  return Deflate(Z_FINISH) && output_->flush();
+}
+
+bool SnoopLogCompressor::Deflate(int flush) {
+  Bytef chunk[kOutputChunkSize];
+  do {
+    stream_.next_out = chunk;
+    stream_.avail_out = sizeof(chunk);
+    int ret = deflate(&stream_, flush);
+    if (ret == Z_STREAM_ERROR) {
+      LOG_ERROR("Failed to compress the snoop log");
+      return false;
+    }
+    size_t compressed_size = sizeof(chunk) - stream_.avail_out;
+    if (compressed_size > 0 && !output_->write(reinterpret_cast<const char*>(chunk), compressed_size)) {
+      return false;
+    }
+    // deflate() fills the whole chunk when there is more output pending
+  } while (stream_.avail_out == 0);
+  return true;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <ostream>
+
+namespace bluetooth {
+namespace hal {
+
+// Compress a btsnoop log into a gzip stream, as it is written
+//
+// Every Flush() ends a deflate block, so that everything written so far can be decompressed even if the stream is
+// never finished, e.g. when the process crashes. Tools reading btsnoop logs, like Wireshark, open the gzip file as is.
+class SnoopLogCompressor {
+ public:
+  explicit SnoopLogCompressor(std::ostream* output);
+  SnoopLogCompressor(const SnoopLogCompressor&) = delete;
+  SnoopLogCompressor& operator=(const SnoopLogCompressor&) = delete;
+  ~SnoopLogCompressor();
+
+  bool Write(const void* data, size_t size);
+  // Write the compressed data to the output stream, and flush it
+  bool Flush();
+  // Write the end of the gzip stream. Nothing can be written afterwards.
+  bool Finish();
+
+ private:
+  bool Deflate(int flush);
+
+  std::ostream* output_;
+  z_stream stream_{};
+  bool finished_ = false;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
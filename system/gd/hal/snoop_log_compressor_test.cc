@@ -0,0 +1,77 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_log_compressor.h"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+using bluetooth::hal::SnoopLogCompressor;
+
+// Decompress as much of |compressed| as possible, a missing gzip trailer is not an error
+std::string Decompress(const std::string& compressed) {
+  z_stream stream{};
+  EXPECT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+  stream.avail_in = compressed.size();
+  std::string decompressed;
+  char chunk[256];
+  int ret;
+  do {
+    stream.next_out = reinterpret_cast<Bytef*>(chunk);
+    stream.avail_out = sizeof(chunk);
+    ret = inflate(&stream, Z_NO_FLUSH);
+    decompressed.append(chunk, sizeof(chunk) - stream.avail_out);
+  } while (ret == Z_OK && stream.avail_in > 0);
+  inflateEnd(&stream);
+  return decompressed;
+}
+
+TEST(SnoopLogCompressorTest, write_and_finish) {
+  std::ostringstream output;
+  std::string data;
+  for (int i = 0; i < 1000; i++) {
+    data.append("btsnoop packet " + std::to_string(i));
+  }
+  {
+    SnoopLogCompressor compressor(&output);
+    ASSERT_TRUE(compressor.Write(data.data(), data.size()));
+    ASSERT_TRUE(compressor.Finish());
+    ASSERT_FALSE(compressor.Write(data.data(), data.size()));
+  }
+  ASSERT_LT(output.str().size(), data.size());
+  ASSERT_EQ(Decompress(output.str()), data);
+}
+
+TEST(SnoopLogCompressorTest, flushed_data_can_be_decompressed) {
+  std::ostringstream output;
+  SnoopLogCompressor compressor(&output);
+  std::string first("first packet");
+  std::string second("second packet");
+  ASSERT_TRUE(compressor.Write(first.data(), first.size()));
+  ASSERT_TRUE(compressor.Flush());
+  ASSERT_EQ(Decompress(output.str()), first);
+  ASSERT_TRUE(compressor.Write(second.data(), second.size()));
+  ASSERT_TRUE(compressor.Flush());
+  ASSERT_EQ(Decompress(output.str()), first + second);
+}
+
+}  // namespace
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_log_reader.h"
+
+#include <arpa/inet.h>
+
+#include <cstring>
+
+#include "hal/snoop_logger_common.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+uint64_t ntohll(uint64_t ll) {
+  if constexpr (isLittleEndian) {
+    return static_cast<uint64_t>(ntohl(ll & 0xffffffff)) << 32 | ntohl(ll >> 32);
+  } else {
+    return ll;
+  }
+}
+
+}  // namespace
+
+SnoopLogReader::SnoopLogReader(std::istream* input) : input_(input) {
+  SnoopLoggerCommon::FileHeaderType header;
+  if (!input_->read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return;
+  }
+  valid_ = memcmp(
+               header.identification_pattern,
+               SnoopLoggerCommon::kBtSnoopFileHeader.identification_pattern,
+               sizeof(header.identification_pattern)) == 0 &&
+           header.version_number == SnoopLoggerCommon::kBtSnoopFileHeader.version_number &&
+           header.datalink_type == SnoopLoggerCommon::kBtSnoopFileHeader.datalink_type;
+}
+
+std::optional<SnoopLogReader::Packet> SnoopLogReader::Next() {
+  while (valid_) {
+    SnoopLogger::PacketHeaderType header;
+    if (!input_->read(reinterpret_cast<char*>(&header), sizeof(header))) {
+      return std::nullopt;
+    }
+    uint32_t length_original = ntohl(header.length_original);
+    uint32_t length_captured = ntohl(header.length_captured);
+    if (length_captured == 0) {
+      LOG_WARN("Record without a packet type");
+      return std::nullopt;
+    }
+
+    HciPacket data(length_captured - 1);
+    if (!input_->read(reinterpret_cast<char*>(data.data()), data.size())) {
+      return std::nullopt;
+    }
+    if (length_captured != length_original) {
+      truncated_count_++;
+      continue;
+    }
+
+    bool received = ntohl(header.flags) & 0x1;
+    return Packet{
+        .type = static_cast<SnoopLogger::PacketType>(header.type),
+        .direction = received ? SnoopLogger::Direction::INCOMING : SnoopLogger::Direction::OUTGOING,
+        .timestamp = std::chrono::microseconds(ntohll(header.timestamp)),
+        .data = std::move(data),
+    };
+  }
+  return std::nullopt;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <optional>
+
+#include "hal/hci_hal.h"
+#include "hal/snoop_logger.h"
+
+namespace bluetooth {
+namespace hal {
+
+// Read the packets of an uncompressed btsnoop log with the H4 datalink type, as written by SnoopLogger
+//
+// The packets truncated by the filtered snoop log modes are skipped, since their content can't be replayed.
+class SnoopLogReader {
+ public:
+  struct Packet {
+    SnoopLogger::PacketType type;
+    SnoopLogger::Direction direction;
+    // Since the start of the year 0 AD, as in the log
+    std::chrono::microseconds timestamp;
+    // Without the H4 packet type
+    HciPacket data;
+  };
+
+  explicit SnoopLogReader(std::istream* input);
+  SnoopLogReader(const SnoopLogReader&) = delete;
+  SnoopLogReader& operator=(const SnoopLogReader&) = delete;
+
+  // Whether the input starts with the btsnoop file header
+  bool IsValid() const {
+    return valid_;
+  }
+
+  // Return the next complete packet, or std::nullopt at the end of the log or at a record cut short
+  std::optional<Packet> Next();
+
+  size_t GetTruncatedCount() const {
+    return truncated_count_;
+  }
+
+ private:
+  std::istream* input_;
+  bool valid_ = false;
+  size_t truncated_count_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
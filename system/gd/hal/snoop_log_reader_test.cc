@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_log_reader.h"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "hal/snoop_logger_common.h"
+
+namespace testing {
+
+using bluetooth::hal::HciPacket;
+using bluetooth::hal::SnoopLoggerCommon;
+using bluetooth::hal::SnoopLogger;
+using bluetooth::hal::SnoopLogReader;
+
+class SnoopLogReaderTest : public Test {
+ protected:
+  void WriteHeader() {
+    log_.write(
+        reinterpret_cast<const char*>(&SnoopLoggerCommon::kBtSnoopFileHeader),
+        sizeof(SnoopLoggerCommon::kBtSnoopFileHeader));
+  }
+
+  void WriteRecord(
+      uint32_t flags, uint64_t timestamp, SnoopLogger::PacketType type, const HciPacket& data, size_t captured) {
+    SnoopLogger::PacketHeaderType header = {
+        .length_original = htonl(data.size() + 1),
+        .length_captured = htonl(captured + 1),
+        .flags = htonl(flags),
+        .dropped_packets = 0,
+        .timestamp = static_cast<uint64_t>(htonl(timestamp & 0xffffffff)) << 32 | htonl(timestamp >> 32),
+        .type = static_cast<uint8_t>(type)};
+    log_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    log_.write(reinterpret_cast<const char*>(data.data()), captured);
+  }
+
+  std::stringstream log_;
+};
+
+TEST_F(SnoopLogReaderTest, read_packets) {
+  WriteHeader();
+  HciPacket reset = {0x03, 0x0c, 0x00};
+  HciPacket complete = {0x0e, 0x04, 0x01, 0x03, 0x0c, 0x00};
+  HciPacket acl = {0x01, 0x20, 0x02, 0x00, 0xaa, 0xbb};
+  WriteRecord(0x2, 1000, SnoopLogger::PacketType::CMD, reset, reset.size());
+  WriteRecord(0x3, 2000, SnoopLogger::PacketType::EVT, complete, complete.size());
+  WriteRecord(0x1, 3000, SnoopLogger::PacketType::ACL, acl, acl.size());
+
+  SnoopLogReader reader(&log_);
+  ASSERT_TRUE(reader.IsValid());
+
+  auto packet = reader.Next();
+  ASSERT_TRUE(packet.has_value());
+  ASSERT_EQ(packet->type, SnoopLogger::PacketType::CMD);
+  ASSERT_EQ(packet->direction, SnoopLogger::Direction::OUTGOING);
+  ASSERT_EQ(packet->timestamp, std::chrono::microseconds(1000));
+  ASSERT_EQ(packet->data, reset);
+
+  packet = reader.Next();
+  ASSERT_TRUE(packet.has_value());
+  ASSERT_EQ(packet->type, SnoopLogger::PacketType::EVT);
+  ASSERT_EQ(packet->direction, SnoopLogger::Direction::INCOMING);
+  ASSERT_EQ(packet->data, complete);
+
+  packet = reader.Next();
+  ASSERT_TRUE(packet.has_value());
+  ASSERT_EQ(packet->type, SnoopLogger::PacketType::ACL);
+  ASSERT_EQ(packet->direction, SnoopLogger::Direction::INCOMING);
+  ASSERT_EQ(packet->timestamp, std::chrono::microseconds(3000));
+  ASSERT_EQ(packet->data, acl);
+
+  ASSERT_FALSE(reader.Next().has_value());
+}
+
+TEST_F(SnoopLogReaderTest, skip_truncated_packets) {
+  WriteHeader();
+  HciPacket acl = {0x01, 0x20, 0x04, 0x00, 0x00, 0x00, 0x40, 0x00};
+  WriteRecord(0x1, 1000, SnoopLogger::PacketType::ACL, acl, 4);
+  WriteRecord(0x1, 2000, SnoopLogger::PacketType::ACL, acl, acl.size());
+
+  SnoopLogReader reader(&log_);
+  ASSERT_TRUE(reader.IsValid());
+  auto packet = reader.Next();
+  ASSERT_TRUE(packet.has_value());
+  ASSERT_EQ(packet->timestamp, std::chrono::microseconds(2000));
+  ASSERT_EQ(reader.GetTruncatedCount(), 1u);
+  ASSERT_FALSE(reader.Next().has_value());
+}
+
+TEST_F(SnoopLogReaderTest, invalid_header) {
+  log_ << "not a btsnoop log";
+  SnoopLogReader reader(&log_);
+  ASSERT_FALSE(reader.IsValid());
+  ASSERT_FALSE(reader.Next().has_value());
+}
+
+TEST_F(SnoopLogReaderTest, record_cut_short) {
+  WriteHeader();
+  HciPacket reset = {0x03, 0x0c, 0x00};
+  WriteRecord(0x2, 1000, SnoopLogger::PacketType::CMD, reset, reset.size());
+  std::string content = log_.str();
+  log_.str(content.substr(0, content.size() - 1));
+
+  SnoopLogReader reader(&log_);
+  ASSERT_TRUE(reader.IsValid());
+  ASSERT_FALSE(reader.Next().has_value());
+}
+
+}  // namespace testing
@@ -20,11 +20,12 @@
 #include <sys/stat.h>
 
 #include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <chrono>
-#include <sstream>
+#include <cstring>
+#include <string_view>
 
-#include "common/circular_buffer.h"
 #include "common/init_flags.h"
 #include "common/strings.h"
 #include "hal/snoop_logger_common.h"
@@ -43,8 +44,12 @@ namespace hal {
 
 // Adds L2CAP channel to acceptlist.
 void FilterTracker::AddL2capCid(uint16_t local_cid, uint16_t remote_cid) {
-  l2c_local_cid.insert(local_cid);
-  l2c_remote_cid.insert(remote_cid);
+  if (std::find(l2c_local_cid.begin(), l2c_local_cid.end(), local_cid) == l2c_local_cid.end()) {
+    l2c_local_cid.push_back(local_cid);
+  }
+  if (std::find(l2c_remote_cid.begin(), l2c_remote_cid.end(), remote_cid) == l2c_remote_cid.end()) {
+    l2c_remote_cid.push_back(remote_cid);
+  }
 }
 
 // Sets L2CAP channel that RFCOMM uses.
@@ -56,23 +61,27 @@ void FilterTracker::SetRfcommCid(uint16_t local_cid, uint16_t remote_cid) {
 // Remove L2CAP channel from acceptlist.
 void FilterTracker::RemoveL2capCid(uint16_t local_cid, uint16_t remote_cid) {
   if (rfcomm_local_cid == local_cid) {
-    rfcomm_channels.clear();
-    rfcomm_channels.insert(0);
+    rfcomm_channels.reset();
+    rfcomm_channels.set(0);
     rfcomm_local_cid = 0;
     rfcomm_remote_cid = 0;
   }
 
-  l2c_local_cid.erase(local_cid);
-  l2c_remote_cid.erase(remote_cid);
+  l2c_local_cid.erase(std::remove(l2c_local_cid.begin(), l2c_local_cid.end(), local_cid), l2c_local_cid.end());
+  l2c_remote_cid.erase(std::remove(l2c_remote_cid.begin(), l2c_remote_cid.end(), remote_cid), l2c_remote_cid.end());
 }
 
 void FilterTracker::AddRfcommDlci(uint8_t channel) {
-  rfcomm_channels.insert(channel);
+  if (channel >= rfcomm_channels.size()) {
+    LOG_WARN("Invalid RFCOMM DLCI %hhu", channel);
+    return;
+  }
+  rfcomm_channels.set(channel);
 }
 
 bool FilterTracker::IsAcceptlistedL2cap(bool local, uint16_t cid) {
-  const auto& set = local ? l2c_local_cid : l2c_remote_cid;
-  return (set.find(cid) != set.end());
+  const auto& cids = local ? l2c_local_cid : l2c_remote_cid;
+  return std::find(cids.begin(), cids.end(), cid) != cids.end();
 }
 
 bool FilterTracker::IsRfcommChannel(bool local, uint16_t cid) {
@@ -81,7 +90,7 @@ bool FilterTracker::IsRfcommChannel(bool local, uint16_t cid) {
 }
 
 bool FilterTracker::IsAcceptlistedDlci(uint8_t dlci) {
-  return rfcomm_channels.find(dlci) != rfcomm_channels.end();
+  return dlci < rfcomm_channels.size() && rfcomm_channels.test(dlci);
 }
 
 void ProfilesFilter::SetupProfilesFilter(bool pbap_filtered, bool map_filtered) {
@@ -239,6 +248,9 @@ namespace {
 // Epoch in microseconds since 01/01/0000.
 constexpr uint64_t kBtSnoopEpochDelta = 0x00dcddb30f2f8000ULL;
 
+// Records queued for the async writer thread, beyond which captured packets are dropped
+constexpr size_t kMaxPendingRecordsSize = 4 * 1024 * 1024;
+
 // Qualcomm debug logs handle
 constexpr uint16_t kQualcommDebugLogHandle = 0xedc;
 
@@ -300,6 +312,8 @@ constexpr size_t kDefaultBtSnoozMaxPayloadBytesPerPacket =
 using namespace std::chrono_literals;
 constexpr std::chrono::hours kBtSnoozLogLifeTime = 12h;
 constexpr std::chrono::hours kBtSnoozLogDeleteRepeatingAlarmInterval = 1h;
+// Packets are not kept in memory for longer than btsnooz log files are kept on disk
+constexpr std::chrono::milliseconds kBtSnoozMaxPacketAge = kBtSnoozLogLifeTime;
 
 std::mutex filter_tracker_list_mutex;
 std::unordered_map<uint16_t, FilterTracker> filter_tracker_list;
@@ -307,6 +321,8 @@ std::unordered_map<uint16_t, uint16_t> local_cid_to_acl;
 
 std::mutex a2dpMediaChannels_mutex;
 std::vector<SnoopLogger::A2dpMediaChannel> a2dpMediaChannels;
+// Lets the A2DP media packets go through without taking a2dpMediaChannels_mutex when there is no media channel
+std::atomic_bool a2dpMediaChannels_empty{true};
 
 std::mutex snoop_log_filters_mutex;
 
@@ -326,6 +342,10 @@ std::string get_btsnoop_log_path(std::string log_dir, bool filtered) {
   return log_dir;
 }
 
+std::string get_compressed_log_path(std::string log_file_path) {
+  return log_file_path.append(".gz");
+}
+
 std::string get_last_log_path(std::string log_file_path) {
   return log_file_path.append(".last");
 }
@@ -436,6 +456,10 @@ const std::string SnoopLogger::kIsDebuggableProperty = "ro.debuggable";
 const std::string SnoopLogger::kBtSnoopLogModeProperty = "persist.bluetooth.btsnooplogmode";
 const std::string SnoopLogger::kBtSnoopDefaultLogModeProperty = "persist.bluetooth.btsnoopdefaultmode";
 const std::string SnoopLogger::kBtSnoopLogPersists = "persist.bluetooth.btsnooplogpersists";
+// Writes btsnoop records from a dedicated thread instead of the thread capturing the packet
+const std::string SnoopLogger::kBtSnoopAsyncWriterProperty = "persist.bluetooth.btsnoop.async_writer";
+// Writes btsnoop logs as gzip files, with a ".gz" extension
+const std::string SnoopLogger::kBtSnoopCompressedProperty = "persist.bluetooth.btsnoop.compressed";
 // Truncates ACL packets (non-fragment) to fixed (MAX_HCI_ACL_LEN) number of bytes
 const std::string SnoopLogger::kBtSnoopLogFilterHeadersProperty =
     "persist.bluetooth.snooplogfilter.headers.enabled";
@@ -485,15 +509,20 @@ SnoopLogger::SnoopLogger(
     bool qualcomm_debug_log_enabled,
     const std::chrono::milliseconds snooz_log_life_time,
     const std::chrono::milliseconds snooz_log_delete_alarm_interval,
-    bool snoop_log_persists)
+    bool snoop_log_persists,
+    bool async_writer_enabled,
+    bool compressed)
     : snoop_log_path_(std::move(snoop_log_path)),
       snooz_log_path_(std::move(snooz_log_path)),
       max_packets_per_file_(max_packets_per_file),
-      btsnooz_buffer_(max_packets_per_buffer),
+      // Same memory as |max_packets_per_buffer| packets of the maximum size, shorter packets take less room
+      btsnooz_buffer_(max_packets_per_buffer * kDefaultBtSnoozMaxBytesPerPacket, kBtSnoozMaxPacketAge),
       qualcomm_debug_log_enabled_(qualcomm_debug_log_enabled),
       snooz_log_life_time_(snooz_log_life_time),
       snooz_log_delete_alarm_interval_(snooz_log_delete_alarm_interval),
-      snoop_log_persists(snoop_log_persists) {
+      snoop_log_persists(snoop_log_persists),
+      async_writer_enabled_(async_writer_enabled),
+      compressed_(compressed) {
   btsnoop_mode_ = btsnoop_mode;
 
   if (btsnoop_mode_ == kBtSnoopLogModeFiltered &&
@@ -521,17 +550,30 @@ SnoopLogger::SnoopLogger(
     // delete both filtered and unfiltered logs
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, true));
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, false));
+    delete_btsnoop_files(get_compressed_log_path(get_btsnoop_log_path(snoop_log_path_, true)));
+    delete_btsnoop_files(get_compressed_log_path(get_btsnoop_log_path(snoop_log_path_, false)));
   }
 
   snoop_logger_socket_thread_ = nullptr;
   socket_ = nullptr;
   // Add ".filtered" extension if necessary
   snoop_log_path_ = get_btsnoop_log_path(snoop_log_path_, btsnoop_mode_ == kBtSnoopLogModeFiltered);
+  // Add ".gz" extension if necessary, and delete the logs of the same mode written in the other format
+  if (btsnoop_mode_ != kBtSnoopLogModeDisabled && !snoop_log_persists) {
+    delete_btsnoop_files(compressed_ ? snoop_log_path_ : get_compressed_log_path(snoop_log_path_));
+  }
+  if (compressed_) {
+    snoop_log_path_ = get_compressed_log_path(snoop_log_path_);
+  }
 }
 
 void SnoopLogger::CloseCurrentSnoopLogFile() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (btsnoop_ostream_.is_open()) {
+    if (compressor_ != nullptr) {
+      compressor_->Finish();
+      compressor_.reset();
+    }
     btsnoop_ostream_.flush();
     btsnoop_ostream_.close();
   }
@@ -565,12 +607,13 @@ void SnoopLogger::OpenNextSnoopLogFile() {
     LOG_ALWAYS_FATAL("Unable to open snoop log at \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
   }
   umask(prevmask);
-  if (!btsnoop_ostream_.write(
-          reinterpret_cast<const char*>(&SnoopLoggerCommon::kBtSnoopFileHeader),
-          sizeof(SnoopLoggerCommon::FileHeaderType))) {
+  if (compressed_) {
+    compressor_ = std::make_unique<SnoopLogCompressor>(&btsnoop_ostream_);
+  }
+  if (!WriteToSnoopLogFile(&SnoopLoggerCommon::kBtSnoopFileHeader, sizeof(SnoopLoggerCommon::FileHeaderType))) {
     LOG_ALWAYS_FATAL("Unable to write file header to \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
   }
-  if (!btsnoop_ostream_.flush()) {
+  if (!FlushSnoopLogFile()) {
     LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
   }
 }
@@ -596,6 +639,7 @@ void SnoopLogger::EnableFilters() {
     }
     LOG_INFO("%s: %s", itr->first.c_str(), itr->second.c_str());
   }
+  UpdateEnabledFilters();
 }
 
 void SnoopLogger::DisableFilters() {
@@ -608,6 +652,16 @@ void SnoopLogger::DisableFilters() {
     itr->second = SnoopLogger::kBtSnoopLogFilterProfileModeDisabled;
     LOG_INFO("%s, %s", itr->first.c_str(), itr->second.c_str());
   }
+  UpdateEnabledFilters();
+}
+
+void SnoopLogger::UpdateEnabledFilters() {
+  is_a2dp_filter_enabled_ = kBtSnoopLogFilterState[kBtSnoopLogFilterProfileA2dpProperty];
+  is_headers_filter_enabled_ = kBtSnoopLogFilterState[kBtSnoopLogFilterHeadersProperty];
+  is_rfcomm_filter_enabled_ = kBtSnoopLogFilterState[kBtSnoopLogFilterProfileRfcommProperty];
+  is_profiles_filter_enabled_ =
+      kBtSnoopLogFilterMode[kBtSnoopLogFilterProfilePbapModeProperty] != kBtSnoopLogFilterProfileModeDisabled ||
+      kBtSnoopLogFilterMode[kBtSnoopLogFilterProfileMapModeProperty] != kBtSnoopLogFilterProfileModeDisabled;
 }
 
 bool SnoopLogger::IsFilterEnabled(std::string filter_name) {
@@ -942,8 +996,7 @@ void SnoopLogger::ClearL2capAcceptlist(
 }
 
 bool SnoopLogger::IsA2dpMediaChannel(uint16_t conn_handle, uint16_t cid, bool is_local_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !is_a2dp_filter_enabled_ || a2dpMediaChannels_empty) {
     return false;
   }
 
@@ -989,6 +1042,7 @@ void SnoopLogger::AddA2dpMediaChannel(
         remote_cid);
     std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
     a2dpMediaChannels.push_back({conn_handle, local_cid, remote_cid});
+    a2dpMediaChannels_empty = false;
   }
 }
 
@@ -1007,6 +1061,7 @@ void SnoopLogger::RemoveA2dpMediaChannel(uint16_t conn_handle, uint16_t local_ci
             return (el.conn_handle == conn_handle && el.local_cid == local_cid);
           }),
       a2dpMediaChannels.end());
+  a2dpMediaChannels_empty = a2dpMediaChannels.empty();
 }
 
 void SnoopLogger::SetRfcommPortOpen(
@@ -1158,19 +1213,18 @@ void SnoopLogger::FilterCapturedPacket(
     return;
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
+  if (is_a2dp_filter_enabled_) {
     if (IsA2dpMediaPacket(direction == Direction::INCOMING, (uint8_t*)packet.data())) {
       length = 0;
       return;
     }
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterHeadersProperty)) {
+  if (is_headers_filter_enabled_) {
     CalculateAclPacketLength(length, (uint8_t*)packet.data(), direction == Direction::INCOMING);
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) ||
-      IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty)) {
+  if (is_profiles_filter_enabled_) {
     // If HeadersFiltered applied, do not use ProfilesFiltered
     if (length == ntohl(header.length_original)) {
       if (packet.size() + EXTRA_BUF_SIZE > DEFAULT_PACKET_SIZE) {
@@ -1184,7 +1238,7 @@ void SnoopLogger::FilterCapturedPacket(
     }
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
+  if (is_rfcomm_filter_enabled_) {
     bool shouldFilter =
         SnoopLogger::ShouldFilterLog(direction == Direction::INCOMING, (uint8_t*)packet.data());
     if (shouldFilter) {
@@ -1221,20 +1275,49 @@ void SnoopLogger::Capture(HciPacket& packet, Direction direction, PacketType typ
                              .dropped_packets = 0,
                              .timestamp = htonll(timestamp_us + kBtSnoopEpochDelta),
                              .type = static_cast<uint8_t>(type)};
+  if (async_writer_enabled_) {
+    std::lock_guard<std::mutex> pending_lock(pending_records_mutex_);
+    if (writer_handler_ != nullptr) {
+      FilterCapturedPacket(packet, direction, type, length, header);
+
+      if (length == 0) {
+        return;
+      } else if (length != ntohl(header.length_original)) {
+        header.length_captured = htonl(length);
+      }
+
+      size_t record_size = sizeof(PacketHeaderType) + length - 1;
+      if (pending_records_size_ + record_size > kMaxPendingRecordsSize) {
+        // The writer thread is not keeping up, record the drop in the next packet written instead of blocking
+        dropped_records_++;
+        return;
+      }
+      header.dropped_packets = htonl(static_cast<uint32_t>(dropped_records_));
+      std::string record;
+      record.reserve(record_size);
+      record.append(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType));
+      record.append(reinterpret_cast<const char*>(packet.data()), length - 1);
+      pending_records_size_ += record_size;
+      pending_records_.push_back(std::move(record));
+      // Records queued while the writer is busy are written with the same batch
+      if (pending_records_.size() == 1) {
+        writer_handler_->Post(common::BindOnce(&SnoopLogger::WritePendingRecords, common::Unretained(this)));
+      }
+      return;
+    }
+  }
+
   {
     std::lock_guard<std::recursive_mutex> lock(file_mutex_);
     if (btsnoop_mode_ == kBtSnoopLogModeDisabled) {
       // btsnoop disabled, log in-memory btsnooz log only
-      std::stringstream ss;
       size_t included_length = get_btsnooz_packet_length_to_write(packet, type, qualcomm_debug_log_enabled_);
       header.length_captured = htonl(included_length + /* type byte */ PACKET_TYPE_LENGTH);
-      if (!ss.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-        LOG_ERROR("Failed to write packet header for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      if (!ss.write(reinterpret_cast<const char*>(packet.data()), included_length)) {
-        LOG_ERROR("Failed to write packet payload for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      btsnooz_buffer_.Push(ss.str());
+      // Records are at most kDefaultBtSnoozMaxBytesPerPacket long, build them on the stack
+      char record[kDefaultBtSnoozMaxBytesPerPacket];
+      std::memcpy(record, &header, sizeof(PacketHeaderType));
+      std::memcpy(record + sizeof(PacketHeaderType), packet.data(), included_length);
+      btsnooz_buffer_.Push(std::string_view(record, sizeof(PacketHeaderType) + included_length));
       return;
     }
 
@@ -1250,10 +1333,10 @@ void SnoopLogger::Capture(HciPacket& packet, Direction direction, PacketType typ
     if (packet_counter_ > max_packets_per_file_) {
       OpenNextSnoopLogFile();
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
+    if (!WriteToSnoopLogFile(&header, sizeof(PacketHeaderType))) {
       LOG_ERROR("Failed to write packet header for btsnoop, error: \"%s\"", strerror(errno));
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(packet.data()), length - 1)) {
+    if (!WriteToSnoopLogFile(packet.data(), length - 1)) {
       LOG_ERROR("Failed to write packet payload for btsnoop, error: \"%s\"", strerror(errno));
     }
 
@@ -1266,12 +1349,56 @@ void SnoopLogger::Capture(HciPacket& packet, Direction direction, PacketType typ
     // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
     // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
     //       as write() syscall dumps data into kernel memory directly
-    if (!btsnoop_ostream_.flush()) {
+    if (!FlushSnoopLogFile()) {
       LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
     }
   }
 }
 
+void SnoopLogger::WritePendingRecords() {
+  std::vector<std::string> records;
+  {
+    std::lock_guard<std::mutex> pending_lock(pending_records_mutex_);
+    records.swap(pending_records_);
+    pending_records_size_ = 0;
+  }
+  if (records.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(file_mutex_);
+  for (const auto& record : records) {
+    packet_counter_++;
+    if (packet_counter_ > max_packets_per_file_) {
+      OpenNextSnoopLogFile();
+    }
+    if (!WriteToSnoopLogFile(record.data(), record.size())) {
+      LOG_ERROR("Failed to write packet for btsnoop, error: \"%s\"", strerror(errno));
+    }
+    if (socket_ != nullptr) {
+      socket_->Write(record.data(), record.size());
+    }
+  }
+  // One flush for the whole batch, see Capture()
+  if (!FlushSnoopLogFile()) {
+    LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+  }
+}
+
+bool SnoopLogger::WriteToSnoopLogFile(const void* data, size_t size) {
+  if (compressor_ != nullptr) {
+    return compressor_->Write(data, size);
+  }
+  return static_cast<bool>(btsnoop_ostream_.write(reinterpret_cast<const char*>(data), size));
+}
+
+bool SnoopLogger::FlushSnoopLogFile() {
+  if (compressor_ != nullptr) {
+    return compressor_->Flush();
+  }
+  return static_cast<bool>(btsnoop_ostream_.flush());
+}
+
 void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (btsnoop_mode_ != kBtSnoopLogModeDisabled) {
@@ -1341,12 +1468,36 @@ void SnoopLogger::Start() {
       }
     }
   }
-  alarm_ = std::make_unique<os::RepeatingAlarm>(GetHandler());
+  if (async_writer_enabled_ && btsnoop_mode_ != kBtSnoopLogModeDisabled) {
+    std::lock_guard<std::mutex> pending_lock(pending_records_mutex_);
+    writer_thread_ = std::make_unique<os::Thread>("bt_snoop_writer", os::Thread::Priority::NORMAL);
+    writer_handler_ = std::make_unique<os::Handler>(writer_thread_.get());
+    dropped_records_ = 0;
+  }
+  alarm_ = std::make_unique<os::RepeatingAlarm>(GetHandler(), /* wake_up */ false);
   alarm_->Schedule(
       common::Bind(&delete_old_btsnooz_files, snooz_log_path_, snooz_log_life_time_), snooz_log_delete_alarm_interval_);
 }
 
 void SnoopLogger::Stop() {
+  if (writer_handler_ != nullptr) {
+    std::unique_ptr<os::Handler> writer_handler;
+    {
+      // Packets captured from now on are written by Capture() directly
+      std::lock_guard<std::mutex> pending_lock(pending_records_mutex_);
+      writer_handler = std::move(writer_handler_);
+    }
+    writer_handler->Clear();
+    writer_handler->WaitUntilStopped(std::chrono::milliseconds(2000));
+    writer_handler.reset();
+    writer_thread_.reset();
+    // Write what was still queued
+    WritePendingRecords();
+    if (dropped_records_ > 0) {
+      LOG_WARN("Dropped %zu btsnoop packets, the writer thread was not keeping up", dropped_records_);
+    }
+  }
+
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   LOG_DEBUG("Closing btsnoop log data at %s", snoop_log_path_.c_str());
   CloseCurrentSnoopLogFile();
@@ -1447,6 +1598,14 @@ bool SnoopLogger::IsBtSnoopLogPersisted() {
   return is_debuggable && os::GetSystemPropertyBool(kBtSnoopLogPersists, false);
 }
 
+bool SnoopLogger::IsBtSnoopAsyncWriterEnabled() {
+  return os::GetSystemPropertyBool(kBtSnoopAsyncWriterProperty, false);
+}
+
+bool SnoopLogger::IsBtSnoopLogCompressed() {
+  return os::GetSystemPropertyBool(kBtSnoopCompressedProperty, false);
+}
+
 bool SnoopLogger::IsQualcommDebugLogEnabled() {
   // Check system prop if the soc manufacturer is Qualcomm
   bool qualcomm_debug_log_enabled = false;
@@ -1468,7 +1627,9 @@ const ModuleFactory SnoopLogger::Factory = ModuleFactory([]() {
       IsQualcommDebugLogEnabled(),
       kBtSnoozLogLifeTime,
       kBtSnoozLogDeleteRepeatingAlarmInterval,
-      IsBtSnoopLogPersisted());
+      IsBtSnoopLogPersisted(),
+      IsBtSnoopAsyncWriterEnabled(),
+      IsBtSnoopLogCompressed());
 });
 
 }  // namespace hal
@@ -16,19 +16,24 @@
 
 #pragma once
 
+#include <atomic>
+#include <bitset>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
-#include "common/circular_buffer.h"
+#include "common/record_ring_buffer.h"
 #include "hal/hci_hal.h"
+#include "hal/snoop_log_compressor.h"
 #include "hal/snoop_logger_socket_thread.h"
 #include "hal/syscall_wrapper_impl.h"
 #include "module.h"
+#include "os/handler.h"
 #include "os/repeating_alarm.h"
+#include "os/thread.h"
 
 namespace bluetooth {
 namespace hal {
@@ -37,14 +42,17 @@ namespace hal {
 static uint64_t file_creation_time;
 #endif
 
+// Checked for every ACL packet in filtered mode. A link only has a handful of channels, so they are kept in small
+// flat arrays, and the 64 RFCOMM DLCIs in a bitmap.
 class FilterTracker {
  public:
   // NOTE: 1 is used as a static CID for L2CAP signaling
-  std::unordered_set<uint16_t> l2c_local_cid = {1};
-  std::unordered_set<uint16_t> l2c_remote_cid = {1};
+  std::vector<uint16_t> l2c_local_cid = {1};
+  std::vector<uint16_t> l2c_remote_cid = {1};
   uint16_t rfcomm_local_cid = 0;
   uint16_t rfcomm_remote_cid = 0;
-  std::unordered_set<uint16_t> rfcomm_channels = {0};
+  // DLCI 0 is the RFCOMM control channel
+  std::bitset<64> rfcomm_channels = 1;
 
   // Adds L2C channel to acceptlist.
   void AddL2capCid(uint16_t local_cid, uint16_t remote_cid);
@@ -145,6 +153,8 @@ class SnoopLogger : public ::bluetooth::Module {
   static const std::string kIsDebuggableProperty;
   static const std::string kBtSnoopLogModeProperty;
   static const std::string kBtSnoopLogPersists;
+  static const std::string kBtSnoopAsyncWriterProperty;
+  static const std::string kBtSnoopCompressedProperty;
   static const std::string kBtSnoopDefaultLogModeProperty;
   static const std::string kBtSnoopLogFilterHeadersProperty;
   static const std::string kBtSnoopLogFilterProfileA2dpProperty;
@@ -207,6 +217,14 @@ class SnoopLogger : public ::bluetooth::Module {
   // Returns whether snoop log persists even after restarting Bluetooth
   static bool IsBtSnoopLogPersisted();
 
+  // Returns whether packets are written to the snoop log from a dedicated thread
+  // Changes to this value is only effective after restarting Bluetooth
+  static bool IsBtSnoopAsyncWriterEnabled();
+
+  // Returns whether the snoop log is written as a gzip file
+  // Changes to this value is only effective after restarting Bluetooth
+  static bool IsBtSnoopLogCompressed();
+
   // Has to be defined from 1 to 4 per btsnoop format
   enum PacketType {
     CMD = 1,
@@ -288,7 +306,9 @@ class SnoopLogger : public ::bluetooth::Module {
       bool qualcomm_debug_log_enabled,
       const std::chrono::milliseconds snooz_log_life_time,
       const std::chrono::milliseconds snooz_log_delete_alarm_interval,
-      bool snoop_log_persists);
+      bool snoop_log_persists,
+      bool async_writer_enabled,
+      bool compressed);
   void CloseCurrentSnoopLogFile();
   void OpenNextSnoopLogFile();
   void DumpSnoozLogToFile(const std::vector<std::string>& data) const;
@@ -296,6 +316,9 @@ class SnoopLogger : public ::bluetooth::Module {
   void EnableFilters();
   // Disable all filters
   void DisableFilters();
+  // Update the filters checked for each packet from kBtSnoopLogFilterState and kBtSnoopLogFilterMode, must be called
+  // with snoop_log_filters_mutex held
+  void UpdateEnabledFilters();
   // Check if the filter is enabled. Pass filter name as a string.
   bool IsFilterEnabled(std::string filter_name);
   // Check if packet should be filtered (rfcommchannelfiltered mode)
@@ -330,6 +353,11 @@ class SnoopLogger : public ::bluetooth::Module {
       PacketType type,
       uint32_t& length,
       PacketHeaderType header);
+  // Write the records captured since the last call, with a single flush (async writer)
+  void WritePendingRecords();
+  // Write to the current snoop log file, through the compressor if enabled
+  bool WriteToSnoopLogFile(const void* data, size_t size);
+  bool FlushSnoopLogFile();
 
   std::unique_ptr<SnoopLoggerSocketThread> snoop_logger_socket_thread_;
 
@@ -339,7 +367,7 @@ class SnoopLogger : public ::bluetooth::Module {
   std::string snooz_log_path_;
   std::ofstream btsnoop_ostream_;
   size_t max_packets_per_file_;
-  common::CircularBuffer<std::string> btsnooz_buffer_;
+  common::RecordRingBuffer btsnooz_buffer_;
   bool qualcomm_debug_log_enabled_ = false;
   size_t packet_counter_ = 0;
   mutable std::recursive_mutex file_mutex_;
@@ -349,6 +377,22 @@ class SnoopLogger : public ::bluetooth::Module {
   SnoopLoggerSocketInterface* socket_;
   SyscallWrapperImpl syscall_if;
   bool snoop_log_persists = false;
+  // With the async writer, Capture() only queues the records, and the writer thread writes them in batches
+  bool async_writer_enabled_ = false;
+  std::unique_ptr<os::Thread> writer_thread_;
+  std::unique_ptr<os::Handler> writer_handler_;
+  // Guards the records queued for the writer thread. Never held while writing to the file.
+  std::mutex pending_records_mutex_;
+  std::vector<std::string> pending_records_;
+  size_t pending_records_size_ = 0;
+  size_t dropped_records_ = 0;
+  bool compressed_ = false;
+  std::unique_ptr<SnoopLogCompressor> compressor_;
+  // Same as IsFilterEnabled(), without looking up the filters by name for each packet
+  std::atomic_bool is_a2dp_filter_enabled_{false};
+  std::atomic_bool is_headers_filter_enabled_{false};
+  std::atomic_bool is_profiles_filter_enabled_{false};
+  std::atomic_bool is_rfcomm_filter_enabled_{false};
 };
 
 }  // namespace hal
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/packet_corpus.h"
+#include "hal/snoop_logger.h"
+#include "module.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+using namespace std::chrono_literals;
+
+class BenchmarkSnoopLogger : public SnoopLogger {
+ public:
+  BenchmarkSnoopLogger(
+      std::string snoop_log_path,
+      std::string snooz_log_path,
+      const std::string& btsnoop_mode,
+      bool async_writer_enabled)
+      : SnoopLogger(
+            std::move(snoop_log_path),
+            std::move(snooz_log_path),
+            SnoopLogger::GetMaxPacketsPerFile(),
+            SnoopLogger::GetMaxPacketsPerBuffer(),
+            btsnoop_mode,
+            false,
+            20ms,
+            5ms,
+            false,
+            async_writer_enabled,
+            false) {}
+
+  std::string ToString() const override {
+    return std::string("BenchmarkSnoopLogger");
+  }
+};
+
+struct CapturedPacket {
+  HciPacket data;
+  SnoopLogger::Direction direction;
+  SnoopLogger::PacketType type;
+};
+
+// Captures the packets of the corpus, in the order of a connected device streaming audio and sending HID reports.
+// range(0) is the snoop log mode, 0 for disabled, 1 for filtered and 2 for full, and range(1) enables the writer
+// thread.
+class BM_SnoopLoggerCapture : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    const std::string* modes[] = {
+        &SnoopLogger::kBtSnoopLogModeDisabled,
+        &SnoopLogger::kBtSnoopLogModeFiltered,
+        &SnoopLogger::kBtSnoopLogModeFull,
+    };
+    auto directory = std::filesystem::temp_directory_path();
+    snoop_log_ = directory / "btsnoop_benchmark_hci.log";
+    snooz_log_ = directory / "btsnooz_benchmark_hci.log";
+    registry_ = new TestModuleRegistry();
+    registry_->InjectTestModule(
+        &SnoopLogger::Factory,
+        new BenchmarkSnoopLogger(snoop_log_.string(), snooz_log_.string(), *modes[st.range(0)], st.range(1) != 0));
+    snoop_logger_ = registry_->GetModuleUnderTest<SnoopLogger>();
+
+    using benchmark::corpus::kAclA2dpMedia;
+    using benchmark::corpus::kAclAttWriteCommand;
+    using benchmark::corpus::kLeAdvertisingReport;
+    using benchmark::corpus::kLeSetScanEnable;
+    using benchmark::corpus::kNumberOfCompletedPackets;
+    packets_ = {
+        {kAclA2dpMedia, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL},
+        {kAclA2dpMedia, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL},
+        {kNumberOfCompletedPackets, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT},
+        {kAclAttWriteCommand, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL},
+        {kLeAdvertisingReport, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT},
+        {kLeSetScanEnable, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD},
+    };
+  }
+
+  void TearDown(State& st) override {
+    registry_->StopAll();
+    delete registry_;
+    std::filesystem::remove(snoop_log_);
+    std::filesystem::remove(snoop_log_.string() + ".last");
+    std::filesystem::remove(snooz_log_);
+    std::filesystem::remove(snooz_log_.string() + ".last");
+    packets_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  TestModuleRegistry* registry_;
+  SnoopLogger* snoop_logger_;
+  std::filesystem::path snoop_log_;
+  std::filesystem::path snooz_log_;
+  std::vector<CapturedPacket> packets_;
+};
+
+BENCHMARK_DEFINE_F(BM_SnoopLoggerCapture, capture)(State& state) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    for (const auto& packet : packets_) {
+      // Capture() may rewrite the packet it logs, as the HAL hands it over
+      HciPacket data = packet.data;
+      snoop_logger_->Capture(data, packet.direction, packet.type);
+      bytes += packet.data.size();
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * packets_.size());
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK_REGISTER_F(BM_SnoopLoggerCapture, capture)->ArgsProduct({{0, 1, 2}, {0, 1}});
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
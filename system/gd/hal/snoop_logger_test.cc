@@ -20,9 +20,12 @@
 #include <gtest/gtest.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <zlib.h>
 
+#include <cstring>
 #include <future>
 #include <unordered_map>
+#include <vector>
 
 #include "common/init_flags.h"
 #include "hal/snoop_logger_common.h"
@@ -129,7 +132,9 @@ class TestSnoopLoggerModule : public SnoopLogger {
       size_t max_packets_per_file,
       const std::string& btsnoop_mode,
       bool qualcomm_debug_log_enabled,
-      bool snoop_log_persists)
+      bool snoop_log_persists,
+      bool async_writer_enabled = false,
+      bool compressed = false)
       : SnoopLogger(
             std::move(snoop_log_path),
             std::move(snooz_log_path),
@@ -139,7 +144,9 @@ class TestSnoopLoggerModule : public SnoopLogger {
             qualcomm_debug_log_enabled,
             20ms,
             5ms,
-            snoop_log_persists) {}
+            snoop_log_persists,
+            async_writer_enabled,
+            compressed) {}
 
   std::string ToString() const override {
     return std::string("TestSnoopLoggerModule");
@@ -553,6 +560,76 @@ TEST_F(SnoopLoggerModuleTest, rotate_file_after_full_test) {
           (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 10);
 }
 
+TEST_F(SnoopLoggerModuleTest, async_writer_rotate_file_after_full_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false,
+      true);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  for (int i = 0; i < 11; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+
+  // Stopping the module writes the packets still queued for the writer thread
+  test_registry->StopAll();
+
+  // Verify states after test
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_last_));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 1);
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_last_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 10);
+}
+
+TEST_F(SnoopLoggerModuleTest, compressed_snoop_log_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false,
+      false,
+      true);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  for (int i = 0; i < 5; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+
+  test_registry->StopAll();
+
+  // Verify states after test
+  auto compressed_snoop_log = temp_snoop_log_.string() + ".gz";
+  ASSERT_FALSE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(compressed_snoop_log));
+  gzFile file = gzopen(compressed_snoop_log.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  std::vector<char> content(64 * 1024);
+  int size = gzread(file, content.data(), content.size());
+  gzclose(file);
+  ASSERT_EQ(
+      static_cast<size_t>(size),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 5);
+  ASSERT_EQ(
+      std::memcmp(
+          content.data(), &SnoopLoggerCommon::kBtSnoopFileHeader, sizeof(SnoopLoggerCommon::FileHeaderType)),
+      0);
+}
+
 TEST_F(SnoopLoggerModuleTest, qualcomm_debug_log_test) {
   auto* snoop_logger = new TestSnoopLoggerModule(
       temp_snoop_log_.string(),
@@ -660,6 +737,30 @@ TEST_F(SnoopLoggerModuleTest, filter_tracker_test) {
   ASSERT_FALSE(filter_list[handle].IsAcceptlistedDlci(dlci));
 }
 
+TEST_F(SnoopLoggerModuleTest, filter_tracker_duplicate_and_invalid_channels_test) {
+  bluetooth::hal::FilterTracker filter;
+  uint16_t local_cid = 0x40;
+  uint16_t remote_cid = 0x41;
+
+  // The signaling channel and the RFCOMM control channel are always acceptlisted
+  ASSERT_TRUE(filter.IsAcceptlistedL2cap(true, 1));
+  ASSERT_TRUE(filter.IsAcceptlistedL2cap(false, 1));
+  ASSERT_TRUE(filter.IsAcceptlistedDlci(0));
+
+  filter.AddL2capCid(local_cid, remote_cid);
+  filter.AddL2capCid(local_cid, remote_cid);
+  filter.RemoveL2capCid(local_cid, remote_cid);
+  ASSERT_FALSE(filter.IsAcceptlistedL2cap(true, local_cid));
+  ASSERT_FALSE(filter.IsAcceptlistedL2cap(false, remote_cid));
+  ASSERT_TRUE(filter.IsAcceptlistedL2cap(true, 1));
+
+  filter.AddRfcommDlci(63);
+  ASSERT_TRUE(filter.IsAcceptlistedDlci(63));
+  filter.AddRfcommDlci(64);
+  ASSERT_FALSE(filter.IsAcceptlistedDlci(64));
+  ASSERT_FALSE(filter.IsAcceptlistedDlci(0xff));
+}
+
 TEST_F(SnoopLoggerModuleTest, a2dp_packets_filtered_test) {
   // Actual test
   uint16_t conn_handle = 0x000b;
@@ -22,6 +22,8 @@
 #include <set>
 
 #include "common/bidi_queue.h"
+#include "common/packet_latency_trace.h"
+#include "common/traffic_telemetry.h"
 #include "hci/acl_manager/acl_scheduler.h"
 #include "hci/acl_manager/classic_impl.h"
 #include "hci/acl_manager/connection_management_callbacks.h"
@@ -40,6 +42,8 @@ namespace bluetooth {
 namespace hci {
 
 constexpr uint16_t kQualcommDebugHandle = 0xedc;
+// Parameters of the last LE link to the device, see acl_manager::LeReconnectParameters
+constexpr char kLeReconnectParametersProperty[] = "LeReconnectParams";
 
 using acl_manager::AclConnection;
 using common::Bind;
@@ -53,6 +57,7 @@ using acl_manager::le_impl;
 using acl_manager::LeAcceptlistCallbacks;
 using acl_manager::LeAclConnection;
 using acl_manager::LeConnectionCallbacks;
+using acl_manager::LeReconnectParameters;
 
 using acl_manager::RoundRobinScheduler;
 
@@ -65,7 +70,6 @@ struct AclManager::impl {
     hci_layer_ = acl_manager_.GetDependency<HciLayer>();
     handler_ = acl_manager_.GetHandler();
     controller_ = acl_manager_.GetDependency<Controller>();
-    round_robin_scheduler_ = new RoundRobinScheduler(handler_, controller_, hci_layer_->GetAclQueueEnd());
     acl_scheduler_ = acl_manager_.GetDependency<AclScheduler>();
 
     if (bluetooth::common::init_flags::gd_remote_name_request_is_enabled()) {
@@ -75,6 +79,7 @@ struct AclManager::impl {
     bool crash_on_unknown_handle = false;
     {
       const std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+      round_robin_scheduler_ = new RoundRobinScheduler(handler_, controller_, hci_layer_->GetAclQueueEnd());
       classic_impl_ = new classic_impl(
           hci_layer_,
           controller_,
@@ -85,12 +90,42 @@ struct AclManager::impl {
           remote_name_request_module_);
       le_impl_ = new le_impl(hci_layer_, controller_, handler_, round_robin_scheduler_, crash_on_unknown_handle);
     }
+    load_le_reconnect_parameters();
 
     hci_queue_end_ = hci_layer_->GetAclQueueEnd();
     hci_queue_end_->RegisterDequeue(
         handler_, common::Bind(&impl::dequeue_and_route_acl_packet_to_connection, common::Unretained(this)));
   }
 
+  // LE links to known devices start with the parameters of their last link
+  void load_le_reconnect_parameters() {
+    auto storage = acl_manager_.GetDependency<storage::StorageModule>();
+    for (const auto& section : storage->GetPersistentSections()) {
+      auto address = Address::FromString(section);
+      auto value = storage->GetProperty(section, kLeReconnectParametersProperty);
+      if (!address.has_value() || !value.has_value()) {
+        continue;
+      }
+      auto parameters = LeReconnectParameters::FromString(*value);
+      if (parameters.has_value()) {
+        handler_->CallOn(le_impl_, &le_impl::load_reconnect_parameters, *address, *parameters);
+      }
+    }
+    handler_->CallOn(
+        le_impl_,
+        &le_impl::set_reconnect_parameters_changed_callback,
+        common::Bind(&impl::store_le_reconnect_parameters, common::Unretained(this)));
+  }
+
+  void store_le_reconnect_parameters(Address address, LeReconnectParameters parameters) {
+    auto storage = acl_manager_.GetDependency<storage::StorageModule>();
+    // Only devices the storage already knows about
+    if (!storage->HasSection(address.ToString())) {
+      return;
+    }
+    storage->SetProperty(address.ToString(), kLeReconnectParametersProperty, parameters.ToString());
+  }
+
   void Stop() {
     hci_queue_end_->UnregisterDequeue();
     if (enqueue_registered_.exchange(false)) {
@@ -108,7 +143,11 @@ struct AclManager::impl {
     unknown_acl_alarm_.reset();
     waiting_packets_.clear();
 
-    delete round_robin_scheduler_;
+    {
+      const std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+      delete round_robin_scheduler_;
+      round_robin_scheduler_ = nullptr;
+    }
     hci_queue_end_ = nullptr;
     handler_ = nullptr;
     hci_layer_ = nullptr;
@@ -153,8 +192,15 @@ struct AclManager::impl {
       retry_unknown_acl(/* timed_out = */ false);
     }
 
-    auto packet = hci_queue_end_->TryDequeue();
-    ASSERT(packet != nullptr);
+    auto packets = hci_queue_end_->TryDequeueBatch(kMaxAclPacketsPerDequeue);
+    ASSERT(!packets.empty());
+    for (auto& packet : packets) {
+      route_acl_packet_to_connection(std::move(packet));
+    }
+  }
+
+  void route_acl_packet_to_connection(std::unique_ptr<AclView> packet) {
+    common::PacketLatencyTrace::Record(packet->GetLatencySample(), common::PacketLatencyStage::HCI_LAYER);
     if (!packet->IsValid()) {
       LOG_INFO("Dropping invalid packet of size %zu", packet->size());
       return;
@@ -181,6 +227,11 @@ struct AclManager::impl {
 
   void Dump(
       std::promise<flatbuffers::Offset<AclManagerData>> promise, flatbuffers::FlatBufferBuilder* fb_builder) const;
+  flatbuffers::Offset<AclSchedulerData> DumpAclScheduler(flatbuffers::FlatBufferBuilder* fb_builder) const;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<LeLinkParametersData>>> DumpLeLinkParameters(
+      flatbuffers::FlatBufferBuilder* fb_builder) const;
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<TrafficTelemetryData>>> DumpTrafficTelemetry(
+      flatbuffers::FlatBufferBuilder* fb_builder) const;
 
   const AclManager& acl_manager_;
 
@@ -199,6 +250,8 @@ struct AclManager::impl {
   std::unique_ptr<os::Alarm> unknown_acl_alarm_;
   std::vector<AclView> waiting_packets_;
   static constexpr std::chrono::seconds kWaitBeforeDroppingUnknownAcl{1};
+  // Upper bound on incoming packets routed per queue wakeup, so one busy link can't monopolize the handler
+  static constexpr size_t kMaxAclPacketsPerDequeue = 16;
 };
 
 AclManager::AclManager() : pimpl_(std::make_unique<impl>(*this)) {}
@@ -401,6 +454,22 @@ void AclManager::SetSystemSuspendState(bool suspended) {
   CallOn(pimpl_->le_impl_, &le_impl::set_system_suspend_state, suspended);
 }
 
+void AclManager::SetLeAclTxCreditReservation(uint16_t handle, uint16_t credits) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkCreditReservation, handle, credits);
+}
+
+void AclManager::RequestLeLinkProfile(uint16_t handle, std::string client, acl_manager::LinkProfile profile) {
+  CallOn(pimpl_->le_impl_, &le_impl::request_link_profile, handle, std::move(client), profile);
+}
+
+void AclManager::ReleaseLeLinkProfile(uint16_t handle, std::string client) {
+  CallOn(pimpl_->le_impl_, &le_impl::release_link_profile, handle, std::move(client));
+}
+
+void AclManager::SetLeLinkAutoUpgradeAllowed(uint16_t handle, bool allowed) {
+  CallOn(pimpl_->le_impl_, &le_impl::set_link_auto_upgrade_allowed, handle, allowed);
+}
+
 LeAddressManager* AclManager::GetLeAddressManager() {
   return pimpl_->le_impl_->le_address_manager_;
 }
@@ -467,17 +536,146 @@ void AclManager::impl::Dump(
   }
   auto vecofstrings = fb_builder->CreateVector(strings, connect_list.size());
 
+  flatbuffers::Offset<AclSchedulerData> acl_scheduler_data;
+  if (round_robin_scheduler_ != nullptr) {
+    acl_scheduler_data = DumpAclScheduler(fb_builder);
+  }
+
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<LeLinkParametersData>>> le_link_parameters;
+  if (le_impl_ != nullptr) {
+    le_link_parameters = DumpLeLinkParameters(fb_builder);
+  }
+
+  auto traffic_telemetry = DumpTrafficTelemetry(fb_builder);
+
   AclManagerDataBuilder builder(*fb_builder);
   builder.add_title(title);
   builder.add_le_filter_accept_list_count(connect_list.size());
   builder.add_le_filter_accept_list(vecofstrings);
   builder.add_le_connectability_state(le_connectability_state);
   builder.add_le_create_connection_timeout_alarms_count(le_create_connection_timeout_alarms_count);
+  if (!acl_scheduler_data.IsNull()) {
+    builder.add_acl_scheduler(acl_scheduler_data);
+  }
+  if (!le_link_parameters.IsNull()) {
+    builder.add_le_link_parameters(le_link_parameters);
+  }
+  builder.add_traffic_telemetry(traffic_telemetry);
 
   flatbuffers::Offset<AclManagerData> dumpsys_data = builder.Finish();
   promise.set_value(dumpsys_data);
 }
 
+flatbuffers::Offset<AclSchedulerData> AclManager::impl::DumpAclScheduler(
+    flatbuffers::FlatBufferBuilder* fb_builder) const {
+  auto policy = fb_builder->CreateString(round_robin_scheduler_->GetPolicyName());
+
+  std::vector<flatbuffers::Offset<AclSchedulerLinkData>> links;
+  for (const auto& stats : round_robin_scheduler_->GetLinkStats()) {
+    bool is_classic = stats.connection_type == RoundRobinScheduler::ConnectionType::CLASSIC;
+    auto connection_type = fb_builder->CreateString(is_classic ? "CLASSIC" : "LE");
+    AclSchedulerLinkDataBuilder link_builder(*fb_builder);
+    link_builder.add_handle(stats.handle);
+    link_builder.add_connection_type(connection_type);
+    link_builder.add_weight(stats.weight);
+    link_builder.add_high_priority(stats.high_priority);
+    link_builder.add_reserved_credits(stats.reserved_credits);
+    link_builder.add_outstanding_credits(stats.outstanding_credits);
+    link_builder.add_deficit(stats.deficit);
+    link_builder.add_sent_packets(stats.sent_packets);
+    link_builder.add_sent_fragments(stats.sent_fragments);
+    link_builder.add_sent_bytes(stats.sent_bytes);
+    links.push_back(link_builder.Finish());
+  }
+  auto links_vector = fb_builder->CreateVector(links);
+
+  auto now = std::chrono::steady_clock::now();
+  std::vector<flatbuffers::Offset<AclCreditSampleData>> credit_history;
+  for (const auto& sample : round_robin_scheduler_->GetCreditHistory()) {
+    AclCreditSampleDataBuilder sample_builder(*fb_builder);
+    sample_builder.add_age_ms(std::chrono::duration_cast<std::chrono::milliseconds>(now - sample.timestamp).count());
+    sample_builder.add_acl_in_use(sample.acl_in_use);
+    sample_builder.add_le_acl_in_use(sample.le_acl_in_use);
+    sample_builder.add_acl_completed(sample.acl_completed);
+    sample_builder.add_le_acl_completed(sample.le_acl_completed);
+    credit_history.push_back(sample_builder.Finish());
+  }
+  auto credit_history_vector = fb_builder->CreateVector(credit_history);
+  auto credit_monitor_stats = round_robin_scheduler_->GetCreditMonitorStats();
+
+  AclSchedulerDataBuilder builder(*fb_builder);
+  builder.add_policy(policy);
+  builder.add_acl_credits(round_robin_scheduler_->GetCredits());
+  builder.add_max_acl_credits(round_robin_scheduler_->GetMaxCredits());
+  builder.add_le_acl_credits(round_robin_scheduler_->GetLeCredits());
+  builder.add_le_max_acl_credits(round_robin_scheduler_->GetLeMaxCredits());
+  builder.add_links(links_vector);
+  builder.add_acl_stalls(credit_monitor_stats.acl_stalls);
+  builder.add_le_acl_stalls(credit_monitor_stats.le_acl_stalls);
+  builder.add_acl_reclaimed_credits(credit_monitor_stats.acl_reclaimed_credits);
+  builder.add_le_acl_reclaimed_credits(credit_monitor_stats.le_acl_reclaimed_credits);
+  builder.add_credit_history(credit_history_vector);
+  return builder.Finish();
+}
+
+flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<LeLinkParametersData>>>
+AclManager::impl::DumpLeLinkParameters(flatbuffers::FlatBufferBuilder* fb_builder) const {
+  std::vector<flatbuffers::Offset<LeLinkParametersData>> links;
+  for (const auto& link : le_impl_->link_parameter_manager_.GetLinkStates()) {
+    std::vector<flatbuffers::Offset<flatbuffers::String>> requests;
+    for (const auto& [client, profile] : link.requests) {
+      requests.push_back(fb_builder->CreateString(client + ":" + acl_manager::LinkProfileText(profile)));
+    }
+    auto requests_vector = fb_builder->CreateVector(requests);
+    auto current = fb_builder->CreateString(link.current.ToString());
+
+    std::vector<flatbuffers::Offset<LeLinkParameterDecisionData>> decisions;
+    for (const auto& decision : link.decisions) {
+      auto reason = fb_builder->CreateString(decision.reason);
+      auto parameters = fb_builder->CreateString(decision.parameters.ToString());
+      LeLinkParameterDecisionDataBuilder decision_builder(*fb_builder);
+      decision_builder.add_reason(reason);
+      decision_builder.add_parameters(parameters);
+      decisions.push_back(decision_builder.Finish());
+    }
+    auto decisions_vector = fb_builder->CreateVector(decisions);
+
+    LeLinkParametersDataBuilder link_builder(*fb_builder);
+    link_builder.add_handle(link.handle);
+    link_builder.add_requests(requests_vector);
+    link_builder.add_current(current);
+    link_builder.add_bytes_per_second(link.bytes_per_second);
+    link_builder.add_auto_upgrade_allowed(link.auto_upgrade_allowed);
+    link_builder.add_auto_upgraded(link.auto_upgraded);
+    link_builder.add_decisions(decisions_vector);
+    links.push_back(link_builder.Finish());
+  }
+  return fb_builder->CreateVector(links);
+}
+
+flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<TrafficTelemetryData>>>
+AclManager::impl::DumpTrafficTelemetry(flatbuffers::FlatBufferBuilder* fb_builder) const {
+  std::vector<flatbuffers::Offset<TrafficTelemetryData>> channels;
+  for (const auto& snapshot : common::TrafficTelemetry::Poll()) {
+    auto type = fb_builder->CreateString(common::TrafficChannelTypeText(snapshot.type));
+    TrafficTelemetryDataBuilder channel_builder(*fb_builder);
+    channel_builder.add_type(type);
+    channel_builder.add_acl_handle(snapshot.acl_handle);
+    channel_builder.add_channel_id(snapshot.channel_id);
+    channel_builder.add_rx_bytes(snapshot.rx_bytes);
+    channel_builder.add_rx_packets(snapshot.rx_packets);
+    channel_builder.add_tx_bytes(snapshot.tx_bytes);
+    channel_builder.add_tx_packets(snapshot.tx_packets);
+    channel_builder.add_rx_queue_depth(snapshot.rx_queue_depth);
+    channel_builder.add_tx_queue_depth(snapshot.tx_queue_depth);
+    channel_builder.add_outstanding_credits(snapshot.outstanding_credits);
+    channel_builder.add_rx_bytes_per_second(snapshot.rx_bytes_per_second);
+    channel_builder.add_tx_bytes_per_second(snapshot.tx_bytes_per_second);
+    channels.push_back(channel_builder.Finish());
+  }
+  return fb_builder->CreateVector(channels);
+}
+
 DumpsysDataFinisher AclManager::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const {
   ASSERT(fb_builder != nullptr);
 
@@ -25,6 +25,7 @@
 #include "hci/acl_manager/connection_callbacks.h"
 #include "hci/acl_manager/le_acceptlist_callbacks.h"
 #include "hci/acl_manager/le_connection_callbacks.h"
+#include "hci/acl_manager/link_parameter_manager.h"
 #include "hci/address.h"
 #include "hci/address_with_type.h"
 #include "hci/distance_measurement_manager.h"
@@ -149,6 +150,16 @@ public:
  virtual void OnLeSuspendInitiatedDisconnect(uint16_t handle, ErrorCode reason);
  virtual void SetSystemSuspendState(bool suspended);
 
+ // Keep |credits| LE controller buffers available for |handle|, e.g. while it carries audio control traffic
+ virtual void SetLeAclTxCreditReservation(uint16_t handle, uint16_t credits);
+
+ // Ask for the LE link |handle| to be tuned for |profile| on behalf of |client|. Requests from all clients of a
+ // link are merged; a link without any request goes back to idle parameters.
+ virtual void RequestLeLinkProfile(uint16_t handle, std::string client, acl_manager::LinkProfile profile);
+ virtual void ReleaseLeLinkProfile(uint16_t handle, std::string client);
+ // Keep |handle| out of the traffic based 2M PHY and data length upgrade, for devices on the interop blocklist
+ virtual void SetLeLinkAutoUpgradeAllowed(uint16_t handle, bool allowed);
+
  static const ModuleFactory Factory;
 
 protected:
@@ -16,21 +16,71 @@
 
 #include "hci/acl_manager/acl_fragmenter.h"
 
+#include <algorithm>
+
 #include "os/log.h"
-#include "packet/fragmenting_inserter.h"
+#include "packet/bit_inserter.h"
 
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+namespace {
+// A slice of the serialized packet shared by all its fragments
+class AclFragment : public packet::BasePacketBuilder {
+ public:
+  AclFragment(std::shared_ptr<const std::vector<uint8_t>> buffer, size_t offset, size_t size)
+      : buffer_(std::move(buffer)), offset_(offset), size_(size) {}
+
+  size_t size() const override {
+    return size_;
+  }
+
+  void Serialize(packet::BitInserter& it) const override {
+    it.insert_bytes(buffer_->data() + offset_, size_);
+  }
+
+ private:
+  std::shared_ptr<const std::vector<uint8_t>> buffer_;
+  size_t offset_;
+  size_t size_;
+};
+}  // namespace
+
 AclFragmenter::AclFragmenter(size_t mtu, std::unique_ptr<packet::BasePacketBuilder> packet)
-    : mtu_(mtu), packet_(std::move(packet)) {}
+    : mtu_(mtu), size_(packet->size()), packet_(std::move(packet)) {
+  ASSERT(mtu_ > 0);
+}
+
+size_t AclFragmenter::GetNumFragments() const {
+  return std::max<size_t>(1, (size_ + mtu_ - 1) / mtu_);
+}
+
+bool AclFragmenter::HasNextFragment() const {
+  return next_fragment_ < GetNumFragments();
+}
+
+std::unique_ptr<packet::BasePacketBuilder> AclFragmenter::GetNextFragment() {
+  ASSERT(HasNextFragment());
+  if (packet_ != nullptr) {
+    auto buffer = std::make_shared<std::vector<uint8_t>>();
+    buffer->reserve(size_);
+    packet::BitInserter it(*buffer);
+    packet_->Serialize(it);
+    ASSERT_LOG(buffer->size() == size_, "Packet serialized to %zu bytes instead of %zu", buffer->size(), size_);
+    packet_.reset();
+    buffer_ = std::move(buffer);
+  }
+  size_t offset = next_fragment_++ * mtu_;
+  return std::make_unique<AclFragment>(buffer_, offset, std::min(mtu_, buffer_->size() - offset));
+}
 
-std::vector<std::unique_ptr<packet::RawBuilder>> AclFragmenter::GetFragments() {
-  std::vector<std::unique_ptr<packet::RawBuilder>> to_return;
-  packet::FragmentingInserter fragmenting_inserter(mtu_, std::back_insert_iterator(to_return));
-  packet_->Serialize(fragmenting_inserter);
-  fragmenting_inserter.finalize();
+std::vector<std::unique_ptr<packet::BasePacketBuilder>> AclFragmenter::GetFragments() {
+  std::vector<std::unique_ptr<packet::BasePacketBuilder>> to_return;
+  to_return.reserve(GetNumFragments());
+  while (HasNextFragment()) {
+    to_return.push_back(GetNextFragment());
+  }
   return to_return;
 }
 
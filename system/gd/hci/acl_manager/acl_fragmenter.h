@@ -17,28 +17,38 @@
 #pragma once
 
 #include <cstdint>
-#include <forward_list>
-#include <iterator>
 #include <memory>
 #include <vector>
 
 #include "packet/base_packet_builder.h"
-#include "packet/raw_builder.h"
 
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+// Splits a packet into controller sized fragments. The packet is serialized once, when the first fragment is
+// requested, and every fragment refers to its slice of that buffer instead of holding a copy of it.
 class AclFragmenter {
  public:
   AclFragmenter(size_t mtu, std::unique_ptr<packet::BasePacketBuilder> input);
   virtual ~AclFragmenter() = default;
 
-  std::vector<std::unique_ptr<packet::RawBuilder>> GetFragments();
+  size_t GetNumFragments() const;
+
+  bool HasNextFragment() const;
+
+  // Fragments are handed out in order, they stay valid after the fragmenter is destroyed
+  std::unique_ptr<packet::BasePacketBuilder> GetNextFragment();
+
+  // All the remaining fragments at once
+  std::vector<std::unique_ptr<packet::BasePacketBuilder>> GetFragments();
 
  private:
   size_t mtu_;
+  size_t size_;
   std::unique_ptr<packet::BasePacketBuilder> packet_;
+  std::shared_ptr<const std::vector<uint8_t>> buffer_;
+  size_t next_fragment_{0};
 };
 
 }  // namespace acl_manager
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/acl_fragmenter.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+std::unique_ptr<packet::RawBuilder> MakePacket(size_t size) {
+  std::vector<uint8_t> bytes(size);
+  for (size_t i = 0; i < size; i++) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+  return std::make_unique<packet::RawBuilder>(bytes);
+}
+
+std::vector<uint8_t> Serialize(const packet::BasePacketBuilder& builder) {
+  std::vector<uint8_t> bytes;
+  packet::BitInserter it(bytes);
+  builder.Serialize(it);
+  return bytes;
+}
+
+TEST(AclFragmenterTest, fragments_cover_the_packet) {
+  const size_t mtu = 27;
+  const size_t packet_size = 100;
+  AclFragmenter fragmenter(mtu, MakePacket(packet_size));
+  ASSERT_EQ(4u, fragmenter.GetNumFragments());
+
+  std::vector<uint8_t> reassembled;
+  size_t num_fragments = 0;
+  while (fragmenter.HasNextFragment()) {
+    auto fragment = fragmenter.GetNextFragment();
+    auto bytes = Serialize(*fragment);
+    ASSERT_EQ(fragment->size(), bytes.size());
+    ASSERT_LE(bytes.size(), mtu);
+    reassembled.insert(reassembled.end(), bytes.begin(), bytes.end());
+    num_fragments++;
+  }
+  ASSERT_EQ(4u, num_fragments);
+  ASSERT_EQ(Serialize(*MakePacket(packet_size)), reassembled);
+}
+
+TEST(AclFragmenterTest, exact_multiple_of_mtu) {
+  AclFragmenter fragmenter(10, MakePacket(30));
+  auto fragments = fragmenter.GetFragments();
+  ASSERT_EQ(3u, fragments.size());
+  for (const auto& fragment : fragments) {
+    ASSERT_EQ(10u, fragment->size());
+  }
+  ASSERT_FALSE(fragmenter.HasNextFragment());
+}
+
+TEST(AclFragmenterTest, empty_packet_makes_one_fragment) {
+  AclFragmenter fragmenter(10, MakePacket(0));
+  auto fragments = fragmenter.GetFragments();
+  ASSERT_EQ(1u, fragments.size());
+  ASSERT_EQ(0u, fragments[0]->size());
+}
+
+TEST(AclFragmenterTest, fragments_outlive_fragmenter) {
+  std::unique_ptr<packet::BasePacketBuilder> last;
+  {
+    AclFragmenter fragmenter(16, MakePacket(40));
+    fragmenter.GetNextFragment();
+    fragmenter.GetNextFragment();
+    last = fragmenter.GetNextFragment();
+  }
+  auto bytes = Serialize(*last);
+  ASSERT_EQ(8u, bytes.size());
+  ASSERT_EQ(32, bytes[0]);
+  ASSERT_EQ(39, bytes[7]);
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/bidi_queue.h"
+#include "common/bind.h"
+#include "hci/acl_manager/acl_fragmenter.h"
+#include "hci/acl_manager/assembler.h"
+#include "hci/acl_manager/round_robin_scheduler.h"
+#include "hci/controller.h"
+#include "hci/hci_packets.h"
+#include "os/handler.h"
+#include "os/log.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+using packet::kLittleEndian;
+using packet::PacketView;
+
+constexpr uint16_t kHandle = 0x0040;
+constexpr auto kTimeout = std::chrono::seconds(10);
+
+std::vector<uint8_t> Payload(size_t size) {
+  std::vector<uint8_t> payload(size);
+  for (size_t i = 0; i < size; i++) {
+    payload[i] = static_cast<uint8_t>(i);
+  }
+  return payload;
+}
+
+// Splits an L2CAP PDU of 4096 bytes in fragments of the HCI MTU given as argument
+void BM_AclFragmenter(State& state) {
+  size_t mtu = state.range(0);
+  auto payload = Payload(4096);
+  for (auto _ : state) {
+    AclFragmenter fragmenter(mtu, std::make_unique<packet::RawBuilder>(payload));
+    auto fragments = fragmenter.GetFragments();
+    ::benchmark::DoNotOptimize(fragments);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * payload.size());
+}
+BENCHMARK(BM_AclFragmenter)->Arg(27)->Arg(251)->Arg(1021);
+
+// Reassembles L2CAP PDUs from ACL fragments, on the handler like the AclManager does, until the PDUs reach the
+// connection queue. The arguments are the size of the PDUs and the size of the fragments.
+class BM_AclAssembler : public ::benchmark::Fixture {
+ protected:
+  // Fewer than the assembler queues before it drops packets
+  static constexpr size_t kPdusPerIteration = 8;
+
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    thread_ = new os::Thread("benchmark_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+    queue_ = new AclConnection::Queue(kPdusPerIteration);
+    assembler_ = new assembler(
+        AddressWithType(Address::FromString("A1:A2:A3:A4:A5:A6").value(), AddressType::PUBLIC_DEVICE_ADDRESS),
+        queue_->GetDownEnd(),
+        handler_);
+    queue_->GetUpEnd()->RegisterDequeue(
+        handler_, common::Bind(&BM_AclAssembler::on_dequeue, common::Unretained(this)));
+
+    size_t pdu_size = st.range(0);
+    size_t fragment_size = st.range(1);
+    auto pdu = Payload(kL2capBasicFrameHeaderSize + pdu_size);
+    pdu[0] = static_cast<uint8_t>(pdu_size);
+    pdu[1] = static_cast<uint8_t>(pdu_size >> 8);
+    for (size_t offset = 0; offset < pdu.size(); offset += fragment_size) {
+      size_t end = std::min(pdu.size(), offset + fragment_size);
+      auto builder = AclBuilder::Create(
+          kHandle,
+          offset == 0 ? PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE : PacketBoundaryFlag::CONTINUING_FRAGMENT,
+          BroadcastFlag::POINT_TO_POINT,
+          std::make_unique<packet::RawBuilder>(std::vector<uint8_t>(pdu.begin() + offset, pdu.begin() + end)));
+      auto bytes = std::make_shared<std::vector<uint8_t>>();
+      packet::BitInserter it(*bytes);
+      builder->Serialize(it);
+      auto acl = AclView::Create(PacketView<kLittleEndian>(bytes));
+      ASSERT(acl.IsValid());
+      fragments_.push_back(acl);
+    }
+  }
+
+  void TearDown(State& st) override {
+    queue_->GetUpEnd()->UnregisterDequeue();
+    delete assembler_;
+    handler_->Clear();
+    delete queue_;
+    delete handler_;
+    delete thread_;
+    fragments_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void deliver() {
+    for (size_t i = 0; i < kPdusPerIteration; i++) {
+      for (const auto& fragment : fragments_) {
+        assembler_->on_incoming_packet(fragment);
+      }
+    }
+  }
+
+  void on_dequeue() {
+    auto pdu = queue_->GetUpEnd()->TryDequeue();
+    ::benchmark::DoNotOptimize(pdu);
+    if (++received_ == kPdusPerIteration) {
+      received_promise_.set_value();
+    }
+  }
+
+  os::Thread* thread_;
+  os::Handler* handler_;
+  AclConnection::Queue* queue_;
+  assembler* assembler_;
+  std::vector<AclView> fragments_;
+  size_t received_ = 0;
+  std::promise<void> received_promise_;
+};
+
+BENCHMARK_DEFINE_F(BM_AclAssembler, reassemble)(State& state) {
+  for (auto _ : state) {
+    received_ = 0;
+    received_promise_ = std::promise<void>();
+    auto received = received_promise_.get_future();
+    handler_->Post(common::BindOnce(&BM_AclAssembler::deliver, common::Unretained(this)));
+    ASSERT(received.wait_for(kTimeout) == std::future_status::ready);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kPdusPerIteration);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kPdusPerIteration * state.range(0));
+}
+BENCHMARK_REGISTER_F(BM_AclAssembler, reassemble)
+    ->Args({23, 27})
+    ->Args({247, 27})
+    ->Args({672, 1021})
+    ->Args({4096, 1021})
+    ->UseRealTime();
+
+class BenchmarkController : public Controller {
+ public:
+  uint16_t GetNumAclPacketBuffers() const override {
+    return 10;
+  }
+
+  uint16_t GetAclPacketLength() const override {
+    return 1021;
+  }
+
+  LeBufferSize GetLeBufferSize() const override {
+    LeBufferSize le_buffer_size;
+    le_buffer_size.le_data_packet_length_ = 251;
+    le_buffer_size.total_num_le_packets_ = 15;
+    return le_buffer_size;
+  }
+
+  void RegisterCompletedAclPacketsCallback(CompletedAclPacketsCallback cb) override {
+    acl_credits_callback_ = cb;
+  }
+
+  void UnregisterCompletedAclPacketsCallback() override {
+    acl_credits_callback_ = {};
+  }
+
+  void SendCompletedAclPacketsCallback(uint16_t handle, uint16_t credits) {
+    acl_credits_callback_.Invoke(handle, credits);
+  }
+
+ private:
+  CompletedAclPacketsCallback acl_credits_callback_;
+};
+
+// Sends packets of 600 bytes from the number of classic links given as argument through the scheduler, to a
+// controller that completes each packet as soon as the HCI queue takes it
+class BM_RoundRobinScheduler : public ::benchmark::Fixture {
+ protected:
+  static constexpr size_t kPacketsPerLink = 32;
+  static constexpr size_t kPacketSize = 600;
+
+  struct Link {
+    uint16_t handle;
+    std::shared_ptr<AclConnection::Queue> queue;
+    size_t remaining = 0;
+  };
+
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    thread_ = new os::Thread("benchmark_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+    controller_ = new BenchmarkController();
+    scheduler_ = new RoundRobinScheduler(handler_, controller_, hci_queue_.GetUpEnd());
+    hci_queue_.GetDownEnd()->RegisterDequeue(
+        handler_, common::Bind(&BM_RoundRobinScheduler::on_hci_dequeue, common::Unretained(this)));
+    links_.resize(st.range(0));
+    for (size_t i = 0; i < links_.size(); i++) {
+      links_[i].handle = static_cast<uint16_t>(i + 1);
+      links_[i].queue = std::make_shared<AclConnection::Queue>(10);
+      scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, links_[i].handle, links_[i].queue);
+    }
+    payload_ = Payload(kPacketSize);
+  }
+
+  void TearDown(State& st) override {
+    for (auto& link : links_) {
+      scheduler_->Unregister(link.handle);
+    }
+    hci_queue_.GetDownEnd()->UnregisterDequeue();
+    delete scheduler_;
+    delete controller_;
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+    links_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  std::unique_ptr<packet::BasePacketBuilder> on_link_enqueue(Link* link) {
+    if (--link->remaining == 0) {
+      link->queue->GetUpEnd()->UnregisterEnqueue();
+    }
+    return std::make_unique<packet::RawBuilder>(payload_);
+  }
+
+  // Serialize the packet like the HAL does, and give its credit back
+  void on_hci_dequeue() {
+    auto packet = hci_queue_.GetDownEnd()->TryDequeue();
+    bytes_.clear();
+    packet::BitInserter it(bytes_);
+    packet->Serialize(it);
+    controller_->SendCompletedAclPacketsCallback((bytes_[0] | (bytes_[1] << 8)) & 0x0fff, 1);
+    if (--remaining_ == 0) {
+      sent_promise_.set_value();
+    }
+  }
+
+  common::BidiQueue<AclView, AclBuilder> hci_queue_{3};
+  os::Thread* thread_;
+  os::Handler* handler_;
+  BenchmarkController* controller_;
+  RoundRobinScheduler* scheduler_;
+  std::vector<Link> links_;
+  std::vector<uint8_t> payload_;
+  std::vector<uint8_t> bytes_;
+  size_t remaining_ = 0;
+  std::promise<void> sent_promise_;
+};
+
+BENCHMARK_DEFINE_F(BM_RoundRobinScheduler, send)(State& state) {
+  for (auto _ : state) {
+    remaining_ = links_.size() * kPacketsPerLink;
+    sent_promise_ = std::promise<void>();
+    auto sent = sent_promise_.get_future();
+    for (auto& link : links_) {
+      link.remaining = kPacketsPerLink;
+      link.queue->GetUpEnd()->RegisterEnqueue(
+          handler_,
+          common::Bind(&BM_RoundRobinScheduler::on_link_enqueue, common::Unretained(this), common::Unretained(&link)));
+    }
+    ASSERT(sent.wait_for(kTimeout) == std::future_status::ready);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * links_.size() * kPacketsPerLink);
+}
+BENCHMARK_REGISTER_F(BM_RoundRobinScheduler, send)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -16,10 +16,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <queue>
+#include <vector>
 
+#include "common/traffic_telemetry.h"
 #include "hci/acl_manager/acl_connection.h"
 #include "hci/address_with_type.h"
 #include "os/handler.h"
@@ -34,12 +38,48 @@ constexpr size_t kMaxQueuedPacketsPerConnection = 10;
 constexpr size_t kL2capBasicFrameHeaderSize = 4;
 
 namespace {
-class PacketViewForRecombination : public packet::PacketView<packet::kLittleEndian> {
+// Reassembles an L2CAP PDU into one contiguous buffer sized from the L2CAP length of the first fragment, so every
+// fragment is copied exactly once and the resulting view holds a single fragment. The PDU keeps the latency sample
+// of its first fragment.
+class RecombinationBuffer {
  public:
-  PacketViewForRecombination(const PacketView& packetView) : PacketView(packetView) {}
-  void AppendPacketView(packet::PacketView<packet::kLittleEndian> to_append) {
-    Append(to_append);
+  void Start(const packet::PacketView<packet::kLittleEndian>& first_fragment, size_t l2cap_pdu_size) {
+    buffer_ = std::make_shared<std::vector<uint8_t>>();
+    buffer_->reserve(kL2capBasicFrameHeaderSize + l2cap_pdu_size);
+    latency_sample_ = first_fragment.GetLatencySample();
+    Append(first_fragment);
   }
+
+  void Append(const packet::PacketView<packet::kLittleEndian>& fragment) {
+    if (buffer_ == nullptr) {
+      buffer_ = std::make_shared<std::vector<uint8_t>>();
+    }
+    buffer_->insert(buffer_->end(), fragment.begin(), fragment.end());
+  }
+
+  packet::PacketView<packet::kLittleEndian> Finish() {
+    if (buffer_ == nullptr) {
+      buffer_ = std::make_shared<std::vector<uint8_t>>();
+    }
+    packet::PacketView<packet::kLittleEndian> pdu(std::move(buffer_));
+    pdu.SetLatencySample(latency_sample_);
+    buffer_.reset();
+    latency_sample_ = 0;
+    return pdu;
+  }
+
+  void Reset() {
+    buffer_.reset();
+    latency_sample_ = 0;
+  }
+
+  size_t size() const {
+    return buffer_ == nullptr ? 0 : buffer_->size();
+  }
+
+ private:
+  std::shared_ptr<std::vector<uint8_t>> buffer_;
+  uint32_t latency_sample_ = 0;
 };
 
 // Per spec 5.1 Vol 2 Part B 5.3, ACL link shall carry L2CAP data. Therefore, an ACL packet shall contain L2CAP PDU.
@@ -61,22 +101,27 @@ struct assembler {
   AddressWithType address_with_type_;
   AclConnection::QueueDownEnd* down_end_;
   os::Handler* handler_;
-  PacketViewForRecombination recombination_stage_{
-      PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
+  RecombinationBuffer recombination_stage_;
   size_t remaining_sdu_continuation_packet_size_ = 0;
   std::shared_ptr<std::atomic_bool> enqueue_registered_ = std::make_shared<std::atomic_bool>(false);
   std::queue<packet::PacketView<packet::kLittleEndian>> incoming_queue_;
+  // ACL payload bytes received from the controller, dropped fragments included
+  uint64_t received_bytes_ = 0;
+  // Registered with the handle of the first packet
+  common::TrafficCounters* traffic_counters_ = nullptr;
 
   ~assembler() {
     if (enqueue_registered_->exchange(false)) {
       down_end_->UnregisterEnqueue();
     }
+    common::TrafficTelemetry::Unregister(traffic_counters_);
   }
 
   // Invoked from some external Queue Reactable context
   std::unique_ptr<packet::PacketView<packet::kLittleEndian>> on_le_incoming_data_ready() {
     auto packet = incoming_queue_.front();
     incoming_queue_.pop();
+    traffic_counters_->SetRxQueueDepth(incoming_queue_.size());
     if (incoming_queue_.empty() && enqueue_registered_->exchange(false)) {
       down_end_->UnregisterEnqueue();
     }
@@ -86,6 +131,12 @@ struct assembler {
   void on_incoming_packet(AclView packet) {
     PacketView<packet::kLittleEndian> payload = packet.GetPayload();
     size_t payload_size = payload.size();
+    received_bytes_ += payload_size;
+    if (traffic_counters_ == nullptr) {
+      traffic_counters_ =
+          common::TrafficTelemetry::Register(common::TrafficChannelType::ACL, packet.GetHandle(), 0);
+    }
+    traffic_counters_->OnReceived(payload_size);
     auto broadcast_flag = packet.GetBroadcastFlag();
     if (broadcast_flag == BroadcastFlag::ACTIVE_PERIPHERAL_BROADCAST) {
       LOG_WARN("Dropping broadcast from remote");
@@ -99,23 +150,21 @@ struct assembler {
     if (packet_boundary_flag == PacketBoundaryFlag::CONTINUING_FRAGMENT) {
       if (remaining_sdu_continuation_packet_size_ < payload_size) {
         LOG_WARN("Remote sent unexpected L2CAP PDU. Drop the entire L2CAP PDU");
-        recombination_stage_ =
-            PacketViewForRecombination(PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
+        recombination_stage_.Reset();
         remaining_sdu_continuation_packet_size_ = 0;
         return;
       }
       remaining_sdu_continuation_packet_size_ -= payload_size;
-      recombination_stage_.AppendPacketView(payload);
+      recombination_stage_.Append(payload);
       if (remaining_sdu_continuation_packet_size_ != 0) {
         return;
       } else {
-        payload = recombination_stage_;
-        recombination_stage_ =
-            PacketViewForRecombination(PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
+        payload = recombination_stage_.Finish();
       }
     } else if (packet_boundary_flag == PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE) {
       if (recombination_stage_.size() > 0) {
         LOG_ERROR("Controller sent a starting packet without finishing previous packet. Drop previous one.");
+        recombination_stage_.Reset();
       }
       size_t l2cap_pdu_size = GetL2capPduSize(packet);
       if (l2cap_pdu_size == 0) {
@@ -135,7 +184,7 @@ struct assembler {
             l2cap_pdu_size - (payload_size - kL2capBasicFrameHeaderSize);
       }
       if (remaining_sdu_continuation_packet_size_ > 0) {
-        recombination_stage_ = payload;
+        recombination_stage_.Start(payload, l2cap_pdu_size);
         return;
       }
     }
@@ -146,6 +195,7 @@ struct assembler {
     }
 
     incoming_queue_.push(payload);
+    traffic_counters_->SetRxQueueDepth(incoming_queue_.size());
     if (!enqueue_registered_->exchange(true)) {
       down_end_->RegisterEnqueue(handler_,
                                  common::Bind(&assembler::on_le_incoming_data_ready, common::Unretained(this)));
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/assembler.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <queue>
+#include <vector>
+
+#include "common/bind.h"
+#include "hci/hci_packets.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+using packet::kLittleEndian;
+using packet::PacketView;
+
+constexpr uint16_t kHandle = 0x0040;
+const auto kTimeout = std::chrono::seconds(1);
+
+class AssemblerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+    queue_ = new AclConnection::Queue(10);
+    assembler_ = new assembler(
+        AddressWithType(Address::FromString("A1:A2:A3:A4:A5:A6").value(), AddressType::PUBLIC_DEVICE_ADDRESS),
+        queue_->GetDownEnd(),
+        handler_);
+    queue_->GetUpEnd()->RegisterDequeue(handler_, common::Bind(&AssemblerTest::on_dequeue, common::Unretained(this)));
+  }
+
+  void TearDown() override {
+    queue_->GetUpEnd()->UnregisterDequeue();
+    delete assembler_;
+    handler_->Clear();
+    delete queue_;
+    delete handler_;
+    delete thread_;
+  }
+
+  // The assembler runs on the handler, like it does in the AclManager
+  void Deliver(PacketBoundaryFlag packet_boundary_flag, std::vector<uint8_t> payload) {
+    auto builder = AclBuilder::Create(
+        kHandle,
+        packet_boundary_flag,
+        BroadcastFlag::POINT_TO_POINT,
+        std::make_unique<packet::RawBuilder>(std::move(payload)));
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    packet::BitInserter it(*bytes);
+    builder->Serialize(it);
+    auto acl = AclView::Create(PacketView<kLittleEndian>(bytes));
+    ASSERT_TRUE(acl.IsValid());
+
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    handler_->Post(common::BindOnce(
+        [](assembler* assembler, AclView acl, std::promise<void> promise) {
+          assembler->on_incoming_packet(acl);
+          promise.set_value();
+        },
+        assembler_,
+        acl,
+        std::move(promise)));
+    ASSERT_EQ(std::future_status::ready, future.wait_for(kTimeout));
+  }
+
+  std::vector<uint8_t> Receive() {
+    auto future = received_promise_.get_future();
+    EXPECT_EQ(std::future_status::ready, future.wait_for(kTimeout));
+    received_promise_ = std::promise<void>();
+    if (received_.empty()) {
+      return {};
+    }
+    auto pdu = received_.front();
+    received_.pop();
+    return std::vector<uint8_t>(pdu.begin(), pdu.end());
+  }
+
+  void on_dequeue() {
+    auto pdu = queue_->GetUpEnd()->TryDequeue();
+    ASSERT_NE(pdu, nullptr);
+    received_.push(*pdu);
+    received_promise_.set_value();
+  }
+
+  os::Thread* thread_;
+  os::Handler* handler_;
+  AclConnection::Queue* queue_;
+  assembler* assembler_;
+  std::queue<PacketView<kLittleEndian>> received_;
+  std::promise<void> received_promise_;
+};
+
+TEST_F(AssemblerTest, single_fragment_pdu) {
+  std::vector<uint8_t> pdu = {0x03, 0x00, 0x40, 0x00, 0x01, 0x02, 0x03};
+  Deliver(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, pdu);
+  ASSERT_EQ(pdu, Receive());
+}
+
+TEST_F(AssemblerTest, reassembles_fragmented_pdu) {
+  Deliver(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, {0x0a, 0x00, 0x40, 0x00, 0x01, 0x02, 0x03});
+  Deliver(PacketBoundaryFlag::CONTINUING_FRAGMENT, {0x04, 0x05, 0x06});
+  Deliver(PacketBoundaryFlag::CONTINUING_FRAGMENT, {0x07, 0x08, 0x09, 0x0a});
+  std::vector<uint8_t> expected = {0x0a, 0x00, 0x40, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a};
+  ASSERT_EQ(expected, Receive());
+}
+
+TEST_F(AssemblerTest, oversized_continuation_drops_pdu) {
+  Deliver(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, {0x04, 0x00, 0x40, 0x00, 0x01, 0x02});
+  Deliver(PacketBoundaryFlag::CONTINUING_FRAGMENT, {0x03, 0x04, 0x05});
+  std::vector<uint8_t> pdu = {0x01, 0x00, 0x40, 0x00, 0x01};
+  Deliver(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, pdu);
+  ASSERT_EQ(pdu, Receive());
+}
+
+TEST_F(AssemblerTest, new_start_drops_unfinished_pdu) {
+  Deliver(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, {0x08, 0x00, 0x40, 0x00, 0x01, 0x02});
+  Deliver(PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE, {0x04, 0x00, 0x40, 0x00, 0x0a, 0x0b});
+  Deliver(PacketBoundaryFlag::CONTINUING_FRAGMENT, {0x0c, 0x0d});
+  std::vector<uint8_t> expected = {0x04, 0x00, 0x40, 0x00, 0x0a, 0x0b, 0x0c, 0x0d};
+  ASSERT_EQ(expected, Receive());
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
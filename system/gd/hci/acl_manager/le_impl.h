@@ -27,11 +27,14 @@
 #include <unordered_set>
 
 #include "common/bind.h"
+#include "common/callback.h"
 #include "common/init_flags.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/acl_manager/assembler.h"
 #include "hci/acl_manager/le_acceptlist_callbacks.h"
 #include "hci/acl_manager/le_connection_management_callbacks.h"
+#include "hci/acl_manager/le_reconnect_parameters.h"
+#include "hci/acl_manager/link_parameter_manager.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/controller.h"
 #include "hci/hci_layer.h"
@@ -40,6 +43,7 @@
 #include "os/alarm.h"
 #include "os/handler.h"
 #include "os/metrics.h"
+#include "os/repeating_alarm.h"
 #include "os/system_properties.h"
 #include "packet/packet_view.h"
 
@@ -70,6 +74,10 @@ constexpr uint8_t PHY_LE_2M = 0x02;
 constexpr uint8_t PHY_LE_CODED = 0x04;
 constexpr bool kEnableBlePrivacy = true;
 constexpr bool kEnableBleOnlyInit1mPhy = false;
+constexpr bool kEnableLeAutoLinkUpgrade = true;
+constexpr std::chrono::milliseconds kLinkTrafficSamplePeriod{1000};
+// Largest LL PDU payload before a data length update
+constexpr uint16_t kLeDefaultTxOctets = 27;
 
 static const std::string kPropertyMinConnInterval = "bluetooth.core.le.min_connection_interval";
 static const std::string kPropertyMaxConnInterval = "bluetooth.core.le.max_connection_interval";
@@ -84,6 +92,7 @@ static const std::string kPropertyConnScanIntervalSlow = "bluetooth.core.le.conn
 static const std::string kPropertyConnScanWindowSlow = "bluetooth.core.le.connection_scan_window_slow";
 static const std::string kPropertyEnableBlePrivacy = "bluetooth.core.gap.le.privacy.enabled";
 static const std::string kPropertyEnableBleOnlyInit1mPhy = "bluetooth.core.gap.le.conn.only_init_1m_phy.enabled";
+static const std::string kPropertyEnableLeAutoLinkUpgrade = "bluetooth.core.le.auto_link_upgrade.enabled";
 
 enum class ConnectabilityState {
   DISARMED = 0,
@@ -154,6 +163,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     if (address_manager_registered) {
       le_address_manager_->UnregisterSync(this);
     }
+    link_traffic_alarm_.reset();
     delete le_address_manager_;
     hci_layer_->PutLeAclConnectionInterface();
     connections.reset();
@@ -281,6 +291,12 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return kIllegalConnectionHandle;
     }
 
+    uint64_t get_received_bytes(uint16_t handle) const {
+      std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
+      auto it = le_acl_connections_.find(handle);
+      return it != le_acl_connections_.end() ? it->second.assembler_->received_bytes_ : 0;
+    }
+
     AddressWithType getAddressWithType(uint16_t handle) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
       auto it = le_acl_connections_.find(handle);
@@ -454,6 +470,9 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     connection->locally_initiated_ = (role == hci::Role::CENTRAL);
     auto connection_callbacks = connection->GetEventCallbacks(
         [this](uint16_t handle) { this->connections.invalidate(handle); });
+    link_parameter_manager_.AddLink(handle);
+    start_link_traffic_sampling();
+    on_le_link_established(handle, remote_address, role, conn_interval, conn_latency, supervision_timeout);
     if (std::holds_alternative<DataAsUninitializedPeripheral>(role_specific_data)) {
       // the OnLeConnectSuccess event will be sent after receiving the On Advertising Set Terminated
       // event, since we need it to know what local_address / advertising set the peer connected to.
@@ -605,6 +624,9 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
     auto connection_callbacks = connection->GetEventCallbacks(
         [this](uint16_t handle) { this->connections.invalidate(handle); });
+    link_parameter_manager_.AddLink(handle);
+    start_link_traffic_sampling();
+    on_le_link_established(handle, remote_address, role, conn_interval, conn_latency, supervision_timeout);
 
     if (std::holds_alternative<DataAsUninitializedPeripheral>(role_specific_data)) {
       // the OnLeConnectSuccess event will be sent after receiving the On Advertising Set Terminated
@@ -663,6 +685,15 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
           callbacks->OnDisconnection(reason);
         },
         kRemoveConnectionAfterwards);
+    link_parameter_manager_.RemoveLink(handle);
+    auto reconnect_parameters = reconnect_parameters_.OnDisconnection(remote_address.GetAddress());
+    if (reconnect_parameters.has_value() && !on_reconnect_parameters_changed_.is_null()) {
+      on_reconnect_parameters_changed_.Run(remote_address.GetAddress(), *reconnect_parameters);
+    }
+    if (connections.is_empty() && link_traffic_alarm_ != nullptr) {
+      link_traffic_alarm_->Cancel();
+      link_traffic_alarm_.reset();
+    }
     if (le_acceptlist_callbacks_ != nullptr) {
       le_acceptlist_callbacks_->OnLeDisconnection(remote_address);
     }
@@ -682,6 +713,13 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
     auto handle = complete_view.GetConnectionHandle();
+    if (complete_view.GetStatus() == ErrorCode::SUCCESS) {
+      reconnect_parameters_.OnConnectionParameters(
+          connections.getAddressWithType(handle).GetAddress(),
+          complete_view.GetConnInterval(),
+          complete_view.GetConnLatency(),
+          complete_view.GetSupervisionTimeout());
+    }
     connections.execute(handle, [=](LeConnectionManagementCallbacks* callbacks) {
       callbacks->OnConnectionUpdate(
           complete_view.GetStatus(),
@@ -698,6 +736,10 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
     auto handle = complete_view.GetConnectionHandle();
+    if (complete_view.GetStatus() == ErrorCode::SUCCESS) {
+      reconnect_parameters_.OnPhyUpdate(
+          connections.getAddressWithType(handle).GetAddress(), complete_view.GetTxPhy(), complete_view.GetRxPhy());
+    }
     connections.execute(handle, [=](LeConnectionManagementCallbacks* callbacks) {
       callbacks->OnPhyUpdate(complete_view.GetStatus(), complete_view.GetTxPhy(), complete_view.GetRxPhy());
     });
@@ -717,6 +759,10 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
     auto handle = data_length_view.GetConnectionHandle();
+    reconnect_parameters_.OnDataLengthChange(
+        connections.getAddressWithType(handle).GetAddress(),
+        data_length_view.GetMaxTxOctets(),
+        data_length_view.GetMaxTxTime());
     connections.execute(handle, [=](LeConnectionManagementCallbacks* callbacks) {
       callbacks->OnDataLengthChange(
           data_length_view.GetMaxTxOctets(),
@@ -936,6 +982,20 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     uint16_t supervision_timeout = os::GetSystemPropertyUint32(kPropertyConnSupervisionTimeout, kSupervisionTimeout);
     ASSERT(check_connection_parameters(conn_interval_min, conn_interval_max, conn_latency, supervision_timeout));
 
+    // A direct connection to a single device starts with the parameters its link last settled on, rather than with
+    // the defaults followed by a connection update
+    if (connect_list.size() == 1 && direct_connections_.count(*connect_list.begin()) == 1) {
+      auto cached = reconnect_parameters_.Get(connect_list.begin()->GetAddress());
+      if (cached.has_value() &&
+          check_connection_parameters(cached->interval, cached->interval, cached->latency, cached->supervision_timeout)) {
+        LOG_INFO("Connecting with the parameters of the last connection: %s", cached->ToString().c_str());
+        conn_interval_min = cached->interval;
+        conn_interval_max = cached->interval;
+        conn_latency = cached->latency;
+        supervision_timeout = cached->supervision_timeout;
+      }
+    }
+
     AddressWithType address_with_type = connection_peer_address_with_type_;
     if (initiator_filter_policy == InitiatorFilterPolicy::USE_FILTER_ACCEPT_LIST) {
       address_with_type = AddressWithType();
@@ -1171,6 +1231,144 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         }));
   }
 
+  void request_link_profile(uint16_t handle, std::string client, LinkProfile profile) {
+    auto previous = link_parameter_manager_.GetCurrentParameters(handle);
+    apply_link_parameters(handle, previous, link_parameter_manager_.Request(handle, client, profile));
+  }
+
+  void release_link_profile(uint16_t handle, std::string client) {
+    auto previous = link_parameter_manager_.GetCurrentParameters(handle);
+    apply_link_parameters(handle, previous, link_parameter_manager_.Release(handle, client));
+  }
+
+  // Sends the commands that move |handle| from |previous| to |parameters|. The PHY and data length are only ever
+  // raised: once a link is on 2M with long PDUs it spends less air time for the same traffic, so going back to
+  // idle only relaxes the connection interval.
+  void apply_link_parameters(
+      uint16_t handle, std::optional<LinkParameters> previous, std::optional<LinkParameters> parameters) {
+    if (!parameters.has_value()) {
+      return;
+    }
+    if (check_connection_parameters(
+            parameters->interval_min,
+            parameters->interval_max,
+            parameters->latency,
+            parameters->supervision_timeout)) {
+      le_acl_connection_interface_->EnqueueCommand(
+          LeConnectionUpdateBuilder::Create(
+              handle,
+              parameters->interval_min,
+              parameters->interval_max,
+              parameters->latency,
+              parameters->supervision_timeout,
+              0,
+              0),
+          handler_->BindOnce([](CommandStatusView status) {
+            ASSERT(status.IsValid());
+            if (status.GetStatus() != ErrorCode::SUCCESS) {
+              LOG_WARN("LE connection update failed: %s", ErrorCodeText(status.GetStatus()).c_str());
+            }
+          }));
+    }
+
+    bool had_2m_phy = previous.has_value() && previous->prefer_2m_phy;
+    if (parameters->prefer_2m_phy && !had_2m_phy) {
+      set_link_2m_phy(handle);
+    }
+    bool had_max_data_length = previous.has_value() && previous->max_data_length;
+    if (parameters->max_data_length && !had_max_data_length) {
+      set_link_max_data_length(handle);
+    }
+  }
+
+  void set_link_2m_phy(uint16_t handle) {
+    if (controller_->SupportsBle2mPhy()) {
+      le_acl_connection_interface_->EnqueueCommand(
+          LeSetPhyBuilder::Create(handle, 0, 0, PHY_LE_2M, PHY_LE_2M, PhyOptions::NO_PREFERENCE),
+          handler_->BindOnce([](CommandStatusView status) {
+            ASSERT(status.IsValid());
+            if (status.GetStatus() != ErrorCode::SUCCESS) {
+              LOG_WARN("LE set PHY failed: %s", ErrorCodeText(status.GetStatus()).c_str());
+            }
+          }));
+    }
+  }
+
+  void set_link_max_data_length(uint16_t handle) {
+    if (controller_->SupportsBleDataPacketLengthExtension()) {
+      auto maximum_data_length = controller_->GetLeMaximumDataLength();
+      le_acl_connection_interface_->EnqueueCommand(
+          LeSetDataLengthBuilder::Create(
+              handle, maximum_data_length.supported_max_tx_octets_, maximum_data_length.supported_max_tx_time_),
+          handler_->BindOnce([](CommandCompleteView complete) {
+            auto complete_view = LeSetDataLengthCompleteView::Create(complete);
+            if (!complete_view.IsValid() || complete_view.GetStatus() != ErrorCode::SUCCESS) {
+              LOG_WARN("LE set data length failed");
+            }
+          }));
+    }
+  }
+
+  // Records the parameters the link settled on and, when reconnecting as central, asks right away for the PHY and data
+  // length the previous link to the device ended up with
+  void on_le_link_established(
+      uint16_t handle,
+      AddressWithType remote_address,
+      Role role,
+      uint16_t conn_interval,
+      uint16_t conn_latency,
+      uint16_t supervision_timeout) {
+    auto cached = reconnect_parameters_.Get(remote_address.GetAddress());
+    reconnect_parameters_.OnConnectionParameters(
+        remote_address.GetAddress(), conn_interval, conn_latency, supervision_timeout);
+    if (role != Role::CENTRAL || !cached.has_value()) {
+      return;
+    }
+    if (cached->tx_phy == PHY_LE_2M && cached->rx_phy == PHY_LE_2M) {
+      set_link_2m_phy(handle);
+    }
+    if (cached->max_tx_octets > kLeDefaultTxOctets) {
+      set_link_max_data_length(handle);
+    }
+  }
+
+  void load_reconnect_parameters(Address address, LeReconnectParameters parameters) {
+    reconnect_parameters_.Load(address, parameters);
+  }
+
+  void set_reconnect_parameters_changed_callback(
+      common::Callback<void(Address, LeReconnectParameters)> callback) {
+    on_reconnect_parameters_changed_ = std::move(callback);
+  }
+
+  void set_link_auto_upgrade_allowed(uint16_t handle, bool allowed) {
+    link_parameter_manager_.SetAutoUpgradeAllowed(handle, allowed);
+  }
+
+  void start_link_traffic_sampling() {
+    if (link_traffic_alarm_ != nullptr ||
+        !os::GetSystemPropertyBool(kPropertyEnableLeAutoLinkUpgrade, kEnableLeAutoLinkUpgrade)) {
+      return;
+    }
+    link_traffic_alarm_ = std::make_unique<os::RepeatingAlarm>(handler_);
+    link_traffic_alarm_->Schedule(
+        common::Bind(&le_impl::sample_link_traffic, common::Unretained(this)), kLinkTrafficSamplePeriod);
+  }
+
+  // Moves LE links that carry sustained traffic in either direction to the 2M PHY and maximum data length
+  void sample_link_traffic() {
+    for (const auto& stats : round_robin_scheduler_->GetLinkStats()) {
+      if (stats.connection_type != RoundRobinScheduler::ConnectionType::LE) {
+        continue;
+      }
+      uint64_t total_bytes = stats.sent_bytes + connections.get_received_bytes(stats.handle);
+      if (link_parameter_manager_.OnTrafficSample(stats.handle, total_bytes, kLinkTrafficSamplePeriod)) {
+        set_link_2m_phy(stats.handle);
+        set_link_max_data_length(stats.handle);
+      }
+    }
+  }
+
   void clear_resolving_list() {
     le_address_manager_->ClearResolvingList();
   }
@@ -1341,6 +1539,10 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   LeConnectionCallbacks* le_client_callbacks_ = nullptr;
   os::Handler* le_client_handler_ = nullptr;
   LeAcceptlistCallbacks* le_acceptlist_callbacks_ = nullptr;
+  LinkParameterManager link_parameter_manager_;
+  LeReconnectParameterCache reconnect_parameters_;
+  common::Callback<void(Address, LeReconnectParameters)> on_reconnect_parameters_changed_;
+  std::unique_ptr<os::RepeatingAlarm> link_traffic_alarm_;
   std::unordered_set<AddressWithType> connecting_le_{};
   bool arm_on_resume_{};
   std::unordered_set<AddressWithType> direct_connections_{};
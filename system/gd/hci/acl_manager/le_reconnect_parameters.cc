@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/le_reconnect_parameters.h"
+
+#include <base/strings/stringprintf.h>
+
+#include <cstdio>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+bool LeReconnectParameters::operator==(const LeReconnectParameters& other) const {
+  return interval == other.interval && latency == other.latency && supervision_timeout == other.supervision_timeout &&
+         tx_phy == other.tx_phy && rx_phy == other.rx_phy && max_tx_octets == other.max_tx_octets &&
+         max_tx_time == other.max_tx_time;
+}
+
+std::string LeReconnectParameters::ToString() const {
+  return base::StringPrintf(
+      "%04hx:%04hx:%04hx:%hhu:%hhu:%04hx:%04hx",
+      interval,
+      latency,
+      supervision_timeout,
+      tx_phy,
+      rx_phy,
+      max_tx_octets,
+      max_tx_time);
+}
+
+std::optional<LeReconnectParameters> LeReconnectParameters::FromString(const std::string& str) {
+  LeReconnectParameters parameters;
+  int consumed = 0;
+  if (sscanf(
+          str.c_str(),
+          "%hx:%hx:%hx:%hhu:%hhu:%hx:%hx%n",
+          &parameters.interval,
+          &parameters.latency,
+          &parameters.supervision_timeout,
+          &parameters.tx_phy,
+          &parameters.rx_phy,
+          &parameters.max_tx_octets,
+          &parameters.max_tx_time,
+          &consumed) != 7 ||
+      static_cast<size_t>(consumed) != str.size()) {
+    return std::nullopt;
+  }
+  return parameters;
+}
+
+void LeReconnectParameterCache::Load(const Address& address, const LeReconnectParameters& parameters) {
+  Entry& entry = entries_[address];
+  entry.parameters = parameters;
+  entry.changed = false;
+}
+
+std::optional<LeReconnectParameters> LeReconnectParameterCache::Get(const Address& address) const {
+  auto it = entries_.find(address);
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  return it->second.parameters;
+}
+
+void LeReconnectParameterCache::OnConnectionParameters(
+    const Address& address, uint16_t interval, uint16_t latency, uint16_t supervision_timeout) {
+  LeReconnectParameters parameters = Get(address).value_or(LeReconnectParameters{});
+  parameters.interval = interval;
+  parameters.latency = latency;
+  parameters.supervision_timeout = supervision_timeout;
+  Update(address, parameters);
+}
+
+void LeReconnectParameterCache::OnPhyUpdate(const Address& address, uint8_t tx_phy, uint8_t rx_phy) {
+  LeReconnectParameters parameters = Get(address).value_or(LeReconnectParameters{});
+  parameters.tx_phy = tx_phy;
+  parameters.rx_phy = rx_phy;
+  Update(address, parameters);
+}
+
+void LeReconnectParameterCache::OnDataLengthChange(
+    const Address& address, uint16_t max_tx_octets, uint16_t max_tx_time) {
+  LeReconnectParameters parameters = Get(address).value_or(LeReconnectParameters{});
+  parameters.max_tx_octets = max_tx_octets;
+  parameters.max_tx_time = max_tx_time;
+  Update(address, parameters);
+}
+
+std::optional<LeReconnectParameters> LeReconnectParameterCache::OnDisconnection(const Address& address) {
+  auto it = entries_.find(address);
+  if (it == entries_.end() || !it->second.changed) {
+    return std::nullopt;
+  }
+  it->second.changed = false;
+  return it->second.parameters;
+}
+
+void LeReconnectParameterCache::Remove(const Address& address) {
+  entries_.erase(address);
+}
+
+void LeReconnectParameterCache::Update(const Address& address, const LeReconnectParameters& parameters) {
+  Entry& entry = entries_[address];
+  if (entry.parameters != parameters) {
+    entry.parameters = parameters;
+    entry.changed = true;
+  }
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "hci/address.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// The parameters an LE link to a device last settled on. They are applied right away when reconnecting to it, instead
+// of starting from the defaults and renegotiating them on every connection.
+struct LeReconnectParameters {
+  // Connection interval, in 1.25 ms units, 0 when unknown
+  uint16_t interval = 0;
+  uint16_t latency = 0;
+  // Supervision timeout, in 10 ms units
+  uint16_t supervision_timeout = 0;
+  // PHY_LE_1M, PHY_LE_2M or PHY_LE_CODED, 0 when unknown
+  uint8_t tx_phy = 0;
+  uint8_t rx_phy = 0;
+  // Largest LL PDU the link settled on, 0 when unknown
+  uint16_t max_tx_octets = 0;
+  uint16_t max_tx_time = 0;
+
+  bool operator==(const LeReconnectParameters& other) const;
+  bool operator!=(const LeReconnectParameters& other) const {
+    return !(*this == other);
+  }
+
+  // Storage representation
+  std::string ToString() const;
+  static std::optional<LeReconnectParameters> FromString(const std::string& str);
+};
+
+// Tracks the parameters of the LE links, per device address, whatever its type. le_impl feeds it the link events, and persists the parameters of
+// a device when its link goes down.
+class LeReconnectParameterCache {
+ public:
+  // Parameters stored by a previous session
+  void Load(const Address& address, const LeReconnectParameters& parameters);
+
+  std::optional<LeReconnectParameters> Get(const Address& address) const;
+
+  void OnConnectionParameters(
+      const Address& address, uint16_t interval, uint16_t latency, uint16_t supervision_timeout);
+  void OnPhyUpdate(const Address& address, uint8_t tx_phy, uint8_t rx_phy);
+  void OnDataLengthChange(const Address& address, uint16_t max_tx_octets, uint16_t max_tx_time);
+
+  // Returns the parameters to persist when they changed since the last time they were loaded or persisted
+  std::optional<LeReconnectParameters> OnDisconnection(const Address& address);
+
+  void Remove(const Address& address);
+
+ private:
+  struct Entry {
+    LeReconnectParameters parameters;
+    bool changed = false;
+  };
+  void Update(const Address& address, const LeReconnectParameters& parameters);
+
+  std::unordered_map<Address, Entry> entries_;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
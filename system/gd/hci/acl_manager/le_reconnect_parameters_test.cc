@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/le_reconnect_parameters.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+const Address kAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const Address kOtherAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x77});
+
+LeReconnectParameters MakeParameters() {
+  LeReconnectParameters parameters;
+  parameters.interval = 0x0018;
+  parameters.latency = 4;
+  parameters.supervision_timeout = 0x01f4;
+  parameters.tx_phy = 2;
+  parameters.rx_phy = 2;
+  parameters.max_tx_octets = 251;
+  parameters.max_tx_time = 2120;
+  return parameters;
+}
+
+TEST(LeReconnectParametersTest, string_round_trip) {
+  auto parameters = MakeParameters();
+  auto parsed = LeReconnectParameters::FromString(parameters.ToString());
+  ASSERT_TRUE(parsed.has_value());
+  ASSERT_EQ(*parsed, parameters);
+}
+
+TEST(LeReconnectParametersTest, invalid_strings_are_rejected) {
+  ASSERT_FALSE(LeReconnectParameters::FromString("").has_value());
+  ASSERT_FALSE(LeReconnectParameters::FromString("0018:0004:01f4").has_value());
+  ASSERT_FALSE(LeReconnectParameters::FromString(MakeParameters().ToString() + ":").has_value());
+}
+
+TEST(LeReconnectParameterCacheTest, link_events_are_recorded) {
+  LeReconnectParameterCache cache;
+  ASSERT_FALSE(cache.Get(kAddress).has_value());
+  cache.OnConnectionParameters(kAddress, 0x0018, 4, 0x01f4);
+  cache.OnPhyUpdate(kAddress, 2, 2);
+  cache.OnDataLengthChange(kAddress, 251, 2120);
+  ASSERT_EQ(cache.Get(kAddress), MakeParameters());
+  ASSERT_FALSE(cache.Get(kOtherAddress).has_value());
+}
+
+TEST(LeReconnectParameterCacheTest, only_changed_parameters_are_persisted) {
+  LeReconnectParameterCache cache;
+  cache.Load(kAddress, MakeParameters());
+  ASSERT_EQ(cache.Get(kAddress), MakeParameters());
+  // Reconnected with the same parameters
+  cache.OnConnectionParameters(kAddress, 0x0018, 4, 0x01f4);
+  ASSERT_FALSE(cache.OnDisconnection(kAddress).has_value());
+
+  cache.OnPhyUpdate(kAddress, 1, 1);
+  auto persisted = cache.OnDisconnection(kAddress);
+  ASSERT_TRUE(persisted.has_value());
+  ASSERT_EQ(persisted->tx_phy, 1);
+  ASSERT_FALSE(cache.OnDisconnection(kAddress).has_value());
+}
+
+TEST(LeReconnectParameterCacheTest, removed_devices_are_forgotten) {
+  LeReconnectParameterCache cache;
+  cache.OnPhyUpdate(kAddress, 2, 2);
+  cache.Remove(kAddress);
+  ASSERT_FALSE(cache.Get(kAddress).has_value());
+  ASSERT_FALSE(cache.OnDisconnection(kAddress).has_value());
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/link_parameter_manager.h"
+
+#include <base/strings/stringprintf.h>
+
+#include <algorithm>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+std::string LinkProfileText(LinkProfile profile) {
+  switch (profile) {
+    case LinkProfile::IDLE:
+      return "IDLE";
+    case LinkProfile::BULK_THROUGHPUT:
+      return "BULK_THROUGHPUT";
+    case LinkProfile::LOW_LATENCY:
+      return "LOW_LATENCY";
+    case LinkProfile::AUDIO:
+      return "AUDIO";
+  }
+  return base::StringPrintf("UNKNOWN[%hhu]", static_cast<uint8_t>(profile));
+}
+
+bool LinkParameters::operator==(const LinkParameters& other) const {
+  return interval_min == other.interval_min && interval_max == other.interval_max && latency == other.latency &&
+         supervision_timeout == other.supervision_timeout && prefer_2m_phy == other.prefer_2m_phy &&
+         max_data_length == other.max_data_length;
+}
+
+std::string LinkParameters::ToString() const {
+  return base::StringPrintf(
+      "interval:0x%04hx-0x%04hx latency:%hu timeout:0x%04hx 2m_phy:%d max_data_length:%d",
+      interval_min,
+      interval_max,
+      latency,
+      supervision_timeout,
+      prefer_2m_phy,
+      max_data_length);
+}
+
+LinkParameters LinkParameterManager::GetProfileParameters(LinkProfile profile) {
+  switch (profile) {
+    case LinkProfile::BULK_THROUGHPUT:
+      // 11.25 ~ 15 ms, with the fastest PHY and the longest PDUs to fill each connection event
+      return {0x0009, 0x000c, 0x0000, 0x01f4, true, true};
+    case LinkProfile::LOW_LATENCY:
+      // 7.5 ~ 11.25 ms, for HID input reports
+      return {0x0006, 0x0009, 0x0000, 0x01f4, false, false};
+    case LinkProfile::AUDIO:
+      // 20 ~ 30 ms for the control traffic next to ISO, on 2M to keep ACL air time short
+      return {0x0010, 0x0018, 0x0000, 0x01f4, true, false};
+    case LinkProfile::IDLE:
+    default:
+      // 30 ~ 50 ms, the parameters LE links are created with
+      return {0x0018, 0x0028, 0x0000, 0x01f4, false, false};
+  }
+}
+
+void LinkParameterManager::AddLink(uint16_t handle) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  LinkState link{};
+  link.handle = handle;
+  link.current = GetProfileParameters(LinkProfile::IDLE);
+  link.auto_upgrade_allowed = true;
+  links_.insert_or_assign(handle, std::move(link));
+}
+
+void LinkParameterManager::RemoveLink(uint16_t handle) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  links_.erase(handle);
+}
+
+std::optional<LinkParameters> LinkParameterManager::Request(
+    uint16_t handle, const std::string& client, LinkProfile profile) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto link = links_.find(handle);
+  if (link == links_.end()) {
+    LOG_WARN("%s asked for %s on unknown handle 0x%04hx", client.c_str(), LinkProfileText(profile).c_str(), handle);
+    return std::nullopt;
+  }
+  link->second.requests[client] = profile;
+  return Update(link->second, client + " requested " + LinkProfileText(profile));
+}
+
+std::optional<LinkParameters> LinkParameterManager::Release(uint16_t handle, const std::string& client) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto link = links_.find(handle);
+  if (link == links_.end() || link->second.requests.erase(client) == 0) {
+    return std::nullopt;
+  }
+  return Update(link->second, client + " released");
+}
+
+std::optional<LinkParameters> LinkParameterManager::GetCurrentParameters(uint16_t handle) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto link = links_.find(handle);
+  if (link == links_.end()) {
+    return std::nullopt;
+  }
+  return link->second.current;
+}
+
+void LinkParameterManager::SetAutoUpgradeAllowed(uint16_t handle, bool allowed) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto link = links_.find(handle);
+  if (link != links_.end()) {
+    link->second.auto_upgrade_allowed = allowed;
+  }
+}
+
+bool LinkParameterManager::OnTrafficSample(
+    uint16_t handle, uint64_t total_bytes, std::chrono::milliseconds period) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto link = links_.find(handle);
+  if (link == links_.end() || period.count() <= 0) {
+    return false;
+  }
+  LinkState& state = link->second;
+  uint64_t bytes = total_bytes >= state.last_total_bytes ? total_bytes - state.last_total_bytes : 0;
+  state.last_total_bytes = total_bytes;
+  state.bytes_per_second = static_cast<uint32_t>(std::min<uint64_t>(bytes * 1000 / period.count(), UINT32_MAX));
+
+  if (state.auto_upgraded || !state.auto_upgrade_allowed) {
+    return false;
+  }
+  if (state.current.prefer_2m_phy && state.current.max_data_length) {
+    // Already there on request
+    state.auto_upgraded = true;
+    return false;
+  }
+  if (state.bytes_per_second >= kBulkTrafficEnterBytesPerSecond) {
+    state.busy_samples++;
+  } else if (state.bytes_per_second < kBulkTrafficExitBytesPerSecond) {
+    state.busy_samples = 0;
+  }
+  if (state.busy_samples < kBulkTrafficSamples) {
+    return false;
+  }
+
+  state.auto_upgraded = true;
+  LinkParameters parameters = state.current;
+  parameters.prefer_2m_phy = true;
+  parameters.max_data_length = true;
+  RecordDecision(state, base::StringPrintf("bulk traffic at %u B/s", state.bytes_per_second), parameters);
+  return true;
+}
+
+std::vector<LinkParameterManager::LinkState> LinkParameterManager::GetLinkStates() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::vector<LinkState> states;
+  for (const auto& [handle, link] : links_) {
+    states.push_back(link);
+  }
+  return states;
+}
+
+LinkParameters LinkParameterManager::Arbitrate(const std::map<std::string, LinkProfile>& requests) {
+  if (requests.empty()) {
+    return GetProfileParameters(LinkProfile::IDLE);
+  }
+
+  LinkParameters merged = GetProfileParameters(requests.begin()->second);
+  // Request with the shortest maximum interval, used when the requested ranges do not overlap
+  LinkParameters tightest = merged;
+  for (const auto& [client, profile] : requests) {
+    LinkParameters parameters = GetProfileParameters(profile);
+    merged.interval_min = std::max(merged.interval_min, parameters.interval_min);
+    merged.interval_max = std::min(merged.interval_max, parameters.interval_max);
+    merged.latency = std::min(merged.latency, parameters.latency);
+    merged.supervision_timeout = std::min(merged.supervision_timeout, parameters.supervision_timeout);
+    merged.prefer_2m_phy |= parameters.prefer_2m_phy;
+    merged.max_data_length |= parameters.max_data_length;
+    if (parameters.interval_max < tightest.interval_max) {
+      tightest = parameters;
+    }
+  }
+  if (merged.interval_min > merged.interval_max) {
+    merged.interval_min = tightest.interval_min;
+    merged.interval_max = tightest.interval_max;
+  }
+  return merged;
+}
+
+std::optional<LinkParameters> LinkParameterManager::Update(LinkState& link, std::string reason) {
+  LinkParameters parameters = Arbitrate(link.requests);
+  if (link.auto_upgraded) {
+    // The PHY and data length stay where the traffic based upgrade put them
+    parameters.prefer_2m_phy = true;
+    parameters.max_data_length = true;
+  }
+  if (parameters == link.current) {
+    return std::nullopt;
+  }
+  RecordDecision(link, std::move(reason), parameters);
+  return parameters;
+}
+
+void LinkParameterManager::RecordDecision(LinkState& link, std::string reason, LinkParameters parameters) {
+  LOG_INFO("handle 0x%04hx: %s -> %s", link.handle, reason.c_str(), parameters.ToString().c_str());
+  link.current = parameters;
+  link.decisions.push_back({std::move(reason), parameters});
+  if (link.decisions.size() > kMaxDecisionsPerLink) {
+    link.decisions.pop_front();
+  }
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
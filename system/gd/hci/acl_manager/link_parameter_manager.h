@@ -0,0 +1,134 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Named traffic profiles a client can ask an LE link to be tuned for
+enum class LinkProfile : uint8_t {
+  IDLE = 0,
+  BULK_THROUGHPUT = 1,
+  LOW_LATENCY = 2,
+  AUDIO = 3,
+};
+
+std::string LinkProfileText(LinkProfile profile);
+
+struct LinkParameters {
+  // Connection interval range, in 1.25 ms units
+  uint16_t interval_min;
+  uint16_t interval_max;
+  // Peripheral latency, in connection events
+  uint16_t latency;
+  // Supervision timeout, in 10 ms units
+  uint16_t supervision_timeout;
+  // Ask for the LE 2M PHY in both directions
+  bool prefer_2m_phy;
+  // Ask for the largest data length the controller supports
+  bool max_data_length;
+
+  bool operator==(const LinkParameters& other) const;
+  std::string ToString() const;
+};
+
+// Arbitrates the connection parameters of LE links between the clients that use them.
+//
+// Each client asks for a profile on a link. The parameters applied to the link satisfy every active request: the
+// interval range is the intersection of the requested ranges, or the tightest one when they do not overlap, the
+// latency and supervision timeout are the smallest requested, and the 2M PHY and maximum data length are asked for
+// as soon as one request wants them. A link without any request goes back to the IDLE parameters.
+//
+// Links that carry sustained traffic are also moved to the 2M PHY and maximum data length without any request, so
+// that throughput does not depend on every client asking for BULK_THROUGHPUT.
+//
+// The manager only computes decisions; le_impl sends the matching HCI commands.
+class LinkParameterManager {
+ public:
+  static constexpr size_t kMaxDecisionsPerLink = 8;
+
+  // A link is upgraded once its rate stayed at or above kBulkTrafficEnterBytesPerSecond for kBulkTrafficSamples
+  // samples in a row. Samples below kBulkTrafficExitBytesPerSecond restart the count, samples in between keep it.
+  static constexpr uint32_t kBulkTrafficEnterBytesPerSecond = 16 * 1024;
+  static constexpr uint32_t kBulkTrafficExitBytesPerSecond = 4 * 1024;
+  static constexpr uint8_t kBulkTrafficSamples = 3;
+
+  struct Decision {
+    std::string reason;
+    LinkParameters parameters;
+  };
+
+  struct LinkState {
+    uint16_t handle;
+    std::map<std::string, LinkProfile> requests;
+    LinkParameters current;
+    std::deque<Decision> decisions;
+    // Traffic based upgrade to the 2M PHY and maximum data length
+    bool auto_upgrade_allowed;
+    bool auto_upgraded;
+    uint64_t last_total_bytes;
+    uint32_t bytes_per_second;
+    uint8_t busy_samples;
+  };
+
+  static LinkParameters GetProfileParameters(LinkProfile profile);
+
+  void AddLink(uint16_t handle);
+  void RemoveLink(uint16_t handle);
+
+  // Records that |client| wants |profile| on |handle|, replacing its previous request on that link.
+  // Returns the parameters to apply when they change, nothing otherwise or when the link is unknown.
+  std::optional<LinkParameters> Request(uint16_t handle, const std::string& client, LinkProfile profile);
+
+  // Drops the request of |client| on |handle|. Returns the parameters to apply when they change.
+  std::optional<LinkParameters> Release(uint16_t handle, const std::string& client);
+
+  std::optional<LinkParameters> GetCurrentParameters(uint16_t handle) const;
+
+  // Devices known to misbehave after a PHY or data length change are kept out of the traffic based upgrade
+  void SetAutoUpgradeAllowed(uint16_t handle, bool allowed);
+
+  // Feeds the total bytes |handle| carried in both directions, sampled every |period|. Returns true once, when the
+  // link has been busy long enough to be moved to the 2M PHY and maximum data length.
+  bool OnTrafficSample(uint16_t handle, uint64_t total_bytes, std::chrono::milliseconds period);
+
+  // Snapshot of every link, for dumpsys
+  std::vector<LinkState> GetLinkStates() const;
+
+ private:
+  static LinkParameters Arbitrate(const std::map<std::string, LinkProfile>& requests);
+  std::optional<LinkParameters> Update(LinkState& link, std::string reason);
+  static void RecordDecision(LinkState& link, std::string reason, LinkParameters parameters);
+
+  mutable std::mutex mutex_;
+  std::map<uint16_t, LinkState> links_;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/link_parameter_manager.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+constexpr uint16_t kHandle = 0x0040;
+
+class LinkParameterManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    manager_.AddLink(kHandle);
+  }
+
+  LinkParameterManager manager_;
+};
+
+TEST_F(LinkParameterManagerTest, unknown_link_is_ignored) {
+  ASSERT_FALSE(manager_.Request(0x0123, "gatt", LinkProfile::BULK_THROUGHPUT).has_value());
+  ASSERT_FALSE(manager_.GetCurrentParameters(0x0123).has_value());
+}
+
+TEST_F(LinkParameterManagerTest, single_request_applies_profile) {
+  auto parameters = manager_.Request(kHandle, "gatt", LinkProfile::BULK_THROUGHPUT);
+  ASSERT_TRUE(parameters.has_value());
+  ASSERT_EQ(*parameters, LinkParameterManager::GetProfileParameters(LinkProfile::BULK_THROUGHPUT));
+  ASSERT_TRUE(parameters->prefer_2m_phy);
+  ASSERT_TRUE(parameters->max_data_length);
+
+  // Asking again for the same profile changes nothing
+  ASSERT_FALSE(manager_.Request(kHandle, "gatt", LinkProfile::BULK_THROUGHPUT).has_value());
+}
+
+TEST_F(LinkParameterManagerTest, release_reverts_to_idle) {
+  manager_.Request(kHandle, "gatt", LinkProfile::BULK_THROUGHPUT);
+  auto parameters = manager_.Release(kHandle, "gatt");
+  ASSERT_TRUE(parameters.has_value());
+  ASSERT_EQ(*parameters, LinkParameterManager::GetProfileParameters(LinkProfile::IDLE));
+
+  // Releasing twice is a no-op
+  ASSERT_FALSE(manager_.Release(kHandle, "gatt").has_value());
+}
+
+TEST_F(LinkParameterManagerTest, requests_are_merged) {
+  manager_.Request(kHandle, "gatt", LinkProfile::BULK_THROUGHPUT);
+  auto parameters = manager_.Request(kHandle, "hid", LinkProfile::LOW_LATENCY);
+  ASSERT_TRUE(parameters.has_value());
+
+  // Overlapping interval ranges are intersected, PHY and data length follow the bulk request
+  ASSERT_EQ(parameters->interval_min, 0x0009);
+  ASSERT_EQ(parameters->interval_max, 0x0009);
+  ASSERT_TRUE(parameters->prefer_2m_phy);
+  ASSERT_TRUE(parameters->max_data_length);
+
+  parameters = manager_.Release(kHandle, "gatt");
+  ASSERT_TRUE(parameters.has_value());
+  ASSERT_EQ(*parameters, LinkParameterManager::GetProfileParameters(LinkProfile::LOW_LATENCY));
+}
+
+TEST_F(LinkParameterManagerTest, disjoint_ranges_use_tightest) {
+  manager_.Request(kHandle, "le_audio", LinkProfile::AUDIO);
+  auto parameters = manager_.Request(kHandle, "hid", LinkProfile::LOW_LATENCY);
+  ASSERT_TRUE(parameters.has_value());
+  auto low_latency = LinkParameterManager::GetProfileParameters(LinkProfile::LOW_LATENCY);
+  ASSERT_EQ(parameters->interval_min, low_latency.interval_min);
+  ASSERT_EQ(parameters->interval_max, low_latency.interval_max);
+  // The audio request still wants the 2M PHY
+  ASSERT_TRUE(parameters->prefer_2m_phy);
+}
+
+TEST_F(LinkParameterManagerTest, decisions_are_bounded) {
+  for (size_t i = 0; i < 2 * LinkParameterManager::kMaxDecisionsPerLink; i++) {
+    manager_.Request(kHandle, "gatt", LinkProfile::BULK_THROUGHPUT);
+    manager_.Release(kHandle, "gatt");
+  }
+  auto states = manager_.GetLinkStates();
+  ASSERT_EQ(states.size(), 1u);
+  ASSERT_EQ(states[0].decisions.size(), LinkParameterManager::kMaxDecisionsPerLink);
+  ASSERT_EQ(states[0].decisions.back().reason, "gatt released");
+  ASSERT_TRUE(states[0].requests.empty());
+
+  manager_.RemoveLink(kHandle);
+  ASSERT_TRUE(manager_.GetLinkStates().empty());
+}
+
+TEST_F(LinkParameterManagerTest, sustained_traffic_upgrades_once) {
+  constexpr std::chrono::milliseconds kPeriod(1000);
+  constexpr uint64_t kBusy = LinkParameterManager::kBulkTrafficEnterBytesPerSecond;
+  uint64_t total = 0;
+  for (uint8_t i = 1; i < LinkParameterManager::kBulkTrafficSamples; i++) {
+    total += kBusy;
+    ASSERT_FALSE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+  }
+  total += kBusy;
+  ASSERT_TRUE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+  auto current = manager_.GetCurrentParameters(kHandle);
+  ASSERT_TRUE(current->prefer_2m_phy);
+  ASSERT_TRUE(current->max_data_length);
+
+  total += kBusy;
+  ASSERT_FALSE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+
+  // Releasing a request keeps the upgraded PHY and data length
+  manager_.Request(kHandle, "hid", LinkProfile::LOW_LATENCY);
+  auto parameters = manager_.Release(kHandle, "hid");
+  ASSERT_TRUE(parameters.has_value());
+  ASSERT_TRUE(parameters->prefer_2m_phy);
+  ASSERT_TRUE(parameters->max_data_length);
+}
+
+TEST_F(LinkParameterManagerTest, traffic_hysteresis) {
+  constexpr std::chrono::milliseconds kPeriod(1000);
+  constexpr uint64_t kBusy = LinkParameterManager::kBulkTrafficEnterBytesPerSecond;
+  constexpr uint64_t kModerate = LinkParameterManager::kBulkTrafficExitBytesPerSecond;
+  constexpr uint64_t kQuiet = kModerate - 1;
+  uint64_t total = 0;
+
+  // A quiet sample restarts the count
+  for (uint8_t i = 1; i < LinkParameterManager::kBulkTrafficSamples; i++) {
+    total += kBusy;
+    ASSERT_FALSE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+  }
+  total += kQuiet;
+  ASSERT_FALSE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+  total += kBusy;
+  ASSERT_FALSE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+
+  // A moderate sample keeps it
+  for (uint8_t i = 2; i < LinkParameterManager::kBulkTrafficSamples; i++) {
+    total += kBusy;
+    ASSERT_FALSE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+  }
+  total += kModerate;
+  ASSERT_FALSE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+  total += kBusy;
+  ASSERT_TRUE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+}
+
+TEST_F(LinkParameterManagerTest, blocked_link_is_not_upgraded) {
+  constexpr std::chrono::milliseconds kPeriod(1000);
+  manager_.SetAutoUpgradeAllowed(kHandle, false);
+  uint64_t total = 0;
+  for (uint8_t i = 0; i < 2 * LinkParameterManager::kBulkTrafficSamples; i++) {
+    total += LinkParameterManager::kBulkTrafficEnterBytesPerSecond;
+    ASSERT_FALSE(manager_.OnTrafficSample(kHandle, total, kPeriod));
+  }
+  ASSERT_FALSE(manager_.GetCurrentParameters(kHandle)->prefer_2m_phy);
+  ASSERT_EQ(manager_.GetLinkStates()[0].bytes_per_second, LinkParameterManager::kBulkTrafficEnterBytesPerSecond);
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
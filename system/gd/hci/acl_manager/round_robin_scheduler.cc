@@ -15,15 +15,20 @@
  */
 
 #include "hci/acl_manager/round_robin_scheduler.h"
-#include "hci/acl_manager/acl_fragmenter.h"
+
+#include <algorithm>
 
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
 RoundRobinScheduler::RoundRobinScheduler(
-    os::Handler* handler, Controller* controller, common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end)
-    : handler_(handler), controller_(controller), hci_queue_end_(hci_queue_end) {
+    os::Handler* handler,
+    Controller* controller,
+    common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end,
+    std::unique_ptr<SchedulingPolicy> policy)
+    : handler_(handler), controller_(controller), policy_(std::move(policy)), hci_queue_end_(hci_queue_end) {
+  ASSERT(policy_ != nullptr);
   max_acl_packet_credits_ = controller_->GetNumAclPacketBuffers();
   acl_packet_credits_ = max_acl_packet_credits_;
   hci_mtu_ = controller_->GetAclPacketLength();
@@ -32,9 +37,14 @@ RoundRobinScheduler::RoundRobinScheduler(
   le_acl_packet_credits_ = le_max_acl_packet_credits_;
   le_hci_mtu_ = le_buffer_size.le_data_packet_length_;
   controller_->RegisterCompletedAclPacketsCallback(handler->BindOn(this, &RoundRobinScheduler::incoming_acl_credits));
+  credit_monitor_alarm_ = std::make_unique<os::RepeatingAlarm>(handler_, /* wake_up */ false);
+  credit_monitor_alarm_->Schedule(
+      common::Bind(&RoundRobinScheduler::CheckCredits, common::Unretained(this)),
+      std::chrono::duration_cast<std::chrono::milliseconds>(kCreditMonitorInterval));
 }
 
 RoundRobinScheduler::~RoundRobinScheduler() {
+  credit_monitor_alarm_->Cancel();
   unregister_all_connections();
   controller_->UnregisterCompletedAclPacketsCallback();
 }
@@ -42,8 +52,15 @@ RoundRobinScheduler::~RoundRobinScheduler() {
 void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t handle,
                                    std::shared_ptr<acl_manager::AclConnection::Queue> queue) {
   ASSERT(acl_queue_handlers_.count(handle) == 0);
-  acl_queue_handler acl_queue_handler = {connection_type, std::move(queue), false, 0};
-  acl_queue_handlers_.insert(std::pair<uint16_t, RoundRobinScheduler::acl_queue_handler>(handle, acl_queue_handler));
+  acl_queue_handler acl_queue_handler;
+  acl_queue_handler.connection_type_ = connection_type;
+  acl_queue_handler.queue_ = std::move(queue);
+  acl_queue_handler.traffic_counters_ =
+      common::TrafficTelemetry::Register(common::TrafficChannelType::ACL, handle, 0);
+  {
+    std::lock_guard<std::mutex> lock(link_stats_mutex_);
+    acl_queue_handlers_.emplace(handle, std::move(acl_queue_handler));
+  }
   if (fragments_to_send_.size() == 0) {
     start_round_robin();
   }
@@ -51,7 +68,7 @@ void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t hand
 
 void RoundRobinScheduler::Unregister(uint16_t handle) {
   ASSERT(acl_queue_handlers_.count(handle) == 1);
-  auto acl_queue_handler = acl_queue_handlers_.find(handle)->second;
+  auto& acl_queue_handler = acl_queue_handlers_.find(handle)->second;
   // Reclaim outstanding packets
   if (acl_queue_handler.connection_type_ == ConnectionType::CLASSIC) {
     acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
@@ -64,8 +81,10 @@ void RoundRobinScheduler::Unregister(uint16_t handle) {
     acl_queue_handler.dequeue_is_registered_ = false;
     acl_queue_handler.queue_->GetDownEnd()->UnregisterDequeue();
   }
+  common::TrafficTelemetry::Unregister(acl_queue_handler.traffic_counters_);
+  std::lock_guard<std::mutex> lock(link_stats_mutex_);
+  policy_->RemoveLink(handle);
   acl_queue_handlers_.erase(handle);
-  starting_point_ = acl_queue_handlers_.begin();
 }
 
 void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
@@ -74,9 +93,49 @@ void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
     LOG_WARN("handle %d is invalid", handle);
     return;
   }
+  std::lock_guard<std::mutex> lock(link_stats_mutex_);
   acl_queue_handler->second.high_priority_ = high_priority;
 }
 
+void RoundRobinScheduler::SetLinkWeight(uint16_t handle, uint16_t weight) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  if (weight == 0) {
+    LOG_WARN("Ignoring weight 0 for handle %d", handle);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(link_stats_mutex_);
+  acl_queue_handler->second.weight_ = weight;
+}
+
+void RoundRobinScheduler::SetLinkCreditReservation(uint16_t handle, uint16_t credits) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  ConnectionType connection_type = acl_queue_handler->second.connection_type_;
+  uint16_t max_credits =
+      connection_type == ConnectionType::CLASSIC ? max_acl_packet_credits_ : le_max_acl_packet_credits_;
+  uint16_t reserved_by_others = 0;
+  for (const auto& [other_handle, other] : acl_queue_handlers_) {
+    if (other_handle != handle && other.connection_type_ == connection_type) {
+      reserved_by_others += other.reserved_credits_;
+    }
+  }
+  // Always leave one buffer that every link can use
+  uint16_t available = max_credits > reserved_by_others + 1 ? max_credits - reserved_by_others - 1 : 0;
+  if (credits > available) {
+    LOG_WARN("Only %hu of %hu credits can be reserved for handle %d", available, credits, handle);
+    credits = available;
+  }
+  std::lock_guard<std::mutex> lock(link_stats_mutex_);
+  acl_queue_handler->second.reserved_credits_ = credits;
+}
+
 uint16_t RoundRobinScheduler::GetCredits() {
   return acl_packet_credits_;
 }
@@ -85,10 +144,159 @@ uint16_t RoundRobinScheduler::GetLeCredits() {
   return le_acl_packet_credits_;
 }
 
-void RoundRobinScheduler::start_round_robin() {
-  if (acl_packet_credits_ == 0 && le_acl_packet_credits_ == 0) {
+uint16_t RoundRobinScheduler::GetMaxCredits() const {
+  return max_acl_packet_credits_;
+}
+
+uint16_t RoundRobinScheduler::GetLeMaxCredits() const {
+  return le_max_acl_packet_credits_;
+}
+
+const char* RoundRobinScheduler::GetPolicyName() const {
+  return policy_->GetName();
+}
+
+std::vector<RoundRobinScheduler::LinkStats> RoundRobinScheduler::GetLinkStats() const {
+  std::lock_guard<std::mutex> lock(link_stats_mutex_);
+  std::vector<LinkStats> link_stats;
+  for (const auto& [handle, acl_queue_handler] : acl_queue_handlers_) {
+    link_stats.push_back(
+        {handle,
+         acl_queue_handler.connection_type_,
+         acl_queue_handler.weight_,
+         acl_queue_handler.high_priority_,
+         acl_queue_handler.reserved_credits_,
+         acl_queue_handler.number_of_sent_packets_,
+         policy_->GetDeficit(handle),
+         acl_queue_handler.total_sent_packets_,
+         acl_queue_handler.total_sent_fragments_,
+         acl_queue_handler.total_sent_bytes_});
+  }
+  return link_stats;
+}
+
+std::vector<RoundRobinScheduler::CreditSample> RoundRobinScheduler::GetCreditHistory() const {
+  std::lock_guard<std::mutex> lock(link_stats_mutex_);
+  return std::vector<CreditSample>(credit_history_.begin(), credit_history_.end());
+}
+
+RoundRobinScheduler::CreditMonitorStats RoundRobinScheduler::GetCreditMonitorStats() const {
+  std::lock_guard<std::mutex> lock(link_stats_mutex_);
+  return {
+      acl_credit_monitor_.stalls_,
+      le_acl_credit_monitor_.stalls_,
+      acl_credit_monitor_.reclaimed_credits_,
+      le_acl_credit_monitor_.reclaimed_credits_};
+}
+
+void RoundRobinScheduler::CheckCredits() {
+  auto now = std::chrono::steady_clock::now();
+  check_credits(ConnectionType::CLASSIC, now);
+  check_credits(ConnectionType::LE, now);
+
+  std::lock_guard<std::mutex> lock(link_stats_mutex_);
+  credit_history_.push_back(
+      {now,
+       static_cast<uint16_t>(buffers_in_use(ConnectionType::CLASSIC)),
+       static_cast<uint16_t>(buffers_in_use(ConnectionType::LE)),
+       acl_credit_monitor_.completed_since_sample_,
+       le_acl_credit_monitor_.completed_since_sample_});
+  acl_credit_monitor_.completed_since_sample_ = 0;
+  le_acl_credit_monitor_.completed_since_sample_ = 0;
+  if (credit_history_.size() > kCreditHistorySize) {
+    credit_history_.pop_front();
+  }
+}
+
+RoundRobinScheduler::credit_monitor& RoundRobinScheduler::get_credit_monitor(ConnectionType connection_type) {
+  return connection_type == ConnectionType::CLASSIC ? acl_credit_monitor_ : le_acl_credit_monitor_;
+}
+
+int RoundRobinScheduler::buffers_in_use(ConnectionType connection_type) const {
+  // The credits of a link that left with fragments still unsent are returned early, and may exceed the maximum
+  int in_use = connection_type == ConnectionType::CLASSIC ? max_acl_packet_credits_ - acl_packet_credits_
+                                                          : le_max_acl_packet_credits_ - le_acl_packet_credits_;
+  return std::max(0, in_use);
+}
+
+void RoundRobinScheduler::check_credits(ConnectionType connection_type, std::chrono::steady_clock::time_point now) {
+  auto& monitor = get_credit_monitor(connection_type);
+  const char* name = connection_type == ConnectionType::CLASSIC ? "ACL" : "LE ACL";
+  uint16_t& credits = connection_type == ConnectionType::CLASSIC ? acl_packet_credits_ : le_acl_packet_credits_;
+  uint16_t max_credits =
+      connection_type == ConnectionType::CLASSIC ? max_acl_packet_credits_ : le_max_acl_packet_credits_;
+
+  // Every buffer the controller holds was sent by a registered link, which gets its credit back with Number Of
+  // Completed Packets or when it is unregistered
+  int outstanding = 0;
+  for (const auto& [handle, acl_queue_handler] : acl_queue_handlers_) {
+    if (acl_queue_handler.connection_type_ == connection_type) {
+      outstanding += acl_queue_handler.number_of_sent_packets_;
+    }
+  }
+  int leaked = max_credits - credits - outstanding + monitor.unsent_fragments_;
+  if (leaked > 0) {
+    LOG_ERROR("%d %s credits are not accounted for by any link, reclaiming them", leaked, name);
+    dump_credit_state(connection_type);
+    credits += leaked;
+    {
+      std::lock_guard<std::mutex> lock(link_stats_mutex_);
+      monitor.reclaimed_credits_ += leaked;
+    }
+    start_round_robin();
+  }
+
+  int in_use = buffers_in_use(connection_type);
+  if (in_use == 0) {
+    monitor.last_completed_ = now;
+    monitor.stalled_ = false;
     return;
   }
+  auto stalled_for = now - monitor.last_completed_;
+  if (!monitor.stalled_ && stalled_for >= kCreditStallTimeout) {
+    LOG_WARN(
+        "No %s credits returned for %lld ms with %d of %hu controller buffers in use",
+        name,
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(stalled_for).count()),
+        in_use,
+        max_credits);
+    dump_credit_state(connection_type);
+    monitor.stalled_ = true;
+    std::lock_guard<std::mutex> lock(link_stats_mutex_);
+    monitor.stalls_++;
+  }
+}
+
+void RoundRobinScheduler::dump_credit_state(ConnectionType connection_type) const {
+  bool is_classic = connection_type == ConnectionType::CLASSIC;
+  const auto& monitor = is_classic ? acl_credit_monitor_ : le_acl_credit_monitor_;
+  LOG_WARN(
+      "%s credits:%hu max:%hu unsent_fragments:%hu fragments_to_send:%zu enqueue_registered:%d",
+      is_classic ? "ACL" : "LE ACL",
+      is_classic ? acl_packet_credits_ : le_acl_packet_credits_,
+      is_classic ? max_acl_packet_credits_ : le_max_acl_packet_credits_,
+      monitor.unsent_fragments_,
+      fragments_to_send_.size(),
+      enqueue_registered_.load());
+  for (const auto& [handle, acl_queue_handler] : acl_queue_handlers_) {
+    if (acl_queue_handler.connection_type_ != connection_type) {
+      continue;
+    }
+    LOG_WARN(
+        "  handle:0x%04hx outstanding:%hu reserved:%hu weight:%hu high_priority:%d pending_packet:%d "
+        "dequeue_registered:%d sent_fragments:%llu",
+        handle,
+        acl_queue_handler.number_of_sent_packets_,
+        acl_queue_handler.reserved_credits_,
+        acl_queue_handler.weight_,
+        acl_queue_handler.high_priority_,
+        acl_queue_handler.pending_packet_ != nullptr,
+        acl_queue_handler.dequeue_is_registered_,
+        static_cast<unsigned long long>(acl_queue_handler.total_sent_fragments_));
+  }
+}
+
+void RoundRobinScheduler::start_round_robin() {
   if (!fragments_to_send_.empty()) {
     auto connection_type = fragments_to_send_.front().first;
     bool classic_buffer_full = acl_packet_credits_ == 0 && connection_type == ConnectionType::CLASSIC;
@@ -105,44 +313,78 @@ void RoundRobinScheduler::start_round_robin() {
     return;
   }
 
-  if (acl_queue_handlers_.size() == 1 || starting_point_ == acl_queue_handlers_.end()) {
-    starting_point_ = acl_queue_handlers_.begin();
+  std::vector<SchedulingPolicy::Candidate> candidates;
+  for (const auto& [handle, acl_queue_handler] : acl_queue_handlers_) {
+    if (acl_queue_handler.pending_packet_ == nullptr || usable_credits(handle, acl_queue_handler) == 0) {
+      continue;
+    }
+    size_t mtu = acl_queue_handler.connection_type_ == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
+    size_t cost = std::max<size_t>(1, (acl_queue_handler.pending_packet_->size() + mtu - 1) / mtu);
+    uint16_t weight = acl_queue_handler.weight_;
+    if (acl_queue_handler.high_priority_) {
+      weight = std::max(weight, kHighPriorityLinkWeight);
+    }
+    candidates.push_back({handle, weight, cost});
   }
-  size_t count = acl_queue_handlers_.size();
-
-  for (auto acl_queue_handler = starting_point_; count > 0; count--) {
-    // Prevent registration when credits is zero
-    bool classic_buffer_full =
-        acl_packet_credits_ == 0 && acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC;
-    bool le_buffer_full =
-        le_acl_packet_credits_ == 0 && acl_queue_handler->second.connection_type_ == ConnectionType::LE;
-    if (!acl_queue_handler->second.dequeue_is_registered_ && !classic_buffer_full && !le_buffer_full) {
-      acl_queue_handler->second.dequeue_is_registered_ = true;
-      uint16_t acl_handle = acl_queue_handler->first;
-      acl_queue_handler->second.queue_->GetDownEnd()->RegisterDequeue(
-          handler_, common::Bind(&RoundRobinScheduler::buffer_packet, common::Unretained(this), acl_handle));
+  if (!candidates.empty()) {
+    uint16_t handle;
+    {
+      std::lock_guard<std::mutex> lock(link_stats_mutex_);
+      handle = policy_->SelectNext(candidates);
     }
-    acl_queue_handler = std::next(acl_queue_handler);
-    if (acl_queue_handler == acl_queue_handlers_.end()) {
-      acl_queue_handler = acl_queue_handlers_.begin();
+    send_pending_packet(handle);
+  }
+
+  // Keep the next packet of every link at hand, so that the policy can choose among all links with data
+  for (auto& [handle, acl_queue_handler] : acl_queue_handlers_) {
+    if (acl_queue_handler.pending_packet_ == nullptr && !acl_queue_handler.dequeue_is_registered_) {
+      acl_queue_handler.dequeue_is_registered_ = true;
+      acl_queue_handler.queue_->GetDownEnd()->RegisterDequeue(
+          handler_, common::Bind(&RoundRobinScheduler::buffer_packet, common::Unretained(this), handle));
     }
   }
+}
 
-  starting_point_ = std::next(starting_point_);
+uint16_t RoundRobinScheduler::usable_credits(uint16_t acl_handle, const acl_queue_handler& handler) const {
+  uint16_t credits = handler.connection_type_ == ConnectionType::CLASSIC ? acl_packet_credits_ : le_acl_packet_credits_;
+  uint16_t reserved_by_others = 0;
+  for (const auto& [handle, other] : acl_queue_handlers_) {
+    if (handle != acl_handle && other.connection_type_ == handler.connection_type_ &&
+        other.reserved_credits_ > other.number_of_sent_packets_) {
+      reserved_by_others += other.reserved_credits_ - other.number_of_sent_packets_;
+    }
+  }
+  return credits > reserved_by_others ? credits - reserved_by_others : 0;
 }
 
 void RoundRobinScheduler::buffer_packet(uint16_t acl_handle) {
-  BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
   auto acl_queue_handler = acl_queue_handlers_.find(acl_handle);
   if( acl_queue_handler == acl_queue_handlers_.end()) {
     LOG_ERROR("Ignore since ACL connection vanished with handle: 0x%X", acl_handle);
     return;
   }
 
+  acl_queue_handler->second.pending_packet_ = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
+  ASSERT(acl_queue_handler->second.pending_packet_ != nullptr);
+  acl_queue_handler->second.dequeue_is_registered_ = false;
+  acl_queue_handler->second.queue_->GetDownEnd()->UnregisterDequeue();
+
+  if (fragments_to_send_.empty()) {
+    start_round_robin();
+  }
+}
+
+void RoundRobinScheduler::send_pending_packet(uint16_t acl_handle) {
+  BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
+  auto acl_queue_handler = acl_queue_handlers_.find(acl_handle);
+  ASSERT(acl_queue_handler != acl_queue_handlers_.end());
+
   // Wrap packet and enqueue it
   uint16_t handle = acl_queue_handler->first;
-  auto packet = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
+  auto packet = std::move(acl_queue_handler->second.pending_packet_);
   ASSERT(packet != nullptr);
+  // Pick up the next packet of the link right away, so that it can keep its turn without a trip through the reactor
+  acl_queue_handler->second.pending_packet_ = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
 
   ConnectionType connection_type = acl_queue_handler->second.connection_type_;
   size_t mtu = connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
@@ -150,30 +392,53 @@ void RoundRobinScheduler::buffer_packet(uint16_t acl_handle) {
                                                 ? PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE
                                                 : PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE;
 
-  int acl_priority = acl_queue_handler->second.high_priority_ ? 1 : 0;
-  if (packet->size() <= mtu) {
-    fragments_to_send_.push(
-        std::make_pair(
-            connection_type, AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))),
-        acl_priority);
+  size_t num_fragments = 1;
+  size_t packet_size = packet->size();
+  if (packet_size <= mtu) {
+    fragments_to_send_.push(std::make_pair(
+        connection_type, AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))));
   } else {
-    auto fragments = AclFragmenter(mtu, std::move(packet)).GetFragments();
-    for (size_t i = 0; i < fragments.size(); i++) {
-      fragments_to_send_.push(
-          std::make_pair(
-              connection_type,
-              AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i]))),
-          acl_priority);
-      packet_boundary_flag = PacketBoundaryFlag::CONTINUING_FRAGMENT;
-    }
+    // The continuing fragments are built one at a time when the HCI queue takes the previous one
+    fragmenter_ = std::make_unique<AclFragmenter>(mtu, std::move(packet));
+    fragmenting_handle_ = handle;
+    fragmenting_connection_type_ = connection_type;
+    num_fragments = fragmenter_->GetNumFragments();
+    fragments_to_send_.push(std::make_pair(
+        connection_type,
+        AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, fragmenter_->GetNextFragment())));
   }
-  ASSERT(fragments_to_send_.size() > 0);
-  unregister_all_connections();
 
-  acl_queue_handler->second.number_of_sent_packets_ += fragments_to_send_.size();
+  {
+    std::lock_guard<std::mutex> lock(link_stats_mutex_);
+    acl_queue_handler->second.number_of_sent_packets_ += num_fragments;
+    acl_queue_handler->second.total_sent_packets_++;
+    acl_queue_handler->second.total_sent_fragments_ += num_fragments;
+    acl_queue_handler->second.total_sent_bytes_ += packet_size;
+  }
+  get_credit_monitor(connection_type).unsent_fragments_ += num_fragments;
+  acl_queue_handler->second.traffic_counters_->OnSent(packet_size);
+  acl_queue_handler->second.traffic_counters_->SetOutstandingCredits(
+      acl_queue_handler->second.number_of_sent_packets_);
   send_next_fragment();
 }
 
+void RoundRobinScheduler::push_next_fragment() {
+  if (fragmenter_ == nullptr) {
+    return;
+  }
+  if (!fragmenter_->HasNextFragment()) {
+    fragmenter_.reset();
+    return;
+  }
+  fragments_to_send_.push(std::make_pair(
+      fragmenting_connection_type_,
+      AclBuilder::Create(
+          fragmenting_handle_,
+          PacketBoundaryFlag::CONTINUING_FRAGMENT,
+          BroadcastFlag::POINT_TO_POINT,
+          fragmenter_->GetNextFragment())));
+}
+
 void RoundRobinScheduler::unregister_all_connections() {
   for (auto acl_queue_handler = acl_queue_handlers_.begin(); acl_queue_handler != acl_queue_handlers_.end();
        acl_queue_handler = std::next(acl_queue_handler)) {
@@ -181,6 +446,8 @@ void RoundRobinScheduler::unregister_all_connections() {
       acl_queue_handler->second.dequeue_is_registered_ = false;
       acl_queue_handler->second.queue_->GetDownEnd()->UnregisterDequeue();
     }
+    common::TrafficTelemetry::Unregister(acl_queue_handler->second.traffic_counters_);
+    acl_queue_handler->second.traffic_counters_ = nullptr;
   }
 }
 
@@ -201,9 +468,11 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
     ASSERT(le_acl_packet_credits_ > 0);
     le_acl_packet_credits_ -= 1;
   }
+  get_credit_monitor(connection_type).unsent_fragments_--;
 
   auto raw_pointer = fragments_to_send_.front().second.release();
   fragments_to_send_.pop();
+  push_next_fragment();
   if (fragments_to_send_.empty()) {
     if (enqueue_registered_.exchange(false)) {
       hci_queue_end_->UnregisterEnqueue();
@@ -226,11 +495,24 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
     return;
   }
 
-  if (acl_queue_handler->second.number_of_sent_packets_ >= credits) {
-    acl_queue_handler->second.number_of_sent_packets_ -= credits;
-  } else {
-    LOG_WARN("receive more credits than we sent");
-    acl_queue_handler->second.number_of_sent_packets_ = 0;
+  {
+    std::lock_guard<std::mutex> lock(link_stats_mutex_);
+    if (acl_queue_handler->second.number_of_sent_packets_ >= credits) {
+      acl_queue_handler->second.number_of_sent_packets_ -= credits;
+    } else {
+      LOG_WARN("receive more credits than we sent");
+      acl_queue_handler->second.number_of_sent_packets_ = 0;
+    }
+  }
+  acl_queue_handler->second.traffic_counters_->SetOutstandingCredits(
+      acl_queue_handler->second.number_of_sent_packets_);
+
+  auto& monitor = get_credit_monitor(acl_queue_handler->second.connection_type_);
+  monitor.last_completed_ = std::chrono::steady_clock::now();
+  monitor.completed_since_sample_ += credits;
+  if (monitor.stalled_) {
+    LOG_INFO("Credits returned after a stall");
+    monitor.stalled_ = false;
   }
 
   bool credit_was_zero = false;
@@ -253,7 +535,8 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
       LOG_WARN("le acl packet credits overflow due to receive %hx credits", credits);
     }
   }
-  if (credit_was_zero) {
+  // Returned credits may also release buffers reserved for this link to the other links
+  if (credit_was_zero || fragments_to_send_.empty()) {
     start_round_robin();
   }
 }
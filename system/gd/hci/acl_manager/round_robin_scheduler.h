@@ -18,12 +18,22 @@
 
 #include <stdint.h>
 
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
 #include "common/bidi_queue.h"
-#include "common/multi_priority_queue.h"
+#include "common/traffic_telemetry.h"
 #include "hci/acl_manager.h"
+#include "hci/acl_manager/acl_fragmenter.h"
+#include "hci/acl_manager/scheduling_policy.h"
 #include "hci/controller.h"
 #include "hci/hci_packets.h"
 #include "os/handler.h"
+#include "os/repeating_alarm.h"
 
 namespace bluetooth {
 namespace hci {
@@ -32,48 +42,142 @@ namespace acl_manager {
 class RoundRobinScheduler {
  public:
   RoundRobinScheduler(
-      os::Handler* handler, Controller* controller, common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end);
+      os::Handler* handler,
+      Controller* controller,
+      common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end,
+      std::unique_ptr<SchedulingPolicy> policy = std::make_unique<DeficitRoundRobinPolicy>());
   ~RoundRobinScheduler();
 
   enum ConnectionType { CLASSIC, LE };
 
+  // Weight given to high priority links (A2dp), unless a larger one is set with SetLinkWeight()
+  static constexpr uint16_t kHighPriorityLinkWeight = 8;
+  // The controller buffers are checked for stalls and leaked credits at this interval
+  static constexpr std::chrono::seconds kCreditMonitorInterval{1};
+  // Controller buffers in use without any Number Of Completed Packets for this long are reported as a stall
+  static constexpr std::chrono::seconds kCreditStallTimeout{10};
+  // Samples of the controller buffer occupancy kept for dumpsys, one per kCreditMonitorInterval
+  static constexpr size_t kCreditHistorySize = 60;
+
   struct acl_queue_handler {
     ConnectionType connection_type_;
     std::shared_ptr<acl_manager::AclConnection::Queue> queue_;
     bool dequeue_is_registered_ = false;
     uint16_t number_of_sent_packets_ = 0;  // Track credits
     bool high_priority_ = false;           // For A2dp use
+    uint16_t weight_ = 1;
+    uint16_t reserved_credits_ = 0;
+    // Next packet of the link, held until the policy picks it
+    std::unique_ptr<packet::BasePacketBuilder> pending_packet_;
+    uint64_t total_sent_packets_ = 0;
+    uint64_t total_sent_fragments_ = 0;
+    uint64_t total_sent_bytes_ = 0;
+    common::TrafficCounters* traffic_counters_ = nullptr;
+  };
+
+  struct LinkStats {
+    uint16_t handle;
+    ConnectionType connection_type;
+    uint16_t weight;
+    bool high_priority;
+    uint16_t reserved_credits;
+    uint16_t outstanding_credits;
+    size_t deficit;
+    uint64_t sent_packets;
+    uint64_t sent_fragments;
+    uint64_t sent_bytes;
+  };
+
+  // Controller buffer occupancy when the credit monitor checked
+  struct CreditSample {
+    std::chrono::steady_clock::time_point timestamp;
+    uint16_t acl_in_use;
+    uint16_t le_acl_in_use;
+    // Credits returned by Number Of Completed Packets since the previous sample
+    uint32_t acl_completed;
+    uint32_t le_acl_completed;
+  };
+
+  struct CreditMonitorStats {
+    uint32_t acl_stalls;
+    uint32_t le_acl_stalls;
+    uint32_t acl_reclaimed_credits;
+    uint32_t le_acl_reclaimed_credits;
   };
 
   void Register(ConnectionType connection_type, uint16_t handle,
                 std::shared_ptr<acl_manager::AclConnection::Queue> queue);
   void Unregister(uint16_t handle);
   void SetLinkPriority(uint16_t handle, bool high_priority);
+  // Share of the controller buffers the link gets when several links have data to send
+  void SetLinkWeight(uint16_t handle, uint16_t weight);
+  // Controller buffers kept available for the link, other links can't use them while it has fewer in flight
+  void SetLinkCreditReservation(uint16_t handle, uint16_t credits);
   uint16_t GetCredits();
   uint16_t GetLeCredits();
+  uint16_t GetMaxCredits() const;
+  uint16_t GetLeMaxCredits() const;
+  const char* GetPolicyName() const;
+
+  // Thread safe, for dumpsys
+  std::vector<LinkStats> GetLinkStats() const;
+  std::vector<CreditSample> GetCreditHistory() const;
+  CreditMonitorStats GetCreditMonitorStats() const;
+
+  // Check the controller buffers for stalls and leaked credits, done by the scheduler every kCreditMonitorInterval.
+  // Credits that no link accounts for are reclaimed.
+  void CheckCredits();
 
  private:
   void start_round_robin();
   void buffer_packet(uint16_t acl_handle);
+  void send_pending_packet(uint16_t acl_handle);
+  void push_next_fragment();
+  uint16_t usable_credits(uint16_t acl_handle, const acl_queue_handler& handler) const;
   void unregister_all_connections();
   void send_next_fragment();
   std::unique_ptr<AclBuilder> handle_enqueue_next_fragment();
   void incoming_acl_credits(uint16_t handle, uint16_t credits);
 
+  struct credit_monitor {
+    // Fragments counted as sent by their link that the HCI queue did not take yet, they still hold no credit
+    uint16_t unsent_fragments_ = 0;
+    std::chrono::steady_clock::time_point last_completed_;
+    uint32_t completed_since_sample_ = 0;
+    bool stalled_ = false;
+    uint32_t stalls_ = 0;
+    uint32_t reclaimed_credits_ = 0;
+  };
+
+  credit_monitor& get_credit_monitor(ConnectionType connection_type);
+  int buffers_in_use(ConnectionType connection_type) const;
+  void check_credits(ConnectionType connection_type, std::chrono::steady_clock::time_point now);
+  void dump_credit_state(ConnectionType connection_type) const;
+
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
+  std::unique_ptr<SchedulingPolicy> policy_;
   std::map<uint16_t, acl_queue_handler> acl_queue_handlers_;
-  common::MultiPriorityQueue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
+  // Guards the link bookkeeping read by GetLinkStats()
+  mutable std::mutex link_stats_mutex_;
+  std::queue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>> fragments_to_send_;
+  // Packet larger than the controller buffers, whose fragments remain to be queued in fragments_to_send_
+  std::unique_ptr<AclFragmenter> fragmenter_;
+  uint16_t fragmenting_handle_ = 0;
+  ConnectionType fragmenting_connection_type_ = ConnectionType::CLASSIC;
   uint16_t max_acl_packet_credits_ = 0;
   uint16_t acl_packet_credits_ = 0;
   uint16_t le_max_acl_packet_credits_ = 0;
   uint16_t le_acl_packet_credits_ = 0;
   size_t hci_mtu_{0};
   size_t le_hci_mtu_{0};
+  credit_monitor acl_credit_monitor_;
+  credit_monitor le_acl_credit_monitor_;
+  // Guarded by link_stats_mutex_
+  std::deque<CreditSample> credit_history_;
+  std::unique_ptr<os::RepeatingAlarm> credit_monitor_alarm_;
   std::atomic_bool enqueue_registered_ = false;
   common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end_ = nullptr;
-  // first register queue end for the Round-robin schedule
-  std::map<uint16_t, acl_queue_handler>::iterator starting_point_;
 };
 
 }  // namespace acl_manager
@@ -412,6 +412,166 @@ TEST_F(RoundRobinSchedulerTest, receive_le_credit_when_next_fragment_is_classic)
   round_robin_scheduler_->Unregister(le_handle);
 }
 
+TEST_F(RoundRobinSchedulerTest, weighted_links_share_credits) {
+  uint16_t handle1 = 0x01;
+  uint16_t handle2 = 0x02;
+  uint16_t handle3 = 0x03;
+  auto connection_queue1 = std::make_shared<AclConnection::Queue>(10);
+  auto connection_queue2 = std::make_shared<AclConnection::Queue>(10);
+  auto connection_queue3 = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle1, connection_queue1);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle2, connection_queue2);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle3, connection_queue3);
+  round_robin_scheduler_->SetLinkWeight(handle1, 3);
+
+  // Use all credits so that both links have data queued when they come back
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(controller_->max_acl_packet_credits_));
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+    EnqueueAclUpEnd(connection_queue3->GetUpEnd(), {0x03, i});
+  }
+  packet_future_->wait();
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+    VerifyPacket(handle3, {0x03, i});
+  }
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 0);
+
+  for (uint8_t i = 0; i < 4; i++) {
+    EnqueueAclUpEnd(connection_queue1->GetUpEnd(), {0x01, i});
+    EnqueueAclUpEnd(connection_queue2->GetUpEnd(), {0x02, i});
+  }
+  enqueue_future_->wait();
+  sync_handler();
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(8));
+  controller_->SendCompletedAclPacketsCallback(handle3, 8);
+  packet_future_->wait();
+  VerifyPacket(handle1, {0x01, 0});
+  VerifyPacket(handle1, {0x01, 1});
+  VerifyPacket(handle1, {0x01, 2});
+  VerifyPacket(handle2, {0x02, 0});
+  VerifyPacket(handle1, {0x01, 3});
+  VerifyPacket(handle2, {0x02, 1});
+  VerifyPacket(handle2, {0x02, 2});
+  VerifyPacket(handle2, {0x02, 3});
+
+  auto link_stats = round_robin_scheduler_->GetLinkStats();
+  ASSERT_EQ(link_stats.size(), 3u);
+  EXPECT_EQ(link_stats[0].weight, 3);
+  EXPECT_EQ(link_stats[0].sent_packets, 4u);
+  EXPECT_EQ(link_stats[0].sent_bytes, 4u * 2);
+  EXPECT_EQ(link_stats[0].outstanding_credits, 4);
+  EXPECT_EQ(link_stats[2].sent_fragments, controller_->max_acl_packet_credits_);
+  EXPECT_EQ(link_stats[2].outstanding_credits, controller_->max_acl_packet_credits_ - 8);
+
+  round_robin_scheduler_->Unregister(handle1);
+  round_robin_scheduler_->Unregister(handle2);
+  round_robin_scheduler_->Unregister(handle3);
+}
+
+TEST_F(RoundRobinSchedulerTest, reserved_credits_are_not_used_by_other_links) {
+  uint16_t handle1 = 0x01;
+  uint16_t handle2 = 0x02;
+  uint16_t reserved_credits = 3;
+  auto connection_queue1 = std::make_shared<AclConnection::Queue>(15);
+  auto connection_queue2 = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle1, connection_queue1);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle2, connection_queue2);
+  round_robin_scheduler_->SetLinkCreditReservation(handle2, reserved_credits);
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(controller_->max_acl_packet_credits_ - reserved_credits));
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+    EnqueueAclUpEnd(connection_queue1->GetUpEnd(), {0x01, i});
+  }
+  packet_future_->wait();
+  enqueue_future_->wait();
+  sync_handler();
+  ASSERT_EQ(sent_acl_packets_.size(), (size_t)(controller_->max_acl_packet_credits_ - reserved_credits));
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), reserved_credits);
+
+  // The reserved credits are still available to the link they are reserved for
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(1));
+  EnqueueAclUpEnd(connection_queue2->GetUpEnd(), {0x02, 0});
+  packet_future_->wait();
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_ - reserved_credits; i++) {
+    VerifyPacket(handle1, {0x01, i});
+  }
+  VerifyPacket(handle2, {0x02, 0});
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), reserved_credits - 1);
+
+  // Returning credits of the first link lets it send again
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(reserved_credits));
+  controller_->SendCompletedAclPacketsCallback(handle1, reserved_credits);
+  packet_future_->wait();
+  for (uint8_t i = controller_->max_acl_packet_credits_ - reserved_credits; i < controller_->max_acl_packet_credits_;
+       i++) {
+    VerifyPacket(handle1, {0x01, i});
+  }
+
+  round_robin_scheduler_->Unregister(handle1);
+  round_robin_scheduler_->Unregister(handle2);
+}
+
+TEST_F(RoundRobinSchedulerTest, credit_history_tracks_buffers_in_use) {
+  uint16_t handle = 0x01;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(2));
+  EnqueueAclUpEnd(connection_queue->GetUpEnd(), {0x01, 0x02});
+  EnqueueAclUpEnd(connection_queue->GetUpEnd(), {0x03, 0x04});
+  packet_future_->wait();
+  handler_->Post(common::BindOnce(&RoundRobinScheduler::CheckCredits, common::Unretained(round_robin_scheduler_)));
+  sync_handler();
+
+  controller_->SendCompletedAclPacketsCallback(handle, 2);
+  handler_->Post(common::BindOnce(&RoundRobinScheduler::CheckCredits, common::Unretained(round_robin_scheduler_)));
+  sync_handler();
+
+  auto history = round_robin_scheduler_->GetCreditHistory();
+  ASSERT_EQ(history.size(), 2u);
+  ASSERT_EQ(history[0].acl_in_use, 2);
+  ASSERT_EQ(history[1].acl_in_use, 0);
+  ASSERT_EQ(history[1].acl_completed, 2u);
+  ASSERT_EQ(round_robin_scheduler_->GetCreditMonitorStats().acl_reclaimed_credits, 0u);
+
+  round_robin_scheduler_->Unregister(handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, leaked_credits_are_reclaimed) {
+  uint16_t handle1 = 0x01;
+  uint16_t handle2 = 0x02;
+  auto connection_queue1 = std::make_shared<AclConnection::Queue>(10);
+  auto connection_queue2 = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle1, connection_queue1);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle2, connection_queue2);
+
+  // The HCI queue takes 3 of the 5 fragments
+  hci_queue_.GetDownEnd()->UnregisterDequeue();
+  EnqueueAclUpEnd(connection_queue1->GetUpEnd(), std::vector<uint8_t>(controller_->hci_mtu_ * 5, 0x01));
+  enqueue_future_->wait();
+  sync_handler();
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), controller_->max_acl_packet_credits_ - 3);
+
+  // The credits of the unsent fragments are returned with the link, then lost when spurious credits overflow
+  round_robin_scheduler_->Unregister(handle1);
+  controller_->SendCompletedAclPacketsCallback(handle2, 1);
+  sync_handler();
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), controller_->max_acl_packet_credits_);
+
+  handler_->Post(common::BindOnce(&RoundRobinScheduler::CheckCredits, common::Unretained(round_robin_scheduler_)));
+  sync_handler();
+  ASSERT_EQ(round_robin_scheduler_->GetCreditMonitorStats().acl_reclaimed_credits, 2u);
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(5));
+  hci_queue_.GetDownEnd()->RegisterDequeue(
+      handler_, common::Bind(&RoundRobinSchedulerTest::HciDownEndDequeue, common::Unretained(this)));
+  packet_future_->wait();
+  sync_handler();
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), controller_->max_acl_packet_credits_);
+
+  round_robin_scheduler_->Unregister(handle2);
+}
+
 }  // namespace
 }  // namespace acl_manager
 }  // namespace hci
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/scheduling_policy.h"
+
+#include <algorithm>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+DeficitRoundRobinPolicy::DeficitRoundRobinPolicy(size_t quantum) : quantum_(quantum) {
+  ASSERT(quantum_ > 0);
+}
+
+const char* DeficitRoundRobinPolicy::GetName() const {
+  return "DeficitRoundRobin";
+}
+
+uint16_t DeficitRoundRobinPolicy::SelectNext(const std::vector<Candidate>& candidates) {
+  ASSERT(!candidates.empty());
+  auto by_handle = [](const Candidate& candidate, uint16_t handle) { return candidate.handle < handle; };
+
+  // A link with nothing to send loses its deficit, so that an idle link can't save up for a burst
+  for (auto it = deficits_.begin(); it != deficits_.end();) {
+    auto candidate = std::lower_bound(candidates.begin(), candidates.end(), it->first, by_handle);
+    if (candidate == candidates.end() || candidate->handle != it->first) {
+      it = deficits_.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  size_t index = 0;
+  if (current_.has_value()) {
+    auto candidate = std::lower_bound(candidates.begin(), candidates.end(), *current_, by_handle);
+    index = candidate - candidates.begin();
+    if (candidate != candidates.end() && candidate->handle == *current_) {
+      size_t& deficit = deficits_[candidate->handle];
+      if (deficit >= candidate->cost) {
+        deficit -= candidate->cost;
+        return candidate->handle;
+      }
+      index++;
+    }
+  }
+
+  // Deficits grow on every visit, so this terminates once the cheapest packet is covered
+  while (true) {
+    const Candidate& candidate = candidates[index % candidates.size()];
+    size_t& deficit = deficits_[candidate.handle];
+    deficit += quantum_ * std::max<uint16_t>(candidate.weight, 1);
+    if (deficit >= candidate.cost) {
+      deficit -= candidate.cost;
+      current_ = candidate.handle;
+      return candidate.handle;
+    }
+    index++;
+  }
+}
+
+void DeficitRoundRobinPolicy::RemoveLink(uint16_t handle) {
+  deficits_.erase(handle);
+  if (current_ == handle) {
+    current_.reset();
+  }
+}
+
+size_t DeficitRoundRobinPolicy::GetDeficit(uint16_t handle) const {
+  auto deficit = deficits_.find(handle);
+  return deficit == deficits_.end() ? 0 : deficit->second;
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
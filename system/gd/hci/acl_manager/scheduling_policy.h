@@ -0,0 +1,77 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Decides which ACL connection gets to hand its next packet to the controller.
+class SchedulingPolicy {
+ public:
+  struct Candidate {
+    uint16_t handle;
+    uint16_t weight;
+    // Number of controller buffers (fragments) the queued packet needs
+    size_t cost;
+  };
+
+  virtual ~SchedulingPolicy() = default;
+
+  virtual const char* GetName() const = 0;
+
+  // |candidates| holds every link with a packet ready to send, sorted by handle, and is never empty.
+  // Returns the handle of the link to serve; its packet is sent right away.
+  virtual uint16_t SelectNext(const std::vector<Candidate>& candidates) = 0;
+
+  virtual void RemoveLink(uint16_t handle) = 0;
+
+  // Buffers |handle| has accumulated towards its next packet, for dumpsys
+  virtual size_t GetDeficit(uint16_t handle) const = 0;
+};
+
+// Deficit round robin: every visit adds |quantum| * weight to the link's deficit and the link keeps the turn as
+// long as its deficit covers the cost of its next packet. Cost is counted in controller buffers, so links share
+// the buffer pool in proportion of their weights regardless of their packet sizes. With a quantum of one and
+// equal weights this is a plain round robin over fragments.
+class DeficitRoundRobinPolicy : public SchedulingPolicy {
+ public:
+  static constexpr size_t kDefaultQuantum = 1;
+
+  explicit DeficitRoundRobinPolicy(size_t quantum = kDefaultQuantum);
+
+  const char* GetName() const override;
+  uint16_t SelectNext(const std::vector<Candidate>& candidates) override;
+  void RemoveLink(uint16_t handle) override;
+  size_t GetDeficit(uint16_t handle) const override;
+
+ private:
+  size_t quantum_;
+  std::map<uint16_t, size_t> deficits_;
+  // Link holding the turn
+  std::optional<uint16_t> current_;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
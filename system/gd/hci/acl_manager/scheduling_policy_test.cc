@@ -0,0 +1,88 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/scheduling_policy.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+using Candidate = SchedulingPolicy::Candidate;
+
+class DeficitRoundRobinPolicyTest : public ::testing::Test {
+ protected:
+  // Run |rounds| selections with the same set of backlogged links and count the buffers each link got
+  std::map<uint16_t, size_t> Run(const std::vector<Candidate>& candidates, size_t rounds) {
+    std::map<uint16_t, size_t> buffers;
+    for (size_t i = 0; i < rounds; i++) {
+      uint16_t handle = policy_.SelectNext(candidates);
+      for (const auto& candidate : candidates) {
+        if (candidate.handle == handle) {
+          buffers[handle] += candidate.cost;
+        }
+      }
+      selected_.push_back(handle);
+    }
+    return buffers;
+  }
+
+  DeficitRoundRobinPolicy policy_;
+  std::vector<uint16_t> selected_;
+};
+
+TEST_F(DeficitRoundRobinPolicyTest, equal_weights_alternate) {
+  Run({{0x01, 1, 1}, {0x02, 1, 1}, {0x03, 1, 1}}, 6);
+  EXPECT_EQ(std::vector<uint16_t>({0x01, 0x02, 0x03, 0x01, 0x02, 0x03}), selected_);
+}
+
+TEST_F(DeficitRoundRobinPolicyTest, weights_share_buffers) {
+  auto buffers = Run({{0x01, 3, 1}, {0x02, 1, 1}}, 400);
+  EXPECT_EQ(300u, buffers[0x01]);
+  EXPECT_EQ(100u, buffers[0x02]);
+  selected_.resize(4);
+  EXPECT_EQ(std::vector<uint16_t>({0x01, 0x01, 0x01, 0x02}), selected_);
+}
+
+TEST_F(DeficitRoundRobinPolicyTest, large_packets_do_not_get_more_buffers) {
+  // 0x01 sends 5-fragment packets, 0x02 single fragment packets
+  auto buffers = Run({{0x01, 1, 5}, {0x02, 1, 1}}, 120);
+  EXPECT_EQ(buffers[0x01], buffers[0x02]);
+}
+
+TEST_F(DeficitRoundRobinPolicyTest, idle_link_loses_deficit) {
+  policy_.SelectNext({{0x01, 1, 4}, {0x02, 1, 1}});
+  EXPECT_GT(policy_.GetDeficit(0x01), 0u);
+  policy_.SelectNext({{0x02, 1, 1}});
+  EXPECT_EQ(0u, policy_.GetDeficit(0x01));
+}
+
+TEST_F(DeficitRoundRobinPolicyTest, removed_link_is_skipped) {
+  policy_.SelectNext({{0x01, 2, 1}, {0x02, 1, 1}});
+  policy_.RemoveLink(0x01);
+  EXPECT_EQ(0u, policy_.GetDeficit(0x01));
+  EXPECT_EQ(0x02, policy_.SelectNext({{0x02, 1, 1}, {0x03, 1, 1}}));
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
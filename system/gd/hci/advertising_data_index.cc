@@ -0,0 +1,150 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/advertising_data_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace bluetooth::hci {
+
+void AdvertisingDataIndex::Build(const uint8_t* data, size_t size) {
+  data_ = data;
+  structures_.clear();
+  types_.reset();
+  complete_ = true;
+
+  size_t position = 0;
+  while (position < size) {
+    uint8_t length = data[position];
+
+    // Zero padding ends the advertising data.
+    if (length == 0) {
+      break;
+    }
+
+    // The structure overflows the advertising data, or can't be indexed.
+    if (position + length >= size || position + 2 > std::numeric_limits<uint16_t>::max()) {
+      complete_ = false;
+      break;
+    }
+
+    uint8_t type = data[position + 1];
+    structures_.push_back(Structure{type, static_cast<uint8_t>(length - 1), static_cast<uint16_t>(position + 2)});
+    types_.set(type);
+    position += length + 1;
+  }
+}
+
+void AdvertisingDataMatcher::Compile(const std::vector<AdvertisingDataPattern>& patterns) {
+  patterns_.clear();
+  positions_.resize(patterns.size());
+
+  for (PatternId id = 0; id < patterns.size(); id++) {
+    const AdvertisingDataPattern& pattern = patterns[id];
+    CompiledPattern compiled;
+    compiled.id = id;
+    compiled.type = pattern.type;
+    compiled.size = static_cast<uint8_t>(std::min<size_t>(pattern.value.size(), std::numeric_limits<uint8_t>::max()));
+    compiled.element_size = pattern.element_size;
+
+    // Pack the masked value and the mask in words, so that they compare with
+    // values loaded the same way regardless of the host endianness.
+    std::vector<uint8_t> value(((compiled.size + kWordSize - 1) / kWordSize) * kWordSize, 0);
+    std::vector<uint8_t> mask(value.size(), 0);
+    for (size_t i = 0; i < compiled.size; i++) {
+      mask[i] = i < pattern.mask.size() ? pattern.mask[i] : 0xff;
+      value[i] = pattern.value[i] & mask[i];
+    }
+    compiled.value.resize(value.size() / kWordSize);
+    compiled.mask.resize(mask.size() / kWordSize);
+    std::memcpy(compiled.value.data(), value.data(), value.size());
+    std::memcpy(compiled.mask.data(), mask.data(), mask.size());
+    patterns_.push_back(std::move(compiled));
+  }
+
+  std::stable_sort(patterns_.begin(), patterns_.end(), [](const CompiledPattern& a, const CompiledPattern& b) {
+    return a.type < b.type;
+  });
+
+  size_t position = 0;
+  for (size_t type = 0; type < first_pattern_.size(); type++) {
+    while (position < patterns_.size() && patterns_[position].type < type) {
+      position++;
+    }
+    first_pattern_[type] = position;
+  }
+  for (size_t i = 0; i < patterns_.size(); i++) {
+    positions_[patterns_[i].id] = i;
+  }
+}
+
+void AdvertisingDataMatcher::Match(const AdvertisingDataIndex& index, std::vector<bool>& matches) const {
+  matches.assign(positions_.size(), false);
+  for (const auto& structure : index.GetStructures()) {
+    const uint8_t* value = index.GetValue(structure);
+    for (size_t position = first_pattern_[structure.type]; position < first_pattern_[structure.type + 1];
+         position++) {
+      const CompiledPattern& pattern = patterns_[position];
+      if (!matches[pattern.id] && MatchesStructure(pattern, value, structure.length)) {
+        matches[pattern.id] = true;
+      }
+    }
+  }
+}
+
+bool AdvertisingDataMatcher::Matches(const AdvertisingDataIndex& index, PatternId id) const {
+  const CompiledPattern& pattern = patterns_[positions_[id]];
+  if (!index.Contains(pattern.type)) {
+    return false;
+  }
+  for (const auto& structure : index.GetStructures()) {
+    if (structure.type == pattern.type && MatchesStructure(pattern, index.GetValue(structure), structure.length)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AdvertisingDataMatcher::MatchesValue(const CompiledPattern& pattern, const uint8_t* value, size_t size) {
+  if (size < pattern.size) {
+    return false;
+  }
+  for (size_t word = 0; word < pattern.value.size(); word++) {
+    // Only the pattern bytes are loaded, the value may end within the last word.
+    uint64_t loaded = 0;
+    std::memcpy(&loaded, value + word * kWordSize, std::min(kWordSize, pattern.size - word * kWordSize));
+    if ((loaded & pattern.mask[word]) != pattern.value[word]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AdvertisingDataMatcher::MatchesStructure(const CompiledPattern& pattern, const uint8_t* value, size_t size) {
+  if (pattern.element_size == 0) {
+    return MatchesValue(pattern, value, size);
+  }
+  for (size_t offset = 0; offset + pattern.element_size <= size; offset += pattern.element_size) {
+    if (MatchesValue(pattern, value + offset, pattern.element_size)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bluetooth::hci
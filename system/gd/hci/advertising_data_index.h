@@ -0,0 +1,142 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace bluetooth::hci {
+
+/// Offset table of the AD structures (Core 5.4 Vol 3 Part C 11) of one
+/// advertising payload. The payload is decoded once, after which the
+/// structures of a given AD type can be looked up without walking the
+/// length-type-value layout again.
+/// The index doesn't own the payload, which must outlive it. Build() can be
+/// called repeatedly on the same index to reuse its storage.
+class AdvertisingDataIndex {
+ public:
+  struct Structure {
+    uint8_t type;
+    uint8_t length;   // Length of the value, the type byte excluded.
+    uint16_t offset;  // Offset of the value in the payload.
+  };
+
+  AdvertisingDataIndex() = default;
+  AdvertisingDataIndex(const uint8_t* data, size_t size) {
+    Build(data, size);
+  }
+  explicit AdvertisingDataIndex(const std::vector<uint8_t>& data) : AdvertisingDataIndex(data.data(), data.size()) {}
+
+  /// Index |data|. Zero padding ends the payload, and a structure
+  /// overflowing the payload is not indexed.
+  void Build(const uint8_t* data, size_t size);
+  void Build(const std::vector<uint8_t>& data) {
+    Build(data.data(), data.size());
+  }
+
+  /// Returns true if the whole payload was indexed, false if it ended with
+  /// an overflowing structure.
+  bool IsComplete() const {
+    return complete_;
+  }
+
+  bool Contains(uint8_t type) const {
+    return types_.test(type);
+  }
+
+  const std::vector<Structure>& GetStructures() const {
+    return structures_;
+  }
+
+  const uint8_t* GetValue(const Structure& structure) const {
+    return data_ + structure.offset;
+  }
+
+ private:
+  const uint8_t* data_{nullptr};
+  std::vector<Structure> structures_;
+  std::bitset<256> types_;
+  bool complete_{true};
+};
+
+/// Value pattern matched against the AD structures of one AD type.
+/// The structure matches if its value starts with |value| once both are
+/// masked with |mask|; an empty mask compares all the bytes.
+/// With a non zero |element_size| the structure is a list of elements of that
+/// size (e.g. a list of 16 bit service UUIDs), and the pattern is compared
+/// against every element instead.
+struct AdvertisingDataPattern {
+  uint8_t type;
+  std::vector<uint8_t> value;
+  std::vector<uint8_t> mask;
+  uint8_t element_size{0};
+};
+
+/// Matches many advertising data patterns against an indexed payload at
+/// once. Patterns are grouped by AD type when compiled, so each structure
+/// of the payload is only visited once, and are compared eight bytes at a
+/// time.
+class AdvertisingDataMatcher {
+ public:
+  /// Index of a pattern, in the order given to Compile().
+  using PatternId = size_t;
+
+  AdvertisingDataMatcher() = default;
+  explicit AdvertisingDataMatcher(const std::vector<AdvertisingDataPattern>& patterns) {
+    Compile(patterns);
+  }
+
+  /// Replace the patterns of the matcher.
+  void Compile(const std::vector<AdvertisingDataPattern>& patterns);
+
+  size_t GetPatternCount() const {
+    return positions_.size();
+  }
+
+  /// Set |matches|[id] for every pattern matched by |index|. |matches| is
+  /// resized to the pattern count and cleared first.
+  void Match(const AdvertisingDataIndex& index, std::vector<bool>& matches) const;
+
+  /// Returns true if the pattern |id| is matched by |index|.
+  bool Matches(const AdvertisingDataIndex& index, PatternId id) const;
+
+ private:
+  static constexpr size_t kWordSize = sizeof(uint64_t);
+
+  struct CompiledPattern {
+    PatternId id;
+    uint8_t type;
+    uint8_t size;  // Number of compared bytes.
+    uint8_t element_size;
+    // Masked value and mask, padded with zeros to whole words.
+    std::vector<uint64_t> value;
+    std::vector<uint64_t> mask;
+  };
+
+  static bool MatchesValue(const CompiledPattern& pattern, const uint8_t* value, size_t size);
+  static bool MatchesStructure(const CompiledPattern& pattern, const uint8_t* value, size_t size);
+
+  // Position of the first compiled pattern of each AD type in |patterns_|,
+  // with the patterns sorted by type.
+  std::array<uint32_t, 257> first_pattern_{};
+  std::vector<CompiledPattern> patterns_;
+  // Position of each pattern in |patterns_|, by id.
+  std::vector<size_t> positions_;
+};
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/advertising_data_index.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace bluetooth::hci {
+
+// AD types.
+static constexpr uint8_t kFlags = 0x01;
+static constexpr uint8_t kCompleteList16BitUuids = 0x03;
+static constexpr uint8_t kCompleteLocalName = 0x09;
+static constexpr uint8_t kServiceData16BitUuid = 0x16;
+static constexpr uint8_t kManufacturerSpecificData = 0xff;
+
+static const std::vector<uint8_t> kAdvertisingData = {
+    0x02, kFlags, 0x06,                                                       // Flags
+    0x05, kCompleteList16BitUuids, 0x0d, 0x18, 0x0f, 0x18,                    // Heart rate, battery
+    0x05, kCompleteLocalName, 't', 'e', 's', 't',                             // Name
+    0x0c, kManufacturerSpecificData, 0xe0, 0x00, 1, 2, 3, 4, 5, 6, 7, 8, 9,  // Google, 9 bytes
+    0x04, kServiceData16BitUuid, 0x6f, 0xfd, 0x42,                            // Exposure notification
+};
+
+TEST(AdvertisingDataIndexTest, index_structures) {
+  AdvertisingDataIndex index(kAdvertisingData);
+  ASSERT_TRUE(index.IsComplete());
+  ASSERT_EQ(5u, index.GetStructures().size());
+  ASSERT_TRUE(index.Contains(kCompleteLocalName));
+  ASSERT_FALSE(index.Contains(0x08));
+
+  auto name = index.GetStructures()[2];
+  ASSERT_EQ(kCompleteLocalName, name.type);
+  ASSERT_EQ(4, name.length);
+  ASSERT_EQ(0, std::memcmp("test", index.GetValue(name), name.length));
+}
+
+TEST(AdvertisingDataIndexTest, zero_padding_and_overflow) {
+  std::vector<uint8_t> padded = {0x02, kFlags, 0x06, 0x00, 0x00};
+  AdvertisingDataIndex index(padded);
+  ASSERT_TRUE(index.IsComplete());
+  ASSERT_EQ(1u, index.GetStructures().size());
+
+  std::vector<uint8_t> overflowing = {0x02, kFlags, 0x06, 0x05, kCompleteLocalName, 't'};
+  index.Build(overflowing);
+  ASSERT_FALSE(index.IsComplete());
+  ASSERT_EQ(1u, index.GetStructures().size());
+  ASSERT_FALSE(index.Contains(kCompleteLocalName));
+}
+
+TEST(AdvertisingDataIndexTest, match_many_patterns) {
+  AdvertisingDataMatcher matcher({
+      {kCompleteList16BitUuids, {0x0f, 0x18}, {}, 2},                          // 0: battery service
+      {kCompleteList16BitUuids, {0x18, 0x0f}, {}, 2},                          // 1: misaligned UUID
+      {kManufacturerSpecificData, {0xe0, 0x00, 1, 2, 3, 4, 5, 6, 7, 8}, {}, 0},  // 2: spans two words
+      {kManufacturerSpecificData, {0xe0, 0x00, 0xf1}, {0xff, 0xff, 0x0f}, 0},  // 3: masked
+      {kManufacturerSpecificData, {0x4c, 0x00}, {}, 0},                        // 4: other company
+      {kServiceData16BitUuid, {0x6f, 0xfd}, {}, 0},                            // 5: service data UUID
+      {kCompleteLocalName, {}, {}, 0},                                         // 6: name present
+      {0x08, {}, {}, 0},                                                       // 7: no short name
+      {kCompleteLocalName, {'t', 'e', 's', 't', 's'}, {}, 0},                  // 8: longer than value
+  });
+  ASSERT_EQ(9u, matcher.GetPatternCount());
+
+  std::vector<bool> matches;
+  matcher.Match(AdvertisingDataIndex(kAdvertisingData), matches);
+  ASSERT_EQ(std::vector<bool>({true, false, true, true, false, true, true, false, false}), matches);
+
+  AdvertisingDataIndex index(kAdvertisingData);
+  for (size_t id = 0; id < matcher.GetPatternCount(); id++) {
+    ASSERT_EQ(matches[id], matcher.Matches(index, id));
+  }
+}
+
+}  // namespace bluetooth::hci
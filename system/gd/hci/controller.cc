@@ -23,9 +23,12 @@
 #include <utility>
 
 #include "common/init_flags.h"
+#include "common/strings.h"
+#include "hci/controller_capability_cache.h"
 #include "hci/hci_layer.h"
 #include "hci_controller_generated.h"
 #include "os/metrics.h"
+#include "os/parameter_provider.h"
 #include "os/system_properties.h"
 #include "sysprops/sysprops_module.h"
 
@@ -39,6 +42,8 @@ static const std::string kPropertyVendorCapabilitiesEnabled =
     "bluetooth.core.le.vendor_capabilities.enabled";
 static const char kPropertyDisabledCommands[] =
     "bluetooth.hci.disabled_commands";
+// Reuse the responses to the reads of capabilities that only change with the firmware
+static const char kPropertyCapabilityCacheEnabled[] = "persist.bluetooth.hci.capability_cache";
 
 using os::Handler;
 
@@ -55,16 +60,37 @@ struct Controller::impl {
     write_le_host_support(Enable::ENABLED, Enable::DISABLED);
     hci_->EnqueueCommand(ReadLocalNameBuilder::Create(),
                          handler->BindOnceOn(this, &Controller::impl::read_local_name_complete_handler));
-    hci_->EnqueueCommand(ReadLocalVersionInformationBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_version_information_complete_handler));
-    hci_->EnqueueCommand(ReadLocalSupportedCommandsBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_supported_commands_complete_handler));
 
-    hci_->EnqueueCommand(
+    std::string capability_cache_path = GetCapabilityCachePath();
+    is_capability_cache_enabled_ = os::GetSystemPropertyBool(kPropertyCapabilityCacheEnabled, false);
+    if (is_capability_cache_enabled_) {
+      // The cached responses are only valid for the firmware that sent them
+      std::promise<void> version_promise;
+      auto version_future = version_promise.get_future();
+      hci_->EnqueueCommand(
+          ReadLocalVersionInformationBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::read_firmware_version_handler, std::move(version_promise)));
+      version_future.wait();
+      cached_capabilities_ = ControllerCapabilityCache::FromPath(capability_cache_path).Read(firmware_version_);
+      LOG_INFO("%zu cached capabilities for firmware %s", cached_capabilities_.size(), firmware_version_.c_str());
+    } else {
+      ControllerCapabilityCache::FromPath(capability_cache_path).Delete();
+      hci_->EnqueueCommand(
+          ReadLocalVersionInformationBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::read_local_version_information_complete_handler));
+    }
+    read_capability(
+        OpCode::READ_LOCAL_SUPPORTED_COMMANDS,
+        ReadLocalSupportedCommandsBuilder::Create(),
+        handler->BindOnceOn(this, &Controller::impl::read_local_supported_commands_complete_handler));
+
+    read_capability(
+        OpCode::LE_READ_LOCAL_SUPPORTED_FEATURES,
         LeReadLocalSupportedFeaturesBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::le_read_local_supported_features_handler));
 
-    hci_->EnqueueCommand(
+    read_capability(
+        OpCode::LE_READ_SUPPORTED_STATES,
         LeReadSupportedStatesBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::le_read_supported_states_handler));
 
@@ -72,15 +98,20 @@ struct Controller::impl {
     std::promise<void> features_promise;
     auto features_future = features_promise.get_future();
 
-    hci_->EnqueueCommand(ReadLocalExtendedFeaturesBuilder::Create(0x00),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
-                                             std::move(features_promise)));
+    read_capability(
+        OpCode::READ_LOCAL_EXTENDED_FEATURES,
+        ReadLocalExtendedFeaturesBuilder::Create(0x00),
+        handler->BindOnceOn(
+            this, &Controller::impl::read_local_extended_features_complete_handler, std::move(features_promise)),
+        0x00);
     features_future.wait();
 
     le_set_event_mask(MaskLeEventMask(local_version_information_.hci_version_, kDefaultLeEventMask));
 
-    hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
+    read_capability(
+        OpCode::READ_BUFFER_SIZE,
+        ReadBufferSizeBuilder::Create(),
+        handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
 
     if (common::init_flags::set_min_encryption_is_enabled() && is_supported(OpCode::SET_MIN_ENCRYPTION_KEY_SIZE)) {
       hci_->EnqueueCommand(
@@ -89,21 +120,25 @@ struct Controller::impl {
     }
 
     if (is_supported(OpCode::LE_READ_BUFFER_SIZE_V2)) {
-      hci_->EnqueueCommand(
+      read_capability(
+          OpCode::LE_READ_BUFFER_SIZE_V2,
           LeReadBufferSizeV2Builder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_buffer_size_v2_handler));
     } else {
-      hci_->EnqueueCommand(
+      read_capability(
+          OpCode::LE_READ_BUFFER_SIZE_V1,
           LeReadBufferSizeV1Builder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_buffer_size_handler));
     }
 
-    hci_->EnqueueCommand(
+    read_capability(
+        OpCode::LE_READ_FILTER_ACCEPT_LIST_SIZE,
         LeReadFilterAcceptListSizeBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::le_read_connect_list_size_handler));
 
     if (is_supported(OpCode::LE_READ_RESOLVING_LIST_SIZE) && module_.SupportsBlePrivacy()) {
-      hci_->EnqueueCommand(
+      read_capability(
+          OpCode::LE_READ_RESOLVING_LIST_SIZE,
           LeReadResolvingListSizeBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_resolving_list_size_handler));
     } else {
@@ -112,8 +147,10 @@ struct Controller::impl {
     }
 
     if (is_supported(OpCode::LE_READ_MAXIMUM_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
-      hci_->EnqueueCommand(LeReadMaximumDataLengthBuilder::Create(),
-                           handler->BindOnceOn(this, &Controller::impl::le_read_maximum_data_length_handler));
+      read_capability(
+          OpCode::LE_READ_MAXIMUM_DATA_LENGTH,
+          LeReadMaximumDataLengthBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::le_read_maximum_data_length_handler));
     } else {
       LOG_INFO("LE_READ_MAXIMUM_DATA_LENGTH not supported, defaulting to 0");
       le_maximum_data_length_.supported_max_rx_octets_ = 0;
@@ -140,7 +177,8 @@ struct Controller::impl {
     }
 
     if (is_supported(OpCode::LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH) && module_.SupportsBleExtendedAdvertising()) {
-      hci_->EnqueueCommand(
+      read_capability(
+          OpCode::LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH,
           LeReadMaximumAdvertisingDataLengthBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_maximum_advertising_data_length_handler));
     } else {
@@ -150,7 +188,8 @@ struct Controller::impl {
 
     if (is_supported(OpCode::LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS) &&
         module_.SupportsBleExtendedAdvertising()) {
-      hci_->EnqueueCommand(
+      read_capability(
+          OpCode::LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS,
           LeReadNumberOfSupportedAdvertisingSetsBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_number_of_supported_advertising_sets_handler));
     } else {
@@ -160,7 +199,8 @@ struct Controller::impl {
 
     if (is_supported(OpCode::LE_READ_PERIODIC_ADVERTISER_LIST_SIZE) &&
         module_.SupportsBlePeriodicAdvertising()) {
-      hci_->EnqueueCommand(
+      read_capability(
+          OpCode::LE_READ_PERIODIC_ADVERTISER_LIST_SIZE,
           LeReadPeriodicAdvertiserListSizeBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_periodic_advertiser_list_size_handler));
     } else {
@@ -191,7 +231,8 @@ struct Controller::impl {
     // Skip vendor capabilities check if configured.
     if (os::GetSystemPropertyBool(
             kPropertyVendorCapabilitiesEnabled, kDefaultVendorCapabilitiesEnabled)) {
-      hci_->EnqueueCommand(
+      read_capability(
+          OpCode::LE_GET_VENDOR_CAPABILITIES,
           LeGetVendorCapabilitiesBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_get_vendor_capabilities_handler));
     } else {
@@ -205,6 +246,74 @@ struct Controller::impl {
         ReadBdAddrBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::read_controller_mac_address_handler, std::move(promise)));
     future.wait();
+
+    // All the other reads completed before the last one
+    if (is_capability_cache_enabled_ && !read_capabilities_.empty()) {
+      read_capabilities_.insert(cached_capabilities_.begin(), cached_capabilities_.end());
+      if (!ControllerCapabilityCache::FromPath(capability_cache_path).Write(firmware_version_, read_capabilities_)) {
+        LOG_WARN("Unable to write the controller capability cache at %s", capability_cache_path.c_str());
+      }
+    }
+    cached_capabilities_.clear();
+    read_capabilities_.clear();
+  }
+
+  static std::string GetCapabilityCachePath() {
+    std::string config_file_path = os::ParameterProvider::ConfigFilePath();
+    return config_file_path.substr(0, config_file_path.find_last_of('.')) + ".controller";
+  }
+
+  // Send a read of a controller capability that does not change until the firmware does. The callback gets the cached
+  // response when there is one for this firmware.
+  void read_capability(
+      OpCode op_code,
+      std::unique_ptr<CommandBuilder> command,
+      common::ContextualOnceCallback<void(CommandCompleteView)> on_complete,
+      std::optional<uint8_t> page_number = std::nullopt) {
+    std::string key = OpCodeText(op_code);
+    if (page_number.has_value()) {
+      key += "_" + std::to_string(*page_number);
+    }
+    auto cached = cached_capabilities_.find(key);
+    if (cached != cached_capabilities_.end()) {
+      on_complete.Invoke(CommandCompleteView::Create(
+          EventView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(cached->second)))));
+      return;
+    }
+    if (!is_capability_cache_enabled_) {
+      hci_->EnqueueCommand(std::move(command), std::move(on_complete));
+      return;
+    }
+    hci_->EnqueueCommand(
+        std::move(command),
+        module_.GetHandler()->BindOnceOn(
+            this, &Controller::impl::read_capability_complete_handler, key, std::move(on_complete)));
+  }
+
+  void read_capability_complete_handler(
+      std::string key,
+      common::ContextualOnceCallback<void(CommandCompleteView)> on_complete,
+      CommandCompleteView view) {
+    // Failed reads are sent again on the next start
+    if (view.IsValid()) {
+      auto payload = view.GetPayload();
+      if (payload.size() > 0 && payload[0] == static_cast<uint8_t>(ErrorCode::SUCCESS)) {
+        read_capabilities_[key] = std::vector<uint8_t>(view.begin(), view.end());
+      }
+    }
+    on_complete.Invoke(std::move(view));
+  }
+
+  void read_firmware_version_handler(std::promise<void> promise, CommandCompleteView view) {
+    read_local_version_information_complete_handler(std::move(view));
+    firmware_version_ = common::StringFormat(
+        "%02hhx.%04hx.%02hhx.%04hx.%04hx",
+        static_cast<uint8_t>(local_version_information_.hci_version_),
+        local_version_information_.hci_revision_,
+        static_cast<uint8_t>(local_version_information_.lmp_version_),
+        local_version_information_.manufacturer_name_,
+        local_version_information_.lmp_subversion_);
+    promise.set_value();
   }
 
   void Stop() {
@@ -323,10 +432,12 @@ struct Controller::impl {
     // Query all extended features
     if (page_number < complete_view.GetMaximumPageNumber()) {
       page_number++;
-      hci_->EnqueueCommand(
+      read_capability(
+          OpCode::READ_LOCAL_EXTENDED_FEATURES,
           ReadLocalExtendedFeaturesBuilder::Create(page_number),
-          module_.GetHandler()->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
-                                           std::move(promise)));
+          module_.GetHandler()->BindOnceOn(
+              this, &Controller::impl::read_local_extended_features_complete_handler, std::move(promise)),
+          page_number);
     } else {
       promise.set_value();
     }
@@ -1084,6 +1195,12 @@ struct Controller::impl {
   uint8_t le_number_supported_advertising_sets_{};
   uint8_t le_periodic_advertiser_list_size_{};
   VendorCapabilities vendor_capabilities_{};
+
+  bool is_capability_cache_enabled_{};
+  std::string firmware_version_{};
+  ControllerCapabilityCache::Responses cached_capabilities_{};
+  // Responses received from the controller during Start(), to update the cache with
+  ControllerCapabilityCache::Responses read_capabilities_{};
 };  // namespace hci
 
 Controller::Controller() : impl_(std::make_unique<impl>(*this)) {}
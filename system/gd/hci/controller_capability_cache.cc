@@ -0,0 +1,108 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/controller_capability_cache.h"
+
+#include "common/strings.h"
+#include "os/files.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+
+constexpr char kFirmwareKey[] = "firmware";
+
+}  // namespace
+
+ControllerCapabilityCache::ControllerCapabilityCache(std::string path) : path_(std::move(path)) {
+  ASSERT(!path_.empty());
+}
+
+ControllerCapabilityCache::Responses ControllerCapabilityCache::Read(const std::string& firmware) {
+  if (!os::FileExists(path_)) {
+    return {};
+  }
+  auto data = os::ReadSmallFile(path_);
+  if (!data) {
+    return {};
+  }
+  auto cache = Deserialize(*data);
+  if (!cache) {
+    LOG_WARN("invalid controller capability cache at %s", path_.c_str());
+    return {};
+  }
+  if (cache->first != firmware) {
+    LOG_INFO("controller capability cache is for firmware %s, not %s", cache->first.c_str(), firmware.c_str());
+    return {};
+  }
+  return std::move(cache->second);
+}
+
+bool ControllerCapabilityCache::Write(const std::string& firmware, const Responses& responses) {
+  return os::WriteToFile(path_, Serialize(firmware, responses));
+}
+
+bool ControllerCapabilityCache::Delete() {
+  if (!os::FileExists(path_)) {
+    return false;
+  }
+  return os::RemoveFile(path_);
+}
+
+std::string ControllerCapabilityCache::Serialize(const std::string& firmware, const Responses& responses) {
+  std::string serialized = std::string(kFirmwareKey) + "=" + firmware + "\n";
+  for (const auto& response : responses) {
+    serialized += response.first + "=" + common::ToHexString(response.second) + "\n";
+  }
+  return serialized;
+}
+
+std::optional<std::pair<std::string, ControllerCapabilityCache::Responses>> ControllerCapabilityCache::Deserialize(
+    const std::string& data) {
+  std::optional<std::string> firmware;
+  Responses responses;
+  for (const auto& line : common::StringSplit(data, "\n")) {
+    if (line.empty()) {
+      continue;
+    }
+    auto tokens = common::StringSplit(line, "=", 2);
+    if (tokens.size() != 2 || tokens[0].empty()) {
+      return std::nullopt;
+    }
+    if (!firmware) {
+      // The firmware comes first
+      if (tokens[0] != kFirmwareKey) {
+        return std::nullopt;
+      }
+      firmware = tokens[1];
+      continue;
+    }
+    auto response = common::FromHexString(tokens[1]);
+    if (!response || response->empty()) {
+      return std::nullopt;
+    }
+    responses[tokens[0]] = std::move(*response);
+  }
+  if (!firmware) {
+    return std::nullopt;
+  }
+  return std::make_pair(std::move(*firmware), std::move(responses));
+}
+
+}  // namespace hci
+}  // namespace bluetooth
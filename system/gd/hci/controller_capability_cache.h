@@ -0,0 +1,54 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+
+// The Command Complete events of the reads of controller capabilities that do not change until the firmware does
+//
+// The responses are stored with the firmware that sent them, and Read() only returns them for that same firmware:
+//   firmware=<firmware>
+//   <read>=<command complete event in hex>
+class ControllerCapabilityCache {
+ public:
+  using Responses = std::map<std::string, std::vector<uint8_t>>;
+
+  static ControllerCapabilityCache FromPath(std::string path) {
+    return ControllerCapabilityCache(std::move(path));
+  }
+  explicit ControllerCapabilityCache(std::string path);
+  // Read the responses sent by |firmware|, empty if there is no cache for this firmware
+  Responses Read(const std::string& firmware);
+  bool Write(const std::string& firmware, const Responses& responses);
+  bool Delete();
+
+  static std::string Serialize(const std::string& firmware, const Responses& responses);
+  static std::optional<std::pair<std::string, Responses>> Deserialize(const std::string& data);
+
+ private:
+  std::string path_;
+};
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/controller_capability_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "os/files.h"
+
+namespace testing {
+
+using bluetooth::hci::ControllerCapabilityCache;
+
+class ControllerCapabilityCacheTest : public Test {
+ protected:
+  void SetUp() override {
+    temp_cache_ = std::filesystem::temp_directory_path() / "temp_controller_capabilities.txt";
+    std::filesystem::remove(temp_cache_);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(temp_cache_);
+  }
+
+  std::filesystem::path temp_cache_;
+};
+
+TEST_F(ControllerCapabilityCacheTest, serialize_deserialize_test) {
+  ControllerCapabilityCache::Responses responses = {
+      {"READ_BUFFER_SIZE", {0x0e, 0x0b, 0x01, 0x05, 0x10, 0x00}},
+      {"READ_LOCAL_EXTENDED_FEATURES_1", {0x0e, 0x0e, 0x01, 0x04, 0x10, 0x00, 0x01}},
+  };
+  auto serialized = ControllerCapabilityCache::Serialize("0a.1234.0a.000f.5678", responses);
+  auto cache = ControllerCapabilityCache::Deserialize(serialized);
+  ASSERT_TRUE(cache.has_value());
+  EXPECT_EQ(cache->first, "0a.1234.0a.000f.5678");
+  EXPECT_EQ(cache->second, responses);
+}
+
+TEST_F(ControllerCapabilityCacheTest, deserialize_invalid_test) {
+  EXPECT_FALSE(ControllerCapabilityCache::Deserialize("").has_value());
+  // The firmware must come first
+  EXPECT_FALSE(ControllerCapabilityCache::Deserialize("READ_BUFFER_SIZE=0e\nfirmware=1\n").has_value());
+  EXPECT_FALSE(ControllerCapabilityCache::Deserialize("firmware=1\nREAD_BUFFER_SIZE=0\n").has_value());
+  EXPECT_FALSE(ControllerCapabilityCache::Deserialize("firmware=1\nREAD_BUFFER_SIZE=zz\n").has_value());
+  EXPECT_FALSE(ControllerCapabilityCache::Deserialize("firmware=1\nREAD_BUFFER_SIZE\n").has_value());
+  EXPECT_TRUE(ControllerCapabilityCache::Deserialize("firmware=1\n").has_value());
+}
+
+TEST_F(ControllerCapabilityCacheTest, read_write_test) {
+  auto cache = ControllerCapabilityCache::FromPath(temp_cache_.string());
+  EXPECT_TRUE(cache.Read("firmware_a").empty());
+
+  ControllerCapabilityCache::Responses responses = {{"READ_BUFFER_SIZE", {0x0e, 0x0b, 0x01, 0x05, 0x10, 0x00}}};
+  ASSERT_TRUE(cache.Write("firmware_a", responses));
+  EXPECT_EQ(cache.Read("firmware_a"), responses);
+
+  // A firmware update invalidates the cache
+  EXPECT_TRUE(cache.Read("firmware_b").empty());
+
+  EXPECT_TRUE(cache.Delete());
+  EXPECT_TRUE(cache.Read("firmware_a").empty());
+  EXPECT_FALSE(cache.Delete());
+}
+
+}  // namespace testing
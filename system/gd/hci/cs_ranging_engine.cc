@@ -0,0 +1,179 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/cs_ranging_engine.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+namespace bluetooth::hci {
+
+namespace {
+// Adjacent channel pairs needed for a phase based estimate
+constexpr size_t kMinChannelPairs = 4;
+// Below this coherence of the phase slopes, the tones are too noisy
+constexpr double kMinCoherence = 0.3;
+constexpr double kHalfNanosecond = 0.5e-9;
+}  // namespace
+
+void CsProcedureData::AddTone(
+    uint8_t channel, float initiator_i, float initiator_q, float reflector_i, float reflector_q, uint8_t quality) {
+  channels.push_back(channel);
+  this->initiator_i.push_back(initiator_i);
+  this->initiator_q.push_back(initiator_q);
+  this->reflector_i.push_back(reflector_i);
+  this->reflector_q.push_back(reflector_q);
+  tone_quality.push_back(quality);
+}
+
+void CsProcedureData::AddRtt(int16_t initiator_toa_tod, int16_t reflector_tod_toa) {
+  this->initiator_toa_tod.push_back(initiator_toa_tod);
+  this->reflector_tod_toa.push_back(reflector_tod_toa);
+}
+
+void CsProcedureData::Clear() {
+  channels.clear();
+  initiator_i.clear();
+  initiator_q.clear();
+  reflector_i.clear();
+  reflector_q.clear();
+  tone_quality.clear();
+  initiator_toa_tod.clear();
+  reflector_tod_toa.clear();
+}
+
+CsRangingResult CsRangingEngine::Estimate(const CsProcedureData& data) {
+  CsRangingResult result;
+  EstimatePhase(data, &result);
+  EstimateRtt(data, &result);
+
+  if (result.phase_valid) {
+    result.valid = true;
+    result.distance_m = result.phase_distance_m;
+    if (result.rtt_valid) {
+      // Select the phase based distance closest to the round trip time one
+      double wraps = std::max(0.0, round((result.rtt_distance_m - result.phase_distance_m) / kAmbiguityM));
+      result.distance_m = result.phase_distance_m + wraps * kAmbiguityM;
+    }
+  } else if (result.rtt_valid) {
+    result.valid = true;
+    result.distance_m = result.rtt_distance_m;
+  }
+  return result;
+}
+
+bool CsRangingEngine::EstimatePhase(const CsProcedureData& data, CsRangingResult* result) {
+  const size_t num_tones = data.channels.size();
+  if (num_tones == 0) {
+    return false;
+  }
+  response_i_.resize(num_tones);
+  response_q_.resize(num_tones);
+
+  // Round trip response of each tone, the product of the two phase correction terms. Straight loop over the arrays,
+  // without branches, for the vectorizer.
+  const float* __restrict ii = data.initiator_i.data();
+  const float* __restrict iq = data.initiator_q.data();
+  const float* __restrict ri = data.reflector_i.data();
+  const float* __restrict rq = data.reflector_q.data();
+  float* __restrict hi = response_i_.data();
+  float* __restrict hq = response_q_.data();
+  for (size_t n = 0; n < num_tones; n++) {
+    hi[n] = ii[n] * ri[n] - iq[n] * rq[n];
+    hq[n] = ii[n] * rq[n] + iq[n] * ri[n];
+  }
+
+  // Channels can be measured more than once, their responses add up
+  channel_i_.fill(0);
+  channel_q_.fill(0);
+  channel_present_.fill(false);
+  for (size_t n = 0; n < num_tones; n++) {
+    uint8_t channel = data.channels[n];
+    if (channel >= kNumChannels || data.tone_quality[n] > CsProcedureData::kToneQualityMedium) {
+      continue;
+    }
+    channel_i_[channel] += hi[n];
+    channel_q_[channel] += hq[n];
+    channel_present_[channel] = true;
+  }
+
+  // Phase slope over the adjacent channels: h[k + 1] * conj(h[k]), normalized so that each pair weighs the same
+  double slope_i = 0;
+  double slope_q = 0;
+  size_t num_pairs = 0;
+  for (size_t k = 0; k + 1 < kNumChannels; k++) {
+    if (!channel_present_[k] || !channel_present_[k + 1]) {
+      continue;
+    }
+    double pi = channel_i_[k + 1] * channel_i_[k] + channel_q_[k + 1] * channel_q_[k];
+    double pq = channel_q_[k + 1] * channel_i_[k] - channel_i_[k + 1] * channel_q_[k];
+    double magnitude = hypot(pi, pq);
+    if (magnitude == 0) {
+      continue;
+    }
+    slope_i += pi / magnitude;
+    slope_q += pq / magnitude;
+    num_pairs++;
+  }
+  if (num_pairs < kMinChannelPairs) {
+    return false;
+  }
+
+  double coherence = hypot(slope_i, slope_q) / num_pairs;
+  if (coherence < kMinCoherence) {
+    return false;
+  }
+
+  // The round trip phase falls with the frequency
+  double slope = atan2(slope_q, slope_i);
+  double distance = -slope * kSpeedOfLight / (4 * M_PI * kChannelSpacingHz);
+  if (distance < 0) {
+    distance += kAmbiguityM;
+  }
+
+  // Circular standard deviation of the slopes, averaged over the pairs
+  double deviation = sqrt(-2 * log(coherence));
+  result->phase_valid = true;
+  result->phase_distance_m = distance;
+  result->error_m = deviation * kSpeedOfLight / (4 * M_PI * kChannelSpacingHz) / sqrt(num_pairs);
+  return true;
+}
+
+bool CsRangingEngine::EstimateRtt(const CsProcedureData& data, CsRangingResult* result) {
+  const size_t num_steps = std::min(data.initiator_toa_tod.size(), data.reflector_tod_toa.size());
+  if (num_steps == 0) {
+    return false;
+  }
+  rtt_m_.resize(num_steps);
+  for (size_t n = 0; n < num_steps; n++) {
+    double round_trip_s = (data.initiator_toa_tod[n] - data.reflector_tod_toa[n]) * kHalfNanosecond;
+    rtt_m_[n] = round_trip_s * kSpeedOfLight / 2;
+  }
+
+  // The median, the timings of a few steps can be far off
+  auto middle = rtt_m_.begin() + num_steps / 2;
+  std::nth_element(rtt_m_.begin(), middle, rtt_m_.end());
+  result->rtt_valid = true;
+  result->rtt_distance_m = std::max(0.0, *middle);
+  if (!result->phase_valid) {
+    // Half a timing unit of resolution
+    result->error_m = kHalfNanosecond * kSpeedOfLight / 4;
+  }
+  return true;
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bluetooth::hci {
+
+/// The results of the steps of a Channel Sounding procedure, gathered from its
+/// subevent results. The values of each kind are kept contiguous, in a
+/// structure of arrays, so that the ranging kernels run over plain float
+/// arrays which the compiler vectorizes.
+struct CsProcedureData {
+  /// Tone quality indicators, only the high and medium quality tones are used
+  static constexpr uint8_t kToneQualityHigh = 0;
+  static constexpr uint8_t kToneQualityMedium = 1;
+
+  /// Adds the phase correction terms, scaled to [-1, 1], measured by the
+  /// initiator and the reflector on a mode 2 step.
+  void AddTone(
+      uint8_t channel,
+      float initiator_i,
+      float initiator_q,
+      float reflector_i,
+      float reflector_q,
+      uint8_t quality);
+
+  /// Adds the timings of a mode 1 step, in units of 0.5 ns.
+  void AddRtt(int16_t initiator_toa_tod, int16_t reflector_tod_toa);
+
+  /// Keeps the capacity, so that the next procedure does not allocate.
+  void Clear();
+
+  // Mode 2 steps, channel k is at 2402 + k MHz
+  std::vector<uint8_t> channels;
+  std::vector<float> initiator_i;
+  std::vector<float> initiator_q;
+  std::vector<float> reflector_i;
+  std::vector<float> reflector_q;
+  std::vector<uint8_t> tone_quality;
+
+  // Mode 1 steps
+  std::vector<int16_t> initiator_toa_tod;
+  std::vector<int16_t> reflector_tod_toa;
+};
+
+struct CsRangingResult {
+  bool valid = false;
+  double distance_m = 0;
+  double error_m = 0;
+
+  // The estimates of each method, combined into distance_m
+  bool phase_valid = false;
+  double phase_distance_m = 0;
+  bool rtt_valid = false;
+  double rtt_distance_m = 0;
+};
+
+/// Estimates the distance to the reflector from the results of a procedure.
+///
+/// Phase based ranging: the round trip phase of the tone on each channel is
+/// the product of the initiator and reflector phase correction terms, and
+/// falls by 4 pi d / c for each Hz of frequency. The slope is measured on the
+/// pairs of adjacent channels, 1 MHz apart, which leaves an ambiguity of about
+/// 150 m: the round trip time estimate, coarser but not ambiguous, selects the
+/// phase based distance in this range.
+///
+/// The engine keeps its buffers between procedures, it is meant to be owned by
+/// the thread running the estimates, not the handler receiving the results.
+class CsRangingEngine {
+ public:
+  static constexpr size_t kNumChannels = 79;
+  static constexpr double kSpeedOfLight = 299792458.0;
+  static constexpr double kChannelSpacingHz = 1e6;
+  // Distance at which the phase slope of adjacent channels wraps around
+  static constexpr double kAmbiguityM = kSpeedOfLight / (2 * kChannelSpacingHz);
+
+  CsRangingResult Estimate(const CsProcedureData& data);
+
+ private:
+  bool EstimatePhase(const CsProcedureData& data, CsRangingResult* result);
+  bool EstimateRtt(const CsProcedureData& data, CsRangingResult* result);
+
+  // Round trip channel response of each tone
+  std::vector<float> response_i_;
+  std::vector<float> response_q_;
+  std::vector<double> rtt_m_;
+  // Sum of the responses of each channel
+  std::array<float, kNumChannels> channel_i_{};
+  std::array<float, kNumChannels> channel_q_{};
+  std::array<bool, kNumChannels> channel_present_{};
+};
+
+}  // namespace bluetooth::hci
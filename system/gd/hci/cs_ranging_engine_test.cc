@@ -0,0 +1,111 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/cs_ranging_engine.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+namespace bluetooth::hci {
+namespace {
+
+constexpr double kFirstChannelHz = 2402e6;
+
+class CsRangingEngineTest : public ::testing::Test {
+ protected:
+  // Adds the tones of a reflector at |distance_m| on the channels [first, last], with a phase offset that the
+  // estimate must not depend on
+  void AddTones(double distance_m, uint8_t first, uint8_t last, uint8_t quality = CsProcedureData::kToneQualityHigh) {
+    for (uint8_t channel = first; channel <= last; channel++) {
+      double frequency = kFirstChannelHz + channel * CsRangingEngine::kChannelSpacingHz;
+      double phase = 0.7 - 4 * M_PI * frequency * distance_m / CsRangingEngine::kSpeedOfLight;
+      // Each side measures half of the round trip phase
+      float i = cos(phase / 2);
+      float q = sin(phase / 2);
+      data_.AddTone(channel, i, q, i, q, quality);
+    }
+  }
+
+  void AddRtts(double distance_m, size_t count) {
+    double half_ns = 2 * distance_m / CsRangingEngine::kSpeedOfLight / 0.5e-9;
+    for (size_t n = 0; n < count; n++) {
+      data_.AddRtt(static_cast<int16_t>(round(half_ns)) + 100, 100);
+    }
+  }
+
+  CsProcedureData data_;
+  CsRangingEngine engine_;
+};
+
+TEST_F(CsRangingEngineTest, no_data) {
+  auto result = engine_.Estimate(data_);
+  ASSERT_FALSE(result.valid);
+}
+
+TEST_F(CsRangingEngineTest, phase_based_distance) {
+  AddTones(3.0, 2, 76);
+  auto result = engine_.Estimate(data_);
+  ASSERT_TRUE(result.valid);
+  ASSERT_TRUE(result.phase_valid);
+  ASSERT_FALSE(result.rtt_valid);
+  ASSERT_NEAR(result.distance_m, 3.0, 0.01);
+  ASSERT_LT(result.error_m, 0.1);
+}
+
+TEST_F(CsRangingEngineTest, low_quality_tones_are_ignored) {
+  AddTones(3.0, 2, 40);
+  AddTones(20.0, 41, 76, 2);
+  auto result = engine_.Estimate(data_);
+  ASSERT_TRUE(result.phase_valid);
+  ASSERT_NEAR(result.distance_m, 3.0, 0.01);
+}
+
+TEST_F(CsRangingEngineTest, too_few_channels) {
+  AddTones(3.0, 10, 12);
+  auto result = engine_.Estimate(data_);
+  ASSERT_FALSE(result.valid);
+}
+
+TEST_F(CsRangingEngineTest, rtt_distance) {
+  AddRtts(30.0, 8);
+  // A step far off does not move the median
+  data_.AddRtt(10000, 0);
+  auto result = engine_.Estimate(data_);
+  ASSERT_TRUE(result.valid);
+  ASSERT_FALSE(result.phase_valid);
+  ASSERT_NEAR(result.distance_m, 30.0, 0.1);
+}
+
+TEST_F(CsRangingEngineTest, rtt_resolves_phase_ambiguity) {
+  constexpr double kDistance = 160.0;
+  AddTones(kDistance, 2, 76);
+  AddRtts(kDistance + 5, 4);
+  auto result = engine_.Estimate(data_);
+  ASSERT_TRUE(result.valid);
+  ASSERT_NEAR(result.phase_distance_m, kDistance - CsRangingEngine::kAmbiguityM, 0.01);
+  ASSERT_NEAR(result.distance_m, kDistance, 0.01);
+}
+
+TEST_F(CsRangingEngineTest, buffers_are_reused) {
+  AddTones(3.0, 2, 76);
+  engine_.Estimate(data_);
+  data_.Clear();
+  AddTones(7.5, 2, 76);
+  ASSERT_NEAR(engine_.Estimate(data_).distance_m, 7.5, 0.01);
+}
+
+}  // namespace
+}  // namespace bluetooth::hci
@@ -16,13 +16,23 @@
 
 #include "hci/hci_layer.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <mutex>
+
 #include "common/bind.h"
 #include "common/init_flags.h"
+#include "common/packet_latency_trace.h"
+#include "common/startup_trace.h"
 #include "common/stop_watch.h"
 #include "hci/hci_metrics_logging.h"
+#include "hci_layer_generated.h"
 #include "os/alarm.h"
 #include "os/metrics.h"
 #include "os/queue.h"
+#include "os/system_properties.h"
 #include "packet/packet_builder.h"
 #include "storage/storage_module.h"
 
@@ -53,6 +63,68 @@ static void fail_if_reset_complete_not_success(CommandCompleteView complete) {
   ASSERT(reset_complete.GetStatus() == ErrorCode::SUCCESS);
 }
 
+const std::string HciLayer::kMaxOutstandingCommandsProperty = "bluetooth.core.hci.max_outstanding_commands";
+const std::string HciLayer::kPacketLatencySamplingRateProperty = "persist.bluetooth.packet_latency_trace.sampling_rate";
+
+// Commands that change how the controller handles the following ones, or whose response can't always
+// be matched to them (vendor specific commands), are only sent when no other command is outstanding.
+static bool is_serialized_command(OpCode op_code) {
+  if ((static_cast<uint16_t>(op_code) >> 10) == 0x3f) {
+    return true;
+  }
+  switch (op_code) {
+    case OpCode::RESET:
+    case OpCode::SET_EVENT_MASK:
+    case OpCode::SET_EVENT_FILTER:
+    case OpCode::SET_CONTROLLER_TO_HOST_FLOW_CONTROL:
+    case OpCode::HOST_BUFFER_SIZE:
+    case OpCode::WRITE_SIMPLE_PAIRING_MODE:
+    case OpCode::WRITE_LE_HOST_SUPPORT:
+    case OpCode::WRITE_SECURE_CONNECTIONS_HOST_SUPPORT:
+    case OpCode::LE_SET_EVENT_MASK:
+    case OpCode::LE_SET_RANDOM_ADDRESS:
+    case OpCode::LE_SET_ADDRESS_RESOLUTION_ENABLE:
+    case OpCode::LE_SET_HOST_FEATURE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Latency histogram with power of two buckets: bucket i counts the latencies below 2^i microseconds
+/// not counted by the previous buckets, and the last bucket counts the rest.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBucketCount = 24;
+
+  void Add(std::chrono::microseconds latency) {
+    uint64_t latency_us = std::max<int64_t>(latency.count(), 0);
+    size_t bucket = 0;
+    while (bucket + 1 < kBucketCount && latency_us >= GetUpperBound(bucket)) {
+      bucket++;
+    }
+    counts_[bucket]++;
+  }
+
+  static uint64_t GetUpperBound(size_t bucket) {
+    return bucket + 1 < kBucketCount ? uint64_t{1} << bucket : std::numeric_limits<uint64_t>::max();
+  }
+
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<LatencyBucketData>>> Dump(
+      flatbuffers::FlatBufferBuilder* fb_builder) const {
+    std::vector<flatbuffers::Offset<LatencyBucketData>> buckets;
+    for (size_t bucket = 0; bucket < kBucketCount; bucket++) {
+      if (counts_[bucket] != 0) {
+        buckets.push_back(CreateLatencyBucketData(*fb_builder, GetUpperBound(bucket), counts_[bucket]));
+      }
+    }
+    return fb_builder->CreateVector(buckets);
+  }
+
+ private:
+  std::array<uint64_t, kBucketCount> counts_{};
+};
+
 static void abort_after_time_out(OpCode op_code) {
   bluetooth::os::LogMetricHciTimeoutEvent(static_cast<uint32_t>(op_code));
   ASSERT_LOG(false, "Done waiting for debug information after HCI timeout (%s)", OpCodeText(op_code).c_str());
@@ -76,6 +148,9 @@ class CommandQueueEntry {
 
   unique_ptr<CommandBuilder> command;
   unique_ptr<CommandView> command_view;
+  std::shared_ptr<std::vector<uint8_t>> bytes;
+  OpCode op_code{OpCode::NONE};
+  std::chrono::steady_clock::time_point send_time;
 
   bool waiting_for_status_;
   ContextualOnceCallback<void(CommandStatusView)> on_status;
@@ -100,6 +175,10 @@ class CommandQueueEntry {
 struct HciLayer::impl {
   impl(hal::HciHal* hal, HciLayer& module) : hal_(hal), module_(module) {
     hci_timeout_alarm_ = new Alarm(module.GetHandler());
+    max_outstanding_commands_ = static_cast<uint8_t>(std::clamp<uint32_t>(
+        os::GetSystemPropertyUint32(kMaxOutstandingCommandsProperty, kDefaultMaxOutstandingCommands),
+        1,
+        std::numeric_limits<uint8_t>::max()));
   }
 
   ~impl() {
@@ -113,6 +192,7 @@ struct HciLayer::impl {
       delete hci_abort_alarm_;
     }
     command_queue_.clear();
+    outstanding_commands_.clear();
   }
 
   void drop(EventView event) {
@@ -122,25 +202,28 @@ struct HciLayer::impl {
   void on_outbound_acl_ready() {
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
+    bytes.reserve(packet->size());
     BitInserter bi(bytes);
     packet->Serialize(bi);
-    hal_->sendAclData(bytes);
+    hal_->sendAclData(std::move(bytes));
   }
 
   void on_outbound_sco_ready() {
     auto packet = sco_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
+    bytes.reserve(packet->size());
     BitInserter bi(bytes);
     packet->Serialize(bi);
-    hal_->sendScoData(bytes);
+    hal_->sendScoData(std::move(bytes));
   }
 
   void on_outbound_iso_ready() {
     auto packet = iso_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
+    bytes.reserve(packet->size());
     BitInserter bi(bytes);
     packet->Serialize(bi);
-    hal_->sendIsoData(bytes);
+    hal_->sendIsoData(std::move(bytes));
   }
 
   template <typename TResponse>
@@ -181,26 +264,32 @@ struct HciLayer::impl {
     bool is_status = logging_id == "status";
 
     ASSERT_LOG(
-        !command_queue_.empty(),
+        !outstanding_commands_.empty(),
         "Unexpected %s event with OpCode 0x%02hx (%s)",
         logging_id.c_str(),
         op_code,
         OpCodeText(op_code).c_str());
-    if (waiting_command_ == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
+    OpCode oldest_op_code = outstanding_commands_.front().op_code;
+    if (oldest_op_code == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
       LOG_ERROR("Discarding event that came after timeout 0x%02hx (%s)", op_code, OpCodeText(op_code).c_str());
       return;
     }
+    // At most one command of each opcode is outstanding, see send_next_command().
+    auto command = std::find_if(
+        outstanding_commands_.begin(), outstanding_commands_.end(), [op_code](const CommandQueueEntry& entry) {
+          return entry.op_code == op_code;
+        });
     ASSERT_LOG(
-        waiting_command_ == op_code,
+        command != outstanding_commands_.end(),
         "Waiting for 0x%02hx (%s), got 0x%02hx (%s)",
-        waiting_command_,
-        OpCodeText(waiting_command_).c_str(),
+        oldest_op_code,
+        OpCodeText(oldest_op_code).c_str(),
         op_code,
         OpCodeText(op_code).c_str());
 
     bool is_vendor_specific = static_cast<int>(op_code) & (0x3f << 10);
     CommandStatusView status_view = CommandStatusView::Create(event);
-    if (is_vendor_specific && (is_status && !command_queue_.front().waiting_for_status_) &&
+    if (is_vendor_specific && (is_status && !command->waiting_for_status_) &&
         (status_view.IsValid() && status_view.GetStatus() == ErrorCode::UNKNOWN_HCI_COMMAND)) {
       // If this is a command status of a vendor specific command, and command complete is expected,
       // we can't treat this as hard failure since we have no way of probing this lack of support at
@@ -208,36 +297,55 @@ struct HciLayer::impl {
       // packet, which will be interpreted as invalid response.
       CommandCompleteView command_complete_view = CommandCompleteView::Create(
           EventView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>()))));
-      command_queue_.front().GetCallback<CommandCompleteView>()->Invoke(
-          std::move(command_complete_view));
+      command->GetCallback<CommandCompleteView>()->Invoke(std::move(command_complete_view));
     } else {
-      if (command_queue_.front().waiting_for_status_ == is_status) {
-        command_queue_.front().GetCallback<TResponse>()->Invoke(std::move(response_view));
+      if (command->waiting_for_status_ == is_status) {
+        command->GetCallback<TResponse>()->Invoke(std::move(response_view));
       } else {
         CommandCompleteView command_complete_view = CommandCompleteView::Create(
             EventView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>()))));
-        command_queue_.front().GetCallback<CommandCompleteView>()->Invoke(std::move(command_complete_view));
+        command->GetCallback<CommandCompleteView>()->Invoke(std::move(command_complete_view));
       }
     }
 
-    command_queue_.pop_front();
-    waiting_command_ = OpCode::NONE;
+    {
+      auto now = std::chrono::steady_clock::now();
+      if (common::StartupTrace::IsRecording()) {
+        common::StartupTrace::Record("HCI " + OpCodeText(op_code), command->send_time, now);
+      }
+      auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - command->send_time);
+      std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+      command_latency_.Add(latency);
+      command_latency_by_op_code_[op_code].Add(latency);
+    }
+    bool was_oldest = command == outstanding_commands_.begin();
+    outstanding_commands_.erase(command);
     if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Cancel();
+      // The timeout always applies to the oldest outstanding command.
+      if (outstanding_commands_.empty()) {
+        hci_timeout_alarm_->Cancel();
+      } else if (was_oldest) {
+        schedule_hci_timeout(outstanding_commands_.front().op_code);
+      }
       send_next_command();
     }
   }
 
+  void schedule_hci_timeout(OpCode op_code) {
+    hci_timeout_alarm_->Cancel();
+    hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
+  }
+
   void on_hci_timeout(OpCode op_code) {
     common::StopWatch::DumpStopWatchLog();
     LOG_ERROR("Timed out waiting for 0x%02hx (%s)", op_code, OpCodeText(op_code).c_str());
     // TODO: LogMetricHciTimeoutEvent(static_cast<uint32_t>(op_code));
 
-    LOG_ERROR("Flushing %zd waiting commands", command_queue_.size());
+    LOG_ERROR("Flushing %zd waiting commands", command_queue_.size() + outstanding_commands_.size());
     // Clear any waiting commands (there is an abort coming anyway)
     command_queue_.clear();
+    outstanding_commands_.clear();
     command_credits_ = 1;
-    waiting_command_ = OpCode::NONE;
     // Ignore the response, since we don't know what might come back.
     enqueue_command(ControllerDebugInfoBuilder::Create(), module_.GetHandler()->BindOnce([](CommandCompleteView) {}));
     // Don't time out for this one;
@@ -254,34 +362,91 @@ struct HciLayer::impl {
     }
   }
 
-  void send_next_command() {
-    if (command_credits_ == 0) {
-      return;
+  // Commands are sent in order, as long as the controller has command credits, up to
+  // |max_outstanding_commands_| at a time. A command isn't sent while another command with the same
+  // opcode is outstanding, so that responses match their command, and serialized commands are sent
+  // alone.
+  bool can_send_command(OpCode op_code) const {
+    if (outstanding_commands_.empty()) {
+      return true;
     }
-    if (waiting_command_ != OpCode::NONE) {
-      return;
+    if (outstanding_commands_.size() >= max_outstanding_commands_ || is_serialized_command(op_code) ||
+        is_serialized_command(outstanding_commands_.front().op_code)) {
+      return false;
     }
-    if (command_queue_.size() == 0) {
-      return;
+    return std::none_of(
+        outstanding_commands_.begin(), outstanding_commands_.end(), [op_code](const CommandQueueEntry& entry) {
+          return entry.op_code == op_code;
+        });
+  }
+
+  void send_next_command() {
+    while (command_credits_ > 0 && !command_queue_.empty()) {
+      CommandQueueEntry& entry = command_queue_.front();
+      if (entry.bytes == nullptr) {
+        // Serialized once, the command may have to wait for the outstanding ones.
+        entry.bytes = std::make_shared<std::vector<uint8_t>>();
+        entry.bytes->reserve(entry.command->size());
+        BitInserter bi(*entry.bytes);
+        entry.command->Serialize(bi);
+        auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(entry.bytes));
+        ASSERT(cmd_view.IsValid());
+        entry.op_code = cmd_view.GetOpCode();
+        entry.command_view = std::make_unique<CommandView>(std::move(cmd_view));
+      }
+      if (!can_send_command(entry.op_code)) {
+        return;
+      }
+      hal_->sendHciCommand(*entry.bytes);
+
+      OpCode op_code = entry.op_code;
+      log_link_layer_connection_command(entry.command_view);
+      log_classic_pairing_command_status(entry.command_view, ErrorCode::STATUS_UNKNOWN);
+      entry.send_time = std::chrono::steady_clock::now();
+      outstanding_commands_.splice(outstanding_commands_.end(), command_queue_, command_queue_.begin());
+      command_credits_--;
+      {
+        std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+        commands_sent_++;
+        max_outstanding_commands_reached_ = std::max(max_outstanding_commands_reached_, outstanding_commands_.size());
+      }
+      if (hci_timeout_alarm_ != nullptr) {
+        if (outstanding_commands_.size() == 1) {
+          schedule_hci_timeout(op_code);
+        }
+      } else {
+        LOG_WARN("%s sent without an hci-timeout timer", OpCodeText(op_code).c_str());
+      }
     }
-    std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
-    BitInserter bi(*bytes);
-    command_queue_.front().command->Serialize(bi);
-    hal_->sendHciCommand(*bytes);
-
-    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
-    ASSERT(cmd_view.IsValid());
-    OpCode op_code = cmd_view.GetOpCode();
-    command_queue_.front().command_view = std::make_unique<CommandView>(std::move(cmd_view));
-    log_link_layer_connection_command(command_queue_.front().command_view);
-    log_classic_pairing_command_status(command_queue_.front().command_view, ErrorCode::STATUS_UNKNOWN);
-    waiting_command_ = op_code;
-    command_credits_ = 0;  // Only allow one outstanding command
-    if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
-    } else {
-      LOG_WARN("%s sent without an hci-timeout timer", OpCodeText(op_code).c_str());
+  }
+
+  flatbuffers::Offset<HciLayerData> Dump(flatbuffers::FlatBufferBuilder* fb_builder) const {
+    std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+    auto title = fb_builder->CreateString("----- Hci Layer Dumpsys -----");
+    auto command_latency = command_latency_.Dump(fb_builder);
+    std::vector<flatbuffers::Offset<OpCodeLatencyData>> op_code_latencies;
+    for (const auto& [op_code, histogram] : command_latency_by_op_code_) {
+      auto op_code_text = fb_builder->CreateString(OpCodeText(op_code));
+      op_code_latencies.push_back(CreateOpCodeLatencyData(*fb_builder, op_code_text, histogram.Dump(fb_builder)));
+    }
+    auto command_latency_by_op_code = fb_builder->CreateVector(op_code_latencies);
+    std::vector<flatbuffers::Offset<SubeventLatencyData>> subevent_latencies;
+    for (const auto& [subevent_code, histogram] : le_subevent_dispatch_latency_) {
+      auto subevent_code_text = fb_builder->CreateString(SubeventCodeText(subevent_code));
+      subevent_latencies.push_back(
+          CreateSubeventLatencyData(*fb_builder, subevent_code_text, histogram.Dump(fb_builder)));
     }
+    auto le_subevent_dispatch_latency = fb_builder->CreateVector(subevent_latencies);
+    HciLayerDataBuilder builder(*fb_builder);
+    builder.add_title(title);
+    builder.add_max_outstanding_commands(max_outstanding_commands_);
+    builder.add_max_outstanding_commands_reached(static_cast<int>(max_outstanding_commands_reached_));
+    builder.add_commands_sent(commands_sent_);
+    builder.add_command_latency(command_latency);
+    builder.add_command_latency_by_op_code(command_latency_by_op_code);
+    builder.add_events_received(events_received_);
+    builder.add_le_subevent_dispatch_latency(le_subevent_dispatch_latency);
+    return builder.Finish();
   }
 
   void register_event(EventCode event, ContextualCallback<void(EventView)> handler) {
@@ -291,28 +456,28 @@ struct HciLayer::impl {
         EventCode::LE_META_EVENT,
         EventCodeText(EventCode::LE_META_EVENT).c_str());
     ASSERT_LOG(
-        event_handlers_.count(event) == 0,
+        event_handlers_[static_cast<uint8_t>(event)].IsEmpty(),
         "Can not register a second handler for %02hhx (%s)",
         event,
         EventCodeText(event).c_str());
-    event_handlers_[event] = handler;
+    event_handlers_[static_cast<uint8_t>(event)] = handler;
   }
 
   void unregister_event(EventCode event) {
-    event_handlers_.erase(event);
+    event_handlers_[static_cast<uint8_t>(event)] = ContextualCallback<void(EventView)>();
   }
 
   void register_le_event(SubeventCode event, ContextualCallback<void(LeMetaEventView)> handler) {
     ASSERT_LOG(
-        subevent_handlers_.count(event) == 0,
+        subevent_handlers_[static_cast<uint8_t>(event)].IsEmpty(),
         "Can not register a second handler for %02hhx (%s)",
         event,
         SubeventCodeText(event).c_str());
-    subevent_handlers_[event] = handler;
+    subevent_handlers_[static_cast<uint8_t>(event)] = handler;
   }
 
   void unregister_le_event(SubeventCode event) {
-    subevent_handlers_.erase(subevent_handlers_.find(event));
+    subevent_handlers_[static_cast<uint8_t>(event)] = ContextualCallback<void(LeMetaEventView)>();
   }
 
   static void abort_after_root_inflammation(uint8_t vse_error) {
@@ -337,9 +502,13 @@ struct HciLayer::impl {
     }
   }
 
-  void on_hci_event(EventView event) {
+  void on_hci_event(EventView event, std::chrono::steady_clock::time_point receive_time) {
     ASSERT(event.IsValid());
-    if (command_queue_.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+      events_received_++;
+    }
+    if (outstanding_commands_.empty()) {
       auto event_code = event.GetEventCode();
       // BT Core spec 5.2 (Volume 4, Part E section 4.4) allows anytime
       // COMMAND_COMPLETE and COMMAND_STATUS with opcode 0x0 for flow control
@@ -370,7 +539,8 @@ struct HciLayer::impl {
       std::unique_ptr<CommandView> no_waiting_command{nullptr};
       log_hci_event(no_waiting_command, event, module_.GetDependency<storage::StorageModule>());
     } else {
-      log_hci_event(command_queue_.front().command_view, event, module_.GetDependency<storage::StorageModule>());
+      log_hci_event(
+          outstanding_commands_.front().command_view, event, module_.GetDependency<storage::StorageModule>());
     }
     EventCode event_code = event.GetEventCode();
     // Root Inflamation is a special case, since it aborts here
@@ -394,44 +564,66 @@ struct HciLayer::impl {
         on_command_status(event);
         break;
       case EventCode::LE_META_EVENT:
-        on_le_meta_event(event);
+        on_le_meta_event(event, receive_time);
         break;
-      default:
-        if (event_handlers_.find(event_code) == event_handlers_.end()) {
+      default: {
+        auto& handler = event_handlers_[static_cast<uint8_t>(event_code)];
+        if (handler.IsEmpty()) {
           LOG_WARN(
               "Unhandled event of type 0x%02hhx (%s)",
               event_code,
               EventCodeText(event_code).c_str());
         } else {
-          event_handlers_[event_code].Invoke(event);
+          handler.Invoke(event);
         }
+      }
     }
   }
 
-  void on_le_meta_event(EventView event) {
+  void on_le_meta_event(EventView event, std::chrono::steady_clock::time_point receive_time) {
     LeMetaEventView meta_event_view = LeMetaEventView::Create(event);
     ASSERT(meta_event_view.IsValid());
     SubeventCode subevent_code = meta_event_view.GetSubeventCode();
-    if (subevent_handlers_.find(subevent_code) == subevent_handlers_.end()) {
+    auto& handler = subevent_handlers_[static_cast<uint8_t>(subevent_code)];
+    if (handler.IsEmpty()) {
       LOG_WARN("Unhandled le subevent of type 0x%02hhx (%s)", subevent_code, SubeventCodeText(subevent_code).c_str());
       return;
     }
-    subevent_handlers_[subevent_code].Invoke(meta_event_view);
+    handler.Invoke(meta_event_view);
+
+    // Time the subevent waited for the handler, which is shared with the modules handling events.
+    auto latency =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - receive_time);
+    std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+    le_subevent_dispatch_latency_[subevent_code].Add(latency);
   }
 
   hal::HciHal* hal_;
   HciLayer& module_;
 
   // Command Handling
+  static constexpr uint32_t kDefaultMaxOutstandingCommands = 1;
   std::list<CommandQueueEntry> command_queue_;
+  // Commands sent and waiting for their response, oldest first.
+  std::list<CommandQueueEntry> outstanding_commands_;
+  uint8_t max_outstanding_commands_{1};
 
-  std::map<EventCode, ContextualCallback<void(EventView)>> event_handlers_;
-  std::map<SubeventCode, ContextualCallback<void(LeMetaEventView)>> subevent_handlers_;
-  OpCode waiting_command_{OpCode::NONE};
+  // Event handlers indexed by event code and LE subevent code, empty when unregistered.
+  std::array<ContextualCallback<void(EventView)>, 256> event_handlers_{};
+  std::array<ContextualCallback<void(LeMetaEventView)>, 256> subevent_handlers_{};
   uint8_t command_credits_{1};  // Send reset first
   Alarm* hci_timeout_alarm_{nullptr};
   Alarm* hci_abort_alarm_{nullptr};
 
+  // Command statistics, also read by dumpsys.
+  mutable std::mutex dumpsys_mutex_;
+  LatencyHistogram command_latency_;
+  std::map<OpCode, LatencyHistogram> command_latency_by_op_code_;
+  std::map<SubeventCode, LatencyHistogram> le_subevent_dispatch_latency_;
+  uint64_t commands_sent_{0};
+  uint64_t events_received_{0};
+  size_t max_outstanding_commands_reached_{0};
+
   // Acl packets
   BidiQueue<AclView, AclBuilder> acl_queue_{3 /* TODO: Set queue depth */};
   os::EnqueueBuffer<AclView> incoming_acl_buffer_{acl_queue_.GetDownEnd()};
@@ -450,14 +642,16 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
   hal_callbacks(HciLayer& module) : module_(module) {}
 
   void hciEventReceived(hal::HciPacket event_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(event_bytes));
+    auto packet = packet::PacketView<packet::kLittleEndian>(
+        std::make_shared<std::vector<uint8_t>>(std::move(event_bytes)));
     EventView event = EventView::Create(packet);
-    module_.CallOn(module_.impl_, &impl::on_hci_event, std::move(event));
+    module_.CallOn(module_.impl_, &impl::on_hci_event, std::move(event), std::chrono::steady_clock::now());
   }
 
   void aclDataReceived(hal::HciPacket data_bytes) override {
     auto packet = packet::PacketView<packet::kLittleEndian>(
         std::make_shared<std::vector<uint8_t>>(std::move(data_bytes)));
+    packet.SetLatencySample(common::PacketLatencyTrace::StartSample());
     auto acl = std::make_unique<AclView>(AclView::Create(packet));
     module_.impl_->incoming_acl_buffer_.Enqueue(std::move(acl), module_.GetHandler());
   }
@@ -664,6 +858,7 @@ void HciLayer::ListDependencies(ModuleList* list) const {
 
 void HciLayer::Start() {
   auto hal = GetDependency<hal::HciHal>();
+  common::PacketLatencyTrace::SetSamplingRate(os::GetSystemPropertyUint32(kPacketLatencySamplingRateProperty, 0));
   impl_ = new impl(hal, *this);
   hal_callbacks_ = new hal_callbacks(*this);
 
@@ -684,6 +879,19 @@ void HciLayer::Start() {
   EnqueueCommand(ResetBuilder::Create(), handler->BindOnce(&fail_if_reset_complete_not_success));
 }
 
+DumpsysDataFinisher HciLayer::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const {
+  ASSERT(fb_builder != nullptr);
+  if (impl_ == nullptr) {
+    return Module::GetDumpsysData(fb_builder);
+  }
+
+  auto dumpsys_data = impl_->Dump(fb_builder);
+
+  return [dumpsys_data](DumpsysDataBuilder* dumpsys_builder) {
+    dumpsys_builder->add_hci_layer_dumpsys_data(dumpsys_data);
+  };
+}
+
 void HciLayer::Stop() {
   auto hal = GetDependency<hal::HciHal>();
   hal->unregisterIncomingPacketCallback();
@@ -107,6 +107,13 @@ class HciLayer : public Module, public CommandInterface<CommandBuilder> {
   static constexpr std::chrono::milliseconds kHciTimeoutMs = std::chrono::milliseconds(2000);
   static constexpr std::chrono::milliseconds kHciTimeoutRestartMs = std::chrono::milliseconds(5000);
 
+  // Maximum number of commands sent to the controller without waiting for their response, within the
+  // controller command credits.
+  static const std::string kMaxOutstandingCommandsProperty;
+
+  // One in this many incoming ACL packets is traced through the stack by common::PacketLatencyTrace, 0 disables it.
+  static const std::string kPacketLatencySamplingRateProperty;
+
   static const ModuleFactory Factory;
 
  protected:
@@ -117,6 +124,8 @@ class HciLayer : public Module, public CommandInterface<CommandBuilder> {
 
   void Stop() override;
 
+  DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const override;  // Module
+
   virtual void Disconnect(uint16_t handle, ErrorCode reason);
   virtual void ReadRemoteVersion(
       hci::ErrorCode hci_status,
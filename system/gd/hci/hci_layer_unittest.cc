@@ -31,6 +31,7 @@
 #include "module.h"
 #include "os/fake_timer/fake_timerfd.h"
 #include "os/handler.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
 
@@ -435,5 +436,80 @@ TEST_F(HciLayerTest, command_status_callback_is_invoked_with_failure_status) {
   sync_handler();
 }
 
+class HciLayerPipelineTest : public HciLayerTest {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(os::SetSystemProperty(HciLayer::kMaxOutstandingCommandsProperty, "4"));
+    HciLayerTest::SetUp();
+  }
+
+  void TearDown() override {
+    HciLayerTest::TearDown();
+    os::ClearSystemPropertiesForHost();
+  }
+
+  void EnqueueCommand(std::unique_ptr<CommandBuilder> command) {
+    hci_->EnqueueCommand(std::move(command), hci_handler_->BindOnceOn(this, &HciLayerPipelineTest::on_complete));
+  }
+
+  void on_complete(CommandCompleteView view) {
+    completed_.push_back(view.GetCommandOpCode());
+  }
+
+  OpCode GetSentOpCode() {
+    auto sent_command = hal_->GetSentCommand();
+    EXPECT_TRUE(sent_command.has_value());
+    return sent_command.has_value() ? sent_command->GetOpCode() : OpCode::NONE;
+  }
+
+  void AssertNothingSent() {
+    sync_handler();
+    ASSERT_FALSE(hal_->GetSentCommand(std::chrono::milliseconds(10)).has_value());
+  }
+
+  std::vector<OpCode> completed_;
+};
+
+TEST_F(HciLayerPipelineTest, commands_are_pipelined_within_credits) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(3, ErrorCode::SUCCESS));
+
+  EnqueueCommand(ReadBdAddrBuilder::Create());
+  EnqueueCommand(ReadLocalSupportedFeaturesBuilder::Create());
+  EnqueueCommand(ReadLocalSupportedCommandsBuilder::Create());
+  EnqueueCommand(ReadBdAddrBuilder::Create());
+  ASSERT_EQ(OpCode::READ_BD_ADDR, GetSentOpCode());
+  ASSERT_EQ(OpCode::READ_LOCAL_SUPPORTED_FEATURES, GetSentOpCode());
+  ASSERT_EQ(OpCode::READ_LOCAL_SUPPORTED_COMMANDS, GetSentOpCode());
+  AssertNothingSent();
+
+  // Responses may come out of order. The second READ_BD_ADDR waits for the first one.
+  hal_->InjectEvent(ReadLocalSupportedFeaturesCompleteBuilder::Create(1, ErrorCode::SUCCESS, 0));
+  AssertNothingSent();
+  hal_->InjectEvent(ReadBdAddrCompleteBuilder::Create(1, ErrorCode::SUCCESS, Address::kAny));
+  ASSERT_EQ(OpCode::READ_BD_ADDR, GetSentOpCode());
+  sync_handler();
+  std::vector<OpCode> expected = {OpCode::READ_LOCAL_SUPPORTED_FEATURES, OpCode::READ_BD_ADDR};
+  ASSERT_EQ(expected, completed_);
+}
+
+TEST_F(HciLayerPipelineTest, serialized_command_is_sent_alone) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(3, ErrorCode::SUCCESS));
+
+  EnqueueCommand(ReadBdAddrBuilder::Create());
+  EnqueueCommand(SetEventMaskBuilder::Create(0x3dbff807fffbffff));
+  EnqueueCommand(ReadLocalSupportedFeaturesBuilder::Create());
+  ASSERT_EQ(OpCode::READ_BD_ADDR, GetSentOpCode());
+  AssertNothingSent();
+
+  hal_->InjectEvent(ReadBdAddrCompleteBuilder::Create(3, ErrorCode::SUCCESS, Address::kAny));
+  ASSERT_EQ(OpCode::SET_EVENT_MASK, GetSentOpCode());
+  AssertNothingSent();
+
+  hal_->InjectEvent(SetEventMaskCompleteBuilder::Create(3, ErrorCode::SUCCESS));
+  ASSERT_EQ(OpCode::READ_LOCAL_SUPPORTED_FEATURES, GetSentOpCode());
+}
+
 }  // namespace hci
 }  // namespace bluetooth
@@ -19,6 +19,7 @@
 
 #include "common/audit_log.h"
 #include "common/strings.h"
+#include "hci/hci_metrics_sampler.h"
 #include "os/metrics.h"
 #include "storage/device.h"
 
@@ -68,6 +69,9 @@ void log_link_layer_connection_command(std::unique_ptr<CommandView>& command_vie
   // get op_code
   ASSERT(command_view->IsValid());
   OpCode op_code = command_view->GetOpCode();
+  if (!HciMetricsSampler::Get().Sample(op_code, android::bluetooth::hci::EVT_UNKNOWN, ErrorCode::STATUS_UNKNOWN)) {
+    return;
+  }
 
   // init parameters to log
   Address address = Address::kEmpty;
@@ -237,6 +241,9 @@ void log_link_layer_connection_command_status(std::unique_ptr<CommandView>& comm
   // get op_code
   ASSERT(command_view->IsValid());
   OpCode op_code = command_view->GetOpCode();
+  if (!HciMetricsSampler::Get().Sample(op_code, android::bluetooth::hci::EVT_COMMAND_STATUS, status)) {
+    return;
+  }
 
   // init parameters to log
   Address address = Address::kEmpty;
@@ -417,6 +424,10 @@ void log_link_layer_connection_command_complete(EventView event_view, std::uniqu
   CommandCompleteView command_complete_view = CommandCompleteView::Create(std::move(event_view));
   ASSERT(command_complete_view.IsValid());
   OpCode op_code = command_complete_view.GetCommandOpCode();
+  if (!HciMetricsSampler::Get().Sample(
+          op_code, android::bluetooth::hci::EVT_COMMAND_COMPLETE, ErrorCode::UNKNOWN_HCI_COMMAND)) {
+    return;
+  }
 
   // init parameters to log
   Address address = Address::kEmpty;
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define LOG_TAG "bt_hci_metrics"
+
+#include "hci/hci_metrics_sampler.h"
+
+#include <algorithm>
+
+#include "os/log.h"
+#include "os/system_properties.h"
+
+namespace bluetooth::hci {
+
+static constexpr char kSampleRateProperty[] = "bluetooth.hci.metrics_sample_rate";
+
+HciMetricsSampler::HciMetricsSampler(
+    uint32_t sample_rate, std::chrono::milliseconds flush_interval, NowFunc now_func)
+    : sample_rate_(std::max<uint32_t>(sample_rate, 1)),
+      flush_interval_(flush_interval),
+      now_func_(now_func),
+      last_flush_(now_func()) {}
+
+HciMetricsSampler& HciMetricsSampler::Get() {
+  static HciMetricsSampler* sampler =
+      new HciMetricsSampler(os::GetSystemPropertyUint32(kSampleRateProperty, kDefaultSampleRate));
+  return *sampler;
+}
+
+bool HciMetricsSampler::IsHighFrequency(OpCode op_code) {
+  switch (op_code) {
+    case OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST:
+    case OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST:
+    case OpCode::LE_CLEAR_FILTER_ACCEPT_LIST:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool HciMetricsSampler::Sample(OpCode op_code, uint16_t event_code, ErrorCode status) {
+  if (!IsHighFrequency(op_code)) {
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (now_func_() - last_flush_ >= flush_interval_) {
+    FlushLocked();
+  }
+
+  Counts& counts = counts_[{op_code, event_code, status}];
+  // Sent commands and their command complete carry no parsed status
+  bool failed = status != ErrorCode::SUCCESS && status != ErrorCode::UNKNOWN_HCI_COMMAND &&
+                status != ErrorCode::STATUS_UNKNOWN;
+  bool upload = failed || counts.count % sample_rate_ == 0;
+  counts.count++;
+  if (upload) {
+    counts.uploaded++;
+  }
+  return upload;
+}
+
+void HciMetricsSampler::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushLocked();
+}
+
+void HciMetricsSampler::FlushLocked() {
+  for (const auto& [key, counts] : counts_) {
+    const auto& [op_code, event_code, status] = key;
+    LOG_INFO(
+        "%s event:0x%02hx status:%s count:%llu uploaded:%llu",
+        OpCodeText(op_code).c_str(),
+        event_code,
+        ErrorCodeText(status).c_str(),
+        static_cast<unsigned long long>(counts.count),
+        static_cast<unsigned long long>(counts.uploaded));
+  }
+  counts_.clear();
+  last_flush_ = now_func_();
+}
+
+uint64_t HciMetricsSampler::GetCount(OpCode op_code, uint16_t event_code, ErrorCode status) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = counts_.find({op_code, event_code, status});
+  return it == counts_.end() ? 0 : it->second.count;
+}
+
+}  // namespace bluetooth::hci
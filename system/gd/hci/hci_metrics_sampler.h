@@ -0,0 +1,82 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "hci/hci_packets.h"
+
+namespace bluetooth::hci {
+
+/// Samples the metrics of the commands that are sent at a high rate, such as
+/// the filter accept list updates of background connections and scanning.
+///
+/// Every occurrence is counted in memory per op code, event and status. Only
+/// one in |sample_rate| successful occurrences is uploaded, failures are
+/// always uploaded. The counts are flushed to the log in one batch once per
+/// flush interval, as occurrences come in.
+class HciMetricsSampler {
+ public:
+  static constexpr uint32_t kDefaultSampleRate = 10;
+  static constexpr std::chrono::minutes kDefaultFlushInterval{15};
+
+  using ClockType = std::chrono::steady_clock;
+  using NowFunc = ClockType::time_point (*)();
+
+  explicit HciMetricsSampler(
+      uint32_t sample_rate = kDefaultSampleRate,
+      std::chrono::milliseconds flush_interval = kDefaultFlushInterval,
+      NowFunc now_func = ClockType::now);
+  HciMetricsSampler(const HciMetricsSampler&) = delete;
+  HciMetricsSampler& operator=(const HciMetricsSampler&) = delete;
+
+  /// The sampler used by the HCI metrics, with the sample rate of the
+  /// bluetooth.hci.metrics_sample_rate property. A rate of 1 uploads all.
+  static HciMetricsSampler& Get();
+
+  /// Counts an occurrence. Returns true if it must be uploaded.
+  bool Sample(OpCode op_code, uint16_t event_code, ErrorCode status);
+
+  /// Logs the counts since the last flush, and resets them.
+  void Flush();
+
+  /// Occurrences counted since the last flush.
+  uint64_t GetCount(OpCode op_code, uint16_t event_code, ErrorCode status) const;
+
+  static bool IsHighFrequency(OpCode op_code);
+
+ private:
+  struct Counts {
+    uint64_t count = 0;
+    uint64_t uploaded = 0;
+  };
+  using Key = std::tuple<OpCode, uint16_t, ErrorCode>;
+
+  void FlushLocked();
+
+  const uint32_t sample_rate_;
+  const std::chrono::milliseconds flush_interval_;
+  const NowFunc now_func_;
+  mutable std::mutex mutex_;
+  std::map<Key, Counts> counts_;
+  ClockType::time_point last_flush_;
+};
+
+}  // namespace bluetooth::hci
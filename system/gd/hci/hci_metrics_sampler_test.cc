@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/hci_metrics_sampler.h"
+
+#include <gtest/gtest.h>
+
+namespace testing {
+
+using bluetooth::hci::ErrorCode;
+using bluetooth::hci::HciMetricsSampler;
+using bluetooth::hci::OpCode;
+
+static constexpr uint16_t kCommandComplete = 0x0e;
+static constexpr uint16_t kCommandStatus = 0x0f;
+
+static HciMetricsSampler::ClockType::time_point fake_now;
+
+static HciMetricsSampler::ClockType::time_point FakeNow() {
+  return fake_now;
+}
+
+class HciMetricsSamplerTest : public Test {
+ protected:
+  void SetUp() override {
+    fake_now = HciMetricsSampler::ClockType::time_point();
+  }
+
+  HciMetricsSampler sampler_{4, std::chrono::minutes(15), FakeNow};
+};
+
+TEST_F(HciMetricsSamplerTest, low_frequency_always_uploaded) {
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(sampler_.Sample(OpCode::CREATE_CONNECTION, kCommandStatus, ErrorCode::SUCCESS));
+  }
+  ASSERT_EQ(sampler_.GetCount(OpCode::CREATE_CONNECTION, kCommandStatus, ErrorCode::SUCCESS), 0u);
+}
+
+TEST_F(HciMetricsSamplerTest, success_sampled) {
+  int uploaded = 0;
+  for (int i = 0; i < 12; i++) {
+    if (sampler_.Sample(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS)) {
+      uploaded++;
+    }
+  }
+  ASSERT_EQ(uploaded, 3);
+  ASSERT_EQ(sampler_.GetCount(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS), 12u);
+}
+
+TEST_F(HciMetricsSamplerTest, failure_always_uploaded) {
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(sampler_.Sample(
+        OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST, kCommandStatus, ErrorCode::COMMAND_DISALLOWED));
+  }
+  ASSERT_EQ(
+      sampler_.GetCount(
+          OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST, kCommandStatus, ErrorCode::COMMAND_DISALLOWED),
+      10u);
+}
+
+TEST_F(HciMetricsSamplerTest, flushed_after_interval) {
+  sampler_.Sample(OpCode::LE_CLEAR_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS);
+  sampler_.Sample(OpCode::LE_CLEAR_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS);
+  fake_now += std::chrono::minutes(14);
+  sampler_.Sample(OpCode::LE_CLEAR_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS);
+  ASSERT_EQ(sampler_.GetCount(OpCode::LE_CLEAR_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS), 3u);
+
+  fake_now += std::chrono::minutes(1);
+  // The first occurrence after a flush is uploaded
+  ASSERT_TRUE(sampler_.Sample(OpCode::LE_CLEAR_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS));
+  ASSERT_EQ(sampler_.GetCount(OpCode::LE_CLEAR_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS), 1u);
+
+  sampler_.Flush();
+  ASSERT_EQ(sampler_.GetCount(OpCode::LE_CLEAR_FILTER_ACCEPT_LIST, kCommandComplete, ErrorCode::SUCCESS), 0u);
+}
+
+}  // namespace testing
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <forward_list>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/packet_corpus.h"
+#include "hci/hci_packets.h"
+#include "os/log.h"
+#include "packet/bit_inserter.h"
+#include "packet/view.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+
+// Compares parsing the same event from a single fragment, which takes the contiguous fast path of
+// packet::Iterator, against the same bytes split in two fragments, which walks the fragment list.
+class BM_HciEventParsing : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    std::vector<CompletedPackets> completed_packets;
+    for (uint16_t handle = 0; handle < kNumHandles; handle++) {
+      CompletedPackets cp;
+      cp.connection_handle_ = handle;
+      cp.host_num_of_completed_packets_ = 1;
+      completed_packets.push_back(cp);
+    }
+    auto builder = NumberOfCompletedPacketsBuilder::Create(completed_packets);
+    bytes_ = std::make_shared<std::vector<uint8_t>>();
+    packet::BitInserter it(*bytes_);
+    builder->Serialize(it);
+  }
+
+  void TearDown(State& st) override {
+    bytes_.reset();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void Parse(State& state, const PacketView<kLittleEndian>& packet) {
+    for (auto _ : state) {
+      auto event = NumberOfCompletedPacketsView::Create(EventView::Create(packet));
+      ASSERT(event.IsValid());
+      auto completed_packets = event.GetCompletedPackets();
+      ::benchmark::DoNotOptimize(completed_packets);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes_->size());
+  }
+
+  static constexpr uint16_t kNumHandles = 16;
+  std::shared_ptr<std::vector<uint8_t>> bytes_;
+};
+
+BENCHMARK_F(BM_HciEventParsing, single_fragment)(State& state) {
+  Parse(state, PacketView<kLittleEndian>(bytes_));
+}
+
+BENCHMARK_F(BM_HciEventParsing, two_fragments)(State& state) {
+  size_t half = bytes_->size() / 2;
+  std::forward_list<packet::View> fragments;
+  fragments.emplace_front(bytes_, half, bytes_->size());
+  fragments.emplace_front(bytes_, 0, half);
+  Parse(state, PacketView<kLittleEndian>(fragments));
+}
+
+// Parses the events of the corpus the stack handles the most
+class BM_HciEventCorpus : public ::benchmark::Fixture {
+ protected:
+  // Parse the event with parse() on each iteration, which returns the view or the fields it read
+  template <typename Parse>
+  void Run(State& state, const std::vector<uint8_t>& event, Parse parse) {
+    auto bytes = std::make_shared<std::vector<uint8_t>>(event);
+    PacketView<kLittleEndian> packet(bytes);
+    for (auto _ : state) {
+      auto parsed = parse(EventView::Create(packet));
+      ::benchmark::DoNotOptimize(parsed);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes->size());
+  }
+};
+
+BENCHMARK_F(BM_HciEventCorpus, command_complete)(State& state) {
+  Run(state, benchmark::corpus::kReadBdAddrComplete, [](EventView event) {
+    auto view = ReadBdAddrCompleteView::Create(CommandCompleteView::Create(event));
+    ASSERT(view.IsValid());
+    return view.GetBdAddr();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, command_status)(State& state) {
+  Run(state, benchmark::corpus::kCreateConnectionStatus, [](EventView event) {
+    auto view = CreateConnectionStatusView::Create(CommandStatusView::Create(event));
+    ASSERT(view.IsValid());
+    return view.GetStatus();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, number_of_completed_packets)(State& state) {
+  Run(state, benchmark::corpus::kNumberOfCompletedPackets, [](EventView event) {
+    auto view = NumberOfCompletedPacketsView::Create(event);
+    ASSERT(view.IsValid());
+    return view.GetCompletedPackets();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, connection_complete)(State& state) {
+  Run(state, benchmark::corpus::kConnectionComplete, [](EventView event) {
+    auto view = ConnectionCompleteView::Create(event);
+    ASSERT(view.IsValid());
+    return view.GetBdAddr();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, disconnection_complete)(State& state) {
+  Run(state, benchmark::corpus::kDisconnectionComplete, [](EventView event) {
+    auto view = DisconnectionCompleteView::Create(event);
+    ASSERT(view.IsValid());
+    return view.GetReason();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, le_enhanced_connection_complete)(State& state) {
+  Run(state, benchmark::corpus::kLeEnhancedConnectionComplete, [](EventView event) {
+    auto view = LeEnhancedConnectionCompleteView::Create(LeMetaEventView::Create(event));
+    ASSERT(view.IsValid());
+    return view.GetPeerAddress();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, le_advertising_report)(State& state) {
+  Run(state, benchmark::corpus::kLeAdvertisingReport, [](EventView event) {
+    auto view = LeAdvertisingReportView::Create(LeMetaEventView::Create(event));
+    ASSERT(view.IsValid());
+    return view.GetResponses();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, le_advertising_report_raw)(State& state) {
+  Run(state, benchmark::corpus::kLeAdvertisingReport, [](EventView event) {
+    auto view = LeAdvertisingReportRawView::Create(LeMetaEventView::Create(event));
+    ASSERT(view.IsValid());
+    return view.GetResponses();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, le_extended_advertising_report)(State& state) {
+  Run(state, benchmark::corpus::kLeExtendedAdvertisingReport, [](EventView event) {
+    auto view = LeExtendedAdvertisingReportView::Create(LeMetaEventView::Create(event));
+    ASSERT(view.IsValid());
+    return view.GetResponses();
+  });
+}
+
+BENCHMARK_F(BM_HciEventCorpus, le_extended_advertising_report_raw)(State& state) {
+  Run(state, benchmark::corpus::kLeExtendedAdvertisingReport, [](EventView event) {
+    auto view = LeExtendedAdvertisingReportRawView::Create(LeMetaEventView::Create(event));
+    ASSERT(view.IsValid());
+    return view.GetResponses();
+  });
+}
+
+}  // namespace hci
+}  // namespace bluetooth
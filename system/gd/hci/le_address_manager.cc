@@ -463,9 +463,9 @@ void LeAddressManager::handle_next_command() {
 
 void LeAddressManager::AddDeviceToFilterAcceptList(
     FilterAcceptListAddressType connect_list_address_type, bluetooth::hci::Address address) {
-  auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(connect_list_address_type, address);
-  Command command = {CommandType::ADD_DEVICE_TO_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
+  handler_->BindOnceOn(
+              this, &LeAddressManager::add_device_to_filter_accept_list, connect_list_address_type, address)
+      .Invoke();
 }
 
 void LeAddressManager::AddDeviceToResolvingList(
@@ -473,100 +473,214 @@ void LeAddressManager::AddDeviceToResolvingList(
     Address peer_identity_address,
     const std::array<uint8_t, 16>& peer_irk,
     const std::array<uint8_t, 16>& local_irk) {
-  if (!supports_ble_privacy_) {
-    return;
-  }
+  handler_
+      ->BindOnceOn(
+          this,
+          &LeAddressManager::add_device_to_resolving_list,
+          peer_identity_address_type,
+          peer_identity_address,
+          peer_irk,
+          local_irk)
+      .Invoke();
+}
 
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
+void LeAddressManager::RemoveDeviceFromFilterAcceptList(
+    FilterAcceptListAddressType connect_list_address_type, bluetooth::hci::Address address) {
+  handler_
+      ->BindOnceOn(
+          this, &LeAddressManager::remove_device_from_filter_accept_list, connect_list_address_type, address)
+      .Invoke();
+}
 
-  auto packet_builder = hci::LeAddDeviceToResolvingListBuilder::Create(
-      peer_identity_address_type, peer_identity_address, peer_irk, local_irk);
-  Command command = {CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+void LeAddressManager::RemoveDeviceFromResolvingList(
+    PeerAddressType peer_identity_address_type, Address peer_identity_address) {
+  handler_
+      ->BindOnceOn(
+          this, &LeAddressManager::remove_device_from_resolving_list, peer_identity_address_type, peer_identity_address)
+      .Invoke();
+}
+
+void LeAddressManager::ClearFilterAcceptList() {
+  handler_->BindOnceOn(this, &LeAddressManager::clear_filter_accept_list).Invoke();
+}
 
-  if (supports_ble_privacy_) {
-    auto packet_builder =
-        hci::LeSetPrivacyModeBuilder::Create(peer_identity_address_type, peer_identity_address, PrivacyMode::DEVICE);
-    Command command = {CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(packet_builder)}};
-    cached_commands_.push(std::move(command));
+void LeAddressManager::ClearResolvingList() {
+  handler_->BindOnceOn(this, &LeAddressManager::clear_resolving_list).Invoke();
+}
+
+void LeAddressManager::BeginListChanges() {
+  handler_->BindOnceOn(this, &LeAddressManager::begin_list_changes).Invoke();
+}
+
+void LeAddressManager::CommitListChanges() {
+  handler_->BindOnceOn(this, &LeAddressManager::commit_list_changes).Invoke();
+}
+
+void LeAddressManager::begin_list_changes() {
+  if (list_changes_depth_++ == 0) {
+    pending_list_state_ = list_state_;
+    accept_list_cleared_ = false;
+    resolving_list_cleared_ = false;
   }
+}
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+void LeAddressManager::commit_list_changes() {
+  ASSERT_LOG(list_changes_depth_ > 0, "No list changes to commit");
+  if (--list_changes_depth_ > 0) {
+    return;
+  }
+
+  size_t num_cached_commands = cached_commands_.size();
+  push_accept_list_changes();
+  push_resolving_list_changes();
+  list_state_ = std::move(pending_list_state_);
+  pending_list_state_ = {};
+  if (cached_commands_.size() == num_cached_commands) {
+    LOG_DEBUG("The list changes cancel each other, nothing to send");
+    return;
+  }
 
   if (registered_clients_.empty()) {
-    handler_->BindOnceOn(this, &LeAddressManager::handle_next_command).Invoke();
+    handle_next_command();
   } else {
-    handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
+    pause_registered_clients();
   }
 }
 
-void LeAddressManager::RemoveDeviceFromFilterAcceptList(
-    FilterAcceptListAddressType connect_list_address_type, bluetooth::hci::Address address) {
-  auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(connect_list_address_type, address);
-  Command command = {CommandType::REMOVE_DEVICE_FROM_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
+// The single changes open a transaction, and commit it from the handler: the changes already posted to the handler
+// are applied in the same pause.
+void LeAddressManager::add_device_to_filter_accept_list(
+    FilterAcceptListAddressType connect_list_address_type, Address address) {
+  begin_list_changes();
+  pending_list_state_.accept_list.insert({connect_list_address_type, address});
+  handler_->BindOnceOn(this, &LeAddressManager::commit_list_changes).Invoke();
 }
 
-void LeAddressManager::RemoveDeviceFromResolvingList(
+void LeAddressManager::add_device_to_resolving_list(
+    PeerAddressType peer_identity_address_type,
+    Address peer_identity_address,
+    const std::array<uint8_t, 16>& peer_irk,
+    const std::array<uint8_t, 16>& local_irk) {
+  if (!supports_ble_privacy_) {
+    return;
+  }
+  begin_list_changes();
+  pending_list_state_.resolving_list[{peer_identity_address_type, peer_identity_address}] = {peer_irk, local_irk};
+  handler_->BindOnceOn(this, &LeAddressManager::commit_list_changes).Invoke();
+}
+
+void LeAddressManager::remove_device_from_filter_accept_list(
+    FilterAcceptListAddressType connect_list_address_type, Address address) {
+  begin_list_changes();
+  pending_list_state_.accept_list.erase({connect_list_address_type, address});
+  handler_->BindOnceOn(this, &LeAddressManager::commit_list_changes).Invoke();
+}
+
+void LeAddressManager::remove_device_from_resolving_list(
     PeerAddressType peer_identity_address_type, Address peer_identity_address) {
   if (!supports_ble_privacy_) {
     return;
   }
+  begin_list_changes();
+  pending_list_state_.resolving_list.erase({peer_identity_address_type, peer_identity_address});
+  handler_->BindOnceOn(this, &LeAddressManager::commit_list_changes).Invoke();
+}
 
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
+void LeAddressManager::clear_filter_accept_list() {
+  begin_list_changes();
+  // The controller list is cleared even if it is known to be empty
+  pending_list_state_.accept_list.clear();
+  accept_list_cleared_ = true;
+  handler_->BindOnceOn(this, &LeAddressManager::commit_list_changes).Invoke();
+}
 
-  auto packet_builder =
-      hci::LeRemoveDeviceFromResolvingListBuilder::Create(peer_identity_address_type, peer_identity_address);
-  Command command = {CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+void LeAddressManager::clear_resolving_list() {
+  if (!supports_ble_privacy_) {
+    return;
+  }
+  begin_list_changes();
+  pending_list_state_.resolving_list.clear();
+  resolving_list_cleared_ = true;
+  handler_->BindOnceOn(this, &LeAddressManager::commit_list_changes).Invoke();
+}
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+void LeAddressManager::push_accept_list_changes() {
+  const auto& current = accept_list_cleared_ ? std::set<AcceptListEntry>{} : list_state_.accept_list;
+  const auto& pending = pending_list_state_.accept_list;
 
-  if (registered_clients_.empty()) {
-    handler_->BindOnceOn(this, &LeAddressManager::handle_next_command).Invoke();
-  } else {
-    handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
+  if (accept_list_cleared_) {
+    auto packet_builder = hci::LeClearFilterAcceptListBuilder::Create();
+    cached_commands_.push({CommandType::CLEAR_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+  }
+  // Remove first, to make room in the controller list
+  for (const auto& [address_type, address] : current) {
+    if (pending.count({address_type, address}) == 0) {
+      auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(address_type, address);
+      cached_commands_.push({CommandType::REMOVE_DEVICE_FROM_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+    }
+  }
+  for (const auto& [address_type, address] : pending) {
+    if (current.count({address_type, address}) == 0) {
+      auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(address_type, address);
+      cached_commands_.push({CommandType::ADD_DEVICE_TO_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+    }
   }
 }
 
-void LeAddressManager::ClearFilterAcceptList() {
-  auto packet_builder = hci::LeClearFilterAcceptListBuilder::Create();
-  Command command = {CommandType::CLEAR_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
+void LeAddressManager::push_add_device_to_resolving_list(
+    const ResolvingListEntry& entry, const ResolvingListKeys& keys) {
+  auto packet_builder =
+      hci::LeAddDeviceToResolvingListBuilder::Create(entry.first, entry.second, keys.peer_irk, keys.local_irk);
+  cached_commands_.push({CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+
+  auto privacy_mode_builder = hci::LeSetPrivacyModeBuilder::Create(entry.first, entry.second, PrivacyMode::DEVICE);
+  cached_commands_.push({CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(privacy_mode_builder)}});
 }
 
-void LeAddressManager::ClearResolvingList() {
+void LeAddressManager::push_resolving_list_changes() {
   if (!supports_ble_privacy_) {
     return;
   }
+  const auto& current = resolving_list_cleared_ ? std::map<ResolvingListEntry, ResolvingListKeys>{}
+                                                : list_state_.resolving_list;
+  const auto& pending = pending_list_state_.resolving_list;
 
-  // Disable Address resolution
+  std::vector<const ResolvingListEntry*> to_remove;
+  std::vector<std::pair<const ResolvingListEntry*, const ResolvingListKeys*>> to_add;
+  for (const auto& [entry, keys] : current) {
+    auto it = pending.find(entry);
+    if (it == pending.end() || !(it->second == keys)) {
+      to_remove.push_back(&entry);
+    }
+  }
+  for (const auto& [entry, keys] : pending) {
+    auto it = current.find(entry);
+    if (it == current.end() || !(it->second == keys)) {
+      to_add.push_back({&entry, &keys});
+    }
+  }
+  if (!resolving_list_cleared_ && to_remove.empty() && to_add.empty()) {
+    return;
+  }
+
+  // The resolving list can only be changed while the address resolution is disabled
   auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
+  cached_commands_.push({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}});
 
-  auto packet_builder = hci::LeClearResolvingListBuilder::Create();
-  Command command = {CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+  if (resolving_list_cleared_) {
+    auto packet_builder = hci::LeClearResolvingListBuilder::Create();
+    cached_commands_.push({CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+  }
+  for (const auto* entry : to_remove) {
+    auto packet_builder = hci::LeRemoveDeviceFromResolvingListBuilder::Create(entry->first, entry->second);
+    cached_commands_.push({CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+  }
+  for (const auto& [entry, keys] : to_add) {
+    push_add_device_to_resolving_list(*entry, *keys);
+  }
 
-  // Enable Address resolution
   auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
-
-  handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
+  cached_commands_.push({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}});
 }
 
 template <class View>
@@ -15,9 +15,11 @@
  */
 #pragma once
 
+#include <array>
 #include <map>
 #include <mutex>
 #include <set>
+#include <utility>
 #include <variant>
 
 #include "common/callback.h"
@@ -96,6 +98,12 @@ class LeAddressManager {
   void RemoveDeviceFromResolvingList(PeerAddressType peer_identity_address_type, Address peer_identity_address);
   void ClearFilterAcceptList();
   void ClearResolvingList();
+  // The filter accept list and resolving list changes made between BeginListChanges() and CommitListChanges() are
+  // sent to the controller together, in a single pause of the clients. Only their net effect on the lists is sent,
+  // and the address resolution is disabled once for all the resolving list changes. Changes made outside of a
+  // transaction are also grouped with the changes that follow them on the handler.
+  void BeginListChanges();
+  void CommitListChanges();
   void OnCommandComplete(CommandCompleteView view);
   std::chrono::milliseconds GetNextPrivateAddressIntervalMs();
 
@@ -147,8 +155,39 @@ class LeAddressManager {
     std::variant<RotateRandomAddressCommand, UpdateIRKCommand, HCICommand> contents;
   };
 
+  using AcceptListEntry = std::pair<FilterAcceptListAddressType, Address>;
+  using ResolvingListEntry = std::pair<PeerAddressType, Address>;
+  struct ResolvingListKeys {
+    std::array<uint8_t, 16> peer_irk;
+    std::array<uint8_t, 16> local_irk;
+    bool operator==(const ResolvingListKeys& other) const {
+      return peer_irk == other.peer_irk && local_irk == other.local_irk;
+    }
+  };
+
+  // The lists as requested from the controller, and as they will be once the open transaction is committed
+  struct ListState {
+    std::set<AcceptListEntry> accept_list;
+    std::map<ResolvingListEntry, ResolvingListKeys> resolving_list;
+  };
+
   void pause_registered_clients();
   void push_command(Command command);
+  void begin_list_changes();
+  void commit_list_changes();
+  void add_device_to_filter_accept_list(FilterAcceptListAddressType connect_list_address_type, Address address);
+  void add_device_to_resolving_list(
+      PeerAddressType peer_identity_address_type,
+      Address peer_identity_address,
+      const std::array<uint8_t, 16>& peer_irk,
+      const std::array<uint8_t, 16>& local_irk);
+  void remove_device_from_filter_accept_list(FilterAcceptListAddressType connect_list_address_type, Address address);
+  void remove_device_from_resolving_list(PeerAddressType peer_identity_address_type, Address peer_identity_address);
+  void clear_filter_accept_list();
+  void clear_resolving_list();
+  void push_accept_list_changes();
+  void push_resolving_list_changes();
+  void push_add_device_to_resolving_list(const ResolvingListEntry& entry, const ResolvingListKeys& keys);
   void ack_pause(LeAddressManagerCallback* callback);
   void resume_registered_clients();
   void ack_resume(LeAddressManagerCallback* callback);
@@ -180,6 +219,12 @@ class LeAddressManager {
   uint8_t resolving_list_size_;
   std::queue<Command> cached_commands_;
   bool supports_ble_privacy_{false};
+
+  ListState list_state_;
+  ListState pending_list_state_;
+  bool accept_list_cleared_{false};
+  bool resolving_list_cleared_{false};
+  int list_changes_depth_{0};
 };
 
 }  // namespace hci
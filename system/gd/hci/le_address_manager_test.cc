@@ -98,6 +98,11 @@ class TestHciLayer : public HciLayer {
     return command_packet_view;
   }
 
+  size_t CommandQueueSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return command_queue_.size();
+  }
+
   void IncomingEvent(std::unique_ptr<EventBuilder> event_builder) {
     auto packet = GetPacketView(std::move(event_builder));
     EventView event = EventView::Create(packet);
@@ -390,6 +395,30 @@ TEST_F(LeAddressManagerWithSingleClientTest, clear_filter_accept_list) {
   clients[0].get()->WaitForResume();
 }
 
+TEST_F(LeAddressManagerWithSingleClientTest, list_changes_are_sent_together) {
+  Address address_a;
+  Address::FromString("01:02:03:04:05:06", address_a);
+  Address address_b;
+  Address::FromString("01:02:03:04:05:07", address_b);
+  ASSERT_NO_FATAL_FAILURE(test_hci_layer_->SetCommandFuture());
+  le_address_manager_->BeginListChanges();
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address_a);
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address_b);
+  le_address_manager_->RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType::RANDOM, address_a);
+  le_address_manager_->CommitListChanges();
+
+  // Only the net change is sent
+  auto packet = test_hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  auto packet_view = LeAddDeviceToFilterAcceptListView::Create(
+      LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(address_b, packet_view.GetAddress());
+  test_hci_layer_->IncomingEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+  sync_handler(handler_);
+  ASSERT_EQ(0UL, test_hci_layer_->CommandQueueSize());
+}
+
 // b/260916288
 TEST_F(LeAddressManagerWithSingleClientTest, DISABLED_add_device_to_resolving_list) {
   Address address;
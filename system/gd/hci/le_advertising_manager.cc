@@ -15,8 +15,12 @@
  */
 #include "hci/le_advertising_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include "common/init_flags.h"
 #include "common/strings.h"
@@ -26,6 +30,7 @@
 #include "hci/hci_packets.h"
 #include "hci/le_advertising_interface.h"
 #include "hci/vendor_specific_event_manager.h"
+#include "hci_le_advertising_manager_generated.h"
 #include "module.h"
 #include "os/handler.h"
 #include "os/log.h"
@@ -41,6 +46,8 @@ constexpr int64_t kLeAdvertisingTxPowerMin = -127;
 constexpr int64_t kLeAdvertisingTxPowerMax = 20;
 constexpr int64_t kLeTxPathLossCompMin = -128;
 constexpr int64_t kLeTxPathLossCompMax = 127;
+// The sets due for an address rotation within that window of each other are rotated together
+constexpr std::chrono::milliseconds kAddressRotationCoalescingWindow = std::chrono::seconds(30);
 
 // system properties
 const std::string kLeTxPathLossCompProperty = "bluetooth.hardware.radio.le_tx_path_loss_comp_db";
@@ -59,6 +66,25 @@ enum class AdvertisingFlag : uint8_t {
   SIMULTANEOUS_LE_AND_BR_EDR_HOST = 0x10,
 };
 
+enum class DataUpdateType {
+  ADVERTISING_DATA,
+  SCAN_RESPONSE_DATA,
+  PERIODIC_DATA,
+};
+
+/**
+ * Updates of one type of data of an advertising set. Only one update is in flight to the controller
+ * at a time; the updates requested meanwhile are coalesced into |pending|, which only keeps the latest
+ * data, and every coalesced request is notified once the pending update completes.
+ */
+struct DataUpdate {
+  bool in_flight = false;
+  // Number of requests carried by the update in flight, and by the pending update.
+  size_t in_flight_requests = 0;
+  size_t pending_requests = 0;
+  std::optional<std::vector<GapData>> pending;
+};
+
 struct Advertiser {
   os::Handler* handler;
   AddressWithType current_address;
@@ -76,7 +102,11 @@ struct Advertiser {
   bool discoverable = false;
   bool directed = false;
   bool in_use = false;
-  std::unique_ptr<os::Alarm> address_rotation_alarm;
+  // When the random address of the set is due for a rotation, unset if it doesn't rotate
+  std::optional<std::chrono::steady_clock::time_point> address_rotation_time;
+  DataUpdate advertising_data_update;
+  DataUpdate scan_response_data_update;
+  DataUpdate periodic_data_update;
 };
 
 /**
@@ -126,6 +156,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     le_maximum_advertising_data_length_ = controller_->GetLeMaximumAdvertisingDataLength();
     acl_manager_ = acl_manager;
     le_address_manager_ = acl_manager->GetLeAddressManager();
+    address_rotation_alarm_ = std::make_unique<os::Alarm>(module_handler_);
     num_instances_ = controller_->GetLeNumberOfSupportedAdverisingSets();
 
     le_advertising_interface_ =
@@ -280,12 +311,8 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
 
     uint8_t advertiser_id = event_view.GetAdvertisingHandle();
 
-    bool was_rotating_address = false;
-    if (advertising_sets_[advertiser_id].address_rotation_alarm != nullptr) {
-      was_rotating_address = true;
-      advertising_sets_[advertiser_id].address_rotation_alarm->Cancel();
-      advertising_sets_[advertiser_id].address_rotation_alarm.reset();
-    }
+    bool was_rotating_address = advertising_sets_[advertiser_id].address_rotation_time.has_value();
+    cancel_address_rotation(advertiser_id);
     enabled_sets_[advertiser_id].advertising_handle_ = kInvalidHandle;
 
     AddressWithType advertiser_address = advertising_sets_[event_view.GetAdvertisingHandle()].current_address;
@@ -316,11 +343,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
           advertising_sets_[advertiser_id].max_extended_advertising_events == 0) {
         LOG_INFO("Reenable advertising");
         if (was_rotating_address) {
-          advertising_sets_[advertiser_id].address_rotation_alarm = std::make_unique<os::Alarm>(module_handler_);
-          advertising_sets_[advertiser_id].address_rotation_alarm->Schedule(
-              common::BindOnce(
-                  &impl::set_advertising_set_random_address_on_timer, common::Unretained(this), advertiser_id),
-              le_address_manager_->GetNextPrivateAddressIntervalMs());
+          schedule_address_rotation(advertiser_id);
         }
         enable_advertiser(advertiser_id, true, 0, 0);
       }
@@ -352,10 +375,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
           hci::LeRemoveAdvertisingSetBuilder::Create(advertiser_id),
           module_handler_->BindOnce(impl::check_status<LeRemoveAdvertisingSetCompleteView>));
 
-      if (advertising_sets_[advertiser_id].address_rotation_alarm != nullptr) {
-        advertising_sets_[advertiser_id].address_rotation_alarm->Cancel();
-        advertising_sets_[advertiser_id].address_rotation_alarm.reset();
-      }
+      cancel_address_rotation(advertiser_id);
     }
     advertising_sets_.erase(advertiser_id);
     if (advertising_sets_.empty() && address_manager_registered) {
@@ -573,11 +593,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       // addresses don't rotate)
       if (advertising_sets_[id].address_type != AdvertiserAddressType::PUBLIC) {
         // start timer for random address
-        advertising_sets_[id].address_rotation_alarm = std::make_unique<os::Alarm>(module_handler_);
-        advertising_sets_[id].address_rotation_alarm->Schedule(
-            common::BindOnce(
-                &impl::set_advertising_set_random_address_on_timer, common::Unretained(this), id),
-            le_address_manager_->GetNextPrivateAddressIntervalMs());
+        schedule_address_rotation(id);
       }
     }
     if (config.advertising_type == AdvertisingType::ADV_IND ||
@@ -660,45 +676,98 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
-  void set_advertising_set_random_address_on_timer(AdvertiserId advertiser_id) {
-    // This function should only be trigger by enabled advertising set or IRK rotation
-    if (enabled_sets_[advertiser_id].advertising_handle_ == kInvalidHandle) {
-      if (advertising_sets_[advertiser_id].address_rotation_alarm != nullptr) {
-        advertising_sets_[advertiser_id].address_rotation_alarm->Cancel();
-        advertising_sets_[advertiser_id].address_rotation_alarm.reset();
+  void schedule_address_rotation(AdvertiserId advertiser_id) {
+    advertising_sets_[advertiser_id].address_rotation_time =
+        std::chrono::steady_clock::now() + le_address_manager_->GetNextPrivateAddressIntervalMs();
+    schedule_address_rotation_alarm();
+  }
+
+  void cancel_address_rotation(AdvertiserId advertiser_id) {
+    auto it = advertising_sets_.find(advertiser_id);
+    if (it == advertising_sets_.end() || !it->second.address_rotation_time.has_value()) {
+      return;
+    }
+    it->second.address_rotation_time.reset();
+    schedule_address_rotation_alarm();
+  }
+
+  // Schedules the alarm for the earliest rotation of all the sets
+  void schedule_address_rotation_alarm() {
+    std::optional<std::chrono::steady_clock::time_point> next_rotation_time;
+    for (const auto& [id, advertising_set] : advertising_sets_) {
+      if (advertising_set.address_rotation_time.has_value() &&
+          (!next_rotation_time.has_value() || advertising_set.address_rotation_time < next_rotation_time)) {
+        next_rotation_time = advertising_set.address_rotation_time;
       }
+    }
+    if (!next_rotation_time.has_value()) {
+      address_rotation_alarm_->Cancel();
       return;
     }
+    // A zero delay would disarm the alarm
+    auto delay = std::max(
+        std::chrono::milliseconds(1),
+        std::chrono::duration_cast<std::chrono::milliseconds>(*next_rotation_time - std::chrono::steady_clock::now()));
+    address_rotation_alarm_->Schedule(
+        common::BindOnce(&impl::rotate_due_addresses, common::Unretained(this)), delay);
+  }
 
-    // TODO handle duration and max_extended_advertising_events_
-    EnabledSet curr_set;
-    curr_set.advertising_handle_ = advertiser_id;
-    curr_set.duration_ = advertising_sets_[advertiser_id].duration;
-    curr_set.max_extended_advertising_events_ = advertising_sets_[advertiser_id].max_extended_advertising_events;
-    std::vector<EnabledSet> enabled_sets = {curr_set};
+  // Rotates the addresses of all the sets due within kAddressRotationCoalescingWindow, so that the connectable ones
+  // are disabled and enabled again once for all of them. They are due again together, for the next rotation to be
+  // coalesced too.
+  void rotate_due_addresses() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<AdvertiserId> due_sets;
+    std::vector<EnabledSet> connectable_sets;
+    for (auto& [id, advertising_set] : advertising_sets_) {
+      if (!advertising_set.address_rotation_time.has_value() ||
+          *advertising_set.address_rotation_time > now + kAddressRotationCoalescingWindow) {
+        continue;
+      }
+      // This should only be trigger by enabled advertising set or IRK rotation
+      if (enabled_sets_[id].advertising_handle_ == kInvalidHandle) {
+        advertising_set.address_rotation_time.reset();
+        continue;
+      }
+      due_sets.push_back(id);
+
+      // TODO handle duration and max_extended_advertising_events_
+      if (advertising_set.connectable) {
+        EnabledSet curr_set;
+        curr_set.advertising_handle_ = id;
+        curr_set.duration_ = advertising_set.duration;
+        curr_set.max_extended_advertising_events_ = advertising_set.max_extended_advertising_events;
+        connectable_sets.push_back(curr_set);
+      }
+    }
 
     // For connectable advertising, we should disable it first
-    if (advertising_sets_[advertiser_id].connectable) {
+    if (!connectable_sets.empty()) {
       le_advertising_interface_->EnqueueCommand(
-          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::DISABLED, enabled_sets),
+          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::DISABLED, connectable_sets),
           module_handler_->BindOnce(impl::check_status<LeSetExtendedAdvertisingEnableCompleteView>));
     }
 
-    rotate_advertiser_address(advertiser_id);
+    auto next_rotation_time = now + le_address_manager_->GetNextPrivateAddressIntervalMs();
+    for (AdvertiserId id : due_sets) {
+      rotate_advertiser_address(id);
+      advertising_sets_[id].address_rotation_time = next_rotation_time;
+    }
 
     // If we are paused, we will be enabled in OnResume(), so don't resume now.
     // Note that OnResume() can never re-enable us while we are changing our address, since the
     // DISABLED and ENABLED commands are enqueued synchronously, so OnResume() doesn't need an
     // analogous check.
-    if (advertising_sets_[advertiser_id].connectable && !paused) {
+    if (!connectable_sets.empty() && !paused) {
       le_advertising_interface_->EnqueueCommand(
-          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::ENABLED, enabled_sets),
+          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::ENABLED, connectable_sets),
           module_handler_->BindOnce(impl::check_status<LeSetExtendedAdvertisingEnableCompleteView>));
     }
 
-    advertising_sets_[advertiser_id].address_rotation_alarm->Schedule(
-        common::BindOnce(&impl::set_advertising_set_random_address_on_timer, common::Unretained(this), advertiser_id),
-        le_address_manager_->GetNextPrivateAddressIntervalMs());
+    if (due_sets.size() > 1) {
+      LOG_INFO("Rotated the addresses of %zu advertising sets together", due_sets.size());
+    }
+    schedule_address_rotation_alarm();
   }
 
   void register_advertiser(
@@ -904,6 +973,141 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
   };
 
   void set_data(AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data) {
+    request_data_update(
+        advertiser_id,
+        set_scan_rsp ? DataUpdateType::SCAN_RESPONSE_DATA : DataUpdateType::ADVERTISING_DATA,
+        std::move(data));
+  }
+
+  static DataUpdate& get_data_update(Advertiser& advertiser, DataUpdateType type) {
+    switch (type) {
+      case DataUpdateType::ADVERTISING_DATA:
+        return advertiser.advertising_data_update;
+      case DataUpdateType::SCAN_RESPONSE_DATA:
+        return advertiser.scan_response_data_update;
+      case DataUpdateType::PERIODIC_DATA:
+        return advertiser.periodic_data_update;
+    }
+    LOG_ALWAYS_FATAL("unreachable");
+  }
+
+  void request_data_update(AdvertiserId advertiser_id, DataUpdateType type, std::vector<GapData> data) {
+    data_updates_requested_++;
+    DataUpdate& update = get_data_update(advertising_sets_[advertiser_id], type);
+    if (update.in_flight) {
+      if (update.pending.has_value()) {
+        data_updates_superseded_++;
+      }
+      update.pending = std::move(data);
+      update.pending_requests++;
+      return;
+    }
+    send_data_update(advertiser_id, type, std::move(data), 1);
+  }
+
+  void send_data_update(AdvertiserId advertiser_id, DataUpdateType type, std::vector<GapData> data, size_t requests) {
+    AdvertisingCallback::AdvertisingStatus status =
+        type == DataUpdateType::PERIODIC_DATA
+            ? send_periodic_data(advertiser_id, std::move(data))
+            : send_data(advertiser_id, type == DataUpdateType::SCAN_RESPONSE_DATA, std::move(data));
+    if (status != AdvertisingCallback::AdvertisingStatus::SUCCESS) {
+      notify_data_update(advertiser_id, type, status, requests);
+      return;
+    }
+    DataUpdate& update = get_data_update(advertising_sets_[advertiser_id], type);
+    update.in_flight = true;
+    update.in_flight_requests = requests;
+  }
+
+  void send_pending_data_update(AdvertiserId advertiser_id, DataUpdateType type) {
+    auto advertiser = advertising_sets_.find(advertiser_id);
+    if (advertiser == advertising_sets_.end()) {
+      return;
+    }
+    DataUpdate& update = get_data_update(advertiser->second, type);
+    if (!update.pending.has_value()) {
+      return;
+    }
+    std::vector<GapData> data = std::move(*update.pending);
+    size_t requests = update.pending_requests;
+    update.pending.reset();
+    update.pending_requests = 0;
+    update.in_flight = false;
+    send_data_update(advertiser_id, type, std::move(data), requests);
+  }
+
+  /// Returns the number of requests completed by the update in flight.
+  size_t complete_data_update(AdvertiserId advertiser_id, DataUpdateType type) {
+    auto advertiser = advertising_sets_.find(advertiser_id);
+    if (advertiser == advertising_sets_.end()) {
+      return 1;
+    }
+    DataUpdate& update = get_data_update(advertiser->second, type);
+    size_t requests = std::max<size_t>(update.in_flight_requests, 1);
+    update.in_flight_requests = 0;
+    if (update.pending.has_value()) {
+      // Stays in flight until the pending update is sent, after the completed requests are notified,
+      // so that requests made in between are still coalesced behind it.
+      module_handler_->CallOn(this, &impl::send_pending_data_update, advertiser_id, type);
+    } else {
+      update.in_flight = false;
+    }
+    return requests;
+  }
+
+  void notify_data_update(
+      AdvertiserId advertiser_id,
+      DataUpdateType type,
+      AdvertisingCallback::AdvertisingStatus status,
+      size_t requests) {
+    if (advertising_callbacks_ == nullptr) {
+      return;
+    }
+    for (size_t i = 0; i < requests; i++) {
+      switch (type) {
+        case DataUpdateType::ADVERTISING_DATA:
+          advertising_callbacks_->OnAdvertisingDataSet(advertiser_id, status);
+          break;
+        case DataUpdateType::SCAN_RESPONSE_DATA:
+          advertising_callbacks_->OnScanResponseDataSet(advertiser_id, status);
+          break;
+        case DataUpdateType::PERIODIC_DATA:
+          advertising_callbacks_->OnPeriodicAdvertisingDataSet(advertiser_id, status);
+          break;
+      }
+    }
+  }
+
+  static std::optional<DataUpdateType> get_data_update_type(CommandCompleteView view) {
+    switch (view.GetCommandOpCode()) {
+      case OpCode::LE_SET_ADVERTISING_DATA:
+      case OpCode::LE_SET_EXTENDED_ADVERTISING_DATA:
+        return DataUpdateType::ADVERTISING_DATA;
+      case OpCode::LE_SET_SCAN_RESPONSE_DATA:
+      case OpCode::LE_SET_EXTENDED_SCAN_RESPONSE_DATA:
+        return DataUpdateType::SCAN_RESPONSE_DATA;
+      case OpCode::LE_SET_PERIODIC_ADVERTISING_DATA:
+        return DataUpdateType::PERIODIC_DATA;
+      case OpCode::LE_MULTI_ADVT: {
+        auto command_view = LeMultiAdvtCompleteView::Create(view);
+        ASSERT(command_view.IsValid());
+        switch (command_view.GetSubCmd()) {
+          case SubOcf::SET_DATA:
+            return DataUpdateType::ADVERTISING_DATA;
+          case SubOcf::SET_SCAN_RESP:
+            return DataUpdateType::SCAN_RESPONSE_DATA;
+          default:
+            return std::nullopt;
+        }
+      }
+      default:
+        return std::nullopt;
+    }
+  }
+
+  /// Enqueues the commands setting |data|, or returns the reason why it can't be set.
+  AdvertisingCallback::AdvertisingStatus send_data(
+      AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data) {
     // The Flags data type shall be included when any of the Flag bits are non-zero and the
     // advertising packet is connectable and discoverable.
     if (!set_scan_rsp && advertising_sets_[advertiser_id].connectable &&
@@ -927,18 +1131,12 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
 
     if (advertising_api_type_ != AdvertisingApiType::EXTENDED && !check_advertising_data(data, false)) {
-      if (set_scan_rsp) {
-        advertising_callbacks_->OnScanResponseDataSet(
-            advertiser_id, AdvertisingCallback::AdvertisingStatus::DATA_TOO_LARGE);
-      } else {
-        advertising_callbacks_->OnAdvertisingDataSet(
-            advertiser_id, AdvertisingCallback::AdvertisingStatus::DATA_TOO_LARGE);
-      }
-      return;
+      return AdvertisingCallback::AdvertisingStatus::DATA_TOO_LARGE;
     }
 
     switch (advertising_api_type_) {
       case (AdvertisingApiType::LEGACY): {
+        data_commands_sent_++;
         if (set_scan_rsp) {
           le_advertising_interface_->EnqueueCommand(
               hci::LeSetScanResponseDataBuilder::Create(data),
@@ -952,6 +1150,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
         }
       } break;
       case (AdvertisingApiType::ANDROID_HCI): {
+        data_commands_sent_++;
         if (set_scan_rsp) {
           le_advertising_interface_->EnqueueCommand(
               hci::LeMultiAdvtSetScanRespBuilder::Create(data, advertiser_id),
@@ -968,16 +1167,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
         for (size_t i = 0; i < data.size(); i++) {
           if (data[i].size() > kLeMaximumFragmentLength) {
             LOG_WARN("AD data len shall not greater than %d", kLeMaximumFragmentLength);
-            if (advertising_callbacks_ != nullptr) {
-              if (set_scan_rsp) {
-                advertising_callbacks_->OnScanResponseDataSet(
-                    advertiser_id, AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR);
-              } else {
-                advertising_callbacks_->OnAdvertisingDataSet(
-                    advertiser_id, AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR);
-              }
-            }
-            return;
+            return AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR;
           }
           data_len += data[i].size();
         }
@@ -986,16 +1176,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
           LOG_WARN(
               "advertising data len exceeds le_maximum_advertising_data_length_ %d",
               le_maximum_advertising_data_length_);
-          if (advertising_callbacks_ != nullptr) {
-            if (set_scan_rsp) {
-              advertising_callbacks_->OnScanResponseDataSet(
-                  advertiser_id, AdvertisingCallback::AdvertisingStatus::DATA_TOO_LARGE);
-            } else {
-              advertising_callbacks_->OnAdvertisingDataSet(
-                  advertiser_id, AdvertisingCallback::AdvertisingStatus::DATA_TOO_LARGE);
-            }
-          }
-          return;
+          return AdvertisingCallback::AdvertisingStatus::DATA_TOO_LARGE;
         }
 
         if (data_len <= kLeMaximumFragmentLength) {
@@ -1019,10 +1200,12 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
         }
       } break;
     }
+    return AdvertisingCallback::AdvertisingStatus::SUCCESS;
   }
 
   void send_data_fragment(
       AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data, Operation operation) {
+    data_commands_sent_++;
     if (operation == Operation::COMPLETE_ADVERTISEMENT || operation == Operation::LAST_FRAGMENT) {
       if (set_scan_rsp) {
         le_advertising_interface_->EnqueueCommand(
@@ -1103,10 +1286,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       advertising_sets_[advertiser_id].max_extended_advertising_events = max_extended_advertising_events;
     } else {
       enabled_sets_[advertiser_id].advertising_handle_ = kInvalidHandle;
-      if (advertising_sets_[advertiser_id].address_rotation_alarm != nullptr) {
-        advertising_sets_[advertiser_id].address_rotation_alarm->Cancel();
-        advertising_sets_[advertiser_id].address_rotation_alarm.reset();
-      }
+      cancel_address_rotation(advertiser_id);
     }
   }
 
@@ -1128,16 +1308,17 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
   }
 
   void set_periodic_data(AdvertiserId advertiser_id, std::vector<GapData> data) {
+    request_data_update(advertiser_id, DataUpdateType::PERIODIC_DATA, std::move(data));
+  }
+
+  /// Enqueues the commands setting the periodic |data|, or returns the reason why it can't be set.
+  AdvertisingCallback::AdvertisingStatus send_periodic_data(AdvertiserId advertiser_id, std::vector<GapData> data) {
     uint16_t data_len = 0;
     // check data size
     for (size_t i = 0; i < data.size(); i++) {
       if (data[i].size() > kLeMaximumFragmentLength) {
         LOG_WARN("AD data len shall not greater than %d", kLeMaximumFragmentLength);
-        if (advertising_callbacks_ != nullptr) {
-          advertising_callbacks_->OnPeriodicAdvertisingDataSet(
-              advertiser_id, AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR);
-        }
-        return;
+        return AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR;
       }
       data_len += data[i].size();
     }
@@ -1145,11 +1326,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     if (data_len > le_maximum_advertising_data_length_) {
       LOG_WARN(
           "advertising data len exceeds le_maximum_advertising_data_length_ %d", le_maximum_advertising_data_length_);
-      if (advertising_callbacks_ != nullptr) {
-        advertising_callbacks_->OnPeriodicAdvertisingDataSet(
-            advertiser_id, AdvertisingCallback::AdvertisingStatus::DATA_TOO_LARGE);
-      }
-      return;
+      return AdvertisingCallback::AdvertisingStatus::DATA_TOO_LARGE;
     }
 
     if (data_len <= kLeMaximumFragmentLength) {
@@ -1171,9 +1348,11 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       }
       send_periodic_data_fragment(advertiser_id, sub_data, Operation::LAST_FRAGMENT);
     }
+    return AdvertisingCallback::AdvertisingStatus::SUCCESS;
   }
 
   void send_periodic_data_fragment(AdvertiserId advertiser_id, std::vector<GapData> data, Operation operation) {
+    data_commands_sent_++;
     if (operation == Operation::COMPLETE_ADVERTISEMENT || operation == Operation::LAST_FRAGMENT) {
       le_advertising_interface_->EnqueueCommand(
           hci::LeSetPeriodicAdvertisingDataBuilder::Create(advertiser_id, operation, data),
@@ -1351,6 +1530,8 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
   hci::AclManager* acl_manager_;
   bool address_manager_registered = false;
   bool paused = false;
+  // A single alarm rotates the addresses of all the sets due, see rotate_due_addresses
+  std::unique_ptr<os::Alarm> address_rotation_alarm_;
 
   std::mutex id_mutex_;
   size_t num_instances_;
@@ -1360,6 +1541,21 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
 
   AdvertisingApiType advertising_api_type_{0};
 
+  // Data update counters, also read by dumpsys.
+  std::atomic_uint64_t data_updates_requested_{0};
+  std::atomic_uint64_t data_updates_superseded_{0};
+  std::atomic_uint64_t data_commands_sent_{0};
+
+  flatbuffers::Offset<LeAdvertisingManagerData> Dump(flatbuffers::FlatBufferBuilder* fb_builder) const {
+    auto title = fb_builder->CreateString("----- Le Advertising Manager Dumpsys -----");
+    LeAdvertisingManagerDataBuilder builder(*fb_builder);
+    builder.add_title(title);
+    builder.add_data_updates_requested(data_updates_requested_);
+    builder.add_data_updates_superseded(data_updates_superseded_);
+    builder.add_data_commands_sent(data_commands_sent_);
+    return builder.Finish();
+  }
+
   void on_read_advertising_physical_channel_tx_power(CommandCompleteView view) {
     auto complete_view = LeReadAdvertisingPhysicalChannelTxPowerCompleteView::Create(view);
     if (!complete_view.IsValid()) {
@@ -1537,32 +1733,33 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       advertising_status = AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR;
     }
 
+    // Data updates coalesced while this one was in flight complete with it.
+    auto data_update_type = get_data_update_type(view);
+    size_t requests = 1;
+    if (data_update_type.has_value()) {
+      requests = complete_data_update(id, *data_update_type);
+    }
+
     // Do not trigger callback if the advertiser not stated yet, or the advertiser is not register
     // from Java layer
     if (advertising_callbacks_ == nullptr || !advertising_sets_[id].started || id_map_[id] == kIdLocal) {
       return;
     }
 
+    if (data_update_type.has_value()) {
+      notify_data_update(id, *data_update_type, advertising_status, requests);
+      return;
+    }
+
     OpCode opcode = view.GetCommandOpCode();
 
     switch (opcode) {
       case OpCode::LE_SET_ADVERTISING_PARAMETERS:
         advertising_callbacks_->OnAdvertisingParametersUpdated(id, le_physical_channel_tx_power_, advertising_status);
         break;
-      case OpCode::LE_SET_ADVERTISING_DATA:
-      case OpCode::LE_SET_EXTENDED_ADVERTISING_DATA:
-        advertising_callbacks_->OnAdvertisingDataSet(id, advertising_status);
-        break;
-      case OpCode::LE_SET_SCAN_RESPONSE_DATA:
-      case OpCode::LE_SET_EXTENDED_SCAN_RESPONSE_DATA:
-        advertising_callbacks_->OnScanResponseDataSet(id, advertising_status);
-        break;
       case OpCode::LE_SET_PERIODIC_ADVERTISING_PARAMETERS:
         advertising_callbacks_->OnPeriodicAdvertisingParametersUpdated(id, advertising_status);
         break;
-      case OpCode::LE_SET_PERIODIC_ADVERTISING_DATA:
-        advertising_callbacks_->OnPeriodicAdvertisingDataSet(id, advertising_status);
-        break;
       case OpCode::LE_MULTI_ADVT: {
         auto command_view = LeMultiAdvtCompleteView::Create(view);
         ASSERT(command_view.IsValid());
@@ -1572,12 +1769,6 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
             advertising_callbacks_->OnAdvertisingParametersUpdated(
                 id, le_physical_channel_tx_power_, advertising_status);
             break;
-          case SubOcf::SET_DATA:
-            advertising_callbacks_->OnAdvertisingDataSet(id, advertising_status);
-            break;
-          case SubOcf::SET_SCAN_RESP:
-            advertising_callbacks_->OnScanResponseDataSet(id, advertising_status);
-            break;
           default:
             LOG_WARN("Unexpected sub event type %s", SubOcfText(command_view.GetSubCmd()).c_str());
         }
@@ -1634,6 +1825,16 @@ std::string LeAdvertisingManager::ToString() const {
   return "Le Advertising Manager";
 }
 
+DumpsysDataFinisher LeAdvertisingManager::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const {
+  ASSERT(fb_builder != nullptr);
+
+  auto dumpsys_data = pimpl_->Dump(fb_builder);
+
+  return [dumpsys_data](DumpsysDataBuilder* dumpsys_builder) {
+    dumpsys_builder->add_hci_le_advertising_manager_dumpsys_data(dumpsys_data);
+  };
+}
+
 size_t LeAdvertisingManager::GetNumberOfAdvertisingInstances() const {
   return pimpl_->GetNumberOfAdvertisingInstances();
 }
@@ -163,6 +163,8 @@ class LeAdvertisingManager : public bluetooth::Module {
 
   std::string ToString() const override;
 
+  DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const override;  // Module
+
  private:
   struct impl;
   std::unique_ptr<impl> pimpl_;
@@ -132,6 +132,11 @@ class TestLeAddressManager : public LeAddressManager {
     address_policy_ = address_policy;
   }
 
+  void SetRotationTimes(std::chrono::milliseconds minimum, std::chrono::milliseconds maximum) {
+    minimum_rotation_time_ = minimum;
+    maximum_rotation_time_ = maximum;
+  }
+
   LeAddressManagerCallback* client_;
   bool ignore_unregister_for_testing = false;
   enum TestClientState {
@@ -152,6 +157,10 @@ class TestAclManager : public AclManager {
     test_le_address_manager_->SetAddressPolicy(address_policy);
   }
 
+  void SetRotationTimes(std::chrono::milliseconds minimum, std::chrono::milliseconds maximum) {
+    test_le_address_manager_->SetRotationTimes(minimum, maximum);
+  }
+
  protected:
   void Start() override {
     thread_ = new os::Thread("thread", os::Thread::Priority::NORMAL);
@@ -952,6 +961,40 @@ TEST_F(LeExtendedAdvertisingAPITest, set_scan_response_fragments_test) {
   test_hci_layer_->IncomingEvent(LeSetExtendedScanResponseDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
 }
 
+TEST_F(LeExtendedAdvertisingAPITest, set_data_coalesces_pending_updates) {
+  std::vector<GapData> advertising_data[3];
+  for (uint8_t i = 0; i < 3; i++) {
+    GapData data_item{};
+    data_item.data_type_ = GapDataType::COMPLETE_LOCAL_NAME;
+    data_item.data_ = {static_cast<uint8_t>('a' + i)};
+    advertising_data[i].push_back(data_item);
+  }
+  le_advertising_manager_->SetData(advertiser_id_, false, advertising_data[0]);
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+
+  // Both updates are held while the first one is in flight, and only the last one is sent.
+  le_advertising_manager_->SetData(advertiser_id_, false, advertising_data[1]);
+  le_advertising_manager_->SetData(advertiser_id_, false, advertising_data[2]);
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  sync_client_handler();
+
+  auto command =
+      LeSetExtendedAdvertisingDataView::Create(LeAdvertisingCommandView::Create(test_hci_layer_->GetCommand()));
+  ASSERT_TRUE(command.IsValid());
+  ASSERT_FALSE(command.GetAdvertisingData().empty());
+  ASSERT_EQ(advertising_data[2][0].data_, command.GetAdvertisingData().back().data_);
+
+  // Every coalesced request is notified.
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS))
+      .Times(2);
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+}
+
 TEST_F(LeExtendedAdvertisingAPITest, set_data_with_invalid_ad_structure) {
   // Set advertising data with AD structure that length greater than 251
   std::vector<GapData> advertising_data{};
@@ -1389,6 +1432,57 @@ TEST_F(LeExtendedAdvertisingManagerTest, use_non_resolvable_address) {
   EXPECT_EQ(address.data()[5] >> 6, 0b00);
 }
 
+TEST_F(LeExtendedAdvertisingManagerTest, rotate_addresses_of_sets_together) {
+  test_acl_manager_->SetAddressPolicy(LeAddressManager::AddressPolicy::USE_RESOLVABLE_ADDRESS);
+  // Long enough for both sets to be started before the first rotation
+  test_acl_manager_->SetRotationTimes(500ms, 600ms);
+
+  AdvertisingConfig advertising_config{};
+  advertising_config.advertising_type = AdvertisingType::ADV_IND;
+  advertising_config.connectable = true;
+  advertising_config.requested_advertiser_address_type = AdvertiserAddressType::RESOLVABLE_RANDOM;
+  advertising_config.channel_map = 1;
+  EXPECT_CALL(mock_advertising_callback_, OnAdvertisingSetStarted).Times(2);
+
+  std::vector<OpCode> adv_opcodes = {
+      OpCode::LE_SET_EXTENDED_ADVERTISING_PARAMETERS,
+      OpCode::LE_SET_ADVERTISING_SET_RANDOM_ADDRESS,
+      OpCode::LE_SET_EXTENDED_SCAN_RESPONSE_DATA,
+      OpCode::LE_SET_EXTENDED_ADVERTISING_DATA,
+      OpCode::LE_SET_EXTENDED_ADVERTISING_ENABLE,
+  };
+  std::vector<uint8_t> success_vector{static_cast<uint8_t>(ErrorCode::SUCCESS)};
+  for (int reg_id = 0; reg_id < 2; reg_id++) {
+    le_advertising_manager_->ExtendedCreateAdvertiser(
+        reg_id, advertising_config, scan_callback, set_terminated_callback, 0, 0, client_handler_);
+    for (size_t i = 0; i < adv_opcodes.size(); i++) {
+      ASSERT_EQ(adv_opcodes[i], test_hci_layer_->GetCommand().GetOpCode());
+      if (adv_opcodes[i] == OpCode::LE_SET_EXTENDED_ADVERTISING_PARAMETERS) {
+        test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingParametersCompleteBuilder::Create(
+            uint8_t{1}, ErrorCode::SUCCESS, static_cast<uint8_t>(-23)));
+      } else {
+        test_hci_layer_->IncomingEvent(
+            CommandCompleteBuilder::Create(uint8_t{1}, adv_opcodes[i], std::make_unique<RawBuilder>(success_vector)));
+      }
+    }
+  }
+  sync_client_handler();
+
+  // Both sets are disabled, get a new address, and are enabled again in one go
+  auto disable_command =
+      LeSetExtendedAdvertisingEnableView::Create(LeAdvertisingCommandView::Create(test_hci_layer_->GetCommand()));
+  ASSERT_TRUE(disable_command.IsValid());
+  ASSERT_EQ(Enable::DISABLED, disable_command.GetEnable());
+  ASSERT_EQ(2UL, disable_command.GetEnabledSets().size());
+  ASSERT_EQ(OpCode::LE_SET_ADVERTISING_SET_RANDOM_ADDRESS, test_hci_layer_->GetCommand().GetOpCode());
+  ASSERT_EQ(OpCode::LE_SET_ADVERTISING_SET_RANDOM_ADDRESS, test_hci_layer_->GetCommand().GetOpCode());
+  auto enable_command =
+      LeSetExtendedAdvertisingEnableView::Create(LeAdvertisingCommandView::Create(test_hci_layer_->GetCommand()));
+  ASSERT_TRUE(enable_command.IsValid());
+  ASSERT_EQ(Enable::ENABLED, enable_command.GetEnable());
+  ASSERT_EQ(2UL, enable_command.GetEnabledSets().size());
+}
+
 TEST_F(LeExtendedAdvertisingManagerTest, use_public_address_type_if_public_address_policy) {
   // arrange: use PUBLIC address policy
   test_acl_manager_->SetAddressPolicy(LeAddressManager::AddressPolicy::USE_PUBLIC_ADDRESS);
@@ -17,7 +17,9 @@
 
 #include <chrono>
 #include <memory>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "common/callback.h"
 #include "common/init_flags.h"
@@ -35,6 +37,10 @@ namespace hci {
 
 constexpr std::chrono::duration kPeriodicSyncTimeout = std::chrono::seconds(30);
 constexpr int kMaxSyncTransactions = 16;
+// Longest periodic advertising data, reassembled from the report fragments
+constexpr size_t kMaxPeriodicAdvertisingDataLength = 1650;
+// Identical periodic advertising data is only delivered every this many reports
+constexpr uint8_t kPeriodicReportDuplicateInterval = 16;
 
 enum PeriodicSyncState : int {
   PERIODIC_SYNC_STATE_IDLE = 0,
@@ -76,6 +82,19 @@ struct PendingPeriodicSyncRequest {
   os::Alarm sync_timeout_alarm;
 };
 
+// Reassembly and caching of the reports of an established sync.
+struct PeriodicSyncReports {
+  // Fragments of the advertising data being received
+  std::vector<uint8_t> data;
+  bool truncated = false;
+  // Last complete advertising data delivered, with the BASE of a broadcast
+  std::vector<uint8_t> last_data;
+  uint8_t duplicate_count = 0;
+  // Last BIGInfo delivered
+  bool has_big_info = false;
+  bool big_info_encrypted = false;
+};
+
 class PeriodicSyncManager {
  public:
   explicit PeriodicSyncManager(ScanningCallback* callbacks)
@@ -90,6 +109,12 @@ class PeriodicSyncManager {
     callbacks_ = callbacks;
   }
 
+  // With room for more than one advertiser in the periodic advertiser list of the controller, the pending syncs are
+  // added to the list and established by a single create sync instead of one after the other.
+  void SetPeriodicAdvertiserListSize(uint8_t size) {
+    periodic_advertiser_list_size_ = size;
+  }
+
   void StartSync(const PeriodicSyncStates& request, uint16_t skip, uint16_t sync_timeout) {
     if (periodic_syncs_.size() >= kMaxSyncTransactions) {
       int status = static_cast<int>(ErrorCode::CONNECTION_REJECTED_LIMITED_RESOURCES);
@@ -108,6 +133,11 @@ class PeriodicSyncManager {
               request.advertiser_sid);
     pending_sync_requests_.emplace_back(
         request.advertiser_sid, request.address_with_type, skip, sync_timeout, handler_);
+    if (UsePeriodicAdvertiserList()) {
+      // Let the syncs started together share the same create sync
+      handler_->CallOn(this, &PeriodicSyncManager::HandleNextRequest);
+      return;
+    }
     HandleNextRequest();
   }
 
@@ -123,6 +153,7 @@ class PeriodicSyncManager {
       return;
     };
     periodic_syncs_.erase(periodic_sync);
+    periodic_sync_reports_.erase(handle);
     le_scanning_interface_->EnqueueCommand(
         hci::LePeriodicAdvertisingTerminateSyncBuilder::Create(handle),
         handler_->BindOnceOn(this, &PeriodicSyncManager::check_status<LePeriodicAdvertisingTerminateSyncCompleteView>));
@@ -136,7 +167,12 @@ class PeriodicSyncManager {
       return;
     }
 
-    if (periodic_sync->sync_state == PERIODIC_SYNC_STATE_PENDING) {
+    auto pending_sync_request = GetPendingSyncFromAddressAndSid(address, adv_sid);
+    if (UsePeriodicAdvertiserList() && pending_sync_request != pending_sync_requests_.end() &&
+        pending_sync_request->busy) {
+      LOG_DEBUG("[PSync]: Removing Sync request from the periodic advertiser list");
+      CancelListRequest(pending_sync_request);
+    } else if (periodic_sync->sync_state == PERIODIC_SYNC_STATE_PENDING) {
       LOG_WARN("[PSync]: Sync state is pending");
       le_scanning_interface_->EnqueueCommand(
           hci::LePeriodicAdvertisingCreateSyncCancelBuilder::Create(),
@@ -202,7 +238,17 @@ class PeriodicSyncManager {
             &PeriodicSyncManager::check_status<LeSetDefaultPeriodicAdvertisingSyncTransferParametersCompleteView>));
   }
 
-  void HandlePeriodicAdvertisingCreateSyncStatus(CommandStatusView) {}
+  void HandlePeriodicAdvertisingCreateSyncStatus(CommandStatusView view) {
+    if (!UsePeriodicAdvertiserList()) {
+      return;
+    }
+    auto status_view = LePeriodicAdvertisingCreateSyncStatusView::Create(view);
+    if (!status_view.IsValid() || status_view.GetStatus() != ErrorCode::SUCCESS) {
+      // The listed requests are left to their timeout
+      LOG_WARN("[PSync]: Create sync from the periodic advertiser list failed");
+      list_create_sync_pending_ = false;
+    }
+  }
 
   void HandlePeriodicAdvertisingCreateSyncCancelStatus(CommandCompleteView) {}
 
@@ -267,6 +313,16 @@ class PeriodicSyncManager {
         event_view.GetPeriodicAdvertisingInterval(),
         (uint16_t)event_view.GetAdvertiserClockAccuracy());
 
+    if (UsePeriodicAdvertiserList()) {
+      list_create_sync_pending_ = false;
+      if (event_view.GetStatus() == ErrorCode::OPERATION_CANCELLED_BY_HOST) {
+        // The create sync was cancelled to update the list, start it again
+        LOG_DEBUG("[PSync]: Create sync from the periodic advertiser list cancelled");
+        HandleNextRequest();
+        return;
+      }
+    }
+
     auto pending_sync_request =
         GetPendingSyncFromAddressAndSid(event_view.GetAdvertiserAddress(), event_view.GetAdvertisingSid());
     if (pending_sync_request != pending_sync_requests_.end()) {
@@ -298,7 +354,7 @@ class PeriodicSyncManager {
             handler_->BindOnceOn(
                 this, &PeriodicSyncManager::check_status<LePeriodicAdvertisingTerminateSyncCompleteView>));
       }
-      AdvanceRequest();
+      AdvanceRequest(pending_sync_request);
       return;
     }
     periodic_sync->sync_handle = event_view.GetSyncHandle();
@@ -311,7 +367,7 @@ class PeriodicSyncManager {
         address_with_type,
         (uint16_t)event_view.GetAdvertiserPhy(),
         event_view.GetPeriodicAdvertisingInterval());
-    AdvanceRequest();
+    AdvanceRequest(pending_sync_request);
   }
 
   void HandleLePeriodicAdvertisingReport(LePeriodicAdvertisingReportView event_view) {
@@ -332,19 +388,47 @@ class PeriodicSyncManager {
       LOG_ERROR("[PSync]: index not found for handle %u", sync_handle);
       return;
     }
+
+    // Deliver the advertising data once reassembled from its fragments
+    auto& reports = periodic_sync_reports_[sync_handle];
+    auto data_status = event_view.GetDataStatus();
+    if (!reports.truncated) {
+      auto data = event_view.GetData();
+      reports.data.insert(reports.data.end(), data.begin(), data.end());
+    }
+    if (data_status == DataStatus::CONTINUING) {
+      if (reports.truncated || reports.data.size() <= kMaxPeriodicAdvertisingDataLength) {
+        return;
+      }
+      LOG_WARN("[PSync]: advertising data too long for handle %u, truncating", sync_handle);
+      reports.data.resize(kMaxPeriodicAdvertisingDataLength);
+      reports.truncated = true;
+      data_status = DataStatus::TRUNCATED;
+    } else if (reports.truncated) {
+      reports.truncated = false;
+      return;
+    }
+
+    std::vector<uint8_t> data = std::move(reports.data);
+    reports.data.clear();
+    if (data_status == DataStatus::COMPLETE) {
+      // The BASE of a broadcast source seldom changes, spare the parsing of the copies
+      if (data == reports.last_data && ++reports.duplicate_count < kPeriodicReportDuplicateInterval) {
+        return;
+      }
+      reports.duplicate_count = 0;
+      reports.last_data = data;
+    }
     LOG_DEBUG("%s", "[PSync]: invoking callback");
     callbacks_->OnPeriodicSyncReport(
-        sync_handle,
-        event_view.GetTxPower(),
-        event_view.GetRssi(),
-        (uint16_t)event_view.GetDataStatus(),
-        event_view.GetData());
+        sync_handle, event_view.GetTxPower(), event_view.GetRssi(), (uint16_t)data_status, std::move(data));
   }
 
   void HandleLePeriodicAdvertisingSyncLost(LePeriodicAdvertisingSyncLostView event_view) {
     ASSERT(event_view.IsValid());
     uint16_t sync_handle = event_view.GetSyncHandle();
     LOG_DEBUG("[PSync]: sync_handle = %d", sync_handle);
+    periodic_sync_reports_.erase(sync_handle);
     callbacks_->OnPeriodicSyncLost(sync_handle);
     auto periodic_sync = GetEstablishedSyncFromHandle(sync_handle);
     periodic_syncs_.erase(periodic_sync);
@@ -418,8 +502,15 @@ class PeriodicSyncManager {
       LOG_ERROR("[PSync]: index not found for handle %u", sync_handle);
       return;
     }
+    bool encrypted = event_view.GetEncryption() == Enable::ENABLED;
+    auto& reports = periodic_sync_reports_[sync_handle];
+    if (reports.has_big_info && reports.big_info_encrypted == encrypted) {
+      return;
+    }
+    reports.has_big_info = true;
+    reports.big_info_encrypted = encrypted;
     LOG_DEBUG("%s", "[PSync]: invoking callback");
-    callbacks_->OnBigInfoReport(sync_handle, event_view.GetEncryption() == Enable::ENABLED ? true : false);
+    callbacks_->OnBigInfoReport(sync_handle, encrypted);
   }
 
  private:
@@ -475,14 +566,15 @@ class PeriodicSyncManager {
     return periodic_sync_transfers_.end();
   }
 
+  static uint8_t GetSyncCteType() {
+    return static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOA_CONSTANT_TONE_EXTENSION) |
+           static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_ONE_US_SLOTS) |
+           static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_TWO_US_SLOTS);
+  }
+
   void HandleStartSyncRequest(uint8_t sid, const AddressWithType& address_with_type, uint16_t skip, uint16_t timeout) {
     PeriodicAdvertisingOptions options;
-    auto sync_cte_type =
-        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOA_CONSTANT_TONE_EXTENSION) |
-        static_cast<uint8_t>(
-            PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_ONE_US_SLOTS) |
-        static_cast<uint8_t>(
-            PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_TWO_US_SLOTS);
+    auto sync_cte_type = GetSyncCteType();
     auto sync = GetSyncFromAddressWithTypeAndSid(address_with_type, sid);
     sync->sync_state = PERIODIC_SYNC_STATE_PENDING;
     AdvertisingAddressType advertisingAddressType =
@@ -498,6 +590,10 @@ class PeriodicSyncManager {
       LOG_DEBUG("pending_sync_requests_ empty");
       return;
     }
+    if (UsePeriodicAdvertiserList()) {
+      HandleNextListRequests();
+      return;
+    }
     auto& request = pending_sync_requests_.front();
     LOG_INFO(
         "executing sync request SID=%04X, bd_addr=%s",
@@ -514,17 +610,144 @@ class PeriodicSyncManager {
         base::BindOnce(&PeriodicSyncManager::OnStartSyncTimeout, base::Unretained(this)), kPeriodicSyncTimeout);
   }
 
-  void AdvanceRequest() {
+  void AdvanceRequest(std::list<PendingPeriodicSyncRequest>::iterator established) {
     LOG_DEBUG("AdvanceRequest");
     if (pending_sync_requests_.empty()) {
       LOG_DEBUG("pending_sync_requests_ empty");
       return;
     }
-    auto it = pending_sync_requests_.begin();
-    pending_sync_requests_.erase(it);
+    if (!UsePeriodicAdvertiserList()) {
+      pending_sync_requests_.erase(pending_sync_requests_.begin());
+    } else if (established != pending_sync_requests_.end()) {
+      // The other listed requests are still being established
+      RemoveFromPeriodicAdvertiserList(*established);
+      pending_sync_requests_.erase(established);
+    }
     HandleNextRequest();
   }
 
+  bool UsePeriodicAdvertiserList() const {
+    return periodic_advertiser_list_size_ > 1;
+  }
+
+  // Adds the requests waiting to the periodic advertiser list, as long as it has room, and syncs to any of the listed
+  // advertisers. The list cannot be changed while the create sync is pending, the requests started meanwhile are added
+  // when it completes.
+  void HandleNextListRequests() {
+    if (list_create_sync_pending_) {
+      LOG_DEBUG("[PSync]: Create sync pending, the periodic advertiser list is locked");
+      return;
+    }
+    size_t listed = 0;
+    for (auto& request : pending_sync_requests_) {
+      if (request.busy) listed++;
+    }
+    for (auto& request : pending_sync_requests_) {
+      if (listed >= periodic_advertiser_list_size_) {
+        LOG_INFO("[PSync]: Periodic advertiser list full, %zu listed", listed);
+        break;
+      }
+      if (request.busy) {
+        continue;
+      }
+      LOG_INFO(
+          "listing sync request SID=%04X, bd_addr=%s",
+          request.advertiser_sid,
+          ADDRESS_TO_LOGGABLE_CSTR(request.address_with_type));
+      if (!periodic_advertiser_list_cleared_) {
+        // Drop the entries left by an earlier run of the stack
+        le_scanning_interface_->EnqueueCommand(
+            hci::LeClearPeriodicAdvertiserListBuilder::Create(),
+            handler_->BindOnceOn(this, &PeriodicSyncManager::check_status<LeClearPeriodicAdvertiserListCompleteView>));
+        periodic_advertiser_list_cleared_ = true;
+      }
+      le_scanning_interface_->EnqueueCommand(
+          hci::LeAddDeviceToPeriodicAdvertiserListBuilder::Create(
+              static_cast<AdvertisingAddressType>(request.address_with_type.GetAddressType()),
+              request.address_with_type.GetAddress(),
+              request.advertiser_sid),
+          handler_->BindOnceOn(
+              this, &PeriodicSyncManager::check_status<LeAddDeviceToPeriodicAdvertiserListCompleteView>));
+      request.busy = true;
+      listed++;
+      auto sync = GetSyncFromAddressWithTypeAndSid(request.address_with_type, request.advertiser_sid);
+      if (sync != periodic_syncs_.end()) {
+        sync->sync_state = PERIODIC_SYNC_STATE_PENDING;
+      }
+      request.sync_timeout_alarm.Schedule(
+          base::BindOnce(
+              &PeriodicSyncManager::OnListSyncTimeout,
+              base::Unretained(this),
+              request.advertiser_sid,
+              request.address_with_type),
+          kPeriodicSyncTimeout);
+    }
+    if (listed == 0) {
+      return;
+    }
+
+    // The listed requests share the parameters of the oldest one
+    auto& request = pending_sync_requests_.front();
+    PeriodicAdvertisingOptions options;
+    options.use_periodic_advertiser_list = 1;
+    le_scanning_interface_->EnqueueCommand(
+        hci::LePeriodicAdvertisingCreateSyncBuilder::Create(
+            options,
+            0,
+            AdvertisingAddressType::PUBLIC_DEVICE_OR_IDENTITY_ADDRESS,
+            Address::kEmpty,
+            request.skip,
+            request.sync_timeout,
+            GetSyncCteType()),
+        handler_->BindOnceOn(this, &PeriodicSyncManager::HandlePeriodicAdvertisingCreateSyncStatus));
+    list_create_sync_pending_ = true;
+  }
+
+  void RemoveFromPeriodicAdvertiserList(const PendingPeriodicSyncRequest& request) {
+    le_scanning_interface_->EnqueueCommand(
+        hci::LeRemoveDeviceFromPeriodicAdvertiserListBuilder::Create(
+            static_cast<AdvertisingAddressType>(request.address_with_type.GetAddressType()),
+            request.address_with_type.GetAddress(),
+            request.advertiser_sid),
+        handler_->BindOnceOn(
+            this, &PeriodicSyncManager::check_status<LeRemoveDeviceFromPeriodicAdvertiserListCompleteView>));
+  }
+
+  void CancelListRequest(std::list<PendingPeriodicSyncRequest>::iterator request) {
+    request->sync_timeout_alarm.Cancel();
+    if (list_create_sync_pending_) {
+      // Unlock the list, the create sync is started again once the controller reports it cancelled
+      le_scanning_interface_->EnqueueCommand(
+          hci::LePeriodicAdvertisingCreateSyncCancelBuilder::Create(),
+          handler_->BindOnceOn(this, &PeriodicSyncManager::HandlePeriodicAdvertisingCreateSyncCancelStatus));
+    }
+    RemoveFromPeriodicAdvertiserList(*request);
+    pending_sync_requests_.erase(request);
+  }
+
+  void OnListSyncTimeout(uint8_t adv_sid, AddressWithType address_with_type) {
+    LOG_WARN("sync timeout SID=%04X, bd_addr=%s", adv_sid, ADDRESS_TO_LOGGABLE_CSTR(address_with_type));
+    auto request = GetPendingSyncFromAddressAndSid(address_with_type.GetAddress(), adv_sid);
+    if (request == pending_sync_requests_.end()) {
+      return;
+    }
+    auto sync = GetSyncFromAddressWithTypeAndSid(address_with_type, adv_sid);
+    if (sync != periodic_syncs_.end()) {
+      int status = static_cast<int>(ErrorCode::ADVERTISING_TIMEOUT);
+      callbacks_->OnPeriodicSyncStarted(sync->request_id, status, 0, adv_sid, address_with_type, 0, 0);
+      RemoveSyncRequest(sync);
+    }
+    // The request owns the alarm being run, release it from the handler
+    handler_->CallOn(this, &PeriodicSyncManager::CancelListRequestOf, adv_sid, address_with_type.GetAddress());
+  }
+
+  void CancelListRequestOf(uint8_t adv_sid, Address address) {
+    auto request = GetPendingSyncFromAddressAndSid(address, adv_sid);
+    if (request != pending_sync_requests_.end()) {
+      CancelListRequest(request);
+    }
+  }
+
   void CleanUpRequest(uint8_t advertiser_sid, Address address) {
     auto it = pending_sync_requests_.begin();
     while (it != pending_sync_requests_.end()) {
@@ -547,6 +770,10 @@ class PeriodicSyncManager {
   std::list<PendingPeriodicSyncRequest> pending_sync_requests_;
   std::list<PeriodicSyncStates> periodic_syncs_;
   std::list<PeriodicSyncTransferStates> periodic_sync_transfers_;
+  std::unordered_map<uint16_t, PeriodicSyncReports> periodic_sync_reports_;
+  uint8_t periodic_advertiser_list_size_ = 0;
+  bool periodic_advertiser_list_cleared_ = false;
+  bool list_create_sync_pending_ = false;
   bool sync_received_callback_registered_ = false;
   int sync_received_callback_id{};
 };
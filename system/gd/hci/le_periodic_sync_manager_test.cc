@@ -25,6 +25,7 @@
 #include "os/handler.h"
 
 using namespace std::chrono_literals;
+using ::testing::_;
 
 namespace bluetooth {
 namespace hci {
@@ -208,6 +209,46 @@ class PeriodicSyncManagerTest : public ::testing::Test {
     MOCK_METHOD(void, OnBigInfoReport, (uint16_t, bool));
   } mock_callbacks_;
 
+  void StartAndEstablishSync(uint8_t advertiser_sid, const AddressWithType& address_with_type, uint16_t sync_handle) {
+    PeriodicSyncStates request{
+        .request_id = 0x01,
+        .advertiser_sid = advertiser_sid,
+        .address_with_type = address_with_type,
+        .sync_handle = sync_handle,
+        .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+    };
+    ASSERT_NO_FATAL_FAILURE(test_le_scanning_interface_->SetCommandFuture());
+    periodic_sync_manager_->StartSync(request, 0x04, 0x0A);
+    test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+    test_le_scanning_interface_->CommandStatusCallback(
+        LePeriodicAdvertisingCreateSyncStatusBuilder::Create(ErrorCode::SUCCESS, 0x00));
+    EXPECT_CALL(mock_callbacks_, OnPeriodicSyncStarted);
+    HandleSyncEstablished(advertiser_sid, address_with_type, sync_handle);
+  }
+
+  void HandleSyncEstablished(uint8_t advertiser_sid, const AddressWithType& address_with_type, uint16_t sync_handle) {
+    auto builder = LePeriodicAdvertisingSyncEstablishedBuilder::Create(
+        ErrorCode::SUCCESS,
+        sync_handle,
+        advertiser_sid,
+        address_with_type.GetAddressType(),
+        address_with_type.GetAddress(),
+        SecondaryPhyType::LE_1M,
+        0xFF,
+        ClockAccuracy::PPM_250);
+    auto event_view = LePeriodicAdvertisingSyncEstablishedView::Create(
+        LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(builder)))));
+    periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(event_view);
+  }
+
+  void HandleReport(uint16_t sync_handle, DataStatus data_status, std::vector<uint8_t> data) {
+    auto builder = LePeriodicAdvertisingReportBuilder::Create(
+        sync_handle, 0x1a, 0x1a, CteType::AOA_CONSTANT_TONE_EXTENSION, data_status, data);
+    auto event_view = LePeriodicAdvertisingReportView::Create(
+        LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(builder)))));
+    periodic_sync_manager_->HandleLePeriodicAdvertisingReport(event_view);
+  }
+
   os::Thread* thread_;
   os::Handler* handler_;
   TestLeScanningInterface* test_le_scanning_interface_;
@@ -646,6 +687,109 @@ TEST_F(PeriodicSyncManagerTest, handle_biginfo_advertising_report_test) {
   sync_handler();
 }
 
+TEST_F(PeriodicSyncManagerTest, periodic_advertising_report_fragments_test) {
+  uint16_t sync_handle = 0x12;
+  Address address;
+  Address::FromString("00:11:22:33:44:55", address);
+  StartAndEstablishSync(0x02, AddressWithType(address, AddressType::PUBLIC_DEVICE_ADDRESS), sync_handle);
+
+  std::vector<uint8_t> expected = {0x01, 0x02, 0x03, 0x04, 0x05};
+  EXPECT_CALL(
+      mock_callbacks_, OnPeriodicSyncReport(sync_handle, _, _, static_cast<uint8_t>(DataStatus::COMPLETE), expected))
+      .Times(1);
+  HandleReport(sync_handle, DataStatus::CONTINUING, {0x01, 0x02});
+  HandleReport(sync_handle, DataStatus::CONTINUING, {0x03});
+  HandleReport(sync_handle, DataStatus::COMPLETE, {0x04, 0x05});
+
+  sync_handler();
+}
+
+TEST_F(PeriodicSyncManagerTest, periodic_advertising_report_duplicates_test) {
+  uint16_t sync_handle = 0x12;
+  Address address;
+  Address::FromString("00:11:22:33:44:55", address);
+  StartAndEstablishSync(0x02, AddressWithType(address, AddressType::PUBLIC_DEVICE_ADDRESS), sync_handle);
+
+  std::vector<uint8_t> base = {0x01, 0x02, 0x03};
+  std::vector<uint8_t> new_base = {0x01, 0x02, 0x04};
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncReport(sync_handle, _, _, _, base)).Times(2);
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncReport(sync_handle, _, _, _, new_base)).Times(1);
+  for (int i = 0; i < kPeriodicReportDuplicateInterval; i++) {
+    HandleReport(sync_handle, DataStatus::COMPLETE, base);
+  }
+  HandleReport(sync_handle, DataStatus::COMPLETE, new_base);
+  HandleReport(sync_handle, DataStatus::COMPLETE, new_base);
+  HandleReport(sync_handle, DataStatus::COMPLETE, base);
+
+  sync_handler();
+}
+
+TEST_F(PeriodicSyncManagerTest, biginfo_advertising_report_duplicates_test) {
+  uint16_t sync_handle = 0x12;
+  Address address;
+  Address::FromString("00:11:22:33:44:55", address);
+  StartAndEstablishSync(0x02, AddressWithType(address, AddressType::PUBLIC_DEVICE_ADDRESS), sync_handle);
+
+  EXPECT_CALL(mock_callbacks_, OnBigInfoReport(sync_handle, true)).Times(1);
+  for (int i = 0; i < 3; i++) {
+    auto builder = LeBigInfoAdvertisingReportBuilder::Create(
+        sync_handle, 2, 9, 24, 3, 1, 2, 100, 10000, 100, static_cast<SecondaryPhyType>(2),
+        static_cast<Enable>(0), static_cast<Enable>(1));
+    auto event_view = LeBigInfoAdvertisingReportView::Create(
+        LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(builder)))));
+    periodic_sync_manager_->HandleLeBigInfoAdvertisingReport(event_view);
+  }
+
+  sync_handler();
+}
+
+TEST_F(PeriodicSyncManagerTest, start_syncs_with_periodic_advertiser_list_test) {
+  periodic_sync_manager_->SetPeriodicAdvertiserListSize(4);
+  Address address;
+  Address::FromString("00:11:22:33:44:55", address);
+  AddressWithType address_with_type = AddressWithType(address, AddressType::PUBLIC_DEVICE_ADDRESS);
+  for (uint8_t advertiser_sid : {0x02, 0x03}) {
+    PeriodicSyncStates request{
+        .request_id = advertiser_sid,
+        .advertiser_sid = advertiser_sid,
+        .address_with_type = address_with_type,
+        .sync_handle = 0,
+        .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+    };
+    periodic_sync_manager_->StartSync(request, 0x04, 0x0A);
+  }
+  sync_handler();
+
+  // Both advertisers are listed for a single create sync
+  test_le_scanning_interface_->GetCommand(OpCode::LE_CLEAR_PERIODIC_ADVERTISER_LIST);
+  for (uint8_t advertiser_sid : {0x02, 0x03}) {
+    auto packet = test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST);
+    auto packet_view = LeAddDeviceToPeriodicAdvertiserListView::Create(LeScanningCommandView::Create(packet));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(advertiser_sid, packet_view.GetAdvertisingSid());
+    ASSERT_EQ(address, packet_view.GetAdvertiserAddress());
+  }
+  auto packet = test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  auto packet_view = LePeriodicAdvertisingCreateSyncView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(1, packet_view.GetOptions().use_periodic_advertiser_list);
+  test_le_scanning_interface_->CommandStatusCallback(
+      LePeriodicAdvertisingCreateSyncStatusBuilder::Create(ErrorCode::SUCCESS, 0x00));
+
+  // The established advertiser leaves the list, the create sync goes on for the other
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncStarted(0x03, _, 0x13, 0x03, _, _, _)).Times(1);
+  HandleSyncEstablished(0x03, address_with_type, 0x13);
+  auto remove_packet =
+      test_le_scanning_interface_->GetCommand(OpCode::LE_REMOVE_DEVICE_FROM_PERIODIC_ADVERTISER_LIST);
+  auto remove_view =
+      LeRemoveDeviceFromPeriodicAdvertiserListView::Create(LeScanningCommandView::Create(remove_packet));
+  ASSERT_TRUE(remove_view.IsValid());
+  ASSERT_EQ(0x03, remove_view.GetAdvertisingSid());
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+
+  sync_handler();
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace bluetooth
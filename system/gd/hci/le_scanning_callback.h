@@ -16,6 +16,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "common/callback.h"
 #include "hci/address_with_type.h"
@@ -45,6 +46,20 @@ class AdvertisingFilterOnFoundOnLostInfo {
   std::vector<uint8_t> scan_response;
 };
 
+class ScanResult {
+ public:
+  uint16_t event_type;
+  uint8_t address_type;
+  Address address;
+  uint8_t primary_phy;
+  uint8_t secondary_phy;
+  uint8_t advertising_sid;
+  int8_t tx_power;
+  int8_t rssi;
+  uint16_t periodic_advertising_interval;
+  std::vector<uint8_t> advertising_data;
+};
+
 class ScanningCallback {
  public:
   enum ScanningStatus {
@@ -69,6 +84,23 @@ class ScanningCallback {
       int8_t rssi,
       uint16_t periodic_advertising_interval,
       std::vector<uint8_t> advertising_data) = 0;
+  // Called instead of OnScanResult when scan result batching is enabled, with the results received during the
+  // batching window in the order they were received.
+  virtual void OnScanResults(std::vector<ScanResult> results) {
+    for (auto& result : results) {
+      OnScanResult(
+          result.event_type,
+          result.address_type,
+          result.address,
+          result.primary_phy,
+          result.secondary_phy,
+          result.advertising_sid,
+          result.tx_power,
+          result.rssi,
+          result.periodic_advertising_interval,
+          std::move(result.advertising_data));
+    }
+  }
   virtual void OnTrackAdvFoundLost(AdvertisingFilterOnFoundOnLostInfo on_found_on_lost_info) = 0;
   virtual void OnBatchScanReports(
       int client_if, int status, int report_format, int num_records, std::vector<uint8_t> data) = 0;
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_deduplicator.h"
+
+#include <cstdlib>
+#include <string_view>
+
+namespace bluetooth::hci {
+
+void LeScanningDeduplicator::Configure(std::chrono::milliseconds refresh_interval, bool report_rssi_changes) {
+  if (refresh_interval != refresh_interval_ || report_rssi_changes != report_rssi_changes_) {
+    cache_.clear();
+  }
+  refresh_interval_ = refresh_interval;
+  report_rssi_changes_ = report_rssi_changes;
+}
+
+bool LeScanningDeduplicator::ShouldForward(
+    uint8_t address_type,
+    Address address,
+    uint8_t advertising_sid,
+    int8_t rssi,
+    const std::vector<uint8_t>& advertising_data,
+    std::chrono::steady_clock::time_point now) {
+  if (!IsEnabled()) {
+    return true;
+  }
+
+  ScanDeduplicationKey key{
+      address,
+      address_type,
+      advertising_sid,
+      std::hash<std::string_view>{}(
+          std::string_view(reinterpret_cast<const char*>(advertising_data.data()), advertising_data.size())),
+  };
+
+  auto entry = cache_.find(key);
+  if (entry == cache_.end()) {
+    cache_.insert_or_assign(key, Entry{now, rssi});
+    return true;
+  }
+
+  Entry& cached = entry->second;
+  bool refresh = now - cached.last_forwarded >= refresh_interval_;
+  bool rssi_changed = report_rssi_changes_ && std::abs(rssi - cached.rssi) >= kRssiChangeThreshold;
+  if (!refresh && !rssi_changed) {
+    suppressed_count_++;
+    return false;
+  }
+  cached.last_forwarded = now;
+  cached.rssi = rssi;
+  return true;
+}
+
+}  // namespace bluetooth::hci
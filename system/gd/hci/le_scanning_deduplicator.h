@@ -0,0 +1,113 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "common/lru_cache.h"
+#include "hci/address.h"
+
+namespace bluetooth::hci {
+
+/// Identifies an advertisement for duplicate suppression: the same advertiser
+/// sending the same data on the same advertising set.
+struct ScanDeduplicationKey {
+  Address address;
+  uint8_t address_type;
+  uint8_t advertising_sid;
+  size_t advertising_data_hash;
+
+  bool operator==(const ScanDeduplicationKey& other) const {
+    return address == other.address && address_type == other.address_type &&
+           advertising_sid == other.advertising_sid && advertising_data_hash == other.advertising_data_hash;
+  }
+};
+
+}  // namespace bluetooth::hci
+
+namespace std {
+template <>
+struct hash<bluetooth::hci::ScanDeduplicationKey> {
+  std::size_t operator()(const bluetooth::hci::ScanDeduplicationKey& key) const {
+    std::size_t seed = std::hash<bluetooth::hci::Address>{}(key.address);
+    seed ^= (static_cast<size_t>(key.address_type) << 8 | key.advertising_sid) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= key.advertising_data_hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+};
+}  // namespace std
+
+namespace bluetooth::hci {
+
+/// The LE Scanning deduplicator drops complete advertising reports that
+/// repeat an advertisement already reported within the refresh interval.
+/// Controller duplicate filtering is reset by every scan parameter change and
+/// is missing for extended scanning on many controllers, so the host does it
+/// before the results are handed to the scanning callbacks.
+
+class LeScanningDeduplicator {
+ public:
+  static constexpr size_t kDefaultCacheSize = 256;
+  /// Smallest RSSI change that counts as an update when RSSI changes are reported.
+  static constexpr int kRssiChangeThreshold = 5;
+
+  explicit LeScanningDeduplicator(size_t cache_size = kDefaultCacheSize) : cache_(cache_size) {}
+  LeScanningDeduplicator(const LeScanningDeduplicator&) = delete;
+  LeScanningDeduplicator& operator=(const LeScanningDeduplicator&) = delete;
+
+  /// Configure the suppression. A zero |refresh_interval| forwards every report.
+  /// With |report_rssi_changes| a duplicate is still forwarded when its RSSI
+  /// moved by at least kRssiChangeThreshold since it was last forwarded.
+  void Configure(std::chrono::milliseconds refresh_interval, bool report_rssi_changes);
+
+  /// Returns true if the report should be forwarded to the scanning callbacks.
+  bool ShouldForward(
+      uint8_t address_type,
+      Address address,
+      uint8_t advertising_sid,
+      int8_t rssi,
+      const std::vector<uint8_t>& advertising_data,
+      std::chrono::steady_clock::time_point now);
+
+  /// Forget every advertisement, so that they are all reported again.
+  void Clear() {
+    cache_.clear();
+  }
+
+  bool IsEnabled() const {
+    return refresh_interval_.count() > 0;
+  }
+
+  uint64_t GetSuppressedCount() const {
+    return suppressed_count_;
+  }
+
+ private:
+  struct Entry {
+    std::chrono::steady_clock::time_point last_forwarded;
+    int8_t rssi;
+  };
+
+  std::chrono::milliseconds refresh_interval_{0};
+  bool report_rssi_changes_{false};
+  common::LruCache<ScanDeduplicationKey, Entry> cache_;
+  uint64_t suppressed_count_{0};
+};
+
+}  // namespace bluetooth::hci
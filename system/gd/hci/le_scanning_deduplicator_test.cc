@@ -0,0 +1,92 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_deduplicator.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth::hci {
+
+static constexpr uint8_t kPublicAddress = 0x00;
+static constexpr uint8_t kSidNotPresent = 0xff;
+static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
+static const Address kOtherAddress = Address({5, 4, 3, 2, 1, 0});
+static const std::vector<uint8_t> kAdvertisingData = {0x02, 0x01, 0x06};
+
+class LeScanningDeduplicatorTest : public ::testing::Test {
+ protected:
+  bool Report(
+      Address address, int8_t rssi, std::chrono::milliseconds at, const std::vector<uint8_t>& data = kAdvertisingData) {
+    return deduplicator_.ShouldForward(kPublicAddress, address, kSidNotPresent, rssi, data, start_ + at);
+  }
+
+  LeScanningDeduplicator deduplicator_{4};
+  std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
+
+TEST_F(LeScanningDeduplicatorTest, disabled_forwards_everything) {
+  ASSERT_TRUE(Report(kTestAddress, -50, 0ms));
+  ASSERT_TRUE(Report(kTestAddress, -50, 0ms));
+  ASSERT_EQ(0u, deduplicator_.GetSuppressedCount());
+}
+
+TEST_F(LeScanningDeduplicatorTest, duplicates_are_suppressed_until_refresh) {
+  deduplicator_.Configure(1000ms, false);
+  ASSERT_TRUE(Report(kTestAddress, -50, 0ms));
+  ASSERT_FALSE(Report(kTestAddress, -50, 10ms));
+  ASSERT_FALSE(Report(kTestAddress, -60, 999ms));
+  ASSERT_TRUE(Report(kTestAddress, -50, 1000ms));
+  ASSERT_FALSE(Report(kTestAddress, -50, 1500ms));
+  ASSERT_EQ(3u, deduplicator_.GetSuppressedCount());
+}
+
+TEST_F(LeScanningDeduplicatorTest, different_data_or_advertiser_is_forwarded) {
+  deduplicator_.Configure(1000ms, false);
+  ASSERT_TRUE(Report(kTestAddress, -50, 0ms));
+  ASSERT_TRUE(Report(kOtherAddress, -50, 0ms));
+  ASSERT_TRUE(Report(kTestAddress, -50, 0ms, {0x02, 0x01, 0x04}));
+  ASSERT_TRUE(deduplicator_.ShouldForward(kPublicAddress, kTestAddress, 0x01, -50, kAdvertisingData, start_));
+  ASSERT_FALSE(Report(kTestAddress, -50, 0ms));
+}
+
+TEST_F(LeScanningDeduplicatorTest, rssi_changes_are_forwarded_when_asked) {
+  deduplicator_.Configure(1000ms, true);
+  ASSERT_TRUE(Report(kTestAddress, -50, 0ms));
+  ASSERT_FALSE(Report(kTestAddress, -52, 10ms));
+  ASSERT_TRUE(Report(kTestAddress, -56, 20ms));
+  // The last forwarded RSSI is the new reference
+  ASSERT_FALSE(Report(kTestAddress, -53, 30ms));
+}
+
+TEST_F(LeScanningDeduplicatorTest, oldest_advertisement_is_evicted) {
+  deduplicator_.Configure(1000ms, false);
+  for (uint8_t i = 0; i < 5; i++) {
+    ASSERT_TRUE(Report(kTestAddress, -50, 0ms, {0x02, 0x01, i}));
+  }
+  ASSERT_TRUE(Report(kTestAddress, -50, 0ms, {0x02, 0x01, 0x00}));
+  ASSERT_FALSE(Report(kTestAddress, -50, 0ms, {0x02, 0x01, 0x04}));
+}
+
+TEST_F(LeScanningDeduplicatorTest, clear_forgets_advertisements) {
+  deduplicator_.Configure(1000ms, false);
+  ASSERT_TRUE(Report(kTestAddress, -50, 0ms));
+  deduplicator_.Clear();
+  ASSERT_TRUE(Report(kTestAddress, -50, 10ms));
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,235 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_filter_engine.h"
+
+#include "os/log.h"
+
+namespace bluetooth::hci {
+
+namespace {
+
+// AD types (Assigned Numbers 2.3).
+constexpr uint8_t kIncompleteListOf16BitServiceUuids = 0x02;
+constexpr uint8_t kCompleteListOf16BitServiceUuids = 0x03;
+constexpr uint8_t kIncompleteListOf32BitServiceUuids = 0x04;
+constexpr uint8_t kCompleteListOf32BitServiceUuids = 0x05;
+constexpr uint8_t kIncompleteListOf128BitServiceUuids = 0x06;
+constexpr uint8_t kCompleteListOf128BitServiceUuids = 0x07;
+constexpr uint8_t kShortenedLocalName = 0x08;
+constexpr uint8_t kCompleteLocalName = 0x09;
+constexpr uint8_t kListOf16BitServiceSolicitationUuids = 0x14;
+constexpr uint8_t kListOf128BitServiceSolicitationUuids = 0x15;
+constexpr uint8_t kServiceData16BitUuid = 0x16;
+constexpr uint8_t kListOf32BitServiceSolicitationUuids = 0x1f;
+constexpr uint8_t kTransportDiscoveryData = 0x26;
+constexpr uint8_t kManufacturerSpecificData = 0xff;
+
+/// Append the little endian representation of |uuid|, |size| bytes long.
+void AppendUuid(std::vector<uint8_t>& bytes, const Uuid& uuid, size_t size) {
+  if (size == Uuid::kNumBytes16) {
+    uint16_t uuid16 = uuid.As16Bit();
+    bytes.push_back((uint8_t)uuid16);
+    bytes.push_back((uint8_t)(uuid16 >> 8));
+  } else if (size == Uuid::kNumBytes32) {
+    uint32_t uuid32 = uuid.As32Bit();
+    bytes.push_back((uint8_t)uuid32);
+    bytes.push_back((uint8_t)(uuid32 >> 8));
+    bytes.push_back((uint8_t)(uuid32 >> 16));
+    bytes.push_back((uint8_t)(uuid32 >> 24));
+  } else {
+    auto uuid128 = uuid.To128BitLE();
+    bytes.insert(bytes.end(), uuid128.begin(), uuid128.end());
+  }
+}
+
+}  // namespace
+
+void LeScanningFilterEngine::SetFilterParameters(uint8_t filter_index, const AdvertisingFilterParameter& parameter) {
+  Filter& filter = filters_[filter_index];
+  filter.has_parameters = true;
+  filter.feature_selection = parameter.feature_selection;
+  filter.rssi_threshold = static_cast<int8_t>(parameter.rssi_high_thresh);
+}
+
+bool LeScanningFilterEngine::AddFilters(
+    uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& filters) {
+  Filter& filter = filters_[filter_index];
+  bool success = true;
+  for (const auto& command : filters) {
+    if (!AddCondition(filter, command)) {
+      LOG_WARN(
+          "Filter %hhu condition %s can't be evaluated on the host",
+          filter_index,
+          ApcfFilterTypeText(command.filter_type).c_str());
+      success = false;
+    }
+  }
+  compiled_ = false;
+  return success;
+}
+
+void LeScanningFilterEngine::RemoveFilter(uint8_t filter_index) {
+  if (filters_.erase(filter_index) != 0) {
+    compiled_ = false;
+  }
+}
+
+void LeScanningFilterEngine::Clear() {
+  filters_.clear();
+  compiled_ = false;
+}
+
+bool LeScanningFilterEngine::AddCondition(Filter& filter, const AdvertisingPacketContentFilterCommand& command) {
+  Condition condition{command.filter_type, false, Address::kEmpty, filter.patterns.size(), 0};
+  auto add_pattern = [&](uint8_t type, std::vector<uint8_t> value, std::vector<uint8_t> mask, uint8_t element_size) {
+    filter.patterns.push_back(AdvertisingDataPattern{type, std::move(value), std::move(mask), element_size});
+    condition.pattern_count++;
+  };
+
+  switch (command.filter_type) {
+    case ApcfFilterType::BROADCASTER_ADDRESS: {
+      condition.is_address = true;
+      condition.address = command.address;
+    } break;
+    case ApcfFilterType::SERVICE_UUID:
+    case ApcfFilterType::SERVICE_SOLICITATION_UUID: {
+      size_t size = command.uuid.GetShortestRepresentationSize();
+      std::vector<uint8_t> value;
+      std::vector<uint8_t> mask;
+      AppendUuid(value, command.uuid, size);
+      if (!command.uuid_mask.IsEmpty()) {
+        AppendUuid(mask, command.uuid_mask, size);
+      }
+      bool solicitation = command.filter_type == ApcfFilterType::SERVICE_SOLICITATION_UUID;
+      if (size == Uuid::kNumBytes16) {
+        if (solicitation) {
+          add_pattern(kListOf16BitServiceSolicitationUuids, value, mask, size);
+        } else {
+          add_pattern(kIncompleteListOf16BitServiceUuids, value, mask, size);
+          add_pattern(kCompleteListOf16BitServiceUuids, value, mask, size);
+        }
+      } else if (size == Uuid::kNumBytes32) {
+        if (solicitation) {
+          add_pattern(kListOf32BitServiceSolicitationUuids, value, mask, size);
+        } else {
+          add_pattern(kIncompleteListOf32BitServiceUuids, value, mask, size);
+          add_pattern(kCompleteListOf32BitServiceUuids, value, mask, size);
+        }
+      } else {
+        if (solicitation) {
+          add_pattern(kListOf128BitServiceSolicitationUuids, value, mask, size);
+        } else {
+          add_pattern(kIncompleteListOf128BitServiceUuids, value, mask, size);
+          add_pattern(kCompleteListOf128BitServiceUuids, value, mask, size);
+        }
+      }
+    } break;
+    case ApcfFilterType::LOCAL_NAME: {
+      add_pattern(kShortenedLocalName, command.name, {}, 0);
+      add_pattern(kCompleteLocalName, command.name, {}, 0);
+    } break;
+    case ApcfFilterType::MANUFACTURER_DATA: {
+      uint16_t company_mask = command.company_mask != 0 ? command.company_mask : 0xffff;
+      std::vector<uint8_t> value = {(uint8_t)command.company, (uint8_t)(command.company >> 8)};
+      std::vector<uint8_t> mask = {(uint8_t)company_mask, (uint8_t)(company_mask >> 8)};
+      value.insert(value.end(), command.data.begin(), command.data.end());
+      if (command.data_mask.empty()) {
+        mask.insert(mask.end(), command.data.size(), 0xff);
+      } else {
+        mask.insert(mask.end(), command.data_mask.begin(), command.data_mask.end());
+      }
+      add_pattern(kManufacturerSpecificData, value, mask, 0);
+    } break;
+    case ApcfFilterType::SERVICE_DATA: {
+      add_pattern(kServiceData16BitUuid, command.data, command.data_mask, 0);
+    } break;
+    case ApcfFilterType::TRANSPORT_DISCOVERY_DATA: {
+      if (command.meta_data_type != ApcfMetaDataType::INVALID) {
+        return false;
+      }
+      // Organization ID, TDS flags, transport data length, transport data.
+      std::vector<uint8_t> value = {command.org_id, command.tds_flags, 0x00};
+      std::vector<uint8_t> mask = {0xff, command.tds_flags_mask, 0x00};
+      value.insert(value.end(), command.data.begin(), command.data.end());
+      if (command.data_mask.empty()) {
+        mask.insert(mask.end(), command.data.size(), 0xff);
+      } else {
+        mask.insert(mask.end(), command.data_mask.begin(), command.data_mask.end());
+      }
+      add_pattern(kTransportDiscoveryData, value, mask, 0);
+    } break;
+    case ApcfFilterType::AD_TYPE: {
+      add_pattern(command.ad_type, command.data, command.data_mask, 0);
+    } break;
+    default:
+      return false;
+  }
+
+  filter.conditions.push_back(condition);
+  return true;
+}
+
+void LeScanningFilterEngine::Compile() {
+  std::vector<AdvertisingDataPattern> patterns;
+  for (auto& [filter_index, filter] : filters_) {
+    filter.pattern_offset = patterns.size();
+    patterns.insert(patterns.end(), filter.patterns.begin(), filter.patterns.end());
+  }
+  matcher_.Compile(patterns);
+  compiled_ = true;
+}
+
+bool LeScanningFilterEngine::Matches(
+    const Address& address, int8_t rssi, const std::vector<uint8_t>& advertising_data) {
+  if (!compiled_) {
+    Compile();
+  }
+
+  index_.Build(advertising_data);
+  matcher_.Match(index_, matches_);
+
+  for (const auto& [filter_index, filter] : filters_) {
+    if (!filter.has_parameters || rssi < filter.rssi_threshold) {
+      continue;
+    }
+    bool match = true;
+    for (const auto& condition : filter.conditions) {
+      if ((filter.feature_selection & (1 << static_cast<uint8_t>(condition.type))) == 0) {
+        continue;
+      }
+      bool condition_match = false;
+      if (condition.is_address) {
+        condition_match = condition.address == address;
+      } else {
+        size_t first = filter.pattern_offset + condition.first_pattern;
+        for (size_t id = first; id < first + condition.pattern_count && !condition_match; id++) {
+          condition_match = matches_[id];
+        }
+      }
+      if (!condition_match) {
+        match = false;
+        break;
+      }
+    }
+    if (match) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bluetooth::hci
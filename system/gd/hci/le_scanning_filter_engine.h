@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "hci/address.h"
+#include "hci/advertising_data_index.h"
+#include "hci/le_scanning_callback.h"
+
+namespace bluetooth::hci {
+
+/// The LE Scanning filter engine evaluates advertising packet content filters
+/// (APCF) on the host, for the filter indexes that don't fit in the controller
+/// filter table.
+/// The content conditions of all the filters are compiled into a single
+/// AdvertisingDataMatcher, so each report is decoded and matched once
+/// whatever the number of filters.
+///
+/// A filter matches a report when all of its content conditions selected by
+/// the feature selection of its parameters match, and the RSSI is at least
+/// the high threshold. A filter without selected conditions matches every
+/// report, like the all pass filter of the controller.
+
+class LeScanningFilterEngine {
+ public:
+  LeScanningFilterEngine() = default;
+  LeScanningFilterEngine(const LeScanningFilterEngine&) = delete;
+  LeScanningFilterEngine& operator=(const LeScanningFilterEngine&) = delete;
+
+  /// Set the parameters of the filter |filter_index|, after which it applies.
+  void SetFilterParameters(uint8_t filter_index, const AdvertisingFilterParameter& parameter);
+
+  /// Add content conditions to the filter |filter_index|. Returns false if
+  /// one of the conditions can't be evaluated on the host, in which case the
+  /// others are still added.
+  bool AddFilters(uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& filters);
+
+  void RemoveFilter(uint8_t filter_index);
+  void Clear();
+
+  bool IsEmpty() const {
+    return filters_.empty();
+  }
+  bool Contains(uint8_t filter_index) const {
+    return filters_.count(filter_index) != 0;
+  }
+  size_t GetFilterCount() const {
+    return filters_.size();
+  }
+
+  /// Returns true if the report matches at least one filter.
+  bool Matches(const Address& address, int8_t rssi, const std::vector<uint8_t>& advertising_data);
+
+ private:
+  /// One content condition: the address matches, or any of the filter
+  /// patterns [first_pattern, first_pattern + pattern_count) matches.
+  struct Condition {
+    ApcfFilterType type;
+    bool is_address;
+    Address address;
+    size_t first_pattern;
+    size_t pattern_count;
+  };
+
+  struct Filter {
+    // The filter only applies once its parameters are set.
+    bool has_parameters{false};
+    uint16_t feature_selection{0};
+    int8_t rssi_threshold{0};
+    std::vector<Condition> conditions;
+    std::vector<AdvertisingDataPattern> patterns;
+    // Id of the first pattern of the filter in the compiled matcher.
+    size_t pattern_offset{0};
+  };
+
+  static bool AddCondition(Filter& filter, const AdvertisingPacketContentFilterCommand& command);
+  void Compile();
+
+  std::map<uint8_t, Filter> filters_;
+  AdvertisingDataMatcher matcher_;
+  bool compiled_{true};
+
+  // Scratch state reused across reports.
+  AdvertisingDataIndex index_;
+  std::vector<bool> matches_;
+};
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_filter_engine.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth::hci {
+
+// Feature selection bits.
+static constexpr uint16_t kAllFeatures = 0x01ff;
+
+static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
+static const Address kOtherAddress = Address({5, 4, 3, 2, 1, 0});
+
+// Flags, 16 bit service UUIDs (heart rate, battery), manufacturer data (Google).
+static const std::vector<uint8_t> kAdvertisingData = {
+    0x02, 0x01, 0x06, 0x05, 0x03, 0x0d, 0x18, 0x0f, 0x18, 0x06, 0xff, 0xe0, 0x00, 0x01, 0x02, 0x03};
+
+class LeScanningFilterEngineTest : public ::testing::Test {
+ protected:
+  static AdvertisingFilterParameter Parameter(uint16_t feature_selection = kAllFeatures, int8_t rssi_threshold = -128) {
+    AdvertisingFilterParameter parameter{};
+    parameter.feature_selection = feature_selection;
+    parameter.rssi_high_thresh = static_cast<uint8_t>(rssi_threshold);
+    parameter.delivery_mode = DeliveryMode::IMMEDIATE;
+    return parameter;
+  }
+
+  static AdvertisingPacketContentFilterCommand Command(ApcfFilterType filter_type) {
+    AdvertisingPacketContentFilterCommand command{};
+    command.filter_type = filter_type;
+    command.meta_data_type = ApcfMetaDataType::INVALID;
+    return command;
+  }
+
+  static AdvertisingPacketContentFilterCommand ServiceUuid(uint16_t uuid) {
+    auto command = Command(ApcfFilterType::SERVICE_UUID);
+    command.uuid = Uuid::From16Bit(uuid);
+    return command;
+  }
+
+  static AdvertisingPacketContentFilterCommand ManufacturerData(uint16_t company, std::vector<uint8_t> data) {
+    auto command = Command(ApcfFilterType::MANUFACTURER_DATA);
+    command.company = company;
+    command.data = data;
+    return command;
+  }
+
+  bool Matches(const Address& address = kTestAddress, int8_t rssi = -50) {
+    return engine_.Matches(address, rssi, kAdvertisingData);
+  }
+
+  LeScanningFilterEngine engine_;
+};
+
+TEST_F(LeScanningFilterEngineTest, filter_applies_with_parameters) {
+  ASSERT_TRUE(engine_.AddFilters(0, {ServiceUuid(0x1234)}));
+  ASSERT_FALSE(Matches());
+
+  // An all pass filter matches everything.
+  engine_.SetFilterParameters(1, Parameter());
+  ASSERT_TRUE(Matches());
+  engine_.RemoveFilter(1);
+  ASSERT_FALSE(Matches());
+}
+
+TEST_F(LeScanningFilterEngineTest, conditions_are_combined) {
+  auto address = Command(ApcfFilterType::BROADCASTER_ADDRESS);
+  address.address = kTestAddress;
+  ASSERT_TRUE(engine_.AddFilters(0, {ServiceUuid(0x180f), ManufacturerData(0x00e0, {0x01, 0x02}), address}));
+  engine_.SetFilterParameters(0, Parameter());
+  ASSERT_TRUE(Matches());
+  ASSERT_FALSE(Matches(kOtherAddress));
+
+  ASSERT_TRUE(engine_.AddFilters(0, {ManufacturerData(0x00e0, {0x02})}));
+  ASSERT_FALSE(Matches());
+
+  // Only the selected features are evaluated.
+  engine_.SetFilterParameters(0, Parameter(1 << static_cast<uint8_t>(ApcfFilterType::SERVICE_UUID)));
+  ASSERT_TRUE(Matches(kOtherAddress));
+}
+
+TEST_F(LeScanningFilterEngineTest, any_filter_matches) {
+  for (uint8_t filter_index = 0; filter_index < 40; filter_index++) {
+    ASSERT_TRUE(engine_.AddFilters(filter_index, {ServiceUuid(0x2000 + filter_index)}));
+    engine_.SetFilterParameters(filter_index, Parameter());
+  }
+  ASSERT_FALSE(Matches());
+
+  ASSERT_TRUE(engine_.AddFilters(40, {ManufacturerData(0x00e0, {})}));
+  engine_.SetFilterParameters(40, Parameter());
+  ASSERT_TRUE(Matches());
+  ASSERT_EQ(41u, engine_.GetFilterCount());
+
+  engine_.Clear();
+  ASSERT_TRUE(engine_.IsEmpty());
+  ASSERT_FALSE(Matches());
+}
+
+TEST_F(LeScanningFilterEngineTest, masked_data_and_rssi) {
+  auto manufacturer_data = ManufacturerData(0x00e0, {0x01, 0xf2});
+  manufacturer_data.data_mask = {0xff, 0x0f};
+  ASSERT_TRUE(engine_.AddFilters(0, {manufacturer_data}));
+  engine_.SetFilterParameters(0, Parameter(kAllFeatures, -60));
+  ASSERT_TRUE(Matches(kTestAddress, -50));
+  ASSERT_FALSE(Matches(kTestAddress, -70));
+}
+
+TEST_F(LeScanningFilterEngineTest, unsupported_condition) {
+  auto tds = Command(ApcfFilterType::TRANSPORT_DISCOVERY_DATA);
+  tds.meta_data_type = ApcfMetaDataType::WIFI_NAN_HASH;
+  ASSERT_FALSE(engine_.AddFilters(0, {tds}));
+}
+
+}  // namespace bluetooth::hci
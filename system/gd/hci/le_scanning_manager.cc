@@ -15,7 +15,10 @@
  */
 #include "hci/le_scanning_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <set>
 #include <unordered_map>
 
 #include "hci/acl_manager.h"
@@ -23,10 +26,14 @@
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
 #include "hci/le_periodic_sync_manager.h"
+#include "hci/le_scanning_deduplicator.h"
+#include "hci/le_scanning_filter_engine.h"
 #include "hci/le_scanning_interface.h"
 #include "hci/le_scanning_reassembler.h"
 #include "hci/vendor_specific_event_manager.h"
+#include "hci_le_scanning_manager_generated.h"
 #include "module.h"
+#include "os/alarm.h"
 #include "os/handler.h"
 #include "os/log.h"
 #include "os/system_properties.h"
@@ -58,6 +65,11 @@ constexpr uint8_t kDataStatusBits = 5;
 // system properties
 const std::string kLeRxPathLossCompProperty = "bluetooth.hardware.radio.le_rx_path_loss_comp_db";
 const std::string kPropertyDisableApcfExtendedFeatures = "bluetooth.le.disable_apcf_extended_features";
+const std::string kPropertyScanResultBatchWindow = "bluetooth.core.le.scan_result_batch_window_ms";
+constexpr uint32_t kMaxScanResultBatchWindowMs = 1000;
+// Number of filter indexes emulated on the host past the controller filter table.
+// Also read by the legacy stack when reporting the filter table size upwards.
+const std::string kPropertySoftwareScanFilters = "bluetooth.core.le.software_scan_filters";
 bool kDisableApcfExtendedFeatures = false;
 
 const ModuleFactory LeScanningManager::Factory = ModuleFactory([]() { return new LeScanningManager(); });
@@ -71,6 +83,13 @@ enum class ScanApiType {
 struct Scanner {
   Uuid app_uuid;
   bool in_use;
+  std::chrono::milliseconds deduplication_refresh_interval{0};
+  bool deduplication_reports_rssi_changes{false};
+  // Scan parameters asked by the scanner until the scan is stopped, combined by update_scan_parameters
+  bool has_scan_parameters{false};
+  LeScanType scan_type{LeScanType::PASSIVE};
+  uint16_t scan_interval{0};
+  uint16_t scan_window{0};
 };
 
 class NullScanningCallback : public ScanningCallback {
@@ -189,6 +208,9 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     le_scanning_interface_ = hci_layer_->GetLeScanningInterface(
         module_handler_->BindOn(this, &LeScanningManager::impl::handle_scan_results));
     periodic_sync_manager_.Init(le_scanning_interface_, module_handler_);
+    if (controller_->IsSupported(OpCode::LE_READ_PERIODIC_ADVERTISER_LIST_SIZE)) {
+      periodic_sync_manager_.SetPeriodicAdvertiserListSize(controller_->GetLePeriodicAdvertiserListSize());
+    }
     /* Check to see if the opcode is supported and C19 (support for extended advertising). */
     if (controller_->IsSupported(OpCode::LE_SET_EXTENDED_SCAN_PARAMETERS) &&
         controller->SupportsBleExtendedAdvertising()) {
@@ -201,6 +223,9 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       api_type_ = ScanApiType::LEGACY;
     }
     is_filter_supported_ = controller_->IsSupported(OpCode::LE_ADV_FILTER);
+    hardware_filter_slots_ = is_filter_supported_ ? controller_->GetVendorCapabilities().max_filter_ : 0;
+    software_filter_slots_ = std::min<int>(
+        os::GetSystemPropertyUint32(kPropertySoftwareScanFilters, 0), UINT8_MAX - hardware_filter_slots_);
     if (os::GetSystemProperty(kPropertyDisableApcfExtendedFeatures) == "1")
       kDisableApcfExtendedFeatures = true;
     if (is_filter_supported_ && !kDisableApcfExtendedFeatures) {
@@ -226,6 +251,9 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     batch_scan_config_.current_state = BatchScanState::DISABLED_STATE;
     batch_scan_config_.ref_value = kInvalidScannerId;
     le_rx_path_loss_comp_ = get_rx_path_loss_compensation();
+    scan_result_batch_alarm_ = std::make_unique<os::Alarm>(module_handler_);
+    set_scan_result_batch_window(
+        std::chrono::milliseconds(os::GetSystemPropertyUint32(kPropertyScanResultBatchWindow, 0)));
   }
 
   void stop() {
@@ -239,6 +267,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     }
     batch_scan_config_.current_state = BatchScanState::DISABLED_STATE;
     batch_scan_config_.ref_value = kInvalidScannerId;
+    scan_result_batch_alarm_.reset();
+    pending_scan_results_.clear();
     scanning_callbacks_ = &null_scanning_callback_;
     periodic_sync_manager_.SetScanningCallback(scanning_callbacks_);
   }
@@ -452,6 +482,36 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
           break;
       }
 
+      if (!software_filter_indexes_.empty() &&
+          !scanning_filter_engine_.Matches(address, rssi, complete_advertising_data.value())) {
+        return;
+      }
+
+      if (!scanning_deduplicator_.ShouldForward(
+              address_type,
+              address,
+              advertising_sid,
+              rssi,
+              complete_advertising_data.value(),
+              std::chrono::steady_clock::now())) {
+        return;
+      }
+
+      if (scan_result_batch_window_.count() > 0) {
+        batch_scan_result(ScanResult{
+            event_type,
+            address_type,
+            address,
+            primary_phy,
+            secondary_phy,
+            advertising_sid,
+            tx_power,
+            get_rssi_after_calibration(rssi),
+            periodic_advertising_interval,
+            std::move(complete_advertising_data.value())});
+        return;
+      }
+
       scanning_callbacks_->OnScanResult(
           event_type,
           address_type,
@@ -466,6 +526,48 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     }
   }
 
+  void set_scan_result_batch_window(std::chrono::milliseconds window) {
+    if (window > std::chrono::milliseconds(kMaxScanResultBatchWindowMs)) {
+      LOG_WARN(
+          "Scan result batch window %d ms is too long, using %u ms",
+          (int)window.count(),
+          kMaxScanResultBatchWindowMs);
+      window = std::chrono::milliseconds(kMaxScanResultBatchWindowMs);
+    }
+    LOG_INFO("Scan result batch window: %d ms", (int)window.count());
+    scan_result_batch_window_ = window;
+    if (window.count() == 0) {
+      flush_scan_results();
+    }
+  }
+
+  void batch_scan_result(ScanResult result) {
+    // The window starts with the first result of a batch, so a result waits at most one window
+    if (pending_scan_results_.empty()) {
+      scan_result_batch_alarm_->Schedule(
+          common::BindOnce(&impl::flush_scan_results, common::Unretained(this)), scan_result_batch_window_);
+    }
+    pending_scan_results_.push_back(std::move(result));
+    if (pending_scan_results_.size() >= kMaxScanResultsPerBatch) {
+      full_scan_result_batches_++;
+      flush_scan_results();
+    }
+  }
+
+  void flush_scan_results() {
+    scan_result_batch_alarm_->Cancel();
+    if (pending_scan_results_.empty()) {
+      return;
+    }
+    batched_scan_results_ += pending_scan_results_.size();
+    scan_result_batches_++;
+    // The next batch starts from a buffer that won't have to grow
+    std::vector<ScanResult> results;
+    results.reserve(kMaxScanResultsPerBatch);
+    results.swap(pending_scan_results_);
+    scanning_callbacks_->OnScanResults(std::move(results));
+  }
+
   void configure_scan() {
     std::vector<PhyScanParameters> parameter_vector;
     PhyScanParameters phy_scan_parameters;
@@ -522,6 +624,7 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       if (!scanners_[i].in_use) {
         scanners_[i].app_uuid = app_uuid;
         scanners_[i].in_use = true;
+        update_scan_deduplication();
         scanning_callbacks_->OnScannerRegistered(app_uuid, i, ScanningCallback::ScanningStatus::SUCCESS);
         return;
       }
@@ -540,11 +643,53 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     if (scanners_[scanner_id].in_use) {
       scanners_[scanner_id].in_use = false;
       scanners_[scanner_id].app_uuid = Uuid::kEmpty;
+      scanners_[scanner_id].deduplication_refresh_interval = std::chrono::milliseconds(0);
+      scanners_[scanner_id].deduplication_reports_rssi_changes = false;
+      update_scan_deduplication();
+      scanners_[scanner_id].has_scan_parameters = false;
+      if (update_scan_parameters() && is_scanning_) {
+        configure_scan();
+        start_scan();
+      }
     } else {
       LOG_WARN("Unregister scanner with unused scanner id");
     }
   }
 
+  void set_scan_deduplication(
+      ScannerId scanner_id, std::chrono::milliseconds refresh_interval, bool report_rssi_changes) {
+    if (scanner_id <= 0 || scanner_id > kMaxAppNum || !scanners_[scanner_id].in_use) {
+      LOG_WARN("Invalid scanner id %d", scanner_id);
+      return;
+    }
+    scanners_[scanner_id].deduplication_refresh_interval = refresh_interval;
+    scanners_[scanner_id].deduplication_reports_rssi_changes = report_rssi_changes;
+    update_scan_deduplication();
+  }
+
+  // All registered scanners share the scan results, so a repeat may only be dropped if none of them wants it
+  void update_scan_deduplication() {
+    std::chrono::milliseconds refresh_interval = std::chrono::milliseconds::max();
+    bool report_rssi_changes = false;
+    bool any_scanner = false;
+    for (uint8_t i = 1; i <= kMaxAppNum; i++) {
+      if (!scanners_[i].in_use) {
+        continue;
+      }
+      any_scanner = true;
+      refresh_interval = std::min(refresh_interval, scanners_[i].deduplication_refresh_interval);
+      report_rssi_changes |= scanners_[i].deduplication_reports_rssi_changes;
+    }
+    if (!any_scanner) {
+      refresh_interval = std::chrono::milliseconds(0);
+    }
+    LOG_INFO(
+        "Scan deduplication refresh interval: %d ms, report rssi changes: %s",
+        (int)refresh_interval.count(),
+        report_rssi_changes ? "true" : "false");
+    scanning_deduplicator_.Configure(refresh_interval, report_rssi_changes);
+  }
+
   void scan(bool start) {
     if (start) {
       configure_scan();
@@ -556,6 +701,15 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
         paused_ = false;
       }
       stop_scan();
+      if (scanning_deduplicator_.IsEnabled()) {
+        LOG_INFO("Suppressed %" PRIu64 " duplicate scan results", scanning_deduplicator_.GetSuppressedCount());
+      }
+      scanning_deduplicator_.Clear();
+      // The upper layer sets the parameters of the next scan again before starting it
+      for (auto& scanner : scanners_) {
+        scanner.has_scan_parameters = false;
+      }
+      num_scan_requirements_ = 0;
     }
   }
 
@@ -593,6 +747,14 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       return;
     }
     is_scanning_ = false;
+    flush_scan_results();
+    if (scan_result_batches_ > 0) {
+      LOG_INFO(
+          "Delivered %" PRIu64 " scan results in %" PRIu64 " batches, %" PRIu64 " batches were full",
+          batched_scan_results_,
+          scan_result_batches_,
+          full_scan_result_batches_);
+    }
 
     switch (api_type_) {
       case ScanApiType::EXTENDED:
@@ -636,28 +798,153 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
           scanner_id, ScanningCallback::ScanningStatus::ILLEGAL_PARAMETER);
       return;
     }
-    le_scan_type_ = scan_type;
-    interval_ms_ = scan_interval;
-    window_ms_ = scan_window;
+    if (scanner_id <= 0 || scanner_id > kMaxAppNum || !scanners_[scanner_id].in_use) {
+      LOG_WARN("Scan parameters of unregistered scanner id %d are not combined", scanner_id);
+      le_scan_type_ = scan_type;
+      interval_ms_ = scan_interval;
+      window_ms_ = scan_window;
+      update_effective_scan_parameters();
+    } else {
+      scanners_[scanner_id].has_scan_parameters = true;
+      scanners_[scanner_id].scan_type = scan_type;
+      scanners_[scanner_id].scan_interval = scan_interval;
+      scanners_[scanner_id].scan_window = scan_window;
+      if (update_scan_parameters() && is_scanning_) {
+        configure_scan();
+        start_scan();
+      }
+    }
     scanning_callbacks_->OnSetScannerParameterComplete(scanner_id, ScanningCallback::SUCCESS);
   }
 
+  // The scanners share a single scan, which runs with the smallest duty cycle satisfying all of them: the shortest
+  // interval, with the window giving the highest window / interval ratio asked, active if any scanner is. The largest
+  // window of one scanner with the shortest interval of another would scan for longer than any of them asked. The last
+  // parameters are kept when no scanner asks for any. Returns whether the parameters changed.
+  bool update_scan_parameters() {
+    uint8_t num_requirements = 0;
+    LeScanType scan_type = LeScanType::PASSIVE;
+    uint32_t interval = UINT32_MAX;
+    for (const auto& scanner : scanners_) {
+      if (!scanner.in_use || !scanner.has_scan_parameters) {
+        continue;
+      }
+      num_requirements++;
+      if (scanner.scan_type == LeScanType::ACTIVE) {
+        scan_type = LeScanType::ACTIVE;
+      }
+      interval = std::min<uint32_t>(interval, scanner.scan_interval);
+    }
+    num_scan_requirements_ = num_requirements;
+    if (num_requirements == 0) {
+      return false;
+    }
+
+    uint32_t window = kLeScanWindowMin;
+    for (const auto& scanner : scanners_) {
+      if (!scanner.in_use || !scanner.has_scan_parameters) {
+        continue;
+      }
+      // Rounded up, so that the scanner gets at least the duty cycle it asked for
+      window = std::max<uint32_t>(
+          window, (scanner.scan_window * interval + scanner.scan_interval - 1) / scanner.scan_interval);
+    }
+    window = std::min(window, interval);
+
+    bool changed = scan_type != le_scan_type_ || interval != interval_ms_ || window != window_ms_;
+    le_scan_type_ = scan_type;
+    interval_ms_ = interval;
+    window_ms_ = static_cast<uint16_t>(window);
+    update_effective_scan_parameters();
+    if (changed) {
+      LOG_INFO(
+          "Scan parameters of %d scanners: %s, interval:0x%04x, window:0x%04x",
+          num_requirements,
+          scan_type == LeScanType::ACTIVE ? "active" : "passive",
+          interval_ms_,
+          window_ms_);
+    }
+    return changed;
+  }
+
+  // Copies of the parameters for dumpsys, which does not run on the module handler
+  void update_effective_scan_parameters() {
+    effective_scan_active_ = le_scan_type_ == LeScanType::ACTIVE;
+    effective_scan_interval_ = interval_ms_;
+    effective_scan_window_ = window_ms_;
+  }
+
+  flatbuffers::Offset<LeScanningManagerData> Dump(flatbuffers::FlatBufferBuilder* fb_builder) const {
+    auto title = fb_builder->CreateString("----- Le Scanning Manager Dumpsys -----");
+    uint32_t interval = effective_scan_interval_;
+    uint32_t batch_scan_interval = batch_scan_interval_;
+    LeScanningManagerDataBuilder builder(*fb_builder);
+    builder.add_title(title);
+    builder.add_scanning(is_scanning_);
+    builder.add_active_scan(effective_scan_active_);
+    builder.add_scan_interval(interval);
+    builder.add_scan_window(effective_scan_window_);
+    builder.add_duty_cycle_per_mille(interval == 0 ? 0 : effective_scan_window_ * 1000 / interval);
+    builder.add_num_scan_requirements(num_scan_requirements_);
+    builder.add_batch_scan_duty_cycle_per_mille(
+        batch_scan_interval == 0 ? 0 : batch_scan_window_ * 1000 / batch_scan_interval);
+    return builder.Finish();
+  }
+
   void set_scan_filter_policy(LeScanningFilterPolicy filter_policy) {
     filter_policy_ = filter_policy;
   }
 
   void scan_filter_enable(bool enable) {
-    if (!is_filter_supported_) {
+    if (!is_filter_supported_ && software_filter_slots_ == 0) {
       LOG_WARN("Advertising filter is not supported");
       return;
     }
 
+    filter_enabled_ = enable;
     Enable apcf_enable = enable ? Enable::ENABLED : Enable::DISABLED;
+    // The controller filtering stays disabled while filters are evaluated on the host.
+    if (!is_filter_supported_ || !software_filter_indexes_.empty()) {
+      scanning_callbacks_->OnFilterEnable(apcf_enable, (uint8_t)ErrorCode::SUCCESS);
+      return;
+    }
     le_scanning_interface_->EnqueueCommand(
         LeAdvFilterEnableBuilder::Create(apcf_enable),
         module_handler_->BindOnceOn(this, &impl::on_advertising_filter_complete));
   }
 
+  bool is_software_filter_index(uint8_t filter_index) {
+    return filter_index >= hardware_filter_slots_ && filter_index < hardware_filter_slots_ + software_filter_slots_;
+  }
+
+  uint8_t available_software_filter_slots() {
+    return software_filter_slots_ - software_filter_indexes_.size();
+  }
+
+  /// Track the filter indexes evaluated on the host. The first one disables the
+  /// controller filtering, as the controller must then report every advertisement,
+  /// and the last one restores it.
+  void update_software_filter_index(uint8_t filter_index, bool in_use) {
+    bool was_host_filtering = !software_filter_indexes_.empty();
+    if (in_use) {
+      software_filter_indexes_.insert(filter_index);
+    } else {
+      software_filter_indexes_.erase(filter_index);
+    }
+    bool is_host_filtering = !software_filter_indexes_.empty();
+    if (was_host_filtering == is_host_filtering) {
+      return;
+    }
+
+    LOG_INFO("%s host filtering", is_host_filtering ? "Starting" : "Stopping");
+    if (is_filter_supported_ && filter_enabled_) {
+      Enable apcf_enable = is_host_filtering ? Enable::DISABLED : Enable::ENABLED;
+      le_scanning_interface_->EnqueueCommand(
+          LeAdvFilterEnableBuilder::Create(apcf_enable),
+          module_handler_->BindOnceOn(this, &impl::on_host_filtering_enable_complete));
+    }
+  }
+
   bool is_bonded(Address target_address) {
     for (auto device : storage_module_->GetBondedDevices()) {
       if (device.GetAddress() == target_address) {
@@ -671,11 +958,52 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
 
   void scan_filter_parameter_setup(
       ApcfAction action, uint8_t filter_index, AdvertisingFilterParameter advertising_filter_parameter) {
-    if (!is_filter_supported_) {
+    if (!is_filter_supported_ && software_filter_slots_ == 0) {
       LOG_WARN("Advertising filter is not supported");
       return;
     }
 
+    // Mirror the filters of the controller, so that they keep applying when the
+    // controller filtering is disabled for the filters evaluated on the host.
+    switch (action) {
+      case ApcfAction::ADD:
+        scanning_filter_engine_.SetFilterParameters(filter_index, advertising_filter_parameter);
+        break;
+      case ApcfAction::DELETE:
+        scanning_filter_engine_.RemoveFilter(filter_index);
+        break;
+      case ApcfAction::CLEAR:
+        scanning_filter_engine_.Clear();
+        break;
+      default:
+        break;
+    }
+
+    if (action == ApcfAction::CLEAR) {
+      while (!software_filter_indexes_.empty()) {
+        update_software_filter_index(*software_filter_indexes_.begin(), false);
+      }
+      if (!is_filter_supported_) {
+        scanning_callbacks_->OnFilterParamSetup(available_software_filter_slots(), action, (uint8_t)ErrorCode::SUCCESS);
+        return;
+      }
+    } else if (is_software_filter_index(filter_index)) {
+      if (action == ApcfAction::ADD && advertising_filter_parameter.delivery_mode != DeliveryMode::IMMEDIATE) {
+        LOG_WARN(
+            "Filter %hhu is evaluated on the host, reports are delivered immediately instead of %s",
+            filter_index,
+            DeliveryModeText(advertising_filter_parameter.delivery_mode).c_str());
+      }
+      update_software_filter_index(filter_index, action == ApcfAction::ADD);
+      scanning_callbacks_->OnFilterParamSetup(available_software_filter_slots(), action, (uint8_t)ErrorCode::SUCCESS);
+      return;
+    }
+
+    if (!is_filter_supported_) {
+      LOG_WARN("Filter index %hhu is out of range", filter_index);
+      return;
+    }
+
     auto entry = remove_me_later_map_.find(filter_index);
     switch (action) {
       case ApcfAction::ADD:
@@ -701,6 +1029,7 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
             module_handler_->BindOnceOn(this, &impl::on_advertising_filter_complete));
 
         // IRK Scanning
+        le_address_manager_->BeginListChanges();
         if (entry != remove_me_later_map_.end()) {
           // Don't want to remove for a bonded device
           if (!is_bonded(entry->second.GetAddress())) {
@@ -734,11 +1063,25 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   }
 
   void scan_filter_add(uint8_t filter_index, std::vector<AdvertisingPacketContentFilterCommand> filters) {
-    if (!is_filter_supported_) {
+    if (!is_filter_supported_ && software_filter_slots_ == 0) {
       LOG_WARN("Advertising filter is not supported");
       return;
     }
 
+    bool success = scanning_filter_engine_.AddFilters(filter_index, filters);
+    if (is_software_filter_index(filter_index)) {
+      uint8_t status = (uint8_t)(success ? ErrorCode::SUCCESS : ErrorCode::UNSUPPORTED_FEATURE_OR_PARAMETER_VALUE);
+      for (const auto& filter : filters) {
+        scanning_callbacks_->OnFilterConfigCallback(
+            filter.filter_type, available_software_filter_slots(), ApcfAction::ADD, status);
+      }
+      return;
+    }
+    if (!is_filter_supported_) {
+      LOG_WARN("Filter index %hhu is out of range", filter_index);
+      return;
+    }
+
     ApcfAction apcf_action = ApcfAction::ADD;
     for (auto filter : filters) {
       /* If data is passed, both mask and data have to be the same length */
@@ -837,9 +1180,10 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
         }
 
         // Now replace it with a new one
-        std::array<uint8_t, 16> empty_irk;
+        std::array<uint8_t, 16> empty_irk{};
         le_address_manager_->AddDeviceToResolvingList(
             static_cast<PeerAddressType>(address_type), address, irk, empty_irk);
+        le_address_manager_->CommitListChanges();
         remove_me_later_map_.emplace(filter_index, AddressWithType(address, static_cast<AddressType>(address_type)));
       }
     } else {
@@ -1132,6 +1476,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     batch_scan_config_.scan_mode = scan_mode;
     batch_scan_config_.scan_interval = duty_cycle_scan_interval_slots;
     batch_scan_config_.scan_window = duty_cycle_scan_window_slots;
+    batch_scan_interval_ = duty_cycle_scan_interval_slots;
+    batch_scan_window_ = duty_cycle_scan_window_slots;
     batch_scan_config_.discard_rule = batch_scan_discard_rule;
     /* This command starts batch scanning, if enabled */
     batch_scan_set_scan_parameter(
@@ -1463,6 +1809,15 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     }
   }
 
+  void on_host_filtering_enable_complete(CommandCompleteView view) {
+    ASSERT(view.IsValid());
+    auto status_view = LeAdvFilterCompleteView::Create(view);
+    ASSERT(status_view.IsValid());
+    if (status_view.GetStatus() != ErrorCode::SUCCESS) {
+      LOG_WARN("Failed to update the controller filtering: %s", ErrorCodeText(status_view.GetStatus()).c_str());
+    }
+  }
+
   void on_apcf_read_extended_features_complete(CommandCompleteView view) {
     ASSERT(view.IsValid());
     auto status_view = LeAdvFilterCompleteView::Create(view);
@@ -1511,6 +1866,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     if (status_view.GetStatus() != ErrorCode::SUCCESS) {
       LOG_INFO("Got batch scan enable complete, status %s", ErrorCodeText(status_view.GetStatus()).c_str());
       batch_scan_config_.current_state = BatchScanState::ERROR_STATE;
+      batch_scan_interval_ = 0;
+      batch_scan_window_ = 0;
     } else {
       batch_scan_config_.current_state = BatchScanState::ENABLED_STATE;
     }
@@ -1524,6 +1881,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     ASSERT(complete_view.IsValid());
     ASSERT(status_view.GetStatus() == ErrorCode::SUCCESS);
     batch_scan_config_.current_state = BatchScanState::DISABLED_STATE;
+    batch_scan_interval_ = 0;
+    batch_scan_window_ = 0;
   }
 
   void on_batch_scan_read_result_complete(
@@ -1635,10 +1994,17 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   ScanningCallback* scanning_callbacks_ = &null_scanning_callback_;
   PeriodicSyncManager periodic_sync_manager_{&null_scanning_callback_};
   std::vector<Scanner> scanners_;
-  bool is_scanning_ = false;
+  std::atomic_bool is_scanning_{false};
   bool scan_on_resume_ = false;
   bool paused_ = false;
   LeScanningReassembler scanning_reassembler_;
+  LeScanningDeduplicator scanning_deduplicator_;
+  LeScanningFilterEngine scanning_filter_engine_;
+  // Filter indexes past the controller filter table, evaluated on the host.
+  std::set<uint8_t> software_filter_indexes_;
+  uint8_t hardware_filter_slots_ = 0;
+  uint8_t software_filter_slots_ = 0;
+  bool filter_enabled_ = false;
   bool is_filter_supported_ = false;
   bool is_ad_type_filter_supported_ = false;
   bool is_batch_scan_supported_ = false;
@@ -1648,6 +2014,13 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   LeScanType le_scan_type_ = LeScanType::ACTIVE;
   uint32_t interval_ms_{1000};
   uint16_t window_ms_{1000};
+  // Read by dumpsys
+  std::atomic_bool effective_scan_active_{true};
+  std::atomic_uint32_t effective_scan_interval_{1000};
+  std::atomic_uint32_t effective_scan_window_{1000};
+  std::atomic_uint8_t num_scan_requirements_{0};
+  std::atomic_uint32_t batch_scan_interval_{0};
+  std::atomic_uint32_t batch_scan_window_{0};
   OwnAddressType own_address_type_{OwnAddressType::PUBLIC_DEVICE_ADDRESS};
   LeScanningFilterPolicy filter_policy_{LeScanningFilterPolicy::ACCEPT_ALL};
   BatchScanConfig batch_scan_config_;
@@ -1655,6 +2028,13 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   std::unordered_map<uint8_t, ScannerId> tracker_id_map_;
   uint16_t total_num_of_advt_tracked_ = 0x00;
   int8_t le_rx_path_loss_comp_ = 0;
+  std::chrono::milliseconds scan_result_batch_window_{0};
+  std::unique_ptr<os::Alarm> scan_result_batch_alarm_;
+  std::vector<ScanResult> pending_scan_results_;
+  uint64_t batched_scan_results_ = 0;
+  uint64_t scan_result_batches_ = 0;
+  // Batches delivered early because kMaxScanResultsPerBatch results arrived within one window
+  uint64_t full_scan_result_batches_ = 0;
 
   static void check_status(CommandCompleteView view) {
     switch (view.GetCommandOpCode()) {
@@ -1707,6 +2087,16 @@ void LeScanningManager::Stop() {
   pimpl_.reset();
 }
 
+DumpsysDataFinisher LeScanningManager::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const {
+  ASSERT(fb_builder != nullptr);
+
+  auto dumpsys_data = pimpl_->Dump(fb_builder);
+
+  return [dumpsys_data](DumpsysDataBuilder* dumpsys_builder) {
+    dumpsys_builder->add_hci_le_scanning_manager_dumpsys_data(dumpsys_data);
+  };
+}
+
 std::string LeScanningManager::ToString() const {
   return "Le Scanning Manager";
 }
@@ -1818,6 +2208,15 @@ void LeScanningManager::RegisterScanningCallback(ScanningCallback* scanning_call
   CallOn(pimpl_.get(), &impl::register_scanning_callback, scanning_callback);
 }
 
+void LeScanningManager::SetScanDeduplication(
+    ScannerId scanner_id, std::chrono::milliseconds refresh_interval, bool report_rssi_changes) {
+  CallOn(pimpl_.get(), &impl::set_scan_deduplication, scanner_id, refresh_interval, report_rssi_changes);
+}
+
+void LeScanningManager::SetScanResultBatchWindow(std::chrono::milliseconds window) {
+  CallOn(pimpl_.get(), &impl::set_scan_result_batch_window, window);
+}
+
 bool LeScanningManager::IsAdTypeFilterSupported() const {
   return pimpl_->is_ad_type_filter_supported();
 }
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include "common/callback.h"
@@ -41,6 +42,8 @@ class LeScanningManager : public bluetooth::Module {
   static constexpr uint8_t kTxPowerInformationNotPresent = 0x7f;
   static constexpr uint8_t kNotPeriodicAdvertisement = 0x00;
   static constexpr ScannerId kInvalidScannerId = 0xFF;
+  // A batch is delivered early once it holds this many results
+  static constexpr size_t kMaxScanResultsPerBatch = 256;
   LeScanningManager();
   LeScanningManager(const LeScanningManager&) = delete;
   LeScanningManager& operator=(const LeScanningManager&) = delete;
@@ -94,6 +97,16 @@ class LeScanningManager : public bluetooth::Module {
 
   virtual void RegisterScanningCallback(ScanningCallback* scanning_callback);
 
+  // Drop repeats of an advertisement reported to |scanner_id| less than |refresh_interval| ago. Repeats are only
+  // dropped while every registered scanner asked for it, using the shortest interval. With |report_rssi_changes|
+  // a repeat whose RSSI moved noticeably is still reported. A zero interval turns it off for the scanner.
+  virtual void SetScanDeduplication(
+      ScannerId scanner_id, std::chrono::milliseconds refresh_interval, bool report_rssi_changes);
+
+  // Coalesce scan results received within |window| into a single ScanningCallback::OnScanResults call.
+  // A zero window delivers every result on its own through OnScanResult.
+  virtual void SetScanResultBatchWindow(std::chrono::milliseconds window);
+
   virtual bool IsAdTypeFilterSupported() const;
 
   static const ModuleFactory Factory;
@@ -107,6 +120,8 @@ class LeScanningManager : public bluetooth::Module {
 
   std::string ToString() const override;
 
+  DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const override;  // Module
+
  private:
   struct impl;
   std::unique_ptr<impl> pimpl_;
@@ -242,6 +242,7 @@ class MockCallbacks : public bluetooth::hci::ScanningCallback {
        uint16_t periodic_advertising_interval,
        std::vector<uint8_t> advertising_data),
       (override));
+  MOCK_METHOD(void, OnScanResults, (std::vector<ScanResult> results), (override));
   MOCK_METHOD(
       void,
       OnTrackAdvFoundLost,
@@ -362,6 +363,67 @@ TEST_F(LeScanningManagerTest, start_scan_test) {
   test_hci_layer_->IncomingLeMetaEvent(LeAdvertisingReportBuilder::Create({report}));
 }
 
+TEST_F(LeScanningManagerTest, combine_scan_parameters_test) {
+  start_le_scanning_manager();
+  Uuid first_uuid = Uuid::From16Bit(0x1111);
+  Uuid second_uuid = Uuid::From16Bit(0x2222);
+  EXPECT_CALL(mock_callbacks_, OnScannerRegistered(first_uuid, ScannerId{1}, ScanningCallback::SUCCESS));
+  EXPECT_CALL(mock_callbacks_, OnScannerRegistered(second_uuid, ScannerId{2}, ScanningCallback::SUCCESS));
+  le_scanning_manager->RegisterScanner(first_uuid);
+  le_scanning_manager->RegisterScanner(second_uuid);
+
+  // A passive scan of 12.5% duty cycle and an active scan of 25% with a shorter interval
+  EXPECT_CALL(mock_callbacks_, OnSetScannerParameterComplete(_, ScanningCallback::SUCCESS)).Times(2);
+  le_scanning_manager->SetScanParameters(ScannerId{1}, LeScanType::PASSIVE, 0x0800, 0x0100);
+  le_scanning_manager->SetScanParameters(ScannerId{2}, LeScanType::ACTIVE, 0x0100, 0x0040);
+  sync_client_handler();
+
+  le_scanning_manager->Scan(true);
+  auto command = LeSetScanParametersView::Create(LeScanningCommandView::Create(test_hci_layer_->GetCommand()));
+  ASSERT_TRUE(command.IsValid());
+  ASSERT_EQ(LeScanType::ACTIVE, command.GetLeScanType());
+  ASSERT_EQ(0x0100, command.GetLeScanInterval());
+  ASSERT_EQ(0x0040, command.GetLeScanWindow());
+  test_hci_layer_->IncomingEvent(LeSetScanParametersCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  ASSERT_EQ(OpCode::LE_SET_SCAN_ENABLE, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  // The remaining scanner runs with its own parameters
+  le_scanning_manager->Unregister(ScannerId{2});
+  ASSERT_EQ(OpCode::LE_SET_SCAN_ENABLE, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  command = LeSetScanParametersView::Create(LeScanningCommandView::Create(test_hci_layer_->GetCommand()));
+  ASSERT_TRUE(command.IsValid());
+  ASSERT_EQ(LeScanType::PASSIVE, command.GetLeScanType());
+  ASSERT_EQ(0x0800, command.GetLeScanInterval());
+  ASSERT_EQ(0x0100, command.GetLeScanWindow());
+  test_hci_layer_->IncomingEvent(LeSetScanParametersCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  ASSERT_EQ(OpCode::LE_SET_SCAN_ENABLE, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+}
+
+TEST_F(LeScanningManagerTest, batched_scan_results_test) {
+  start_le_scanning_manager();
+  le_scanning_manager->SetScanResultBatchWindow(std::chrono::milliseconds(1000));
+
+  // Enable scan
+  le_scanning_manager->Scan(true);
+  ASSERT_EQ(OpCode::LE_SET_SCAN_PARAMETERS, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanParametersCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  ASSERT_EQ(OpCode::LE_SET_SCAN_ENABLE, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  LeAdvertisingResponse report = make_advertising_report();
+  EXPECT_CALL(mock_callbacks_, OnScanResult).Times(0);
+  test_hci_layer_->IncomingLeMetaEvent(LeAdvertisingReportBuilder::Create({report, report}));
+  sync_client_handler();
+
+  // Stopping the scan delivers the pending batch without waiting for the window
+  EXPECT_CALL(mock_callbacks_, OnScanResults(testing::SizeIs(2)));
+  le_scanning_manager->Scan(false);
+  sync_client_handler();
+}
+
 TEST_F(LeScanningManagerTest, is_ad_type_filter_supported_false_test) {
   start_le_scanning_manager();
   ASSERT_TRUE(fake_registry_.IsStarted(&HciLayer::Factory));
@@ -15,6 +15,8 @@
  */
 #include "hci/le_scanning_reassembler.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <unordered_map>
 
@@ -66,12 +68,15 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingRep
   }
 
   // Concatenate the data with existing fragments.
-  std::list<AdvertisingFragment>::iterator advertising_fragment =
-      AppendFragment(key, advertising_data);
+  AdvertisingFragment* advertising_fragment = AppendFragment(key, advertising_data);
+  if (advertising_fragment == nullptr) {
+    LOG_WARN("Dropping advertising data longer than %zu bytes", kMaximumAdvertisingDataSize);
+    return {};
+  }
 
   // Trim the advertising data when the complete payload is received.
   if (data_status != DataStatus::CONTINUING) {
-    advertising_fragment->data = TrimAdvertisingData(advertising_fragment->data);
+    advertising_fragment->size = TrimAdvertisingData(advertising_fragment->data.data(), advertising_fragment->size);
   }
 
   // TODO(b/272120114) waiting for a scan response here is prone to failure as the
@@ -89,8 +94,9 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingRep
 
   // Otherwise the full advertising report has been reassembled,
   // removed the cache entry and return the complete advertising data.
-  std::vector<uint8_t> complete_advertising_data = std::move(advertising_fragment->data);
-  cache_.erase(advertising_fragment);
+  std::vector<uint8_t> complete_advertising_data(
+      advertising_fragment->data.begin(), advertising_fragment->data.begin() + advertising_fragment->size);
+  advertising_fragment->in_use = false;
   return complete_advertising_data;
 }
 
@@ -98,24 +104,29 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingRep
 /// GAP Data entries.
 std::vector<uint8_t> LeScanningReassembler::TrimAdvertisingData(
     const std::vector<uint8_t>& advertising_data) {
+  std::vector<uint8_t> significant_advertising_data(advertising_data);
+  significant_advertising_data.resize(
+      TrimAdvertisingData(significant_advertising_data.data(), significant_advertising_data.size()));
+  return significant_advertising_data;
+}
+
+size_t LeScanningReassembler::TrimAdvertisingData(uint8_t* advertising_data, size_t size) {
   // Remove empty and overflowing entries from the advertising data.
-  std::vector<uint8_t> significant_advertising_data;
-  for (size_t offset = 0; offset < advertising_data.size();) {
-    size_t remaining_size = advertising_data.size() - offset;
+  // Entries are only ever moved towards the front, so this can be done in place.
+  size_t significant_size = 0;
+  for (size_t offset = 0; offset < size;) {
+    size_t remaining_size = size - offset;
     uint8_t entry_size = advertising_data[offset];
 
     if (entry_size != 0 && entry_size < remaining_size) {
-      significant_advertising_data.push_back(entry_size);
-      significant_advertising_data.insert(
-          significant_advertising_data.end(),
-          advertising_data.begin() + offset + 1,
-          advertising_data.begin() + offset + 1 + entry_size);
+      std::memmove(advertising_data + significant_size, advertising_data + offset, entry_size + 1);
+      significant_size += entry_size + 1;
     }
 
     offset += entry_size + 1;
   }
 
-  return significant_advertising_data;
+  return significant_size;
 }
 
 LeScanningReassembler::AdvertisingKey::AdvertisingKey(
@@ -132,48 +143,60 @@ LeScanningReassembler::AdvertisingKey::AdvertisingKey(
   }
 }
 
-bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& other) {
+bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& other) const {
   return address == other.address && sid == other.sid;
 }
 
 /// Append to the current advertising data of the selected advertiser.
 /// If the advertiser is unknown a new entry is added, optionally by
 /// dropping the oldest advertiser.
-std::list<LeScanningReassembler::AdvertisingFragment>::iterator
-LeScanningReassembler::AppendFragment(const AdvertisingKey& key, const std::vector<uint8_t>& data) {
-  auto it = FindFragment(key);
-  if (it != cache_.end()) {
-    it->data.insert(it->data.end(), data.cbegin(), data.cend());
-    return it;
+LeScanningReassembler::AdvertisingFragment* LeScanningReassembler::AppendFragment(
+    const AdvertisingKey& key, const std::vector<uint8_t>& data) {
+  AdvertisingFragment* fragment = FindFragment(key);
+  if (fragment == nullptr) {
+    fragment = &cache_[0];
+    for (auto& slot : cache_) {
+      if (!slot.in_use) {
+        fragment = &slot;
+        break;
+      }
+      if (slot.sequence < fragment->sequence) {
+        fragment = &slot;
+      }
+    }
+    fragment->key = key;
+    fragment->in_use = true;
+    fragment->sequence = next_sequence_++;
+    fragment->size = 0;
   }
 
-  if (cache_.size() > kMaximumCacheSize) {
-    cache_.pop_back();
+  if (data.size() > fragment->data.size() - fragment->size) {
+    fragment->in_use = false;
+    return nullptr;
   }
-
-  cache_.emplace_front(key, data);
-  return cache_.begin();
+  std::copy(data.cbegin(), data.cend(), fragment->data.begin() + fragment->size);
+  fragment->size += data.size();
+  return fragment;
 }
 
 void LeScanningReassembler::RemoveFragment(const AdvertisingKey& key) {
-  auto it = FindFragment(key);
-  if (it != cache_.end()) {
-    cache_.erase(it);
+  AdvertisingFragment* fragment = FindFragment(key);
+  if (fragment != nullptr) {
+    fragment->in_use = false;
   }
 }
 
 bool LeScanningReassembler::ContainsFragment(const AdvertisingKey& key) {
-  return FindFragment(key) != cache_.end();
+  return FindFragment(key) != nullptr;
 }
 
-std::list<LeScanningReassembler::AdvertisingFragment>::iterator LeScanningReassembler::FindFragment(
-    const AdvertisingKey& key) {
-  for (auto it = cache_.begin(); it != cache_.end(); it++) {
-    if (it->key == key) {
-      return it;
+LeScanningReassembler::AdvertisingFragment* LeScanningReassembler::FindFragment(const AdvertisingKey& key) {
+  for (auto& fragment : cache_) {
+    if (fragment.in_use && fragment.key == key) {
+      return &fragment;
     }
   }
-  return cache_.end();
+  return nullptr;
 }
 
 }  // namespace bluetooth::hci
@@ -17,8 +17,8 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <array>
 #include <cstdint>
-#include <list>
 #include <optional>
 #include <vector>
 
@@ -82,17 +82,24 @@ class LeScanningReassembler {
     std::optional<AddressWithType> address;
     std::optional<uint8_t> sid;
 
+    AdvertisingKey() = default;
     AdvertisingKey(Address address, DirectAdvertisingAddressType address_type, uint8_t sid);
-    bool operator==(const AdvertisingKey& other);
+    bool operator==(const AdvertisingKey& other) const;
   };
 
-  /// Packs incomplete advertising data.
+  /// Maximum length of the advertising data of one advertising event
+  /// (Core 5.4 Vol 4 Part E 7.8.64), scan response included.
+  static constexpr size_t kMaximumAdvertisingDataSize = 1650;
+
+  /// Packs incomplete advertising data in a reassembly slot.
+  /// The buffer is inline so that reassembling doesn't allocate.
   struct AdvertisingFragment {
     AdvertisingKey key;
-    std::vector<uint8_t> data;
-
-    AdvertisingFragment(const AdvertisingKey& key, const std::vector<uint8_t>& data)
-        : key(key), data(data.begin(), data.end()) {}
+    bool in_use{false};
+    /// Creation order of the slot, the oldest is evicted first.
+    uint64_t sequence{0};
+    size_t size{0};
+    std::array<uint8_t, kMaximumAdvertisingDataSize> data;
   };
 
   /// Advertising cache for de-fragmenting extended advertising reports,
@@ -100,19 +107,25 @@ class LeScanningReassembler {
   /// applicable.
   /// The cached advertising data is removed as soon as the complete
   /// advertisement is got (including the scan response).
+  /// The cache is small enough that a linear search over the slots is
+  /// cheaper than maintaining an index.
   static constexpr size_t kMaximumCacheSize = 16;
-  std::list<AdvertisingFragment> cache_;
+  std::array<AdvertisingFragment, kMaximumCacheSize> cache_;
+  uint64_t next_sequence_{0};
 
   /// Advertising cache management methods.
-  std::list<AdvertisingFragment>::iterator AppendFragment(
-      const AdvertisingKey& key, const std::vector<uint8_t>& data);
+  /// AppendFragment returns nullptr if the data doesn't fit in the slot,
+  /// in which case the advertisement is dropped.
+  AdvertisingFragment* AppendFragment(const AdvertisingKey& key, const std::vector<uint8_t>& data);
   void RemoveFragment(const AdvertisingKey& key);
   bool ContainsFragment(const AdvertisingKey& key);
-  std::list<AdvertisingFragment>::iterator FindFragment(const AdvertisingKey& key);
+  AdvertisingFragment* FindFragment(const AdvertisingKey& key);
 
   /// Trim the advertising data by removing empty or overflowing
   /// GAP Data entries.
   static std::vector<uint8_t> TrimAdvertisingData(const std::vector<uint8_t>& advertising_data);
+  /// Same as above, in place. Returns the trimmed size.
+  static size_t TrimAdvertisingData(uint8_t* advertising_data, size_t size);
 
   FRIEND_TEST(LeScanningReassemblerTest, trim_advertising_data);
 };
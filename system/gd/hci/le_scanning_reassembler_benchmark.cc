@@ -0,0 +1,113 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/le_scanning_reassembler.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+
+// Event type fields.
+static constexpr uint16_t kConnectable = 0x1;
+static constexpr uint16_t kScannable = 0x2;
+static constexpr uint16_t kScanResponse = 0x8;
+static constexpr uint16_t kLegacy = 0x10;
+static constexpr uint16_t kComplete = 0x0;
+static constexpr uint16_t kContinuation = 0x20;
+static constexpr uint8_t kSidNotPresent = 0xff;
+
+struct AdvertisingReport {
+  uint16_t event_type;
+  Address address;
+  uint8_t sid;
+  std::vector<uint8_t> data;
+};
+
+// Replays a report stream shaped like a busy scan: advertisers in range are
+// interleaved, and each sends one of non scannable legacy advertising,
+// scannable legacy advertising followed by its scan response, or extended
+// advertising fragmented in three reports.
+class BM_LeScanningReassembler : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    for (uint8_t round = 0; round < kNumRounds; round++) {
+      for (uint8_t advertiser = 0; advertiser < kNumAdvertisers; advertiser++) {
+        Address address({advertiser, round, 0x11, 0x22, 0x33, 0x44});
+        switch (advertiser % 3) {
+          case 0:
+            reports_.push_back({kLegacy | kComplete, address, kSidNotPresent, Data(31)});
+            break;
+          case 1:
+            reports_.push_back({kLegacy | kConnectable | kScannable, address, kSidNotPresent, Data(31)});
+            reports_.push_back({kLegacy | kScannable | kScanResponse, address, kSidNotPresent, Data(31)});
+            break;
+          case 2:
+            reports_.push_back({kContinuation, address, advertiser, Data(229)});
+            reports_.push_back({kContinuation, address, advertiser, Data(229)});
+            reports_.push_back({kComplete, address, advertiser, Data(100)});
+            break;
+        }
+      }
+    }
+  }
+
+  void TearDown(State& st) override {
+    reports_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  // Advertising data made of AD structures of at most 8 bytes.
+  static std::vector<uint8_t> Data(size_t size) {
+    std::vector<uint8_t> data;
+    while (data.size() < size) {
+      uint8_t length = std::min<size_t>(7, size - data.size() - 1);
+      data.push_back(length);
+      data.insert(data.end(), length, 0xff);
+    }
+    return data;
+  }
+
+  static constexpr uint8_t kNumRounds = 16;
+  static constexpr uint8_t kNumAdvertisers = 12;
+  std::vector<AdvertisingReport> reports_;
+};
+
+BENCHMARK_F(BM_LeScanningReassembler, replay_report_stream)(State& state) {
+  LeScanningReassembler reassembler;
+  size_t bytes = 0;
+  for (auto& report : reports_) {
+    bytes += report.data.size();
+  }
+  for (auto _ : state) {
+    for (auto& report : reports_) {
+      auto data = reassembler.ProcessAdvertisingReport(
+          report.event_type, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, report.address, report.sid, report.data);
+      ::benchmark::DoNotOptimize(data);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * reports_.size());
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes);
+}
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -38,6 +38,10 @@ static constexpr uint8_t kTruncated = 0x40;
 // Defaults for other fields.
 static constexpr uint8_t kSidNotPresent = 0xff;
 
+// Reassembler limits.
+static constexpr size_t kMaximumAdvertisingDataSize = 1650;
+static constexpr uint8_t kMaximumCacheSize = 16;
+
 // Test addresses.
 static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
 
@@ -324,4 +328,45 @@ TEST_F(LeScanningReassemblerTest, interleaved_advertising) {
       std::vector<uint8_t>({0x2, 0x3, 0x3}));
 }
 
+
+TEST_F(LeScanningReassemblerTest, oversized_advertising_is_dropped) {
+  std::vector<uint8_t> fragment(251, 0x0);
+  for (size_t i = 0; i < kMaximumAdvertisingDataSize / fragment.size(); i++) {
+    ASSERT_FALSE(reassembler_
+                     .ProcessAdvertisingReport(
+                         kContinuation, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, fragment)
+                     .has_value());
+  }
+
+  // The fragment overflowing the reassembly buffer drops the advertisement.
+  ASSERT_FALSE(reassembler_
+                   .ProcessAdvertisingReport(
+                       kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, fragment)
+                   .has_value());
+
+  ASSERT_EQ(
+      reassembler_.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, {0x1, 0x2}),
+      std::vector<uint8_t>({0x1, 0x2}));
+}
+
+TEST_F(LeScanningReassemblerTest, oldest_advertising_is_evicted) {
+  for (uint8_t sid = 0; sid <= kMaximumCacheSize; sid++) {
+    ASSERT_FALSE(reassembler_
+                     .ProcessAdvertisingReport(
+                         kContinuation, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, sid, {0x1, sid})
+                     .has_value());
+  }
+
+  // The first advertiser was evicted to make room for the last one.
+  ASSERT_EQ(
+      reassembler_.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, {0x1, 0x2}),
+      std::vector<uint8_t>({0x1, 0x1, 0x1, 0x2}));
+  ASSERT_EQ(
+      reassembler_.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x0, {0x1, 0x2}),
+      std::vector<uint8_t>({0x1, 0x2}));
+}
+
 }  // namespace bluetooth::hci
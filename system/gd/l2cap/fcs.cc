@@ -16,9 +16,11 @@
 
 #include "l2cap/fcs.h"
 
+#include <array>
+
 namespace {
 // Table for optimizing the CRC calculation, which is a bitwise operation.
-static const uint16_t crctab[256] = {
+constexpr uint16_t crctab[256] = {
     0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241, 0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1,
     0xc481, 0x0440, 0xcc01, 0x0cc0, 0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40, 0x0a00, 0xcac1, 0xcb81, 0x0b40,
     0xc901, 0x09c0, 0x0880, 0xc841, 0xd801, 0x18c0, 0x1980, 0xd941, 0x1b00, 0xdbc1, 0xda81, 0x1a40, 0x1e00, 0xdec1,
@@ -39,6 +41,23 @@ static const uint16_t crctab[256] = {
     0x4c80, 0x8c41, 0x4400, 0x84c1, 0x8581, 0x4540, 0x8701, 0x47c0, 0x4680, 0x8641, 0x8201, 0x42c0, 0x4380, 0x8341,
     0x4100, 0x81c1, 0x8081, 0x4040,
 };
+
+// Tables processing 8 bytes at once (slicing-by-8): entry i of table k is the CRC of byte i followed by k null bytes.
+constexpr std::array<std::array<uint16_t, 256>, 8> MakeSliceTables() {
+  std::array<std::array<uint16_t, 256>, 8> tables{};
+  for (size_t i = 0; i < 256; i++) {
+    tables[0][i] = crctab[i];
+  }
+  for (size_t k = 1; k < tables.size(); k++) {
+    for (size_t i = 0; i < 256; i++) {
+      uint16_t crc = tables[k - 1][i];
+      tables[k][i] = ((crc >> 8) & 0x00ff) ^ crctab[crc & 0x00ff];
+    }
+  }
+  return tables;
+}
+
+constexpr std::array<std::array<uint16_t, 256>, 8> kSliceTables = MakeSliceTables();
 }  // namespace
 
 namespace bluetooth {
@@ -52,6 +71,19 @@ void Fcs::AddByte(uint8_t byte) {
   crc = ((crc >> 8) & 0x00ff) ^ crctab[(crc & 0x00ff) ^ byte];
 }
 
+void Fcs::AddBytes(const uint8_t* data, size_t len) {
+  const auto& t = kSliceTables;
+  uint16_t value = crc;
+  for (; len >= 8; len -= 8, data += 8) {
+    value = t[7][(value & 0x00ff) ^ data[0]] ^ t[6][((value >> 8) & 0x00ff) ^ data[1]] ^ t[5][data[2]] ^
+            t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+  }
+  for (; len > 0; len--) {
+    value = ((value >> 8) & 0x00ff) ^ crctab[(value & 0x00ff) ^ *data++];
+  }
+  crc = value;
+}
+
 uint16_t Fcs::GetChecksum() const {
   return crc;
 }
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "l2cap/fcs.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+
+// range(0) is the frame size, from a small S-frame up to the largest ERTM
+// I-frame of the classic stack.
+class BM_Fcs : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    data_.resize(st.range(0));
+    for (size_t i = 0; i < data_.size(); i++) {
+      data_[i] = static_cast<uint8_t>(i);
+    }
+  }
+
+  void TearDown(State& st) override {
+    data_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  std::vector<uint8_t> data_;
+};
+
+BENCHMARK_DEFINE_F(BM_Fcs, add_byte)(State& state) {
+  for (auto _ : state) {
+    Fcs fcs;
+    fcs.Initialize();
+    for (uint8_t byte : data_) {
+      fcs.AddByte(byte);
+    }
+    benchmark::DoNotOptimize(fcs.GetChecksum());
+  }
+  state.SetBytesProcessed(state.iterations() * data_.size());
+}
+
+BENCHMARK_DEFINE_F(BM_Fcs, add_bytes)(State& state) {
+  for (auto _ : state) {
+    Fcs fcs;
+    fcs.Initialize();
+    fcs.AddBytes(data_.data(), data_.size());
+    benchmark::DoNotOptimize(fcs.GetChecksum());
+  }
+  state.SetBytesProcessed(state.iterations() * data_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_Fcs, add_byte)->Arg(8)->Arg(64)->Arg(672)->Arg(1691);
+BENCHMARK_REGISTER_F(BM_Fcs, add_bytes)->Arg(8)->Arg(64)->Arg(672)->Arg(1691);
+
+}  // namespace l2cap
+}  // namespace bluetooth
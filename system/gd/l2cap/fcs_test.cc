@@ -0,0 +1,59 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/fcs.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace bluetooth {
+namespace l2cap {
+
+TEST(L2capFcsTest, known_value) {
+  // CRC-16 check value of the ASCII string "123456789".
+  std::vector<uint8_t> data = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  Fcs fcs;
+  fcs.Initialize();
+  fcs.AddBytes(data.data(), data.size());
+  ASSERT_EQ(0xbb3d, fcs.GetChecksum());
+}
+
+TEST(L2capFcsTest, add_bytes_matches_add_byte) {
+  std::vector<uint8_t> data;
+  for (size_t i = 0; i < 1024; i++) {
+    data.push_back(static_cast<uint8_t>(i * 37 + (i >> 3)));
+  }
+
+  for (size_t len = 0; len <= data.size(); len += 13) {
+    Fcs bytewise;
+    bytewise.Initialize();
+    for (size_t i = 0; i < len; i++) {
+      bytewise.AddByte(data[i]);
+    }
+
+    // Split in two calls, so that eight byte blocks continue a partial checksum.
+    Fcs sliced;
+    sliced.Initialize();
+    sliced.AddBytes(data.data(), len / 3);
+    sliced.AddBytes(data.data() + len / 3, len - len / 3);
+    ASSERT_EQ(bytewise.GetChecksum(), sliced.GetChecksum()) << "len " << len;
+  }
+}
+
+}  // namespace l2cap
+}  // namespace bluetooth
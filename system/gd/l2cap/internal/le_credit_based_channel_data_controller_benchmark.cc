@@ -0,0 +1,189 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/bidi_queue.h"
+#include "common/bind.h"
+#include "l2cap/internal/ilink.h"
+#include "l2cap/internal/le_credit_based_channel_data_controller.h"
+#include "l2cap/internal/scheduler.h"
+#include "l2cap/l2cap_packets.h"
+#include "os/handler.h"
+#include "os/log.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+constexpr Cid kCid = 0x41;
+constexpr auto kTimeout = std::chrono::seconds(10);
+
+class BenchmarkLink : public ILink {
+ public:
+  void SendDisconnectionRequest(Cid local_cid, Cid remote_cid) override {}
+  hci::AddressWithType GetDevice() const override {
+    return {};
+  }
+};
+
+std::vector<uint8_t> Payload(size_t size) {
+  std::vector<uint8_t> payload(size);
+  for (size_t i = 0; i < size; i++) {
+    payload[i] = static_cast<uint8_t>(i);
+  }
+  return payload;
+}
+
+// The arguments are the size of the SDUs and the MPS of the channel, as a file transfer over an LE CoC uses them
+class BM_LeCreditBasedDataController : public ::benchmark::Fixture {
+ protected:
+  static constexpr size_t kSdusPerIteration = 16;
+
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    thread_ = new os::Thread("benchmark_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+    sdu_ = Payload(st.range(0));
+    mps_ = st.range(1);
+    controller_ = std::make_unique<LeCreditBasedDataController>(
+        &link_, kCid, kCid, channel_queue_.GetDownEnd(), handler_, &scheduler_);
+    controller_->SetMtu(sdu_.size());
+    controller_->SetMps(mps_);
+  }
+
+  void TearDown(State& st) override {
+    controller_.reset();
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  BenchmarkLink link_;
+  Scheduler scheduler_;
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue_{kSdusPerIteration};
+  os::Thread* thread_;
+  os::Handler* handler_;
+  std::unique_ptr<LeCreditBasedDataController> controller_;
+  std::vector<uint8_t> sdu_;
+  size_t mps_;
+};
+
+// Segments an SDU into K-frames, and takes them out as the scheduler does
+BENCHMARK_DEFINE_F(BM_LeCreditBasedDataController, segment)(State& state) {
+  size_t segments = (sdu_.size() + mps_ - 3) / (mps_ - 2);
+  for (auto _ : state) {
+    controller_->OnCredit(segments);
+    controller_->OnSdu(std::make_unique<packet::RawBuilder>(sdu_));
+    for (size_t i = 0; i < segments; i++) {
+      auto pdu = controller_->GetNextPacket();
+      ::benchmark::DoNotOptimize(pdu);
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * sdu_.size());
+}
+BENCHMARK_REGISTER_F(BM_LeCreditBasedDataController, segment)
+    ->Args({512, 251})
+    ->Args({4096, 251})
+    ->Args({4096, 1014});
+
+// Reassembles SDUs from K-frames on the handler, until the SDUs reach the channel queue
+class BM_LeCreditBasedDataControllerReassembly : public BM_LeCreditBasedDataController {
+ protected:
+  void SetUp(State& st) override {
+    BM_LeCreditBasedDataController::SetUp(st);
+    channel_queue_.GetUpEnd()->RegisterDequeue(
+        handler_,
+        common::Bind(&BM_LeCreditBasedDataControllerReassembly::on_dequeue, common::Unretained(this)));
+    // K-frames no larger than the MPS, basic header included
+    size_t offset = 0;
+    while (offset < sdu_.size()) {
+      size_t size = std::min(sdu_.size() - offset, mps_ - (offset == 0 ? 6 : 4));
+      auto payload = std::make_unique<packet::RawBuilder>(
+          std::vector<uint8_t>(sdu_.begin() + offset, sdu_.begin() + offset + size));
+      std::unique_ptr<BasicFrameBuilder> builder;
+      if (offset == 0) {
+        builder = FirstLeInformationFrameBuilder::Create(kCid, sdu_.size(), std::move(payload));
+      } else {
+        builder = BasicFrameBuilder::Create(kCid, std::move(payload));
+      }
+      auto bytes = std::make_shared<std::vector<uint8_t>>();
+      packet::BitInserter it(*bytes);
+      builder->Serialize(it);
+      pdus_.emplace_back(bytes);
+      offset += size;
+    }
+  }
+
+  void TearDown(State& st) override {
+    channel_queue_.GetUpEnd()->UnregisterDequeue();
+    pdus_.clear();
+    BM_LeCreditBasedDataController::TearDown(st);
+  }
+
+  void deliver() {
+    for (size_t i = 0; i < kSdusPerIteration; i++) {
+      for (const auto& pdu : pdus_) {
+        controller_->OnPdu(pdu);
+      }
+    }
+  }
+
+  void on_dequeue() {
+    auto sdu = channel_queue_.GetUpEnd()->TryDequeue();
+    ::benchmark::DoNotOptimize(sdu);
+    if (++received_ == kSdusPerIteration) {
+      received_promise_.set_value();
+    }
+  }
+
+  std::vector<packet::PacketView<kLittleEndian>> pdus_;
+  size_t received_ = 0;
+  std::promise<void> received_promise_;
+};
+
+BENCHMARK_DEFINE_F(BM_LeCreditBasedDataControllerReassembly, reassemble)(State& state) {
+  for (auto _ : state) {
+    received_ = 0;
+    received_promise_ = std::promise<void>();
+    auto received = received_promise_.get_future();
+    handler_->Post(common::BindOnce(&BM_LeCreditBasedDataControllerReassembly::deliver, common::Unretained(this)));
+    ASSERT(received.wait_for(kTimeout) == std::future_status::ready);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kSdusPerIteration * sdu_.size());
+}
+BENCHMARK_REGISTER_F(BM_LeCreditBasedDataControllerReassembly, reassemble)
+    ->Args({512, 251})
+    ->Args({4096, 251})
+    ->Args({4096, 1014})
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
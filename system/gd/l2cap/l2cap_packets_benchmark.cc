@@ -0,0 +1,118 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/hci_packets.h"
+#include "l2cap/l2cap_packets.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+
+namespace {
+constexpr uint16_t kHandle = 0x0040;
+constexpr uint16_t kAttCid = 0x0004;
+constexpr uint16_t kDynamicCid = 0x0040;
+constexpr uint8_t kAttHandleValueNotification = 0x1b;
+constexpr uint16_t kAttHandle = 0x002a;
+
+std::unique_ptr<hci::AclBuilder> ToAcl(std::unique_ptr<packet::BasePacketBuilder> payload) {
+  return hci::AclBuilder::Create(
+      kHandle,
+      hci::PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE,
+      hci::BroadcastFlag::POINT_TO_POINT,
+      std::move(payload));
+}
+}  // namespace
+
+// Builds the packets the way the stack does for each send, and serializes them the way the HCI layer does before
+// handing them to the HAL. range(0) is the size of the payload, from a notification of a few bytes to a full EDR ACL
+// packet.
+class BM_PacketBuilder : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    payload_.resize(st.range(0));
+    for (size_t i = 0; i < payload_.size(); i++) {
+      payload_[i] = static_cast<uint8_t>(i);
+    }
+  }
+
+  void TearDown(State& st) override {
+    payload_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  // Serialize the packet returned by build() on each iteration
+  template <typename Build>
+  void Run(State& state, Build build) {
+    size_t size = 0;
+    for (auto _ : state) {
+      auto builder = build();
+      std::vector<uint8_t> bytes;
+      bytes.reserve(builder->size());
+      packet::BitInserter it(bytes);
+      builder->Serialize(it);
+      size = bytes.size();
+      ::benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size);
+  }
+
+  std::vector<uint8_t> payload_;
+};
+
+BENCHMARK_DEFINE_F(BM_PacketBuilder, acl)(State& state) {
+  Run(state, [this]() { return ToAcl(std::make_unique<packet::RawBuilder>(payload_)); });
+}
+
+BENCHMARK_DEFINE_F(BM_PacketBuilder, l2cap_basic_frame)(State& state) {
+  Run(state, [this]() {
+    return ToAcl(BasicFrameBuilder::Create(kDynamicCid, std::make_unique<packet::RawBuilder>(payload_)));
+  });
+}
+
+// The Fcs is computed by an observer of the inserter, on each byte
+BENCHMARK_DEFINE_F(BM_PacketBuilder, l2cap_basic_frame_with_fcs)(State& state) {
+  Run(state, [this]() {
+    return ToAcl(BasicFrameWithFcsBuilder::Create(kDynamicCid, std::make_unique<packet::RawBuilder>(payload_)));
+  });
+}
+
+BENCHMARK_DEFINE_F(BM_PacketBuilder, att_notification)(State& state) {
+  Run(state, [this]() {
+    auto att = std::make_unique<packet::RawBuilder>();
+    att->AddOctets1(kAttHandleValueNotification);
+    att->AddOctets2(kAttHandle);
+    att->AddOctets(payload_);
+    return ToAcl(BasicFrameBuilder::Create(kAttCid, std::move(att)));
+  });
+}
+
+BENCHMARK_REGISTER_F(BM_PacketBuilder, acl)->Arg(8)->Arg(64)->Arg(1021);
+BENCHMARK_REGISTER_F(BM_PacketBuilder, l2cap_basic_frame)->Arg(8)->Arg(64)->Arg(1017);
+BENCHMARK_REGISTER_F(BM_PacketBuilder, l2cap_basic_frame_with_fcs)->Arg(8)->Arg(64)->Arg(1015);
+BENCHMARK_REGISTER_F(BM_PacketBuilder, att_notification)->Arg(8)->Arg(64)->Arg(244);
+
+}  // namespace l2cap
+}  // namespace bluetooth
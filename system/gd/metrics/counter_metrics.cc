@@ -32,7 +32,7 @@ void CounterMetrics::ListDependencies(ModuleList* list) const {
 }
 
 void CounterMetrics::Start() {
-  alarm_ = std::make_unique<os::RepeatingAlarm>(GetHandler());
+  alarm_ = std::make_unique<os::RepeatingAlarm>(GetHandler(), /* wake_up */ false);
   alarm_->Schedule(
       common::Bind(&CounterMetrics::DrainBufferedCounters,
            bluetooth::common::Unretained(this)),
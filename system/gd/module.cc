@@ -17,7 +17,14 @@
 
 #include "module.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <thread>
+
 #include "common/init_flags.h"
+#include "common/startup_trace.h"
 #include "os/wakelock_manager.h"
 
 using ::bluetooth::os::Handler;
@@ -56,12 +63,19 @@ Module* Module::GetDependency(const ModuleFactory* module) const {
 }
 
 Module* ModuleRegistry::Get(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
   auto instance = started_modules_.find(module);
   ASSERT_LOG(instance != started_modules_.end(), "Request for module not started up, maybe not in Start(ModuleList)?");
   return instance->second;
 }
 
+size_t ModuleRegistry::NextCacheSlot() {
+  static std::atomic<size_t> next_slot{0};
+  return next_slot++;
+}
+
 bool ModuleRegistry::IsStarted(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
   return started_modules_.find(module) != started_modules_.end();
 }
 
@@ -77,9 +91,12 @@ void ModuleRegistry::set_registry_and_handler(Module* instance, Thread* thread)
 }
 
 Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
-  auto started_instance = started_modules_.find(module);
-  if (started_instance != started_modules_.end()) {
-    return started_instance->second;
+  {
+    std::lock_guard<std::mutex> lock(started_modules_mutex_);
+    auto started_instance = started_modules_.find(module);
+    if (started_instance != started_modules_.end()) {
+      return started_instance->second;
+    }
   }
 
   LOG_INFO("Constructing next module");
@@ -92,15 +109,148 @@ Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
 
   LOG_INFO("Finished starting dependencies and calling Start() of %s", instance->ToString().c_str());
 
+  SetStartTime();
   last_instance_ = "starting " + instance->ToString();
+  auto start_time = std::chrono::steady_clock::now();
   instance->Start();
-  start_order_.push_back(module);
-  started_modules_[module] = instance;
+  SetStarted(module, instance, start_time);
   LOG_INFO("Started %s", instance->ToString().c_str());
   return instance;
 }
 
+void ModuleRegistry::StartParallel(ModuleList* modules, Thread* thread, size_t max_concurrency) {
+  ASSERT(max_concurrency > 0);
+
+  struct Node {
+    const ModuleFactory* module;
+    Module* instance;
+    size_t num_pending_dependencies;
+    std::vector<size_t> dependants;
+  };
+  std::vector<Node> nodes;
+  std::map<const ModuleFactory*, size_t> node_indices;
+
+  // Construct every module that is not started yet on this thread, as Start() would, and link each one to the
+  // modules it has to wait for
+  std::function<std::optional<size_t>(const ModuleFactory*)> add_module =
+      [&](const ModuleFactory* module) -> std::optional<size_t> {
+    if (IsStarted(module)) {
+      return std::nullopt;
+    }
+    auto node_index = node_indices.find(module);
+    if (node_index != node_indices.end()) {
+      return node_index->second;
+    }
+
+    LOG_INFO("Constructing next module");
+    Module* instance = module->ctor_();
+    set_registry_and_handler(instance, thread);
+    instance->ListDependencies(&instance->dependencies_);
+    std::vector<size_t> dependencies;
+    for (auto dependency : instance->dependencies_.list_) {
+      auto dependency_index = add_module(dependency);
+      if (dependency_index.has_value()) {
+        dependencies.push_back(*dependency_index);
+      }
+    }
+
+    size_t index = nodes.size();
+    nodes.push_back(Node{module, instance, dependencies.size(), {}});
+    node_indices[module] = index;
+    for (auto dependency_index : dependencies) {
+      nodes[dependency_index].dependants.push_back(index);
+    }
+    return index;
+  };
+  for (auto module : modules->list_) {
+    add_module(module);
+  }
+  if (nodes.empty()) {
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable ready_or_done;
+  std::queue<size_t> ready;
+  size_t num_started = 0;
+  for (size_t index = 0; index < nodes.size(); index++) {
+    if (nodes[index].num_pending_dependencies == 0) {
+      ready.push(index);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(started_modules_mutex_);
+    is_parallel_start_ = true;
+  }
+  SetStartTime();
+
+  auto start_ready_modules = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      ready_or_done.wait(lock, [&] { return !ready.empty() || num_started == nodes.size(); });
+      if (ready.empty()) {
+        return;
+      }
+      const Node& node = nodes[ready.front()];
+      ready.pop();
+      last_instance_ = "starting " + node.instance->ToString();
+      lock.unlock();
+
+      LOG_INFO("Calling Start() of %s", node.instance->ToString().c_str());
+      auto start_time = std::chrono::steady_clock::now();
+      node.instance->Start();
+      SetStarted(node.module, node.instance, start_time);
+      LOG_INFO("Started %s", node.instance->ToString().c_str());
+
+      lock.lock();
+      num_started++;
+      for (auto dependant : node.dependants) {
+        if (--nodes[dependant].num_pending_dependencies == 0) {
+          ready.push(dependant);
+        }
+      }
+      ready_or_done.notify_all();
+    }
+  };
+
+  // This thread is one of the workers
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < std::min(max_concurrency, nodes.size()); i++) {
+    workers.emplace_back(start_ready_modules);
+  }
+  start_ready_modules();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void ModuleRegistry::SetStartTime() {
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
+  if (!start_time_.has_value()) {
+    start_time_ = std::chrono::steady_clock::now();
+  }
+}
+
+void ModuleRegistry::SetStarted(
+    const ModuleFactory* module, Module* instance, std::chrono::steady_clock::time_point start_time) {
+  auto now = std::chrono::steady_clock::now();
+  common::StartupTrace::Record("Start " + instance->ToString(), start_time, now);
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
+  // Modules are stopped in reverse order of this, which is always after their dependencies
+  start_order_.push_back(module);
+  started_modules_[module] = instance;
+  module_start_times_.push_back(ModuleStartTime{
+      instance->ToString(),
+      std::chrono::duration_cast<std::chrono::microseconds>(start_time - *start_time_),
+      std::chrono::duration_cast<std::chrono::microseconds>(now - start_time)});
+}
+
 void ModuleRegistry::StopAll() {
+  for (auto& cached_module : cached_modules_) {
+    cached_module.store(nullptr, std::memory_order_release);
+  }
+
   // Since modules were brought up in dependency order, it is safe to tear down by going in reverse order.
   for (auto it = start_order_.rbegin(); it != start_order_.rend(); it++) {
     auto instance = started_modules_.find(*it);
@@ -119,14 +269,19 @@ void ModuleRegistry::StopAll() {
     ASSERT(instance != started_modules_.end());
     delete instance->second->handler_;
     delete instance->second;
+    std::lock_guard<std::mutex> lock(started_modules_mutex_);
     started_modules_.erase(instance);
   }
 
   ASSERT(started_modules_.empty());
   start_order_.clear();
+  start_time_.reset();
+  module_start_times_.clear();
+  is_parallel_start_ = false;
 }
 
 os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
   auto started_instance = started_modules_.find(module);
   if (started_instance != started_modules_.end()) {
     return started_instance->second->GetHandler();
@@ -154,6 +309,22 @@ void ModuleDumper::DumpState(std::string* output) const {
 
   auto wakelock_offset = WakelockManager::Get().GetDumpsysData(&builder);
 
+  std::vector<flatbuffers::Offset<ModuleStartTimeData>> start_times;
+  for (const auto& start_time : module_registry_.module_start_times_) {
+    start_times.push_back(CreateModuleStartTimeData(
+        builder,
+        builder.CreateString(start_time.name),
+        start_time.start_offset.count(),
+        start_time.duration.count()));
+  }
+  auto start_times_offset = builder.CreateVector(start_times);
+  auto start_data_title = builder.CreateString("----- Module Start Times -----");
+  ModuleStartDataBuilder start_data_builder(builder);
+  start_data_builder.add_title(start_data_title);
+  start_data_builder.add_is_parallel(module_registry_.is_parallel_start_);
+  start_data_builder.add_start_times(start_times_offset);
+  auto start_data_offset = start_data_builder.Finish();
+
   std::queue<DumpsysDataFinisher> queue;
   for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend(); it++) {
     auto instance = module_registry_.started_modules_.find(*it);
@@ -165,6 +336,7 @@ void ModuleDumper::DumpState(std::string* output) const {
   data_builder.add_title(title);
   data_builder.add_init_flags(init_flags_offset);
   data_builder.add_wakelock_manager_data(wakelock_offset);
+  data_builder.add_module_start_data(start_data_offset);
 
   while (!queue.empty()) {
     queue.front()(&data_builder);
@@ -17,10 +17,14 @@
 #pragma once
 
 #include <flatbuffers/flatbuffers.h>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <future>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -146,19 +150,67 @@ class ModuleRegistry {
 
   Module* Start(const ModuleFactory* id, ::bluetooth::os::Thread* thread);
 
+  // Start all the modules on this list and their dependencies in dependency order, like Start(), except that modules
+  // that do not depend on each other are started concurrently, on up to |max_concurrency| threads
+  void StartParallel(ModuleList* modules, ::bluetooth::os::Thread* thread, size_t max_concurrency);
+
   // Stop all running modules in reverse order of start
   void StopAll();
 
  protected:
+  struct ModuleStartTime {
+    std::string name;
+    // From the time the first module started
+    std::chrono::microseconds start_offset;
+    std::chrono::microseconds duration;
+  };
+
   Module* Get(const ModuleFactory* module) const;
 
+  // Same as Get(&T::Factory), except that the module is only looked up in started_modules_ the first time, for the hot
+  // paths. Each module type has a slot in cached_modules_, until StopAll().
+  template <class T>
+  T* Get() const {
+    size_t slot = GetCacheSlot<T>();
+    if (slot >= kMaxCachedModules) {
+      return static_cast<T*>(Get(&T::Factory));
+    }
+    Module* instance = cached_modules_[slot].load(std::memory_order_acquire);
+    if (instance == nullptr) {
+      instance = Get(&T::Factory);
+      cached_modules_[slot].store(instance, std::memory_order_release);
+    }
+    return static_cast<T*>(instance);
+  }
+
+  void SetStartTime();
+  void SetStarted(const ModuleFactory* module, Module* instance, std::chrono::steady_clock::time_point start_time);
+
   void set_registry_and_handler(Module* instance, ::bluetooth::os::Thread* thread) const;
 
   os::Handler* GetModuleHandler(const ModuleFactory* module) const;
 
+  // Modules started in parallel look up their dependencies while other modules are being added
+  mutable std::mutex started_modules_mutex_;
   std::map<const ModuleFactory*, Module*> started_modules_;
   std::vector<const ModuleFactory*> start_order_;
   std::string last_instance_;
+  std::optional<std::chrono::steady_clock::time_point> start_time_;
+  std::vector<ModuleStartTime> module_start_times_;
+  bool is_parallel_start_ = false;
+
+ private:
+  static constexpr size_t kMaxCachedModules = 64;
+
+  static size_t NextCacheSlot();
+
+  template <class T>
+  static size_t GetCacheSlot() {
+    static const size_t slot = NextCacheSlot();
+    return slot;
+  }
+
+  mutable std::array<std::atomic<Module*>, kMaxCachedModules> cached_modules_{};
 };
 
 class ModuleDumper {
@@ -187,7 +239,7 @@ class TestModuleRegistry : public ModuleRegistry {
 
   template <class T>
   T* GetModuleUnderTest() const {
-    return static_cast<T*>(GetModuleUnderTest(&T::Factory));
+    return Get<T>();
   }
 
   os::Handler* GetTestModuleHandler(const ModuleFactory* module) const {
@@ -271,6 +271,45 @@ TEST_F(ModuleTest, two_dependencies) {
   EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
 }
 
+TEST_F(ModuleTest, two_dependencies_parallel) {
+  ModuleList list;
+  list.add<TestModuleTwoDependencies>();
+  registry_->StartParallel(&list, thread_, 4);
+
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleTwoDependencies>());
+
+  registry_->StopAll();
+
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
+}
+
+TEST_F(ModuleTest, parallel_start_after_serial_start) {
+  ModuleList list;
+  list.add<TestModuleOneDependency>();
+  registry_->Start(&list, thread_);
+
+  ModuleList parallel_list;
+  parallel_list.add<TestModuleTwoDependencies>();
+  parallel_list.add<TestModuleOneDependency>();
+  registry_->StartParallel(&parallel_list, thread_, 2);
+
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleTwoDependencies>());
+
+  registry_->StopAll();
+
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
+}
+
 void post_to_module_one_handler() {
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
   test_module_one_dependency_handler->Post(common::BindOnce([] { FAIL(); }));
@@ -301,6 +340,13 @@ TEST_F(ModuleTest, dump_state) {
   auto test_data = data->module_unittest_data();
   EXPECT_STREQ("Initial Test String", test_data->title()->c_str());
 
+  auto start_data = data->module_start_data();
+  EXPECT_FALSE(start_data->is_parallel());
+  ASSERT_EQ(2u, start_data->start_times()->size());
+  EXPECT_STREQ("TestModuleNoDependency", start_data->start_times()->Get(0)->module_name()->c_str());
+  EXPECT_STREQ("TestModuleDumpState", start_data->start_times()->Get(1)->module_name()->c_str());
+  EXPECT_LE(0, start_data->start_times()->Get(1)->start_offset_us());
+
   TestModuleDumpState* test_module =
       static_cast<TestModuleDumpState*>(registry_->Start(&TestModuleDumpState::Factory, nullptr));
   test_module->test_string_ = "A Second Test String";
@@ -314,5 +360,17 @@ TEST_F(ModuleTest, dump_state) {
   registry_->StopAll();
 }
 
+TEST_F(ModuleTest, cached_module_dropped_on_stop_all) {
+  TestModuleRegistry registry;
+  auto first = registry.Start<TestModuleNoDependency>(&registry.GetTestThread());
+  EXPECT_EQ(first, registry.GetModuleUnderTest<TestModuleNoDependency>());
+  EXPECT_EQ(first, registry.GetModuleUnderTest<TestModuleNoDependency>());
+  registry.StopAll();
+
+  auto second = registry.Start<TestModuleNoDependency>(&registry.GetTestThread());
+  EXPECT_EQ(second, registry.GetModuleUnderTest<TestModuleNoDependency>());
+  registry.StopAll();
+}
+
 }  // namespace
 }  // namespace bluetooth
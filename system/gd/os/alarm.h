@@ -33,8 +33,9 @@ namespace os {
 // itself from the thread.
 class Alarm {
  public:
-  // Create and register a single-shot alarm on a given handler
-  explicit Alarm(Handler* handler);
+  // Create and register a single-shot alarm on a given handler. An alarm that does not |wake_up| the system expires when
+  // the system is next awake for another reason, for work that can wait such as metrics or storage saves.
+  explicit Alarm(Handler* handler, bool wake_up = true);
 
   Alarm(const Alarm&) = delete;
   Alarm& operator=(const Alarm&) = delete;
@@ -45,6 +46,10 @@ class Alarm {
   // Schedule the alarm with given delay
   void Schedule(common::OnceClosure task, std::chrono::milliseconds delay);
 
+  // Schedule the alarm with given delay, that may be extended by up to |slack|. The expiration is aligned so that
+  // alarms with overlapping slack windows expire together and wake the system once.
+  void Schedule(common::OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack);
+
   // Cancel the alarm. No-op if it's not armed.
   void Cancel();
 
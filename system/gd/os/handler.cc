@@ -16,19 +16,33 @@
 
 #include "os/handler.h"
 
+#include <time.h>
+
+#include <chrono>
 #include <cstring>
 
 #include "common/bind.h"
 #include "common/callback.h"
+#include "common/inline_task.h"
 #include "os/log.h"
 #include "os/reactor.h"
 #include "os/utils.h"
 
 namespace bluetooth {
 namespace os {
+using common::InlineTask;
 using common::OnceClosure;
 
-Handler::Handler(Thread* thread) : tasks_(new std::queue<OnceClosure>()), thread_(thread) {
+// Time after which handle_next_event() yields to the other reactables of the thread, even if there are tasks left
+static constexpr std::chrono::milliseconds kMaxTaskBatchDuration(10);
+
+static int64_t thread_cpu_time_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+Handler::Handler(Thread* thread) : tasks_(new std::queue<InlineTask>()), thread_(thread) {
   event_ = thread_->GetReactor()->NewEvent();
   reactable_ = thread_->GetReactor()->Register(
       event_->Id(), common::Bind(&Handler::handle_next_event, common::Unretained(this)), common::Closure());
@@ -43,19 +57,27 @@ Handler::~Handler() {
 }
 
 void Handler::Post(OnceClosure closure) {
+  post_task(InlineTask(std::move(closure)));
+}
+
+void Handler::post_task(InlineTask task) {
   {
     std::lock_guard<std::mutex> lock(mutex_);
     if (was_cleared()) {
       LOG_WARN("Posting to a handler which has been cleared");
       return;
     }
-    tasks_->emplace(std::move(closure));
+    tasks_->emplace(std::move(task));
+    if (notified_) {
+      return;
+    }
+    notified_ = true;
   }
   event_->Notify();
 }
 
 void Handler::Clear() {
-  std::queue<OnceClosure>* tmp = nullptr;
+  std::queue<InlineTask>* tmp = nullptr;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     ASSERT_LOG(!was_cleared(), "Handlers must only be cleared once");
@@ -74,8 +96,15 @@ void Handler::WaitUntilStopped(std::chrono::milliseconds timeout) {
   ASSERT(thread_->GetReactor()->WaitForUnregisteredReactable(timeout));
 }
 
+void Handler::SetCpuTimeAccounting(bool enabled) {
+  account_cpu_time_ = enabled;
+}
+
+std::chrono::nanoseconds Handler::GetCpuTime() const {
+  return std::chrono::nanoseconds(cpu_time_ns_.load());
+}
+
 void Handler::handle_next_event() {
-  common::OnceClosure closure;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     bool has_data = event_->Read();
@@ -84,11 +113,34 @@ void Handler::handle_next_event() {
       return;
     }
     ASSERT_LOG(has_data, "Notified for work but no work available");
-
-    closure = std::move(tasks_->front());
-    tasks_->pop();
   }
-  std::move(closure).Run();
+
+  auto deadline = std::chrono::steady_clock::now() + kMaxTaskBatchDuration;
+  do {
+    InlineTask task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (was_cleared()) {
+        return;
+      }
+      if (tasks_->empty()) {
+        notified_ = false;
+        return;
+      }
+      task = std::move(tasks_->front());
+      tasks_->pop();
+    }
+    if (account_cpu_time_.load(std::memory_order_relaxed)) {
+      int64_t start = thread_cpu_time_ns();
+      std::move(task).Run();
+      cpu_time_ns_ += thread_cpu_time_ns() - start;
+    } else {
+      std::move(task).Run();
+    }
+  } while (std::chrono::steady_clock::now() < deadline);
+
+  // Out of time, wake up again for the remaining tasks
+  event_->Notify();
 }
 
 }  // namespace os
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -24,6 +26,7 @@
 #include "common/bind.h"
 #include "common/callback.h"
 #include "common/contextual_callback.h"
+#include "common/inline_task.h"
 #include "os/thread.h"
 #include "os/utils.h"
 
@@ -47,12 +50,24 @@ class Handler : public common::IPostableContext {
   // Enqueue a closure to the queue of this handler
   virtual void Post(common::OnceClosure closure) override;
 
+  // Enqueue a callable to the queue of this handler. Unlike a closure from BindOnce(), a lambda with a few captures is
+  // stored in the queue without a heap allocation.
+  template <typename Functor>
+  void PostTask(Functor&& functor) {
+    post_task(common::InlineTask(std::forward<Functor>(functor)));
+  }
+
   // Remove all pending events from the queue of this handler
   void Clear();
 
   // Die if the current reactable doesn't stop before the timeout.  Must be called after Clear()
   void WaitUntilStopped(std::chrono::milliseconds timeout);
 
+  // Accumulate the thread CPU time spent in the tasks of this handler, for benchmarks. Off by default, the time of
+  // the queue callbacks registered on the thread is not included.
+  void SetCpuTimeAccounting(bool enabled);
+  std::chrono::nanoseconds GetCpuTime() const;
+
   template <typename Functor, typename... Args>
   void Call(Functor&& functor, Args&&... args) {
     Post(common::BindOnce(std::forward<Functor>(functor), std::forward<Args>(args)...));
@@ -93,6 +108,9 @@ class Handler : public common::IPostableContext {
   template <typename T>
   friend class Queue;
 
+  template <typename T>
+  friend class SpscQueue;
+
   friend class Alarm;
 
   friend class RepeatingAlarm;
@@ -101,11 +119,17 @@ class Handler : public common::IPostableContext {
   inline bool was_cleared() const {
     return tasks_ == nullptr;
   };
-  std::queue<common::OnceClosure>* tasks_;
+  std::queue<common::InlineTask>* tasks_;
   Thread* thread_;
   std::unique_ptr<Reactor::Event> event_;
+  // True from the Post() that finds the handler idle until handle_next_event() finds the queue empty. The other
+  // Post() calls in between don't notify the event.
+  bool notified_ = false;
+  std::atomic_bool account_cpu_time_ = false;
+  std::atomic<int64_t> cpu_time_ns_ = 0;
   Reactor::Reactable* reactable_;
   mutable std::mutex mutex_;
+  void post_task(common::InlineTask task);
   void handle_next_event();
 };
 
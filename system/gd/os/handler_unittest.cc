@@ -18,6 +18,7 @@
 
 #include <future>
 #include <thread>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -94,6 +95,47 @@ TEST_F(HandlerTest, post_task_cleared) {
   ASSERT_EQ(val, 1);
 }
 
+TEST_F(HandlerTest, post_tasks_invoked_in_order) {
+  const int num_tasks = 1000;
+  std::vector<int> order;
+  std::promise<void> tasks_ran;
+  auto future = tasks_ran.get_future();
+  // The first task posts more tasks while the handler is running it
+  handler_->Post(common::BindOnce(
+      [](Handler* handler, std::vector<int>* order, std::promise<void> tasks_ran) {
+        order->push_back(0);
+        for (int i = 1; i < num_tasks; i++) {
+          handler->Post(common::BindOnce(
+              [](std::vector<int>* order, int i) { order->push_back(i); }, common::Unretained(order), i));
+        }
+        handler->Post(
+            common::BindOnce([](std::promise<void> tasks_ran) { tasks_ran.set_value(); }, std::move(tasks_ran)));
+      },
+      common::Unretained(handler_),
+      common::Unretained(&order),
+      std::move(tasks_ran)));
+  future.wait();
+  ASSERT_EQ(order.size(), static_cast<size_t>(num_tasks));
+  for (int i = 0; i < num_tasks; i++) {
+    ASSERT_EQ(order[i], i);
+  }
+  handler_->Clear();
+}
+
+TEST_F(HandlerTest, post_lambda_invoked) {
+  auto number = std::make_unique<int>(1);
+  auto to_change = std::make_shared<int>(0);
+  std::promise<void> closure_ran;
+  auto future = closure_ran.get_future();
+  handler_->PostTask([number = std::move(number), to_change, closure_ran = std::move(closure_ran)]() mutable {
+    *to_change = *number;
+    closure_ran.set_value();
+  });
+  future.wait();
+  ASSERT_EQ(*to_change, 1);
+  handler_->Clear();
+}
+
 void check_int(std::unique_ptr<int> number, std::shared_ptr<int> to_change) {
   *to_change = *number;
 }
@@ -116,6 +158,35 @@ TEST_F(HandlerTest, callback_with_promise) {
   handler_->Clear();
 }
 
+TEST_F(HandlerTest, cpu_time_accounting) {
+  auto busy = []() {
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  };
+  auto run = [this](std::function<void()> task) {
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    handler_->PostTask(task);
+    // Posted after the task, to read the time once it was accounted
+    handler_->PostTask([&promise]() { promise.set_value(); });
+    future.wait();
+  };
+
+  run(busy);
+  ASSERT_EQ(handler_->GetCpuTime().count(), 0);
+
+  handler_->SetCpuTimeAccounting(true);
+  run(busy);
+  auto cpu_time = handler_->GetCpuTime();
+  ASSERT_GT(cpu_time, std::chrono::milliseconds(1));
+
+  handler_->SetCpuTimeAccounting(false);
+  run(busy);
+  ASSERT_EQ(handler_->GetCpuTime(), cpu_time);
+  handler_->Clear();
+}
+
 // For Death tests, all the threading needs to be done in the ASSERT_DEATH call
 class HandlerDeathTest : public ::testing::Test {
  protected:
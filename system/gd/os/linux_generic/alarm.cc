@@ -17,6 +17,7 @@
 #include "os/alarm.h"
 
 #include <sys/timerfd.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <cstring>
@@ -37,7 +38,23 @@ namespace os {
 using common::Closure;
 using common::OnceClosure;
 
-Alarm::Alarm(Handler* handler) : handler_(handler), fd_(TIMERFD_CREATE(ALARM_CLOCK, 0)) {
+namespace {
+
+uint64_t now_ms() {
+#ifdef USE_FAKE_TIMERS
+  return fake_timer::fake_timerfd_get_clock();
+#else
+  timespec ts;
+  int result = clock_gettime(CLOCK_BOOTTIME, &ts);
+  ASSERT(result == 0);
+  return ts.tv_sec * 1000ull + ts.tv_nsec / 1000000;
+#endif
+}
+
+}  // namespace
+
+Alarm::Alarm(Handler* handler, bool wake_up)
+    : handler_(handler), fd_(TIMERFD_CREATE(wake_up ? ALARM_CLOCK : CLOCK_BOOTTIME, 0)) {
   ASSERT_LOG(fd_ != -1, "cannot create timerfd: %s", strerror(errno));
 
   token_ = handler_->thread_->GetReactor()->Register(
@@ -62,6 +79,24 @@ void Alarm::Schedule(OnceClosure task, std::chrono::milliseconds delay) {
   task_ = std::move(task);
 }
 
+void Alarm::Schedule(OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack) {
+  if (slack.count() <= 0) {
+    Schedule(std::move(task), delay);
+    return;
+  }
+
+  // Delay the deadline to the next multiple of the largest power of two not above the slack. Deadlines are taken on
+  // the boot clock, so alarms with overlapping slack windows are aligned on the same expiration.
+  uint64_t granularity = 1;
+  while (granularity <= static_cast<uint64_t>(slack.count()) / 2) {
+    granularity <<= 1;
+  }
+  uint64_t now = now_ms();
+  uint64_t deadline = now + delay.count();
+  deadline = (deadline + granularity - 1) & ~(granularity - 1);
+  Schedule(std::move(task), std::chrono::milliseconds(deadline - now));
+}
+
 void Alarm::Cancel() {
   std::lock_guard<std::mutex> lock(mutex_);
   itimerspec disarm_itimerspec{/* disarm timer */};
@@ -50,9 +50,9 @@ class AlarmTest : public ::testing::Test {
     handler_->Post(common::BindOnce(fake_timerfd_advance, ms));
   }
   Alarm* alarm_;
+  Handler* handler_;
 
  private:
-  Handler* handler_;
   Thread* thread_;
 };
 
@@ -92,6 +92,30 @@ TEST_F(AlarmTest, schedule_while_alarm_armed) {
   future.get();
 }
 
+TEST_F(AlarmTest, schedule_with_slack) {
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  // The 8ms slack aligns the 10ms deadline on 16ms.
+  alarm_->Schedule(
+      BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)),
+      std::chrono::milliseconds(10),
+      std::chrono::milliseconds(8));
+  fake_timer_advance(10);
+  ASSERT_EQ(std::future_status::timeout, future.wait_for(std::chrono::milliseconds(10)));
+  fake_timer_advance(6);
+  future.get();
+}
+
+TEST_F(AlarmTest, schedule_without_wake_up) {
+  Alarm alarm(handler_, /* wake_up */ false);
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  alarm.Schedule(
+      BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)), std::chrono::milliseconds(10));
+  fake_timer_advance(10);
+  future.get();
+}
+
 TEST_F(AlarmTest, delete_while_alarm_armed) {
   alarm_->Schedule(BindOnce([]() { ASSERT_TRUE(false) << "Should not happen"; }), std::chrono::milliseconds(1));
   delete alarm_;
@@ -103,6 +103,28 @@ std::unique_ptr<T> Queue<T>::TryDequeue() {
   return data;
 }
 
+template <typename T>
+std::vector<std::unique_ptr<T>> Queue<T>::TryDequeueBatch(size_t max_items) {
+  std::vector<std::unique_ptr<T>> batch;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  size_t count = std::min(max_items, queue_.size());
+  if (count == 0) {
+    return batch;
+  }
+
+  batch.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    dequeue_.reactive_semaphore_.Decrease();
+    batch.push_back(std::move(queue_.front()));
+    queue_.pop();
+  }
+
+  enqueue_.reactive_semaphore_.Increase(count);
+
+  return batch;
+}
+
 template <typename T>
 void Queue<T>::EnqueueCallbackInternal(EnqueueCallback callback) {
   std::unique_ptr<T> data = callback.Run();
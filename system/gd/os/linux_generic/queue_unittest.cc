@@ -810,6 +810,38 @@ TEST_F(QueueTest, unregister_dequeue_and_wait) {
   delete indicator;
 }
 
+// Batch dequeue returns items in order and frees the whole batch for the enqueue end at once
+TEST_F(QueueTest, try_dequeue_batch) {
+  Queue<std::string> queue(kQueueSize);
+  EnqueueBuffer<std::string> enqueue_buffer(&queue);
+  for (int i = 0; i < kDoubleOfQueueSize; i++) {
+    enqueue_buffer.Enqueue(std::make_unique<std::string>(std::to_string(i)), enqueue_handler_);
+  }
+  sync_enqueue_handler();
+  EXPECT_EQ(enqueue_buffer.Size(), (size_t)kQueueSize);
+
+  auto batch = queue.TryDequeueBatch(kHalfOfQueueSize);
+  ASSERT_EQ(batch.size(), (size_t)kHalfOfQueueSize);
+  for (int i = 0; i < kHalfOfQueueSize; i++) {
+    EXPECT_EQ(*batch[i], std::to_string(i));
+  }
+  sync_enqueue_handler();
+  EXPECT_EQ(enqueue_buffer.Size(), (size_t)kHalfOfQueueSize);
+
+  batch = queue.TryDequeueBatch(kDoubleOfQueueSize);
+  ASSERT_EQ(batch.size(), (size_t)kQueueSize);
+  for (int i = 0; i < kQueueSize; i++) {
+    EXPECT_EQ(*batch[i], std::to_string(kHalfOfQueueSize + i));
+  }
+  sync_enqueue_handler();
+  EXPECT_EQ(enqueue_buffer.Size(), 0u);
+
+  batch = queue.TryDequeueBatch(kDoubleOfQueueSize);
+  ASSERT_EQ(batch.size(), (size_t)kHalfOfQueueSize);
+  EXPECT_EQ(*batch.back(), std::to_string(kDoubleOfQueueSize - 1));
+  EXPECT_TRUE(queue.TryDequeueBatch(kQueueSize).empty());
+}
+
 // Create all threads for death tests in the function that dies
 class QueueDeathTest : public ::testing::Test {
  public:
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "os/utils.h"
 
 namespace bluetooth {
@@ -33,8 +35,8 @@ class ReactiveSemaphore {
   ~ReactiveSemaphore();
   // Decrements the value of |fd_|, this will cause a crash if |fd_| unreadable.
   void Decrease();
-  // Increase the value of |fd_|, this will cause a crash if |fd_| unwritable.
-  void Increase();
+  // Increase the value of |fd_| by |count|, this will cause a crash if |fd_| unwritable.
+  void Increase(uint64_t count = 1);
   int GetFd();
 
  private:
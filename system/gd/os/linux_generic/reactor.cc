@@ -26,7 +26,9 @@
 #include <cinttypes>
 #include <cstring>
 
+#include "os/linux_generic/reactor_poller.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 
 namespace {
 
@@ -35,12 +37,76 @@ constexpr int kEpollMaxEvents = 64;
 constexpr uint64_t kStopReactor = 1 << 0;
 constexpr uint64_t kWaitForIdle = 1 << 1;
 
+constexpr char kReactorIoUringEnabledProperty[] = "bluetooth.os.reactor.io_uring.enabled";
+
 }  // namespace
 
 namespace bluetooth {
 namespace os {
 using common::Closure;
 
+namespace {
+
+class EpollPoller : public ReactorPoller {
+ public:
+  EpollPoller() {
+    RUN_NO_INTR(epoll_fd_ = epoll_create1(EPOLL_CLOEXEC));
+    ASSERT_LOG(epoll_fd_ != -1, "could not create epoll fd: %s", strerror(errno));
+  }
+
+  ~EpollPoller() override {
+    int result;
+    RUN_NO_INTR(result = close(epoll_fd_));
+    ASSERT(result != -1);
+  }
+
+  void Add(int fd, uint32_t events, void* data) override {
+    epoll_event event = {
+        .events = events,
+        .data = {.ptr = data},
+    };
+    int register_fd;
+    RUN_NO_INTR(register_fd = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event));
+    ASSERT(register_fd != -1);
+  }
+
+  void Modify(int fd, uint32_t events, void* data) override {
+    epoll_event event = {
+        .events = events,
+        .data = {.ptr = data},
+    };
+    int modify_fd;
+    RUN_NO_INTR(modify_fd = epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event));
+    ASSERT(modify_fd != -1);
+  }
+
+  bool Remove(int fd) override {
+    int result;
+    RUN_NO_INTR(result = epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr));
+    if (result == -1 && errno == ENOENT) {
+      return false;
+    }
+    ASSERT(result != -1);
+    return true;
+  }
+
+  int Wait(epoll_event* events, int max_events, int timeout_ms) override {
+    int count;
+    RUN_NO_INTR(count = epoll_wait(epoll_fd_, events, max_events, timeout_ms));
+    ASSERT(count != -1);
+    return count;
+  }
+
+ private:
+  int epoll_fd_ = -1;
+};
+
+}  // namespace
+
+std::unique_ptr<ReactorPoller> NewEpollPoller() {
+  return std::make_unique<EpollPoller>();
+}
+
 struct Reactor::Event::impl {
   impl() {
     fd_ = eventfd(0, EFD_SEMAPHORE | EFD_NONBLOCK);
@@ -99,29 +165,32 @@ class Reactor::Reactable {
   std::unique_ptr<std::promise<void>> finished_promise_;
 };
 
-Reactor::Reactor() : epoll_fd_(0), control_fd_(0), is_running_(false) {
-  RUN_NO_INTR(epoll_fd_ = epoll_create1(EPOLL_CLOEXEC));
-  ASSERT_LOG(epoll_fd_ != -1, "could not create epoll fd: %s", strerror(errno));
+Reactor::Reactor() : control_fd_(0), is_running_(false) {
+  if (GetSystemPropertyBool(kReactorIoUringEnabledProperty, false)) {
+    poller_ = NewIoUringPoller();
+    if (poller_ == nullptr) {
+      LOG_INFO("io_uring is not available, using epoll");
+    }
+  }
+  if (poller_ == nullptr) {
+    poller_ = NewEpollPoller();
+  }
 
   control_fd_ = eventfd(0, EFD_NONBLOCK);
   ASSERT(control_fd_ != -1);
 
-  epoll_event control_epoll_event = {EPOLLIN, {.ptr = nullptr}};
-  int result;
-  RUN_NO_INTR(result = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, control_fd_, &control_epoll_event));
-  ASSERT(result != -1);
+  // The control fd is the only one registered with nullptr
+  poller_->Add(control_fd_, EPOLLIN, nullptr);
 }
 
 Reactor::~Reactor() {
-  int result;
-  RUN_NO_INTR(result = epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, control_fd_, nullptr));
-  ASSERT(result != -1);
+  bool removed = poller_->Remove(control_fd_);
+  ASSERT(removed);
+  poller_ = nullptr;
 
+  int result;
   RUN_NO_INTR(result = close(control_fd_));
   ASSERT(result != -1);
-
-  RUN_NO_INTR(result = close(epoll_fd_));
-  ASSERT(result != -1);
 }
 
 void Reactor::Run() {
@@ -136,9 +205,7 @@ void Reactor::Run() {
       invalidation_list_.clear();
     }
     epoll_event events[kEpollMaxEvents];
-    int count;
-    RUN_NO_INTR(count = epoll_wait(epoll_fd_, events, kEpollMaxEvents, timeout_ms));
-    ASSERT(count != -1);
+    int count = poller_->Wait(events, kEpollMaxEvents, timeout_ms);
     if (waiting_for_idle && count == 0) {
       timeout_ms = -1;
       waiting_for_idle = false;
@@ -147,25 +214,15 @@ void Reactor::Run() {
       idle_promise_ = nullptr;
     }
 
+    uint64_t control_value = 0;
     for (int i = 0; i < count; ++i) {
       auto event = events[i];
       ASSERT(event.events != 0u);
 
       // If the ptr stored in epoll_event.data is nullptr, it means the control fd triggered
       if (event.data.ptr == nullptr) {
-        uint64_t value;
-        eventfd_read(control_fd_, &value);
-        if ((value & kStopReactor) != 0) {
-          is_running_ = false;
-          return;
-        } else if ((value & kWaitForIdle) != 0) {
-          timeout_ms = 30;
-          waiting_for_idle = true;
-          continue;
-        } else {
-          LOG_ERROR("Unknown control_fd value %" PRIu64 "x", value);
-          continue;
-        }
+        eventfd_read(control_fd_, &control_value);
+        continue;
       }
       auto* reactable = static_cast<Reactor::Reactable*>(event.data.ptr);
       std::unique_lock<std::mutex> lock(mutex_);
@@ -196,6 +253,18 @@ void Reactor::Run() {
         }
       }
     }
+
+    // The control fd is handled after the reactables that were ready along with it, whichever order the poller
+    // returned them in
+    if ((control_value & kStopReactor) != 0) {
+      is_running_ = false;
+      return;
+    } else if ((control_value & kWaitForIdle) != 0) {
+      timeout_ms = 30;
+      waiting_for_idle = true;
+    } else if (control_value != 0) {
+      LOG_ERROR("Unknown control_fd value %" PRIu64 "x", control_value);
+    }
   }
 }
 
@@ -220,13 +289,7 @@ Reactor::Reactable* Reactor::Register(int fd, Closure on_read_ready, Closure on_
     poll_event_type |= EPOLLOUT;
   }
   auto* reactable = new Reactable(fd, on_read_ready, on_write_ready);
-  epoll_event event = {
-      .events = poll_event_type,
-      .data = {.ptr = reactable},
-  };
-  int register_fd;
-  RUN_NO_INTR(register_fd = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event));
-  ASSERT(register_fd != -1);
+  poller_->Add(fd, poll_event_type, reactable);
   return reactable;
 }
 
@@ -238,13 +301,9 @@ void Reactor::Unregister(Reactor::Reactable* reactable) {
   }
   bool delaying_delete_until_callback_finished = false;
   {
-    int result;
     std::lock_guard<std::mutex> reactable_lock(reactable->mutex_);
-    RUN_NO_INTR(result = epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, reactable->fd_, nullptr));
-    if (result == -1 && errno == ENOENT) {
+    if (!poller_->Remove(reactable->fd_)) {
       LOG_INFO("reactable is invalid or unregistered");
-    } else {
-      ASSERT(result != -1);
     }
 
     // If we are unregistering during the callback event from this reactable, we delete it after the callback is
@@ -299,13 +358,7 @@ void Reactor::ModifyRegistration(Reactor::Reactable* reactable, ReactOn react_on
   if (react_on == REACT_ON_WRITE_ONLY || react_on == REACT_ON_READ_WRITE) {
     poll_event_type |= EPOLLOUT;
   }
-  epoll_event event = {
-      .events = poll_event_type,
-      .data = {.ptr = reactable},
-  };
-  int modify_fd;
-  RUN_NO_INTR(modify_fd = epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, reactable->fd_, &event));
-  ASSERT(modify_fd != -1);
+  poller_->Modify(reactable->fd_, poll_event_type, reactable);
 }
 
 }  // namespace os
@@ -0,0 +1,383 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+
+#include "os/linux_generic/reactor_poller.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace os {
+
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+
+namespace {
+
+constexpr unsigned kSubmissionQueueEntries = 64;
+// There is at most one poll and one poll removal in flight per fd
+constexpr unsigned kCompletionQueueEntries = 1024;
+constexpr uint32_t kRequiredFeatures =
+    IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_POLL_32BITS | IORING_FEAT_EXT_ARG;
+// user_data of the poll removals and wake ups, their completions are ignored
+constexpr uint64_t kIgnoredUserData = 0;
+
+// Polls with one shot IORING_OP_POLL_ADD requests, which are only armed by Wait(). A completed poll is armed again by
+// the next Wait(), once the reactor ran the callbacks of the previous one: like with level triggered epoll, an fd is
+// only reported again if it is still ready. The polls are submitted along with the wait, by a single io_uring_enter().
+class IoUringPoller : public ReactorPoller {
+ public:
+  IoUringPoller() = default;
+  IoUringPoller(const IoUringPoller&) = delete;
+  IoUringPoller& operator=(const IoUringPoller&) = delete;
+
+  ~IoUringPoller() override {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (ring_ != MAP_FAILED) {
+      munmap(ring_, ring_size_);
+    }
+    if (ring_fd_ != -1) {
+      close(ring_fd_);
+    }
+  }
+
+  bool Setup() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = kCompletionQueueEntries;
+    ring_fd_ = syscall(__NR_io_uring_setup, kSubmissionQueueEntries, &params);
+    if (ring_fd_ == -1) {
+      LOG_INFO("io_uring_setup failed: %s", strerror(errno));
+      return false;
+    }
+    if ((params.features & kRequiredFeatures) != kRequiredFeatures) {
+      LOG_INFO("io_uring features 0x%x are missing", kRequiredFeatures & ~params.features);
+      return false;
+    }
+
+    ring_size_ = std::max(
+        params.sq_off.array + params.sq_entries * sizeof(unsigned),
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (ring_ == MAP_FAILED) {
+      LOG_INFO("unable to map the io_uring queues: %s", strerror(errno));
+      return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      LOG_INFO("unable to map the io_uring submission entries: %s", strerror(errno));
+      return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    auto* ring = static_cast<uint8_t*>(ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(ring + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    // Submission entry i is always at index i of the ring
+    auto* sq_array = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+    for (unsigned i = 0; i < sq_entries_; i++) {
+      sq_array[i] = i;
+    }
+    sq_local_tail_ = *sq_tail_;
+    cq_head_ = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+    return true;
+  }
+
+  void Add(int fd, uint32_t events, void* data) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT_LOG(polls_.find(fd) == polls_.end(), "fd %d is already polled", fd);
+    Poll& poll = polls_[fd];
+    poll = {next_poll_id_++, events, data, false};
+    poll_fds_[poll.id] = fd;
+    unarmed_fds_.push_back(fd);
+    wake_up_wait_thread();
+  }
+
+  void Modify(int fd, uint32_t events, void* data) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = polls_.find(fd);
+    ASSERT_LOG(it != polls_.end(), "fd %d is not polled", fd);
+    Poll& poll = it->second;
+    poll.events = events;
+    poll.data = data;
+    // Otherwise the next Wait() arms it with the new events
+    if (poll.armed) {
+      queue_poll_remove(poll.id);
+      poll_fds_.erase(poll.id);
+      poll.id = next_poll_id_++;
+      poll.armed = false;
+      poll_fds_[poll.id] = fd;
+      unarmed_fds_.push_back(fd);
+      wake_up_wait_thread();
+    }
+  }
+
+  bool Remove(int fd) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = polls_.find(fd);
+    if (it == polls_.end()) {
+      return false;
+    }
+    // A completion already in the queue is dropped by Wait(), as the poll id is no longer known
+    if (it->second.armed) {
+      queue_poll_remove(it->second.id);
+      submit_off_wait_thread();
+    }
+    poll_fds_.erase(it->second.id);
+    polls_.erase(it);
+    return true;
+  }
+
+  int Wait(epoll_event* events, int max_events, int timeout_ms) override {
+    wait_thread_ = std::this_thread::get_id();
+    for (;;) {
+      unsigned to_submit = arm_unarmed_polls();
+
+      // Submit the polls even if there are completions to return: the fds that are ready already complete now and are
+      // returned along with them, like epoll_wait() would
+      bool timed_out = false;
+      if (__atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) != *cq_head_) {
+        if (to_submit > 0) {
+          enter(to_submit, 0, 0, nullptr, 0);
+        }
+      } else {
+        int result;
+        if (timeout_ms < 0) {
+          result = enter(to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        } else {
+          __kernel_timespec timeout = {
+              .tv_sec = timeout_ms / 1000,
+              .tv_nsec = (timeout_ms % 1000) * 1000000LL,
+          };
+          io_uring_getevents_arg arg;
+          memset(&arg, 0, sizeof(arg));
+          arg.ts = reinterpret_cast<uint64_t>(&timeout);
+          result = enter(to_submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+        }
+        ASSERT_LOG(
+            result != -1 || errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY,
+            "io_uring_enter failed: %s",
+            strerror(errno));
+        timed_out = result == -1 && errno == ETIME;
+
+        // The fds added while waiting may be ready already, arm them now so that they are returned along with the
+        // completions, like epoll_wait() would
+        to_submit = arm_unarmed_polls();
+        if (to_submit > 0) {
+          enter(to_submit, 0, 0, nullptr, 0);
+        }
+      }
+
+      int count = reap(events, max_events);
+      // Only ignored completions were reaped, wait again like epoll_wait() would
+      if (count > 0 || timed_out) {
+        return count;
+      }
+    }
+  }
+
+ private:
+  // Queue a poll request for the fds that are not armed yet, return the number of requests to submit
+  unsigned arm_unarmed_polls() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : unarmed_fds_) {
+      auto it = polls_.find(fd);
+      if (it != polls_.end() && !it->second.armed) {
+        queue_poll_add(fd, &it->second);
+      }
+    }
+    unarmed_fds_.clear();
+    return sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  }
+
+  struct Poll {
+    // user_data of the poll request
+    uint64_t id;
+    uint32_t events;
+    void* data;
+    // Whether the poll request is in flight
+    bool armed;
+  };
+
+  // Return the events of the completed polls, up to |max_events|
+  int reap(epoll_event* events, int max_events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int count = 0;
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail && count < max_events; head++) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      if (cqe.user_data == kIgnoredUserData) {
+        continue;
+      }
+      auto fd_it = poll_fds_.find(cqe.user_data);
+      if (fd_it == poll_fds_.end()) {
+        continue;
+      }
+      int fd = fd_it->second;
+      Poll& poll = polls_[fd];
+      poll.armed = false;
+      if (cqe.res < 0) {
+        // Leave it unarmed, instead of failing again in every Wait()
+        LOG_ERROR("poll of fd %d failed: %s", fd, strerror(-cqe.res));
+        continue;
+      }
+      unarmed_fds_.push_back(fd);
+      events[count].events = static_cast<uint32_t>(cqe.res);
+      events[count].data.ptr = poll.data;
+      count++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return count;
+  }
+
+  int enter(unsigned to_submit, unsigned min_complete, unsigned flags, const void* arg, size_t arg_size) {
+    return syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, arg, arg_size);
+  }
+
+  // The caller must hold mutex_ and call commit_sqe() once the returned entry is filled
+  io_uring_sqe* get_sqe() {
+    if (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == sq_entries_) {
+      enter(sq_entries_, 0, 0, nullptr, 0);
+      ASSERT_LOG(
+          sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) < sq_entries_,
+          "unable to submit the io_uring requests: %s",
+          strerror(errno));
+    }
+    io_uring_sqe* sqe = &sqes_[sq_local_tail_ & sq_mask_];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+  }
+
+  void commit_sqe() {
+    sq_local_tail_++;
+    __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+  }
+
+  void queue_poll_add(int fd, Poll* poll) {
+    io_uring_sqe* sqe = get_sqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+#if __BYTE_ORDER == __BIG_ENDIAN
+    sqe->poll32_events = (poll->events << 16) | (poll->events >> 16);
+#else
+    sqe->poll32_events = poll->events;
+#endif
+    sqe->user_data = poll->id;
+    commit_sqe();
+    poll->armed = true;
+  }
+
+  void queue_poll_remove(uint64_t id) {
+    io_uring_sqe* sqe = get_sqe();
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = id;
+    sqe->user_data = kIgnoredUserData;
+    commit_sqe();
+  }
+
+  // Make the thread in Wait() arm the new polls, with the readiness of the fds when it starts waiting
+  void wake_up_wait_thread() {
+    if (std::this_thread::get_id() == wait_thread_.load()) {
+      return;
+    }
+    io_uring_sqe* sqe = get_sqe();
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = kIgnoredUserData;
+    commit_sqe();
+    submit_off_wait_thread();
+  }
+
+  // The thread in Wait() submits the requests it queued itself, before it waits
+  void submit_off_wait_thread() {
+    if (std::this_thread::get_id() == wait_thread_.load()) {
+      return;
+    }
+    unsigned to_submit = sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (to_submit > 0) {
+      enter(to_submit, 0, 0, nullptr, 0);
+    }
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<int, Poll> polls_;
+  std::unordered_map<uint64_t, int> poll_fds_;
+  // Polls to arm in the next Wait()
+  std::vector<int> unarmed_fds_;
+  uint64_t next_poll_id_ = kIgnoredUserData + 1;
+  std::atomic<std::thread::id> wait_thread_;
+
+  int ring_fd_ = -1;
+  void* ring_ = MAP_FAILED;
+  size_t ring_size_ = 0;
+  io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqes_size_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  // Tail of the submission queue, ahead of *sq_tail_ while an entry is being filled
+  unsigned sq_local_tail_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+};
+
+}  // namespace
+
+std::unique_ptr<ReactorPoller> NewIoUringPoller() {
+  auto poller = std::make_unique<IoUringPoller>();
+  if (!poller->Setup()) {
+    return nullptr;
+  }
+  return poller;
+}
+
+#else
+
+std::unique_ptr<ReactorPoller> NewIoUringPoller() {
+  return nullptr;
+}
+
+#endif
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/epoll.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace bluetooth {
+namespace os {
+
+// The readiness notification mechanism of a Reactor. The events are epoll events. Wait() is only called by the thread
+// running the reactor; Add(), Modify() and Remove() are called from any thread.
+class ReactorPoller {
+ public:
+  virtual ~ReactorPoller() = default;
+
+  // Start polling |fd| for |events|, the events of |fd| are returned with |data|
+  virtual void Add(int fd, uint32_t events, void* data) = 0;
+
+  // Change the polled events of |fd|
+  virtual void Modify(int fd, uint32_t events, void* data) = 0;
+
+  // Stop polling |fd|. Wait() doesn't return its events from here on. Return false if |fd| was not polled.
+  virtual bool Remove(int fd) = 0;
+
+  // Wait for up to |timeout_ms|, or forever when -1, for events. Return the number of events written to |events|.
+  virtual int Wait(epoll_event* events, int max_events, int timeout_ms) = 0;
+};
+
+std::unique_ptr<ReactorPoller> NewEpollPoller();
+
+// Return nullptr when io_uring is not supported by the kernel or not allowed in this process
+std::unique_ptr<ReactorPoller> NewIoUringPoller();
+
+}  // namespace os
+}  // namespace bluetooth
@@ -26,6 +26,7 @@
 #include "common/callback.h"
 #include "gtest/gtest.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace os {
@@ -37,10 +38,12 @@ using common::Bind;
 
 std::promise<int>* g_promise;
 
-class ReactorTest : public ::testing::Test {
+// The parameter is whether the reactor polls with io_uring, when the kernel supports it
+class ReactorTest : public ::testing::TestWithParam<bool> {
  protected:
   void SetUp() override {
     g_promise = new std::promise<int>;
+    SetSystemProperty("bluetooth.os.reactor.io_uring.enabled", GetParam() ? "true" : "false");
     reactor_ = new Reactor;
   }
 
@@ -49,6 +52,7 @@ class ReactorTest : public ::testing::Test {
     g_promise = nullptr;
     delete reactor_;
     reactor_ = nullptr;
+    ClearSystemPropertiesForHost();
   }
 
   Reactor* reactor_;
@@ -165,20 +169,20 @@ class FakeRunningReactable {
   std::promise<void> finished;
 };
 
-TEST_F(ReactorTest, start_and_stop) {
+TEST_P(ReactorTest, start_and_stop) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
   reactor_->Stop();
   reactor_thread.join();
 }
 
-TEST_F(ReactorTest, stop_and_start) {
+TEST_P(ReactorTest, stop_and_start) {
   auto reactor_thread = std::thread(&Reactor::Stop, reactor_);
   auto another_thread = std::thread(&Reactor::Run, reactor_);
   reactor_thread.join();
   another_thread.join();
 }
 
-TEST_F(ReactorTest, stop_multi_times) {
+TEST_P(ReactorTest, stop_multi_times) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
   for (int i = 0; i < 5; i++) {
     reactor_->Stop();
@@ -186,7 +190,7 @@ TEST_F(ReactorTest, stop_multi_times) {
   reactor_thread.join();
 }
 
-TEST_F(ReactorTest, cold_register_only) {
+TEST_P(ReactorTest, cold_register_only) {
   FakeReactable fake_reactable;
   auto* reactable = reactor_->Register(
       fake_reactable.fd_, Bind(&FakeReactable::OnReadReady, common::Unretained(&fake_reactable)), common::Closure());
@@ -194,7 +198,7 @@ TEST_F(ReactorTest, cold_register_only) {
   reactor_->Unregister(reactable);
 }
 
-TEST_F(ReactorTest, cold_register) {
+TEST_P(ReactorTest, cold_register) {
   FakeReactable fake_reactable;
   auto* reactable = reactor_->Register(
       fake_reactable.fd_, Bind(&FakeReactable::OnReadReady, common::Unretained(&fake_reactable)), common::Closure());
@@ -209,7 +213,7 @@ TEST_F(ReactorTest, cold_register) {
   reactor_->Unregister(reactable);
 }
 
-TEST_F(ReactorTest, hot_register_from_different_thread) {
+TEST_P(ReactorTest, hot_register_from_different_thread) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
   auto future = g_promise->get_future();
 
@@ -225,7 +229,7 @@ TEST_F(ReactorTest, hot_register_from_different_thread) {
   reactor_->Unregister(reactable);
 }
 
-TEST_F(ReactorTest, unregister_from_different_thread_while_task_is_executing_) {
+TEST_P(ReactorTest, unregister_from_different_thread_while_task_is_executing_) {
   FakeRunningReactable fake_reactable;
   auto* reactable = reactor_->Register(
       fake_reactable.fd_,
@@ -243,7 +247,7 @@ TEST_F(ReactorTest, unregister_from_different_thread_while_task_is_executing_) {
   reactor_thread.join();
 }
 
-TEST_F(ReactorTest, unregister_from_different_thread_while_task_is_executing_wait_fails) {
+TEST_P(ReactorTest, unregister_from_different_thread_while_task_is_executing_wait_fails) {
   FakeRunningReactable fake_reactable;
   auto* reactable = reactor_->Register(
       fake_reactable.fd_,
@@ -262,7 +266,7 @@ TEST_F(ReactorTest, unregister_from_different_thread_while_task_is_executing_wai
   reactor_thread.join();
 }
 
-TEST_F(ReactorTest, unregister_from_different_thread_while_task_is_executing_wait_succeeds) {
+TEST_P(ReactorTest, unregister_from_different_thread_while_task_is_executing_wait_succeeds) {
   FakeRunningReactable fake_reactable;
   auto* reactable = reactor_->Register(
       fake_reactable.fd_,
@@ -281,7 +285,7 @@ TEST_F(ReactorTest, unregister_from_different_thread_while_task_is_executing_wai
   reactor_thread.join();
 }
 
-TEST_F(ReactorTest, hot_unregister_from_different_thread) {
+TEST_P(ReactorTest, hot_unregister_from_different_thread) {
   FakeReactable fake_reactable;
   auto* reactable = reactor_->Register(
       fake_reactable.fd_, Bind(&FakeReactable::OnReadReady, common::Unretained(&fake_reactable)), common::Closure());
@@ -298,7 +302,7 @@ TEST_F(ReactorTest, hot_unregister_from_different_thread) {
   reactor_thread.join();
 }
 
-TEST_F(ReactorTest, hot_register_from_same_thread) {
+TEST_P(ReactorTest, hot_register_from_same_thread) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
   auto future = g_promise->get_future();
 
@@ -319,7 +323,7 @@ TEST_F(ReactorTest, hot_register_from_same_thread) {
   reactor_->Unregister(reactable);
 }
 
-TEST_F(ReactorTest, hot_unregister_from_same_thread) {
+TEST_P(ReactorTest, hot_unregister_from_same_thread) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
   auto future = g_promise->get_future();
 
@@ -343,7 +347,7 @@ TEST_F(ReactorTest, hot_unregister_from_same_thread) {
   reactor_->Unregister(reactable);
 }
 
-TEST_F(ReactorTest, hot_unregister_from_callback) {
+TEST_P(ReactorTest, hot_unregister_from_callback) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
 
   FakeReactable fake_reactable1(reactor_);
@@ -364,7 +368,7 @@ TEST_F(ReactorTest, hot_unregister_from_callback) {
   reactor_->Unregister(reactable1);
 }
 
-TEST_F(ReactorTest, hot_unregister_during_unregister_from_callback) {
+TEST_P(ReactorTest, hot_unregister_during_unregister_from_callback) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
   auto future = g_promise->get_future();
 
@@ -387,7 +391,7 @@ TEST_F(ReactorTest, hot_unregister_during_unregister_from_callback) {
   reactor_thread.join();
 }
 
-TEST_F(ReactorTest, start_and_stop_multi_times) {
+TEST_P(ReactorTest, start_and_stop_multi_times) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
   reactor_->Stop();
   reactor_thread.join();
@@ -398,7 +402,7 @@ TEST_F(ReactorTest, start_and_stop_multi_times) {
   }
 }
 
-TEST_F(ReactorTest, on_write_ready) {
+TEST_P(ReactorTest, on_write_ready) {
   FakeReactable fake_reactable;
   auto* reactable = reactor_->Register(
       fake_reactable.fd_, common::Closure(), Bind(&FakeReactable::OnWriteReady, common::Unretained(&fake_reactable)));
@@ -414,7 +418,7 @@ TEST_F(ReactorTest, on_write_ready) {
   reactor_->Unregister(reactable);
 }
 
-TEST_F(ReactorTest, modify_registration) {
+TEST_P(ReactorTest, modify_registration) {
   FakeReactable fake_reactable;
   auto* reactable = reactor_->Register(
       fake_reactable.fd_,
@@ -448,6 +452,8 @@ TEST_F(ReactorTest, modify_registration) {
   reactor_->Unregister(reactable);
 }
 
+INSTANTIATE_TEST_SUITE_P(ReactorTest, ReactorTest, ::testing::Bool());
+
 }  // namespace
 }  // namespace os
 }  // namespace bluetooth
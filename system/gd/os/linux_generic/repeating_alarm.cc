@@ -36,7 +36,8 @@ namespace bluetooth {
 namespace os {
 using common::Closure;
 
-RepeatingAlarm::RepeatingAlarm(Handler* handler) : handler_(handler), fd_(TIMERFD_CREATE(ALARM_CLOCK, 0)) {
+RepeatingAlarm::RepeatingAlarm(Handler* handler, bool wake_up)
+    : handler_(handler), fd_(TIMERFD_CREATE(wake_up ? ALARM_CLOCK : CLOCK_BOOTTIME, 0)) {
   ASSERT(fd_ != -1);
 
   token_ = handler_->thread_->GetReactor()->Register(
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+template <typename T>
+SpscQueue<T>::QueueEndpoint::QueueEndpoint()
+    : fd_(eventfd(0, EFD_NONBLOCK)), handler_(nullptr), reactable_(nullptr) {
+  ASSERT(fd_ != -1);
+}
+
+template <typename T>
+SpscQueue<T>::QueueEndpoint::~QueueEndpoint() {
+  int close_status;
+  RUN_NO_INTR(close_status = close(fd_));
+  ASSERT_LOG(close_status != -1, "close failed: %s", strerror(errno));
+}
+
+template <typename T>
+void SpscQueue<T>::QueueEndpoint::Signal() {
+  auto write_result = eventfd_write(fd_, 1);
+  ASSERT_LOG(write_result != -1, "signal failed: %s", strerror(errno));
+}
+
+template <typename T>
+void SpscQueue<T>::QueueEndpoint::Clear() {
+  // Not a semaphore, a single read resets the counter. EAGAIN just means it was already clear.
+  eventfd_t val;
+  eventfd_read(fd_, &val);
+}
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity) : slots_(capacity), capacity_(capacity) {
+  ASSERT(capacity_ > 0);
+  enqueue_.Signal();
+};
+
+template <typename T>
+SpscQueue<T>::~SpscQueue() {
+  ASSERT_LOG(enqueue_.handler_ == nullptr, "Enqueue is not unregistered");
+  ASSERT_LOG(dequeue_.handler_ == nullptr, "Dequeue is not unregistered");
+};
+
+template <typename T>
+void SpscQueue<T>::RegisterEnqueue(Handler* handler, EnqueueCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT(enqueue_.handler_ == nullptr);
+  ASSERT(enqueue_.reactable_ == nullptr);
+  enqueue_.handler_ = handler;
+  enqueue_.reactable_ = enqueue_.handler_->thread_->GetReactor()->Register(
+      enqueue_.fd_,
+      base::Bind(&SpscQueue<T>::EnqueueCallbackInternal, base::Unretained(this), std::move(callback)),
+      base::Closure());
+}
+
+template <typename T>
+void SpscQueue<T>::UnregisterEnqueue() {
+  Reactor* reactor = nullptr;
+  Reactor::Reactable* to_unregister = nullptr;
+  bool wait_for_unregister = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT(enqueue_.reactable_ != nullptr);
+    reactor = enqueue_.handler_->thread_->GetReactor();
+    wait_for_unregister = (!enqueue_.handler_->thread_->IsSameThread());
+    to_unregister = enqueue_.reactable_;
+    enqueue_.reactable_ = nullptr;
+    enqueue_.handler_ = nullptr;
+  }
+  reactor->Unregister(to_unregister);
+  if (wait_for_unregister) {
+    reactor->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+  }
+}
+
+template <typename T>
+void SpscQueue<T>::RegisterDequeue(Handler* handler, DequeueCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT(dequeue_.handler_ == nullptr);
+  ASSERT(dequeue_.reactable_ == nullptr);
+  dequeue_.handler_ = handler;
+  dequeue_.reactable_ = dequeue_.handler_->thread_->GetReactor()->Register(
+      dequeue_.fd_,
+      base::Bind(&SpscQueue<T>::DequeueCallbackInternal, base::Unretained(this), std::move(callback)),
+      base::Closure());
+}
+
+template <typename T>
+void SpscQueue<T>::UnregisterDequeue() {
+  Reactor* reactor = nullptr;
+  Reactor::Reactable* to_unregister = nullptr;
+  bool wait_for_unregister = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT(dequeue_.reactable_ != nullptr);
+    reactor = dequeue_.handler_->thread_->GetReactor();
+    wait_for_unregister = (!dequeue_.handler_->thread_->IsSameThread());
+    to_unregister = dequeue_.reactable_;
+    dequeue_.reactable_ = nullptr;
+    dequeue_.handler_ = nullptr;
+  }
+  reactor->Unregister(to_unregister);
+  if (wait_for_unregister) {
+    reactor->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+  }
+}
+
+template <typename T>
+std::unique_ptr<T> SpscQueue<T>::TryDequeue() {
+  if (size_.load(std::memory_order_acquire) == 0) {
+    return nullptr;
+  }
+
+  std::unique_ptr<T> data = std::move(slots_[head_]);
+  head_ = (head_ + 1) % capacity_;
+  OnItemsDequeued(size_.fetch_sub(1, std::memory_order_acq_rel), 1);
+  return data;
+}
+
+template <typename T>
+std::vector<std::unique_ptr<T>> SpscQueue<T>::TryDequeueBatch(size_t max_items) {
+  std::vector<std::unique_ptr<T>> batch;
+  size_t count = std::min(max_items, size_.load(std::memory_order_acquire));
+  if (count == 0) {
+    return batch;
+  }
+
+  batch.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    batch.push_back(std::move(slots_[head_]));
+    head_ = (head_ + 1) % capacity_;
+  }
+  OnItemsDequeued(size_.fetch_sub(count, std::memory_order_acq_rel), count);
+  return batch;
+}
+
+template <typename T>
+void SpscQueue<T>::OnItemsDequeued(size_t previous_size, size_t count) {
+  if (previous_size == count) {
+    // Drained. The producer may have pushed between the decrement and the clear, re-arm if so.
+    dequeue_.Clear();
+    if (size_.load(std::memory_order_acquire) > 0) {
+      dequeue_.Signal();
+    }
+  }
+  if (previous_size == capacity_) {
+    enqueue_.Signal();
+  }
+}
+
+template <typename T>
+void SpscQueue<T>::EnqueueCallbackInternal(EnqueueCallback callback) {
+  if (size_.load(std::memory_order_acquire) == capacity_) {
+    // Full. The consumer may have popped between the load and the clear, re-arm if so.
+    enqueue_.Clear();
+    if (size_.load(std::memory_order_acquire) < capacity_) {
+      enqueue_.Signal();
+    }
+    return;
+  }
+
+  std::unique_ptr<T> data = callback.Run();
+  ASSERT(data != nullptr);
+  slots_[tail_] = std::move(data);
+  tail_ = (tail_ + 1) % capacity_;
+  if (size_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    dequeue_.Signal();
+  }
+}
+
+template <typename T>
+void SpscQueue<T>::DequeueCallbackInternal(DequeueCallback callback) {
+  if (size_.load(std::memory_order_acquire) == 0) {
+    // Stale signal for an item that was already consumed
+    dequeue_.Clear();
+    if (size_.load(std::memory_order_acquire) > 0) {
+      dequeue_.Signal();
+    }
+    return;
+  }
+  callback.Run();
+}
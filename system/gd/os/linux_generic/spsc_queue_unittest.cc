@@ -0,0 +1,180 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/spsc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "common/bind.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+constexpr int kQueueSize = 10;
+constexpr int kNumItems = 1000;
+
+class SpscQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    enqueue_thread_ = new Thread("enqueue_thread", Thread::Priority::NORMAL);
+    enqueue_handler_ = new Handler(enqueue_thread_);
+    dequeue_thread_ = new Thread("dequeue_thread", Thread::Priority::NORMAL);
+    dequeue_handler_ = new Handler(dequeue_thread_);
+  }
+  void TearDown() override {
+    enqueue_handler_->Clear();
+    delete enqueue_handler_;
+    delete enqueue_thread_;
+    dequeue_handler_->Clear();
+    delete dequeue_handler_;
+    delete dequeue_thread_;
+  }
+
+  void sync_handlers() {
+    ASSERT_TRUE(enqueue_thread_->GetReactor()->WaitForIdle(2s));
+    ASSERT_TRUE(dequeue_thread_->GetReactor()->WaitForIdle(2s));
+  }
+
+  Thread* enqueue_thread_;
+  Handler* enqueue_handler_;
+  Thread* dequeue_thread_;
+  Handler* dequeue_handler_;
+};
+
+class TestDequeueEnd {
+ public:
+  TestDequeueEnd(SpscQueue<std::string>* queue, size_t expected) : queue_(queue), expected_(expected) {}
+
+  void DequeueCallback() {
+    callback_count_++;
+    auto data = queue_->TryDequeue();
+    ASSERT_NE(data, nullptr);
+    received_.push_back(*data);
+    if (received_.size() == expected_) {
+      queue_->UnregisterDequeue();
+      promise_.set_value();
+    }
+  }
+
+  SpscQueue<std::string>* queue_;
+  size_t expected_;
+  std::vector<std::string> received_;
+  std::atomic_int callback_count_ = 0;
+  std::promise<void> promise_;
+};
+
+TEST_F(SpscQueueTest, try_dequeue_empty_queue) {
+  SpscQueue<std::string> queue(kQueueSize);
+  EXPECT_EQ(queue.TryDequeue(), nullptr);
+}
+
+TEST_F(SpscQueueTest, dequeue_callback_not_invoked_on_empty_queue) {
+  SpscQueue<std::string> queue(kQueueSize);
+  TestDequeueEnd dequeue_end(&queue, kQueueSize);
+  queue.RegisterDequeue(
+      dequeue_handler_, common::Bind(&TestDequeueEnd::DequeueCallback, common::Unretained(&dequeue_end)));
+  std::this_thread::sleep_for(20ms);
+  sync_handlers();
+  EXPECT_EQ(dequeue_end.callback_count_, 0);
+  queue.UnregisterDequeue();
+}
+
+TEST_F(SpscQueueTest, enqueue_stops_when_full_and_resumes_after_dequeue) {
+  SpscQueue<std::string> queue(kQueueSize);
+  EnqueueBuffer<std::string> enqueue_buffer(&queue);
+  for (int i = 0; i < 2 * kQueueSize; i++) {
+    enqueue_buffer.Enqueue(std::make_unique<std::string>(std::to_string(i)), enqueue_handler_);
+  }
+  sync_handlers();
+  EXPECT_EQ(enqueue_buffer.Size(), (size_t)kQueueSize);
+
+  // The test thread is the only consumer
+  auto data = queue.TryDequeue();
+  ASSERT_NE(data, nullptr);
+  EXPECT_EQ(*data, "0");
+  sync_handlers();
+  EXPECT_EQ(enqueue_buffer.Size(), (size_t)kQueueSize - 1);
+
+  for (int i = 1; i < 2 * kQueueSize; i++) {
+    data = queue.TryDequeue();
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(*data, std::to_string(i));
+    sync_handlers();
+  }
+  sync_handlers();
+  EXPECT_EQ(enqueue_buffer.Size(), 0u);
+  EXPECT_EQ(queue.TryDequeue(), nullptr);
+}
+
+TEST_F(SpscQueueTest, items_cross_threads_in_order) {
+  SpscQueue<std::string> queue(kQueueSize);
+  TestDequeueEnd dequeue_end(&queue, kNumItems);
+  auto future = dequeue_end.promise_.get_future();
+  queue.RegisterDequeue(
+      dequeue_handler_, common::Bind(&TestDequeueEnd::DequeueCallback, common::Unretained(&dequeue_end)));
+
+  EnqueueBuffer<std::string> enqueue_buffer(&queue);
+  for (int i = 0; i < kNumItems; i++) {
+    enqueue_buffer.Enqueue(std::make_unique<std::string>(std::to_string(i)), enqueue_handler_);
+  }
+  ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+
+  ASSERT_EQ(dequeue_end.received_.size(), (size_t)kNumItems);
+  for (int i = 0; i < kNumItems; i++) {
+    EXPECT_EQ(dequeue_end.received_[i], std::to_string(i));
+  }
+  sync_handlers();
+  EXPECT_EQ(queue.TryDequeue(), nullptr);
+}
+
+TEST_F(SpscQueueTest, try_dequeue_batch) {
+  SpscQueue<std::string> queue(kQueueSize);
+  EnqueueBuffer<std::string> enqueue_buffer(&queue);
+  for (int i = 0; i < 2 * kQueueSize; i++) {
+    enqueue_buffer.Enqueue(std::make_unique<std::string>(std::to_string(i)), enqueue_handler_);
+  }
+  sync_handlers();
+  EXPECT_EQ(enqueue_buffer.Size(), (size_t)kQueueSize);
+
+  // Draining a full queue in one batch resumes the enqueue end
+  auto batch = queue.TryDequeueBatch(2 * kQueueSize);
+  ASSERT_EQ(batch.size(), (size_t)kQueueSize);
+  for (int i = 0; i < kQueueSize; i++) {
+    EXPECT_EQ(*batch[i], std::to_string(i));
+  }
+  sync_handlers();
+  EXPECT_EQ(enqueue_buffer.Size(), 0u);
+
+  batch = queue.TryDequeueBatch(1);
+  ASSERT_EQ(batch.size(), 1u);
+  EXPECT_EQ(*batch[0], std::to_string(kQueueSize));
+  batch = queue.TryDequeueBatch(2 * kQueueSize);
+  ASSERT_EQ(batch.size(), (size_t)kQueueSize - 1);
+  EXPECT_EQ(*batch.back(), std::to_string(2 * kQueueSize - 1));
+  EXPECT_TRUE(queue.TryDequeueBatch(kQueueSize).empty());
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
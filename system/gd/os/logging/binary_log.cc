@@ -0,0 +1,290 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "os/logging/binary_log.h"
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/lock_free_circular_buffer.h"
+#include "common/strings.h"
+#include "hci/address.h"
+#include "os/logging/log_redaction.h"
+#include "types/raw_address.h"
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+
+constexpr size_t kRingCapacity = 256;
+// Rings of the threads which exited are kept for dumpsys, until there are that many rings
+constexpr size_t kMaxRings = 64;
+constexpr char kTimeFormat[] = "%m-%d %H:%M:%S";
+
+// The timestamps of all the rings share the same epoch, so that the entries of the threads can be sorted together
+class SharedTimestamper : public common::Timestamper {
+ public:
+  long long GetTimestamp() const override {
+    static const common::MonotonicTimestamperInMilliseconds timestamper;
+    return timestamper.GetTimestamp();
+  }
+};
+
+struct Ring {
+  Ring() : entries(std::make_unique<SharedTimestamper>()) {}
+
+  pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  char name[16] = {};
+  common::LockFreeTimestampedCircularBuffer<BinaryLogEntry, kRingCapacity> entries;
+};
+
+std::mutex rings_mutex;
+// Never destroyed, the threads may still log during the static destruction
+std::vector<std::shared_ptr<Ring>>& rings = *new std::vector<std::shared_ptr<Ring>>();
+
+std::shared_ptr<Ring> NewRing() {
+  auto ring = std::make_shared<Ring>();
+  pthread_getname_np(pthread_self(), ring->name, sizeof(ring->name));
+
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  if (rings.size() >= kMaxRings) {
+    // Only the registry still holds the rings of the threads which exited
+    auto exited = std::find_if(rings.begin(), rings.end(), [](const auto& it) { return it.use_count() == 1; });
+    if (exited != rings.end()) {
+      rings.erase(exited);
+    }
+  }
+  rings.push_back(ring);
+  return ring;
+}
+
+std::string AddressToString(uint64_t value, bool redact) {
+  uint8_t bytes[6];
+  for (size_t i = 0; i < sizeof(bytes); i++) {
+    bytes[i] = static_cast<uint8_t>(value >> (8 * (sizeof(bytes) - 1 - i)));
+  }
+  char buffer[sizeof("xx:xx:xx:xx:xx:xx")];
+  // The empty and any addresses tell nothing about the device, like in RawAddress::ToRedactedStringForLogging
+  if (redact && value != 0 && value != 0xffffffffffff) {
+    snprintf(buffer, sizeof(buffer), "xx:xx:xx:xx:%02x:%02x", bytes[4], bytes[5]);
+  } else {
+    snprintf(
+        buffer,
+        sizeof(buffer),
+        "%02x:%02x:%02x:%02x:%02x:%02x",
+        bytes[0],
+        bytes[1],
+        bytes[2],
+        bytes[3],
+        bytes[4],
+        bytes[5]);
+  }
+  return buffer;
+}
+
+// The specifications come from the format strings of the call sites, with the length modifier of the stored value
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+template <typename T>
+void AppendFormatted(std::string* out, const std::string& spec, T value) {
+  char buffer[64];
+  int size = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+  if (size < 0) {
+    return;
+  }
+  if (static_cast<size_t>(size) < sizeof(buffer)) {
+    out->append(buffer, size);
+    return;
+  }
+  std::string large(size + 1, '\0');
+  snprintf(large.data(), large.size(), spec.c_str(), value);
+  out->append(large.data(), size);
+}
+#pragma GCC diagnostic pop
+
+// Formats the argument with the flags, width and precision of |spec|. The conversion of the format string is used if
+// it fits the type of the stored value, the default one of that type otherwise.
+void AppendArg(
+    std::string* out, std::string spec, char conversion, BinaryLogArgType type, uint64_t value, bool redact) {
+  switch (type) {
+    case BinaryLogArgType::kBool:
+      if (conversion == 's') {
+        AppendFormatted(out, spec + 's', value ? "true" : "false");
+        return;
+      }
+      [[fallthrough]];
+    case BinaryLogArgType::kSigned:
+    case BinaryLogArgType::kUnsigned: {
+      if (strchr("diuoxXc", conversion) == nullptr) {
+        conversion = type == BinaryLogArgType::kSigned ? 'd' : 'u';
+      }
+      if (conversion == 'c') {
+        AppendFormatted(out, spec + 'c', static_cast<int>(value));
+      } else if (conversion == 'd' || conversion == 'i') {
+        AppendFormatted(out, spec + "ll" + conversion, static_cast<long long>(value));
+      } else {
+        AppendFormatted(out, spec + "ll" + conversion, static_cast<unsigned long long>(value));
+      }
+      return;
+    }
+    case BinaryLogArgType::kDouble: {
+      if (strchr("fFeEgGaA", conversion) == nullptr) {
+        conversion = 'f';
+      }
+      double as_double;
+      std::memcpy(&as_double, &value, sizeof(as_double));
+      AppendFormatted(out, spec + conversion, as_double);
+      return;
+    }
+    case BinaryLogArgType::kPointer:
+      AppendFormatted(out, spec + 'p', reinterpret_cast<void*>(static_cast<uintptr_t>(value)));
+      return;
+    case BinaryLogArgType::kAddress:
+      AppendFormatted(out, spec + 's', AddressToString(value, redact).c_str());
+      return;
+  }
+}
+
+}  // namespace
+
+uint64_t BinaryLogArg<hci::Address>::Encode(const hci::Address& address) {
+  // The most significant byte is address[5]
+  uint64_t value = 0;
+  for (auto it = address.address.rbegin(); it != address.address.rend(); it++) {
+    value = (value << 8) | *it;
+  }
+  return value;
+}
+
+uint64_t BinaryLogArg<RawAddress>::Encode(const RawAddress& address) {
+  // The most significant byte is address[0]
+  uint64_t value = 0;
+  for (uint8_t byte : address.address) {
+    value = (value << 8) | byte;
+  }
+  return value;
+}
+
+void BinaryLogPush(const BinaryLogEntry& entry) {
+  thread_local std::shared_ptr<Ring> ring = NewRing();
+  ring->entries.Push(entry);
+}
+
+std::string BinaryLogDecode(const BinaryLogEntry& entry, bool redact) {
+  std::string out;
+  const char* p = entry.format->format;
+  size_t arg = 0;
+  while (*p != '\0') {
+    if (*p != '%') {
+      out.push_back(*p++);
+      continue;
+    }
+    if (p[1] == '%') {
+      out.push_back('%');
+      p += 2;
+      continue;
+    }
+
+    // Flags, width and precision are kept, the length modifier is replaced by the one of the stored value
+    const char* start = p++;
+    std::string spec = "%";
+    while (*p != '\0' && strchr("-+ #0", *p) != nullptr) {
+      spec.push_back(*p++);
+    }
+    while (isdigit(static_cast<unsigned char>(*p))) {
+      spec.push_back(*p++);
+    }
+    if (*p == '.') {
+      spec.push_back(*p++);
+      while (isdigit(static_cast<unsigned char>(*p))) {
+        spec.push_back(*p++);
+      }
+    }
+    while (*p != '\0' && strchr("hlLqjzt", *p) != nullptr) {
+      p++;
+    }
+
+    // Malformed specifications, and the ones without an argument, are printed as is
+    const char conversion = *p;
+    if (!isalpha(static_cast<unsigned char>(conversion)) || arg >= entry.num_args) {
+      out.append(start, p - start);
+      continue;
+    }
+    p++;
+    AppendArg(&out, spec, conversion, entry.types[arg], entry.args[arg], redact);
+    arg++;
+  }
+  return out;
+}
+
+void BinaryLogDump(int fd) {
+  struct DecodedEntry {
+    long long timestamp;
+    const Ring* ring;
+    BinaryLogEntry entry;
+  };
+
+  std::vector<std::shared_ptr<Ring>> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    snapshot = rings;
+  }
+
+  std::vector<DecodedEntry> entries;
+  for (const auto& ring : snapshot) {
+    for (const auto& it : ring->entries.Pull()) {
+      entries.push_back({it.timestamp, ring.get(), it.entry});
+    }
+  }
+  // The entries of each ring are already in order
+  std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return a.timestamp < b.timestamp;
+  });
+
+  const bool redact = should_log_be_redacted();
+  dprintf(fd, "\nBluetooth binary log (%zu threads):\n", snapshot.size());
+  for (const auto& it : entries) {
+    const BinaryLogFormat* format = it.entry.format;
+    dprintf(
+        fd,
+        "  %s %7d %-15s %s %s:%d %s: %s\n",
+        common::StringFormatTimeWithMilliseconds(
+            kTimeFormat, std::chrono::system_clock::time_point(std::chrono::milliseconds(it.timestamp)))
+            .c_str(),
+        it.ring->tid,
+        it.ring->name,
+        format->tag,
+        format->file,
+        format->line,
+        format->function,
+        BinaryLogDecode(it.entry, redact).c_str());
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,176 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#ifndef LOG_TAG
+#define LOG_TAG "bluetooth"
+#endif
+
+class RawAddress;
+
+namespace bluetooth {
+namespace hci {
+class Address;
+}  // namespace hci
+
+namespace os {
+
+// Binary event log, for the hot paths that cannot afford to format a string for each event
+//
+//   BINARY_LOG("acl packet handle:0x%04x size:%zu", handle, size);
+//   BINARY_LOG("connected to %s", address);
+//
+// The arguments are stored raw, with the call site they come from, in a ring owned by the logging thread: nothing is
+// formatted nor allocated until dumpsys, which decodes the entries of all the threads with their format strings. The
+// addresses are redacted when decoded, like ADDRESS_TO_LOGGABLE_STR does.
+//
+// The arguments may be integers, enums, floating point numbers, pointers, hci::Address and RawAddress. Strings are
+// not captured, as nothing guarantees that they outlive the entry: the format string itself must be a literal.
+
+enum class BinaryLogArgType : uint8_t {
+  kSigned,
+  kUnsigned,
+  kBool,
+  kDouble,
+  kPointer,
+  kAddress,
+};
+
+// One call site of BINARY_LOG, whose address identifies the format of its entries
+struct BinaryLogFormat {
+  const char* tag;
+  const char* file;
+  int line;
+  const char* function;
+  const char* format;
+};
+
+struct BinaryLogEntry {
+  static constexpr size_t kMaxArgs = 6;
+
+  const BinaryLogFormat* format;
+  uint8_t num_args;
+  BinaryLogArgType types[kMaxArgs];
+  uint64_t args[kMaxArgs];
+};
+
+// How each type of argument is stored, the types without a specialization are not supported
+template <typename T, typename Enable = void>
+struct BinaryLogArg;
+
+template <>
+struct BinaryLogArg<bool> {
+  static constexpr BinaryLogArgType kType = BinaryLogArgType::kBool;
+  static uint64_t Encode(bool value) {
+    return value;
+  }
+};
+
+template <typename T>
+struct BinaryLogArg<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+  static constexpr BinaryLogArgType kType =
+      std::is_signed_v<T> ? BinaryLogArgType::kSigned : BinaryLogArgType::kUnsigned;
+  static uint64_t Encode(T value) {
+    // Signed values are sign extended, and decoded as int64_t
+    return static_cast<uint64_t>(static_cast<std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>(value));
+  }
+};
+
+template <typename T>
+struct BinaryLogArg<T, std::enable_if_t<std::is_enum_v<T>>> {
+  static constexpr BinaryLogArgType kType = BinaryLogArg<std::underlying_type_t<T>>::kType;
+  static uint64_t Encode(T value) {
+    return BinaryLogArg<std::underlying_type_t<T>>::Encode(static_cast<std::underlying_type_t<T>>(value));
+  }
+};
+
+template <typename T>
+struct BinaryLogArg<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+  static constexpr BinaryLogArgType kType = BinaryLogArgType::kDouble;
+  static uint64_t Encode(T value) {
+    double as_double = value;
+    uint64_t bits;
+    std::memcpy(&bits, &as_double, sizeof(bits));
+    return bits;
+  }
+};
+
+template <typename T>
+struct BinaryLogArg<T*> {
+  static_assert(
+      !std::is_same_v<std::remove_cv_t<T>, char>, "strings are not captured, they may not outlive the entry");
+  static constexpr BinaryLogArgType kType = BinaryLogArgType::kPointer;
+  static uint64_t Encode(const T* value) {
+    return reinterpret_cast<uintptr_t>(value);
+  }
+};
+
+// The addresses are stored as 48 bit integers, most significant byte first as they are printed
+template <>
+struct BinaryLogArg<hci::Address> {
+  static constexpr BinaryLogArgType kType = BinaryLogArgType::kAddress;
+  static uint64_t Encode(const hci::Address& address);
+};
+
+template <>
+struct BinaryLogArg<RawAddress> {
+  static constexpr BinaryLogArgType kType = BinaryLogArgType::kAddress;
+  static uint64_t Encode(const RawAddress& address);
+};
+
+// Stores the entry in the ring of the calling thread
+void BinaryLogPush(const BinaryLogEntry& entry);
+
+template <typename... Args>
+BinaryLogEntry BinaryLogMakeEntry(const BinaryLogFormat* format, const Args&... args) {
+  static_assert(sizeof...(Args) <= BinaryLogEntry::kMaxArgs, "too many arguments for a binary log entry");
+  BinaryLogEntry entry{format, static_cast<uint8_t>(sizeof...(Args)), {}, {}};
+  [[maybe_unused]] size_t i = 0;
+  ((entry.types[i] = BinaryLogArg<std::decay_t<Args>>::kType,
+    entry.args[i] = BinaryLogArg<std::decay_t<Args>>::Encode(args),
+    i++),
+   ...);
+  return entry;
+}
+
+template <typename... Args>
+void BinaryLogRecord(const BinaryLogFormat* format, const Args&... args) {
+  BinaryLogPush(BinaryLogMakeEntry(format, args...));
+}
+
+// Formats the entry with the format string of its call site, the addresses are masked if |redact|
+std::string BinaryLogDecode(const BinaryLogEntry& entry, bool redact);
+
+// Decodes the entries of all the threads, oldest first, redacted if the logs are
+void BinaryLogDump(int fd);
+
+}  // namespace os
+}  // namespace bluetooth
+
+#define BINARY_LOG(fmt, args...)                                                                                   \
+  do {                                                                                                             \
+    static constexpr ::bluetooth::os::BinaryLogFormat _binary_log_format{LOG_TAG, __FILE__, __LINE__, __func__, fmt}; \
+    ::bluetooth::os::BinaryLogRecord(&_binary_log_format, ##args);                                                 \
+  } while (false)
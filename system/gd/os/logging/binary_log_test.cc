@@ -0,0 +1,102 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/logging/binary_log.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "hci/address.h"
+#include "types/raw_address.h"
+
+namespace testing {
+
+using bluetooth::os::BinaryLogDecode;
+using bluetooth::os::BinaryLogDump;
+using bluetooth::os::BinaryLogFormat;
+using bluetooth::os::BinaryLogMakeEntry;
+
+namespace {
+enum class TestEnum : uint8_t { kValue = 7 };
+
+template <typename... Args>
+std::string Decode(const char* format_string, bool redact, const Args&... args) {
+  static BinaryLogFormat format{"test", "file.cc", 1, "Decode", nullptr};
+  format.format = format_string;
+  return BinaryLogDecode(BinaryLogMakeEntry(&format, args...), redact);
+}
+}  // namespace
+
+TEST(BinaryLogTest, decode_integers) {
+  ASSERT_EQ(Decode("handle:0x%04x size:%zu", false, uint16_t{0x40}, size_t{27}), "handle:0x0040 size:27");
+  ASSERT_EQ(Decode("%d %u %lld", false, -1, 4000000000u, int64_t{-5}), "-1 4000000000 -5");
+  ASSERT_EQ(Decode("reason:%hhu", false, TestEnum::kValue), "reason:7");
+  ASSERT_EQ(Decode("%c", false, 'a'), "a");
+}
+
+TEST(BinaryLogTest, decode_other_types) {
+  ASSERT_EQ(Decode("%.2f", false, 1.5f), "1.50");
+  ASSERT_EQ(Decode("%s %d", false, true, false), "true 0");
+  ASSERT_EQ(Decode("%p", false, static_cast<void*>(nullptr)), Decode("%p", false, static_cast<int*>(nullptr)));
+}
+
+TEST(BinaryLogTest, decode_mismatched_format) {
+  // The conversions which do not fit the stored value are replaced by the one of its type
+  ASSERT_EQ(Decode("%s", false, 42), "42");
+  ASSERT_EQ(Decode("%d", false, 0.25), "0.250000");
+  ASSERT_EQ(Decode("100%% %d %d", false, 1), "100% 1 %d");
+  ASSERT_EQ(Decode("%*d", false, 1), "%*d");
+  ASSERT_EQ(Decode("trailing %", false, 1), "trailing %");
+}
+
+TEST(BinaryLogTest, decode_addresses) {
+  const uint8_t bytes[] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+  bluetooth::hci::Address address(bytes);
+  RawAddress raw_address(bytes);
+  ASSERT_EQ(Decode("%s", false, address), address.ToString());
+  ASSERT_EQ(Decode("%s", false, raw_address), raw_address.ToString());
+  ASSERT_EQ(Decode("%s", true, address), address.ToRedactedStringForLogging());
+  ASSERT_EQ(Decode("%s", true, raw_address), raw_address.ToRedactedStringForLogging());
+  ASSERT_EQ(Decode("%s", true, RawAddress::kEmpty), "00:00:00:00:00:00");
+}
+
+TEST(BinaryLogTest, dump_entries_of_all_threads) {
+  BINARY_LOG("main thread entry %d", 1);
+  std::thread([]() { BINARY_LOG("other thread entry %d", 2); }).join();
+
+  FILE* file = tmpfile();
+  ASSERT_NE(file, nullptr);
+  BinaryLogDump(fileno(file));
+  std::string output;
+  char buffer[256];
+  rewind(file);
+  while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+    output += buffer;
+  }
+  fclose(file);
+
+  auto main_entry = output.find("main thread entry 1");
+  auto other_entry = output.find("other thread entry 2");
+  ASSERT_NE(main_entry, std::string::npos);
+  ASSERT_NE(other_entry, std::string::npos);
+  ASSERT_LT(main_entry, other_entry);
+}
+
+}  // namespace testing
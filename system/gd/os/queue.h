@@ -18,9 +18,11 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <functional>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -50,6 +52,19 @@ class IQueueDequeue {
   virtual void RegisterDequeue(Handler* handler, DequeueCallback callback) = 0;
   virtual void UnregisterDequeue() = 0;
   virtual std::unique_ptr<T> TryDequeue() = 0;
+  // Dequeue up to |max_items| items at once, in queue order. Implementations override this to take their
+  // synchronization only once for the whole batch.
+  virtual std::vector<std::unique_ptr<T>> TryDequeueBatch(size_t max_items) {
+    std::vector<std::unique_ptr<T>> batch;
+    while (batch.size() < max_items) {
+      std::unique_ptr<T> item = TryDequeue();
+      if (item == nullptr) {
+        break;
+      }
+      batch.push_back(std::move(item));
+    }
+    return batch;
+  }
 };
 
 template <typename T>
@@ -78,6 +93,10 @@ class Queue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
   // Try to dequeue an item from this queue. Return nullptr when there is nothing in the queue.
   std::unique_ptr<T> TryDequeue() override;
 
+  // Dequeue up to |max_items| items while holding the queue lock once. Returns an empty vector when there is
+  // nothing in the queue.
+  std::vector<std::unique_ptr<T>> TryDequeueBatch(size_t max_items) override;
+
  private:
   void EnqueueCallbackInternal(EnqueueCallback callback);
   // An internal queue that holds at most |capacity| pieces of data
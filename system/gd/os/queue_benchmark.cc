@@ -19,6 +19,7 @@
 #include "benchmark/benchmark.h"
 #include "os/handler.h"
 #include "os/queue.h"
+#include "os/spsc_queue.h"
 #include "os/thread.h"
 
 using ::benchmark::State;
@@ -37,8 +38,10 @@ class BM_QueuePerformance : public ::benchmark::Fixture {
   }
 
   void TearDown(State& st) override {
+    enqueue_handler_->Clear();
     delete enqueue_handler_;
     delete enqueue_thread_;
+    dequeue_handler_->Clear();
     delete dequeue_handler_;
     delete dequeue_thread_;
     enqueue_handler_ = nullptr;
@@ -54,13 +57,15 @@ class BM_QueuePerformance : public ::benchmark::Fixture {
   Handler* dequeue_handler_;
 };
 
+template <typename QueueType>
 class TestEnqueueEnd {
  public:
-  explicit TestEnqueueEnd(int64_t count, Queue<std::string>* queue, Handler* handler, std::promise<void>* promise)
+  explicit TestEnqueueEnd(int64_t count, QueueType* queue, Handler* handler, std::promise<void>* promise)
       : count_(count), handler_(handler), queue_(queue), promise_(promise) {}
 
   void RegisterEnqueue() {
-    handler_->Post(common::BindOnce(&TestEnqueueEnd::handle_register_enqueue, common::Unretained(this)));
+    handler_->Post(
+        common::BindOnce(&TestEnqueueEnd<QueueType>::handle_register_enqueue, common::Unretained(this)));
   }
 
   void push(std::string data) {
@@ -95,22 +100,25 @@ class TestEnqueueEnd {
 
  private:
   Handler* handler_;
-  Queue<std::string>* queue_;
+  QueueType* queue_;
   std::promise<void>* promise_;
   std::mutex mutex_;
 
   void handle_register_enqueue() {
-    queue_->RegisterEnqueue(handler_, common::Bind(&TestEnqueueEnd::EnqueueCallbackForTest, common::Unretained(this)));
+    queue_->RegisterEnqueue(
+        handler_, common::Bind(&TestEnqueueEnd<QueueType>::EnqueueCallbackForTest, common::Unretained(this)));
   }
 };
 
+template <typename QueueType>
 class TestDequeueEnd {
  public:
-  explicit TestDequeueEnd(int64_t count, Queue<std::string>* queue, Handler* handler, std::promise<void>* promise)
+  explicit TestDequeueEnd(int64_t count, QueueType* queue, Handler* handler, std::promise<void>* promise)
       : count_(count), handler_(handler), queue_(queue), promise_(promise) {}
 
   void RegisterDequeue() {
-    handler_->Post(common::BindOnce(&TestDequeueEnd::handle_register_dequeue, common::Unretained(this)));
+    handler_->Post(
+        common::BindOnce(&TestDequeueEnd<QueueType>::handle_register_dequeue, common::Unretained(this)));
   }
 
   void DequeueCallbackForTest() {
@@ -129,33 +137,38 @@ class TestDequeueEnd {
 
  private:
   Handler* handler_;
-  Queue<std::string>* queue_;
+  QueueType* queue_;
   std::promise<void>* promise_;
 
   void handle_register_dequeue() {
-    queue_->RegisterDequeue(handler_, common::Bind(&TestDequeueEnd::DequeueCallbackForTest, common::Unretained(this)));
+    queue_->RegisterDequeue(
+        handler_, common::Bind(&TestDequeueEnd<QueueType>::DequeueCallbackForTest, common::Unretained(this)));
   }
 };
 
+// Moves |num_packets| strings of |packet_size| bytes from the enqueue handler to the dequeue handler
+template <typename QueueType>
+void send_packets(Handler* enqueue_handler, Handler* dequeue_handler, int64_t num_packets, int64_t packet_size) {
+  QueueType queue(num_packets);
+
+  // register dequeue
+  std::promise<void> dequeue_promise;
+  auto dequeue_future = dequeue_promise.get_future();
+  TestDequeueEnd<QueueType> test_dequeue_end(num_packets, &queue, dequeue_handler, &dequeue_promise);
+  test_dequeue_end.RegisterDequeue();
+
+  // Push data to enqueue end buffer and register enqueue
+  std::promise<void> enqueue_promise;
+  TestEnqueueEnd<QueueType> test_enqueue_end(num_packets, &queue, enqueue_handler, &enqueue_promise);
+  for (int i = 0; i < num_packets; i++) {
+    test_enqueue_end.push(std::string(packet_size, 'x'));
+  }
+  dequeue_future.wait();
+}
+
 BENCHMARK_DEFINE_F(BM_QueuePerformance, send_packet_vary_by_packet_num)(State& state) {
   for (auto _ : state) {
-    int64_t num_data_to_send_ = state.range(0);
-    Queue<std::string> queue(num_data_to_send_);
-
-    // register dequeue
-    std::promise<void> dequeue_promise;
-    auto dequeue_future = dequeue_promise.get_future();
-    TestDequeueEnd test_dequeue_end(num_data_to_send_, &queue, enqueue_handler_, &dequeue_promise);
-    test_dequeue_end.RegisterDequeue();
-
-    // Push data to enqueue end buffer and register enqueue
-    std::promise<void> enqueue_promise;
-    TestEnqueueEnd test_enqueue_end(num_data_to_send_, &queue, enqueue_handler_, &enqueue_promise);
-    for (int i = 0; i < num_data_to_send_; i++) {
-      std::string data = std::to_string(1);
-      test_enqueue_end.push(std::move(data));
-    }
-    dequeue_future.wait();
+    send_packets<Queue<std::string>>(enqueue_handler_, enqueue_handler_, state.range(0), 1);
   }
 
   state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
@@ -172,24 +185,7 @@ BENCHMARK_REGISTER_F(BM_QueuePerformance, send_packet_vary_by_packet_num)
 
 BENCHMARK_DEFINE_F(BM_QueuePerformance, send_10000_packet_vary_by_packet_size)(State& state) {
   for (auto _ : state) {
-    int64_t num_data_to_send_ = 10000;
-    int64_t packet_size = state.range(0);
-    Queue<std::string> queue(num_data_to_send_);
-
-    // register dequeue
-    std::promise<void> dequeue_promise;
-    auto dequeue_future = dequeue_promise.get_future();
-    TestDequeueEnd test_dequeue_end(num_data_to_send_, &queue, enqueue_handler_, &dequeue_promise);
-    test_dequeue_end.RegisterDequeue();
-
-    // Push data to enqueue end buffer and register enqueue
-    std::promise<void> enqueue_promise;
-    TestEnqueueEnd test_enqueue_end(num_data_to_send_, &queue, enqueue_handler_, &enqueue_promise);
-    for (int i = 0; i < num_data_to_send_; i++) {
-      std::string data = std::string(packet_size, 'x');
-      test_enqueue_end.push(std::move(data));
-    }
-    dequeue_future.wait();
+    send_packets<Queue<std::string>>(enqueue_handler_, enqueue_handler_, 10000, state.range(0));
   }
 
   state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0) * 10000);
@@ -202,5 +198,67 @@ BENCHMARK_REGISTER_F(BM_QueuePerformance, send_10000_packet_vary_by_packet_size)
     ->Iterations(100)
     ->UseRealTime();
 
+BENCHMARK_DEFINE_F(BM_QueuePerformance, cross_thread_send_packet_vary_by_packet_num)(State& state) {
+  for (auto _ : state) {
+    send_packets<Queue<std::string>>(enqueue_handler_, dequeue_handler_, state.range(0), 1);
+  }
+
+  state.SetItemsProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, cross_thread_send_packet_vary_by_packet_num)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Iterations(100)
+    ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_QueuePerformance, spsc_send_packet_vary_by_packet_num)(State& state) {
+  for (auto _ : state) {
+    send_packets<SpscQueue<std::string>>(enqueue_handler_, enqueue_handler_, state.range(0), 1);
+  }
+
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, spsc_send_packet_vary_by_packet_num)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Iterations(100)
+    ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_QueuePerformance, spsc_send_10000_packet_vary_by_packet_size)(State& state) {
+  for (auto _ : state) {
+    send_packets<SpscQueue<std::string>>(enqueue_handler_, enqueue_handler_, 10000, state.range(0));
+  }
+
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0) * 10000);
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, spsc_send_10000_packet_vary_by_packet_size)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Iterations(100)
+    ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_QueuePerformance, spsc_cross_thread_send_packet_vary_by_packet_num)(State& state) {
+  for (auto _ : state) {
+    send_packets<SpscQueue<std::string>>(enqueue_handler_, dequeue_handler_, state.range(0), 1);
+  }
+
+  state.SetItemsProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, spsc_cross_thread_send_packet_vary_by_packet_num)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Iterations(100)
+    ->UseRealTime();
+
 }  // namespace os
 }  // namespace bluetooth
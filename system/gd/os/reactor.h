@@ -32,6 +32,8 @@
 namespace bluetooth {
 namespace os {
 
+class ReactorPoller;
+
 // A simple implementation of reactor-style looper.
 // When a reactor is running, the main loop is polling and blocked until at least one registered reactable is ready to
 // read or write. It will invoke on_read_ready() or on_write_ready(), which is registered with the reactor. Then, it
@@ -41,7 +43,8 @@ class Reactor {
   // An object used for Unregister() and ModifyRegistration()
   class Reactable;
 
-  // Construct a reactor on the current thread
+  // Construct a reactor on the current thread. It polls with io_uring when the bluetooth.os.reactor.io_uring.enabled
+  // property is true and the kernel supports it, and with epoll otherwise.
   Reactor();
 
   Reactor(const Reactor&) = delete;
@@ -98,7 +101,7 @@ class Reactor {
 
  private:
   mutable std::mutex mutex_;
-  int epoll_fd_;
+  std::unique_ptr<ReactorPoller> poller_;
   int control_fd_;
   std::atomic<bool> is_running_;
   std::list<Reactable*> invalidation_list_;
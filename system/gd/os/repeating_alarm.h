@@ -33,8 +33,9 @@ namespace os {
 // itself from the thread.
 class RepeatingAlarm {
  public:
-  // Create and register a repeating alarm on a given handler
-  explicit RepeatingAlarm(Handler* handler);
+  // Create and register a repeating alarm on a given handler. An alarm that does not |wake_up| the system expires when
+  // the system is next awake for another reason, for work that can wait such as metrics or storage saves.
+  explicit RepeatingAlarm(Handler* handler, bool wake_up = true);
 
   RepeatingAlarm(const RepeatingAlarm&) = delete;
   RepeatingAlarm& operator=(const RepeatingAlarm&) = delete;
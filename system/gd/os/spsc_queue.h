@@ -0,0 +1,106 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/bind.h"
+#include "common/callback.h"
+#include "os/handler.h"
+#include "os/log.h"
+#include "os/queue.h"
+
+namespace bluetooth {
+namespace os {
+
+// A drop-in alternative to |Queue| for queues with exactly one enqueue end and one dequeue end, which is the
+// case for ACL connection, L2CAP channel and ISO queues.
+//
+// Items live in a fixed ring buffer indexed by the producer and the consumer only, so enqueue and dequeue never
+// take a lock. Readiness is signalled through eventfds that are only written on the empty -> non-empty and
+// full -> non-full transitions, so a burst of N items costs a couple of eventfd syscalls instead of 4 * N.
+//
+// TryDequeue() must only be called from the dequeue end, i.e. from the registered dequeue callback or from the
+// dequeue handler thread.
+template <typename T>
+class SpscQueue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
+ public:
+  using EnqueueCallback = common::Callback<std::unique_ptr<T>()>;
+  using DequeueCallback = common::Callback<void()>;
+  // Create a queue with |capacity| is the maximum number of messages a queue can contain
+  explicit SpscQueue(size_t capacity);
+  ~SpscQueue();
+  // See |Queue::RegisterEnqueue|
+  void RegisterEnqueue(Handler* handler, EnqueueCallback callback) override;
+  // See |Queue::UnregisterEnqueue|
+  void UnregisterEnqueue() override;
+  // See |Queue::RegisterDequeue|
+  void RegisterDequeue(Handler* handler, DequeueCallback callback) override;
+  // See |Queue::UnregisterDequeue|
+  void UnregisterDequeue() override;
+
+  // Try to dequeue an item from this queue. Return nullptr when there is nothing in the queue.
+  std::unique_ptr<T> TryDequeue() override;
+
+  // Dequeue up to |max_items| items, signalling the enqueue end at most once for the whole batch.
+  std::vector<std::unique_ptr<T>> TryDequeueBatch(size_t max_items) override;
+
+ private:
+  void EnqueueCallbackInternal(EnqueueCallback callback);
+  void DequeueCallbackInternal(DequeueCallback callback);
+  // Publish that |count| items were removed, given the size before they were removed
+  void OnItemsDequeued(size_t previous_size, size_t count);
+
+  // Ring buffer of |capacity_| slots. |head_| is only touched by the consumer and |tail_| by the producer,
+  // |size_| publishes slot contents between the two.
+  std::vector<std::unique_ptr<T>> slots_;
+  const size_t capacity_;
+  size_t head_ = 0;
+  size_t tail_ = 0;
+  std::atomic<size_t> size_ = 0;
+  // Guards registration state only, never taken on the enqueue/dequeue path
+  std::mutex mutex_;
+
+  class QueueEndpoint {
+   public:
+    QueueEndpoint();
+    ~QueueEndpoint();
+    // Make the endpoint readable, idempotent
+    void Signal();
+    // Make the endpoint unreadable
+    void Clear();
+    int fd_;
+    Handler* handler_;
+    Reactor::Reactable* reactable_;
+  };
+
+  QueueEndpoint enqueue_;
+  QueueEndpoint dequeue_;
+};
+
+#include "os/linux_generic/spsc_queue.tpp"
+
+}  // namespace os
+}  // namespace bluetooth
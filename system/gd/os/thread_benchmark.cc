@@ -17,6 +17,7 @@
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "common/bind.h"
@@ -85,6 +86,7 @@ BENCHMARK_DEFINE_F(BM_ReactorThread, batch_enque_dequeue)(State& state) {
     }
     counter_future.wait();
   }
+  state.SetItemsProcessed(state.iterations() * num_messages_to_send_);
 };
 
 BENCHMARK_REGISTER_F(BM_ReactorThread, batch_enque_dequeue)
@@ -95,6 +97,29 @@ BENCHMARK_REGISTER_F(BM_ReactorThread, batch_enque_dequeue)
     ->Iterations(1)
     ->UseRealTime();
 
+// Same as batch_enque_dequeue, without a BindState allocation per message
+BENCHMARK_DEFINE_F(BM_ReactorThread, batch_enque_dequeue_post_task)(State& state) {
+  for (auto _ : state) {
+    num_messages_to_send_ = state.range(0);
+    counter_ = 0;
+    counter_promise_ = std::promise<void>();
+    std::future<void> counter_future = counter_promise_.get_future();
+    for (int i = 0; i < num_messages_to_send_; i++) {
+      handler_->PostTask([this]() { callback_batch(); });
+    }
+    counter_future.wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_messages_to_send_);
+};
+
+BENCHMARK_REGISTER_F(BM_ReactorThread, batch_enque_dequeue_post_task)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Iterations(1)
+    ->UseRealTime();
+
 BENCHMARK_DEFINE_F(BM_ReactorThread, sequential_execution)(State& state) {
   for (auto _ : state) {
     num_messages_to_send_ = state.range(0);
@@ -115,3 +140,32 @@ BENCHMARK_REGISTER_F(BM_ReactorThread, sequential_execution)
     ->Arg(100000)
     ->Iterations(1)
     ->UseRealTime();
+
+// range(0) threads post range(1) messages each at the same time, the items per second are the posts per second
+BENCHMARK_DEFINE_F(BM_ReactorThread, concurrent_post)(State& state) {
+  for (auto _ : state) {
+    num_messages_to_send_ = state.range(0) * state.range(1);
+    counter_ = 0;
+    counter_promise_ = std::promise<void>();
+    std::future<void> counter_future = counter_promise_.get_future();
+    std::vector<std::thread> posters;
+    for (int i = 0; i < state.range(0); i++) {
+      posters.emplace_back([this, &state]() {
+        for (int j = 0; j < state.range(1); j++) {
+          handler_->Post(BindOnce(
+              &BM_ReactorThread_concurrent_post_Benchmark::callback_batch, bluetooth::common::Unretained(this)));
+        }
+      });
+    }
+    for (auto& poster : posters) {
+      poster.join();
+    }
+    counter_future.wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_messages_to_send_);
+};
+
+BENCHMARK_REGISTER_F(BM_ReactorThread, concurrent_post)
+    ->ArgsProduct({{1, 4}, {1000, 100000}})
+    ->Iterations(1)
+    ->UseRealTime();
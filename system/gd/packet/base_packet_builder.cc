@@ -0,0 +1,116 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/base_packet_builder.h"
+
+#include <new>
+
+namespace bluetooth {
+namespace packet {
+
+namespace {
+
+// Blocks are pooled by size classes of kGranularity bytes, larger builders always come from the heap
+constexpr size_t kGranularity = 16;
+constexpr size_t kMaxPooledSize = 256;
+constexpr size_t kNumSizeClasses = kMaxPooledSize / kGranularity;
+// Free blocks kept by each thread in each size class, the others go back to the heap
+constexpr size_t kMaxFreeBlocks = 64;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+// A block can be freed by another thread than the one which allocated it: it then goes to the pool of the freeing
+// thread, the free blocks are only bounded per thread.
+class BuilderPool {
+ public:
+  ~BuilderPool() {
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+      while (free_blocks_[i] != nullptr) {
+        FreeBlock* block = free_blocks_[i];
+        free_blocks_[i] = block->next;
+        ::operator delete(block);
+      }
+    }
+    destroyed_ = true;
+  }
+
+  // nullptr once the pool of the thread is destroyed, builders destroyed after it use the heap
+  static BuilderPool* Get() {
+    thread_local BuilderPool pool;
+    return destroyed_ ? nullptr : &pool;
+  }
+
+  void* Allocate(size_t size) {
+    size_t index = GetSizeClass(size);
+    FreeBlock* block = free_blocks_[index];
+    if (block == nullptr) {
+      return ::operator new((index + 1) * kGranularity);
+    }
+    free_blocks_[index] = block->next;
+    num_free_blocks_[index]--;
+    return block;
+  }
+
+  void Free(void* ptr, size_t size) {
+    size_t index = GetSizeClass(size);
+    if (num_free_blocks_[index] >= kMaxFreeBlocks) {
+      ::operator delete(ptr);
+      return;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = free_blocks_[index];
+    free_blocks_[index] = block;
+    num_free_blocks_[index]++;
+  }
+
+ private:
+  static size_t GetSizeClass(size_t size) {
+    return (size + kGranularity - 1) / kGranularity - 1;
+  }
+
+  static thread_local bool destroyed_;
+  FreeBlock* free_blocks_[kNumSizeClasses]{};
+  size_t num_free_blocks_[kNumSizeClasses]{};
+};
+
+thread_local bool BuilderPool::destroyed_ = false;
+
+}  // namespace
+
+void* BasePacketBuilder::operator new(size_t size) {
+  BuilderPool* pool = size == 0 || size > kMaxPooledSize ? nullptr : BuilderPool::Get();
+  if (pool == nullptr) {
+    return ::operator new(size);
+  }
+  return pool->Allocate(size);
+}
+
+void BasePacketBuilder::operator delete(void* ptr, size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+  BuilderPool* pool = size == 0 || size > kMaxPooledSize ? nullptr : BuilderPool::Get();
+  if (pool == nullptr) {
+    ::operator delete(ptr);
+    return;
+  }
+  pool->Free(ptr, size);
+}
+
+}  // namespace packet
+}  // namespace bluetooth
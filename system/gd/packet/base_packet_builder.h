@@ -33,6 +33,11 @@ class BasePacketBuilder {
  public:
   virtual ~BasePacketBuilder() = default;
 
+  // Builders are short lived: created for a single Serialize() and destroyed. They are recycled through small
+  // per-thread pools of blocks, so that the hot paths creating a builder per packet do not hit the heap.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   virtual size_t size() const = 0;
 
   // Write to the vector with the given iterator.
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/base_packet_builder.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace packet {
+
+namespace {
+class LargeBuilder : public BasePacketBuilder {
+ public:
+  size_t size() const override {
+    return sizeof(data_);
+  }
+  void Serialize(BitInserter& it) const override {
+    it.insert_bytes(data_, sizeof(data_));
+  }
+
+ private:
+  uint8_t data_[512]{};
+};
+}  // namespace
+
+TEST(BasePacketBuilderTest, builderIsRecycled) {
+  auto builder = std::make_unique<RawBuilder>(std::vector<uint8_t>{1, 2, 3});
+  void* block = builder.get();
+  builder.reset();
+  builder = std::make_unique<RawBuilder>(std::vector<uint8_t>{4, 5});
+  ASSERT_EQ(block, static_cast<void*>(builder.get()));
+
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+  builder->Serialize(it);
+  ASSERT_EQ(bytes, std::vector<uint8_t>({4, 5}));
+}
+
+TEST(BasePacketBuilderTest, largeBuilder) {
+  std::unique_ptr<BasePacketBuilder> builder = std::make_unique<LargeBuilder>();
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+  builder->Serialize(it);
+  ASSERT_EQ(bytes.size(), builder->size());
+}
+
+TEST(BasePacketBuilderTest, builderFreedOnAnotherThread) {
+  std::vector<std::unique_ptr<BasePacketBuilder>> builders;
+  std::thread thread([&builders]() {
+    for (size_t i = 0; i < 128; i++) {
+      builders.push_back(std::make_unique<RawBuilder>(std::vector<uint8_t>{static_cast<uint8_t>(i)}));
+    }
+  });
+  thread.join();
+  for (auto& builder : builders) {
+    ASSERT_EQ(builder->size(), 1u);
+  }
+  builders.clear();
+}
+
+}  // namespace packet
+}  // namespace bluetooth
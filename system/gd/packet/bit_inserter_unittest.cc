@@ -78,5 +78,30 @@ TEST(BitInserterTest, observerTest) {
   ASSERT_EQ(result.size(), copy.size());
 }
 
+TEST(BitInserterTest, insertBytes) {
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+  std::vector<uint8_t> copy;
+  it.RegisterObserver(ByteObserver([&copy](uint8_t byte) { copy.push_back(byte); }, []() { return 0; }));
+
+  std::vector<uint8_t> payload = {0x01, 0x02, 0x03, 0xf4};
+  it.insert_bytes(payload.data(), payload.size());
+  ASSERT_EQ(payload, bytes);
+  ASSERT_EQ(payload, copy);
+  it.UnregisterObserver();
+}
+
+TEST(BitInserterTest, insertBytesNotAligned) {
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+
+  it.insert_bits(0b1010, 4);
+  std::vector<uint8_t> payload = {0x12, 0x34};
+  it.insert_bytes(payload.data(), payload.size());
+  it.insert_bits(0b0101, 4);
+  std::vector<uint8_t> result = {0x2a, 0x41, 0x53};
+  ASSERT_EQ(result, bytes);
+}
+
 }  // namespace packet
 }  // namespace bluetooth
@@ -48,5 +48,14 @@ void ByteInserter::insert_byte(uint8_t byte) {
   std::back_insert_iterator<std::vector<uint8_t>>::operator=(byte);
 }
 
+void ByteInserter::insert_bytes(const uint8_t* bytes, size_t length) {
+  for (auto& observer : registered_observers_) {
+    for (size_t i = 0; i < length; i++) {
+      observer.OnByte(bytes[i]);
+    }
+  }
+  container->insert(container->end(), bytes, bytes + length);
+}
+
 }  // namespace packet
 }  // namespace bluetooth
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <forward_list>
 #include <iterator>
@@ -42,12 +43,12 @@ class EndianInserter {
   template <typename FixedWidthPODType, typename std::enable_if<std::is_pod<FixedWidthPODType>::value, int>::type = 0>
   void insert(FixedWidthPODType value, BitInserter& it) const {
     uint8_t* raw_bytes = (uint8_t*)&value;
-    for (size_t i = 0; i < sizeof(FixedWidthPODType); i++) {
-      if (little_endian == true) {
-        it.insert_byte(raw_bytes[i]);
-      } else {
-        it.insert_byte(raw_bytes[sizeof(FixedWidthPODType) - i - 1]);
-      }
+    if (little_endian == true) {
+      it.insert_bytes(raw_bytes, sizeof(FixedWidthPODType));
+    } else {
+      uint8_t swapped[sizeof(FixedWidthPODType)];
+      std::reverse_copy(raw_bytes, raw_bytes + sizeof(FixedWidthPODType), swapped);
+      it.insert_bytes(swapped, sizeof(FixedWidthPODType));
     }
   }
 
@@ -56,13 +57,14 @@ class EndianInserter {
       typename T,
       typename std::enable_if<std::is_base_of<CustomFieldFixedSizeInterface<T>, T>::value, int>::type = 0>
   void insert(const T& value, BitInserter& it) const {
-    auto* raw_bytes = value.data();
-    for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
-      if (little_endian == true) {
-        it.insert_byte(raw_bytes[i]);
-      } else {
-        it.insert_byte(raw_bytes[CustomFieldFixedSizeInterface<T>::length() - i - 1]);
-      }
+    constexpr size_t length = CustomFieldFixedSizeInterface<T>::length();
+    const uint8_t* raw_bytes = value.data();
+    if (little_endian == true) {
+      it.insert_bytes(raw_bytes, length);
+    } else {
+      uint8_t swapped[length];
+      std::reverse_copy(raw_bytes, raw_bytes + length, swapped);
+      it.insert_bytes(swapped, length);
     }
   }
 
@@ -72,13 +74,15 @@ class EndianInserter {
   void insert(FixedWidthIntegerType value, BitInserter& it, size_t num_bits) const {
     ASSERT(num_bits <= (sizeof(FixedWidthIntegerType) * 8));
 
+    uint8_t bytes[sizeof(uint64_t)];
     for (size_t i = 0; i < num_bits / 8; i++) {
       if (little_endian == true) {
-        it.insert_byte(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8)));
+        bytes[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8));
       } else {
-        it.insert_byte(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (((num_bits / 8) - i - 1) * 8)));
+        bytes[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (((num_bits / 8) - i - 1) * 8));
       }
     }
+    it.insert_bytes(bytes, num_bits / 8);
     if (num_bits % 8) {
       it.insert_bits(static_cast<uint8_t>(static_cast<uint64_t>(value) >> ((num_bits / 8) * 8)), num_bits % 8);
     }
@@ -97,6 +101,10 @@ class EndianInserter {
   void insert_vector(const std::vector<FixedWidthIntegerType>& vec, BitInserter& it) const {
     static_assert(std::is_pod<FixedWidthIntegerType>::value,
                   "EndianInserter::insert requires a vector with elements of a fixed-size.");
+    if constexpr (sizeof(FixedWidthIntegerType) == 1) {
+      it.insert_bytes(reinterpret_cast<const uint8_t*>(vec.data()), vec.size());
+      return;
+    }
     for (const auto& element : vec) {
       insert(element, it);
     }
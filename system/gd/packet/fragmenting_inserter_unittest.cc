@@ -171,5 +171,22 @@ TEST_P(FragmentingTest, mtuFragmentTest) {
 
 INSTANTIATE_TEST_CASE_P(chopomatic, FragmentingTest, ::testing::Range<size_t>(1, kPacketSize + 1));
 
+TEST(FragmentingInserterTest, insertBytes) {
+  std::vector<uint8_t> payload = {0x01, 0x02, 0x03, 0x04, 0x05};
+  std::vector<std::unique_ptr<RawBuilder>> fragments;
+
+  FragmentingInserter it(2, std::back_insert_iterator(fragments));
+  it.insert_bytes(payload.data(), payload.size());
+  it.finalize();
+
+  ASSERT_EQ(3ul, fragments.size());
+  std::vector<uint8_t> bytes;
+  BitInserter bit_inserter(bytes);
+  for (const auto& fragment : fragments) {
+    fragment->Serialize(bit_inserter);
+  }
+  ASSERT_EQ(payload, bytes);
+}
+
 }  // namespace packet
 }  // namespace bluetooth
@@ -16,6 +16,8 @@
 
 #include "packet/iterator.h"
 
+#include <iterator>
+
 #include "os/log.h"
 
 namespace bluetooth {
@@ -30,6 +32,9 @@ Iterator<little_endian>::Iterator(const std::forward_list<View>& data, size_t of
   for (auto& view : data) {
     end_ += view.size();
   }
+  if (!data_.empty() && std::next(data_.begin()) == data_.end()) {
+    contiguous_data_ = data_.front().data();
+  }
 }
 
 template <bool little_endian>
@@ -87,6 +92,7 @@ Iterator<little_endian>& Iterator<little_endian>::operator=(const Iterator<littl
   this->begin_ = itr.begin_;
   this->end_ = itr.end_;
   this->index_ = itr.index_;
+  this->contiguous_data_ = itr.contiguous_data_;
   return *this;
 }
 
@@ -128,6 +134,9 @@ uint8_t Iterator<little_endian>::operator*() const {
       index_,
       begin_,
       end_);
+  if (contiguous_data_ != nullptr) {
+    return contiguous_data_[index_];
+  }
   size_t index = index_;
 
   for (auto view : data_) {
@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <forward_list>
 #include <memory>
 #include <type_traits>
@@ -83,6 +85,15 @@ class Iterator : public IteratorTraits {
     FixedWidthPODType extracted_value{};
     uint8_t* value_ptr = (uint8_t*)&extracted_value;
 
+    if (contiguous_data_ != nullptr && NumBytesRemaining() >= sizeof(FixedWidthPODType)) {
+      std::memcpy(value_ptr, contiguous_data_ + index_, sizeof(FixedWidthPODType));
+      if (!little_endian) {
+        std::reverse(value_ptr, value_ptr + sizeof(FixedWidthPODType));
+      }
+      index_ += sizeof(FixedWidthPODType);
+      return extracted_value;
+    }
+
     for (size_t i = 0; i < sizeof(FixedWidthPODType); i++) {
       size_t index = (little_endian ? i : sizeof(FixedWidthPODType) - i - 1);
       value_ptr[index] = this->operator*();
@@ -94,6 +105,14 @@ class Iterator : public IteratorTraits {
   template <typename T, typename std::enable_if<std::is_base_of_v<CustomFieldFixedSizeInterface<T>, T>, int>::type = 0>
   T extract() {
     T extracted_value{};
+    if (contiguous_data_ != nullptr && NumBytesRemaining() >= CustomFieldFixedSizeInterface<T>::length()) {
+      std::memcpy(extracted_value.data(), contiguous_data_ + index_, CustomFieldFixedSizeInterface<T>::length());
+      if (!little_endian) {
+        std::reverse(extracted_value.data(), extracted_value.data() + CustomFieldFixedSizeInterface<T>::length());
+      }
+      index_ += CustomFieldFixedSizeInterface<T>::length();
+      return extracted_value;
+    }
     for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
       size_t index = (little_endian ? i : CustomFieldFixedSizeInterface<T>::length() - i - 1);
       extracted_value.data()[index] = this->operator*();
@@ -107,6 +126,8 @@ class Iterator : public IteratorTraits {
   size_t index_;
   size_t begin_;
   size_t end_;
+  // Set when the data is a single fragment, so that accesses don't have to walk the fragment list
+  const uint8_t* contiguous_data_ = nullptr;
 };
 
 }  // namespace packet
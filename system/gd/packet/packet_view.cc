@@ -91,12 +91,16 @@ std::forward_list<View> PacketView<little_endian>::GetSubviewList(size_t begin,
 
 template <bool little_endian>
 PacketView<true> PacketView<little_endian>::GetLittleEndianSubview(size_t begin, size_t end) const {
-  return PacketView<true>(GetSubviewList(begin, end));
+  PacketView<true> subview(GetSubviewList(begin, end));
+  subview.SetLatencySample(latency_sample_);
+  return subview;
 }
 
 template <bool little_endian>
 PacketView<false> PacketView<little_endian>::GetBigEndianSubview(size_t begin, size_t end) const {
-  return PacketView<false>(GetSubviewList(begin, end));
+  PacketView<false> subview(GetSubviewList(begin, end));
+  subview.SetLatencySample(latency_sample_);
+  return subview;
 }
 
 template <bool little_endian>
@@ -50,12 +50,21 @@ class PacketView {
   PacketView<true> GetLittleEndianSubview(size_t begin, size_t end) const;
   PacketView<false> GetBigEndianSubview(size_t begin, size_t end) const;
 
+  // The common::PacketLatencyTrace sample of the packet, 0 when it is not sampled. Subviews keep the sample.
+  uint32_t GetLatencySample() const {
+    return latency_sample_;
+  }
+  void SetLatencySample(uint32_t latency_sample) {
+    latency_sample_ = latency_sample;
+  }
+
  protected:
   void Append(PacketView to_add);
 
  private:
   std::forward_list<View> fragments_;
   size_t length_;
+  uint32_t latency_sample_ = 0;
 
   std::forward_list<View> GetSubviewList(size_t begin, size_t end) const;
 };
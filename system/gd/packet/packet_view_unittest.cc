@@ -545,6 +545,26 @@ TEST_F(PacketViewMultiViewTest, dereferenceTestBigEndian) {
   ASSERT_DEATH(*multi_itr, "");
 }
 
+TEST_F(PacketViewMultiViewTest, extractTest) {
+  auto single_itr = single_view.begin();
+  auto multi_itr = multi_view.begin();
+  ASSERT_EQ(single_itr.extract<uint8_t>(), multi_itr.extract<uint8_t>());
+  ASSERT_EQ(single_itr.extract<uint32_t>(), multi_itr.extract<uint32_t>());
+  ASSERT_EQ(single_itr.extract<uint64_t>(), multi_itr.extract<uint64_t>());
+  ASSERT_EQ(single_itr.extract<uint64_t>(), multi_itr.extract<uint64_t>());
+  ASSERT_EQ(single_itr.extract<Address>(), multi_itr.extract<Address>());
+  ASSERT_EQ(single_itr.NumBytesRemaining(), multi_itr.NumBytesRemaining());
+}
+
+TEST_F(PacketViewMultiViewTest, extractSubrangeBoundsTest) {
+  auto single_itr = single_view.begin().Subrange(30, 2);
+  auto multi_itr = multi_view.begin().Subrange(30, 2);
+  ASSERT_EQ(0x1f1eu, single_itr.extract<uint16_t>());
+  ASSERT_EQ(0x1f1eu, multi_itr.extract<uint16_t>());
+  auto bounds_test = single_view.begin().Subrange(30, 2);
+  ASSERT_DEATH(bounds_test.extract<uint32_t>(), "");
+}
+
 TEST_F(PacketViewMultiViewTest, arrayOperatorTest) {
   for (size_t i = 0; i < single_view.size(); i++) {
     ASSERT_EQ(single_view[i], multi_view[i]);
@@ -585,6 +605,16 @@ TEST_F(PacketViewMultiViewAppendTest, arrayOperatorTestAppend) {
   ASSERT_DEATH(multi_view[single_view.size()], "");
 }
 
+TEST(PacketViewTest, subviewKeepsLatencySampleTest) {
+  PacketView<true> packet(std::make_shared<const vector<uint8_t>>(count_all));
+  ASSERT_EQ(packet.GetLatencySample(), 0u);
+  packet.SetLatencySample(42);
+  ASSERT_EQ(packet.GetLittleEndianSubview(2, 10).GetLatencySample(), 42u);
+  ASSERT_EQ(packet.GetBigEndianSubview(2, 10).GetLatencySample(), 42u);
+  PacketView<true> copy = packet;
+  ASSERT_EQ(copy.GetLatencySample(), 42u);
+}
+
 TEST(ViewTest, arrayOperatorTest) {
   View view_all(std::make_shared<const vector<uint8_t>>(count_all), 0, count_all.size());
   size_t past_end = view_all.size();
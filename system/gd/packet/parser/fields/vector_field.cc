@@ -197,6 +197,12 @@ void VectorField::GenParameterValidator(std::ostream&) const {
 }
 
 void VectorField::GenInserter(std::ostream& s) const {
+  if (element_field_->GetFieldType() == ScalarField::kFieldType && element_field_->GetSize().bits() == 8) {
+    // Bytes are copied at once
+    s << "i.insert_bytes(reinterpret_cast<const uint8_t*>(" << GetName() << "_.data()), " << GetName()
+      << "_.size());";
+    return;
+  }
   s << "for (const auto& val_ : " << GetName() << "_) {";
   element_field_->GenInserter(s);
   s << "}\n";
@@ -76,7 +76,10 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool
   // Constructor from a View
   if (parent_ != nullptr) {
     s << "explicit " << name_ << "View(" << parent_->name_ << "View parent)";
-    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false; }";
+    // A sibling definition may have been validated deeper than the parent, which says nothing about this one.
+    size_t parent_depth = GetAncestors().size();
+    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false;";
+    s << "if (validated_depth_ > " << parent_depth << ") { validated_depth_ = " << parent_depth << "; } }";
   } else {
     s << "explicit " << name_ << "View(PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian> packet) ";
     s << " : PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian>(packet) { was_validated_ = false;}";
@@ -179,6 +182,9 @@ void PacketDef::GenValidator(std::ostream& s) const {
     }
   }
 
+  // Number of definitions from the root down to this one, used to skip validating ancestors twice.
+  size_t depth = GetAncestors().size() + 1;
+
   // Generate the public validator IsValid().
   // The method only needs to be generated for the top most class.
   if (parent_ == nullptr) {
@@ -199,7 +205,8 @@ void PacketDef::GenValidator(std::ostream& s) const {
     s << "virtual bool Validate() const {" << std::endl;
   } else {
     s << "bool Validate() const override {" << std::endl;
-    s << "  if (!" << parent_->name_ << "View::Validate()) {" << std::endl;
+    // A view created from an already validated parent doesn't need to walk the parent's fields again.
+    s << "  if (validated_depth_ < " << depth - 1 << " && !" << parent_->name_ << "View::Validate()) {" << std::endl;
     s << "    return false;" << std::endl;
     s << "  }" << std::endl;
   }
@@ -212,14 +219,15 @@ void PacketDef::GenValidator(std::ostream& s) const {
     parent_size = parent_->GetSize(true);
   }
 
-  s << "auto it = begin() + (" << parent_size << ") / 8;";
+  // Bounds are tracked as a byte index rather than with an Iterator, so validation doesn't copy the fragment list.
+  s << "size_t validated_end = (" << parent_size << ") / 8;";
 
   // Check if you can extract the static fields.
   // At this point you know you can use the size getters without crashing
   // as long as they follow the instruction that size fields cant come before
   // their corrisponding variable length field.
-  s << "it += " << ((bits_size + 7) / 8) << " /* Total size of the fixed fields */;";
-  s << "if (it > end()) return false;";
+  s << "validated_end += " << ((bits_size + 7) / 8) << " /* Total size of the fixed fields */;";
+  s << "if (validated_end > size()) return false;";
 
   // For any variable length fields, use their size check.
   for (const auto& field : fields_) {
@@ -295,12 +303,12 @@ void PacketDef::GenValidator(std::ostream& s) const {
       s << "(begin() + (" << offset << ") / 8);";
 
       s << "if (!" << custom_size_var << ".has_value()) { return false; }";
-      s << "it += *" << custom_size_var << ";";
-      s << "if (it > end()) return false;";
+      s << "validated_end += *" << custom_size_var << ";";
+      s << "if (validated_end > size()) return false;";
       continue;
     } else {
-      s << "it += (" << field_size.dynamic_string() << ") / 8;";
-      s << "if (it > end()) return false;";
+      s << "validated_end += (" << field_size.dynamic_string() << ") / 8;";
+      s << "if (validated_end > size()) return false;";
     }
   }
 
@@ -326,10 +334,13 @@ void PacketDef::GenValidator(std::ostream& s) const {
     s << "\n";
   }
 
+  s << "validated_depth_ = " << depth << ";";
   s << "return true;";
   s << "}\n";
   if (parent_ == nullptr) {
     s << "bool was_validated_{false};\n";
+    // Deepest definition whose Validate() passed for this data, carried over when a child view is created.
+    s << "mutable size_t validated_depth_{0};\n";
   }
 }
 
@@ -457,6 +468,7 @@ void PacketDef::GenBuilderDefinitionPybind11(std::ostream& s) const {
   }
   s << ".def(\"Serialize\", [](" << name_ << "Builder& builder){";
   s << "std::vector<uint8_t> bytes;";
+  s << "bytes.reserve(builder.size());";
   s << "BitInserter bi(bytes);";
   s << "builder.Serialize(bi);";
   s << "return bytes;})";
@@ -237,6 +237,7 @@ void StructDef::GenDefinitionPybind11(std::ostream& s) const {
   s << ".def(py::init<>())";
   s << ".def(\"Serialize\", [](" << GetTypeName() << "& obj){";
   s << "std::vector<uint8_t> bytes;";
+  s << "bytes.reserve(obj.size());";
   s << "BitInserter bi(bytes);";
   s << "obj.Serialize(bi);";
   s << "return bytes;})";
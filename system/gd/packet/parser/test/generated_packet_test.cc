@@ -94,6 +94,24 @@ TEST(GeneratedPacketTest, testChildTwoTwoThree) {
   ASSERT_TRUE(grandchild_view.IsValid());
 }
 
+TEST(GeneratedPacketTest, testSiblingOfValidatedView) {
+  auto packet = ChildTwoTwoThreeBuilder::Create();
+  std::shared_ptr<std::vector<uint8_t>> packet_bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter it(*packet_bytes);
+  packet->Serialize(it);
+
+  PacketView<kLittleEndian> packet_bytes_view(packet_bytes);
+  ChildTwoTwoThreeView grandchild_view =
+      ChildTwoTwoThreeView::Create(ChildTwoTwoView::Create(ParentTwoView::Create(packet_bytes_view)));
+  ASSERT_TRUE(grandchild_view.IsValid());
+
+  // The parent was validated through the grandchild, but the sibling's own constraints still apply
+  ParentTwoView parent_view = grandchild_view;
+  ASSERT_TRUE(parent_view.IsValid());
+  ChildTwoThreeView sibling_view = ChildTwoThreeView::Create(parent_view);
+  ASSERT_FALSE(sibling_view.IsValid());
+}
+
 TEST(GeneratedPacketTest, testChild) {
   uint16_t field_name = 0xa2a1;
   uint8_t footer = 0xb1;
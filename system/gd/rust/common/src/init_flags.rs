@@ -385,6 +385,8 @@ init_flags!(
         hfp_dynamic_version = true,
         irk_rotation,
         leaudio_targeted_announcement_reconnection_mode = true,
+        osi_alarm_heap,
+        osi_allocation_sample_rate: i32,
         pass_phy_update_callback = true,
         pbap_pse_dynamic_version_upgrade = false,
         periodic_advertising_adi = true,
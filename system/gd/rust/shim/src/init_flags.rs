@@ -36,9 +36,11 @@ mod ffi {
         fn get_log_level_for_tag(tag: &str) -> i32;
         fn get_asha_packet_drop_frequency_threshold() -> i32;
         fn get_asha_phy_update_retry_limit() -> i32;
+        fn get_osi_allocation_sample_rate() -> i32;
         fn hfp_dynamic_version_is_enabled() -> bool;
         fn irk_rotation_is_enabled() -> bool;
         fn leaudio_targeted_announcement_reconnection_mode_is_enabled() -> bool;
+        fn osi_alarm_heap_is_enabled() -> bool;
         fn pass_phy_update_callback_is_enabled() -> bool;
         fn pbap_pse_dynamic_version_upgrade_is_enabled() -> bool;
         fn periodic_advertising_adi_is_enabled() -> bool;
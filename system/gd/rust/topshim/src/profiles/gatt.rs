@@ -1852,6 +1852,7 @@ impl Gatt {
             services_removed_cb: None,
             services_added_cb: None,
             subrate_chg_cb: None,
+            notify_batch_cb: None,
         });
 
         let gatt_server_callbacks = Box::new(btgatt_server_callbacks_t {
@@ -18,6 +18,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <random>
+
 #include "security/ecc/p_256_ecc_pp.h"
 
 namespace bluetooth {
@@ -107,6 +110,67 @@ TEST(SmpEccValidationTest, test_invalid_points) {
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
 
+// Test data from Bluetooth Core Specification
+// Version 5.0 | Vol 2, Part G | 7.1.2
+TEST(SmpEccPointMultTest, test_spec_sample) {
+  const uint32_t private_key_a[KEY_LENGTH_DWORDS_P256] = {0xcd3c1abd, 0x5899b8a6, 0xeb40b799, 0x4aff607b, 0xd2103f50, 0x74c9b3e3, 0xa3c55f38, 0x3f49f6d4};
+  const uint32_t private_key_b[KEY_LENGTH_DWORDS_P256] = {0xf47fc5fd, 0x6b4fdd49, 0xf19d7cfb, 0x59cb9ac2, 0xeed4e72a, 0x900afcfb, 0x32f6bb9a, 0x55188b3d};
+  const uint32_t public_key_a_x[KEY_LENGTH_DWORDS_P256] = {0x0e359de6, 0xcc030148, 0xacf4fddb, 0xeff49111, 0xe9f9a5b9, 0x5e2c83a7, 0xf297be2c, 0x20b003d2};
+  const uint32_t public_key_a_y[KEY_LENGTH_DWORDS_P256] = {0x1589d28b, 0x741c8ed0, 0x8fed3024, 0x766345c2, 0x5a52155c, 0x63329abf, 0x652aeb6d, 0xdc809c49};
+  const uint32_t dhkey[KEY_LENGTH_DWORDS_P256] = {0x73bfa698, 0x868d34f3, 0xb4f866f1, 0x99796b13, 0x0a397d9b, 0x341010a6, 0x57c8ad05, 0xec0234a3};
+
+  Point public_key_a;
+  ECC_PointMult_Base(&public_key_a, private_key_a);
+  EXPECT_EQ(0, memcmp(public_key_a.x, public_key_a_x, sizeof(public_key_a_x)));
+  EXPECT_EQ(0, memcmp(public_key_a.y, public_key_a_y, sizeof(public_key_a_y)));
+
+  Point shared;
+  ECC_PointMult_Window(&shared, &public_key_a, private_key_b);
+  EXPECT_EQ(0, memcmp(shared.x, dhkey, sizeof(dhkey)));
+}
+
+// The comb and the window must give the same points as the reference implementation
+TEST(SmpEccPointMultTest, test_matches_reference) {
+  std::mt19937 random(0);
+  for (int i = 0; i < 64; i++) {
+    uint32_t n[KEY_LENGTH_DWORDS_P256];
+    uint32_t m[KEY_LENGTH_DWORDS_P256];
+    for (int j = 0; j < KEY_LENGTH_DWORDS_P256; j++) {
+      n[j] = random();
+      m[j] = random();
+    }
+    // Small scalars take the special cases of the point additions
+    if (i < 4) {
+      memset(n, 0, sizeof(n));
+      n[0] = i + 1;
+    }
+
+    Point expected;
+    uint32_t n_copy[KEY_LENGTH_DWORDS_P256];
+    memcpy(n_copy, n, sizeof(n));
+    ECC_PointMult_Bin_NAF(&expected, &curve_p256.G, n_copy);
+
+    Point base;
+    ECC_PointMult_Base(&base, n);
+    EXPECT_EQ(0, memcmp(base.x, expected.x, sizeof(base.x)));
+    EXPECT_EQ(0, memcmp(base.y, expected.y, sizeof(base.y)));
+
+    // n * G as the peer public key
+    expected.z[0] = 1;
+    for (int j = 1; j < KEY_LENGTH_DWORDS_P256; j++) {
+      expected.z[j] = 0;
+    }
+    Point window;
+    ECC_PointMult_Window(&window, &expected, m);
+    uint32_t m_copy[KEY_LENGTH_DWORDS_P256];
+    memcpy(m_copy, m, sizeof(m));
+    Point expected_shared;
+    ECC_PointMult_Bin_NAF(&expected_shared, &expected, m_copy);
+    EXPECT_EQ(0, memcmp(window.x, expected_shared.x, sizeof(window.x)));
+    EXPECT_EQ(0, memcmp(window.y, expected_shared.y, sizeof(window.y)));
+  }
+}
+
 }  // namespace ecc
 }  // namespace security
 }  // namespace bluetooth
@@ -27,6 +27,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "security/ecc/multprecision.h"
+#include "security/ecc/p_256_field.h"
 
 namespace bluetooth {
 namespace security {
@@ -240,6 +241,362 @@ void ECC_PointMult_Bin_NAF(Point* q, const Point* p, uint32_t* n) {
   multiprecision_mersenns_mult_mod(q->y, q->y, q->z, modp);
 }
 
+// Jacobian coordinates, x = X / Z^2 and y = Y / Z^3, of field elements in Montgomery form. The point at infinity has
+// Z = 0.
+struct JacobianPoint {
+  FieldElement x;
+  FieldElement y;
+  FieldElement z;
+};
+
+struct AffinePoint {
+  FieldElement x;
+  FieldElement y;
+};
+
+// Fixed base comb for G: bit i of each of the kCombTeeth parts of the scalar, kCombSpacing bits apart, selects one of
+// the precomputed sums of 2^(kCombSpacing * j) G, so that n G takes kCombSpacing doublings and additions.
+static constexpr int kCombTeeth = 6;
+static constexpr int kCombSpacing = 43;
+static_assert(kCombTeeth * kCombSpacing >= 256);
+
+struct CombTable {
+  // points[u - 1] is the sum of 2^(kCombSpacing * j) G for each bit j set in u
+  AffinePoint points[(1 << kCombTeeth) - 1];
+};
+
+static void jacobian_from_affine(JacobianPoint* r, const AffinePoint& p) {
+  r->x = p.x;
+  r->y = p.y;
+  r->z = kFieldOne;
+}
+
+static void jacobian_select(JacobianPoint* r, const JacobianPoint& p, uint64_t mask) {
+  field_select(&r->x, p.x, mask);
+  field_select(&r->y, p.y, mask);
+  field_select(&r->z, p.z, mask);
+}
+
+// r = 2p, "dbl-2001-b" for a = -3
+static void jacobian_double(JacobianPoint* r, const JacobianPoint& p) {
+  FieldElement delta, gamma, beta, alpha, t1, t2;
+
+  // delta = z1^2
+  field_sqr(&delta, p.z);
+  // gamma = y1^2
+  field_sqr(&gamma, p.y);
+  // beta = x1 * gamma
+  field_mul(&beta, p.x, gamma);
+  // t1 = x1 - delta
+  field_sub(&t1, p.x, delta);
+  // t2 = x1 + delta
+  field_add(&t2, p.x, delta);
+  // alpha = 3 * t1 * t2
+  field_mul(&alpha, t1, t2);
+  field_add(&t1, alpha, alpha);
+  field_add(&alpha, t1, alpha);
+
+  // z3 = (y1 + z1)^2 - gamma - delta
+  field_add(&t1, p.y, p.z);
+  field_sqr(&t1, t1);
+  field_sub(&t1, t1, gamma);
+  field_sub(&r->z, t1, delta);
+
+  // beta = 4 * beta
+  field_add(&beta, beta, beta);
+  field_add(&beta, beta, beta);
+  // x3 = alpha^2 - 8 * beta
+  field_sqr(&t1, alpha);
+  field_add(&t2, beta, beta);
+  field_sub(&r->x, t1, t2);
+
+  // y3 = alpha * (4 * beta - x3) - 8 * gamma^2
+  field_sub(&t1, beta, r->x);
+  field_mul(&t1, alpha, t1);
+  field_sqr(&gamma, gamma);
+  field_add(&gamma, gamma, gamma);
+  field_add(&gamma, gamma, gamma);
+  field_add(&gamma, gamma, gamma);
+  field_sub(&r->y, t1, gamma);
+}
+
+// r = p + q, "add-2007-bl"
+static void jacobian_add(JacobianPoint* r, const JacobianPoint& p, const JacobianPoint& q) {
+  FieldElement z1z1, z2z2, u1, u2, s1, s2, h, i, j, rr, v, t;
+  JacobianPoint sum;
+
+  // z1z1 = z1^2
+  field_sqr(&z1z1, p.z);
+  // z2z2 = z2^2
+  field_sqr(&z2z2, q.z);
+  // u1 = x1 * z2z2
+  field_mul(&u1, p.x, z2z2);
+  // u2 = x2 * z1z1
+  field_mul(&u2, q.x, z1z1);
+  // s1 = y1 * z2 * z2z2
+  field_mul(&s1, p.y, q.z);
+  field_mul(&s1, s1, z2z2);
+  // s2 = y2 * z1 * z1z1
+  field_mul(&s2, q.y, p.z);
+  field_mul(&s2, s2, z1z1);
+  // h = u2 - u1
+  field_sub(&h, u2, u1);
+  // rr = 2 * (s2 - s1)
+  field_sub(&rr, s2, s1);
+  field_add(&rr, rr, rr);
+
+  uint64_t p_is_infinity = field_is_zero(p.z);
+  uint64_t q_is_infinity = field_is_zero(q.z);
+  if (!p_is_infinity && !q_is_infinity && field_is_zero(h)) {
+    // Only possible when p = q or p = -q
+    if (field_is_zero(rr)) {
+      jacobian_double(r, p);
+    } else {
+      memset(r, 0, sizeof(JacobianPoint));
+    }
+    return;
+  }
+
+  // i = (2 * h)^2
+  field_add(&i, h, h);
+  field_sqr(&i, i);
+  // j = h * i
+  field_mul(&j, h, i);
+  // v = u1 * i
+  field_mul(&v, u1, i);
+
+  // x3 = rr^2 - j - 2 * v
+  field_sqr(&t, rr);
+  field_sub(&t, t, j);
+  field_sub(&t, t, v);
+  field_sub(&sum.x, t, v);
+
+  // y3 = rr * (v - x3) - 2 * s1 * j
+  field_sub(&t, v, sum.x);
+  field_mul(&t, rr, t);
+  field_mul(&s1, s1, j);
+  field_add(&s1, s1, s1);
+  field_sub(&sum.y, t, s1);
+
+  // z3 = ((z1 + z2)^2 - z1z1 - z2z2) * h
+  field_add(&t, p.z, q.z);
+  field_sqr(&t, t);
+  field_sub(&t, t, z1z1);
+  field_sub(&t, t, z2z2);
+  field_mul(&sum.z, t, h);
+
+  jacobian_select(&sum, q, p_is_infinity);
+  jacobian_select(&sum, p, q_is_infinity);
+  *r = sum;
+}
+
+// r = p + q, "madd-2007-bl"
+static void jacobian_add_affine(JacobianPoint* r, const JacobianPoint& p, const AffinePoint& q) {
+  FieldElement z1z1, u2, s2, h, hh, i, j, rr, v, t;
+  JacobianPoint sum;
+
+  // z1z1 = z1^2
+  field_sqr(&z1z1, p.z);
+  // u2 = x2 * z1z1
+  field_mul(&u2, q.x, z1z1);
+  // s2 = y2 * z1 * z1z1
+  field_mul(&s2, q.y, p.z);
+  field_mul(&s2, s2, z1z1);
+  // h = u2 - x1
+  field_sub(&h, u2, p.x);
+  // rr = 2 * (s2 - y1)
+  field_sub(&rr, s2, p.y);
+  field_add(&rr, rr, rr);
+
+  uint64_t p_is_infinity = field_is_zero(p.z);
+  if (!p_is_infinity && field_is_zero(h)) {
+    // Only possible when p = q or p = -q
+    if (field_is_zero(rr)) {
+      jacobian_double(r, p);
+    } else {
+      memset(r, 0, sizeof(JacobianPoint));
+    }
+    return;
+  }
+
+  // hh = h^2
+  field_sqr(&hh, h);
+  // i = 4 * hh
+  field_add(&i, hh, hh);
+  field_add(&i, i, i);
+  // j = h * i
+  field_mul(&j, h, i);
+  // v = x1 * i
+  field_mul(&v, p.x, i);
+
+  // x3 = rr^2 - j - 2 * v
+  field_sqr(&t, rr);
+  field_sub(&t, t, j);
+  field_sub(&t, t, v);
+  field_sub(&sum.x, t, v);
+
+  // y3 = rr * (v - x3) - 2 * y1 * j
+  field_sub(&t, v, sum.x);
+  field_mul(&t, rr, t);
+  field_mul(&j, p.y, j);
+  field_add(&j, j, j);
+  field_sub(&sum.y, t, j);
+
+  // z3 = (z1 + h)^2 - z1z1 - hh
+  field_add(&t, p.z, h);
+  field_sqr(&t, t);
+  field_sub(&t, t, z1z1);
+  field_sub(&sum.z, t, hh);
+
+  JacobianPoint q_jacobian;
+  jacobian_from_affine(&q_jacobian, q);
+  jacobian_select(&sum, q_jacobian, p_is_infinity);
+  *r = sum;
+}
+
+static void jacobian_to_point(Point* q, const JacobianPoint& p) {
+  FieldElement z_inv, z_inv2, t;
+
+  field_inv(&z_inv, p.z);
+  field_sqr(&z_inv2, z_inv);
+  field_mul(&t, p.x, z_inv2);
+  field_to_words(q->x, t);
+  field_mul(&z_inv2, z_inv2, z_inv);
+  field_mul(&t, p.y, z_inv2);
+  field_to_words(q->y, t);
+  multiprecision_init(q->z);
+  q->z[0] = 1;
+}
+
+// All ones if a == b, 0 otherwise
+static uint64_t equal_mask(uint32_t a, uint32_t b) {
+  uint64_t x = a ^ b;
+  return 0 - ((x - 1) >> 63);
+}
+
+static uint32_t scalar_bit(const uint32_t* n, int i) {
+  if (i >= 256) return 0;
+  return (n[i / 32] >> (i % 32)) & 1;
+}
+
+static CombTable* build_comb_table() {
+  auto* table = new CombTable();
+  JacobianPoint teeth[kCombTeeth];
+  JacobianPoint sums[(1 << kCombTeeth) - 1];
+  AffinePoint g;
+
+  field_from_words(&g.x, curve_p256.G.x);
+  field_from_words(&g.y, curve_p256.G.y);
+  jacobian_from_affine(&teeth[0], g);
+  for (int j = 1; j < kCombTeeth; j++) {
+    teeth[j] = teeth[j - 1];
+    for (int i = 0; i < kCombSpacing; i++) {
+      jacobian_double(&teeth[j], teeth[j]);
+    }
+  }
+
+  for (int u = 1; u < (1 << kCombTeeth); u++) {
+    int j = __builtin_ctz(u);
+    if (u == (1 << j)) {
+      sums[u - 1] = teeth[j];
+    } else {
+      jacobian_add(&sums[u - 1], sums[(u & ~(1 << j)) - 1], teeth[j]);
+    }
+  }
+
+  // Convert all the sums to affine coordinates with a single inversion
+  FieldElement products[(1 << kCombTeeth) - 1];
+  products[0] = sums[0].z;
+  for (int u = 1; u < (1 << kCombTeeth) - 1; u++) {
+    field_mul(&products[u], products[u - 1], sums[u].z);
+  }
+  FieldElement inv;
+  field_inv(&inv, products[(1 << kCombTeeth) - 2]);
+  for (int u = (1 << kCombTeeth) - 2; u >= 0; u--) {
+    FieldElement z_inv, z_inv2;
+    if (u > 0) {
+      field_mul(&z_inv, inv, products[u - 1]);
+      field_mul(&inv, inv, sums[u].z);
+    } else {
+      z_inv = inv;
+    }
+    field_sqr(&z_inv2, z_inv);
+    field_mul(&table->points[u].x, sums[u].x, z_inv2);
+    field_mul(&z_inv2, z_inv2, z_inv);
+    field_mul(&table->points[u].y, sums[u].y, z_inv2);
+  }
+  return table;
+}
+
+static const CombTable& get_comb_table() {
+  // Built on first use, and never destroyed
+  static const CombTable* table = build_comb_table();
+  return *table;
+}
+
+void ECC_PointMult_Base(Point* q, const uint32_t* n) {
+  const CombTable& table = get_comb_table();
+  JacobianPoint r;
+  memset(&r, 0, sizeof(r));
+
+  for (int i = kCombSpacing - 1; i >= 0; i--) {
+    jacobian_double(&r, r);
+
+    uint32_t u = 0;
+    for (int j = 0; j < kCombTeeth; j++) {
+      u |= scalar_bit(n, kCombSpacing * j + i) << j;
+    }
+
+    // Read the whole table, so that the memory accesses do not depend on the private key
+    AffinePoint t;
+    memset(&t, 0, sizeof(t));
+    for (uint32_t entry = 1; entry < (1 << kCombTeeth); entry++) {
+      uint64_t mask = equal_mask(entry, u);
+      field_select(&t.x, table.points[entry - 1].x, mask);
+      field_select(&t.y, table.points[entry - 1].y, mask);
+    }
+
+    JacobianPoint sum;
+    jacobian_add_affine(&sum, r, t);
+    jacobian_select(&r, sum, ~equal_mask(u, 0));
+  }
+
+  jacobian_to_point(q, r);
+}
+
+void ECC_PointMult_Window(Point* q, const Point* p, const uint32_t* n) {
+  // multiples[d] = d * p, for each 4 bit digit d of n
+  JacobianPoint multiples[16];
+  AffinePoint p_affine;
+
+  field_from_words(&p_affine.x, p->x);
+  field_from_words(&p_affine.y, p->y);
+  memset(&multiples[0], 0, sizeof(JacobianPoint));
+  jacobian_from_affine(&multiples[1], p_affine);
+  for (int d = 2; d < 16; d += 2) {
+    jacobian_double(&multiples[d], multiples[d / 2]);
+    jacobian_add_affine(&multiples[d + 1], multiples[d], p_affine);
+  }
+
+  JacobianPoint r;
+  memset(&r, 0, sizeof(r));
+  for (int i = 63; i >= 0; i--) {
+    for (int k = 0; k < 4; k++) {
+      jacobian_double(&r, r);
+    }
+
+    uint32_t digit = (n[i / 8] >> ((i % 8) * 4)) & 0xf;
+    JacobianPoint t;
+    memset(&t, 0, sizeof(t));
+    for (uint32_t d = 1; d < 16; d++) {
+      jacobian_select(&t, multiples[d], equal_mask(d, digit));
+    }
+    jacobian_add(&r, r, t);
+  }
+
+  jacobian_to_point(q, r);
+}
+
 bool ECC_ValidatePoint(const Point& pt) {
   // Ensure y^2 = x^3 + a*x + b (mod p); a = -3
 
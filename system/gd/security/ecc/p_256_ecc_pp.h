@@ -67,9 +67,16 @@ static constexpr elliptic_curve_t curve_p256{
 /* This function checks that point is on the elliptic curve*/
 bool ECC_ValidatePoint(const Point& point);
 
+// Reference implementation, with the 32 bit multiprecision functions. |n| is overwritten.
 void ECC_PointMult_Bin_NAF(Point* q, const Point* p, uint32_t* n);
 
-#define ECC_PointMult(q, p, n) ECC_PointMult_Bin_NAF(q, p, n)
+// q = n * G, for the public key of private key |n|, with a precomputed table of multiples of G
+void ECC_PointMult_Base(Point* q, const uint32_t* n);
+
+// q = n * p, for the DHKey of private key |n| and public key |p|. Only the x and y coordinates of |p| are used.
+void ECC_PointMult_Window(Point* q, const Point* p, const uint32_t* n);
+
+#define ECC_PointMult(q, p, n) ECC_PointMult_Window(q, p, n)
 
 }  // namespace ecc
 }  // namespace security
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/ecc/p_256_field.h"
+
+namespace bluetooth {
+namespace security {
+namespace ecc {
+
+namespace {
+
+constexpr uint64_t kP[4] = {0xffffffffffffffff, 0x00000000ffffffff, 0x0000000000000000, 0xffffffff00000001};
+// p - 2, the exponent of the inversion
+constexpr uint64_t kPMinus2[4] = {0xfffffffffffffffd, 0x00000000ffffffff, 0x0000000000000000, 0xffffffff00000001};
+// 2^512 mod p, to convert to Montgomery form
+constexpr FieldElement kR2{{0x0000000000000003, 0xfffffffbffffffff, 0xfffffffffffffffe, 0x00000004fffffffd}};
+
+// (hi, lo) = a * b + c + d, which cannot overflow 128 bits
+inline void mul_add(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t* lo, uint64_t* hi) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 t = static_cast<unsigned __int128>(a) * b + c + d;
+  *lo = static_cast<uint64_t>(t);
+  *hi = static_cast<uint64_t>(t >> 64);
+#else
+  // 32 bit targets
+  uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+  uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+  uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+  uint64_t mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+  uint64_t l = (mid << 32) | (ll & 0xffffffff);
+  uint64_t h = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  l += c;
+  h += (l < c);
+  l += d;
+  h += (l < d);
+  *lo = l;
+  *hi = h;
+#endif
+}
+
+inline uint64_t add_carry(uint64_t a, uint64_t b, uint64_t carry_in, uint64_t* carry_out) {
+  uint64_t s = a + b;
+  uint64_t carry = (s < a);
+  s += carry_in;
+  *carry_out = carry | (s < carry_in);
+  return s;
+}
+
+inline uint64_t sub_borrow(uint64_t a, uint64_t b, uint64_t borrow_in, uint64_t* borrow_out) {
+  uint64_t d = a - b;
+  uint64_t borrow = (a < b);
+  *borrow_out = borrow | (d < borrow_in);
+  return d - borrow_in;
+}
+
+// c = t - p if t + carry * 2^256 >= p, t otherwise, for t + carry * 2^256 < 2p
+inline void reduce_once(FieldElement* c, const uint64_t t[4], uint64_t carry) {
+  uint64_t u[4];
+  uint64_t borrow = 0;
+  for (int i = 0; i < 4; i++) {
+    u[i] = sub_borrow(t[i], kP[i], borrow, &borrow);
+  }
+  uint64_t keep_t = 0 - (borrow & (carry ^ 1));
+  for (int i = 0; i < 4; i++) {
+    c->limb[i] = (t[i] & keep_t) | (u[i] & ~keep_t);
+  }
+}
+
+}  // namespace
+
+void field_from_words(FieldElement* c, const uint32_t* a) {
+  FieldElement t;
+  for (int i = 0; i < 4; i++) {
+    t.limb[i] = static_cast<uint64_t>(a[2 * i]) | (static_cast<uint64_t>(a[2 * i + 1]) << 32);
+  }
+  field_mul(c, t, kR2);
+}
+
+void field_to_words(uint32_t* c, const FieldElement& a) {
+  FieldElement t;
+  field_mul(&t, a, FieldElement{{1, 0, 0, 0}});
+  for (int i = 0; i < 4; i++) {
+    c[2 * i] = static_cast<uint32_t>(t.limb[i]);
+    c[2 * i + 1] = static_cast<uint32_t>(t.limb[i] >> 32);
+  }
+}
+
+void field_add(FieldElement* c, const FieldElement& a, const FieldElement& b) {
+  uint64_t t[4];
+  uint64_t carry = 0;
+  for (int i = 0; i < 4; i++) {
+    t[i] = add_carry(a.limb[i], b.limb[i], carry, &carry);
+  }
+  reduce_once(c, t, carry);
+}
+
+void field_sub(FieldElement* c, const FieldElement& a, const FieldElement& b) {
+  uint64_t t[4];
+  uint64_t borrow = 0;
+  for (int i = 0; i < 4; i++) {
+    t[i] = sub_borrow(a.limb[i], b.limb[i], borrow, &borrow);
+  }
+  // Add p back if a < b
+  uint64_t mask = 0 - borrow;
+  uint64_t carry = 0;
+  for (int i = 0; i < 4; i++) {
+    c->limb[i] = add_carry(t[i], kP[i] & mask, carry, &carry);
+  }
+}
+
+// Montgomery multiplication, one limb of a at a time: t = (t + a[i] * b + m * p) / 2^64 with m = t[0]
+void field_mul(FieldElement* c, const FieldElement& a, const FieldElement& b) {
+  uint64_t t[5] = {0, 0, 0, 0, 0};
+  for (int i = 0; i < 4; i++) {
+    uint64_t carry = 0;
+    for (int j = 0; j < 4; j++) {
+      mul_add(a.limb[i], b.limb[j], t[j], carry, &t[j], &carry);
+    }
+    uint64_t t5;
+    t[4] = add_carry(t[4], carry, 0, &t5);
+
+    uint64_t m = t[0];
+    uint64_t lo;
+    mul_add(m, kP[0], t[0], 0, &lo, &carry);
+    for (int j = 1; j < 4; j++) {
+      mul_add(m, kP[j], t[j], carry, &t[j - 1], &carry);
+    }
+    t[3] = add_carry(t[4], carry, 0, &carry);
+    t[4] = t5 + carry;
+  }
+  reduce_once(c, t, t[4]);
+}
+
+void field_sqr(FieldElement* c, const FieldElement& a) {
+  field_mul(c, a, a);
+}
+
+void field_inv(FieldElement* c, const FieldElement& a) {
+  FieldElement r = kFieldOne;
+  // The exponent is public, the branch does not depend on a
+  for (int i = 255; i >= 0; i--) {
+    field_sqr(&r, r);
+    if ((kPMinus2[i / 64] >> (i % 64)) & 1) {
+      field_mul(&r, r, a);
+    }
+  }
+  *c = r;
+}
+
+uint64_t field_is_zero(const FieldElement& a) {
+  uint64_t bits = a.limb[0] | a.limb[1] | a.limb[2] | a.limb[3];
+  // The top bit of (bits - 1) & ~bits is only set when bits is 0
+  return 0 - (((bits - 1) & ~bits) >> 63);
+}
+
+void field_select(FieldElement* c, const FieldElement& a, uint64_t mask) {
+  for (int i = 0; i < 4; i++) {
+    c->limb[i] = (a.limb[i] & mask) | (c->limb[i] & ~mask);
+  }
+}
+
+}  // namespace ecc
+}  // namespace security
+}  // namespace bluetooth
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace bluetooth {
+namespace security {
+namespace ecc {
+
+// An element of the field of the P-256 prime p = 2^256 - 2^224 + 2^192 + 2^96 - 1, in Montgomery form a * 2^256 mod p,
+// as four 64 bit limbs, least significant first.
+//
+// p is -1 mod 2^64, so each step of the Montgomery reduction multiplies p by the low limb alone. The operations take
+// the same time whatever the value of their operands, and the result can be the same element as an operand.
+struct FieldElement {
+  uint64_t limb[4];
+};
+
+// 1 in Montgomery form, 2^256 mod p
+constexpr FieldElement kFieldOne{{0x0000000000000001, 0xffffffff00000000, 0xffffffffffffffff, 0x00000000fffffffe}};
+
+// |a| is 8 little endian 32 bit words, as in Point
+void field_from_words(FieldElement* c, const uint32_t* a);
+void field_to_words(uint32_t* c, const FieldElement& a);
+
+void field_add(FieldElement* c, const FieldElement& a, const FieldElement& b);
+void field_sub(FieldElement* c, const FieldElement& a, const FieldElement& b);
+void field_mul(FieldElement* c, const FieldElement& a, const FieldElement& b);
+void field_sqr(FieldElement* c, const FieldElement& a);
+// c = a^(p - 2) = a^-1, or 0 if a is 0
+void field_inv(FieldElement* c, const FieldElement& a);
+
+// All ones if a is 0, 0 otherwise
+uint64_t field_is_zero(const FieldElement& a);
+// c = a where mask is all ones, c is unchanged where mask is 0
+void field_select(FieldElement* c, const FieldElement& a, uint64_t mask);
+
+}  // namespace ecc
+}  // namespace security
+}  // namespace bluetooth
@@ -228,6 +228,7 @@ Phase1ResultOrFailure PairingHandlerLe::ExchangePairingFeature(const InitialInfo
 
     // Convert builder to view
     std::shared_ptr<std::vector<uint8_t>> packet_bytes = std::make_shared<std::vector<uint8_t>>();
+    packet_bytes->reserve(pairing_request_builder->size());
     BitInserter it(*packet_bytes);
     pairing_request_builder->Serialize(it);
     PacketView<kLittleEndian> packet_bytes_view(packet_bytes);
@@ -305,6 +306,7 @@ Phase1ResultOrFailure PairingHandlerLe::ExchangePairingFeature(const InitialInfo
 
     // Convert builder to view
     std::shared_ptr<std::vector<uint8_t>> packet_bytes = std::make_shared<std::vector<uint8_t>>();
+    packet_bytes->reserve(pairing_response_builder->size());
     BitInserter it(*packet_bytes);
     pairing_response_builder->Serialize(it);
     PacketView<kLittleEndian> packet_bytes_view(packet_bytes);
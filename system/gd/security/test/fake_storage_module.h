@@ -27,7 +27,8 @@ static const std::chrono::milliseconds kTestConfigSaveDelay = std::chrono::milli
 
 class FakeStorageModule : public storage::StorageModule {
  public:
-  FakeStorageModule() : storage::StorageModule("/tmp/temp_config.txt", kTestConfigSaveDelay, 100, false, false) {}
+  FakeStorageModule()
+      : storage::StorageModule("/tmp/temp_config.txt", kTestConfigSaveDelay, 100, false, false, false, false) {}
 
   storage::ConfigCache* GetConfigCachePublic() {
     return StorageModule::GetConfigCache();
@@ -17,7 +17,9 @@
 
 #include "dumpsys/dumpsys.h"
 
+#include <chrono>
 #include <future>
+#include <mutex>
 #include <string>
 
 #include "dumpsys/filter.h"
@@ -35,11 +37,16 @@ static const std::string kReadOnlyDebuggableProperty = "ro.debuggable";
 namespace {
 constexpr char kModuleName[] = "shim::Dumpsys";
 constexpr char kDumpsysTitle[] = "----- Gd Dumpsys ------";
+// How long the printing of a snapshot waits for the module handler to take it
+constexpr std::chrono::milliseconds kSnapshotTimeout{2000};
 }  // namespace
 
 struct Dumpsys::impl {
  public:
-  void DumpWithArgsSync(int fd, const char** args, std::promise<void> promise);
+  // Serializes the dumpsys data of the modules, on the module handler
+  void TakeSnapshot(std::promise<void> promise);
+  // Filters and prints the latest snapshot, on any thread
+  void PrintSnapshot(int fd);
   int GetNumberOfBundledSchemas() const;
 
   impl(const Dumpsys& dumpsys_module, const dumpsys::ReflectionSchema& reflection_schema);
@@ -53,10 +60,13 @@ struct Dumpsys::impl {
   bool IsDebuggable() const;
 
  private:
-  void DumpWithArgsAsync(int fd, const char** args);
-
   const Dumpsys& dumpsys_module_;
   const dumpsys::ReflectionSchema reflection_schema_;
+
+  // The snapshot is never modified once taken, only replaced
+  std::mutex snapshot_mutex_;
+  std::shared_ptr<const std::string> snapshot_;
+  std::chrono::steady_clock::time_point snapshot_time_;
 };
 
 const ModuleFactory Dumpsys::Factory =
@@ -117,25 +127,45 @@ std::string Dumpsys::impl::PrintAsJson(std::string* dumpsys_data) const {
   return jsongen;
 }
 
-void Dumpsys::impl::DumpWithArgsAsync(int fd, const char** args) {
-  ParsedDumpsysArgs parsed_dumpsys_args(args);
+void Dumpsys::impl::TakeSnapshot(std::promise<void> promise) {
   const auto registry = dumpsys_module_.GetModuleRegistry();
 
   ModuleDumper dumper(*registry, kDumpsysTitle);
-  std::string dumpsys_data;
-  dumper.DumpState(&dumpsys_data);
+  auto dumpsys_data = std::make_shared<std::string>();
+  dumper.DumpState(dumpsys_data.get());
+
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    snapshot_ = std::move(dumpsys_data);
+    snapshot_time_ = std::chrono::steady_clock::now();
+  }
+  promise.set_value();
+}
+
+void Dumpsys::impl::PrintSnapshot(int fd) {
+  std::shared_ptr<const std::string> snapshot;
+  std::chrono::steady_clock::time_point snapshot_time;
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    snapshot = snapshot_;
+    snapshot_time = snapshot_time_;
+  }
+
+  if (snapshot == nullptr) {
+    dprintf(fd, " ----- No snapshot taken -----\n");
+    return;
+  }
+
+  auto age = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - snapshot_time);
+  dprintf(fd, " ----- Snapshot taken %lld ms ago -----\n", static_cast<long long>(age.count()));
 
+  std::string dumpsys_data(*snapshot);
   dprintf(fd, " ----- Filtering as Developer -----\n");
   FilterAsDeveloper(&dumpsys_data);
 
   dprintf(fd, "%s", PrintAsJson(&dumpsys_data).c_str());
 }
 
-void Dumpsys::impl::DumpWithArgsSync(int fd, const char** args, std::promise<void> promise) {
-  DumpWithArgsAsync(fd, args);
-  promise.set_value();
-}
-
 Dumpsys::Dumpsys(const std::string& pre_bundled_schema)
     : reflection_schema_(dumpsys::ReflectionSchema(pre_bundled_schema)) {}
 
@@ -143,18 +173,31 @@ void Dumpsys::Dump(int fd, const char** args) {
   if (fd <= 0) {
     return;
   }
-  std::promise<void> promise;
-  auto future = promise.get_future();
-  CallOn(pimpl_.get(), &Dumpsys::impl::DumpWithArgsSync, fd, args, std::move(promise));
-  future.get();
+  Snapshot()(fd);
 }
 
 void Dumpsys::Dump(int fd, const char** args, std::promise<void> promise) {
-  if (fd <= 0) {
-    promise.set_value();
-    return;
-  }
-  CallOn(pimpl_.get(), &Dumpsys::impl::DumpWithArgsSync, fd, args, std::move(promise));
+  Dump(fd, args);
+  promise.set_value();
+}
+
+std::function<void(int fd)> Dumpsys::Snapshot() {
+  std::promise<void> promise;
+  std::shared_future<void> taken = promise.get_future().share();
+  // The handler only serializes the data; filtering, formatting and writing
+  // to the fd, which may block on a slow reader, happen on the caller thread
+  GetHandler()->Call(
+      [](std::shared_ptr<impl> pimpl, std::promise<void> promise) { pimpl->TakeSnapshot(std::move(promise)); },
+      pimpl_,
+      std::move(promise));
+
+  std::shared_ptr<impl> pimpl = pimpl_;
+  return [pimpl, taken](int fd) {
+    if (taken.wait_for(kSnapshotTimeout) != std::future_status::ready) {
+      dprintf(fd, " ----- Stack busy, printing the previous snapshot -----\n");
+    }
+    pimpl->PrintSnapshot(fd);
+  };
 }
 
 os::Handler* Dumpsys::GetGdShimHandler() {
@@ -167,7 +210,7 @@ os::Handler* Dumpsys::GetGdShimHandler() {
 void Dumpsys::ListDependencies(ModuleList* list) const {}
 
 void Dumpsys::Start() {
-  pimpl_ = std::make_unique<impl>(*this, reflection_schema_);
+  pimpl_ = std::make_shared<impl>(*this, reflection_schema_);
 }
 
 void Dumpsys::Stop() {
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <functional>
 #include <future>
 #include <memory>
 #include <string>
@@ -32,6 +33,12 @@ class Dumpsys : public bluetooth::Module {
   void Dump(int fd, const char** args);
   void Dump(int fd, const char** args, std::promise<void> promise);
 
+  // Asks the module handler for a snapshot of the dumpsys data of the modules
+  // and returns right away. The returned callback waits a bounded time for the
+  // snapshot and prints the latest one to |fd|: it does not touch the modules,
+  // so it can run without holding up the stack, even after this module stopped.
+  std::function<void(int fd)> Snapshot();
+
   // Convenience thread used by shim layer for task execution
   os::Handler* GetGdShimHandler();
 
@@ -53,7 +60,7 @@ class Dumpsys : public bluetooth::Module {
 
  private:
   struct impl;
-  std::unique_ptr<impl> pimpl_;
+  std::shared_ptr<impl> pimpl_;
   const dumpsys::ReflectionSchema reflection_schema_;
 };
 
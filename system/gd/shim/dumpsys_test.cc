@@ -134,4 +134,18 @@ TEST_F(DumpsysTest, dump_as_user) {
   ASSERT_TRUE(dumpsys_byte_cnt < socket_buffer_size);
 }
 
+TEST_F(DumpsysTest, snapshot_printed_on_caller_thread) {
+  auto print_snapshot = dumpsys_module_->Snapshot();
+
+  int sv[2];
+  ASSERT_EQ(0, socketpair(AF_LOCAL, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+  int socket_buffer_size = GetSocketBufferSize(sv[0]);
+
+  print_snapshot(sv[0]);
+
+  int dumpsys_byte_cnt = 0;
+  ASSERT_TRUE(SimpleJsonValidator(sv[1], &dumpsys_byte_cnt));
+  ASSERT_TRUE(dumpsys_byte_cnt < socket_buffer_size);
+}
+
 }  // namespace testing
@@ -17,14 +17,17 @@
 #include "stack_manager.h"
 
 #include <stdio.h>
+#include <algorithm>
 #include <chrono>
 #include <future>
 #include <queue>
+#include <thread>
 
 #include "common/bind.h"
 #include "module.h"
 #include "os/handler.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 #include "os/wakelock_manager.h"
 
@@ -34,6 +37,10 @@ using ::bluetooth::os::WakelockManager;
 
 namespace bluetooth {
 
+// Start modules that do not depend on each other concurrently
+constexpr char kParallelStartProperty[] = "persist.bluetooth.stack.parallel_start";
+constexpr size_t kMaxParallelStartThreads = 4;
+
 void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
   management_thread_ = new Thread("management_thread", Thread::Priority::NORMAL);
   handler_ = new Handler(management_thread_);
@@ -60,7 +67,13 @@ void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
 }
 
 void StackManager::handle_start_up(ModuleList* modules, Thread* stack_thread, std::promise<void> promise) {
-  registry_.Start(modules, stack_thread);
+  if (os::GetSystemPropertyBool(kParallelStartProperty, false)) {
+    size_t max_concurrency =
+        std::clamp<size_t>(std::thread::hardware_concurrency(), 1, kMaxParallelStartThreads);
+    registry_.StartParallel(modules, stack_thread, max_concurrency);
+  } else {
+    registry_.Start(modules, stack_thread);
+  }
   promise.set_value();
 }
 
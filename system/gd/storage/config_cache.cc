@@ -16,6 +16,7 @@
 
 #include "storage/config_cache.h"
 
+#include <chrono>
 #include <ios>
 #include <sstream>
 #include <utility>
@@ -62,22 +63,35 @@ ConfigCache::ConfigCache(size_t temp_device_capacity, std::unordered_set<std::st
     : persistent_property_names_(std::move(persistent_property_names)),
       information_sections_(),
       persistent_devices_(),
-      temporary_devices_(temp_device_capacity) {}
+      temporary_devices_(temp_device_capacity) {
+  for (const auto& property : persistent_property_names_) {
+    persistent_property_keys_.insert(PropertyKey::Intern(property));
+  }
+}
 
 void ConfigCache::SetPersistentConfigChangedCallback(std::function<void()> persistent_config_changed_callback) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   persistent_config_changed_callback_ = std::move(persistent_config_changed_callback);
 }
 
+void ConfigCache::SetPersistentMutationCallback(
+    std::function<void(std::optional<MutationEntry>)> persistent_mutation_callback) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  persistent_mutation_callback_ = std::move(persistent_mutation_callback);
+}
+
 ConfigCache::ConfigCache(ConfigCache&& other) noexcept
     : persistent_config_changed_callback_(nullptr),
+      persistent_mutation_callback_(nullptr),
       persistent_property_names_(std::move(other.persistent_property_names_)),
+      persistent_property_keys_(std::move(other.persistent_property_keys_)),
       information_sections_(std::move(other.information_sections_)),
       persistent_devices_(std::move(other.persistent_devices_)),
       temporary_devices_(std::move(other.temporary_devices_)) {
   ASSERT_LOG(
       other.persistent_config_changed_callback_ == nullptr,
       "Can't assign after setting the callback");
+  ASSERT_LOG(other.persistent_mutation_callback_ == nullptr, "Can't assign after setting the callback");
 }
 
 ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
@@ -89,8 +103,11 @@ ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
   ASSERT_LOG(
       other.persistent_config_changed_callback_ == nullptr,
       "Can't assign after setting the callback");
+  ASSERT_LOG(other.persistent_mutation_callback_ == nullptr, "Can't assign after setting the callback");
   persistent_config_changed_callback_ = {};
+  persistent_mutation_callback_ = {};
   persistent_property_names_ = std::move(other.persistent_property_names_);
+  persistent_property_keys_ = std::move(other.persistent_property_keys_);
   information_sections_ = std::move(other.information_sections_);
   persistent_devices_ = std::move(other.persistent_devices_);
   temporary_devices_ = std::move(other.temporary_devices_);
@@ -112,10 +129,16 @@ bool ConfigCache::operator!=(const ConfigCache& rhs) const {
 void ConfigCache::Clear() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   if (information_sections_.size() > 0) {
+    for (const auto& section : information_sections_) {
+      PersistentRemoveCallback(section.first);
+    }
     information_sections_.clear();
     PersistentConfigChangedCallback();
   }
   if (persistent_devices_.size() > 0) {
+    for (const auto& section : persistent_devices_) {
+      PersistentRemoveCallback(section.first);
+    }
     persistent_devices_.clear();
     PersistentConfigChangedCallback();
   }
@@ -131,34 +154,42 @@ bool ConfigCache::HasSection(const std::string& section) const {
 }
 
 bool ConfigCache::HasProperty(const std::string& section, const std::string& property) const {
+  auto property_key = PropertyKey::Find(property);
+  if (!property_key) {
+    return false;
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
-    return section_iter->second.find(property) != section_iter->second.end();
+    return section_iter->second.find(*property_key) != section_iter->second.end();
   }
   section_iter = persistent_devices_.find(section);
   if (section_iter != persistent_devices_.end()) {
-    return section_iter->second.find(property) != section_iter->second.end();
+    return section_iter->second.find(*property_key) != section_iter->second.end();
   }
   section_iter = temporary_devices_.find(section);
   if (section_iter != temporary_devices_.end()) {
-    return section_iter->second.find(property) != section_iter->second.end();
+    return section_iter->second.find(*property_key) != section_iter->second.end();
   }
   return false;
 }
 
 std::optional<std::string> ConfigCache::GetProperty(const std::string& section, const std::string& property) const {
+  auto property_key = PropertyKey::Find(property);
+  if (!property_key) {
+    return std::nullopt;
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
-    auto property_iter = section_iter->second.find(property);
+    auto property_iter = section_iter->second.find(*property_key);
     if (property_iter != section_iter->second.end()) {
       return property_iter->second;
     }
   }
   section_iter = persistent_devices_.find(section);
   if (section_iter != persistent_devices_.end()) {
-    auto property_iter = section_iter->second.find(property);
+    auto property_iter = section_iter->second.find(*property_key);
     if (property_iter != section_iter->second.end()) {
       std::string value = property_iter->second;
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && value == kEncryptedStr) {
@@ -169,7 +200,7 @@ std::optional<std::string> ConfigCache::GetProperty(const std::string& section,
   }
   section_iter = temporary_devices_.find(section);
   if (section_iter != temporary_devices_.end()) {
-    auto property_iter = section_iter->second.find(property);
+    auto property_iter = section_iter->second.find(*property_key);
     if (property_iter != section_iter->second.end()) {
       return property_iter->second;
     }
@@ -184,26 +215,38 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
   TrimAfterNewLine(value);
   ASSERT_LOG(!section.empty(), "Empty section name not allowed");
   ASSERT_LOG(!property.empty(), "Empty property name not allowed");
+  auto property_key = PropertyKey::Intern(property);
   if (!IsDeviceSection(section)) {
     auto section_iter = information_sections_.find(section);
     if (section_iter == information_sections_.end()) {
-      section_iter = information_sections_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
+      section_iter = information_sections_.try_emplace_back(section, SectionProperties{}).first;
+    }
+    if (HasValue(section_iter->second, property_key, value)) {
+      return;
     }
-    section_iter->second.insert_or_assign(property, std::move(value));
+    PersistentSetCallback(section, property, value);
+    section_iter->second.insert_or_assign(property_key, std::move(value));
     PersistentConfigChangedCallback();
     return;
   }
   auto section_iter = persistent_devices_.find(section);
-  if (section_iter == persistent_devices_.end() && IsPersistentProperty(property)) {
+  if (section_iter == persistent_devices_.end() && persistent_property_keys_.count(property_key) > 0) {
     // move paired devices or create new paired device when a link key is set
     auto section_properties = temporary_devices_.extract(section);
     if (section_properties) {
       section_iter = persistent_devices_.try_emplace_back(section, std::move(section_properties->second)).first;
+      for (const auto& moved_property : section_iter->second) {
+        PersistentSetCallback(section, moved_property.first.ToString(), moved_property.second);
+      }
     } else {
-      section_iter = persistent_devices_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
+      section_iter = persistent_devices_.try_emplace_back(section, SectionProperties{}).first;
     }
   }
   if (section_iter != persistent_devices_.end()) {
+    // Unchanged values are neither journaled nor saved again
+    if (HasValue(section_iter->second, property_key, value)) {
+      return;
+    }
     bool is_encrypted = value == kEncryptedStr;
     if ((!value.empty()) && os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
         os::ParameterProvider::IsCommonCriteriaMode() && InEncryptKeyNameList(property) && !is_encrypted) {
@@ -212,22 +255,24 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
         value = kEncryptedStr;
       }
     }
-    section_iter->second.insert_or_assign(property, std::move(value));
+    PersistentSetCallback(section, property, value);
+    section_iter->second.insert_or_assign(property_key, std::move(value));
     PersistentConfigChangedCallback();
     return;
   }
   section_iter = temporary_devices_.find(section);
   if (section_iter == temporary_devices_.end()) {
-    auto triple = temporary_devices_.try_emplace(section, common::ListMap<std::string, std::string>{});
+    auto triple = temporary_devices_.try_emplace(section, SectionProperties{});
     section_iter = std::get<0>(triple);
   }
-  section_iter->second.insert_or_assign(property, std::move(value));
+  section_iter->second.insert_or_assign(property_key, std::move(value));
 }
 
 bool ConfigCache::RemoveSection(const std::string& section) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   // sections are unique among all three maps, hence removing from one of them is enough
   if (information_sections_.extract(section) || persistent_devices_.extract(section)) {
+    PersistentRemoveCallback(section);
     PersistentConfigChangedCallback();
     return true;
   } else {
@@ -236,15 +281,20 @@ bool ConfigCache::RemoveSection(const std::string& section) {
 }
 
 bool ConfigCache::RemoveProperty(const std::string& section, const std::string& property) {
+  auto property_key = PropertyKey::Find(property);
+  if (!property_key) {
+    return false;
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
-    auto value = section_iter->second.extract(property);
+    auto value = section_iter->second.extract(*property_key);
     // if section is empty after removal, remove the whole section as empty section is not allowed
     if (section_iter->second.size() == 0) {
       information_sections_.erase(section_iter);
     }
     if (value.has_value()) {
+      PersistentRemoveCallback(section, property);
       PersistentConfigChangedCallback();
       return true;
     } else {
@@ -253,16 +303,23 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
   }
   section_iter = persistent_devices_.find(section);
   if (section_iter != persistent_devices_.end()) {
-    auto value = section_iter->second.extract(property);
+    auto value = section_iter->second.extract(*property_key);
     // if section is empty after removal, remove the whole section as empty section is not allowed
+    bool is_unpaired = false;
     if (section_iter->second.size() == 0) {
       persistent_devices_.erase(section_iter);
-    } else if (value && IsPersistentProperty(property)) {
+    } else if (value && persistent_property_keys_.count(*property_key) > 0) {
       // move unpaired device
       auto section_properties = persistent_devices_.extract(section);
       temporary_devices_.insert_or_assign(section, std::move(section_properties->second));
+      is_unpaired = true;
     }
     if (value.has_value()) {
+      if (is_unpaired) {
+        PersistentRemoveCallback(section);
+      } else {
+        PersistentRemoveCallback(section, property);
+      }
       PersistentConfigChangedCallback();
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && os::ParameterProvider::IsCommonCriteriaMode() &&
           InEncryptKeyNameList(property)) {
@@ -275,7 +332,7 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
   }
   section_iter = temporary_devices_.find(section);
   if (section_iter != temporary_devices_.end()) {
-    auto value = section_iter->second.extract(property);
+    auto value = section_iter->second.extract(*property_key);
     if (section_iter->second.size() == 0) {
       temporary_devices_.erase(section_iter);
     }
@@ -287,30 +344,46 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
 void ConfigCache::ConvertEncryptOrDecryptKeyIfNeeded() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   LOG_INFO("%s", __func__);
+  // Keys are only ever converted by the keystore
+  if (os::ParameterProvider::GetBtKeystoreInterface() == nullptr) {
+    return;
+  }
+  auto start_time = std::chrono::steady_clock::now();
+  bool is_common_criteria_mode = os::ParameterProvider::IsCommonCriteriaMode();
+  size_t num_encrypted = 0;
+  size_t num_decrypted = 0;
   auto persistent_sections = GetPersistentSections();
   for (const auto& section : persistent_sections) {
     auto section_iter = persistent_devices_.find(section);
     for (const auto& property : kEncryptKeyNameList) {
-      auto property_iter = section_iter->second.find(std::string(property));
-      if (property_iter != section_iter->second.end()) {
-        bool is_encrypted = property_iter->second == kEncryptedStr;
-        if ((!property_iter->second.empty()) && os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
-            os::ParameterProvider::IsCommonCriteriaMode() && !is_encrypted) {
-          if (os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(
-                  section + "-" + std::string(property), property_iter->second)) {
-            SetProperty(section, std::string(property), kEncryptedStr);
-          }
-        }
-        if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && is_encrypted) {
-          std::string value_str =
-              os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + std::string(property));
-          if (!os::ParameterProvider::IsCommonCriteriaMode()) {
-            SetProperty(section, std::string(property), value_str);
-          }
+      auto property_iter = section_iter->second.find(PropertyKey::Intern(property));
+      if (property_iter == section_iter->second.end() || property_iter->second.empty()) {
+        continue;
+      }
+      bool is_encrypted = property_iter->second == kEncryptedStr;
+      if (is_common_criteria_mode && !is_encrypted) {
+        if (os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(
+                section + "-" + std::string(property), property_iter->second)) {
+          SetProperty(section, std::string(property), kEncryptedStr);
+          num_encrypted++;
         }
+      } else if (!is_common_criteria_mode && is_encrypted) {
+        std::string value_str =
+            os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + std::string(property));
+        SetProperty(section, std::string(property), value_str);
+        num_decrypted++;
       }
+      // Keys that stay encrypted are fetched from the keystore by GetProperty(), on first access only
     }
   }
+  LOG_INFO(
+      "%zu keys encrypted and %zu keys decrypted for %zu devices in %lld ms",
+      num_encrypted,
+      num_decrypted,
+      persistent_sections.size(),
+      static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::steady_clock::now() - start_time)
+                                 .count()));
 }
 
 bool ConfigCache::IsDeviceSection(const std::string& section) {
@@ -318,16 +391,22 @@ bool ConfigCache::IsDeviceSection(const std::string& section) {
 }
 
 bool ConfigCache::IsPersistentProperty(const std::string& property) const {
-  return persistent_property_names_.find(property) != persistent_property_names_.end();
+  auto property_key = PropertyKey::Find(property);
+  return property_key && persistent_property_keys_.count(*property_key) > 0;
 }
 
 void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
+  auto property_key = PropertyKey::Find(property);
+  if (!property_key) {
+    return;
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   size_t num_persistent_removed = 0;
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (auto it = config_section->begin(); it != config_section->end();) {
-      if (it->second.contains(property)) {
+      if (it->second.contains(*property_key)) {
         LOG_INFO("Removing persistent section %s with property %s", it->first.c_str(), property.c_str());
+        PersistentRemoveCallback(it->first);
         it = config_section->erase(it);
         num_persistent_removed++;
         continue;
@@ -336,7 +415,7 @@ void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
     }
   }
   for (auto it = temporary_devices_.begin(); it != temporary_devices_.end();) {
-    if (it->second.contains(property)) {
+    if (it->second.contains(*property_key)) {
       LOG_INFO("Removing temporary section %s with property %s", it->first.c_str(), property.c_str());
       it = temporary_devices_.erase(it);
       continue;
@@ -360,6 +439,8 @@ std::vector<std::string> ConfigCache::GetPersistentSections() const {
 
 void ConfigCache::Commit(std::queue<MutationEntry>& mutation_entries) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  // The persistent config changed callback is called once for the whole mutation
+  is_committing_ = true;
   while (!mutation_entries.empty()) {
     auto entry = std::move(mutation_entries.front());
     mutation_entries.pop();
@@ -376,6 +457,11 @@ void ConfigCache::Commit(std::queue<MutationEntry>& mutation_entries) {
         // do not write a default case so that when a new enum is defined, compilation would fail automatically
     }
   }
+  is_committing_ = false;
+  if (has_persistent_change_in_commit_) {
+    has_persistent_change_in_commit_ = false;
+    PersistentConfigChangedCallback();
+  }
 }
 
 std::string ConfigCache::SerializeToLegacyFormat() const {
@@ -385,7 +471,7 @@ std::string ConfigCache::SerializeToLegacyFormat() const {
     for (const auto& section : *config_section) {
       serialized << "[" << section.first << "]" << std::endl;
       for (const auto& property : section.second) {
-        serialized << property.first << " = " << property.second << std::endl;
+        serialized << property.first.ToString() << " = " << property.second << std::endl;
       }
       serialized << std::endl;
     }
@@ -395,11 +481,15 @@ std::string ConfigCache::SerializeToLegacyFormat() const {
 
 std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWithProperty(
     const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
   std::vector<SectionAndPropertyValue> result;
+  auto property_key = PropertyKey::Find(property);
+  if (!property_key) {
+    return result;
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (const auto& elem : *config_section) {
-      auto it = elem.second.find(property);
+      auto it = elem.second.find(*property_key);
       if (it != elem.second.end()) {
         result.emplace_back(SectionAndPropertyValue{.section = elem.first, .property = it->second});
         continue;
@@ -407,7 +497,7 @@ std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWi
     }
   }
   for (const auto& elem : temporary_devices_) {
-    auto it = elem.second.find(property);
+    auto it = elem.second.find(*property_key);
     if (it != elem.second.end()) {
       result.emplace_back(SectionAndPropertyValue{.section = elem.first, .property = it->second});
       continue;
@@ -419,11 +509,12 @@ std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWi
 namespace {
 
 bool FixDeviceTypeInconsistencyInSection(
-    const std::string& section_name, common::ListMap<std::string, std::string>& device_section_entries) {
+    const std::string& section_name, common::ListMap<PropertyKey, std::string>& device_section_entries) {
   if (!hci::Address::IsValidAddress(section_name)) {
     return false;
   }
-  auto device_type_iter = device_section_entries.find("DevType");
+  static const PropertyKey kDeviceTypeKey = PropertyKey::Intern("DevType");
+  auto device_type_iter = device_section_entries.find(kDeviceTypeKey);
   if (device_type_iter != device_section_entries.end() &&
       device_type_iter->second == std::to_string(hci::DeviceType::DUAL)) {
     // We might only have one of classic/LE keys for a dual device, but it is still a dual device,
@@ -438,10 +529,10 @@ bool FixDeviceTypeInconsistencyInSection(
   // default
   hci::DeviceType device_type = hci::DeviceType::BR_EDR;
   for (const auto& entry : device_section_entries) {
-    if (kLePropertyNames.find(entry.first) != kLePropertyNames.end()) {
+    if (kLePropertyNames.find(entry.first.ToString()) != kLePropertyNames.end()) {
       is_le = true;
     }
-    if (kClassicPropertyNames.find(entry.first) != kClassicPropertyNames.end()) {
+    if (kClassicPropertyNames.find(entry.first.ToString()) != kClassicPropertyNames.end()) {
       is_classic = true;
     }
   }
@@ -460,7 +551,7 @@ bool FixDeviceTypeInconsistencyInSection(
       device_type_iter->second = std::move(device_type_str);
     }
   } else {
-    device_section_entries.insert_or_assign("DevType", std::move(device_type_str));
+    device_section_entries.insert_or_assign(kDeviceTypeKey, std::move(device_type_str));
   }
   return inconsistent;
 }
@@ -474,6 +565,7 @@ bool ConfigCache::FixDeviceTypeInconsistencies() {
     for (auto& elem : *config_section) {
       if (FixDeviceTypeInconsistencyInSection(elem.first, elem.second)) {
         persistent_device_changed = true;
+        PersistentSetCallback(elem.first, "DevType", elem.second.find(PropertyKey::Intern("DevType"))->second);
       }
     }
   }
@@ -492,7 +584,7 @@ bool ConfigCache::FixDeviceTypeInconsistencies() {
 bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
     const std::string& section, const std::unordered_set<std::string_view>& property_names) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  const common::ListMap<std::string, std::string>* section_ptr;
+  const SectionProperties* section_ptr;
   if (!IsDeviceSection(section)) {
     auto section_iter = information_sections_.find(section);
     if (section_iter == information_sections_.end()) {
@@ -510,7 +602,7 @@ bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
     section_ptr = &section_iter->second;
   }
   for (const auto& property : *section_ptr) {
-    if (property_names.count(property.first) > 0) {
+    if (property_names.count(property.first.ToString()) > 0) {
       return true;
     }
   }
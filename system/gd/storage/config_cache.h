@@ -31,6 +31,7 @@
 #include "hci/address.h"
 #include "os/utils.h"
 #include "storage/mutation_entry.h"
+#include "storage/property_key.h"
 
 namespace bluetooth {
 namespace storage {
@@ -111,6 +112,10 @@ class ConfigCache {
   virtual void Clear();
   // Set a callback to notify interested party that a persistent config change has just happened
   virtual void SetPersistentConfigChangedCallback(std::function<void()> persistent_config_changed_callback);
+  // Set a callback to receive every persistent config change, as the mutation entry that replays it on top of the
+  // persistent config as it was before the change, or std::nullopt for a change that no mutation entry can replay
+  virtual void SetPersistentMutationCallback(
+      std::function<void(std::optional<MutationEntry>)> persistent_mutation_callback);
 
   // Device config specific methods
   // TODO: methods here should be moved to a device specific config cache if this config cache is supposed to be generic
@@ -125,26 +130,71 @@ class ConfigCache {
   static const std::string kDefaultSectionName;
 
  private:
+  friend class ConfigSnapshot;
+
   mutable std::recursive_mutex mutex_;
   // A callback to notify interested party that a persistent config change has just happened, empty by default
   std::function<void()> persistent_config_changed_callback_;
+  // A callback to record persistent config changes, empty by default
+  std::function<void(std::optional<MutationEntry>)> persistent_mutation_callback_;
   // A set of property names that if set would make a section persistent and if non of these properties are set, a
   // section would become temporary again
   std::unordered_set<std::string_view> persistent_property_names_;
+  // Keys of persistent_property_names_
+  std::unordered_set<PropertyKey> persistent_property_keys_;
+  // Properties of a section, keyed by interned names so that lookups compare pointers instead of strings
+  using SectionProperties = common::ListMap<PropertyKey, std::string>;
   // Common section that does not relate to remote device, will be written to disk
-  common::ListMap<std::string, common::ListMap<std::string, std::string>> information_sections_;
+  common::ListMap<std::string, SectionProperties> information_sections_;
   // Information about persistent devices, normally paired, will be written to disk
-  common::ListMap<std::string, common::ListMap<std::string, std::string>> persistent_devices_;
+  common::ListMap<std::string, SectionProperties> persistent_devices_;
   // Information about temporary devices, normally unpaired, will not be written to disk, will be evicted automatically
   // if capacity exceeds given value during initialization
-  common::LruCache<std::string, common::ListMap<std::string, std::string>> temporary_devices_;
+  common::LruCache<std::string, SectionProperties> temporary_devices_;
+  // Set while a mutation is committed, to notify its persistent changes at once when it is done
+  bool is_committing_ = false;
+  mutable bool has_persistent_change_in_commit_ = false;
+
+  // Check if |property_key| of |properties| is already set to |value|
+  static bool HasValue(const SectionProperties& properties, PropertyKey property_key, const std::string& value) {
+    auto property_iter = properties.find(property_key);
+    return property_iter != properties.end() && property_iter->second == value;
+  }
 
   // Convenience method to check if the callback is valid before calling it
   inline void PersistentConfigChangedCallback() const {
+    if (is_committing_) {
+      has_persistent_change_in_commit_ = true;
+      return;
+    }
     if (persistent_config_changed_callback_) {
       persistent_config_changed_callback_();
     }
   }
+
+  // Convenience methods to build the mutation entries only when they are recorded
+  inline void PersistentSetCallback(
+      const std::string& section, const std::string& property, const std::string& value) const {
+    if (!persistent_mutation_callback_) {
+      return;
+    }
+    // Mutation entries cannot set empty values
+    if (value.empty()) {
+      persistent_mutation_callback_(std::nullopt);
+      return;
+    }
+    persistent_mutation_callback_(MutationEntry::Set(MutationEntry::PropertyType::NORMAL, section, property, value));
+  }
+  inline void PersistentRemoveCallback(const std::string& section) const {
+    if (persistent_mutation_callback_) {
+      persistent_mutation_callback_(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, section));
+    }
+  }
+  inline void PersistentRemoveCallback(const std::string& section, const std::string& property) const {
+    if (persistent_mutation_callback_) {
+      persistent_mutation_callback_(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, section, property));
+    }
+  }
 };
 
 }  // namespace storage
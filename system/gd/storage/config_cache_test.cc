@@ -37,6 +37,7 @@ std::string GetTestAddress(int i) {
 
 using bluetooth::storage::ConfigCache;
 using bluetooth::storage::Device;
+using bluetooth::storage::MutationEntry;
 using SectionAndPropertyValue = bluetooth::storage::ConfigCache::SectionAndPropertyValue;
 
 TEST(ConfigCacheTest, simple_set_get_test) {
@@ -275,6 +276,40 @@ TEST(ConfigCacheTest, persistent_config_changed_callback_test) {
   ASSERT_EQ(num_change, 4);
 }
 
+TEST(ConfigCacheTest, persistent_config_unchanged_value_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  int num_change = 0;
+  config.SetPersistentConfigChangedCallback([&num_change] { num_change++; });
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  ASSERT_EQ(num_change, 2);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  ASSERT_EQ(num_change, 2);
+  config.SetProperty("A", "B", "D");
+  ASSERT_EQ(num_change, 3);
+  ASSERT_THAT(config.GetProperty("A", "B"), Optional(StrEq("D")));
+}
+
+TEST(ConfigCacheTest, persistent_config_changed_callback_commit_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  int num_change = 0;
+  config.SetPersistentConfigChangedCallback([&num_change] { num_change++; });
+
+  std::queue<MutationEntry> entries;
+  entries.push(MutationEntry::Set(MutationEntry::PropertyType::NORMAL, "A", "B", "C"));
+  entries.push(MutationEntry::Set(MutationEntry::PropertyType::NORMAL, "CC:DD:EE:FF:00:11", "LinkKey", "AABBCCDD"));
+  entries.push(MutationEntry::Set(MutationEntry::PropertyType::NORMAL, "CC:DD:EE:FF:00:11", "Name", "foo"));
+  config.Commit(entries);
+  ASSERT_EQ(num_change, 1);
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "Name"), Optional(StrEq("foo")));
+
+  // A mutation that changes nothing is not notified
+  entries.push(MutationEntry::Set(MutationEntry::PropertyType::NORMAL, "A", "B", "C"));
+  config.Commit(entries);
+  ASSERT_EQ(num_change, 1);
+}
+
 TEST(ConfigCacheTest, fix_device_type_inconsistency_missing_devtype_no_keys_test) {
   ConfigCache config(100, Device::kLinkKeyProperties);
   config.SetProperty("A", "B", "C");
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <fstream>
+#include <queue>
+
+#include "common/strings.h"
+#include "os/files.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+constexpr char kSeparator = '\t';
+constexpr char kSetTag[] = "S";
+constexpr char kRemovePropertyTag[] = "P";
+constexpr char kRemoveSectionTag[] = "R";
+
+bool IsEncodable(const std::string& field) {
+  return field.find_first_of("\t\n") == std::string::npos;
+}
+
+}  // namespace
+
+ConfigJournal::ConfigJournal(std::string path) : path_(std::move(path)) {
+  ASSERT(!path_.empty());
+}
+
+std::optional<std::string> ConfigJournal::Encode(const MutationEntry& entry) {
+  if (!IsEncodable(entry.section) || !IsEncodable(entry.property) || entry.value.find('\n') != std::string::npos) {
+    return std::nullopt;
+  }
+  std::string line;
+  switch (entry.entry_type) {
+    case MutationEntry::EntryType::SET:
+      line = kSetTag + (kSeparator + entry.section) + kSeparator + entry.property + kSeparator + entry.value;
+      break;
+    case MutationEntry::EntryType::REMOVE_PROPERTY:
+      line = kRemovePropertyTag + (kSeparator + entry.section) + kSeparator + entry.property;
+      break;
+    case MutationEntry::EntryType::REMOVE_SECTION:
+      line = kRemoveSectionTag + (kSeparator + entry.section);
+      break;
+      // do not write a default case so that when a new enum is defined, compilation would fail automatically
+  }
+  return line + '\n';
+}
+
+std::optional<MutationEntry> ConfigJournal::Decode(const std::string& line) {
+  // The value is last, hence may have separators in it
+  auto tokens = common::StringSplit(line, std::string(1, kSeparator), 4);
+  if (tokens.size() == 4 && tokens[0] == kSetTag && !tokens[3].empty()) {
+    return MutationEntry::Set(
+        MutationEntry::PropertyType::NORMAL, std::move(tokens[1]), std::move(tokens[2]), std::move(tokens[3]));
+  }
+  if (tokens.size() == 3 && tokens[0] == kRemovePropertyTag) {
+    return MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, std::move(tokens[1]), std::move(tokens[2]));
+  }
+  if (tokens.size() == 2 && tokens[0] == kRemoveSectionTag) {
+    return MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, std::move(tokens[1]));
+  }
+  return std::nullopt;
+}
+
+bool ConfigJournal::Append(const std::vector<MutationEntry>& entries) {
+  std::string data;
+  for (const auto& entry : entries) {
+    auto line = Encode(entry);
+    if (!line) {
+      LOG_WARN("cannot journal a change of section %s, property %s", entry.section.c_str(), entry.property.c_str());
+      return false;
+    }
+    data += *line;
+  }
+  if (data.empty()) {
+    return true;
+  }
+  return os::AppendToFile(path_, data);
+}
+
+std::optional<size_t> ConfigJournal::Replay(ConfigCache* cache) {
+  if (!os::FileExists(path_)) {
+    return std::nullopt;
+  }
+  auto data = os::ReadSmallFile(path_);
+  if (!data) {
+    return std::nullopt;
+  }
+  std::queue<MutationEntry> entries;
+  size_t line_start = 0;
+  size_t line_end;
+  // Lines that are not terminated were not fully written
+  while ((line_end = data->find('\n', line_start)) != std::string::npos) {
+    auto entry = Decode(data->substr(line_start, line_end - line_start));
+    if (!entry) {
+      LOG_WARN("corrupted journal entry at offset %zu in %s", line_start, path_.c_str());
+      break;
+    }
+    entries.push(std::move(*entry));
+    line_start = line_end + 1;
+  }
+  size_t num_entries = entries.size();
+  cache->Commit(entries);
+  return num_entries;
+}
+
+size_t ConfigJournal::GetSize() const {
+  std::ifstream journal(path_, std::ios::binary | std::ios::ate);
+  if (!journal) {
+    return 0;
+  }
+  return static_cast<size_t>(journal.tellg());
+}
+
+bool ConfigJournal::Delete() {
+  if (!os::FileExists(path_)) {
+    return false;
+  }
+  return os::RemoveFile(path_);
+}
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/config_cache.h"
+#include "storage/mutation_entry.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Append only log of the persistent config changes made since the config file was last written
+//
+// Each line holds one mutation entry, with tab separated fields:
+//   S <section> <property> <value>
+//   P <section> <property>
+//   R <section>
+// The entries set or remove absolute values, hence replaying a journal on top of a config file that already has its
+// changes, e.g. after a crash between writing the config file and deleting the journal, gives the same config.
+class ConfigJournal {
+ public:
+  static ConfigJournal FromPath(std::string path) {
+    return ConfigJournal(std::move(path));
+  }
+  explicit ConfigJournal(std::string path);
+  // Append |entries| and sync them to disk, return false when they could not all be written
+  bool Append(const std::vector<MutationEntry>& entries);
+  // Apply the journal on top of |cache|, return the number of entries applied or std::nullopt if there is no journal
+  // A last entry that was only partially written is ignored, as are the entries following a corrupted one
+  std::optional<size_t> Replay(ConfigCache* cache);
+  // Return the size of the journal in bytes, 0 if there is none
+  size_t GetSize() const;
+  bool Delete();
+
+  // Return the journal line of |entry|, std::nullopt if it cannot be encoded
+  static std::optional<std::string> Encode(const MutationEntry& entry);
+  static std::optional<MutationEntry> Decode(const std::string& line);
+
+ private:
+  std::string path_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "os/files.h"
+#include "storage/device.h"
+
+namespace testing {
+
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigJournal;
+using bluetooth::storage::Device;
+using bluetooth::storage::MutationEntry;
+
+class ConfigJournalTest : public Test {
+ protected:
+  void SetUp() override {
+    journal_path_ = std::filesystem::temp_directory_path() / "temp_config.journal";
+    if (std::filesystem::exists(journal_path_)) {
+      ASSERT_TRUE(std::filesystem::remove(journal_path_));
+    }
+  }
+
+  void TearDown() override {
+    if (std::filesystem::exists(journal_path_)) {
+      ASSERT_TRUE(std::filesystem::remove(journal_path_));
+    }
+  }
+
+  static void FillConfig(ConfigCache& config) {
+    config.SetProperty("Adapter", "Address", "01:02:03:ab:cd:ef");
+    config.SetProperty("01:02:03:ab:cd:ea", "Name", "hello world");
+    config.SetProperty("01:02:03:ab:cd:ea", "LinkKey", "fedcba0987654321fedcba0987654328");
+  }
+
+  std::filesystem::path journal_path_;
+};
+
+TEST_F(ConfigJournalTest, encode_decode_test) {
+  auto line = ConfigJournal::Encode(
+      MutationEntry::Set(MutationEntry::PropertyType::NORMAL, "Adapter", "Name", "hello\tworld"));
+  ASSERT_THAT(line, Optional(StrEq("S\tAdapter\tName\thello\tworld\n")));
+  ASSERT_THAT(
+      ConfigJournal::Encode(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, "Adapter", "Name")),
+      Optional(StrEq("P\tAdapter\tName\n")));
+  ASSERT_THAT(
+      ConfigJournal::Encode(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, "Adapter")),
+      Optional(StrEq("R\tAdapter\n")));
+
+  // Separators are only allowed in values
+  ASSERT_FALSE(
+      ConfigJournal::Encode(MutationEntry::Set(MutationEntry::PropertyType::NORMAL, "Ada\tpter", "Name", "foo")));
+
+  ASSERT_TRUE(ConfigJournal::Decode("P\tAdapter\tName"));
+  ASSERT_TRUE(ConfigJournal::Decode("R\tAdapter"));
+  ASSERT_FALSE(ConfigJournal::Decode("S\tAdapter\tName\t"));
+  ASSERT_FALSE(ConfigJournal::Decode("S\tAdapter\tName"));
+  ASSERT_FALSE(ConfigJournal::Decode("X\tAdapter"));
+  ASSERT_FALSE(ConfigJournal::Decode(""));
+}
+
+TEST_F(ConfigJournalTest, replay_gives_same_config_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  ConfigCache snapshot(100, Device::kLinkKeyProperties);
+  FillConfig(config);
+  FillConfig(snapshot);
+
+  std::vector<MutationEntry> entries;
+  config.SetPersistentMutationCallback([&entries](std::optional<MutationEntry> entry) {
+    ASSERT_TRUE(entry);
+    entries.push_back(std::move(*entry));
+  });
+  config.SetProperty("Adapter", "Name", "foo");
+  config.SetProperty("01:02:03:ab:cd:ea", "Name", "bar");
+  // Temporary devices are not journaled until they are paired
+  config.SetProperty("01:02:03:ab:cd:eb", "Name", "baz");
+  ASSERT_EQ(entries.size(), 2u);
+  config.SetProperty("01:02:03:ab:cd:eb", "LinkKey", "fedcba0987654321fedcba0987654329");
+  ASSERT_EQ(entries.size(), 4u);
+  // Unpairing removes the device from the persistent config
+  config.RemoveProperty("01:02:03:ab:cd:ea", "LinkKey");
+  config.RemoveProperty("Adapter", "Name");
+  ASSERT_EQ(entries.size(), 6u);
+
+  // Empty values cannot be journaled
+  std::optional<MutationEntry> empty_value_entry = MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, "foo");
+  snapshot.SetPersistentMutationCallback(
+      [&empty_value_entry](std::optional<MutationEntry> entry) { empty_value_entry = std::move(entry); });
+  snapshot.SetProperty("Adapter", "Empty", "");
+  ASSERT_FALSE(empty_value_entry);
+  snapshot.RemoveProperty("Adapter", "Empty");
+  ASSERT_TRUE(empty_value_entry);
+  snapshot.SetPersistentMutationCallback(nullptr);
+
+  auto journal = ConfigJournal::FromPath(journal_path_.string());
+  ASSERT_THAT(journal.Replay(&snapshot), Eq(std::nullopt));
+  ASSERT_TRUE(journal.Append(entries));
+  ASSERT_GT(journal.GetSize(), 0u);
+  ASSERT_THAT(journal.Replay(&snapshot), Optional(6u));
+  ASSERT_EQ(snapshot.SerializeToLegacyFormat(), config.SerializeToLegacyFormat());
+
+  // Replaying again on a config that has the changes already changes nothing
+  ASSERT_THAT(journal.Replay(&snapshot), Optional(6u));
+  ASSERT_EQ(snapshot.SerializeToLegacyFormat(), config.SerializeToLegacyFormat());
+
+  ASSERT_TRUE(journal.Delete());
+  ASSERT_EQ(journal.GetSize(), 0u);
+}
+
+TEST_F(ConfigJournalTest, partial_entry_is_ignored_test) {
+  ASSERT_TRUE(bluetooth::os::WriteToFile(journal_path_.string(), "S\tAdapter\tName\tfoo\nS\tAdapter\tNam"));
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  ASSERT_THAT(ConfigJournal::FromPath(journal_path_.string()).Replay(&config), Optional(1u));
+  ASSERT_THAT(config.GetProperty("Adapter", "Name"), Optional(StrEq("foo")));
+  ASSERT_FALSE(config.HasProperty("Adapter", "Nam"));
+}
+
+TEST_F(ConfigJournalTest, replay_stops_at_corrupted_entry_test) {
+  ASSERT_TRUE(bluetooth::os::WriteToFile(
+      journal_path_.string(), "S\tAdapter\tName\tfoo\ngarbage\nS\tAdapter\tAddress\t01:02:03:ab:cd:ef\n"));
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  ASSERT_THAT(ConfigJournal::FromPath(journal_path_.string()).Replay(&config), Optional(1u));
+  ASSERT_TRUE(config.HasProperty("Adapter", "Name"));
+  ASSERT_FALSE(config.HasProperty("Adapter", "Address"));
+}
+
+}  // namespace testing
@@ -0,0 +1,215 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_snapshot.h"
+
+#include <chrono>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+
+#include "os/files.h"
+#include "os/log.h"
+#include "storage/device.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+constexpr uint32_t kSnapshotMagic = 0x53435442;  // "BTCS"
+constexpr uint32_t kSnapshotVersion = 1;
+// magic, version, config_file_time_ns, payload_size, payload_checksum
+constexpr size_t kSnapshotHeaderSize = 4 + 4 + 8 + 4 + 8;
+
+// FNV-1a, enough to detect a torn or corrupted snapshot
+uint64_t Checksum(std::string_view data) {
+  uint64_t checksum = 0xcbf29ce484222325;
+  for (char c : data) {
+    checksum ^= static_cast<uint8_t>(c);
+    checksum *= 0x100000001b3;
+  }
+  return checksum;
+}
+
+template <typename T>
+void WriteInteger(std::string& out, T value) {
+  using U = std::make_unsigned_t<T>;
+  U unsigned_value = static_cast<U>(value);
+  for (size_t i = 0; i < sizeof(T); i++) {
+    out.push_back(static_cast<char>((unsigned_value >> (8 * i)) & 0xff));
+  }
+}
+
+void WriteString(std::string& out, const std::string& value) {
+  WriteInteger(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(std::string_view data) : data_(data) {}
+
+  template <typename T>
+  bool ReadInteger(T* value) {
+    if (data_.size() < sizeof(T)) {
+      return false;
+    }
+    using U = std::make_unsigned_t<T>;
+    U unsigned_value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+      unsigned_value |= static_cast<U>(static_cast<uint8_t>(data_[i])) << (8 * i);
+    }
+    *value = static_cast<T>(unsigned_value);
+    data_.remove_prefix(sizeof(T));
+    return true;
+  }
+
+  bool ReadString(std::string* value) {
+    uint32_t size;
+    if (!ReadInteger(&size) || data_.size() < size) {
+      return false;
+    }
+    value->assign(data_.data(), size);
+    data_.remove_prefix(size);
+    return true;
+  }
+
+  std::string_view Remaining() const {
+    return data_;
+  }
+
+ private:
+  std::string_view data_;
+};
+
+std::optional<int64_t> GetConfigFileTime(const std::string& config_file_path) {
+  if (!os::FileExists(config_file_path)) {
+    return std::nullopt;
+  }
+  auto time = os::FileCreatedTime(config_file_path);
+  if (!time) {
+    return std::nullopt;
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time->time_since_epoch()).count();
+}
+
+}  // namespace
+
+ConfigSnapshot::ConfigSnapshot(std::string path) : path_(std::move(path)) {
+  ASSERT(!path_.empty());
+}
+
+std::optional<ConfigCache> ConfigSnapshot::Read(const std::string& config_file_path, size_t temp_devices_capacity) {
+  if (!os::FileExists(path_)) {
+    return std::nullopt;
+  }
+  auto config_file_time_ns = GetConfigFileTime(config_file_path);
+  if (!config_file_time_ns) {
+    return std::nullopt;
+  }
+  auto data = os::ReadSmallFile(path_);
+  if (!data) {
+    return std::nullopt;
+  }
+  auto cache = Deserialize(*data, *config_file_time_ns, temp_devices_capacity);
+  if (!cache) {
+    LOG_WARN("config snapshot at %s does not match %s", path_.c_str(), config_file_path.c_str());
+  }
+  return cache;
+}
+
+bool ConfigSnapshot::Write(const ConfigCache& cache, const std::string& config_file_path) {
+  auto config_file_time_ns = GetConfigFileTime(config_file_path);
+  if (!config_file_time_ns) {
+    return false;
+  }
+  return os::WriteToFile(path_, Serialize(cache, *config_file_time_ns));
+}
+
+bool ConfigSnapshot::Delete() {
+  if (!os::FileExists(path_)) {
+    return false;
+  }
+  return os::RemoveFile(path_);
+}
+
+std::string ConfigSnapshot::Serialize(const ConfigCache& cache, int64_t config_file_time_ns) {
+  std::lock_guard<std::recursive_mutex> lock(cache.mutex_);
+  // Same content as ConfigCache::SerializeToLegacyFormat()
+  std::string payload;
+  WriteInteger(payload, static_cast<uint32_t>(cache.information_sections_.size() + cache.persistent_devices_.size()));
+  for (const auto* config_section : {&cache.information_sections_, &cache.persistent_devices_}) {
+    for (const auto& section : *config_section) {
+      WriteString(payload, section.first);
+      WriteInteger(payload, static_cast<uint32_t>(section.second.size()));
+      for (const auto& property : section.second) {
+        WriteString(payload, property.first.ToString());
+        WriteString(payload, property.second);
+      }
+    }
+  }
+  std::string serialized;
+  serialized.reserve(kSnapshotHeaderSize + payload.size());
+  WriteInteger(serialized, kSnapshotMagic);
+  WriteInteger(serialized, kSnapshotVersion);
+  WriteInteger(serialized, config_file_time_ns);
+  WriteInteger(serialized, static_cast<uint32_t>(payload.size()));
+  WriteInteger(serialized, Checksum(payload));
+  serialized.append(payload);
+  return serialized;
+}
+
+std::optional<ConfigCache> ConfigSnapshot::Deserialize(
+    const std::string& data, int64_t config_file_time_ns, size_t temp_devices_capacity) {
+  SnapshotReader reader(data);
+  uint32_t magic, version, payload_size;
+  int64_t time_ns;
+  uint64_t checksum;
+  if (!reader.ReadInteger(&magic) || !reader.ReadInteger(&version) || !reader.ReadInteger(&time_ns) ||
+      !reader.ReadInteger(&payload_size) || !reader.ReadInteger(&checksum)) {
+    return std::nullopt;
+  }
+  if (magic != kSnapshotMagic || version != kSnapshotVersion || time_ns != config_file_time_ns ||
+      payload_size != reader.Remaining().size() || checksum != Checksum(reader.Remaining())) {
+    return std::nullopt;
+  }
+  ConfigCache cache(temp_devices_capacity, Device::kLinkKeyProperties);
+  uint32_t num_sections;
+  if (!reader.ReadInteger(&num_sections)) {
+    return std::nullopt;
+  }
+  std::string section, property, value;
+  for (uint32_t i = 0; i < num_sections; i++) {
+    uint32_t num_properties;
+    if (!reader.ReadString(&section) || section.empty() || !reader.ReadInteger(&num_properties)) {
+      return std::nullopt;
+    }
+    for (uint32_t j = 0; j < num_properties; j++) {
+      if (!reader.ReadString(&property) || property.empty() || !reader.ReadString(&value)) {
+        return std::nullopt;
+      }
+      cache.SetProperty(section, property, value);
+    }
+  }
+  if (!reader.Remaining().empty()) {
+    return std::nullopt;
+  }
+  return cache;
+}
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "storage/config_cache.h"
+
+namespace bluetooth {
+namespace storage {
+
+// A binary copy of a config file, that loads without any text parsing
+//
+// The snapshot records the time the config file was last changed on disk, and is only read back when the config file
+// has not changed since. Any mismatch, or a corrupted snapshot, makes Read() fail so that the caller falls back to the
+// config file.
+//
+// All integers are little endian:
+//   header   := magic:u32 version:u32 config_file_time_ns:i64 payload_size:u32 payload_checksum:u64
+//   payload  := num_sections:u32 section*
+//   section  := name:string num_properties:u32 (property:string value:string)*
+//   string   := size:u32 bytes
+class ConfigSnapshot {
+ public:
+  static ConfigSnapshot FromPath(std::string path) {
+    return ConfigSnapshot(std::move(path));
+  }
+  explicit ConfigSnapshot(std::string path);
+  // Read a snapshot of the config file at |config_file_path|, return std::nullopt if there is no valid snapshot
+  // for the current config file
+  std::optional<ConfigCache> Read(const std::string& config_file_path, size_t temp_devices_capacity);
+  // Write a snapshot of |cache|, which must just have been written to the config file at |config_file_path|
+  bool Write(const ConfigCache& cache, const std::string& config_file_path);
+  bool Delete();
+
+  static std::string Serialize(const ConfigCache& cache, int64_t config_file_time_ns);
+  static std::optional<ConfigCache> Deserialize(
+      const std::string& data, int64_t config_file_time_ns, size_t temp_devices_capacity);
+
+ private:
+  std::string path_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_snapshot.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "os/files.h"
+#include "storage/device.h"
+#include "storage/legacy_config_file.h"
+
+namespace testing {
+
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigSnapshot;
+using bluetooth::storage::Device;
+using bluetooth::storage::LegacyConfigFile;
+
+constexpr int64_t kConfigFileTimeNs = 1234567890123;
+
+class ConfigSnapshotTest : public Test {
+ protected:
+  void SetUp() override {
+    auto temp_dir = std::filesystem::temp_directory_path();
+    config_path_ = temp_dir / "temp_config.conf";
+    snapshot_path_ = temp_dir / "temp_config.snapshot";
+    DeleteFiles();
+  }
+
+  void TearDown() override {
+    DeleteFiles();
+  }
+
+  void DeleteFiles() {
+    for (const auto& path : {config_path_, snapshot_path_}) {
+      if (std::filesystem::exists(path)) {
+        ASSERT_TRUE(std::filesystem::remove(path));
+      }
+    }
+  }
+
+  static void FillConfig(ConfigCache& config) {
+    config.SetProperty("Adapter", "Address", "01:02:03:ab:cd:ef");
+    config.SetProperty("Adapter", "Empty", "");
+    config.SetProperty("01:02:03:ab:cd:ea", "Name", "hello = world");
+    config.SetProperty("01:02:03:ab:cd:ea", "LinkKey", "fedcba0987654321fedcba0987654328");
+    // Temporary devices are not saved
+    config.SetProperty("01:02:03:ab:cd:eb", "Name", "foo");
+  }
+
+  std::filesystem::path config_path_;
+  std::filesystem::path snapshot_path_;
+};
+
+TEST_F(ConfigSnapshotTest, serialize_deserialize_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  FillConfig(config);
+  auto data = ConfigSnapshot::Serialize(config, kConfigFileTimeNs);
+  auto snapshot = ConfigSnapshot::Deserialize(data, kConfigFileTimeNs, 100);
+  ASSERT_TRUE(snapshot);
+  ASSERT_EQ(snapshot->SerializeToLegacyFormat(), config.SerializeToLegacyFormat());
+  ASSERT_TRUE(snapshot->IsPersistentSection("01:02:03:ab:cd:ea"));
+  ASSERT_FALSE(snapshot->HasSection("01:02:03:ab:cd:eb"));
+}
+
+TEST_F(ConfigSnapshotTest, mismatch_is_rejected_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  FillConfig(config);
+  auto data = ConfigSnapshot::Serialize(config, kConfigFileTimeNs);
+
+  // Another config file
+  ASSERT_FALSE(ConfigSnapshot::Deserialize(data, kConfigFileTimeNs + 1, 100));
+  // Torn write
+  ASSERT_FALSE(ConfigSnapshot::Deserialize(data.substr(0, data.size() - 1), kConfigFileTimeNs, 100));
+  ASSERT_FALSE(ConfigSnapshot::Deserialize("", kConfigFileTimeNs, 100));
+  // Corrupted payload
+  data[data.size() - 2] ^= 0x01;
+  ASSERT_FALSE(ConfigSnapshot::Deserialize(data, kConfigFileTimeNs, 100));
+}
+
+TEST_F(ConfigSnapshotTest, write_read_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  FillConfig(config);
+  auto snapshot = ConfigSnapshot::FromPath(snapshot_path_.string());
+
+  // No config file to match
+  ASSERT_FALSE(snapshot.Write(config, config_path_.string()));
+
+  ASSERT_TRUE(LegacyConfigFile::FromPath(config_path_.string()).Write(config));
+  ASSERT_TRUE(snapshot.Write(config, config_path_.string()));
+  auto read_config = snapshot.Read(config_path_.string(), 100);
+  ASSERT_TRUE(read_config);
+  ASSERT_EQ(read_config->SerializeToLegacyFormat(), config.SerializeToLegacyFormat());
+
+  // Rewriting the config file makes the snapshot outdated
+  ASSERT_TRUE(LegacyConfigFile::FromPath(config_path_.string()).Write(config));
+  ASSERT_FALSE(snapshot.Read(config_path_.string(), 100));
+
+  ASSERT_TRUE(snapshot.Delete());
+  ASSERT_FALSE(snapshot.Delete());
+  ASSERT_FALSE(snapshot.Read(config_path_.string(), 100));
+}
+
+}  // namespace testing
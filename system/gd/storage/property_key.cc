@@ -0,0 +1,72 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/property_key.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+struct PropertyKeyRegistry {
+  std::shared_mutex mutex;
+  // std::deque never moves its elements, hence the names can be referenced by pointer
+  std::deque<std::string> names;
+  std::unordered_map<std::string_view, const std::string*> index;
+};
+
+PropertyKeyRegistry& GetRegistry() {
+  // Never destroyed, so that keys held by static objects stay valid until exit
+  static auto* registry = new PropertyKeyRegistry();
+  return *registry;
+}
+
+}  // namespace
+
+PropertyKey PropertyKey::Intern(std::string_view name) {
+  auto key = Find(name);
+  if (key) {
+    return *key;
+  }
+  auto& registry = GetRegistry();
+  std::unique_lock<std::shared_mutex> lock(registry.mutex);
+  // Another thread may have registered the name since Find()
+  auto iter = registry.index.find(name);
+  if (iter != registry.index.end()) {
+    return PropertyKey(iter->second);
+  }
+  const std::string* stored_name = &registry.names.emplace_back(name);
+  registry.index.emplace(*stored_name, stored_name);
+  return PropertyKey(stored_name);
+}
+
+std::optional<PropertyKey> PropertyKey::Find(std::string_view name) {
+  auto& registry = GetRegistry();
+  std::shared_lock<std::shared_mutex> lock(registry.mutex);
+  auto iter = registry.index.find(name);
+  if (iter == registry.index.end()) {
+    return std::nullopt;
+  }
+  return PropertyKey(iter->second);
+}
+
+}  // namespace storage
+}  // namespace bluetooth
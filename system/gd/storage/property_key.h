@@ -0,0 +1,71 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace bluetooth {
+namespace storage {
+
+// An interned property name
+//
+// Every property name is stored once in a process wide registry, and a key is a pointer to that storage. Keys are
+// compared and hashed as pointers, and a config entry only holds the key instead of a copy of the name.
+//
+// Names are never removed from the registry. This is fine as the set of property names used by the stack is fixed.
+//
+// This class is thread safe
+class PropertyKey {
+ public:
+  // Returns the key of |name|, registering |name| if this is the first time it is seen
+  static PropertyKey Intern(std::string_view name);
+  // Returns the key of |name| if it is registered, std::nullopt otherwise. As every stored property is registered, a
+  // property that is not registered is not stored anywhere
+  static std::optional<PropertyKey> Find(std::string_view name);
+
+  const std::string& ToString() const {
+    return *name_;
+  }
+
+  bool operator==(const PropertyKey& rhs) const {
+    return name_ == rhs.name_;
+  }
+  bool operator!=(const PropertyKey& rhs) const {
+    return !(*this == rhs);
+  }
+
+ private:
+  friend struct std::hash<PropertyKey>;
+
+  explicit PropertyKey(const std::string* name) : name_(name) {}
+
+  const std::string* name_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
+
+namespace std {
+template <>
+struct hash<bluetooth::storage::PropertyKey> {
+  std::size_t operator()(const bluetooth::storage::PropertyKey& val) const {
+    return std::hash<const std::string*>{}(val.name_);
+  }
+};
+}  // namespace std
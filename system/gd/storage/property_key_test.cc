@@ -0,0 +1,60 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/property_key.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace testing {
+
+using bluetooth::storage::PropertyKey;
+
+TEST(PropertyKeyTest, intern_test) {
+  auto key = PropertyKey::Intern("PropertyKeyTest_Name");
+  ASSERT_EQ(key.ToString(), "PropertyKeyTest_Name");
+  ASSERT_EQ(key, PropertyKey::Intern(std::string("PropertyKeyTest_") + "Name"));
+  ASSERT_NE(key, PropertyKey::Intern("PropertyKeyTest_Other"));
+  ASSERT_EQ(std::hash<PropertyKey>{}(key), std::hash<PropertyKey>{}(PropertyKey::Intern("PropertyKeyTest_Name")));
+}
+
+TEST(PropertyKeyTest, find_does_not_register_test) {
+  ASSERT_FALSE(PropertyKey::Find("PropertyKeyTest_Unknown"));
+  ASSERT_FALSE(PropertyKey::Find("PropertyKeyTest_Unknown"));
+  auto key = PropertyKey::Intern("PropertyKeyTest_Unknown");
+  auto found = PropertyKey::Find("PropertyKeyTest_Unknown");
+  ASSERT_TRUE(found);
+  ASSERT_EQ(*found, key);
+}
+
+TEST(PropertyKeyTest, concurrent_intern_test) {
+  constexpr int kNumThreads = 4;
+  std::vector<PropertyKey> keys(kNumThreads, PropertyKey::Intern("PropertyKeyTest_Placeholder"));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&keys, i]() { keys[i] = PropertyKey::Intern("PropertyKeyTest_Concurrent"); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& key : keys) {
+    ASSERT_EQ(key, *PropertyKey::Find("PropertyKeyTest_Concurrent"));
+  }
+}
+
+}  // namespace testing
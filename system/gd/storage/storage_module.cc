@@ -30,6 +30,8 @@
 #include "os/parameter_provider.h"
 #include "os/system_properties.h"
 #include "storage/config_cache.h"
+#include "storage/config_journal.h"
+#include "storage/config_snapshot.h"
 #include "storage/legacy_config_file.h"
 #include "storage/mutation.h"
 
@@ -42,6 +44,8 @@ using os::Alarm;
 using os::Handler;
 
 static const std::string kFactoryResetProperty = "persist.bluetooth.factoryreset";
+static const std::string kConfigJournalProperty = "persist.bluetooth.storage.journal";
+static const std::string kConfigSnapshotProperty = "persist.bluetooth.storage.snapshot";
 
 static const size_t kDefaultTempDeviceCapacity = 10000;
 // Save config whenever there is a change, but delay it by this value so that burst config change won't overwhelm disk
@@ -49,6 +53,8 @@ static const std::chrono::milliseconds kDefaultConfigSaveDelay = std::chrono::mi
 // Writing a config to disk takes a minimum 10 ms on a decent x86_64 machine, and 20 ms if including backup file
 // The config saving delay must be bigger than this value to avoid overwhelming the disk
 static const std::chrono::milliseconds kMinConfigSaveDelay = std::chrono::milliseconds(20);
+// The journal is compacted into the config file once it grows past this size, so that it stays cheap to replay
+static const size_t kMaxConfigJournalSize = 64 * 1024;
 
 const int kConfigFileComparePass = 1;
 const int kConfigBackupComparePass = 2;
@@ -67,14 +73,22 @@ StorageModule::StorageModule(
     std::chrono::milliseconds config_save_delay,
     size_t temp_devices_capacity,
     bool is_restricted_mode,
-    bool is_single_user_mode)
+    bool is_single_user_mode,
+    bool is_journal_enabled,
+    bool is_snapshot_enabled)
     : config_file_path_(std::move(config_file_path)),
       config_save_delay_(config_save_delay),
       temp_devices_capacity_(temp_devices_capacity),
       is_restricted_mode_(is_restricted_mode),
-      is_single_user_mode_(is_single_user_mode) {
+      is_single_user_mode_(is_single_user_mode),
+      is_journal_enabled_(is_journal_enabled),
+      is_snapshot_enabled_(is_snapshot_enabled) {
   // e.g. "/data/misc/bluedroid/bt_config.conf" to "/data/misc/bluedroid/bt_config.bak"
   config_backup_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".bak";
+  // e.g. "/data/misc/bluedroid/bt_config.conf" to "/data/misc/bluedroid/bt_config.journal"
+  config_journal_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".journal";
+  // e.g. "/data/misc/bluedroid/bt_config.conf" to "/data/misc/bluedroid/bt_config.snapshot"
+  config_snapshot_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".snapshot";
   ASSERT_LOG(
       config_save_delay > kMinConfigSaveDelay,
       "Config save delay of %lld ms is not enough, must be at least %lld ms to avoid overwhelming the disk",
@@ -89,16 +103,30 @@ StorageModule::~StorageModule() {
 
 const ModuleFactory StorageModule::Factory = ModuleFactory([]() {
   return new StorageModule(
-      os::ParameterProvider::ConfigFilePath(), kDefaultConfigSaveDelay, kDefaultTempDeviceCapacity, false, false);
+      os::ParameterProvider::ConfigFilePath(),
+      kDefaultConfigSaveDelay,
+      kDefaultTempDeviceCapacity,
+      false,
+      false,
+      os::GetSystemPropertyBool(kConfigJournalProperty, false),
+      os::GetSystemPropertyBool(kConfigSnapshotProperty, false));
 });
 
 struct StorageModule::impl {
   explicit impl(Handler* handler, ConfigCache cache, size_t in_memory_cache_size_limit)
-      : config_save_alarm_(handler), cache_(std::move(cache)), memory_only_cache_(in_memory_cache_size_limit, {}) {}
+      : config_save_alarm_(handler, /* wake_up */ false),
+        cache_(std::move(cache)),
+        memory_only_cache_(in_memory_cache_size_limit, {}) {}
   Alarm config_save_alarm_;
   ConfigCache cache_;
   ConfigCache memory_only_cache_;
   bool has_pending_config_save_ = false;
+  // Persistent config changes not journaled yet. They are recorded with the config cache mutex held, hence have
+  // their own mutex
+  std::mutex journal_mutex_;
+  std::vector<MutationEntry> pending_journal_entries_;
+  // Set when the next save must rewrite the config file instead of appending to the journal
+  bool is_config_file_outdated_ = false;
 };
 
 Mutation StorageModule::Modify() {
@@ -122,6 +150,32 @@ void StorageModule::SaveImmediately() {
     pimpl_->config_save_alarm_.Cancel();
     pimpl_->has_pending_config_save_ = false;
   }
+  if (is_journal_enabled_) {
+    std::vector<MutationEntry> entries;
+    bool is_config_file_outdated;
+    {
+      std::lock_guard<std::mutex> journal_lock(pimpl_->journal_mutex_);
+      entries.swap(pimpl_->pending_journal_entries_);
+      is_config_file_outdated = pimpl_->is_config_file_outdated_;
+    }
+    auto journal = ConfigJournal::FromPath(config_journal_path_);
+    if (!is_config_file_outdated && journal.Append(entries) && journal.GetSize() < kMaxConfigJournalSize) {
+      return;
+    }
+  }
+  WriteConfigFiles();
+}
+
+void StorageModule::WriteConfigFiles() {
+  if (is_journal_enabled_) {
+    // Everything recorded so far is part of the config written below. Entries recorded from now on may be
+    // journaled again, which is harmless as replaying them gives the same config.
+    std::lock_guard<std::mutex> journal_lock(pimpl_->journal_mutex_);
+    pimpl_->pending_journal_entries_.clear();
+    pimpl_->is_config_file_outdated_ = false;
+  }
+  // 0. the snapshot is of the config file that is about to be replaced
+  ConfigSnapshot::FromPath(config_snapshot_path_).Delete();
   // 1. rename old config to backup name
   if (os::FileExists(config_file_path_)) {
     ASSERT(os::RenameFile(config_file_path_, config_backup_path_));
@@ -130,7 +184,14 @@ void StorageModule::SaveImmediately() {
   ASSERT(LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_));
   // 3. now write back up to disk as well
   ASSERT(LegacyConfigFile::FromPath(config_backup_path_).Write(pimpl_->cache_));
-  // 4. save checksum if it is running in common criteria mode
+  // 4. both files have the journaled changes now, if this doesn't happen the journal is replayed again on start
+  ConfigJournal::FromPath(config_journal_path_).Delete();
+  // 5. write the snapshot last, so that a snapshot always matches the config file
+  if (is_snapshot_enabled_ &&
+      !ConfigSnapshot::FromPath(config_snapshot_path_).Write(pimpl_->cache_, config_file_path_)) {
+    LOG_WARN("unable to write config snapshot at %s", config_snapshot_path_.c_str());
+  }
+  // 6. save checksum if it is running in common criteria mode
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
       bluetooth::os::ParameterProvider::IsCommonCriteriaMode()) {
     bluetooth::os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(
@@ -154,16 +215,36 @@ void StorageModule::Start() {
     LOG_INFO("%s is true, delete config files", kFactoryResetProperty.c_str());
     LegacyConfigFile::FromPath(config_file_path_).Delete();
     LegacyConfigFile::FromPath(config_backup_path_).Delete();
+    ConfigJournal::FromPath(config_journal_path_).Delete();
+    ConfigSnapshot::FromPath(config_snapshot_path_).Delete();
     os::SetSystemProperty(kFactoryResetProperty, "false");
   }
   if (!is_config_checksum_pass(kConfigFileComparePass)) {
     LegacyConfigFile::FromPath(config_file_path_).Delete();
+    ConfigJournal::FromPath(config_journal_path_).Delete();
+    ConfigSnapshot::FromPath(config_snapshot_path_).Delete();
+  }
+  // The checksum covers the config file only, hence every change has to be written to it
+  if (is_journal_enabled_ && bluetooth::os::ParameterProvider::IsCommonCriteriaMode()) {
+    LOG_INFO("config journal is disabled in common criteria mode");
+    is_journal_enabled_ = false;
   }
   if (!is_config_checksum_pass(kConfigBackupComparePass)) {
     LegacyConfigFile::FromPath(config_backup_path_).Delete();
   }
+  if (!is_snapshot_enabled_) {
+    ConfigSnapshot::FromPath(config_snapshot_path_).Delete();
+  }
   bool save_needed = false;
-  auto config = LegacyConfigFile::FromPath(config_file_path_).Read(temp_devices_capacity_);
+  std::optional<ConfigCache> config;
+  if (is_snapshot_enabled_) {
+    config = ConfigSnapshot::FromPath(config_snapshot_path_).Read(config_file_path_, temp_devices_capacity_);
+  }
+  if (!config) {
+    config = LegacyConfigFile::FromPath(config_file_path_).Read(temp_devices_capacity_);
+    // Write the snapshot that will be loaded on next start
+    save_needed = is_snapshot_enabled_;
+  }
   if (!config || !config->HasSection(kAdapterSection)) {
     LOG_WARN("cannot load config at %s, using backup at %s.", config_file_path_.c_str(), config_backup_path_.c_str());
     config = LegacyConfigFile::FromPath(config_backup_path_).Read(temp_devices_capacity_);
@@ -176,6 +257,12 @@ void StorageModule::Start() {
     config.emplace(temp_devices_capacity_, Device::kLinkKeyProperties);
     file_source = "Empty";
   }
+  // Apply the changes journaled after the config files were last written
+  auto num_journal_entries = ConfigJournal::FromPath(config_journal_path_).Replay(&config.value());
+  if (num_journal_entries) {
+    LOG_INFO("replayed %zu journaled config changes", *num_journal_entries);
+    save_needed = true;
+  }
   if (!file_source.empty()) {
     config->SetProperty(kInfoSection, kFileSourceProperty, std::move(file_source));
   }
@@ -195,6 +282,17 @@ void StorageModule::Start() {
   config->FixDeviceTypeInconsistencies();
   // TODO (b/158035889) Migrate metrics module to GD
   pimpl_ = std::make_unique<impl>(GetHandler(), std::move(config.value()), temp_devices_capacity_);
+  pimpl_->is_config_file_outdated_ = save_needed;
+  if (is_journal_enabled_) {
+    pimpl_->cache_.SetPersistentMutationCallback([this](std::optional<MutationEntry> entry) {
+      std::lock_guard<std::mutex> journal_lock(pimpl_->journal_mutex_);
+      if (entry) {
+        pimpl_->pending_journal_entries_.push_back(std::move(*entry));
+      } else {
+        pimpl_->is_config_file_outdated_ = true;
+      }
+    });
+  }
   if (save_needed) {
     // Set a timer and write the new config file to disk.
     SaveDelayed();
@@ -212,6 +310,10 @@ void StorageModule::Stop() {
     // Save pending changes before stopping the module.
     SaveImmediately();
   }
+  if (is_journal_enabled_ && ConfigJournal::FromPath(config_journal_path_).GetSize() > 0) {
+    // Leave an up to date config file behind
+    WriteConfigFiles();
+  }
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr) {
     bluetooth::os::ParameterProvider::GetBtKeystoreInterface()->clear_map();
   }
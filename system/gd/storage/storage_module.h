@@ -137,12 +137,18 @@ class StorageModule : public bluetooth::Module {
   // - config_save_delay is the duration after which to dump config to disk after SaveDelayed() is called
   // - temp_devices_capacity is the number of temporary, typically unpaired devices to hold in a memory based LRU
   // - is_restricted_mode and is_single_user_mode are flags from upper layer
+  // - is_journal_enabled makes config saves append the changes to a .journal file, the config file is only rewritten
+  //   when the journal grows too large and when the module stops
+  // - is_snapshot_enabled makes config saves also write a binary .snapshot file, which is loaded on start instead
+  //   of parsing the config file when it is still up to date
   StorageModule(
       std::string config_file_path,
       std::chrono::milliseconds config_save_delay,
       size_t temp_devices_capacity,
       bool is_restricted_mode,
-      bool is_single_user_mode);
+      bool is_single_user_mode,
+      bool is_journal_enabled,
+      bool is_snapshot_enabled);
 
   bool HasSection(const std::string& section) const;
   bool HasProperty(const std::string& section, const std::string& property) const;
@@ -180,11 +186,17 @@ class StorageModule : public bluetooth::Module {
   std::unique_ptr<impl> pimpl_;
   std::string config_file_path_;
   std::string config_backup_path_;
+  std::string config_journal_path_;
+  std::string config_snapshot_path_;
   std::chrono::milliseconds config_save_delay_;
   size_t temp_devices_capacity_;
   bool is_restricted_mode_;
   bool is_single_user_mode_;
+  bool is_journal_enabled_;
+  bool is_snapshot_enabled_;
   static bool is_config_checksum_pass(int check_bit);
+  // Write the whole config to the config and backup files, and drop the journal
+  void WriteConfigFiles();
 };
 
 }  // namespace storage
@@ -53,13 +53,17 @@ class TestStorageModule : public StorageModule {
       std::string config_file_path,
       std::chrono::milliseconds config_save_delay,
       bool is_restricted_mode,
-      bool is_single_user_mode)
+      bool is_single_user_mode,
+      bool is_journal_enabled = false,
+      bool is_snapshot_enabled = false)
       : StorageModule(
             std::move(config_file_path),
             config_save_delay,
             kTestTempDevicesCapacity,
             is_restricted_mode,
-            is_single_user_mode) {}
+            is_single_user_mode,
+            is_journal_enabled,
+            is_snapshot_enabled) {}
 
   ConfigCache* GetMemoryOnlyConfigCachePublic() {
     return StorageModule::GetMemoryOnlyConfigCache();
@@ -107,6 +111,8 @@ class StorageModuleTest : public Test {
     temp_dir_ = std::filesystem::temp_directory_path();
     temp_config_ = temp_dir_ / "temp_config.txt";
     temp_backup_config_ = temp_dir_ / "temp_config.bak";
+    temp_journal_ = temp_dir_ / "temp_config.journal";
+    temp_snapshot_ = temp_dir_ / "temp_config.snapshot";
     DeleteConfigFiles();
     ASSERT_FALSE(std::filesystem::exists(temp_config_));
     ASSERT_FALSE(std::filesystem::exists(temp_backup_config_));
@@ -124,6 +130,12 @@ class StorageModuleTest : public Test {
     if (std::filesystem::exists(temp_backup_config_)) {
       ASSERT_TRUE(std::filesystem::remove(temp_backup_config_));
     }
+    if (std::filesystem::exists(temp_journal_)) {
+      ASSERT_TRUE(std::filesystem::remove(temp_journal_));
+    }
+    if (std::filesystem::exists(temp_snapshot_)) {
+      ASSERT_TRUE(std::filesystem::remove(temp_snapshot_));
+    }
   }
 
   void FakeTimerAdvance(std::chrono::milliseconds time) {
@@ -146,6 +158,8 @@ class StorageModuleTest : public Test {
   std::filesystem::path temp_dir_;
   std::filesystem::path temp_config_;
   std::filesystem::path temp_backup_config_;
+  std::filesystem::path temp_journal_;
+  std::filesystem::path temp_snapshot_;
 };
 
 TEST_F(StorageModuleTest, empty_config_no_op_test) {
@@ -331,4 +345,98 @@ TEST_F(StorageModuleTest, no_config_causes_a_write) {
   ASSERT_TRUE(std::filesystem::exists(temp_config_));
 }
 
-}  // namespace testing
\ No newline at end of file
+TEST_F(StorageModuleTest, journaled_save_does_not_rewrite_config) {
+  // Prepare config file
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+
+  // Set up
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false, true);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+
+  // Change a property
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", "name", "foo");
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+
+  // Only the change is written
+  ASSERT_THAT(bluetooth::os::ReadSmallFile(temp_config_.string()), Optional(StrEq(kReadTestConfig)));
+  ASSERT_THAT(
+      bluetooth::os::ReadSmallFile(temp_journal_.string()), Optional(StrEq("S\t01:02:03:ab:cd:ea\tname\tfoo\n")));
+
+  // Tear down
+  test_registry_.StopAll();
+
+  // The journal is compacted into the config file on stop
+  ASSERT_FALSE(std::filesystem::exists(temp_journal_));
+  auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  ASSERT_TRUE(config);
+  ASSERT_THAT(config->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+}
+
+TEST_F(StorageModuleTest, journal_is_replayed_on_start) {
+  // Prepare config file and the journal left by a crash
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_journal_.string(), "S\t01:02:03:ab:cd:ea\tname\tfoo\nR\tMetr"));
+
+  // Set up
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false, true);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+
+  // The partially written entry is ignored
+  ASSERT_THAT(storage->GetPropertyPublic("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+  ASSERT_TRUE(storage->HasSectionPublic("Metrics"));
+
+  // The config file is rewritten with the journaled changes
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+  ASSERT_FALSE(std::filesystem::exists(temp_journal_));
+  auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  ASSERT_TRUE(config);
+  ASSERT_THAT(config->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+
+  // Tear down
+  test_registry_.StopAll();
+}
+
+TEST_F(StorageModuleTest, snapshot_is_loaded_on_start) {
+  // Prepare config file
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+
+  // The first start writes the snapshot
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false, false, true);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+  test_registry_.StopAll();
+  ASSERT_TRUE(std::filesystem::exists(temp_snapshot_));
+  auto config_content = bluetooth::os::ReadSmallFile(temp_config_.string());
+  ASSERT_TRUE(config_content);
+
+  // The next start loads the snapshot, and has no reason to write the config
+  storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false, false, true);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+  ASSERT_THAT(storage->GetPropertyPublic("01:02:03:ab:cd:ea", "name"), Optional(StrEq("hello world")));
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+  test_registry_.StopAll();
+  ASSERT_THAT(bluetooth::os::ReadSmallFile(temp_config_.string()), Optional(StrEq(*config_content)));
+}
+
+TEST_F(StorageModuleTest, outdated_snapshot_is_ignored) {
+  // Prepare config file
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false, false, true);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+  test_registry_.StopAll();
+  ASSERT_TRUE(std::filesystem::exists(temp_snapshot_));
+
+  // Config file changed behind the snapshot
+  auto config_content = bluetooth::os::ReadSmallFile(temp_config_.string());
+  ASSERT_TRUE(config_content);
+  *config_content += "[01:02:03:ab:cd:eb]\nname = foo\nLinkKey = fedcba0987654321fedcba0987654329\n";
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), *config_content));
+
+  storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false, false, true);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+  ASSERT_THAT(storage->GetPropertyPublic("01:02:03:ab:cd:eb", "name"), Optional(StrEq("foo")));
+  test_registry_.StopAll();
+}
+
+}  // namespace testing
@@ -124,6 +124,16 @@ typedef void (*register_for_notification_callback)(int conn_id, int registered,
 typedef void (*notify_callback)(int conn_id,
                                 const btgatt_notify_params_t& p_data);
 
+/**
+ * Remote device notifications callback, invoked instead of notify_callback
+ * for the clients which enabled notification batching. Delivers |count|
+ * notifications, in the order they were received, the connection of each one
+ * being given in |conn_ids|.
+ */
+typedef void (*notify_batch_callback)(const int* conn_ids,
+                                      const btgatt_notify_params_t* p_data,
+                                      int count);
+
 /** Reports result of a GATT read operation */
 typedef void (*read_characteristic_callback)(int conn_id, int status,
                                              btgatt_read_params_t* p_data);
@@ -214,6 +224,7 @@ typedef struct {
   conn_updated_callback conn_updated_cb;
   service_changed_callback service_changed_cb;
   subrate_change_callback subrate_chg_cb;
+  notify_batch_callback notify_batch_cb;
 } btgatt_client_callbacks_t;
 
 /** Represents the standard BT-GATT client interface. */
@@ -324,6 +335,11 @@ typedef struct {
                                  int subrate_max, int max_latency, int cont_num,
                                  int timeout);
 
+  /** Delivers the notifications of a client in batches through
+   * notify_batch_cb, rather than one by one through notify_cb. Indications are
+   * always delivered one by one. */
+  bt_status_t (*set_notification_batching)(int client_if, bool enable);
+
 } btgatt_client_interface_t;
 
 __END_DECLS
@@ -578,6 +578,12 @@
 #define SMP_MAX_ENC_KEY_SIZE 16
 #endif
 
+/* The number of LE pairings SMP can run at the same time, with different
+ * devices. The pairings over BR/EDR only use the first control block. */
+#ifndef SMP_MAX_CONCURRENT_PAIRINGS
+#define SMP_MAX_CONCURRENT_PAIRINGS 4
+#endif
+
 /* minimum link timeout after SMP pairing is done, leave room for key exchange
    and racing condition for the following service connection.
    Prefer greater than 0 second, and no less than default inactivity link idle
@@ -721,6 +727,15 @@
 #define PORT_TX_BUF_CRITICAL_WM 15
 #endif
 
+/* The number of credits a port delivering data through a callout can be
+ * granted at most, in number of buffers. The credits granted grow towards it
+ * while the consumer keeps up, and fall back when it pushes back. Such ports
+ * do not queue received data, so they are not bounded by
+ * PORT_RX_BUF_CRITICAL_WM. Must not exceed 255. */
+#ifndef PORT_RX_BUF_CO_MAX_CREDITS
+#define PORT_RX_BUF_CO_MAX_CREDITS 40
+#endif
+
 /* The RFCOMM multiplexer preferred flow control mechanism. */
 #ifndef PORT_FC_DEFAULT
 #define PORT_FC_DEFAULT PORT_FC_CREDIT
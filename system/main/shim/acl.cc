@@ -33,9 +33,11 @@
 #include "btif/include/btif_hh.h"
 #include "common/interfaces/ILoggable.h"
 #include "device/include/controller.h"
+#include "device/include/interop.h"
 #include "gd/common/bidi_queue.h"
 #include "gd/common/bind.h"
 #include "gd/common/init_flags.h"
+#include "gd/common/packet_latency_trace.h"
 #include "gd/common/strings.h"
 #include "gd/common/sync_map_count.h"
 #include "gd/hci/acl_manager.h"
@@ -426,6 +428,9 @@ class ShimAclConnection {
 
   void data_ready_callback() {
     auto packet = queue_up_end_->TryDequeue();
+    uint32_t latency_sample = packet->GetLatencySample();
+    bluetooth::common::PacketLatencyTrace::Record(
+        latency_sample, bluetooth::common::PacketLatencyStage::ACL_ASSEMBLER);
     uint16_t length = packet->size();
     std::vector<uint8_t> preamble;
     preamble.push_back(LowByte(handle_));
@@ -435,6 +440,7 @@ class ShimAclConnection {
     BT_HDR* p_buf = MakeLegacyBtHdrPacket(std::move(packet), preamble);
     ASSERT_LOG(p_buf != nullptr,
                "Unable to allocate BT_HDR legacy packet handle:%04x", handle_);
+    bluetooth::common::PacketLatencyTrace::TagBuffer(p_buf, latency_sample);
     if (send_data_upwards_ == nullptr) {
       LOG_WARN("Dropping ACL data with no callback");
       osi_free(p_buf);
@@ -1736,6 +1742,14 @@ void shim::legacy::Acl::OnLeConnectSuccess(
   pimpl_->handle_to_le_connection_map_[handle]
       ->ReadRemoteControllerInformation();
 
+  RawAddress connection_addr = ToRawAddress(address_with_type.GetAddress());
+  RawAddress peer_addr = ToRawAddress(peer_address_with_type.GetAddress());
+  if (interop_match_addr(INTEROP_DISABLE_LE_AUTO_LINK_UPGRADE,
+                         &connection_addr) ||
+      interop_match_addr(INTEROP_DISABLE_LE_AUTO_LINK_UPGRADE, &peer_addr)) {
+    GetAclManager()->SetLeLinkAutoUpgradeAllowed(handle, false);
+  }
+
   tBLE_BD_ADDR legacy_address_with_type =
       ToLegacyAddressWithType(address_with_type);
 
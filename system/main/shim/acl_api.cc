@@ -159,6 +159,33 @@ void bluetooth::shim::ACL_LeSubrateRequest(
       hci_handle, subrate_min, subrate_max, max_latency, cont_num, sup_tout);
 }
 
+void bluetooth::shim::ACL_SetLeTxCreditReservation(uint16_t hci_handle,
+                                                   uint16_t credits) {
+  Stack::GetInstance()
+      ->GetStackManager()
+      ->GetInstance<bluetooth::hci::AclManager>()
+      ->SetLeAclTxCreditReservation(hci_handle, credits);
+}
+
+void bluetooth::shim::ACL_RequestLeLinkProfile(uint16_t hci_handle,
+                                               const std::string& client,
+                                               uint8_t profile) {
+  Stack::GetInstance()
+      ->GetStackManager()
+      ->GetInstance<bluetooth::hci::AclManager>()
+      ->RequestLeLinkProfile(
+          hci_handle, client,
+          static_cast<bluetooth::hci::acl_manager::LinkProfile>(profile));
+}
+
+void bluetooth::shim::ACL_ReleaseLeLinkProfile(uint16_t hci_handle,
+                                               const std::string& client) {
+  Stack::GetInstance()
+      ->GetStackManager()
+      ->GetInstance<bluetooth::hci::AclManager>()
+      ->ReleaseLeLinkProfile(hci_handle, client);
+}
+
 void bluetooth::shim::ACL_RemoteNameRequest(const RawAddress& addr,
                                             uint8_t page_scan_rep_mode,
                                             uint8_t page_scan_mode,
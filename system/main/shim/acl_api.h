@@ -17,6 +17,7 @@
 #pragma once
 
 #include <optional>
+#include <string>
 
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
@@ -60,6 +61,13 @@ void ACL_LeSubrateRequest(uint16_t hci_handle, uint16_t subrate_min,
                           uint16_t subrate_max, uint16_t max_latency,
                           uint16_t cont_num, uint16_t sup_tout);
 
+void ACL_SetLeTxCreditReservation(uint16_t hci_handle, uint16_t credits);
+
+// |profile| is a bluetooth::hci::acl_manager::LinkProfile value
+void ACL_RequestLeLinkProfile(uint16_t hci_handle, const std::string& client,
+                              uint8_t profile);
+void ACL_ReleaseLeLinkProfile(uint16_t hci_handle, const std::string& client);
+
 void ACL_RemoteNameRequest(const RawAddress& bd_addr,
                            uint8_t page_scan_rep_mode, uint8_t page_scan_mode,
                            uint16_t clock_offset);
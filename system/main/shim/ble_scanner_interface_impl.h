@@ -19,6 +19,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <set>
 
@@ -107,6 +108,7 @@ class BleScannerInterfaceImpl : public ::BleScannerInterface,
                     int8_t tx_power, int8_t rssi,
                     uint16_t periodic_advertising_interval,
                     std::vector<uint8_t> advertising_data) override;
+  void OnScanResults(std::vector<bluetooth::hci::ScanResult> results) override;
   void OnTrackAdvFoundLost(bluetooth::hci::AdvertisingFilterOnFoundOnLostInfo
                                on_found_on_lost_info) override;
   void OnBatchScanReports(int client_if, int status, int report_format,
@@ -147,6 +149,18 @@ class BleScannerInterfaceImpl : public ::BleScannerInterface,
   void handle_remote_properties(RawAddress bd_addr, tBLE_ADDR_TYPE addr_type,
                                 std::vector<uint8_t> advertising_data);
 
+  struct LegacyScanResult {
+    bluetooth::hci::ScanResult result;
+    RawAddress raw_address;
+    tBLE_ADDR_TYPE ble_addr_type;
+  };
+  void handle_scan_results(std::vector<LegacyScanResult> results);
+
+  // Batches posted to the jni thread and not handled yet
+  std::atomic<size_t> pending_scan_result_batches_{0};
+  // Batches posted while the jni thread was still behind on a previous one
+  size_t lagging_scan_result_batches_ = 0;
+
   class AddressCache {
    public:
     void init(void);
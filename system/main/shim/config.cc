@@ -29,6 +29,7 @@
 
 using ::bluetooth::shim::GetStorage;
 using ::bluetooth::storage::ConfigCacheHelper;
+using ::bluetooth::storage::MutationEntry;
 
 namespace bluetooth {
 namespace shim {
@@ -108,6 +109,18 @@ bool BtifConfigInterface::SetStr(const std::string& section,
   return true;
 }
 
+bool BtifConfigInterface::SetStrs(
+    const std::string& section,
+    const std::vector<std::pair<std::string, std::string>>& properties) {
+  auto mutation = GetStorage()->Modify();
+  for (const auto& [property, value] : properties) {
+    mutation.Add(MutationEntry::Set(MutationEntry::PropertyType::NORMAL,
+                                    section, property, value));
+  }
+  mutation.Commit();
+  return true;
+}
+
 // TODO: implement encrypted read
 bool BtifConfigInterface::GetBin(const std::string& section,
                                  const std::string& property, uint8_t* value,
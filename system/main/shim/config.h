@@ -19,6 +19,7 @@
 #include <list>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace bluetooth {
@@ -44,6 +45,10 @@ class BtifConfigInterface {
                                            const std::string& key);
   static bool SetStr(const std::string& section, const std::string& key,
                      const std::string& value);
+  // Sets all the |properties| of |section| in one storage mutation
+  static bool SetStrs(
+      const std::string& section,
+      const std::vector<std::pair<std::string, std::string>>& properties);
   static bool GetBin(const std::string& section, const std::string& key,
                      uint8_t* value, size_t* length);
   static size_t GetBinLength(const std::string& section,
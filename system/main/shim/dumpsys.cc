@@ -18,6 +18,7 @@
 
 #include "main/shim/dumpsys.h"
 
+#include <functional>
 #include <unordered_map>
 
 #include "main/shim/entry.h"
@@ -54,10 +55,13 @@ void bluetooth::shim::Dump(int fd, const char** args) {
       dumpsys.second(fd);
     }
   }
-  bluetooth::shim::Stack::GetInstance()->LockForDumpsys([=]() {
+  /* Only the request for a snapshot is made with the stack locked, the
+   * snapshot is printed once the stack is unlocked */
+  std::function<void(int)> print_snapshot;
+  bluetooth::shim::Stack::GetInstance()->LockForDumpsys([&]() {
     if (bluetooth::shim::is_gd_stack_started_up()) {
       if (bluetooth::shim::is_gd_dumpsys_module_started()) {
-        bluetooth::shim::GetDumpsys()->Dump(fd, args);
+        print_snapshot = bluetooth::shim::GetDumpsys()->Snapshot();
       } else {
         dprintf(fd, "%s NOTE: gd dumpsys module not loaded or started\n",
                 kModuleName);
@@ -66,4 +70,5 @@ void bluetooth::shim::Dump(int fd, const char** args) {
       dprintf(fd, "%s gd stack is enabled but not started\n", kModuleName);
     }
   });
+  if (print_snapshot) print_snapshot(fd);
 }
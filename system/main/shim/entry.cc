@@ -41,128 +41,87 @@
 namespace bluetooth {
 namespace shim {
 
+namespace {
+// The stack manager caches each started module, so this doesn't look the
+// module up again on each call
+template <class T>
+T* GetModule() {
+  return Stack::GetInstance()->GetStackManager()->GetInstance<T>();
+}
+}  // namespace
+
 os::Handler* GetGdShimHandler() { return Stack::GetInstance()->GetHandler(); }
 
 hci::LeAdvertisingManager* GetAdvertising() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hci::LeAdvertisingManager>();
+  return GetModule<hci::LeAdvertisingManager>();
 }
 
-hci::Controller* GetController() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hci::Controller>();
-}
+hci::Controller* GetController() { return GetModule<hci::Controller>(); }
 
 neighbor::ConnectabilityModule* GetConnectability() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<neighbor::ConnectabilityModule>();
+  return GetModule<neighbor::ConnectabilityModule>();
 }
 
 neighbor::DiscoverabilityModule* GetDiscoverability() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<neighbor::DiscoverabilityModule>();
+  return GetModule<neighbor::DiscoverabilityModule>();
 }
 
-Dumpsys* GetDumpsys() {
-  return Stack::GetInstance()->GetStackManager()->GetInstance<Dumpsys>();
-}
+Dumpsys* GetDumpsys() { return GetModule<Dumpsys>(); }
 
 neighbor::InquiryModule* GetInquiry() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<neighbor::InquiryModule>();
+  return GetModule<neighbor::InquiryModule>();
 }
 
-hci::HciLayer* GetHciLayer() {
-  return Stack::GetInstance()->GetStackManager()->GetInstance<hci::HciLayer>();
-}
+hci::HciLayer* GetHciLayer() { return GetModule<hci::HciLayer>(); }
 
 l2cap::classic::L2capClassicModule* GetL2capClassicModule() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<bluetooth::l2cap::classic::L2capClassicModule>();
+  return GetModule<bluetooth::l2cap::classic::L2capClassicModule>();
 }
 
 bluetooth::l2cap::le::L2capLeModule* GetL2capLeModule() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<bluetooth::l2cap::le::L2capLeModule>();
+  return GetModule<bluetooth::l2cap::le::L2capLeModule>();
 }
 
-neighbor::PageModule* GetPage() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<neighbor::PageModule>();
-}
+neighbor::PageModule* GetPage() { return GetModule<neighbor::PageModule>(); }
 
 hci::RemoteNameRequestModule* GetRemoteNameRequest() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hci::RemoteNameRequestModule>();
+  return GetModule<hci::RemoteNameRequestModule>();
 }
 
 hci::LeScanningManager* GetScanning() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hci::LeScanningManager>();
+  return GetModule<hci::LeScanningManager>();
 }
 
 hci::DistanceMeasurementManager* GetDistanceMeasurementManager() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hci::DistanceMeasurementManager>();
+  return GetModule<hci::DistanceMeasurementManager>();
 }
 
 security::SecurityModule* GetSecurityModule() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<security::SecurityModule>();
+  return GetModule<security::SecurityModule>();
 }
 
-hal::SnoopLogger* GetSnoopLogger() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hal::SnoopLogger>();
-}
+hal::SnoopLogger* GetSnoopLogger() { return GetModule<hal::SnoopLogger>(); }
 
 storage::StorageModule* GetStorage() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<storage::StorageModule>();
+  return GetModule<storage::StorageModule>();
 }
 
-hci::AclManager* GetAclManager() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hci::AclManager>();
-}
+hci::AclManager* GetAclManager() { return GetModule<hci::AclManager>(); }
 
 hci::VendorSpecificEventManager* GetVendorSpecificEventManager() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hci::VendorSpecificEventManager>();
+  return GetModule<hci::VendorSpecificEventManager>();
 }
 
 activity_attribution::ActivityAttribution* GetActivityAttribution() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<activity_attribution::ActivityAttribution>();
+  return GetModule<activity_attribution::ActivityAttribution>();
 }
 
 metrics::CounterMetrics* GetCounterMetrics() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<metrics::CounterMetrics>();
+  return GetModule<metrics::CounterMetrics>();
 }
 
 hci::MsftExtensionManager* GetMsftExtensionManager() {
-  return Stack::GetInstance()
-      ->GetStackManager()
-      ->GetInstance<hci::MsftExtensionManager>();
+  return GetModule<hci::MsftExtensionManager>();
 }
 
 }  // namespace shim
@@ -36,6 +36,7 @@
 #include "packet/raw_builder.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
+#include "stack/include/btm_iso_api.h"
 #include "stack/include/hcimsgs.h"
 
 /**
@@ -298,7 +299,7 @@ static BT_HDR* WrapPacketAndCopy(
     uint16_t event,
     bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>* data) {
   size_t packet_size = data->size() + kBtHdrSize;
-  BT_HDR* packet = reinterpret_cast<BT_HDR*>(osi_malloc(packet_size));
+  BT_HDR* packet = reinterpret_cast<BT_HDR*>(osi_malloc_packet(packet_size));
   packet->offset = 0;
   packet->len = data->size();
   packet->layer_specific = 0;
@@ -613,7 +614,12 @@ static void transmit_fragment(BT_HDR* packet, bool send_transmit_finished) {
   }
 
   if (free_after_transmit) {
-    osi_free(packet);
+    if (event == MSG_STACK_TO_HC_HCI_ISO &&
+        (packet->layer_specific & BT_ISO_HDR_FROM_SDU_POOL)) {
+      bluetooth::hci::IsoManager::GetInstance()->ReleaseIsoSdu(packet);
+    } else {
+      osi_free(packet);
+    }
   }
 }
 static void dispatch_reassembled(BT_HDR* packet) {
@@ -120,8 +120,8 @@ inline BT_HDR* MakeLegacyBtHdrPacket(
         packet,
     const std::vector<uint8_t>& preamble) {
   std::vector<uint8_t> packet_vector(packet->begin(), packet->end());
-  BT_HDR* buffer = static_cast<BT_HDR*>(
-      osi_calloc(packet_vector.size() + preamble.size() + sizeof(BT_HDR)));
+  BT_HDR* buffer = static_cast<BT_HDR*>(osi_calloc_packet(
+      packet_vector.size() + preamble.size() + sizeof(BT_HDR)));
   std::copy(preamble.begin(), preamble.end(), buffer->data);
   std::copy(packet_vector.begin(), packet_vector.end(),
             buffer->data + preamble.size());
@@ -62,6 +62,7 @@ constexpr uint8_t kFilterLogicAnd = 0x01;
 constexpr uint8_t kLowestRssiValue = 129;
 constexpr uint16_t kAllowAllFilter = 0x00;
 constexpr uint16_t kListLogicOr = 0x01;
+constexpr size_t kScanResultBatchesLagWarning = 8;
 
 class DefaultScanningCallback : public ::ScanningCallbacks {
   void OnScannerRegistered(const bluetooth::Uuid app_uuid, uint8_t scanner_id,
@@ -536,6 +537,64 @@ void BleScannerInterfaceImpl::OnScanResult(
       advertising_data);
 }
 
+void BleScannerInterfaceImpl::OnScanResults(
+    std::vector<bluetooth::hci::ScanResult> results) {
+  std::vector<LegacyScanResult> legacy_results;
+  legacy_results.reserve(results.size());
+  for (auto& result : results) {
+    RawAddress raw_address = ToRawAddress(result.address);
+    tBLE_ADDR_TYPE ble_addr_type = to_ble_addr_type(result.address_type);
+
+    btm_cb.neighbor.le_scan.results++;
+    if (ble_addr_type != BLE_ADDR_ANONYMOUS) {
+      btm_ble_process_adv_addr(raw_address, &ble_addr_type);
+    }
+
+    // TODO: Remove when StartInquiry in GD part implemented
+    btm_ble_process_adv_pkt_cont_for_inquiry(
+        result.event_type, ble_addr_type, raw_address, result.primary_phy,
+        result.secondary_phy, result.advertising_sid, result.tx_power,
+        result.rssi, result.periodic_advertising_interval,
+        result.advertising_data);
+
+    legacy_results.push_back({std::move(result), raw_address, ble_addr_type});
+  }
+
+  size_t pending = ++pending_scan_result_batches_;
+  if (pending > 1) {
+    lagging_scan_result_batches_++;
+    if (pending == kScanResultBatchesLagWarning) {
+      LOG_WARN("%zu scan result batches pending on the jni thread, %zu lagged",
+               pending, lagging_scan_result_batches_);
+    }
+  }
+
+  // One task for the whole batch instead of two per result. Scan results can
+  // be dropped when the JNI thread is behind, the state events can't.
+  if (do_in_jni_thread_bulk(base::BindOnce(
+          &BleScannerInterfaceImpl::handle_scan_results, base::Unretained(this),
+          std::move(legacy_results))) != BT_STATUS_SUCCESS) {
+    pending_scan_result_batches_--;
+  }
+}
+
+void BleScannerInterfaceImpl::handle_scan_results(
+    std::vector<LegacyScanResult> results) {
+  pending_scan_result_batches_--;
+  for (auto& legacy_result : results) {
+    auto& result = legacy_result.result;
+    handle_remote_properties(legacy_result.raw_address,
+                             legacy_result.ble_addr_type,
+                             result.advertising_data);
+    scanning_callbacks_->OnScanResult(
+        result.event_type, static_cast<uint8_t>(result.address_type),
+        legacy_result.raw_address, result.primary_phy, result.secondary_phy,
+        result.advertising_sid, result.tx_power, result.rssi,
+        result.periodic_advertising_interval,
+        std::move(result.advertising_data));
+  }
+}
+
 void BleScannerInterfaceImpl::OnTrackAdvFoundLost(
     bluetooth::hci::AdvertisingFilterOnFoundOnLostInfo on_found_on_lost_info) {
   AdvertisingTrackInfo track_info = {};
@@ -619,8 +678,7 @@ void BleScannerInterfaceImpl::OnPeriodicSyncReport(uint16_t sync_handle,
                                                    int8_t tx_power, int8_t rssi,
                                                    uint8_t status,
                                                    std::vector<uint8_t> data) {
-  do_in_jni_thread(
-      FROM_HERE,
+  do_in_jni_thread_bulk(
       base::BindOnce(&ScanningCallbacks::OnPeriodicSyncReport,
                      base::Unretained(scanning_callbacks_), sync_handle,
                      tx_power, rssi, status, std::move(data)));
@@ -802,19 +860,15 @@ void BleScannerInterfaceImpl::handle_remote_properties(
   auto* storage_module = bluetooth::shim::GetStorage();
   bluetooth::hci::Address address = ToGdAddress(bd_addr);
 
-  // update device type
+  // update device type and address type in one mutation
   auto mutation = storage_module->Modify();
   bluetooth::storage::Device device =
       storage_module->GetDeviceByLegacyKey(address);
   mutation.Add(device.SetDeviceType(device_type));
-  mutation.Commit();
-
-  // update address type
-  auto mutation2 = storage_module->Modify();
   bluetooth::storage::LeDevice le_device = device.Le();
-  mutation2.Add(
+  mutation.Add(
       le_device.SetAddressType((bluetooth::hci::AddressType)addr_type));
-  mutation2.Commit();
+  mutation.Commit();
 }
 
 void BleScannerInterfaceImpl::AddressCache::add(const RawAddress& p_bda) {
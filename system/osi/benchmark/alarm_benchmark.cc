@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/init_flags.h"
+#include "common/message_loop_thread.h"
+#include "osi/include/alarm.h"
+#include "osi/include/osi.h"
+
+using ::benchmark::State;
+
+bluetooth::common::MessageLoopThread* get_main_thread() { return nullptr; }
+
+static void alarm_cb(UNUSED_ATTR void* data) {}
+
+// Sets then cancels many pending alarms, with the list (range(0) == 0) or the
+// heap (range(0) == 1) of pending alarms, and range(1) alarms.
+class BM_OsiAlarm : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    const char* list_flags[] = {nullptr};
+    const char* heap_flags[] = {"INIT_osi_alarm_heap=true", nullptr};
+    bluetooth::common::InitFlags::Load(st.range(0) ? heap_flags : list_flags);
+
+    std::mt19937 generator(0);
+    // Far enough in the future that no alarm fires during the benchmark.
+    std::uniform_int_distribution<uint64_t> interval_ms(60000, 120000);
+    for (int64_t i = 0; i < st.range(1); i++) {
+      alarms_.push_back(alarm_new(
+          ("alarm_benchmark[" + std::to_string(i) + "]").c_str()));
+      intervals_ms_.push_back(interval_ms(generator));
+    }
+  }
+
+  void TearDown(State& st) override {
+    for (alarm_t* alarm : alarms_) alarm_free(alarm);
+    alarms_.clear();
+    intervals_ms_.clear();
+    alarm_cleanup();
+    bluetooth::common::InitFlags::Load(nullptr);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  std::vector<alarm_t*> alarms_;
+  std::vector<uint64_t> intervals_ms_;
+};
+
+BENCHMARK_DEFINE_F(BM_OsiAlarm, set_cancel)(State& state) {
+  for (auto _ : state) {
+    for (size_t i = 0; i < alarms_.size(); i++) {
+      alarm_set(alarms_[i], intervals_ms_[i], alarm_cb, nullptr);
+    }
+    for (alarm_t* alarm : alarms_) alarm_cancel(alarm);
+  }
+  state.SetItemsProcessed(state.iterations() * alarms_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_OsiAlarm, set_cancel)
+    ->ArgsProduct({{0, 1}, {16, 128, 512, 2048}});
+
+// Reschedules each alarm while all the others are pending, as per connection
+// timers do when traffic restarts them.
+BENCHMARK_DEFINE_F(BM_OsiAlarm, reschedule)(State& state) {
+  for (size_t i = 0; i < alarms_.size(); i++) {
+    alarm_set(alarms_[i], intervals_ms_[i], alarm_cb, nullptr);
+  }
+  for (auto _ : state) {
+    for (size_t i = 0; i < alarms_.size(); i++) {
+      alarm_set(alarms_[i], intervals_ms_[alarms_.size() - i - 1], alarm_cb,
+                nullptr);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * alarms_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_OsiAlarm, reschedule)
+    ->ArgsProduct({{0, 1}, {16, 128, 512, 2048}});
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
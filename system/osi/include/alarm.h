@@ -79,6 +79,20 @@ void alarm_set(alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
 void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
                         alarm_callback_t cb, void* data);
 
+// Sets an |alarm| like |alarm_set|, except that the callback may be delayed
+// by up to |slack_ms| after |interval_ms|. The alarm expiration is aligned so
+// that alarms with overlapping slack windows expire together, saving wakeups
+// and wakelock acquisitions. Use it for timeouts that don't need millisecond
+// precision.
+void alarm_set_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                          uint64_t slack_ms, alarm_callback_t cb, void* data);
+
+// Same as |alarm_set_with_slack| except that the |cb| callback is scheduled
+// for execution in the context of the main message loop.
+void alarm_set_on_mloop_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                                   uint64_t slack_ms, alarm_callback_t cb,
+                                   void* data);
+
 // This function cancels the |alarm| if it was previously set.
 // When this call returns, the caller has a guarantee that the
 // callback is not in progress and will not be called if it
@@ -29,6 +29,13 @@ typedef uint8_t allocator_id_t;
 // the allocation tracker functions do nothing but are still safe to call.
 void allocation_tracker_init(void);
 
+// Initialize the sampling allocation tracker, cheap enough for production
+// builds. One allocation in |sample_rate| of each thread is recorded with its
+// callsite, and the live octets of the callsites are estimated from them. It
+// does nothing if |sample_rate| is 0 or the allocation tracker is initialized.
+// Like |allocation_tracker_init|, it must be called before any allocation.
+void allocation_tracker_init_sampling(uint32_t sample_rate);
+
 // Reset the allocation tracker. Don't call this in the normal course of
 // operations. Useful mostly for testing.
 void allocation_tracker_reset(void);
@@ -43,9 +50,11 @@ size_t allocation_tracker_expect_no_allocations(void);
 // size of the allocation without any canaries. The caller must allocate
 // enough memory for canaries; the total allocation size can be determined
 // by calling |allocation_tracker_resize_for_canary|. Returns |ptr| offset
-// to the the beginning of the uncanaried region.
+// to the the beginning of the uncanaried region. |callsite| is the code
+// address the live octets are reported for.
 void* allocation_tracker_notify_alloc(allocator_id_t allocator_id, void* ptr,
-                                      size_t requested_size);
+                                      size_t requested_size,
+                                      const void* callsite = NULL);
 
 // Notify the tracker of an allocation that is being freed. |ptr| must be a
 // pointer returned by a call to |allocation_tracker_notify_alloc| with the
@@ -55,5 +64,5 @@ void* allocation_tracker_notify_alloc(allocator_id_t allocator_id, void* ptr,
 void* allocation_tracker_notify_free(allocator_id_t allocator_id, void* ptr);
 
 // Get the full size for an allocation, taking into account the size of
-// canaries.
+// canaries, or of the header of the sampling allocation tracker.
 size_t allocation_tracker_resize_for_canary(size_t size);
@@ -41,6 +41,14 @@ void* osi_malloc(size_t size);
 void* osi_calloc(size_t size);
 void osi_free(void* ptr);
 
+// Allocate a packet buffer (BT_HDR) of |size| bytes. Small buffers are taken
+// from per-thread size class pools, which avoids the malloc churn of the
+// packets exchanged on the data paths, and larger ones or those allocated
+// once the pools are exhausted from |osi_malloc| or |osi_calloc|. The buffer
+// is released with |osi_free| like any other.
+void* osi_malloc_packet(size_t size);
+void* osi_calloc_packet(size_t size);
+
 // Free a buffer that was previously allocated with function |osi_malloc|
 // or |osi_calloc| and reset the pointer to that buffer to NULL.
 // |p_ptr| is a pointer to the buffer pointer to be reset.
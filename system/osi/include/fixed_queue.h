@@ -36,6 +36,22 @@ typedef void (*fixed_queue_cb)(fixed_queue_t* queue, void* context);
 // the returned queue with |fixed_queue_free|.
 fixed_queue_t* fixed_queue_new(size_t capacity);
 
+// Largest capacity of the queues created by |fixed_queue_new_ring|.
+#define FIXED_QUEUE_RING_MAX_CAPACITY (1 << 16)
+
+// Creates a new fixed queue backed by a lock-free ring of at least |capacity|
+// elements, rounded up to a power of two. |capacity| must be in
+// [1, FIXED_QUEUE_RING_MAX_CAPACITY]. Enqueues and dequeues take no lock and
+// no syscall, except for a single eventfd write per batch of elements
+// enqueued while the consumer is not draining the queue. When registered for
+// dequeue, the callback is invoked for all the elements of a batch in a row,
+// and must not free the queue.
+// |fixed_queue_try_peek_last|, |fixed_queue_try_remove_from_queue|,
+// |fixed_queue_get_list| and |fixed_queue_get_enqueue_fd| are not supported
+// on these queues. Returns NULL on failure. The caller must free the returned
+// queue with |fixed_queue_free|.
+fixed_queue_t* fixed_queue_new_ring(size_t capacity);
+
 // Frees a queue and (optionally) the enqueued elements.
 // |queue| is the queue to free. If the |free_cb| callback is not null,
 // it is called on each queue element to free it.
@@ -32,6 +32,13 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts);
 // Return true on success, otherwise false.
 bool wakelock_acquire(void);
 
+// Acquire the Bluetooth wakelock on behalf of |source|, such as the name of
+// the alarm or the profile that needs the system awake. The time until the
+// next release is accounted to |source| in the debug dump.
+// The function is thread safe.
+// Return true on success, otherwise false.
+bool wakelock_acquire_for(const char* source);
+
 // Release the Bluetooth wakelock.
 // The function is thread safe.
 // Return true on success, otherwise false.
@@ -0,0 +1,47 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#ifndef LIB_OSI_INTERNAL
+#error "Please do not include this outside of osi."
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Size class pools backing |osi_malloc_packet| and |osi_calloc_packet|.
+// Each size class owns a fixed number of slots in a single reserved region.
+// Every thread caches a few free slots per class, so that allocating and
+// freeing packets on the same thread doesn't take the pool lock.
+
+// Returns a slot of the smallest size class holding |size| bytes, or NULL
+// if |size| is larger than the largest class or the pool of that class is
+// exhausted. The content of the slot is undefined.
+void* packet_pool_alloc(size_t size);
+
+// Returns true if |ptr| points into a slot returned by |packet_pool_alloc|.
+// |ptr| may be NULL.
+bool packet_pool_owns(const void* ptr);
+
+// Returns the slot containing |ptr| to its pool. |ptr| must be owned by the
+// packet pool, see |packet_pool_owns|.
+void packet_pool_free(void* ptr);
+
+// Dump the statistics of each size class to the |fd| file descriptor.
+void packet_pool_debug_dump(int fd);
@@ -36,8 +36,11 @@
 #include <hardware/bluetooth.h>
 
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include "check.h"
+#include "common/init_flags.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/list.h"
@@ -93,6 +96,7 @@ struct alarm_t {
   std::shared_ptr<std::recursive_mutex> callback_mutex;
   uint64_t creation_time_ms;
   uint64_t period_ms;
+  uint64_t slack_ms;  // Tolerated delay of the deadline, 0 if none
   uint64_t deadline_ms;
   uint64_t prev_deadline_ms;  // Previous deadline - used for accounting of
                               // periodic timers
@@ -104,8 +108,16 @@ struct alarm_t {
 
   bool for_msg_loop;  // True, if the alarm should be processed on message loop
   CancelableClosureInStruct closure;  // posted to message loop for processing
+
+  // Position of the alarm in |alarm_heap|, or ALARM_NOT_PENDING.
+  size_t heap_index;
+  // Order in which the alarm was scheduled, breaks the ties between alarms
+  // with the same deadline in |alarm_heap|.
+  uint64_t sequence;
 };
 
+static const size_t ALARM_NOT_PENDING = SIZE_MAX;
+
 // If the next wakeup time is less than this threshold, we should acquire
 // a wakelock instead of setting a wake alarm so we're not bouncing in
 // and out of suspend frequently. This value is externally visible to allow
@@ -115,9 +127,24 @@ static const clockid_t CLOCK_ID = CLOCK_BOOTTIME;
 
 // This mutex ensures that the |alarm_set|, |alarm_cancel|, and alarm callback
 // functions execute serially and not concurrently. As a result, this mutex
-// also protects the |alarms| list.
+// also protects the |alarms| list and the |alarm_heap|.
 static std::mutex alarms_mutex;
+// Pending alarms sorted by deadline. The list is allocated while the alarms
+// are initialized, but only holds the pending alarms if |use_alarm_heap| is
+// false.
 static list_t* alarms;
+// With the osi_alarm_heap init flag, the pending alarms are kept in a binary
+// min-heap ordered by deadline instead, where each alarm knows its position.
+// Setting and canceling an alarm is then O(log n) instead of O(n) with many
+// pending alarms.
+static bool use_alarm_heap;
+static std::vector<alarm_t*> alarm_heap;
+static uint64_t alarm_sequence;
+
+// Number of alarms dispatched from the same expiration as the previous alarm,
+// and that expiration.
+static size_t coalesced_expiration_count;
+static uint64_t last_expiration_ms;
 static timer_t timer;
 static timer_t wakeup_timer;
 static bool timer_set;
@@ -135,9 +162,13 @@ static alarm_t* alarm_new_internal(const char* name, bool is_periodic);
 static bool lazy_initialize(void);
 static uint64_t now_ms(void);
 static void alarm_set_internal(alarm_t* alarm, uint64_t period_ms,
-                               alarm_callback_t cb, void* data,
-                               fixed_queue_t* queue, bool for_msg_loop);
+                               uint64_t slack_ms, alarm_callback_t cb,
+                               void* data, fixed_queue_t* queue,
+                               bool for_msg_loop);
 static void alarm_cancel_internal(alarm_t* alarm);
+static alarm_t* pending_alarms_front(void);
+static void pending_alarms_insert(alarm_t* alarm);
+static void pending_alarms_remove(alarm_t* alarm);
 static void remove_pending_alarm(alarm_t* alarm);
 static void schedule_next_instance(alarm_t* alarm);
 static void reschedule_root_alarm(void);
@@ -179,6 +210,7 @@ static alarm_t* alarm_new_internal(const char* name, bool is_periodic) {
   ret->stats.name = osi_strdup(name);
 
   ret->for_msg_loop = false;
+  ret->heap_index = ALARM_NOT_PENDING;
   // placement new
   new (&ret->closure) CancelableClosureInStruct();
 
@@ -212,19 +244,32 @@ uint64_t alarm_get_remaining_ms(const alarm_t* alarm) {
 
 void alarm_set(alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
                void* data) {
-  alarm_set_internal(alarm, interval_ms, cb, data, default_callback_queue,
+  alarm_set_internal(alarm, interval_ms, 0, cb, data, default_callback_queue,
                      false);
 }
 
 void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
                         alarm_callback_t cb, void* data) {
-  alarm_set_internal(alarm, interval_ms, cb, data, NULL, true);
+  alarm_set_internal(alarm, interval_ms, 0, cb, data, NULL, true);
+}
+
+void alarm_set_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                          uint64_t slack_ms, alarm_callback_t cb, void* data) {
+  alarm_set_internal(alarm, interval_ms, slack_ms, cb, data,
+                     default_callback_queue, false);
+}
+
+void alarm_set_on_mloop_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                                   uint64_t slack_ms, alarm_callback_t cb,
+                                   void* data) {
+  alarm_set_internal(alarm, interval_ms, slack_ms, cb, data, NULL, true);
 }
 
 // Runs in exclusion with alarm_cancel and timer_callback.
 static void alarm_set_internal(alarm_t* alarm, uint64_t period_ms,
-                               alarm_callback_t cb, void* data,
-                               fixed_queue_t* queue, bool for_msg_loop) {
+                               uint64_t slack_ms, alarm_callback_t cb,
+                               void* data, fixed_queue_t* queue,
+                               bool for_msg_loop) {
   CHECK(alarms != NULL);
   CHECK(alarm != NULL);
   CHECK(cb != NULL);
@@ -233,6 +278,7 @@ static void alarm_set_internal(alarm_t* alarm, uint64_t period_ms,
 
   alarm->creation_time_ms = now_ms();
   alarm->period_ms = period_ms;
+  alarm->slack_ms = slack_ms;
   alarm->queue = queue;
   alarm->callback = cb;
   alarm->data = data;
@@ -260,8 +306,7 @@ void alarm_cancel(alarm_t* alarm) {
 // Internal implementation of canceling an alarm.
 // The caller must hold the |alarms_mutex|
 static void alarm_cancel_internal(alarm_t* alarm) {
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  bool needs_reschedule = (pending_alarms_front() == alarm);
 
   remove_pending_alarm(alarm);
 
@@ -303,6 +348,8 @@ void alarm_cleanup(void) {
 
   list_free(alarms);
   alarms = NULL;
+  for (alarm_t* alarm : alarm_heap) alarm->heap_index = ALARM_NOT_PENDING;
+  alarm_heap.clear();
 }
 
 static bool lazy_initialize(void) {
@@ -320,6 +367,7 @@ static bool lazy_initialize(void) {
     LOG_ERROR("%s unable to allocate alarm list.", __func__);
     goto error;
   }
+  use_alarm_heap = bluetooth::common::init_flags::osi_alarm_heap_is_enabled();
 
   if (!timer_create_internal(CLOCK_ID, &timer)) goto error;
   timer_initialized = true;
@@ -398,10 +446,107 @@ static uint64_t now_ms(void) {
   return (ts.tv_sec * 1000LL) + (ts.tv_nsec / 1000000LL);
 }
 
+static bool alarm_heap_less(const alarm_t* a, const alarm_t* b) {
+  if (a->deadline_ms != b->deadline_ms) return a->deadline_ms < b->deadline_ms;
+  return a->sequence < b->sequence;
+}
+
+static void alarm_heap_swap(size_t i, size_t j) {
+  std::swap(alarm_heap[i], alarm_heap[j]);
+  alarm_heap[i]->heap_index = i;
+  alarm_heap[j]->heap_index = j;
+}
+
+static void alarm_heap_sift_up(size_t index) {
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (!alarm_heap_less(alarm_heap[index], alarm_heap[parent])) break;
+    alarm_heap_swap(index, parent);
+    index = parent;
+  }
+}
+
+static void alarm_heap_sift_down(size_t index) {
+  while (true) {
+    size_t smallest = index;
+    size_t left = 2 * index + 1;
+    size_t right = left + 1;
+    if (left < alarm_heap.size() &&
+        alarm_heap_less(alarm_heap[left], alarm_heap[smallest]))
+      smallest = left;
+    if (right < alarm_heap.size() &&
+        alarm_heap_less(alarm_heap[right], alarm_heap[smallest]))
+      smallest = right;
+    if (smallest == index) break;
+    alarm_heap_swap(index, smallest);
+    index = smallest;
+  }
+}
+
+// Returns the pending alarm with the earliest deadline, or NULL if there is
+// none. The caller must hold the |alarms_mutex|
+static alarm_t* pending_alarms_front(void) {
+  if (use_alarm_heap) {
+    return alarm_heap.empty() ? NULL : alarm_heap.front();
+  }
+  return list_is_empty(alarms) ? NULL
+                               : static_cast<alarm_t*>(list_front(alarms));
+}
+
+// Add a pending alarm, after the alarms with the same deadline.
+// The caller must hold the |alarms_mutex|
+static void pending_alarms_insert(alarm_t* alarm) {
+  if (use_alarm_heap) {
+    alarm->sequence = alarm_sequence++;
+    alarm->heap_index = alarm_heap.size();
+    alarm_heap.push_back(alarm);
+    alarm_heap_sift_up(alarm->heap_index);
+    return;
+  }
+
+  // Add it into the timer list sorted by deadline (earliest deadline first).
+  if (list_is_empty(alarms) ||
+      ((alarm_t*)list_front(alarms))->deadline_ms > alarm->deadline_ms) {
+    list_prepend(alarms, alarm);
+  } else {
+    for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
+         node = list_next(node)) {
+      list_node_t* next = list_next(node);
+      if (next == list_end(alarms) ||
+          ((alarm_t*)list_node(next))->deadline_ms > alarm->deadline_ms) {
+        list_insert_after(alarms, node, alarm);
+        break;
+      }
+    }
+  }
+}
+
+// Remove an alarm from the pending alarms, if present.
+// The caller must hold the |alarms_mutex|
+static void pending_alarms_remove(alarm_t* alarm) {
+  if (!use_alarm_heap) {
+    list_remove(alarms, alarm);
+    return;
+  }
+
+  size_t index = alarm->heap_index;
+  if (index == ALARM_NOT_PENDING) return;
+  alarm->heap_index = ALARM_NOT_PENDING;
+
+  alarm_t* last = alarm_heap.back();
+  alarm_heap.pop_back();
+  if (last == alarm) return;
+
+  alarm_heap[index] = last;
+  last->heap_index = index;
+  alarm_heap_sift_up(index);
+  alarm_heap_sift_down(last->heap_index);
+}
+
 // Remove alarm from internal alarm list and the processing queue
 // The caller must hold the |alarms_mutex|
 static void remove_pending_alarm(alarm_t* alarm) {
-  list_remove(alarms, alarm);
+  pending_alarms_remove(alarm);
 
   if (alarm->for_msg_loop) {
     alarm->closure.i.Cancel();
@@ -414,12 +559,21 @@ static void remove_pending_alarm(alarm_t* alarm) {
   }
 }
 
+// Delay |deadline_ms| to the next multiple of the largest power of two not
+// above |slack_ms|. Deadlines are absolute, so alarms with overlapping slack
+// windows are aligned on the same expiration.
+static uint64_t align_deadline(uint64_t deadline_ms, uint64_t slack_ms) {
+  if (slack_ms == 0) return deadline_ms;
+  uint64_t granularity = 1;
+  while (granularity <= slack_ms / 2) granularity <<= 1;
+  return (deadline_ms + granularity - 1) & ~(granularity - 1);
+}
+
 // Must be called with |alarms_mutex| held
 static void schedule_next_instance(alarm_t* alarm) {
   // If the alarm is currently set and it's at the start of the list,
   // we'll need to re-schedule since we've adjusted the earliest deadline.
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  bool needs_reschedule = (pending_alarms_front() == alarm);
   if (alarm->callback) remove_pending_alarm(alarm);
 
   // Calculate the next deadline for this alarm
@@ -428,28 +582,14 @@ static void schedule_next_instance(alarm_t* alarm) {
   if ((alarm->is_periodic) && (alarm->period_ms != 0))
     ms_into_period =
         ((just_now_ms - alarm->creation_time_ms) % alarm->period_ms);
-  alarm->deadline_ms = just_now_ms + (alarm->period_ms - ms_into_period);
+  alarm->deadline_ms = align_deadline(
+      just_now_ms + (alarm->period_ms - ms_into_period), alarm->slack_ms);
 
-  // Add it into the timer list sorted by deadline (earliest deadline first).
-  if (list_is_empty(alarms) ||
-      ((alarm_t*)list_front(alarms))->deadline_ms > alarm->deadline_ms) {
-    list_prepend(alarms, alarm);
-  } else {
-    for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-         node = list_next(node)) {
-      list_node_t* next = list_next(node);
-      if (next == list_end(alarms) ||
-          ((alarm_t*)list_node(next))->deadline_ms > alarm->deadline_ms) {
-        list_insert_after(alarms, node, alarm);
-        break;
-      }
-    }
-  }
+  pending_alarms_insert(alarm);
 
   // If the new alarm has the earliest deadline, we need to re-evaluate our
   // schedule.
-  if (needs_reschedule ||
-      (!list_is_empty(alarms) && list_front(alarms) == alarm)) {
+  if (needs_reschedule || pending_alarms_front() == alarm) {
     reschedule_root_alarm();
   }
 }
@@ -466,13 +606,13 @@ static void reschedule_root_alarm(void) {
   struct itimerspec timer_time;
   memset(&timer_time, 0, sizeof(timer_time));
 
-  if (list_is_empty(alarms)) goto done;
+  next = pending_alarms_front();
+  if (next == NULL) goto done;
 
-  next = static_cast<alarm_t*>(list_front(alarms));
   next_expiration = next->deadline_ms - now_ms();
   if (next_expiration < TIMER_INTERVAL_FOR_WAKELOCK_IN_MS) {
     if (!timer_set) {
-      if (!wakelock_acquire()) {
+      if (!wakelock_acquire_for(next->stats.name)) {
         LOG_ERROR("%s unable to acquire wake lock", __func__);
       }
     }
@@ -628,14 +768,16 @@ static void callback_dispatch(UNUSED_ATTR void* context) {
     // Take into account that the alarm may get cancelled before we get to it.
     // We're done here if there are no alarms or the alarm at the front is in
     // the future. Exit right away since there's nothing left to do.
-    if (list_is_empty(alarms) ||
-        (alarm = static_cast<alarm_t*>(list_front(alarms)))->deadline_ms >
-            now_ms()) {
+    alarm = pending_alarms_front();
+    if (alarm == NULL || alarm->deadline_ms > now_ms()) {
       reschedule_root_alarm();
       continue;
     }
 
-    list_remove(alarms, alarm);
+    pending_alarms_remove(alarm);
+
+    if (alarm->deadline_ms == last_expiration_ms) coalesced_expiration_count++;
+    last_expiration_ms = alarm->deadline_ms;
 
     if (alarm->is_periodic) {
       alarm->prev_deadline_ms = alarm->deadline_ms;
@@ -734,12 +876,22 @@ void alarm_debug_dump(int fd) {
 
   uint64_t just_now_ms = now_ms();
 
-  dprintf(fd, "  Total Alarms: %zu\n\n", list_length(alarms));
+  std::vector<alarm_t*> pending;
+  if (use_alarm_heap) {
+    pending = alarm_heap;
+  } else {
+    for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
+         node = list_next(node)) {
+      pending.push_back((alarm_t*)list_node(node));
+    }
+  }
+
+  dprintf(fd, "  Total Alarms: %zu (%s)\n", pending.size(),
+          use_alarm_heap ? "heap" : "list");
+  dprintf(fd, "  Coalesced expirations: %zu\n\n", coalesced_expiration_count);
 
   // Dump info for each alarm
-  for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-       node = list_next(node)) {
-    alarm_t* alarm = (alarm_t*)list_node(node);
+  for (alarm_t* alarm : pending) {
     alarm_stats_t* stats = &alarm->stats;
 
     dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
@@ -754,10 +906,11 @@ void alarm_debug_dump(int fd) {
             "    Deviation counts (overdue/premature)",
             stats->overdue_scheduling.count, stats->premature_scheduling.count);
 
-    dprintf(fd, "%-51s: %llu / %llu / %lld\n",
-            "    Time in ms (since creation/interval/remaining)",
+    dprintf(fd, "%-51s: %llu / %llu / %llu / %lld\n",
+            "    Time in ms (since creation/interval/slack/remaining)",
             (unsigned long long)(just_now_ms - alarm->creation_time_ms),
             (unsigned long long)alarm->period_ms,
+            (unsigned long long)alarm->slack_ms,
             (long long)(alarm->deadline_ms - just_now_ms));
 
     dump_stat(fd, &stats->overdue_scheduling,
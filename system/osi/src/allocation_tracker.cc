@@ -21,28 +21,64 @@
 #include "osi/include/allocation_tracker.h"
 
 #include <base/logging.h>
+#include <dlfcn.h>
 #include <stdlib.h>
 #include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "check.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/packet_pool.h"
 
 typedef struct {
   uint8_t allocator_id;
   void* ptr;
   size_t size;
   bool freed;
+  const void* callsite;
 } allocation_t;
 
+// Live allocations of a callsite
+typedef struct {
+  size_t count;
+  size_t size;
+} callsite_stats_t;
+
+// Header of every allocation while sampling, the callsite is NULL when the
+// allocation is not sampled. Its alignment keeps the allocations aligned.
+typedef struct alignas(max_align_t) {
+  const void* callsite;
+  uint32_t size;
+  uint32_t magic;
+} sample_header_t;
+
+// The sampled allocations of a callsite are always in the same shard, which
+// is locked only on the allocations being sampled and on their frees
+typedef struct {
+  std::mutex lock;
+  std::unordered_map<const void*, callsite_stats_t> callsites;
+} sample_shard_t;
+
+static const uint32_t sample_magic = 0x534d504c; /* "SMPL" */
+static const size_t sample_num_shards = 16;
+static const size_t num_dumped_callsites = 20;
+
 static const size_t canary_size = 8;
 static char canary[canary_size];
 static std::unordered_map<void*, allocation_t*> allocations;
 static std::mutex tracker_lock;
 static bool enabled = false;
+static std::atomic<uint32_t> sample_rate = 0;
+static sample_shard_t sample_shards[sample_num_shards];
 
 // Memory allocation statistics
 static size_t alloc_counter = 0;
@@ -62,6 +98,92 @@ void allocation_tracker_init(void) {
   enabled = true;
 }
 
+void allocation_tracker_init_sampling(uint32_t rate) {
+  std::unique_lock<std::mutex> lock(tracker_lock);
+  if (enabled || rate == 0 || sample_rate != 0) return;
+
+  LOG_INFO("sampling one allocation in %u", rate);
+
+  sample_rate = rate;
+}
+
+static sample_shard_t& sample_shard(const void* callsite) {
+  return sample_shards[std::hash<const void*>{}(callsite) % sample_num_shards];
+}
+
+static void* sample_notify_alloc(uint32_t rate, void* ptr,
+                                 size_t requested_size, const void* callsite) {
+  // Counts down to the next sampled allocation of the thread
+  thread_local uint32_t until_sample = 0;
+
+  sample_header_t* header = (sample_header_t*)ptr;
+  header->callsite = NULL;
+  header->size = (uint32_t)requested_size;
+  header->magic = sample_magic;
+
+  if (until_sample == 0) {
+    until_sample = rate;
+    header->callsite = callsite;
+
+    sample_shard_t& shard = sample_shard(header->callsite);
+    std::unique_lock<std::mutex> lock(shard.lock);
+    callsite_stats_t& stats = shard.callsites[header->callsite];
+    stats.count++;
+    stats.size += requested_size;
+  }
+  until_sample--;
+
+  return header + 1;
+}
+
+static void* sample_notify_free(void* ptr) {
+  sample_header_t* header = ((sample_header_t*)ptr) - 1;
+  CHECK(header->magic == sample_magic);  // Must have been tracked before
+
+  if (header->callsite != NULL) {
+    sample_shard_t& shard = sample_shard(header->callsite);
+    std::unique_lock<std::mutex> lock(shard.lock);
+    auto stats = shard.callsites.find(header->callsite);
+    CHECK(stats != shard.callsites.end());
+    stats->second.count--;
+    stats->second.size -= header->size;
+    if (stats->second.count == 0) shard.callsites.erase(stats);
+  }
+
+  // Catch double frees
+  header->magic = 0;
+  return header;
+}
+
+// Live allocations by callsite, estimated from the samples while sampling
+static std::unordered_map<const void*, callsite_stats_t> live_callsites(
+    uint32_t* rate) {
+  std::unordered_map<const void*, callsite_stats_t> callsites;
+
+  *rate = sample_rate;
+  if (*rate != 0) {
+    for (sample_shard_t& shard : sample_shards) {
+      std::unique_lock<std::mutex> lock(shard.lock);
+      for (const auto& entry : shard.callsites) {
+        callsites[entry.first] = {entry.second.count * *rate,
+                                  entry.second.size * *rate};
+      }
+    }
+    return callsites;
+  }
+
+  std::unique_lock<std::mutex> lock(tracker_lock);
+  *rate = 1;
+  for (const auto& entry : allocations) {
+    allocation_t* allocation = entry.second;
+    if (allocation->freed) continue;
+    callsite_stats_t& stats = callsites[allocation->callsite];
+    stats.count++;
+    stats.size += allocation->size;
+  }
+  return callsites;
+}
+
 // Test function only. Do not call in the normal course of operations.
 void allocation_tracker_uninit(void) {
   std::unique_lock<std::mutex> lock(tracker_lock);
@@ -69,6 +191,12 @@ void allocation_tracker_uninit(void) {
 
   allocations.clear();
   enabled = false;
+
+  sample_rate = 0;
+  for (sample_shard_t& shard : sample_shards) {
+    std::unique_lock<std::mutex> shard_lock(shard.lock);
+    shard.callsites.clear();
+  }
 }
 
 void allocation_tracker_reset(void) {
@@ -80,6 +208,18 @@ void allocation_tracker_reset(void) {
 
 size_t allocation_tracker_expect_no_allocations(void) {
   std::unique_lock<std::mutex> lock(tracker_lock);
+  if (sample_rate != 0) {
+    lock.unlock();
+
+    uint32_t rate;
+    size_t unfreed_memory_size = 0;
+    for (const auto& entry : live_callsites(&rate)) {
+      unfreed_memory_size += entry.second.size;
+      LOG_ERROR("%s found unfreed allocations. callsite: 0x%zx size: %zd bytes",
+                __func__, (uintptr_t)entry.first, entry.second.size);
+    }
+    return unfreed_memory_size;
+  }
   if (!enabled) return 0;
 
   size_t unfreed_memory_size = 0;
@@ -98,7 +238,15 @@ size_t allocation_tracker_expect_no_allocations(void) {
 }
 
 void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
-                                      size_t requested_size) {
+                                      size_t requested_size,
+                                      const void* callsite) {
+  if (callsite == NULL) callsite = __builtin_return_address(0);
+
+  uint32_t rate = sample_rate.load(std::memory_order_relaxed);
+  if (rate != 0 && ptr) {
+    return sample_notify_alloc(rate, ptr, requested_size, callsite);
+  }
+
   char* return_ptr;
   {
     std::unique_lock<std::mutex> lock(tracker_lock);
@@ -124,6 +272,7 @@ void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
     allocation->freed = false;
     allocation->size = requested_size;
     allocation->ptr = return_ptr;
+    allocation->callsite = callsite;
   }
 
   // Add the canary on both sides
@@ -135,6 +284,10 @@ void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
 
 void* allocation_tracker_notify_free(UNUSED_ATTR uint8_t allocator_id,
                                      void* ptr) {
+  if (sample_rate.load(std::memory_order_relaxed) != 0 && ptr) {
+    return sample_notify_free(ptr);
+  }
+
   std::unique_lock<std::mutex> lock(tracker_lock);
 
   if (!enabled || !ptr) return ptr;
@@ -171,9 +324,47 @@ void* allocation_tracker_notify_free(UNUSED_ATTR uint8_t allocator_id,
 }
 
 size_t allocation_tracker_resize_for_canary(size_t size) {
+  if (sample_rate.load(std::memory_order_relaxed) != 0) {
+    return size + sizeof(sample_header_t);
+  }
   return (!enabled) ? size : size + (2 * canary_size);
 }
 
+static void dump_callsites(int fd) {
+  uint32_t rate;
+  auto callsites = live_callsites(&rate);
+  if (callsites.empty()) return;
+
+  std::vector<std::pair<const void*, callsite_stats_t>> sorted(
+      callsites.begin(), callsites.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return a.second.size > b.second.size;
+  });
+  if (sorted.size() > num_dumped_callsites) {
+    sorted.resize(num_dumped_callsites);
+  }
+
+  if (rate > 1) {
+    dprintf(fd, "  Live octets by callsite, sampled 1 in %u:\n", rate);
+  } else {
+    dprintf(fd, "  Live octets by callsite:\n");
+  }
+  for (const auto& entry : sorted) {
+    Dl_info info = {};
+    if (dladdr(entry.first, &info) && info.dli_fname != NULL) {
+      const char* name = strrchr(info.dli_fname, '/');
+      dprintf(fd, "    %s+0x%zx %s: %zu allocations, %zu octets\n",
+              name ? name + 1 : info.dli_fname,
+              (uintptr_t)entry.first - (uintptr_t)info.dli_fbase,
+              info.dli_sname ? info.dli_sname : "", entry.second.count,
+              entry.second.size);
+    } else {
+      dprintf(fd, "    %p: %zu allocations, %zu octets\n", entry.first,
+              entry.second.count, entry.second.size);
+    }
+  }
+}
+
 void osi_allocator_debug_dump(int fd) {
   dprintf(fd, "\nBluetooth Memory Allocation Statistics:\n");
 
@@ -184,4 +375,8 @@ void osi_allocator_debug_dump(int fd) {
   dprintf(fd, "  Total allocated/free/used octets : %zu / %zu / %zu\n",
           alloc_total_size, free_total_size,
           alloc_total_size - free_total_size);
+  lock.unlock();
+
+  dump_callsites(fd);
+  packet_pool_debug_dump(fd);
 }
@@ -22,8 +22,10 @@
 #include "check.h"
 #include "osi/include/allocation_tracker.h"
 #include "osi/include/allocator.h"
+#include "osi/packet_pool.h"
 
 static const allocator_id_t alloc_allocator_id = 42;
+static const allocator_id_t packet_allocator_id = 43;
 
 char* osi_strdup(const char* str) {
   size_t size = strlen(str) + 1;  // + 1 for the null terminator
@@ -32,7 +34,8 @@ char* osi_strdup(const char* str) {
   CHECK(ptr);
 
   char* new_string = static_cast<char*>(
-      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size));
+      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size,
+                                      __builtin_return_address(0)));
   if (!new_string) return NULL;
 
   memcpy(new_string, str, size);
@@ -48,7 +51,8 @@ char* osi_strndup(const char* str, size_t len) {
   CHECK(ptr);
 
   char* new_string = static_cast<char*>(
-      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size + 1));
+      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size + 1,
+                                      __builtin_return_address(0)));
   if (!new_string) return NULL;
 
   memcpy(new_string, str, size);
@@ -61,7 +65,8 @@ void* osi_malloc(size_t size) {
   size_t real_size = allocation_tracker_resize_for_canary(size);
   void* ptr = malloc(real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size,
+                                         __builtin_return_address(0));
 }
 
 void* osi_calloc(size_t size) {
@@ -69,10 +74,34 @@ void* osi_calloc(size_t size) {
   size_t real_size = allocation_tracker_resize_for_canary(size);
   void* ptr = calloc(1, real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size,
+                                         __builtin_return_address(0));
+}
+
+void* osi_malloc_packet(size_t size) {
+  CHECK(static_cast<ssize_t>(size) >= 0);
+  size_t real_size = allocation_tracker_resize_for_canary(size);
+  void* ptr = packet_pool_alloc(real_size);
+  if (ptr == NULL) return osi_malloc(size);
+  return allocation_tracker_notify_alloc(packet_allocator_id, ptr, size,
+                                         __builtin_return_address(0));
+}
+
+void* osi_calloc_packet(size_t size) {
+  CHECK(static_cast<ssize_t>(size) >= 0);
+  size_t real_size = allocation_tracker_resize_for_canary(size);
+  void* ptr = packet_pool_alloc(real_size);
+  if (ptr == NULL) return osi_calloc(size);
+  memset(ptr, 0, real_size);
+  return allocation_tracker_notify_alloc(packet_allocator_id, ptr, size,
+                                         __builtin_return_address(0));
 }
 
 void osi_free(void* ptr) {
+  if (packet_pool_owns(ptr)) {
+    packet_pool_free(allocation_tracker_notify_free(packet_allocator_id, ptr));
+    return;
+  }
   free(allocation_tracker_notify_free(alloc_allocator_id, ptr));
 }
 
@@ -28,10 +28,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include <sstream>
+#include <string_view>
 #include <type_traits>
 
 #include "check.h"
@@ -68,7 +70,7 @@ bool config_t::Has(const std::string& key) {
   return Find(key) != sections.end();
 }
 
-static bool config_parse(FILE* fp, config_t* config);
+static bool config_parse(std::string_view data, config_t* config);
 
 template <typename T,
           class = typename std::enable_if<std::is_same<
@@ -99,20 +101,43 @@ std::unique_ptr<config_t> config_new_empty(void) {
 std::unique_ptr<config_t> config_new(const char* filename) {
   CHECK(filename != nullptr);
 
+  int fd = open(filename, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    LOG(ERROR) << __func__ << ": unable to open file '" << filename
+               << "': " << strerror(errno);
+    return nullptr;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    LOG(ERROR) << __func__ << ": unable to stat file '" << filename
+               << "': " << strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+
   std::unique_ptr<config_t> config = config_new_empty();
+  if (st.st_size == 0) {
+    close(fd);
+    return config;
+  }
 
-  FILE* fp = fopen(filename, "rt");
-  if (!fp) {
-    LOG(ERROR) << __func__ << ": unable to open file '" << filename
+  // The file is parsed in place, without copying each line out of it.
+  void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << __func__ << ": unable to map file '" << filename
                << "': " << strerror(errno);
     return nullptr;
   }
 
-  if (!config_parse(fp, config.get())) {
+  if (!config_parse(
+          std::string_view(static_cast<const char*>(data), st.st_size),
+          config.get())) {
     config.reset();
   }
 
-  fclose(fp);
+  munmap(data, st.st_size);
   return config;
 }
 
@@ -477,53 +502,65 @@ error2:
   return false;
 }
 
-static char* trim(char* str) {
-  while (isspace(*str)) ++str;
-
-  if (!*str) return str;
-
-  char* end_str = str + strlen(str) - 1;
-  while (end_str > str && isspace(*end_str)) --end_str;
-
-  end_str[1] = '\0';
+static std::string_view trim(std::string_view str) {
+  while (!str.empty() && isspace(static_cast<unsigned char>(str.front())))
+    str.remove_prefix(1);
+  while (!str.empty() && isspace(static_cast<unsigned char>(str.back())))
+    str.remove_suffix(1);
   return str;
 }
 
-static bool config_parse(FILE* fp, config_t* config) {
-  CHECK(fp != nullptr);
+static bool config_parse(std::string_view data, config_t* config) {
   CHECK(config != nullptr);
 
   int line_num = 0;
-  char line[4096];
-  char section[4096];
-  strcpy(section, CONFIG_DEFAULT_SECTION);
-
-  while (fgets(line, sizeof(line), fp)) {
-    char* line_ptr = trim(line);
+  std::string_view section = CONFIG_DEFAULT_SECTION;
+  // Section of |section|, looked up on its first key only, so that a section
+  // without keys is not added, and the following keys skip the lookup.
+  section_t* sec = nullptr;
+
+  while (!data.empty()) {
+    size_t eol = data.find('\n');
+    std::string_view line = data.substr(0, eol);
+    data.remove_prefix(eol == std::string_view::npos ? data.size() : eol + 1);
     ++line_num;
 
+    // A line ends at its first nul character, as when it was read by fgets.
+    line = trim(line.substr(0, line.find('\0')));
+
     // Skip blank and comment lines.
-    if (*line_ptr == '\0' || *line_ptr == '#') continue;
+    if (line.empty() || line.front() == '#') continue;
 
-    if (*line_ptr == '[') {
-      size_t len = strlen(line_ptr);
-      if (line_ptr[len - 1] != ']') {
+    if (line.front() == '[') {
+      if (line.back() != ']') {
         VLOG(1) << __func__ << ": unterminated section name on line "
                 << line_num;
         return false;
       }
-      strncpy(section, line_ptr + 1, len - 2);  // NOLINT (len < 4096)
-      section[len - 2] = '\0';
+      section = line.substr(1, line.size() - 2);
+      sec = nullptr;
     } else {
-      char* split = strchr(line_ptr, '=');
-      if (!split) {
+      size_t split = line.find('=');
+      if (split == std::string_view::npos) {
         VLOG(1) << __func__ << ": no key/value separator found on line "
                 << line_num;
         return false;
       }
 
-      *split = '\0';
-      config_set_string(config, section, trim(line_ptr), trim(split + 1));
+      if (sec == nullptr) {
+        auto it = std::find_if(
+            config->sections.begin(), config->sections.end(),
+            [section](const section_t& s) { return s.name == section; });
+        if (it == config->sections.end()) {
+          config->sections.emplace_back(
+              section_t{.name = std::string(section)});
+          it = std::prev(config->sections.end());
+        }
+        sec = &*it;
+      }
+
+      sec->Set(std::string(trim(line.substr(0, split))),
+               std::string(trim(line.substr(split + 1))));
     }
   }
   return true;
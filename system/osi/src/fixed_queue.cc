@@ -16,20 +16,62 @@
  *
  ******************************************************************************/
 
+#define LOG_TAG "bt_osi_fixed_queue"
+
 #include <base/logging.h>
+#include <errno.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 #include "check.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/list.h"
+#include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "osi/include/reactor.h"
 #include "osi/semaphore.h"
 
+// Bounded lock-free ring of the queues created by |fixed_queue_new_ring|,
+// after D. Vyukov's bounded MPMC queue. The sequence of a cell tells whether
+// it is free for the enqueue at |position| (sequence == position) or holds
+// the element for the dequeue at |position| (sequence == position + 1).
+struct fixed_queue_ring_t {
+  struct cell_t {
+    std::atomic<size_t> sequence;
+    void* data;
+  };
+
+  explicit fixed_queue_ring_t(size_t size)
+      : cells(new cell_t[size]), mask(size - 1) {
+    for (size_t i = 0; i < size; i++) cells[i].sequence.store(i);
+  }
+
+  std::unique_ptr<cell_t[]> cells;
+  const size_t mask;
+  alignas(64) std::atomic<size_t> enqueue_position{0};
+  alignas(64) std::atomic<size_t> dequeue_position{0};
+
+  // |dequeue_fd| is written once per batch of elements: only the enqueue
+  // that sets |dequeue_signaled| signals it, and the flag is cleared when the
+  // consumer reads the fd, before it drains the ring.
+  std::atomic<bool> dequeue_signaled{false};
+  int dequeue_fd{-1};
+  // Semaphore posted on dequeue while an enqueue is blocked on a full ring.
+  std::atomic<size_t> blocked_enqueues{0};
+  int enqueue_fd{-1};
+};
+
 typedef struct fixed_queue_t {
+  // Set for the queues created with |fixed_queue_new_ring|, which don't use
+  // |list|, the semaphores nor the mutex.
+  fixed_queue_ring_t* ring;
+
   list_t* list;
   semaphore_t* enqueue_sem;
   semaphore_t* dequeue_sem;
@@ -43,6 +85,83 @@ typedef struct fixed_queue_t {
 
 static void internal_dequeue_ready(void* context);
 
+static bool ring_try_enqueue(fixed_queue_ring_t* ring, void* data) {
+  size_t position = ring->enqueue_position.load(std::memory_order_relaxed);
+  fixed_queue_ring_t::cell_t* cell;
+  while (true) {
+    cell = &ring->cells[position & ring->mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (sequence == position) {
+      if (ring->enqueue_position.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed))
+        break;
+    } else if ((intptr_t)(sequence - position) < 0) {
+      return false;  // The ring is full
+    } else {
+      position = ring->enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+  cell->data = data;
+  cell->sequence.store(position + 1, std::memory_order_release);
+
+  if (!ring->dequeue_signaled.exchange(true)) {
+    eventfd_write(ring->dequeue_fd, 1);
+  }
+  return true;
+}
+
+static void* ring_try_dequeue(fixed_queue_ring_t* ring) {
+  size_t position = ring->dequeue_position.load(std::memory_order_relaxed);
+  fixed_queue_ring_t::cell_t* cell;
+  while (true) {
+    cell = &ring->cells[position & ring->mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (sequence == position + 1) {
+      if (ring->dequeue_position.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed))
+        break;
+    } else if ((intptr_t)(sequence - (position + 1)) < 0) {
+      return NULL;  // The ring is empty
+    } else {
+      position = ring->dequeue_position.load(std::memory_order_relaxed);
+    }
+  }
+  void* data = cell->data;
+  cell->sequence.store(position + ring->mask + 1, std::memory_order_release);
+
+  // Pairs with the fence of the blocked enqueue, so that either it sees the
+  // released cell or this dequeue sees it blocked.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (ring->blocked_enqueues.load(std::memory_order_relaxed) > 0) {
+    eventfd_write(ring->enqueue_fd, 1);
+  }
+  return data;
+}
+
+static size_t ring_length(fixed_queue_ring_t* ring) {
+  size_t dequeue_position = ring->dequeue_position.load();
+  size_t enqueue_position = ring->enqueue_position.load();
+  return enqueue_position > dequeue_position
+             ? enqueue_position - dequeue_position
+             : 0;
+}
+
+// Consume the signal of |dequeue_fd|. The enqueues that follow signal again.
+static void ring_clear_dequeue_signal(fixed_queue_ring_t* ring) {
+  eventfd_t value;
+  eventfd_read(ring->dequeue_fd, &value);
+  // Read-modify-write, to synchronize with the enqueue that set the flag.
+  ring->dequeue_signaled.exchange(false);
+}
+
+// Signal |dequeue_fd| again if elements were left in the ring after the
+// signal was consumed.
+static void ring_signal_remaining(fixed_queue_ring_t* ring) {
+  if (ring_length(ring) > 0 && !ring->dequeue_signaled.exchange(true)) {
+    eventfd_write(ring->dequeue_fd, 1);
+  }
+}
+
 fixed_queue_t* fixed_queue_new(size_t capacity) {
   fixed_queue_t* ret =
       static_cast<fixed_queue_t*>(osi_calloc(sizeof(fixed_queue_t)));
@@ -66,11 +185,49 @@ error:
   return NULL;
 }
 
+fixed_queue_t* fixed_queue_new_ring(size_t capacity) {
+  CHECK(capacity > 0);
+  CHECK(capacity <= FIXED_QUEUE_RING_MAX_CAPACITY);
+
+  size_t size = 1;
+  while (size < capacity) size <<= 1;
+
+  fixed_queue_t* ret =
+      static_cast<fixed_queue_t*>(osi_calloc(sizeof(fixed_queue_t)));
+  ret->capacity = size;
+  ret->ring = new fixed_queue_ring_t(size);
+
+  ret->ring->dequeue_fd = eventfd(0, EFD_CLOEXEC);
+  if (ret->ring->dequeue_fd == -1) goto error;
+
+  ret->ring->enqueue_fd = eventfd(0, EFD_CLOEXEC | EFD_SEMAPHORE);
+  if (ret->ring->enqueue_fd == -1) goto error;
+
+  return ret;
+
+error:
+  LOG_ERROR("%s unable to create eventfd: %s", __func__, strerror(errno));
+  fixed_queue_free(ret, NULL);
+  return NULL;
+}
+
 void fixed_queue_free(fixed_queue_t* queue, fixed_queue_free_cb free_cb) {
   if (!queue) return;
 
   fixed_queue_unregister_dequeue(queue);
 
+  if (queue->ring) {
+    void* data;
+    while ((data = ring_try_dequeue(queue->ring)) != NULL) {
+      if (free_cb) free_cb(data);
+    }
+    if (queue->ring->dequeue_fd != -1) close(queue->ring->dequeue_fd);
+    if (queue->ring->enqueue_fd != -1) close(queue->ring->enqueue_fd);
+    delete queue->ring;
+    osi_free(queue);
+    return;
+  }
+
   if (free_cb)
     for (const list_node_t* node = list_begin(queue->list);
          node != list_end(queue->list); node = list_next(node))
@@ -96,6 +253,7 @@ void fixed_queue_flush(fixed_queue_t* queue, fixed_queue_free_cb free_cb) {
 
 bool fixed_queue_is_empty(fixed_queue_t* queue) {
   if (queue == NULL) return true;
+  if (queue->ring) return ring_length(queue->ring) == 0;
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list);
@@ -103,6 +261,7 @@ bool fixed_queue_is_empty(fixed_queue_t* queue) {
 
 size_t fixed_queue_length(fixed_queue_t* queue) {
   if (queue == NULL) return 0;
+  if (queue->ring) return ring_length(queue->ring);
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_length(queue->list);
@@ -118,6 +277,24 @@ void fixed_queue_enqueue(fixed_queue_t* queue, void* data) {
   CHECK(queue != NULL);
   CHECK(data != NULL);
 
+  if (queue->ring) {
+    fixed_queue_ring_t* ring = queue->ring;
+    while (!ring_try_enqueue(ring, data)) {
+      // Check again once registered as blocked, the dequeues that follow
+      // post |enqueue_fd|.
+      ring->blocked_enqueues++;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      bool enqueued = ring_try_enqueue(ring, data);
+      if (!enqueued) {
+        eventfd_t value;
+        eventfd_read(ring->enqueue_fd, &value);
+      }
+      ring->blocked_enqueues--;
+      if (enqueued) break;
+    }
+    return;
+  }
+
   semaphore_wait(queue->enqueue_sem);
 
   {
@@ -131,6 +308,15 @@ void fixed_queue_enqueue(fixed_queue_t* queue, void* data) {
 void* fixed_queue_dequeue(fixed_queue_t* queue) {
   CHECK(queue != NULL);
 
+  if (queue->ring) {
+    void* ret;
+    while ((ret = ring_try_dequeue(queue->ring)) == NULL) {
+      ring_clear_dequeue_signal(queue->ring);
+    }
+    ring_signal_remaining(queue->ring);
+    return ret;
+  }
+
   semaphore_wait(queue->dequeue_sem);
 
   void* ret = NULL;
@@ -149,6 +335,8 @@ bool fixed_queue_try_enqueue(fixed_queue_t* queue, void* data) {
   CHECK(queue != NULL);
   CHECK(data != NULL);
 
+  if (queue->ring) return ring_try_enqueue(queue->ring, data);
+
   if (!semaphore_try_wait(queue->enqueue_sem)) return false;
 
   {
@@ -163,6 +351,8 @@ bool fixed_queue_try_enqueue(fixed_queue_t* queue, void* data) {
 void* fixed_queue_try_dequeue(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
 
+  if (queue->ring) return ring_try_dequeue(queue->ring);
+
   if (!semaphore_try_wait(queue->dequeue_sem)) return NULL;
 
   void* ret = NULL;
@@ -180,12 +370,23 @@ void* fixed_queue_try_dequeue(fixed_queue_t* queue) {
 void* fixed_queue_try_peek_first(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
 
+  if (queue->ring) {
+    // Only meaningful on the consumer thread, like with the list.
+    fixed_queue_ring_t* ring = queue->ring;
+    size_t position = ring->dequeue_position.load();
+    fixed_queue_ring_t::cell_t* cell = &ring->cells[position & ring->mask];
+    return cell->sequence.load(std::memory_order_acquire) == position + 1
+               ? cell->data
+               : NULL;
+  }
+
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list) ? NULL : list_front(queue->list);
 }
 
 void* fixed_queue_try_peek_last(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
+  CHECK(queue->ring == NULL);  // Not supported by ring queues
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list) ? NULL : list_back(queue->list);
@@ -193,6 +394,7 @@ void* fixed_queue_try_peek_last(fixed_queue_t* queue) {
 
 void* fixed_queue_try_remove_from_queue(fixed_queue_t* queue, void* data) {
   if (queue == NULL) return NULL;
+  CHECK(queue->ring == NULL);  // Not supported by ring queues
 
   bool removed = false;
   {
@@ -213,6 +415,7 @@ void* fixed_queue_try_remove_from_queue(fixed_queue_t* queue, void* data) {
 
 list_t* fixed_queue_get_list(fixed_queue_t* queue) {
   CHECK(queue != NULL);
+  CHECK(queue->ring == NULL);  // Not supported by ring queues
 
   // NOTE: Using the list in this way is not thread-safe.
   // Using this list in any context where threads can call other functions
@@ -222,11 +425,13 @@ list_t* fixed_queue_get_list(fixed_queue_t* queue) {
 
 int fixed_queue_get_dequeue_fd(const fixed_queue_t* queue) {
   CHECK(queue != NULL);
+  if (queue->ring) return queue->ring->dequeue_fd;
   return semaphore_get_fd(queue->dequeue_sem);
 }
 
 int fixed_queue_get_enqueue_fd(const fixed_queue_t* queue) {
   CHECK(queue != NULL);
+  CHECK(queue->ring == NULL);  // Not supported by ring queues
   return semaphore_get_fd(queue->enqueue_sem);
 }
 
@@ -259,5 +464,21 @@ static void internal_dequeue_ready(void* context) {
   CHECK(context != NULL);
 
   fixed_queue_t* queue = static_cast<fixed_queue_t*>(context);
-  queue->dequeue_ready(queue, queue->dequeue_context);
+  if (!queue->ring) {
+    queue->dequeue_ready(queue, queue->dequeue_context);
+    return;
+  }
+
+  // Drain the batch signaled by a single |dequeue_fd| wakeup, for as long as
+  // the callback consumes the elements.
+  fixed_queue_ring_t* ring = queue->ring;
+  ring_clear_dequeue_signal(ring);
+  size_t length = ring_length(ring);
+  while (length > 0 && queue->dequeue_object != NULL) {
+    queue->dequeue_ready(queue, queue->dequeue_context);
+    size_t new_length = ring_length(ring);
+    if (new_length >= length) break;
+    length = new_length;
+  }
+  ring_signal_remaining(ring);
 }
@@ -0,0 +1,252 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_osi_packet_pool"
+
+#include "osi/packet_pool.h"
+
+#include <base/logging.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <atomic>
+#include <mutex>
+
+#include "check.h"
+#include "osi/include/log.h"
+
+// Slot size and slot count of each size class. The largest class holds
+// BT_DEFAULT_BUFFER_SIZE buffers, with room for the allocation tracker
+// canaries.
+static const size_t class_slot_size[] = {64, 256, 1024, 4608};
+static const size_t class_slot_count[] = {256, 256, 128, 128};
+#define PACKET_POOL_CLASS_COUNT \
+  (sizeof(class_slot_size) / sizeof(class_slot_size[0]))
+
+// Number of free slots cached per class by each thread, and the number of
+// slots moved at once between a thread cache and its pool.
+#define PACKET_POOL_CACHE_SIZE 16
+#define PACKET_POOL_CACHE_BATCH (PACKET_POOL_CACHE_SIZE / 2)
+
+typedef struct packet_pool_slot_t {
+  struct packet_pool_slot_t* next;
+} packet_pool_slot_t;
+
+typedef struct {
+  size_t slot_size;
+  size_t slot_count;
+  uint8_t* begin;
+
+  // Guards |free_slots| and |next_unused|. Slots past |next_unused| have
+  // never been used, which keeps their pages untouched until needed.
+  std::mutex lock;
+  packet_pool_slot_t* free_slots;
+  size_t next_unused;
+
+  // Statistics
+  std::atomic<size_t> alloc_count;
+  std::atomic<size_t> free_count;
+  std::atomic<size_t> exhausted_count;
+  std::atomic<size_t> peak_in_use;
+} packet_pool_class_t;
+
+typedef struct {
+  void* slots[PACKET_POOL_CACHE_SIZE];
+  size_t count;
+} packet_pool_cache_t;
+
+// The pools are never released: thread caches may return their slots
+// after the static destructors ran.
+static packet_pool_class_t* pool_classes;
+static std::atomic<uintptr_t> pool_begin;
+static std::atomic<uintptr_t> pool_end;
+static std::once_flag pool_once;
+static std::atomic<size_t> oversized_count;
+
+static void pool_class_push(packet_pool_class_t* pool_class, void** slots,
+                            size_t count);
+
+// Returns the cached slots of the thread to their pools on thread exit.
+class PacketPoolThreadCache {
+ public:
+  ~PacketPoolThreadCache() {
+    for (size_t i = 0; i < PACKET_POOL_CLASS_COUNT; i++) {
+      if (caches[i].count > 0) {
+        pool_class_push(&pool_classes[i], caches[i].slots, caches[i].count);
+        caches[i].count = 0;
+      }
+    }
+  }
+  packet_pool_cache_t caches[PACKET_POOL_CLASS_COUNT] = {};
+};
+
+static thread_local PacketPoolThreadCache thread_cache;
+
+static void pool_initialize(void) {
+  size_t total_size = 0;
+  for (size_t i = 0; i < PACKET_POOL_CLASS_COUNT; i++) {
+    total_size += class_slot_size[i] * class_slot_count[i];
+  }
+
+  // The region is only reserved: pages are backed on first use.
+  void* region = mmap(NULL, total_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (region == MAP_FAILED) {
+    LOG_ERROR("%s unable to reserve the packet pool: %s", __func__,
+              strerror(errno));
+    return;
+  }
+
+  pool_classes = new packet_pool_class_t[PACKET_POOL_CLASS_COUNT]();
+  uint8_t* begin = static_cast<uint8_t*>(region);
+  for (size_t i = 0; i < PACKET_POOL_CLASS_COUNT; i++) {
+    packet_pool_class_t* pool_class = &pool_classes[i];
+    pool_class->slot_size = class_slot_size[i];
+    pool_class->slot_count = class_slot_count[i];
+    pool_class->begin = begin;
+    pool_class->free_slots = NULL;
+    pool_class->next_unused = 0;
+    begin += class_slot_size[i] * class_slot_count[i];
+  }
+
+  // |pool_end| is published last, so the range is never seen half set.
+  pool_begin.store(reinterpret_cast<uintptr_t>(region),
+                   std::memory_order_relaxed);
+  pool_end.store(reinterpret_cast<uintptr_t>(begin), std::memory_order_release);
+}
+
+// Moves up to |count| free slots of |pool_class| to |slots|. Returns the
+// number of slots moved.
+static size_t pool_class_pop(packet_pool_class_t* pool_class, void** slots,
+                             size_t count) {
+  std::unique_lock<std::mutex> lock(pool_class->lock);
+  size_t popped = 0;
+  while (popped < count && pool_class->free_slots != NULL) {
+    slots[popped++] = pool_class->free_slots;
+    pool_class->free_slots = pool_class->free_slots->next;
+  }
+  while (popped < count && pool_class->next_unused < pool_class->slot_count) {
+    slots[popped++] =
+        pool_class->begin + pool_class->next_unused++ * pool_class->slot_size;
+  }
+  return popped;
+}
+
+static void pool_class_push(packet_pool_class_t* pool_class, void** slots,
+                            size_t count) {
+  std::unique_lock<std::mutex> lock(pool_class->lock);
+  for (size_t i = 0; i < count; i++) {
+    packet_pool_slot_t* slot = static_cast<packet_pool_slot_t*>(slots[i]);
+    slot->next = pool_class->free_slots;
+    pool_class->free_slots = slot;
+  }
+}
+
+static void pool_class_update_peak(packet_pool_class_t* pool_class) {
+  size_t in_use =
+      pool_class->alloc_count.load(std::memory_order_relaxed) -
+      pool_class->free_count.load(std::memory_order_relaxed);
+  size_t peak = pool_class->peak_in_use.load(std::memory_order_relaxed);
+  while (in_use > peak && !pool_class->peak_in_use.compare_exchange_weak(
+                              peak, in_use, std::memory_order_relaxed)) {
+  }
+}
+
+void* packet_pool_alloc(size_t size) {
+  size_t class_index = 0;
+  while (class_index < PACKET_POOL_CLASS_COUNT &&
+         class_slot_size[class_index] < size) {
+    class_index++;
+  }
+  if (class_index == PACKET_POOL_CLASS_COUNT) {
+    oversized_count.fetch_add(1, std::memory_order_relaxed);
+    return NULL;
+  }
+
+  std::call_once(pool_once, pool_initialize);
+  if (pool_classes == NULL) return NULL;
+
+  packet_pool_class_t* pool_class = &pool_classes[class_index];
+  packet_pool_cache_t* cache = &thread_cache.caches[class_index];
+  if (cache->count == 0) {
+    cache->count =
+        pool_class_pop(pool_class, cache->slots, PACKET_POOL_CACHE_BATCH);
+    if (cache->count == 0) {
+      pool_class->exhausted_count.fetch_add(1, std::memory_order_relaxed);
+      return NULL;
+    }
+  }
+
+  pool_class->alloc_count.fetch_add(1, std::memory_order_relaxed);
+  pool_class_update_peak(pool_class);
+  return cache->slots[--cache->count];
+}
+
+bool packet_pool_owns(const void* ptr) {
+  uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  uintptr_t end = pool_end.load(std::memory_order_acquire);
+  return address < end &&
+         address >= pool_begin.load(std::memory_order_relaxed);
+}
+
+void packet_pool_free(void* ptr) {
+  CHECK(packet_pool_owns(ptr));
+
+  uint8_t* address = static_cast<uint8_t*>(ptr);
+  size_t class_index = 0;
+  while (address >= pool_classes[class_index].begin +
+                        pool_classes[class_index].slot_size *
+                            pool_classes[class_index].slot_count) {
+    class_index++;
+  }
+
+  packet_pool_class_t* pool_class = &pool_classes[class_index];
+  size_t offset = address - pool_class->begin;
+  void* slot = pool_class->begin +
+               (offset / pool_class->slot_size) * pool_class->slot_size;
+  pool_class->free_count.fetch_add(1, std::memory_order_relaxed);
+
+  packet_pool_cache_t* cache = &thread_cache.caches[class_index];
+  if (cache->count == PACKET_POOL_CACHE_SIZE) {
+    cache->count -= PACKET_POOL_CACHE_BATCH;
+    pool_class_push(pool_class, &cache->slots[cache->count],
+                    PACKET_POOL_CACHE_BATCH);
+  }
+  cache->slots[cache->count++] = slot;
+}
+
+void packet_pool_debug_dump(int fd) {
+  dprintf(fd, "  Packet pool oversized allocations : %zu\n",
+          oversized_count.load(std::memory_order_relaxed));
+  if (pool_end.load(std::memory_order_acquire) == 0) return;
+
+  for (size_t i = 0; i < PACKET_POOL_CLASS_COUNT; i++) {
+    packet_pool_class_t* pool_class = &pool_classes[i];
+    size_t alloc_count = pool_class->alloc_count.load();
+    size_t free_count = pool_class->free_count.load();
+    dprintf(fd,
+            "  Packet pool %4zu octets class allocated/free/used/peak/slots : "
+            "%zu / %zu / %zu / %zu / %zu (exhausted %zu)\n",
+            pool_class->slot_size, alloc_count, free_count,
+            alloc_count - free_count, pool_class->peak_in_use.load(),
+            pool_class->slot_count, pool_class->exhausted_count.load());
+  }
+}
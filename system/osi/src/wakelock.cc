@@ -30,8 +30,11 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "base/logging.h"
 #include "check.h"
@@ -50,6 +53,7 @@ static bool is_native = true;
 
 static const clockid_t CLOCK_ID = CLOCK_BOOTTIME;
 static const char* WAKE_LOCK_ID = "bluetooth_timer";
+static const char* UNATTRIBUTED_SOURCE = "unattributed";
 static const std::string DEFAULT_WAKE_LOCK_PATH = "/sys/power/wake_lock";
 static const std::string DEFAULT_WAKE_UNLOCK_PATH = "/sys/power/wake_unlock";
 static std::string wake_lock_path;
@@ -79,6 +83,16 @@ typedef struct {
 
 static wakelock_stats_t wakelock_stats;
 
+// Hold time of the wakelock by the source that acquired it
+typedef struct {
+  size_t acquired_count;
+  uint64_t total_acquired_interval_ms;
+  uint64_t max_acquired_interval_ms;
+} wakelock_source_stats_t;
+
+static std::map<std::string, wakelock_source_stats_t> wakelock_source_stats;
+static std::string wakelock_acquired_source;
+
 // This mutex ensures that the functions that update and dump the statistics
 // are executed serially.
 static std::mutex stats_mutex;
@@ -90,7 +104,8 @@ static bt_status_t wakelock_release_native(void);
 static void wakelock_initialize(void);
 static void wakelock_initialize_native(void);
 static void reset_wakelock_stats(void);
-static void update_wakelock_acquired_stats(bt_status_t acquired_status);
+static void update_wakelock_acquired_stats(bt_status_t acquired_status,
+                                          const char* source);
 static void update_wakelock_released_stats(bt_status_t released_status);
 
 void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
@@ -100,6 +115,10 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
 }
 
 bool wakelock_acquire(void) {
+  return wakelock_acquire_for(UNATTRIBUTED_SOURCE);
+}
+
+bool wakelock_acquire_for(const char* source) {
   pthread_once(&initialized, wakelock_initialize);
 
   bt_status_t status = BT_STATUS_FAIL;
@@ -109,7 +128,7 @@ bool wakelock_acquire(void) {
   else
     status = wakelock_acquire_callout();
 
-  update_wakelock_acquired_stats(status);
+  update_wakelock_acquired_stats(status, source);
 
   if (status != BT_STATUS_SUCCESS)
     LOG_ERROR("%s unable to acquire wake lock: %d", __func__, status);
@@ -250,6 +269,8 @@ static void reset_wakelock_stats(void) {
   wakelock_stats.last_acquired_timestamp_ms = 0;
   wakelock_stats.last_released_timestamp_ms = 0;
   wakelock_stats.last_reset_timestamp_ms = now_ms();
+  wakelock_source_stats.clear();
+  wakelock_acquired_source.clear();
 }
 
 //
@@ -257,10 +278,11 @@ static void reset_wakelock_stats(void) {
 //
 // This function should be called every time when the wakelock is acquired.
 // |acquired_status| is the status code that was return when the wakelock was
-// acquired.
+// acquired, and |source| the source that acquired it.
 // This function is thread-safe.
 //
-static void update_wakelock_acquired_stats(bt_status_t acquired_status) {
+static void update_wakelock_acquired_stats(bt_status_t acquired_status,
+                                          const char* source) {
   const uint64_t just_now_ms = now_ms();
 
   std::lock_guard<std::mutex> lock(stats_mutex);
@@ -277,9 +299,12 @@ static void update_wakelock_acquired_stats(bt_status_t acquired_status) {
   wakelock_stats.is_acquired = true;
   wakelock_stats.acquired_count++;
   wakelock_stats.last_acquired_timestamp_ms = just_now_ms;
+  // While acquired, the wakelock is accounted to the source that acquired it
+  wakelock_acquired_source = source;
+  wakelock_source_stats[wakelock_acquired_source].acquired_count++;
 
   BluetoothMetricsLogger::GetInstance()->LogWakeEvent(
-      bluetooth::common::WAKE_EVENT_ACQUIRED, "", "", just_now_ms);
+      bluetooth::common::WAKE_EVENT_ACQUIRED, "", source, just_now_ms);
 }
 
 //
@@ -320,8 +345,15 @@ static void update_wakelock_released_stats(bt_status_t released_status) {
   wakelock_stats.last_acquired_interval_ms = delta_ms;
   wakelock_stats.total_acquired_interval_ms += delta_ms;
 
+  wakelock_source_stats_t& source_stats =
+      wakelock_source_stats[wakelock_acquired_source];
+  source_stats.total_acquired_interval_ms += delta_ms;
+  source_stats.max_acquired_interval_ms =
+      std::max(source_stats.max_acquired_interval_ms, delta_ms);
+
   BluetoothMetricsLogger::GetInstance()->LogWakeEvent(
-      bluetooth::common::WAKE_EVENT_RELEASED, "", "", just_now_ms);
+      bluetooth::common::WAKE_EVENT_RELEASED, "",
+      wakelock_acquired_source.c_str(), just_now_ms);
 }
 
 void wakelock_debug_dump(int fd) {
@@ -369,4 +401,28 @@ void wakelock_debug_dump(int fd) {
   dprintf(fd, "  Total run time (ms)            : %llu\n",
           (unsigned long long)(just_now_ms -
                                wakelock_stats.last_reset_timestamp_ms));
+
+  if (wakelock_source_stats.empty()) return;
+
+  // The sources holding the wakelock the longest first
+  std::vector<std::pair<std::string, wakelock_source_stats_t>> sources(
+      wakelock_source_stats.begin(), wakelock_source_stats.end());
+  for (auto& [source, source_stats] : sources) {
+    if (wakelock_stats.is_acquired && source == wakelock_acquired_source) {
+      source_stats.total_acquired_interval_ms += delta_ms;
+      source_stats.max_acquired_interval_ms =
+          std::max(source_stats.max_acquired_interval_ms, delta_ms);
+    }
+  }
+  std::sort(sources.begin(), sources.end(), [](const auto& a, const auto& b) {
+    return a.second.total_acquired_interval_ms >
+           b.second.total_acquired_interval_ms;
+  });
+  dprintf(fd, "  Acquired time by source (ms)   : count / total / max\n");
+  for (const auto& [source, source_stats] : sources) {
+    dprintf(fd, "    %-28s: %zu / %llu / %llu\n", source.c_str(),
+            source_stats.acquired_count,
+            (unsigned long long)source_stats.total_acquired_interval_ms,
+            (unsigned long long)source_stats.max_acquired_interval_ms);
+  }
 }
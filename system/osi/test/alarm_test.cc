@@ -21,6 +21,7 @@
 
 #include "AlarmTestHarness.h"
 
+#include "common/init_flags.h"
 #include "common/message_loop_thread.h"
 #include "osi/include/alarm.h"
 #include "osi/include/fixed_queue.h"
@@ -250,6 +251,23 @@ TEST_F(AlarmTest, test_set_long_long) {
   alarm_free(alarm[1]);
 }
 
+TEST_F(AlarmTest, test_set_with_slack) {
+  alarm_t* alarm[2] = {alarm_new("alarm_test.test_set_with_slack_0"),
+                       alarm_new("alarm_test.test_set_with_slack_1")};
+
+  alarm_set_with_slack(alarm[0], 10, 100, cb, NULL);
+  alarm_set_with_slack(alarm[1], 20, 100, cb, NULL);
+  EXPECT_LE(alarm_get_remaining_ms(alarm[0]), 10u + 100u);
+  EXPECT_LE(alarm_get_remaining_ms(alarm[1]), 20u + 100u);
+
+  semaphore_wait(semaphore);
+  semaphore_wait(semaphore);
+  EXPECT_EQ(cb_counter, 2);
+
+  alarm_free(alarm[0]);
+  alarm_free(alarm[1]);
+}
+
 TEST_F(AlarmTest, test_is_scheduled) {
   alarm_t* alarm = alarm_new("alarm_test.test_is_scheduled");
 
@@ -357,3 +375,82 @@ TEST_F(AlarmTest, test_delete_during_callback) {
   }
   alarm_cleanup();
 }
+
+class AlarmHeapTest : public AlarmTest {
+ protected:
+  void SetUp() override {
+    const char* test_flags[] = {"INIT_osi_alarm_heap=true", nullptr};
+    bluetooth::common::InitFlags::Load(test_flags);
+    AlarmTest::SetUp();
+  }
+
+  void TearDown() override {
+    AlarmTest::TearDown();
+    bluetooth::common::InitFlags::Load(nullptr);
+  }
+};
+
+// Alarms with different deadlines are dispatched by deadline, and alarms with
+// the same deadline in the order they were set.
+TEST_F(AlarmHeapTest, test_callback_ordering) {
+  alarm_t* alarms[100];
+
+  for (int i = 0; i < 100; i++) {
+    const std::string alarm_name =
+        "alarm_test.heap_test_callback_ordering[" + std::to_string(i) + "]";
+    alarms[i] = alarm_new(alarm_name.c_str());
+  }
+
+  for (int i = 99; i >= 50; i--) {
+    alarm_set(alarms[i], 100 + 10 * (i - 49), ordered_cb, INT_TO_PTR(i));
+  }
+  for (int i = 0; i < 50; i++) {
+    alarm_set(alarms[i], 100, ordered_cb, INT_TO_PTR(i));
+  }
+
+  for (int i = 1; i <= 100; i++) {
+    semaphore_wait(semaphore);
+    EXPECT_GE(cb_counter, i);
+  }
+  EXPECT_EQ(cb_counter, 100);
+  EXPECT_EQ(cb_misordered_counter, 0);
+
+  for (int i = 0; i < 100; i++) alarm_free(alarms[i]);
+
+  EXPECT_FALSE(WakeLockHeld());
+}
+
+TEST_F(AlarmHeapTest, test_cancel_and_reschedule) {
+  alarm_t* alarms[100];
+
+  for (int i = 0; i < 100; i++) {
+    const std::string alarm_name =
+        "alarm_test.heap_test_cancel_and_reschedule[" + std::to_string(i) + "]";
+    alarms[i] = alarm_new(alarm_name.c_str());
+    alarm_set(alarms[i], 50 + (i * 37) % 100, cb, NULL);
+  }
+
+  // Cancel every other alarm, then move the others around.
+  for (int i = 0; i < 100; i += 2) {
+    alarm_cancel(alarms[i]);
+    EXPECT_FALSE(alarm_is_scheduled(alarms[i]));
+  }
+  for (int i = 1; i < 100; i += 2) {
+    alarm_set(alarms[i], 150 - i, cb, NULL);
+    EXPECT_TRUE(alarm_is_scheduled(alarms[i]));
+  }
+
+  for (int i = 1; i <= 50; i++) {
+    semaphore_wait(semaphore);
+  }
+  EXPECT_EQ(cb_counter, 50);
+
+  msleep(EPSILON_MS);
+  EXPECT_EQ(cb_counter, 50);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_FALSE(alarm_is_scheduled(alarms[i]));
+    alarm_free(alarms[i]);
+  }
+
+  EXPECT_FALSE(WakeLockHeld());
+}
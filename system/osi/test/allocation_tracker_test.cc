@@ -18,6 +18,9 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+#include <vector>
+
 #include "osi/include/allocation_tracker.h"
 
 void allocation_tracker_uninit(void);
@@ -62,3 +65,49 @@ TEST(AllocationTrackerTest, test_canaries_on) {
 
   free(dummy_allocation);
 }
+
+TEST(AllocationTrackerTest, test_sampling_every_allocation) {
+  allocation_tracker_uninit();
+  allocation_tracker_init_sampling(1);
+
+  size_t with_header_size = allocation_tracker_resize_for_canary(4);
+  EXPECT_TRUE(with_header_size > 4);
+
+  void* dummy_allocation = malloc(with_header_size);
+  void* useable_ptr =
+      allocation_tracker_notify_alloc(allocator_id, dummy_allocation, 4);
+  EXPECT_TRUE(useable_ptr > dummy_allocation);
+  EXPECT_EQ(4U, allocation_tracker_expect_no_allocations());
+
+  void* freeable_ptr =
+      allocation_tracker_notify_free(allocator_id, useable_ptr);
+  EXPECT_EQ(dummy_allocation, freeable_ptr);
+  EXPECT_EQ(0U, allocation_tracker_expect_no_allocations());
+
+  free(dummy_allocation);
+  allocation_tracker_uninit();
+}
+
+TEST(AllocationTrackerTest, test_sampling_estimates_live_octets) {
+  allocation_tracker_uninit();
+  allocation_tracker_init_sampling(4);
+
+  // One allocation in four is sampled, and accounts for four of them
+  std::vector<void*> allocations;
+  for (int i = 0; i < 8; i++) {
+    void* ptr = malloc(allocation_tracker_resize_for_canary(10));
+    allocations.push_back(
+        allocation_tracker_notify_alloc(allocator_id, ptr, 10));
+  }
+  EXPECT_EQ(80U, allocation_tracker_expect_no_allocations());
+
+  // The allocations may be freed on another thread
+  std::thread([&allocations]() {
+    for (void* ptr : allocations) {
+      free(allocation_tracker_notify_free(allocator_id, ptr));
+    }
+  }).join();
+  EXPECT_EQ(0U, allocation_tracker_expect_no_allocations());
+
+  allocation_tracker_uninit();
+}
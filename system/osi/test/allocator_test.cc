@@ -16,6 +16,8 @@
  *
  ******************************************************************************/
 #include <cstring>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -50,3 +52,60 @@ TEST_F(AllocatorTest, test_osi_strndup) {
   EXPECT_EQ(0, strcmp(str, copy_str));
   osi_free(copy_str);
 }
+
+TEST_F(AllocatorTest, test_osi_malloc_packet) {
+  // Freed packets are reused by the same thread.
+  void* packet = osi_malloc_packet(200);
+  ASSERT_NE(nullptr, packet);
+  memset(packet, 0xff, 200);
+  osi_free(packet);
+  EXPECT_EQ(packet, osi_malloc_packet(180));
+  osi_free(packet);
+
+  uint8_t* zeroed = static_cast<uint8_t*>(osi_calloc_packet(1000));
+  ASSERT_NE(nullptr, zeroed);
+  for (size_t i = 0; i < 1000; i++) {
+    EXPECT_EQ(0, zeroed[i]);
+  }
+  osi_free(zeroed);
+
+  // Buffers larger than the largest size class fall back to osi_malloc.
+  void* large = osi_malloc_packet(64 * 1024);
+  ASSERT_NE(nullptr, large);
+  memset(large, 0, 64 * 1024);
+  osi_free(large);
+}
+
+TEST_F(AllocatorTest, test_osi_malloc_packet_exhausted) {
+  // Packets keep being allocated once the size class runs out of slots.
+  std::vector<void*> packets;
+  for (size_t i = 0; i < 1024; i++) {
+    void* packet = osi_malloc_packet(64);
+    ASSERT_NE(nullptr, packet);
+    memset(packet, 0, 64);
+    packets.push_back(packet);
+  }
+  for (void* packet : packets) {
+    osi_free(packet);
+  }
+}
+
+TEST_F(AllocatorTest, test_osi_malloc_packet_free_on_other_thread) {
+  std::vector<void*> packets;
+  for (size_t i = 0; i < 100; i++) {
+    packets.push_back(osi_malloc_packet(4096));
+  }
+  std::thread([&packets]() {
+    for (void* packet : packets) {
+      osi_free(packet);
+    }
+  }).join();
+
+  for (size_t i = 0; i < 100; i++) {
+    packets[i] = osi_malloc_packet(4096);
+    ASSERT_NE(nullptr, packets[i]);
+  }
+  for (void* packet : packets) {
+    osi_free(packet);
+  }
+}
@@ -149,6 +149,43 @@ TEST_F(ConfigTest, config_new) {
   EXPECT_TRUE(config.get() != NULL);
 }
 
+TEST_F(ConfigTest, config_new_empty_file) {
+  FILE* fp = fopen(CONFIG_FILE, "wt");
+  ASSERT_NE(fp, nullptr);
+  ASSERT_EQ(fclose(fp), 0);
+
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  ASSERT_TRUE(config.get() != NULL);
+  EXPECT_TRUE(config->sections.empty());
+}
+
+TEST_F(ConfigTest, config_new_without_trailing_newline) {
+  static const char content[] = "[A]\r\nkey = one\r\n[B]\n[A]\nkey=two";
+  FILE* fp = fopen(CONFIG_FILE, "wt");
+  ASSERT_NE(fp, nullptr);
+  ASSERT_EQ(fwrite(content, 1, sizeof(content) - 1, fp), sizeof(content) - 1);
+  ASSERT_EQ(fclose(fp), 0);
+
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  ASSERT_TRUE(config.get() != NULL);
+  EXPECT_EQ(config->sections.size(), 1u);
+  EXPECT_FALSE(config_has_section(*config, "B"));
+  EXPECT_EQ(*config_get_string(*config, "A", "key", NULL), "two");
+}
+
+TEST_F(ConfigTest, config_new_bad_lines) {
+  static const char unterminated[] = "[A\nkey = one\n";
+  static const char no_separator[] = "[A]\nkey one\n";
+  for (const char* content : {unterminated, no_separator}) {
+    FILE* fp = fopen(CONFIG_FILE, "wt");
+    ASSERT_NE(fp, nullptr);
+    ASSERT_GE(fputs(content, fp), 0);
+    ASSERT_EQ(fclose(fp), 0);
+
+    EXPECT_TRUE(config_new(CONFIG_FILE).get() == NULL);
+  }
+}
+
 TEST_F(ConfigTest, config_new_clone) {
   std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
   std::unique_ptr<config_t> clone = config_new_clone(*config);
@@ -348,3 +348,77 @@ TEST_F(FixedQueueTest, test_fixed_queue_register_dequeue) {
   thread_free(worker_thread);
   fixed_queue_free(queue, NULL);
 }
+
+TEST_F(FixedQueueTest, test_fixed_queue_ring_enqueue_dequeue) {
+  // The capacity is rounded up to a power of two
+  fixed_queue_t* queue = fixed_queue_new_ring(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+  EXPECT_EQ((size_t)16, fixed_queue_capacity(queue));
+  EXPECT_TRUE(fixed_queue_is_empty(queue));
+
+  fixed_queue_enqueue(queue, (void*)DUMMY_DATA_STRING1);
+  EXPECT_TRUE(fixed_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING2));
+  EXPECT_EQ((size_t)2, fixed_queue_length(queue));
+  EXPECT_EQ(DUMMY_DATA_STRING1, fixed_queue_try_peek_first(queue));
+  EXPECT_EQ(DUMMY_DATA_STRING1, fixed_queue_dequeue(queue));
+  EXPECT_EQ(DUMMY_DATA_STRING2, fixed_queue_try_dequeue(queue));
+  EXPECT_EQ(NULL, fixed_queue_try_dequeue(queue));
+  EXPECT_EQ(NULL, fixed_queue_try_peek_first(queue));
+
+  // Wrap around the ring several times
+  for (size_t i = 0; i < 5; i++) {
+    for (size_t j = 0; j < 16; j++) {
+      EXPECT_TRUE(fixed_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING));
+    }
+    EXPECT_FALSE(fixed_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING));
+    for (size_t j = 0; j < 16; j++) {
+      EXPECT_EQ(DUMMY_DATA_STRING, fixed_queue_try_dequeue(queue));
+    }
+  }
+
+  test_queue_entry_free_counter = 0;
+  fixed_queue_enqueue(queue, (void*)DUMMY_DATA_STRING1);
+  fixed_queue_enqueue(queue, (void*)DUMMY_DATA_STRING2);
+  fixed_queue_free(queue, test_queue_entry_free_cb);
+  EXPECT_EQ(2, test_queue_entry_free_counter);
+}
+
+static size_t ring_received_counter = 0;
+
+// Dequeue one message, and complete the future with the last one.
+static void fixed_queue_ring_ready(fixed_queue_t* queue,
+                                   UNUSED_ATTR void* context) {
+  void* msg = fixed_queue_try_dequeue(queue);
+  EXPECT_TRUE(msg != NULL);
+  if (++ring_received_counter == 3 * TEST_QUEUE_SIZE) {
+    future_ready(received_message_future, msg);
+  }
+}
+
+TEST_F(FixedQueueTest, test_fixed_queue_ring_register_dequeue) {
+  fixed_queue_t* queue = fixed_queue_new_ring(4 * TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+
+  received_message_future = future_new();
+  ASSERT_TRUE(received_message_future != NULL);
+  ring_received_counter = 0;
+
+  thread_t* worker_thread = thread_new("test_fixed_queue_worker_thread");
+  ASSERT_TRUE(worker_thread != NULL);
+
+  fixed_queue_register_dequeue(queue, thread_get_reactor(worker_thread),
+                               fixed_queue_ring_ready, NULL);
+
+  // All the messages are received, whether they were signaled in a single
+  // batch or not
+  for (size_t i = 0; i < 3 * TEST_QUEUE_SIZE; i++) {
+    fixed_queue_enqueue(queue, (void*)DUMMY_DATA_STRING);
+  }
+  const char* msg = (const char*)future_await(received_message_future);
+  EXPECT_EQ(DUMMY_DATA_STRING, msg);
+  EXPECT_TRUE(fixed_queue_is_empty(queue));
+
+  fixed_queue_unregister_dequeue(queue);
+  thread_free(worker_thread);
+  fixed_queue_free(queue, NULL);
+}
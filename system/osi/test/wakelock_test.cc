@@ -20,10 +20,13 @@
 
 #include <base/logging.h>
 #include <fcntl.h>
+#include <stdio.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <string>
+
 #include "osi/include/wakelock.h"
 
 #include "AllocationTestHarness.h"
@@ -161,3 +164,28 @@ TEST_F(WakelockTest, test_set_paths) {
     ASSERT_FALSE(IsFileWakeLockAcquired());
   }
 }
+
+TEST_F(WakelockTest, test_acquired_time_by_source) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+
+  wakelock_acquire_for("first_source");
+  wakelock_release();
+  wakelock_acquire_for("second_source");
+  // Already acquired, the wakelock stays accounted to the second source
+  wakelock_acquire_for("first_source");
+  wakelock_release();
+
+  FILE* dump = tmpfile();
+  ASSERT_NE(dump, nullptr);
+  wakelock_debug_dump(fileno(dump));
+  fflush(dump);
+  rewind(dump);
+  std::string output;
+  char line[256];
+  while (fgets(line, sizeof(line), dump) != nullptr) output += line;
+  fclose(dump);
+
+  EXPECT_NE(output.find("first_source"), std::string::npos);
+  EXPECT_NE(output.find("second_source"), std::string::npos);
+  EXPECT_NE(output.find("Acquired time by source"), std::string::npos);
+}
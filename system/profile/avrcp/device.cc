@@ -15,6 +15,8 @@
  */
 #include "device.h"
 
+#include <algorithm>
+
 #include "abstract_message_loop.h"
 #include "avrcp_common.h"
 #include "connection_handler.h"
@@ -1131,15 +1133,14 @@ void Device::HandleGetFolderItems(uint8_t label,
                      weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
     case Scope::VFS:
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
-          base::Bind(&Device::GetVFSListResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label, pkt));
+      GetFolderListing(false, base::Bind(&Device::GetVFSListResponse,
+                                         weak_ptr_factory_.GetWeakPtr(),
+                                         label, pkt));
       break;
     case Scope::NOW_PLAYING:
-      media_interface_->GetNowPlayingList(
-          base::Bind(&Device::GetNowPlayingListResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label, pkt));
+      GetNowPlayingListing(base::Bind(&Device::GetNowPlayingListResponse,
+                                      weak_ptr_factory_.GetWeakPtr(), label,
+                                      pkt));
       break;
     default:
       DEVICE_LOG(ERROR) << __func__ << ": " << pkt->GetScope();
@@ -1168,13 +1169,12 @@ void Device::HandleGetTotalNumberOfItems(
       break;
     }
     case Scope::VFS:
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
-          base::Bind(&Device::GetTotalNumberOfItemsVFSResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label));
+      GetFolderListing(false,
+                       base::Bind(&Device::GetTotalNumberOfItemsVFSResponse,
+                                  weak_ptr_factory_.GetWeakPtr(), label));
       break;
     case Scope::NOW_PLAYING:
-      media_interface_->GetNowPlayingList(
+      GetNowPlayingListing(
           base::Bind(&Device::GetTotalNumberOfItemsNowPlayingResponse,
                      weak_ptr_factory_.GetWeakPtr(), label));
       break;
@@ -1193,8 +1193,8 @@ void Device::GetTotalNumberOfItemsMediaPlayersResponse(
   send_message(label, true, std::move(builder));
 }
 
-void Device::GetTotalNumberOfItemsVFSResponse(uint8_t label,
-                                              std::vector<ListItem> list) {
+void Device::GetTotalNumberOfItemsVFSResponse(
+    uint8_t label, const std::vector<ListItem>& list) {
   DEVICE_VLOG(2) << __func__ << ": num_items=" << list.size();
 
   auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
@@ -1203,7 +1203,8 @@ void Device::GetTotalNumberOfItemsVFSResponse(uint8_t label,
 }
 
 void Device::GetTotalNumberOfItemsNowPlayingResponse(
-    uint8_t label, std::string curr_song_id, std::vector<SongInfo> list) {
+    uint8_t label, const std::string& curr_song_id,
+    const std::vector<SongInfo>& list) {
   DEVICE_VLOG(2) << __func__ << ": num_items=" << list.size();
 
   auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
@@ -1252,17 +1253,16 @@ void Device::HandleChangePath(uint8_t label,
                    << "\"";
   }
 
-  media_interface_->GetFolderItems(
-      curr_browsed_player_id_, CurrentFolder(),
-      base::Bind(&Device::ChangePathResponse, weak_ptr_factory_.GetWeakPtr(),
-                 label, pkt));
+  // The folder entered is always fetched again, so that its listing is up to
+  // date for the folder items requests that follow.
+  GetFolderListing(true, base::Bind(&Device::ChangePathResponse,
+                                    weak_ptr_factory_.GetWeakPtr(), label,
+                                    pkt));
 }
 
 void Device::ChangePathResponse(uint8_t label,
                                 std::shared_ptr<ChangePathRequest> pkt,
-                                std::vector<ListItem> list) {
-  // TODO (apanicke): Reconstruct the VFS ID's here. Right now it gets
-  // reconstructed in GetFolderItemsVFS
+                                const std::vector<ListItem>& list) {
   auto builder =
       ChangePathResponseBuilder::MakeBuilder(Status::NO_ERROR, list.size());
   send_message(label, true, std::move(builder));
@@ -1290,7 +1290,7 @@ void Device::HandleGetItemAttributes(
 
   switch (pkt->GetScope()) {
     case Scope::NOW_PLAYING: {
-      media_interface_->GetNowPlayingList(
+      GetNowPlayingListing(
           base::Bind(&Device::GetItemAttributesNowPlayingResponse,
                      weak_ptr_factory_.GetWeakPtr(), label, pkt));
     } break;
@@ -1299,10 +1299,9 @@ void Device::HandleGetItemAttributes(
       // then we can auto send the error without calling up. We do this check
       // later right now though in order to prevent race conditions with updates
       // on the media layer.
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
-          base::Bind(&Device::GetItemAttributesVFSResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label, pkt));
+      GetFolderListing(false,
+                       base::Bind(&Device::GetItemAttributesVFSResponse,
+                                  weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
     default:
       DEVICE_LOG(ERROR) << "UNKNOWN SCOPE FOR HANDLE GET ITEM ATTRIBUTES";
@@ -1312,7 +1311,7 @@ void Device::HandleGetItemAttributes(
 
 void Device::GetItemAttributesNowPlayingResponse(
     uint8_t label, std::shared_ptr<GetItemAttributesRequest> pkt,
-    std::string curr_media_id, std::vector<SongInfo> song_list) {
+    const std::string& curr_media_id, const std::vector<SongInfo>& song_list) {
   DEVICE_VLOG(2) << __func__ << ": uid=" << loghex(pkt->GetUid());
   auto builder = GetItemAttributesResponseBuilder::MakeBuilder(Status::NO_ERROR,
                                                                browse_mtu_);
@@ -1363,7 +1362,7 @@ void Device::GetItemAttributesNowPlayingResponse(
 
 void Device::GetItemAttributesVFSResponse(
     uint8_t label, std::shared_ptr<GetItemAttributesRequest> pkt,
-    std::vector<ListItem> item_list) {
+    const std::vector<ListItem>& item_list) {
   DEVICE_VLOG(2) << __func__ << ": uid=" << loghex(pkt->GetUid());
 
   auto media_id = vfs_ids_.get_media_id(pkt->GetUid());
@@ -1479,7 +1478,7 @@ std::set<AttributeEntry> filter_attributes_requested(
 
 void Device::GetVFSListResponse(uint8_t label,
                                 std::shared_ptr<GetFolderItemsRequest> pkt,
-                                std::vector<ListItem> items) {
+                                const std::vector<ListItem>& items) {
   DEVICE_VLOG(2) << __func__ << ": start_item=" << pkt->GetStartItem()
                  << " end_item=" << pkt->GetEndItem();
 
@@ -1487,25 +1486,14 @@ void Device::GetVFSListResponse(uint8_t label,
   auto builder = GetFolderItemsResponseBuilder::MakeVFSBuilder(
       Status::NO_ERROR, 0x0000, browse_mtu_);
 
-  // TODO (apanicke): Add test that checks if vfs_ids_ is the correct size after
-  // an operation.
-  for (const auto& item : items) {
-    if (item.type == ListItem::FOLDER) {
-      vfs_ids_.insert(item.folder.media_id);
-    } else if (item.type == ListItem::SONG) {
-      vfs_ids_.insert(item.song.media_id);
-    }
-  }
-
-  // Add the elements retrieved in the last get folder items request and map
-  // them to UIDs The maps will be cleared every time a directory change
-  // happens. These items do not need to correspond with the now playing list as
-  // the UID's only need to be unique in the context of the current scope and
-  // the current folder
+  // Only the requested page is built. The items were mapped to UIDs when the
+  // listing was fetched. These items do not need to correspond with the now
+  // playing list as the UID's only need to be unique in the context of the
+  // current scope and the current folder
   for (auto i = pkt->GetStartItem(); i <= pkt->GetEndItem() && i < items.size();
        i++) {
     if (items[i].type == ListItem::FOLDER) {
-      auto folder = items[i].folder;
+      const auto& folder = items[i].folder;
       // right now we always use folders of mixed type
       FolderItem folder_item(vfs_ids_.get_uid(folder.media_id), 0x00,
                              folder.is_playable, folder.name);
@@ -1543,16 +1531,12 @@ void Device::GetVFSListResponse(uint8_t label,
 
 void Device::GetNowPlayingListResponse(
     uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
-    std::string /* unused curr_song_id */, std::vector<SongInfo> song_list) {
+    const std::string& /* unused curr_song_id */,
+    const std::vector<SongInfo>& song_list) {
   DEVICE_VLOG(2) << __func__;
   auto builder = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
       Status::NO_ERROR, 0x0000, browse_mtu_);
 
-  now_playing_ids_.clear();
-  for (const SongInfo& song : song_list) {
-    now_playing_ids_.insert(song.media_id);
-  }
-
   for (size_t i = pkt->GetStartItem();
        i <= pkt->GetEndItem() && i < song_list.size(); i++) {
     auto song = song_list[i];
@@ -1582,6 +1566,119 @@ void Device::GetNowPlayingListResponse(
   send_message(label, true, std::move(builder));
 }
 
+void Device::GetFolderListing(bool refresh, ListItemsCallback cb) {
+  // Players are database unaware, their UID counter is always 0
+  ListingKey key(Scope::VFS, CurrentFolder(), 0x0000);
+  if (!refresh) {
+    auto it = listings_.find(key);
+    if (it != listings_.end()) {
+      DEVICE_VLOG(3) << __func__ << ": Listing of \"" << CurrentFolder()
+                     << "\" is kept";
+      cb.Run(it->second.items);
+      return;
+    }
+  }
+
+  media_interface_->GetFolderItems(
+      curr_browsed_player_id_, CurrentFolder(),
+      base::Bind(&Device::FolderListingReceived, weak_ptr_factory_.GetWeakPtr(),
+                 key, listings_generation_, cb));
+}
+
+void Device::FolderListingReceived(ListingKey key, uint32_t generation,
+                                   ListItemsCallback cb,
+                                   std::vector<ListItem> items) {
+  // Map the items to UIDs once per listing rather than for every page
+  // requested. The UIDs are never cleared so that those sent to the remote
+  // device stay valid.
+  for (const auto& item : items) {
+    if (item.type == ListItem::FOLDER) {
+      vfs_ids_.insert(item.folder.media_id);
+    } else if (item.type == ListItem::SONG) {
+      vfs_ids_.insert(item.song.media_id);
+    }
+  }
+
+  if (generation != listings_generation_) {
+    cb.Run(items);
+    return;
+  }
+
+  Listing listing;
+  listing.items = std::move(items);
+  cb.Run(StoreListing(key, std::move(listing)).items);
+}
+
+void Device::GetNowPlayingListing(SongListCallback cb) {
+  ListingKey key(Scope::NOW_PLAYING, "", 0x0000);
+  auto it = listings_.find(key);
+  if (it != listings_.end()) {
+    DEVICE_VLOG(3) << __func__ << ": Now playing listing is kept";
+    cb.Run(it->second.curr_song_id, it->second.songs);
+    return;
+  }
+
+  media_interface_->GetNowPlayingList(
+      base::Bind(&Device::NowPlayingListingReceived,
+                 weak_ptr_factory_.GetWeakPtr(), listings_generation_, cb));
+}
+
+void Device::NowPlayingListingReceived(uint32_t generation,
+                                       SongListCallback cb,
+                                       std::string curr_song_id,
+                                       std::vector<SongInfo> songs) {
+  now_playing_ids_.clear();
+  now_playing_ids_.reserve(songs.size());
+  for (const SongInfo& song : songs) {
+    now_playing_ids_.insert(song.media_id);
+  }
+
+  if (generation != listings_generation_) {
+    cb.Run(curr_song_id, songs);
+    return;
+  }
+
+  Listing listing;
+  listing.curr_song_id = std::move(curr_song_id);
+  listing.songs = std::move(songs);
+  const Listing& kept = StoreListing(
+      ListingKey(Scope::NOW_PLAYING, "", 0x0000), std::move(listing));
+  cb.Run(kept.curr_song_id, kept.songs);
+}
+
+const Device::Listing& Device::StoreListing(const ListingKey& key,
+                                            Listing listing) {
+  auto order_it =
+      std::find(listing_order_.begin(), listing_order_.end(), key);
+  if (order_it != listing_order_.end()) listing_order_.erase(order_it);
+  listing_order_.push_back(key);
+  listings_[key] = std::move(listing);
+
+  while (listing_order_.size() > kMaxListings) {
+    listings_.erase(listing_order_.front());
+    listing_order_.pop_front();
+  }
+  return listings_[key];
+}
+
+void Device::DropListings(Scope scope) {
+  listings_generation_++;
+  for (auto it = listing_order_.begin(); it != listing_order_.end();) {
+    if (std::get<Scope>(*it) == scope) {
+      listings_.erase(*it);
+      it = listing_order_.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+void Device::ClearListings() {
+  listings_generation_++;
+  listings_.clear();
+  listing_order_.clear();
+}
+
 void Device::HandleSetBrowsedPlayer(
     uint8_t label, std::shared_ptr<SetBrowsedPlayerRequest> pkt) {
   if (!pkt->IsValid()) {
@@ -1624,6 +1721,7 @@ void Device::SetBrowsedPlayerResponse(
   // Clear the path and push the new root.
   current_path_ = std::stack<std::string>();
   current_path_.push(root_id);
+  ClearListings();
 
   auto response = SetBrowsedPlayerResponseBuilder::MakeBuilder(
       Status::NO_ERROR, 0x0000, num_items, 0, "");
@@ -1638,6 +1736,9 @@ void Device::SendMediaUpdate(bool metadata, bool play_status, bool queue) {
                  << " : play_status= " << play_status << " : queue=" << queue
                  << " ; is_silence=" << is_silence;
 
+  // The current song is part of the now playing listing
+  if (queue || metadata) DropListings(Scope::NOW_PLAYING);
+
   if (queue) {
     HandleNowPlayingUpdate();
   }
@@ -1657,6 +1758,8 @@ void Device::SendFolderUpdate(bool available_players, bool addressed_player,
   CHECK(media_interface_);
   DEVICE_VLOG(4) << __func__;
 
+  if (available_players || addressed_player || uids) ClearListings();
+
   if (available_players) {
     HandleAvailablePlayerUpdate();
   }
@@ -1834,6 +1937,7 @@ void Device::HandleAddressedPlayerUpdate() {
 void Device::DeviceDisconnected() {
   DEVICE_LOG(INFO) << "Device was disconnected";
   play_pos_update_cb_.Cancel();
+  ClearListings();
 
   // TODO (apanicke): Once the interfaces are set in the Device construction,
   // remove these conditionals.
@@ -19,9 +19,12 @@
 #include <base/cancelable_callback.h>
 #include <base/functional/bind.h>
 
+#include <deque>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <stack>
+#include <tuple>
 
 #include "avrcp_internal.h"
 #include "hardware/avrcp/avrcp.h"
@@ -222,30 +225,32 @@ class Device {
       uint16_t curr_player, std::vector<MediaPlayerInfo> players);
   virtual void GetVFSListResponse(uint8_t label,
                                   std::shared_ptr<GetFolderItemsRequest> pkt,
-                                  std::vector<ListItem> items);
+                                  const std::vector<ListItem>& items);
   virtual void GetNowPlayingListResponse(
       uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
-      std::string curr_song_id, std::vector<SongInfo> song_list);
+      const std::string& curr_song_id, const std::vector<SongInfo>& song_list);
 
   // GET TOTAL NUMBER OF ITEMS
   virtual void HandleGetTotalNumberOfItems(
       uint8_t label, std::shared_ptr<GetTotalNumberOfItemsRequest> pkt);
   virtual void GetTotalNumberOfItemsMediaPlayersResponse(
       uint8_t label, uint16_t curr_player, std::vector<MediaPlayerInfo> list);
-  virtual void GetTotalNumberOfItemsVFSResponse(uint8_t label,
-                                                std::vector<ListItem> items);
+  virtual void GetTotalNumberOfItemsVFSResponse(
+      uint8_t label, const std::vector<ListItem>& items);
   virtual void GetTotalNumberOfItemsNowPlayingResponse(
-      uint8_t label, std::string curr_song_id, std::vector<SongInfo> song_list);
+      uint8_t label, const std::string& curr_song_id,
+      const std::vector<SongInfo>& song_list);
 
   // GET ITEM ATTRIBUTES
   virtual void HandleGetItemAttributes(
       uint8_t label, std::shared_ptr<GetItemAttributesRequest> request);
   virtual void GetItemAttributesNowPlayingResponse(
       uint8_t label, std::shared_ptr<GetItemAttributesRequest> pkt,
-      std::string curr_media_id, std::vector<SongInfo> song_list);
+      const std::string& curr_media_id,
+      const std::vector<SongInfo>& song_list);
   virtual void GetItemAttributesVFSResponse(
       uint8_t label, std::shared_ptr<GetItemAttributesRequest> pkt,
-      std::vector<ListItem> item_list);
+      const std::vector<ListItem>& item_list);
 
   // SET BROWSED PLAYER
   virtual void HandleSetBrowsedPlayer(
@@ -259,7 +264,7 @@ class Device {
                                 std::shared_ptr<ChangePathRequest> request);
   virtual void ChangePathResponse(uint8_t label,
                                   std::shared_ptr<ChangePathRequest> request,
-                                  std::vector<ListItem> list);
+                                  const std::vector<ListItem>& list);
 
   // PLAY ITEM
   virtual void HandlePlayItem(uint8_t label,
@@ -326,6 +331,40 @@ class Device {
     active_labels_.erase(label);
     send_message_cb_.Run(label, browse, std::move(message));
   }
+
+  // BROWSING LISTINGS
+  // Remote devices page through the listings of the browsed player with a
+  // request per page while the media interface only returns complete lists.
+  // The lists are kept, keyed by scope, folder and UID counter, so that a
+  // folder is only fetched once while it is paged through. Entering a folder
+  // fetches it again, and the media and folder updates of the player drop
+  // the lists they change.
+  using ListingKey = std::tuple<Scope, std::string, uint16_t>;
+  struct Listing {
+    std::string curr_song_id;
+    std::vector<SongInfo> songs;
+    std::vector<ListItem> items;
+  };
+  using ListItemsCallback =
+      base::Callback<void(const std::vector<ListItem>& items)>;
+  using SongListCallback = base::Callback<void(
+      const std::string& curr_song_id, const std::vector<SongInfo>& songs)>;
+
+  static constexpr size_t kMaxListings = 4;
+
+  // Runs |cb| with the listing of the current folder, fetched from the media
+  // interface unless it is kept already and |refresh| is not set.
+  void GetFolderListing(bool refresh, ListItemsCallback cb);
+  void FolderListingReceived(ListingKey key, uint32_t generation,
+                             ListItemsCallback cb, std::vector<ListItem> items);
+  void GetNowPlayingListing(SongListCallback cb);
+  void NowPlayingListingReceived(uint32_t generation, SongListCallback cb,
+                                 std::string curr_song_id,
+                                 std::vector<SongInfo> songs);
+  const Listing& StoreListing(const ListingKey& key, Listing listing);
+  void DropListings(Scope scope);
+  void ClearListings();
+
   base::WeakPtrFactory<Device> weak_ptr_factory_;
 
   // TODO (apanicke): Initialize all the variables in the constructor.
@@ -359,6 +398,13 @@ class Device {
   MediaIdMap vfs_ids_;
   MediaIdMap now_playing_ids_;
 
+  std::map<ListingKey, Listing> listings_;
+  // Keys of |listings_|, the oldest first
+  std::deque<ListingKey> listing_order_;
+  // Changed each time listings are dropped, so that a listing fetched before
+  // is not kept
+  uint32_t listings_generation_ = 0;
+
   uint32_t play_pos_interval_ = 0;
 
   SongInfo last_song_info_;
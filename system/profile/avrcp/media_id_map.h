@@ -16,14 +16,17 @@
 
 #pragma once
 
-#include <map>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
 
 namespace bluetooth {
 namespace avrcp {
 
 // A helper class to convert Media ID's (represented as strings) that are
 // received from the AVRCP Media Interface layer into UID's to be used
-// with connected devices.
+// with connected devices. The UID's are handed out in order of insertion
+// starting at 1, so the map is only built once for each listing received.
 class MediaIdMap {
  public:
   void clear() {
@@ -31,32 +34,37 @@ class MediaIdMap {
     uid_to_media_id_.clear();
   }
 
-  std::string get_media_id(uint64_t uid) {
+  void reserve(size_t count) {
+    media_id_to_uid_.reserve(count);
+    uid_to_media_id_.reserve(count);
+  }
+
+  size_t size() const { return media_id_to_uid_.size(); }
+
+  std::string get_media_id(uint64_t uid) const {
     const auto& uid_it = uid_to_media_id_.find(uid);
     if (uid_it == uid_to_media_id_.end()) return "";
     return uid_it->second;
   }
 
-  uint64_t get_uid(std::string media_id) {
+  uint64_t get_uid(const std::string& media_id) const {
     const auto& media_id_it = media_id_to_uid_.find(media_id);
     if (media_id_it == media_id_to_uid_.end()) return 0;
     return media_id_it->second;
   }
 
-  uint64_t insert(std::string media_id) {
-    if (media_id_to_uid_.find(media_id) != media_id_to_uid_.end()) {
-      return media_id_to_uid_[media_id];
-    }
-
+  uint64_t insert(const std::string& media_id) {
     uint64_t uid = media_id_to_uid_.size() + 1;
-    media_id_to_uid_.insert(std::pair<std::string, uint64_t>(media_id, uid));
-    uid_to_media_id_.insert(std::pair<uint64_t, std::string>(uid, media_id));
+    auto result = media_id_to_uid_.emplace(media_id, uid);
+    if (!result.second) return result.first->second;
+
+    uid_to_media_id_.emplace(uid, media_id);
     return uid;
   }
 
  private:
-  std::map<std::string, uint64_t> media_id_to_uid_;
-  std::map<uint64_t, std::string> uid_to_media_id_;
+  std::unordered_map<std::string, uint64_t> media_id_to_uid_;
+  std::unordered_map<uint64_t, std::string> uid_to_media_id_;
 };
 
 }  // namespace avrcp
@@ -1070,7 +1070,7 @@ TEST_F(AvrcpDeviceTest, changePathTest) {
   ListItem item4 = {ListItem::FOLDER, info4, SongInfo()};
   std::vector<ListItem> list1 = {item2, item3, item4};
   EXPECT_CALL(interface, GetFolderItems(_, "test_id1", _))
-      .Times(3)
+      .Times(2)
       .WillRepeatedly(InvokeCb<2>(list1));
 
   std::vector<ListItem> list2 = {};
@@ -1142,6 +1142,100 @@ TEST_F(AvrcpDeviceTest, changePathTest) {
   SendBrowseMessage(5, request);
 }
 
+TEST_F(AvrcpDeviceTest, getFolderItemsPagingTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr,
+                                  nullptr);
+
+  FolderInfo info0 = {"test_id0", true, "Test Folder0"};
+  FolderInfo info1 = {"test_id1", true, "Test Folder1"};
+  ListItem item0 = {ListItem::FOLDER, info0, SongInfo()};
+  ListItem item1 = {ListItem::FOLDER, info1, SongInfo()};
+  std::vector<ListItem> list = {item0, item1};
+
+  // The listing is fetched once and kept for the pages that follow
+  EXPECT_CALL(interface, GetFolderItems(_, "", _))
+      .Times(1)
+      .WillOnce(InvokeCb<2>(list));
+
+  auto first_page = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  first_page->AddFolder(FolderItem(1, 0, true, "Test Folder0"));
+  EXPECT_CALL(response_cb, Call(1, true, matchPacket(std::move(first_page))))
+      .Times(1);
+  auto folder_request_builder =
+      GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 0, 0, {});
+  auto request = TestBrowsePacket::Make();
+  folder_request_builder->Serialize(request);
+  SendBrowseMessage(1, request);
+
+  auto second_page = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  second_page->AddFolder(FolderItem(2, 0, true, "Test Folder1"));
+  EXPECT_CALL(response_cb, Call(2, true, matchPacket(std::move(second_page))))
+      .Times(1);
+  folder_request_builder =
+      GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 1, 1, {});
+  request = TestBrowsePacket::Make();
+  folder_request_builder->Serialize(request);
+  SendBrowseMessage(2, request);
+
+  auto total_response = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
+      Status::NO_ERROR, 0, list.size());
+  EXPECT_CALL(response_cb,
+              Call(3, true, matchPacket(std::move(total_response))))
+      .Times(1);
+  SendBrowseMessage(
+      3, TestBrowsePacket::Make(get_total_number_of_items_request_vfs));
+}
+
+TEST_F(AvrcpDeviceTest, getNowPlayingListAfterUpdateTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr,
+                                  nullptr);
+  SetBipClientStatus(false);
+
+  SongInfo info0 = {"test_id0",
+                    {AttributeEntry(Attribute::TITLE, "Test Song0")}};
+  SongInfo info1 = {"test_id1",
+                    {AttributeEntry(Attribute::TITLE, "Test Song1")}};
+  std::vector<SongInfo> list0 = {info0};
+  std::vector<SongInfo> list1 = {info0, info1};
+
+  // The now playing listing is fetched again once the queue changed
+  EXPECT_CALL(interface, GetNowPlayingList(_))
+      .WillOnce(InvokeCb<0>("test_id0", list0))
+      .WillOnce(InvokeCb<0>("test_id0", list1));
+
+  auto expected_response = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  expected_response->AddSong(
+      MediaElementItem(1, "Test Song0", info0.attributes));
+  EXPECT_CALL(response_cb,
+              Call(1, true, matchPacket(std::move(expected_response))))
+      .Times(1);
+  auto request = TestBrowsePacket::Make(get_folder_items_request_now_playing);
+  SendBrowseMessage(1, request);
+
+  test_device->SendMediaUpdate(false, false, true);
+
+  expected_response = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  expected_response->AddSong(
+      MediaElementItem(1, "Test Song0", info0.attributes));
+  expected_response->AddSong(
+      MediaElementItem(2, "Test Song1", info1.attributes));
+  EXPECT_CALL(response_cb,
+              Call(2, true, matchPacket(std::move(expected_response))))
+      .Times(1);
+  request = TestBrowsePacket::Make(get_folder_items_request_now_playing);
+  SendBrowseMessage(2, request);
+}
+
 TEST_F(AvrcpDeviceTest, getItemAttributesNowPlayingTest) {
   MockMediaInterface interface;
   NiceMock<MockA2dpInterface> a2dp_interface;
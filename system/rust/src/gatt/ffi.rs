@@ -84,7 +84,8 @@ mod inner {
         );
 
         /// This callback is invoked when writing - the client
-        /// must reply using SendResponse
+        /// must reply using SendResponse. The value is moved to
+        /// C++, which hands it to the JNI thread without copying it
         #[cxx_name = "OnServerWrite"]
         fn on_server_write(
             self: &GattServerCallbacks,
@@ -95,7 +96,7 @@ mod inner {
             offset: u32,
             need_response: bool,
             is_prepare: bool,
-            value: &[u8],
+            value: Vec<u8>,
         );
 
         /// This callback is invoked when executing / cancelling a write
@@ -230,7 +231,7 @@ impl GattCallbacks for GattCallbacksImpl {
             },
             matches!(write_type, GattWriteType::Request { .. }),
             matches!(write_type, GattWriteType::Request(GattWriteRequestType::Prepare { .. })),
-            &value.get_raw_payload().collect::<Vec<_>>(),
+            value.get_raw_payload().collect::<Vec<_>>(),
         );
     }
 
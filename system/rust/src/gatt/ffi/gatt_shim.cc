@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <utility>
 
 #include "include/hardware/bluetooth.h"
 #include "include/hardware/bt_common_types.h"
@@ -83,7 +84,7 @@ void GattServerCallbacks::OnServerRead(uint16_t conn_id, uint32_t trans_id,
 void GattServerCallbacks::OnServerWrite(
     uint16_t conn_id, uint32_t trans_id, uint16_t attr_handle,
     AttributeBackingType attr_type, uint32_t offset, bool need_response,
-    bool is_prepare, ::rust::Slice<const uint8_t> value) const {
+    bool is_prepare, ::rust::Vec<uint8_t> value) const {
   auto addr = AddressOfConnection(conn_id);
   if (!addr.has_value()) {
     LOG_WARN(
@@ -92,27 +93,31 @@ void GattServerCallbacks::OnServerWrite(
     return;
   }
 
-  auto buf = new uint8_t[value.size()];
-  std::copy(value.begin(), value.end(), buf);
-
+  request_write_callback callback = nullptr;
   switch (attr_type) {
     case AttributeBackingType::CHARACTERISTIC:
-      do_in_jni_thread(
-          FROM_HERE,
-          base::Bind(callbacks.request_write_characteristic_cb, conn_id,
-                     trans_id, addr.value(), attr_handle, offset, need_response,
-                     is_prepare, base::Owned(buf), value.size()));
+      callback = callbacks.request_write_characteristic_cb;
       break;
     case AttributeBackingType::DESCRIPTOR:
-      do_in_jni_thread(
-          FROM_HERE,
-          base::Bind(callbacks.request_write_descriptor_cb, conn_id, trans_id,
-                     addr.value(), attr_handle, offset, need_response,
-                     is_prepare, base::Owned(buf), value.size()));
+      callback = callbacks.request_write_descriptor_cb;
       break;
     default:
       LOG_ALWAYS_FATAL("Unexpected backing type %hhu", attr_type);
   }
+
+  // The value is owned by the task, and lent to the callback
+  do_in_jni_thread(
+      FROM_HERE,
+      base::BindOnce(
+          [](request_write_callback callback, uint16_t conn_id,
+             uint32_t trans_id, RawAddress addr, uint16_t attr_handle,
+             uint32_t offset, bool need_response, bool is_prepare,
+             ::rust::Vec<uint8_t> value) {
+            callback(conn_id, trans_id, addr, attr_handle, offset,
+                     need_response, is_prepare, value.data(), value.size());
+          },
+          callback, conn_id, trans_id, addr.value(), attr_handle, offset,
+          need_response, is_prepare, std::move(value)));
 }
 
 void GattServerCallbacks::OnIndicationSentConfirmation(uint16_t conn_id,
@@ -46,7 +46,7 @@ class GattServerCallbacks {
   void OnServerWrite(uint16_t conn_id, uint32_t trans_id, uint16_t attr_handle,
                      AttributeBackingType attr_type, uint32_t offset,
                      bool need_response, bool is_prepare,
-                     ::rust::Slice<const uint8_t> value) const;
+                     ::rust::Vec<uint8_t> value) const;
 
   void OnIndicationSentConfirmation(uint16_t conn_id, int status) const;
 
@@ -24,11 +24,16 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <mutex>
+#include <vector>
+
 #include "a2dp_aac.h"
+#include "common/message_loop_thread.h"
 #include "common/time_util.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 
 //
@@ -38,6 +43,14 @@
 // A2DP AAC encoder interval in milliseconds
 #define A2DP_AAC_ENCODER_INTERVAL_MS 20
 
+// When set, the AAC frames are encoded on a worker thread one media tick
+// ahead of their transmission: each tick only sends the packets encoded
+// during the previous one, so the media task does not wait on the encoder.
+#define A2DP_AAC_ENCODE_AHEAD_PROPERTY "persist.bluetooth.a2dp_aac.encode_ahead"
+
+// Number of packets the encoding worker allocates ahead
+#define A2DP_AAC_ENCODE_AHEAD_PACKETS 4
+
 // offset
 #if (BTA_AV_CO_CP_SCMS_T == TRUE)
 #define A2DP_AAC_OFFSET (AVDT_MEDIA_OFFSET + 1)
@@ -52,6 +65,8 @@ typedef struct {
   uint32_t frame_length;         // Samples per channel in a frame
   uint8_t input_channels_n;      // Number of channels
   int max_encoded_buffer_bytes;  // Max encoded bytes per frame
+  int bit_rate;                  // CBR bit rate of the codec config
+  bool variable_bit_rate;        // True if the encoder runs in VBR mode
 } tA2DP_AAC_ENCODER_PARAMS;
 
 typedef struct {
@@ -75,6 +90,7 @@ typedef struct {
 typedef struct {
   a2dp_source_read_callback_t read_callback;
   a2dp_source_enqueue_callback_t enqueue_callback;
+  const tA2DP_SOURCE_SPAN_CALLBACKS* span_callbacks;
   uint16_t TxAaMtuSize;
 
   bool use_SCMS_T;
@@ -93,6 +109,30 @@ typedef struct {
 
 static tA2DP_AAC_ENCODER_CB a2dp_aac_encoder_cb;
 
+// A packet encoded ahead, sent at the next media tick
+typedef struct {
+  BT_HDR* p_buf;
+  uint8_t frames_n;
+  uint32_t bytes_read;
+} tA2DP_AAC_READY_PACKET;
+
+// While the encoding runs ahead, the encoder and its output buffers are only
+// used from the worker. The media task hands it the number of frames due at
+// each tick, and takes the packets it has ready.
+struct A2dpAacEncodeAhead {
+  A2dpAacEncodeAhead() : worker("bt_a2dp_aac_encoder_worker") {}
+
+  bool enabled = false;
+  bluetooth::common::MessageLoopThread worker;
+  std::vector<BT_HDR*> free_packets;  // Allocated ahead, used by the worker
+
+  std::mutex mutex;  // Guards the fields below
+  std::vector<tA2DP_AAC_READY_PACKET> ready_packets;
+  uint32_t underflow_bytes = 0;  // PCM bytes due but not read by the worker
+};
+
+static A2dpAacEncodeAhead a2dp_aac_encode_ahead;
+
 static uint32_t a2dp_aac_encoder_interval_ms = A2DP_AAC_ENCODER_INTERVAL_MS;
 
 static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
@@ -103,9 +143,21 @@ static void a2dp_aac_get_num_frame_iteration(uint8_t* num_of_iterations,
                                              uint8_t* num_of_frames,
                                              uint64_t timestamp_us);
 static void a2dp_aac_encode_frames(uint8_t nb_frame);
-static bool a2dp_aac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read);
+static bool a2dp_aac_read_feeding(uint8_t* read_buffer, const uint8_t** p_pcm,
+                                  uint32_t* bytes_read);
 static uint16_t adjust_effective_mtu(
     const tA2DP_ENCODER_INIT_PEER_PARAMS& peer_params);
+static void a2dp_aac_encode_ahead_start(void);
+static void a2dp_aac_encode_ahead_stop(void);
+static void a2dp_aac_encode_ahead_flush(void);
+static void a2dp_aac_encode_ahead_frames(uint8_t nb_frame,
+                                         uint8_t nb_iterations);
+static void a2dp_aac_send_ready_packets(void);
+static BT_HDR* a2dp_aac_get_packet(void);
+static bool a2dp_aac_output_packet(BT_HDR* p_buf, uint8_t frames_n,
+                                   uint32_t bytes_read);
+static void a2dp_aac_return_feeding(uint32_t bytes);
+static void a2dp_aac_set_bitrate(int bit_rate);
 
 bool A2DP_LoadEncoderAac(void) {
   // Nothing to do - the library is statically linked
@@ -114,6 +166,7 @@ bool A2DP_LoadEncoderAac(void) {
 
 void A2DP_UnloadEncoderAac(void) {
   // Nothing to do - the library is statically linked
+  a2dp_aac_encode_ahead_stop();
   if (a2dp_aac_encoder_cb.has_aac_handle)
     aacEncClose(&a2dp_aac_encoder_cb.aac_handle);
   memset(&a2dp_aac_encoder_cb, 0, sizeof(a2dp_aac_encoder_cb));
@@ -123,6 +176,7 @@ void a2dp_aac_encoder_init(const tA2DP_ENCODER_INIT_PEER_PARAMS* p_peer_params,
                            A2dpCodecConfig* a2dp_codec_config,
                            a2dp_source_read_callback_t read_callback,
                            a2dp_source_enqueue_callback_t enqueue_callback) {
+  a2dp_aac_encode_ahead_stop();
   if (a2dp_aac_encoder_cb.has_aac_handle)
     aacEncClose(&a2dp_aac_encoder_cb.aac_handle);
   memset(&a2dp_aac_encoder_cb, 0, sizeof(a2dp_aac_encoder_cb));
@@ -147,6 +201,10 @@ void a2dp_aac_encoder_init(const tA2DP_ENCODER_INIT_PEER_PARAMS* p_peer_params,
   bool config_updated = false;
   a2dp_aac_encoder_update(a2dp_codec_config, &restart_input, &restart_output,
                           &config_updated);
+
+  if (osi_property_get_bool(A2DP_AAC_ENCODE_AHEAD_PROPERTY, false)) {
+    a2dp_aac_encode_ahead_start();
+  }
 }
 
 // Update the A2DP AAC encoder.
@@ -306,6 +364,7 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
         __func__, aac_param_value, aac_error);
     return;  // TODO: Return an error?
   }
+  p_encoder_params->bit_rate = aac_param_value;
 
   // Set the encoder's parameters: PEAK Bit Rate
   aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
@@ -388,6 +447,8 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
     aac_param_value =
         static_cast<uint8_t>(bitrate_mode) & ~A2DP_AAC_VARIABLE_BIT_RATE_MASK;
   }
+  p_encoder_params->variable_bit_rate =
+      (aac_param_value != A2DP_AAC_VARIABLE_BIT_RATE_DISABLED);
   LOG_INFO("%s: AACENC_BITRATEMODE: %d", __func__, aac_param_value);
   aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
                                   AACENC_BITRATEMODE, aac_param_value);
@@ -431,6 +492,7 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
 }
 
 void a2dp_aac_encoder_cleanup(void) {
+  a2dp_aac_encode_ahead_stop();
   if (a2dp_aac_encoder_cb.has_aac_handle)
     aacEncClose(&a2dp_aac_encoder_cb.aac_handle);
   memset(&a2dp_aac_encoder_cb, 0, sizeof(a2dp_aac_encoder_cb));
@@ -457,6 +519,7 @@ void a2dp_aac_feeding_reset(void) {
   /* By default, just clear the entire state */
   memset(&a2dp_aac_encoder_cb.aac_feeding_state, 0,
          sizeof(a2dp_aac_encoder_cb.aac_feeding_state));
+  a2dp_aac_encode_ahead_flush();
 
   a2dp_aac_encoder_cb.aac_feeding_state.bytes_per_tick =
       (a2dp_aac_encoder_cb.feeding_params.sample_rate *
@@ -472,6 +535,7 @@ void a2dp_aac_feeding_reset(void) {
 
 void a2dp_aac_feeding_flush(void) {
   a2dp_aac_encoder_cb.aac_feeding_state.counter = 0.0f;
+  a2dp_aac_encode_ahead_flush();
 }
 
 uint64_t a2dp_aac_get_encoder_interval_ms(void) {
@@ -482,15 +546,61 @@ int a2dp_aac_get_effective_frame_size() {
   return a2dp_aac_encoder_cb.TxAaMtuSize;
 }
 
+void a2dp_aac_set_span_callbacks(
+    const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks) {
+  a2dp_aac_encoder_cb.span_callbacks = callbacks;
+}
+
+void a2dp_aac_set_bitrate_percent(uint8_t percent) {
+  tA2DP_AAC_ENCODER_PARAMS* p_encoder_params =
+      &a2dp_aac_encoder_cb.aac_encoder_params;
+  // In VBR mode the encoder picks the bit rate per frame from its quality
+  // setting, there is no target to scale.
+  if (!a2dp_aac_encoder_cb.has_aac_handle ||
+      p_encoder_params->variable_bit_rate || p_encoder_params->bit_rate <= 0) {
+    return;
+  }
+
+  int bit_rate = (p_encoder_params->bit_rate * percent) / 100;
+  LOG_INFO("%s: bit rate %d (%d%%)", __func__, bit_rate, percent);
+  if (a2dp_aac_encode_ahead.enabled) {
+    a2dp_aac_encode_ahead.worker.DoInThread(
+        FROM_HERE, base::BindOnce(&a2dp_aac_set_bitrate, bit_rate));
+    return;
+  }
+  a2dp_aac_set_bitrate(bit_rate);
+}
+
+static void a2dp_aac_set_bitrate(int bit_rate) {
+  AACENC_ERROR aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
+                                               AACENC_BITRATE, bit_rate);
+  if (aac_error != AACENC_OK) {
+    LOG_ERROR(
+        "%s: Cannot set AAC parameter AACENC_BITRATE to %d: "
+        "AAC error 0x%x",
+        __func__, bit_rate, aac_error);
+  }
+}
+
 void a2dp_aac_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
 
+  // The packets encoded during the previous tick go out first
+  if (a2dp_aac_encode_ahead.enabled) a2dp_aac_send_ready_packets();
+
   a2dp_aac_get_num_frame_iteration(&nb_iterations, &nb_frame, timestamp_us);
   LOG_VERBOSE("%s: Sending %d frames per iteration, %d iterations", __func__,
               nb_frame, nb_iterations);
   if (nb_frame == 0) return;
 
+  if (a2dp_aac_encode_ahead.enabled) {
+    a2dp_aac_encode_ahead.worker.DoInThread(
+        FROM_HERE, base::BindOnce(&a2dp_aac_encode_ahead_frames, nb_frame,
+                                  nb_iterations));
+    return;
+  }
+
   for (uint8_t counter = 0; counter < nb_iterations; counter++) {
     // Transcode frame and enqueue
     a2dp_aac_encode_frames(nb_frame);
@@ -586,7 +696,7 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
   int written = 0;
 
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+    BT_HDR* p_buf = a2dp_aac_get_packet();
     p_buf->offset = A2DP_AAC_OFFSET;
     p_buf->len = 0;
     p_buf->layer_specific = 0;
@@ -598,19 +708,26 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
       // Read the PCM data and encode it
       //
       uint32_t bytes_read = 0;
-      if (a2dp_aac_read_feeding(read_buffer, &bytes_read)) {
+      const uint8_t* pcm = nullptr;
+      if (a2dp_aac_read_feeding(read_buffer, &pcm, &bytes_read)) {
         uint8_t* packet = (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len;
         if (!a2dp_aac_encoder_cb.has_aac_handle) {
           LOG_ERROR("%s: invalid AAC handle", __func__);
+          if (pcm != read_buffer) {
+            a2dp_aac_encoder_cb.span_callbacks->release(bytes_read);
+          }
           a2dp_aac_encoder_cb.stats.media_read_total_dropped_packets++;
           osi_free(p_buf);
           return;
         }
-        in_buf_vector[0] = read_buffer;
+        in_buf_vector[0] = const_cast<uint8_t*>(pcm);
         out_buf_vector[0] = packet + count;
         AACENC_ERROR aac_error =
             aacEncEncode(a2dp_aac_encoder_cb.aac_handle, &in_buf_desc,
                          &out_buf_desc, &aac_in_args, &aac_out_args);
+        if (pcm != read_buffer) {
+          a2dp_aac_encoder_cb.span_callbacks->release(bytes_read);
+        }
         if (aac_error != AACENC_OK) {
           LOG_ERROR("%s: AAC encoding error: 0x%x", __func__, aac_error);
           a2dp_aac_encoder_cb.stats.media_read_total_dropped_packets++;
@@ -624,10 +741,9 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
         p_buf->layer_specific++;  // added a frame to the buffer
       } else {
         LOG_WARN("%s: underflow %d", __func__, nb_frame);
-        a2dp_aac_encoder_cb.aac_feeding_state.counter +=
-            nb_frame * p_encoder_params->frame_length *
-            p_feeding_params->channel_count *
-            p_feeding_params->bits_per_sample / 8;
+        a2dp_aac_return_feeding(nb_frame * p_encoder_params->frame_length *
+                                p_feeding_params->channel_count *
+                                p_feeding_params->bits_per_sample / 8);
 
         // no more pcm to read
         nb_frame = 0;
@@ -651,8 +767,7 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
 
       uint8_t done_nb_frame = remain_nb_frame - nb_frame;
       remain_nb_frame = nb_frame;
-      if (!a2dp_aac_encoder_cb.enqueue_callback(p_buf, done_nb_frame,
-                                                total_bytes_read))
+      if (!a2dp_aac_output_packet(p_buf, done_nb_frame, total_bytes_read))
         return;
     } else {
       a2dp_aac_encoder_cb.stats.media_read_total_dropped_packets++;
@@ -661,7 +776,8 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
   }
 }
 
-static bool a2dp_aac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
+static bool a2dp_aac_read_feeding(uint8_t* read_buffer, const uint8_t** p_pcm,
+                                  uint32_t* bytes_read) {
   uint32_t read_size = a2dp_aac_encoder_cb.aac_encoder_params.frame_length *
                        a2dp_aac_encoder_cb.feeding_params.channel_count *
                        a2dp_aac_encoder_cb.feeding_params.bits_per_sample / 8;
@@ -669,6 +785,16 @@ static bool a2dp_aac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
   a2dp_aac_encoder_cb.stats.media_read_total_expected_reads_count++;
   a2dp_aac_encoder_cb.stats.media_read_total_expected_read_bytes += read_size;
 
+  /* Encode in place when a whole frame is available from the audio HAL */
+  if (a2dp_aac_encoder_cb.span_callbacks != nullptr &&
+      a2dp_aac_encoder_cb.span_callbacks->peek(p_pcm, read_size)) {
+    a2dp_aac_encoder_cb.stats.media_read_total_actual_read_bytes += read_size;
+    a2dp_aac_encoder_cb.stats.media_read_total_actual_reads_count++;
+    *bytes_read = read_size;
+    return true;
+  }
+  *p_pcm = read_buffer;
+
   /* Read Data from UIPC channel */
   uint32_t nb_byte_read =
       a2dp_aac_encoder_cb.read_callback(read_buffer, read_size);
@@ -687,6 +813,102 @@ static bool a2dp_aac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
   return true;
 }
 
+static void a2dp_aac_encode_ahead_start(void) {
+  a2dp_aac_encode_ahead.worker.StartUp();
+  if (!a2dp_aac_encode_ahead.worker.IsRunning()) {
+    LOG_ERROR("%s: unable to start the encoding worker", __func__);
+    return;
+  }
+  a2dp_aac_encode_ahead.enabled = true;
+  LOG_INFO("%s: encoding one tick ahead", __func__);
+}
+
+static void a2dp_aac_encode_ahead_stop(void) {
+  if (a2dp_aac_encode_ahead.worker.IsRunning()) {
+    a2dp_aac_encode_ahead.worker.ShutDown();
+  }
+  a2dp_aac_encode_ahead.enabled = false;
+  a2dp_aac_encode_ahead_flush();
+  for (BT_HDR* p_buf : a2dp_aac_encode_ahead.free_packets) osi_free(p_buf);
+  a2dp_aac_encode_ahead.free_packets.clear();
+}
+
+// Drops the packets encoded ahead, along with the audio they carry.
+static void a2dp_aac_encode_ahead_flush(void) {
+  std::lock_guard<std::mutex> lock(a2dp_aac_encode_ahead.mutex);
+  for (auto& packet : a2dp_aac_encode_ahead.ready_packets) {
+    osi_free(packet.p_buf);
+  }
+  a2dp_aac_encode_ahead.ready_packets.clear();
+  a2dp_aac_encode_ahead.underflow_bytes = 0;
+}
+
+// Runs on the worker: encodes the frames due at a media tick, then allocates
+// the packets for the next one.
+static void a2dp_aac_encode_ahead_frames(uint8_t nb_frame,
+                                         uint8_t nb_iterations) {
+  for (uint8_t counter = 0; counter < nb_iterations; counter++) {
+    a2dp_aac_encode_frames(nb_frame);
+  }
+  while (a2dp_aac_encode_ahead.free_packets.size() <
+         A2DP_AAC_ENCODE_AHEAD_PACKETS) {
+    a2dp_aac_encode_ahead.free_packets.push_back(
+        (BT_HDR*)osi_malloc_packet(BT_DEFAULT_BUFFER_SIZE));
+  }
+}
+
+static void a2dp_aac_send_ready_packets(void) {
+  std::vector<tA2DP_AAC_READY_PACKET> ready_packets;
+  {
+    std::lock_guard<std::mutex> lock(a2dp_aac_encode_ahead.mutex);
+    ready_packets.swap(a2dp_aac_encode_ahead.ready_packets);
+    a2dp_aac_encoder_cb.aac_feeding_state.counter +=
+        a2dp_aac_encode_ahead.underflow_bytes;
+    a2dp_aac_encode_ahead.underflow_bytes = 0;
+  }
+
+  size_t i = 0;
+  while (i < ready_packets.size()) {
+    const tA2DP_AAC_READY_PACKET& packet = ready_packets[i++];
+    if (!a2dp_aac_encoder_cb.enqueue_callback(packet.p_buf, packet.frames_n,
+                                              packet.bytes_read)) {
+      break;
+    }
+  }
+  // The media task stopped or flushed the tx queue
+  for (; i < ready_packets.size(); i++) osi_free(ready_packets[i].p_buf);
+}
+
+static BT_HDR* a2dp_aac_get_packet(void) {
+  if (!a2dp_aac_encode_ahead.free_packets.empty()) {
+    BT_HDR* p_buf = a2dp_aac_encode_ahead.free_packets.back();
+    a2dp_aac_encode_ahead.free_packets.pop_back();
+    return p_buf;
+  }
+  return (BT_HDR*)osi_malloc_packet(BT_DEFAULT_BUFFER_SIZE);
+}
+
+static bool a2dp_aac_output_packet(BT_HDR* p_buf, uint8_t frames_n,
+                                   uint32_t bytes_read) {
+  if (!a2dp_aac_encode_ahead.enabled) {
+    return a2dp_aac_encoder_cb.enqueue_callback(p_buf, frames_n, bytes_read);
+  }
+  std::lock_guard<std::mutex> lock(a2dp_aac_encode_ahead.mutex);
+  a2dp_aac_encode_ahead.ready_packets.push_back({p_buf, frames_n, bytes_read});
+  return true;
+}
+
+// Gives the PCM |bytes| that could not be read back to the feeding counter, to
+// be read at the next tick.
+static void a2dp_aac_return_feeding(uint32_t bytes) {
+  if (!a2dp_aac_encode_ahead.enabled) {
+    a2dp_aac_encoder_cb.aac_feeding_state.counter += bytes;
+    return;
+  }
+  std::lock_guard<std::mutex> lock(a2dp_aac_encode_ahead.mutex);
+  a2dp_aac_encode_ahead.underflow_bytes += bytes;
+}
+
 static uint16_t adjust_effective_mtu(
     const tA2DP_ENCODER_INIT_PEER_PARAMS& peer_params) {
   uint16_t mtu_size = BT_DEFAULT_BUFFER_SIZE - A2DP_AAC_OFFSET - sizeof(BT_HDR);
@@ -0,0 +1,58 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "a2dp_packetizer.h"
+
+#include "stack/include/hcidefs.h"
+#include "stack/include/l2cdefs.h"
+
+// Size of the RTP header of the AVDTP media packets
+#define A2DP_RTP_HEADER_SIZE 12
+
+uint16_t A2DP_GetAclPacketPayloadSize(bool is_peer_edr,
+                                      bool peer_supports_3mbps) {
+  if (!is_peer_edr) return HCI_DH5_PACKET_SIZE;
+  if (!peer_supports_3mbps) return HCI_EDR2_DH5_PACKET_SIZE;
+  return HCI_EDR3_DH5_PACKET_SIZE;
+}
+
+uint8_t A2DP_GetAclAlignedFrameCount(uint16_t frame_len,
+                                     uint16_t media_header_len,
+                                     uint8_t max_frames,
+                                     uint16_t acl_payload_size) {
+  if (frame_len == 0 || max_frames == 0 || acl_payload_size == 0) {
+    return max_frames;
+  }
+
+  const uint32_t overhead =
+      L2CAP_PKT_OVERHEAD + A2DP_RTP_HEADER_SIZE + media_header_len;
+  uint8_t best_frames = max_frames;
+  uint32_t best_acl_packets = 0;
+  for (uint32_t frames = max_frames; frames > 0; frames--) {
+    uint32_t pdu_len = overhead + frames * frame_len;
+    uint32_t acl_packets = (pdu_len + acl_payload_size - 1) / acl_payload_size;
+    // Keep the larger frame count unless fewer frames are strictly more
+    // efficient, i.e. frames / acl_packets > best_frames / best_acl_packets
+    if (best_acl_packets == 0 ||
+        frames * best_acl_packets > best_frames * acl_packets) {
+      best_frames = frames;
+      best_acl_packets = acl_packets;
+    }
+  }
+  return best_frames;
+}
@@ -25,6 +25,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+
+#include "a2dp_packetizer.h"
 #include "a2dp_sbc.h"
 #include "a2dp_sbc_up_sample.h"
 #include "common/time_util.h"
@@ -94,8 +97,11 @@ typedef struct {
 typedef struct {
   a2dp_source_read_callback_t read_callback;
   a2dp_source_enqueue_callback_t enqueue_callback;
+  const tA2DP_SOURCE_SPAN_CALLBACKS* span_callbacks;
   uint16_t TxAaMtuSize;
   uint8_t tx_sbc_frames;
+  int16_t config_bitpool;   /* Bitpool for the bit rate of the codec config */
+  int16_t min_bitpool;      /* Min bitpool of the codec config */
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
   uint32_t timestamp;       /* Timestamp for the A2DP frames */
   SBC_ENC_PARAMS sbc_encoder_params;
@@ -112,7 +118,7 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
                                     bool* p_restart_input,
                                     bool* p_restart_output,
                                     bool* p_config_updated);
-static bool a2dp_sbc_read_feeding(uint32_t* bytes);
+static bool a2dp_sbc_read_feeding(const int16_t** p_pcm, uint32_t* bytes);
 static void a2dp_sbc_encode_frames(uint8_t nb_frame);
 static void a2dp_sbc_get_num_frame_iteration(uint8_t* num_of_iterations,
                                              uint8_t* num_of_frames,
@@ -330,6 +336,8 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
 
   /* Finally update the bitpool in the encoder structure */
   p_encoder_params->s16BitPool = s16BitPool;
+  a2dp_sbc_encoder_cb.config_bitpool = s16BitPool;
+  a2dp_sbc_encoder_cb.min_bitpool = min_bitpool;
 
   LOG_INFO("%s: final bit rate %d, final bit pool %d", __func__,
            p_encoder_params->u16BitRate, p_encoder_params->s16BitPool);
@@ -372,6 +380,28 @@ int a2dp_sbc_get_effective_frame_size() {
   return a2dp_sbc_encoder_cb.TxAaMtuSize;
 }
 
+void a2dp_sbc_set_span_callbacks(
+    const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks) {
+  a2dp_sbc_encoder_cb.span_callbacks = callbacks;
+}
+
+void a2dp_sbc_set_bitrate_percent(uint8_t percent) {
+  SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
+  int16_t s16BitPool = (a2dp_sbc_encoder_cb.config_bitpool * percent) / 100;
+  if (s16BitPool < a2dp_sbc_encoder_cb.min_bitpool)
+    s16BitPool = a2dp_sbc_encoder_cb.min_bitpool;
+  if (s16BitPool > a2dp_sbc_encoder_cb.config_bitpool)
+    s16BitPool = a2dp_sbc_encoder_cb.config_bitpool;
+  if (s16BitPool == p_encoder_params->s16BitPool) return;
+
+  LOG_INFO("%s: bit pool %d -> %d (%d%%)", __func__,
+           p_encoder_params->s16BitPool, s16BitPool, percent);
+  // The bitpool is carried in each frame header, so the encoder does not need
+  // to be reset: keep its analysis state to avoid a glitch.
+  p_encoder_params->s16BitPool = s16BitPool;
+  a2dp_sbc_encoder_cb.tx_sbc_frames = calculate_max_frames_per_packet();
+}
+
 void a2dp_sbc_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
@@ -497,7 +527,7 @@ static void a2dp_sbc_encode_frames(uint8_t nb_frame) {
   uint8_t last_frame_len = 0;
 
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(A2DP_SBC_BUFFER_SIZE);
+    BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(A2DP_SBC_BUFFER_SIZE);
     uint32_t bytes_read = 0;
 
     p_buf->offset = A2DP_SBC_OFFSET;
@@ -513,11 +543,15 @@ static void a2dp_sbc_encode_frames(uint8_t nb_frame) {
       // Read the PCM data and encode it. If necessary, upsample the data.
       //
       uint32_t num_bytes = 0;
-      if (a2dp_sbc_read_feeding(&num_bytes)) {
+      const int16_t* input = nullptr;
+      if (a2dp_sbc_read_feeding(&input, &num_bytes)) {
         uint8_t* output = (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len;
-        int16_t* input = a2dp_sbc_encoder_cb.pcmBuffer;
-        uint16_t output_len = SBC_Encode(p_encoder_params, input, output);
+        uint16_t output_len = SBC_Encode(p_encoder_params,
+                                         const_cast<int16_t*>(input), output);
         last_frame_len = output_len;
+        if (input != a2dp_sbc_encoder_cb.pcmBuffer) {
+          a2dp_sbc_encoder_cb.span_callbacks->release(num_bytes);
+        }
 
         /* Update SBC frame length */
         p_buf->len += output_len;
@@ -561,7 +595,7 @@ static void a2dp_sbc_encode_frames(uint8_t nb_frame) {
   }
 }
 
-static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
+static bool a2dp_sbc_read_feeding(const int16_t** p_pcm, uint32_t* bytes_read) {
   SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
   uint16_t blocm_x_subband =
       p_encoder_params->s16NumOfSubBands * p_encoder_params->s16NumOfBlocks;
@@ -600,11 +634,27 @@ static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
       break;
   }
 
+  *p_pcm = a2dp_sbc_encoder_cb.pcmBuffer;
   a2dp_sbc_encoder_cb.stats.media_read_total_expected_reads_count++;
   if (sbc_sampling == a2dp_sbc_encoder_cb.feeding_params.sample_rate) {
     read_size =
         bytes_needed - a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue;
     a2dp_sbc_encoder_cb.stats.media_read_total_expected_read_bytes += read_size;
+
+    /* Encode in place when a whole frame is available from the audio HAL */
+    if (a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue == 0 &&
+        a2dp_sbc_encoder_cb.span_callbacks != nullptr) {
+      const uint8_t* span = nullptr;
+      if (a2dp_sbc_encoder_cb.span_callbacks->peek(&span, read_size)) {
+        *p_pcm = reinterpret_cast<const int16_t*>(span);
+        *bytes_read = read_size;
+        a2dp_sbc_encoder_cb.stats.media_read_total_actual_read_bytes +=
+            read_size;
+        a2dp_sbc_encoder_cb.stats.media_read_total_actual_reads_count++;
+        return true;
+      }
+    }
+
     nb_byte_read = a2dp_sbc_encoder_cb.read_callback(
         ((uint8_t*)a2dp_sbc_encoder_cb.pcmBuffer) +
             a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
@@ -794,8 +844,18 @@ static uint8_t calculate_max_frames_per_packet(void) {
 
     default:
       LOG_ERROR("%s: Max number of SBC frames: %d", __func__, result);
-      break;
+      return result;
   }
+
+  // Avoid media packets ending with a mostly empty baseband packet
+  uint16_t acl_payload_size = A2DP_GetAclPacketPayloadSize(
+      a2dp_sbc_encoder_cb.peer_params.is_peer_edr,
+      a2dp_sbc_encoder_cb.peer_params.peer_supports_3mbps);
+  result = A2DP_GetAclAlignedFrameCount(frame_len, A2DP_HDR_SIZE,
+                                        std::min<uint16_t>(result, 0x0F),
+                                        acl_payload_size);
+  LOG_VERBOSE("%s: Number of SBC frames aligned to %d octet ACL packets: %d",
+              __func__, acl_payload_size, result);
   return result;
 }
 
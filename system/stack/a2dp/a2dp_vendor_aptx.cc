@@ -76,7 +76,10 @@ static const tA2DP_ENCODER_INTERFACE a2dp_encoder_interface_aptx = {
     a2dp_vendor_aptx_get_encoder_interval_ms,
     a2dp_vendor_aptx_get_effective_frame_size,
     a2dp_vendor_aptx_send_frames,
-    nullptr  // set_transmit_queue_length
+    nullptr,  // set_transmit_queue_length
+    a2dp_vendor_aptx_set_span_callbacks,
+    nullptr,  // encoder_reconfigure
+    nullptr,  // set_bitrate_percent
 };
 
 UNUSED_ATTR static tA2DP_STATUS A2DP_CodecInfoMatchesCapabilityAptx(
@@ -75,6 +75,7 @@ typedef struct {
 typedef struct {
   a2dp_source_read_callback_t read_callback;
   a2dp_source_enqueue_callback_t enqueue_callback;
+  const tA2DP_SOURCE_SPAN_CALLBACKS* span_callbacks;
 
   bool use_SCMS_T;
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
@@ -95,8 +96,8 @@ static void a2dp_vendor_aptx_encoder_update(A2dpCodecConfig* a2dp_codec_config,
 static void aptx_init_framing_params(tAPTX_FRAMING_PARAMS* framing_params);
 static void aptx_update_framing_params(tAPTX_FRAMING_PARAMS* framing_params);
 static size_t aptx_encode_16bit(tAPTX_FRAMING_PARAMS* framing_params,
-                                size_t* data_out_index, uint16_t* data16_in,
-                                uint8_t* data_out);
+                                size_t* data_out_index,
+                                const uint16_t* data16_in, uint8_t* data_out);
 
 /*******************************************************************************
  *
@@ -306,11 +307,16 @@ int a2dp_vendor_aptx_get_effective_frame_size() {
   return a2dp_aptx_encoder_cb.peer_params.peer_mtu;
 }
 
+void a2dp_vendor_aptx_set_span_callbacks(
+    const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks) {
+  a2dp_aptx_encoder_cb.span_callbacks = callbacks;
+}
+
 void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
   tAPTX_FRAMING_PARAMS* framing_params = &a2dp_aptx_encoder_cb.framing_params;
 
   // Prepare the packet to send
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(BT_DEFAULT_BUFFER_SIZE);
   p_buf->offset = A2DP_APTX_OFFSET;
   p_buf->len = 0;
   p_buf->layer_specific = 0;
@@ -336,8 +342,17 @@ void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
       expected_read_bytes;
 
   LOG_VERBOSE("%s: PCM read of size %u", __func__, expected_read_bytes);
-  bytes_read = a2dp_aptx_encoder_cb.read_callback((uint8_t*)read_buffer16,
-                                                  expected_read_bytes);
+  const uint16_t* pcm = read_buffer16;
+  const uint8_t* span = nullptr;
+  if (a2dp_aptx_encoder_cb.span_callbacks != nullptr &&
+      a2dp_aptx_encoder_cb.span_callbacks->peek(&span, expected_read_bytes)) {
+    // Encode in place from the audio HAL
+    pcm = reinterpret_cast<const uint16_t*>(span);
+    bytes_read = expected_read_bytes;
+  } else {
+    bytes_read = a2dp_aptx_encoder_cb.read_callback((uint8_t*)read_buffer16,
+                                                    expected_read_bytes);
+  }
   a2dp_aptx_encoder_cb.stats.media_read_total_actual_read_bytes += bytes_read;
   if (bytes_read < expected_read_bytes) {
     LOG_WARN("%s: underflow at PCM reading: read %u bytes instead of %u",
@@ -352,7 +367,10 @@ void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
        reads++, offset +=
                 (framing_params->pcm_bytes_per_read / sizeof(uint16_t))) {
     pcm_bytes_encoded += aptx_encode_16bit(framing_params, &encoded_ptr_index,
-                                           read_buffer16 + offset, encoded_ptr);
+                                           pcm + offset, encoded_ptr);
+  }
+  if (pcm != read_buffer16) {
+    a2dp_aptx_encoder_cb.span_callbacks->release(bytes_read);
   }
 
   // Compute the number of encoded bytes
@@ -379,8 +397,8 @@ void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
 }
 
 static size_t aptx_encode_16bit(tAPTX_FRAMING_PARAMS* framing_params,
-                                size_t* data_out_index, uint16_t* data16_in,
-                                uint8_t* data_out) {
+                                size_t* data_out_index,
+                                const uint16_t* data16_in, uint8_t* data_out) {
   size_t pcm_bytes_encoded = 0;
   size_t frame = 0;
 
@@ -74,6 +74,7 @@ typedef struct {
 typedef struct {
   a2dp_source_read_callback_t read_callback;
   a2dp_source_enqueue_callback_t enqueue_callback;
+  const tA2DP_SOURCE_SPAN_CALLBACKS* span_callbacks;
 
   bool use_SCMS_T;
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
@@ -95,7 +96,8 @@ static void aptx_hd_init_framing_params(
 static void aptx_hd_update_framing_params(
     tAPTX_HD_FRAMING_PARAMS* framing_params);
 static size_t aptx_hd_encode_24bit(tAPTX_HD_FRAMING_PARAMS* framing_params,
-                                   size_t* data_out_index, uint32_t* data32_in,
+                                   size_t* data_out_index,
+                                   const uint32_t* data32_in,
                                    uint8_t* data_out);
 
 /*******************************************************************************
@@ -289,12 +291,17 @@ int a2dp_vendor_aptx_hd_get_effective_frame_size() {
   return a2dp_aptx_hd_encoder_cb.peer_params.peer_mtu;
 }
 
+void a2dp_vendor_aptx_hd_set_span_callbacks(
+    const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks) {
+  a2dp_aptx_hd_encoder_cb.span_callbacks = callbacks;
+}
+
 void a2dp_vendor_aptx_hd_send_frames(uint64_t timestamp_us) {
   tAPTX_HD_FRAMING_PARAMS* framing_params =
       &a2dp_aptx_hd_encoder_cb.framing_params;
 
   // Prepare the packet to send
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(BT_DEFAULT_BUFFER_SIZE);
   p_buf->offset = A2DP_APTX_HD_OFFSET;
   p_buf->len = 0;
   p_buf->layer_specific = 0;
@@ -321,8 +328,18 @@ void a2dp_vendor_aptx_hd_send_frames(uint64_t timestamp_us) {
       expected_read_bytes;
 
   LOG_VERBOSE("%s: PCM read of size %u", __func__, expected_read_bytes);
-  bytes_read = a2dp_aptx_hd_encoder_cb.read_callback((uint8_t*)read_buffer32,
-                                                     expected_read_bytes);
+  const uint32_t* pcm = read_buffer32;
+  const uint8_t* span = nullptr;
+  if (a2dp_aptx_hd_encoder_cb.span_callbacks != nullptr &&
+      a2dp_aptx_hd_encoder_cb.span_callbacks->peek(&span,
+                                                   expected_read_bytes)) {
+    // Encode in place from the audio HAL
+    pcm = reinterpret_cast<const uint32_t*>(span);
+    bytes_read = expected_read_bytes;
+  } else {
+    bytes_read = a2dp_aptx_hd_encoder_cb.read_callback(
+        (uint8_t*)read_buffer32, expected_read_bytes);
+  }
   a2dp_aptx_hd_encoder_cb.stats.media_read_total_actual_read_bytes +=
       bytes_read;
   if (bytes_read < expected_read_bytes) {
@@ -338,8 +355,11 @@ void a2dp_vendor_aptx_hd_send_frames(uint64_t timestamp_us) {
        reads++, offset +=
                 framing_params->pcm_bytes_per_read / sizeof(uint32_t)) {
     pcm_bytes_encoded +=
-        aptx_hd_encode_24bit(framing_params, &encoded_ptr_index,
-                             read_buffer32 + offset, encoded_ptr);
+        aptx_hd_encode_24bit(framing_params, &encoded_ptr_index, pcm + offset,
+                             encoded_ptr);
+  }
+  if (pcm != read_buffer32) {
+    a2dp_aptx_hd_encoder_cb.span_callbacks->release(bytes_read);
   }
 
   // Compute the number of encoded bytes
@@ -367,7 +387,8 @@ void a2dp_vendor_aptx_hd_send_frames(uint64_t timestamp_us) {
 }
 
 static size_t aptx_hd_encode_24bit(tAPTX_HD_FRAMING_PARAMS* framing_params,
-                                   size_t* data_out_index, uint32_t* data32_in,
+                                   size_t* data_out_index,
+                                   const uint32_t* data32_in,
                                    uint8_t* data_out) {
   size_t pcm_bytes_encoded = 0;
   const uint8_t* p = (const uint8_t*)(data32_in);
@@ -90,7 +90,11 @@ static const tA2DP_ENCODER_INTERFACE a2dp_encoder_interface_ldac = {
     a2dp_vendor_ldac_get_encoder_interval_ms,
     a2dp_vendor_ldac_get_effective_frame_size,
     a2dp_vendor_ldac_send_frames,
-    a2dp_vendor_ldac_set_transmit_queue_length};
+    a2dp_vendor_ldac_set_transmit_queue_length,
+    a2dp_vendor_ldac_set_span_callbacks,
+    a2dp_vendor_ldac_encoder_reconfigure,
+    nullptr,  // set_bitrate_percent: LDAC adapts its own bit rate
+};
 
 static const tA2DP_DECODER_INTERFACE a2dp_decoder_interface_ldac = {
     a2dp_vendor_ldac_decoder_init,          a2dp_vendor_ldac_decoder_cleanup,
@@ -84,6 +84,7 @@ typedef struct {
 typedef struct {
   a2dp_source_read_callback_t read_callback;
   a2dp_source_enqueue_callback_t enqueue_callback;
+  const tA2DP_SOURCE_SPAN_CALLBACKS* span_callbacks;
   uint16_t TxAaMtuSize;
   size_t TxQueueLength;
 
@@ -114,11 +115,14 @@ static void a2dp_vendor_ldac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
                                             bool* p_restart_input,
                                             bool* p_restart_output,
                                             bool* p_config_updated);
+static int a2dp_vendor_ldac_set_quality_mode(
+    const btav_a2dp_codec_config_t& codec_config);
 static void a2dp_ldac_get_num_frame_iteration(uint8_t* num_of_iterations,
                                               uint8_t* num_of_frames,
                                               uint64_t timestamp_us);
 static void a2dp_ldac_encode_frames(uint8_t nb_frame);
-static bool a2dp_ldac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read);
+static bool a2dp_ldac_read_feeding(uint8_t* read_buffer, const uint8_t** p_pcm,
+                                   uint32_t* bytes_read);
 static uint16_t adjust_effective_mtu(
     const tA2DP_ENCODER_INIT_PEER_PARAMS& peer_params);
 static std::string quality_mode_index_to_name(int quality_mode_index);
@@ -221,6 +225,59 @@ static void a2dp_vendor_ldac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
 
   // Set the quality mode index
   int old_quality_mode_index = p_encoder_params->quality_mode_index;
+  int ldac_eqmid = a2dp_vendor_ldac_set_quality_mode(codec_config);
+
+  if (p_encoder_params->quality_mode_index != old_quality_mode_index)
+    *p_config_updated = true;
+
+  p_encoder_params->pcm_wlength =
+      a2dp_ldac_encoder_cb.feeding_params.bits_per_sample >> 3;
+  // Set the Audio format from pcm_wlength
+  p_encoder_params->pcm_fmt = LDACBT_SMPL_FMT_S16;
+  if (p_encoder_params->pcm_wlength == 2)
+    p_encoder_params->pcm_fmt = LDACBT_SMPL_FMT_S16;
+  else if (p_encoder_params->pcm_wlength == 3)
+    p_encoder_params->pcm_fmt = LDACBT_SMPL_FMT_S24;
+  else if (p_encoder_params->pcm_wlength == 4)
+    p_encoder_params->pcm_fmt = LDACBT_SMPL_FMT_S32;
+
+  const tA2DP_ENCODER_INIT_PEER_PARAMS& peer_params =
+      a2dp_ldac_encoder_cb.peer_params;
+  a2dp_ldac_encoder_cb.TxAaMtuSize = adjust_effective_mtu(peer_params);
+  LOG_INFO("%s: MTU=%d, peer_mtu=%d", __func__,
+           a2dp_ldac_encoder_cb.TxAaMtuSize, peer_params.peer_mtu);
+  LOG_INFO(
+      "%s: sample_rate: %d channel_mode: %d "
+      "quality_mode_index: %d pcm_wlength: %d pcm_fmt: %d",
+      __func__, p_encoder_params->sample_rate, p_encoder_params->channel_mode,
+      p_encoder_params->quality_mode_index, p_encoder_params->pcm_wlength,
+      p_encoder_params->pcm_fmt);
+
+  // Initialize the encoder.
+  // NOTE: MTU in the initialization must include the AVDT media header size.
+  int result = ldacBT_init_handle_encode(
+      a2dp_ldac_encoder_cb.ldac_handle,
+      a2dp_ldac_encoder_cb.TxAaMtuSize + AVDT_MEDIA_HDR_SIZE, ldac_eqmid,
+      p_encoder_params->channel_mode, p_encoder_params->pcm_fmt,
+      p_encoder_params->sample_rate);
+  if (result != 0) {
+    int err_code = ldacBT_get_error_code(a2dp_ldac_encoder_cb.ldac_handle);
+    LOG_ERROR(
+        "%s: error initializing the LDAC encoder: %d api_error = %d "
+        "handle_error = %d block_error = %d error_code = 0x%x",
+        __func__, result, LDACBT_API_ERR(err_code), LDACBT_HANDLE_ERR(err_code),
+        LDACBT_BLOCK_ERR(err_code), err_code);
+  }
+}
+
+// Set the quality mode of the A2DP LDAC encoder from |codec_config|, and get
+// or free the LDAC ABR handle as the mode requires.
+// Returns the EQMID to encode with.
+static int a2dp_vendor_ldac_set_quality_mode(
+    const btav_a2dp_codec_config_t& codec_config) {
+  tA2DP_LDAC_ENCODER_PARAMS* p_encoder_params =
+      &a2dp_ldac_encoder_cb.ldac_encoder_params;
+  int old_quality_mode_index = p_encoder_params->quality_mode_index;
   if (codec_config.codec_specific_1 != 0) {
     p_encoder_params->quality_mode_index = codec_config.codec_specific_1 % 10;
     LOG_INFO("%s: setting quality mode to %s", __func__,
@@ -283,47 +340,50 @@ static void a2dp_vendor_ldac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
     }
   }
 
-  if (p_encoder_params->quality_mode_index != old_quality_mode_index)
-    *p_config_updated = true;
+  return ldac_eqmid;
+}
 
-  p_encoder_params->pcm_wlength =
-      a2dp_ldac_encoder_cb.feeding_params.bits_per_sample >> 3;
-  // Set the Audio format from pcm_wlength
-  p_encoder_params->pcm_fmt = LDACBT_SMPL_FMT_S16;
-  if (p_encoder_params->pcm_wlength == 2)
-    p_encoder_params->pcm_fmt = LDACBT_SMPL_FMT_S16;
-  else if (p_encoder_params->pcm_wlength == 3)
-    p_encoder_params->pcm_fmt = LDACBT_SMPL_FMT_S24;
-  else if (p_encoder_params->pcm_wlength == 4)
-    p_encoder_params->pcm_fmt = LDACBT_SMPL_FMT_S32;
+bool a2dp_vendor_ldac_encoder_reconfigure(A2dpCodecConfig* a2dp_codec_config) {
+  tA2DP_LDAC_ENCODER_PARAMS* p_encoder_params =
+      &a2dp_ldac_encoder_cb.ldac_encoder_params;
+  uint8_t codec_info[AVDT_CODEC_SIZE];
 
-  const tA2DP_ENCODER_INIT_PEER_PARAMS& peer_params =
-      a2dp_ldac_encoder_cb.peer_params;
-  a2dp_ldac_encoder_cb.TxAaMtuSize = adjust_effective_mtu(peer_params);
-  LOG_INFO("%s: MTU=%d, peer_mtu=%d", __func__,
-           a2dp_ldac_encoder_cb.TxAaMtuSize, peer_params.peer_mtu);
-  LOG_INFO(
-      "%s: sample_rate: %d channel_mode: %d "
-      "quality_mode_index: %d pcm_wlength: %d pcm_fmt: %d",
-      __func__, p_encoder_params->sample_rate, p_encoder_params->channel_mode,
-      p_encoder_params->quality_mode_index, p_encoder_params->pcm_wlength,
-      p_encoder_params->pcm_fmt);
+  if (!a2dp_ldac_encoder_cb.has_ldac_handle ||
+      !a2dp_codec_config->copyOutOtaCodecConfig(codec_info)) {
+    return false;
+  }
+  const uint8_t* p_codec_info = codec_info;
 
-  // Initialize the encoder.
-  // NOTE: MTU in the initialization must include the AVDT media header size.
-  int result = ldacBT_init_handle_encode(
-      a2dp_ldac_encoder_cb.ldac_handle,
-      a2dp_ldac_encoder_cb.TxAaMtuSize + AVDT_MEDIA_HDR_SIZE, ldac_eqmid,
-      p_encoder_params->channel_mode, p_encoder_params->pcm_fmt,
-      p_encoder_params->sample_rate);
+  // Only the quality mode can change without re-initializing the encoder
+  const tA2DP_FEEDING_PARAMS& feeding_params =
+      a2dp_ldac_encoder_cb.feeding_params;
+  if (A2DP_VendorGetTrackSampleRateLdac(p_codec_info) !=
+          (int)feeding_params.sample_rate ||
+      A2DP_VendorGetTrackChannelCountLdac(p_codec_info) !=
+          (int)feeding_params.channel_count ||
+      A2DP_VendorGetChannelModeCodeLdac(p_codec_info) !=
+          p_encoder_params->channel_mode ||
+      a2dp_codec_config->getAudioBitsPerSample() !=
+          feeding_params.bits_per_sample) {
+    return false;
+  }
+
+  int ldac_eqmid =
+      a2dp_vendor_ldac_set_quality_mode(a2dp_codec_config->getCodecConfig());
+  if (p_encoder_params->quality_mode_index == A2DP_LDAC_QUALITY_ABR) {
+    // Let the ABR adapt from the EQMID it starts with
+    ldac_eqmid = LDAC_ABR_MODE_EQMID;
+  }
+  int result = ldacBT_set_eqmid(a2dp_ldac_encoder_cb.ldac_handle, ldac_eqmid);
   if (result != 0) {
     int err_code = ldacBT_get_error_code(a2dp_ldac_encoder_cb.ldac_handle);
-    LOG_ERROR(
-        "%s: error initializing the LDAC encoder: %d api_error = %d "
-        "handle_error = %d block_error = %d error_code = 0x%x",
-        __func__, result, LDACBT_API_ERR(err_code), LDACBT_HANDLE_ERR(err_code),
-        LDACBT_BLOCK_ERR(err_code), err_code);
+    LOG_ERROR("%s: error setting the LDAC EQMID %d: %d error_code = 0x%x",
+              __func__, ldac_eqmid, result, err_code);
+    return false;
   }
+  LOG_INFO("%s: quality_mode_index: %d", __func__,
+           p_encoder_params->quality_mode_index);
+  return true;
 }
 
 void a2dp_vendor_ldac_encoder_cleanup(void) {
@@ -364,6 +424,11 @@ int a2dp_vendor_ldac_get_effective_frame_size() {
   return a2dp_ldac_encoder_cb.TxAaMtuSize;
 }
 
+void a2dp_vendor_ldac_set_span_callbacks(
+    const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks) {
+  a2dp_ldac_encoder_cb.span_callbacks = callbacks;
+}
+
 void a2dp_vendor_ldac_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
@@ -462,7 +527,7 @@ static void a2dp_ldac_encode_frames(uint8_t nb_frame) {
 
   uint32_t bytes_read = 0;
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+    BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(BT_DEFAULT_BUFFER_SIZE);
     p_buf->offset = A2DP_LDAC_OFFSET;
     p_buf->len = 0;
     p_buf->layer_specific = 0;
@@ -474,18 +539,26 @@ static void a2dp_ldac_encode_frames(uint8_t nb_frame) {
       // Read the PCM data and encode it
       //
       uint32_t temp_bytes_read = 0;
-      if (a2dp_ldac_read_feeding(read_buffer, &temp_bytes_read)) {
+      const uint8_t* pcm = nullptr;
+      if (a2dp_ldac_read_feeding(read_buffer, &pcm, &temp_bytes_read)) {
         bytes_read += temp_bytes_read;
         uint8_t* packet = (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len;
         if (a2dp_ldac_encoder_cb.ldac_handle == NULL) {
           LOG_ERROR("%s: invalid LDAC handle", __func__);
+          if (pcm != read_buffer) {
+            a2dp_ldac_encoder_cb.span_callbacks->release(temp_bytes_read);
+          }
           a2dp_ldac_encoder_cb.stats.media_read_total_dropped_packets++;
           osi_free(p_buf);
           return;
         }
         int result = ldacBT_encode(
-            a2dp_ldac_encoder_cb.ldac_handle, read_buffer, (int*)&encode_count,
-            packet + count, (int*)&written, (int*)&out_frames);
+            a2dp_ldac_encoder_cb.ldac_handle, const_cast<uint8_t*>(pcm),
+            (int*)&encode_count, packet + count, (int*)&written,
+            (int*)&out_frames);
+        if (pcm != read_buffer) {
+          a2dp_ldac_encoder_cb.span_callbacks->release(temp_bytes_read);
+        }
         if (result != 0) {
           int err_code =
               ldacBT_get_error_code(a2dp_ldac_encoder_cb.ldac_handle);
@@ -540,7 +613,8 @@ static void a2dp_ldac_encode_frames(uint8_t nb_frame) {
   }
 }
 
-static bool a2dp_ldac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
+static bool a2dp_ldac_read_feeding(uint8_t* read_buffer, const uint8_t** p_pcm,
+                                   uint32_t* bytes_read) {
   uint32_t read_size = LDACBT_ENC_LSU *
                        a2dp_ldac_encoder_cb.feeding_params.channel_count *
                        a2dp_ldac_encoder_cb.feeding_params.bits_per_sample / 8;
@@ -548,6 +622,16 @@ static bool a2dp_ldac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
   a2dp_ldac_encoder_cb.stats.media_read_total_expected_reads_count++;
   a2dp_ldac_encoder_cb.stats.media_read_total_expected_read_bytes += read_size;
 
+  /* Encode in place when a whole frame is available from the audio HAL */
+  if (a2dp_ldac_encoder_cb.span_callbacks != nullptr &&
+      a2dp_ldac_encoder_cb.span_callbacks->peek(p_pcm, read_size)) {
+    a2dp_ldac_encoder_cb.stats.media_read_total_actual_read_bytes += read_size;
+    a2dp_ldac_encoder_cb.stats.media_read_total_actual_reads_count++;
+    *bytes_read = read_size;
+    return true;
+  }
+  *p_pcm = read_buffer;
+
   /* Read Data from UIPC channel */
   uint32_t nb_byte_read =
       a2dp_ldac_encoder_cb.read_callback(read_buffer, read_size);
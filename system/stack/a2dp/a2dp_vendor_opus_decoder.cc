@@ -115,42 +115,45 @@ bool a2dp_vendor_opus_decoder_decode_packet(BT_HDR* p_buf) {
       pBuffer, A2DP_OPUS_CODEC_DEFAULT_SAMPLERATE);
   frameLen = opus_packet_get_nb_samples(pBuffer, bufferSize,
                                         A2DP_OPUS_CODEC_DEFAULT_SAMPLERATE);
-  uint32_t num_frames = pBuffer[0] & 0xf;
-
-  LOG_ERROR("numframes %d framesize %d framelen %d bufferSize %d", num_frames,
-            frameSize, frameLen, bufferSize);
-  LOG_ERROR("numChannels %d numFrames %d offset %d", numChannels, numFrames,
-            p_buf->offset);
-
-  for (uint32_t frame = 0; frame < numFrames; ++frame) {
-    {
-      numChannels = opus_packet_get_nb_channels(pBuffer);
-
-      ret_val = opus_decode(a2dp_opus_decoder_cb.opus_handle,
-                            reinterpret_cast<unsigned char*>(pBuffer),
-                            bufferSize, a2dp_opus_decoder_cb.decode_buf,
-                            A2DP_OPUS_DECODE_BUFFER_LENGTH, 0 /* flags */);
-
-      if (ret_val < OPUS_OK) {
-        LOG_ERROR("Opus DecodeFrame failed %d, applying concealment", ret_val);
-        ret_val = opus_decode(a2dp_opus_decoder_cb.opus_handle, NULL, 0,
-                              a2dp_opus_decoder_cb.decode_buf,
-                              A2DP_OPUS_DECODE_BUFFER_LENGTH, 0 /* flags */);
-      }
-
-      if (ret_val < OPUS_OK) {
-        LOG_ERROR("Opus DecodeFrame retry failed with %d, dropping packet",
-                  ret_val);
-        return false;
-      }
-
-      size_t frame_len =
-          ret_val * numChannels * sizeof(a2dp_opus_decoder_cb.decode_buf[0]);
-      a2dp_opus_decoder_cb.decode_callback(
-          reinterpret_cast<uint8_t*>(a2dp_opus_decoder_cb.decode_buf),
-          frame_len);
+
+  LOG_VERBOSE("numChannels %d numFrames %d framesize %d framelen %d",
+              numChannels, numFrames, frameSize, frameLen);
+
+  // All the frames of the packet are decoded at once, whatever their
+  // duration: 2.5 and 5 ms frames of the low latency mode come one per packet.
+  // The max frame size is counted in samples per channel.
+  int max_frame_size = A2DP_OPUS_DECODE_BUFFER_LENGTH /
+                       (A2DP_OPUS_CODEC_OUTPUT_CHS *
+                        sizeof(a2dp_opus_decoder_cb.decode_buf[0]));
+  ret_val = opus_decode(a2dp_opus_decoder_cb.opus_handle,
+                        reinterpret_cast<unsigned char*>(pBuffer), bufferSize,
+                        a2dp_opus_decoder_cb.decode_buf, max_frame_size,
+                        0 /* flags */);
+
+  if (ret_val < OPUS_OK) {
+    LOG_ERROR("Opus DecodeFrame failed %d, applying concealment", ret_val);
+    // Conceal as much audio as the last packet carried
+    opus_int32 last_packet_duration = 0;
+    opus_decoder_ctl(a2dp_opus_decoder_cb.opus_handle,
+                     OPUS_GET_LAST_PACKET_DURATION(&last_packet_duration));
+    if (last_packet_duration <= 0 || last_packet_duration > max_frame_size) {
+      last_packet_duration = max_frame_size;
     }
+    ret_val = opus_decode(a2dp_opus_decoder_cb.opus_handle, NULL, 0,
+                          a2dp_opus_decoder_cb.decode_buf, last_packet_duration,
+                          0 /* flags */);
   }
+
+  if (ret_val < OPUS_OK) {
+    LOG_ERROR("Opus DecodeFrame retry failed with %d, dropping packet",
+              ret_val);
+    return false;
+  }
+
+  size_t frame_len = ret_val * A2DP_OPUS_CODEC_OUTPUT_CHS *
+                     sizeof(a2dp_opus_decoder_cb.decode_buf[0]);
+  a2dp_opus_decoder_cb.decode_callback(
+      reinterpret_cast<uint8_t*>(a2dp_opus_decoder_cb.decode_buf), frame_len);
   return true;
 }
 
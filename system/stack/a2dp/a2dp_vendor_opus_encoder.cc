@@ -39,6 +39,7 @@ typedef struct {
   uint8_t channel_mode;
   uint8_t bits_per_sample;
   uint8_t quality_mode_index;
+  int application;  // OPUS_APPLICATION_* the encoder is initialized with
   int pcm_wlength;
   uint8_t pcm_fmt;
 } tA2DP_OPUS_ENCODER_PARAMS;
@@ -64,6 +65,7 @@ typedef struct {
 typedef struct {
   a2dp_source_read_callback_t read_callback;
   a2dp_source_enqueue_callback_t enqueue_callback;
+  const tA2DP_SOURCE_SPAN_CALLBACKS* span_callbacks;
   uint16_t TxAaMtuSize;
   size_t TxQueueLength;
 
@@ -94,7 +96,8 @@ static void a2dp_opus_get_num_frame_iteration(uint8_t* num_of_iterations,
                                               uint8_t* num_of_frames,
                                               uint64_t timestamp_us);
 static void a2dp_opus_encode_frames(uint8_t nb_frame);
-static bool a2dp_opus_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read);
+static bool a2dp_opus_read_feeding(uint8_t* read_buffer, const uint8_t** p_pcm,
+                                   uint32_t* bytes_read);
 
 void a2dp_vendor_opus_encoder_cleanup(void) {
   if (a2dp_opus_encoder_cb.has_opus_handle) {
@@ -160,6 +163,8 @@ void a2dp_vendor_opus_encoder_init(
     return;
   } else {
     a2dp_opus_encoder_cb.has_opus_handle = true;
+    a2dp_opus_encoder_cb.opus_encoder_params.application =
+        OPUS_APPLICATION_AUDIO;
   }
 
   a2dp_vendor_opus_encoder_update(a2dp_opus_encoder_cb.peer_mtu,
@@ -236,6 +241,35 @@ static bool a2dp_vendor_opus_encoder_update(uint16_t peer_mtu,
   p_encoder_params->framesize = A2DP_VendorGetFrameSizeOpus(p_codec_info);
   p_encoder_params->bitrate = A2DP_VendorGetBitRateOpus(p_codec_info);
 
+  // Low latency mode: shorter frames, without the lookahead of the music and
+  // speech modes
+  int application = OPUS_APPLICATION_AUDIO;
+  switch (codec_config.codec_specific_2 & A2DP_OPUS_LOW_LATENCY_MASK) {
+    case A2DP_OPUS_LOW_LATENCY_5MS:
+      p_encoder_params->framesize = p_encoder_params->sample_rate / 200;
+      application = OPUS_APPLICATION_RESTRICTED_LOWDELAY;
+      break;
+    case A2DP_OPUS_LOW_LATENCY_2_5MS:
+      p_encoder_params->framesize = p_encoder_params->sample_rate / 400;
+      application = OPUS_APPLICATION_RESTRICTED_LOWDELAY;
+      break;
+    default:
+      break;
+  }
+  // The application can only be changed before the first encoded frame
+  if (application != p_encoder_params->application) {
+    error = opus_encoder_init(a2dp_opus_encoder_cb.opus_handle,
+                              A2DP_OPUS_CODEC_DEFAULT_SAMPLERATE,
+                              A2DP_OPUS_CODEC_OUTPUT_CHS, application);
+    if (error != OPUS_OK) {
+      LOG_ERROR("failed to set encoder application %d", application);
+      return false;
+    }
+    p_encoder_params->application = application;
+  }
+  LOG_INFO("frame size %u application %d", p_encoder_params->framesize,
+           p_encoder_params->application);
+
   a2dp_vendor_opus_feeding_reset();
 
   uint16_t mtu_size =
@@ -314,6 +348,24 @@ uint64_t a2dp_vendor_opus_get_encoder_interval_ms(void) {
           a2dp_opus_encoder_cb.opus_encoder_params.sample_rate);
 }
 
+void a2dp_vendor_opus_set_span_callbacks(
+    const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks) {
+  a2dp_opus_encoder_cb.span_callbacks = callbacks;
+}
+
+void a2dp_vendor_opus_set_bitrate_percent(uint8_t percent) {
+  if (!a2dp_opus_encoder_cb.has_opus_handle) return;
+
+  int32_t bitrate =
+      (a2dp_opus_encoder_cb.opus_encoder_params.bitrate * percent) / 100;
+  LOG_INFO("setting bitrate to %d (%d%%)", bitrate, percent);
+  int error = opus_encoder_ctl(a2dp_opus_encoder_cb.opus_handle,
+                               OPUS_SET_BITRATE(bitrate));
+  if (error != OPUS_OK) {
+    LOG_ERROR("failed to set encoder bitrate");
+  }
+}
+
 void a2dp_vendor_opus_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
@@ -380,7 +432,7 @@ static void a2dp_opus_encode_frames(uint8_t nb_frame) {
 
   uint32_t bytes_read = 0;
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+    BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(BT_DEFAULT_BUFFER_SIZE);
     p_buf->offset = A2DP_OPUS_OFFSET;
     p_buf->len = 0;
     p_buf->layer_specific = 0;
@@ -391,12 +443,16 @@ static void a2dp_opus_encode_frames(uint8_t nb_frame) {
       // Read the PCM data and encode it
       //
       uint32_t temp_bytes_read = 0;
-      if (a2dp_opus_read_feeding(read_buffer, &temp_bytes_read)) {
+      const uint8_t* pcm = nullptr;
+      if (a2dp_opus_read_feeding(read_buffer, &pcm, &temp_bytes_read)) {
         bytes_read += temp_bytes_read;
         packet = (unsigned char*)(p_buf + 1) + p_buf->offset + p_buf->len;
 
         if (a2dp_opus_encoder_cb.opus_handle == NULL) {
           LOG_ERROR("invalid OPUS handle");
+          if (pcm != read_buffer) {
+            a2dp_opus_encoder_cb.span_callbacks->release(temp_bytes_read);
+          }
           a2dp_opus_encoder_cb.stats.media_read_total_dropped_packets++;
           osi_free(p_buf);
           return;
@@ -404,8 +460,11 @@ static void a2dp_opus_encode_frames(uint8_t nb_frame) {
 
         written =
             opus_encode(a2dp_opus_encoder_cb.opus_handle,
-                        (const opus_int16*)&read_buffer[0], opus_frame_size,
-                        packet, (BT_DEFAULT_BUFFER_SIZE - p_buf->offset));
+                        (const opus_int16*)pcm, opus_frame_size, packet,
+                        (BT_DEFAULT_BUFFER_SIZE - p_buf->offset));
+        if (pcm != read_buffer) {
+          a2dp_opus_encoder_cb.span_callbacks->release(temp_bytes_read);
+        }
 
         if (written <= 0) {
           LOG_ERROR("OPUS encoding error");
@@ -452,7 +511,8 @@ static void a2dp_opus_encode_frames(uint8_t nb_frame) {
   }
 }
 
-static bool a2dp_opus_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
+static bool a2dp_opus_read_feeding(uint8_t* read_buffer, const uint8_t** p_pcm,
+                                   uint32_t* bytes_read) {
   uint32_t read_size = a2dp_opus_encoder_cb.opus_encoder_params.framesize *
                        a2dp_opus_encoder_cb.feeding_params.channel_count *
                        a2dp_opus_encoder_cb.feeding_params.bits_per_sample / 8;
@@ -460,6 +520,16 @@ static bool a2dp_opus_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
   a2dp_opus_encoder_cb.stats.media_read_total_expected_reads_count++;
   a2dp_opus_encoder_cb.stats.media_read_total_expected_read_bytes += read_size;
 
+  /* Encode in place when a whole frame is available from the audio HAL */
+  if (a2dp_opus_encoder_cb.span_callbacks != nullptr &&
+      a2dp_opus_encoder_cb.span_callbacks->peek(p_pcm, read_size)) {
+    a2dp_opus_encoder_cb.stats.media_read_total_actual_read_bytes += read_size;
+    a2dp_opus_encoder_cb.stats.media_read_total_actual_reads_count++;
+    *bytes_read = read_size;
+    return true;
+  }
+  *p_pcm = read_buffer;
+
   /* Read Data from UIPC channel */
   uint32_t nb_byte_read =
       a2dp_opus_encoder_cb.read_callback(read_buffer, read_size);
@@ -17,10 +17,13 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
+#include "osi/include/alarm.h"
+#include "stack/acl/link_activity.h"
 #include "stack/acl/peer_packet_types.h"
 #include "stack/include/acl_api_types.h"
 #include "stack/include/bt_types.h"
@@ -166,6 +169,22 @@ struct tBTM_PM_MCB {
   uint16_t max_lat = 0;
   uint16_t min_loc_to = 0;
   uint16_t min_rmt_to = 0;
+
+  /* traffic prediction and power mode statistics of the link */
+  LinkActivity activity;
+  alarm_t* wake_timer = nullptr; /* leaves sniff ahead of the next burst */
+  uint64_t mode_request_us = 0;  /* when the pending mode command was sent */
+  size_t sniff_count = 0;
+  size_t active_count = 0;
+  size_t early_wake_count = 0;
+  size_t sniff_packet_count = 0; /* packets sent or received in sniff */
+  /* latency of the mode changes requested by the host */
+  size_t to_sniff_requests = 0;
+  size_t to_active_requests = 0;
+  uint64_t to_sniff_latency_us = 0;  /* total */
+  uint64_t to_active_latency_us = 0; /* total */
+  uint64_t max_to_active_latency_us = 0;
+
   void Init(RawAddress bda, uint16_t handle) {
     bda_ = bda;
     handle_ = handle;
@@ -390,6 +409,11 @@ struct tACL_CB {
   friend struct StackAclBtmAcl;
 
   tACL_CONN acl_db[MAX_L2CAP_LINKS];
+  /* Lookup hints over acl_db, each hit is checked against the entry. They
+   * hold 1 + index in acl_db, 0 if none.
+   */
+  uint8_t acl_index_by_handle[HCI_DATA_HANDLE_MASK + 1]{};
+  std::map<std::pair<RawAddress, tBT_TRANSPORT>, uint8_t> acl_index_by_address;
   tBTM_ROLE_SWITCH_CMPL switch_role_ref_data;
   uint16_t btm_acl_pkt_types_supported = kDefaultPacketTypeMask;
   uint16_t btm_def_link_policy;
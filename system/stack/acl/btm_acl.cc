@@ -316,10 +316,23 @@ void BTM_acl_after_controller_started(const controller_t* controller) {
  ******************************************************************************/
 tACL_CONN* StackAclBtmAcl::btm_bda_to_acl(const RawAddress& bda,
                                           tBT_TRANSPORT transport) {
+  auto& index_by_address = btm_cb.acl_cb_.acl_index_by_address;
+  auto hint = index_by_address.find(std::make_pair(bda, transport));
+  if (hint != index_by_address.end()) {
+    tACL_CONN* p_acl = &btm_cb.acl_cb_.acl_db[hint->second - 1];
+    if ((p_acl->in_use) && p_acl->remote_addr == bda &&
+        p_acl->transport == transport) {
+      return p_acl;
+    }
+    index_by_address.erase(hint);
+  }
+
+  /* The address may have been consolidated since the hint was stored */
   tACL_CONN* p_acl = &btm_cb.acl_cb_.acl_db[0];
   for (uint8_t index = 0; index < MAX_L2CAP_LINKS; index++, p_acl++) {
     if ((p_acl->in_use) && p_acl->remote_addr == bda &&
         p_acl->transport == transport) {
+      index_by_address[std::make_pair(bda, transport)] = index + 1;
       return p_acl;
     }
   }
@@ -362,8 +375,19 @@ void btm_acl_consolidate(const RawAddress& identity_addr,
  *
  ******************************************************************************/
 uint8_t btm_handle_to_acl_index(uint16_t hci_handle) {
-  tACL_CONN* p = &btm_cb.acl_cb_.acl_db[0];
+  tACL_CONN* p;
   uint8_t xx;
+
+  if (hci_handle <= HCI_DATA_HANDLE_MASK &&
+      btm_cb.acl_cb_.acl_index_by_handle[hci_handle] != 0) {
+    xx = btm_cb.acl_cb_.acl_index_by_handle[hci_handle] - 1;
+    p = &btm_cb.acl_cb_.acl_db[xx];
+    if ((p->in_use) && (p->hci_handle == hci_handle)) {
+      return (xx);
+    }
+  }
+
+  p = &btm_cb.acl_cb_.acl_db[0];
   for (xx = 0; xx < MAX_L2CAP_LINKS; xx++, p++) {
     if ((p->in_use) && (p->hci_handle == hci_handle)) {
       break;
@@ -447,6 +471,14 @@ void btm_acl_created(const RawAddress& bda, uint16_t hci_handle,
     return;
   }
 
+  const uint8_t acl_index =
+      static_cast<uint8_t>(1 + (p_acl - &btm_cb.acl_cb_.acl_db[0]));
+  if (hci_handle <= HCI_DATA_HANDLE_MASK) {
+    btm_cb.acl_cb_.acl_index_by_handle[hci_handle] = acl_index;
+  }
+  btm_cb.acl_cb_.acl_index_by_address[std::make_pair(bda, transport)] =
+      acl_index;
+
   p_acl->in_use = true;
   p_acl->hci_handle = hci_handle;
   p_acl->link_role = link_role;
@@ -523,6 +555,15 @@ void btm_acl_removed(uint16_t handle) {
     return;
   }
   p_acl->in_use = false;
+  const uint8_t acl_index =
+      static_cast<uint8_t>(1 + (p_acl - &btm_cb.acl_cb_.acl_db[0]));
+  if (handle <= HCI_DATA_HANDLE_MASK) {
+    btm_cb.acl_cb_.acl_index_by_handle[handle] = 0;
+  }
+  auto& index_by_address = btm_cb.acl_cb_.acl_index_by_address;
+  for (auto it = index_by_address.begin(); it != index_by_address.end();) {
+    it = (it->second == acl_index) ? index_by_address.erase(it) : ++it;
+  }
   NotifyAclLinkDown(*p_acl);
   if (p_acl->is_transport_br_edr()) {
     BTM_PM_OnDisconnected(handle);
@@ -2830,6 +2871,7 @@ void acl_send_data_packet_br_edr(const RawAddress& bd_addr, BT_HDR* p_buf) {
       osi_free(p_buf);
       return;
     }
+    BTM_PM_OnAclData(p_acl->hci_handle);
     return bluetooth::shim::ACL_WriteData(p_acl->hci_handle, p_buf);
 }
 
@@ -32,16 +32,20 @@
 
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <unordered_map>
 
 #include "bt_target.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "device/include/interop.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
+#include "osi/include/alarm.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"  // UNUSED_ATTR
+#include "osi/include/properties.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/btm_api.h"
 #include "stack/include/btm_api_types.h"
@@ -51,6 +55,12 @@
 void l2c_OnHciModeChangeSendPendingPackets(RawAddress remote);
 void btm_sco_chk_pend_unpark(tHCI_STATUS status, uint16_t handle);
 void btm_cont_rswitch_from_handle(uint16_t hci_handle);
+
+/* Adapts the sniff parameters to the traffic of the links, and leaves sniff
+ * mode ahead of the predicted bursts */
+#define BTM_PM_TRAFFIC_PREDICTION_PROPERTY \
+  "persist.bluetooth.pm.traffic_prediction"
+
 extern tBTM_CB btm_cb;
 
 namespace {
@@ -72,6 +82,12 @@ tBTM_PM_RCB pm_reg_db; /* per application/module */
 uint8_t pm_pend_id = 0; /* the id pf the module, which has a pending PM cmd */
 
 constexpr char kBtmLogTag[] = "ACL";
+
+// Lead time of the early wake ups until a mode change has been measured
+constexpr uint64_t kBtmPmDefaultWakeLeadUs = 30000;
+constexpr uint64_t kBtmPmWakeMarginUs = 5000;
+// The bursts have to be this many sniff intervals apart to wake up early
+constexpr uint64_t kBtmPmMinWakeIntervals = 4;
 }
 
 /*****************************************************************************/
@@ -106,6 +122,37 @@ static tBTM_STATUS btm_pm_snd_md_req(uint16_t handle, uint8_t pm_id,
                                      int link_ind,
                                      const tBTM_PM_PWR_MD* p_mode);
 
+static bool btm_pm_traffic_prediction_enabled() {
+  return osi_property_get_bool(BTM_PM_TRAFFIC_PREDICTION_PROPERTY, true);
+}
+
+static double us_to_ms(uint64_t us) { return us / 1000.0; }
+
+static void btm_pm_log_link_stats(const tBTM_PM_MCB& cb) {
+  const uint64_t to_sniff_us =
+      cb.to_sniff_requests ? cb.to_sniff_latency_us / cb.to_sniff_requests : 0;
+  const uint64_t to_active_us =
+      cb.to_active_requests ? cb.to_active_latency_us / cb.to_active_requests
+                            : 0;
+  const std::string stats = base::StringPrintf(
+      "sniff:%zu active:%zu early_wake:%zu sniff_packets:%zu/%zu "
+      "to_sniff_ms:%.1f to_active_ms:%.1f max_to_active_ms:%.1f "
+      "burst_period_ms:%.1f",
+      cb.sniff_count, cb.active_count, cb.early_wake_count,
+      cb.sniff_packet_count, cb.activity.GetPacketCount(),
+      us_to_ms(to_sniff_us), us_to_ms(to_active_us),
+      us_to_ms(cb.max_to_active_latency_us),
+      us_to_ms(cb.activity.GetBurstPeriodUs()));
+  LOG_INFO("Power mode stats peer:%s %s", ADDRESS_TO_LOGGABLE_CSTR(cb.bda_),
+           stats.c_str());
+  BTM_LogHistory(kBtmLogTag, cb.bda_, "Power mode stats", stats);
+}
+
+static void btm_pm_free_wake_timer(tBTM_PM_MCB* p_cb) {
+  alarm_free(p_cb->wake_timer);
+  p_cb->wake_timer = nullptr;
+}
+
 /*****************************************************************************/
 /*                     P U B L I C  F U N C T I O N S                        */
 /*****************************************************************************/
@@ -151,14 +198,19 @@ void BTM_PM_OnConnected(uint16_t handle, const RawAddress& remote_bda) {
   if (pm_mode_db.find(handle) != pm_mode_db.end()) {
     LOG_ERROR("Overwriting power mode db entry handle:%hu peer:%s", handle,
               ADDRESS_TO_LOGGABLE_CSTR(remote_bda));
+    btm_pm_free_wake_timer(&pm_mode_db[handle]);
   }
   pm_mode_db[handle] = {};
   pm_mode_db[handle].Init(remote_bda, handle);
 }
 
 void BTM_PM_OnDisconnected(uint16_t handle) {
-  if (pm_mode_db.find(handle) == pm_mode_db.end()) {
+  auto entry = pm_mode_db.find(handle);
+  if (entry == pm_mode_db.end()) {
     LOG_ERROR("Erasing unknown power mode db entry handle:%hu", handle);
+  } else {
+    btm_pm_log_link_stats(entry->second);
+    btm_pm_free_wake_timer(&entry->second);
   }
   pm_mode_db.erase(handle);
   if (handle == pm_pend_link) {
@@ -166,6 +218,14 @@ void BTM_PM_OnDisconnected(uint16_t handle) {
   }
 }
 
+void BTM_PM_OnAclData(uint16_t handle) {
+  auto entry = pm_mode_db.find(handle);
+  if (entry == pm_mode_db.end()) return;
+  tBTM_PM_MCB& cb = entry->second;
+  cb.activity.OnPacket(bluetooth::common::time_get_os_boottime_us());
+  if (cb.state == BTM_PM_ST_SNIFF) cb.sniff_packet_count++;
+}
+
 /*******************************************************************************
  *
  * Function         BTM_SetPowerMode
@@ -339,6 +399,10 @@ tBTM_STATUS BTM_SetSsrParams(const RawAddress& remote_bda, uint16_t max_lat,
         " min_local_timeout:0x%04x",
         power_mode_state_text(p_cb->state).c_str(), p_cb->state, max_lat,
         min_rmt_to, min_loc_to);
+    if (btm_pm_traffic_prediction_enabled()) {
+      max_lat = p_cb->activity.ChooseSniffMaxLatency(
+          bluetooth::common::time_get_os_boottime_us(), max_lat);
+    }
     send_sniff_subrating(p_cb->handle_, remote_bda, max_lat, min_rmt_to,
                          min_loc_to);
     return BTM_SUCCESS;
@@ -375,6 +439,9 @@ void btm_pm_reset(void) {
   }
   /* no command pending */
   pm_pend_link = 0;
+  for (auto& entry : pm_mode_db) {
+    btm_pm_free_wake_timer(&entry.second);
+  }
   pm_mode_db.clear();
   pm_pend_id = 0;
   memset(&pm_reg_db, 0, sizeof(pm_reg_db));
@@ -550,11 +617,26 @@ static tBTM_STATUS btm_pm_snd_md_req(uint16_t handle, uint8_t pm_id,
   if (p_cb->chg_ind) {
     LOG_DEBUG("Need to wake first");
     md_res.mode = BTM_PM_MD_ACTIVE;
-  } else if (BTM_PM_MD_SNIFF == md_res.mode && p_cb->max_lat) {
+  } else if (BTM_PM_MD_SNIFF == md_res.mode) {
+    const uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+    const bool prediction = btm_pm_traffic_prediction_enabled();
+    if (prediction) {
+      const uint16_t max_interval =
+          p_cb->activity.ChooseSniffInterval(now_us, md_res.min, md_res.max);
+      if (max_interval != md_res.max) {
+        LOG_DEBUG("Lowering sniff max interval from %hu to %hu for traffic",
+                  md_res.max, max_interval);
+        md_res.max = max_interval;
+      }
+    }
     const controller_t* controller = controller_get_interface();
-    if (controller->supports_sniff_subrating()) {
+    if (p_cb->max_lat && controller->supports_sniff_subrating()) {
       LOG_DEBUG("Sending sniff subrating to controller");
-      send_sniff_subrating(handle, p_cb->bda_, p_cb->max_lat, p_cb->min_rmt_to,
+      const uint16_t max_lat =
+          prediction ? p_cb->activity.ChooseSniffMaxLatency(now_us,
+                                                               p_cb->max_lat)
+                     : p_cb->max_lat;
+      send_sniff_subrating(handle, p_cb->bda_, max_lat, p_cb->min_rmt_to,
                            p_cb->min_loc_to);
     }
     p_cb->max_lat = 0;
@@ -616,6 +698,7 @@ static tBTM_STATUS btm_pm_snd_md_req(uint16_t handle, uint8_t pm_id,
     LOG_ERROR("pm_pending_link maxed out");
     return (BTM_NO_RESOURCES);
   }
+  p_cb->mode_request_us = bluetooth::common::time_get_os_boottime_us();
 
   return BTM_CMD_STARTED;
 }
@@ -670,6 +753,8 @@ void btm_pm_proc_cmd_status(tHCI_STATUS status) {
   if (status == HCI_SUCCESS) {
     p_cb->state = BTM_PM_ST_PENDING;
     pm_status = BTM_PM_STS_PENDING;
+  } else {
+    p_cb->mode_request_us = 0;
   }
 
   /* notify the caller is appropriate */
@@ -687,6 +772,55 @@ void btm_pm_proc_cmd_status(tHCI_STATUS status) {
   btm_pm_continue_pending_mode_changes();
 }
 
+/*******************************************************************************
+ *
+ * Function         btm_pm_wake_timeout
+ *
+ * Description      Leaves sniff mode ahead of the predicted burst of a link.
+ *
+ ******************************************************************************/
+static void btm_pm_wake_timeout(void* data) {
+  const uint16_t handle = PTR_TO_UINT(data);
+  auto entry = pm_mode_db.find(handle);
+  if (entry == pm_mode_db.end()) return;
+  tBTM_PM_MCB* p_cb = &entry->second;
+  if (p_cb->state != BTM_PM_ST_SNIFF ||
+      !p_cb->activity.IsRegular(bluetooth::common::time_get_os_boottime_us())) {
+    return;
+  }
+  LOG_DEBUG("Leaving sniff mode ahead of the next burst peer:%s",
+            ADDRESS_TO_LOGGABLE_CSTR(p_cb->bda_));
+  p_cb->early_wake_count++;
+  BTM_SetLinkPolicyActiveMode(p_cb->bda_);
+}
+
+static void btm_pm_schedule_wake(tBTM_PM_MCB* p_cb) {
+  const uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  const LinkActivity& activity = p_cb->activity;
+  const uint64_t period_us = activity.GetBurstPeriodUs();
+  const uint64_t interval_us = p_cb->interval * LinkActivity::kSlotUs;
+  if (!activity.IsRegular(now_us) ||
+      period_us < kBtmPmMinWakeIntervals * interval_us) {
+    return;
+  }
+
+  // Leave sniff mode as long before the burst as it took the last times
+  uint64_t lead_us = kBtmPmDefaultWakeLeadUs;
+  if (p_cb->to_active_requests != 0) {
+    lead_us = p_cb->to_active_latency_us / p_cb->to_active_requests +
+              kBtmPmWakeMarginUs;
+  }
+  uint64_t next_burst_us = activity.GetNextBurstUs();
+  while (next_burst_us <= now_us + lead_us) next_burst_us += period_us;
+
+  if (p_cb->wake_timer == nullptr) {
+    p_cb->wake_timer = alarm_new("btm_pm.wake_timer");
+  }
+  alarm_set_on_mloop(p_cb->wake_timer,
+                     (next_burst_us - lead_us - now_us) / 1000,
+                     btm_pm_wake_timeout, UINT_TO_PTR(p_cb->handle_));
+}
+
 /*******************************************************************************
  *
  * Function         btm_process_mode_change
@@ -723,6 +857,34 @@ void btm_pm_proc_mode_change(tHCI_STATUS hci_status, uint16_t hci_handle,
            power_mode_state_text(old_state).c_str(), old_state,
            power_mode_state_text(p_cb->state).c_str(), p_cb->state);
 
+  /* account for the transition and its latency */
+  const uint64_t latency_us =
+      p_cb->mode_request_us
+          ? bluetooth::common::time_get_os_boottime_us() - p_cb->mode_request_us
+          : 0;
+  p_cb->mode_request_us = 0;
+  if (hci_status == HCI_SUCCESS && mode == BTM_PM_MD_SNIFF) {
+    p_cb->sniff_count++;
+    if (latency_us) {
+      p_cb->to_sniff_requests++;
+      p_cb->to_sniff_latency_us += latency_us;
+    }
+    if (btm_pm_traffic_prediction_enabled()) btm_pm_schedule_wake(p_cb);
+  } else if (hci_status == HCI_SUCCESS && mode == BTM_PM_MD_ACTIVE) {
+    p_cb->active_count++;
+    if (latency_us) {
+      p_cb->to_active_requests++;
+      p_cb->to_active_latency_us += latency_us;
+      p_cb->max_to_active_latency_us =
+          std::max(p_cb->max_to_active_latency_us, latency_us);
+    }
+    if (p_cb->wake_timer != nullptr) alarm_cancel(p_cb->wake_timer);
+  }
+  if (latency_us) {
+    LOG_DEBUG("Power mode change took %.1f ms peer:%s", us_to_ms(latency_us),
+              ADDRESS_TO_LOGGABLE_CSTR(p_cb->bda_));
+  }
+
   if ((p_cb->state == BTM_PM_ST_ACTIVE) || (p_cb->state == BTM_PM_ST_SNIFF)) {
     l2c_OnHciModeChangeSendPendingPackets(p_cb->bda_);
   }
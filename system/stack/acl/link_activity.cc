@@ -0,0 +1,67 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/acl/link_activity.h"
+
+#include <algorithm>
+
+void LinkActivity::OnPacket(uint64_t timestamp_us) {
+  bool new_burst =
+      packet_count_ == 0 || timestamp_us - last_packet_us_ > kBurstGapUs;
+  packet_count_++;
+  last_packet_us_ = timestamp_us;
+  if (!new_burst) return;
+
+  if (burst_count_ == 1) {
+    // The first period is only a guess, start with a large deviation
+    period_us_ = timestamp_us - burst_start_us_;
+    deviation_us_ = period_us_ / 2;
+  } else if (burst_count_ > 1) {
+    int64_t error = static_cast<int64_t>(timestamp_us - burst_start_us_) -
+                    static_cast<int64_t>(period_us_);
+    period_us_ += error / (1 << kPeriodShift);
+    int64_t deviation_error = (error < 0 ? -error : error) -
+                              static_cast<int64_t>(deviation_us_);
+    deviation_us_ += deviation_error / (1 << kDeviationShift);
+  }
+  burst_start_us_ = timestamp_us;
+  burst_count_++;
+}
+
+bool LinkActivity::IsRegular(uint64_t timestamp_us) const {
+  if (burst_count_ < kMinBursts || period_us_ == 0) return false;
+  if (deviation_us_ * 4 > period_us_) return false;
+  // The pattern is broken once the next burst is late by half a period
+  return timestamp_us <= GetNextBurstUs() + period_us_ / 2;
+}
+
+uint16_t LinkActivity::ChooseSniffInterval(uint64_t timestamp_us,
+                                           uint16_t min_interval,
+                                           uint16_t max_interval) const {
+  if (!IsRegular(timestamp_us) || min_interval > max_interval) {
+    return max_interval;
+  }
+  // Sniff intervals are an even number of slots
+  uint64_t interval = (period_us_ / 4 / kSlotUs) & ~1ull;
+  interval = std::min<uint64_t>(interval, max_interval);
+  return std::max<uint64_t>(interval, min_interval);
+}
+
+uint16_t LinkActivity::ChooseSniffMaxLatency(uint64_t timestamp_us,
+                                             uint16_t max_latency) const {
+  if (!IsRegular(timestamp_us)) return max_latency;
+  return std::min<uint64_t>(max_latency, period_us_ / 2 / kSlotUs);
+}
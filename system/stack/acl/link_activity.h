@@ -0,0 +1,77 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//
+// Activity predictor of an ACL link, fed with the timestamps of the packets
+// sent and received on the link.
+//
+// Packets closer than a burst gap are grouped into bursts, and the period
+// between the starts of the bursts is smoothed along with its deviation. When
+// the deviation is small against the period the traffic is regular, and the
+// start of the next burst can be predicted: the power manager uses it to pick
+// sniff parameters that do not delay the bursts too much, and to leave sniff
+// mode just before the next burst instead of after it.
+//
+class LinkActivity {
+ public:
+  static constexpr uint64_t kSlotUs = 625;
+
+  void OnPacket(uint64_t timestamp_us);
+
+  // The traffic is regular, and its pattern still holds at |timestamp_us|.
+  bool IsRegular(uint64_t timestamp_us) const;
+
+  // Smoothed period between the bursts, 0 before the second burst.
+  uint64_t GetBurstPeriodUs() const { return period_us_; }
+
+  // Predicted start of the next burst, only meaningful if IsRegular().
+  uint64_t GetNextBurstUs() const { return burst_start_us_ + period_us_; }
+
+  // The largest sniff interval, in slots, within [|min_interval|,
+  // |max_interval|] that keeps the wait of a burst under a quarter of the
+  // burst period. |max_interval| if the traffic is not regular.
+  uint16_t ChooseSniffInterval(uint64_t timestamp_us, uint16_t min_interval,
+                               uint16_t max_interval) const;
+
+  // The sniff subrating max latency, in slots, capped to half the burst
+  // period. |max_latency| if the traffic is not regular.
+  uint16_t ChooseSniffMaxLatency(uint64_t timestamp_us,
+                                 uint16_t max_latency) const;
+
+  size_t GetPacketCount() const { return packet_count_; }
+  size_t GetBurstCount() const { return burst_count_; }
+
+ private:
+  // Packets closer than this belong to the same burst
+  static constexpr uint64_t kBurstGapUs = 10000;
+  // Bursts needed before trusting the period
+  static constexpr size_t kMinBursts = 4;
+  // The period is smoothed over 8 bursts, its deviation over 4
+  static constexpr int kPeriodShift = 3;
+  static constexpr int kDeviationShift = 2;
+
+  uint64_t last_packet_us_ = 0;
+  uint64_t burst_start_us_ = 0;
+  uint64_t period_us_ = 0;
+  uint64_t deviation_us_ = 0;
+  size_t packet_count_ = 0;
+  size_t burst_count_ = 0;
+};
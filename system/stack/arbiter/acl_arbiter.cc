@@ -98,7 +98,10 @@ class RustGattAclArbiter : public AclArbiter {
     uint8_t* packet_start = (uint8_t*)(packet + 1) + packet->offset;
     uint8_t* packet_end = packet_start + packet->len;
 
+    // Rust boxes the packet, which shrinks it to its length: reserving that
+    // length upfront avoids reallocating it while copying and while boxing
     auto vec = ::rust::Vec<uint8_t>();
+    vec.reserve(packet->len);
     std::copy(packet_start, packet_end, std::back_inserter(vec));
     return callbacks_.intercept_packet(tcb_idx, std::move(vec));
   }
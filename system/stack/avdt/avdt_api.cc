@@ -38,6 +38,7 @@
 #include "stack/btm/btm_sec.h"
 #include "stack/include/a2dp_codec_api.h"
 #include "stack/include/bt_hdr.h"
+#include "stack/include/btu.h"  // btu_check_executor_affinity
 #include "types/raw_address.h"
 
 /* Control block for AVDTP */
@@ -248,6 +249,8 @@ uint16_t AVDT_RemoveStream(uint8_t handle) {
 uint16_t AVDT_DiscoverReq(const RawAddress& bd_addr, uint8_t channel_index,
                           tAVDT_SEP_INFO* p_sep_info, uint8_t max_seps,
                           tAVDT_CTRL_CBACK* p_cback) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::AUDIO_CONTROL, __func__);
+
   AvdtpCcb* p_ccb;
   uint16_t result = AVDT_SUCCESS;
   tAVDT_CCB_EVT evt;
@@ -442,6 +445,8 @@ uint16_t AVDT_DelayReport(uint8_t handle, uint8_t seid, uint16_t delay) {
 uint16_t AVDT_OpenReq(uint8_t handle, const RawAddress& bd_addr,
                       uint8_t channel_index, uint8_t seid,
                       AvdtpSepConfig* p_cfg) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::AUDIO_CONTROL, __func__);
+
   AvdtpCcb* p_ccb = NULL;
   AvdtpScb* p_scb = NULL;
   uint16_t result = AVDT_SUCCESS;
@@ -559,6 +564,8 @@ uint16_t AVDT_ConfigRsp(uint8_t handle, uint8_t label, uint8_t error_code,
  *
  ******************************************************************************/
 uint16_t AVDT_StartReq(uint8_t* p_handles, uint8_t num_handles) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::AUDIO_CONTROL, __func__);
+
   AvdtpScb* p_scb = NULL;
   tAVDT_CCB_EVT evt;
   uint16_t result = AVDT_SUCCESS;
@@ -619,6 +626,8 @@ uint16_t AVDT_StartReq(uint8_t* p_handles, uint8_t num_handles) {
  *
  ******************************************************************************/
 uint16_t AVDT_SuspendReq(uint8_t* p_handles, uint8_t num_handles) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::AUDIO_CONTROL, __func__);
+
   AvdtpScb* p_scb = NULL;
   tAVDT_CCB_EVT evt;
   uint16_t result = AVDT_SUCCESS;
@@ -678,6 +687,8 @@ uint16_t AVDT_SuspendReq(uint8_t* p_handles, uint8_t num_handles) {
  *
  ******************************************************************************/
 uint16_t AVDT_CloseReq(uint8_t handle) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::AUDIO_CONTROL, __func__);
+
   AvdtpScb* p_scb;
   uint16_t result = AVDT_SUCCESS;
 
@@ -717,6 +728,8 @@ uint16_t AVDT_CloseReq(uint8_t handle) {
  *
  ******************************************************************************/
 uint16_t AVDT_ReconfigReq(uint8_t handle, AvdtpSepConfig* p_cfg) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::AUDIO_CONTROL, __func__);
+
   AvdtpScb* p_scb;
   uint16_t result = AVDT_SUCCESS;
   tAVDT_SCB_EVT evt;
@@ -0,0 +1,490 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Encode and decode cost of the codecs of the stack, on the libraries the
+// stack links, at the configurations the A2DP, HFP, LE Audio and ASHA paths
+// use them. Each iteration codes one frame, items_per_second is the number of
+// frames per second and max_frame_us the slowest frame of the run.
+
+#include <aacenc_lib.h>
+#include <benchmark/benchmark.h>
+#include <ldacBT.h>
+#include <math.h>
+#include <opus.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "aptXHDbtenc.h"
+#include "aptXbtenc.h"
+#include "embdrv/g722/g722_enc_dec.h"
+#include "embdrv/lc3/include/lc3.h"
+#include "embdrv/sbc/decoder/include/oi_codec_sbc.h"
+#include "embdrv/sbc/decoder/include/oi_status.h"
+#include "embdrv/sbc/encoder/include/sbc_encoder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// Two tones and some noise, so that the codecs spend the bits they would on
+// music instead of short cutting silence
+std::vector<int16_t> Pcm(size_t samples_per_channel, int channels,
+                         int sample_rate) {
+  std::vector<int16_t> pcm(samples_per_channel * channels);
+  std::minstd_rand noise(1);
+  for (size_t i = 0; i < samples_per_channel; i++) {
+    double t = static_cast<double>(i) / sample_rate;
+    for (int c = 0; c < channels; c++) {
+      double sample = 8000 * sin(2 * M_PI * (440 + 110 * c) * t) +
+                      4000 * sin(2 * M_PI * 3150 * t) +
+                      static_cast<int>(noise() % 1024) - 512;
+      pcm[i * channels + c] = static_cast<int16_t>(sample);
+    }
+  }
+  return pcm;
+}
+
+// Time each frame to report the worst one along with the throughput
+template <typename CodeFrame>
+void RunFrames(State& state, CodeFrame code_frame) {
+  std::chrono::steady_clock::duration worst(0);
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    code_frame();
+    worst = std::max(worst, std::chrono::steady_clock::now() - start);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["max_frame_us"] =
+      std::chrono::duration<double, std::micro>(worst).count();
+}
+
+/* SBC and mSBC */
+
+constexpr int kSbcSamplesPerFrame = 16 * 8;
+constexpr int kMsbcSamplesPerFrame = 15 * 8;
+
+void SetupSbcEncoder(SBC_ENC_PARAMS* params, int sampling_freq,
+                     int16_t bitpool) {
+  *params = {};
+  params->s16SamplingFreq = sampling_freq;
+  params->s16ChannelMode = SBC_JOINT_STEREO;
+  params->s16NumOfSubBands = 8;
+  params->s16NumOfChannels = 2;
+  params->s16NumOfBlocks = 16;
+  params->s16AllocationMethod = SBC_LOUDNESS;
+  params->s16BitPool = bitpool;
+  params->Format = SBC_FORMAT_GENERAL;
+  SBC_Encoder_Init(params);
+}
+
+void SetupMsbcEncoder(SBC_ENC_PARAMS* params) {
+  *params = {};
+  params->s16SamplingFreq = SBC_sf16000;
+  params->s16ChannelMode = SBC_MONO;
+  params->s16NumOfSubBands = 8;
+  params->s16NumOfChannels = 1;
+  params->s16NumOfBlocks = 15;
+  params->s16AllocationMethod = SBC_LOUDNESS;
+  params->s16BitPool = 26;
+  params->Format = SBC_FORMAT_MSBC;
+  SBC_Encoder_Init(params);
+}
+
+// range(0) is 0 for 44.1kHz and 1 for 48kHz, at the bitpools of the high
+// quality A2DP configuration, and range(1) enables the SIMD analysis filter
+void BM_SbcEncode(State& state) {
+  bool is_48k = state.range(0) != 0;
+  SBC_Encoder_UseSimd(state.range(1) != 0);
+  SBC_ENC_PARAMS params;
+  SetupSbcEncoder(&params, is_48k ? SBC_sf48000 : SBC_sf44100,
+                  is_48k ? 51 : 53);
+  auto pcm = Pcm(kSbcSamplesPerFrame, 2, is_48k ? 48000 : 44100);
+  uint8_t output[512];
+  RunFrames(state, [&]() {
+    ::benchmark::DoNotOptimize(SBC_Encode(&params, pcm.data(), output));
+  });
+  SBC_Encoder_UseSimd(true);
+}
+BENCHMARK(BM_SbcEncode)->ArgsProduct({{0, 1}, {0, 1}});
+
+void BM_MsbcEncode(State& state) {
+  SBC_ENC_PARAMS params;
+  SetupMsbcEncoder(&params);
+  auto pcm = Pcm(kMsbcSamplesPerFrame, 1, 16000);
+  uint8_t output[512];
+  RunFrames(state, [&]() {
+    ::benchmark::DoNotOptimize(SBC_Encode(&params, pcm.data(), output));
+  });
+}
+BENCHMARK(BM_MsbcEncode);
+
+struct SbcDecoder {
+  OI_CODEC_SBC_DECODER_CONTEXT context;
+  uint32_t context_data[CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS)];
+};
+
+// Decodes a frame of the bitstream the encoder produces in the same
+// configuration
+void RunSbcDecode(State& state, SbcDecoder* decoder,
+                  const std::vector<uint8_t>& frame, size_t pcm_samples) {
+  std::vector<int16_t> pcm(pcm_samples);
+  RunFrames(state, [&]() {
+    const OI_BYTE* data = frame.data();
+    uint32_t data_size = frame.size();
+    uint32_t pcm_bytes = pcm.size() * sizeof(int16_t);
+    OI_STATUS status = OI_CODEC_SBC_DecodeFrame(
+        &decoder->context, &data, &data_size, pcm.data(), &pcm_bytes);
+    if (!OI_SUCCESS(status)) {
+      state.SkipWithError("Decoding failure");
+    }
+  });
+}
+
+void BM_SbcDecode(State& state) {
+  SBC_ENC_PARAMS params;
+  SetupSbcEncoder(&params, SBC_sf44100, 53);
+  auto pcm = Pcm(kSbcSamplesPerFrame, 2, 44100);
+  std::vector<uint8_t> frame(512);
+  frame.resize(SBC_Encode(&params, pcm.data(), frame.data()));
+
+  SbcDecoder decoder;
+  OI_CODEC_SBC_DecoderReset(&decoder.context, decoder.context_data,
+                            sizeof(decoder.context_data), 2, 2, false);
+  RunSbcDecode(state, &decoder, frame, kSbcSamplesPerFrame * 2);
+}
+BENCHMARK(BM_SbcDecode);
+
+void BM_MsbcDecode(State& state) {
+  SBC_ENC_PARAMS params;
+  SetupMsbcEncoder(&params);
+  auto pcm = Pcm(kMsbcSamplesPerFrame, 1, 16000);
+  std::vector<uint8_t> frame(512);
+  frame.resize(SBC_Encode(&params, pcm.data(), frame.data()));
+
+  SbcDecoder decoder;
+  OI_CODEC_SBC_DecoderReset(&decoder.context, decoder.context_data,
+                            sizeof(decoder.context_data), 1, 1, false);
+  OI_CODEC_SBC_DecoderConfigureMSbc(&decoder.context);
+  RunSbcDecode(state, &decoder, frame, kMsbcSamplesPerFrame);
+}
+BENCHMARK(BM_MsbcDecode);
+
+/* aptX and aptX HD */
+
+// aptX has no frames, each iteration encodes the 512 samples of a read of the
+// A2DP encoder, 4 samples per codeword
+constexpr size_t kAptxSamplesPerIteration = 512;
+
+void BM_AptxEncode(State& state) {
+  void* encoder = malloc(SizeofAptxbtenc());
+  aptxbtenc_init(encoder, 0);
+  auto pcm = Pcm(kAptxSamplesPerIteration, 2, 44100);
+  RunFrames(state, [&]() {
+    for (size_t i = 0; i < pcm.size(); i += 8) {
+      uint32_t pcm_l[4];
+      uint32_t pcm_r[4];
+      for (size_t j = 0; j < 4; j++) {
+        pcm_l[j] = static_cast<uint16_t>(pcm[i + 2 * j]);
+        pcm_r[j] = static_cast<uint16_t>(pcm[i + 2 * j + 1]);
+      }
+      uint16_t codeword[2];
+      aptxbtenc_encodestereo(encoder, pcm_l, pcm_r, codeword);
+      ::benchmark::DoNotOptimize(codeword);
+    }
+  });
+  free(encoder);
+}
+BENCHMARK(BM_AptxEncode);
+
+void BM_AptxHdEncode(State& state) {
+  void* encoder = malloc(SizeofAptxhdbtenc());
+  aptxhdbtenc_init(encoder, 0);
+  auto pcm = Pcm(kAptxSamplesPerIteration, 2, 48000);
+  RunFrames(state, [&]() {
+    for (size_t i = 0; i < pcm.size(); i += 8) {
+      uint32_t pcm_l[4];
+      uint32_t pcm_r[4];
+      for (size_t j = 0; j < 4; j++) {
+        // 24 bit samples
+        pcm_l[j] = static_cast<uint32_t>(pcm[i + 2 * j]) << 8;
+        pcm_r[j] = static_cast<uint32_t>(pcm[i + 2 * j + 1]) << 8;
+      }
+      uint32_t codeword[2];
+      aptxhdbtenc_encodestereo(encoder, pcm_l, pcm_r, codeword);
+      ::benchmark::DoNotOptimize(codeword);
+    }
+  });
+  free(encoder);
+}
+BENCHMARK(BM_AptxHdEncode);
+
+/* AAC */
+
+// MPEG-2 AAC LC in LATM, as the A2DP encoder sets it up. range(0) is the bit
+// rate.
+void BM_AacEncode(State& state) {
+  HANDLE_AACENCODER encoder;
+  aacEncOpen(&encoder, 0, 2);
+  aacEncoder_SetParam(encoder, AACENC_AOT, AOT_AAC_LC);
+  aacEncoder_SetParam(encoder, AACENC_AUDIOMUXVER, 2);
+  aacEncoder_SetParam(encoder, AACENC_SIGNALING_MODE, 1);
+  aacEncoder_SetParam(encoder, AACENC_SAMPLERATE, 44100);
+  aacEncoder_SetParam(encoder, AACENC_BITRATE, state.range(0));
+  aacEncoder_SetParam(encoder, AACENC_CHANNELMODE, MODE_2);
+  aacEncoder_SetParam(encoder, AACENC_TRANSMUX, TT_MP4_LATM_MCP1);
+  aacEncoder_SetParam(encoder, AACENC_HEADER_PERIOD, 1);
+  aacEncoder_SetParam(encoder, AACENC_BITRATEMODE, 0);
+  if (aacEncEncode(encoder, nullptr, nullptr, nullptr, nullptr) !=
+      AACENC_OK) {
+    state.SkipWithError("Cannot configure the AAC encoder");
+    aacEncClose(&encoder);
+    return;
+  }
+  AACENC_InfoStruct info;
+  aacEncInfo(encoder, &info);
+
+  auto pcm = Pcm(info.frameLength, 2, 44100);
+  std::vector<uint8_t> output(info.maxOutBufBytes);
+  void* in_buf_vector[1] = {pcm.data()};
+  int in_buf_identifiers[1] = {IN_AUDIO_DATA};
+  int in_buf_sizes[1] = {static_cast<int>(pcm.size() * sizeof(int16_t))};
+  int in_buf_element_sizes[1] = {sizeof(int16_t)};
+  AACENC_BufDesc in_buf_desc = {1, in_buf_vector, in_buf_identifiers,
+                                in_buf_sizes, in_buf_element_sizes};
+  void* out_buf_vector[1] = {output.data()};
+  int out_buf_identifiers[1] = {OUT_BITSTREAM_DATA};
+  int out_buf_sizes[1] = {static_cast<int>(output.size())};
+  int out_buf_element_sizes[1] = {sizeof(uint8_t)};
+  AACENC_BufDesc out_buf_desc = {1, out_buf_vector, out_buf_identifiers,
+                                 out_buf_sizes, out_buf_element_sizes};
+  AACENC_InArgs in_args = {};
+  in_args.numInSamples = pcm.size();
+  AACENC_OutArgs out_args = {};
+  RunFrames(state, [&]() {
+    aacEncEncode(encoder, &in_buf_desc, &out_buf_desc, &in_args, &out_args);
+  });
+  aacEncClose(&encoder);
+}
+BENCHMARK(BM_AacEncode)->Arg(256000)->Arg(320000);
+
+/* LDAC */
+
+constexpr int kLdacMtu = 679;  // 2-DH5 packets
+
+// Each iteration encodes the LDACBT_ENC_LSU samples the A2DP encoder hands
+// over per call. range(0) is the sample rate and range(1) the quality, 0 for
+// high, 1 for standard and 2 for mobile use.
+void BM_LdacEncode(State& state) {
+  int sample_rate = state.range(0);
+  const int eqmids[] = {LDACBT_EQMID_HQ, LDACBT_EQMID_SQ, LDACBT_EQMID_MQ};
+  HANDLE_LDAC_BT encoder = ldacBT_get_handle();
+  if (ldacBT_init_handle_encode(encoder, kLdacMtu, eqmids[state.range(1)],
+                                LDACBT_CHANNEL_MODE_STEREO,
+                                LDACBT_SMPL_FMT_S16, sample_rate) != 0) {
+    state.SkipWithError("Cannot configure the LDAC encoder");
+    ldacBT_free_handle(encoder);
+    return;
+  }
+  auto pcm = Pcm(LDACBT_ENC_LSU, 2, sample_rate);
+  uint8_t output[1024];
+  RunFrames(state, [&]() {
+    int pcm_used = 0;
+    int written = 0;
+    int frames = 0;
+    ldacBT_encode(encoder, pcm.data(), &pcm_used, output, &written, &frames);
+  });
+  ldacBT_free_handle(encoder);
+}
+BENCHMARK(BM_LdacEncode)->ArgsProduct({{48000, 96000}, {0, 1, 2}});
+
+/* Opus */
+
+constexpr int kOpusSampleRate = 48000;
+constexpr int kOpusBitRate = 256000;
+constexpr int kOpusComplexity = 5;
+
+// range(0) is the frame duration in ms
+void BM_OpusEncode(State& state) {
+  int error;
+  OpusEncoder* encoder = opus_encoder_create(kOpusSampleRate, 2,
+                                             OPUS_APPLICATION_AUDIO, &error);
+  opus_encoder_ctl(encoder, OPUS_SET_COMPLEXITY(kOpusComplexity));
+  opus_encoder_ctl(encoder, OPUS_SET_BITRATE(kOpusBitRate));
+  int frame_size = kOpusSampleRate / 1000 * state.range(0);
+  auto pcm = Pcm(frame_size, 2, kOpusSampleRate);
+  uint8_t output[1500];
+  RunFrames(state, [&]() {
+    ::benchmark::DoNotOptimize(opus_encode(encoder, pcm.data(), frame_size,
+                                           output, sizeof(output)));
+  });
+  opus_encoder_destroy(encoder);
+}
+BENCHMARK(BM_OpusEncode)->Arg(10)->Arg(20);
+
+void BM_OpusDecode(State& state) {
+  int error;
+  OpusEncoder* encoder = opus_encoder_create(kOpusSampleRate, 2,
+                                             OPUS_APPLICATION_AUDIO, &error);
+  opus_encoder_ctl(encoder, OPUS_SET_COMPLEXITY(kOpusComplexity));
+  opus_encoder_ctl(encoder, OPUS_SET_BITRATE(kOpusBitRate));
+  int frame_size = kOpusSampleRate / 1000 * state.range(0);
+  auto pcm = Pcm(frame_size, 2, kOpusSampleRate);
+  std::vector<uint8_t> frame(1500);
+  frame.resize(std::max(0, opus_encode(encoder, pcm.data(), frame_size,
+                                       frame.data(), frame.size())));
+  opus_encoder_destroy(encoder);
+
+  OpusDecoder* decoder = opus_decoder_create(kOpusSampleRate, 2, &error);
+  RunFrames(state, [&]() {
+    ::benchmark::DoNotOptimize(opus_decode(decoder, frame.data(), frame.size(),
+                                           pcm.data(), frame_size, 0));
+  });
+  opus_decoder_destroy(decoder);
+}
+BENCHMARK(BM_OpusDecode)->Arg(10)->Arg(20);
+
+// Encodes and decodes each frame, as the low latency mode of the A2DP Opus
+// codec would. range(0) is the frame duration in tenths of ms, and range(1) is
+// 1 for the restricted low delay application of that mode. latency_ms adds up
+// the frame duration, the lookahead of the encoder and the slowest coding.
+void BM_OpusLatency(State& state) {
+  int error;
+  int application = state.range(1) ? OPUS_APPLICATION_RESTRICTED_LOWDELAY
+                                   : OPUS_APPLICATION_AUDIO;
+  OpusEncoder* encoder =
+      opus_encoder_create(kOpusSampleRate, 2, application, &error);
+  opus_encoder_ctl(encoder, OPUS_SET_COMPLEXITY(kOpusComplexity));
+  opus_encoder_ctl(encoder, OPUS_SET_BITRATE(kOpusBitRate));
+  OpusDecoder* decoder = opus_decoder_create(kOpusSampleRate, 2, &error);
+  int frame_size = kOpusSampleRate * state.range(0) / 10000;
+  auto pcm = Pcm(frame_size, 2, kOpusSampleRate);
+  std::vector<int16_t> decoded(pcm.size());
+  uint8_t frame[1500];
+  RunFrames(state, [&]() {
+    int len =
+        opus_encode(encoder, pcm.data(), frame_size, frame, sizeof(frame));
+    ::benchmark::DoNotOptimize(opus_decode(decoder, frame, std::max(len, 0),
+                                           decoded.data(), frame_size, 0));
+  });
+
+  opus_int32 lookahead = 0;
+  opus_encoder_ctl(encoder, OPUS_GET_LOOKAHEAD(&lookahead));
+  state.counters["latency_ms"] =
+      state.range(0) / 10.0 + lookahead * 1000.0 / kOpusSampleRate +
+      state.counters["max_frame_us"].value / 1000;
+  opus_decoder_destroy(decoder);
+  opus_encoder_destroy(encoder);
+}
+BENCHMARK(BM_OpusLatency)->ArgsProduct({{25, 50, 100, 200}, {0, 1}});
+
+/* LC3 */
+
+// One channel, as LE Audio codes each channel on its own. range(0) is the
+// frame duration in us, range(1) the sample rate and range(2) the bit rate,
+// from the 16_2 voice to the 48_6 high reliability media configurations.
+void BM_Lc3Encode(State& state) {
+  int dt_us = state.range(0);
+  int sr_hz = state.range(1);
+  int nbytes = lc3_frame_bytes(dt_us, state.range(2));
+  void* memory = malloc(lc3_encoder_size(dt_us, sr_hz));
+  lc3_encoder_t encoder = lc3_setup_encoder(dt_us, sr_hz, 0, memory);
+  auto pcm = Pcm(lc3_frame_samples(dt_us, sr_hz), 1, sr_hz);
+  std::vector<uint8_t> output(nbytes);
+  RunFrames(state, [&]() {
+    lc3_encode(encoder, LC3_PCM_FORMAT_S16, pcm.data(), 1, nbytes,
+               output.data());
+  });
+  free(memory);
+}
+
+void BM_Lc3Decode(State& state) {
+  int dt_us = state.range(0);
+  int sr_hz = state.range(1);
+  int nbytes = lc3_frame_bytes(dt_us, state.range(2));
+  void* encoder_memory = malloc(lc3_encoder_size(dt_us, sr_hz));
+  lc3_encoder_t encoder = lc3_setup_encoder(dt_us, sr_hz, 0, encoder_memory);
+  auto pcm = Pcm(lc3_frame_samples(dt_us, sr_hz), 1, sr_hz);
+  std::vector<uint8_t> frame(nbytes);
+  lc3_encode(encoder, LC3_PCM_FORMAT_S16, pcm.data(), 1, nbytes, frame.data());
+  free(encoder_memory);
+
+  void* memory = malloc(lc3_decoder_size(dt_us, sr_hz));
+  lc3_decoder_t decoder = lc3_setup_decoder(dt_us, sr_hz, 0, memory);
+  RunFrames(state, [&]() {
+    lc3_decode(decoder, frame.data(), nbytes, LC3_PCM_FORMAT_S16, pcm.data(),
+               1);
+  });
+  free(memory);
+}
+
+#define LC3_CONFIGURATIONS        \
+  Args({10000, 16000, 32000})     \
+      ->Args({7500, 16000, 32000}) \
+      ->Args({10000, 24000, 48000}) \
+      ->Args({10000, 48000, 80000}) \
+      ->Args({10000, 48000, 124000}) \
+      ->Args({7500, 48000, 96000})
+BENCHMARK(BM_Lc3Encode)->LC3_CONFIGURATIONS;
+BENCHMARK(BM_Lc3Decode)->LC3_CONFIGURATIONS;
+#undef LC3_CONFIGURATIONS
+
+/* G.722 */
+
+// 64kbit/s packed, on the 20ms frames of the hearing aid audio streaming
+constexpr int kG722SamplesPerFrame = 320;
+
+void BM_G722Encode(State& state) {
+  g722_encode_state_t* encoder = g722_encode_init(nullptr, 64000, G722_PACKED);
+  auto pcm = Pcm(kG722SamplesPerFrame, 1, 16000);
+  uint8_t output[kG722SamplesPerFrame];
+  RunFrames(state, [&]() {
+    ::benchmark::DoNotOptimize(
+        g722_encode(encoder, output, pcm.data(), pcm.size()));
+  });
+  g722_encode_release(encoder);
+}
+BENCHMARK(BM_G722Encode);
+
+void BM_G722Decode(State& state) {
+  g722_encode_state_t* encoder = g722_encode_init(nullptr, 64000, G722_PACKED);
+  auto pcm = Pcm(kG722SamplesPerFrame, 1, 16000);
+  std::vector<uint8_t> frame(kG722SamplesPerFrame);
+  frame.resize(g722_encode(encoder, frame.data(), pcm.data(), pcm.size()));
+  g722_encode_release(encoder);
+
+  g722_decode_state_t* decoder = g722_decode_init(nullptr, 64000, G722_PACKED);
+  RunFrames(state, [&]() {
+    ::benchmark::DoNotOptimize(
+        g722_decode(decoder, pcm.data(), frame.data(), frame.size(), 0xffff));
+  });
+  g722_decode_release(decoder);
+}
+BENCHMARK(BM_G722Decode);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gd/benchmark/packet_corpus.h"
+#include "stack/gatt/gatt_int.h"
+#include "stack/include/bt_hdr.h"
+#undef LOG_TAG
+#include "stack/gatt/gatt_sr.cc"
+#include "types/bluetooth/uuid.h"
+#include "types/raw_address.h"
+
+using ::benchmark::State;
+
+tGATT_CB gatt_cb;
+
+// The server runs down to the application callback, the rest of the stack is
+// stubbed as in the GATT server unit tests.
+namespace connection_manager {
+bool background_connect_remove(uint8_t app_id, const RawAddress& address) {
+  return false;
+}
+bool direct_connect_remove(uint8_t app_id, const RawAddress& address) {
+  return false;
+}
+bool is_background_connection(const RawAddress& address) { return false; }
+
+}  // namespace connection_manager
+
+BT_HDR* attp_build_sr_msg(tGATT_TCB& tcb, uint8_t op_code, tGATT_SR_MSG* p_msg,
+                          uint16_t payload_size) {
+  return nullptr;
+}
+tGATT_STATUS attp_send_cl_confirmation_msg(tGATT_TCB& tcb, uint16_t cid) {
+  return GATT_SUCCESS;
+}
+tGATT_STATUS attp_send_cl_msg(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
+                              uint8_t op_code, tGATT_CL_MSG* p_msg) {
+  return GATT_SUCCESS;
+}
+tGATT_STATUS attp_send_sr_msg(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_msg) {
+  return GATT_SUCCESS;
+}
+
+void gatt_act_discovery(tGATT_CLCB* p_clcb) {}
+bool gatt_disconnect(tGATT_TCB* p_tcb) { return false; }
+tGATT_CH_STATE gatt_get_ch_state(tGATT_TCB* p_tcb) { return GATT_CH_CLOSE; }
+tGATT_STATUS gatts_db_read_attr_value_by_type(
+    tGATT_TCB& tcb, uint16_t cid, tGATT_SVC_DB* p_db, uint8_t op_code,
+    BT_HDR* p_rsp, uint16_t s_handle, uint16_t e_handle, const Uuid& type,
+    uint16_t* p_len, tGATT_SEC_FLAG sec_flag, uint8_t key_size,
+    uint32_t trans_id, uint16_t* p_cur_handle) {
+  return GATT_SUCCESS;
+}
+void gatt_set_ch_state(tGATT_TCB* p_tcb, tGATT_CH_STATE ch_state) {}
+tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle) {
+  return nullptr;
+}
+Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db) { return nullptr; }
+tGATT_STATUS GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_handle,
+                                         uint16_t val_len, uint8_t* p_val) {
+  return GATT_SUCCESS;
+}
+tGATT_STATUS gatts_read_attr_perm_check(tGATT_SVC_DB* p_db, bool is_long,
+                                        uint16_t handle,
+                                        tGATT_SEC_FLAG sec_flag,
+                                        uint8_t key_size) {
+  return GATT_SUCCESS;
+}
+tGATT_STATUS gatts_read_attr_value_by_handle(
+    tGATT_TCB& tcb, uint16_t cid, tGATT_SVC_DB* p_db, uint8_t op_code,
+    uint16_t handle, uint16_t offset, uint8_t* p_value, uint16_t* p_len,
+    uint16_t mtu, tGATT_SEC_FLAG sec_flag, uint8_t key_size,
+    uint32_t trans_id) {
+  return GATT_SUCCESS;
+}
+tGATT_STATUS gatts_write_attr_perm_check(tGATT_SVC_DB* p_db, uint8_t op_code,
+                                         uint16_t handle, uint16_t offset,
+                                         uint8_t* p_data, uint16_t len,
+                                         tGATT_SEC_FLAG sec_flag,
+                                         uint8_t key_size) {
+  return GATT_SUCCESS;
+}
+void gatt_update_app_use_link_flag(tGATT_IF gatt_if, tGATT_TCB* p_tcb,
+                                   bool is_add, bool check_acl_link) {}
+bluetooth::common::MessageLoopThread* get_main_thread() { return nullptr; }
+void l2cble_set_fixed_channel_tx_data_length(const RawAddress& remote_bda,
+                                             uint16_t fix_cid,
+                                             uint16_t tx_mtu) {}
+void L2CA_SetLeFixedChannelTxDataLength(const RawAddress& remote_bda,
+                                        uint16_t fix_cid, uint16_t tx_mtu) {}
+
+bool gatt_sr_is_cl_change_aware(tGATT_TCB& tcb) { return false; }
+void gatt_sr_init_cl_status(tGATT_TCB& p_tcb) {}
+void gatt_sr_update_cl_status(tGATT_TCB& p_tcb, bool chg_aware) {
+  p_tcb.is_robust_cache_change_aware = chg_aware;
+}
+
+namespace {
+
+void ApplicationRequestCallback(uint16_t conn_id, uint32_t trans_id,
+                                tGATTS_REQ_TYPE type, tGATTS_DATA* p_data) {
+  ::benchmark::DoNotOptimize(p_data->write_req.value[0]);
+}
+
+// Handles the ATT write PDUs of the corpus, from their op code to the
+// application callback. The pending request is cleared after each write, as
+// the response of the application would.
+class BM_GattServerWrite : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    memset(&tcb_, 0, sizeof(tcb_));
+    memset(&el_, 0, sizeof(el_));
+    tcb_.att_lcid = L2CAP_ATT_CID;
+    el_.gatt_if = 1;
+    gatt_cb.cl_rcb[el_.gatt_if - 1].in_use = true;
+    gatt_cb.cl_rcb[el_.gatt_if - 1].app_cb.p_req_cb =
+        ApplicationRequestCallback;
+  }
+
+  void Write(State& state, const std::vector<uint8_t>& pdu) {
+    std::vector<uint8_t> bytes = pdu;
+    uint8_t op_code = bytes[0];
+    uint16_t handle = bytes[1] | (bytes[2] << 8);
+    uint16_t len = bytes.size() - 3;
+    for (auto _ : state) {
+      gatts_process_write_req(tcb_, L2CAP_ATT_CID, el_, handle, op_code, len,
+                              &bytes[3], BTGATT_DB_CHARACTERISTIC);
+      tcb_.sr_cmd.op_code = 0;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            bytes.size());
+  }
+
+  tGATT_TCB tcb_;
+  tGATT_SRV_LIST_ELEM el_;
+};
+
+BENCHMARK_F(BM_GattServerWrite, write_request)(State& state) {
+  Write(state, bluetooth::benchmark::corpus::kAttWriteRequest);
+}
+
+BENCHMARK_F(BM_GattServerWrite, write_command)(State& state) {
+  Write(state, bluetooth::benchmark::corpus::kAttWriteCommand);
+}
+
+BENCHMARK_F(BM_GattServerWrite, prepare_write_request)(State& state) {
+  Write(state, bluetooth::benchmark::corpus::kAttPrepareWriteRequest);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <math.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <random>
+#include <vector>
+
+#include "stack/btm/btm_sco_plc_dsp.h"
+
+using ::benchmark::State;
+using namespace bluetooth::audio::sco::wbs;
+
+namespace {
+
+// The pattern matching as first written, correlating in floats one lag after
+// the other.
+int reference_pattern_match(const int16_t* hist) {
+  int best = 0;
+  float max_cn = FLT_MIN;
+  const int16_t* x = &hist[BTM_PLC_HL - BTM_PLC_TL];
+  for (int i = 0; i < BTM_PLC_WL; i++) {
+    const int16_t* y = &hist[i];
+    float sum = 0, x2 = 0, y2 = 0;
+    for (int j = 0; j < BTM_PLC_TL; j++) {
+      sum += ((float)x[j]) * y[j];
+      x2 += ((float)x[j]) * x[j];
+      y2 += ((float)y[j]) * y[j];
+    }
+    float cn = sum / sqrtf(x2 * y2);
+    if (cn > max_cn) {
+      best = i;
+      max_cn = cn;
+    }
+  }
+  return best;
+}
+
+// A lossy wideband SCO trace: 16 kHz voiced speech whose pitch and loudness
+// drift, with the packets lost in bursts at a rate of range(0) percent. The
+// history of each lost frame is what the PLC searches.
+class BM_MsbcPlc : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    constexpr int kFrames = 500;
+    std::mt19937 generator(0);
+    std::normal_distribution<float> noise(0, 150);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    float phase = 0;
+    for (int i = 0; i < kFrames * BTM_MSBC_FS; i++) {
+      float t = (float)i / 16000;
+      float pitch = 140 + 40 * sinf(2 * M_PI * 0.7f * t);
+      float amplitude = 6000 + 5000 * sinf(2 * M_PI * 2.3f * t);
+      phase += 2 * M_PI * pitch / 16000;
+      float sample = amplitude * (sinf(phase) + 0.6f * sinf(2 * phase) +
+                                  0.3f * sinf(3 * phase)) +
+                     noise(generator);
+      pcm_.push_back(
+          std::min(std::max(sample, (float)INT16_MIN), (float)INT16_MAX));
+    }
+
+    for (int frame = BTM_PLC_HL / BTM_MSBC_FS + 1; frame < kFrames; frame++) {
+      if (percent(generator) >= st.range(0)) continue;
+      // A lost packet is often followed by another one
+      for (int burst = 0; burst <= percent(generator) % 3 && frame < kFrames;
+           burst++, frame++) {
+        lost_frames_.push_back(frame);
+      }
+    }
+  }
+
+  void TearDown(State& st) override {
+    pcm_.clear();
+    lost_frames_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  const int16_t* history(int frame) const {
+    return &pcm_[frame * BTM_MSBC_FS - BTM_PLC_HL];
+  }
+
+  std::vector<int16_t> pcm_;
+  std::vector<int> lost_frames_;
+};
+
+// Constructs the substitution of each lost frame
+BENCHMARK_DEFINE_F(BM_MsbcPlc, conceal)(State& state) {
+  int16_t output[BTM_MSBC_FS + BTM_PLC_OLAL];
+  for (auto _ : state) {
+    for (int frame : lost_frames_) {
+      const int16_t* hist = history(frame);
+      const int16_t* best_match =
+          &hist[plc_pattern_match(hist) + BTM_PLC_TL];
+      float scaler =
+          plc_amplitude_match(&hist[BTM_PLC_HL - BTM_MSBC_FS], best_match);
+      plc_overlap_add(output, 1.0, &hist[BTM_PLC_HL], scaler, best_match);
+      plc_scale(&output[BTM_PLC_OLAL], scaler, &best_match[BTM_PLC_OLAL],
+                BTM_MSBC_FS - BTM_PLC_OLAL);
+      plc_overlap_add(&output[BTM_MSBC_FS], scaler, &best_match[BTM_MSBC_FS],
+                      1.0, &best_match[BTM_MSBC_FS]);
+      ::benchmark::DoNotOptimize(output);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * lost_frames_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_MsbcPlc, conceal)->Arg(2)->Arg(10)->Arg(30);
+
+BENCHMARK_DEFINE_F(BM_MsbcPlc, pattern_match)(State& state) {
+  for (auto _ : state) {
+    for (int frame : lost_frames_) {
+      ::benchmark::DoNotOptimize(plc_pattern_match(history(frame)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * lost_frames_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_MsbcPlc, pattern_match)->Arg(10);
+
+BENCHMARK_DEFINE_F(BM_MsbcPlc, reference_pattern_match)(State& state) {
+  for (auto _ : state) {
+    for (int frame : lost_frames_) {
+      ::benchmark::DoNotOptimize(reference_pattern_match(history(frame)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * lost_frames_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_MsbcPlc, reference_pattern_match)->Arg(10);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
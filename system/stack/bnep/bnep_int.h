@@ -127,6 +127,17 @@ typedef struct {
   RawAddress rcvd_mcast_filter_start[BNEP_MAX_MULTI_FILTERS];
   RawAddress rcvd_mcast_filter_end[BNEP_MAX_MULTI_FILTERS];
 
+  /* The received filters compiled into sorted, disjoint ranges that the data
+   * path looks up with a binary search. Multicast addresses are compared as
+   * 48 bit big endian numbers. */
+  uint16_t num_prot_ranges;
+  uint16_t prot_range_start[BNEP_MAX_PROT_FILTERS];
+  uint16_t prot_range_end[BNEP_MAX_PROT_FILTERS];
+
+  uint16_t num_mcast_ranges;
+  uint64_t mcast_range_start[BNEP_MAX_MULTI_FILTERS];
+  uint64_t mcast_range_end[BNEP_MAX_MULTI_FILTERS];
+
   uint16_t bad_pkts_rcvd;
   uint8_t re_transmits;
   uint16_t handle;
@@ -25,6 +25,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <utility>
+
+
 #include "bnep_int.h"
 #include "device/include/controller.h"
 #include "osi/include/allocator.h"
@@ -99,6 +103,63 @@ tBNEP_CONN* bnepu_find_bcb_by_bd_addr(const RawAddress& p_bda) {
   return (NULL);
 }
 
+/*******************************************************************************
+ *
+ * Function         bnepu_compile_ranges
+ *
+ * Description      This function sorts the |num| ranges [start, end] and
+ *                  merges those that overlap or touch.
+ *
+ * Returns          Number of ranges written to |range_start| and |range_end|
+ *
+ ******************************************************************************/
+template <typename T>
+static uint16_t bnepu_compile_ranges(const T* start, const T* end,
+                                     uint16_t num, T* range_start,
+                                     T* range_end) {
+  std::pair<T, T> ranges[std::max(BNEP_MAX_PROT_FILTERS,
+                                  BNEP_MAX_MULTI_FILTERS)];
+  for (uint16_t xx = 0; xx < num; xx++) ranges[xx] = {start[xx], end[xx]};
+  std::sort(ranges, ranges + num);
+
+  uint16_t count = 0;
+  for (uint16_t xx = 0; xx < num; xx++) {
+    if (count && ranges[xx].first <= range_end[count - 1] + 1) {
+      range_end[count - 1] = std::max(range_end[count - 1], ranges[xx].second);
+    } else {
+      range_start[count] = ranges[xx].first;
+      range_end[count] = ranges[xx].second;
+      count++;
+    }
+  }
+  return count;
+}
+
+/*******************************************************************************
+ *
+ * Function         bnepu_in_ranges
+ *
+ * Description      This function looks up |value| in the |num| sorted,
+ *                  disjoint ranges compiled by bnepu_compile_ranges.
+ *
+ * Returns          true if one of the ranges holds |value|
+ *
+ ******************************************************************************/
+template <typename T>
+static bool bnepu_in_ranges(T value, const T* range_start, const T* range_end,
+                            uint16_t num) {
+  /* The last range starting at or before the value */
+  const T* p = std::upper_bound(range_start, range_start + num, value);
+  if (p == range_start) return false;
+  return value <= range_end[p - range_start - 1];
+}
+
+static uint64_t bnepu_mcast_key(const RawAddress& addr) {
+  uint64_t key = 0;
+  for (int xx = 0; xx < BD_ADDR_LEN; xx++) key = (key << 8) | addr.address[xx];
+  return key;
+}
+
 /*******************************************************************************
  *
  * Function         bnepu_allocate_bcb
@@ -931,6 +992,9 @@ void bnepu_process_peer_filter_set(tBNEP_CONN* p_bcb, uint8_t* p_filters,
     p_bcb->rcvd_prot_filter_start[xx] = start;
     p_bcb->rcvd_prot_filter_end[xx] = end;
   }
+  p_bcb->num_prot_ranges = bnepu_compile_ranges(
+      p_bcb->rcvd_prot_filter_start, p_bcb->rcvd_prot_filter_end, num_filters,
+      p_bcb->prot_range_start, p_bcb->prot_range_end);
 
   bnepu_send_peer_filter_rsp(p_bcb, resp_code);
 }
@@ -1093,6 +1157,18 @@ void bnepu_process_peer_multicast_filter_set(tBNEP_CONN* p_bcb,
     }
   }
 
+  p_bcb->num_mcast_ranges = 0;
+  if (p_bcb->rcvd_mcast_filters != 0xFFFF) {
+    uint64_t start[BNEP_MAX_MULTI_FILTERS], end[BNEP_MAX_MULTI_FILTERS];
+    for (xx = 0; xx < num_filters; xx++) {
+      start[xx] = bnepu_mcast_key(p_bcb->rcvd_mcast_filter_start[xx]);
+      end[xx] = bnepu_mcast_key(p_bcb->rcvd_mcast_filter_end[xx]);
+    }
+    p_bcb->num_mcast_ranges =
+        bnepu_compile_ranges(start, end, num_filters, p_bcb->mcast_range_start,
+                             p_bcb->mcast_range_end);
+  }
+
   BNEP_TRACE_EVENT("BNEP multicast filters %d", p_bcb->rcvd_mcast_filters);
   bnepu_send_peer_multicast_filter_rsp(p_bcb, resp_code);
 
@@ -1200,7 +1276,7 @@ tBNEP_RESULT bnep_is_packet_allowed(tBNEP_CONN* p_bcb,
                                     uint16_t protocol, bool fw_ext_present,
                                     uint8_t* p_data, uint16_t org_len) {
   if (p_bcb->rcvd_num_filters) {
-    uint16_t i, proto;
+    uint16_t proto;
 
     /* Findout the actual protocol to check for the filtering */
     proto = protocol;
@@ -1229,13 +1305,8 @@ tBNEP_RESULT bnep_is_packet_allowed(tBNEP_CONN* p_bcb,
       BE_STREAM_TO_UINT16(proto, p_data);
     }
 
-    for (i = 0; i < p_bcb->rcvd_num_filters; i++) {
-      if ((p_bcb->rcvd_prot_filter_start[i] <= proto) &&
-          (proto <= p_bcb->rcvd_prot_filter_end[i]))
-        break;
-    }
-
-    if (i == p_bcb->rcvd_num_filters) {
+    if (!bnepu_in_ranges(proto, p_bcb->prot_range_start,
+                         p_bcb->prot_range_end, p_bcb->num_prot_ranges)) {
       BNEP_TRACE_DEBUG("Ignoring protocol 0x%x in BNEP data write", proto);
       return BNEP_IGNORE_CMD;
     }
@@ -1243,27 +1314,15 @@ tBNEP_RESULT bnep_is_packet_allowed(tBNEP_CONN* p_bcb,
 
   /* Ckeck for multicast address filtering */
   if ((p_dest_addr.address[0] & 0x01) && p_bcb->rcvd_mcast_filters) {
-    uint16_t i;
-
-    /* Check if every multicast should be filtered */
-    if (p_bcb->rcvd_mcast_filters != 0xFFFF) {
-      /* Check if the address is mentioned in the filter range */
-      for (i = 0; i < p_bcb->rcvd_mcast_filters; i++) {
-        if ((memcmp(p_bcb->rcvd_mcast_filter_start[i].address,
-                    p_dest_addr.address, BD_ADDR_LEN) <= 0) &&
-            (memcmp(p_bcb->rcvd_mcast_filter_end[i].address,
-                    p_dest_addr.address, BD_ADDR_LEN) >= 0))
-          break;
-      }
-    }
-
     /*
     ** If every multicast should be filtered or the address is not in the filter
     *range
     ** drop the packet
     */
     if ((p_bcb->rcvd_mcast_filters == 0xFFFF) ||
-        (i == p_bcb->rcvd_mcast_filters)) {
+        !bnepu_in_ranges(bnepu_mcast_key(p_dest_addr),
+                         p_bcb->mcast_range_start, p_bcb->mcast_range_end,
+                         p_bcb->num_mcast_ranges)) {
       VLOG(1) << "Ignoring multicast address " << p_dest_addr
               << " in BNEP data write";
       return BNEP_IGNORE_CMD;
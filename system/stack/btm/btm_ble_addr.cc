@@ -25,7 +25,11 @@
 #include <base/functional/bind.h>
 #include <string.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "btm_ble_int.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "gap_api.h"
 #include "main/shim/shim.h"
@@ -154,37 +158,130 @@ bool btm_ble_addr_resolvable(const RawAddress& rpa,
   return false;
 }
 
-/** This function match the random address to the appointed device record,
- * starting from calculating IRK. If the record index exceeds the maximum record
- * number, matching failed and send a callback. */
-static bool btm_ble_match_random_bda(void* data, void* context) {
-  tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
-  RawAddress* random_bda = static_cast<RawAddress*>(context);
-
-  if (!(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
-      !(p_dev_rec->ble.key_type & BTM_LE_KEY_PID))
-    // Match fails preconditions
-    return true;
-
-  if (rpa_matches_irk(*random_bda, p_dev_rec->ble.keys.irk)) {
-    // Matched
-    return false;
+namespace {
+
+/* The IRK of a bonded device, with its AES key schedule expanded once */
+struct IrkEntry {
+  tBTM_SEC_DEV_REC* p_dev_rec;
+  Octet16 irk;
+  crypto_toolbox::Aes128 cipher;
+};
+
+/* Result of the resolution of a random address, |irk_index| is
+ * kRpaNotResolved if no bonded device matched */
+struct RpaResolution {
+  size_t irk_index;
+  uint64_t expiry_ms;
+};
+
+constexpr size_t kRpaNotResolved = SIZE_MAX;
+/* Peers change their RPA every 15 minutes at most */
+constexpr uint64_t kRpaResolutionLifetimeMs = 15 * 60 * 1000;
+/* More than the random addresses seen in a busy scan */
+constexpr size_t kMaxRpaResolutions = 256;
+
+/* The IRKs of the security records, in security record list order */
+std::vector<IrkEntry> irk_index;
+/* Cleared every time an IRK is added, changed or removed from |irk_index| */
+std::unordered_map<RawAddress, RpaResolution> rpa_resolutions;
+
+/* Update |irk_index| from the security records. This only compares the IRKs,
+ * the key schedules are expanded for the new or changed IRKs only. */
+void update_irk_index() {
+  size_t index = 0;
+  bool changed = false;
+  list_node_t* end = list_end(btm_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+    if (!(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
+        !(p_dev_rec->ble.key_type & BTM_LE_KEY_PID)) {
+      continue;
+    }
+    const Octet16& irk = p_dev_rec->ble.keys.irk;
+    if (index < irk_index.size() && irk_index[index].p_dev_rec == p_dev_rec &&
+        irk_index[index].irk == irk) {
+      index++;
+      continue;
+    }
+    IrkEntry entry{p_dev_rec, irk, crypto_toolbox::Aes128(irk)};
+    if (index < irk_index.size()) {
+      irk_index[index] = std::move(entry);
+    } else {
+      irk_index.push_back(std::move(entry));
+    }
+    index++;
+    changed = true;
+  }
+  if (index < irk_index.size()) {
+    irk_index.resize(index);
+    changed = true;
+  }
+  if (changed) {
+    rpa_resolutions.clear();
   }
+}
 
-  // This item not a match, continue iteration
-  return true;
+/* Return the index in |irk_index| of the IRK that |rpa| was generated with,
+ * or kRpaNotResolved */
+size_t match_irk_index(const RawAddress& rpa) {
+  /* use the 3 MSB of bd address as prand */
+  uint8_t rand[3];
+  rand[0] = rpa.address[2];
+  rand[1] = rpa.address[1];
+  rand[2] = rpa.address[0];
+  /* and the 3 LSB as the hash to match */
+  uint8_t hash[3];
+  hash[0] = rpa.address[5];
+  hash[1] = rpa.address[4];
+  hash[2] = rpa.address[3];
+
+  for (size_t i = 0; i < irk_index.size(); i++) {
+    Octet16 x = irk_index[i].cipher.Encrypt(&rand[0], 3);
+    if (memcmp(x.data(), &hash[0], 3) == 0) {
+      return i;
+    }
+  }
+  return kRpaNotResolved;
 }
 
+}  // namespace
+
 /** This function is called to resolve a random address.
  * Returns pointer to the security record of the device whom a random address is
  * matched to.
+ *
+ * Scans and connections report the same random addresses many times, so the
+ * result is cached until the peer rotates its address, or the bonded IRKs
+ * change. Only a cache miss costs one AES per bonded IRK.
  */
 tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
-  list_node_t* n = list_foreach(btm_cb.sec_dev_rec, btm_ble_match_random_bda,
-                                (void*)&random_bda);
-  return (n == nullptr) ? (nullptr)
-                        : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+  update_irk_index();
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  auto resolution = rpa_resolutions.find(random_bda);
+  if (resolution != rpa_resolutions.end()) {
+    if (resolution->second.expiry_ms > now_ms) {
+      size_t index = resolution->second.irk_index;
+      return index == kRpaNotResolved ? nullptr : irk_index[index].p_dev_rec;
+    }
+    rpa_resolutions.erase(resolution);
+  }
+
+  size_t index = match_irk_index(random_bda);
+  if (rpa_resolutions.size() >= kMaxRpaResolutions) {
+    for (auto it = rpa_resolutions.begin(); it != rpa_resolutions.end();) {
+      it = it->second.expiry_ms <= now_ms ? rpa_resolutions.erase(it)
+                                          : std::next(it);
+    }
+    if (rpa_resolutions.size() >= kMaxRpaResolutions) {
+      rpa_resolutions.clear();
+    }
+  }
+  rpa_resolutions[random_bda] = {index, now_ms + kRpaResolutionLifetimeMs};
+  return index == kRpaNotResolved ? nullptr : irk_index[index].p_dev_rec;
 }
 
 /*******************************************************************************
@@ -195,25 +292,37 @@ static tBTM_SEC_DEV_REC* btm_find_dev_by_identity_addr(
     const RawAddress& bd_addr, uint8_t addr_type) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
 
+  tBTM_SEC_DEV_REC* p_match = nullptr;
+  auto& hints = btm_cb.sec_dev_rec_by_identity;
+  auto hint = hints.find(bd_addr);
+  if (hint != hints.end()) {
+    if (hint->second->ble.identity_address_with_type.bda == bd_addr) {
+      p_match = hint->second;
+    } else {
+      hints.erase(hint);
+    }
+  }
+
   list_node_t* end = list_end(btm_cb.sec_dev_rec);
-  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
-       node = list_next(node)) {
+  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec);
+       p_match == nullptr && node != end; node = list_next(node)) {
     tBTM_SEC_DEV_REC* p_dev_rec =
         static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
     if (p_dev_rec->ble.identity_address_with_type.bda == bd_addr) {
-      if ((p_dev_rec->ble.identity_address_with_type.type &
-           (~BLE_ADDR_TYPE_ID_BIT)) != (addr_type & (~BLE_ADDR_TYPE_ID_BIT)))
-        BTM_TRACE_WARNING(
-            "%s find pseudo->random match with diff addr type: %d vs %d",
-            __func__, p_dev_rec->ble.identity_address_with_type.type,
-            addr_type);
-
-      /* found the match */
-      return p_dev_rec;
+      p_match = p_dev_rec;
+      hints[bd_addr] = p_dev_rec;
     }
   }
+  if (p_match == nullptr) return NULL;
+
+  if ((p_match->ble.identity_address_with_type.type &
+       (~BLE_ADDR_TYPE_ID_BIT)) != (addr_type & (~BLE_ADDR_TYPE_ID_BIT)))
+    BTM_TRACE_WARNING(
+        "%s find pseudo->random match with diff addr type: %d vs %d", __func__,
+        p_match->ble.identity_address_with_type.type, addr_type);
 
-  return NULL;
+  /* found the match */
+  return p_match;
 }
 
 /*******************************************************************************
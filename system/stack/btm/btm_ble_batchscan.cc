@@ -327,6 +327,52 @@ void read_reports_cb(std::vector<uint8_t> data_all, uint8_t num_records_all,
   }
 }
 
+/* Stream the reports: |cb| is run with each page of records as it is read
+ * from the controller, then once with no record when all were read */
+void stream_reports_cb(tBTM_BLE_SCAN_REP_CBACK cb, uint8_t* p, uint16_t len) {
+  if (len < 4) {
+    BTM_TRACE_ERROR("%s: wrong length", __func__);
+    cb.Run(BTM_ERR_PROCESSING, 0, 0, {});
+    return;
+  }
+
+  uint8_t status, subcode;
+  STREAM_TO_UINT8(status, p);
+  STREAM_TO_UINT8(subcode, p);
+
+  uint8_t expected_opcode = BTM_BLE_BATCH_SCAN_READ_RESULTS;
+  if (subcode != expected_opcode) {
+    BTM_TRACE_ERROR("%s: bad subcode, expected: %d got: %d", __func__,
+                    expected_opcode, subcode);
+    cb.Run(BTM_ERR_PROCESSING, 0, 0, {});
+    return;
+  }
+
+  uint8_t report_format, num_records;
+  STREAM_TO_UINT8(report_format, p);
+  STREAM_TO_UINT8(num_records, p);
+
+  BTM_TRACE_DEBUG("%s: status=%d,len=%d,rec=%d", __func__, status, len - 4,
+                  num_records);
+
+  if (status != BTM_SUCCESS) {
+    cb.Run(BTM_ERR_PROCESSING, report_format, 0, {});
+    return;
+  }
+
+  if (num_records == 0 || len == 4) {
+    cb.Run(BTM_SUCCESS, report_format, 0, {});
+    return;
+  }
+
+  cb.Run(BTM_SUCCESS, report_format, num_records,
+         std::vector<uint8_t>(p, p + len - 4));
+
+  /* More records could be in the buffer and needs to be pulled out */
+  btm_ble_read_batchscan_reports(report_format,
+                                 base::Bind(&stream_reports_cb, std::move(cb)));
+}
+
 /**
  * This function writes the storage configuration in controller
  *
@@ -550,6 +596,29 @@ void BTM_BleReadScanReports(tBTM_BLE_BATCH_SCAN_MODE scan_mode,
   return;
 }
 
+/* This function is called to start streaming batch scan reports */
+void BTM_BleStreamScanReports(tBTM_BLE_BATCH_SCAN_MODE scan_mode,
+                              tBTM_BLE_SCAN_REP_CBACK cb) {
+  BTM_TRACE_EVENT("%s; %d", __func__, scan_mode);
+
+  if (!can_do_batch_scan()) {
+    BTM_TRACE_ERROR("Controller does not support batch scan");
+    cb.Run(BTM_ERR_PROCESSING, 0, 0, {});
+    return;
+  }
+
+  if (scan_mode != BTM_BLE_BATCH_SCAN_MODE_PASS &&
+      scan_mode != BTM_BLE_BATCH_SCAN_MODE_ACTI) {
+    BTM_TRACE_ERROR("Illegal stream scan params: %d, %d", scan_mode,
+                    ble_batchscan_cb.cur_state);
+    cb.Run(BTM_ILLEGAL_VALUE, 0, 0, {});
+    return;
+  }
+
+  btm_ble_read_batchscan_reports(scan_mode,
+                                 base::Bind(&stream_reports_cb, cb));
+}
+
 /* This function is called to setup the callback for tracking */
 void BTM_BleTrackAdvertiser(tBTM_BLE_TRACK_ADV_CBACK* p_track_cback,
                             tBTM_BLE_REF_VALUE ref_value) {
@@ -28,6 +28,7 @@
 #include <base/logging.h>
 #include <base/strings/string_number_conversions.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -89,6 +90,10 @@ static const char kPropertyInquiryScanInterval[] =
     "bluetooth.core.le.inquiry_scan_interval";
 static const char kPropertyInquiryScanWindow[] =
     "bluetooth.core.le.inquiry_scan_window";
+/* Sysprop path for the filter indexes emulated on the host past the
+ * controller filter table, see gd/hci/le_scanning_filter_engine.h */
+static const char kPropertySoftwareScanFilters[] =
+    "bluetooth.core.le.software_scan_filters";
 
 static void btm_ble_start_scan();
 static void btm_ble_stop_scan();
@@ -701,6 +706,14 @@ static void btm_ble_vendor_capability_vsc_cmpl_cback(
   STREAM_TO_UINT8(btm_cb.cmn_ble_vsc_cb.max_filter, p);
   STREAM_TO_UINT8(btm_cb.cmn_ble_vsc_cb.energy_support, p);
 
+  int software_scan_filters =
+      osi_property_get_int32(kPropertySoftwareScanFilters, 0);
+  if (software_scan_filters > 0) {
+    btm_cb.cmn_ble_vsc_cb.max_filter = std::min<int>(
+        UINT8_MAX, btm_cb.cmn_ble_vsc_cb.max_filter + software_scan_filters);
+    btm_cb.cmn_ble_vsc_cb.filter_support = 1;
+  }
+
   if (p_vcs_cplt_params->param_len >
       BTM_VSC_CHIP_CAPABILITY_RSP_LEN_L_RELEASE) {
     STREAM_TO_UINT16(btm_cb.cmn_ble_vsc_cb.version_supported, p);
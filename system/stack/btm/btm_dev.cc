@@ -139,9 +139,22 @@ bool BTM_SecAddDevice(const RawAddress& bd_addr, DEV_CLASS dev_class,
   return true;
 }
 
+/* Remove the lookup hints to |p_dev_rec| before the record is freed */
+static void remove_dev_rec_hints(tBTM_SEC_DEV_REC* p_dev_rec) {
+  auto remove_from = [p_dev_rec](auto& hints) {
+    for (auto it = hints.begin(); it != hints.end();) {
+      it = (it->second == p_dev_rec) ? hints.erase(it) : std::next(it);
+    }
+  };
+  remove_from(btm_cb.sec_dev_rec_by_address);
+  remove_from(btm_cb.sec_dev_rec_by_handle);
+  remove_from(btm_cb.sec_dev_rec_by_identity);
+}
+
 void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
   p_dev_rec->link_key.fill(0);
   memset(&p_dev_rec->ble.keys, 0, sizeof(tBTM_SEC_BLE_KEYS));
+  remove_dev_rec_hints(p_dev_rec);
   list_remove(btm_cb.sec_dev_rec, p_dev_rec);
 }
 
@@ -330,6 +343,9 @@ bool btm_dev_support_role_switch(const RawAddress& bd_addr) {
   return false;
 }
 
+/* Enough for the public and current resolvable addresses of all the records */
+constexpr size_t kMaxSecDevRecAddressHints = 2 * BTM_SEC_MAX_DEVICE_RECORDS;
+
 bool is_handle_equal(void* data, void* context) {
   tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
   uint16_t* handle = static_cast<uint16_t*>(context);
@@ -351,8 +367,23 @@ bool is_handle_equal(void* data, void* context) {
  *
  ******************************************************************************/
 tBTM_SEC_DEV_REC* btm_find_dev_by_handle(uint16_t handle) {
+  /* Many records have no handle, only the first one of the list is right */
+  bool use_hints = (handle != HCI_INVALID_HANDLE);
+  auto& hints = btm_cb.sec_dev_rec_by_handle;
+  if (use_hints) {
+    auto hint = hints.find(handle);
+    if (hint != hints.end()) {
+      if (!is_handle_equal(hint->second, &handle)) return hint->second;
+      hints.erase(hint);
+    }
+  }
+
   list_node_t* n = list_foreach(btm_cb.sec_dev_rec, is_handle_equal, &handle);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    if (use_hints) hints[handle] = p_dev_rec;
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -382,9 +413,24 @@ bool is_address_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev(const RawAddress& bd_addr) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
 
+  /* The hint is checked the way the list is, so a resolvable address of the
+   * hinted record costs one resolution instead of one per record */
+  auto& hints = btm_cb.sec_dev_rec_by_address;
+  auto hint = hints.find(bd_addr);
+  if (hint != hints.end()) {
+    if (!is_address_equal(hint->second, (void*)&bd_addr)) return hint->second;
+    hints.erase(hint);
+  }
+
   list_node_t* n =
       list_foreach(btm_cb.sec_dev_rec, is_address_equal, (void*)&bd_addr);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    /* Peers change their resolvable addresses, forget the old ones */
+    if (hints.size() >= kMaxSecDevRecAddressHints) hints.clear();
+    hints[bd_addr] = p_dev_rec;
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -46,6 +46,7 @@
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/l2cap_controller_interface.h"
+#include "stack/include/smp_api.h"
 #include "types/raw_address.h"
 
 extern tBTM_CB btm_cb;
@@ -216,6 +217,9 @@ void BTM_reset_complete() {
                  btm_cb.cfg.pin_code_len);
 
   decode_controller_support();
+
+  /* Have a key pair ready for the first LE Secure Connections pairing */
+  SMP_FillKeyPool();
 }
 
 /*******************************************************************************
@@ -570,8 +574,11 @@ void btm_vendor_specific_evt(const uint8_t* p, uint8_t evt_len) {
         // Excluding the HCI Event packet header and 1 octet sub-event code
         int16_t bqr_parameter_length = evt_len - HCIE_PREAMBLE_SIZE - 1;
         const uint8_t* p_bqr_event = bqr_ptr;
-        // The stream currently points to the BQR sub-event parameters
-        switch (sub_event_code) {
+        // The stream currently points to the BQR sub-event parameters, which
+        // start with the quality report id
+        uint8_t quality_report_id =
+            bqr_parameter_length > 0 ? p_bqr_event[0] : 0;
+        switch (quality_report_id) {
         case bluetooth::bqr::QUALITY_REPORT_ID_LMP_LL_MESSAGE_TRACE:
           if (bqr_parameter_length >= bluetooth::bqr::kLogDumpParamTotalLen) {
             bluetooth::bqr::DumpLmpLlMessage(bqr_parameter_length, p_bqr_event);
@@ -591,7 +598,7 @@ void btm_vendor_specific_evt(const uint8_t* p, uint8_t evt_len) {
           break;
 
         default:
-          LOG_INFO("Unhandled BQR subevent 0x%02hxx", sub_event_code);
+          LOG_INFO("Unhandled BQR report id 0x%02hhx", quality_report_id);
         }
       }
     }
@@ -33,7 +33,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <cstdlib>
+#include <functional>
 #include <mutex>
+#include <string_view>
 
 #include "advertise_data_parser.h"
 #include "common/time_util.h"
@@ -100,6 +103,12 @@ using bluetooth::Uuid;
 /* 3 second timeout waiting for responses */
 #define BTM_INQ_REPLY_TIMEOUT_MS (3 * 1000)
 
+/* Change of RSSI in dB for a device already found by the inquiry to be
+ * reported again */
+#ifndef BTM_INQ_RSSI_UPDATE_DELTA
+#define BTM_INQ_RSSI_UPDATE_DELTA 5
+#endif
+
 /* TRUE to enable DEBUG traces for btm_inq */
 #ifndef BTM_INQ_DEBUG
 #define BTM_INQ_DEBUG FALSE
@@ -624,6 +633,7 @@ tBTM_STATUS BTM_StartInquiry(tBTM_INQ_RESULTS_CB* p_results_cb,
   btm_cb.neighbor.classic_inquiry = {
       .start_time_ms = timestamper_in_milliseconds.GetTimestamp(),
       .results = 0,
+      .duplicates = 0,
   };
 
   LOG_DEBUG("Starting device discovery inq_active:0x%02x",
@@ -1179,6 +1189,21 @@ tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
   return (p_old);
 }
 
+/*******************************************************************************
+ *
+ * Function         btm_inq_eir_hash
+ *
+ * Description      This function hashes the EIR of an extended inquiry result,
+ *                  to find out whether a repeated result carries new data.
+ *
+ * Returns          the hash of the EIR
+ *
+ ******************************************************************************/
+static size_t btm_inq_eir_hash(const uint8_t* p_eir) {
+  return std::hash<std::string_view>{}(std::string_view(
+      reinterpret_cast<const char*>(p_eir), HCI_EXT_INQ_RESPONSE_LEN));
+}
+
 /*******************************************************************************
  *
  * Function         btm_process_inq_results
@@ -1249,6 +1274,7 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
 
   btm_cb.neighbor.classic_inquiry.results += num_resp;
   for (xx = 0; xx < num_resp; xx++) {
+    is_new = true;
     update = false;
     /* Extract inquiry results */
     STREAM_TO_BDADDR(bda, p);
@@ -1275,28 +1301,32 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
       /* By default suppose no update needed */
       i_rssi = (int8_t)rssi;
 
-      /* If this new RSSI is higher than the last one */
+      /* If the RSSI moved noticeably since the last report */
       if ((rssi != 0) && p_i &&
-          (i_rssi > p_i->inq_info.results.rssi ||
-           p_i->inq_info.results.rssi == 0
+          (p_i->reported_rssi == 0 ||
+           abs(i_rssi - p_i->reported_rssi) >= BTM_INQ_RSSI_UPDATE_DELTA
            /* BR/EDR inquiry information update */
            ||
-           (p_i->inq_info.results.device_type & BT_DEVICE_TYPE_BREDR) != 0)) {
+           (p_i->inq_info.results.device_type & BT_DEVICE_TYPE_BREDR) == 0)) {
         p_cur = &p_i->inq_info.results;
-        BTM_TRACE_DEBUG("update RSSI new:%d, old:%d", i_rssi, p_cur->rssi);
+        BTM_TRACE_DEBUG("update RSSI new:%d, old:%d", i_rssi,
+                        p_i->reported_rssi);
         p_cur->rssi = i_rssi;
         update = true;
       }
       /* If we received a second Extended Inq Event for an already */
       /* discovered device, this is because for the first one EIR was not
-         received */
-      else if ((inq_res_mode == BTM_INQ_RESULT_EXTENDED) && (p_i)) {
+         received, or because it changed */
+      else if ((inq_res_mode == BTM_INQ_RESULT_EXTENDED) && (p_i) &&
+               p_i->reported_eir_hash != btm_inq_eir_hash(p)) {
         p_cur = &p_i->inq_info.results;
         update = true;
       }
       /* If no update needed continue with next response (if any) */
-      else
+      else {
+        btm_cb.neighbor.classic_inquiry.duplicates++;
         continue;
+      }
     }
 
     /* If existing entry, use that, else get a new one (possibly reusing the
@@ -1370,8 +1400,10 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
         /* set bit map of UUID list from received EIR */
         btm_set_eir_uuid(p, p_cur);
         p_eir_data = p;
+        p_i->reported_eir_hash = btm_inq_eir_hash(p);
       } else
         p_eir_data = NULL;
+      p_i->reported_rssi = p_cur->rssi;
 
       /* If a callback is registered, call it with the results */
       if (p_inq_results_cb) {
@@ -1493,11 +1525,12 @@ void btm_process_inq_complete(tHCI_STATUS status, uint8_t mode) {
       BTM_LogHistory(
           kBtmLogTag, RawAddress::kEmpty, "Classic inquiry complete",
           base::StringPrintf(
-              "duration_s:%6.3f results:%lu inq_active:0x%02x std:%u rssi:%u "
-              "ext:%u status:%s",
+              "duration_s:%6.3f results:%lu duplicates:%lu inq_active:0x%02x "
+              "std:%u rssi:%u ext:%u status:%s",
               (end_time_ms - btm_cb.neighbor.classic_inquiry.start_time_ms) /
                   1000.0,
-              btm_cb.neighbor.classic_inquiry.results, inq_active,
+              btm_cb.neighbor.classic_inquiry.results,
+              btm_cb.neighbor.classic_inquiry.duplicates, inq_active,
               p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_STANDARD],
               p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_WITH_RSSI],
               p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_EXTENDED],
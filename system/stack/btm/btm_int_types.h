@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "gd/common/circular_buffer.h"
 #include "osi/include/allocator.h"
@@ -278,6 +279,12 @@ typedef struct tBTM_CB {
   uint8_t disc_reason{0};           /* for legacy devices */
   tBTM_SEC_SERV_REC sec_serv_rec[BTM_SEC_MAX_SERVICE_RECORDS];
   list_t* sec_dev_rec{nullptr}; /* list of tBTM_SEC_DEV_REC */
+  /* Lookup hints into |sec_dev_rec|, by any address that matched a record, by
+   * ACL handle and by LE identity address. The record fields are written all
+   * over the stack, so a hint is checked against its record before use. */
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> sec_dev_rec_by_address;
+  std::unordered_map<uint16_t, tBTM_SEC_DEV_REC*> sec_dev_rec_by_handle;
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> sec_dev_rec_by_identity;
   tBTM_SEC_SERV_REC* p_out_serv{nullptr};
   tBTM_MKEY_CALLBACK* mkey_cback{nullptr};
 
@@ -313,6 +320,7 @@ typedef struct tBTM_CB {
     struct {
       long long start_time_ms;
       unsigned long results;
+      unsigned long duplicates;
     } classic_inquiry, le_scan, le_inquiry, le_observe, le_legacy_scan;
     std::unique_ptr<
         bluetooth::common::TimestampedCircularBuffer<tBTM_INQUIRY_CMPL>>
@@ -359,6 +367,9 @@ typedef struct tBTM_CB {
       *((tBTM_SEC_DEV_REC*)ptr) = {};
       osi_free(ptr);
     });
+    sec_dev_rec_by_address.clear();
+    sec_dev_rec_by_handle.clear();
+    sec_dev_rec_by_identity.clear();
 
     /* Initialize BTM component structures */
     btm_inq_vars.Init(); /* Inquiry Database and Structures */
@@ -387,6 +398,9 @@ typedef struct tBTM_CB {
 
     list_free(sec_dev_rec);
     sec_dev_rec = nullptr;
+    sec_dev_rec_by_address.clear();
+    sec_dev_rec_by_handle.clear();
+    sec_dev_rec_by_identity.clear();
 
     alarm_free(sec_collision_timer);
     sec_collision_timer = nullptr;
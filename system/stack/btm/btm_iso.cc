@@ -24,6 +24,7 @@
 using bluetooth::hci::iso_manager::BigCallbacks;
 using bluetooth::hci::iso_manager::CigCallbacks;
 using bluetooth::hci::iso_manager::iso_impl;
+using bluetooth::hci::iso_manager::iso_sdu_pool;
 
 namespace bluetooth {
 namespace hci {
@@ -33,7 +34,7 @@ struct IsoManager::impl {
 
   void Start() {
     LOG_ASSERT(!iso_impl_);
-    iso_impl_ = std::make_unique<iso_impl>();
+    iso_impl_ = std::make_unique<iso_impl>(sdu_pool_);
   }
 
   void Stop() {
@@ -48,6 +49,7 @@ struct IsoManager::impl {
   bool IsRunning() { return iso_impl_ ? true : false; }
 
   const IsoManager& iso_manager_;
+  iso_sdu_pool sdu_pool_;
   std::unique_ptr<iso_impl> iso_impl_;
 };
 
@@ -120,6 +122,10 @@ void IsoManager::HandleIsoData(void* p_msg) {
     pimpl_->iso_impl_->handle_iso_data(static_cast<BT_HDR*>(p_msg));
 }
 
+void IsoManager::ReleaseIsoSdu(void* p_msg) {
+  pimpl_->sdu_pool_.release(static_cast<BT_HDR*>(p_msg));
+}
+
 void IsoManager::HandleDisconnect(uint16_t handle, uint8_t reason) {
   if (pimpl_->IsRunning())
     pimpl_->iso_impl_->disconnection_complete(handle, reason);
@@ -17,11 +17,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
@@ -33,8 +37,10 @@
 #include "device/include/controller.h"
 #include "hci/include/hci_layer.h"
 #include "internal_include/stack_config.h"
+#include "main/shim/acl_api.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btm_log_history.h"
 #include "stack/include/hci_error_code.h"
@@ -55,6 +61,18 @@ static constexpr uint8_t kStateFlagIsBroadcast = 0x10;
 
 constexpr char kBtmLogTag[] = "ISO";
 
+/* LE ACL buffers kept for an ACL link while it has established CISes */
+static constexpr char kPropertyIsoAclCreditReservation[] =
+    "bluetooth.core.le.iso_acl_credit_reservation";
+static constexpr int32_t kDefaultIsoAclCreditReservation = 2;
+
+/* Every that many SDUs sent on a CIS or BIS, HCI_LE_Read_ISO_TX_Sync is used
+ * to compare the progress of the controller ISO clock with the host clock
+ * the SDUs are sent with.
+ */
+static constexpr size_t kIsoTxSyncReadPeriodSdus = 500;
+static constexpr int32_t kIsoClockDriftLogThresholdPpm = 50;
+
 struct iso_sync_info {
   uint32_t first_sync_ts;
   uint16_t seq_nb;
@@ -83,17 +101,110 @@ struct iso_base {
     uint64_t evt_last_lost_us = 0;
   };
 
+  struct tx_timing_stats {
+    size_t sdu_count = 0;
+    /* When the SDUs are submitted within their SDU interval */
+    uint32_t submit_offset_min_us = UINT32_MAX;
+    uint32_t submit_offset_max_us = 0;
+    uint64_t submit_offset_sum_us = 0;
+    /* SDUs sent after one or more intervals without any SDU, and SDUs sent
+     * in the same interval as the previous one
+     */
+    size_t late_sdu_count = 0;
+    size_t missed_interval_count = 0;
+    size_t same_interval_count = 0;
+    uint64_t last_late_sdu_us = 0;
+    uint32_t last_seq_nb = 0;
+    /* Last late SDU count put in the BTM log history */
+    size_t logged_late_sdu_count = 0;
+
+    /* Controller against host clock, from HCI_LE_Read_ISO_TX_Sync */
+    bool tx_sync_supported = true;
+    bool tx_sync_has_ref = false;
+    uint16_t tx_sync_seq_nb = 0;
+    uint32_t tx_sync_ts = 0;
+    int64_t tx_sync_host_elapsed_us = 0;
+    int64_t tx_sync_controller_elapsed_us = 0;
+    int32_t clock_drift_ppm = 0;
+    bool clock_drift_logged = false;
+  };
+
   credits_stats cr_stats;
   event_stats evt_stats;
+  tx_timing_stats tx_stats;
 };
 
 typedef iso_base iso_cis;
 typedef iso_base iso_bis;
 
+/* Buffers for the outgoing ISO SDUs. A new SDU is sent on each CIS and BIS
+ * every SDU interval, so rather than going through the allocator each time,
+ * the buffers given back by the HCI layer once transmitted are kept here and
+ * reused. It outlives iso_impl since buffers may still be in flight when the
+ * module stops.
+ */
+struct iso_sdu_pool {
+  /* Largest SDU a pooled buffer can carry, LC3 frames are much smaller */
+  static constexpr uint16_t kMaxSduLen = 512;
+  static constexpr size_t kMaxCachedBuffers = 32;
+  static constexpr size_t kBufferSize =
+      sizeof(BT_HDR) + kIsoHeaderWithTsLen + kMaxSduLen;
+
+  ~iso_sdu_pool() {
+    for (auto buffer : buffers_) osi_free(buffer);
+  }
+
+  /* Returns a buffer for an SDU of |sdu_len| bytes, nullptr if too long */
+  BT_HDR* acquire(uint16_t sdu_len) {
+    if (sdu_len > kMaxSduLen) return nullptr;
+
+    BT_HDR* packet = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!buffers_.empty()) {
+        packet = buffers_.back();
+        buffers_.pop_back();
+      } else {
+        allocated_count_++;
+      }
+    }
+
+    if (packet == nullptr) packet = (BT_HDR*)osi_malloc(kBufferSize);
+    return packet;
+  }
+
+  /* May be called from any thread */
+  void release(BT_HDR* packet) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (buffers_.size() < kMaxCachedBuffers) {
+        buffers_.push_back(packet);
+        return;
+      }
+    }
+    osi_free(packet);
+  }
+
+  void dump(int fd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dprintf(fd, "    SDU pool: %zu cached buffers, %zu allocated\n",
+            buffers_.size(), allocated_count_);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<BT_HDR*> buffers_;
+  size_t allocated_count_ = 0;
+};
+
 struct iso_impl {
-  iso_impl() {
-    iso_credits_ = controller_get_interface()->get_iso_buffer_count();
+  iso_impl(iso_sdu_pool& sdu_pool) : sdu_pool_(sdu_pool) {
+    iso_buffer_count_ = controller_get_interface()->get_iso_buffer_count();
+    iso_credits_ = iso_buffer_count_;
     iso_buffer_size_ = controller_get_interface()->get_iso_data_size();
+    acl_credit_reservation_ = std::max(
+        0, osi_property_get_int32(kPropertyIsoAclCreditReservation,
+                                  kDefaultIsoAclCreditReservation));
   }
 
   ~iso_impl() {}
@@ -281,6 +392,7 @@ struct iso_impl {
         evt.cis_conn_hdl = cis_param.cis_conn_handle;
         evt.cig_id = 0xFF;
         cis->state_flags &= ~kStateFlagIsConnecting;
+        cis_hdl_to_acl_hdl_.erase(evt.cis_conn_hdl);
         cig_callbacks_->OnCisEvent(kIsoEventCisEstablishCmpl, &evt);
 
         BTM_LogHistory(
@@ -302,6 +414,7 @@ struct iso_impl {
                    (kStateFlagIsConnected | kStateFlagIsConnecting)))
           << "Already connected or connecting";
       cis->state_flags |= kStateFlagIsConnecting;
+      cis_hdl_to_acl_hdl_[el.cis_conn_handle] = el.acl_conn_handle;
 
       tBTM_SEC_DEV_REC* p_rec = btm_find_dev_by_handle(el.acl_conn_handle);
       if (p_rec) {
@@ -502,6 +615,125 @@ struct iso_impl {
                                    base::Unretained(this)));
   }
 
+  static std::string iso_group_text(const iso_base* iso) {
+    if (iso->state_flags & kStateFlagIsBroadcast)
+      return base::StringPrintf("big_handle:0x%02x", iso->big_handle);
+    return base::StringPrintf("cig_id:0x%02x", iso->cig_id);
+  }
+
+  RawAddress iso_peer_address(uint16_t iso_handle) const {
+    auto addr = cis_hdl_to_addr.find(iso_handle);
+    return addr != cis_hdl_to_addr.end() ? addr->second : RawAddress::kEmpty;
+  }
+
+  void on_iso_tx_sync_read(uint8_t* stream, uint16_t len) {
+    uint8_t status;
+    uint16_t conn_handle;
+    uint16_t seq_nb;
+    uint32_t tx_ts;
+
+    // 1 + 2 + 2 + 4 + 3
+    if (len < 12) {
+      LOG_ERROR("Malformed ISO TX sync format, len=%d", len);
+      return;
+    }
+
+    STREAM_TO_UINT8(status, stream);
+    STREAM_TO_UINT16(conn_handle, stream);
+
+    iso_base* iso = GetIsoIfKnown(conn_handle);
+    if (iso == nullptr) {
+      /* The CIS or BIS may be gone while waiting on the response */
+      LOG_WARN("Invalid connection handle: 0x%04x", conn_handle);
+      return;
+    }
+
+    auto& stats = iso->tx_stats;
+    if (status != HCI_SUCCESS) {
+      LOG_WARN("Failed to read ISO TX sync, status: 0x%02x, not asking again",
+               status);
+      stats.tx_sync_supported = false;
+      return;
+    }
+
+    STREAM_TO_UINT16(seq_nb, stream);
+    STREAM_TO_UINT32(tx_ts, stream);
+
+    /* The sequence numbers follow the host clock, one per SDU interval,
+     * while the timestamp is the controller's. Sum up both from one read to
+     * the next and compare.
+     */
+    if (stats.tx_sync_has_ref) {
+      uint16_t seq_delta = seq_nb - stats.tx_sync_seq_nb;
+      stats.tx_sync_host_elapsed_us += (int64_t)seq_delta * iso->sdu_itv;
+      stats.tx_sync_controller_elapsed_us +=
+          (uint32_t)(tx_ts - stats.tx_sync_ts);
+      if (stats.tx_sync_host_elapsed_us > 0) {
+        stats.clock_drift_ppm = (int32_t)(
+            (stats.tx_sync_controller_elapsed_us -
+             stats.tx_sync_host_elapsed_us) *
+            1000000 / stats.tx_sync_host_elapsed_us);
+      }
+    }
+    stats.tx_sync_has_ref = true;
+    stats.tx_sync_seq_nb = seq_nb;
+    stats.tx_sync_ts = tx_ts;
+
+    if (std::abs(stats.clock_drift_ppm) >= kIsoClockDriftLogThresholdPpm &&
+        !stats.clock_drift_logged) {
+      stats.clock_drift_logged = true;
+      BTM_LogHistory(
+          kBtmLogTag, iso_peer_address(conn_handle), "ISO clock drift",
+          base::StringPrintf("iso_handle:0x%04x %s drift:%d ppm", conn_handle,
+                             iso_group_text(iso).c_str(),
+                             stats.clock_drift_ppm));
+    }
+
+    if (stats.late_sdu_count != stats.logged_late_sdu_count) {
+      stats.logged_late_sdu_count = stats.late_sdu_count;
+      BTM_LogHistory(
+          kBtmLogTag, iso_peer_address(conn_handle), "Late ISO SDUs",
+          base::StringPrintf("iso_handle:0x%04x %s late:%zu missed:%zu "
+                             "max_offset:%uus",
+                             conn_handle, iso_group_text(iso).c_str(),
+                             stats.late_sdu_count,
+                             stats.missed_interval_count,
+                             stats.submit_offset_max_us));
+    }
+  }
+
+  void update_tx_timing_stats(uint16_t iso_handle, iso_base* iso,
+                              uint32_t ts) {
+    auto& stats = iso->tx_stats;
+    uint32_t seq_nb = (ts - iso->sync_info.first_sync_ts) / iso->sdu_itv;
+    uint32_t offset_us = (ts - iso->sync_info.first_sync_ts) % iso->sdu_itv;
+
+    stats.submit_offset_min_us =
+        std::min(stats.submit_offset_min_us, offset_us);
+    stats.submit_offset_max_us =
+        std::max(stats.submit_offset_max_us, offset_us);
+    stats.submit_offset_sum_us += offset_us;
+
+    if (stats.sdu_count != 0) {
+      if (seq_nb == stats.last_seq_nb) {
+        stats.same_interval_count++;
+      } else if (seq_nb > stats.last_seq_nb + 1) {
+        stats.late_sdu_count++;
+        stats.missed_interval_count += seq_nb - stats.last_seq_nb - 1;
+        stats.last_late_sdu_us = ts;
+      }
+    }
+    stats.last_seq_nb = seq_nb;
+    stats.sdu_count++;
+
+    if (stats.tx_sync_supported &&
+        (stats.sdu_count % kIsoTxSyncReadPeriodSdus) == 0) {
+      btsnd_hcic_read_iso_tx_sync(
+          iso_handle, base::BindOnce(&iso_impl::on_iso_tx_sync_read,
+                                     base::Unretained(this)));
+    }
+  }
+
   BT_HDR* prepare_ts_hci_packet(uint16_t iso_handle, uint32_t ts,
                                 uint16_t seq_nb, uint16_t data_len) {
     /* Add 2 for packet seq., 2 for length, 4 for the timestamp */
@@ -509,11 +741,16 @@ struct iso_impl {
 
     /* Add 2 for handle, 2 for length */
     uint16_t iso_full_len = iso_data_load_len + 4;
-    BT_HDR* packet = (BT_HDR*)osi_malloc(iso_full_len + sizeof(BT_HDR));
+    BT_HDR* packet = sdu_pool_.acquire(data_len);
+    if (packet != nullptr) {
+      packet->layer_specific = BT_ISO_HDR_FROM_SDU_POOL;
+    } else {
+      packet = (BT_HDR*)osi_malloc(iso_full_len + sizeof(BT_HDR));
+      packet->layer_specific = 0;
+    }
     packet->len = iso_full_len;
     packet->offset = 0;
     packet->event = MSG_STACK_TO_HC_HCI_ISO;
-    packet->layer_specific = 0;
 
     uint8_t* packet_data = packet->data;
     UINT16_TO_STREAM(packet_data, iso_handle);
@@ -577,6 +814,8 @@ struct iso_impl {
         prepare_ts_hci_packet(iso_handle, ts, iso->sync_info.seq_nb, data_len);
     memcpy(packet->data + kIsoDataInTsBtHdrOffset, data, data_len);
     send_iso_data_hci_packet(packet);
+
+    update_tx_timing_stats(iso_handle, iso, ts);
   }
 
   void process_cis_est_pkt(uint8_t len, uint8_t* data) {
@@ -616,8 +855,10 @@ struct iso_impl {
 
     if (evt.status == HCI_SUCCESS) {
       cis->state_flags |= kStateFlagIsConnected;
+      reserve_acl_credits(evt.cis_conn_hdl);
     } else {
       cis_hdl_to_addr.erase(evt.cis_conn_hdl);
+      cis_hdl_to_acl_hdl_.erase(evt.cis_conn_hdl);
     }
 
     cis->state_flags &= ~kStateFlagIsConnecting;
@@ -655,12 +896,47 @@ struct iso_impl {
       iso_credits_ += cis->used_credits;
       cis->used_credits = 0;
 
+      release_acl_credits(handle);
+
       /* Data path is considered still valid, but can be reconfigured only once
        * CIS is reestablished.
        */
     }
   }
 
+  /* Keep LE ACL buffers available for the ACL link of an established CIS, so
+   * that bulk traffic of other links can't use up the controller buffers its
+   * audio control traffic needs. The reservation lasts as long as the link has
+   * a CIS established.
+   */
+  void reserve_acl_credits(uint16_t cis_handle) {
+    auto acl_handle = cis_hdl_to_acl_hdl_.find(cis_handle);
+    if (acl_handle == cis_hdl_to_acl_hdl_.end() ||
+        acl_credit_reservation_ == 0) {
+      return;
+    }
+
+    if (acl_hdl_to_active_cis_count_[acl_handle->second]++ == 0) {
+      bluetooth::shim::ACL_SetLeTxCreditReservation(acl_handle->second,
+                                                    acl_credit_reservation_);
+    }
+  }
+
+  void release_acl_credits(uint16_t cis_handle) {
+    auto acl_handle = cis_hdl_to_acl_hdl_.find(cis_handle);
+    if (acl_handle == cis_hdl_to_acl_hdl_.end()) return;
+
+    auto active_cis_count =
+        acl_hdl_to_active_cis_count_.find(acl_handle->second);
+    cis_hdl_to_acl_hdl_.erase(acl_handle);
+    if (active_cis_count == acl_hdl_to_active_cis_count_.end()) return;
+
+    if (--active_cis_count->second == 0) {
+      bluetooth::shim::ACL_SetLeTxCreditReservation(active_cis_count->first, 0);
+      acl_hdl_to_active_cis_count_.erase(active_cis_count);
+    }
+  }
+
   void handle_num_completed_pkts(uint8_t* p, uint8_t evt_len) {
     uint8_t num_handles;
 
@@ -969,11 +1245,62 @@ struct iso_impl {
                  : 0llu));
   }
 
+  static void dump_tx_timing_stats(int fd,
+                                   const iso_base::tx_timing_stats& stats) {
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+    dprintf(fd, "        TX Timing Stats:\n");
+    dprintf(fd, "          SDUs sent: %zu\n", stats.sdu_count);
+    if (stats.sdu_count > 0) {
+      dprintf(fd,
+              "          Submit offset in interval (us) min/avg/max: "
+              "%u/%llu/%u\n",
+              stats.submit_offset_min_us,
+              (unsigned long long)(stats.submit_offset_sum_us /
+                                   stats.sdu_count),
+              stats.submit_offset_max_us);
+    }
+    dprintf(fd, "          Late SDUs (count): %zu\n", stats.late_sdu_count);
+    dprintf(fd, "          Intervals without SDU (count): %zu\n",
+            stats.missed_interval_count);
+    dprintf(fd, "          SDUs sharing an interval (count): %zu\n",
+            stats.same_interval_count);
+    dprintf(fd, "          Last late SDU time ago (ms): %llu\n",
+            (stats.last_late_sdu_us > 0
+                 ? (unsigned long long)(now_us - stats.last_late_sdu_us) / 1000
+                 : 0llu));
+    if (!stats.tx_sync_supported) {
+      dprintf(fd, "          Clock drift: unavailable\n");
+    } else if (stats.tx_sync_host_elapsed_us > 0) {
+      dprintf(fd, "          Clock drift (ppm): %d over %llu ms\n",
+              stats.clock_drift_ppm,
+              (unsigned long long)stats.tx_sync_host_elapsed_us / 1000);
+    }
+  }
+
   void dump(int fd) const {
     dprintf(fd, "  ----------------\n ");
     dprintf(fd, "  ISO Manager:\n");
-    dprintf(fd, "    Available credits: %d\n", iso_credits_.load());
+    dprintf(fd, "    Available credits: %d of %d\n", iso_credits_.load(),
+            iso_buffer_count_);
+    /* Every credit in use belongs to an ISO stream until it completes */
+    int used_credits = 0;
+    for (auto const& [handle, cis] : conn_hdl_to_cis_map_) {
+      used_credits += cis->used_credits;
+    }
+    for (auto const& [handle, bis] : conn_hdl_to_bis_map_) {
+      used_credits += bis->used_credits;
+    }
+    dprintf(fd, "    Credits not accounted for by any stream: %d\n",
+            iso_buffer_count_ - iso_credits_.load() - used_credits);
     dprintf(fd, "    Controller buffer size: %d\n", iso_buffer_size_);
+    sdu_pool_.dump(fd);
+    dprintf(fd, "    LE ACL credits reserved per audio link: %d\n",
+            acl_credit_reservation_);
+    for (auto const& [acl_handle, cis_count] : acl_hdl_to_active_cis_count_) {
+      dprintf(fd, "      ACL handle: %d, established CISes: %d\n", acl_handle,
+              cis_count);
+    }
     dprintf(fd, "    Num of ISO traffic callbacks: %lu\n",
             static_cast<unsigned long>(
                 on_iso_traffic_active_callbacks_list_.size()));
@@ -988,6 +1315,7 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_tx_timing_stats(fd, cis_pair.second->tx_stats);
     }
     dprintf(fd, "    BISes:\n");
     for (auto const& cis_pair : conn_hdl_to_bis_map_) {
@@ -1000,6 +1328,7 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_tx_timing_stats(fd, cis_pair.second->tx_stats);
     }
     dprintf(fd, "  ----------------\n ");
   }
@@ -1007,7 +1336,12 @@ struct iso_impl {
   std::map<uint16_t, std::unique_ptr<iso_cis>> conn_hdl_to_cis_map_;
   std::map<uint16_t, std::unique_ptr<iso_bis>> conn_hdl_to_bis_map_;
   std::map<uint16_t, RawAddress> cis_hdl_to_addr;
+  std::map<uint16_t, uint16_t> cis_hdl_to_acl_hdl_;
+  std::map<uint16_t, int> acl_hdl_to_active_cis_count_;
+  int acl_credit_reservation_;
 
+  iso_sdu_pool& sdu_pool_;
+  uint16_t iso_buffer_count_;
   std::atomic_uint16_t iso_credits_;
   uint16_t iso_buffer_size_;
   uint32_t last_big_create_req_sdu_itv_;
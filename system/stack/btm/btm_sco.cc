@@ -96,12 +96,12 @@ const bluetooth::legacy::hci::Interface& GetLegacyHciInterface() {
    ESCO_PKT_TYPES_MASK_NO_2_EV5 | ESCO_PKT_TYPES_MASK_NO_3_EV5)
 
 /* Buffer used for reading PCM data from audio server that will be encoded into
- * mSBC packet. The BTM_SCO_DATA_SIZE_MAX should be set to a number divisible by
- * BTM_MSBC_CODE_SIZE(240) */
+ * mSBC or LC3 packet. The BTM_SCO_DATA_SIZE_MAX should be set to a number
+ * divisible by BTM_MSBC_CODE_SIZE(240) and BTM_LC3_CODE_SIZE(480) */
 static int16_t btm_pcm_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
 
 /* The read and write offset for btm_pcm_buf.
- * They are only used for WBS and the unit is byte. */
+ * They are only used for WBS and SWB and the unit is byte. */
 static size_t btm_pcm_buf_read_offset = 0;
 static size_t btm_pcm_buf_write_offset = 0;
 /******************************************************************************/
@@ -253,16 +253,25 @@ void btm_route_sco_data(BT_HDR* p_msg) {
 
   const uint8_t* decoded = nullptr;
   size_t written = 0, rc = 0;
-  if (active_sco->is_wbs()) {
+  if (active_sco->is_wbs() || active_sco->is_swb()) {
     uint16_t status = HCID_GET_PKT_STATUS(handle_with_flags);
 
     if (status > 0) LOG_DEBUG("Packet corrupted with status(0x%X)", status);
-    rc = bluetooth::audio::sco::wbs::enqueue_packet(payload, data_len,
-                                                    status > 0);
+    if (active_sco->is_swb()) {
+      rc = bluetooth::audio::sco::swb::enqueue_packet(payload, data_len,
+                                                      status > 0);
+    } else {
+      rc = bluetooth::audio::sco::wbs::enqueue_packet(payload, data_len,
+                                                      status > 0);
+    }
     if (rc != data_len) LOG_DEBUG("Failed to enqueue packet");
 
     while (rc) {
-      rc = bluetooth::audio::sco::wbs::decode(&decoded);
+      if (active_sco->is_swb()) {
+        rc = bluetooth::audio::sco::swb::decode(&decoded);
+      } else {
+        rc = bluetooth::audio::sco::wbs::decode(&decoded);
+      }
       if (rc == 0) {
         LOG_DEBUG("Failed to decode frames");
         break;
@@ -279,7 +288,9 @@ void btm_route_sco_data(BT_HDR* p_msg) {
    * server, so that we can keep the data read/write rate balanced */
   size_t read = 0, avail = 0;
   const uint8_t* encoded = nullptr;
-  if (active_sco->is_wbs()) {
+  if (active_sco->is_wbs() || active_sco->is_swb()) {
+    size_t code_size =
+        active_sco->is_swb() ? BTM_LC3_CODE_SIZE : BTM_MSBC_CODE_SIZE;
     while (written) {
       avail = BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_write_offset;
       if (avail) {
@@ -309,8 +320,8 @@ void btm_route_sco_data(BT_HDR* p_msg) {
          * buffer to spare the buffer space when the buffer is full */
         LOG_WARN("Buffer is full when we try to read from audio server");
         ASSERT_LOG(btm_pcm_buf_write_offset - btm_pcm_buf_read_offset >=
-                       BTM_MSBC_CODE_SIZE,
-                   "PCM buffer is full but fails to encode a mSBC packet. "
+                       code_size,
+                   "PCM buffer is full but fails to encode a packet. "
                    "This is abnormal and can cause busy loop: "
                    "WriteOffset:%lu, ReadOffset:%lu, BufferSize:%lu",
                    (unsigned long)btm_pcm_buf_write_offset,
@@ -319,9 +330,15 @@ void btm_route_sco_data(BT_HDR* p_msg) {
       }
 
       btm_pcm_buf_write_offset += read;
-      rc = bluetooth::audio::sco::wbs::encode(
-          &btm_pcm_buf[btm_pcm_buf_read_offset / sizeof(*btm_pcm_buf)],
-          btm_pcm_buf_write_offset - btm_pcm_buf_read_offset);
+      if (active_sco->is_swb()) {
+        rc = bluetooth::audio::sco::swb::encode(
+            &btm_pcm_buf[btm_pcm_buf_read_offset / sizeof(*btm_pcm_buf)],
+            btm_pcm_buf_write_offset - btm_pcm_buf_read_offset);
+      } else {
+        rc = bluetooth::audio::sco::wbs::encode(
+            &btm_pcm_buf[btm_pcm_buf_read_offset / sizeof(*btm_pcm_buf)],
+            btm_pcm_buf_write_offset - btm_pcm_buf_read_offset);
+      }
 
       if (!rc)
         LOG_DEBUG(
@@ -331,8 +348,8 @@ void btm_route_sco_data(BT_HDR* p_msg) {
             (unsigned long)btm_pcm_buf_write_offset);
 
       /* The offsets should reset some time as the buffer length should always
-       * divisible by BTM_MSBC_CODE_SIZE(240) and wbs::encode only returns
-       * BTM_MSBC_CODE_SIZE or 0 */
+       * divisible by the code size, which wbs::encode and swb::encode return
+       * on success and 0 on failure */
       btm_pcm_buf_read_offset += rc;
       if (btm_pcm_buf_write_offset == btm_pcm_buf_read_offset) {
         btm_pcm_buf_write_offset = 0;
@@ -341,59 +358,88 @@ void btm_route_sco_data(BT_HDR* p_msg) {
 
       /* Send all of the available SCO packets buffered in the queue */
       while (1) {
-        rc = bluetooth::audio::sco::wbs::dequeue_packet(&encoded);
+        if (active_sco->is_swb()) {
+          rc = bluetooth::audio::sco::swb::dequeue_packet(&encoded);
+        } else {
+          rc = bluetooth::audio::sco::wbs::dequeue_packet(&encoded);
+        }
         if (!rc) break;
 
-        auto data = std::vector<uint8_t>(encoded, encoded + rc);
-        btm_send_sco_packet(std::move(data));
+        BT_HDR* packet = btm_sco_alloc_packet();
+        memcpy(btm_sco_packet_data(packet), encoded, rc);
+        btm_send_sco_packet(packet, rc);
       }
     }
   } else {
     while (written) {
+      /* In narrow-band, the CVSD encode is offloaded to controller so we can
+       * send PCM data directly to SCO. It is read from the audio server
+       * straight into the packet.
+       * We don't maintain buffer read/write offset for NB as we send all data
+       * that we read from the audio server. */
+      BT_HDR* packet = btm_sco_alloc_packet();
       read = bluetooth::audio::sco::read(
-          (uint8_t*)btm_pcm_buf,
+          btm_sco_packet_data(packet),
           written < BTM_SCO_DATA_SIZE_MAX ? written : BTM_SCO_DATA_SIZE_MAX);
       if (read == 0) {
         LOG_INFO("Failed to read %lu bytes of PCM data from audio server",
                  (unsigned long)(written < BTM_SCO_DATA_SIZE_MAX
                                      ? written
                                      : BTM_SCO_DATA_SIZE_MAX));
+        osi_free(packet);
         break;
       }
       written -= read;
 
-      /* In narrow-band, the CVSD encode is offloaded to controller so we can
-       * send PCM data directly to SCO.
-       * We don't maintain buffer read/write offset for NB as we send all data
-       * that we read from the audio server. */
-      auto data = std::vector<uint8_t>((uint8_t*)btm_pcm_buf,
-                                       (uint8_t*)btm_pcm_buf + read);
-      btm_send_sco_packet(std::move(data));
+      btm_send_sco_packet(packet, read);
     }
   }
 }
 
-void btm_send_sco_packet(std::vector<uint8_t> data) {
+void btm_send_sco_packet(BT_HDR* p_buf, size_t data_len) {
   auto* active_sco = btm_get_active_sco();
-  if (active_sco == nullptr || data.empty()) {
+  if (active_sco == nullptr || data_len == 0) {
+    osi_free(p_buf);
     return;
   }
-  BT_HDR* packet = btm_sco_make_packet(std::move(data), active_sco->hci_handle);
-  bte_main_hci_send(packet, BT_EVT_TO_LM_HCI_SCO);
+  btm_sco_frame_packet(p_buf, active_sco->hci_handle, data_len);
+  bte_main_hci_send(p_buf, BT_EVT_TO_LM_HCI_SCO);
+}
+
+// The outgoing SCO packets are sent every few milliseconds, they are taken
+// from the packet pools and sized for BTM_SCO_DATA_SIZE_MAX bytes of data
+// rather than zeroed small buffers
+BT_HDR* btm_sco_alloc_packet(void) {
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(
+      sizeof(BT_HDR) + BTM_SCO_HCI_HEADER_LEN + BTM_SCO_DATA_SIZE_MAX);
+  p_buf->event = BT_EVT_TO_LM_HCI_SCO;
+  p_buf->len = 0;
+  p_buf->offset = 0;
+  p_buf->layer_specific = 0;
+  return p_buf;
+}
+
+uint8_t* btm_sco_packet_data(BT_HDR* p_buf) {
+  return p_buf->data + BTM_SCO_HCI_HEADER_LEN;
+}
+
+void btm_sco_frame_packet(BT_HDR* p_buf, uint16_t sco_handle,
+                          size_t data_len) {
+  ASSERT_LOG(data_len <= BTM_SCO_DATA_SIZE_MAX, "Invalid SCO data size: %lu",
+             (unsigned long)data_len);
+  p_buf->len = data_len + BTM_SCO_HCI_HEADER_LEN;
+  uint8_t* header = p_buf->data;
+  UINT16_TO_STREAM(header, sco_handle);
+  UINT8_TO_STREAM(header, data_len);
 }
 
 // Build a SCO packet from uint8
 BT_HDR* btm_sco_make_packet(std::vector<uint8_t> data, uint16_t sco_handle) {
   ASSERT_LOG(data.size() <= BTM_SCO_DATA_SIZE_MAX, "Invalid SCO data size: %lu",
              (unsigned long)data.size());
-  BT_HDR* p_buf = (BT_HDR*)osi_calloc(BT_SMALL_BUFFER_SIZE);
-  p_buf->event = BT_EVT_TO_LM_HCI_SCO;
-  // SCO header size is 3 per Core 5.2 Vol 4 Part E 5.4.3 figure 5.3
-  p_buf->len = data.size() + 3;
-  uint8_t* payload = p_buf->data;
-  UINT16_TO_STREAM(payload, sco_handle);
-  UINT8_TO_STREAM(payload, data.size());
-  ARRAY_TO_STREAM(payload, data.data(), static_cast<int>(data.size()));
+  BT_HDR* p_buf = btm_sco_alloc_packet();
+  memcpy(btm_sco_packet_data(p_buf), data.data(), data.size());
+  btm_sco_frame_packet(p_buf, sco_handle, data.size());
   return p_buf;
 }
 
@@ -931,11 +977,16 @@ void btm_sco_connected(const RawAddress& bda, uint16_t hci_handle,
 
       /* In-band (non-offload) data path */
       if (p->is_inband()) {
-        if (p->is_wbs()) {
+        if (p->is_wbs() || p->is_swb()) {
           btm_pcm_buf_read_offset = 0;
           btm_pcm_buf_write_offset = 0;
+        }
+        if (p->is_wbs()) {
           bluetooth::audio::sco::wbs::init(
               hfp_hal_interface::get_packet_size(codec));
+        } else if (p->is_swb()) {
+          bluetooth::audio::sco::swb::init(
+              hfp_hal_interface::get_packet_size(codec));
         }
 
         std::fill(std::begin(btm_pcm_buf), std::end(btm_pcm_buf), 0);
@@ -1169,18 +1220,27 @@ void btm_sco_on_disconnected(uint16_t hci_handle, tHCI_REASON reason) {
           p_sco->esco.setup.transmit_coding_format.coding_format));
 
   if (p_sco->is_inband()) {
-    if (p_sco->is_wbs()) {
+    if (p_sco->is_wbs() || p_sco->is_swb()) {
       int num_decoded_frames;
       double packet_loss_ratio;
-      if (bluetooth::audio::sco::wbs::fill_plc_stats(&num_decoded_frames,
-                                                     &packet_loss_ratio)) {
+      bool has_stats =
+          p_sco->is_swb()
+              ? bluetooth::audio::sco::swb::fill_plc_stats(&num_decoded_frames,
+                                                           &packet_loss_ratio)
+              : bluetooth::audio::sco::wbs::fill_plc_stats(&num_decoded_frames,
+                                                           &packet_loss_ratio);
+      if (has_stats) {
         log_hfp_audio_packet_loss_stats(bd_addr, num_decoded_frames,
                                         packet_loss_ratio);
       } else {
         LOG_WARN("Failed to get the packet loss stats");
       }
 
-      bluetooth::audio::sco::wbs::cleanup();
+      if (p_sco->is_swb()) {
+        bluetooth::audio::sco::swb::cleanup();
+      } else {
+        bluetooth::audio::sco::wbs::cleanup();
+      }
     }
 
     bluetooth::audio::sco::cleanup();
@@ -16,11 +16,9 @@
 
 #include <errno.h>
 #include <grp.h>
-#include <math.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
-#include <cfloat>
 #include <memory>
 
 // Define before including log.h
@@ -31,6 +29,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "stack/btm/btm_sco.h"
+#include "stack/btm/btm_sco_plc_dsp.h"
 #include "udrv/include/uipc.h"
 
 #define SCO_DATA_READ_POLL_MS 10
@@ -39,22 +38,15 @@
 #define SCO_HOST_DATA_GROUP "bluetooth-audio"
 
 /* Per Bluetooth Core v5.0 and HFP 1.7 specification. */
-#define BTM_MSBC_H2_HEADER_0 0x01
-#define BTM_MSBC_H2_HEADER_LEN 2
-#define BTM_MSBC_PKT_LEN 60
+#define BTM_H2_HEADER_0 0x01
+#define BTM_H2_HEADER_LEN 2
+#define BTM_H2_PKT_LEN 60 /* mSBC and LC3-SWB packet length */
 #define BTM_MSBC_PKT_FRAME_LEN 57 /* Packet length without the header */
 #define BTM_MSBC_SYNC_WORD 0xAD
 
-/* Used by PLC */
-#define BTM_MSBC_SAMPLE_SIZE 2 /* 2 bytes*/
-#define BTM_MSBC_FS 120        /* Frame Size */
-
-#define BTM_PLC_WL 256 /* 16ms - Window Length for pattern matching */
-#define BTM_PLC_TL 64  /* 4ms - Template Length for matching */
-#define BTM_PLC_HL \
-  (BTM_PLC_WL + BTM_MSBC_FS - 1) /* Length of History buffer required */
-#define BTM_PLC_SBCRL 36         /* SBC Reconvergence sample Length */
-#define BTM_PLC_OLAL 16          /* OverLap-Add Length */
+/* Per HFP 1.9 specification. */
+#define BTM_LC3_PKT_FRAME_LEN 58 /* Packet length without the header */
+#define BTM_LC3_FS 240           /* Frame Size */
 
 /* Disable the PLC when there are more than threshold of lost packets in the
  * window */
@@ -134,20 +126,233 @@ size_t write(const uint8_t* p_buf, uint32_t len) {
   return UIPC_Send(*sco_uipc, UIPC_CH_ID_AV_AUDIO, 0, p_buf, len) ? len : 0;
 }
 
-namespace wbs {
-
 /* Second octet of H2 header is composed by 4 bits fixed 0x8 and 4 bits
  * sequence number 0000, 0011, 1100, 1111. */
 static const uint8_t btm_h2_header_frames_count[] = {0x08, 0x38, 0xc8, 0xf8};
 
-/* Supported SCO packet sizes for mSBC. The wideband speech mSBC frame parsing
- * code ties to limited packet size values. Specifically list them out
- * to check against when setting packet size. The first entry is the default
- * value as a fallback. */
-constexpr size_t btm_wbs_supported_pkt_size[] = {BTM_MSBC_PKT_LEN, 72, 0};
+/* Supported SCO packet sizes for mSBC and LC3-SWB. The frame parsing code ties
+ * to limited packet size values. Specifically list them out to check against
+ * when setting packet size. The first entry is the default value as a
+ * fallback. */
+constexpr size_t btm_h2_supported_pkt_size[] = {BTM_H2_PKT_LEN, 72, 0};
 /* Buffer size should be set to least common multiple of SCO packet size and
- * BTM_MSBC_PKT_LEN for optimizing buffer copy. */
-constexpr size_t btm_wbs_msbc_buffer_size[] = {BTM_MSBC_PKT_LEN, 360, 0};
+ * BTM_H2_PKT_LEN for optimizing buffer copy. */
+constexpr size_t btm_h2_buffer_size[] = {BTM_H2_PKT_LEN, 360, 0};
+
+/* Define the structure that buffers the H2 framed packets of the mSBC and the
+ * LC3-SWB codecs */
+struct tBTM_SCO_PKT_INFO {
+  size_t packet_size; /* SCO packet size supported by lower layer */
+  size_t buf_size; /* The size of the buffer, determined by the packet_size. */
+  bool check_sync_word; /* If the frames start with the mSBC sync word, LC3
+                           frames have none */
+
+  uint8_t* decode_buf;  /* Buffer to store packets to decode */
+  size_t decode_buf_wo; /* Write offset of the decode buffer */
+  size_t decode_buf_ro; /* Read offset of the decode buffer */
+  bool read_corrupted;  /* If the current packet read is corrupted */
+
+  uint8_t* encode_buf;  /* Buffer to store the encoded SCO packets */
+  size_t encode_buf_wo; /* Write offset of the encode buffer */
+  size_t encode_buf_ro; /* Read offset of the encode buffer */
+
+  uint8_t num_encoded_pkts; /* Number of the encoded packets */
+
+  static size_t get_supported_packet_size(size_t pkt_size,
+                                          size_t* buffer_size) {
+    int i;
+    for (i = 0; btm_h2_supported_pkt_size[i] != 0 &&
+                btm_h2_supported_pkt_size[i] != pkt_size;
+         i++)
+      ;
+    /* In case of unsupported value, error log and fallback to
+     * BTM_H2_PKT_LEN(60). */
+    if (btm_h2_supported_pkt_size[i] == 0) {
+      LOG_WARN("Unsupported packet size %lu", (unsigned long)pkt_size);
+      i = 0;
+    }
+
+    if (buffer_size) {
+      *buffer_size = btm_h2_buffer_size[i];
+    }
+    return btm_h2_supported_pkt_size[i];
+  }
+
+  bool verify_h2_header_seq_num(const uint8_t num) {
+    for (int i = 0; i < 4; i++) {
+      if (num == btm_h2_header_frames_count[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ public:
+  size_t init(size_t pkt_size, bool sync_word) {
+    decode_buf_wo = 0;
+    decode_buf_ro = 0;
+    encode_buf_wo = 0;
+    encode_buf_ro = 0;
+    check_sync_word = sync_word;
+
+    pkt_size = get_supported_packet_size(pkt_size, &buf_size);
+    if (pkt_size == packet_size) return packet_size;
+    packet_size = pkt_size;
+
+    if (decode_buf) osi_free(decode_buf);
+    decode_buf = (uint8_t*)osi_calloc(buf_size);
+
+    if (encode_buf) osi_free(encode_buf);
+    encode_buf = (uint8_t*)osi_calloc(buf_size);
+    return packet_size;
+  }
+
+  void deinit() {
+    if (decode_buf) osi_free(decode_buf);
+    if (encode_buf) osi_free(encode_buf);
+  }
+
+  size_t decodable() { return decode_buf_wo - decode_buf_ro; }
+
+  void mark_pkt_decoded() {
+    if (decode_buf_ro + BTM_H2_PKT_LEN > decode_buf_wo) {
+      LOG_ERROR("Trying to mark read offset beyond write offset.");
+      return;
+    }
+
+    decode_buf_ro += BTM_H2_PKT_LEN;
+    if (decode_buf_ro == decode_buf_wo) {
+      decode_buf_ro = 0;
+      decode_buf_wo = 0;
+    }
+  }
+
+  size_t write(const uint8_t* input, size_t len) {
+    if (len > buf_size - decode_buf_wo) {
+      return 0;
+    }
+
+    std::copy(input, input + len, decode_buf + decode_buf_wo);
+    decode_buf_wo += len;
+    return len;
+  }
+
+  const uint8_t* find_pkt_head() {
+    if (read_corrupted) {
+      LOG_DEBUG("Skip corrupted packets");
+      read_corrupted = false;
+      return nullptr;
+    }
+
+    size_t rp = 0;
+    while (rp < BTM_H2_PKT_LEN &&
+           decode_buf_wo - (decode_buf_ro + rp) >= BTM_H2_PKT_LEN) {
+      if ((decode_buf[decode_buf_ro + rp] != BTM_H2_HEADER_0) ||
+          (!verify_h2_header_seq_num(decode_buf[decode_buf_ro + rp + 1])) ||
+          (check_sync_word &&
+           decode_buf[decode_buf_ro + rp + 2] != BTM_MSBC_SYNC_WORD)) {
+        rp++;
+        continue;
+      }
+
+      if (rp != 0) {
+        LOG_WARN("Skipped %lu bytes of data ahead of a valid frame",
+                 (unsigned long)rp);
+        decode_buf_ro += rp;
+      }
+      return &decode_buf[decode_buf_ro];
+    }
+
+    return nullptr;
+  }
+
+  /* Fill in the H2 header and update the buffer's write offset to guard the
+   * buffer space to be written. Return a pointer to the start of packet's
+   * body for the caller to fill the encoded data if there is enough space
+   * in the buffer to fill in a new packet, otherwise return a nullptr. */
+  uint8_t* fill_pkt_template() {
+    uint8_t* wp = &encode_buf[encode_buf_wo];
+    if (buf_size - encode_buf_wo < BTM_H2_PKT_LEN) {
+      LOG_DEBUG("Packet queue can't accommodate more packets.");
+      return nullptr;
+    }
+
+    wp[0] = BTM_H2_HEADER_0;
+    wp[1] = btm_h2_header_frames_count[num_encoded_pkts % 4];
+    encode_buf_wo += BTM_H2_PKT_LEN;
+
+    num_encoded_pkts++;
+    return wp + BTM_H2_HEADER_LEN;
+  }
+
+  size_t mark_pkt_dequeued() {
+    LOG_DEBUG(
+        "Try to mark an encoded packet dequeued: ro:%lu wo:%lu pkt_size:%lu",
+        (unsigned long)encode_buf_ro, (unsigned long)encode_buf_wo,
+        (unsigned long)packet_size);
+
+    if (encode_buf_wo - encode_buf_ro < packet_size) return 0;
+
+    encode_buf_ro += packet_size;
+    if (encode_buf_ro == encode_buf_wo) {
+      encode_buf_ro = 0;
+      encode_buf_wo = 0;
+    }
+
+    return packet_size;
+  }
+
+  const uint8_t* sco_pkt_read_ptr() {
+    if (encode_buf_wo - encode_buf_ro < packet_size) {
+      LOG_DEBUG("Insufficient data as a SCO packet to read.");
+      return nullptr;
+    }
+
+    return &encode_buf[encode_buf_ro];
+  }
+};
+
+static size_t enqueue_pkt(tBTM_SCO_PKT_INFO* info, const uint8_t* data,
+                          size_t pkt_size, bool corrupted) {
+  if (pkt_size != info->packet_size) {
+    LOG_WARN(
+        "Ignoring the coming packet with size %lu that is inconsistent with "
+        "the HAL reported packet size %lu",
+        (unsigned long)pkt_size, (unsigned long)info->packet_size);
+    return 0;
+  }
+
+  if (data == nullptr) {
+    LOG_WARN("Invalid data to enqueue");
+    return 0;
+  }
+
+  info->read_corrupted |= corrupted;
+  if (info->write(data, pkt_size) != pkt_size) {
+    LOG_DEBUG("Fail to write packet with size %lu to buffer",
+              (unsigned long)pkt_size);
+    return 0;
+  }
+
+  return pkt_size;
+}
+
+static size_t dequeue_pkt(tBTM_SCO_PKT_INFO* info, const uint8_t** output) {
+  if (output == nullptr) {
+    LOG_WARN("%s Invalid output pointer", __func__);
+    return 0;
+  }
+
+  *output = info->sco_pkt_read_ptr();
+  if (*output == nullptr) {
+    LOG_DEBUG("Insufficient data to dequeue.");
+    return 0;
+  }
+
+  return info->mark_pkt_dequeued();
+}
+
+namespace wbs {
 
 /* The pre-computed SCO packet per HFP 1.7 spec. This mSBC packet will be
  * decoded into all-zero input PCM. */
@@ -161,18 +366,6 @@ static const uint8_t btm_msbc_zero_packet[] = {
     /* End of Audio Samples */
     0x00 /* A padding byte defined by mSBC */};
 
-/* Raised Cosine table for OLA */
-static const float rcos[BTM_PLC_OLAL] = {
-    0.99148655f, 0.96623611f, 0.92510857f, 0.86950446f,
-    0.80131732f, 0.72286918f, 0.63683150f, 0.54613418f,
-    0.45386582f, 0.36316850f, 0.27713082f, 0.19868268f,
-    0.13049554f, 0.07489143f, 0.03376389f, 0.00851345f};
-
-static int16_t f_to_s16(float input) {
-  return input > INT16_MAX   ? INT16_MAX
-         : input < INT16_MIN ? INT16_MIN
-                             : (int16_t)input;
-}
 /* This structure tracks the packet loss for last PLC_WINDOW_SIZE of packets */
 struct tBTM_MSBC_BTM_PLC_WINDOW {
   bool loss_hist[BTM_PLC_WINDOW_SIZE]; /* The packet loss history of receiving
@@ -230,53 +423,6 @@ struct tBTM_MSBC_PLC {
   int num_decoded_frames; /* Number of total read mSBC frames. */
   int num_lost_frames;    /* Number of total lost mSBC frames. */
 
-  void overlap_add(int16_t* output, float scaler_d, const int16_t* desc,
-                   float scaler_a, const int16_t* asc) {
-    for (int i = 0; i < BTM_PLC_OLAL; i++) {
-      output[i] = f_to_s16(scaler_d * desc[i] * rcos[i] +
-                           scaler_a * asc[i] * rcos[BTM_PLC_OLAL - 1 - i]);
-    }
-  }
-
-  float cross_correlation(int16_t* x, int16_t* y) {
-    float sum = 0, x2 = 0, y2 = 0;
-
-    for (int i = 0; i < BTM_PLC_TL; i++) {
-      sum += ((float)x[i]) * y[i];
-      x2 += ((float)x[i]) * x[i];
-      y2 += ((float)y[i]) * y[i];
-    }
-    return sum / sqrtf(x2 * y2);
-  }
-
-  int pattern_match(int16_t* hist) {
-    int best = 0;
-    float cn, max_cn = FLT_MIN;
-
-    for (int i = 0; i < BTM_PLC_WL; i++) {
-      cn = cross_correlation(&hist[BTM_PLC_HL - BTM_PLC_TL], &hist[i]);
-      if (cn > max_cn) {
-        best = i;
-        max_cn = cn;
-      }
-    }
-    return best;
-  }
-
-  float amplitude_match(int16_t* x, int16_t* y) {
-    uint32_t sum_x = 0, sum_y = 0;
-    float scaler;
-    for (int i = 0; i < BTM_MSBC_FS; i++) {
-      sum_x += abs(x[i]);
-      sum_y += abs(y[i]);
-    }
-
-    if (sum_y == 0) return 1.2f;
-
-    scaler = (float)sum_x / sum_y;
-    return scaler > 1.2f ? 1.2f : scaler < 0.75f ? 0.75f : scaler;
-  }
-
  public:
   void init() {
     if (pl_window) osi_free(pl_window);
@@ -310,18 +456,19 @@ struct tBTM_MSBC_PLC {
     if (!pl_window->is_packet_loss_too_high()) {
       if (handled_bad_frames == 0) {
         /* Finds the best matching samples and amplitude */
-        best_lag = pattern_match(hist) + BTM_PLC_TL;
+        best_lag = plc_pattern_match(hist) + BTM_PLC_TL;
         best_match_hist = &hist[best_lag];
-        scaler =
-            amplitude_match(&hist[BTM_PLC_HL - BTM_MSBC_FS], best_match_hist);
+        scaler = plc_amplitude_match(&hist[BTM_PLC_HL - BTM_MSBC_FS],
+                                     best_match_hist);
 
         /* Constructs the substitution samples */
-        overlap_add(frame_head, 1.0, decoded_buffer, scaler, best_match_hist);
-        for (int i = BTM_PLC_OLAL; i < BTM_MSBC_FS; i++)
-          hist[BTM_PLC_HL + i] = f_to_s16(scaler * best_match_hist[i]);
-        overlap_add(&frame_head[BTM_MSBC_FS], scaler,
-                    &best_match_hist[BTM_MSBC_FS], 1.0,
-                    &best_match_hist[BTM_MSBC_FS]);
+        plc_overlap_add(frame_head, 1.0, decoded_buffer, scaler,
+                        best_match_hist);
+        plc_scale(&frame_head[BTM_PLC_OLAL], scaler,
+                  &best_match_hist[BTM_PLC_OLAL], BTM_MSBC_FS - BTM_PLC_OLAL);
+        plc_overlap_add(&frame_head[BTM_MSBC_FS], scaler,
+                        &best_match_hist[BTM_MSBC_FS], 1.0,
+                        &best_match_hist[BTM_MSBC_FS]);
 
         memmove(&frame_head[BTM_MSBC_FS + BTM_PLC_OLAL],
                 &best_match_hist[BTM_MSBC_FS + BTM_PLC_OLAL],
@@ -373,8 +520,8 @@ struct tBTM_MSBC_PLC {
        * received samples to have it reconverge with the true output */
       std::copy(frame_head, &frame_head[BTM_PLC_SBCRL], input);
       /* Overlap the input frame with the previous output frame */
-      overlap_add(&input[BTM_PLC_SBCRL], 1.0, &frame_head[BTM_PLC_SBCRL], 1.0,
-                  &input[BTM_PLC_SBCRL]);
+      plc_overlap_add(&input[BTM_PLC_SBCRL], 1.0, &frame_head[BTM_PLC_SBCRL],
+                      1.0, &input[BTM_PLC_SBCRL]);
       handled_bad_frames = 0;
     }
 
@@ -387,69 +534,14 @@ struct tBTM_MSBC_PLC {
 };
 
 /* Define the structure that contains mSBC data */
-struct tBTM_MSBC_INFO {
-  size_t packet_size; /* SCO mSBC packet size supported by lower layer */
-  size_t buf_size; /* The size of the buffer, determined by the packet_size. */
-
-  uint8_t* msbc_decode_buf; /* Buffer to store mSBC packets to decode */
-  size_t decode_buf_wo;     /* Write offset of the decode buffer */
-  size_t decode_buf_ro;     /* Read offset of the decode buffer */
-  bool read_corrupted;      /* If the current mSBC packet read is corrupted */
-
-  uint8_t* msbc_encode_buf; /* Buffer to store the encoded SCO packets */
-  size_t encode_buf_wo;     /* Write offset of the encode buffer */
-  size_t encode_buf_ro;     /* Read offset of the encode buffer */
-
+struct tBTM_MSBC_INFO : tBTM_SCO_PKT_INFO {
   int16_t decoded_pcm_buf[BTM_MSBC_FS]; /* Buffer to store decoded PCM */
 
-  uint8_t num_encoded_msbc_pkts; /* Number of the encoded mSBC packets */
-
   tBTM_MSBC_PLC* plc; /* PLC component to handle the packet loss of input */
-  static size_t get_supported_packet_size(size_t pkt_size,
-                                          size_t* buffer_size) {
-    int i;
-    for (i = 0; btm_wbs_supported_pkt_size[i] != 0 &&
-                btm_wbs_supported_pkt_size[i] != pkt_size;
-         i++)
-      ;
-    /* In case of unsupported value, error log and fallback to
-     * BTM_MSBC_PKT_LEN(60). */
-    if (btm_wbs_supported_pkt_size[i] == 0) {
-      LOG_WARN("Unsupported packet size %lu", (unsigned long)pkt_size);
-      i = 0;
-    }
-
-    if (buffer_size) {
-      *buffer_size = btm_wbs_msbc_buffer_size[i];
-    }
-    return btm_wbs_supported_pkt_size[i];
-  }
-
-  bool verify_h2_header_seq_num(const uint8_t num) {
-    for (int i = 0; i < 4; i++) {
-      if (num == btm_h2_header_frames_count[i]) {
-        return true;
-      }
-    }
-    return false;
-  }
 
  public:
   size_t init(size_t pkt_size) {
-    decode_buf_wo = 0;
-    decode_buf_ro = 0;
-    encode_buf_wo = 0;
-    encode_buf_ro = 0;
-
-    pkt_size = get_supported_packet_size(pkt_size, &buf_size);
-    if (pkt_size == packet_size) return packet_size;
-    packet_size = pkt_size;
-
-    if (msbc_decode_buf) osi_free(msbc_decode_buf);
-    msbc_decode_buf = (uint8_t*)osi_calloc(buf_size);
-
-    if (msbc_encode_buf) osi_free(msbc_encode_buf);
-    msbc_encode_buf = (uint8_t*)osi_calloc(buf_size);
+    pkt_size = tBTM_SCO_PKT_INFO::init(pkt_size, /* sync_word */ true);
 
     if (plc) {
       plc->deinit();
@@ -457,116 +549,16 @@ struct tBTM_MSBC_INFO {
     }
     plc = (tBTM_MSBC_PLC*)osi_calloc(sizeof(*plc));
     plc->init();
-    return packet_size;
+    return pkt_size;
   }
 
   void deinit() {
-    if (msbc_decode_buf) osi_free(msbc_decode_buf);
-    if (msbc_encode_buf) osi_free(msbc_encode_buf);
+    tBTM_SCO_PKT_INFO::deinit();
     if (plc) {
       plc->deinit();
       osi_free_and_reset((void**)&plc);
     }
   }
-
-  size_t decodable() { return decode_buf_wo - decode_buf_ro; }
-
-  void mark_pkt_decoded() {
-    if (decode_buf_ro + BTM_MSBC_PKT_LEN > decode_buf_wo) {
-      LOG_ERROR("Trying to mark read offset beyond write offset.");
-      return;
-    }
-
-    decode_buf_ro += BTM_MSBC_PKT_LEN;
-    if (decode_buf_ro == decode_buf_wo) {
-      decode_buf_ro = 0;
-      decode_buf_wo = 0;
-    }
-  }
-
-  size_t write(const uint8_t* input, size_t len) {
-    if (len > buf_size - decode_buf_wo) {
-      return 0;
-    }
-
-    std::copy(input, input + len, msbc_decode_buf + decode_buf_wo);
-    decode_buf_wo += len;
-    return len;
-  }
-
-  const uint8_t* find_msbc_pkt_head() {
-    if (read_corrupted) {
-      LOG_DEBUG("Skip corrupted mSBC packets");
-      read_corrupted = false;
-      return nullptr;
-    }
-
-    size_t rp = 0;
-    while (rp < BTM_MSBC_PKT_LEN &&
-           decode_buf_wo - (decode_buf_ro + rp) >= BTM_MSBC_PKT_LEN) {
-      if ((msbc_decode_buf[decode_buf_ro + rp] != BTM_MSBC_H2_HEADER_0) ||
-          (!verify_h2_header_seq_num(
-              msbc_decode_buf[decode_buf_ro + rp + 1])) ||
-          (msbc_decode_buf[decode_buf_ro + rp + 2] != BTM_MSBC_SYNC_WORD)) {
-        rp++;
-        continue;
-      }
-
-      if (rp != 0) {
-        LOG_WARN("Skipped %lu bytes of mSBC data ahead of a valid mSBC frame",
-                 (unsigned long)rp);
-        decode_buf_ro += rp;
-      }
-      return &msbc_decode_buf[decode_buf_ro];
-    }
-
-    return nullptr;
-  }
-
-  /* Fill in the mSBC header and update the buffer's write offset to guard the
-   * buffer space to be written. Return a pointer to the start of mSBC packet's
-   * body for the caller to fill the encoded mSBC data if there is enough space
-   * in the buffer to fill in a new packet, otherwise return a nullptr. */
-  uint8_t* fill_msbc_pkt_template() {
-    uint8_t* wp = &msbc_encode_buf[encode_buf_wo];
-    if (buf_size - encode_buf_wo < BTM_MSBC_PKT_LEN) {
-      LOG_DEBUG("Packet queue can't accommodate more packets.");
-      return nullptr;
-    }
-
-    wp[0] = BTM_MSBC_H2_HEADER_0;
-    wp[1] = btm_h2_header_frames_count[num_encoded_msbc_pkts % 4];
-    encode_buf_wo += BTM_MSBC_PKT_LEN;
-
-    num_encoded_msbc_pkts++;
-    return wp + BTM_MSBC_H2_HEADER_LEN;
-  }
-
-  size_t mark_pkt_dequeued() {
-    LOG_DEBUG(
-        "Try to mark an encoded packet dequeued: ro:%lu wo:%lu pkt_size:%lu",
-        (unsigned long)encode_buf_ro, (unsigned long)encode_buf_wo,
-        (unsigned long)packet_size);
-
-    if (encode_buf_wo - encode_buf_ro < packet_size) return 0;
-
-    encode_buf_ro += packet_size;
-    if (encode_buf_ro == encode_buf_wo) {
-      encode_buf_ro = 0;
-      encode_buf_wo = 0;
-    }
-
-    return packet_size;
-  }
-
-  const uint8_t* sco_pkt_read_ptr() {
-    if (encode_buf_wo - encode_buf_ro < packet_size) {
-      LOG_DEBUG("Insufficient data as a SCO packet to read.");
-      return nullptr;
-    }
-
-    return &msbc_encode_buf[encode_buf_ro];
-  }
 };
 
 static tBTM_MSBC_INFO* msbc_info = nullptr;
@@ -614,27 +606,7 @@ size_t enqueue_packet(const uint8_t* data, size_t pkt_size, bool corrupted) {
     return 0;
   }
 
-  if (pkt_size != msbc_info->packet_size) {
-    LOG_WARN(
-        "Ignoring the coming packet with size %lu that is inconsistent with "
-        "the HAL reported packet size %lu",
-        (unsigned long)pkt_size, (unsigned long)msbc_info->packet_size);
-    return 0;
-  }
-
-  if (data == nullptr) {
-    LOG_WARN("Invalid data to enqueue");
-    return 0;
-  }
-
-  msbc_info->read_corrupted |= corrupted;
-  if (msbc_info->write(data, pkt_size) != pkt_size) {
-    LOG_DEBUG("Fail to write packet with size %lu to buffer",
-              (unsigned long)pkt_size);
-    return 0;
-  }
-
-  return pkt_size;
+  return enqueue_pkt(msbc_info, data, pkt_size, corrupted);
 }
 
 size_t decode(const uint8_t** out_data) {
@@ -650,18 +622,18 @@ size_t decode(const uint8_t** out_data) {
     return 0;
   }
 
-  if (msbc_info->decodable() < BTM_MSBC_PKT_LEN) {
+  if (msbc_info->decodable() < BTM_H2_PKT_LEN) {
     LOG_DEBUG("No complete mSBC packet to decode");
     return 0;
   }
 
-  frame_head = msbc_info->find_msbc_pkt_head();
+  frame_head = msbc_info->find_pkt_head();
   if (frame_head == nullptr) {
     LOG_DEBUG("No valid mSBC packet to decode %lu, %lu",
               (unsigned long)msbc_info->decode_buf_ro,
               (unsigned long)msbc_info->decode_buf_wo);
     /* Done with parsing the raw bytes just read. If we couldn't find a valid
-     * mSBC frame head, we shall treat the existing BTM_MSBC_PKT_LEN length
+     * mSBC frame head, we shall treat the existing BTM_H2_PKT_LEN length
      * of mSBC data as a corrupted packet and conduct the PLC. */
     goto packet_loss;
   }
@@ -705,7 +677,7 @@ size_t encode(int16_t* data, size_t len) {
     return 0;
   }
 
-  pkt_body = msbc_info->fill_msbc_pkt_template();
+  pkt_body = msbc_info->fill_pkt_template();
   if (pkt_body == nullptr) {
     LOG_DEBUG("Failed to fill the template to fill the mSBC packet");
     return 0;
@@ -715,7 +687,7 @@ size_t encode(int16_t* data, size_t len) {
       GetInterfaceToProfiles()->msbcCodec->encodePacket(data, pkt_body);
   if (encoded_size != BTM_MSBC_PKT_FRAME_LEN) {
     LOG_WARN("Encoding invalid packet size: %lu", (unsigned long)encoded_size);
-    std::copy(&btm_msbc_zero_packet[BTM_MSBC_H2_HEADER_LEN],
+    std::copy(&btm_msbc_zero_packet[BTM_H2_HEADER_LEN],
               std::end(btm_msbc_zero_packet), pkt_body);
   }
 
@@ -728,21 +700,166 @@ size_t dequeue_packet(const uint8_t** output) {
     return 0;
   }
 
-  if (output == nullptr) {
+  return dequeue_pkt(msbc_info, output);
+}
+
+}  // namespace wbs
+
+namespace swb {
+
+/* Define the structure that contains LC3-SWB data. The LC3 decoder conceals
+ * the lost packets itself. */
+struct tBTM_LC3_INFO : tBTM_SCO_PKT_INFO {
+  int16_t decoded_pcm_buf[BTM_LC3_FS]; /* Buffer to store decoded PCM */
+
+  int num_decoded_frames; /* Number of total read LC3 frames. */
+  int num_lost_frames;    /* Number of total lost LC3 frames. */
+};
+
+static tBTM_LC3_INFO* lc3_info = nullptr;
+
+size_t init(size_t pkt_size) {
+  GetInterfaceToProfiles()->lc3Codec->initialize();
+
+  if (lc3_info) {
+    LOG_WARN("Re-initiating LC3 buffer that is active or not cleaned");
+    lc3_info->deinit();
+    osi_free(lc3_info);
+  }
+
+  lc3_info = (tBTM_LC3_INFO*)osi_calloc(sizeof(*lc3_info));
+  return lc3_info->init(pkt_size, /* sync_word */ false);
+}
+
+void cleanup() {
+  GetInterfaceToProfiles()->lc3Codec->cleanup();
+
+  if (lc3_info == nullptr) return;
+
+  lc3_info->deinit();
+  osi_free_and_reset((void**)&lc3_info);
+}
+
+bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio) {
+  if (lc3_info == NULL || num_decoded_frames == NULL ||
+      packet_loss_ratio == NULL)
+    return false;
+
+  int decoded_frames = lc3_info->num_decoded_frames;
+  int lost_frames = lc3_info->num_lost_frames;
+  if (decoded_frames <= 0 || lost_frames < 0 || lost_frames > decoded_frames)
+    return false;
+
+  *num_decoded_frames = decoded_frames;
+  *packet_loss_ratio = (double)lost_frames / decoded_frames;
+  return true;
+}
+
+size_t enqueue_packet(const uint8_t* data, size_t pkt_size, bool corrupted) {
+  if (lc3_info == nullptr) {
+    LOG_WARN("LC3 buffer uninitialized or cleaned");
+    return 0;
+  }
+
+  return enqueue_pkt(lc3_info, data, pkt_size, corrupted);
+}
+
+size_t decode(const uint8_t** out_data) {
+  const uint8_t* frame_head = nullptr;
+
+  if (lc3_info == nullptr) {
+    LOG_WARN("LC3 buffer uninitialized or cleaned");
+    return 0;
+  }
+
+  if (out_data == nullptr) {
     LOG_WARN("%s Invalid output pointer", __func__);
     return 0;
   }
 
-  *output = msbc_info->sco_pkt_read_ptr();
-  if (*output == nullptr) {
-    LOG_DEBUG("Insufficient data to dequeue.");
+  if (lc3_info->decodable() < BTM_H2_PKT_LEN) {
+    LOG_DEBUG("No complete LC3 packet to decode");
     return 0;
   }
 
-  return msbc_info->mark_pkt_dequeued();
+  lc3_info->num_decoded_frames++;
+  frame_head = lc3_info->find_pkt_head();
+  if (frame_head == nullptr) {
+    LOG_DEBUG("No valid LC3 packet to decode %lu, %lu",
+              (unsigned long)lc3_info->decode_buf_ro,
+              (unsigned long)lc3_info->decode_buf_wo);
+  } else if (!GetInterfaceToProfiles()->lc3Codec->decodePacket(
+                 frame_head, lc3_info->decoded_pcm_buf,
+                 sizeof(lc3_info->decoded_pcm_buf))) {
+    LOG_DEBUG("Decoding LC3 packet failed");
+    frame_head = nullptr;
+  }
+
+  if (frame_head == nullptr) {
+    /* Treat the BTM_H2_PKT_LEN length of data as a lost packet and have the
+     * decoder conceal it. */
+    lc3_info->num_lost_frames++;
+    if (!GetInterfaceToProfiles()->lc3Codec->decodePacket(
+            nullptr, lc3_info->decoded_pcm_buf,
+            sizeof(lc3_info->decoded_pcm_buf))) {
+      LOG_WARN("LC3 packet loss concealment failed");
+      std::fill(std::begin(lc3_info->decoded_pcm_buf),
+                std::end(lc3_info->decoded_pcm_buf), 0);
+    }
+  }
+
+  *out_data = (const uint8_t*)lc3_info->decoded_pcm_buf;
+  lc3_info->mark_pkt_decoded();
+  return BTM_LC3_CODE_SIZE;
 }
 
-}  // namespace wbs
+size_t encode(int16_t* data, size_t len) {
+  uint8_t* pkt_body = nullptr;
+  uint32_t encoded_size = 0;
+  if (lc3_info == nullptr) {
+    LOG_WARN("LC3 buffer uninitialized or cleaned");
+    return 0;
+  }
+
+  if (data == nullptr) {
+    LOG_WARN("Invalid data to encode");
+    return 0;
+  }
+
+  if (len < BTM_LC3_CODE_SIZE) {
+    LOG_DEBUG(
+        "PCM frames with size %lu is insufficient to be encoded into a LC3 "
+        "packet",
+        (unsigned long)len);
+    return 0;
+  }
+
+  pkt_body = lc3_info->fill_pkt_template();
+  if (pkt_body == nullptr) {
+    LOG_DEBUG("Failed to fill the template to fill the LC3 packet");
+    return 0;
+  }
+
+  encoded_size =
+      GetInterfaceToProfiles()->lc3Codec->encodePacket(data, pkt_body);
+  if (encoded_size != BTM_LC3_PKT_FRAME_LEN) {
+    LOG_WARN("Encoding invalid packet size: %lu", (unsigned long)encoded_size);
+    std::fill(pkt_body, pkt_body + BTM_LC3_PKT_FRAME_LEN, 0);
+  }
+
+  return BTM_LC3_CODE_SIZE;
+}
+
+size_t dequeue_packet(const uint8_t** output) {
+  if (lc3_info == nullptr) {
+    LOG_WARN("LC3 buffer uninitialized or cleaned");
+    return 0;
+  }
+
+  return dequeue_pkt(lc3_info, output);
+}
+
+}  // namespace swb
 
 }  // namespace sco
 }  // namespace audio
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/btm/btm_sco_plc_dsp.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cfloat>
+
+#if __SSE2__
+#include <emmintrin.h>
+#elif __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace bluetooth {
+namespace audio {
+namespace sco {
+namespace wbs {
+
+namespace {
+
+/* Raised Cosine table for OLA */
+const float rcos[BTM_PLC_OLAL] = {
+    0.99148655f, 0.96623611f, 0.92510857f, 0.86950446f,
+    0.80131732f, 0.72286918f, 0.63683150f, 0.54613418f,
+    0.45386582f, 0.36316850f, 0.27713082f, 0.19868268f,
+    0.13049554f, 0.07489143f, 0.03376389f, 0.00851345f};
+
+/* Written with min and max so that the loops calling it vectorize */
+inline int16_t f_to_s16(float input) {
+  return (int16_t)std::min(std::max(input, (float)INT16_MIN),
+                           (float)INT16_MAX);
+}
+
+/* Sum of the products of BTM_PLC_TL samples, accumulated in 8 lanes */
+inline float dot_product(const float* x, const float* y) {
+#if __SSE2__
+  __m128 acc_lo = _mm_setzero_ps();
+  __m128 acc_hi = _mm_setzero_ps();
+  for (int i = 0; i < BTM_PLC_TL; i += 8) {
+    acc_lo = _mm_add_ps(
+        acc_lo, _mm_mul_ps(_mm_loadu_ps(&x[i]), _mm_loadu_ps(&y[i])));
+    acc_hi = _mm_add_ps(
+        acc_hi, _mm_mul_ps(_mm_loadu_ps(&x[i + 4]), _mm_loadu_ps(&y[i + 4])));
+  }
+  __m128 acc = _mm_add_ps(acc_lo, acc_hi);
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  return _mm_cvtss_f32(acc);
+#elif __ARM_NEON
+  float32x4_t acc_lo = vdupq_n_f32(0);
+  float32x4_t acc_hi = vdupq_n_f32(0);
+  for (int i = 0; i < BTM_PLC_TL; i += 8) {
+    acc_lo = vaddq_f32(acc_lo, vmulq_f32(vld1q_f32(&x[i]), vld1q_f32(&y[i])));
+    acc_hi = vaddq_f32(acc_hi,
+                       vmulq_f32(vld1q_f32(&x[i + 4]), vld1q_f32(&y[i + 4])));
+  }
+  float32x4_t acc = vaddq_f32(acc_lo, acc_hi);
+  float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+  return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+  float acc[8] = {0};
+  for (int i = 0; i < BTM_PLC_TL; i += 8) {
+    for (int j = 0; j < 8; j++) acc[j] += x[i + j] * y[i + j];
+  }
+  return ((acc[0] + acc[4]) + (acc[2] + acc[6])) +
+         ((acc[1] + acc[5]) + (acc[3] + acc[7]));
+#endif
+}
+
+/* Exact, unlike accumulating the squares in a float */
+inline int64_t energy(const int16_t* x) {
+  int64_t sum = 0;
+  for (int i = 0; i < BTM_PLC_TL; i++) sum += (int32_t)x[i] * x[i];
+  return sum;
+}
+
+}  // namespace
+
+int plc_pattern_match(const int16_t* hist) {
+  /* Converted once rather than for each of the BTM_PLC_WL correlations */
+  float samples[BTM_PLC_HL];
+  for (int i = 0; i < BTM_PLC_HL; i++) samples[i] = hist[i];
+
+  const float* pattern = &samples[BTM_PLC_HL - BTM_PLC_TL];
+  float x2 = (float)energy(&hist[BTM_PLC_HL - BTM_PLC_TL]);
+  /* The energy of the candidate samples slides along with them */
+  int64_t y2 = energy(hist);
+
+  int best = 0;
+  float cn, max_cn = FLT_MIN;
+  for (int i = 0; i < BTM_PLC_WL; i++) {
+    if (i > 0) {
+      y2 += (int32_t)hist[i + BTM_PLC_TL - 1] * hist[i + BTM_PLC_TL - 1] -
+            (int32_t)hist[i - 1] * hist[i - 1];
+    }
+    cn = dot_product(pattern, &samples[i]) / sqrtf(x2 * (float)y2);
+    if (cn > max_cn) {
+      best = i;
+      max_cn = cn;
+    }
+  }
+  return best;
+}
+
+float plc_amplitude_match(const int16_t* x, const int16_t* y) {
+  uint32_t sum_x = 0, sum_y = 0;
+  float scaler;
+  for (int i = 0; i < BTM_MSBC_FS; i++) {
+    sum_x += abs(x[i]);
+    sum_y += abs(y[i]);
+  }
+
+  if (sum_y == 0) return 1.2f;
+
+  scaler = (float)sum_x / sum_y;
+  return scaler > 1.2f ? 1.2f : scaler < 0.75f ? 0.75f : scaler;
+}
+
+void plc_overlap_add(int16_t* output, float scaler_d, const int16_t* desc,
+                     float scaler_a, const int16_t* asc) {
+  for (int i = 0; i < BTM_PLC_OLAL; i++) {
+    output[i] = f_to_s16(scaler_d * desc[i] * rcos[i] +
+                         scaler_a * asc[i] * rcos[BTM_PLC_OLAL - 1 - i]);
+  }
+}
+
+void plc_scale(int16_t* output, float scaler, const int16_t* input,
+               size_t len) {
+  for (size_t i = 0; i < len; i++) output[i] = f_to_s16(scaler * input[i]);
+}
+
+}  // namespace wbs
+}  // namespace sco
+}  // namespace audio
+}  // namespace bluetooth
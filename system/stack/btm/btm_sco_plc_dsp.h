@@ -0,0 +1,62 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* Used by PLC */
+#define BTM_MSBC_SAMPLE_SIZE 2 /* 2 bytes*/
+#define BTM_MSBC_FS 120        /* Frame Size */
+
+#define BTM_PLC_WL 256 /* 16ms - Window Length for pattern matching */
+#define BTM_PLC_TL 64  /* 4ms - Template Length for matching */
+#define BTM_PLC_HL \
+  (BTM_PLC_WL + BTM_MSBC_FS - 1) /* Length of History buffer required */
+#define BTM_PLC_SBCRL 36         /* SBC Reconvergence sample Length */
+#define BTM_PLC_OLAL 16          /* OverLap-Add Length */
+
+namespace bluetooth {
+namespace audio {
+namespace sco {
+namespace wbs {
+
+/* The signal processing kernels of the mSBC packet loss concealment, run on
+ * the audio path for every lost frame. The correlations of the pattern
+ * matching use SSE2 or NEON when available and a scalar loop with the same
+ * order of accumulation otherwise. */
+
+/* Returns the index in |hist| of the BTM_PLC_TL samples that correlate best
+ * with the BTM_PLC_TL samples ending the BTM_PLC_HL samples of |hist|. */
+int plc_pattern_match(const int16_t* hist);
+
+/* Returns the ratio of the amplitudes of the BTM_MSBC_FS samples of |x| and
+ * |y|, clamped between 0.75 and 1.2. */
+float plc_amplitude_match(const int16_t* x, const int16_t* y);
+
+/* Cross fades the BTM_PLC_OLAL samples of |desc| out and those of |asc| in. */
+void plc_overlap_add(int16_t* output, float scaler_d, const int16_t* desc,
+                     float scaler_a, const int16_t* asc);
+
+/* Scales |len| samples, saturating to 16 bits. */
+void plc_scale(int16_t* output, float scaler, const int16_t* input,
+               size_t len);
+
+}  // namespace wbs
+}  // namespace sco
+}  // namespace audio
+}  // namespace bluetooth
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "hfp_lc3_decoder"
+
+#include "hfp_lc3_decoder.h"
+
+#include "embdrv/lc3/include/lc3.h"
+#include "osi/include/allocator.h"
+#include "osi/include/log.h"
+
+#define HFP_LC3_H2_HEADER_LEN 2
+#define HFP_LC3_PKT_FRAME_LEN 58 /* Packet length without the header */
+#define HFP_LC3_PCM_BYTES 480
+
+/* HFP 1.9 LC3-SWB: 7.5 ms frames of 32 kHz mono audio */
+#define HFP_LC3_FRAME_DURATION_US 7500
+#define HFP_LC3_SAMPLE_RATE_HZ 32000
+
+static void* hfp_lc3_decoder_mem = nullptr;
+static lc3_decoder_t hfp_lc3_decoder = nullptr;
+
+bool hfp_lc3_decoder_init() {
+  if (hfp_lc3_decoder_mem) {
+    LOG_WARN("%s: The decoder instance should have been released", __func__);
+    osi_free(hfp_lc3_decoder_mem);
+  }
+
+  hfp_lc3_decoder_mem = osi_malloc(lc3_decoder_size(
+      HFP_LC3_FRAME_DURATION_US, HFP_LC3_SAMPLE_RATE_HZ));
+  hfp_lc3_decoder =
+      lc3_setup_decoder(HFP_LC3_FRAME_DURATION_US, HFP_LC3_SAMPLE_RATE_HZ,
+                        HFP_LC3_SAMPLE_RATE_HZ, hfp_lc3_decoder_mem);
+  if (hfp_lc3_decoder == nullptr) {
+    LOG_ERROR("%s: lc3_setup_decoder failed", __func__);
+    osi_free_and_reset(&hfp_lc3_decoder_mem);
+    return false;
+  }
+
+  return true;
+}
+
+void hfp_lc3_decoder_cleanup(void) {
+  if (hfp_lc3_decoder_mem) osi_free_and_reset(&hfp_lc3_decoder_mem);
+  hfp_lc3_decoder = nullptr;
+}
+
+bool hfp_lc3_decoder_decode_packet(const uint8_t* i_buf, int16_t* o_buf,
+                                   size_t out_len) {
+  if (hfp_lc3_decoder == nullptr) {
+    LOG_ERROR("%s: The decoder is not initialized", __func__);
+    return false;
+  }
+
+  if (o_buf == nullptr || out_len < HFP_LC3_PCM_BYTES) {
+    LOG_ERROR(
+        "Output buffer's size %lu is less than one complete LC3 frame %d",
+        (unsigned long)out_len, HFP_LC3_PCM_BYTES);
+    return false;
+  }
+
+  /* A nullptr input makes the decoder conceal the frame. It only fails on
+   * wrong parameters. */
+  int rc = lc3_decode(hfp_lc3_decoder,
+                      i_buf ? i_buf + HFP_LC3_H2_HEADER_LEN : nullptr,
+                      HFP_LC3_PKT_FRAME_LEN, LC3_PCM_FORMAT_S16, o_buf, 1);
+  if (rc < 0) {
+    LOG_ERROR("Decoding failure: %d", rc);
+    return false;
+  }
+
+  return true;
+}
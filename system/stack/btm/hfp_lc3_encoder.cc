@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "hfp_lc3_encoder"
+
+#include "hfp_lc3_encoder.h"
+
+#include "embdrv/lc3/include/lc3.h"
+#include "osi/include/allocator.h"
+#include "osi/include/log.h"
+
+#define HFP_LC3_PKT_FRAME_LEN 58 /* Packet length without the header */
+
+/* HFP 1.9 LC3-SWB: 7.5 ms frames of 32 kHz mono audio */
+#define HFP_LC3_FRAME_DURATION_US 7500
+#define HFP_LC3_SAMPLE_RATE_HZ 32000
+
+static void* hfp_lc3_encoder_mem = nullptr;
+static lc3_encoder_t hfp_lc3_encoder = nullptr;
+
+void hfp_lc3_encoder_init() {
+  if (hfp_lc3_encoder_mem) {
+    LOG_WARN("%s: The encoder instance should have been released", __func__);
+    osi_free(hfp_lc3_encoder_mem);
+  }
+
+  hfp_lc3_encoder_mem = osi_malloc(lc3_encoder_size(
+      HFP_LC3_FRAME_DURATION_US, HFP_LC3_SAMPLE_RATE_HZ));
+  hfp_lc3_encoder =
+      lc3_setup_encoder(HFP_LC3_FRAME_DURATION_US, HFP_LC3_SAMPLE_RATE_HZ,
+                        HFP_LC3_SAMPLE_RATE_HZ, hfp_lc3_encoder_mem);
+  if (hfp_lc3_encoder == nullptr) {
+    LOG_ERROR("%s: lc3_setup_encoder failed", __func__);
+    osi_free_and_reset(&hfp_lc3_encoder_mem);
+  }
+}
+
+void hfp_lc3_encoder_cleanup(void) {
+  if (hfp_lc3_encoder_mem) osi_free_and_reset(&hfp_lc3_encoder_mem);
+  hfp_lc3_encoder = nullptr;
+}
+
+uint32_t hfp_lc3_encode_frames(int16_t* input, uint8_t* output) {
+  if (hfp_lc3_encoder == nullptr) {
+    LOG_ERROR("%s: The encoder is not initialized", __func__);
+    return 0;
+  }
+
+  if (lc3_encode(hfp_lc3_encoder, LC3_PCM_FORMAT_S16, input, 1,
+                 HFP_LC3_PKT_FRAME_LEN, output) != 0) {
+    LOG_ERROR("%s: lc3_encode failed", __func__);
+    return 0;
+  }
+
+  return HFP_LC3_PKT_FRAME_LEN;
+}
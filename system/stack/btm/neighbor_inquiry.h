@@ -172,6 +172,9 @@ typedef struct {
   tBTM_INQ_INFO inq_info;
   bool in_use;
   bool scan_rsp;
+  int8_t reported_rssi;     /* RSSI of the last result given to the caller */
+  size_t reported_eir_hash; /* hash of the EIR of the last result given to */
+                            /* the caller, 0 if none                       */
 } tINQ_DB_ENT;
 
 typedef struct /* contains the parameters passed to the inquiry functions */
@@ -35,6 +35,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "stack/include/acl_hci_link_interface.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btu.h"
@@ -42,6 +43,13 @@
 using bluetooth::common::MessageLoopThread;
 using bluetooth::hci::IsoManager;
 
+/* Set to true to record the queueing delay and run time of the tasks of the
+ * main thread, shown by dumpsys */
+#ifndef PROPERTY_MAIN_THREAD_TASK_PROFILING
+#define PROPERTY_MAIN_THREAD_TASK_PROFILING \
+  "persist.bluetooth.main_thread_task_profiling"
+#endif
+
 void btm_route_sco_data(BT_HDR* p_msg);
 
 /* Define BTU storage area */
@@ -120,13 +128,16 @@ void main_thread_start_up() {
   if (!main_thread.IsRunning()) {
     LOG(FATAL) << __func__ << ": unable to start btu message loop thread.";
   }
-  if (!main_thread.EnableRealTimeScheduling()) {
+  if (!main_thread.ApplySchedulingPolicy(true)) {
 #if defined(__ANDROID__)
     LOG(FATAL) << __func__ << ": unable to enable real time scheduling";
 #else
     LOG(ERROR) << __func__ << ": unable to enable real time scheduling";
 #endif
   }
+  if (osi_property_get_bool(PROPERTY_MAIN_THREAD_TASK_PROFILING, false)) {
+    main_thread.EnableTaskProfiling(true);
+  }
 }
 
 void main_thread_shut_down() { main_thread.ShutDown(); }
@@ -46,6 +46,18 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#define AES_HW_X86
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#define AES_HW_ARM64
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
 /* define if you have fast 32-bit types on your system */
 #if 1
 #define HAVE_UINT_32T
@@ -527,6 +539,151 @@ static void inv_mix_sub_columns(uint_8t dt[N_BLOCK], uint_8t st[N_BLOCK]) {
       is_box(gfm_b(st[12]) ^ gfm_d(st[13]) ^ gfm_9(st[14]) ^ gfm_e(st[15]));
 }
 
+/*  AES instructions of the CPU (AES-NI, ARMv8 Cryptography Extension)
+
+    When the CPU has them, they replace the table based code above for the
+    key expansion of 128 bit keys and for encryption. Unlike the table
+    lookups they take the same time whatever the key and the data. They use
+    the same key schedule as the table based code, so decryption still works
+    with a context set up by them.
+*/
+
+#if defined(AES_HW_X86) || defined(AES_HW_ARM64)
+#define AES_HW
+
+static bool aes_hw_disabled;
+
+static bool aes_hw_supported(void) {
+#if defined(AES_HW_X86)
+  unsigned int eax, ebx, ecx, edx;
+  return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_AES) &&
+         (edx & bit_SSE2);
+#else
+  return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#endif
+}
+
+static bool aes_hw(void) {
+  static const bool supported = aes_hw_supported();
+  return supported && !aes_hw_disabled;
+}
+
+#if defined(AES_HW_X86)
+#define AES_HW_TARGET __attribute__((target("aes,sse2")))
+
+AES_HW_TARGET static inline __m128i aes_hw_expand_128(__m128i key,
+                                                      __m128i assist) {
+  assist = _mm_shuffle_epi32(assist, _MM_SHUFFLE(3, 3, 3, 3));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+
+/* the round constant must be an immediate operand of aeskeygenassist */
+#define aes_hw_expand_round(k, rc) \
+  aes_hw_expand_128(k, _mm_aeskeygenassist_si128(k, rc))
+
+AES_HW_TARGET static void aes_hw_set_key_128(const uint_8t key[N_BLOCK],
+                                             uint_8t ksch[11 * N_BLOCK]) {
+  __m128i rk[11];
+  int i;
+
+  rk[0] = _mm_loadu_si128((const __m128i*)key);
+  rk[1] = aes_hw_expand_round(rk[0], 0x01);
+  rk[2] = aes_hw_expand_round(rk[1], 0x02);
+  rk[3] = aes_hw_expand_round(rk[2], 0x04);
+  rk[4] = aes_hw_expand_round(rk[3], 0x08);
+  rk[5] = aes_hw_expand_round(rk[4], 0x10);
+  rk[6] = aes_hw_expand_round(rk[5], 0x20);
+  rk[7] = aes_hw_expand_round(rk[6], 0x40);
+  rk[8] = aes_hw_expand_round(rk[7], 0x80);
+  rk[9] = aes_hw_expand_round(rk[8], 0x1b);
+  rk[10] = aes_hw_expand_round(rk[9], 0x36);
+  for (i = 0; i < 11; ++i)
+    _mm_storeu_si128((__m128i*)(ksch + i * N_BLOCK), rk[i]);
+}
+
+AES_HW_TARGET static void aes_hw_encrypt(const uint_8t in[N_BLOCK],
+                                         uint_8t out[N_BLOCK],
+                                         const uint_8t* ksch, uint_8t rnd) {
+  __m128i s = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in),
+                            _mm_loadu_si128((const __m128i*)ksch));
+  uint_8t r;
+
+  for (r = 1; r < rnd; ++r)
+    s = _mm_aesenc_si128(s,
+                         _mm_loadu_si128((const __m128i*)(ksch + r * N_BLOCK)));
+  s = _mm_aesenclast_si128(
+      s, _mm_loadu_si128((const __m128i*)(ksch + rnd * N_BLOCK)));
+  _mm_storeu_si128((__m128i*)out, s);
+}
+
+#else /* AES_HW_ARM64 */
+#if defined(__clang__)
+#define AES_HW_TARGET __attribute__((target("aes")))
+#else
+#define AES_HW_TARGET __attribute__((target("+crypto")))
+#endif
+
+/* SubWord() with AESE: all the columns of the state are the same word, so
+   that ShiftRows() leaves it unchanged */
+AES_HW_TARGET static inline uint_32t aes_hw_sub_word(uint_32t w) {
+  uint8x16_t s = vreinterpretq_u8_u32(vdupq_n_u32(w));
+  s = vaeseq_u8(s, vdupq_n_u8(0));
+  return vgetq_lane_u32(vreinterpretq_u32_u8(s), 0);
+}
+
+AES_HW_TARGET static void aes_hw_set_key_128(const uint_8t key[N_BLOCK],
+                                             uint_8t ksch[11 * N_BLOCK]) {
+  static const uint_8t rcon[10] = {0x01, 0x02, 0x04, 0x08, 0x10,
+                                   0x20, 0x40, 0x80, 0x1b, 0x36};
+  uint_32t w[44];
+  int i;
+
+  memcpy(w, key, N_BLOCK);
+  for (i = 4; i < 44; ++i) {
+    uint_32t t = w[i - 1];
+    if (i % 4 == 0) {
+      /* RotWord() of a little endian word */
+      t = aes_hw_sub_word(t);
+      t = ((t >> 8) | (t << 24)) ^ rcon[i / 4 - 1];
+    }
+    w[i] = w[i - 4] ^ t;
+  }
+  memcpy(ksch, w, sizeof(w));
+}
+
+AES_HW_TARGET static void aes_hw_encrypt(const uint_8t in[N_BLOCK],
+                                         uint_8t out[N_BLOCK],
+                                         const uint_8t* ksch, uint_8t rnd) {
+  uint8x16_t s = vld1q_u8(in);
+  uint_8t r;
+
+  for (r = 0; r + 1 < rnd; ++r)
+    s = vaesmcq_u8(vaeseq_u8(s, vld1q_u8(ksch + r * N_BLOCK)));
+  s = vaeseq_u8(s, vld1q_u8(ksch + r * N_BLOCK));
+  s = veorq_u8(s, vld1q_u8(ksch + rnd * N_BLOCK));
+  vst1q_u8(out, s);
+}
+
+#endif
+#endif
+
+bool aes_hw_is_enabled(void) {
+#if defined(AES_HW)
+  return aes_hw();
+#else
+  return false;
+#endif
+}
+
+void aes_hw_set_enabled(bool enabled) {
+#if defined(AES_HW)
+  aes_hw_disabled = !enabled;
+#endif
+}
+
 #if defined(AES_ENC_PREKEYED) || defined(AES_DEC_PREKEYED)
 
 /*  Set the cipher key for the pre-keyed version */
@@ -557,6 +714,13 @@ return_type aes_set_key(const unsigned char key[], length_type keylen,
       ctx->rnd = 0;
       return (return_type)-1;
   }
+#if defined(AES_HW)
+  if (keylen == 16 && aes_hw()) {
+    aes_hw_set_key_128(key, ctx->ksch);
+    ctx->rnd = 10;
+    return 0;
+  }
+#endif
   block_copy_nn(ctx->ksch, key, keylen);
   hi = (keylen + 28) << 2;
   ctx->rnd = (hi >> 4) - 1;
@@ -597,6 +761,12 @@ return_type aes_set_key(const unsigned char key[], length_type keylen,
 
 return_type aes_encrypt(const unsigned char in[N_BLOCK],
                         unsigned char out[N_BLOCK], const aes_context ctx[1]) {
+#if defined(AES_HW)
+  if (ctx->rnd && aes_hw()) {
+    aes_hw_encrypt(in, out, ctx->ksch, ctx->rnd);
+    return 0;
+  }
+#endif
   if (ctx->rnd) {
     uint_8t s1[N_BLOCK], r;
     copy_and_key(s1, in, ctx->ksch);
@@ -104,6 +104,14 @@ return_type aes_cbc_decrypt(const unsigned char* in, unsigned char* out,
                             const aes_context ctx[1]);
 #endif
 
+/*  Whether aes_set_key() and aes_encrypt() use the AES instructions of the
+    CPU, see aes.cc. Tests and benchmarks can turn them off to run the table
+    based code instead.
+*/
+
+bool aes_hw_is_enabled(void);
+void aes_hw_set_enabled(bool enabled);
+
 /*  The following calls are for 'on the fly' keying.  In this case the
     encryption and decryption keys are different.
 
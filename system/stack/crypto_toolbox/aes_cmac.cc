@@ -60,23 +60,57 @@ static void xor_128(Octet16* a, const Octet16& b) {
 }
 }  // namespace
 
-/* This function computes AES_128(key, message) */
-Octet16 aes_128(const Octet16& key, const Octet16& message) {
+/** utility function to expand the key schedule of |key|, in little endian
+ * order, once for all the blocks encrypted with it. */
+static void aes_128_set_key(const Octet16& key, aes_context* ctx) {
   Octet16 key_reversed;
+  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+  aes_set_key(key_reversed.data(), key_reversed.size(), ctx);
+}
+
+/** utility function to compute AES_128 of |message|, in little endian order,
+ * with a key schedule from aes_128_set_key(). */
+static Octet16 aes_128_encrypt(const aes_context& ctx, const Octet16& message) {
   Octet16 message_reversed;
   Octet16 output;
 
-  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
   std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
-
-  aes_context ctx;
-  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
   aes_encrypt(message_reversed.data(), output.data(), &ctx);
 
   std::reverse(output.begin(), output.end());
   return output;
 }
 
+/* This function computes AES_128(key, message) */
+Octet16 aes_128(const Octet16& key, const Octet16& message) {
+  aes_context ctx;
+  aes_128_set_key(key, &ctx);
+  return aes_128_encrypt(ctx, message);
+}
+
+struct Aes128::Context {
+  aes_context ctx;
+};
+
+Aes128::Aes128(const Octet16& key) : context_(std::make_unique<Context>()) {
+  aes_128_set_key(key, &context_->ctx);
+}
+
+Aes128::Aes128(Aes128&& other) = default;
+Aes128& Aes128::operator=(Aes128&& other) = default;
+Aes128::~Aes128() = default;
+
+Octet16 Aes128::Encrypt(const Octet16& message) const {
+  return aes_128_encrypt(context_->ctx, message);
+}
+
+Octet16 Aes128::Encrypt(const uint8_t* message, uint8_t length) const {
+  CHECK(length <= OCTET16_LEN) << "you tried aes_128 more than 16 bytes!";
+  Octet16 msg{0};
+  std::copy(message, message + length, msg.begin());
+  return Encrypt(msg);
+}
+
 /** utility function to padding the given text to be a 128 bits data. The
  * parameter dest is input and output parameter, it must point to a
  * OCTET16_LEN memory space; where include length bytes valid data. */
@@ -101,7 +135,7 @@ static void leftshift_onebit(uint8_t* input, uint8_t* output) {
 }
 
 /** This function is the calculation of block cipher using AES-128. */
-static Octet16 cmac_aes_k_calculate(const Octet16& key) {
+static Octet16 cmac_aes_k_calculate(const aes_context& ctx) {
   Octet16 output;
   Octet16 x{0};  // zero initialized
 
@@ -112,8 +146,8 @@ static Octet16 cmac_aes_k_calculate(const Octet16& key) {
     /* Mi' := Mi (+) X  */
     xor_128((Octet16*)&cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN], x);
 
-    output = aes_128(key, &cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN],
-                     OCTET16_LEN);
+    output = aes_128_encrypt(
+        ctx, *(Octet16*)&cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN]);
     x = output;
     i++;
   }
@@ -145,13 +179,13 @@ static void cmac_prepare_last_block(const Octet16& k1, const Octet16& k2) {
 }
 
 /** This is the function to generate the two subkeys.
- * |key| is CMAC key, expect SRK when used by SMP.
+ * |ctx| is the key schedule of the CMAC key, expect SRK when used by SMP.
  */
-static void cmac_generate_subkey(const Octet16& key) {
+static void cmac_generate_subkey(const aes_context& ctx) {
   DVLOG(2) << __func__;
 
   Octet16 zero{};
-  Octet16 p = aes_128(key, zero.data(), OCTET16_LEN);
+  Octet16 p = aes_128_encrypt(ctx, zero);
 
   Octet16 k1, k2;
   uint8_t* pp = p.data();
@@ -205,10 +239,14 @@ Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
     cmac_cb.len = 0;
   }
 
+  /* the key schedule is expanded once for the subkeys and all the blocks */
+  aes_context ctx;
+  aes_128_set_key(key, &ctx);
+
   /* prepare calculation for subkey s and last block of data */
-  cmac_generate_subkey(key);
+  cmac_generate_subkey(ctx);
   /* start calculation */
-  Octet16 signature = cmac_aes_k_calculate(key);
+  Octet16 signature = cmac_aes_k_calculate(ctx);
 
   /* clean up */
   memset(&cmac_cb, 0, sizeof(tCMAC_CB));
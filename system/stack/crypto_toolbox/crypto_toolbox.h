@@ -17,6 +17,8 @@
 #pragma once
 #include <base/logging.h>
 
+#include <memory>
+
 #include "check.h"
 #include "stack/include/bt_octets.h"
 #include "stack/include/bt_types.h"
@@ -48,6 +50,25 @@ inline Octet16 aes_128(const Octet16& key, const uint8_t* message,
   return aes_128(key, msg);
 }
 
+/* AES_128 with the key schedule of |key| expanded once, to encrypt many
+ * messages with the same key, e.g. when resolving RPAs with the IRK of each
+ * bonded device */
+class Aes128 {
+ public:
+  explicit Aes128(const Octet16& key);
+  Aes128(Aes128&& other);
+  Aes128& operator=(Aes128&& other);
+  ~Aes128();
+
+  Octet16 Encrypt(const Octet16& message) const;
+  /* |message| can be at most 16 bytes long, same as aes_128() */
+  Octet16 Encrypt(const uint8_t* message, uint8_t length) const;
+
+ private:
+  struct Context;
+  std::unique_ptr<Context> context_;
+};
+
 // |tlen| - lenth of mac desired
 // |p_signature| - data pointer to where signed data to be stored, tlen long.
 inline void aes_cmac(const Octet16& key, const uint8_t* message,
@@ -16,6 +16,7 @@
  */
 
 #include "eatt_impl.h"
+#include "main/shim/dumpsys.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/l2cap/l2c_int.h"
 #include "types/raw_address.h"
@@ -185,6 +186,47 @@ EattChannel* EattExtension::GetChannelAvailableForClientRequest(
   return pimpl_->eatt_impl_->get_channel_available_for_client_request(bd_addr);
 }
 
+EattChannel* EattExtension::GetChannelAvailableForLongClientRequest(
+    const RawAddress& bd_addr) {
+  return pimpl_->eatt_impl_->get_channel_available_for_long_client_request(
+      bd_addr);
+}
+
+EattChannel* EattExtension::GetChannelAvailableForNotification(
+    const RawAddress& bd_addr, uint16_t last_cid, uint16_t* queued) {
+  return pimpl_->eatt_impl_->get_channel_available_for_notification(
+      bd_addr, last_cid, queued);
+}
+
+#define DUMPSYS_TAG "stack::eatt"
+void EattExtension::Dump(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+  if (!pimpl_->IsRunning()) return;
+
+  for (const eatt_device& eatt_dev : pimpl_->eatt_impl_->devices_) {
+    if (eatt_dev.eatt_channels.empty()) continue;
+
+    LOG_DUMPSYS(fd,
+                "  peer:%s channels:%zu max:%hhu rx_mtu:%hu "
+                "last_period_uses:%u large_values:%u",
+                ADDRESS_TO_LOGGABLE_CSTR(eatt_dev.bda_),
+                eatt_dev.eatt_channels.size(), eatt_dev.max_channels_,
+                eatt_dev.rx_mtu_, eatt_dev.window_use_count_,
+                eatt_dev.window_large_value_count_);
+    for (const auto& el : eatt_dev.eatt_channels) {
+      const EattChannel* channel = el.second.get();
+      LOG_DUMPSYS(fd,
+                  "    cid:0x%04x state:%hhu tx_mtu:%hu rx_mtu:%hu uses:%u "
+                  "large_values:%u cl_cmd_queued:%zu l2cap_queued:%hu",
+                  el.first, static_cast<uint8_t>(channel->state_),
+                  channel->tx_mtu_, channel->rx_mtu_, channel->use_count_,
+                  channel->large_value_count_, channel->cl_cmd_q_.size(),
+                  L2CA_FlushChannel(el.first, L2CAP_FLUSH_CHANS_GET));
+    }
+  }
+}
+#undef DUMPSYS_TAG
+
 /* Start stop GATT indication timer per CID */
 void EattExtension::StartIndicationConfirmationTimer(const RawAddress& bd_addr,
                                                      uint16_t cid) {
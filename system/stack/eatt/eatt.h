@@ -28,6 +28,15 @@
 #define EATT_MAX_TX_MTU  (1024)
 #define EATT_ALL_CIDS (0xFFFF)
 
+/* Opened channels kept on a connection, even when they are idle */
+#define EATT_MIN_CHANNELS (1)
+/* Buffers queued on the notification channel from which a channel is added */
+#define EATT_NOTIF_BACKLOG_THRESHOLD (4)
+/* Large values in a check period from which the MTU may be raised */
+#define EATT_LARGE_VALUE_MIN_COUNT (8)
+/* Period of the check of the idle channels and of the large values */
+#define EATT_LOAD_CHECK_PERIOD_MS (30000)
+
 namespace bluetooth {
 namespace eatt {
 
@@ -57,6 +66,12 @@ class EattChannel {
   alarm_t* ind_confirmation_timer_;
   /* GATT client command queue */
   std::deque<tGATT_CMD_Q> cl_cmd_q_;
+  /* Times the channel was picked by GATT or received a PDU */
+  uint32_t use_count_;
+  /* Of those, the PDUs filling the MTU and the long client requests */
+  uint32_t large_value_count_;
+  /* use_count_ at the last check of the idle channels */
+  uint32_t use_count_at_check_;
 
   EattChannel(RawAddress& bda, uint16_t cid, uint16_t tx_mtu, uint16_t rx_mtu)
       : bda_(bda),
@@ -65,7 +80,10 @@ class EattChannel {
         state_(EattChannelState::EATT_CHANNEL_PENDING),
         indicate_handle_(0),
         ind_ack_timer_(NULL),
-        ind_confirmation_timer_(NULL) {
+        ind_confirmation_timer_(NULL),
+        use_count_(0),
+        large_value_count_(0),
+        use_count_at_check_(0) {
     cl_cmd_q_ = std::deque<tGATT_CMD_Q>();
     EattChannelSetTxMTU(tx_mtu);
   }
@@ -128,6 +146,10 @@ class EattExtension {
   /**
    * Connect at maximum 5 EATT channels to peer device.
    *
+   * When Android is the central, the idle channels are closed later on, and
+   * channels are added again while GATT has more to send than the opened
+   * ones can carry, up to the number the peer accepted.
+   *
    * @param bd_addr peer device address
    */
   virtual void Connect(const RawAddress& bd_addr);
@@ -243,6 +265,44 @@ class EattExtension {
   virtual EattChannel* GetChannelAvailableForClientRequest(
       const RawAddress& bd_addr);
 
+  /**
+   * Get EATT channel available to send a GATT request whose value may take
+   * several requests, like a long read or a prepared write.
+   *
+   * Among the channels available for a request, it is the one with the
+   * largest MTU, so that the value takes the fewest round trips.
+   *
+   * @param bd_addr peer device address
+   *
+   * @return pointer to EATT channel.
+   */
+  virtual EattChannel* GetChannelAvailableForLongClientRequest(
+      const RawAddress& bd_addr);
+
+  /**
+   * Get EATT channel to send a notification on.
+   *
+   * The channel of the previous notification of the attribute is kept while
+   * it still has buffers queued in L2CAP, so that the notifications of an
+   * attribute reach the peer in order. Otherwise it is the opened channel
+   * with the fewest buffers queued.
+   *
+   * @param bd_addr peer device address
+   * @param last_cid channel of the previous notification of the attribute
+   * @param queued set to the number of buffers queued on the channel
+   *
+   * @return pointer to EATT channel.
+   */
+  virtual EattChannel* GetChannelAvailableForNotification(
+      const RawAddress& bd_addr, uint16_t last_cid, uint16_t* queued);
+
+  /**
+   * Dump the EATT channels of each peer device, with their utilization.
+   *
+   * @param fd file descriptor to write to
+   */
+  virtual void Dump(int fd);
+
   /**
    * Start GATT indication timer per CID.
    *
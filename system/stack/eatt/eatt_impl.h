@@ -52,8 +52,19 @@ class eatt_device {
 
   std::map<uint16_t, std::shared_ptr<EattChannel>> eatt_channels;
   bool collision;
+  /* Channels accepted by the peer, no more are added under load */
+  uint8_t max_channels_;
+  /* Channel uses since the last check of the channels load */
+  uint32_t window_use_count_;
+  uint32_t window_large_value_count_;
   eatt_device(const RawAddress& bd_addr, uint16_t mtu, uint16_t mps)
-      : rx_mtu_(mtu), rx_mps_(mps), eatt_tcb_(nullptr), collision(false) {
+      : rx_mtu_(mtu),
+        rx_mps_(mps),
+        eatt_tcb_(nullptr),
+        collision(false),
+        max_channels_(L2CAP_CREDIT_BASED_MAX_CIDS),
+        window_use_count_(0),
+        window_large_value_count_(0) {
     bda_ = bd_addr;
   }
 };
@@ -64,14 +75,16 @@ struct eatt_impl {
   uint16_t default_mtu_;
   uint16_t max_mps_;
   tL2CAP_APPL_INFO reg_info_;
+  alarm_t* load_check_timer_;
 
   eatt_impl() {
     default_mtu_ = EATT_DEFAULT_MTU;
     max_mps_ = EATT_MIN_MTU_MPS;
     psm_ = BT_PSM_EATT;
+    load_check_timer_ = alarm_new("eatt_load_check_timer");
   };
 
-  ~eatt_impl() = default;
+  ~eatt_impl() { alarm_free(load_check_timer_); }
 
   eatt_device* find_device_by_cid(uint16_t lcid) {
     /* This works only because Android CIDs are unique across the ACL
@@ -102,6 +115,138 @@ struct eatt_impl {
     return false;
   }
 
+  size_t count_opened_channels(const eatt_device* eatt_dev) {
+    return std::count_if(
+        eatt_dev->eatt_channels.begin(), eatt_dev->eatt_channels.end(),
+        [](const std::pair<uint16_t, std::shared_ptr<EattChannel>>& el) {
+          return el.second->state_ == EattChannelState::EATT_CHANNEL_OPENED;
+        });
+  }
+
+  /* The number of channels follows the load only when Android is the
+   * central, as it is the one connecting EATT. */
+  bool is_load_adaptive(const eatt_device* eatt_dev) {
+    return !stack_config_get_interface()->get_pts_l2cap_ecoc_upper_tester() &&
+           L2CA_GetBleConnRole(eatt_dev->bda_) == HCI_ROLE_CENTRAL;
+  }
+
+  void schedule_load_check() {
+    if (alarm_is_scheduled(load_check_timer_)) return;
+    alarm_set_on_mloop(load_check_timer_, EATT_LOAD_CHECK_PERIOD_MS,
+                       eatt_load_check_timeout, this);
+  }
+
+  void count_channel_use(eatt_device* eatt_dev, EattChannel* channel,
+                         bool large_value) {
+    channel->use_count_++;
+    eatt_dev->window_use_count_++;
+    if (large_value) {
+      channel->large_value_count_++;
+      eatt_dev->window_large_value_count_++;
+    }
+    schedule_load_check();
+  }
+
+  /* Called when GATT has more to send than the opened channels can carry */
+  void add_channel_if_needed(eatt_device* eatt_dev) {
+    if (!is_load_adaptive(eatt_dev)) return;
+    if (eatt_dev->eatt_channels.size() >= eatt_dev->max_channels_) return;
+    if (count_opened_channels(eatt_dev) == 0 ||
+        is_channel_connection_pending(eatt_dev))
+      return;
+
+    LOG_INFO("Device %s, adding a channel to the %zu opened ones",
+             ADDRESS_TO_LOGGABLE_CSTR(eatt_dev->bda_),
+             count_opened_channels(eatt_dev));
+    connect_eatt(eatt_dev, 1);
+  }
+
+  /* The peer refused some of the requested channels, do not ask for more of
+   * them when the load grows. */
+  void limit_channels(eatt_device* eatt_dev) {
+    if (eatt_dev->eatt_channels.empty()) return;
+    eatt_dev->max_channels_ = std::min<size_t>(eatt_dev->max_channels_,
+                                               eatt_dev->eatt_channels.size());
+  }
+
+  bool is_channel_idle(uint16_t cid, const EattChannel* channel) {
+    return channel->state_ == EattChannelState::EATT_CHANNEL_OPENED &&
+           channel->use_count_ == channel->use_count_at_check_ &&
+           channel->cl_cmd_q_.empty() &&
+           channel->server_outstanding_cmd_.op_code == 0 &&
+           !GATT_HANDLE_IS_VALID(channel->indicate_handle_) &&
+           !alarm_is_scheduled(channel->ind_ack_timer_) &&
+           L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET) == 0;
+  }
+
+  void close_idle_channels(eatt_device* eatt_dev) {
+    std::vector<uint16_t> idle_cids;
+    for (auto& el : eatt_dev->eatt_channels) {
+      if (is_channel_idle(el.first, el.second.get()))
+        idle_cids.push_back(el.first);
+      el.second->use_count_at_check_ = el.second->use_count_;
+    }
+
+    size_t num_of_opened = count_opened_channels(eatt_dev);
+    for (uint16_t cid : idle_cids) {
+      if (num_of_opened <= EATT_MIN_CHANNELS) break;
+
+      LOG_INFO("Device %s, closing idle cid 0x%04x",
+               ADDRESS_TO_LOGGABLE_CSTR(eatt_dev->bda_), cid);
+      disconnect_channel(cid);
+      eatt_dev->eatt_tcb_->eatt--;
+      remove_channel_by_cid(eatt_dev, cid);
+      num_of_opened--;
+    }
+  }
+
+  /* When most of the PDUs fill the MTU, or are parts of long values, let the
+   * peer send larger ones. The MTU of a channel can only be increased. */
+  void raise_mtu_if_large_values(eatt_device* eatt_dev) {
+    if (eatt_dev->window_large_value_count_ < EATT_LARGE_VALUE_MIN_COUNT ||
+        2 * eatt_dev->window_large_value_count_ < eatt_dev->window_use_count_)
+      return;
+
+    uint16_t mtu = eatt_dev->rx_mtu_;
+    for (auto& el : eatt_dev->eatt_channels) {
+      /* Wait for the channels being connected or reconfigured */
+      if (el.second->state_ != EattChannelState::EATT_CHANNEL_OPENED) return;
+      mtu = std::max(mtu, el.second->rx_mtu_);
+    }
+    if (mtu >= GATT_MAX_MTU_SIZE) return;
+
+    uint16_t new_mtu = std::min<uint16_t>(2 * mtu, GATT_MAX_MTU_SIZE);
+    LOG_INFO("Device %s, %u of %u PDUs carried large values, new mtu %d",
+             ADDRESS_TO_LOGGABLE_CSTR(eatt_dev->bda_),
+             eatt_dev->window_large_value_count_, eatt_dev->window_use_count_,
+             new_mtu);
+    eatt_dev->rx_mtu_ = new_mtu;
+    reconfigure_all(eatt_dev->bda_, new_mtu);
+  }
+
+  void check_channels_load() {
+    bool keep_checking = false;
+    for (eatt_device& eatt_dev : devices_) {
+      if (eatt_dev.eatt_channels.empty() || !is_load_adaptive(&eatt_dev))
+        continue;
+
+      close_idle_channels(&eatt_dev);
+      raise_mtu_if_large_values(&eatt_dev);
+      eatt_dev.window_use_count_ = 0;
+      eatt_dev.window_large_value_count_ = 0;
+
+      if (count_opened_channels(&eatt_dev) > EATT_MIN_CHANNELS)
+        keep_checking = true;
+    }
+
+    if (keep_checking) schedule_load_check();
+  }
+
+  static void eatt_load_check_timeout(void* data) {
+    eatt_impl* p_eatt_impl = (eatt_impl*)data;
+    p_eatt_impl->check_channels_load();
+  }
+
   EattChannel* find_channel_by_cid(const RawAddress& bdaddr, uint16_t lcid) {
     eatt_device* eatt_dev = find_device_by_address(bdaddr);
     if (!eatt_dev) return nullptr;
@@ -406,6 +551,7 @@ struct eatt_impl {
       LOG(ERROR) << __func__
                  << " Could not connect CoC result: " << loghex(result);
       remove_channel_by_cid(eatt_dev, lcid);
+      limit_channels(eatt_dev);
 
       /* If there is no channels connected, check if there was collision */
       if (!is_channel_connection_pending(eatt_dev)) {
@@ -498,6 +644,7 @@ struct eatt_impl {
       case EattChannelState::EATT_CHANNEL_PENDING:
         LOG(ERROR) << "Connecting failed";
         remove_channel_by_cid(eatt_dev, lcid);
+        limit_channels(eatt_dev);
         break;
       case EattChannelState::EATT_CHANNEL_RECONFIGURING:
         /* Just go back to open state */
@@ -542,6 +689,7 @@ struct eatt_impl {
       return;
     }
 
+    count_channel_use(eatt_dev, channel, data_p->len >= channel->rx_mtu_);
     gatt_data_process(*eatt_dev->eatt_tcb_, channel->cid_, data_p);
     osi_free(data_p);
   }
@@ -694,8 +842,73 @@ struct eatt_impl {
                  el.second->cl_cmd_q_.empty();
         });
 
-    return (iter == eatt_dev->eatt_channels.end()) ? nullptr
-                                                   : iter->second.get();
+    if (iter == eatt_dev->eatt_channels.end()) {
+      /* The request waits for one of the channels in use */
+      add_channel_if_needed(eatt_dev);
+      return nullptr;
+    }
+
+    count_channel_use(eatt_dev, iter->second.get(), false);
+    return iter->second.get();
+  }
+
+  EattChannel* get_channel_available_for_long_client_request(
+      const RawAddress& bd_addr) {
+    eatt_device* eatt_dev = find_device_by_address(bd_addr);
+    if (!eatt_dev) return nullptr;
+
+    EattChannel* channel = nullptr;
+    for (auto& el : eatt_dev->eatt_channels) {
+      if (el.second->state_ != EattChannelState::EATT_CHANNEL_OPENED ||
+          !el.second->cl_cmd_q_.empty())
+        continue;
+
+      if (channel == nullptr ||
+          std::min(el.second->tx_mtu_, el.second->rx_mtu_) >
+              std::min(channel->tx_mtu_, channel->rx_mtu_)) {
+        channel = el.second.get();
+      }
+    }
+
+    if (channel) count_channel_use(eatt_dev, channel, true);
+    return channel;
+  }
+
+  EattChannel* get_channel_available_for_notification(
+      const RawAddress& bd_addr, uint16_t last_cid, uint16_t* queued) {
+    eatt_device* eatt_dev = find_device_by_address(bd_addr);
+    if (!eatt_dev) return nullptr;
+
+    auto last = eatt_dev->eatt_channels.find(last_cid);
+    if (last != eatt_dev->eatt_channels.end() &&
+        last->second->state_ == EattChannelState::EATT_CHANNEL_OPENED) {
+      *queued = L2CA_FlushChannel(last_cid, L2CAP_FLUSH_CHANS_GET);
+      if (*queued > 0) {
+        count_channel_use(eatt_dev, last->second.get(), false);
+        return last->second.get();
+      }
+    }
+
+    EattChannel* channel = nullptr;
+    for (auto& el : eatt_dev->eatt_channels) {
+      if (el.second->state_ != EattChannelState::EATT_CHANNEL_OPENED) continue;
+
+      uint16_t channel_queued =
+          L2CA_FlushChannel(el.first, L2CAP_FLUSH_CHANS_GET);
+      if (channel == nullptr || channel_queued < *queued) {
+        channel = el.second.get();
+        *queued = channel_queued;
+      }
+      if (*queued == 0) break;
+    }
+
+    if (!channel) return nullptr;
+
+    /* Even the least busy channel has a backlog */
+    if (*queued >= EATT_NOTIF_BACKLOG_THRESHOLD)
+      add_channel_if_needed(eatt_dev);
+    count_channel_use(eatt_dev, channel, false);
+    return channel;
   }
 
   void free_gatt_resources(const RawAddress& bd_addr) {
@@ -950,6 +1163,7 @@ struct eatt_impl {
     eatt_dev->eatt_tcb_->eatt = 0;
     eatt_dev->eatt_tcb_ = nullptr;
     eatt_dev->collision = false;
+    eatt_dev->max_channels_ = L2CAP_CREDIT_BASED_MAX_CIDS;
   }
 
   void upper_tester_connect(const RawAddress& bd_addr, eatt_device* eatt_dev,
@@ -136,8 +136,8 @@ static BT_HDR* attp_build_browse_cmd(uint8_t op_code, uint16_t s_hdl,
                                      const bluetooth::Uuid& uuid) {
   const size_t payload_size =
       (GATT_OP_CODE_SIZE) + (GATT_START_END_HANDLE_SIZE) + (Uuid::kNumBytes128);
-  BT_HDR* p_buf =
-      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(
+      sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
 
   uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
   /* Describe the built message location and size */
@@ -165,8 +165,8 @@ static BT_HDR* attp_build_read_by_type_value_cmd(
     uint16_t payload_size, tGATT_FIND_TYPE_VALUE* p_value_type) {
   uint8_t* p;
   uint16_t len = p_value_type->value_len;
-  BT_HDR* p_buf =
-      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(
+      sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
 
   p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
   p_buf->offset = L2CAP_MIN_OFFSET;
@@ -282,8 +282,8 @@ static BT_HDR* attp_build_value_cmd(uint16_t payload_size, uint8_t op_code,
                                     uint16_t handle, uint16_t offset,
                                     uint16_t len, uint8_t* p_data) {
   uint8_t *p, *pp, pair_len, *p_pair_len;
-  BT_HDR* p_buf =
-      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(
+      sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
 
   p = pp = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
   UINT8_TO_STREAM(p, op_code);
@@ -354,6 +354,45 @@ tGATT_STATUS attp_send_msg_to_l2cap(tGATT_TCB& tcb, uint16_t lcid,
 }
 
 /** Build ATT Server PDUs */
+/*******************************************************************************
+ *
+ * Function         attp_build_multi_value_notif
+ *
+ * Description      Build a multiple handle value notification with as many of
+ *                  the notifications starting at |first| as fit in
+ *                  |payload_size|.
+ *
+ * Returns          Pointer to the PDU. The index of the first notification
+ *                  left out is stored in |p_next|.
+ *
+ ******************************************************************************/
+BT_HDR* attp_build_multi_value_notif(uint16_t payload_size,
+                                     const std::vector<tGATT_VALUE>& notifs,
+                                     size_t first, size_t* p_next) {
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc_packet(
+      sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+
+  uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  UINT8_TO_STREAM(p, GATT_HANDLE_MULTI_VALUE_NOTIF);
+  p_buf->offset = L2CAP_MIN_OFFSET;
+  p_buf->len = 1;
+
+  size_t i = first;
+  for (; i < notifs.size(); i++) {
+    const tGATT_VALUE& notif = notifs[i];
+    /* Handle and length of each value, which is never truncated */
+    if (p_buf->len + 4 + notif.len > payload_size) break;
+
+    UINT16_TO_STREAM(p, notif.handle);
+    UINT16_TO_STREAM(p, notif.len);
+    ARRAY_TO_STREAM(p, notif.value, notif.len);
+    p_buf->len += 4 + notif.len;
+  }
+
+  *p_next = i;
+  return p_buf;
+}
+
 BT_HDR* attp_build_sr_msg(tGATT_TCB& tcb, uint8_t op_code, tGATT_SR_MSG* p_msg,
                           uint16_t payload_size) {
   uint16_t offset = 0;
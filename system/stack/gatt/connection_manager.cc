@@ -23,11 +23,14 @@
 #include <base/location.h>
 #include <base/logging.h>
 
+#include <algorithm>
+#include <array>
 #include <map>
 #include <memory>
 #include <set>
 
 #include "bind_helpers.h"
+#include "common/time_util.h"
 #include "internal_include/bt_trace.h"
 #include "main/shim/le_scanning_manager.h"
 #include "main/shim/shim.h"
@@ -76,15 +79,116 @@ struct tAPPS_CONNECTING {
   std::set<tAPP_ID> doing_bg_conn;
   std::set<tAPP_ID> doing_targeted_announcements_conn;
   bool is_in_accept_list;
+  // The accept list is full, the device is added to it once there is room
+  bool is_waiting_for_accept_list;
 
   // Apps trying to do direct connection.
   std::map<tAPP_ID, unique_alarm_ptr> doing_direct_conn;
+  // Highest priority and earliest deadline of the direct connection attempts,
+  // and start of the first attempt
+  tCONN_PRIORITY direct_conn_priority;
+  uint64_t direct_conn_deadline_ms;
+  uint64_t direct_conn_start_ms;
 };
 
 namespace {
 // Maps address to apps trying to connect to it
 std::map<RawAddress, tAPPS_CONNECTING> bgconn_dev;
 
+// Upper bounds of the time to connect buckets, the last bucket is for the
+// longer times
+constexpr uint64_t kTimeToConnectBucketsMs[] = {500,  1000,  2000,
+                                                5000, 10000, 20000};
+constexpr size_t kNumTimeToConnectBuckets =
+    sizeof(kTimeToConnectBucketsMs) / sizeof(kTimeToConnectBucketsMs[0]) + 1;
+constexpr size_t kNumConnPriorities = CONN_PRIORITY_HIGH + 1;
+
+// Outcome of the direct connection attempts, for each priority
+struct {
+  std::array<std::array<size_t, kNumTimeToConnectBuckets>, kNumConnPriorities>
+      time_to_connect;
+  std::array<size_t, kNumConnPriorities> timed_out;
+  std::array<size_t, kNumConnPriorities> waited_for_accept_list;
+} direct_conn_stats;
+
+void record_time_to_connect(tCONN_PRIORITY priority, uint64_t duration_ms) {
+  size_t bucket = 0;
+  while (bucket < kNumTimeToConnectBuckets - 1 &&
+         duration_ms >= kTimeToConnectBucketsMs[bucket]) {
+    bucket++;
+  }
+  direct_conn_stats.time_to_connect[priority][bucket]++;
+}
+
+int num_of_devices_in_accept_list(void) {
+  return std::count_if(
+      bgconn_dev.begin(), bgconn_dev.end(),
+      [](const auto& pair) { return pair.second.is_in_accept_list; });
+}
+
+/* Whether |a| should get into the accept list before |b|: direct connections
+ * first, by priority then deadline, then background connections */
+bool is_first_to_get_into_accept_list(const tAPPS_CONNECTING& a,
+                                      const tAPPS_CONNECTING& b) {
+  bool a_is_direct = !a.doing_direct_conn.empty();
+  bool b_is_direct = !b.doing_direct_conn.empty();
+  if (a_is_direct != b_is_direct) return a_is_direct;
+  if (!a_is_direct) return false;
+  if (a.direct_conn_priority != b.direct_conn_priority) {
+    return a.direct_conn_priority > b.direct_conn_priority;
+  }
+  return a.direct_conn_deadline_ms < b.direct_conn_deadline_ms;
+}
+
+/* Make room in the full accept list for a direct connection, by taking it from
+ * a device only doing background connection. That device gets back into the
+ * accept list once there is room again. Returns true if a device was removed */
+bool suspend_background_connection(void) {
+  for (auto& [address, device] : bgconn_dev) {
+    if (!device.is_in_accept_list || !device.doing_direct_conn.empty() ||
+        device.doing_bg_conn.empty()) {
+      continue;
+    }
+    LOG_INFO("Suspend background connection to %s, for a direct connection",
+             ADDRESS_TO_LOGGABLE_CSTR(address));
+    BTM_AcceptlistRemove(address);
+    device.is_in_accept_list = false;
+    device.is_waiting_for_accept_list = true;
+    return true;
+  }
+  return false;
+}
+
+/* Give the room in the accept list to the devices waiting for it, until it is
+ * full again */
+void add_devices_waiting_for_accept_list(void) {
+  while (true) {
+    auto next = bgconn_dev.end();
+    for (auto it = bgconn_dev.begin(); it != bgconn_dev.end(); it++) {
+      if (it->second.is_waiting_for_accept_list &&
+          (next == bgconn_dev.end() ||
+           is_first_to_get_into_accept_list(it->second, next->second))) {
+        next = it;
+      }
+    }
+    if (next == bgconn_dev.end()) {
+      return;
+    }
+
+    bool is_direct = !next->second.doing_direct_conn.empty();
+    bool added = is_direct ? BTM_AcceptlistAdd(next->first, true)
+                           : BTM_AcceptlistAdd(next->first);
+    if (!added) {
+      LOG_DEBUG("Accept list is still full");
+      return;
+    }
+    LOG_INFO("Device %s got into the accept list",
+             ADDRESS_TO_LOGGABLE_CSTR(next->first));
+    next->second.is_waiting_for_accept_list = false;
+    next->second.is_in_accept_list = true;
+  }
+}
+
 int num_of_targeted_announcements_users(void) {
   return std::count_if(
       bgconn_dev.begin(), bgconn_dev.end(), [](const auto& pair) {
@@ -251,6 +355,7 @@ bool background_connect_targeted_announcement_add(tAPP_ID app_id,
   if (disable_accept_list) {
     BTM_AcceptlistRemove(address);
     bgconn_dev[address].is_in_accept_list = false;
+    add_devices_waiting_for_accept_list();
   }
 
   bgconn_dev[address].doing_targeted_announcements_conn.insert(app_id);
@@ -290,6 +395,10 @@ bool background_connect_add(uint8_t app_id, const RawAddress& address) {
       LOG_DEBUG("app_id=%d, address=%s, already in accept list",
                 static_cast<int>(app_id), ADDRESS_TO_LOGGABLE_CSTR(address));
       in_acceptlist = true;
+    } else if (it->second.is_waiting_for_accept_list) {
+      LOG_DEBUG("app_id=%d, address=%s, waiting for room in accept list",
+                static_cast<int>(app_id), ADDRESS_TO_LOGGABLE_CSTR(address));
+      in_acceptlist = true;
     } else {
       is_targeted_announcement_enabled =
           !it->second.doing_targeted_announcements_conn.empty();
@@ -328,6 +437,7 @@ bool remove_unconditional(const RawAddress& address) {
 
   BTM_AcceptlistRemove(address);
   bgconn_dev.erase(it);
+  add_devices_waiting_for_accept_list();
   return true;
 }
 
@@ -344,6 +454,7 @@ bool background_connect_remove(uint8_t app_id, const RawAddress& address) {
   }
 
   bool accept_list_enabled = it->second.is_in_accept_list;
+  bool is_waiting_for_accept_list = it->second.is_waiting_for_accept_list;
   auto num_of_targeted_announcements_before_remove =
       it->second.doing_targeted_announcements_conn.size();
 
@@ -365,7 +476,7 @@ bool background_connect_remove(uint8_t app_id, const RawAddress& address) {
     LOG_DEBUG("some device is still connecting, app_id=%d, address=%s",
               static_cast<int>(app_id), ADDRESS_TO_LOGGABLE_CSTR(address));
     /* Check which method should be used now.*/
-    if (!accept_list_enabled) {
+    if (!accept_list_enabled && !is_waiting_for_accept_list) {
       /* Accept list was not used */
       if (!it->second.doing_targeted_announcements_conn.empty()) {
         /* Keep using filtering */
@@ -386,6 +497,7 @@ bool background_connect_remove(uint8_t app_id, const RawAddress& address) {
   // no more apps interested - remove from accept list and delete record
   if (accept_list_enabled) {
     BTM_AcceptlistRemove(address);
+    add_devices_waiting_for_accept_list();
     return true;
   }
 
@@ -417,9 +529,12 @@ void on_app_deregistered(uint8_t app_id) {
       continue;
     }
 
-    BTM_AcceptlistRemove(it->first);
+    if (!it->second.is_waiting_for_accept_list) {
+      BTM_AcceptlistRemove(it->first);
+    }
     it = bgconn_dev.erase(it);
   }
+  add_devices_waiting_for_accept_list();
 }
 
 static void remove_all_clients_with_pending_connections(
@@ -437,6 +552,13 @@ void on_connection_complete(const RawAddress& address) {
   LOG_INFO("Le connection completed to device:%s",
            ADDRESS_TO_LOGGABLE_CSTR(address));
 
+  auto it = bgconn_dev.find(address);
+  if (it != bgconn_dev.end() && !it->second.doing_direct_conn.empty()) {
+    record_time_to_connect(it->second.direct_conn_priority,
+                           bluetooth::common::time_get_os_boottime_ms() -
+                               it->second.direct_conn_start_ms);
+  }
+
   remove_all_clients_with_pending_connections(address);
 }
 
@@ -457,6 +579,10 @@ void reset(bool after_reset) {
 void wl_direct_connect_timeout_cb(uint8_t app_id, const RawAddress& address) {
   LOG_DEBUG("app_id=%d, address=%s", static_cast<int>(app_id),
             ADDRESS_TO_LOGGABLE_CSTR(address));
+  auto it = bgconn_dev.find(address);
+  if (it != bgconn_dev.end()) {
+    direct_conn_stats.timed_out[it->second.direct_conn_priority]++;
+  }
   on_connection_timed_out(app_id, address);
 
   // TODO: this would free the timer, from within the timer callback, which is
@@ -467,13 +593,23 @@ void wl_direct_connect_timeout_cb(uint8_t app_id, const RawAddress& address) {
 /** Add a device to the direct connection list. Returns true if device
  * added to the list, false otherwise */
 bool direct_connect_add(uint8_t app_id, const RawAddress& address) {
-  LOG_DEBUG("app_id=%d, address=%s", static_cast<int>(app_id),
-            ADDRESS_TO_LOGGABLE_CSTR(address));
+  return direct_connect_add(app_id, address, CONN_PRIORITY_NORMAL,
+                            DIRECT_CONNECT_TIMEOUT);
+}
+
+/** Add a device to the direct connection list, or to the devices waiting for
+ * room in the accept list when it is full. Returns true if device added to
+ * either list, false otherwise */
+bool direct_connect_add(uint8_t app_id, const RawAddress& address,
+                        tCONN_PRIORITY priority, uint64_t timeout_ms) {
+  LOG_DEBUG("app_id=%d, address=%s, priority=%d", static_cast<int>(app_id),
+            ADDRESS_TO_LOGGABLE_CSTR(address), static_cast<int>(priority));
   if (bluetooth::shim::is_gd_l2cap_enabled()) {
     return L2CA_ConnectFixedChnl(L2CAP_ATT_CID, address);
   }
 
   bool in_acceptlist = false;
+  bool is_waiting_for_accept_list = false;
   auto it = bgconn_dev.find(address);
   if (it != bgconn_dev.end()) {
     // app already trying to connect to this particular device
@@ -489,25 +625,47 @@ bool direct_connect_add(uint8_t app_id, const RawAddress& address) {
                app_id);
       in_acceptlist = true;
     }
+    is_waiting_for_accept_list = it->second.is_waiting_for_accept_list;
   }
 
-  if (!in_acceptlist) {
-    if (!BTM_AcceptlistAdd(address, true)) {
+  if (!in_acceptlist && !is_waiting_for_accept_list) {
+    if (BTM_AcceptlistAdd(address, true) ||
+        (suspend_background_connection() && BTM_AcceptlistAdd(address, true))) {
+      bgconn_dev[address].is_in_accept_list = true;
+    } else if (num_of_devices_in_accept_list() > 0) {
+      // The attempt starts once a device leaves the accept list
+      LOG_INFO("Accept list is full, direct connection to %s waits for room",
+               ADDRESS_TO_LOGGABLE_CSTR(address));
+      bgconn_dev[address].is_waiting_for_accept_list = true;
+      direct_conn_stats.waited_for_accept_list[priority]++;
+    } else {
       // if we can't add to acceptlist, turn parameters back to slow.
       LOG_WARN("Unable to add le device to acceptlist");
       return false;
     }
-    bgconn_dev[address].is_in_accept_list = true;
+  }
+
+  tAPPS_CONNECTING& device = bgconn_dev[address];
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (device.doing_direct_conn.empty()) {
+    device.direct_conn_priority = priority;
+    device.direct_conn_deadline_ms = now_ms + timeout_ms;
+    device.direct_conn_start_ms = now_ms;
+  } else {
+    device.direct_conn_priority =
+        std::max(device.direct_conn_priority, priority);
+    device.direct_conn_deadline_ms =
+        std::min(device.direct_conn_deadline_ms, now_ms + timeout_ms);
   }
 
   // Setup a timer
   alarm_t* timeout = alarm_new("wl_conn_params_30s");
   alarm_set_closure(
-      FROM_HERE, timeout, DIRECT_CONNECT_TIMEOUT,
+      FROM_HERE, timeout, timeout_ms,
       base::BindOnce(&wl_direct_connect_timeout_cb, app_id, address));
 
-  bgconn_dev[address].doing_direct_conn.emplace(
-      app_id, unique_alarm_ptr(timeout, &alarm_free));
+  device.doing_direct_conn.emplace(app_id,
+                                   unique_alarm_ptr(timeout, &alarm_free));
 
   return true;
 }
@@ -546,19 +704,50 @@ bool direct_connect_remove(uint8_t app_id, const RawAddress& address) {
   }
 
   // no more apps interested - remove from acceptlist
-  BTM_AcceptlistRemove(address);
+  bool was_in_accept_list = it->second.is_in_accept_list;
+  if (was_in_accept_list) {
+    BTM_AcceptlistRemove(address);
+  }
 
   if (!is_targeted_announcement_enabled) {
     bgconn_dev.erase(it);
   } else {
     it->second.is_in_accept_list = false;
+    it->second.is_waiting_for_accept_list = false;
   }
 
+  if (was_in_accept_list) {
+    add_devices_waiting_for_accept_list();
+  }
   return true;
 }
 
 void dump(int fd) {
   dprintf(fd, "\nconnection_manager state:\n");
+  dprintf(fd, "\ttime to connect of direct connections, low/normal/high:\n");
+  for (size_t bucket = 0; bucket < kNumTimeToConnectBuckets; bucket++) {
+    if (bucket < kNumTimeToConnectBuckets - 1) {
+      dprintf(fd, "\t\t< %5lu ms: ",
+              (unsigned long)kTimeToConnectBucketsMs[bucket]);
+    } else {
+      dprintf(fd, "\t\t>= %4lu ms: ",
+              (unsigned long)kTimeToConnectBucketsMs[bucket - 1]);
+    }
+    for (size_t priority = 0; priority < kNumConnPriorities; priority++) {
+      dprintf(fd, "%s%zu", priority == 0 ? "" : "/",
+              direct_conn_stats.time_to_connect[priority][bucket]);
+    }
+    dprintf(fd, "\n");
+  }
+  dprintf(fd, "\t\ttimed out: %zu/%zu/%zu\n",
+          direct_conn_stats.timed_out[CONN_PRIORITY_LOW],
+          direct_conn_stats.timed_out[CONN_PRIORITY_NORMAL],
+          direct_conn_stats.timed_out[CONN_PRIORITY_HIGH]);
+  dprintf(fd, "\t\twaited for the accept list: %zu/%zu/%zu\n",
+          direct_conn_stats.waited_for_accept_list[CONN_PRIORITY_LOW],
+          direct_conn_stats.waited_for_accept_list[CONN_PRIORITY_NORMAL],
+          direct_conn_stats.waited_for_accept_list[CONN_PRIORITY_HIGH]);
+
   if (bgconn_dev.empty()) {
     dprintf(fd, "\tno Low Energy connection attempts\n");
     return;
@@ -590,6 +779,9 @@ void dump(int fd) {
     }
     dprintf(fd, "\n\t\t is in the allow list: %s",
             entry.second.is_in_accept_list ? "true" : "false");
+    if (entry.second.is_waiting_for_accept_list) {
+      dprintf(fd, "\n\t\t is waiting for room in the allow list");
+    }
   }
   dprintf(fd, "\n");
 }
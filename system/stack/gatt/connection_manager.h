@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <set>
 
 #include "types/raw_address.h"
@@ -50,7 +51,20 @@ void on_connection_complete(const RawAddress& address);
 
 std::set<tAPP_ID> get_apps_connecting_to(const RawAddress& remote_bda);
 
+/* Priority of a direct connection attempt. When the accept list is full, the
+ * attempts with the highest priority, then the closest deadline, are the first
+ * to get into it. */
+enum tCONN_PRIORITY : uint8_t {
+  CONN_PRIORITY_LOW = 0,
+  CONN_PRIORITY_NORMAL = 1,
+  CONN_PRIORITY_HIGH = 2,
+};
+
 bool direct_connect_add(tAPP_ID app_id, const RawAddress& address);
+/* The attempt times out |timeout_ms| after this call, including the time spent
+ * waiting for room in the accept list. */
+bool direct_connect_add(tAPP_ID app_id, const RawAddress& address,
+                        tCONN_PRIORITY priority, uint64_t timeout_ms);
 bool direct_connect_remove(tAPP_ID app_id, const RawAddress& address);
 
 void dump(int fd);
@@ -41,14 +41,17 @@
 #include "rust/src/connection/ffi/connection_shim.h"
 #include "stack/arbiter/acl_arbiter.h"
 #include "stack/btm/btm_dev.h"
+#include "stack/eatt/eatt.h"
 #include "stack/gatt/connection_manager.h"
 #include "stack/gatt/gatt_int.h"
 #include "stack/include/bt_hdr.h"
+#include "stack/include/btu.h"  // btu_check_executor_affinity
 #include "types/bluetooth/uuid.h"
 #include "types/bt_transport.h"
 #include "types/raw_address.h"
 
 using bluetooth::Uuid;
+using bluetooth::eatt::EattExtension;
 
 bool BTM_BackgroundConnectAddressKnown(const RawAddress& address);
 /**
@@ -127,18 +130,22 @@ static bool is_gatt_attr_type(const Uuid& uuid) {
   return false;
 }
 
-/** Update the the last service info for the service list info */
+/** Update the the last service info and the indexes for the service list
+ * info */
 static void gatt_update_last_srv_info() {
   gatt_cb.last_service_handle = 0;
 
   for (tGATT_SRV_LIST_ELEM& el : *gatt_cb.srv_list_info) {
     gatt_cb.last_service_handle = el.s_hdl;
   }
+
+  gatt_sr_update_srv_index();
 }
 
-/** Update database hash and client status */
+/** Update database hash and client status. The hash is only computed when
+ * next used, so that adding many services in a row computes it once. */
 static void gatt_update_for_database_change() {
-  gatt_cb.database_hash = gatts_calculate_database_hash(gatt_cb.srv_list_info);
+  gatt_cb.is_database_hash_outdated = true;
 
   uint8_t i = 0;
   for (i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
@@ -442,6 +449,8 @@ void GATTS_StopService(uint16_t service_handle) {
  ******************************************************************************/
 tGATT_STATUS GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_handle,
                                          uint16_t val_len, uint8_t* p_val) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::GATT, __func__);
+
   tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
   uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
   tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
@@ -520,6 +529,26 @@ static tGATT_STATUS GATTS_HandleMultileValueNotification(
   return attp_send_sr_msg(*p_tcb, cid, p_buf);
 }
 #endif
+
+/* Sends |notif| in a handle value notification on |cid| */
+static tGATT_STATUS gatts_send_value_notif(tGATT_TCB& tcb, uint16_t cid,
+                                           const tGATT_VALUE& notif) {
+  tGATT_STATUS cmd_sent;
+  tGATT_SR_MSG gatt_sr_msg;
+  gatt_sr_msg.attr_value = notif;
+
+  uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
+  BT_HDR* p_buf = attp_build_sr_msg(tcb, GATT_HANDLE_VALUE_NOTIF, &gatt_sr_msg,
+                                    payload_size);
+
+  if (p_buf != NULL) {
+    cmd_sent = attp_send_sr_msg(tcb, cid, p_buf);
+  } else {
+    cmd_sent = GATT_NO_RESOURCES;
+  }
+  return cmd_sent;
+}
+
 /*******************************************************************************
  *
  * Function         GATTS_HandleValueNotification
@@ -538,6 +567,8 @@ static tGATT_STATUS GATTS_HandleMultileValueNotification(
 tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
                                            uint16_t attr_handle,
                                            uint16_t val_len, uint8_t* p_val) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::GATT, __func__);
+
   tGATT_VALUE notif;
   tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
   uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
@@ -603,21 +634,90 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   memcpy(notif.value, p_val, val_len);
   notif.auth_req = GATT_AUTH_REQ_NONE;
 
-  tGATT_STATUS cmd_sent;
-  tGATT_SR_MSG gatt_sr_msg;
-  gatt_sr_msg.attr_value = notif;
+  uint16_t cid = gatt_tcb_get_cid_for_notification(
+      *p_tcb, p_reg->eatt_support, attr_handle);
+  return gatts_send_value_notif(*p_tcb, cid, notif);
+}
 
-  uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
-  uint16_t payload_size = gatt_tcb_get_payload_size_tx(*p_tcb, cid);
-  BT_HDR* p_buf = attp_build_sr_msg(*p_tcb, GATT_HANDLE_VALUE_NOTIF,
-                                    &gatt_sr_msg, payload_size);
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleMultipleValueNotification
+ *
+ * Description      This function sends handle value notifications to a client,
+ *                  packed into multiple handle value notifications when the
+ *                  client supports them.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  notifs: handles and values of the notifications, sent in
+ *                          this order.
+ *
+ * Returns          GATT_SUCCESS if sucessfully sent; otherwise error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATTS_HandleMultipleValueNotification(
+    uint16_t conn_id, const std::vector<tGATT_VALUE>& notifs) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::GATT, __func__);
 
-  if (p_buf != NULL) {
-    cmd_sent = attp_send_sr_msg(*p_tcb, cid, p_buf);
-  } else {
-    cmd_sent = GATT_NO_RESOURCES;
+  tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
+  uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+
+  VLOG(1) << __func__ << ": count=" << notifs.size();
+
+  if ((p_reg == NULL) || (p_tcb == NULL)) {
+    LOG(ERROR) << __func__ << ": Unknown  conn_id=" << loghex(conn_id);
+    return (tGATT_STATUS)GATT_INVALID_CONN_ID;
   }
-  return cmd_sent;
+
+  for (const tGATT_VALUE& notif : notifs) {
+    if (!GATT_HANDLE_IS_VALID(notif.handle) || notif.len > GATT_MAX_ATTR_LEN) {
+      return GATT_ILLEGAL_PARAMETER;
+    }
+  }
+
+  bool multi_notif = gatt_sr_is_cl_multi_variable_len_notif_supported(*p_tcb);
+  tGATT_STATUS status = GATT_SUCCESS;
+  size_t i = 0;
+  while (i < notifs.size()) {
+    uint16_t cid = gatt_tcb_get_cid_for_notification(
+        *p_tcb, p_reg->eatt_support, notifs[i].handle);
+    size_t next = i + 1;
+    BT_HDR* p_buf = NULL;
+
+    if (multi_notif && next < notifs.size()) {
+      p_buf = attp_build_multi_value_notif(
+          gatt_tcb_get_payload_size_tx(*p_tcb, cid), notifs, i, &next);
+      /* A single value is sent in a handle value notification */
+      if (next < i + 2) {
+        osi_free(p_buf);
+        p_buf = NULL;
+        next = i + 1;
+      }
+    }
+
+    tGATT_STATUS cmd_sent;
+    if (p_buf == NULL) {
+      cmd_sent = gatts_send_value_notif(*p_tcb, cid, notifs[i]);
+    } else {
+      p_tcb->multi_notif_count++;
+      if (cid != p_tcb->att_lcid) {
+        /* The next notification of each of these attributes follows them */
+        for (size_t j = i; j < next; j++) {
+          p_tcb->notif_cid_by_handle[notifs[j].handle] = cid;
+        }
+      }
+      cmd_sent = attp_send_sr_msg(*p_tcb, cid, p_buf);
+    }
+
+    if (cmd_sent == GATT_CONGESTED) {
+      status = GATT_CONGESTED;
+    } else if (cmd_sent != GATT_SUCCESS) {
+      return cmd_sent;
+    }
+    i = next;
+  }
+  return status;
 }
 
 /*******************************************************************************
@@ -873,6 +973,8 @@ std::list<uint16_t> GATTC_GetAndRemoveListOfConnIdsWaitingForMtuRequest(
 tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
                             uint16_t start_handle, uint16_t end_handle,
                             const Uuid& uuid) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::GATT, __func__);
+
   tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
   uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
   tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
@@ -925,6 +1027,32 @@ tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
                         Uuid::kEmpty);
 }
 
+/*******************************************************************************
+ *
+ * Function         GATTC_IsAdditionalBearerAvailable
+ *
+ * Description      This function checks if a client request sent now would be
+ *                  carried by EATT bearer without waiting for the requests
+ *                  already outstanding on the connection.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          true if an idle EATT bearer is available for the request.
+ *
+ ******************************************************************************/
+bool GATTC_IsAdditionalBearerAvailable(uint16_t conn_id) {
+  tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
+  uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
+
+  if ((p_tcb == NULL) || (p_reg == NULL)) return false;
+  if (!p_reg->eatt_support || !p_tcb->eatt) return false;
+
+  return EattExtension::GetInstance()->GetChannelAvailableForClientRequest(
+             p_tcb->peer_bda) != nullptr;
+}
+
 /*******************************************************************************
  *
  * Function         GATTC_Read
@@ -941,6 +1069,8 @@ tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
  ******************************************************************************/
 tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
                         tGATT_READ_PARAM* p_read) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::GATT, __func__);
+
   tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
   uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
   tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
@@ -960,6 +1090,11 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
     return GATT_ILLEGAL_PARAMETER;
   }
 
+  if (type == GATT_READ_MULTIPLE_VAR_LEN &&
+      !gatt_cl_is_sr_read_multi_var_supported(*p_tcb)) {
+    return GATT_REQ_NOT_SUPPORTED;
+  }
+
   tGATT_CLCB* p_clcb = gatt_clcb_alloc(conn_id);
   if (!p_clcb) return GATT_NO_RESOURCES;
 
@@ -967,6 +1102,11 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
   p_clcb->op_subtype = type;
   p_clcb->auth_req = p_read->by_handle.auth_req;
   p_clcb->counter = 0;
+  /* A long value is read with Read Blob requests on the same bearer */
+  if (type == GATT_READ_BY_HANDLE) {
+    p_clcb->cid =
+        gatt_tcb_get_att_cid_for_long_op(*p_tcb, p_reg->eatt_support);
+  }
   p_clcb->read_req_current_mtu =
       gatt_tcb_get_payload_size_tx(*p_tcb, p_clcb->cid);
 
@@ -977,13 +1117,18 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
       p_clcb->e_handle = p_read->service.e_handle;
       p_clcb->uuid = p_read->service.uuid;
       break;
-    case GATT_READ_MULTIPLE: {
-      p_clcb->s_handle = 0;
+    case GATT_READ_MULTIPLE:
+    case GATT_READ_MULTIPLE_VAR_LEN: {
+      /* The completion of a variable length read carries its first handle */
+      p_clcb->s_handle = type == GATT_READ_MULTIPLE_VAR_LEN
+                             ? p_read->read_multiple.handles[0]
+                             : 0;
       /* copy multiple handles in CB */
       tGATT_READ_MULTI* p_read_multi =
           (tGATT_READ_MULTI*)osi_malloc(sizeof(tGATT_READ_MULTI));
       p_clcb->p_attr_buf = (uint8_t*)p_read_multi;
       memcpy(p_read_multi, &p_read->read_multiple, sizeof(tGATT_READ_MULTI));
+      p_read_multi->variable_len = type == GATT_READ_MULTIPLE_VAR_LEN;
       break;
     }
     case GATT_READ_BY_HANDLE:
@@ -1050,6 +1195,8 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
  ******************************************************************************/
 tGATT_STATUS GATTC_Write(uint16_t conn_id, tGATT_WRITE_TYPE type,
                          tGATT_VALUE* p_write) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::GATT, __func__);
+
   tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
   uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
   tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
@@ -1073,6 +1220,15 @@ tGATT_STATUS GATTC_Write(uint16_t conn_id, tGATT_WRITE_TYPE type,
   p_clcb->p_attr_buf = (uint8_t*)osi_malloc(sizeof(tGATT_VALUE));
   memcpy(p_clcb->p_attr_buf, (void*)p_write, sizeof(tGATT_VALUE));
 
+  /* A long value is written with Prepare Write requests on the same bearer */
+  if (type == GATT_WRITE_PREPARE ||
+      (type == GATT_WRITE &&
+       p_write->len >
+           gatt_tcb_get_payload_size_tx(*p_tcb, p_clcb->cid) - GATT_HDR_SIZE)) {
+    p_clcb->cid =
+        gatt_tcb_get_att_cid_for_long_op(*p_tcb, p_reg->eatt_support);
+  }
+
   tGATT_VALUE* p = (tGATT_VALUE*)p_clcb->p_attr_buf;
   if (type == GATT_WRITE_PREPARE) {
     p_clcb->start_offset = p_write->offset;
@@ -1099,6 +1255,8 @@ tGATT_STATUS GATTC_Write(uint16_t conn_id, tGATT_WRITE_TYPE type,
  *
  ******************************************************************************/
 tGATT_STATUS GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute) {
+  btu_check_executor_affinity(tBTU_EXECUTOR::GATT, __func__);
+
   tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
   uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
   tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
@@ -1694,3 +1852,28 @@ void gatt_load_bonded(void) {
     }
   }
 }
+
+#define DUMPSYS_TAG "shim::legacy::gatt"
+void GATT_Dumpsys(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+
+  for (int i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
+    const tGATT_TCB& tcb = gatt_cb.tcb[i];
+    if (!tcb.in_use) continue;
+
+    LOG_DUMPSYS(fd, "  peer:%s transport:%s eatt:%hhu",
+                ADDRESS_TO_LOGGABLE_CSTR(tcb.peer_bda),
+                bt_transport_text(tcb.transport).c_str(), tcb.eatt);
+    LOG_DUMPSYS(fd, "    pending_indications:%zu max:%zu",
+                fixed_queue_length(tcb.pending_ind_q), tcb.pending_ind_q_max);
+    LOG_DUMPSYS(fd,
+                "    notifications:%lu over_eatt:%lu multiple_value:%lu "
+                "max_queued_on_channel:%hu",
+                (unsigned long)tcb.notif_count,
+                (unsigned long)tcb.eatt_notif_count,
+                (unsigned long)tcb.multi_notif_count, tcb.notif_queued_max);
+  }
+
+  EattExtension::GetInstance()->Dump(fd);
+}
+#undef DUMPSYS_TAG
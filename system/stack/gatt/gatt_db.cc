@@ -27,6 +27,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "bt_target.h"
 #include "bt_trace.h"
 #include "gatt_int.h"
@@ -267,9 +269,11 @@ static tGATT_STATUS read_attr_value(tGATT_ATTR& attr16, uint16_t offset,
  *
  * Function         gatts_db_read_attr_value_by_type
  *
- * Description      Query attribute value by attribute type.
+ * Description      Query attribute value by attribute type, through the
+ *                  attribute type index of the started services.
  *
- * Parameter        p_db: pointer to the attribute database.
+ * Parameter        p_db: pointer to the attribute database of a started
+ *                        service.
  *                  p_rsp: Read By type response data.
  *                  s_handle: starting handle of the range we are looking for.
  *                  e_handle: ending handle of the range we are looking for.
@@ -290,40 +294,51 @@ tGATT_STATUS gatts_db_read_attr_value_by_type(
   uint16_t len = 0;
   uint8_t* p = (uint8_t*)(p_rsp + 1) + p_rsp->len + L2CAP_MIN_OFFSET;
 
-  if (p_db) {
-    for (tGATT_ATTR& attr : p_db->attr_list) {
-      if (attr.handle >= s_handle && type == attr.uuid) {
-        if (*p_len <= 2) {
-          status = GATT_NO_RESOURCES;
-          break;
-        }
+  // Attributes of the type in the range of this service, from s_handle
+  auto type_it = gatt_cb.srv_type_index.find(type);
+  if (p_db && !p_db->attr_list.empty() &&
+      type_it != gatt_cb.srv_type_index.end()) {
+    uint16_t first_handle = std::max(s_handle, p_db->attr_list.front().handle);
+    uint16_t last_handle = p_db->attr_list.back().handle;
+    std::vector<tGATT_ATTR*>& attrs = type_it->second;
+    auto attr_it = std::lower_bound(
+        attrs.begin(), attrs.end(), first_handle,
+        [](const tGATT_ATTR* p_attr, uint16_t handle) {
+          return p_attr->handle < handle;
+        });
+    for (; attr_it != attrs.end() && (*attr_it)->handle <= last_handle;
+         attr_it++) {
+      tGATT_ATTR& attr = **attr_it;
+      if (*p_len <= 2) {
+        status = GATT_NO_RESOURCES;
+        break;
+      }
 
-        UINT16_TO_STREAM(p, attr.handle);
+      UINT16_TO_STREAM(p, attr.handle);
 
-        status = read_attr_value(attr, 0, &p, false, (uint16_t)(*p_len - 2),
-                                 &len, sec_flag, key_size);
+      status = read_attr_value(attr, 0, &p, false, (uint16_t)(*p_len - 2),
+                               &len, sec_flag, key_size);
 
-        if (status == GATT_PENDING) {
-          status = gatts_send_app_read_request(tcb, cid, op_code, attr.handle,
-                                               0, trans_id, attr.gatt_type);
+      if (status == GATT_PENDING) {
+        status = gatts_send_app_read_request(tcb, cid, op_code, attr.handle,
+                                             0, trans_id, attr.gatt_type);
 
-          /* one callback at a time */
-          break;
-        } else if (status == GATT_SUCCESS) {
-          if (p_rsp->offset == 0) p_rsp->offset = len + 2;
-
-          if (p_rsp->offset == len + 2) {
-            p_rsp->len += (len + 2);
-            *p_len -= (len + 2);
-          } else {
-            LOG(ERROR) << "format mismatch";
-            status = GATT_NO_RESOURCES;
-            break;
-          }
+        /* one callback at a time */
+        break;
+      } else if (status == GATT_SUCCESS) {
+        if (p_rsp->offset == 0) p_rsp->offset = len + 2;
+
+        if (p_rsp->offset == len + 2) {
+          p_rsp->len += (len + 2);
+          *p_len -= (len + 2);
         } else {
-          *p_cur_handle = attr.handle;
+          LOG(ERROR) << "format mismatch";
+          status = GATT_NO_RESOURCES;
           break;
         }
+      } else {
+        *p_cur_handle = attr.handle;
+        break;
       }
     }
   }
@@ -456,12 +471,15 @@ uint16_t gatts_add_char_descr(tGATT_SVC_DB& db, tGATT_PERM perm,
 tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle) {
   if (!p_db) return nullptr;
 
-  for (auto& attr : p_db->attr_list) {
-    if (attr.handle == handle) return &attr;
-    if (attr.handle > handle) return nullptr;
-  }
+  // Attributes are allocated in handle order
+  auto it = std::lower_bound(
+      p_db->attr_list.begin(), p_db->attr_list.end(), handle,
+      [](const tGATT_ATTR& attr, uint16_t handle) {
+        return attr.handle < handle;
+      });
+  if (it == p_db->attr_list.end() || it->handle != handle) return nullptr;
 
-  return nullptr;
+  return &(*it);
 }
 
 /*******************************************************************************
@@ -26,6 +26,7 @@
 #include <deque>
 #include <list>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -299,6 +300,8 @@ typedef struct {
   uint16_t e_hdl;      /* service ending handle */
   tGATT_IF gatt_if;    /* this service is belong to which application */
   bool is_primary;
+  /* database hash input for this service, serialized on first use */
+  std::vector<uint8_t> hash_info;
 } tGATT_SRV_LIST_ELEM;
 
 typedef struct {
@@ -349,6 +352,15 @@ typedef struct {
   /* Used to set proper TX DATA LEN on the controller*/
   uint16_t max_user_mtu;
 
+  /* EATT channel of the last notification of each attribute handle */
+  std::unordered_map<uint16_t, uint16_t> notif_cid_by_handle;
+  /* Queue depths and counters reported by GATT_Dumpsys */
+  size_t pending_ind_q_max;
+  uint16_t notif_queued_max;
+  uint32_t notif_count;
+  uint32_t eatt_notif_count;
+  uint32_t multi_notif_count;
+
 } tGATT_TCB;
 
 /* logic channel */
@@ -410,6 +422,9 @@ typedef struct {
 
 typedef struct {
   tGATT_TCB tcb[GATT_MAX_PHY_CHANNEL];
+  /* Index in tcb of the dynamic ATT and EATT channels, only a hint for
+   * gatt_find_tcb_by_cid() which checks it against the TCB. */
+  std::unordered_map<uint16_t, uint8_t> tcb_idx_by_cid;
   fixed_queue_t* sign_op_queue;
 
   uint16_t next_handle;     /* next available handle */
@@ -419,6 +434,12 @@ typedef struct {
   std::list<tGATT_HDL_LIST_ELEM>* hdl_list_info;
   std::list<tGATT_SRV_LIST_ELEM>* srv_list_info;
 
+  /* Started services in start handle order, and their attributes grouped by
+   * attribute type in handle order. Rebuilt by gatt_sr_update_srv_index()
+   * whenever srv_list_info changes. */
+  std::vector<std::list<tGATT_SRV_LIST_ELEM>::iterator> srv_index;
+  std::unordered_map<bluetooth::Uuid, std::vector<tGATT_ATTR*>> srv_type_index;
+
   fixed_queue_t* srv_chg_clt_q; /* service change clients queue */
   tGATT_REG cl_rcb[GATT_MAX_APPS];
 
@@ -452,7 +473,10 @@ typedef struct {
   uint8_t gatt_cl_supported_feat_mask;
 
   uint16_t handle_of_database_hash;
+  /* Only valid when is_database_hash_outdated is false, use
+   * gatts_get_database_hash() */
   Octet16 database_hash;
+  bool is_database_hash_outdated;
 
   tGATT_APPL_INFO cb_info;
 
@@ -504,6 +528,7 @@ bool gatt_cl_read_sr_supp_feat_req(
     const RawAddress& peer_bda,
     base::OnceCallback<void(const RawAddress&, uint8_t)> cb);
 bool gatt_sr_is_cl_multi_variable_len_notif_supported(tGATT_TCB& tcb);
+bool gatt_cl_is_sr_read_multi_var_supported(tGATT_TCB& tcb);
 
 bool gatt_sr_is_cl_change_aware(tGATT_TCB& tcb);
 void gatt_sr_init_cl_status(tGATT_TCB& tcb);
@@ -515,6 +540,9 @@ tGATT_STATUS attp_send_cl_msg(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
                               uint8_t op_code, tGATT_CL_MSG* p_msg);
 BT_HDR* attp_build_sr_msg(tGATT_TCB& tcb, uint8_t op_code, tGATT_SR_MSG* p_msg,
                           uint16_t payload_size);
+BT_HDR* attp_build_multi_value_notif(uint16_t payload_size,
+                                     const std::vector<tGATT_VALUE>& notifs,
+                                     size_t first, size_t* p_next);
 tGATT_STATUS attp_send_sr_msg(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_msg);
 tGATT_STATUS attp_send_msg_to_l2cap(tGATT_TCB& tcb, uint16_t cid,
                                     BT_HDR* p_toL2CAP);
@@ -566,6 +594,9 @@ bool gatt_auto_connect_dev_remove(tGATT_IF gatt_if, const RawAddress& bd_addr);
 /* server function */
 std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle);
+std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_first_srv_from_handle(
+    uint16_t handle);
+void gatt_sr_update_srv_index();
 tGATT_STATUS gatt_sr_process_app_rsp(tGATT_TCB& tcb, tGATT_IF gatt_if,
                                      uint32_t trans_id, uint8_t op_code,
                                      tGATT_STATUS status, tGATTS_RSP* p_msg,
@@ -598,6 +629,9 @@ bool gatt_tcb_get_cid_available_for_indication(tGATT_TCB* p_tcb,
 bool gatt_tcb_find_indicate_handle(tGATT_TCB& tcb, uint16_t cid,
                                    uint16_t* indicated_handle_p);
 uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support);
+uint16_t gatt_tcb_get_att_cid_for_long_op(tGATT_TCB& tcb, bool eatt_support);
+uint16_t gatt_tcb_get_cid_for_notification(tGATT_TCB& tcb, bool eatt_support,
+                                           uint16_t handle);
 uint16_t gatt_tcb_get_payload_size_tx(tGATT_TCB& tcb, uint16_t cid);
 uint16_t gatt_tcb_get_payload_size_rx(tGATT_TCB& tcb, uint16_t cid);
 void gatt_clcb_invalidate(tGATT_TCB* p_tcb, const tGATT_CLCB* p_clcb);
@@ -670,6 +704,7 @@ uint16_t gatts_add_char_ext_prop_descr(tGATT_SVC_DB& db,
                                        uint16_t extended_properties);
 uint16_t gatts_add_char_descr(tGATT_SVC_DB& db, tGATT_PERM perm,
                               const bluetooth::Uuid& dscp_uuid);
+tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle);
 tGATT_STATUS gatts_db_read_attr_value_by_type(
     tGATT_TCB& tcb, uint16_t cid, tGATT_SVC_DB* p_db, uint8_t op_code,
     BT_HDR* p_rsp, uint16_t s_handle, uint16_t e_handle,
@@ -692,5 +727,6 @@ bluetooth::Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db);
 
 /* gatt_sr_hash.cc */
 Octet16 gatts_calculate_database_hash(std::list<tGATT_SRV_LIST_ELEM>* lst_ptr);
+const Octet16& gatts_get_database_hash();
 
 #endif
@@ -31,6 +31,7 @@
 #include "connection_manager.h"
 #include "device/include/interop.h"
 #include "gd/common/init_flags.h"
+#include "gd/common/packet_latency_trace.h"
 #include "hardware/bt_gatt_types.h"
 #include "internal_include/stack_config.h"
 #include "l2c_api.h"
@@ -75,6 +76,7 @@ static void gatt_l2cif_disconnect_ind_cback(uint16_t l2cap_cid,
                                             bool ack_needed);
 static void gatt_l2cif_disconnect(uint16_t l2cap_cid);
 static void gatt_l2cif_data_ind_cback(uint16_t l2cap_cid, BT_HDR* p_msg);
+static void gatt_end_packet_latency_sample(BT_HDR* p_buf);
 static void gatt_send_conn_cback(tGATT_TCB* p_tcb);
 static void gatt_l2cif_congest_cback(uint16_t cid, bool congested);
 static void gatt_on_l2cap_error(uint16_t lcid, uint16_t result);
@@ -196,6 +198,7 @@ void gatt_free(void) {
   gatt_cb.srv_list_info->clear();
   delete gatt_cb.srv_list_info;
   gatt_cb.srv_list_info = nullptr;
+  gatt_sr_update_srv_index();
 
   EattExtension::GetInstance()->Stop();
 }
@@ -740,6 +743,7 @@ static void gatt_le_cong_cback(const RawAddress& remote_bda, bool congested) {
  ******************************************************************************/
 static void gatt_le_data_ind(uint16_t chan, const RawAddress& bd_addr,
                              BT_HDR* p_buf) {
+  gatt_end_packet_latency_sample(p_buf);
 
   /* Find CCB based on bd addr */
   tGATT_TCB* p_tcb = gatt_find_tcb_by_addr(bd_addr, BT_TRANSPORT_LE);
@@ -907,6 +911,8 @@ static void gatt_l2cif_disconnect(uint16_t lcid) {
 
 /** This is the L2CAP data indication callback function */
 static void gatt_l2cif_data_ind_cback(uint16_t lcid, BT_HDR* p_buf) {
+  gatt_end_packet_latency_sample(p_buf);
+
   /* look up clcb for this channel */
   tGATT_TCB* p_tcb = gatt_find_tcb_by_cid(lcid);
   if (p_tcb && gatt_get_ch_state(p_tcb) == GATT_CH_OPEN) {
@@ -917,6 +923,14 @@ static void gatt_l2cif_data_ind_cback(uint16_t lcid, BT_HDR* p_buf) {
   osi_free(p_buf);
 }
 
+/** GATT is the last stage of the latency trace of the incoming packets */
+static void gatt_end_packet_latency_sample(BT_HDR* p_buf) {
+  bluetooth::common::PacketLatencyTrace::End(
+      bluetooth::common::PacketLatencyTrace::GetBufferSample(p_buf),
+      bluetooth::common::PacketLatencyStage::GATT);
+  bluetooth::common::PacketLatencyTrace::UntagBuffer(p_buf);
+}
+
 /** L2CAP congestion callback */
 static void gatt_l2cif_congest_cback(uint16_t lcid, bool congested) {
   tGATT_TCB* p_tcb = gatt_find_tcb_by_cid(lcid);
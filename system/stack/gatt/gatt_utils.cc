@@ -26,6 +26,7 @@
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <deque>
 
@@ -174,6 +175,8 @@ void gatt_add_pending_ind(tGATT_TCB* p_tcb, tGATT_VALUE* p_ind) {
   tGATT_VALUE* p_buf = (tGATT_VALUE*)osi_malloc(sizeof(tGATT_VALUE));
   memcpy(p_buf, p_ind, sizeof(tGATT_VALUE));
   fixed_queue_enqueue(p_tcb->pending_ind_q, p_buf);
+  p_tcb->pending_ind_q_max = std::max(
+      p_tcb->pending_ind_q_max, fixed_queue_length(p_tcb->pending_ind_q));
 }
 
 /*******************************************************************************
@@ -772,15 +775,63 @@ void  gatt_ind_ack_timeout(void* data) {
  ******************************************************************************/
 std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle) {
-  auto it = gatt_cb.srv_list_info->begin();
+  auto it = gatt_sr_find_first_srv_from_handle(handle);
+  if (it != gatt_cb.srv_list_info->end() && it->s_hdl <= handle) {
+    return it;
+  }
 
-  for (; it != gatt_cb.srv_list_info->end(); it++) {
-    if (it->s_hdl <= handle && it->e_hdl >= handle) {
-      return it;
-    }
+  return gatt_cb.srv_list_info->end();
+}
+
+/*******************************************************************************
+ *
+ * Description      Search for the first service ending at or after a specific
+ *                  handle. Services don't overlap, so the following services
+ *                  in the list start after this handle.
+ *
+ * Returns          The end of the service list if not found, the service
+ *                  otherwise.
+ *
+ ******************************************************************************/
+std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_first_srv_from_handle(
+    uint16_t handle) {
+  auto index_it = std::lower_bound(
+      gatt_cb.srv_index.begin(), gatt_cb.srv_index.end(), handle,
+      [](const std::list<tGATT_SRV_LIST_ELEM>::iterator& it, uint16_t handle) {
+        return it->e_hdl < handle;
+      });
+  if (index_it == gatt_cb.srv_index.end()) {
+    return gatt_cb.srv_list_info->end();
   }
 
-  return it;
+  return *index_it;
+}
+
+/*******************************************************************************
+ *
+ * Description      Rebuild the handle and attribute type indexes of the
+ *                  started services. Must be called whenever a service is
+ *                  added to or removed from the service list.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_sr_update_srv_index() {
+  gatt_cb.srv_index.clear();
+  gatt_cb.srv_type_index.clear();
+  if (gatt_cb.srv_list_info == nullptr) return;
+
+  // The service list is kept sorted by start handle, and the attributes of a
+  // service are allocated in handle order.
+  for (auto it = gatt_cb.srv_list_info->begin();
+       it != gatt_cb.srv_list_info->end(); it++) {
+    gatt_cb.srv_index.push_back(it);
+    if (it->p_db == nullptr) continue;
+
+    for (tGATT_ATTR& attr : it->p_db->attr_list) {
+      gatt_cb.srv_type_index[attr.uuid].push_back(&attr);
+    }
+  }
 }
 
 /*******************************************************************************
@@ -1117,6 +1168,69 @@ uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support) {
   return tcb.att_lcid;
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_tcb_get_att_cid_for_long_op
+ *
+ * Description      This function gets cid for a GATT operation which may take
+ *                  several requests, like a long read or a prepared write.
+ *                  Of the idle bearers, the one with the largest MTU is used
+ *                  so that the value takes the fewest round trips.
+ *
+ * Returns          Available CID
+ *
+ ******************************************************************************/
+uint16_t gatt_tcb_get_att_cid_for_long_op(tGATT_TCB& tcb, bool eatt_support) {
+  if (!eatt_support || !tcb.eatt) return tcb.att_lcid;
+
+  EattChannel* channel =
+      EattExtension::GetInstance()->GetChannelAvailableForLongClientRequest(
+          tcb.peer_bda);
+  if (!channel) return tcb.att_lcid;
+
+  /* The ATT bearer is kept when it is idle and at least as large */
+  if (tcb.cl_cmd_q.empty() &&
+      tcb.payload_size >= std::min(channel->tx_mtu_, channel->rx_mtu_)) {
+    return tcb.att_lcid;
+  }
+  return channel->cid_;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_tcb_get_cid_for_notification
+ *
+ * Description      This function gets cid for a notification of the attribute
+ *                  handle. The notifications are spread over the EATT
+ *                  channels, with those of one attribute kept in order.
+ *
+ * Returns          Available CID
+ *
+ ******************************************************************************/
+uint16_t gatt_tcb_get_cid_for_notification(tGATT_TCB& tcb, bool eatt_support,
+                                           uint16_t handle) {
+  tcb.notif_count++;
+  if (!eatt_support || !tcb.eatt) return tcb.att_lcid;
+
+  uint16_t last_cid = 0;
+  auto it = tcb.notif_cid_by_handle.find(handle);
+  if (it != tcb.notif_cid_by_handle.end()) last_cid = it->second;
+
+  uint16_t queued = 0;
+  EattChannel* channel =
+      EattExtension::GetInstance()->GetChannelAvailableForNotification(
+          tcb.peer_bda, last_cid, &queued);
+  if (!channel) {
+    if (it != tcb.notif_cid_by_handle.end()) tcb.notif_cid_by_handle.erase(it);
+    return tcb.att_lcid;
+  }
+
+  tcb.eatt_notif_count++;
+  tcb.notif_queued_max = std::max(tcb.notif_queued_max, queued);
+  tcb.notif_cid_by_handle[handle] = channel->cid_;
+  return channel->cid_;
+}
+
 /*******************************************************************************
  *
  * Function         gatt_tcb_get_payload_size_tx
@@ -1248,16 +1362,33 @@ void gatt_clcb_invalidate(tGATT_TCB* p_tcb, const tGATT_CLCB* p_clcb) {
  * Returns           NULL if not found. Otherwise pointer to the rcb.
  *
  ******************************************************************************/
+static bool gatt_tcb_has_cid(const tGATT_TCB& tcb, uint16_t lcid) {
+  if (!tcb.in_use) return false;
+  if (tcb.att_lcid == lcid) return true;
+  return EattExtension::GetInstance()->FindEattChannelByCid(tcb.peer_bda,
+                                                            lcid) != nullptr;
+}
+
 tGATT_TCB* gatt_find_tcb_by_cid(uint16_t lcid) {
   uint16_t xx = 0;
   tGATT_TCB* p_tcb = NULL;
 
+  /* The fixed ATT channel is shared by all the LE links */
+  bool use_index = (lcid != L2CAP_ATT_CID);
+  if (use_index) {
+    auto it = gatt_cb.tcb_idx_by_cid.find(lcid);
+    if (it != gatt_cb.tcb_idx_by_cid.end()) {
+      if (gatt_tcb_has_cid(gatt_cb.tcb[it->second], lcid)) {
+        return &gatt_cb.tcb[it->second];
+      }
+      gatt_cb.tcb_idx_by_cid.erase(it);
+    }
+  }
+
   for (xx = 0; xx < GATT_MAX_PHY_CHANNEL; xx++) {
-    if (gatt_cb.tcb[xx].in_use &&
-        ((gatt_cb.tcb[xx].att_lcid == lcid) ||
-         ((EattExtension::GetInstance()->FindEattChannelByCid(gatt_cb.tcb[xx].peer_bda,
-                                                      lcid) != nullptr)))) {
+    if (gatt_tcb_has_cid(gatt_cb.tcb[xx], lcid)) {
       p_tcb = &gatt_cb.tcb[xx];
+      if (use_index) gatt_cb.tcb_idx_by_cid[lcid] = xx;
       break;
     }
   }
@@ -1735,6 +1866,12 @@ void gatt_cleanup_upon_disc(const RawAddress& bda, tGATT_DISCONN_REASON reason,
     }
   }
 
+  for (auto it = gatt_cb.tcb_idx_by_cid.begin();
+       it != gatt_cb.tcb_idx_by_cid.end();) {
+    it = (it->second == p_tcb->tcb_idx) ? gatt_cb.tcb_idx_by_cid.erase(it)
+                                        : std::next(it);
+  }
+
   *p_tcb = tGATT_TCB();
   VLOG(1) << __func__ << ": exit";
 }
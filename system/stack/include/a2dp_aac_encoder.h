@@ -80,4 +80,11 @@ int a2dp_aac_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_aac_send_frames(uint64_t timestamp_us);
 
+// Set the callbacks to encode the AAC input audio data in place.
+void a2dp_aac_set_span_callbacks(const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks);
+
+// Set the AAC CBR bit rate to |percent| percent of the bit rate of the codec
+// config. Does nothing in VBR mode.
+void a2dp_aac_set_bitrate_percent(uint8_t percent);
+
 #endif  // A2DP_AAC_ENCODER_H
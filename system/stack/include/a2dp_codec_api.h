@@ -486,6 +486,18 @@ typedef uint32_t (*a2dp_source_read_callback_t)(uint8_t* p_buf, uint32_t len);
 typedef bool (*a2dp_source_enqueue_callback_t)(BT_HDR* p_buf, size_t frames_n,
                                                uint32_t num_bytes);
 
+// Callbacks to encode audio data in place, without copying it out of the
+// audio HAL data queue first.
+typedef struct {
+  // Sets |*p_buf| to |len| contiguous octets of audio data. Returns false when
+  // they are not available contiguously, in which case the data has to be
+  // read with the read callback instead.
+  bool (*peek)(const uint8_t** p_buf, uint32_t len);
+
+  // Consumes the |len| octets of audio data returned by |peek|, once encoded.
+  void (*release)(uint32_t len);
+} tA2DP_SOURCE_SPAN_CALLBACKS;
+
 //
 // A2DP encoder callbacks interface.
 //
@@ -521,6 +533,22 @@ typedef struct {
 
   // Set transmit queue length for the A2DP encoder.
   void (*set_transmit_queue_length)(size_t transmit_queue_length);
+
+  // Set the callbacks to encode the input audio data in place. Must be called
+  // after |encoder_init|, the encoder reads the data with |read_callback|
+  // until then.
+  void (*set_span_callbacks)(const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks);
+
+  // Reconfigure the running A2DP encoder with |a2dp_codec_config|, from the
+  // next encoded frame and without restarting the stream. Returns false if
+  // the new configuration needs the encoder to be initialized again, for
+  // instance when the audio feeding changes. May be null.
+  bool (*encoder_reconfigure)(A2dpCodecConfig* a2dp_codec_config);
+
+  // Set the bit rate of the encoder to |percent| percent of the bit rate of
+  // the current codec config, from the next encoded frame, to adapt to the
+  // capacity of the link. May be null.
+  void (*set_bitrate_percent)(uint8_t percent);
 } tA2DP_ENCODER_INTERFACE;
 
 // Prototype for a callback to receive decoded audio data from a
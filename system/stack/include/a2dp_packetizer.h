@@ -0,0 +1,61 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Utility functions to choose the number of codec frames in an A2DP media
+ *  packet, so that the packet fills the baseband packets of the ACL link.
+ *
+ ******************************************************************************/
+#ifndef A2DP_PACKETIZER_H
+#define A2DP_PACKETIZER_H
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *
+ * Function         A2DP_GetAclPacketPayloadSize
+ *
+ * Description      Returns the payload size of the largest baseband packet
+ *                  (DH5, 2-DH5 or 3-DH5) the link to the peer uses.
+ *
+ ******************************************************************************/
+uint16_t A2DP_GetAclPacketPayloadSize(bool is_peer_edr,
+                                      bool peer_supports_3mbps);
+
+/*******************************************************************************
+ *
+ * Function         A2DP_GetAclAlignedFrameCount
+ *
+ * Description      Chooses the number of frames of |frame_len| octets in a
+ *                  media packet, up to |max_frames|, so that the L2CAP PDU
+ *                  carries the most frames per baseband packet of
+ *                  |acl_payload_size| octets. |media_header_len| is the size
+ *                  of the codec media payload header.
+ *                  With equal efficiency, the largest frame count is chosen.
+ *
+ * Returns          The number of frames per packet, or |max_frames| when it
+ *                  is 0 or the frame length is unknown.
+ *
+ ******************************************************************************/
+uint8_t A2DP_GetAclAlignedFrameCount(uint16_t frame_len,
+                                     uint16_t media_header_len,
+                                     uint8_t max_frames,
+                                     uint16_t acl_payload_size);
+
+#endif  // A2DP_PACKETIZER_H
@@ -65,6 +65,13 @@ int a2dp_sbc_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_sbc_send_frames(uint64_t timestamp_us);
 
+// Set the callbacks to encode the SBC input audio data in place.
+void a2dp_sbc_set_span_callbacks(const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks);
+
+// Set the SBC bitpool to |percent| percent of the bitpool of the codec config,
+// and no less than its min bitpool.
+void a2dp_sbc_set_bitrate_percent(uint8_t percent);
+
 // Get SBC bitrate
 // Returns |uint32_t| bitrate in bits per second
 uint32_t a2dp_sbc_get_bitrate();
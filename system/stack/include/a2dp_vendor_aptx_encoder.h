@@ -64,6 +64,9 @@ int a2dp_vendor_aptx_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us);
 
+// Set the callbacks to encode the aptX input audio data in place.
+void a2dp_vendor_aptx_set_span_callbacks(const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks);
+
 typedef int (*tAPTX_ENCODER_INIT)(void* state, short endian);
 
 typedef int (*tAPTX_ENCODER_ENCODE_STEREO)(void* state, void* pcmL, void* pcmR,
@@ -44,6 +44,11 @@ void a2dp_vendor_ldac_encoder_init(
     a2dp_source_read_callback_t read_callback,
     a2dp_source_enqueue_callback_t enqueue_callback);
 
+// Reconfigure the running A2DP LDAC encoder with |a2dp_codec_config|.
+// Returns false if the new configuration needs the encoder to be initialized
+// again.
+bool a2dp_vendor_ldac_encoder_reconfigure(A2dpCodecConfig* a2dp_codec_config);
+
 // Cleanup the A2DP LDAC encoder.
 void a2dp_vendor_ldac_encoder_cleanup(void);
 
@@ -63,6 +68,9 @@ int a2dp_vendor_ldac_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_vendor_ldac_send_frames(uint64_t timestamp_us);
 
+// Set the callbacks to encode the LDAC input audio data in place.
+void a2dp_vendor_ldac_set_span_callbacks(const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks);
+
 // Set transmit queue length for the A2DP LDAC ABR(Adaptive Bit Rate) mechanism.
 void a2dp_vendor_ldac_set_transmit_queue_length(size_t transmit_queue_length);
 
@@ -49,6 +49,14 @@
 #define A2DP_OPUS_FUTURE_3 0x40
 #define A2DP_OPUS_FUTURE_4 0x80
 
+// Low latency mode, selected with codec_specific_2 of the codec config.
+// The Opus frames are then 5 or 2.5 ms long, one frame per media packet, and
+// coded without the music and speech lookahead. The frame duration is carried
+// in the TOC byte of each Opus packet, the negotiated frame size is unchanged.
+#define A2DP_OPUS_LOW_LATENCY_MASK 0x03
+#define A2DP_OPUS_LOW_LATENCY_5MS 0x01
+#define A2DP_OPUS_LOW_LATENCY_2_5MS 0x02
+
 // Length of the Opus Media Payload header
 #define A2DP_OPUS_MPL_HDR_LEN 1
 
@@ -50,6 +50,13 @@ uint64_t a2dp_vendor_opus_get_encoder_interval_ms(void);
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_vendor_opus_send_frames(uint64_t timestamp_us);
 
+// Set the callbacks to encode the Opus input audio data in place.
+void a2dp_vendor_opus_set_span_callbacks(const tA2DP_SOURCE_SPAN_CALLBACKS* callbacks);
+
+// Set the Opus bit rate to |percent| percent of the bit rate of the codec
+// config.
+void a2dp_vendor_opus_set_bitrate_percent(uint8_t percent);
+
 // Set transmit queue length for the A2DP Opus (Dynamic Bit Rate) mechanism.
 void a2dp_vendor_opus_set_transmit_queue_length(size_t transmit_queue_length);
 
@@ -688,6 +688,10 @@ void BTM_PM_OnConnected(uint16_t handle, const RawAddress& remote_bda);
 // Notified by ACL that a link is disconnected
 void BTM_PM_OnDisconnected(uint16_t handle);
 
+// Notified by ACL and L2CAP of the data sent and received on a BR/EDR link,
+// to predict its activity
+void BTM_PM_OnAclData(uint16_t handle);
+
 /*******************************************************************************
  *
  * Function         BTM_SetPowerMode
@@ -150,6 +150,13 @@ void BTM_BleDisableBatchScan(base::Callback<void(uint8_t /* status */)> cb);
 void BTM_BleReadScanReports(tBLE_SCAN_MODE scan_mode,
                             tBTM_BLE_SCAN_REP_CBACK cb);
 
+/* This function is called to stream batch scan reports. |cb| is run for each
+ * page of records as the controller returns them, instead of once with all the
+ * records, and a last time with no record when all the records were read. Only
+ * one page is held in memory at a time */
+void BTM_BleStreamScanReports(tBLE_SCAN_MODE scan_mode,
+                              tBTM_BLE_SCAN_REP_CBACK cb);
+
 /* This function is called to setup the callback for tracking */
 void BTM_BleTrackAdvertiser(tBTM_BLE_TRACK_ADV_CBACK* p_track_cback,
                             tBTM_BLE_REF_VALUE ref_value);
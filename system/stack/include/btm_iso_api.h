@@ -199,6 +199,16 @@ class IsoManager {
    */
   virtual void HandleIsoData(void* p_msg);
 
+  /**
+   * Gives back a transmitted Iso Data packet sent by SendIsoData()
+   *
+   * <p> Called by the HCI layer instead of freeing packets flagged with
+   * BT_ISO_HDR_FROM_SDU_POOL. Can be called from any thread.
+   *
+   * @param p_msg raw data packet. The ownership of p_msg is transferred.
+   */
+  virtual void ReleaseIsoSdu(void* p_msg);
+
   /**
    * Handles disconnect HCI event
    *
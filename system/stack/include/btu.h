@@ -29,9 +29,11 @@
 
 #include <base/functional/callback.h>
 #include <base/location.h>
+#include <base/logging.h>
 #include <base/threading/thread.h>
 
 #include <cstdint>
+#include <utility>
 
 #include "bt_target.h"
 #include "common/message_loop_thread.h"
@@ -73,4 +75,53 @@ bool is_on_main_thread();
 using BtMainClosure = std::function<void()>;
 void post_on_bt_main(BtMainClosure closure);
 
+/* Executors of the subsystems of the stack. A subsystem posts its work to its
+ * own executor and checks that its entry points are called on it. All the
+ * executors run on the main thread for now: a subsystem can only get a thread
+ * of its own once it no longer shares state with the others.
+ */
+enum class tBTU_EXECUTOR : uint8_t {
+  MAIN,
+  GATT,          /* GATT client and server */
+  AUDIO_CONTROL, /* AVDTP signaling and the AV state machine */
+};
+
+inline const char* btu_executor_text(tBTU_EXECUTOR executor) {
+  switch (executor) {
+    case tBTU_EXECUTOR::MAIN:
+      return "main";
+    case tBTU_EXECUTOR::GATT:
+      return "gatt";
+    case tBTU_EXECUTOR::AUDIO_CONTROL:
+      return "audio_control";
+  }
+  return "unknown";
+}
+
+inline bt_status_t do_in_executor(tBTU_EXECUTOR executor,
+                                  const base::Location& from_here,
+                                  base::OnceClosure task) {
+  return do_in_main_thread(from_here, std::move(task));
+}
+
+inline bt_status_t do_in_executor_delayed(tBTU_EXECUTOR executor,
+                                          const base::Location& from_here,
+                                          base::OnceClosure task,
+                                          const base::TimeDelta& delay) {
+  return do_in_main_thread_delayed(from_here, std::move(task), delay);
+}
+
+inline bool is_on_executor(tBTU_EXECUTOR executor) {
+  return is_on_main_thread();
+}
+
+/* Log an error when called off the given executor */
+inline void btu_check_executor_affinity(tBTU_EXECUTOR executor,
+                                        const char* caller) {
+  if (!is_on_executor(executor)) {
+    LOG(ERROR) << caller << " called off the "
+               << btu_executor_text(executor) << " executor";
+  }
+}
+
 #endif
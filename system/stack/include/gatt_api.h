@@ -23,6 +23,7 @@
 #include <cstdint>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "bt_target.h"
 #include "btm_ble_api.h"
@@ -942,6 +943,24 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
                                            uint16_t attr_handle,
                                            uint16_t val_len, uint8_t* p_val);
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleMultipleValueNotification
+ *
+ * Description      This function sends handle value notifications to a client,
+ *                  packed into multiple handle value notifications up to the
+ *                  MTU when the client supports them.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  notifs: handles and values of the notifications, sent in
+ *                          this order.
+ *
+ * Returns          GATT_SUCCESS if sucessfully sent; otherwise error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATTS_HandleMultipleValueNotification(
+    uint16_t conn_id, const std::vector<tGATT_VALUE>& notifs);
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -1049,6 +1068,21 @@ tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
 tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
                             uint16_t start_handle, uint16_t end_handle);
 
+/*******************************************************************************
+ *
+ * Function         GATTC_IsAdditionalBearerAvailable
+ *
+ * Description      This function checks if a client request sent now would be
+ *                  carried by EATT bearer without waiting for the requests
+ *                  already outstanding on the connection.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          true if an idle EATT bearer is available for the request.
+ *
+ ******************************************************************************/
+bool GATTC_IsAdditionalBearerAvailable(uint16_t conn_id);
+
 /*******************************************************************************
  *
  * Function         GATTC_Read
@@ -1297,6 +1331,9 @@ bool GATT_GetConnIdIfConnected(tGATT_IF gatt_if, const RawAddress& bd_addr,
 void GATT_ConfigServiceChangeCCC(const RawAddress& remote_bda, bool enable,
                                  tBT_TRANSPORT transport);
 
+// Dumps the queue depths of the GATT server traffic of each connection.
+void GATT_Dumpsys(int fd);
+
 // Enables the GATT profile on the device.
 // It clears out the control blocks, and registers with L2CAP.
 void gatt_init(void);
@@ -935,4 +935,19 @@ void L2CA_SetMediaStreamChannel(uint16_t local_media_cid, bool status);
 bool L2CA_isMediaChannel(uint16_t handle, uint16_t channel_id,
                          bool is_local_cid);
 
+/*******************************************************************************
+**
+** Function         L2CA_Dumpsys
+**
+** Description      This function dumps the state of the LE connection
+**                      oriented channels, with the throughput each one
+**                      achieves in both directions
+**
+**  Parameters:     fd: File descriptor to write to
+**
+** Returns          void
+**
+*******************************************************************************/
+void L2CA_Dumpsys(int fd);
+
 #endif /* L2C_API_H */
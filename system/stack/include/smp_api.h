@@ -47,6 +47,19 @@
  ******************************************************************************/
 void SMP_Init(void);
 
+/*******************************************************************************
+ *
+ * Function         SMP_FillKeyPool
+ *
+ * Description      This function starts generating the key pairs used by
+ *                  Secure Connections pairings ahead of time, once the
+ *                  controller is ready.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SMP_FillKeyPool(void);
+
 /*******************************************************************************
  *
  * Function         SMP_SetTraceLevel
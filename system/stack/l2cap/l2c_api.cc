@@ -38,6 +38,7 @@
 #include "gd/os/system_properties.h"
 #include "gd/os/metrics.h"
 #include "hci/include/btsnoop.h"
+#include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
 #include "main/shim/metrics_api.h"
 #include "osi/include/allocator.h"
@@ -1918,3 +1919,46 @@ bool L2CA_isMediaChannel(uint16_t handle, uint16_t channel_id,
 
   return ret;
 }
+
+#define DUMPSYS_TAG "shim::legacy::l2cap"
+void L2CA_Dumpsys(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+
+  LOG_DUMPSYS(fd, "LE credits default:%hu threshold:%hu",
+              L2CA_LeCreditDefault(), L2CA_LeCreditThreshold());
+  LOG_DUMPSYS(fd, "ACL window:%hu/%hu leaked:%d LE window:%hu/%hu leaked:%d",
+              l2cb.controller_xmit_window, l2cb.num_lm_acl_bufs,
+              l2c_link_get_leaked_xmit_window(BT_TRANSPORT_BR_EDR),
+              l2cb.controller_le_xmit_window, l2cb.num_lm_ble_bufs,
+              l2c_link_get_leaked_xmit_window(BT_TRANSPORT_LE));
+
+  const tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  for (int i = 0; i < MAX_L2CAP_LINKS; i++, p_lcb++) {
+    if (!p_lcb->in_use || p_lcb->transport != BT_TRANSPORT_LE) continue;
+    LOG_DUMPSYS(fd, "  peer:%s handle:0x%04x conn_interval:%hu tx_data_len:%hu",
+                ADDRESS_TO_LOGGABLE_CSTR(p_lcb->remote_bd_addr),
+                p_lcb->Handle(), p_lcb->conn_interval, p_lcb->tx_data_len);
+
+    for (const tL2C_CCB* p_ccb = p_lcb->ccb_queue.p_first_ccb; p_ccb;
+         p_ccb = p_ccb->p_next_ccb) {
+      if (p_ccb->local_cid < L2CAP_BASE_APPL_CID) continue;
+      LOG_DUMPSYS(fd,
+                  "    lcid:0x%04x rcid:0x%04x psm:0x%04x ecoc:%d "
+                  "local_mps:%hu peer_mps:%hu",
+                  p_ccb->local_cid, p_ccb->remote_cid,
+                  p_ccb->p_rcb ? p_ccb->p_rcb->real_psm : 0, p_ccb->ecoc,
+                  p_ccb->local_conn_cfg.mps, p_ccb->peer_conn_cfg.mps);
+      LOG_DUMPSYS(fd,
+                  "      rx_bytes_per_sec:%-8u rx_pdu_len:%-5hu "
+                  "credits_granted:%hu",
+                  p_ccb->le_rx_rate.bytes_per_sec, p_ccb->le_rx_rate.pdu_len,
+                  p_ccb->remote_credit_count);
+      LOG_DUMPSYS(fd,
+                  "      tx_bytes_per_sec:%-8u tx_pdu_len:%-5hu "
+                  "credits_held:%hu",
+                  p_ccb->le_tx_rate.bytes_per_sec, p_ccb->le_tx_rate.pdu_len,
+                  p_ccb->peer_conn_cfg.credits);
+    }
+  }
+}
+#undef DUMPSYS_TAG
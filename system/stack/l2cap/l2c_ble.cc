@@ -286,6 +286,7 @@ bool l2cble_conn_comp(uint16_t handle, uint8_t role, const RawAddress& bda,
   /* update link parameter, set peripheral link as non-spec default upon link up
    */
   p_lcb->min_interval = p_lcb->max_interval = conn_interval;
+  p_lcb->conn_interval = conn_interval;
   p_lcb->timeout = conn_timeout;
   p_lcb->latency = conn_latency;
   p_lcb->conn_update_mask = L2C_BLE_NOT_DEFAULT_PARAM;
@@ -435,6 +436,8 @@ void l2cble_process_conn_update_evt(uint16_t handle, uint8_t status,
 
   if (status != HCI_SUCCESS) {
     L2CAP_TRACE_WARNING("%s: Error status: %d", __func__, status);
+  } else {
+    p_lcb->conn_interval = interval;
   }
 
   l2cble_start_conn_update(p_lcb);
@@ -1213,7 +1213,7 @@ static void l2c_csm_config(tL2C_CCB* p_ccb, tL2CEVT event, void* p_data) {
         if (p_ccb->local_cid < L2CAP_BASE_APPL_CID) {
           if (l2cb.fixed_reg[p_ccb->local_cid - L2CAP_FIRST_FIXED_CHNL]
                   .pL2CA_FixedData_Cb != nullptr) {
-            p_ccb->metrics.rx(static_cast<BT_HDR*>(p_data)->len);
+            l2cu_count_rx_data(p_ccb, static_cast<BT_HDR*>(p_data)->len);
             (*l2cb.fixed_reg[p_ccb->local_cid - L2CAP_FIRST_FIXED_CHNL]
                   .pL2CA_FixedData_Cb)(p_ccb->local_cid,
                                        p_ccb->p_lcb->remote_bd_addr,
@@ -1224,7 +1224,7 @@ static void l2c_csm_config(tL2C_CCB* p_ccb, tL2CEVT event, void* p_data) {
           break;
         }
       }
-      if (p_data) p_ccb->metrics.rx(static_cast<BT_HDR*>(p_data)->len);
+      if (p_data) l2cu_count_rx_data(p_ccb, static_cast<BT_HDR*>(p_data)->len);
       (*p_ccb->p_rcb->api.pL2CA_DataInd_Cb)(p_ccb->local_cid, (BT_HDR*)p_data);
       break;
 
@@ -1366,7 +1366,7 @@ static void l2c_csm_open(tL2C_CCB* p_ccb, tL2CEVT event, void* p_data) {
 
     case L2CEVT_L2CAP_DATA: /* Peer data packet rcvd    */
       if (p_data && (p_ccb->p_rcb) && (p_ccb->p_rcb->api.pL2CA_DataInd_Cb)) {
-        p_ccb->metrics.rx(static_cast<BT_HDR*>(p_data)->len);
+        l2cu_count_rx_data(p_ccb, static_cast<BT_HDR*>(p_data)->len);
         (*p_ccb->p_rcb->api.pL2CA_DataInd_Cb)(p_ccb->local_cid,
                                               (BT_HDR*)p_data);
       }
@@ -1694,7 +1694,7 @@ static const char* l2c_csm_get_event_name(tL2CEVT event) {
 void l2c_enqueue_peer_data(tL2C_CCB* p_ccb, BT_HDR* p_buf) {
   CHECK(p_ccb != nullptr);
 
-  p_ccb->metrics.tx(p_buf->len);
+  l2cu_count_tx_data(p_ccb, p_buf->len);
 
   uint8_t* p;
 
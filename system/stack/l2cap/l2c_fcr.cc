@@ -29,6 +29,7 @@
 #include <string.h>
 
 #include "common/time_util.h"
+#include "gd/l2cap/fcs.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "stack/include/bt_hdr.h"
@@ -48,39 +49,6 @@ static const char* SAR_types[] = {"Unsegmented", "Start", "End",
                                   "Continuation"};
 static const char* SUP_types[] = {"RR", "REJ", "RNR", "SREJ"};
 
-/* Look-up table for the CRC calculation */
-static const unsigned short crctab[256] = {
-    0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241, 0xc601,
-    0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440, 0xcc01, 0x0cc0,
-    0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40, 0x0a00, 0xcac1, 0xcb81,
-    0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841, 0xd801, 0x18c0, 0x1980, 0xd941,
-    0x1b00, 0xdbc1, 0xda81, 0x1a40, 0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01,
-    0x1dc0, 0x1c80, 0xdc41, 0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0,
-    0x1680, 0xd641, 0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081,
-    0x1040, 0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
-    0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441, 0x3c00,
-    0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41, 0xfa01, 0x3ac0,
-    0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840, 0x2800, 0xe8c1, 0xe981,
-    0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41, 0xee01, 0x2ec0, 0x2f80, 0xef41,
-    0x2d00, 0xedc1, 0xec81, 0x2c40, 0xe401, 0x24c0, 0x2580, 0xe541, 0x2700,
-    0xe7c1, 0xe681, 0x2640, 0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0,
-    0x2080, 0xe041, 0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281,
-    0x6240, 0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
-    0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41, 0xaa01,
-    0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840, 0x7800, 0xb8c1,
-    0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41, 0xbe01, 0x7ec0, 0x7f80,
-    0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40, 0xb401, 0x74c0, 0x7580, 0xb541,
-    0x7700, 0xb7c1, 0xb681, 0x7640, 0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101,
-    0x71c0, 0x7080, 0xb041, 0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0,
-    0x5280, 0x9241, 0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481,
-    0x5440, 0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
-    0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841, 0x8801,
-    0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40, 0x4e00, 0x8ec1,
-    0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41, 0x4400, 0x84c1, 0x8581,
-    0x4540, 0x8701, 0x47c0, 0x4680, 0x8641, 0x8201, 0x42c0, 0x4380, 0x8341,
-    0x4100, 0x81c1, 0x8081, 0x4040,
-};
-
 /*******************************************************************************
  *  Static local functions
 */
@@ -98,22 +66,18 @@ static bool do_sar_reassembly(tL2C_CCB* p_ccb, BT_HDR* p_buf,
  *
  * Function         l2c_fcr_updcrc
  *
- * Description      This function computes the CRC using the look-up table.
+ * Description      This function computes the CRC, shared with the GD L2CAP
+ *                  which processes eight bytes per step.
  *
  * Returns          CRC
  *
  ******************************************************************************/
-static unsigned short l2c_fcr_updcrc(unsigned short icrc, unsigned char* icp,
-                                     int icnt) {
-  unsigned short crc = icrc;
-  unsigned char* cp = icp;
-  int cnt = icnt;
-
-  while (cnt--) {
-    crc = ((crc >> 8) & 0xff) ^ crctab[(crc & 0xff) ^ *cp++];
-  }
-
-  return (crc);
+static uint16_t l2c_fcr_updcrc(const uint8_t* p, uint16_t len) {
+  static_assert(L2CAP_FCR_INIT_CRC == 0, "Fcs::Initialize() sets the CRC to 0");
+  bluetooth::l2cap::Fcs fcs;
+  fcs.Initialize();
+  fcs.AddBytes(p, len);
+  return fcs.GetChecksum();
 }
 
 /*******************************************************************************
@@ -128,7 +92,7 @@ static unsigned short l2c_fcr_updcrc(unsigned short icrc, unsigned char* icp,
 static uint16_t l2c_fcr_tx_get_fcs(BT_HDR* p_buf) {
   uint8_t* p = ((uint8_t*)(p_buf + 1)) + p_buf->offset;
 
-  return (l2c_fcr_updcrc(L2CAP_FCR_INIT_CRC, p, p_buf->len));
+  return (l2c_fcr_updcrc(p, p_buf->len));
 }
 
 /*******************************************************************************
@@ -146,8 +110,7 @@ static uint16_t l2c_fcr_rx_get_fcs(BT_HDR* p_buf) {
   /* offset points past the L2CAP header, but the CRC check includes it */
   p -= L2CAP_PKT_OVERHEAD;
 
-  return (
-      l2c_fcr_updcrc(L2CAP_FCR_INIT_CRC, p, p_buf->len + L2CAP_PKT_OVERHEAD));
+  return (l2c_fcr_updcrc(p, p_buf->len + L2CAP_PKT_OVERHEAD));
 }
 
 /*******************************************************************************
@@ -212,15 +175,16 @@ void l2c_fcr_cleanup(tL2C_CCB* p_ccb) {
 
   osi_free_and_reset((void**)&p_fcrb->p_rx_sdu);
 
+  /* The retransmit queue only references frames owned by waiting_for_ack_q */
+  fixed_queue_free(p_fcrb->retrans_q, NULL);
+  p_fcrb->retrans_q = NULL;
+
   fixed_queue_free(p_fcrb->waiting_for_ack_q, osi_free);
   p_fcrb->waiting_for_ack_q = NULL;
 
   fixed_queue_free(p_fcrb->srej_rcv_hold_q, osi_free);
   p_fcrb->srej_rcv_hold_q = NULL;
 
-  fixed_queue_free(p_fcrb->retrans_q, osi_free);
-  p_fcrb->retrans_q = NULL;
-
   memset(p_fcrb, 0, sizeof(tL2C_FCRB));
 }
 
@@ -242,7 +206,7 @@ BT_HDR* l2c_fcr_clone_buf(BT_HDR* p_buf, uint16_t new_offset,
    * the FCS (Frame Check Sequence) at the end of the buffer.
    */
   uint16_t buf_size = no_of_bytes + sizeof(BT_HDR) + new_offset + L2CAP_FCS_LEN;
-  BT_HDR* p_buf2 = (BT_HDR*)osi_malloc(buf_size);
+  BT_HDR* p_buf2 = (BT_HDR*)osi_malloc_packet(buf_size);
 
   p_buf2->offset = new_offset;
   p_buf2->len = no_of_bytes;
@@ -720,7 +684,7 @@ void l2c_lcc_proc_pdu(tL2C_CCB* p_ccb, BT_HDR* p_buf) {
       return;
     }
 
-    p_data = (BT_HDR*)osi_malloc(BT_HDR_SIZE + sdu_length);
+    p_data = (BT_HDR*)osi_malloc_packet(BT_HDR_SIZE + sdu_length);
     if (p_data == NULL) {
       osi_free(p_buf);
       return;
@@ -884,6 +848,10 @@ static bool process_reqseq(tL2C_CCB* p_ccb, uint16_t ctrl_word) {
       if ((ls == L2CAP_FCR_UNSEG_SDU) || (ls == L2CAP_FCR_END_SDU))
         full_sdus_xmitted++;
 
+      /* Drop any pending retransmission of the frame, it is no longer needed */
+      while (fixed_queue_try_remove_from_queue(p_fcrb->retrans_q, p_tmp))
+        ;
+
       osi_free(p_tmp);
     }
 
@@ -1203,7 +1171,7 @@ static bool do_sar_reassembly(tL2C_CCB* p_ccb, BT_HDR* p_buf,
                             p_fcrb->rx_sdu_len, p_ccb->max_rx_mtu);
         packet_ok = false;
       } else {
-        p_fcrb->p_rx_sdu = (BT_HDR*)osi_malloc(
+        p_fcrb->p_rx_sdu = (BT_HDR*)osi_malloc_packet(
             BT_HDR_SIZE + OBX_BUF_MIN_OFFSET + p_fcrb->rx_sdu_len);
         p_fcrb->p_rx_sdu->offset = OBX_BUF_MIN_OFFSET;
         p_fcrb->p_rx_sdu->len = 0;
@@ -1341,8 +1309,7 @@ static bool retransmit_i_frames(tL2C_CCB* p_ccb, uint8_t tx_seq) {
     }
 
     /* Also flush our retransmission queue */
-    while (!fixed_queue_is_empty(p_ccb->fcrb.retrans_q))
-      osi_free(fixed_queue_try_dequeue(p_ccb->fcrb.retrans_q));
+    fixed_queue_flush(p_ccb->fcrb.retrans_q, NULL);
 
     if (list_ack != NULL) node_ack = list_begin(list_ack);
   }
@@ -1352,14 +1319,10 @@ static bool retransmit_i_frames(tL2C_CCB* p_ccb, uint8_t tx_seq) {
       p_buf = (BT_HDR*)list_node(node_ack);
       node_ack = list_next(node_ack);
 
-      BT_HDR* p_buf2 = l2c_fcr_clone_buf(p_buf, p_buf->offset, p_buf->len);
-      if (p_buf2) {
-        p_buf2->layer_specific = p_buf->layer_specific;
-
-        fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf2);
-      }
+      /* Queue a reference only, the frame is copied when it is sent */
+      fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf);
 
-      if ((tx_seq != L2C_FCR_RETX_ALL_PKTS) || (p_buf2 == NULL)) break;
+      if (tx_seq != L2C_FCR_RETX_ALL_PKTS) break;
     }
   }
 
@@ -1390,14 +1353,20 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
       mid_seg = false,    /* The segment is the middle part of data */
       last_seg = false;   /* The segment is the last part of data   */
   uint16_t sdu_len = 0;
-  BT_HDR *p_buf, *p_xmit;
+  BT_HDR *p_buf, *p_xmit, *p_wack;
   uint8_t* p;
   uint16_t max_pdu = p_ccb->tx_mps /* Needed? - L2CAP_MAX_HEADER_FCS*/;
 
   /* If there is anything in the retransmit queue, that goes first
   */
-  p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->fcrb.retrans_q);
-  if (p_buf != NULL) {
+  p_wack = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->fcrb.retrans_q);
+  if (p_wack != NULL) {
+    /* The queued frame stays in waiting_for_ack_q until it is acked, so send
+     * a copy. This is the only copy made for a retransmission, since the
+     * lower layer takes ownership of the buffer it is given. */
+    p_buf = l2c_fcr_clone_buf(p_wack, p_wack->offset, p_wack->len);
+    p_buf->layer_specific = p_wack->layer_specific;
+
     /* Update Rx Seq and FCS if we acked some packets while this one was queued
      */
     prepare_I_frame(p_ccb, p_buf, true);
@@ -1494,8 +1463,7 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
   prepare_I_frame(p_ccb, p_xmit, false);
 
   if (p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE) {
-    BT_HDR* p_wack =
-        l2c_fcr_clone_buf(p_xmit, HCI_DATA_PREAMBLE_SIZE, p_xmit->len);
+    p_wack = l2c_fcr_clone_buf(p_xmit, HCI_DATA_PREAMBLE_SIZE, p_xmit->len);
 
     if (!p_wack) {
       L2CAP_TRACE_ERROR(
@@ -1535,35 +1503,46 @@ BT_HDR* l2c_lcc_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
       p_buf->len,
       (uint16_t)(first_pdu ? (max_pdu - L2CAP_LCC_SDU_LENGTH) : max_pdu));
   bool last_pdu = (no_of_bytes_to_send == p_buf->len);
+  uint16_t sdu_len = p_buf->len;
+
+  /* The last segment, or an unsegmented SDU, is sent straight out of the SDU
+   * buffer when there is room in front of the data for the headers. Only the
+   * segments before it need a buffer of their own, since the SDU buffer is
+   * still needed for the rest of the data. */
+  BT_HDR* p_xmit;
+  if (last_pdu &&
+      p_buf->offset >= (first_pdu ? L2CAP_LCC_OFFSET : L2CAP_MIN_OFFSET)) {
+    p_xmit = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->xmit_hold_q);
+  } else {
+    /* Get a new buffer and copy the data that can be sent in a PDU */
+    p_xmit = l2c_fcr_clone_buf(
+        p_buf, first_pdu ? L2CAP_LCC_OFFSET : L2CAP_MIN_OFFSET,
+        no_of_bytes_to_send);
 
-  /* Get a new buffer and copy the data that can be sent in a PDU */
-  BT_HDR* p_xmit =
-      l2c_fcr_clone_buf(p_buf, first_pdu ? L2CAP_LCC_OFFSET : L2CAP_MIN_OFFSET,
-                        no_of_bytes_to_send);
+    /* copy PBF setting */
+    p_xmit->layer_specific = p_buf->layer_specific;
+
+    p_buf->event = p_ccb->local_cid;
+    p_buf->len -= no_of_bytes_to_send;
+    p_buf->offset += no_of_bytes_to_send;
+
+    if (last_pdu) {
+      p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->xmit_hold_q);
+      osi_free(p_buf);
+    }
+  }
 
-  p_buf->event = p_ccb->local_cid;
   p_xmit->event = p_ccb->local_cid;
 
   if (first_pdu) {
     p_xmit->offset -= L2CAP_LCC_SDU_LENGTH; /* for writing the SDU length. */
     uint8_t* p = (uint8_t*)(p_xmit + 1) + p_xmit->offset;
-    UINT16_TO_STREAM(p, p_buf->len);
+    UINT16_TO_STREAM(p, sdu_len);
     p_xmit->len += L2CAP_LCC_SDU_LENGTH;
   }
 
-  p_buf->len -= no_of_bytes_to_send;
-  p_buf->offset += no_of_bytes_to_send;
-
-  /* copy PBF setting */
-  p_xmit->layer_specific = p_buf->layer_specific;
-
   if (last_piece_of_sdu) *last_piece_of_sdu = last_pdu;
 
-  if (last_pdu) {
-    p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->xmit_hold_q);
-    osi_free(p_buf);
-  }
-
   /* Step back to add the L2CAP headers */
   p_xmit->offset -= L2CAP_PKT_OVERHEAD;
   p_xmit->len += L2CAP_PKT_OVERHEAD;
@@ -1574,9 +1553,103 @@ BT_HDR* l2c_lcc_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
   /* Note: if FCS has to be included then the length is recalculated later */
   UINT16_TO_STREAM(p, p_xmit->len - L2CAP_PKT_OVERHEAD);
   UINT16_TO_STREAM(p, p_ccb->remote_cid);
+
+  l2c_lcc_update_rate(&p_ccb->le_tx_rate, p_xmit->len - L2CAP_PKT_OVERHEAD);
   return (p_xmit);
 }
 
+/* Length of a throughput sampling window */
+#define L2C_LE_RATE_WINDOW_MS 250
+
+/* Time assumed between running low on credits and the peer sending again
+ * with the new ones, on top of the two connection events needed to deliver
+ * the credits and get the next PDU back */
+#define L2C_LE_CREDIT_SLACK_MS 20
+
+/*******************************************************************************
+ *
+ * Function         l2c_lcc_update_rate
+ *
+ * Description      Account a PDU of length len in the throughput estimate of
+ *                  an LE CoC channel.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void l2c_lcc_update_rate(tL2C_LE_RATE* p_rate, uint16_t len) {
+  CHECK(p_rate != NULL);
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  if (p_rate->window_start_ms == 0) p_rate->window_start_ms = now_ms;
+
+  p_rate->window_bytes += len;
+  p_rate->window_pdus++;
+
+  uint64_t elapsed_ms = now_ms - p_rate->window_start_ms;
+  if (elapsed_ms < L2C_LE_RATE_WINDOW_MS) return;
+
+  uint32_t sample = (uint32_t)(p_rate->window_bytes * 1000ULL / elapsed_ms);
+  uint16_t pdu_len = p_rate->window_bytes / p_rate->window_pdus;
+
+  /* Weight the new sample by 1/4, or take it as is for the first window */
+  if (p_rate->bytes_per_sec == 0) {
+    p_rate->bytes_per_sec = sample;
+    p_rate->pdu_len = pdu_len;
+  } else {
+    p_rate->bytes_per_sec = (3ULL * p_rate->bytes_per_sec + sample) / 4;
+    p_rate->pdu_len = (3U * p_rate->pdu_len + pdu_len) / 4;
+  }
+
+  p_rate->window_start_ms = now_ms;
+  p_rate->window_bytes = 0;
+  p_rate->window_pdus = 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_lcc_get_credits_to_grant
+ *
+ * Description      Called after a PDU was received on an LE CoC channel to
+ *                  decide whether credits must be returned to the peer.
+ *
+ *                  The number of credits the peer holds is kept at least at
+ *                  L2CA_LeCreditDefault(), and raised to cover what the peer
+ *                  can send, at the measured rate, while the next credits
+ *                  are on their way, so that a fast link never stalls waiting
+ *                  for credits. Credits are returned once the peer is down
+ *                  to half of that, or to L2CA_LeCreditThreshold().
+ *
+ * Returns          Number of credits to send, 0 if none.
+ *
+ ******************************************************************************/
+uint16_t l2c_lcc_get_credits_to_grant(tL2C_CCB* p_ccb) {
+  CHECK(p_ccb != NULL);
+  CHECK(p_ccb->p_lcb != NULL);
+  const tL2C_LE_RATE& rate = p_ccb->le_rx_rate;
+
+  /* Before the first estimate assume full sized PDUs */
+  uint32_t pdu_len = rate.pdu_len;
+  if (pdu_len == 0) pdu_len = p_ccb->local_conn_cfg.mps;
+  if (pdu_len == 0) pdu_len = 1;
+
+  uint32_t interval = p_ccb->p_lcb->conn_interval;
+  if (interval == 0) interval = BTM_BLE_CONN_INT_MIN;
+  uint32_t refill_ms = 2 * interval * 5 / 4 + L2C_LE_CREDIT_SLACK_MS;
+
+  /* Twice the PDUs in flight during a refill, so the watermark covers it */
+  uint64_t needed = 2ULL * rate.bytes_per_sec * refill_ms / 1000 / pdu_len;
+  uint16_t target = std::max<uint64_t>(
+      L2CA_LeCreditDefault(), std::min<uint64_t>(needed, L2CAP_LE_CREDIT_MAX));
+
+  uint16_t low_watermark = std::max<uint16_t>(L2CA_LeCreditThreshold(),
+                                              target / 2);
+  if (p_ccb->remote_credit_count > low_watermark) return 0;
+
+  uint16_t credits = target - p_ccb->remote_credit_count;
+  p_ccb->remote_credit_count = target;
+  return credits;
+}
+
 /*******************************************************************************
  * Configuration negotiation functions
  *
@@ -31,6 +31,7 @@
 
 #include "btm_api.h"
 #include "btm_ble_api.h"
+#include "gd/common/traffic_telemetry.h"
 #include "l2c_api.h"
 #include "l2cap_acl_interface.h"
 #include "l2cap_controller_interface.h"
@@ -49,6 +50,9 @@
 
 #define MAX_ACTIVE_AVDT_CONN 2
 
+/* Number of ACL connection handles, as they are 12 bits */
+#define L2C_NUM_ACL_HANDLES 0x1000
+
 constexpr uint16_t L2CAP_CREDIT_BASED_MIN_MTU = 64;
 constexpr uint16_t L2CAP_CREDIT_BASED_MIN_MPS = 64;
 
@@ -68,6 +72,8 @@ constexpr uint16_t L2CAP_CREDIT_BASED_MIN_MPS = 64;
 #define L2CAP_WAIT_INFO_RSP_TIMEOUT_MS (3 * 1000)      /* 3 seconds */
 #define L2CAP_BLE_LINK_CONNECT_TIMEOUT_MS (30 * 1000)  /* 30 seconds */
 #define L2CAP_FCR_ACK_TIMEOUT_MS 200                   /* 200 milliseconds */
+/* Tolerated delay of the link idle timeout, to coalesce it with other alarms */
+#define L2CAP_LINK_IDLE_TIMEOUT_SLACK_MS 500
 
 /* Define the possible L2CAP channel states. The names of
  * the states may seem a bit strange, but they are taken from
@@ -247,7 +253,7 @@ typedef struct {
   fixed_queue_t*
       waiting_for_ack_q;          /* Buffers sent and waiting for peer to ack */
   fixed_queue_t* srej_rcv_hold_q; /* Buffers rcvd but held pending SREJ rsp */
-  fixed_queue_t* retrans_q;       /* Buffers being retransmitted */
+  fixed_queue_t* retrans_q;       /* Unacked buffers to retransmit (not owned) */
 
   alarm_t* ack_timer;         /* Timer delaying RR */
   alarm_t* mon_retrans_timer; /* Timer Monitor or Retransmission */
@@ -283,6 +289,17 @@ typedef struct {
   void* p_ref_data;
 } tL2CAP_SEC_DATA;
 
+/* Throughput estimate of an LE CoC channel, sampled over short windows and
+ * smoothed. Used to size the credits granted to the peer and for dumpsys.
+ */
+typedef struct {
+  uint64_t window_start_ms{0};
+  uint32_t window_bytes{0};
+  uint32_t window_pdus{0};
+  uint32_t bytes_per_sec{0}; /* Smoothed throughput */
+  uint16_t pdu_len{0};       /* Smoothed PDU length */
+} tL2C_LE_RATE;
+
 /* Define a channel control block (CCB). There may be many channel control
  * blocks between the same two Bluetooth devices (i.e. on the same link).
  * Each CCB has unique local and remote CIDs. All channel control blocks on
@@ -355,6 +372,10 @@ typedef struct t_l2c_ccb {
    * remote). Valid only for LE CoC */
   uint16_t remote_credit_count;
 
+  /* Achieved LE CoC throughput in each direction. Valid only for LE CoC */
+  tL2C_LE_RATE le_rx_rate;
+  tL2C_LE_RATE le_tx_rate;
+
   /* used to indicate that ECOC is used */
   bool ecoc{false};
   bool reconfig_started;
@@ -380,6 +401,9 @@ typedef struct t_l2c_ccb {
     } dropped;
   } metrics;
 
+  /* Per channel telemetry, registered with the first data of the channel */
+  bluetooth::common::TrafficCounters* traffic_counters{nullptr};
+
 } tL2C_CCB;
 
 /***********************************************************************
@@ -540,6 +564,7 @@ typedef struct t_l2c_linkcb {
 
   uint16_t min_interval; /* parameters as requested by peripheral */
   uint16_t max_interval;
+  uint16_t conn_interval; /* current connection interval, 1.25 ms units */
   uint16_t latency;
   uint16_t timeout;
   uint16_t min_ce_len;
@@ -610,6 +635,10 @@ typedef struct {
   bool is_cong_cback_context;
 
   tL2C_LCB lcb_pool[MAX_L2CAP_LINKS];    /* Link Control Block pool */
+  /* 1 + index in lcb_pool of the LCB of each ACL handle, 0 if none */
+  uint8_t lcb_index_by_handle[L2C_NUM_ACL_HANDLES];
+  /* L2C_LCB_BIT of the LCBs which may have data queued */
+  uint32_t lcb_pending_mask;
   tL2C_CCB ccb_pool[MAX_L2CAP_CHANNELS]; /* Channel Control Block pool */
   tL2C_RCB rcb_pool[MAX_L2CAP_CLIENTS];  /* Registration info pool */
 
@@ -658,6 +687,12 @@ typedef struct {
 
 } tL2C_CB;
 
+static_assert(MAX_L2CAP_LINKS < 0xFF,
+              "lcb_index_by_handle does not fit the LCB indexes");
+static_assert(MAX_L2CAP_LINKS <= 32, "lcb_pending_mask has a bit per LCB");
+
+#define L2C_LCB_BIT(p_lcb) (1u << ((p_lcb) - &l2cb.lcb_pool[0]))
+
 /* Define a structure that contains the information about a connection.
  * This structure is used to pass between functions, and not all the
  * fields will always be filled in.
@@ -721,6 +756,8 @@ void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority);
 
 tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid);
 void l2cu_release_ccb(tL2C_CCB* p_ccb);
+void l2cu_count_rx_data(tL2C_CCB* p_ccb, uint16_t len);
+void l2cu_count_tx_data(tL2C_CCB* p_ccb, uint16_t len);
 tL2C_CCB* l2cu_find_ccb_by_cid(tL2C_LCB* p_lcb, uint16_t local_cid);
 tL2C_CCB* l2cu_find_ccb_by_remote_cid(tL2C_LCB* p_lcb, uint16_t remote_cid);
 bool l2c_is_cmd_rejected(uint8_t cmd_code, uint8_t id, tL2C_LCB* p_lcb);
@@ -814,6 +851,8 @@ void l2c_info_resp_timer_timeout(void* data);
 void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
                               BT_HDR* p_buf);
 void l2c_link_adjust_allocation(void);
+int l2c_link_get_leaked_xmit_window(tBT_TRANSPORT transport);
+void l2c_link_reclaim_leaked_xmit_window(void);
 
 void l2c_link_sec_comp(const RawAddress* p_bda, tBT_TRANSPORT trasnport,
                        void* p_ref_data, tBTM_STATUS status);
@@ -850,6 +889,8 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
 void l2c_fcr_start_timer(tL2C_CCB* p_ccb);
 void l2c_lcc_proc_pdu(tL2C_CCB* p_ccb, BT_HDR* p_buf);
 BT_HDR* l2c_lcc_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb, bool* last_piece_of_sdu);
+void l2c_lcc_update_rate(tL2C_LE_RATE* p_rate, uint16_t len);
+uint16_t l2c_lcc_get_credits_to_grant(tL2C_CCB* p_ccb);
 
 /* Configuration negotiation */
 uint8_t l2c_fcr_chk_chan_modes(tL2C_CCB* p_ccb);
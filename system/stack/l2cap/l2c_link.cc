@@ -57,6 +57,7 @@ void btm_sco_acl_removed(const RawAddress* bda);
 
 static void l2c_link_send_to_lower(tL2C_LCB* p_lcb, BT_HDR* p_buf);
 static BT_HDR* l2cu_get_next_buffer_to_send(tL2C_LCB* p_lcb);
+static bool l2c_link_has_queued_data(tL2C_LCB* p_lcb);
 
 /*******************************************************************************
  *
@@ -898,6 +899,12 @@ void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
                               BT_HDR* p_buf) {
   bool single_write = false;
 
+  /* Data is always queued before the link is checked, so the round robin only
+   * has to visit the links which were checked since they were last found
+   * without data.
+   */
+  if (p_lcb) l2cb.lcb_pending_mask |= L2C_LCB_BIT(p_lcb);
+
   /* Save the channel ID for faster counting */
   if (p_buf) {
     p_buf->event = local_cid;
@@ -941,6 +948,9 @@ void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
       /* Check for wraparound */
       if (p_lcb == &l2cb.lcb_pool[MAX_L2CAP_LINKS]) p_lcb = &l2cb.lcb_pool[0];
 
+      /* No data queued on this link */
+      if (!(l2cb.lcb_pending_mask & L2C_LCB_BIT(p_lcb))) continue;
+
       /* If controller window is full, nothing to do */
       if (((l2cb.controller_xmit_window == 0 ||
             (l2cb.round_robin_unacked >= l2cb.round_robin_quota)) &&
@@ -976,6 +986,8 @@ void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
         if (p_buf != NULL) {
           LOG_DEBUG("Sending next buffer");
           l2c_link_send_to_lower(p_lcb, p_buf);
+        } else if (!l2c_link_has_queued_data(p_lcb)) {
+          l2cb.lcb_pending_mask &= ~L2C_LCB_BIT(p_lcb);
         }
       }
     }
@@ -1155,6 +1167,60 @@ void l2c_packets_completed(uint16_t handle, uint16_t num_sent) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         l2c_link_get_leaked_xmit_window
+ *
+ * Description      Count the controller buffers taken from the transmit
+ *                  window of the transport that no link is waiting on.
+ *
+ * Returns          number of leaked buffers, negative if the window holds
+ *                  more buffers than the controller has
+ *
+ ******************************************************************************/
+int l2c_link_get_leaked_xmit_window(tBT_TRANSPORT transport) {
+  int sent_not_acked = 0;
+  const tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  for (int xx = 0; xx < MAX_L2CAP_LINKS; xx++, p_lcb++) {
+    if (p_lcb->in_use && p_lcb->transport == transport) {
+      sent_not_acked += p_lcb->sent_not_acked;
+    }
+  }
+
+  if (transport == BT_TRANSPORT_LE) {
+    return l2cb.num_lm_ble_bufs - l2cb.controller_le_xmit_window -
+           sent_not_acked;
+  }
+  return l2cb.num_lm_acl_bufs - l2cb.controller_xmit_window - sent_not_acked;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_link_reclaim_leaked_xmit_window
+ *
+ * Description      Return to the transmit windows the buffers that no link
+ *                  is waiting on, so that a link that went away before its
+ *                  packets were completed does not keep them forever.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void l2c_link_reclaim_leaked_xmit_window(void) {
+  int leaked = l2c_link_get_leaked_xmit_window(BT_TRANSPORT_BR_EDR);
+  if (leaked > 0) {
+    LOG_ERROR("Reclaiming %d ACL buffers not accounted for by any link",
+              leaked);
+    l2cb.controller_xmit_window += leaked;
+  }
+
+  leaked = l2c_link_get_leaked_xmit_window(BT_TRANSPORT_LE);
+  if (leaked > 0) {
+    LOG_ERROR("Reclaiming %d LE ACL buffers not accounted for by any link",
+              leaked);
+    l2cb.controller_le_xmit_window += leaked;
+  }
+}
+
 /*******************************************************************************
  *
  * Function         l2c_link_segments_xmitted
@@ -1323,6 +1389,36 @@ tL2C_CCB* l2cu_get_next_channel_in_rr(tL2C_LCB* p_lcb) {
   return p_serve_ccb;
 }
 
+/******************************************************************************
+ *
+ * Function         l2c_link_has_queued_data
+ *
+ * Description      Check if the link, or any channel on it, still holds data
+ *                  to send, whether or not it may be sent right now.
+ *
+ * Returns          true if there is data queued
+ *
+ ******************************************************************************/
+static bool l2c_ccb_has_queued_data(const tL2C_CCB* p_ccb) {
+  return !fixed_queue_is_empty(p_ccb->xmit_hold_q) ||
+         !fixed_queue_is_empty(p_ccb->fcrb.retrans_q);
+}
+
+static bool l2c_link_has_queued_data(tL2C_LCB* p_lcb) {
+  if (!list_is_empty(p_lcb->link_xmit_data_q)) return true;
+
+  for (int xx = 0; xx < L2CAP_NUM_FIXED_CHNLS; xx++) {
+    tL2C_CCB* p_ccb = p_lcb->p_fixed_ccbs[xx];
+    if (p_ccb != NULL && l2c_ccb_has_queued_data(p_ccb)) return true;
+  }
+
+  for (tL2C_CCB* p_ccb = p_lcb->ccb_queue.p_first_ccb; p_ccb != NULL;
+       p_ccb = p_ccb->p_next_ccb) {
+    if (l2c_ccb_has_queued_data(p_ccb)) return true;
+  }
+  return false;
+}
+
 /******************************************************************************
  *
  * Function         l2cu_get_next_buffer_to_send
@@ -27,6 +27,7 @@
 #include <string.h>
 
 #include "bt_target.h"
+#include "gd/common/packet_latency_trace.h"
 #include "gd/hal/snoop_logger.h"
 #include "hcimsgs.h"  // HCID_GET_
 #include "main/shim/shim.h"
@@ -59,6 +60,9 @@ tL2C_CB l2cb;
  *
  ******************************************************************************/
 void l2c_rcv_acl_data(BT_HDR* p_msg) {
+  bluetooth::common::PacketLatencyTrace::Record(
+      bluetooth::common::PacketLatencyTrace::GetBufferSample(p_msg),
+      bluetooth::common::PacketLatencyStage::L2CAP);
   uint8_t* p = (uint8_t*)(p_msg + 1) + p_msg->offset;
 
   /* Extract the handle */
@@ -97,6 +101,8 @@ void l2c_rcv_acl_data(BT_HDR* p_msg) {
     return;
   }
 
+  if (p_lcb->transport == BT_TRANSPORT_BR_EDR) BTM_PM_OnAclData(handle);
+
   /* Update the buffer header */
   p_msg->offset += 4;
 
@@ -163,7 +169,7 @@ void l2c_rcv_acl_data(BT_HDR* p_msg) {
 
     /* If no CCB for this channel, allocate one */
     p_ccb = p_lcb->p_fixed_ccbs[rcv_cid - L2CAP_FIRST_FIXED_CHNL];
-    p_ccb->metrics.rx(p_msg->len);
+    l2cu_count_rx_data(p_ccb, p_msg->len);
 
     if (p_ccb->peer_cfg.fcr.mode != L2CAP_FCR_BASIC_MODE)
       l2c_fcr_proc_pdu(p_ccb, p_msg);
@@ -179,16 +185,15 @@ void l2c_rcv_acl_data(BT_HDR* p_msg) {
   }
 
   if (p_lcb->transport == BT_TRANSPORT_LE) {
+    l2c_lcc_update_rate(&p_ccb->le_rx_rate, p_msg->len);
     l2c_lcc_proc_pdu(p_ccb, p_msg);
 
     /* The remote device has one less credit left */
     --p_ccb->remote_credit_count;
 
     /* If the credits left on the remote device are getting low, send some */
-    if (p_ccb->remote_credit_count <= L2CA_LeCreditThreshold()) {
-      uint16_t credits = L2CA_LeCreditDefault() - p_ccb->remote_credit_count;
-      p_ccb->remote_credit_count = L2CA_LeCreditDefault();
-
+    uint16_t credits = l2c_lcc_get_credits_to_grant(p_ccb);
+    if (credits != 0) {
       /* Return back credits */
       l2c_csm_execute(p_ccb, L2CEVT_L2CA_SEND_FLOW_CONTROL_CREDIT, &credits);
     }
@@ -108,6 +108,10 @@ void l2cu_set_lcb_handle(struct t_l2c_linkcb& p_lcb, uint16_t handle) {
              p_lcb.Handle(), handle);
   }
   p_lcb.SetHandle(handle);
+  if (handle < L2C_NUM_ACL_HANDLES) {
+    l2cb.lcb_index_by_handle[handle] =
+        static_cast<uint8_t>(1 + (&p_lcb - &l2cb.lcb_pool[0]));
+  }
 }
 
 /*******************************************************************************
@@ -153,6 +157,12 @@ void l2cu_release_lcb(tL2C_LCB* p_lcb) {
   tL2C_CCB* p_ccb;
 
   p_lcb->in_use = false;
+  if (p_lcb->Handle() < L2C_NUM_ACL_HANDLES &&
+      l2cb.lcb_index_by_handle[p_lcb->Handle()] ==
+          1 + (p_lcb - &l2cb.lcb_pool[0])) {
+    l2cb.lcb_index_by_handle[p_lcb->Handle()] = 0;
+  }
+  l2cb.lcb_pending_mask &= ~L2C_LCB_BIT(p_lcb);
   p_lcb->ResetBonding();
 
   /* Stop and free timers */
@@ -177,6 +187,8 @@ void l2cu_release_lcb(tL2C_LCB* p_lcb) {
       }
     }
   }
+  /* Disconnection races may leave buffers that no link waits on anymore */
+  l2c_link_reclaim_leaked_xmit_window();
 
   l2cu_process_fixed_disc_cback(p_lcb);
 
@@ -1463,6 +1475,8 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
 
   p_ccb->is_flushable = false;
   p_ccb->ecoc = false;
+  p_ccb->le_rx_rate = {};
+  p_ccb->le_tx_rate = {};
 
   alarm_free(p_ccb->l2c_ccb_timer);
   p_ccb->l2c_ccb_timer = alarm_new("l2c.l2c_ccb_timer");
@@ -1578,6 +1592,9 @@ void l2cu_release_ccb(tL2C_CCB* p_ccb) {
   fixed_queue_free(p_ccb->xmit_hold_q, osi_free);
   p_ccb->xmit_hold_q = NULL;
 
+  bluetooth::common::TrafficTelemetry::Unregister(p_ccb->traffic_counters);
+  p_ccb->traffic_counters = nullptr;
+
   l2c_fcr_cleanup(p_ccb);
 
   /* Channel may not be assigned to any LCB if it was just pre-reserved */
@@ -1634,6 +1651,38 @@ void l2cu_release_ccb(tL2C_CCB* p_ccb) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         l2cu_count_rx_data, l2cu_count_tx_data
+ *
+ * Description      Count the data received or sent on a channel in its
+ *                  metrics and in its traffic telemetry
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static bluetooth::common::TrafficCounters* l2cu_traffic_counters(
+    tL2C_CCB* p_ccb) {
+  if (p_ccb->traffic_counters == nullptr) {
+    uint16_t handle = (p_ccb->p_lcb != nullptr) ? p_ccb->p_lcb->Handle()
+                                                : HCI_INVALID_HANDLE;
+    p_ccb->traffic_counters = bluetooth::common::TrafficTelemetry::Register(
+        bluetooth::common::TrafficChannelType::L2CAP, handle,
+        p_ccb->local_cid);
+  }
+  return p_ccb->traffic_counters;
+}
+
+void l2cu_count_rx_data(tL2C_CCB* p_ccb, uint16_t len) {
+  p_ccb->metrics.rx(len);
+  l2cu_traffic_counters(p_ccb)->OnReceived(len);
+}
+
+void l2cu_count_tx_data(tL2C_CCB* p_ccb, uint16_t len) {
+  p_ccb->metrics.tx(len);
+  l2cu_traffic_counters(p_ccb)->OnSent(len);
+}
+
 /*******************************************************************************
  *
  * Function         l2cu_find_ccb_by_remote_cid
@@ -2758,8 +2807,9 @@ void l2cu_no_dynamic_ccbs(tL2C_LCB* p_lcb) {
   }
 
   if (start_timeout) {
-    alarm_set_on_mloop(p_lcb->l2c_lcb_timer, timeout_ms, l2c_lcb_timer_timeout,
-                       p_lcb);
+    alarm_set_on_mloop_with_slack(p_lcb->l2c_lcb_timer, timeout_ms,
+                                  L2CAP_LINK_IDLE_TIMEOUT_SLACK_MS,
+                                  l2c_lcb_timer_timeout, p_lcb);
     LOG_DEBUG("Started link IDLE timeout_ms:%lu", (unsigned long)timeout_ms);
   } else {
     alarm_cancel(p_lcb->l2c_lcb_timer);
@@ -3366,15 +3416,25 @@ void l2cu_send_peer_ble_credit_based_disconn_req(tL2C_CCB* p_ccb) {
  *
  * Function         l2cu_find_lcb_by_handle
  *
- * Description      Look through all active LCBs for a match based on the
- *                  HCI handle.
+ * Description      Look up the LCB indexed by the HCI handle, or look
+ *                  through all active LCBs if the index is out of date.
  *
  * Returns          pointer to matched LCB, or NULL if no match
  *
  ******************************************************************************/
 tL2C_LCB* l2cu_find_lcb_by_handle(uint16_t handle) {
   int xx;
-  tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  tL2C_LCB* p_lcb;
+
+  /* Called for each received ACL packet, the index avoids the scan */
+  if (handle < L2C_NUM_ACL_HANDLES && l2cb.lcb_index_by_handle[handle] != 0) {
+    p_lcb = &l2cb.lcb_pool[l2cb.lcb_index_by_handle[handle] - 1];
+    if ((p_lcb->in_use) && (p_lcb->Handle() == handle)) {
+      return (p_lcb);
+    }
+  }
+
+  p_lcb = &l2cb.lcb_pool[0];
 
   for (xx = 0; xx < MAX_L2CAP_LINKS; xx++, p_lcb++) {
     if ((p_lcb->in_use) && (p_lcb->Handle() == handle)) {
@@ -3502,12 +3562,15 @@ static void send_congestion_status_to_all_clients(tL2C_CCB* p_ccb,
 
 /* check if any change in congestion status */
 void l2cu_check_channel_congestion(tL2C_CCB* p_ccb) {
+  size_t q_count = fixed_queue_length(p_ccb->xmit_hold_q);
+  if (p_ccb->traffic_counters != nullptr) {
+    p_ccb->traffic_counters->SetTxQueueDepth(q_count);
+  }
+
   /* If the CCB queue limit is subject to a quota, check for congestion if this
    * channel has outgoing traffic */
   if (p_ccb->buff_quota == 0) return;
 
-  size_t q_count = fixed_queue_length(p_ccb->xmit_hold_q);
-
   if (p_ccb->cong_sent) {
     /* if channel was congested, but is not congested now, tell the app */
     if (q_count <= (p_ccb->buff_quota / 2))
@@ -28,6 +28,7 @@
 
 #include <base/logging.h>
 
+#include <algorithm>
 #include <cstdint>
 
 #include "osi/include/allocator.h"
@@ -869,6 +870,7 @@ static int port_write(tPORT* p_port, BT_HDR* p_buf) {
   } else {
     RFCOMM_TRACE_EVENT("PORT_Write : Data is being sent");
 
+    port_count_tx_data(p_port, p_buf->len);
     RFCOMM_DataReq(p_port->rfc.p_mcb, p_port->dlci, p_buf);
     return (PORT_SUCCESS);
   }
@@ -929,38 +931,37 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
   length = RFCOMM_DATA_BUF_SIZE -
            (uint16_t)(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + RFCOMM_DATA_OVERHEAD);
 
-  /* If there are buffers scheduled for transmission check if requested */
-  /* data fits into the end of the queue */
+  /* If there are buffers scheduled for transmission, top up the last one so
+   * that small writes go out in full size frames. Every buffer in the queue
+   * holds at least a frame at the peer MTU (see below). */
   mutex_global_lock();
 
   p_buf = (BT_HDR*)fixed_queue_try_peek_last(p_port->tx.queue);
-  if ((p_buf != NULL) &&
-      (((int)p_buf->len + available) <= (int)p_port->peer_mtu) &&
-      (((int)p_buf->len + available) <= (int)length)) {
-    // if(recv(fd, (uint8_t *)(p_buf + 1) + p_buf->offset + p_buf->len,
-    // available, 0) != available)
+  int room = std::min((int)p_port->peer_mtu, (int)length);
+  if ((p_buf != NULL) && ((int)p_buf->len < room)) {
+    int appended = std::min(room - (int)p_buf->len, available);
     if (!p_port->p_data_co_callback(
             handle, (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len,
-            available, DATA_CO_CALLBACK_TYPE_OUTGOING))
+            appended, DATA_CO_CALLBACK_TYPE_OUTGOING))
 
     {
       error(
           "p_data_co_callback DATA_CO_CALLBACK_TYPE_OUTGOING failed, "
           "available:%d",
-          available);
+          appended);
       mutex_global_unlock();
       return (PORT_UNKNOWN_ERROR);
     }
-    // memcpy ((uint8_t *)(p_buf + 1) + p_buf->offset + p_buf->len, p_data,
-    // max_len);
-    p_port->tx.queue_size += (uint16_t)available;
+    p_port->tx.queue_size += (uint16_t)appended;
 
-    *p_len = available;
-    p_buf->len += (uint16_t)available;
+    *p_len = appended;
+    p_buf->len += (uint16_t)appended;
+    available -= appended;
 
-    mutex_global_unlock();
-
-    return (PORT_SUCCESS);
+    if (available == 0) {
+      mutex_global_unlock();
+      return (PORT_SUCCESS);
+    }
   }
 
   mutex_global_unlock();
@@ -982,12 +983,17 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
       break;
     }
 
-    /* continue with rfcomm data write */
-    p_buf = (BT_HDR*)osi_malloc(RFCOMM_DATA_BUF_SIZE);
+    if (p_port->peer_mtu < length) length = p_port->peer_mtu;
+
+    /* continue with rfcomm data write. The buffer is sized for a full frame at
+     * the peer MTU rather than for the largest frame, so that small MTU links
+     * do not waste a default size buffer per frame. Data appended to the tail
+     * of the queue above is bounded by the peer MTU, so it still fits. */
+    p_buf = (BT_HDR*)osi_malloc_packet(sizeof(BT_HDR) + L2CAP_MIN_OFFSET +
+                                       RFCOMM_DATA_OVERHEAD + length);
     p_buf->offset = L2CAP_MIN_OFFSET + RFCOMM_MIN_OFFSET;
     p_buf->layer_specific = handle;
 
-    if (p_port->peer_mtu < length) length = p_port->peer_mtu;
     if (available < (int)length) length = (uint16_t)available;
     p_buf->len = length;
     p_buf->event = BT_EVT_TO_BTU_SP_DATA;
@@ -1107,7 +1113,7 @@ int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len,
       break;
 
     /* continue with rfcomm data write */
-    p_buf = (BT_HDR*)osi_malloc(RFCOMM_DATA_BUF_SIZE);
+    p_buf = (BT_HDR*)osi_malloc_packet(RFCOMM_DATA_BUF_SIZE);
     p_buf->offset = L2CAP_MIN_OFFSET + RFCOMM_MIN_OFFSET;
     p_buf->layer_specific = handle;
 
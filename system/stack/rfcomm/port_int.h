@@ -27,6 +27,7 @@
 
 #include <cstdint>
 
+#include "gd/common/traffic_telemetry.h"
 #include "osi/include/alarm.h"
 #include "osi/include/fixed_queue.h"
 #include "stack/include/l2c_api.h"
@@ -185,12 +186,16 @@ typedef struct {
   uint16_t
       credit_rx_max; /* Max number of credits we will allow this guy to sent */
   uint16_t credit_rx_low;   /* Number of credits when we send credit update */
+  uint16_t credit_rx_max_base; /* credit_rx_max selected for the MTU, that */
+  uint16_t credit_rx_low_base; /* the window shrinks back to on pushback */
   uint16_t rx_buf_critical; /* port receive queue critical watermark level */
   bool keep_port_handle;    /* true if port is not deallocated when closing */
   /* it is set to true for server when allocating port */
   uint16_t keep_mtu; /* Max MTU that port can receive by server */
   uint16_t sec_mask; /* Bitmask of security requirements for this port */
                      /* see the BTM_SEC_* values in btm_api_types.h */
+  /* Per port telemetry, registered with the first data of the port */
+  bluetooth::common::TrafficCounters* traffic_counters;
 } tPORT;
 
 /* Define the PORT/RFCOMM control structure
@@ -215,6 +220,8 @@ uint32_t port_get_signal_changes(tPORT* p_port, uint8_t old_signals,
                                  uint8_t signal);
 uint32_t port_flow_control_user(tPORT* p_port);
 void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count);
+void port_count_rx_data(tPORT* p_port, uint16_t len);
+void port_count_tx_data(tPORT* p_port, uint16_t len);
 
 /*
  * Functions provided by the port_rfc.cc
@@ -799,6 +799,7 @@ void PORT_DataInd(tRFC_MCB* p_mcb, uint8_t dlci, BT_HDR* p_buf) {
     osi_free(p_buf);
     return;
   }
+  port_count_rx_data(p_port, p_buf->len);
   /* If client registered callout callback with flow control we can just deliver
    * receive data */
   if (p_port->p_data_co_callback) {
@@ -892,10 +893,13 @@ void PORT_FlowInd(tRFC_MCB* p_mcb, uint8_t dlci, bool enable_data) {
     p_port->tx.peer_fc = !enable_data;
   }
 
-  for (i = 0; i < MAX_RFC_PORTS; i++) {
-    /* If DLCI is 0 event applies to all ports */
+  /* If DLCI is 0 event applies to all ports on this multiplexer; walk the */
+  /* multiplexer's own DLCI table rather than every port in the stack      */
+  for (i = 0; i <= RFCOMM_MAX_DLCI; i++) {
     if (dlci == 0) {
-      p_port = &rfc_cb.port.port[i];
+      uint8_t handle = p_mcb->port_handles[i];
+      if (handle == 0) continue;
+      p_port = &rfc_cb.port.port[handle - 1];
       if (!p_port->in_use || (p_port->rfc.p_mcb != p_mcb) ||
           (p_port->rfc.state != RFC_STATE_OPENED))
         continue;
@@ -948,6 +952,7 @@ uint32_t port_rfc_send_tx_data(tPORT* p_port) {
         RFCOMM_TRACE_DEBUG("Sending RFCOMM_DataReq tx.queue_size=%d",
                            p_port->tx.queue_size);
 
+        port_count_tx_data(p_port, p_buf->len);
         RFCOMM_DataReq(p_port->rfc.p_mcb, p_port->dlci, p_buf);
 
         events |= PORT_EV_TXCHAR;
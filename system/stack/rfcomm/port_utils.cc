@@ -24,6 +24,7 @@
 
 #include <base/logging.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 
@@ -187,6 +188,8 @@ void port_select_mtu(tPORT* p_port) {
   p_port->rx_buf_critical = (PORT_RX_CRITICAL_WM / p_port->mtu);
   if (p_port->rx_buf_critical > PORT_RX_BUF_CRITICAL_WM)
     p_port->rx_buf_critical = PORT_RX_BUF_CRITICAL_WM;
+  p_port->credit_rx_max_base = p_port->credit_rx_max;
+  p_port->credit_rx_low_base = p_port->credit_rx_low;
   RFCOMM_TRACE_DEBUG(
       "%s: credit_rx_max %d, credit_rx_low %d, rx_buf_critical %d", __func__,
       p_port->credit_rx_max, p_port->credit_rx_low, p_port->rx_buf_critical);
@@ -205,6 +208,9 @@ void port_release_port(tPORT* p_port) {
   RFCOMM_TRACE_DEBUG("%s p_port: %p state: %d keep_handle: %d", __func__,
                      p_port, p_port->rfc.state, p_port->keep_port_handle);
 
+  bluetooth::common::TrafficTelemetry::Unregister(p_port->traffic_counters);
+  p_port->traffic_counters = nullptr;
+
   mutex_global_lock();
   BT_HDR* p_buf;
   while ((p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->rx.queue)) !=
@@ -440,6 +446,50 @@ uint32_t port_get_signal_changes(tPORT* p_port, uint8_t old_signals,
   return (p_port->ev_mask & events);
 }
 
+/*******************************************************************************
+ *
+ * Function         port_adjust_credit_window
+ *
+ * Description      Grow the number of credits granted to the peer by one step
+ *                  of credit_rx_low while the user keeps up with the data, or
+ *                  halve it, down to what was selected for the MTU, when the
+ *                  user pushes back.
+ *
+ *                  Only ports delivering data through a callout grow the
+ *                  window: other ports queue what they receive, and a wider
+ *                  window would overrun the rx queue critical watermark.
+ *
+ * Returns          nothing
+ *
+ ******************************************************************************/
+static void port_adjust_credit_window(tPORT* p_port, bool grow) {
+  if (p_port->credit_rx_max_base == 0) return;
+
+  uint16_t credit_max = p_port->p_data_co_callback ? PORT_RX_BUF_CO_MAX_CREDITS
+                                                   : p_port->credit_rx_max_base;
+  if (credit_max < p_port->credit_rx_max_base)
+    credit_max = p_port->credit_rx_max_base;
+
+  uint16_t new_max;
+  if (grow) {
+    new_max = p_port->credit_rx_max + std::max<uint16_t>(
+                                          p_port->credit_rx_low_base, 1);
+    if (new_max > credit_max) new_max = credit_max;
+  } else {
+    new_max = std::max<uint16_t>(p_port->credit_rx_max / 2,
+                                 p_port->credit_rx_max_base);
+  }
+  if (new_max == p_port->credit_rx_max) return;
+
+  p_port->credit_rx_max = new_max;
+  /* Keep requesting credits at the same fraction of the window */
+  p_port->credit_rx_low = (uint16_t)((uint32_t)new_max *
+                                     p_port->credit_rx_low_base /
+                                     p_port->credit_rx_max_base);
+  RFCOMM_TRACE_DEBUG("%s: credit_rx_max %d, credit_rx_low %d", __func__,
+                     p_port->credit_rx_max, p_port->credit_rx_low);
+}
+
 /*******************************************************************************
  *
  * Function         port_flow_control_peer
@@ -470,6 +520,10 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
       /* There might be a special case when we just adjusted rx_max */
       if ((p_port->credit_rx <= p_port->credit_rx_low) && !p_port->rx.user_fc &&
           (p_port->credit_rx_max > p_port->credit_rx)) {
+        /* The window was consumed without the user pushing back: widen it,
+         * so the peer is less likely to run out of credits */
+        if (!p_port->rx.peer_fc) port_adjust_credit_window(p_port, true);
+
         rfc_send_credit(p_port->rfc.p_mcb, p_port->dlci,
                         (uint8_t)(p_port->credit_rx_max - p_port->credit_rx));
 
@@ -482,10 +536,12 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
     else {
       /* if client registered data callback, just do what they want */
       if (p_port->p_data_callback || p_port->p_data_co_callback) {
+        if (!p_port->rx.peer_fc) port_adjust_credit_window(p_port, false);
         p_port->rx.peer_fc = true;
       }
       /* if queue count reached credit rx max, set peer fc */
       else if (fixed_queue_length(p_port->rx.queue) >= p_port->credit_rx_max) {
+        if (!p_port->rx.peer_fc) port_adjust_credit_window(p_port, false);
         p_port->rx.peer_fc = true;
       }
     }
@@ -525,3 +581,36 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
     }
   }
 }
+
+/*******************************************************************************
+ *
+ * Function         port_count_rx_data, port_count_tx_data
+ *
+ * Description      Count the data received from or sent to the peer on a
+ *                  port in its traffic telemetry, with the depth of the port
+ *                  queues
+ *
+ ******************************************************************************/
+static bluetooth::common::TrafficCounters* port_traffic_counters(
+    tPORT* p_port) {
+  if (p_port->traffic_counters == nullptr) {
+    p_port->traffic_counters = bluetooth::common::TrafficTelemetry::Register(
+        bluetooth::common::TrafficChannelType::RFCOMM,
+        get_btm_client_interface().lifecycle.BTM_GetHCIConnHandle(
+            p_port->bd_addr, BT_TRANSPORT_BR_EDR),
+        p_port->dlci);
+  }
+  return p_port->traffic_counters;
+}
+
+void port_count_rx_data(tPORT* p_port, uint16_t len) {
+  bluetooth::common::TrafficCounters* counters = port_traffic_counters(p_port);
+  counters->OnReceived(len);
+  counters->SetRxQueueDepth(fixed_queue_length(p_port->rx.queue));
+}
+
+void port_count_tx_data(tPORT* p_port, uint16_t len) {
+  bluetooth::common::TrafficCounters* counters = port_traffic_counters(p_port);
+  counters->OnSent(len);
+  counters->SetTxQueueDepth(fixed_queue_length(p_port->tx.queue));
+}
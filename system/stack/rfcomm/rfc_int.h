@@ -152,6 +152,9 @@ typedef struct {
 #define RFC_CLOSE_TIMEOUT 10
 /* first connection to be established on Mx */
 #define RFCOMM_CONN_TIMEOUT 120
+/* The timeouts above are in seconds, they may fire that late to be coalesced
+ * with other alarms */
+#define RFC_TIMER_SLACK_MS 500
 
 /* Define RFComm control block
 */
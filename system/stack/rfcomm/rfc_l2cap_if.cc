@@ -29,6 +29,7 @@
 
 #include "bt_target.h"
 #include "common/time_util.h"
+#include "gd/common/packet_latency_trace.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"  // UNUSED_ATTR
@@ -254,6 +255,9 @@ void RFCOMM_DisconnectInd(uint16_t lcid, bool is_conf_needed) {
  *
  ******************************************************************************/
 void RFCOMM_BufDataInd(uint16_t lcid, BT_HDR* p_buf) {
+  bluetooth::common::PacketLatencyTrace::Record(
+      bluetooth::common::PacketLatencyTrace::GetBufferSample(p_buf),
+      bluetooth::common::PacketLatencyStage::RFCOMM);
   tRFC_MCB* p_mcb = rfc_find_lcid_mcb(lcid);
 
   if (!p_mcb) {
@@ -222,8 +222,9 @@ void rfc_timer_start(tRFC_MCB* p_mcb, uint16_t timeout) {
   RFCOMM_TRACE_EVENT("%s - timeout:%d seconds", __func__, timeout);
 
   uint64_t interval_ms = timeout * 1000;
-  alarm_set_on_mloop(p_mcb->mcb_timer, interval_ms, rfcomm_mcb_timer_timeout,
-                     p_mcb);
+  alarm_set_on_mloop_with_slack(p_mcb->mcb_timer, interval_ms,
+                                RFC_TIMER_SLACK_MS, rfcomm_mcb_timer_timeout,
+                                p_mcb);
 }
 
 /*******************************************************************************
@@ -250,8 +251,9 @@ void rfc_port_timer_start(tPORT* p_port, uint16_t timeout) {
   RFCOMM_TRACE_EVENT("%s - timeout:%d seconds", __func__, timeout);
 
   uint64_t interval_ms = timeout * 1000;
-  alarm_set_on_mloop(p_port->rfc.port_timer, interval_ms,
-                     rfcomm_port_timer_timeout, p_port);
+  alarm_set_on_mloop_with_slack(p_port->rfc.port_timer, interval_ms,
+                                RFC_TIMER_SLACK_MS, rfcomm_port_timer_timeout,
+                                p_port);
 }
 
 /*******************************************************************************
@@ -25,7 +25,9 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "bt_target.h"
 #include "osi/include/allocator.h"
@@ -38,9 +40,70 @@
 /******************************************************************************/
 /*            L O C A L    F U N C T I O N     P R O T O T Y P E S            */
 /******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
-                             const uint8_t* p_his_uuid, uint16_t his_len,
-                             int nest_level);
+static void find_uuids_in_seq(uint8_t* p, uint32_t seq_len,
+                              std::vector<bluetooth::Uuid>* p_uuids,
+                              int nest_level);
+
+/* The UUIDs of each record of the server database, in record order and in
+ * their 128 bit form, so that a service search does not parse the attributes
+ * of every record. Built by the first search after a change of the database.
+ */
+static std::vector<std::vector<bluetooth::Uuid>> sdp_db_uuid_index;
+static bool sdp_db_uuid_index_valid = false;
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_invalidate_uuid_index
+ *
+ * Description      This function is called when records or attributes of the
+ *                  server database are changed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_db_invalidate_uuid_index(void) { sdp_db_uuid_index_valid = false; }
+
+/* Converts a big endian UUID of |len| bytes, returns false if |len| is not a
+ * UUID length, like sdpu_compare_uuid_arrays() */
+static bool uuid_from_be_array(const uint8_t* p, uint32_t len,
+                               bluetooth::Uuid* p_uuid) {
+  switch (len) {
+    case bluetooth::Uuid::kNumBytes16:
+      *p_uuid = bluetooth::Uuid::From16Bit((p[0] << 8) | p[1]);
+      return true;
+    case bluetooth::Uuid::kNumBytes32:
+      *p_uuid = bluetooth::Uuid::From32Bit(
+          ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+      return true;
+    case bluetooth::Uuid::kNumBytes128:
+      *p_uuid = bluetooth::Uuid::From128BitBE(p);
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void sdp_db_build_uuid_index(void) {
+  const tSDP_DB& db = sdp_cb.server_db;
+  sdp_db_uuid_index.resize(db.num_records);
+  for (uint16_t rec = 0; rec < db.num_records; rec++) {
+    std::vector<bluetooth::Uuid>& uuids = sdp_db_uuid_index[rec];
+    uuids.clear();
+    const tSDP_RECORD& record = db.record[rec];
+    for (uint16_t xx = 0; xx < record.num_attributes; xx++) {
+      const tSDP_ATTRIBUTE& attr = record.attribute[xx];
+      bluetooth::Uuid uuid;
+      if (attr.type == UUID_DESC_TYPE) {
+        if (uuid_from_be_array(attr.value_ptr, attr.len, &uuid))
+          uuids.push_back(uuid);
+      } else if (attr.type == DATA_ELE_SEQ_DESC_TYPE) {
+        find_uuids_in_seq(attr.value_ptr, attr.len, &uuids, 0);
+      }
+    }
+    std::sort(uuids.begin(), uuids.end());
+  }
+  sdp_db_uuid_index_valid = true;
+}
 
 /*******************************************************************************
  *
@@ -56,40 +119,35 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
                                          const tSDP_UUID_SEQ* p_seq) {
   uint16_t xx, yy;
-  const tSDP_ATTRIBUTE* p_attr;
-  tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
+  bluetooth::Uuid uuids[MAX_UUIDS_PER_SEQ];
+
+  /* A UUID of a bad length matches no attribute */
+  for (yy = 0; yy < p_seq->num_uids; yy++) {
+    if (!uuid_from_be_array(&p_seq->uuid_entry[yy].value[0],
+                            p_seq->uuid_entry[yy].len, &uuids[yy])) {
+      SDP_TRACE_ERROR("%s: invalid length", __func__);
+      return (NULL);
+    }
+  }
+
+  if (!sdp_db_uuid_index_valid) sdp_db_build_uuid_index();
 
   /* If NULL, start at the beginning, else start at the first specified record
    */
-  if (!p_rec)
-    p_rec = &sdp_cb.server_db.record[0];
-  else
-    p_rec++;
+  xx = p_rec ? (p_rec - &sdp_cb.server_db.record[0]) + 1 : 0;
 
   /* Look through the records. The spec says that a match occurs if */
   /* the record contains all the passed UUIDs in it.                */
-  for (; p_rec < p_end; p_rec++) {
+  for (; xx < sdp_cb.server_db.num_records; xx++) {
+    const std::vector<bluetooth::Uuid>& rec_uuids = sdp_db_uuid_index[xx];
     for (yy = 0; yy < p_seq->num_uids; yy++) {
-      p_attr = &p_rec->attribute[0];
-      for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
-        if (p_attr->type == UUID_DESC_TYPE) {
-          if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
-                                       &p_seq->uuid_entry[yy].value[0],
-                                       p_seq->uuid_entry[yy].len))
-            break;
-        } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
-          if (find_uuid_in_seq(p_attr->value_ptr, p_attr->len,
-                               &p_seq->uuid_entry[yy].value[0],
-                               p_seq->uuid_entry[yy].len, 0))
-            break;
-        }
-      }
       /* If any UUID was not found,  on to the next record */
-      if (xx == p_rec->num_attributes) break;
+      if (!std::binary_search(rec_uuids.begin(), rec_uuids.end(), uuids[yy]))
+        break;
     }
 
     /* If every UUID was found in the record, return the record */
-    if (yy == p_seq->num_uids) return (p_rec);
+    if (yy == p_seq->num_uids) return (&sdp_cb.server_db.record[xx]);
   }
 
   /* If here, no more records found */
@@ -98,22 +156,23 @@ const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
 
 /*******************************************************************************
  *
- * Function         find_uuid_in_seq
+ * Function         find_uuids_in_seq
  *
- * Description      This function searches a data element sequenct for a UUID.
+ * Description      This function adds the UUIDs of a data element sequence to
+ *                  |p_uuids|.
  *
- * Returns          true if found, else false
+ * Returns          void
  *
  ******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
-                             const uint8_t* p_uuid, uint16_t uuid_len,
-                             int nest_level) {
+static void find_uuids_in_seq(uint8_t* p, uint32_t seq_len,
+                              std::vector<bluetooth::Uuid>* p_uuids,
+                              int nest_level) {
   uint8_t* p_end = p + seq_len;
   uint8_t type;
   uint32_t len;
 
   /* A little safety check to avoid excessive recursion */
-  if (nest_level > 3) return (false);
+  if (nest_level > 3) return;
 
   while (p < p_end) {
     type = *p++;
@@ -124,16 +183,13 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
     }
     type = type >> 3;
     if (type == UUID_DESC_TYPE) {
-      if (sdpu_compare_uuid_arrays(p, len, p_uuid, uuid_len)) return (true);
+      bluetooth::Uuid uuid;
+      if (uuid_from_be_array(p, len, &uuid)) p_uuids->push_back(uuid);
     } else if (type == DATA_ELE_SEQ_DESC_TYPE) {
-      if (find_uuid_in_seq(p, len, p_uuid, uuid_len, nest_level + 1))
-        return (true);
+      find_uuids_in_seq(p, len, p_uuids, nest_level + 1);
     }
     p = p + len;
   }
-
-  /* If here, failed to match */
-  return (false);
 }
 
 /*******************************************************************************
@@ -257,6 +313,7 @@ uint32_t SDP_CreateRecord(void) {
 
   /* First, check if there is a free record */
   if (p_db->num_records < SDP_MAX_RECORDS) {
+    sdp_db_invalidate_uuid_index();
     memset(&p_db->record[p_db->num_records], 0, sizeof(tSDP_RECORD));
 
     /* We will use a handle of the first unreserved handle plus last record
@@ -299,6 +356,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
   uint16_t xx, yy, zz;
   tSDP_RECORD* p_rec = &sdp_cb.server_db.record[0];
 
+  sdp_db_invalidate_uuid_index();
   if (handle == 0 || sdp_cb.server_db.num_records == 0) {
     /* Delete all records in the database */
     sdp_cb.server_db.num_records = 0;
@@ -444,6 +502,7 @@ bool SDP_AddAttributeToRecord(tSDP_RECORD* p_rec, uint16_t attr_id,
   uint16_t xx, yy;
   tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
 
+  sdp_db_invalidate_uuid_index();
   /* Found the record. Now, see if the attribute already exists */
   for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
     /* The attribute exists. replace it */
@@ -884,6 +943,7 @@ bool SDP_DeleteAttributeFromRecord(tSDP_RECORD* p_rec, uint16_t attr_id) {
   uint8_t* pad_ptr;
   uint32_t len; /* Number of bytes in the entry */
 
+  sdp_db_invalidate_uuid_index();
   /* Found it. Now, find the attribute */
   for (uint16_t attribute_index = 0; attribute_index < p_rec->num_attributes;
        attribute_index++, p_attr++) {
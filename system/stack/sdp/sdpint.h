@@ -319,6 +319,7 @@ void sdpu_callback(tCONN_CB& ccb, tSDP_REASON reason);
 
 /* Functions provided by sdp_db.cc
  */
+void sdp_db_invalidate_uuid_index(void);
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
                                          const tSDP_UUID_SEQ* p_seq);
 tSDP_RECORD* sdp_db_find_record(uint32_t handle);
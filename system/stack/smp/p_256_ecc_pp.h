@@ -19,47 +19,18 @@
 /******************************************************************************
  *
  *  This file contains simple pairing algorithms using Elliptic Curve
- *Cryptography for private public key
+ *  Cryptography for private public key. The implementation is shared with
+ *  the GD security module.
  *
  ******************************************************************************/
 
 #pragma once
 
-#include <cstdbool>
-#include "p_256_multprecision.h"
+#include "security/ecc/p_256_ecc_pp.h"
 
-typedef struct {
-  uint32_t x[KEY_LENGTH_DWORDS_P256];
-  uint32_t y[KEY_LENGTH_DWORDS_P256];
-  uint32_t z[KEY_LENGTH_DWORDS_P256];
-} Point;
-
-typedef struct {
-  // curve's coefficients
-  uint32_t a[KEY_LENGTH_DWORDS_P256];
-  uint32_t b[KEY_LENGTH_DWORDS_P256];
-
-  // whether a is -3
-  int a_minus3;
-
-  // prime modulus
-  uint32_t p[KEY_LENGTH_DWORDS_P256];
-
-  // Omega, p = 2^m -omega
-  uint32_t omega[KEY_LENGTH_DWORDS_P256];
-
-  // base point, a point on E of order r
-  Point G;
-
-} elliptic_curve_t;
-
-extern elliptic_curve_t curve;
-extern elliptic_curve_t curve_p256;
-
-bool ECC_ValidatePoint(const Point& p);
-
-void ECC_PointMult_Bin_NAF(Point* q, Point* p, uint32_t* n);
-
-#define ECC_PointMult(q, p, n) ECC_PointMult_Bin_NAF(q, p, n)
-
-void p_256_init_curve();
+using bluetooth::security::ecc::curve_p256;
+using bluetooth::security::ecc::ECC_PointMult_Base;
+using bluetooth::security::ecc::ECC_PointMult_Bin_NAF;
+using bluetooth::security::ecc::ECC_PointMult_Window;
+using bluetooth::security::ecc::ECC_ValidatePoint;
+using bluetooth::security::ecc::Point;
@@ -24,6 +24,7 @@
 #include "btif/include/btif_common.h"
 #include "btif/include/core_callbacks.h"
 #include "btif/include/stack_manager.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
 #include "internal_include/bt_target.h"
 #include "main/shim/shim.h"
@@ -749,6 +750,8 @@ void smp_process_pairing_public_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
   }
 
   p_cb->flags |= SMP_PAIR_FLAG_HAVE_PEER_PUBL_KEY;
+  p_cb->pairing_times.peer_publ_key_ms =
+      bluetooth::common::time_get_os_boottime_ms();
 
   smp_wait_for_both_public_keys(p_cb, NULL);
 }
@@ -1162,7 +1165,7 @@ void smp_proc_sl_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
   if (key_type == SMP_KEY_TYPE_TK) {
     smp_generate_srand_mrand_confirm(p_cb, NULL);
   } else if (key_type == SMP_KEY_TYPE_CFM) {
-    smp_set_state(SMP_STATE_WAIT_CONFIRM);
+    smp_set_state(p_cb, SMP_STATE_WAIT_CONFIRM);
 
     if (p_cb->flags & SMP_PAIR_FLAGS_CMD_CONFIRM)
       smp_sm_event(p_cb, SMP_CONFIRM_EVT, NULL);
@@ -1312,7 +1315,7 @@ void smp_key_distribution(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
 
   if (!p_cb->local_i_key && !p_cb->local_r_key) {
     /* state check to prevent re-entrant */
-    if (smp_get_state() == SMP_STATE_BOND_PENDING) {
+    if (smp_get_state(p_cb) == SMP_STATE_BOND_PENDING) {
       if (p_cb->derive_lk) {
         tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(p_cb->pairing_bda);
         if (!(p_dev_rec->sec_flags & BTM_SEC_LE_LINK_KEY_AUTHED) &&
@@ -1339,7 +1342,7 @@ void smp_key_distribution(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
           SMP_TRACE_DEBUG("%s delaying auth complete.", __func__);
           alarm_set_on_mloop(p_cb->delayed_auth_timer_ent,
                              SMP_DELAYED_AUTH_TIMEOUT_MS,
-                             smp_delayed_auth_complete_timeout, NULL);
+                             smp_delayed_auth_complete_timeout, p_cb);
         }
       } else {
         p_cb->wait_for_authorization_complete = true;
@@ -1377,7 +1380,7 @@ void smp_decide_association_model(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
           /* display consent dialog if this device has a display */
           SMP_TRACE_DEBUG("ENCRYPTION_ONLY showing Consent Dialog");
           p_cb->cb_evt = SMP_CONSENT_REQ_EVT;
-          smp_set_state(SMP_STATE_WAIT_NONCE);
+          smp_set_state(p_cb, SMP_STATE_WAIT_NONCE);
           smp_sm_event(p_cb, SMP_SC_DSPL_NC_EVT, NULL);
         } else {
           p_cb->sec_level = SMP_SEC_UNAUTHENTICATE;
@@ -1457,7 +1460,7 @@ void smp_process_io_response(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
   SMP_TRACE_DEBUG("%s", __func__);
   if (p_cb->flags & SMP_PAIR_FLAGS_WE_STARTED_DD) {
     /* pairing started by local (peripheral) Security Request */
-    smp_set_state(SMP_STATE_SEC_REQ_PENDING);
+    smp_set_state(p_cb, SMP_STATE_SEC_REQ_PENDING);
     smp_send_cmd(SMP_OPCODE_SEC_REQ, p_cb);
   } else /* plan to send pairing respond */
   {
@@ -1667,7 +1670,7 @@ void smp_process_local_nonce(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
         smp_calculate_local_commitment(p_cb);
         smp_send_commitment(p_cb, NULL);
         /* peripheral has to wait for peer nonce */
-        smp_set_state(SMP_STATE_WAIT_NONCE);
+        smp_set_state(p_cb, SMP_STATE_WAIT_NONCE);
       } else /* i.e. central */
       {
         if (p_cb->flags & SMP_PAIR_FLAG_HAVE_PEER_COMM) {
@@ -1679,7 +1682,7 @@ void smp_process_local_nonce(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
               p_cb->selected_association_model);
           p_cb->flags &= ~SMP_PAIR_FLAG_HAVE_PEER_COMM;
           smp_send_rand(p_cb, NULL);
-          smp_set_state(SMP_STATE_WAIT_NONCE);
+          smp_set_state(p_cb, SMP_STATE_WAIT_NONCE);
         }
       }
       break;
@@ -1694,7 +1697,7 @@ void smp_process_local_nonce(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
         if (p_cb->flags & SMP_PAIR_FLAG_HAVE_PEER_COMM) {
           /* central commitment is already received */
           smp_send_commitment(p_cb, NULL);
-          smp_set_state(SMP_STATE_WAIT_NONCE);
+          smp_set_state(p_cb, SMP_STATE_WAIT_NONCE);
         }
       }
       break;
@@ -1703,7 +1706,7 @@ void smp_process_local_nonce(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
         smp_send_rand(p_cb, NULL);
       }
 
-      smp_set_state(SMP_STATE_WAIT_NONCE);
+      smp_set_state(p_cb, SMP_STATE_WAIT_NONCE);
       break;
     default:
       SMP_TRACE_ERROR("Association Model = %d is not used in LE SC",
@@ -1768,7 +1771,7 @@ void smp_process_peer_nonce(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
           /* display consent dialog */
           SMP_TRACE_DEBUG("JUST WORKS showing Consent Dialog");
           p_cb->cb_evt = SMP_CONSENT_REQ_EVT;
-          smp_set_state(SMP_STATE_WAIT_NONCE);
+          smp_set_state(p_cb, SMP_STATE_WAIT_NONCE);
           smp_sm_event(p_cb, SMP_SC_DSPL_NC_EVT, NULL);
         } else {
           /* go directly to phase 2 */
@@ -1776,7 +1779,7 @@ void smp_process_peer_nonce(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
         }
       } else /* numeric comparison */
       {
-        smp_set_state(SMP_STATE_WAIT_NONCE);
+        smp_set_state(p_cb, SMP_STATE_WAIT_NONCE);
         smp_sm_event(p_cb, SMP_SC_CALC_NC_EVT, NULL);
       }
       break;
@@ -1796,7 +1799,7 @@ void smp_process_peer_nonce(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
       }
 
       if (++p_cb->round < 20) {
-        smp_set_state(SMP_STATE_SEC_CONN_PHS1_START);
+        smp_set_state(p_cb, SMP_STATE_SEC_CONN_PHS1_START);
         p_cb->flags &= ~SMP_PAIR_FLAG_HAVE_PEER_COMM;
         smp_start_nonce_generation(p_cb);
         break;
@@ -1901,7 +1904,7 @@ void smp_wait_for_both_public_keys(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
     if ((p_cb->role == HCI_ROLE_PERIPHERAL) &&
         ((p_cb->req_oob_type == SMP_OOB_LOCAL) ||
          (p_cb->req_oob_type == SMP_OOB_BOTH))) {
-      smp_set_state(SMP_STATE_PUBLIC_KEY_EXCH);
+      smp_set_state(p_cb, SMP_STATE_PUBLIC_KEY_EXCH);
     }
     smp_sm_event(p_cb, SMP_BOTH_PUBL_KEYS_RCVD_EVT, NULL);
   }
@@ -2032,9 +2035,9 @@ void smp_set_local_oob_random_commitment(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
  *
  ******************************************************************************/
 void smp_link_encrypted(const RawAddress& bda, uint8_t encr_enable) {
-  tSMP_CB* p_cb = &smp_cb;
+  tSMP_CB* p_cb = smp_cb_find(bda);
 
-  if (smp_cb.pairing_bda == bda) {
+  if (p_cb != NULL) {
     LOG_DEBUG("SMP encryption enable:%hhu device:%s", encr_enable,
               ADDRESS_TO_LOGGABLE_CSTR(bda));
 
@@ -2050,7 +2053,7 @@ void smp_link_encrypted(const RawAddress& bda, uint8_t encr_enable) {
         .status = static_cast<tSMP_STATUS>(encr_enable),
     };
 
-    smp_sm_event(&smp_cb, SMP_ENCRYPTED_EVT, &smp_int_data);
+    smp_sm_event(p_cb, SMP_ENCRYPTED_EVT, &smp_int_data);
   } else {
     LOG_WARN(
         "SMP state machine busy so skipping encryption enable:%hhu device:%s",
@@ -2060,7 +2063,11 @@ void smp_link_encrypted(const RawAddress& bda, uint8_t encr_enable) {
 
 void smp_cancel_start_encryption_attempt() {
   SMP_TRACE_ERROR("%s: Encryption request cancelled", __func__);
-  smp_sm_event(&smp_cb, SMP_DISCARD_SEC_REQ_EVT, NULL);
+  /* the controller does not tell which link failed, only the pairings waiting
+   * for the encryption handle the event */
+  for (tSMP_CB& cb : smp_cb_pool) {
+    smp_sm_event(&cb, SMP_DISCARD_SEC_REQ_EVT, NULL);
+  }
 }
 
 /*******************************************************************************
@@ -2074,21 +2081,20 @@ void smp_cancel_start_encryption_attempt() {
  *
  ******************************************************************************/
 bool smp_proc_ltk_request(const RawAddress& bda) {
-  SMP_TRACE_DEBUG("%s state = %d", __func__, smp_cb.state);
-  bool match = false;
+  tSMP_CB* p_cb = smp_cb_find(bda);
 
-  if (bda == smp_cb.pairing_bda) {
-    match = true;
-  } else {
+  if (p_cb == NULL) {
     tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(bda);
-    if (p_dev_rec != NULL && p_dev_rec->ble.pseudo_addr == smp_cb.pairing_bda &&
-        p_dev_rec->ble.pseudo_addr != RawAddress::kEmpty) {
-      match = true;
+    if (p_dev_rec != NULL && p_dev_rec->ble.pseudo_addr != RawAddress::kEmpty) {
+      p_cb = smp_cb_find(p_dev_rec->ble.pseudo_addr);
     }
   }
 
-  if (match && smp_cb.state == SMP_STATE_ENCRYPTION_PENDING) {
-    smp_sm_event(&smp_cb, SMP_ENC_REQ_EVT, NULL);
+  if (p_cb == NULL) return false;
+
+  SMP_TRACE_DEBUG("%s state = %d", __func__, p_cb->state);
+  if (p_cb->state == SMP_STATE_ENCRYPTION_PENDING) {
+    smp_sm_event(p_cb, SMP_ENC_REQ_EVT, NULL);
     return true;
   }
 
@@ -2106,9 +2112,7 @@ bool smp_proc_ltk_request(const RawAddress& bda) {
  * Returns          void
  *
  ******************************************************************************/
-void smp_process_secure_connection_long_term_key(void) {
-  tSMP_CB* p_cb = &smp_cb;
-
+void smp_process_secure_connection_long_term_key(tSMP_CB* p_cb) {
   SMP_TRACE_DEBUG("%s", __func__);
   smp_save_secure_connections_long_term_key(p_cb);
 
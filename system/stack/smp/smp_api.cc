@@ -55,27 +55,46 @@ void SMP_Init(void) {
     return;
   }
 
-  memset(&smp_cb, 0, sizeof(tSMP_CB));
-  smp_cb.smp_rsp_timer_ent = alarm_new("smp.smp_rsp_timer_ent");
-  smp_cb.delayed_auth_timer_ent = alarm_new("smp.delayed_auth_timer_ent");
+  for (tSMP_CB& cb : smp_cb_pool) {
+    memset(&cb, 0, sizeof(tSMP_CB));
+    cb.smp_rsp_timer_ent = alarm_new("smp.smp_rsp_timer_ent");
+    cb.delayed_auth_timer_ent = alarm_new("smp.delayed_auth_timer_ent");
 
 #if defined(SMP_INITIAL_TRACE_LEVEL)
-  smp_cb.trace_level = SMP_INITIAL_TRACE_LEVEL;
+    cb.trace_level = SMP_INITIAL_TRACE_LEVEL;
 #else
-  smp_cb.trace_level = BT_TRACE_LEVEL_NONE; /* No traces */
+    cb.trace_level = BT_TRACE_LEVEL_NONE; /* No traces */
 #endif
+  }
   SMP_TRACE_EVENT("%s", __func__);
 
   smp_l2cap_if_init();
-  /* initialization of P-256 parameters */
-  p_256_init_curve();
+  smp_key_pool_init();
 
   /* Initialize failure case for certification */
-  smp_cb.cert_failure = static_cast<tSMP_STATUS>(
+  tSMP_STATUS cert_failure = static_cast<tSMP_STATUS>(
       stack_config_get_interface()->get_pts_smp_failure_case());
-  if (smp_cb.cert_failure)
+  for (tSMP_CB& cb : smp_cb_pool) cb.cert_failure = cert_failure;
+  if (cert_failure)
     SMP_TRACE_ERROR("%s PTS FAILURE MODE IN EFFECT (CASE %d)", __func__,
-                    smp_cb.cert_failure);
+                    cert_failure);
+}
+
+/*******************************************************************************
+ *
+ * Function         SMP_FillKeyPool
+ *
+ * Description      This function starts generating the key pairs used by
+ *                  Secure Connections pairings ahead of time, once the
+ *                  controller is ready.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SMP_FillKeyPool(void) {
+  if (bluetooth::shim::is_gd_shim_enabled()) return;
+
+  smp_key_pool_fill();
 }
 
 /*******************************************************************************
@@ -99,7 +118,9 @@ void SMP_Init(void) {
  *
  ******************************************************************************/
 uint8_t SMP_SetTraceLevel(uint8_t new_level) {
-  if (new_level != 0xFF) smp_cb.trace_level = new_level;
+  if (new_level != 0xFF) {
+    for (tSMP_CB& cb : smp_cb_pool) cb.trace_level = new_level;
+  }
 
   return (smp_cb.trace_level);
 }
@@ -122,7 +143,7 @@ bool SMP_Register(tSMP_CALLBACK* p_cback) {
   if (smp_cb.p_callback != NULL) {
     SMP_TRACE_ERROR("SMP_Register: duplicate registration, overwrite it");
   }
-  smp_cb.p_callback = p_cback;
+  for (tSMP_CB& cb : smp_cb_pool) cb.p_callback = p_cback;
 
   return (true);
 }
@@ -132,7 +153,8 @@ bool SMP_Register(tSMP_CALLBACK* p_cback) {
  * Function         SMP_Pair
  *
  * Description      This function call to perform a SMP pairing with peer
- *                  device. Device support one SMP pairing at one time.
+ *                  device. Device support SMP_MAX_CONCURRENT_PAIRINGS
+ *                  pairings with different devices at one time.
  *
  * Parameters       bd_addr - peer device bd address.
  *
@@ -142,7 +164,9 @@ bool SMP_Register(tSMP_CALLBACK* p_cback) {
 tSMP_STATUS SMP_Pair(const RawAddress& bd_addr, tBLE_ADDR_TYPE addr_type) {
   LOG_ASSERT(!bluetooth::shim::is_gd_shim_enabled())
       << "Legacy SMP API should not be invoked when GD Security is used";
-  tSMP_CB* p_cb = &smp_cb;
+  tSMP_CB* p_cb = smp_cb_alloc(bd_addr);
+
+  if (p_cb == NULL) return SMP_BUSY;
 
   SMP_TRACE_EVENT("%s: state=%d br_state=%d flag=0x%x, bd_addr=%s", __func__,
                   p_cb->state, p_cb->br_state, p_cb->flags,
@@ -238,11 +262,13 @@ bool SMP_PairCancel(const RawAddress& bd_addr) {
   LOG_ASSERT(!bluetooth::shim::is_gd_shim_enabled())
       << "Legacy SMP API should not be invoked when GD Security is used";
 
-  tSMP_CB* p_cb = &smp_cb;
+  tSMP_CB* p_cb = smp_cb_find(bd_addr);
+
+  if (p_cb == NULL) return false;
 
   SMP_TRACE_EVENT("SMP_CancelPair state=%d flag=0x%x ", p_cb->state,
                   p_cb->flags);
-  if (p_cb->state != SMP_STATE_IDLE && p_cb->pairing_bda == bd_addr) {
+  if (p_cb->state != SMP_STATE_IDLE) {
     p_cb->is_pair_cancel = true;
     SMP_TRACE_DEBUG("Cancel Pairing: set fail reason Unknown");
     tSMP_INT_DATA smp_int_data;
@@ -273,69 +299,72 @@ void SMP_SecurityGrant(const RawAddress& bd_addr, tSMP_STATUS res) {
 
   SMP_TRACE_EVENT("SMP_SecurityGrant ");
 
+  tSMP_CB* p_cb = smp_cb_find(bd_addr);
+  if (p_cb == NULL) return;
+
   // If just showing consent dialog, send response
-  if (smp_cb.cb_evt == SMP_CONSENT_REQ_EVT) {
+  if (p_cb->cb_evt == SMP_CONSENT_REQ_EVT) {
     // If JUSTWORKS, this is used to display the consent dialog
-    if (smp_cb.selected_association_model == SMP_MODEL_SEC_CONN_JUSTWORKS) {
+    if (p_cb->selected_association_model == SMP_MODEL_SEC_CONN_JUSTWORKS) {
       if (res == SMP_SUCCESS) {
-        smp_sm_event(&smp_cb, SMP_SC_NC_OK_EVT, NULL);
+        smp_sm_event(p_cb, SMP_SC_NC_OK_EVT, NULL);
       } else {
         SMP_TRACE_WARNING("%s() - Consent dialog fails for JUSTWORKS",
                           __func__);
         /* send pairing failure */
         tSMP_INT_DATA smp_int_data;
         smp_int_data.status = SMP_NUMERIC_COMPAR_FAIL;
-        smp_sm_event(&smp_cb, SMP_AUTH_CMPL_EVT, &smp_int_data);
+        smp_sm_event(p_cb, SMP_AUTH_CMPL_EVT, &smp_int_data);
       }
-    } else if (smp_cb.selected_association_model == SMP_MODEL_ENCRYPTION_ONLY) {
+    } else if (p_cb->selected_association_model == SMP_MODEL_ENCRYPTION_ONLY) {
       if (res == SMP_SUCCESS) {
-        smp_cb.sec_level = SMP_SEC_UNAUTHENTICATE;
+        p_cb->sec_level = SMP_SEC_UNAUTHENTICATE;
 
         tSMP_KEY key;
         tSMP_INT_DATA smp_int_data;
         key.key_type = SMP_KEY_TYPE_TK;
-        key.p_data = smp_cb.tk.data();
+        key.p_data = p_cb->tk.data();
         smp_int_data.key = key;
 
-        smp_cb.tk = {0};
-        smp_sm_event(&smp_cb, SMP_KEY_READY_EVT, &smp_int_data);
+        p_cb->tk = {0};
+        smp_sm_event(p_cb, SMP_KEY_READY_EVT, &smp_int_data);
       } else {
         SMP_TRACE_WARNING("%s() - Consent dialog fails for ENCRYPTION_ONLY",
                           __func__);
         /* send pairing failure */
         tSMP_INT_DATA smp_int_data;
         smp_int_data.status = SMP_NUMERIC_COMPAR_FAIL;
-        smp_sm_event(&smp_cb, SMP_AUTH_CMPL_EVT, &smp_int_data);
+        smp_sm_event(p_cb, SMP_AUTH_CMPL_EVT, &smp_int_data);
       }
     }
     return;
   }
 
-  if (smp_cb.smp_over_br) {
-    if (smp_cb.br_state != SMP_BR_STATE_WAIT_APP_RSP ||
-        smp_cb.cb_evt != SMP_SEC_REQUEST_EVT || smp_cb.pairing_bda != bd_addr) {
+  if (p_cb->smp_over_br) {
+    if (p_cb->br_state != SMP_BR_STATE_WAIT_APP_RSP ||
+        p_cb->cb_evt != SMP_SEC_REQUEST_EVT || p_cb->pairing_bda != bd_addr) {
       return;
     }
 
     /* clear the SMP_SEC_REQUEST_EVT event after get grant */
     /* avoid generating duplicate pair request */
-    smp_cb.cb_evt = SMP_EVT_NONE;
+    p_cb->cb_evt = SMP_EVT_NONE;
     tSMP_INT_DATA smp_int_data;
     smp_int_data.status = res;
-    smp_br_state_machine_event(&smp_cb, SMP_BR_API_SEC_GRANT_EVT,
+    smp_br_state_machine_event(p_cb, SMP_BR_API_SEC_GRANT_EVT,
                                &smp_int_data);
     return;
   }
 
-  if (smp_cb.state != SMP_STATE_WAIT_APP_RSP ||
-      smp_cb.cb_evt != SMP_SEC_REQUEST_EVT || smp_cb.pairing_bda != bd_addr)
+  if (p_cb->state != SMP_STATE_WAIT_APP_RSP ||
+      p_cb->cb_evt != SMP_SEC_REQUEST_EVT || p_cb->pairing_bda != bd_addr)
     return;
   /* clear the SMP_SEC_REQUEST_EVT event after get grant */
   /* avoid generate duplicate pair request */
-  smp_cb.cb_evt = SMP_EVT_NONE;
+  p_cb->cb_evt = SMP_EVT_NONE;
   tSMP_INT_DATA smp_int_data;
   smp_int_data.status = res;
-  smp_sm_event(&smp_cb, SMP_API_SEC_GRANT_EVT, &smp_int_data);
+  smp_sm_event(p_cb, SMP_API_SEC_GRANT_EVT, &smp_int_data);
 }
 
 /*******************************************************************************
@@ -358,18 +387,18 @@ void SMP_PasskeyReply(const RawAddress& bd_addr, uint8_t res,
   LOG_ASSERT(!bluetooth::shim::is_gd_shim_enabled())
       << "Legacy SMP API should not be invoked when GD Security is used";
 
-  tSMP_CB* p_cb = &smp_cb;
+  tSMP_CB* p_cb = smp_cb_find(bd_addr);
 
   SMP_TRACE_EVENT("SMP_PasskeyReply: Key: %d  Result:%d", passkey, res);
 
-  /* If timeout already expired or has been canceled, ignore the reply */
-  if (p_cb->cb_evt != SMP_PASSKEY_REQ_EVT) {
-    SMP_TRACE_WARNING("SMP_PasskeyReply() - Wrong State: %d", p_cb->state);
+  if (p_cb == NULL) {
+    SMP_TRACE_ERROR("SMP_PasskeyReply() - Wrong BD Addr");
     return;
   }
 
-  if (bd_addr != p_cb->pairing_bda) {
-    SMP_TRACE_ERROR("SMP_PasskeyReply() - Wrong BD Addr");
+  /* If timeout already expired or has been canceled, ignore the reply */
+  if (p_cb->cb_evt != SMP_PASSKEY_REQ_EVT) {
+    SMP_TRACE_WARNING("SMP_PasskeyReply() - Wrong State: %d", p_cb->state);
     return;
   }
 
@@ -391,9 +420,9 @@ void SMP_PasskeyReply(const RawAddress& bd_addr, uint8_t res,
              SMP_MODEL_SEC_CONN_PASSKEY_ENT) {
     tSMP_INT_DATA smp_int_data;
     smp_int_data.passkey = passkey;
-    smp_sm_event(&smp_cb, SMP_SC_KEY_READY_EVT, &smp_int_data);
+    smp_sm_event(p_cb, SMP_SC_KEY_READY_EVT, &smp_int_data);
   } else {
-    smp_convert_string_to_tk(&p_cb->tk, passkey);
+    smp_convert_string_to_tk(p_cb, passkey);
   }
 
   return;
@@ -415,18 +444,18 @@ void SMP_ConfirmReply(const RawAddress& bd_addr, uint8_t res) {
   LOG_ASSERT(!bluetooth::shim::is_gd_shim_enabled())
       << "Legacy SMP API should not be invoked when GD Security is used";
 
-  tSMP_CB* p_cb = &smp_cb;
+  tSMP_CB* p_cb = smp_cb_find(bd_addr);
 
   SMP_TRACE_EVENT("%s: Result:%d", __func__, res);
 
-  /* If timeout already expired or has been canceled, ignore the reply */
-  if (p_cb->cb_evt != SMP_NC_REQ_EVT) {
-    SMP_TRACE_WARNING("%s() - Wrong State: %d", __func__, p_cb->state);
+  if (p_cb == NULL) {
+    SMP_TRACE_ERROR("%s() - Wrong BD Addr", __func__);
     return;
   }
 
-  if (bd_addr != p_cb->pairing_bda) {
-    SMP_TRACE_ERROR("%s() - Wrong BD Addr", __func__);
+  /* If timeout already expired or has been canceled, ignore the reply */
+  if (p_cb->cb_evt != SMP_NC_REQ_EVT) {
+    SMP_TRACE_WARNING("%s() - Wrong State: %d", __func__, p_cb->state);
     return;
   }
 
@@ -463,10 +492,12 @@ void SMP_OobDataReply(const RawAddress& bd_addr, tSMP_STATUS res, uint8_t len,
   LOG_ASSERT(!bluetooth::shim::is_gd_shim_enabled())
       << "Legacy SMP API should not be invoked when GD Security is used";
 
-  tSMP_CB* p_cb = &smp_cb;
+  tSMP_CB* p_cb = smp_cb_find(bd_addr);
   tSMP_KEY key;
 
-  SMP_TRACE_EVENT("%s State: %d  res:%d", __func__, smp_cb.state, res);
+  if (p_cb == NULL) return;
+
+  SMP_TRACE_EVENT("%s State: %d  res:%d", __func__, p_cb->state, res);
 
   /* If timeout already expired or has been canceled, ignore the reply */
   if (p_cb->state != SMP_STATE_WAIT_APP_RSP || p_cb->cb_evt != SMP_OOB_REQ_EVT)
@@ -486,7 +517,7 @@ void SMP_OobDataReply(const RawAddress& bd_addr, tSMP_STATUS res, uint8_t len,
 
     tSMP_INT_DATA smp_int_data;
     smp_int_data.key = key;
-    smp_sm_event(&smp_cb, SMP_KEY_READY_EVT, &smp_int_data);
+    smp_sm_event(p_cb, SMP_KEY_READY_EVT, &smp_int_data);
   }
 }
 
@@ -503,6 +534,16 @@ void SMP_OobDataReply(const RawAddress& bd_addr, tSMP_STATUS res, uint8_t len,
 void SMP_SecureConnectionOobDataReply(uint8_t* p_data) {
   tSMP_CB* p_cb = &smp_cb;
 
+  /* the reply does not carry the address of the device, it goes to the pairing
+   * which waits for the OOB data */
+  for (tSMP_CB& cb : smp_cb_pool) {
+    if (cb.state == SMP_STATE_WAIT_APP_RSP &&
+        cb.cb_evt == SMP_SC_OOB_REQ_EVT) {
+      p_cb = &cb;
+      break;
+    }
+  }
+
   tSMP_SC_OOB_DATA* p_oob = (tSMP_SC_OOB_DATA*)p_data;
   if (!p_oob) {
     SMP_TRACE_ERROR("%s received no data", __func__);
@@ -556,7 +597,7 @@ void SMP_SecureConnectionOobDataReply(uint8_t* p_data) {
   p_cb->sc_oob_data = *p_oob;
 
   smp_int_data.p_data = p_data;
-  smp_sm_event(&smp_cb, SMP_SC_OOB_DATA_EVT, &smp_int_data);
+  smp_sm_event(p_cb, SMP_SC_OOB_DATA_EVT, &smp_int_data);
 }
 
 /*******************************************************************************
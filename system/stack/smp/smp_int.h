@@ -231,6 +231,15 @@ typedef struct {
   BT_HDR* p_copy;
 } tSMP_REQ_Q_ENTRY;
 
+/* Times of the pairing phases, in ms since boot, 0 until the phase is reached */
+typedef struct {
+  uint64_t start_ms;
+  uint64_t local_publ_key_ms;
+  uint64_t peer_publ_key_ms;
+  uint64_t dhkey_ms;
+  bool local_key_from_pool;
+} tSMP_PAIRING_TIMES;
+
 /* SMP control block */
 typedef struct {
   tSMP_CALLBACK* p_callback;
@@ -310,12 +319,16 @@ typedef struct {
   tSMP_STATUS cert_failure; /*failure case for certification */
   alarm_t* delayed_auth_timer_ent;
   tBLE_BD_ADDR pairing_ble_bd_addr;
+  tSMP_PAIRING_TIMES pairing_times;
 } tSMP_CB;
 
 /* Server Action functions are of this type */
 typedef void (*tSMP_ACT)(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 
-extern tSMP_CB smp_cb;
+/* Control blocks of the LE pairings in progress, the first one is also the
+ * one of the pairings over BR/EDR and of the local OOB data */
+extern tSMP_CB smp_cb_pool[SMP_MAX_CONCURRENT_PAIRINGS];
+extern tSMP_CB& smp_cb;
 
 /* Functions provided by att_main.cc */
 void smp_init(void);
@@ -323,8 +336,8 @@ void smp_init(void);
 /* smp main */
 bool smp_sm_event(tSMP_CB* p_cb, tSMP_EVENT event, tSMP_INT_DATA* p_data);
 
-tSMP_STATE smp_get_state(void);
-void smp_set_state(tSMP_STATE state);
+tSMP_STATE smp_get_state(const tSMP_CB* p_cb);
+void smp_set_state(tSMP_CB* p_cb, tSMP_STATE state);
 
 /* smp_br_main */
 void smp_br_state_machine_event(tSMP_CB* p_cb, tSMP_BR_EVENT event,
@@ -388,7 +401,7 @@ void smp_wait_for_both_public_keys(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_start_passkey_verification(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_process_secure_connection_oob_data(tSMP_CB* p_cb,
                                             tSMP_INT_DATA* p_data);
-void smp_process_secure_connection_long_term_key(void);
+void smp_process_secure_connection_long_term_key(tSMP_CB* p_cb);
 void smp_set_local_oob_keys(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_set_local_oob_random_commitment(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_set_derive_link_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
@@ -414,9 +427,11 @@ void smp_log_metrics(const RawAddress& bd_addr, bool is_outgoing,
                      const uint8_t* p_buf, size_t buf_len, bool is_over_br);
 bool smp_send_cmd(uint8_t cmd_code, tSMP_CB* p_cb);
 void smp_cb_cleanup(tSMP_CB* p_cb);
+tSMP_CB* smp_cb_find(const RawAddress& bd_addr);
+tSMP_CB* smp_cb_alloc(const RawAddress& bd_addr);
 void smp_reset_control_value(tSMP_CB* p_cb);
 void smp_proc_pairing_cmpl(tSMP_CB* p_cb);
-void smp_convert_string_to_tk(Octet16* tk, uint32_t passkey);
+void smp_convert_string_to_tk(tSMP_CB* p_cb, uint32_t passkey);
 void smp_mask_enc_key(uint8_t loc_enc_size, Octet16* p_data);
 void smp_rsp_timeout(void* data);
 void smp_delayed_auth_complete_timeout(void* data);
@@ -445,6 +460,8 @@ void smp_generate_rand_cont(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_use_oob_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_compute_dhkey(tSMP_CB* p_cb);
+void smp_key_pool_init(void);
+void smp_key_pool_fill(void);
 void smp_calculate_local_commitment(tSMP_CB* p_cb);
 Octet16 smp_calculate_peer_commitment(tSMP_CB* p_cb);
 void smp_calculate_numeric_comparison_display_number(tSMP_CB* p_cb,
@@ -26,12 +26,16 @@
 
 #include <algorithm>
 #include <cstring>
+#include <deque>
 
 #include "bt_target.h"
 #include "btm_ble_api.h"
 #include "btm_ble_int.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
+#include "osi/include/alarm.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "p_256_ecc_pp.h"
 #include "smp_int.h"
 #include "stack/btm/btm_dev.h"
@@ -53,6 +57,8 @@ using crypto_toolbox::aes_128;
 static void smp_process_stk(tSMP_CB* p_cb, Octet16* p);
 static Octet16 smp_calculate_legacy_short_term_key(tSMP_CB* p_cb);
 static void smp_process_private_key(tSMP_CB* p_cb);
+static void smp_local_publ_key_created(tSMP_CB* p_cb);
+static bool smp_key_pool_take(tSMP_CB* p_cb);
 
 #define SMP_PASSKEY_MASK 0xfff00000
 
@@ -114,7 +120,7 @@ void smp_proc_passkey(tSMP_CB* p_cb, BT_OCTET8 rand) {
   if (p_cb->selected_association_model == SMP_MODEL_SEC_CONN_PASSKEY_DISP) {
     tSMP_INT_DATA smp_int_data;
     smp_int_data.passkey = passkey;
-    smp_sm_event(&smp_cb, SMP_KEY_READY_EVT, &smp_int_data);
+    smp_sm_event(p_cb, SMP_KEY_READY_EVT, &smp_int_data);
   } else {
     tSMP_KEY key;
     key.key_type = SMP_KEY_TYPE_TK;
@@ -532,11 +538,11 @@ static void smp_generate_ltk_cont(uint16_t div, tSMP_CB* p_cb) {
 void smp_generate_ltk(tSMP_CB* p_cb, UNUSED_ATTR tSMP_INT_DATA* p_data) {
   SMP_TRACE_DEBUG("%s", __func__);
 
-  if (smp_get_br_state() == SMP_BR_STATE_BOND_PENDING) {
+  if (p_cb->br_state == SMP_BR_STATE_BOND_PENDING) {
     smp_br_process_link_key(p_cb, NULL);
     return;
   } else if (p_cb->le_secure_connections_mode_is_used) {
-    smp_process_secure_connection_long_term_key();
+    smp_process_secure_connection_long_term_key(p_cb);
     return;
   }
 
@@ -612,6 +618,13 @@ void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
     LOG_WARN("OOB Association Model with no saved data present");
   }
 
+  if (smp_key_pool_take(p_cb)) {
+    LOG_DEBUG("Using a key pair generated ahead of the pairing");
+    p_cb->pairing_times.local_key_from_pool = true;
+    smp_local_publ_key_created(p_cb);
+    return;
+  }
+
   btsnd_hcic_ble_rand(Bind(
       [](tSMP_CB* p_cb, BT_OCTET8 rand) {
         memcpy((void*)p_cb->private_key, rand, BT_OCTET8_LEN);
@@ -688,12 +701,21 @@ void smp_use_oob_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
       break;
     default:
       LOG_INFO("create secret key anew");
-      smp_set_state(SMP_STATE_PAIR_REQ_RSP);
+      smp_set_state(p_cb, SMP_STATE_PAIR_REQ_RSP);
       smp_decide_association_model(p_cb, NULL);
       break;
   }
 }
 
+static void smp_calculate_public_key(const BT_OCTET32 private_key,
+                                     tSMP_PUBLIC_KEY* p_publ_key) {
+  Point public_key;
+
+  ECC_PointMult_Base(&public_key, (const uint32_t*)private_key);
+  memcpy(p_publ_key->x, public_key.x, BT_OCTET32_LEN);
+  memcpy(p_publ_key->y, public_key.y, BT_OCTET32_LEN);
+}
+
 /*******************************************************************************
  *
  * Function         smp_process_private_key
@@ -706,15 +728,25 @@ void smp_use_oob_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
  *
  ******************************************************************************/
 void smp_process_private_key(tSMP_CB* p_cb) {
-  Point public_key;
-  BT_OCTET32 private_key;
-
   SMP_TRACE_DEBUG("%s", __func__);
 
-  memcpy(private_key, p_cb->private_key, BT_OCTET32_LEN);
-  ECC_PointMult(&public_key, &(curve_p256.G), (uint32_t*)private_key);
-  memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
-  memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
+  smp_calculate_public_key(p_cb->private_key, &p_cb->loc_publ_key);
+  smp_local_publ_key_created(p_cb);
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_local_publ_key_created
+ *
+ * Description      This function notifies SM that the local private key /
+ *                  public key pair is ready.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void smp_local_publ_key_created(tSMP_CB* p_cb) {
+  p_cb->pairing_times.local_publ_key_ms =
+      bluetooth::common::time_get_os_boottime_ms();
 
   smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
                                       BT_OCTET32_LEN);
@@ -751,6 +783,7 @@ void smp_compute_dhkey(tSMP_CB* p_cb) {
   ECC_PointMult(&new_publ_key, &peer_publ_key, (uint32_t*)private_key);
 
   memcpy(p_cb->dhkey, new_publ_key.x, BT_OCTET32_LEN);
+  p_cb->pairing_times.dhkey_ms = bluetooth::common::time_get_os_boottime_ms();
 
   smp_debug_print_nbyte_little_endian(p_cb->dhkey, "Old DHKey", BT_OCTET32_LEN);
 
@@ -764,6 +797,158 @@ void smp_compute_dhkey(tSMP_CB* p_cb) {
                                       BT_OCTET32_LEN);
 }
 
+/* Configuration of the pool of key pairs generated ahead of the pairings. A
+ * pool size of 0 disables the pool. */
+static const char kPropertyKeyPoolSize[] =
+    "bluetooth.core.smp.le.key_pool_size";
+static const char kPropertyKeyPoolLifetimeMs[] =
+    "bluetooth.core.smp.le.key_pool_lifetime_ms";
+static const int32_t kDefaultKeyPoolSize = 1;
+/* A key pair that is not used in time is dropped and replaced */
+static const int32_t kDefaultKeyPoolLifetimeMs = 10 * 60 * 1000;
+
+typedef struct {
+  BT_OCTET32 private_key;
+  tSMP_PUBLIC_KEY publ_key;
+  uint64_t created_ms;
+} tSMP_KEY_PAIR;
+
+static struct {
+  std::deque<tSMP_KEY_PAIR> key_pairs;
+  size_t size;
+  uint64_t lifetime_ms;
+  bool is_filling;
+  BT_OCTET32 next_private_key;
+  alarm_t* expiry_timer;
+} smp_key_pool;
+
+static void smp_key_pool_drop_expired() {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  while (!smp_key_pool.key_pairs.empty() &&
+         now_ms - smp_key_pool.key_pairs.front().created_ms >=
+             smp_key_pool.lifetime_ms) {
+    memset(&smp_key_pool.key_pairs.front(), 0, sizeof(tSMP_KEY_PAIR));
+    smp_key_pool.key_pairs.pop_front();
+  }
+}
+
+static void smp_key_pool_expiry_timeout(void* /* data */) {
+  smp_key_pool_drop_expired();
+  smp_key_pool_fill();
+}
+
+/* Arm the timer for the oldest key pair of the pool */
+static void smp_key_pool_schedule_expiry() {
+  if (smp_key_pool.key_pairs.empty()) {
+    alarm_cancel(smp_key_pool.expiry_timer);
+    return;
+  }
+  uint64_t age_ms = bluetooth::common::time_get_os_boottime_ms() -
+                    smp_key_pool.key_pairs.front().created_ms;
+  uint64_t remaining_ms = age_ms < smp_key_pool.lifetime_ms
+                              ? smp_key_pool.lifetime_ms - age_ms
+                              : 0;
+  alarm_set_on_mloop(smp_key_pool.expiry_timer, remaining_ms,
+                     smp_key_pool_expiry_timeout, nullptr);
+}
+
+/* The private key is read from the controller 8 octets at a time, as for the
+ * pairings */
+static void smp_key_pool_proc_rand(uint8_t offset, BT_OCTET8 rand) {
+  memcpy(&smp_key_pool.next_private_key[offset], rand, BT_OCTET8_LEN);
+  offset += BT_OCTET8_LEN;
+  if (offset < BT_OCTET32_LEN) {
+    btsnd_hcic_ble_rand(Bind(&smp_key_pool_proc_rand, offset));
+    return;
+  }
+
+  tSMP_KEY_PAIR key_pair;
+  memcpy(key_pair.private_key, smp_key_pool.next_private_key, BT_OCTET32_LEN);
+  memset(smp_key_pool.next_private_key, 0, BT_OCTET32_LEN);
+  smp_calculate_public_key(key_pair.private_key, &key_pair.publ_key);
+  key_pair.created_ms = bluetooth::common::time_get_os_boottime_ms();
+  smp_key_pool.is_filling = false;
+
+  if (smp_key_pool.key_pairs.size() < smp_key_pool.size) {
+    smp_key_pool.key_pairs.push_back(key_pair);
+    smp_key_pool_schedule_expiry();
+  }
+  memset(&key_pair, 0, sizeof(key_pair));
+  smp_key_pool_fill();
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_key_pool_init
+ *
+ * Description      This function reads the configuration of the pool of key
+ *                  pairs and empties it.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_key_pool_init(void) {
+  int32_t size = osi_property_get_int32(kPropertyKeyPoolSize,
+                                        kDefaultKeyPoolSize);
+  int32_t lifetime_ms = osi_property_get_int32(kPropertyKeyPoolLifetimeMs,
+                                               kDefaultKeyPoolLifetimeMs);
+  smp_key_pool.size = size > 0 ? size : 0;
+  smp_key_pool.lifetime_ms =
+      lifetime_ms > 0 ? lifetime_ms : kDefaultKeyPoolLifetimeMs;
+
+  for (auto& key_pair : smp_key_pool.key_pairs) {
+    memset(&key_pair, 0, sizeof(key_pair));
+  }
+  smp_key_pool.key_pairs.clear();
+  smp_key_pool.is_filling = false;
+  if (smp_key_pool.expiry_timer == nullptr) {
+    smp_key_pool.expiry_timer = alarm_new("smp.key_pool_expiry_timer");
+  }
+  alarm_cancel(smp_key_pool.expiry_timer);
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_key_pool_fill
+ *
+ * Description      This function starts the generation of key pairs in the
+ *                  background, until the pool is full, so that a Secure
+ *                  Connections pairing does not have to wait for the
+ *                  controller to generate its private key.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_key_pool_fill(void) {
+  if (smp_key_pool.is_filling ||
+      smp_key_pool.key_pairs.size() >= smp_key_pool.size) {
+    return;
+  }
+  const controller_t* controller = controller_get_interface();
+  if (!controller->get_is_ready() || !controller->supports_ble()) {
+    return;
+  }
+
+  smp_key_pool.is_filling = true;
+  btsnd_hcic_ble_rand(Bind(&smp_key_pool_proc_rand, (uint8_t)0));
+}
+
+/* Move the oldest key pair of the pool to the control block */
+static bool smp_key_pool_take(tSMP_CB* p_cb) {
+  smp_key_pool_drop_expired();
+  if (smp_key_pool.key_pairs.empty()) {
+    return false;
+  }
+
+  tSMP_KEY_PAIR& key_pair = smp_key_pool.key_pairs.front();
+  memcpy(p_cb->private_key, key_pair.private_key, BT_OCTET32_LEN);
+  p_cb->loc_publ_key = key_pair.publ_key;
+  memset(&key_pair, 0, sizeof(tSMP_KEY_PAIR));
+  smp_key_pool.key_pairs.pop_front();
+  smp_key_pool_schedule_expiry();
+  return true;
+}
+
 /** The function calculates and saves local commmitment in CB. */
 void smp_calculate_local_commitment(tSMP_CB* p_cb) {
   uint8_t random_input;
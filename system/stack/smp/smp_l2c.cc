@@ -93,7 +93,7 @@ static void smp_connect_callback(UNUSED_ATTR uint16_t channel,
                                  const RawAddress& bd_addr, bool connected,
                                  UNUSED_ATTR uint16_t reason,
                                  tBT_TRANSPORT transport) {
-  tSMP_CB* p_cb = &smp_cb;
+  tSMP_CB* p_cb = smp_cb_find(bd_addr);
   tSMP_INT_DATA int_data;
 
   if (bd_addr.IsEmpty()) {
@@ -115,7 +115,7 @@ static void smp_connect_callback(UNUSED_ATTR uint16_t channel,
               ADDRESS_TO_LOGGABLE_CSTR(bd_addr), bt_transport_text(transport).c_str());
   }
 
-  if (bd_addr == p_cb->pairing_bda) {
+  if (p_cb != NULL) {
     LOG_DEBUG("Received callback for device in pairing process:%s state:%s",
               ADDRESS_TO_LOGGABLE_CSTR(bd_addr),
               (connected) ? "connected" : "disconnected");
@@ -152,7 +152,7 @@ static void smp_connect_callback(UNUSED_ATTR uint16_t channel,
  ******************************************************************************/
 static void smp_data_received(uint16_t channel, const RawAddress& bd_addr,
                               BT_HDR* p_buf) {
-  tSMP_CB* p_cb = &smp_cb;
+  tSMP_CB* p_cb = smp_cb_find(bd_addr);
   uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   uint8_t cmd;
 
@@ -174,25 +174,28 @@ static void smp_data_received(uint16_t channel, const RawAddress& bd_addr,
     return;
   }
 
-  /* reject the pairing request if there is an on-going SMP pairing */
+  /* reject the pairing request if all the control blocks run the pairings of
+   * other devices */
   if (SMP_OPCODE_PAIRING_REQ == cmd || SMP_OPCODE_SEC_REQ == cmd) {
+    p_cb = smp_cb_alloc(bd_addr);
+    if (p_cb == NULL) {
+      osi_free(p_buf);
+      smp_reject_unexpected_pairing_command(bd_addr);
+      return;
+    }
     if ((p_cb->state == SMP_STATE_IDLE) &&
         (p_cb->br_state == SMP_BR_STATE_IDLE) &&
         !(p_cb->flags & SMP_PAIR_FLAGS_WE_STARTED_DD)) {
       p_cb->role = L2CA_GetBleConnRole(bd_addr);
       p_cb->pairing_bda = bd_addr;
-    } else if (bd_addr != p_cb->pairing_bda) {
-      osi_free(p_buf);
-      smp_reject_unexpected_pairing_command(bd_addr);
-      return;
     }
     /* else, out of state pairing request/security request received, passed into
      * SM */
   }
 
-  if (bd_addr == p_cb->pairing_bda) {
+  if (p_cb != NULL) {
     alarm_set_on_mloop(p_cb->smp_rsp_timer_ent, SMP_WAIT_FOR_RSP_TIMEOUT_MS,
-                       smp_rsp_timeout, NULL);
+                       smp_rsp_timeout, p_cb);
 
     smp_log_metrics(p_cb->pairing_bda, false /* incoming */,
                     p_buf->data + p_buf->offset, p_buf->len,
@@ -257,7 +260,7 @@ static void smp_br_connect_callback(uint16_t channel, const RawAddress& bd_addr,
    * Classic transport shouldn't impact that.
    */
   tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(p_cb->pairing_bda);
-  if (smp_get_state() == SMP_STATE_BOND_PENDING &&
+  if (smp_get_state(p_cb) == SMP_STATE_BOND_PENDING &&
       (p_dev_rec && p_dev_rec->is_link_key_known()) &&
       alarm_is_scheduled(p_cb->delayed_auth_timer_ent)) {
     /* If we were to not return here, we would reset SMP control block, and
@@ -335,7 +338,7 @@ static void smp_br_data_received(uint16_t channel, const RawAddress& bd_addr,
 
   if (bd_addr == p_cb->pairing_bda) {
     alarm_set_on_mloop(p_cb->smp_rsp_timer_ent, SMP_WAIT_FOR_RSP_TIMEOUT_MS,
-                       smp_rsp_timeout, NULL);
+                       smp_rsp_timeout, p_cb);
 
     smp_log_metrics(p_cb->pairing_bda, false /* incoming */,
                     p_buf->data + p_buf->offset, p_buf->len,
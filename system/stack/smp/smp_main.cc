@@ -23,6 +23,7 @@
 #include <string.h>
 #include "smp_int.h"
 
+#include "common/time_util.h"
 #include "osi/include/log.h"
 
 namespace {
@@ -930,7 +931,8 @@ typedef const uint8_t (*tSMP_ENTRY_TBL)[SMP_STATE_MAX];
 static const tSMP_ENTRY_TBL smp_entry_table[] = {smp_central_entry_map,
                                                  smp_peripheral_entry_map};
 
-tSMP_CB smp_cb;
+tSMP_CB smp_cb_pool[SMP_MAX_CONCURRENT_PAIRINGS];
+tSMP_CB& smp_cb = smp_cb_pool[0];
 
 #define SMP_ALL_TBL_MASK 0x80
 
@@ -938,18 +940,18 @@ tSMP_CB smp_cb;
  * Function     smp_set_state
  * Returns      None
  ******************************************************************************/
-void smp_set_state(tSMP_STATE state) {
+void smp_set_state(tSMP_CB* p_cb, tSMP_STATE state) {
   if (state < SMP_STATE_MAX) {
     SMP_TRACE_DEBUG("State change: %s(%d) ==> %s(%d)",
-                    smp_get_state_name(smp_cb.state), smp_cb.state,
+                    smp_get_state_name(p_cb->state), p_cb->state,
                     smp_get_state_name(state), state);
-    if (smp_cb.state != state) {
+    if (p_cb->state != state) {
       BTM_LogHistory(
-          kBtmLogTag, smp_cb.pairing_ble_bd_addr, "Security state changed",
-          base::StringPrintf("%s => %s", smp_get_state_name(smp_cb.state),
+          kBtmLogTag, p_cb->pairing_ble_bd_addr, "Security state changed",
+          base::StringPrintf("%s => %s", smp_get_state_name(p_cb->state),
                              smp_get_state_name(state)));
     }
-    smp_cb.state = state;
+    p_cb->state = state;
   } else {
     SMP_TRACE_DEBUG("smp_set_state invalid state =%d", state);
   }
@@ -959,7 +961,7 @@ void smp_set_state(tSMP_STATE state) {
  * Function     smp_get_state
  * Returns      The smp state
  ******************************************************************************/
-tSMP_STATE smp_get_state(void) { return smp_cb.state; }
+tSMP_STATE smp_get_state(const tSMP_CB* p_cb) { return p_cb->state; }
 
 /*******************************************************************************
  *
@@ -1021,7 +1023,10 @@ bool smp_sm_event(tSMP_CB* p_cb, tSMP_EVENT event, tSMP_INT_DATA* p_data) {
 
   /* Get possible next state from state table. */
 
-  smp_set_state(state_table[entry - 1][SMP_SME_NEXT_STATE]);
+  smp_set_state(p_cb, state_table[entry - 1][SMP_SME_NEXT_STATE]);
+  if (curr_state == SMP_STATE_IDLE && p_cb->state != SMP_STATE_IDLE) {
+    p_cb->pairing_times.start_ms = bluetooth::common::time_get_os_boottime_ms();
+  }
 
   /* If action is not ignore, clear param, exec action and get next state.
    * The action function may set the Param for cback.
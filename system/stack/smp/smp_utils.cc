@@ -27,6 +27,7 @@
 
 #include "bt_target.h"
 #include "btm_ble_api.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "l2c_api.h"
 #include "osi/include/log.h"
@@ -347,8 +348,12 @@ void smp_log_metrics(const RawAddress& bd_addr, bool is_outgoing,
 bool smp_send_msg_to_L2CAP(const RawAddress& rem_bda, BT_HDR* p_toL2CAP) {
   uint16_t l2cap_ret;
   uint16_t fixed_cid = L2CAP_SMP_CID;
+  tSMP_CB* p_cb = smp_cb_find(rem_bda);
 
-  if (smp_cb.smp_over_br) {
+  /* the rejections of the unexpected pairings have no control block */
+  if (p_cb == NULL) p_cb = &smp_cb;
+
+  if (p_cb->smp_over_br) {
     fixed_cid = L2CAP_SMP_BR_CID;
   }
 
@@ -356,15 +361,13 @@ bool smp_send_msg_to_L2CAP(const RawAddress& rem_bda, BT_HDR* p_toL2CAP) {
 
   smp_log_metrics(rem_bda, true /* outgoing */,
                   p_toL2CAP->data + p_toL2CAP->offset, p_toL2CAP->len,
-                  smp_cb.smp_over_br /* is_over_br */);
+                  p_cb->smp_over_br /* is_over_br */);
 
   l2cap_ret = L2CA_SendFixedChnlData(fixed_cid, rem_bda, p_toL2CAP);
   if (l2cap_ret == L2CAP_DW_FAILED) {
     SMP_TRACE_ERROR("SMP failed to pass msg to L2CAP");
     return false;
   } else {
-    tSMP_CB* p_cb = &smp_cb;
-
     if (p_cb->wait_for_authorization_complete) {
       tSMP_INT_DATA smp_int_data;
       smp_int_data.status = SMP_SUCCESS;
@@ -400,7 +403,7 @@ bool smp_send_cmd(uint8_t cmd_code, tSMP_CB* p_cb) {
     if (p_buf != NULL && smp_send_msg_to_L2CAP(p_cb->pairing_bda, p_buf)) {
       sent = true;
       alarm_set_on_mloop(p_cb->smp_rsp_timer_ent, SMP_WAIT_FOR_RSP_TIMEOUT_MS,
-                         smp_rsp_timeout, NULL);
+                         smp_rsp_timeout, p_cb);
     }
   }
 
@@ -425,8 +428,8 @@ bool smp_send_cmd(uint8_t cmd_code, tSMP_CB* p_cb) {
  * Returns          void
  *
  ******************************************************************************/
-void smp_rsp_timeout(UNUSED_ATTR void* data) {
-  tSMP_CB* p_cb = &smp_cb;
+void smp_rsp_timeout(void* data) {
+  tSMP_CB* p_cb = (tSMP_CB*)data;
 
   SMP_TRACE_EVENT("%s state:%d br_state:%d", __func__, p_cb->state,
                   p_cb->br_state);
@@ -450,16 +453,18 @@ void smp_rsp_timeout(UNUSED_ATTR void* data) {
  * Returns          void
  *
  ******************************************************************************/
-void smp_delayed_auth_complete_timeout(UNUSED_ATTR void* data) {
+void smp_delayed_auth_complete_timeout(void* data) {
+  tSMP_CB* p_cb = (tSMP_CB*)data;
+
   /*
    * Waited for potential pair failure. Send SMP_AUTH_CMPL_EVT if
    * the state is still in bond pending.
    */
-  if (smp_get_state() == SMP_STATE_BOND_PENDING) {
+  if (smp_get_state(p_cb) == SMP_STATE_BOND_PENDING) {
     SMP_TRACE_EVENT("%s sending delayed auth complete.", __func__);
     tSMP_INT_DATA smp_int_data;
     smp_int_data.status = SMP_SUCCESS;
-    smp_sm_event(&smp_cb, SMP_AUTH_CMPL_EVT, &smp_int_data);
+    smp_sm_event(p_cb, SMP_AUTH_CMPL_EVT, &smp_int_data);
   }
 }
 
@@ -832,18 +837,18 @@ static BT_HDR* smp_build_pairing_keypress_notification_cmd(
 
 /** This function is called to convert a 6 to 16 digits numeric character string
  * into SMP TK. */
-void smp_convert_string_to_tk(Octet16* tk, uint32_t passkey) {
-  uint8_t* p = tk->data();
+void smp_convert_string_to_tk(tSMP_CB* p_cb, uint32_t passkey) {
+  uint8_t* p = p_cb->tk.data();
   tSMP_KEY key;
   SMP_TRACE_EVENT("smp_convert_string_to_tk");
   UINT32_TO_STREAM(p, passkey);
 
   key.key_type = SMP_KEY_TYPE_TK;
-  key.p_data = tk->data();
+  key.p_data = p_cb->tk.data();
 
   tSMP_INT_DATA smp_int_data;
   smp_int_data.key = key;
-  smp_sm_event(&smp_cb, SMP_KEY_READY_EVT, &smp_int_data);
+  smp_sm_event(p_cb, SMP_KEY_READY_EVT, &smp_int_data);
 }
 
 /** This function is called to mask off the encryption key based on the maximum
@@ -896,6 +901,60 @@ void smp_cb_cleanup(tSMP_CB* p_cb) {
   p_cb->delayed_auth_timer_ent = delayed_auth_timer_ent;
 }
 
+/* Whether the control block runs a pairing, or waits for the connection of the
+ * one we started */
+static bool smp_cb_in_use(const tSMP_CB* p_cb) {
+  return p_cb->state != SMP_STATE_IDLE || p_cb->br_state != SMP_BR_STATE_IDLE ||
+         (p_cb->flags & SMP_PAIR_FLAGS_WE_STARTED_DD) || p_cb->smp_over_br;
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_cb_find
+ *
+ * Description      This function looks up the control block of the pairing
+ *                  with the device.
+ *
+ * Returns          The control block, or NULL if no pairing with the device is
+ *                  in progress.
+ *
+ ******************************************************************************/
+tSMP_CB* smp_cb_find(const RawAddress& bd_addr) {
+  for (tSMP_CB& cb : smp_cb_pool) {
+    if (smp_cb_in_use(&cb) && cb.pairing_bda == bd_addr) return &cb;
+  }
+
+  /* the first control block keeps the device of its last pairing */
+  if (smp_cb.pairing_bda == bd_addr) return &smp_cb;
+  return NULL;
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_cb_alloc
+ *
+ * Description      This function looks up the control block of the pairing
+ *                  with the device, or picks an idle one for it. The first
+ *                  control block is preferred, so that a single pairing at a
+ *                  time behaves as before.
+ *
+ * Returns          The control block, or NULL if SMP already runs
+ *                  SMP_MAX_CONCURRENT_PAIRINGS pairings with other devices.
+ *
+ ******************************************************************************/
+tSMP_CB* smp_cb_alloc(const RawAddress& bd_addr) {
+  tSMP_CB* p_cb = smp_cb_find(bd_addr);
+  if (p_cb != NULL) return p_cb;
+
+  for (tSMP_CB& cb : smp_cb_pool) {
+    if (!smp_cb_in_use(&cb)) return &cb;
+  }
+
+  SMP_TRACE_WARNING("%s: %d pairings already in progress", __func__,
+                    SMP_MAX_CONCURRENT_PAIRINGS);
+  return NULL;
+}
+
 /*******************************************************************************
  *
  * Function         smp_remove_fixed_channel
@@ -942,6 +1001,34 @@ void smp_reset_control_value(tSMP_CB* p_cb) {
   smp_cb_cleanup(p_cb);
 }
 
+/*******************************************************************************
+ *
+ * Function         smp_log_pairing_times
+ *
+ * Description      This function logs how long each phase of a Secure
+ *                  Connections pairing took.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void smp_log_pairing_times(const tSMP_CB* p_cb) {
+  const tSMP_PAIRING_TIMES& times = p_cb->pairing_times;
+  if (!p_cb->le_secure_connections_mode_is_used || times.start_ms == 0) return;
+
+  auto since_start = [&times](uint64_t phase_ms) -> long long {
+    return phase_ms != 0 ? static_cast<long long>(phase_ms - times.start_ms)
+                         : -1;
+  };
+  LOG_INFO(
+      "Pairing times remote:%s local public key:%lld ms (%s) peer public "
+      "key:%lld ms dhkey:%lld ms complete:%lld ms",
+      ADDRESS_TO_LOGGABLE_CSTR(p_cb->pairing_bda),
+      since_start(times.local_publ_key_ms),
+      times.local_key_from_pool ? "pooled" : "generated",
+      since_start(times.peer_publ_key_ms), since_start(times.dhkey_ms),
+      since_start(bluetooth::common::time_get_os_boottime_ms()));
+}
+
 /*******************************************************************************
  *
  * Function         smp_proc_pairing_cmpl
@@ -1005,8 +1092,12 @@ void smp_proc_pairing_cmpl(tSMP_CB* p_cb) {
     btm_dev_consolidate_existing_connections(pairing_bda);
   }
 
+  smp_log_pairing_times(p_cb);
   smp_reset_control_value(p_cb);
 
+  /* Replace the key pair used by this pairing, now that it is over */
+  smp_key_pool_fill();
+
   if (p_callback) (*p_callback)(SMP_COMPLT_EVT, pairing_bda, &evt_data);
 }
 
@@ -32,6 +32,7 @@
 #include "common/time_util.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "osi/test/AllocationTestHarness.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/a2dp_aac_decoder.h"
@@ -49,6 +50,8 @@ constexpr char kDecodedDataCallbackIsInvoked[] =
 constexpr char kEnqueueCallbackIsInvoked[] =
     "A2DP source enqueue callback is invoked.";
 constexpr uint16_t kPeerMtu = 1000;
+constexpr char kEncodeAheadProperty[] =
+    "persist.bluetooth.a2dp_aac.encode_ahead";
 constexpr char kWavFile[] = "test/a2dp/raw_data/pcm1644s.wav";
 constexpr uint8_t kCodecInfoAacCapability[AVDT_CODEC_SIZE] = {
     8,           // Length (A2DP_AAC_INFO_LEN)
@@ -203,6 +206,33 @@ TEST_F(A2dpAacTest, a2dp_enqueue_cb_is_invoked) {
   log_capture_->WaitUntilLogContains(&promise, kEnqueueCallbackIsInvoked);
 }
 
+TEST_F(A2dpAacTest, a2dp_enqueue_cb_is_invoked_when_encoding_ahead) {
+  log_capture_ = std::make_unique<LogCapture>();
+  auto read_cb = +[](uint8_t* p_buf, uint32_t len) -> uint32_t {
+    ASSERT(kAacReadSize == len);
+    return len;
+  };
+  auto enqueue_cb = +[](BT_HDR* p_buf, size_t frames_n, uint32_t len) -> bool {
+    LOG_DEBUG("%s", kEnqueueCallbackIsInvoked);
+    osi_free(p_buf);
+    return false;
+  };
+  osi_property_set(kEncodeAheadProperty, "true");
+  InitializeEncoder(true, read_cb, enqueue_cb);
+  osi_property_set(kEncodeAheadProperty, "false");
+  // The frames encoded at a tick are sent at the next one
+  uint64_t timestamp_us = bluetooth::common::time_gettimeofday_us();
+  encoder_iface_->send_frames(timestamp_us);
+  usleep(kA2dpTickUs);
+  timestamp_us = bluetooth::common::time_gettimeofday_us();
+  encoder_iface_->send_frames(timestamp_us);
+  usleep(kA2dpTickUs);
+  timestamp_us = bluetooth::common::time_gettimeofday_us();
+  encoder_iface_->send_frames(timestamp_us);
+  std::promise<void> promise;
+  log_capture_->WaitUntilLogContains(&promise, kEnqueueCallbackIsInvoked);
+}
+
 TEST_F(A2dpAacTest, decoded_data_cb_not_invoked_when_empty_packet) {
   auto data_cb = +[](uint8_t* p_buf, uint32_t len) { FAIL(); };
   InitializeDecoder(data_cb);
@@ -18,6 +18,7 @@
 
 #include <base/logging.h>
 #include <gtest/gtest.h>
+#include <opus.h>
 #include <stdio.h>
 
 #include <chrono>
@@ -241,5 +242,36 @@ TEST_F(A2dpOpusTest, decoded_data_cb_invoked) {
   osi_free(packet);
 }
 
+TEST_F(A2dpOpusTest, decoded_data_cb_invoked_for_low_latency_frame) {
+  // 5 ms frame, as sent in the low latency mode
+  constexpr int kFrameSize = A2DP_OPUS_CODEC_DEFAULT_SAMPLERATE / 200;
+  static uint32_t decoded_len;
+  decoded_len = 0;
+  auto data_cb = +[](uint8_t* p_buf, uint32_t len) { decoded_len += len; };
+  InitializeDecoder(data_cb);
+
+  int error;
+  OpusEncoder* encoder = opus_encoder_create(
+      A2DP_OPUS_CODEC_DEFAULT_SAMPLERATE, A2DP_OPUS_CODEC_OUTPUT_CHS,
+      OPUS_APPLICATION_RESTRICTED_LOWDELAY, &error);
+  ASSERT_EQ(error, OPUS_OK);
+  std::vector<int16_t> pcm(kFrameSize * A2DP_OPUS_CODEC_OUTPUT_CHS);
+  memcpy(pcm.data(), wav_reader.GetSamples(), pcm.size() * sizeof(pcm[0]));
+  // The media payload header, then the Opus packet
+  std::vector<uint8_t> data(A2DP_OPUS_MPL_HDR_LEN + 1500);
+  int len = opus_encode(encoder, pcm.data(), kFrameSize,
+                        data.data() + A2DP_OPUS_MPL_HDR_LEN, 1500);
+  opus_encoder_destroy(encoder);
+  ASSERT_GT(len, 0);
+  data[0] = 1;
+  data.resize(A2DP_OPUS_MPL_HDR_LEN + len);
+
+  BT_HDR* packet = AllocateL2capPacket(data);
+  ASSERT_TRUE(decoder_iface_->decode_packet(packet));
+  osi_free(packet);
+  ASSERT_EQ(decoded_len,
+            kFrameSize * A2DP_OPUS_CODEC_OUTPUT_CHS * sizeof(int16_t));
+}
+
 }  // namespace testing
 }  // namespace bluetooth
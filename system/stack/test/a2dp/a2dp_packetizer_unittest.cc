@@ -0,0 +1,72 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/include/a2dp_packetizer.h"
+
+#include <gtest/gtest.h>
+
+#include "stack/include/hcidefs.h"
+
+namespace {
+
+// SBC frame of a stereo 44.1 kHz stream at bitpool 53
+constexpr uint16_t kSbcFrameLen = 119;
+constexpr uint16_t kSbcMediaHeaderLen = 1;
+
+TEST(A2dpPacketizerTest, acl_packet_payload_size) {
+  ASSERT_EQ(A2DP_GetAclPacketPayloadSize(false, false), HCI_DH5_PACKET_SIZE);
+  ASSERT_EQ(A2DP_GetAclPacketPayloadSize(true, false),
+            HCI_EDR2_DH5_PACKET_SIZE);
+  ASSERT_EQ(A2DP_GetAclPacketPayloadSize(true, true), HCI_EDR3_DH5_PACKET_SIZE);
+}
+
+TEST(A2dpPacketizerTest, frames_fitting_one_acl_packet_are_kept) {
+  ASSERT_EQ(A2DP_GetAclAlignedFrameCount(kSbcFrameLen, kSbcMediaHeaderLen, 5,
+                                         HCI_EDR2_DH5_PACKET_SIZE),
+            5);
+  ASSERT_EQ(A2DP_GetAclAlignedFrameCount(kSbcFrameLen, kSbcMediaHeaderLen, 8,
+                                         HCI_EDR3_DH5_PACKET_SIZE),
+            8);
+}
+
+TEST(A2dpPacketizerTest, mostly_empty_acl_packet_is_avoided) {
+  // 15 frames take two 3-DH5 packets, 8 frames fill a single one
+  ASSERT_EQ(A2DP_GetAclAlignedFrameCount(kSbcFrameLen, kSbcMediaHeaderLen, 15,
+                                         HCI_EDR3_DH5_PACKET_SIZE),
+            8);
+  // 4 frames fill a single 2-DH5 packet, the fifth one needs another
+  ASSERT_EQ(A2DP_GetAclAlignedFrameCount(160, kSbcMediaHeaderLen, 5,
+                                         HCI_EDR2_DH5_PACKET_SIZE),
+            4);
+}
+
+TEST(A2dpPacketizerTest, largest_frame_count_on_equal_efficiency) {
+  // 3 frames per 2-DH5 packet either way
+  ASSERT_EQ(A2DP_GetAclAlignedFrameCount(200, kSbcMediaHeaderLen, 6,
+                                         HCI_EDR2_DH5_PACKET_SIZE),
+            6);
+}
+
+TEST(A2dpPacketizerTest, unknown_frame_length) {
+  ASSERT_EQ(A2DP_GetAclAlignedFrameCount(0, kSbcMediaHeaderLen, 5,
+                                         HCI_EDR2_DH5_PACKET_SIZE),
+            5);
+  ASSERT_EQ(A2DP_GetAclAlignedFrameCount(kSbcFrameLen, kSbcMediaHeaderLen, 0,
+                                         HCI_EDR2_DH5_PACKET_SIZE),
+            0);
+}
+
+}  // namespace
@@ -34,6 +34,7 @@
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "osi/test/AllocationTestHarness.h"
+#include "sbc_encoder.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/a2dp_sbc_decoder.h"
 #include "stack/include/a2dp_sbc_encoder.h"
@@ -308,5 +309,49 @@ TEST_F(A2dpSbcTest, get_track_bits_per_sample) {
   ASSERT_EQ(A2DP_GetTrackBitsPerSampleSbc(kCodecInfoSbcCapability), 16);
 }
 
+// Encodes the test file in every subband and channel layout with the SIMD
+// analysis filter and with the portable one
+TEST(A2dpSbcEncoderTest, simd_analysis_filter_is_bit_exact) {
+  const int16_t subbands[] = {SUB_BANDS_4, SUB_BANDS_8};
+  const int16_t channel_modes[] = {SBC_MONO, SBC_DUAL, SBC_STEREO,
+                                   SBC_JOINT_STEREO};
+  const int16_t* samples =
+      reinterpret_cast<const int16_t*>(wav_reader.GetSamples());
+  size_t sample_count = wav_reader.GetSampleCount() / sizeof(int16_t);
+
+  for (int16_t num_of_subbands : subbands) {
+    for (int16_t channel_mode : channel_modes) {
+      std::vector<uint8_t> bitstreams[2];
+      for (bool use_simd : {false, true}) {
+        SBC_Encoder_UseSimd(use_simd);
+        SBC_ENC_PARAMS params{};
+        params.s16SamplingFreq = SBC_sf44100;
+        params.s16ChannelMode = channel_mode;
+        params.s16NumOfSubBands = num_of_subbands;
+        params.s16NumOfBlocks = 16;
+        params.s16AllocationMethod = SBC_LOUDNESS;
+        params.u16BitRate = 328;
+        SBC_Encoder_Init(&params);
+
+        size_t frame_samples = params.s16NumOfBlocks * num_of_subbands *
+                               params.s16NumOfChannels;
+        int16_t input[SBC_MAX_PCM_BUFFER_SIZE];
+        uint8_t output[512];
+        for (size_t offset = 0; offset + frame_samples <= sample_count;
+             offset += frame_samples) {
+          std::copy(samples + offset, samples + offset + frame_samples, input);
+          uint32_t length = SBC_Encode(&params, input, output);
+          bitstreams[use_simd].insert(bitstreams[use_simd].end(), output,
+                                      output + length);
+        }
+      }
+      ASSERT_FALSE(bitstreams[0].empty());
+      ASSERT_EQ(bitstreams[0], bitstreams[1])
+          << "subbands:" << num_of_subbands << " channel_mode:" << channel_mode;
+    }
+  }
+  SBC_Encoder_UseSimd(true);
+}
+
 }  // namespace testing
 }  // namespace bluetooth
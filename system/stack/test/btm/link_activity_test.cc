@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/acl/link_activity.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint64_t kStartUs = 1000000;
+constexpr uint64_t kPeriodUs = 100000;
+
+class LinkActivityTest : public ::testing::Test {
+ protected:
+  // Sends |count| bursts of 3 packets, |period_us| apart
+  void SendBursts(size_t count, uint64_t period_us) {
+    for (size_t i = 0; i < count; i++) {
+      now_us_ += period_us;
+      for (uint64_t j = 0; j < 3; j++) activity_.OnPacket(now_us_ + j * 1000);
+    }
+  }
+
+  LinkActivity activity_;
+  uint64_t now_us_ = kStartUs;
+};
+
+TEST_F(LinkActivityTest, no_traffic_is_not_regular) {
+  ASSERT_FALSE(activity_.IsRegular(now_us_));
+  ASSERT_EQ(activity_.ChooseSniffInterval(now_us_, 18, 800), 800);
+  ASSERT_EQ(activity_.ChooseSniffMaxLatency(now_us_, 800), 800);
+}
+
+TEST_F(LinkActivityTest, packets_are_grouped_into_bursts) {
+  SendBursts(8, kPeriodUs);
+  ASSERT_EQ(activity_.GetPacketCount(), 24u);
+  ASSERT_EQ(activity_.GetBurstCount(), 8u);
+  ASSERT_EQ(activity_.GetBurstPeriodUs(), kPeriodUs);
+}
+
+TEST_F(LinkActivityTest, periodic_bursts_are_predicted) {
+  SendBursts(8, kPeriodUs);
+  ASSERT_TRUE(activity_.IsRegular(now_us_));
+  ASSERT_EQ(activity_.GetNextBurstUs(), now_us_ + kPeriodUs);
+}
+
+TEST_F(LinkActivityTest, periodic_bursts_limit_sniff_parameters) {
+  SendBursts(8, kPeriodUs);
+  // A quarter and half of the period, in slots
+  ASSERT_EQ(activity_.ChooseSniffInterval(now_us_, 18, 800), 40);
+  ASSERT_EQ(activity_.ChooseSniffMaxLatency(now_us_, 800), 80);
+  // Within the limits of the profile
+  ASSERT_EQ(activity_.ChooseSniffInterval(now_us_, 50, 800), 50);
+  ASSERT_EQ(activity_.ChooseSniffInterval(now_us_, 18, 36), 36);
+  ASSERT_EQ(activity_.ChooseSniffMaxLatency(now_us_, 0), 0);
+}
+
+TEST_F(LinkActivityTest, irregular_bursts_are_not_predicted) {
+  for (size_t i = 0; i < 8; i++) {
+    SendBursts(1, kPeriodUs / 2);
+    SendBursts(1, kPeriodUs * 3);
+  }
+  ASSERT_FALSE(activity_.IsRegular(now_us_));
+  ASSERT_EQ(activity_.ChooseSniffInterval(now_us_, 18, 800), 800);
+}
+
+TEST_F(LinkActivityTest, missed_bursts_break_the_pattern) {
+  SendBursts(8, kPeriodUs);
+  ASSERT_TRUE(activity_.IsRegular(now_us_ + kPeriodUs));
+  ASSERT_FALSE(activity_.IsRegular(now_us_ + 2 * kPeriodUs));
+}
+
+}  // namespace
@@ -20,12 +20,17 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <map>
 #include <memory>
 
 #include "btif/include/core_callbacks.h"
 #include "btif/include/stack_manager.h"
 #include "stack/btm/btm_sco.h"
+#include "stack/btm/btm_sco_plc_dsp.h"
+#include "stack/include/hfp_lc3_decoder.h"
+#include "stack/include/hfp_lc3_encoder.h"
 #include "stack/include/hfp_msbc_decoder.h"
 #include "stack/include/hfp_msbc_encoder.h"
 #include "test/common/mock_functions.h"
@@ -72,6 +77,28 @@ struct CodecInterface : bluetooth::core::CodecInterface {
   }
 };
 
+struct Lc3CodecInterface : bluetooth::core::CodecInterface {
+  Lc3CodecInterface() : bluetooth::core::CodecInterface(){};
+
+  void initialize() override {
+    hfp_lc3_decoder_init();
+    hfp_lc3_encoder_init();
+  }
+
+  void cleanup() override {
+    hfp_lc3_decoder_cleanup();
+    hfp_lc3_encoder_cleanup();
+  }
+
+  uint32_t encodePacket(int16_t* input, uint8_t* output) {
+    return hfp_lc3_encode_frames(input, output);
+  }
+
+  bool decodePacket(const uint8_t* i_buf, int16_t* o_buf, size_t out_len) {
+    return hfp_lc3_decoder_decode_packet(i_buf, o_buf, out_len);
+  }
+};
+
 class ScoHciTest : public Test {
  public:
  protected:
@@ -83,6 +110,8 @@ class ScoHciTest : public Test {
 
     static auto codec = CodecInterface{};
     GetInterfaceToProfiles()->msbcCodec = &codec;
+    static auto lc3_codec = Lc3CodecInterface{};
+    GetInterfaceToProfiles()->lc3Codec = &lc3_codec;
   }
   void TearDown() override {}
 };
@@ -110,6 +139,18 @@ class ScoHciWbsWithInitCleanTest : public ScoHciTest {
   void TearDown() override { bluetooth::audio::sco::wbs::cleanup(); }
 };
 
+class ScoHciSwbTest : public ScoHciTest {};
+
+class ScoHciSwbWithInitCleanTest : public ScoHciTest {
+ public:
+ protected:
+  void SetUp() override {
+    ScoHciTest::SetUp();
+    bluetooth::audio::sco::swb::init(60);
+  }
+  void TearDown() override { bluetooth::audio::sco::swb::cleanup(); }
+};
+
 TEST_F(ScoHciTest, ScoOverHciOpenFail) {
   bluetooth::audio::sco::open();
   ASSERT_EQ(get_func_call_count("UIPC_Init"), 1);
@@ -430,4 +471,150 @@ TEST_F(ScoHciWbsWithInitCleanTest, WbsPlc) {
   }
 }
 
+TEST_F(ScoHciSwbTest, SwbInit) {
+  ASSERT_EQ(bluetooth::audio::sco::swb::init(60), size_t(60));
+  ASSERT_EQ(bluetooth::audio::sco::swb::init(72), size_t(72));
+  // Fallback to 60 if the packet size is not supported
+  ASSERT_EQ(bluetooth::audio::sco::swb::init(48), size_t(60));
+  bluetooth::audio::sco::swb::cleanup();
+}
+
+TEST_F(ScoHciSwbTest, SwbWithoutInit) {
+  uint8_t payload[60] = {0};
+  int16_t data[240] = {0};
+  const uint8_t* output = nullptr;
+  // Return 0 if buffer is uninitialized
+  ASSERT_EQ(bluetooth::audio::sco::swb::enqueue_packet(payload, sizeof(payload),
+                                                       false),
+            size_t(0));
+  ASSERT_EQ(bluetooth::audio::sco::swb::decode(&output), size_t(0));
+  ASSERT_EQ(bluetooth::audio::sco::swb::encode(data, sizeof(data)), size_t(0));
+  ASSERT_EQ(bluetooth::audio::sco::swb::dequeue_packet(&output), size_t(0));
+  ASSERT_EQ(output, nullptr);
+}
+
+TEST_F(ScoHciSwbWithInitCleanTest, SwbEncodeDequeuePackets) {
+  uint8_t h2_header_frames_count[] = {0x08, 0x38, 0xc8, 0xf8};
+  int16_t data[240] = {0};
+  const uint8_t* encoded = nullptr;
+
+  // Return 0 if data length is insufficient
+  ASSERT_EQ(bluetooth::audio::sco::swb::encode(data, sizeof(data) - 1),
+            size_t(0));
+  for (size_t i = 0; i < 5; i++) {
+    ASSERT_EQ(bluetooth::audio::sco::swb::encode(data, sizeof(data)),
+              size_t(BTM_LC3_CODE_SIZE));
+    ASSERT_EQ(bluetooth::audio::sco::swb::dequeue_packet(&encoded), size_t(60));
+    ASSERT_NE(encoded, nullptr);
+    ASSERT_EQ(encoded[0], 0x01);
+    ASSERT_EQ(encoded[1], h2_header_frames_count[i % 4]);
+  }
+}
+
+TEST_F(ScoHciSwbWithInitCleanTest, SwbPlc) {
+  int16_t data[240];
+  const uint8_t* encoded = nullptr;
+  const uint8_t* decoded = nullptr;
+  uint8_t invalid_pkt[60] = {0};
+  size_t lost_pkt_idx = 7;
+
+  for (size_t i = 0, sample_idx = 0; i < 10; i++) {
+    // Input data is a 1000Hz sine wave at 32kHz
+    for (size_t j = 0; j < 240; j++, sample_idx++)
+      data[j] = 1000 * sin(2 * M_PI * sample_idx / 32);
+    ASSERT_EQ(bluetooth::audio::sco::swb::encode(data, sizeof(data)),
+              sizeof(data));
+    ASSERT_EQ(bluetooth::audio::sco::swb::dequeue_packet(&encoded), size_t(60));
+    ASSERT_NE(encoded, nullptr);
+
+    // Substitute to invalid packet to simulate packet loss.
+    ASSERT_EQ(bluetooth::audio::sco::swb::enqueue_packet(
+                  i != lost_pkt_idx ? encoded : invalid_pkt, 60, false),
+              size_t(60));
+    ASSERT_EQ(bluetooth::audio::sco::swb::decode(&decoded),
+              size_t(BTM_LC3_CODE_SIZE));
+    ASSERT_NE(decoded, nullptr);
+  }
+
+  int num_decoded_frames;
+  double packet_loss_ratio;
+  ASSERT_EQ(bluetooth::audio::sco::swb::fill_plc_stats(&num_decoded_frames,
+                                                       &packet_loss_ratio),
+            true);
+  ASSERT_EQ(num_decoded_frames, 10);
+  ASSERT_EQ(packet_loss_ratio, (double)1 / 10);
+}
+
+// The pattern matching as first written, correlating in floats one lag after
+// the other
+int reference_pattern_match(const int16_t* hist) {
+  int best = 0;
+  float max_cn = FLT_MIN;
+  const int16_t* x = &hist[BTM_PLC_HL - BTM_PLC_TL];
+  for (int i = 0; i < BTM_PLC_WL; i++) {
+    const int16_t* y = &hist[i];
+    float sum = 0, x2 = 0, y2 = 0;
+    for (int j = 0; j < BTM_PLC_TL; j++) {
+      sum += ((float)x[j]) * y[j];
+      x2 += ((float)x[j]) * x[j];
+      y2 += ((float)y[j]) * y[j];
+    }
+    float cn = sum / sqrtf(x2 * y2);
+    if (cn > max_cn) {
+      best = i;
+      max_cn = cn;
+    }
+  }
+  return best;
+}
+
+double correlation(const int16_t* hist, int lag) {
+  const int16_t* x = &hist[BTM_PLC_HL - BTM_PLC_TL];
+  const int16_t* y = &hist[lag];
+  double sum = 0, x2 = 0, y2 = 0;
+  for (int j = 0; j < BTM_PLC_TL; j++) {
+    sum += (double)x[j] * y[j];
+    x2 += (double)x[j] * x[j];
+    y2 += (double)y[j] * y[j];
+  }
+  return sum / sqrt(x2 * y2);
+}
+
+TEST_F(ScoHciWbsTest, WbsPlcPatternMatch) {
+  int16_t hist[BTM_PLC_HL];
+  // Voiced speech like signals of different pitches and amplitudes, with noise
+  for (int pitch : {40, 57, 91, 123}) {
+    for (float amplitude : {300.0f, 8000.0f, 40000.0f}) {
+      srand(pitch);
+      for (int i = 0; i < BTM_PLC_HL; i++) {
+        float sample = amplitude * (sinf(2 * M_PI * i / pitch) +
+                                    0.5f * sinf(6 * M_PI * i / pitch)) +
+                       (rand() % 200 - 100);
+        hist[i] = std::min(std::max(sample, (float)INT16_MIN),
+                           (float)INT16_MAX);
+      }
+      // Periods of the signal correlate alike, a rounding error may pick
+      // another one
+      int lag = bluetooth::audio::sco::wbs::plc_pattern_match(hist);
+      ASSERT_NEAR(correlation(hist, lag),
+                  correlation(hist, reference_pattern_match(hist)), 1e-4)
+          << "pitch " << pitch << " amplitude " << amplitude;
+    }
+  }
+}
+
+TEST_F(ScoHciWbsTest, WbsPlcScaleSaturates) {
+  int16_t input[BTM_MSBC_FS];
+  int16_t output[BTM_MSBC_FS];
+  for (int i = 0; i < BTM_MSBC_FS; i++) input[i] = (i - BTM_MSBC_FS / 2) * 500;
+  bluetooth::audio::sco::wbs::plc_scale(output, 1.2f, input, BTM_MSBC_FS);
+  for (int i = 0; i < BTM_MSBC_FS; i++) {
+    ASSERT_EQ(output[i], (int16_t)std::min(std::max(1.2f * input[i],
+                                                    (float)INT16_MIN),
+                                           (float)INT16_MAX));
+  }
+  ASSERT_EQ(output[0], INT16_MIN);
+  ASSERT_EQ(output[BTM_MSBC_FS - 1], INT16_MAX);
+}
+
 }  // namespace
@@ -19,6 +19,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -31,6 +32,7 @@
 #include "internal_include/stack_config.h"
 #include "osi/include/allocator.h"
 #include "osi/include/osi.h"
+#include "stack/btm/btm_ble_int.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/btm/btm_sco.h"
@@ -218,6 +220,23 @@ TEST(ScoTest, make_sco_packet) {
   osi_free(p);
 }
 
+TEST(ScoTest, frame_sco_packet_in_place) {
+  uint16_t handle = 0x1ab;
+  BT_HDR* p = btm_sco_alloc_packet();
+  uint8_t* data = btm_sco_packet_data(p);
+  ASSERT_EQ(data, p->data + BTM_SCO_HCI_HEADER_LEN);
+  memset(data, 0x5a, BTM_SCO_DATA_SIZE_MAX);
+  btm_sco_frame_packet(p, handle, 60);
+  ASSERT_EQ(p->event, BT_EVT_TO_LM_HCI_SCO);
+  ASSERT_EQ(p->offset, 0);
+  ASSERT_EQ(p->len, BTM_SCO_HCI_HEADER_LEN + 60);
+  ASSERT_EQ(p->data[0], 0xab);
+  ASSERT_EQ(p->data[1], 0x01);
+  ASSERT_EQ(p->data[2], 60);
+  ASSERT_EQ(p->data[3], 0x5a);
+  osi_free(p);
+}
+
 TEST(BtmTest, BTM_EIR_MAX_SERVICES) { ASSERT_EQ(46, BTM_EIR_MAX_SERVICES); }
 
 }  // namespace
@@ -397,6 +416,40 @@ TEST_F(StackBtmWithInitFreeTest, btm_sec_allocate_dev_rec__all) {
   // Further, the memory for each record is reused when necessary.
 }
 
+TEST_F(StackBtmWithInitFreeTest, btm_ble_resolve_random_addr) {
+  // BT Spec 5.0 | Vol 3, Part H D.7
+  Octet16 irk{0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05,
+              0x34, 0x10, 0x10, 0xa6, 0x0a, 0x39, 0x7d, 0x9b};
+  std::reverse(irk.begin(), irk.end());
+  const RawAddress rpa({0x70, 0x81, 0x94, 0x0d, 0xfb, 0xaa});
+  const Octet16 other_irk{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                          0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+
+  tBTM_SEC_DEV_REC* other_record = btm_sec_allocate_dev_rec();
+  other_record->device_type |= BT_DEVICE_TYPE_BLE;
+  other_record->ble.key_type |= BTM_LE_KEY_PID;
+  other_record->ble.keys.irk = other_irk;
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+
+  // Adding an IRK invalidates the previous resolutions
+  tBTM_SEC_DEV_REC* device_record = btm_sec_allocate_dev_rec();
+  device_record->device_type |= BT_DEVICE_TYPE_BLE;
+  device_record->ble.key_type |= BTM_LE_KEY_PID;
+  device_record->ble.keys.irk = irk;
+  ASSERT_EQ(device_record, btm_ble_resolve_random_addr(rpa));
+  ASSERT_EQ(device_record, btm_ble_resolve_random_addr(rpa));
+
+  // So does changing one
+  device_record->ble.keys.irk = other_irk;
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+  device_record->ble.keys.irk = irk;
+  ASSERT_EQ(device_record, btm_ble_resolve_random_addr(rpa));
+
+  // Records without an IRK are not candidates
+  device_record->ble.key_type &= ~BTM_LE_KEY_PID;
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+}
+
 TEST_F(StackBtmTest, btm_oob_data_text) {
   std::vector<std::pair<tBTM_OOB_DATA, std::string>> datas = {
       std::make_pair(BTM_OOB_NONE, "BTM_OOB_NONE"),
@@ -455,3 +508,35 @@ TEST_F(StackBtmWithInitFreeTest, wipe_secrets_and_remove) {
 
   wipe_secrets_and_remove(device_record);
 }
+
+TEST_F(StackBtmWithInitFreeTest, btm_find_dev__lookup_hints) {
+  const RawAddress bd_addr({0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6});
+  const RawAddress other_bd_addr({0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6});
+  const uint16_t handle = 0x0042;
+
+  tBTM_SEC_DEV_REC* other_record = btm_sec_allocate_dev_rec();
+  other_record->bd_addr = other_bd_addr;
+  tBTM_SEC_DEV_REC* device_record = btm_sec_allocate_dev_rec();
+  device_record->bd_addr = bd_addr;
+  device_record->hci_handle = handle;
+
+  ASSERT_EQ(device_record, btm_find_dev(bd_addr));
+  ASSERT_EQ(device_record, btm_find_dev_by_handle(handle));
+  // Twice, from the hints
+  ASSERT_EQ(device_record, btm_find_dev(bd_addr));
+  ASSERT_EQ(device_record, btm_find_dev_by_handle(handle));
+
+  // Stale hints are not used
+  device_record->hci_handle = HCI_INVALID_HANDLE;
+  other_record->hci_handle = handle;
+  ASSERT_EQ(other_record, btm_find_dev_by_handle(handle));
+  device_record->bd_addr = RawAddress::kEmpty;
+  ASSERT_EQ(nullptr, btm_find_dev(bd_addr));
+  other_record->bd_addr = bd_addr;
+  ASSERT_EQ(other_record, btm_find_dev(bd_addr));
+
+  // Nor the ones of removed records
+  wipe_secrets_and_remove(other_record);
+  ASSERT_EQ(nullptr, btm_find_dev(bd_addr));
+  ASSERT_EQ(nullptr, btm_find_dev_by_handle(handle));
+}
@@ -17,9 +17,14 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
 
 #include "btm_iso_api.h"
 #include "hci/include/hci_layer.h"
+#include "main/shim/acl_api.h"
 #include "main/shim/shim.h"
 #include "mock_controller.h"
 #include "mock_hcic_layer.h"
@@ -47,6 +52,12 @@ bool bluetooth::shim::is_gd_shim_enabled() { return false; }
 bool IsIsoActive = false;
 
 tBTM_SEC_DEV_REC* btm_find_dev_by_handle(uint16_t handle) { return nullptr; }
+
+std::map<uint16_t, uint16_t> acl_credit_reservations;
+void bluetooth::shim::ACL_SetLeTxCreditReservation(uint16_t hci_handle,
+                                                   uint16_t credits) {
+  acl_credit_reservations[hci_handle] = credits;
+}
 void BTM_LogHistory(const std::string& tag, const RawAddress& bd_addr,
                     const std::string& msg, const std::string& extra) {}
 
@@ -70,7 +81,12 @@ static void SetMockBteInterface(MockBteInterface* interface) {
 
 void bte_main_hci_send(BT_HDR* p_msg, uint16_t event) {
   bte::bte_interface->HciSend(p_msg, event);
-  osi_free(p_msg);
+  /* Same as the HCI layer once the packet is transmitted */
+  if (p_msg->layer_specific & BT_ISO_HDR_FROM_SDU_POOL) {
+    bluetooth::hci::IsoManager::GetInstance()->ReleaseIsoSdu(p_msg);
+  } else {
+    osi_free(p_msg);
+  }
 }
 
 namespace {
@@ -1231,6 +1247,35 @@ TEST_F(IsoManagerTest, DisconnectCisValid) {
   }
 }
 
+TEST_F(IsoManagerTest, EstablishedCisReservesAclCredits) {
+  const uint16_t acl_handle = 1;
+  acl_credit_reservations.clear();
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+  EXPECT_CALL(*cig_callbacks_, OnCisEvent).Times(AnyNumber());
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, acl_handle});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+  ASSERT_EQ(acl_credit_reservations.size(), 1u);
+  uint16_t reserved_credits = acl_credit_reservations[acl_handle];
+  ASSERT_GT(reserved_credits, 0);
+
+  // The reservation is kept until the last CIS of the ACL link is gone
+  uint8_t disconnect_reason = 0x16;
+  auto& conn_handles = volatile_test_cig_create_cmpl_evt_.conn_handles;
+  for (auto it = conn_handles.begin(); it != std::prev(conn_handles.end());
+       it++) {
+    IsoManager::GetInstance()->DisconnectCis(*it, disconnect_reason);
+    ASSERT_EQ(acl_credit_reservations[acl_handle], reserved_credits);
+  }
+  IsoManager::GetInstance()->DisconnectCis(conn_handles.back(),
+                                           disconnect_reason);
+  ASSERT_EQ(acl_credit_reservations[acl_handle], 0);
+}
+
 // Check if we properly ignore not ISO related disconnect events
 TEST_F(IsoManagerDeathTest, DisconnectCisInvalidResponse) {
   IsoManager::GetInstance()->CreateCig(
@@ -1904,6 +1949,108 @@ TEST_F(IsoManagerTest, SendIsoDataCigValid) {
   }
 }
 
+TEST_F(IsoManagerTest, SendIsoDataReusesPooledBuffers) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  std::vector<BT_HDR*> packets;
+  EXPECT_CALL(bte_interface_, HciSend)
+      .Times(2)
+      .WillRepeatedly([&packets](BT_HDR* p_msg, uint16_t event) {
+        ASSERT_TRUE(p_msg->layer_specific & BT_ISO_HDR_FROM_SDU_POOL);
+        packets.push_back(p_msg);
+      });
+
+  std::vector<uint8_t> data_vec(108, 0);
+  IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                         data_vec.size());
+  IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                         data_vec.size());
+
+  // The buffer released after the first SDU carried the second one
+  ASSERT_EQ(packets.size(), 2u);
+  ASSERT_EQ(packets[0], packets[1]);
+}
+
+TEST_F(IsoManagerTest, SendIsoDataTracksClockDrift) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  std::vector<base::OnceCallback<void(uint8_t*, uint16_t)>> tx_sync_cbs;
+  EXPECT_CALL(hcic_interface_, ReadIsoTxSync(handle, _))
+      .Times(2)
+      .WillRepeatedly(
+          [&tx_sync_cbs](uint16_t iso_handle,
+                         base::OnceCallback<void(uint8_t*, uint16_t)> cb) {
+            tx_sync_cbs.push_back(std::move(cb));
+          });
+  EXPECT_CALL(bte_interface_, HciSend).Times(AnyNumber());
+
+  std::vector<uint8_t> data_vec(108, 0);
+  uint8_t mock_rsp[5];
+  // HCI_LE_Read_ISO_TX_Sync is sent every 500 SDUs
+  for (size_t i = 0; i < 1000; i++) {
+    IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                           data_vec.size());
+
+    // Give the credit back right away
+    uint8_t* p = mock_rsp;
+    UINT8_TO_STREAM(p, 1);
+    UINT16_TO_STREAM(p, handle);
+    UINT16_TO_STREAM(p, 1);
+    IsoManager::GetInstance()->HandleNumComplDataPkts(mock_rsp,
+                                                      sizeof(mock_rsp));
+  }
+  ASSERT_EQ(tx_sync_cbs.size(), 2u);
+
+  // The controller clock runs 100 ppm faster over 1000 SDU intervals
+  const uint32_t sdu_itv = kDefaultCigParams.sdu_itv_mtos;
+  const uint32_t tx_ts[] = {1000, 1000 + 1000 * sdu_itv + sdu_itv / 10};
+  const uint16_t seq_nb[] = {10, 1010};
+  for (int i = 0; i < 2; i++) {
+    std::vector<uint8_t> rsp(12, 0);
+    uint8_t* p = rsp.data();
+    UINT8_TO_STREAM(p, HCI_SUCCESS);
+    UINT16_TO_STREAM(p, handle);
+    UINT16_TO_STREAM(p, seq_nb[i]);
+    UINT32_TO_STREAM(p, tx_ts[i]);
+    std::move(tx_sync_cbs[i]).Run(rsp.data(), rsp.size());
+  }
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  IsoManager::GetInstance()->Dump(fds[1]);
+  close(fds[1]);
+  std::string dump;
+  char buf[1024];
+  for (ssize_t n; (n = read(fds[0], buf, sizeof(buf))) > 0;) {
+    dump.append(buf, n);
+  }
+  close(fds[0]);
+
+  ASSERT_NE(dump.find("Clock drift (ppm): 100 "), std::string::npos);
+}
+
 TEST_F(IsoManagerTest, SendIsoDataBigValid) {
   IsoManager::GetInstance()->CreateBig(volatile_test_big_params_evt_.big_id,
                                        kDefaultBigParams);
@@ -19,3 +19,4 @@
 #include "common/message_loop_thread.h"
 
 bluetooth::common::MessageLoopThread* get_main_thread() { return nullptr; }
+bool is_on_main_thread() { return true; }
@@ -96,6 +96,18 @@ EattChannel* EattExtension::GetChannelAvailableForClientRequest(
   return pimpl_->GetChannelAvailableForClientRequest(bd_addr);
 }
 
+EattChannel* EattExtension::GetChannelAvailableForLongClientRequest(
+    const RawAddress& bd_addr) {
+  return pimpl_->GetChannelAvailableForLongClientRequest(bd_addr);
+}
+
+EattChannel* EattExtension::GetChannelAvailableForNotification(
+    const RawAddress& bd_addr, uint16_t last_cid, uint16_t* queued) {
+  return pimpl_->GetChannelAvailableForNotification(bd_addr, last_cid, queued);
+}
+
+void EattExtension::Dump(int fd) { pimpl_->Dump(fd); }
+
 /* Start stop GATT indication timer per CID */
 void EattExtension::StartIndicationConfirmationTimer(const RawAddress& bd_addr,
                                                      uint16_t cid) {
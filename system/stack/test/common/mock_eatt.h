@@ -56,6 +56,12 @@ class MockEattExtension : public EattExtension {
               (const RawAddress& bd_addr));
   MOCK_METHOD((EattChannel*), GetChannelAvailableForClientRequest,
               (const RawAddress& bd_addr));
+  MOCK_METHOD((EattChannel*), GetChannelAvailableForLongClientRequest,
+              (const RawAddress& bd_addr));
+  MOCK_METHOD((EattChannel*), GetChannelAvailableForNotification,
+              (const RawAddress& bd_addr, uint16_t last_cid,
+               uint16_t* queued));
+  MOCK_METHOD((void), Dump, (int fd));
   MOCK_METHOD((void), StartIndicationConfirmationTimer,
               (const RawAddress& bd_addr, uint16_t cid));
   MOCK_METHOD((void), StopIndicationConfirmationTimer,
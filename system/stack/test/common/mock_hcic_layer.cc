@@ -78,6 +78,11 @@ void btsnd_hcic_read_iso_link_quality(
   hcic_interface->ReadIsoLinkQuality(iso_handle, std::move(cb));
 }
 
+void btsnd_hcic_read_iso_tx_sync(
+    uint16_t iso_handle, base::OnceCallback<void(uint8_t*, uint16_t)> cb) {
+  hcic_interface->ReadIsoTxSync(iso_handle, std::move(cb));
+}
+
 void btsnd_hcic_create_big(uint8_t big_handle, uint8_t adv_handle,
                            uint8_t num_bis, uint32_t sdu_itv,
                            uint16_t max_sdu_size, uint16_t transport_latency,
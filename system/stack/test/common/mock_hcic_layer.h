@@ -56,6 +56,9 @@ class HcicInterface {
   virtual void ReadIsoLinkQuality(
       uint16_t iso_handle, base::OnceCallback<void(uint8_t*, uint16_t)> cb) = 0;
 
+  virtual void ReadIsoTxSync(
+      uint16_t iso_handle, base::OnceCallback<void(uint8_t*, uint16_t)> cb) = 0;
+
   // iso_manager::big_create_params is a workaround for the 10 params function
   // limitation that gmock sets
   virtual void CreateBig(
@@ -105,6 +108,11 @@ class MockHcicInterface : public HcicInterface {
                base::OnceCallback<void(uint8_t*, uint16_t)> cb),
               (override));
 
+  MOCK_METHOD((void), ReadIsoTxSync,
+              (uint16_t iso_handle,
+               base::OnceCallback<void(uint8_t*, uint16_t)> cb),
+              (override));
+
   MOCK_METHOD(
       (void), CreateBig,
       (uint8_t big_handle,
@@ -104,3 +104,7 @@ uint16_t L2CA_LeCreditDefault() { return l2cap_interface->LeCreditDefault(); }
 uint16_t L2CA_LeCreditThreshold() {
   return l2cap_interface->LeCreditThreshold();
 }
+
+uint16_t L2CA_FlushChannel(uint16_t lcid, uint16_t num_to_flush) {
+  return l2cap_interface->FlushChannel(lcid, num_to_flush);
+}
@@ -53,6 +53,7 @@ class L2capInterface {
                                 tL2CAP_LE_CFG_INFO* peer_cfg) = 0;
   virtual uint16_t LeCreditDefault() = 0;
   virtual uint16_t LeCreditThreshold() = 0;
+  virtual uint16_t FlushChannel(uint16_t lcid, uint16_t num_to_flush) = 0;
   virtual ~L2capInterface() = default;
 };
 
@@ -88,6 +89,7 @@ class MockL2capInterface : public L2capInterface {
                bool(const RawAddress& p_bd_addr, std::vector<uint16_t> &lcids, tL2CAP_LE_CFG_INFO* peer_cfg));
   MOCK_METHOD(uint16_t, LeCreditDefault, ());
   MOCK_METHOD(uint16_t, LeCreditThreshold, ());
+  MOCK_METHOD(uint16_t, FlushChannel, (uint16_t lcid, uint16_t num_to_flush));
 };
 
 /**
@@ -23,6 +23,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <random>
 #include <vector>
 
 #include "stack/crypto_toolbox/aes.h"
@@ -319,6 +321,29 @@ TEST(CryptoToolboxTest, bt_spec_example_d_7_test) {
   EXPECT_EQ(result[2], expected_ah[2]);
 }
 
+// Same as bt_spec_example_d_7_test, with the key schedule expanded once
+TEST(CryptoToolboxTest, aes_128_with_expanded_key_test) {
+  Octet16 IRK{0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05,
+              0x34, 0x10, 0x10, 0xa6, 0x0a, 0x39, 0x7d, 0x9b};
+  Octet16 prand{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x81, 0x94};
+  Octet16 expected_aes_128{0x15, 0x9d, 0x5f, 0xb7, 0x2e, 0xbe, 0x23, 0x11,
+                           0xa4, 0x8c, 0x1b, 0xdc, 0xc4, 0x0d, 0xfb, 0xaa};
+
+  std::reverse(std::begin(IRK), std::end(IRK));
+  std::reverse(std::begin(prand), std::end(prand));
+  std::reverse(std::begin(expected_aes_128), std::end(expected_aes_128));
+
+  Aes128 cipher(IRK);
+  EXPECT_EQ(expected_aes_128, cipher.Encrypt(prand.data(), 3));
+  // The expanded key is not changed by encrypting
+  EXPECT_EQ(expected_aes_128, cipher.Encrypt(prand.data(), 3));
+  EXPECT_EQ(aes_128(IRK, prand), cipher.Encrypt(prand));
+
+  Aes128 moved_cipher(std::move(cipher));
+  EXPECT_EQ(expected_aes_128, moved_cipher.Encrypt(prand.data(), 3));
+}
+
 // BT Spec 5.0 | Vol 3, Part H D.8
 TEST(CryptoToolboxTest, bt_spec_example_d_8_test) {
   Octet16 Key{0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05,
@@ -399,4 +424,38 @@ TEST(CryptoToolboxTest, bt_spec_example_d_12_test) {
   EXPECT_EQ(expected_ltk, ltk);
 }
 
+// The AES instructions of the CPU, when it has them, and the table based code
+// use the same key schedule and give the same results
+TEST(CryptoToolboxTest, aes_hw_matches_table_based_aes_test) {
+  bool hw_enabled = aes_hw_is_enabled();
+  std::mt19937 random(0);
+  uint8_t key[32], message[16];
+
+  for (int i = 0; i < 100; i++) {
+    std::generate(std::begin(key), std::end(key), random);
+    std::generate(std::begin(message), std::end(message), random);
+
+    for (uint8_t key_length : {16, 32}) {
+      aes_context hw_ctx, table_ctx;
+      uint8_t hw_output[16], table_output[16], decrypted[16];
+
+      aes_hw_set_enabled(true);
+      aes_set_key(key, key_length, &hw_ctx);
+      aes_encrypt(message, hw_output, &hw_ctx);
+      aes_hw_set_enabled(false);
+      aes_set_key(key, key_length, &table_ctx);
+      aes_encrypt(message, table_output, &table_ctx);
+
+      ASSERT_EQ(hw_ctx.rnd, table_ctx.rnd);
+      EXPECT_EQ(0, memcmp(hw_ctx.ksch, table_ctx.ksch,
+                          (hw_ctx.rnd + 1) * N_BLOCK));
+      EXPECT_EQ(0, memcmp(hw_output, table_output, sizeof(hw_output)));
+      aes_decrypt(hw_output, decrypted, &hw_ctx);
+      EXPECT_EQ(0, memcmp(message, decrypted, sizeof(message)));
+    }
+  }
+
+  aes_hw_set_enabled(hw_enabled);
+}
+
 }  // namespace crypto_toolbox
@@ -418,6 +418,106 @@ TEST_F(EattTest, ConnectSucceedMultipleChannels) {
   DisconnectEattDevice(connected_cids_);
 }
 
+TEST_F(EattTest, NotificationChannelLeastQueued) {
+  ConnectDeviceEattSupported(3);
+
+  /* Buffers queued in L2CAP on the channels 61, 62 and 63 */
+  EXPECT_CALL(l2cap_interface_, FlushChannel(_, L2CAP_FLUSH_CHANS_GET))
+      .WillRepeatedly([](uint16_t cid, uint16_t num_to_flush) -> uint16_t {
+        return cid == 61 ? 4 : cid == 62 ? 1 : 2;
+      });
+
+  uint16_t queued = 0;
+  EattChannel* channel = eatt_instance_->GetChannelAvailableForNotification(
+      test_address, 0, &queued);
+  ASSERT_TRUE(channel != nullptr);
+  ASSERT_EQ(channel->cid_, 62);
+  ASSERT_EQ(queued, 1);
+
+  /* The channel of the previous notification is kept while it is queued */
+  channel = eatt_instance_->GetChannelAvailableForNotification(test_address,
+                                                               61, &queued);
+  ASSERT_TRUE(channel != nullptr);
+  ASSERT_EQ(channel->cid_, 61);
+  ASSERT_EQ(queued, 4);
+
+  DisconnectEattDevice(connected_cids_);
+}
+
+TEST_F(EattTest, LongClientRequestChannelLargestMtu) {
+  ConnectDeviceEattSupported(3);
+
+  eatt_instance_->FindEattChannelByCid(test_address, 62)->tx_mtu_ = 200;
+  eatt_instance_->FindEattChannelByCid(test_address, 62)->rx_mtu_ = 200;
+  eatt_instance_->FindEattChannelByCid(test_address, 63)->tx_mtu_ = 300;
+  eatt_instance_->FindEattChannelByCid(test_address, 63)->rx_mtu_ = 100;
+
+  EattChannel* channel =
+      eatt_instance_->GetChannelAvailableForLongClientRequest(test_address);
+  ASSERT_TRUE(channel != nullptr);
+  ASSERT_EQ(channel->cid_, 62);
+
+  /* The channels with an outstanding request are not available */
+  channel->cl_cmd_q_.emplace_back();
+  channel =
+      eatt_instance_->GetChannelAvailableForLongClientRequest(test_address);
+  ASSERT_TRUE(channel != nullptr);
+  ASSERT_EQ(channel->cid_, 63);
+
+  eatt_instance_->FindEattChannelByCid(test_address, 62)->cl_cmd_q_.clear();
+  DisconnectEattDevice(connected_cids_);
+}
+
+TEST_F(EattTest, ChannelAddedWhenAllChannelsBusy) {
+  ConnectDeviceEattSupported(5);
+
+  /* The peer closes two of the channels, the three others are busy */
+  l2cap_app_info_.pL2CA_DisconnectInd_Cb(64, false);
+  l2cap_app_info_.pL2CA_DisconnectInd_Cb(65, false);
+  for (uint16_t cid : {61, 62, 63}) {
+    eatt_instance_->FindEattChannelByCid(test_address, cid)
+        ->cl_cmd_q_.emplace_back();
+  }
+
+  tL2CAP_LE_CFG_INFO cfg;
+  EXPECT_CALL(l2cap_interface_,
+              ConnectCreditBasedReq(BT_PSM_EATT, test_address, _))
+      .WillOnce(DoAll(SaveArgPointee<2>(&cfg),
+                      Return(std::vector<uint16_t>{66})));
+  ASSERT_EQ(nullptr,
+            eatt_instance_->GetChannelAvailableForClientRequest(test_address));
+  ASSERT_EQ(cfg.number_of_channels, 1);
+
+  /* No more channels until the new one is connected */
+  ASSERT_EQ(nullptr,
+            eatt_instance_->GetChannelAvailableForClientRequest(test_address));
+
+  for (uint16_t cid : {61, 62, 63}) {
+    eatt_instance_->FindEattChannelByCid(test_address, cid)->cl_cmd_q_.clear();
+  }
+  DisconnectEattDevice({61, 62, 63, 66});
+}
+
+TEST_F(EattTest, NoChannelAddedOverPeerLimit) {
+  /* The peer accepted only two of the channels */
+  ConnectDeviceEattSupported(2);
+  for (uint16_t cid : connected_cids_) {
+    eatt_instance_->FindEattChannelByCid(test_address, cid)
+        ->cl_cmd_q_.emplace_back();
+  }
+
+  EXPECT_CALL(l2cap_interface_,
+              ConnectCreditBasedReq(BT_PSM_EATT, test_address, _))
+      .Times(0);
+  ASSERT_EQ(nullptr,
+            eatt_instance_->GetChannelAvailableForClientRequest(test_address));
+
+  for (uint16_t cid : connected_cids_) {
+    eatt_instance_->FindEattChannelByCid(test_address, cid)->cl_cmd_q_.clear();
+  }
+  DisconnectEattDevice(connected_cids_);
+}
+
 TEST_F(EattTest, ConnectFailedEattNotSupported) {
   ON_CALL(gatt_interface_, ClientReadSupportedFeatures)
       .WillByDefault(
@@ -24,7 +24,9 @@
 
 #include "common/message_loop_thread.h"
 #include "common/strings.h"
+#include "osi/include/allocator.h"
 #include "stack/gatt/gatt_int.h"
+#include "stack/include/bt_hdr.h"
 #include "stack/include/gatt_api.h"
 #include "test/common/mock_functions.h"
 #include "types/bluetooth/uuid.h"
@@ -191,3 +193,36 @@ TEST_F(StackGattTest, gatt_status_text) {
   ASSERT_STREQ(unknown.c_str(),
                gatt_status_text(static_cast<tGATT_STATUS>(0xfc)).c_str());
 }
+
+TEST_F(StackGattTest, attp_build_multi_value_notif) {
+  std::vector<tGATT_VALUE> notifs(3);
+  for (size_t i = 0; i < notifs.size(); i++) {
+    notifs[i].handle = 0x0010 + i;
+    notifs[i].len = 4;
+    memset(notifs[i].value, 0xa0 + i, notifs[i].len);
+  }
+
+  /* Opcode and two handle, length and value tuples */
+  size_t next = 0;
+  BT_HDR* p_buf = attp_build_multi_value_notif(1 + 2 * 8, notifs, 0, &next);
+  ASSERT_EQ(2u, next);
+  ASSERT_EQ(17, p_buf->len);
+  const uint8_t expected[] = {GATT_HANDLE_MULTI_VALUE_NOTIF,
+                              0x10, 0x00, 0x04, 0x00, 0xa0, 0xa0, 0xa0, 0xa0,
+                              0x11, 0x00, 0x04, 0x00, 0xa1, 0xa1, 0xa1, 0xa1};
+  ASSERT_EQ(0, memcmp(expected, (uint8_t*)(p_buf + 1) + p_buf->offset,
+                      sizeof(expected)));
+  osi_free(p_buf);
+
+  /* From the first notification left out */
+  p_buf = attp_build_multi_value_notif(1 + 8 + 7, notifs, 2, &next);
+  ASSERT_EQ(3u, next);
+  ASSERT_EQ(9, p_buf->len);
+  osi_free(p_buf);
+
+  /* A value is never truncated */
+  p_buf = attp_build_multi_value_notif(1 + 7, notifs, 0, &next);
+  ASSERT_EQ(0u, next);
+  ASSERT_EQ(1, p_buf->len);
+  osi_free(p_buf);
+}
@@ -354,4 +354,58 @@ TEST_F(BleConnectionManager, test_re_add_background_connect_to_allow_list) {
   EXPECT_TRUE(background_connect_remove(CLIENT1, address1));
   Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
 }
+
+/** Verify that a direct connection waits for room when the accept list is
+ * full, and gets in once another direct connection is over */
+TEST_F(BleConnectionManager, test_direct_connect_waits_for_full_accept_list) {
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address1, true))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(direct_connect_add(CLIENT1, address1));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+
+  // Accept list is full
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address2, true))
+      .WillOnce(Return(false));
+  EXPECT_TRUE(direct_connect_add(CLIENT2, address2, CONN_PRIORITY_HIGH,
+                                 10 * 1000));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+
+  // The waiting device takes the room left by the first one
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address1)).Times(1);
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address2, true))
+      .WillOnce(Return(true));
+  on_connection_complete(address1);
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address2)).Times(1);
+  EXPECT_TRUE(direct_connect_remove(CLIENT2, address2));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+}
+
+/** Verify that a direct connection takes the room of a background connection
+ * in the full accept list, and that the background connection gets back in
+ * once the direct connection is over */
+TEST_F(BleConnectionManager, test_direct_connect_suspends_background_connect) {
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address1))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(background_connect_add(CLIENT1, address1));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address2, true))
+      .WillOnce(Return(false))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address1)).Times(1);
+  EXPECT_TRUE(direct_connect_add(CLIENT2, address2));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address2)).Times(1);
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address1))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(direct_connect_remove(CLIENT2, address2));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address1)).Times(1);
+  EXPECT_TRUE(background_connect_remove(CLIENT1, address1));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+}
 }  // namespace connection_manager
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 
 #include <cstddef>
+#include <cstring>
 
 #include "stack/include/sdp_api.h"
 #include "stack/sdp/sdpint.h"
@@ -173,6 +174,49 @@ TEST_F(StackSdpMainTest, sdp_service_search_request_queuing_race_condition) {
   sdp_disconnect(p_ccb2, SDP_SUCCESS);
 }
 
+static tSDP_UUID_SEQ make_uuid_seq(uint16_t uuid16) {
+  tSDP_UUID_SEQ seq = {};
+  seq.num_uids = 1;
+  seq.uuid_entry[0].len = 2;
+  seq.uuid_entry[0].value[0] = uuid16 >> 8;
+  seq.uuid_entry[0].value[1] = uuid16 & 0xff;
+  return seq;
+}
+
+TEST_F(StackSdpMainTest, sdp_db_service_search) {
+  uint16_t a2dp_source = UUID_SERVCLASS_AUDIO_SOURCE;
+  uint16_t hfp_ag = UUID_SERVCLASS_AG_HANDSFREE;
+  uint32_t a2dp_handle = SDP_CreateRecord();
+  ASSERT_TRUE(SDP_AddServiceClassIdList(a2dp_handle, 1, &a2dp_source));
+  uint32_t hfp_handle = SDP_CreateRecord();
+  ASSERT_TRUE(SDP_AddServiceClassIdList(hfp_handle, 1, &hfp_ag));
+
+  tSDP_UUID_SEQ seq = make_uuid_seq(UUID_SERVCLASS_AG_HANDSFREE);
+  const tSDP_RECORD* p_rec = sdp_db_service_search(nullptr, &seq);
+  ASSERT_NE(nullptr, p_rec);
+  ASSERT_EQ(hfp_handle, p_rec->record_handle);
+  ASSERT_EQ(nullptr, sdp_db_service_search(p_rec, &seq));
+
+  // The 128 bit form of a UUID finds the same record
+  seq.uuid_entry[0].len = 16;
+  const uint8_t hfp_ag_128[16] = {0x00, 0x00, 0x11, 0x1f, 0x00, 0x00,
+                                  0x10, 0x00, 0x80, 0x00, 0x00, 0x80,
+                                  0x5f, 0x9b, 0x34, 0xfb};
+  memcpy(seq.uuid_entry[0].value, hfp_ag_128, sizeof(hfp_ag_128));
+  ASSERT_EQ(p_rec, sdp_db_service_search(nullptr, &seq));
+
+  // Changes of the database are seen by the next search
+  ASSERT_TRUE(SDP_DeleteAttribute(hfp_handle, ATTR_ID_SERVICE_CLASS_ID_LIST));
+  ASSERT_EQ(nullptr, sdp_db_service_search(nullptr, &seq));
+  ASSERT_TRUE(SDP_DeleteRecord(a2dp_handle));
+  ASSERT_TRUE(SDP_AddServiceClassIdList(hfp_handle, 1, &hfp_ag));
+  p_rec = sdp_db_service_search(nullptr, &seq);
+  ASSERT_NE(nullptr, p_rec);
+  ASSERT_EQ(hfp_handle, p_rec->record_handle);
+
+  SDP_DeleteRecord(0);
+}
+
 TEST_F(StackSdpMainTest, sdp_disc_wait_text) {
   std::vector<std::pair<tSDP_DISC_WAIT, std::string>> states = {
       std::make_pair(SDP_DISC_WAIT_CONN, "SDP_DISC_WAIT_CONN"),
@@ -36,11 +36,10 @@ static void add_item_to_list(std::list<tGATT_SRV_LIST_ELEM>& srv_list_info,
   elem.is_primary = is_primary;
 }
 
-// BT Spec 5.2, Vol 3, Part G, Appendix B
-TEST(GattDatabaseTest, matchExampleInBtSpecV52) {
-  tGATT_SVC_DB local_db[4];
+// Database of the example in BT Spec 5.2, Vol 3, Part G, Appendix B
+static void add_example_services(std::list<tGATT_SRV_LIST_ELEM>& srv_list_info,
+                                 tGATT_SVC_DB (&local_db)[4]) {
   for (int i=0; i<4; i++) local_db[i] = tGATT_SVC_DB();
-  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
 
   // 0x1800
   add_item_to_list(srv_list_info, &local_db[0], true);
@@ -77,6 +76,13 @@ TEST(GattDatabaseTest, matchExampleInBtSpecV52) {
   gatts_init_service_db(local_db[3], Uuid::From16Bit(0x180F), false, 0x0014, 3);
   gatts_add_characteristic(local_db[3], GATT_PERM_READ,  GATT_CHAR_PROP_BIT_READ,
     Uuid::From16Bit(0x2A19));
+}
+
+// BT Spec 5.2, Vol 3, Part G, Appendix B
+TEST(GattDatabaseTest, matchExampleInBtSpecV52) {
+  tGATT_SVC_DB local_db[4];
+  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
+  add_example_services(srv_list_info, local_db);
 
   Octet16 expected_hash{0xF1, 0xCA, 0x2D, 0x48, 0xEC, 0xF5, 0x8B, 0xAC,
                         0x8A, 0x88, 0x30, 0xBB, 0xB9, 0xFB, 0xA9, 0x90};
@@ -86,3 +92,75 @@ TEST(GattDatabaseTest, matchExampleInBtSpecV52) {
 
   ASSERT_EQ(result_hash, expected_hash);
 }
+
+TEST(GattDatabaseTest, cachedServicesAfterRemoval) {
+  tGATT_SVC_DB local_db[4];
+  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
+  add_example_services(srv_list_info, local_db);
+  Octet16 hash = gatts_calculate_database_hash(&srv_list_info);
+  ASSERT_EQ(hash, gatts_calculate_database_hash(&srv_list_info));
+
+  tGATT_SVC_DB expected_db[4];
+  std::list<tGATT_SRV_LIST_ELEM> expected_list_info;
+  add_example_services(expected_list_info, expected_db);
+  expected_list_info.erase(std::next(expected_list_info.begin()));
+
+  srv_list_info.erase(std::next(srv_list_info.begin()));
+  Octet16 result_hash = gatts_calculate_database_hash(&srv_list_info);
+
+  ASSERT_NE(result_hash, hash);
+  ASSERT_EQ(result_hash, gatts_calculate_database_hash(&expected_list_info));
+}
+
+TEST(GattDatabaseTest, hashComputedOnUse) {
+  tGATT_SVC_DB local_db[4];
+  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
+  add_example_services(srv_list_info, local_db);
+  Octet16 hash = gatts_calculate_database_hash(&srv_list_info);
+
+  gatt_cb.srv_list_info = &srv_list_info;
+  gatt_cb.database_hash = Octet16{0};
+  gatt_cb.is_database_hash_outdated = false;
+  ASSERT_EQ(gatts_get_database_hash(), Octet16{0});
+
+  gatt_cb.is_database_hash_outdated = true;
+  ASSERT_EQ(gatts_get_database_hash(), hash);
+  ASSERT_FALSE(gatt_cb.is_database_hash_outdated);
+  gatt_cb.srv_list_info = nullptr;
+}
+
+TEST(GattDatabaseTest, serviceIndexLookups) {
+  tGATT_SVC_DB local_db[4];
+  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
+  add_example_services(srv_list_info, local_db);
+  for (tGATT_SRV_LIST_ELEM& elem : srv_list_info) {
+    elem.s_hdl = elem.p_db->attr_list.front().handle;
+    elem.e_hdl = elem.p_db->end_handle - 1;
+  }
+
+  gatt_cb.srv_list_info = &srv_list_info;
+  gatt_sr_update_srv_index();
+
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0001)->p_db, &local_db[0]);
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0009)->p_db, &local_db[1]);
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0016)->p_db, &local_db[3]);
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0017), srv_list_info.end());
+  ASSERT_EQ(gatt_sr_find_first_srv_from_handle(0x0013)->p_db, &local_db[2]);
+
+  tGATT_ATTR* p_attr = find_attr_by_handle(&local_db[1], 0x0009);
+  ASSERT_NE(p_attr, nullptr);
+  ASSERT_EQ(p_attr->uuid, Uuid::From16Bit(0x2902));
+  ASSERT_EQ(find_attr_by_handle(&local_db[1], 0x0001), nullptr);
+
+  const auto& declarations =
+      gatt_cb.srv_type_index[Uuid::From16Bit(GATT_UUID_CHAR_DECLARE)];
+  ASSERT_EQ(declarations.size(), 7u);
+  ASSERT_TRUE(std::is_sorted(declarations.begin(), declarations.end(),
+                             [](const tGATT_ATTR* a, const tGATT_ATTR* b) {
+                               return a->handle < b->handle;
+                             }));
+
+  gatt_cb.srv_list_info = nullptr;
+  gatt_sr_update_srv_index();
+  ASSERT_TRUE(gatt_cb.srv_index.empty());
+}
@@ -172,6 +172,8 @@ class StackL2capChannelTest : public StackL2capTest {
       .fixed_chnl_idle_tout = 0,
       .tx_data_len = 0,
       .remote_credit_count = 0,
+      .le_rx_rate = {},
+      .le_tx_rate = {},
       .ecoc = false,
       .reconfig_started = false,
       .metrics = {},
@@ -194,6 +196,24 @@ TEST_F(StackL2capChannelTest, l2c_lcc_proc_pdu__NextSegment) {
   l2c_lcc_proc_pdu(&ccb_, p_buf);
 }
 
+TEST_F(StackL2capChannelTest, l2c_lcc_get_credits_to_grant) {
+  ccb_.p_lcb = &l2cb.lcb_pool[0];
+  ccb_.p_lcb->conn_interval = 6;
+
+  // Plenty of credits left on the peer
+  ccb_.remote_credit_count = L2CA_LeCreditDefault();
+  ASSERT_EQ(0, l2c_lcc_get_credits_to_grant(&ccb_));
+  ASSERT_EQ(L2CA_LeCreditDefault(), ccb_.remote_credit_count);
+
+  // Peer ran low, it is topped up back to the default
+  ccb_.remote_credit_count = L2CA_LeCreditThreshold();
+  ASSERT_EQ(L2CA_LeCreditDefault() - L2CA_LeCreditThreshold(),
+            l2c_lcc_get_credits_to_grant(&ccb_));
+  ASSERT_EQ(L2CA_LeCreditDefault(), ccb_.remote_credit_count);
+
+  ccb_.p_lcb = nullptr;
+}
+
 TEST_F(StackL2capChannelTest, l2c_link_init) {
   l2cb.num_lm_acl_bufs = 0;
   l2cb.controller_xmit_window = 0;
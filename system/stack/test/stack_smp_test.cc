@@ -32,7 +32,9 @@
 #include "stack/smp/p_256_ecc_pp.h"
 #include "stack/smp/smp_int.h"
 #include "test/common/mock_functions.h"
+#include "test/mock/mock_device_controller.h"
 #include "test/mock/mock_stack_acl.h"
+#include "test/mock/mock_stack_hcic_hciblecmds.h"
 #include "types/hci_role.h"
 #include "types/raw_address.h"
 
@@ -372,8 +374,8 @@ TEST(SmpEccValidationTest, test_valid_points) {
 
 TEST(SmpEccValidationTest, test_invalid_points) {
   Point p;
-  multiprecision_init(p.x);
-  multiprecision_init(p.y);
+  memset(p.x, 0, sizeof(p.x));
+  memset(p.y, 0, sizeof(p.y));
 
   EXPECT_FALSE(ECC_ValidatePoint(p));
 
@@ -403,6 +405,76 @@ TEST(SmpEccValidationTest, test_invalid_points) {
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
 
+TEST(SmpKeyPoolTest, test_key_pair_is_generated_ahead) {
+  uint8_t next_octet = 1;
+  test::mock::stack_hcic_hciblecmds::btsnd_hcic_ble_rand.body =
+      [&next_octet](base::Callback<void(BT_OCTET8)> cb) {
+        BT_OCTET8 rand;
+        for (int i = 0; i < BT_OCTET8_LEN; i++) rand[i] = next_octet++;
+        cb.Run(rand);
+      };
+  test::mock::device_controller::readable = true;
+  test::mock::device_controller::ble_supported = true;
+
+  smp_key_pool_init();
+  smp_key_pool_fill();
+  // The private key takes 4 random numbers from the controller
+  EXPECT_EQ(1 + BT_OCTET32_LEN, next_octet);
+
+  tSMP_CB cb{};
+  smp_create_private_key(&cb, nullptr);
+  // The pairing did not wait for the controller
+  EXPECT_EQ(1 + BT_OCTET32_LEN, next_octet);
+  EXPECT_TRUE(cb.pairing_times.local_key_from_pool);
+  for (int i = 0; i < BT_OCTET32_LEN; i++) {
+    EXPECT_EQ(i + 1, cb.private_key[i]);
+  }
+
+  Point public_key;
+  ECC_PointMult_Base(&public_key, (uint32_t*)cb.private_key);
+  EXPECT_EQ(0, memcmp(cb.loc_publ_key.x, public_key.x, BT_OCTET32_LEN));
+  EXPECT_EQ(0, memcmp(cb.loc_publ_key.y, public_key.y, BT_OCTET32_LEN));
+
+  test::mock::stack_hcic_hciblecmds::btsnd_hcic_ble_rand = {};
+  test::mock::device_controller::readable = false;
+  test::mock::device_controller::ble_supported = false;
+}
+
+TEST(SmpCbPoolTest, test_pairings_with_different_devices_run_together) {
+  for (tSMP_CB& cb : smp_cb_pool) memset(&cb, 0, sizeof(tSMP_CB));
+
+  RawAddress first({0x11, 0x22, 0x33, 0x44, 0x55, 0x00});
+  tSMP_CB* p_first = smp_cb_alloc(first);
+  // A single pairing uses the same control block as before
+  ASSERT_EQ(&smp_cb, p_first);
+  p_first->pairing_bda = first;
+  p_first->state = SMP_STATE_WAIT_APP_RSP;
+
+  std::vector<tSMP_CB*> others;
+  for (uint8_t i = 1; i < SMP_MAX_CONCURRENT_PAIRINGS; i++) {
+    RawAddress other({0x11, 0x22, 0x33, 0x44, 0x55, i});
+    tSMP_CB* p_cb = smp_cb_alloc(other);
+    ASSERT_NE(nullptr, p_cb);
+    EXPECT_EQ(nullptr, smp_cb_find(other));
+    p_cb->pairing_bda = other;
+    p_cb->state = SMP_STATE_WAIT_APP_RSP;
+    EXPECT_EQ(p_cb, smp_cb_find(other));
+    others.push_back(p_cb);
+  }
+  EXPECT_EQ(p_first, smp_cb_find(first));
+  EXPECT_EQ(p_first, smp_cb_alloc(first));
+
+  // All the control blocks are taken
+  RawAddress last({0x11, 0x22, 0x33, 0x44, 0x55, 0xff});
+  EXPECT_EQ(nullptr, smp_cb_alloc(last));
+
+  // The control block of a finished pairing is picked up again
+  others.front()->state = SMP_STATE_IDLE;
+  EXPECT_EQ(others.front(), smp_cb_alloc(last));
+
+  for (tSMP_CB& cb : smp_cb_pool) memset(&cb, 0, sizeof(tSMP_CB));
+}
+
 TEST(SmpStatusText, smp_status_text) {
   std::vector<std::pair<tSMP_STATUS, std::string>> status = {
       std::make_pair(SMP_SUCCESS, "SMP_SUCCESS"),
@@ -95,7 +95,7 @@ void CleanCoreInterface() {
 
 MockCoreInterface::MockCoreInterface()
     : bluetooth::core::CoreInterface{&eventCallbacks, &mockConfigInterface,
-                                     &mockCodecInterface,
+                                     &mockCodecInterface, &mockCodecInterface,
                                      &HACK_profileInterface} {};
 
 void MockCoreInterface::onBluetoothEnabled(){};
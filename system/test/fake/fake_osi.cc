@@ -97,6 +97,13 @@ FakeOsi::FakeOsi() {
         alarm->data = data;
       };
 
+  test::mock::osi_alarm::alarm_set_on_mloop_with_slack.body =
+      [](alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+         alarm_callback_t cb, void* data) {
+        alarm->cb = cb;
+        alarm->data = data;
+      };
+
   test::mock::osi_alarm::alarm_cancel.body = [](alarm_t* alarm) {
     if (alarm) {
       alarm->cb = nullptr;
@@ -253,6 +260,8 @@ FakeOsi::FakeOsi() {
   test::mock::osi_fixed_queue::fixed_queue_new.body = [](size_t capacity) {
     return new fixed_queue_t(capacity);
   };
+  test::mock::osi_fixed_queue::fixed_queue_new_ring.body =
+      [](size_t capacity) { return new fixed_queue_t(capacity); };
   test::mock::osi_fixed_queue::fixed_queue_flush.body =
       [](fixed_queue_t* q, fixed_queue_free_cb cb) {
         if (q) {
@@ -394,6 +403,7 @@ FakeOsi::~FakeOsi() {
   test::mock::osi_list::list_node = {};
 
   test::mock::osi_fixed_queue::fixed_queue_new = {};
+  test::mock::osi_fixed_queue::fixed_queue_new_ring = {};
   test::mock::osi_fixed_queue::fixed_queue_flush = {};
   test::mock::osi_fixed_queue::fixed_queue_free = {};
   test::mock::osi_fixed_queue::fixed_queue_enqueue = {};
@@ -65,6 +65,10 @@ const std::list<gatt::Service>* BTA_GATTC_GetServices(uint16_t conn_id) {
   inc_func_call_count(__func__);
   return nullptr;
 }
+bool BTA_GATTC_GetDatabaseHash(uint16_t conn_id, Octet16* p_hash) {
+  inc_func_call_count(__func__);
+  return false;
+}
 tGATT_STATUS BTA_GATTC_DeregisterForNotifications(tGATT_IF client_if,
                                                   const RawAddress& bda,
                                                   uint16_t handle) {
@@ -142,6 +146,12 @@ void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
                             tGATT_AUTH_REQ auth_req) {
   inc_func_call_count(__func__);
 }
+void BTA_GATTC_ReadMultipleVariable(uint16_t conn_id,
+                                    const std::vector<uint16_t>& handles,
+                                    tGATT_AUTH_REQ auth_req,
+                                    GATT_READ_OP_CB callback, void* cb_data) {
+  inc_func_call_count(__func__);
+}
 void BTA_GATTC_ReadUsingCharUuid(uint16_t conn_id, const bluetooth::Uuid& uuid,
                                  uint16_t s_handle, uint16_t e_handle,
                                  tGATT_AUTH_REQ auth_req,
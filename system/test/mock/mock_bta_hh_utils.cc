@@ -41,6 +41,7 @@ struct bta_hh_add_device_to_list bta_hh_add_device_to_list;
 struct bta_hh_clean_up_kdev bta_hh_clean_up_kdev;
 struct bta_hh_cleanup_disable bta_hh_cleanup_disable;
 struct bta_hh_dev_handle_to_cb_idx bta_hh_dev_handle_to_cb_idx;
+struct bta_hh_record_rpt_latency bta_hh_record_rpt_latency;
 struct bta_hh_find_cb bta_hh_find_cb;
 struct bta_hh_get_cb bta_hh_get_cb;
 struct bta_hh_read_ssr_param bta_hh_read_ssr_param;
@@ -76,6 +77,11 @@ uint8_t bta_hh_dev_handle_to_cb_idx(uint8_t dev_handle) {
   inc_func_call_count(__func__);
   return test::mock::bta_hh_utils::bta_hh_dev_handle_to_cb_idx(dev_handle);
 }
+void bta_hh_record_rpt_latency(tBTA_HH_DEV_CB* p_cb,
+                               uint64_t rx_timestamp_us) {
+  inc_func_call_count(__func__);
+  test::mock::bta_hh_utils::bta_hh_record_rpt_latency(p_cb, rx_timestamp_us);
+}
 uint8_t bta_hh_find_cb(const RawAddress& bda) {
   inc_func_call_count(__func__);
   return test::mock::bta_hh_utils::bta_hh_find_cb(bda);
@@ -111,5 +117,6 @@ bool bta_hh_le_is_hh_gatt_if(tGATT_IF client_if) {
   test::mock::bta_hh_utils::bta_hh_le_is_hh_gatt_if(client_if);
   return false;
 }
+void DumpsysBtaHh(int fd) { inc_func_call_count(__func__); }
 // Mocked functions complete
 // END mockcify generation
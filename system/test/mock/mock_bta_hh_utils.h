@@ -104,6 +104,18 @@ struct bta_hh_dev_handle_to_cb_idx {
 };
 extern struct bta_hh_dev_handle_to_cb_idx bta_hh_dev_handle_to_cb_idx;
 
+// Name: bta_hh_record_rpt_latency
+// Params: tBTA_HH_DEV_CB* p_cb, uint64_t rx_timestamp_us
+// Return: void
+struct bta_hh_record_rpt_latency {
+  std::function<void(tBTA_HH_DEV_CB* p_cb, uint64_t rx_timestamp_us)> body{
+      [](tBTA_HH_DEV_CB* p_cb, uint64_t rx_timestamp_us) {}};
+  void operator()(tBTA_HH_DEV_CB* p_cb, uint64_t rx_timestamp_us) {
+    body(p_cb, rx_timestamp_us);
+  };
+};
+extern struct bta_hh_record_rpt_latency bta_hh_record_rpt_latency;
+
 // Name: bta_hh_find_cb
 // Params: const RawAddress& bda
 // Return: uint8_t
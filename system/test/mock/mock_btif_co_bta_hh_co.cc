@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:12
+ *   Functions generated:14
  */
 
 #include <cstdint>
@@ -47,7 +47,7 @@ void bta_hh_co_close(btif_hh_device_t* p_dev) { inc_func_call_count(__func__); }
 void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len,
                     tBTA_HH_PROTO_MODE mode, uint8_t sub_class,
                     uint8_t ctry_code, UNUSED_ATTR const RawAddress& peer_addr,
-                    uint8_t app_id) {
+                    uint8_t app_id, bool more_data) {
   inc_func_call_count(__func__);
 }
 void bta_hh_co_get_rpt_rsp(uint8_t dev_handle, uint8_t status,
@@ -77,4 +77,14 @@ void bta_hh_le_co_rpt_info(const RawAddress& remote_bda,
                            UNUSED_ATTR uint8_t app_id) {
   inc_func_call_count(__func__);
 }
+void bta_hh_le_co_save_db_hash(const RawAddress& remote_bda,
+                               const Octet16& hash,
+                               UNUSED_ATTR uint8_t app_id) {
+  inc_func_call_count(__func__);
+}
+bool bta_hh_le_co_load_db_hash(const RawAddress& remote_bda, Octet16* p_hash,
+                               UNUSED_ATTR uint8_t app_id) {
+  inc_func_call_count(__func__);
+  return false;
+}
 void uhid_set_non_blocking(int fd) { inc_func_call_count(__func__); }
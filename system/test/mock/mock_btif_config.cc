@@ -56,6 +56,7 @@ struct btif_config_get_uint64 btif_config_get_uint64;
 struct btif_config_set_uint64 btif_config_set_uint64;
 struct btif_config_get_str btif_config_get_str;
 struct btif_config_set_str btif_config_set_str;
+struct btif_config_set_strs btif_config_set_strs;
 struct btif_config_get_bin btif_config_get_bin;
 struct btif_config_get_bin_length btif_config_get_bin_length;
 struct btif_config_set_bin btif_config_set_bin;
@@ -104,6 +105,12 @@ bool btif_config_set_str(const std::string& section, const std::string& key,
   inc_func_call_count(__func__);
   return test::mock::btif_config::btif_config_set_str(section, key, value);
 }
+bool btif_config_set_strs(
+    const std::string& section,
+    const std::vector<std::pair<std::string, std::string>>& values) {
+  inc_func_call_count(__func__);
+  return test::mock::btif_config::btif_config_set_strs(section, values);
+}
 bool btif_config_get_bin(const std::string& section, const std::string& key,
                          uint8_t* value, size_t* length) {
   inc_func_call_count(__func__);
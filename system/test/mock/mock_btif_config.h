@@ -140,6 +140,24 @@ struct btif_config_set_str {
   };
 };
 extern struct btif_config_set_str btif_config_set_str;
+// Name: btif_config_set_strs
+// Params: const std::string& section, const std::vector<std::pair<std::string,
+// std::string>>& values Returns: bool
+struct btif_config_set_strs {
+  std::function<bool(
+      const std::string& section,
+      const std::vector<std::pair<std::string, std::string>>& values)>
+      body{[](const std::string& section,
+              const std::vector<std::pair<std::string, std::string>>& values) {
+        return false;
+      }};
+  bool operator()(
+      const std::string& section,
+      const std::vector<std::pair<std::string, std::string>>& values) {
+    return body(section, values);
+  };
+};
+extern struct btif_config_set_strs btif_config_set_strs;
 // Name: btif_config_get_bin
 // Params: const std::string& section, const std::string& key, uint8_t* value,
 // size_t* length Returns: bool
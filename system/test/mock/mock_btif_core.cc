@@ -61,6 +61,14 @@ bt_status_t btif_transfer_context(tBTIF_CBACK* p_cback, uint16_t event,
   inc_func_call_count(__func__);
   return BT_STATUS_SUCCESS;
 }
+void btif_debug_jni_thread_dump(int fd) {
+  inc_func_call_count(__func__);
+}
+bt_status_t do_in_jni_thread_bulk(base::OnceClosure task) {
+  inc_func_call_count(__func__);
+  do_in_jni_thread_task_queue.push(std::move(task));
+  return BT_STATUS_SUCCESS;
+}
 bt_status_t do_in_jni_thread(base::OnceClosure task) {
   inc_func_call_count(__func__);
   do_in_jni_thread_task_queue.push(std::move(task));
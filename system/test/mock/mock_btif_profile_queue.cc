@@ -38,6 +38,7 @@ namespace btif_profile_queue {
 
 // Function state capture and return values, if needed
 struct btif_queue_advance btif_queue_advance;
+struct btif_queue_advance_by_uuid btif_queue_advance_by_uuid;
 struct btif_queue_cleanup btif_queue_cleanup;
 struct btif_queue_connect btif_queue_connect;
 struct btif_queue_connect_next btif_queue_connect_next;
@@ -64,6 +65,10 @@ void btif_queue_advance() {
   inc_func_call_count(__func__);
   test::mock::btif_profile_queue::btif_queue_advance();
 }
+void btif_queue_advance_by_uuid(uint16_t uuid, const RawAddress* bda) {
+  inc_func_call_count(__func__);
+  test::mock::btif_profile_queue::btif_queue_advance_by_uuid(uuid, bda);
+}
 void btif_queue_cleanup(uint16_t uuid) {
   inc_func_call_count(__func__);
   test::mock::btif_profile_queue::btif_queue_cleanup(uuid);
@@ -67,6 +67,16 @@ struct btif_queue_advance {
 };
 extern struct btif_queue_advance btif_queue_advance;
 
+// Name: btif_queue_advance_by_uuid
+// Params: uint16_t uuid, const RawAddress* bda
+// Return: void
+struct btif_queue_advance_by_uuid {
+  std::function<void(uint16_t uuid, const RawAddress* bda)> body{
+      [](uint16_t uuid, const RawAddress* bda) {}};
+  void operator()(uint16_t uuid, const RawAddress* bda) { body(uuid, bda); };
+};
+extern struct btif_queue_advance_by_uuid btif_queue_advance_by_uuid;
+
 // Name: btif_queue_cleanup
 // Params: uint16_t uuid
 // Return: void
@@ -168,6 +168,12 @@ bt_status_t btif_storage_set_remote_device_property(
   inc_func_call_count(__func__);
   return BT_STATUS_SUCCESS;
 }
+bt_status_t btif_storage_set_remote_device_properties(
+    const RawAddress* remote_bd_addr, uint32_t num_properties,
+    bt_property_t* properties) {
+  inc_func_call_count(__func__);
+  return BT_STATUS_SUCCESS;
+}
 void btif_storage_add_hearing_aid(const HearingDevice& dev_info) {
   inc_func_call_count(__func__);
 }
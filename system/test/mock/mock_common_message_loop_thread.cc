@@ -44,7 +44,8 @@ MessageLoopThread::MessageLoopThread(const std::string& thread_name,
       linux_tid_(-1),
       weak_ptr_factory_(this),
       shutting_down_(false),
-      is_main_(is_main) {}
+      is_main_(is_main),
+      task_profiling_enabled_(false) {}
 
 MessageLoopThread::~MessageLoopThread() { ShutDown(); }
 
@@ -175,6 +176,16 @@ bool MessageLoopThread::EnableRealTimeScheduling() {
   return true;
 }
 
+bool MessageLoopThread::ApplySchedulingPolicy(bool realtime) { return true; }
+
+void MessageLoopThread::DumpScheduling(int fd) const {}
+
+void MessageLoopThread::EnableTaskProfiling(bool enable) {
+  task_profiling_enabled_ = enable;
+}
+
+void MessageLoopThread::DumpTaskProfile(int fd) const {}
+
 base::WeakPtr<MessageLoopThread> MessageLoopThread::GetWeakPtr() {
   std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
   return weak_ptr_factory_.GetWeakPtr();
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gd/common/startup_trace.h"
+#include "test/common/mock_functions.h"
+
+namespace bluetooth {
+namespace common {
+
+void StartupTrace::Start() { inc_func_call_count(__func__); }
+void StartupTrace::Stop() { inc_func_call_count(__func__); }
+bool StartupTrace::IsRecording() {
+  inc_func_call_count(__func__);
+  return false;
+}
+void StartupTrace::Record(
+    std::string name, std::chrono::steady_clock::time_point start_timestamp,
+    std::chrono::steady_clock::time_point end_timestamp) {
+  inc_func_call_count(__func__);
+}
+std::vector<StartupTraceEvent> StartupTrace::GetEvents() {
+  inc_func_call_count(__func__);
+  return {};
+}
+void StartupTrace::Dump(int fd) { inc_func_call_count(__func__); }
+
+ScopedStartupTrace::ScopedStartupTrace(std::string name)
+    : name_(std::move(name)),
+      start_timestamp_(std::chrono::steady_clock::now()) {
+  inc_func_call_count(__func__);
+}
+ScopedStartupTrace::~ScopedStartupTrace() { inc_func_call_count(__func__); }
+
+}  // namespace common
+}  // namespace bluetooth
@@ -17,6 +17,7 @@
  ******************************************************************************/
 
 #include "common/init_flags.h"
+#include "os/logging/binary_log.h"
 #include "os/logging/log_redaction.h"
 
 namespace bluetooth {
@@ -26,5 +27,17 @@ using bluetooth::common::init_flags::redact_log_is_enabled;
 
 bool should_log_be_redacted() { return false; }
 
+uint64_t BinaryLogArg<hci::Address>::Encode(const hci::Address& address) {
+  return 0;
+}
+uint64_t BinaryLogArg<RawAddress>::Encode(const RawAddress& address) {
+  return 0;
+}
+void BinaryLogPush(const BinaryLogEntry& entry) {}
+std::string BinaryLogDecode(const BinaryLogEntry& entry, bool redact) {
+  return std::string();
+}
+void BinaryLogDump(int fd) {}
+
 }  // namespace os
 }  // namespace bluetooth
@@ -61,6 +61,11 @@ bool bluetooth::shim::BtifConfigInterface::SetStr(const std::string& section,
                                                   const std::string& value) {
   return false;
 }
+bool bluetooth::shim::BtifConfigInterface::SetStrs(
+    const std::string& section,
+    const std::vector<std::pair<std::string, std::string>>& properties) {
+  return false;
+}
 bool bluetooth::shim::BtifConfigInterface::GetBin(const std::string& section,
                                                   const std::string& key,
                                                   uint8_t* value,
@@ -100,3 +100,16 @@ void bluetooth::shim::ACL_LeSubrateRequest(
     uint16_t max_latency, uint16_t cont_num, uint16_t sup_tout) {
   inc_func_call_count(__func__);
 }
+void bluetooth::shim::ACL_SetLeTxCreditReservation(uint16_t hci_handle,
+                                                   uint16_t credits) {
+  inc_func_call_count(__func__);
+}
+void bluetooth::shim::ACL_RequestLeLinkProfile(uint16_t hci_handle,
+                                               const std::string& client,
+                                               uint8_t profile) {
+  inc_func_call_count(__func__);
+}
+void bluetooth::shim::ACL_ReleaseLeLinkProfile(uint16_t hci_handle,
+                                               const std::string& client) {
+  inc_func_call_count(__func__);
+}
@@ -46,6 +46,8 @@ struct alarm_new alarm_new;
 struct alarm_new_periodic alarm_new_periodic;
 struct alarm_set alarm_set;
 struct alarm_set_on_mloop alarm_set_on_mloop;
+struct alarm_set_with_slack alarm_set_with_slack;
+struct alarm_set_on_mloop_with_slack alarm_set_on_mloop_with_slack;
 
 }  // namespace osi_alarm
 }  // namespace mock
@@ -94,5 +96,18 @@ void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
   inc_func_call_count(__func__);
   test::mock::osi_alarm::alarm_set_on_mloop(alarm, interval_ms, cb, data);
 }
+void alarm_set_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                          uint64_t slack_ms, alarm_callback_t cb, void* data) {
+  inc_func_call_count(__func__);
+  test::mock::osi_alarm::alarm_set_with_slack(alarm, interval_ms, slack_ms, cb,
+                                              data);
+}
+void alarm_set_on_mloop_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                                   uint64_t slack_ms, alarm_callback_t cb,
+                                   void* data) {
+  inc_func_call_count(__func__);
+  test::mock::osi_alarm::alarm_set_on_mloop_with_slack(alarm, interval_ms,
+                                                       slack_ms, cb, data);
+}
 // Mocked functions complete
 // END mockcify generation
@@ -175,6 +175,38 @@ struct alarm_set_on_mloop {
 };
 extern struct alarm_set_on_mloop alarm_set_on_mloop;
 
+// Name: alarm_set_with_slack
+// Params: alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+// alarm_callback_t cb, void* data
+// Return: void
+struct alarm_set_with_slack {
+  std::function<void(alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+                     alarm_callback_t cb, void* data)>
+      body{[](alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+              alarm_callback_t cb, void* data) {}};
+  void operator()(alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+                  alarm_callback_t cb, void* data) {
+    body(alarm, interval_ms, slack_ms, cb, data);
+  };
+};
+extern struct alarm_set_with_slack alarm_set_with_slack;
+
+// Name: alarm_set_on_mloop_with_slack
+// Params: alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+// alarm_callback_t cb, void* data
+// Return: void
+struct alarm_set_on_mloop_with_slack {
+  std::function<void(alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+                     alarm_callback_t cb, void* data)>
+      body{[](alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+              alarm_callback_t cb, void* data) {}};
+  void operator()(alarm_t* alarm, uint64_t interval_ms, uint64_t slack_ms,
+                  alarm_callback_t cb, void* data) {
+    body(alarm, interval_ms, slack_ms, cb, data);
+  };
+};
+extern struct alarm_set_on_mloop_with_slack alarm_set_on_mloop_with_slack;
+
 }  // namespace osi_alarm
 }  // namespace mock
 }  // namespace test
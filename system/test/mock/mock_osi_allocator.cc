@@ -40,6 +40,8 @@ struct osi_calloc osi_calloc;
 struct osi_free osi_free;
 struct osi_free_and_reset osi_free_and_reset;
 struct osi_malloc osi_malloc;
+struct osi_malloc_packet osi_malloc_packet;
+struct osi_calloc_packet osi_calloc_packet;
 struct osi_strdup osi_strdup;
 struct osi_strndup osi_strndup;
 
@@ -64,6 +66,14 @@ void* osi_malloc(size_t size) {
   inc_func_call_count(__func__);
   return test::mock::osi_allocator::osi_malloc(size);
 }
+void* osi_malloc_packet(size_t size) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_allocator::osi_malloc_packet(size);
+}
+void* osi_calloc_packet(size_t size) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_allocator::osi_calloc_packet(size);
+}
 char* osi_strdup(const char* str) {
   inc_func_call_count(__func__);
   return test::mock::osi_allocator::osi_strdup(str);
@@ -88,6 +88,28 @@ struct osi_malloc {
 };
 extern struct osi_malloc osi_malloc;
 
+// Name: osi_malloc_packet
+// Params: size_t size
+// Return: void*
+// Packets are allocated through the |osi_malloc| mock by default.
+struct osi_malloc_packet {
+  std::function<void*(size_t size)> body{
+      [](size_t size) { return test::mock::osi_allocator::osi_malloc(size); }};
+  void* operator()(size_t size) { return body(size); };
+};
+extern struct osi_malloc_packet osi_malloc_packet;
+
+// Name: osi_calloc_packet
+// Params: size_t size
+// Return: void*
+// Packets are allocated through the |osi_calloc| mock by default.
+struct osi_calloc_packet {
+  std::function<void*(size_t size)> body{
+      [](size_t size) { return test::mock::osi_allocator::osi_calloc(size); }};
+  void* operator()(size_t size) { return body(size); };
+};
+extern struct osi_calloc_packet osi_calloc_packet;
+
 // Name: osi_strdup
 // Params: const char* str
 // Return: char*
@@ -47,6 +47,7 @@ struct fixed_queue_get_list fixed_queue_get_list;
 struct fixed_queue_is_empty fixed_queue_is_empty;
 struct fixed_queue_length fixed_queue_length;
 struct fixed_queue_new fixed_queue_new;
+struct fixed_queue_new_ring fixed_queue_new_ring;
 struct fixed_queue_register_dequeue fixed_queue_register_dequeue;
 struct fixed_queue_try_dequeue fixed_queue_try_dequeue;
 struct fixed_queue_try_enqueue fixed_queue_try_enqueue;
@@ -104,6 +105,10 @@ fixed_queue_t* fixed_queue_new(size_t capacity) {
   inc_func_call_count(__func__);
   return test::mock::osi_fixed_queue::fixed_queue_new(capacity);
 }
+fixed_queue_t* fixed_queue_new_ring(size_t capacity) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_fixed_queue::fixed_queue_new_ring(capacity);
+}
 void fixed_queue_register_dequeue(fixed_queue_t* queue, reactor_t* reactor,
                                   fixed_queue_cb ready_cb, void* context) {
   inc_func_call_count(__func__);
@@ -174,6 +174,17 @@ struct fixed_queue_new {
 };
 extern struct fixed_queue_new fixed_queue_new;
 
+// Name: fixed_queue_new_ring
+// Params: size_t capacity
+// Return: fixed_queue_t*
+struct fixed_queue_new_ring {
+  fixed_queue_t* return_value{0};
+  std::function<fixed_queue_t*(size_t capacity)> body{
+      [this](size_t capacity) { return return_value; }};
+  fixed_queue_t* operator()(size_t capacity) { return body(capacity); };
+};
+extern struct fixed_queue_new_ring fixed_queue_new_ring;
+
 // Name: fixed_queue_register_dequeue
 // Params: fixed_queue_t* queue, reactor_t* reactor, fixed_queue_cb ready_cb,
 // void* context Return: void
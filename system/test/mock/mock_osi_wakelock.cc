@@ -37,6 +37,7 @@ namespace osi_wakelock {
 
 // Function state capture and return values, if needed
 struct wakelock_acquire wakelock_acquire;
+struct wakelock_acquire_for wakelock_acquire_for;
 struct wakelock_cleanup wakelock_cleanup;
 struct wakelock_debug_dump wakelock_debug_dump;
 struct wakelock_release wakelock_release;
@@ -52,6 +53,10 @@ bool wakelock_acquire(void) {
   inc_func_call_count(__func__);
   return test::mock::osi_wakelock::wakelock_acquire();
 }
+bool wakelock_acquire_for(const char* source) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_wakelock::wakelock_acquire_for(source);
+}
 void wakelock_cleanup(void) {
   inc_func_call_count(__func__);
   test::mock::osi_wakelock::wakelock_cleanup();
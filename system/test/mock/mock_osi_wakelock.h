@@ -75,6 +75,17 @@ struct wakelock_acquire {
 };
 extern struct wakelock_acquire wakelock_acquire;
 
+// Name: wakelock_acquire_for
+// Params: const char* source
+// Return: bool
+struct wakelock_acquire_for {
+  bool return_value{false};
+  std::function<bool(const char* source)> body{
+      [this](const char* source) { return return_value; }};
+  bool operator()(const char* source) { return body(source); };
+};
+extern struct wakelock_acquire_for wakelock_acquire_for;
+
 // Name: wakelock_cleanup
 // Params: void
 // Return: void
@@ -73,6 +73,7 @@ void BTM_PM_OnConnected(uint16_t handle, const RawAddress& remote_bda) {
   inc_func_call_count(__func__);
 }
 void BTM_PM_OnDisconnected(uint16_t handle) { inc_func_call_count(__func__); }
+void BTM_PM_OnAclData(uint16_t handle) { inc_func_call_count(__func__); }
 void btm_pm_on_mode_change(tHCI_STATUS status, uint16_t handle,
                            tHCI_MODE current_mode, uint16_t interval) {
   inc_func_call_count(__func__);
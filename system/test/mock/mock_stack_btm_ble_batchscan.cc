@@ -53,6 +53,10 @@ void BTM_BleReadScanReports(tBTM_BLE_BATCH_SCAN_MODE scan_mode,
                             tBTM_BLE_SCAN_REP_CBACK cb) {
   inc_func_call_count(__func__);
 }
+void BTM_BleStreamScanReports(tBTM_BLE_BATCH_SCAN_MODE scan_mode,
+                              tBTM_BLE_SCAN_REP_CBACK cb) {
+  inc_func_call_count(__func__);
+}
 void BTM_BleSetStorageConfig(uint8_t batch_scan_full_max,
                              uint8_t batch_scan_trunc_max,
                              uint8_t batch_scan_notify_threshold,
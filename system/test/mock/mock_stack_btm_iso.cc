@@ -1,5 +1,6 @@
 #include <memory>
 
+#include "osi/include/allocator.h"
 #include "stack/include/btm_iso_api.h"
 
 using bluetooth::hci::iso_manager::BigCallbacks;
@@ -36,6 +37,7 @@ void IsoManager::CreateBig(uint8_t big_id,
                            struct iso_manager::big_create_params big_params) {}
 void IsoManager::TerminateBig(uint8_t big_id, uint8_t reason) {}
 void IsoManager::HandleIsoData(void* p_msg) {}
+void IsoManager::ReleaseIsoSdu(void* p_msg) { osi_free(p_msg); }
 void IsoManager::HandleDisconnect(uint16_t handle, uint8_t reason) {}
 void IsoManager::HandleNumComplDataPkts(uint8_t* p, uint8_t evt_len) {}
 void IsoManager::HandleGdNumComplDataPkts(uint16_t handle, uint16_t credits) {}
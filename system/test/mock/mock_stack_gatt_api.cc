@@ -45,6 +45,7 @@ struct GATTC_UpdateUserAttMtuIfNeeded GATTC_UpdateUserAttMtuIfNeeded;
 struct GATTC_ConfigureMTU GATTC_ConfigureMTU;
 struct GATTC_Discover GATTC_Discover;
 struct GATTC_ExecuteWrite GATTC_ExecuteWrite;
+struct GATTC_IsAdditionalBearerAvailable GATTC_IsAdditionalBearerAvailable;
 struct GATTC_Read GATTC_Read;
 struct GATTC_SendHandleValueConfirm GATTC_SendHandleValueConfirm;
 struct GATTC_Write GATTC_Write;
@@ -84,6 +85,7 @@ tGATTC_TryMtuRequestResult GATTC_TryMtuRequest::return_value =
 tGATT_STATUS GATTC_ConfigureMTU::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_Discover::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_ExecuteWrite::return_value = GATT_SUCCESS;
+bool GATTC_IsAdditionalBearerAvailable::return_value = false;
 tGATT_STATUS GATTC_Read::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_SendHandleValueConfirm::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_Write::return_value = GATT_SUCCESS;
@@ -143,6 +145,10 @@ tGATT_STATUS GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute) {
   inc_func_call_count(__func__);
   return test::mock::stack_gatt_api::GATTC_ExecuteWrite(conn_id, is_execute);
 }
+bool GATTC_IsAdditionalBearerAvailable(uint16_t conn_id) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATTC_IsAdditionalBearerAvailable(conn_id);
+}
 tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
                         tGATT_READ_PARAM* p_read) {
   inc_func_call_count(__func__);
@@ -265,4 +271,11 @@ bool GATT_Connect(tGATT_IF gatt_if, const RawAddress& bd_addr,
       gatt_if, bd_addr, 0, connection_type, transport, opportunistic, 0);
 }
 
+tGATT_STATUS GATTS_HandleMultipleValueNotification(
+    uint16_t conn_id, const std::vector<tGATT_VALUE>& notifs) {
+  inc_func_call_count(__func__);
+  return GATT_SUCCESS;
+}
+void GATT_Dumpsys(int fd) { inc_func_call_count(__func__); }
+
 // END mockcify generation
@@ -59,6 +59,13 @@ bool connection_manager::direct_connect_add(uint8_t app_id,
   inc_func_call_count(__func__);
   return false;
 }
+bool connection_manager::direct_connect_add(uint8_t app_id,
+                                            const RawAddress& address,
+                                            tCONN_PRIORITY priority,
+                                            uint64_t timeout_ms) {
+  inc_func_call_count(__func__);
+  return false;
+}
 bool connection_manager::direct_connect_remove(uint8_t app_id,
                                                const RawAddress& address) {
   inc_func_call_count(__func__);
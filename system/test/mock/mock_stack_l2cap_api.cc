@@ -84,6 +84,7 @@ struct L2CA_SetMediaStreamChannel L2CA_SetMediaStreamChannel;
 struct L2CA_isMediaChannel L2CA_isMediaChannel;
 struct L2CA_LeCreditDefault L2CA_LeCreditDefault;
 struct L2CA_LeCreditThreshold L2CA_LeCreditThreshold;
+struct L2CA_Dumpsys L2CA_Dumpsys;
 
 }  // namespace stack_l2cap_api
 }  // namespace mock
@@ -291,5 +292,9 @@ uint16_t L2CA_LeCreditThreshold() {
   inc_func_call_count(__func__);
   return test::mock::stack_l2cap_api::L2CA_LeCreditThreshold();
 }
+void L2CA_Dumpsys(int fd) {
+  inc_func_call_count(__func__);
+  test::mock::stack_l2cap_api::L2CA_Dumpsys(fd);
+}
 
 // END mockcify generation
@@ -524,6 +524,14 @@ struct L2CA_LeCreditThreshold {
   uint16_t operator()() { return body(); };
 };
 extern struct L2CA_LeCreditThreshold L2CA_LeCreditThreshold;
+// Name: L2CA_Dumpsys
+// Params: int fd
+// Returns: void
+struct L2CA_Dumpsys {
+  std::function<void(int fd)> body{[](int fd) {}};
+  void operator()(int fd) { body(fd); };
+};
+extern struct L2CA_Dumpsys L2CA_Dumpsys;
 
 }  // namespace stack_l2cap_api
 }  // namespace mock
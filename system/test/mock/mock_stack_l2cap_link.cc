@@ -52,6 +52,13 @@ void l2c_OnHciModeChangeSendPendingPackets(RawAddress remote) {
 void l2c_info_resp_timer_timeout(void* data) { inc_func_call_count(__func__); }
 void l2c_link_adjust_allocation(void) { inc_func_call_count(__func__); }
 void l2c_link_adjust_chnl_allocation(void) { inc_func_call_count(__func__); }
+int l2c_link_get_leaked_xmit_window(tBT_TRANSPORT transport) {
+  inc_func_call_count(__func__);
+  return 0;
+}
+void l2c_link_reclaim_leaked_xmit_window(void) {
+  inc_func_call_count(__func__);
+}
 void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
                               BT_HDR* p_buf) {
   inc_func_call_count(__func__);
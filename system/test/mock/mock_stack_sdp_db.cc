@@ -92,6 +92,7 @@ tSDP_RECORD* sdp_db_find_record(uint32_t handle) {
   inc_func_call_count(__func__);
   return nullptr;
 }
+void sdp_db_invalidate_uuid_index(void) { inc_func_call_count(__func__); }
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
                                          tSDP_UUID_SEQ* p_seq) {
   inc_func_call_count(__func__);
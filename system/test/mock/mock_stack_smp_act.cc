@@ -399,9 +399,9 @@ bool smp_proc_ltk_request(const RawAddress& bda) {
   inc_func_call_count(__func__);
   return test::mock::stack_smp_act::smp_proc_ltk_request(bda);
 }
-void smp_process_secure_connection_long_term_key(void) {
+void smp_process_secure_connection_long_term_key(tSMP_CB* p_cb) {
   inc_func_call_count(__func__);
-  test::mock::stack_smp_act::smp_process_secure_connection_long_term_key();
+  test::mock::stack_smp_act::smp_process_secure_connection_long_term_key(p_cb);
 }
 void smp_set_derive_link_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
   inc_func_call_count(__func__);
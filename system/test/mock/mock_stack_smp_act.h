@@ -643,11 +643,11 @@ struct smp_proc_ltk_request {
 };
 extern struct smp_proc_ltk_request smp_proc_ltk_request;
 // Name: smp_process_secure_connection_long_term_key
-// Params: void
+// Params: tSMP_CB* p_cb
 // Returns: void
 struct smp_process_secure_connection_long_term_key {
-  std::function<void(void)> body{[](void) {}};
-  void operator()(void) { body(); };
+  std::function<void(tSMP_CB* p_cb)> body{[](tSMP_CB* p_cb) {}};
+  void operator()(tSMP_CB* p_cb) { body(p_cb); };
 };
 extern struct smp_process_secure_connection_long_term_key
     smp_process_secure_connection_long_term_key;
@@ -67,6 +67,7 @@ void SMP_ConfirmReply(const RawAddress& bd_addr, uint8_t res) {
   inc_func_call_count(__func__);
 }
 void SMP_Init(void) { inc_func_call_count(__func__); }
+void SMP_FillKeyPool(void) { inc_func_call_count(__func__); }
 void SMP_OobDataReply(const RawAddress& bd_addr, tSMP_STATUS res, uint8_t len,
                       uint8_t* p_data) {
   inc_func_call_count(__func__);
@@ -307,6 +307,14 @@ void* osi_malloc(size_t size) {
   inc_func_call_count(__func__);
   return nullptr;
 }
+void* osi_malloc_packet(size_t size) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
+void* osi_calloc_packet(size_t size) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
 
 bool fixed_queue_is_empty(fixed_queue_t* queue) {
   inc_func_call_count(__func__);
@@ -320,6 +328,10 @@ fixed_queue_t* fixed_queue_new(size_t capacity) {
   inc_func_call_count(__func__);
   return nullptr;
 }
+fixed_queue_t* fixed_queue_new_ring(size_t capacity) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
 int fixed_queue_get_dequeue_fd(const fixed_queue_t* queue) {
   inc_func_call_count(__func__);
   return 0;
@@ -419,6 +431,18 @@ void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
   fake_osi_alarm_set_on_mloop_.cb = cb;
   fake_osi_alarm_set_on_mloop_.data = data;
 }
+void alarm_set_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                          uint64_t slack_ms, alarm_callback_t cb, void* data) {
+  inc_func_call_count(__func__);
+}
+void alarm_set_on_mloop_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                                   uint64_t slack_ms, alarm_callback_t cb,
+                                   void* data) {
+  inc_func_call_count(__func__);
+  fake_osi_alarm_set_on_mloop_.interval_ms = interval_ms;
+  fake_osi_alarm_set_on_mloop_.cb = cb;
+  fake_osi_alarm_set_on_mloop_.data = data;
+}
 
 int osi_rand(void) {
   inc_func_call_count(__func__);
@@ -630,6 +654,10 @@ bool wakelock_acquire(void) {
   inc_func_call_count(__func__);
   return false;
 }
+bool wakelock_acquire_for(const char* source) {
+  inc_func_call_count(__func__);
+  return false;
+}
 bool wakelock_release(void) {
   inc_func_call_count(__func__);
   return false;
@@ -32,33 +32,9 @@ using UUID128Bit = Uuid::UUID128Bit;
 const Uuid Uuid::kEmpty = Uuid::From128BitBE(UUID128Bit{{0x00}});
 
 namespace {
-constexpr Uuid kBase = Uuid::From128BitBE(
-    UUID128Bit{{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
-                0x00, 0x80, 0x5f, 0x9b, 0x34, 0xfb}});
+constexpr Uuid kBase = Uuid::From16Bit(0x0000);
 }  // namespace
 
-size_t Uuid::GetShortestRepresentationSize() const {
-  if (memcmp(uu.data() + kNumBytes32, kBase.uu.data() + kNumBytes32,
-             kNumBytes128 - kNumBytes32) != 0) {
-    return kNumBytes128;
-  }
-
-  if (uu[0] == 0 && uu[1] == 0) return kNumBytes16;
-
-  return kNumBytes32;
-}
-
-bool Uuid::Is16Bit() const {
-  return GetShortestRepresentationSize() == kNumBytes16;
-}
-
-uint16_t Uuid::As16Bit() const { return (((uint16_t)uu[2]) << 8) + uu[3]; }
-
-uint32_t Uuid::As32Bit() const {
-  return (((uint32_t)uu[0]) << 24) + (((uint32_t)uu[1]) << 16) +
-         (((uint32_t)uu[2]) << 8) + uu[3];
-}
-
 Uuid Uuid::FromString(const std::string& uuid, bool* is_valid) {
   if (is_valid) *is_valid = false;
   Uuid ret = kBase;
@@ -103,14 +79,6 @@ Uuid Uuid::FromString(const std::string& uuid, bool* is_valid) {
   return ret;
 }
 
-Uuid Uuid::From16Bit(uint16_t uuid16) {
-  Uuid u = kBase;
-
-  u.uu[2] = (uint8_t)((0xFF00 & uuid16) >> 8);
-  u.uu[3] = (uint8_t)(0x00FF & uuid16);
-  return u;
-}
-
 Uuid Uuid::From32Bit(uint32_t uuid32) {
   Uuid u = kBase;
 
@@ -153,23 +121,10 @@ Uuid Uuid::GetRandom() {
   return uuid;
 }
 
-bool Uuid::IsEmpty() const { return *this == kEmpty; }
-
-bool Uuid::IsBase() const { return *this == kBase; }
-
 void Uuid::UpdateUuid(const Uuid& uuid) {
   uu = uuid.uu;
 }
 
-bool Uuid::operator<(const Uuid& rhs) const {
-  return std::lexicographical_compare(uu.begin(), uu.end(), rhs.uu.begin(),
-                                      rhs.uu.end());
-}
-
-bool Uuid::operator==(const Uuid& rhs) const { return uu == rhs.uu; }
-
-bool Uuid::operator!=(const Uuid& rhs) const { return uu != rhs.uu; }
-
 std::string Uuid::ToString() const {
   return base::StringPrintf(
       "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <array>
+#include <functional>
 #include <string>
 
 namespace bluetooth {
@@ -51,18 +52,30 @@ class Uuid final {
 
   // Returns the shortest possible representation of this UUID in bytes. Either
   // kNumBytes16, kNumBytes32, or kNumBytes128
-  size_t GetShortestRepresentationSize() const;
+  constexpr size_t GetShortestRepresentationSize() const {
+    if (GetLow() != kBaseLow || (GetHigh() & kBase32BitMask) != kBaseHigh) {
+      return kNumBytes128;
+    }
+    if ((GetHigh() >> 48) == 0) return kNumBytes16;
+    return kNumBytes32;
+  }
 
   // Returns true if this UUID can be represented as 16 bit.
-  bool Is16Bit() const;
+  constexpr bool Is16Bit() const {
+    return GetLow() == kBaseLow && (GetHigh() & kBase16BitMask) == kBaseHigh;
+  }
 
   // Returns 16 bit Little Endian representation of this UUID. Use
   // GetShortestRepresentationSize() or Is16Bit() before using this method.
-  uint16_t As16Bit() const;
+  constexpr uint16_t As16Bit() const {
+    return static_cast<uint16_t>(GetHigh() >> 32);
+  }
 
   // Returns 32 bit Little Endian representation of this UUID. Use
   // GetShortestRepresentationSize() before using this method.
-  uint32_t As32Bit() const;
+  constexpr uint32_t As32Bit() const {
+    return static_cast<uint32_t>(GetHigh() >> 32);
+  }
 
   // Converts string representing 128, 32, or 16 bit UUID in
   // xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx, xxxxxxxx, or xxxx format to UUID. If
@@ -70,8 +83,14 @@ class Uuid final {
   // successfull, false otherwise.
   static Uuid FromString(const std::string& uuid, bool* is_valid = nullptr);
 
-  // Converts 16bit Little Endian representation of UUID to UUID
-  static Uuid From16Bit(uint16_t uuid16bit);
+  // Converts 16bit Little Endian representation of UUID to UUID. constexpr, so
+  // that comparing with a SIG assigned UUID compares with constants.
+  static constexpr Uuid From16Bit(uint16_t uuid16bit) {
+    UUID128Bit uu = kBaseBytes;
+    uu[2] = static_cast<uint8_t>(uuid16bit >> 8);
+    uu[3] = static_cast<uint8_t>(uuid16bit);
+    return Uuid(uu);
+  }
 
   // Converts 32bit Little Endian representation of UUID to UUID
   static Uuid From32Bit(uint32_t uuid32bit);
@@ -104,21 +123,49 @@ class Uuid final {
   std::string ToString() const;
 
   // Returns true if this UUID is equal to kEmpty
-  bool IsEmpty() const;
+  constexpr bool IsEmpty() const { return GetHigh() == 0 && GetLow() == 0; }
 
   // Returns true if this UUID is equal to kBase
-  bool IsBase() const;
+  constexpr bool IsBase() const {
+    return GetHigh() == kBaseHigh && GetLow() == kBaseLow;
+  }
 
   // Update UUID with new value
   void UpdateUuid(const Uuid& uuid);
 
-  bool operator<(const Uuid& rhs) const;
-  bool operator==(const Uuid& rhs) const;
-  bool operator!=(const Uuid& rhs) const;
+  constexpr bool operator<(const Uuid& rhs) const {
+    return GetHigh() < rhs.GetHigh() ||
+           (GetHigh() == rhs.GetHigh() && GetLow() < rhs.GetLow());
+  }
+  constexpr bool operator==(const Uuid& rhs) const {
+    return GetHigh() == rhs.GetHigh() && GetLow() == rhs.GetLow();
+  }
+  constexpr bool operator!=(const Uuid& rhs) const { return !(*this == rhs); }
+
+  // Returns the first and last 8 bytes of the UUID as Big Endian integers,
+  // which the comparisons and the hash work on instead of the 16 bytes.
+  constexpr uint64_t GetHigh() const { return LoadBE64(0); }
+  constexpr uint64_t GetLow() const { return LoadBE64(8); }
 
  private:
   constexpr Uuid(const UUID128Bit& val) : uu{val} {};
 
+  // 00000000-0000-1000-8000-00805F9B34FB, the base of the SIG assigned UUIDs
+  static constexpr UUID128Bit kBaseBytes{{0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                          0x10, 0x00, 0x80, 0x00, 0x00, 0x80,
+                                          0x5f, 0x9b, 0x34, 0xfb}};
+  static constexpr uint64_t kBaseHigh = 0x0000000000001000;
+  static constexpr uint64_t kBaseLow = 0x800000805f9b34fb;
+  // The bytes a 32 and 16 bit UUID share with the base
+  static constexpr uint64_t kBase32BitMask = 0x00000000ffffffff;
+  static constexpr uint64_t kBase16BitMask = 0xffff0000ffffffff;
+
+  constexpr uint64_t LoadBE64(size_t offset) const {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; i++) value = (value << 8) | uu[offset + i];
+    return value;
+  }
+
   // Network-byte-ordered ID (Big Endian).
   UUID128Bit uu;
 };
@@ -137,10 +184,10 @@ namespace std {
 template <>
 struct hash<bluetooth::Uuid> {
   std::size_t operator()(const bluetooth::Uuid& key) const {
-    const auto& uuid_bytes = key.To128BitBE();
-    std::hash<std::string> hash_fn;
-    return hash_fn(std::string(reinterpret_cast<const char*>(uuid_bytes.data()),
-                               uuid_bytes.size()));
+    // The SIG assigned UUIDs only differ in their high word
+    uint64_t value = key.GetLow();
+    value ^= key.GetHigh() + 0x9e3779b97f4a7c15 + (value << 6) + (value >> 2);
+    return std::hash<uint64_t>()(value);
   }
 };
 
@@ -106,6 +106,30 @@ TEST(UuidTest, From32Bit) {
   EXPECT_TRUE(memcmp(&uuid, u4, sizeof(u4)) == 0);
 }
 
+TEST(UuidTest, Compare) {
+  static_assert(Uuid::From16Bit(0x1800) != Uuid::From16Bit(0x1801));
+  EXPECT_EQ(Uuid::From16Bit(0x1800), Uuid::FromString("1800"));
+  EXPECT_NE(Uuid::From16Bit(0x1800), Uuid::From32Bit(0x00011800));
+  EXPECT_NE(ONES, SEQUENTIAL);
+
+  // Ordered as the Big Endian bytes
+  EXPECT_TRUE(Uuid::kEmpty < kBase);
+  EXPECT_TRUE(Uuid::From16Bit(0x1800) < Uuid::From16Bit(0x1801));
+  EXPECT_TRUE(SEQUENTIAL < ONES);
+  EXPECT_FALSE(ONES < SEQUENTIAL);
+  EXPECT_FALSE(ONES < ONES);
+  Uuid::UUID128Bit low = ONES.To128BitBE();
+  low[15] = 0x10;
+  EXPECT_TRUE(Uuid::From128BitBE(low) < ONES);
+}
+
+TEST(UuidTest, Hash) {
+  std::hash<Uuid> hash;
+  EXPECT_EQ(hash(Uuid::From16Bit(0x1800)), hash(Uuid::FromString("1800")));
+  EXPECT_NE(hash(Uuid::From16Bit(0x1800)), hash(Uuid::From16Bit(0x1801)));
+  EXPECT_NE(hash(ONES), hash(SEQUENTIAL));
+}
+
 TEST(UuidTest, ToString) {
   const std::string UUID_BASE_STR = "00000000-0000-1000-8000-00805f9b34fb";
   const std::string UUID_EMP_STR = "00000000-0000-0000-0000-000000000000";
@@ -61,12 +61,22 @@ typedef void(tUIPC_RCV_CBACK)(
 
 const char* dump_uipc_event(tUIPC_EVENT event);
 
+/* shared memory of a channel, see uipc_shm.h */
+typedef struct {
+  void* base; /* NULL while the data goes through the socket */
+  uint32_t ring_size;
+  int evt_fd;      /* signaled by the peer */
+  int peer_evt_fd; /* signaled by the stack */
+} tUIPC_SHM_CHAN;
+
 typedef struct {
   int srvfd;
   int fd;
   int read_poll_tmo_ms;
   int task_evt_flags; /* event flags pending to be processed in read task */
   tUIPC_RCV_CBACK* cback;
+  bool shm_setup_pending; /* nothing was received on the connection yet */
+  tUIPC_SHM_CHAN shm;
 } tUIPC_CHAN;
 
 struct tUIPC_STATE {
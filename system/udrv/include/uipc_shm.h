@@ -0,0 +1,132 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Shared memory mode of the UIPC channels, for the peers which want to
+ *  move the audio data without copying it through the socket.
+ *
+ *  Right after connecting, the peer sends a tUIPC_SHM_SETUP message, with
+ *  three file descriptors attached as SCM_RIGHTS:
+ *    - the shared memory, of at least UIPC_SHM_SIZE(ring_size) bytes, which
+ *      holds the ring from the peer to the stack followed by the ring from
+ *      the stack to the peer,
+ *    - an eventfd the peer signals when it wrote to its ring or read from
+ *      the ring of the stack,
+ *    - an eventfd the stack signals when it wrote to its ring or read from
+ *      the ring of the peer.
+ *  The rings are single producer single consumer, and must be zeroed by the
+ *  peer. From then on the peer only writes the data to its ring, the socket
+ *  is only used to detect the disconnection. The stack may still send on
+ *  the socket until it read the setup, the first time it reads the channel.
+ *  The connection is closed if the setup is rejected.
+ *
+ ******************************************************************************/
+#ifndef UIPC_SHM_H
+#define UIPC_SHM_H
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#define UIPC_SHM_MAGIC 0x4d485355 /* "USHM" */
+#define UIPC_SHM_VERSION 1
+#define UIPC_SHM_NUM_FDS 3
+
+/* ring sizes accepted by the stack, they must be a power of two */
+#define UIPC_SHM_RING_SIZE_MIN 1024
+#define UIPC_SHM_RING_SIZE_MAX (1024 * 1024)
+
+typedef struct {
+  uint32_t magic;     /* UIPC_SHM_MAGIC */
+  uint32_t version;   /* UIPC_SHM_VERSION */
+  uint32_t ring_size; /* bytes of data of each ring */
+} tUIPC_SHM_SETUP;
+
+/* header of a ring, followed by its data */
+typedef struct {
+  alignas(64) std::atomic<uint32_t> head; /* bytes written by the producer */
+  alignas(64) std::atomic<uint32_t> tail; /* bytes read by the consumer */
+} tUIPC_SHM_RING;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "the rings are shared with another process");
+
+#define UIPC_SHM_SIZE(ring_size) (2 * (sizeof(tUIPC_SHM_RING) + (ring_size)))
+
+/* ring written by the peer */
+static inline tUIPC_SHM_RING* uipc_shm_peer_ring(void* shm) {
+  return (tUIPC_SHM_RING*)shm;
+}
+
+/* ring written by the stack */
+static inline tUIPC_SHM_RING* uipc_shm_stack_ring(void* shm,
+                                                  uint32_t ring_size) {
+  return (tUIPC_SHM_RING*)((uint8_t*)shm + sizeof(tUIPC_SHM_RING) + ring_size);
+}
+
+/* Writes up to |len| bytes to the ring, returns the number of bytes written */
+static inline size_t uipc_shm_ring_write(tUIPC_SHM_RING* ring,
+                                         uint32_t ring_size,
+                                         const uint8_t* p_buf, size_t len) {
+  uint8_t* data = (uint8_t*)(ring + 1);
+  uint32_t head = ring->head.load(std::memory_order_relaxed);
+  uint32_t used = head - ring->tail.load(std::memory_order_acquire);
+
+  /* the other process corrupted the ring */
+  if (used > ring_size) return 0;
+
+  size_t n = std::min<size_t>(len, ring_size - used);
+  uint32_t offset = head & (ring_size - 1);
+  size_t first = std::min<size_t>(n, ring_size - offset);
+  memcpy(data + offset, p_buf, first);
+  memcpy(data, p_buf + first, n - first);
+  ring->head.store(head + n, std::memory_order_release);
+  return n;
+}
+
+/* Reads up to |len| bytes from the ring, returns the number of bytes read */
+static inline size_t uipc_shm_ring_read(tUIPC_SHM_RING* ring,
+                                        uint32_t ring_size, uint8_t* p_buf,
+                                        size_t len) {
+  const uint8_t* data = (const uint8_t*)(ring + 1);
+  uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+  uint32_t used = ring->head.load(std::memory_order_acquire) - tail;
+
+  /* the other process corrupted the ring */
+  if (used > ring_size) return 0;
+
+  size_t n = std::min<size_t>(len, used);
+  uint32_t offset = tail & (ring_size - 1);
+  size_t first = std::min<size_t>(n, ring_size - offset);
+  memcpy(p_buf, data + offset, first);
+  memcpy(p_buf + first, data, n - first);
+  ring->tail.store(tail + n, std::memory_order_release);
+  return n;
+}
+
+/* Drops the data of the ring, only called by the consumer */
+static inline void uipc_shm_ring_flush(tUIPC_SHM_RING* ring) {
+  ring->tail.store(ring->head.load(std::memory_order_acquire),
+                   std::memory_order_release);
+}
+
+#endif /* UIPC_SHM_H */
@@ -49,6 +49,7 @@
 #include "osi/include/osi.h"
 #include "osi/include/socket_utils/sockets.h"
 #include "uipc.h"
+#include "uipc_shm.h"
 
 /*****************************************************************************
  *  Constants & Macros
@@ -78,6 +79,8 @@ typedef enum {
  *  Static functions
  *****************************************************************************/
 static int uipc_close_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id);
+void uipc_close_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id);
+static inline void uipc_wakeup_locked(tUIPC_STATE& uipc);
 
 /*****************************************************************************
  *  Externs
@@ -200,6 +203,8 @@ static int uipc_main_init(tUIPC_STATE& uipc) {
     p->fd = UIPC_DISCONNECTED;
     p->task_evt_flags = 0;
     p->cback = NULL;
+    p->shm.evt_fd = UIPC_DISCONNECTED;
+    p->shm.peer_evt_fd = UIPC_DISCONNECTED;
   }
 
   return 0;
@@ -231,6 +236,259 @@ static void uipc_check_task_flags_locked(tUIPC_STATE& uipc) {
   }
 }
 
+/*****************************************************************************
+ *
+ *   shared memory helper functions
+ *
+ ****************************************************************************/
+
+static void uipc_shm_signal(int fd) {
+  uint64_t count = 1;
+  ssize_t ret;
+  OSI_NO_INTR(ret = write(fd, &count, sizeof(count)));
+  if (ret < 0) LOG_WARN("failed to signal the peer (%s)", strerror(errno));
+}
+
+/* only called once poll() reported the signal, so that it does not block */
+static void uipc_shm_clear_signal(int fd) {
+  uint64_t count;
+  ssize_t ret;
+  OSI_NO_INTR(ret = read(fd, &count, sizeof(count)));
+  if (ret < 0) LOG_WARN("failed to clear the signal (%s)", strerror(errno));
+}
+
+static void uipc_shm_close_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
+  tUIPC_SHM_CHAN* shm = &uipc.ch[ch_id].shm;
+
+  if (shm->base != NULL) {
+    LOG_DEBUG("UNMAP SHARED MEMORY OF CH %d", ch_id);
+    munmap(shm->base, UIPC_SHM_SIZE(shm->ring_size));
+    shm->base = NULL;
+  }
+
+  if (shm->evt_fd != UIPC_DISCONNECTED) {
+    FD_CLR(shm->evt_fd, &uipc.active_set);
+    close(shm->evt_fd);
+    shm->evt_fd = UIPC_DISCONNECTED;
+  }
+
+  if (shm->peer_evt_fd != UIPC_DISCONNECTED) {
+    close(shm->peer_evt_fd);
+    shm->peer_evt_fd = UIPC_DISCONNECTED;
+  }
+}
+
+/* Maps the shared memory of |setup|, the file descriptors are taken over */
+static bool uipc_shm_setup_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                                  const tUIPC_SHM_SETUP& setup, int* fds) {
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+  uint32_t ring_size = setup.ring_size;
+  struct stat st;
+  void* base = MAP_FAILED;
+
+  if (setup.magic != UIPC_SHM_MAGIC || setup.version != UIPC_SHM_VERSION ||
+      ring_size < UIPC_SHM_RING_SIZE_MIN ||
+      ring_size > UIPC_SHM_RING_SIZE_MAX ||
+      (ring_size & (ring_size - 1)) != 0) {
+    LOG_ERROR("CH %d: invalid shared memory setup, version %u ring size %u",
+              ch_id, setup.version, ring_size);
+  } else if (fstat(fds[0], &st) < 0 ||
+             st.st_size < (off_t)UIPC_SHM_SIZE(ring_size)) {
+    LOG_ERROR("CH %d: shared memory smaller than its rings", ch_id);
+  } else {
+    base = mmap(NULL, UIPC_SHM_SIZE(ring_size), PROT_READ | PROT_WRITE,
+                MAP_SHARED, fds[0], 0);
+    if (base == MAP_FAILED) {
+      LOG_ERROR("CH %d: mmap failed (%s)", ch_id, strerror(errno));
+    }
+  }
+
+  close(fds[0]);
+  if (base == MAP_FAILED) {
+    close(fds[1]);
+    close(fds[2]);
+    return false;
+  }
+
+  p->shm.base = base;
+  p->shm.ring_size = ring_size;
+  p->shm.evt_fd = fds[1];
+  p->shm.peer_evt_fd = fds[2];
+
+  /* keep notifying the user if it waits for the data in the read task */
+  if (SAFE_FD_ISSET(p->fd, &uipc.active_set)) {
+    FD_SET(p->shm.evt_fd, &uipc.active_set);
+    uipc.max_fd = MAX(uipc.max_fd, p->shm.evt_fd);
+    uipc_wakeup_locked(uipc);
+  }
+
+  LOG_INFO("CH %d: data moved to shared memory, ring size %u", ch_id,
+           ring_size);
+  return true;
+}
+
+/* Receives from the connection of the channel. The first message may be the
+ * tUIPC_SHM_SETUP of a peer moving the data to shared memory: it is consumed,
+ * and the channel is closed if it is rejected. */
+static ssize_t uipc_recv(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, int fd,
+                         uint8_t* p_buf, size_t len) {
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+  ssize_t n;
+
+  if (!p->shm_setup_pending) {
+    OSI_NO_INTR(n = recv(fd, p_buf, len, 0));
+    return n;
+  }
+
+  struct iovec iov = {.iov_base = p_buf, .iov_len = len};
+  char cmsg_buf[CMSG_SPACE(UIPC_SHM_NUM_FDS * sizeof(int))];
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cmsg_buf;
+  msg.msg_controllen = sizeof(cmsg_buf);
+
+  OSI_NO_INTR(n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC));
+  if (n <= 0) return n;
+
+  std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+  p->shm_setup_pending = false;
+
+  int fds[UIPC_SHM_NUM_FDS];
+  size_t num_fds = 0;
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+
+    size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    int* cmsg_fds = (int*)CMSG_DATA(cmsg);
+    for (size_t i = 0; i < count; i++) {
+      if (num_fds < UIPC_SHM_NUM_FDS)
+        fds[num_fds++] = cmsg_fds[i];
+      else
+        close(cmsg_fds[i]);
+    }
+  }
+
+  /* regular data, the peer keeps using the socket */
+  if (num_fds == 0 && !(msg.msg_flags & MSG_CTRUNC)) return n;
+
+  /* the setup may have been split by a short read */
+  tUIPC_SHM_SETUP setup;
+  size_t copied = std::min((size_t)n, sizeof(setup));
+  memcpy(&setup, p_buf, copied);
+  bool valid = num_fds == UIPC_SHM_NUM_FDS && !(msg.msg_flags & MSG_CTRUNC);
+  if (valid && copied < sizeof(setup)) {
+    ssize_t ret;
+    OSI_NO_INTR(ret = recv(fd, (uint8_t*)&setup + copied,
+                           sizeof(setup) - copied, MSG_WAITALL));
+    valid = ret == (ssize_t)(sizeof(setup) - copied);
+  }
+
+  if (!valid) {
+    LOG_ERROR("CH %d: invalid shared memory setup message, %zu fds", ch_id,
+              num_fds);
+    for (size_t i = 0; i < num_fds; i++) close(fds[i]);
+    uipc_close_locked(uipc, ch_id);
+    return 0;
+  }
+
+  if (!uipc_shm_setup_locked(uipc, ch_id, setup, fds)) {
+    uipc_close_locked(uipc, ch_id);
+    return 0;
+  }
+
+  /* the peer should not have sent more data through the socket */
+  n -= copied;
+  memmove(p_buf, p_buf + copied, n);
+  return n;
+}
+
+static uint32_t uipc_shm_read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                              uint8_t* p_buf, uint32_t len) {
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+  uint32_t n_read = 0;
+
+  while (n_read < len) {
+    int evt_fd;
+    int fd;
+    {
+      /* the read task unmaps the shared memory when the channel is closed */
+      std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+      if (p->shm.base == NULL) {
+        LOG_ERROR("UIPC_Read : channel %d closed", ch_id);
+        break;
+      }
+
+      size_t n = uipc_shm_ring_read(uipc_shm_peer_ring(p->shm.base),
+                                    p->shm.ring_size, p_buf + n_read,
+                                    len - n_read);
+      if (n > 0) {
+        n_read += n;
+        /* the peer may be waiting for room in its ring */
+        uipc_shm_signal(p->shm.peer_evt_fd);
+        continue;
+      }
+
+      evt_fd = p->shm.evt_fd;
+      fd = p->fd;
+    }
+
+    /* the socket is only polled for the disconnection */
+    struct pollfd pfd[2] = {{evt_fd, POLLIN, 0}, {fd, 0, 0}};
+    int poll_ret;
+    OSI_NO_INTR(poll_ret = poll(pfd, 2, p->read_poll_tmo_ms));
+    if (poll_ret == 0) {
+      LOG_WARN("poll timeout (%d ms)", p->read_poll_tmo_ms);
+      break;
+    }
+    if (poll_ret < 0) {
+      LOG_ERROR("%s(): poll() failed: return %d errno %d (%s)", __func__,
+                poll_ret, errno, strerror(errno));
+      break;
+    }
+
+    if (pfd[1].revents & (POLLHUP | POLLNVAL)) {
+      LOG_WARN("poll : channel detached remotely");
+      std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+      uipc_close_locked(uipc, ch_id);
+      return 0;
+    }
+
+    if (pfd[0].revents & POLLIN) uipc_shm_clear_signal(evt_fd);
+  }
+
+  return n_read;
+}
+
+static bool uipc_shm_send_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                                 const uint8_t* p_buf, uint16_t msglen) {
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+  tUIPC_SHM_RING* ring = uipc_shm_stack_ring(p->shm.base, p->shm.ring_size);
+  size_t n_sent = 0;
+
+  while (true) {
+    size_t n = uipc_shm_ring_write(ring, p->shm.ring_size, p_buf + n_sent,
+                                   msglen - n_sent);
+    if (n > 0) {
+      n_sent += n;
+      uipc_shm_signal(p->shm.peer_evt_fd);
+    }
+    if (n_sent == msglen) return true;
+
+    /* wait for the peer to make room in the ring, like a blocking write */
+    struct pollfd pfd = {p->shm.evt_fd, POLLIN, 0};
+    int poll_ret;
+    OSI_NO_INTR(poll_ret = poll(&pfd, 1, p->read_poll_tmo_ms));
+    if (poll_ret <= 0) {
+      LOG_ERROR("failed to write, %zu of %d bytes sent", n_sent, msglen);
+      return false;
+    }
+    uipc_shm_clear_signal(p->shm.evt_fd);
+  }
+}
+
 static int uipc_check_fd_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
   if (ch_id >= UIPC_CH_NUM) return -1;
 
@@ -244,8 +502,10 @@ static int uipc_check_fd_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
       FD_CLR(uipc.ch[ch_id].fd, &uipc.active_set);
       uipc.ch[ch_id].fd = UIPC_DISCONNECTED;
     }
+    uipc_shm_close_locked(uipc, ch_id);
 
     uipc.ch[ch_id].fd = accept_server_socket(uipc.ch[ch_id].srvfd);
+    uipc.ch[ch_id].shm_setup_pending = true;
 
     LOG_DEBUG("NEW FD %d", uipc.ch[ch_id].fd);
 
@@ -270,6 +530,13 @@ static int uipc_check_fd_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
     if (uipc.ch[ch_id].cback)
       uipc.ch[ch_id].cback(ch_id, UIPC_RX_DATA_READY_EVT);
   }
+
+  if (SAFE_FD_ISSET(uipc.ch[ch_id].shm.evt_fd, &uipc.read_set)) {
+    uipc_shm_clear_signal(uipc.ch[ch_id].shm.evt_fd);
+
+    if (uipc.ch[ch_id].cback)
+      uipc.ch[ch_id].cback(ch_id, UIPC_RX_DATA_READY_EVT);
+  }
   return 0;
 }
 
@@ -331,6 +598,12 @@ static void uipc_flush_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
     return;
   }
 
+  if (uipc.ch[ch_id].shm.base != NULL) {
+    uipc_shm_ring_flush(uipc_shm_peer_ring(uipc.ch[ch_id].shm.base));
+    uipc_shm_signal(uipc.ch[ch_id].shm.peer_evt_fd);
+    return;
+  }
+
   while (1) {
     int ret;
     OSI_NO_INTR(ret = poll(&pfd, 1, 1));
@@ -352,7 +625,13 @@ static void uipc_flush_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
 
     /* read sufficiently large buffer to ensure flush empties socket faster than
        it is getting refilled */
-    (void)read(pfd.fd, &buf, UIPC_FLUSH_BUFFER_SIZE);
+    if (uipc_recv(uipc, ch_id, pfd.fd, (uint8_t*)buf,
+                  UIPC_FLUSH_BUFFER_SIZE) == 0 &&
+        uipc.ch[ch_id].shm.base != NULL) {
+      /* the peer moved the data to shared memory */
+      uipc_flush_ch_locked(uipc, ch_id);
+      return;
+    }
   }
 }
 
@@ -392,6 +671,7 @@ static int uipc_close_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
     uipc.ch[ch_id].fd = UIPC_DISCONNECTED;
     wakeup = 1;
   }
+  uipc_shm_close_locked(uipc, ch_id);
 
   /* notify this connection is closed */
   if (uipc.ch[ch_id].cback) uipc.ch[ch_id].cback(ch_id, UIPC_CLOSE_EVT);
@@ -584,6 +864,10 @@ bool UIPC_Send(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
 
   std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
 
+  if (uipc.ch[ch_id].shm.base != NULL) {
+    return uipc_shm_send_locked(uipc, ch_id, p_buf, msglen);
+  }
+
   ssize_t ret;
   OSI_NO_INTR(ret = write(uipc.ch[ch_id].fd, p_buf, msglen));
   if (ret < 0) {
@@ -620,6 +904,10 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
     return 0;
   }
 
+  if (uipc.ch[ch_id].shm.base != NULL) {
+    return uipc_shm_read(uipc, ch_id, p_buf, len);
+  }
+
   while (n_read < (int)len) {
     pfd.fd = fd;
     pfd.events = POLLIN | POLLHUP;
@@ -646,8 +934,12 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
       return 0;
     }
 
-    ssize_t n;
-    OSI_NO_INTR(n = recv(fd, p_buf + n_read, len - n_read, 0));
+    ssize_t n = uipc_recv(uipc, ch_id, fd, p_buf + n_read, len - n_read);
+
+    if (n == 0 && uipc.ch[ch_id].shm.base != NULL) {
+      /* the peer moved the data to shared memory */
+      return n_read + uipc_shm_read(uipc, ch_id, p_buf + n_read, len - n_read);
+    }
 
     if (n == 0) {
       LOG_WARN("UIPC_Read : channel detached remotely");
@@ -692,6 +984,8 @@ bool UIPC_Ioctl(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint32_t request,
       if (uipc.ch[ch_id].fd != UIPC_DISCONNECTED) {
         /* remove this channel from active set */
         FD_CLR(uipc.ch[ch_id].fd, &uipc.active_set);
+        if (uipc.ch[ch_id].shm.evt_fd != UIPC_DISCONNECTED)
+          FD_CLR(uipc.ch[ch_id].shm.evt_fd, &uipc.active_set);
 
         /* refresh active set */
         uipc_wakeup_locked(uipc);